@@ -47,19 +47,241 @@ namespace at {
 // if not use the same mechanism. In order to accomplish that we might have to
 // do some refactoring.
 
-Tensor sum_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
+// Reductions over an empty list of dims reduce over all of the dims of the
+// tensor. The physical tensor has batch dims too, so we spell out the logical
+// dims in that case. A logical scalar gets a size-1 dim to reduce over, as
+// reductions of scalars accept dims 0 and -1.
+template <Tensor (*Op)(const Tensor&, IntArrayRef, bool, optional<ScalarType>)>
+Tensor reduction_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
   auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
-  auto dims_physical = self_physical.getPhysicalDims(dims);
-  auto result = at::sum(self_physical.tensor(), dims_physical, keepdim, dtype);
+  auto physical = self_physical.tensor();
+  const auto num_batch_dims = self_physical.numBatchDims();
+  const bool is_logical_scalar = /*logical dim*/self.dim() == 0;
+
+  VmapDimVector dims_physical;
+  if (is_logical_scalar) {
+    for (auto dim : dims) {
+      maybe_wrap_dim(dim, /*logical dim*/self.dim());
+    }
+    physical = physical.unsqueeze(-1);
+    dims_physical.push_back(num_batch_dims);
+  } else if (dims.empty()) {
+    for (int64_t dim = num_batch_dims; dim < physical.dim(); dim++) {
+      dims_physical.push_back(dim);
+    }
+  } else {
+    dims_physical = self_physical.getPhysicalDims(dims);
+  }
+
+  auto result = Op(physical, dims_physical, keepdim, dtype);
+  if (is_logical_scalar && keepdim) {
+    result = result.squeeze(-1);
+  }
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+template <Tensor (*Op)(const Tensor&, IntArrayRef, bool, optional<ScalarType>)>
+Tensor full_reduction_batching_rule(const Tensor& self, optional<ScalarType> dtype) {
+  return reduction_batching_rule<Op>(self, /*dims*/{}, /*keepdim*/false, dtype);
+}
+
+template <Tensor (*Op)(const Tensor&)>
+Tensor unary_pointwise_batching_rule(const Tensor& self) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto result = Op(self_physical.tensor());
   return self_physical.newLogicalFromPhysical(result);
 }
 
-Tensor mul_batching_rule(const Tensor& self, const Tensor& other) {
+template <Tensor (*Op)(const Tensor&, const Tensor&)>
+Tensor binary_pointwise_batching_rule(const Tensor& self, const Tensor& other) {
+  auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self, other});
+  auto result = Op(physical_args[0].tensor(), physical_args[1].tensor());
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
+template <Tensor (*Op)(const Tensor&, const Tensor&, Scalar)>
+Tensor binary_pointwise_alpha_batching_rule(const Tensor& self, const Tensor& other, Scalar alpha) {
   auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self, other});
-  auto result = at::mul(physical_args[0].tensor(), physical_args[1].tensor());
+  auto result = Op(physical_args[0].tensor(), physical_args[1].tensor(), alpha);
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
+// NOTE: [Batching rule for matmul]
+// at::matmul treats 1-D operands specially and broadcasts the dims in front
+// of the last two, so the batch dims can't just be passed through: a physical
+// tensor of size [B0, 3] for a logical vector would be multiplied as a matrix.
+// In general, we turn 1-D operands into matrices, let BroadcastingVmapTransform
+// line up the batch dims and the dims in front of the matrices, do one
+// at::matmul, and squeeze the extra dims back out.
+//
+// When only one of the operands is batched and the other has at most 2 dims,
+// at::matmul can fold the batch dims into the rows of a single matrix
+// multiplication instead, which saves expanding the unbatched operand to the
+// batch size.
+Tensor matmul_batching_rule(const Tensor& self, const Tensor& other) {
+  const auto self_dim = /*logical dim*/self.dim();
+  const auto other_dim = /*logical dim*/other.dim();
+  TORCH_CHECK(self_dim > 0 && other_dim > 0,
+      "both arguments to matmul need to be at least 1D, but they are ",
+      self_dim, "D and ", other_dim, "D");
+
+  if (!isBatched(other) && other_dim <= 2) {
+    auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+    auto result = at::matmul(self_physical.tensor(), other);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  if (!isBatched(self) && self_dim <= 2) {
+    auto other_physical = MultiBatchVmapTransform::logicalToPhysical(other);
+    // A batch of vectors, [B0, k], times a matrix of size [n, k] is the same
+    // as [B0, k] times the transposed [k, n] matrix.
+    auto result = other_dim == 1
+        ? at::matmul(other_physical.tensor(), self_dim == 2 ? self.t() : self)
+        : at::matmul(self, other_physical.tensor());
+    return other_physical.newLogicalFromPhysical(result);
+  }
+
+  auto self_matrix = self_dim == 1 ? self.unsqueeze(0) : self;
+  auto other_matrix = other_dim == 1 ? other.unsqueeze(1) : other;
+  auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self_matrix, other_matrix});
+  auto result = at::matmul(physical_args[0].tensor(), physical_args[1].tensor());
+  if (other_dim == 1) {
+    result = result.squeeze(-1);
+  }
+  if (self_dim == 1) {
+    result = result.squeeze(other_dim == 1 ? -1 : -2);
+  }
   return physical_args[0].newLogicalFromPhysical(result);
 }
 
+Tensor mm_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(/*logical dim*/self.dim() == 2, "self must be a matrix");
+  TORCH_CHECK(/*logical dim*/other.dim() == 2, "mat2 must be a matrix");
+  return matmul_batching_rule(self, other);
+}
+
+Tensor mv_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(/*logical dim*/self.dim() == 2 && /*logical dim*/other.dim() == 1,
+      "vector + matrix @ vector expected, got ", self.dim(), ", ", other.dim());
+  return matmul_batching_rule(self, other);
+}
+
+Tensor dot_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(/*logical dim*/self.dim() == 1 && /*logical dim*/other.dim() == 1,
+      "1D tensors expected, but got ", self.dim(), "D and ", other.dim(), "D tensors");
+  return matmul_batching_rule(self, other);
+}
+
+Tensor bmm_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(/*logical dim*/self.dim() == 3, "batch1 must be a 3D tensor");
+  TORCH_CHECK(/*logical dim*/other.dim() == 3, "batch2 must be a 3D tensor");
+  // at::matmul would broadcast a batch of size 1; bmm doesn't.
+  TORCH_CHECK(self.size(0) == other.size(0),
+      "batch1 and batch2 must have same number of batches, got ",
+      self.size(0), " and ", other.size(0));
+  return matmul_batching_rule(self, other);
+}
+
+// A batch of inputs convolved with the same weight is one convolution over a
+// bigger batch of images, so the batch dims get folded into N. Per-example
+// weights turn into a grouped convolution instead: the inputs of the examples
+// are stacked along the channels and every example gets `groups` groups of
+// the stacked weights. A batched bias is added to the result afterwards.
+Tensor conv2d_batching_rule(
+    const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  if (bias.defined() && isBatched(bias)) {
+    auto result = at::conv2d(input, weight, /*bias*/Tensor(), stride, padding, dilation, groups);
+    return result + bias.unsqueeze(-1).unsqueeze(-1);
+  }
+  TORCH_CHECK(/*logical dim*/input.dim() == 4 && /*logical dim*/weight.dim() == 4,
+      "conv2d: vmap expects a 4-dimensional input and weight, got ",
+      input.dim(), "-dimensional input and ", weight.dim(), "-dimensional weight");
+
+  if (!isBatched(weight)) {
+    auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+    const auto num_batch_dims = input_physical.numBatchDims();
+    // [B0, B1, N, C, H, W] -> [B0 * B1 * N, C, H, W]
+    auto result = at::conv2d(
+        input_physical.tensor().flatten(0, num_batch_dims),
+        weight, bias, stride, padding, dilation, groups);
+    auto input_sizes = input_physical.tensor().sizes();
+    VmapDimVector result_sizes(input_sizes.begin(), input_sizes.begin() + num_batch_dims + 1);
+    result_sizes.insert(result_sizes.end(), result.sizes().begin() + 1, result.sizes().end());
+    return input_physical.newLogicalFromPhysical(result.view(result_sizes));
+  }
+
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({input, weight});
+  const auto& input_physical = physical_args[0].tensor();
+  const auto& weight_physical = physical_args[1].tensor();
+  const auto num_batch_dims = physical_args[0].numBatchDims();
+  auto batch_sizes = input_physical.sizes().slice(0, num_batch_dims);
+  int64_t num_examples = 1;
+  for (auto size : batch_sizes) {
+    num_examples *= size;
+  }
+
+  // [B0, B1, N, C, H, W] -> [N, B0 * B1 * C, H, W]
+  auto input_stacked = input_physical.flatten(0, num_batch_dims - 1).transpose(0, 1).flatten(1, 2);
+  // [B0, B1, O, C / groups, kH, kW] -> [B0 * B1 * O, C / groups, kH, kW]
+  auto weight_stacked = weight_physical.flatten(0, num_batch_dims);
+  auto bias_stacked = bias.defined() ? bias.repeat({num_examples}) : Tensor();
+  auto result = at::conv2d(
+      input_stacked, weight_stacked, bias_stacked,
+      stride, padding, dilation, groups * num_examples);
+
+  // [N, B0 * B1 * O, H', W'] -> [B0, B1, N, O, H', W']
+  const auto out_channels = weight_physical.size(num_batch_dims);
+  result = result.view({result.size(0), num_examples, out_channels, result.size(2), result.size(3)})
+      .transpose(0, 1);
+  VmapDimVector result_sizes(batch_sizes.begin(), batch_sizes.end());
+  result_sizes.insert(result_sizes.end(), result.sizes().begin() + 1, result.sizes().end());
+  return physical_args[0].newLogicalFromPhysical(result.view(result_sizes));
+}
+
+// Per-example weights get stacked into one embedding table, with the indices
+// of each example offset to the rows of its own weight.
+Tensor embedding_batching_rule(
+    const Tensor& weight, const Tensor& indices,
+    int64_t padding_idx, bool scale_grad_by_freq, bool sparse) {
+  if (!isBatched(weight)) {
+    auto indices_physical = MultiBatchVmapTransform::logicalToPhysical(indices);
+    auto result = at::embedding(
+        weight, indices_physical.tensor(), padding_idx, scale_grad_by_freq, sparse);
+    return indices_physical.newLogicalFromPhysical(result);
+  }
+  TORCH_CHECK(/*logical dim*/weight.dim() == 2, "'weight' must be 2-D");
+  TORCH_CHECK(padding_idx == -1,
+      "embedding: vmap over the weight does not support padding_idx yet");
+
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({weight, indices});
+  const auto& weight_physical = physical_args[0].tensor();
+  const auto& indices_physical = physical_args[1].tensor();
+  const auto num_batch_dims = physical_args[0].numBatchDims();
+  const auto num_embeddings = weight_physical.size(num_batch_dims);
+  // The stacked table would silently look indices that are out of range up
+  // in the weight of another example.
+  TORCH_CHECK(
+      !(indices_physical.lt(0) | indices_physical.ge(num_embeddings)).any().item<bool>(),
+      "embedding: index out of range for a weight of ", num_embeddings, " embeddings");
+
+  auto batch_sizes = weight_physical.sizes().slice(0, num_batch_dims);
+  int64_t num_examples = 1;
+  for (auto size : batch_sizes) {
+    num_examples *= size;
+  }
+  VmapDimVector offsets_sizes(batch_sizes.begin(), batch_sizes.end());
+  offsets_sizes.resize(indices_physical.dim(), 1);
+  auto offsets = at::arange(num_examples, indices_physical.options())
+      .mul_(num_embeddings)
+      .view(offsets_sizes);
+
+  // [B0, B1, V, D] -> [B0 * B1 * V, D]
+  auto result = at::embedding(
+      weight_physical.flatten(0, num_batch_dims), indices_physical + offsets,
+      padding_idx, scale_grad_by_freq, sparse);
+  return physical_args[1].newLogicalFromPhysical(result);
+}
+
 Tensor expand_batching_rule(const Tensor& self, IntArrayRef size, bool implicit) {
   auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
   auto size_physical = self_physical.getPhysicalShape(size);
@@ -159,13 +381,64 @@ TORCH_LIBRARY_IMPL(aten, Batched, m) {
   m.impl("_add_batch_dim", native::_add_batch_dim);
   m.impl("_remove_batch_dim", native::_remove_batch_dim);
 
-  m.impl_UNBOXED("sum.dim_IntList", sum_batching_rule);
-  m.impl_UNBOXED("mul.Tensor", mul_batching_rule);
   m.impl("expand", expand_batching_rule);
   m.impl("transpose.int", transpose_int_batching_rule);
   m.impl("unsqueeze", unsqueeze_batching_rule);
   m.impl("squeeze.dim", squeeze_dim_batching_rule);
   m.impl("permute", permute_batching_rule);
+
+  // reductions
+  m.impl_UNBOXED("sum", full_reduction_batching_rule<at::sum>);
+  m.impl_UNBOXED("sum.dim_IntList", reduction_batching_rule<at::sum>);
+  m.impl_UNBOXED("mean", full_reduction_batching_rule<at::mean>);
+  m.impl_UNBOXED("mean.dim", reduction_batching_rule<at::mean>);
+
+  // unary pointwise ops
+#define UNARY_POINTWISE(op) m.impl(#op, unary_pointwise_batching_rule<at::op>);
+  UNARY_POINTWISE(abs);
+  UNARY_POINTWISE(acos);
+  UNARY_POINTWISE(asin);
+  UNARY_POINTWISE(atan);
+  UNARY_POINTWISE(ceil);
+  UNARY_POINTWISE(cos);
+  UNARY_POINTWISE(cosh);
+  UNARY_POINTWISE(exp);
+  UNARY_POINTWISE(expm1);
+  UNARY_POINTWISE(floor);
+  UNARY_POINTWISE(log);
+  UNARY_POINTWISE(log10);
+  UNARY_POINTWISE(log1p);
+  UNARY_POINTWISE(log2);
+  UNARY_POINTWISE(neg);
+  UNARY_POINTWISE(reciprocal);
+  UNARY_POINTWISE(relu);
+  UNARY_POINTWISE(round);
+  UNARY_POINTWISE(rsqrt);
+  UNARY_POINTWISE(sigmoid);
+  UNARY_POINTWISE(sign);
+  UNARY_POINTWISE(sin);
+  UNARY_POINTWISE(sinh);
+  UNARY_POINTWISE(sqrt);
+  UNARY_POINTWISE(tan);
+  UNARY_POINTWISE(tanh);
+  UNARY_POINTWISE(trunc);
+#undef UNARY_POINTWISE
+
+  // binary pointwise ops
+  m.impl("add.Tensor", binary_pointwise_alpha_batching_rule<at::add>);
+  m.impl("sub.Tensor", binary_pointwise_alpha_batching_rule<at::sub>);
+  m.impl_UNBOXED("mul.Tensor", binary_pointwise_batching_rule<at::mul>);
+  m.impl("div.Tensor", binary_pointwise_batching_rule<at::div>);
+
+  // matrix multiplication
+  m.impl("mm", mm_batching_rule);
+  m.impl("mv", mv_batching_rule);
+  m.impl("dot", dot_batching_rule);
+  m.impl("bmm", bmm_batching_rule);
+  m.impl("matmul", matmul_batching_rule);
+
+  m.impl_UNBOXED("conv2d", conv2d_batching_rule);
+  m.impl("embedding", embedding_batching_rule);
 }
 
 } // namespace at
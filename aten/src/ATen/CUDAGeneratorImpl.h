@@ -3,10 +3,85 @@
 #include <c10/core/GeneratorImpl.h>
 #include <ATen/core/Generator.h>
 
+#include <atomic>
+
 // TODO: this file should be in ATen/cuda, not top level
 
 namespace at {
 
+/**
+ * Note [CUDA Graph-safe RNG states]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * A kernel launched with philox_engine_inputs() has its seed and offset baked
+ * in as values. Replaying a captured graph would then hand every replay the
+ * same random numbers. Kernels meant to be capturable instead take a
+ * PhiloxCudaState from philox_cuda_state() and unpack it on the device with
+ * at::cuda::philox::unpack (ATen/cuda/CUDAGraphsUtils.cuh):
+ *
+ * - Outside of capture, the state holds the seed and offset as values, so
+ *   eager numerics are unchanged.
+ * - During capture, the state holds a pointer to a device-side offset owned
+ *   by the graph plus the offset of this kernel relative to the start of the
+ *   graph. Before each replay, CUDAGraph::replay() advances the generator by
+ *   the whole graph's increment and writes the old offset to the device, so
+ *   every replay draws fresh numbers exactly as if the graph's kernels were
+ *   launched eagerly.
+ *
+ * Usage:
+ *   // See Note [Lock-free philox offsets]
+ *   PhiloxCudaState rng_engine_inputs = gen->philox_cuda_state(offset_increment);
+ *   kernel<<<...>>>(rng_engine_inputs);
+ *
+ *   __global__ void kernel(PhiloxCudaState philox_args) {
+ *     auto seeds = at::cuda::philox::unpack(philox_args);
+ *     curand_init(seeds.first, idx, seeds.second, &state);
+ *   }
+ */
+/**
+ * Note [Lock-free philox offsets]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Every CUDA random op reserves a range of philox offsets for its kernel, and
+ * models running dropout in a loop do so thousands of times per iteration,
+ * from as many threads as there are devices. So philox_cuda_state() and
+ * philox_engine_inputs() reserve the range with an atomic increment and need
+ * no gen->mutex_: the kernel gets the same offset it would under the lock, and
+ * concurrent ops get disjoint ranges. The rest of the generator, i.e. seeding,
+ * the state getters and setters and clone(), still follows
+ * Note [Acquire lock when using random generators], and a seed set
+ * concurrently with a random op reaches it before or after the op's offset.
+ */
+struct PhiloxCudaState {
+  PhiloxCudaState() = default;
+  // Called if graph capture is not underway
+  PhiloxCudaState(uint64_t seed,
+                  uint64_t offset) {
+    seed_ = seed;
+    offset_.val = offset;
+  }
+  // Called if graph capture is underway
+  PhiloxCudaState(uint64_t seed,
+                  int64_t* offset_extragraph,
+                  uint32_t offset_intragraph) {
+    seed_ = seed;
+    offset_.ptr = offset_extragraph;
+    offset_intragraph_ = offset_intragraph;
+    captured_ = true;
+  }
+
+  // Public members, directly accessible by at::cuda::philox::unpack.
+  union Payload {
+    uint64_t val;
+    int64_t* ptr;
+  };
+
+  uint64_t seed_ = 0;
+  Payload offset_;
+  uint32_t offset_intragraph_ = 0;
+  bool captured_ = false;
+};
+
 struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   // Constructors
   CUDAGeneratorImpl(DeviceIndex device_index = -1);
@@ -19,13 +94,25 @@ struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   uint64_t seed() override;
   void set_philox_offset_per_thread(uint64_t offset);
   uint64_t philox_offset_per_thread();
+  // Not capturable: kernels using it can't be part of a CUDA graph.
+  // See Note [Lock-free philox offsets]
   std::pair<uint64_t, uint64_t> philox_engine_inputs(uint64_t increment);
+  // See Note [CUDA Graph-safe RNG states] and Note [Lock-free philox offsets]
+  PhiloxCudaState philox_cuda_state(uint64_t increment);
+  // Called by CUDAGraph around capture. capture_epilogue() returns the offset
+  // increment of the whole graph.
+  void capture_prologue(int64_t* offset_extragraph);
+  uint64_t capture_epilogue();
   static DeviceType device_type();
 
 private:
   CUDAGeneratorImpl* clone_impl() const override;
-  uint64_t seed_ = default_rng_seed_val;
-  uint64_t philox_offset_per_thread_ = 0;
+  // See Note [Lock-free philox offsets]
+  std::atomic<uint64_t> seed_{default_rng_seed_val};
+  std::atomic<uint64_t> philox_offset_per_thread_{0};
+  int64_t* offset_extragraph_ = nullptr;
+  std::atomic<uint32_t> offset_intragraph_{0};
+  std::atomic<bool> graph_expects_this_gen_{false};
 };
 
 namespace cuda {
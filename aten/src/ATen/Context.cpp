@@ -94,6 +94,38 @@ void Context::setAllowTF32CuBLAS(bool b) {
   allow_tf32_cublas = b;
 }
 
+bool Context::useCUDACopyStreams() const {
+  return use_cuda_copy_streams;
+}
+
+void Context::setUseCUDACopyStreams(bool b) {
+  use_cuda_copy_streams = b;
+}
+
+bool Context::allowFastMathCPU() const {
+  return allow_fast_math_cpu;
+}
+
+void Context::setAllowFastMathCPU(bool b) {
+  allow_fast_math_cpu = b;
+}
+
+bool Context::benchmarkCPUConv() const {
+  return benchmark_cpu_conv;
+}
+
+void Context::setBenchmarkCPUConv(bool b) {
+  benchmark_cpu_conv = b;
+}
+
+bool Context::parallelCPURNG() const {
+  return parallel_cpu_rng;
+}
+
+void Context::setParallelCPURNG(bool b) {
+  parallel_cpu_rng = b;
+}
+
 bool Context::hasMKL() const {
 #if AT_MKL_ENABLED()
   return true;
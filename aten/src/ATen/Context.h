@@ -111,6 +111,22 @@ class CAFFE2_API Context {
   void alertNotDeterministic(c10::string_view const& caller);
   bool allowTF32CuBLAS() const;
   void setAllowTF32CuBLAS(bool);
+  // Whether non_blocking to() copies between the CPU and a CUDA device are
+  // issued on the device's copy stream instead of the current stream.
+  bool useCUDACopyStreams() const;
+  void setUseCUDACopyStreams(bool);
+  // Lets CPU kernels use the faster, less accurate math functions.
+  // See Note [Vectorized math accuracy]
+  bool allowFastMathCPU() const;
+  void setAllowFastMathCPU(bool);
+  // Lets CPU convolutions time the available backends on first use of a
+  // shape and cache the fastest. See Note [CPU convolution benchmark]
+  bool benchmarkCPUConv() const;
+  void setBenchmarkCPUConv(bool);
+  // Lets CPU random ops fill contiguous float and double tensors from a
+  // philox stream, in parallel. See Note [Parallel CPU random numbers]
+  bool parallelCPURNG() const;
+  void setParallelCPURNG(bool);
   at::QEngine qEngine() const;
   void setQEngine(at::QEngine e);
   const std::vector<at::QEngine>& supportedQEngines() const;
@@ -139,6 +155,10 @@ class CAFFE2_API Context {
   bool _deterministic = false;
   bool benchmark_cudnn = false;
   bool allow_tf32_cublas = true;
+  bool use_cuda_copy_streams = false;
+  bool allow_fast_math_cpu = false;
+  bool benchmark_cpu_conv = false;
+  bool parallel_cpu_rng = false;
   bool enabled_mkldnn = true;
   #ifdef C10_MOBILE
   bool release_original_weights = true;
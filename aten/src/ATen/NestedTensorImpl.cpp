@@ -0,0 +1,96 @@
+#include <ATen/NestedTensorImpl.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+
+namespace at {
+
+NestedTensorImpl::NestedTensorImpl(Tensor buffer, std::vector<int64_t> offsets)
+  : TensorImpl(
+      c10::DispatchKeySet(DispatchKey::NestedTensor),
+      buffer.dtype(),
+      buffer.device()
+    )
+  , buffer_(std::move(buffer))
+  , offsets_(std::move(offsets))
+{
+  TORCH_INTERNAL_ASSERT(buffer_.defined());
+  TORCH_INTERNAL_ASSERT(!offsets_.empty() && offsets_.front() == 0);
+  TORCH_INTERNAL_ASSERT(buffer_.dim() >= 1 && offsets_.back() == buffer_.size(0));
+
+  int64_t max_length = 0;
+  for (int64_t i = 0; i < num_components(); i++) {
+    TORCH_INTERNAL_ASSERT(length(i) >= 0);
+    max_length = std::max(max_length, length(i));
+  }
+  const auto buffer_sizes = buffer_.sizes();
+  sizes_.clear();
+  sizes_.reserve(buffer_sizes.size() + 1);
+  sizes_.push_back(num_components());
+  sizes_.push_back(max_length);
+  sizes_.insert(sizes_.end(), buffer_sizes.begin() + 1, buffer_sizes.end());
+  refresh_numel();
+}
+
+Tensor NestedTensorImpl::component(int64_t i) const {
+  TORCH_CHECK(
+      i >= 0 && i < num_components(),
+      "nested tensor component ", i, " is out of range for ", num_components(),
+      " components");
+  return buffer_.narrow(0, offsets_[i], length(i));
+}
+
+// The following are publically exposed as methods of Tensor
+IntArrayRef NestedTensorImpl::strides() const {
+  TORCH_CHECK(false, "Nested tensors do not have strides; convert them with to_padded_tensor() first");
+}
+int64_t NestedTensorImpl::stride(int64_t d) const {
+  TORCH_CHECK(false, "Nested tensors do not have strides; convert them with to_padded_tensor() first");
+}
+bool NestedTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  TORCH_CHECK(false, "is_contiguous is not defined for nested tensors");
+}
+const Storage& NestedTensorImpl::storage() const {
+  TORCH_CHECK(false, "Nested tensors do not have storage; their packed buffer does");
+}
+int64_t NestedTensorImpl::storage_offset() const {
+  TORCH_CHECK(false, "Nested tensors do not have storage; their packed buffer does");
+}
+
+// The following are some internal inherited methods that we do not support.
+// They should never get called.
+void NestedTensorImpl::set_size(int64_t dim, int64_t new_size) {
+  TORCH_INTERNAL_ASSERT(false, "Can't set_size for NestedTensorImpl");
+}
+void NestedTensorImpl::set_stride(int64_t dim, int64_t new_stride) {
+  TORCH_INTERNAL_ASSERT(false, "Can't set_stride for NestedTensorImpl");
+}
+void NestedTensorImpl::set_storage_offset(int64_t storage_offset) {
+  TORCH_INTERNAL_ASSERT(false, "Can't set_storage_offset for NestedTensorImpl");
+}
+bool NestedTensorImpl::has_storage() const {
+  TORCH_INTERNAL_ASSERT(false, "Can't query has_storage for NestedTensorImpl");
+}
+
+Tensor makeNested(const Tensor& buffer, std::vector<int64_t> offsets) {
+  TORCH_INTERNAL_ASSERT(!isNested(buffer));
+  return at::detail::make_tensor<NestedTensorImpl>(buffer, std::move(offsets));
+}
+
+Tensor nestedPaddedRowIndices(
+    IntArrayRef offsets, int64_t padded_length, Device device) {
+  std::vector<int64_t> rows;
+  rows.reserve(offsets.back());
+  for (size_t i = 0; i + 1 < offsets.size(); i++) {
+    const int64_t length = offsets[i + 1] - offsets[i];
+    TORCH_INTERNAL_ASSERT(length <= padded_length);
+    for (int64_t j = 0; j < length; j++) {
+      rows.push_back(i * padded_length + j);
+    }
+  }
+  return at::tensor(rows, at::kLong).to(device);
+}
+
+} // namespace at
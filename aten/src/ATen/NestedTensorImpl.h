@@ -0,0 +1,91 @@
+#pragma once
+
+#include <ATen/ArrayRef.h>
+#include <ATen/Tensor.h>
+
+#include <vector>
+
+namespace at {
+
+// A NestedTensorImpl holds a batch of tensors ("components") that have the
+// same dtype, device and trailing sizes but differ in the size of their first
+// dim, such as sequences of different lengths:
+//
+//    components [len_0, *inner], [len_1, *inner], ..., [len_{B-1}, *inner]
+//
+// Instead of padding every component to the longest, they are stored packed
+// back to back in one buffer of size [len_0 + ... + len_{B-1}, *inner], and
+// component i is rows [offsets[i], offsets[i + 1]) of the buffer.
+//
+// NB: We use the term "NestedTensor" to mean a Tensor that is backed with a
+// NestedTensorImpl.
+//
+// sizes() are those of the padded form, [B, max(len_i), *inner], so dim() and
+// the dims past the ragged one mean the same as for a padded batch. Dim 1 is
+// the ragged dim. The operators registered for the NestedTensor dispatch key
+// (see NestedTensorRegistrations.cpp) compute on the buffer directly, so work
+// on padding is never done; the others raise an error and need a conversion
+// to_padded_tensor() first.
+//
+// Like BatchedTensorImpl, this is a wrapper: it only has the NestedTensor
+// dispatch key, and the kernels call regular operators on the buffer, which
+// record autograd as usual.
+struct TORCH_API NestedTensorImpl : public c10::TensorImpl {
+  NestedTensorImpl(Tensor buffer, std::vector<int64_t> offsets);
+
+  // The packed components, of size [offsets().back(), *inner]
+  const Tensor& buffer() const { return buffer_; }
+
+  // The B + 1 row offsets of the components in the buffer
+  IntArrayRef offsets() const { return offsets_; }
+
+  int64_t num_components() const { return offsets_.size() - 1; }
+  int64_t length(int64_t i) const { return offsets_[i + 1] - offsets_[i]; }
+
+  // Component i, a view of the buffer
+  Tensor component(int64_t i) const;
+
+  // Override a bunch of methods inherited from TensorImpl to return error messages.
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
+  IntArrayRef strides() const override;
+  int64_t stride(int64_t d) const override;
+  void set_size(int64_t dim, int64_t new_size) override;
+  void set_stride(int64_t dim, int64_t new_stride) override;
+  void set_storage_offset(int64_t storage_offset) override;
+  bool has_storage() const override;
+  const Storage& storage() const override;
+  int64_t storage_offset() const override;
+
+ private:
+  Tensor buffer_;
+  std::vector<int64_t> offsets_;
+};
+
+inline bool isNested(const Tensor& tensor) {
+  return tensor.unsafeGetTensorImpl()->key_set().has(DispatchKey::NestedTensor);
+}
+
+// It is unsafe to call this on a Tensor that is not backed by a
+// NestedTensorImpl. Please use `maybeGetNested` whenever possible.
+inline NestedTensorImpl* unsafeGetNested(const Tensor& tensor) {
+  return static_cast<NestedTensorImpl*>(tensor.unsafeGetTensorImpl());
+}
+
+inline NestedTensorImpl* maybeGetNested(const Tensor& tensor) {
+  if (!isNested(tensor)) {
+    return nullptr;
+  }
+  return unsafeGetNested(tensor);
+}
+
+// Use this to construct a NestedTensor from a packed buffer and its offsets
+TORCH_API Tensor makeNested(const Tensor& buffer, std::vector<int64_t> offsets);
+
+// The rows of the padded form, viewed as [B * padded_length, *inner], that
+// hold the packed rows, in order: offsets[i] + j is at i * padded_length + j.
+// The conversions to and from the padded form are one index_select or
+// index_copy_ with these.
+TORCH_API Tensor nestedPaddedRowIndices(
+    IntArrayRef offsets, int64_t padded_length, Device device);
+
+} // namespace at
@@ -0,0 +1,294 @@
+#include <torch/library.h>
+#include <ATen/NestedTensorImpl.h>
+#include <ATen/ATen.h>
+#include <ATen/WrapDimUtils.h>
+
+namespace at {
+
+// NOTE: [How do NestedTensor kernels work?]
+//
+// A NestedTensor of padded size [B, L, *inner] is backed by a buffer of size
+// [N, *inner] holding the rows of all B components back to back (see
+// NestedTensorImpl.h). An operator that treats every row on its own, such as
+// pointwise ops, linear, or layer_norm over the inner dims, gives the same
+// rows whether or not they are packed, so its kernel runs the operator once on
+// the buffer and wraps the result with the same offsets. Logical dim d >= 2
+// of the nested tensor is dim d - 1 of the buffer.
+//
+// Operators that mix the rows of a component (softmax over the ragged dim,
+// attention) run once per component and concatenate the results. Operators
+// without a kernel here raise an error through the fallback below.
+//
+// The kernels call regular operators on the buffers, so autograd is recorded
+// on those; a NestedTensor itself never requires grad.
+
+namespace {
+
+// Logical dims 0 and 1 of a NestedTensor are the batch and the ragged dim.
+constexpr int64_t kNumOuterDims = 2;
+
+Tensor wrapLike(const NestedTensorImpl* impl, const Tensor& buffer) {
+  return makeNested(buffer, impl->offsets().vec());
+}
+
+// Concatenates the results computed for each component into a buffer; `empty`
+// is the buffer to use when there are no components to concatenate.
+Tensor catComponents(const std::vector<Tensor>& results, const Tensor& empty) {
+  return results.empty() ? empty : at::cat(results, 0);
+}
+
+int64_t innerDim(const Tensor& self, int64_t dim, const char* op_name) {
+  const auto dim_ = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(dim_ != 0, op_name, ": the batch dim of a nested tensor is not supported");
+  return dim_ - 1;
+}
+
+// The buffer to use for `tensor` as an operand of a pointwise op with the
+// NestedTensor `nested`. A dense operand can only broadcast over the inner
+// dims, so it has to be the same for all rows.
+Tensor packedOperand(const Tensor& tensor, const NestedTensorImpl* nested, const char* op_name) {
+  if (auto* impl = maybeGetNested(tensor)) {
+    TORCH_CHECK(impl->offsets() == nested->offsets(),
+        op_name, ": expected nested tensors with the same component lengths");
+    return impl->buffer();
+  }
+  TORCH_CHECK(tensor.dim() <= nested->dim() - kNumOuterDims,
+      op_name, ": a dense operand can only broadcast over the dims past the ragged "
+      "dim of a nested tensor, but got a dense tensor of size ", tensor.sizes(),
+      " and a nested tensor of padded size ", nested->sizes());
+  return tensor;
+}
+
+const NestedTensorImpl* nestedOperand(const Tensor& self, const Tensor& other) {
+  auto* impl = maybeGetNested(self);
+  return impl ? impl : unsafeGetNested(other);
+}
+
+void checkDense(const Tensor& tensor, const char* op_name, const char* arg_name) {
+  TORCH_CHECK(!isNested(tensor),
+      op_name, ": expected a dense ", arg_name, ", but got a nested tensor");
+}
+
+template <Tensor (*Op)(const Tensor&)>
+Tensor unary_pointwise_nested(const Tensor& self) {
+  auto* self_impl = unsafeGetNested(self);
+  return wrapLike(self_impl, Op(self_impl->buffer()));
+}
+
+template <Tensor (*Op)(const Tensor&, const Tensor&)>
+Tensor binary_pointwise_nested(const Tensor& self, const Tensor& other) {
+  auto* nested = nestedOperand(self, other);
+  auto result = Op(
+      packedOperand(self, nested, "binary op"), packedOperand(other, nested, "binary op"));
+  return wrapLike(nested, result);
+}
+
+template <Tensor (*Op)(const Tensor&, const Tensor&, Scalar)>
+Tensor binary_pointwise_alpha_nested(const Tensor& self, const Tensor& other, Scalar alpha) {
+  auto* nested = nestedOperand(self, other);
+  auto result = Op(
+      packedOperand(self, nested, "binary op"), packedOperand(other, nested, "binary op"),
+      alpha);
+  return wrapLike(nested, result);
+}
+
+Tensor& add__nested(Tensor& self, const Tensor& other, Scalar alpha) {
+  auto* self_impl = maybeGetNested(self);
+  TORCH_CHECK(self_impl, "add_: can't add a nested tensor in-place to a dense tensor");
+  self_impl->buffer().add_(packedOperand(other, self_impl, "add_"), alpha);
+  return self;
+}
+
+Tensor& mul__nested(Tensor& self, const Tensor& other) {
+  auto* self_impl = maybeGetNested(self);
+  TORCH_CHECK(self_impl, "mul_: can't multiply a dense tensor in-place by a nested tensor");
+  self_impl->buffer().mul_(packedOperand(other, self_impl, "mul_"));
+  return self;
+}
+
+Tensor contiguous_nested(const Tensor& self, MemoryFormat memory_format) {
+  // The buffer is what gets computed on, and every kernel produces a new one.
+  return self;
+}
+
+std::vector<Tensor> unbind_nested(const Tensor& self, int64_t dim) {
+  TORCH_CHECK(maybe_wrap_dim(dim, self.dim()) == 0,
+      "unbind: nested tensors can only be unbound along the batch dim");
+  auto* self_impl = unsafeGetNested(self);
+  std::vector<Tensor> components;
+  components.reserve(self_impl->num_components());
+  for (int64_t i = 0; i < self_impl->num_components(); i++) {
+    components.push_back(self_impl->component(i));
+  }
+  return components;
+}
+
+Tensor to_padded_tensor_nested(const Tensor& self, double padding) {
+  auto* self_impl = unsafeGetNested(self);
+  const auto& buffer = self_impl->buffer();
+  const auto padded_length = self.size(1);
+  auto rows_size = buffer.sizes().vec();
+  rows_size[0] = self_impl->num_components() * padded_length;
+  auto padded = at::full(rows_size, padding, buffer.options());
+  padded = padded.index_copy(
+      0, nestedPaddedRowIndices(self_impl->offsets(), padded_length, buffer.device()),
+      buffer);
+  return padded.view(self.sizes());
+}
+
+Tensor linear_nested(const Tensor& input, const Tensor& weight, const Tensor& bias) {
+  checkDense(weight, "linear", "weight");
+  TORCH_CHECK(!bias.defined() || !isNested(bias),
+      "linear: expected a dense bias, but got a nested tensor");
+  TORCH_CHECK(input.dim() > kNumOuterDims,
+      "linear: expected a nested input with features past the ragged dim, but got "
+      "padded size ", input.sizes());
+  auto* input_impl = unsafeGetNested(input);
+  return wrapLike(input_impl, at::linear(input_impl->buffer(), weight, bias));
+}
+
+Tensor matmul_nested(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(isNested(self) && !isNested(other) && other.dim() >= 1 && other.dim() <= 2,
+      "matmul: nested tensors can only be multiplied by a dense vector or matrix "
+      "on the right");
+  TORCH_CHECK(self.dim() > kNumOuterDims,
+      "matmul: expected a nested tensor with a dim past the ragged dim to multiply, "
+      "but got padded size ", self.sizes());
+  auto* self_impl = unsafeGetNested(self);
+  return wrapLike(self_impl, at::matmul(self_impl->buffer(), other));
+}
+
+Tensor layer_norm_nested(
+    const Tensor& input, IntArrayRef normalized_shape, const Tensor& weight,
+    const Tensor& bias, double eps, bool cudnn_enable) {
+  TORCH_CHECK(
+      static_cast<int64_t>(normalized_shape.size()) <= input.dim() - kNumOuterDims,
+      "layer_norm: nested tensors can only be normalized over the dims past the "
+      "ragged dim, but got normalized_shape ", normalized_shape,
+      " for padded size ", input.sizes());
+  TORCH_CHECK((!weight.defined() || !isNested(weight)) && (!bias.defined() || !isNested(bias)),
+      "layer_norm: expected a dense weight and bias, but got a nested tensor");
+  auto* input_impl = unsafeGetNested(input);
+  return wrapLike(
+      input_impl,
+      at::layer_norm(input_impl->buffer(), normalized_shape, weight, bias, eps, cudnn_enable));
+}
+
+template <Tensor (*Op)(const Tensor&, int64_t, c10::optional<ScalarType>)>
+Tensor softmax_nested(const Tensor& self, int64_t dim, c10::optional<ScalarType> dtype) {
+  auto* self_impl = unsafeGetNested(self);
+  const auto buffer_dim = innerDim(self, dim, "softmax");
+  if (buffer_dim > 0) {
+    return wrapLike(self_impl, Op(self_impl->buffer(), buffer_dim, dtype));
+  }
+  // Along the ragged dim, each component is normalized on its own, with no
+  // padding to mask out.
+  std::vector<Tensor> results;
+  results.reserve(self_impl->num_components());
+  for (int64_t i = 0; i < self_impl->num_components(); i++) {
+    results.push_back(Op(self_impl->component(i), 0, dtype));
+  }
+  return wrapLike(
+      self_impl, catComponents(results, Op(self_impl->buffer(), 0, dtype)));
+}
+
+Tensor dropout_nested(const Tensor& input, double p, bool train) {
+  auto* input_impl = unsafeGetNested(input);
+  return wrapLike(input_impl, at::dropout(input_impl->buffer(), p, train));
+}
+
+Tensor embedding_nested(
+    const Tensor& weight, const Tensor& indices, int64_t padding_idx,
+    bool scale_grad_by_freq, bool sparse) {
+  checkDense(weight, "embedding", "weight");
+  auto* indices_impl = unsafeGetNested(indices);
+  return wrapLike(
+      indices_impl,
+      at::embedding(weight, indices_impl->buffer(), padding_idx, scale_grad_by_freq, sparse));
+}
+
+// Each query component attends to the key and value component of the same
+// index; see at::native::nested_attention for the dense computation.
+Tensor nested_attention_nested(
+    const Tensor& query, const Tensor& key, const Tensor& value, c10::optional<double> scale) {
+  auto* query_impl = maybeGetNested(query);
+  auto* key_impl = maybeGetNested(key);
+  auto* value_impl = maybeGetNested(value);
+  TORCH_CHECK(query_impl && key_impl && value_impl,
+      "nested_attention: expected the query, key and value to be all nested or all dense");
+  TORCH_CHECK(
+      query_impl->num_components() == key_impl->num_components() &&
+          key_impl->offsets() == value_impl->offsets(),
+      "nested_attention: expected as many query components as key components, and keys "
+      "and values with the same component lengths");
+  std::vector<Tensor> results;
+  results.reserve(query_impl->num_components());
+  for (int64_t i = 0; i < query_impl->num_components(); i++) {
+    results.push_back(at::nested_attention(
+        query_impl->component(i).unsqueeze(0),
+        key_impl->component(i).unsqueeze(0),
+        value_impl->component(i).unsqueeze(0),
+        scale).squeeze(0));
+  }
+  auto empty_size = value_impl->buffer().sizes().vec();
+  empty_size[0] = 0;
+  return wrapLike(
+      query_impl, catComponents(results, value_impl->buffer().new_empty(empty_size)));
+}
+
+void nestedTensorFallback(const c10::OperatorHandle& op, torch::jit::Stack* stack) {
+  TORCH_CHECK(false, op.schema().name(), " is not supported for nested tensors; "
+      "convert them with to_padded_tensor() first");
+}
+
+} // namespace
+
+TORCH_LIBRARY_IMPL(_, NestedTensor, m) {
+  m.fallback(torch::CppFunction::makeFromBoxedFunction<&nestedTensorFallback>());
+}
+
+TORCH_LIBRARY_IMPL(aten, NestedTensor, m) {
+  // NB: Like BatchedTensor, a NestedTensor only has the NestedTensor dispatch
+  // key on it, so operators that only need sizes() call the underlying
+  // implementation directly.
+  m.impl("size.int", static_cast<int64_t (*)(const Tensor&, int64_t)>(native::size));
+  m.impl("contiguous", contiguous_nested);
+  m.impl("unbind.int", unbind_nested);
+  m.impl("to_padded_tensor", to_padded_tensor_nested);
+
+  // unary pointwise ops
+#define UNARY_POINTWISE(op) m.impl(#op, unary_pointwise_nested<at::op>);
+  UNARY_POINTWISE(abs);
+  UNARY_POINTWISE(cos);
+  UNARY_POINTWISE(exp);
+  UNARY_POINTWISE(gelu);
+  UNARY_POINTWISE(log);
+  UNARY_POINTWISE(neg);
+  UNARY_POINTWISE(reciprocal);
+  UNARY_POINTWISE(relu);
+  UNARY_POINTWISE(rsqrt);
+  UNARY_POINTWISE(sigmoid);
+  UNARY_POINTWISE(sin);
+  UNARY_POINTWISE(sqrt);
+  UNARY_POINTWISE(tanh);
+#undef UNARY_POINTWISE
+
+  // binary pointwise ops
+  m.impl("add.Tensor", binary_pointwise_alpha_nested<at::add>);
+  m.impl("sub.Tensor", binary_pointwise_alpha_nested<at::sub>);
+  m.impl_UNBOXED("mul.Tensor", binary_pointwise_nested<at::mul>);
+  m.impl("div.Tensor", binary_pointwise_nested<at::div>);
+  m.impl_UNBOXED("add_.Tensor", add__nested);
+  m.impl_UNBOXED("mul_.Tensor", mul__nested);
+
+  m.impl_UNBOXED("linear", linear_nested);
+  m.impl("matmul", matmul_nested);
+  m.impl_UNBOXED("layer_norm", layer_norm_nested);
+  m.impl("softmax.int", softmax_nested<at::softmax>);
+  m.impl("log_softmax.int", softmax_nested<at::log_softmax>);
+  m.impl("dropout", dropout_nested);
+  m.impl("embedding", embedding_nested);
+  m.impl("nested_attention", nested_attention_nested);
+}
+
+} // namespace at
@@ -16,4 +16,14 @@ public:
       }) {}
 };
 
+class CAFFE2_API PTWorkStealingThreadPool
+    : public c10::WorkStealingThreadPool {
+public:
+  explicit PTWorkStealingThreadPool(int pool_size)
+    : c10::WorkStealingThreadPool(pool_size, [](){
+        c10::setThreadName("PTThreadPool");
+        at::init_num_threads();
+      }) {}
+};
+
 } // namespace at
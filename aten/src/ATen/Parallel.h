@@ -131,6 +131,11 @@ CAFFE2_API int get_num_interop_threads();
 CAFFE2_API void launch(std::function<void()> func);
 namespace internal {
 void launch_no_thread_state(std::function<void()> fn);
+
+// Runs one of the pending inter-op tasks on the calling thread, if there is
+// any, and returns whether it did. Used to help instead of blocking when
+// waiting for the result of an inter-op task.
+CAFFE2_API bool run_pending_interop_task();
 } // namespace internal
 
 // Launches intra-op parallel task
@@ -143,6 +148,24 @@ CAFFE2_API std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
 // Returns number of intra-op threads used by default
 CAFFE2_API int intraop_default_num_threads();
 
+// Returns number of inter-op threads used by default
+CAFFE2_API int interop_default_num_threads();
+
+namespace internal {
+// The numbers of threads read from the file the ATEN_THREAD_CONFIG
+// environment variable points to, 0 where it doesn't set one. The file holds
+// `key=value` lines, e.g. as written by binaries/thread_config_tuner:
+//   intra_op_threads=4
+//   inter_op_threads=2
+// The OMP_NUM_THREADS and MKL_NUM_THREADS variables take precedence over
+// intra_op_threads, and set_num_threads / set_num_interop_threads over both.
+struct ThreadConfig {
+  int intra_op_threads{0};
+  int inter_op_threads{0};
+};
+CAFFE2_API const ThreadConfig& thread_config();
+} // namespace internal
+
 } // namespace at
 
 #if AT_PARALLEL_OPENMP
@@ -3,7 +3,9 @@
 #include <ATen/Config.h>
 #include <ATen/PTThreadPool.h>
 #include <ATen/Version.h>
+#include <c10/util/numa.h>
 
+#include <fstream>
 #include <sstream>
 #include <thread>
 
@@ -40,8 +42,53 @@ size_t get_env_num_threads(const char* var_name, size_t def_value = 0) {
   return def_value;
 }
 
+internal::ThreadConfig read_thread_config() {
+  internal::ThreadConfig config;
+  const char* path = std::getenv("ATEN_THREAD_CONFIG");
+  if (path == nullptr || *path == '\0') {
+    return config;
+  }
+  std::ifstream file(path);
+  if (!file) {
+    TORCH_WARN("Can't open the thread config ATEN_THREAD_CONFIG=", path);
+    return config;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    const auto eq = line.find('=');
+    if (line.empty() || line[0] == '#' || eq == std::string::npos) {
+      continue;
+    }
+    const auto key = line.substr(0, eq);
+    int* value = nullptr;
+    if (key == "intra_op_threads") {
+      value = &config.intra_op_threads;
+    } else if (key == "inter_op_threads") {
+      value = &config.inter_op_threads;
+    } else {
+      // Other keys are left to the tools that share the file.
+      continue;
+    }
+    try {
+      *value = c10::stoi(line.substr(eq + 1));
+      TORCH_CHECK(*value > 0);
+    } catch (const std::exception& e) {
+      *value = 0;
+      TORCH_WARN("Invalid ", key, " in the thread config ", path, ", ", e.what());
+    }
+  }
+  return config;
+}
+
 } // namespace
 
+namespace internal {
+const ThreadConfig& thread_config() {
+  static const ThreadConfig config = read_thread_config();
+  return config;
+}
+} // namespace internal
+
 std::string get_parallel_info() {
   std::ostringstream ss;
 
@@ -65,15 +112,29 @@ std::string get_parallel_info() {
   ss << "std::thread::hardware_concurrency() : "
      << std::thread::hardware_concurrency() << std::endl;
 
+  ss << "NUMA: ";
+  if (c10::IsNUMAPartitioned()) {
+    ss << "partitioned over " << c10::GetNumNUMANodes() << " nodes";
+  } else if (c10::IsNUMAEnabled()) {
+    ss << "enabled";
+  } else {
+    ss << "disabled";
+  }
+  ss << std::endl;
+
   ss << "Environment variables:" << std::endl;
   ss << "\tOMP_NUM_THREADS : "
      << get_env_var("OMP_NUM_THREADS", "[not set]") << std::endl;
   ss << "\tMKL_NUM_THREADS : "
      << get_env_var("MKL_NUM_THREADS", "[not set]") << std::endl;
+  ss << "\tATEN_THREAD_CONFIG : "
+     << get_env_var("ATEN_THREAD_CONFIG", "[not set]") << std::endl;
 
   ss << "ATen parallel backend: ";
   #if AT_PARALLEL_OPENMP
   ss << "OpenMP";
+  #elif AT_PARALLEL_WORK_STEALING
+  ss << "native thread pool with work stealing";
   #elif AT_PARALLEL_NATIVE
   ss << "native thread pool";
   #elif AT_PARALLEL_NATIVE_TBB
@@ -85,7 +146,7 @@ std::string get_parallel_info() {
   ss << std::endl;
 
   #if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
-  ss << "Experimental: single thread pool" << std::endl;
+  ss << "Experimental: single thread pool with nested parallelism" << std::endl;
   #endif
 
   return ss.str();
@@ -98,7 +159,8 @@ int intraop_default_num_threads() {
   // call this API for mobile.
   TORCH_CHECK(false, "Undefined intraop_default_num_threads on mobile.");
 #else
-  size_t nthreads = get_env_num_threads("OMP_NUM_THREADS", 0);
+  size_t nthreads = internal::thread_config().intra_op_threads;
+  nthreads = get_env_num_threads("OMP_NUM_THREADS", nthreads);
   nthreads = get_env_num_threads("MKL_NUM_THREADS", nthreads);
   if (nthreads == 0) {
     nthreads = TaskThreadPoolBase::defaultNumThreads();
@@ -107,4 +169,12 @@ int intraop_default_num_threads() {
 #endif
 }
 
+int interop_default_num_threads() {
+  const int nthreads = internal::thread_config().inter_op_threads;
+  if (nthreads > 0) {
+    return nthreads;
+  }
+  return TaskThreadPoolBase::defaultNumThreads();
+}
+
 } // namespace at
@@ -65,24 +65,54 @@ int _num_pool_threads(int nthreads) {
   return nthreads - 1;
 }
 
+std::shared_ptr<TaskThreadPoolBase> _create_intraop_pool() {
+  int pool_size = _num_pool_threads(num_intraop_threads.exchange(CONSUMED));
+  // Under the partitioned NUMA policy every node gets its own set of workers,
+  // as long as there are enough threads to go around.
+  if (c10::IsNUMAPartitioned() && pool_size >= c10::GetNumNUMANodes()) {
+    return std::make_shared<NUMAThreadPool>(
+        pool_size, c10::GetNumNUMANodes(), []() {
+          c10::setThreadName("PTThreadPool");
+          at::init_num_threads();
+        });
+  }
+  return ThreadPoolRegistry()->Create(
+      "C10",
+      /* device_id */ 0,
+      /* pool_size */ pool_size,
+      /* create_new */ true); // create a separate thread pool for intra-op
+}
+
 TaskThreadPoolBase& _get_intraop_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
-          /* create_new */ true); // create a separate thread pool for intra-op
+  static std::shared_ptr<TaskThreadPoolBase> pool = _create_intraop_pool();
   return *pool;
 }
 
+// Returns the intra-op pool if it is partitioned over NUMA nodes, nullptr
+// otherwise.
+NUMAThreadPool* _get_numa_intraop_pool() {
+  static NUMAThreadPool* numa_pool =
+      dynamic_cast<NUMAThreadPool*>(&_get_intraop_pool());
+  return numa_pool;
+}
+
 #endif // C10_MOBILE
 
 // Run lambda function `fn` over `task_id` in [0, `range`) with threadpool.
 // `fn` will be called with params: (thread_pool_task_id, task_id).
 void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
 #ifndef C10_MOBILE
-  for (size_t i = 1; i < range; ++i) {
-    _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
+  if (NUMAThreadPool* numa_pool = _get_numa_intraop_pool()) {
+    // Send task i to the node holding the i-th slab of partitioned
+    // allocations (see c10::GetNUMANodeForPartition).
+    for (size_t i = 1; i < range; ++i) {
+      numa_pool->runOnNode(
+          c10::GetNUMANodeForPartition(i, range), [fn, i]() { fn((int)i, i); });
+    }
+  } else {
+    for (size_t i = 1; i < range; ++i) {
+      _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
+    }
   }
   // Run the first task on the current thread directly.
   fn(0, 0);
@@ -99,19 +129,88 @@ void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
 #endif // C10_MOBILE
 }
 
+// Note [Cooperative nested parallelism]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default a parallel_for inside a parallel region (or inside a task the
+// intra-op pool runs for intraop_launch) runs serially on the calling thread.
+// With EXPERIMENTAL_SINGLE_THREAD_POOL, inter-op tasks (at::launch) run on the
+// intra-op pool as well, so a forked branch would never get more than one
+// core. In that mode nested loops are split into tasks like top level ones.
+//
+// A pool thread that blocked waiting for its tasks could deadlock the pool:
+// if every worker does, nobody is left to run the queued tasks. So tasks are
+// claimed before they run, and once the calling thread is done with its own
+// task it claims and runs every task no worker has started yet. It only ever
+// waits for tasks that are already running on other threads. Idle workers
+// thus get recruited, and a busy pool degrades to serial execution on the
+// calling thread. Queued tasks that lost the race to the calling thread
+// return immediately when a worker gets to them.
+
 // RAII guard helps to support in_parallel_region() and get_thread_num() API.
+// The previous values are restored on exit, as nested parallel regions can
+// run on a thread that is itself in a parallel region.
 struct ParallelRegionGuard {
-  ParallelRegionGuard(int64_t task_id) {
+  ParallelRegionGuard(int64_t task_id)
+      : prev_thread_num_(thread_num_),
+        prev_in_parallel_region_(in_parallel_region_) {
     _set_thread_num(task_id);
     _set_in_parallel_region(true);
   }
 
   ~ParallelRegionGuard() {
-    _set_in_parallel_region(false);
-    _unset_thread_num();
+    _set_in_parallel_region(prev_in_parallel_region_);
+    _set_thread_num(prev_thread_num_);
   }
+
+ private:
+  const size_t prev_thread_num_;
+  const bool prev_in_parallel_region_;
 };
 
+// Run `fn` over `task_id` in [0, `num_tasks`) with threadpool and wait for
+// all of them, running those no pool thread has started on the current
+// thread. See Note [Cooperative nested parallelism].
+void _run_cooperatively(
+    const std::function<void(size_t)>& fn, size_t num_tasks) {
+  struct Job {
+    const std::function<void(size_t)>* fn;
+    std::unique_ptr<std::atomic<bool>[]> claimed;
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t remaining;
+
+    void run(size_t task_id) {
+      if (claimed[task_id].exchange(true)) {
+        return;
+      }
+      (*fn)(task_id);
+      std::unique_lock<std::mutex> lk(mutex);
+      if (--remaining == 0) {
+        cv.notify_one();
+      }
+    }
+  };
+  // Shared with the queued pool tasks, which may outlive this call.
+  auto job = std::make_shared<Job>();
+  job->fn = &fn;
+  job->claimed.reset(new std::atomic<bool>[num_tasks]());
+  job->remaining = num_tasks;
+
+  _run_with_pool(
+      [job](int /* unused */, size_t task_id) { job->run(task_id); },
+      num_tasks);
+  // Pool threads take tasks in increasing order, start from the other end.
+  for (size_t task_id = num_tasks; task_id-- > 1;) {
+    job->run(task_id);
+  }
+
+  // Wait for the tasks that are running on other threads.
+  std::unique_lock<std::mutex> lk(job->mutex);
+  while (job->remaining != 0) {
+    job->cv.wait(lk);
+  }
+}
+
 } // namespace
 
 namespace internal {
@@ -130,13 +229,9 @@ void _parallel_run(
   struct {
     std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
     std::exception_ptr eptr;
-    std::mutex mutex;
-    volatile size_t remaining;
-    std::condition_variable cv;
   } state;
 
-  auto task = [f, &state, begin, end, chunk_size]
-      (int /* unused */, size_t task_id) {
+  auto task = [&f, &state, begin, end, chunk_size](size_t task_id) {
     int64_t local_start = begin + task_id * chunk_size;
     if (local_start < end) {
       int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
@@ -149,28 +244,121 @@ void _parallel_run(
         }
       }
     }
-    {
-      std::unique_lock<std::mutex> lk(state.mutex);
-      if (--state.remaining == 0) {
-        state.cv.notify_one();
+  };
+  _run_cooperatively(task, num_tasks);
+
+  if (state.eptr) {
+    std::rethrow_exception(state.eptr);
+  }
+}
+
+#if AT_PARALLEL_WORK_STEALING
+
+namespace {
+
+// Owners take chunks of at least 1/kStealingChunkDivisor of what is left in
+// their range, so that most of it stays available to thieves.
+constexpr int64_t kStealingChunkDivisor = 8;
+
+// The part of the range a worker has not started yet. The owner takes chunks
+// off the front, thieves split off the back half.
+struct StealingSlot {
+  std::mutex mutex;
+  int64_t begin = 0;
+  int64_t end = 0;
+  // keep the slots of different workers on different cache lines
+  char padding[64];
+};
+
+} // namespace
+
+void _parallel_run_stealing(
+  const int64_t begin,
+  const int64_t end,
+  const int64_t grain_size,
+  const std::function<void(int64_t, int64_t)>& f) {
+  at::internal::lazy_init_num_threads();
+
+  const int64_t grain = std::max(grain_size, (int64_t)1);
+  size_t num_tasks, chunk_size;
+  std::tie(num_tasks, chunk_size) =
+      internal::calc_num_tasks_and_chunk_size(begin, end, grain);
+
+  // Every worker starts out with the chunk the static schedule would give it.
+  std::vector<StealingSlot> slots(num_tasks);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    slots[i].begin = begin + i * chunk_size;
+    slots[i].end = std::min(end, (int64_t)(slots[i].begin + chunk_size));
+  }
+
+  struct {
+    std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
+    std::exception_ptr eptr;
+    std::atomic<bool> stop{false};
+  } state;
+
+  auto take = [&slots, grain](size_t id, int64_t& start, int64_t& stop) {
+    StealingSlot& slot = slots[id];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    const int64_t left = slot.end - slot.begin;
+    if (left <= 0) {
+      return false;
+    }
+    start = slot.begin;
+    stop = start + std::min(left, std::max(grain, left / kStealingChunkDivisor));
+    slot.begin = stop;
+    return true;
+  };
+
+  auto steal = [&slots, grain, num_tasks](size_t id) {
+    StealingSlot& mine = slots[id];
+    for (size_t k = 1; k < num_tasks; ++k) {
+      StealingSlot& victim = slots[(id + k) % num_tasks];
+      std::lock(victim.mutex, mine.mutex);
+      std::lock_guard<std::mutex> victim_lock(victim.mutex, std::adopt_lock);
+      std::lock_guard<std::mutex> mine_lock(mine.mutex, std::adopt_lock);
+      const int64_t left = victim.end - victim.begin;
+      // Leave the victim at least one grain, and take at least one.
+      if (left >= 2 * grain) {
+        const int64_t mid = victim.end - left / 2;
+        mine.begin = mid;
+        mine.end = victim.end;
+        victim.end = mid;
+        return true;
       }
     }
+    return false;
   };
-  state.remaining = num_tasks;
-  _run_with_pool(task, num_tasks);
-
-  // Wait for all tasks to finish.
-  {
-    std::unique_lock<std::mutex> lk(state.mutex);
-    if (state.remaining != 0) {
-      state.cv.wait(lk);
+
+  auto task = [&f, &state, &take, &steal](size_t task_id) {
+    ParallelRegionGuard guard(task_id);
+    int64_t start, stop;
+    while (!state.stop.load(std::memory_order_relaxed)) {
+      if (!take(task_id, start, stop)) {
+        if (steal(task_id)) {
+          continue;
+        }
+        break;
+      }
+      try {
+        f(start, stop);
+      } catch (...) {
+        if (!state.err_flag.test_and_set()) {
+          state.eptr = std::current_exception();
+        }
+        state.stop.store(true, std::memory_order_relaxed);
+      }
     }
-  }
+  };
+  _run_cooperatively(task, num_tasks);
+
   if (state.eptr) {
     std::rethrow_exception(state.eptr);
   }
 }
 
+#endif // AT_PARALLEL_WORK_STEALING
+
 } // namespace internal
 
 void init_num_threads() {
@@ -249,9 +437,26 @@ bool in_parallel_region() {
 #endif // C10_MOBILE
 }
 
+namespace {
+
+#ifndef C10_MOBILE
+// Whether intraop_launch should run `func` on the calling thread.
+bool _launch_inline() {
+#if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
+  // at::launch goes through intraop_launch, so tasks forked from a pool
+  // thread still need to go to the pool to run concurrently.
+  return get_num_threads() <= 1;
+#else
+  return in_parallel_region() || get_num_threads() <= 1;
+#endif
+}
+#endif // C10_MOBILE
+
+} // namespace
+
 void intraop_launch(std::function<void()> func) {
 #ifndef C10_MOBILE
-  if (!in_parallel_region() && get_num_threads() > 1) {
+  if (!_launch_inline()) {
     _get_intraop_pool().run(func);
   } else {
     // execute inline if we're in parallel region
@@ -268,7 +473,7 @@ std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
     std::function<void()> func) {
 #ifndef C10_MOBILE
   auto future = std::make_shared<c10::ivalue::Future>(c10::NoneType::get());
-  if (!in_parallel_region() && get_num_threads() > 1) {
+  if (!_launch_inline()) {
     _get_intraop_pool().run(
       [func, future]() {
         func();
@@ -28,6 +28,29 @@ CAFFE2_API void _parallel_run(
   const int64_t grain_size,
   const std::function<void(int64_t, int64_t, size_t)>& f);
 
+#if AT_PARALLEL_WORK_STEALING
+// Like _parallel_run, but f may be called on any number of sub-ranges of
+// [begin, end), each at least grain_size long (except at the end of a
+// range). Threads that run out of work steal half of another thread's
+// remaining range.
+CAFFE2_API void _parallel_run_stealing(
+  const int64_t begin,
+  const int64_t end,
+  const int64_t grain_size,
+  const std::function<void(int64_t, int64_t)>& f);
+#endif
+
+// Whether parallel primitives called from inside a parallel region run
+// serially on the calling thread. With a single thread pool nested loops
+// recruit idle workers instead, see Note [Cooperative nested parallelism].
+inline bool _run_nested_serially() {
+#if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
+  return false;
+#else
+  return in_parallel_region();
+#endif
+}
+
 } // namespace internal
 
 template <class F>
@@ -40,10 +63,20 @@ inline void parallel_for(
   if (begin >= end) {
     return;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size || internal::_run_nested_serially()) {
     f(begin, end);
     return;
   }
+#if AT_PARALLEL_WORK_STEALING
+  internal::_parallel_run_stealing(
+      begin,
+      end,
+      grain_size,
+      [f](int64_t start, int64_t end) {
+        f(start, end);
+      }
+  );
+#else
   internal::_parallel_run(
       begin,
       end,
@@ -52,6 +85,7 @@ inline void parallel_for(
         f(start, end);
       }
   );
+#endif
 }
 
 template <class scalar_t, class F, class SF>
@@ -66,9 +100,11 @@ inline scalar_t parallel_reduce(
   if (begin >= end) {
     return ident;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size || internal::_run_nested_serially()) {
     return f(begin, end, ident);
   }
+  // Reductions keep the static partitioning even with work stealing, so that
+  // partial results are combined in order and the result is deterministic.
   size_t num_tasks, chunk_size;
   std::tie(num_tasks, chunk_size) =
       internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
@@ -8,6 +8,10 @@
 #include <mkl.h>
 #endif
 
+#ifdef USE_PTHREADPOOL
+#include <caffe2/utils/threadpool/pthreadpool-cpp.h>
+#endif
+
 namespace at {
 
 namespace {
@@ -20,6 +24,8 @@ void init_num_threads() {
   auto nthreads = num_threads.load();
   if (nthreads > 0) {
     set_num_threads(nthreads);
+  } else if (internal::thread_config().intra_op_threads > 0) {
+    set_num_threads(intraop_default_num_threads());
   } else {
 #if defined(_OPENMP) && defined(TH_BLAS_MKL) && !defined(TH_BLAS_MKL_SEQ)
     // If we are using MKL an OpenMP make sure the number of threads match.
@@ -49,6 +55,13 @@ void set_num_threads(int nthreads) {
   // See https://github.com/pytorch/pytorch/issues/13757
   mkl_set_dynamic(false);
 #endif
+#ifdef USE_PTHREADPOOL
+  // QNNPACK and XNNPACK run on the pthreadpool, which otherwise keeps one
+  // thread per core however many threads the user asked for.
+  caffe2::PThreadPool* const pool = caffe2::pthreadpool();
+  TORCH_INTERNAL_ASSERT(pool, "Invalid thread pool!");
+  pool->set_thread_count(nthreads);
+#endif
 }
 
 // Explicitly calling omp_get_max_threads() as the size of the parallel
@@ -19,6 +19,10 @@ const int CONSUMED = -2;
 // NOT_SET -> CONSUMED
 std::atomic<int> num_interop_threads{NOT_SET};
 
+int _num_pool_threads(int nthreads) {
+  return nthreads == NOT_SET ? interop_default_num_threads() : nthreads;
+}
+
 // thread pool global instance is hidden,
 // users should use at::launch and get/set_num_interop_threads interface
 TaskThreadPoolBase& get_pool() {
@@ -26,7 +30,8 @@ TaskThreadPoolBase& get_pool() {
       ThreadPoolRegistry()->Create(
           "C10",
           /* device_id */ 0,
-          /* pool_size */ num_interop_threads.exchange(CONSUMED),
+          /* pool_size */ _num_pool_threads(
+              num_interop_threads.exchange(CONSUMED)),
           /* create_new */ true);
   return *pool;
 }
@@ -40,7 +45,7 @@ std::shared_ptr<TaskThreadPoolBase> create_c10_threadpool(
   TORCH_CHECK(device_id == 0);
   // Create new thread pool
   TORCH_CHECK(create_new);
-  return std::make_shared<PTThreadPool>(pool_size);
+  return std::make_shared<PTWorkStealingThreadPool>(pool_size);
 }
 
 } // namespace
@@ -62,7 +67,7 @@ int get_num_interop_threads() {
     return nthreads;
   } else if (nthreads == NOT_SET) {
     // return default value
-    return TaskThreadPoolBase::defaultNumThreads();
+    return interop_default_num_threads();
   } else {
     return get_pool().size();
   }
@@ -76,6 +81,20 @@ void launch_no_thread_state(std::function<void()> fn) {
   get_pool().run(std::move(fn));
 #endif
 }
+
+bool run_pending_interop_task() {
+#if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
+  return false;
+#else
+  // Don't create the pool if nothing was launched yet
+  if (num_interop_threads.load() != CONSUMED) {
+    return false;
+  }
+  static auto* pool =
+      dynamic_cast<c10::WorkStealingThreadPool*>(&get_pool());
+  return pool && pool->runPendingTask();
+#endif
+}
 } // namespace internal
 
 void launch(std::function<void()> func) {
@@ -10,6 +10,10 @@ namespace at {
 
 // Thread local state contains values that are preserved across
 // thread boundaries (e.g. at::launch/JIT fork, autograd, at::parallel_for)
+//
+// Capturing and restoring it is cheap: the debug info and the callbacks are
+// immutable and shared by pointer, and both are nullptr unless a profiler or
+// DebugInfoGuard is active.
 class TORCH_API ThreadLocalState {
  public:
   // Saves the thread local variables' values and
@@ -30,8 +34,8 @@ class TORCH_API ThreadLocalState {
   // with DebugInfoGuard
   std::shared_ptr<c10::ThreadLocalDebugInfo> debug_info_;
 
-  // RecordFunction TLS callbacks
-  RecordFunctionCallbacks callbacks_;
+  // RecordFunction TLS callbacks, shared with the thread that captured them
+  std::shared_ptr<const RecordFunctionCallbacks> callbacks_;
 
   bool observers_enabled_ = false;
 
@@ -55,11 +55,6 @@ VmapPhysicalView MultiBatchVmapTransform::logicalToPhysical(const Tensor& logica
   return { permuteBatchDimsToFront(batched), createLevelsBitset(batched->bdims()) };
 }
 
-std::vector<VmapPhysicalView>
-MultiBatchVmapTransform::logicalToPhysical(TensorList logical_tensors) {
-  TORCH_INTERNAL_ASSERT(false, "NYI");
-}
-
 int64_t VmapPhysicalView::numBatchDims() {
   return levels_.count();
 }
@@ -198,6 +193,41 @@ getLevelsAndLargestLogicalDim(TensorList logical_tensors) {
   return { levels, largest_logical_dim };
 }
 
+std::vector<VmapPhysicalView>
+MultiBatchVmapTransform::logicalToPhysical(TensorList logical_tensors) {
+  std::bitset<kVmapNumLevels> levels;
+  std::tie(levels, std::ignore) = getLevelsAndLargestLogicalDim(logical_tensors);
+  const int64_t num_batch_dims = levels.count();
+
+  // Give every tensor a batch dim for each of the levels (of size 1 for the
+  // levels it isn't batched over) but leave its example dims alone, then
+  // expand the size-1 batch dims to the batch sizes of the other tensors.
+  // For example, given inputs of size (B0, 2) and (B1, 3) at levels 0 and 1,
+  // this returns views of size (B0, B1, 2) and (B0, B1, 3).
+  std::vector<Tensor> aligned_tensors;
+  aligned_tensors.reserve(logical_tensors.size());
+  VmapDimVector batch_sizes(num_batch_dims, 1);
+  for (const auto& tensor : logical_tensors) {
+    auto aligned = alignBatchDimsAtFront(tensor, levels, /*logical dim*/tensor.dim());
+    for (int64_t bdim = 0; bdim < num_batch_dims; bdim++) {
+      if (aligned.size(bdim) != 1) {
+        batch_sizes[bdim] = aligned.size(bdim);
+      }
+    }
+    aligned_tensors.push_back(std::move(aligned));
+  }
+
+  std::vector<VmapPhysicalView> result;
+  result.reserve(aligned_tensors.size());
+  for (const auto& aligned : aligned_tensors) {
+    VmapDimVector expanded_sizes(batch_sizes.begin(), batch_sizes.end());
+    auto example_sizes = aligned.sizes().slice(num_batch_dims);
+    expanded_sizes.insert(expanded_sizes.end(), example_sizes.begin(), example_sizes.end());
+    result.emplace_back(aligned.expand(expanded_sizes), levels);
+  }
+  return result;
+}
+
 VmapPhysicalViewVec BroadcastingVmapTransform::logicalToPhysical(TensorList logical_tensors) {
   TORCH_INTERNAL_ASSERT(
       logical_tensors.size() == 2,
@@ -50,7 +50,13 @@ using VmapDimVector = SmallVector<int64_t, kVmapStaticDimVecSize>;
 // Given one or more logical views on Tensors, `logicalToPhysical` 
 // permutes all of the batch dims to the front of the tensor, aligns
 // and expands the batch dims to match each other (according to their `level`),
-// and returns a VmapPhysicalView on the tensor(s).
+// and returns a VmapPhysicalView on the tensor(s). Unlike BroadcastingVmapTransform,
+// the non-batch dims are left as they are.
+//
+// The TensorList overload also accepts regular Tensors, which are treated
+// as being batched over none of the levels. For example, given inputs of size
+// (B0, 2, 3) and (3, 4) where B0 is a batch dimension, it returns
+// VmapPhysicalViews wrapping tensors of size (B0, 2, 3) and (B0, 3, 4).
 struct TORCH_API MultiBatchVmapTransform {
   static VmapPhysicalView logicalToPhysical(const Tensor& logical_tensor);
   static std::vector<VmapPhysicalView> logicalToPhysical(TensorList logical_tensors);
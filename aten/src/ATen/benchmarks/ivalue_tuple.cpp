@@ -0,0 +1,81 @@
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/serialization/pickle.h>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts the heap allocations of the benchmarked code, reported per
+// iteration.
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+static void reportAllocations(benchmark::State& state, size_t start) {
+  state.counters["allocs"] = benchmark::Counter(
+      static_cast<double>(allocations.load() - start),
+      benchmark::Counter::kAvgIterations);
+}
+
+static void tuple_create(benchmark::State& state) {
+  at::Tensor a = at::rand({2, 2});
+  at::Tensor b = at::rand({2, 2});
+  const size_t start = allocations.load();
+  for (auto _ : state) {
+    auto tuple = c10::ivalue::Tuple::create(a, b);
+    benchmark::DoNotOptimize(tuple);
+  }
+  reportAllocations(state, start);
+}
+
+static void tuple_unpack(benchmark::State& state) {
+  at::Tensor a = at::rand({2, 2});
+  at::Tensor b = at::rand({2, 2});
+  const size_t start = allocations.load();
+  for (auto _ : state) {
+    c10::IValue tuple = std::make_tuple(a, b);
+    auto unpacked = tuple.to<std::tuple<at::Tensor, at::Tensor>>();
+    benchmark::DoNotOptimize(unpacked);
+  }
+  reportAllocations(state, start);
+}
+
+static void unpickle_dicts(benchmark::State& state) {
+  c10::impl::GenericList list(c10::DictType::create(
+      c10::StringType::get(), c10::IntType::get()));
+  for (int64_t i = 0; i < state.range(0); i++) {
+    c10::Dict<std::string, int64_t> dict;
+    dict.insert("input_ids", i);
+    dict.insert("attention_mask", i);
+    dict.insert("token_type_ids", i);
+    list.push_back(dict);
+  }
+  const std::vector<char> data = torch::jit::pickle(list);
+  const size_t start = allocations.load();
+  for (auto _ : state) {
+    c10::IValue value = torch::jit::unpickle(data.data(), data.size());
+    benchmark::DoNotOptimize(value);
+  }
+  reportAllocations(state, start);
+}
+
+BENCHMARK(tuple_create);
+BENCHMARK(tuple_unpack);
+BENCHMARK(unpickle_dicts)->Arg(16)->Arg(256);
+BENCHMARK_MAIN();
@@ -23,6 +23,13 @@ const DispatchKeySet always_included{DispatchKey::Autograd, DispatchKey::Backend
 //
 // Unlike Tensor::key_set(), the value of this on a tensor can change depending
 // on TLS.
+static inline DispatchKey dispatchTypeId(
+    DispatchKeySet ks,
+    DispatchKeySet key_mask,
+    c10::impl::LocalDispatchKeySet local) {
+  return (((ks | local.included_ | always_included) - local.excluded_) & key_mask).highestPriorityTypeId();
+}
+
 static inline DispatchKey dispatchTypeId(
     DispatchKeySet ks,
     // The key mask lets us eliminate (by zero entries) keys which should not
@@ -39,13 +46,12 @@ static inline DispatchKey dispatchTypeId(
     // function (as opposed to just applying it to the input 'ks').
     DispatchKeySet key_mask
 ) {
-  c10::impl::LocalDispatchKeySet local = c10::impl::tls_local_dispatch_key_set();
   // TODO: It's a bit irritating that we have to do logical ORs here, it would
   // be nice to only do one.  Can always_included be folded into the TLS?  Well,
   // it's a bit troublesome, because fastpath TLS access requires the type of
   // the TLS in question to be zero-initialized, so you don't actually win
   // anyting in that case.
-  return (((ks | local.included_ | always_included) - local.excluded_) & key_mask).highestPriorityTypeId();
+  return dispatchTypeId(ks, key_mask, c10::impl::tls_local_dispatch_key_set());
 }
 
 }
@@ -141,6 +147,12 @@ public:
     return dispatchKeySetToDispatchKey_(eligibleKeys, ks);
   }
 
+  // Like getDispatchKeyUnboxed with DispatchKeySet::FULL, for the key set of
+  // the arguments and the thread local state already at hand
+  DispatchKey getDispatchKey(DispatchKeySet ks, c10::impl::LocalDispatchKeySet local) const {
+    return impl::dispatchTypeId(ks, nonFallthroughKeys_, local);
+  }
+
   void setOperatorHasFallthroughForKey(DispatchKey k, bool has_fallthrough);
 
   std::string dumpState() const;
@@ -38,6 +38,29 @@ class RegistrationListenerList;
 }
 class SchemaRegistrationHandleRAII;
 
+/**
+ * Remembers the kernel an operator call site dispatched to, see
+ * Dispatcher::callCached. The kernel is reused as long as the call site is
+ * given tensors with the same dispatch keys, under the same thread local
+ * included/excluded keys, and the dispatch table of the operator isn't
+ * updated by a registration.
+ *
+ * It isn't thread safe, so each thread needs its own:
+ *
+ *   static thread_local c10::DispatchCache cache;
+ *   return op.callCached(cache, self, other);
+ */
+struct DispatchCache final {
+  const impl::OperatorEntry* op = nullptr;
+  // Dispatch table version of op, see OperatorEntry::dispatchTableVersion
+  uint64_t version = 0;
+  DispatchKeySet arg_keys;
+  DispatchKeySet tls_included;
+  DispatchKeySet tls_excluded;
+  DispatchKey dispatch_key = DispatchKey::Undefined;
+  const KernelFunction* kernel = nullptr;
+};
+
 /**
  * Top-level dispatch interface for dispatching via the dynamic dispatcher.
  * Most end users shouldn't use this directly; if you're trying to register
@@ -132,6 +155,11 @@ public:
   template<class Return, class... Args>
   Return redispatch(const TypedOperatorHandle<Return (Args...)>& op, DispatchKey currentDispatchKey, Args... args) const;
 
+  // Like call, but reuses the kernel resolved by the previous call with the
+  // same cache when nothing that affects dispatch changed. See DispatchCache.
+  template<class Return, class... Args>
+  Return callCached(const TypedOperatorHandle<Return (Args...)>& op, DispatchCache& cache, Args... args) const;
+
   // Invoke an operator via the boxed calling convention using an IValue stack
   void callBoxed(const OperatorHandle& op, Stack* stack) const;
 
@@ -227,6 +255,10 @@ private:
   void cleanup(const OperatorHandle& op, const OperatorName& op_name);
   void checkSchemaCompatibility(const OperatorHandle& op, const FunctionSchema& schema, const std::string& debug);
 
+  // Calls the kernel resolved for dispatchKey, running the RecordFunction callbacks
+  template<class Return, class... Args>
+  Return callKernel_(const TypedOperatorHandle<Return (Args...)>& op, const KernelFunction& kernel, DispatchKey dispatchKey, Args... args) const;
+
   std::list<OperatorDef> operators_;
   LeftRight<ska::flat_hash_map<OperatorName, OperatorHandle>> operatorLookupTable_;
   // Map from namespace to debug string (saying, e.g., where the library was defined)
@@ -325,6 +357,10 @@ public:
     return c10::Dispatcher::singleton().callWithDispatchKey<Return, Args...>(*this, dispatchKey, std::forward<Args>(args)...);
   }
 
+  Return callCached(DispatchCache& cache, Args... args) const {
+    return c10::Dispatcher::singleton().callCached<Return, Args...>(*this, cache, std::forward<Args>(args)...);
+  }
+
 private:
   explicit TypedOperatorHandle(std::list<Dispatcher::OperatorDef>::iterator operatorIterator)
   : OperatorHandle(std::move(operatorIterator)) {}
@@ -339,6 +375,12 @@ template<class Return, class... Args>
 inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(Args...)>& op, DispatchKey dispatchKey, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
   const KernelFunction& kernel = op.operatorIterator_->op.lookup(dispatchKey);
+  return callKernel_<Return, Args...>(op, kernel, dispatchKey, std::forward<Args>(args)...);
+}
+
+template<class Return, class... Args>
+inline Return Dispatcher::callKernel_(const TypedOperatorHandle<Return(Args...)>& op, const KernelFunction& kernel, DispatchKey dispatchKey, Args... args) const {
+  detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
 
   // Check if we need to run callbacks registered with RecordFunction
   // If true and callbacks need inputs, we box the arguments and pass
@@ -379,6 +421,32 @@ inline Return Dispatcher::call(const TypedOperatorHandle<Return(Args...)>& op, A
   return callWithDispatchKey<Return, Args...>(op, dispatchKey, args...);
 }
 
+template<class Return, class... Args>
+inline Return Dispatcher::callCached(const TypedOperatorHandle<Return(Args...)>& op, DispatchCache& cache, Args... args) const {
+  detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
+  const auto& entry = op.operatorIterator_->op;
+  // Read first: if the table changes from now on, the next call misses
+  auto version = entry.dispatchTableVersion();
+  auto arg_keys = detail::multi_dispatch_key_set(args...);
+  impl::LocalDispatchKeySet local = impl::tls_local_dispatch_key_set();
+  if (C10_UNLIKELY(
+        cache.op != &entry || cache.version != version ||
+        !(cache.arg_keys == arg_keys) ||
+        !(cache.tls_included == local.included_) ||
+        !(cache.tls_excluded == local.excluded_))) {
+    auto dispatchKey = entry.dispatchKeyExtractor().getDispatchKey(arg_keys, local);
+    // The table entries don't move, only their content changes
+    cache.kernel = &entry.lookup(dispatchKey);
+    cache.dispatch_key = dispatchKey;
+    cache.op = &entry;
+    cache.version = version;
+    cache.arg_keys = arg_keys;
+    cache.tls_included = local.included_;
+    cache.tls_excluded = local.excluded_;
+  }
+  return callKernel_<Return, Args...>(op, *cache.kernel, cache.dispatch_key, std::forward<Args>(args)...);
+}
+
 template<class Return, class... Args>
 inline Return Dispatcher::redispatch(const TypedOperatorHandle<Return (Args...)>& op, DispatchKey currentDispatchKey, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
@@ -15,6 +15,7 @@
 
 #include <list>
 #include <array>
+#include <atomic>
 
 namespace c10 {
 
@@ -169,6 +170,11 @@ public:
 
   [[noreturn]] void reportError(DispatchKey dispatchKey) const;
 
+  // Changes whenever the dispatch table is updated, see DispatchCache
+  uint64_t dispatchTableVersion() const {
+    return dispatchTableVersion_.load(std::memory_order_acquire);
+  }
+
   const KernelFunction& lookup(DispatchKey k) const {
     const auto& kernel = dispatchTable_[static_cast<uint8_t>(k)];
     if (C10_UNLIKELY(!kernel.isValid())) {
@@ -186,6 +192,8 @@ private:
 
   std::array<KernelFunction, static_cast<uint8_t>(DispatchKey::NumDispatchKeys)> dispatchTable_;
   DispatchKeyExtractor dispatchKeyExtractor_;
+  // Starts at 1, 0 means empty for DispatchCache
+  std::atomic<uint64_t> dispatchTableVersion_ {1};
 
   // This manuallyBoxedKernel_ member is a temporary hack that allows generated_unboxing_wrappers.cpp to register its codegen'ed
   // unboxing wrapper for aten operators. We still need those for some operators because not all work
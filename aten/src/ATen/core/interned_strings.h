@@ -96,6 +96,10 @@ namespace c10 {
   _(prim, ConstantChunk)             \
   _(prim, MMTreeReduce)              \
   _(prim, MMBatchSide)               \
+  _(prim, BatchedLinear)             \
+  _(prim, BatchedConv2d)             \
+  _(prim, BatchedEmbeddingBag)       \
+  _(prim, BatchedPointwise)          \
   _(prim, min)                       \
   _(prim, max)                       \
   _(prim, abs)                       \
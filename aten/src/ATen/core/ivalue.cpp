@@ -40,9 +40,9 @@ bool operator==(const ivalue::Tuple& lhs, const ivalue::Tuple& rhs) {
   return lhs.elements_.size() == rhs.elements_.size() &&
       // see [container equality]
       std::equal(
-             lhs.elements_.cbegin(),
-             lhs.elements_.cend(),
-             rhs.elements_.cbegin(),
+             lhs.elements_.begin(),
+             lhs.elements_.end(),
+             rhs.elements_.begin(),
              _fastEqualsForContainer);
 }
 
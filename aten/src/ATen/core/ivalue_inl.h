@@ -174,51 +174,253 @@ struct CAFFE2_API ConstantString final : c10::intrusive_ptr_target {
 
 struct Future;
 
+// The elements of a Tuple. Up to kMaxInlineSize of them, like the
+// (Tensor, Tensor) a method returns, are stored inline instead of in a
+// std::vector, so that creating the Tuple takes a single allocation.
+// Reads like a const std::vector<IValue>, and converts to one.
+class TupleElements {
+ public:
+  static constexpr size_t kMaxInlineSize = 3;
+
+  using value_type = IValue;
+  using const_iterator = const IValue*;
+  using iterator = const_iterator;
+
+  TupleElements() : inlineSize_(0) {
+    new (&elementsVector_) std::vector<IValue>();
+  }
+
+  explicit TupleElements(std::vector<IValue> elements) : inlineSize_(0) {
+    new (&elementsVector_) std::vector<IValue>(std::move(elements));
+  }
+
+  explicit TupleElements(IValue&& e1) : inlineSize_(1) {
+    new (&elementsInline_[0]) IValue(std::move(e1));
+  }
+
+  TupleElements(IValue&& e1, IValue&& e2) : inlineSize_(2) {
+    new (&elementsInline_[0]) IValue(std::move(e1));
+    new (&elementsInline_[1]) IValue(std::move(e2));
+  }
+
+  TupleElements(IValue&& e1, IValue&& e2, IValue&& e3) : inlineSize_(3) {
+    new (&elementsInline_[0]) IValue(std::move(e1));
+    new (&elementsInline_[1]) IValue(std::move(e2));
+    new (&elementsInline_[2]) IValue(std::move(e3));
+  }
+
+  TupleElements(const TupleElements& rhs) : inlineSize_(rhs.inlineSize_) {
+    if (inlineSize_) {
+      for (size_t i = 0; i < inlineSize_; i++) {
+        new (&elementsInline_[i]) IValue(rhs.elementsInline_[i]);
+      }
+    } else {
+      new (&elementsVector_) std::vector<IValue>(rhs.elementsVector_);
+    }
+  }
+
+  TupleElements(TupleElements&& rhs) noexcept {
+    moveFrom(std::move(rhs));
+  }
+
+  TupleElements& operator=(const TupleElements& rhs) {
+    if (this != &rhs) {
+      TupleElements copy(rhs);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  TupleElements& operator=(TupleElements&& rhs) noexcept {
+    if (this != &rhs) {
+      destroy();
+      moveFrom(std::move(rhs));
+    }
+    return *this;
+  }
+
+  ~TupleElements() {
+    destroy();
+  }
+
+  size_t size() const {
+    return inlineSize_ ? inlineSize_ : elementsVector_.size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  const IValue* data() const {
+    return inlineSize_ ? elementsInline_ : elementsVector_.data();
+  }
+
+  const_iterator begin() const {
+    return data();
+  }
+
+  const_iterator end() const {
+    return data() + size();
+  }
+
+  const IValue& operator[](size_t idx) const {
+    return data()[idx];
+  }
+
+  IValue& operator[](size_t idx) {
+    return inlineSize_ ? elementsInline_[idx] : elementsVector_[idx];
+  }
+
+  const IValue& at(size_t idx) const {
+    TORCH_CHECK_INDEX(
+        idx < size(),
+        "Tuple index ",
+        idx,
+        " out of range for a tuple of size ",
+        size());
+    return data()[idx];
+  }
+
+  const IValue& front() const {
+    return at(0);
+  }
+
+  const IValue& back() const {
+    return at(size() - 1);
+  }
+
+  c10::ArrayRef<IValue> asArrayRef() const {
+    return c10::ArrayRef<IValue>(data(), size());
+  }
+
+  operator c10::ArrayRef<IValue>() const {
+    return asArrayRef();
+  }
+
+  std::vector<IValue> vec() const & {
+    return std::vector<IValue>(begin(), end());
+  }
+
+  std::vector<IValue> vec() && {
+    if (!inlineSize_) {
+      return std::move(elementsVector_);
+    }
+    std::vector<IValue> result;
+    result.reserve(inlineSize_);
+    for (size_t i = 0; i < inlineSize_; i++) {
+      result.push_back(std::move(elementsInline_[i]));
+    }
+    return result;
+  }
+
+  operator std::vector<IValue>() const & {
+    return vec();
+  }
+
+  operator std::vector<IValue>() && {
+    return std::move(*this).vec();
+  }
+
+ private:
+  void moveFrom(TupleElements&& rhs) noexcept {
+    inlineSize_ = rhs.inlineSize_;
+    if (inlineSize_) {
+      for (size_t i = 0; i < inlineSize_; i++) {
+        new (&elementsInline_[i]) IValue(std::move(rhs.elementsInline_[i]));
+      }
+    } else {
+      new (&elementsVector_)
+          std::vector<IValue>(std::move(rhs.elementsVector_));
+    }
+  }
+
+  void destroy() {
+    if (inlineSize_) {
+      for (size_t i = 0; i < inlineSize_; i++) {
+        elementsInline_[i].~IValue();
+      }
+    } else {
+      elementsVector_.~vector();
+    }
+  }
+
+  // 0 when the elements are in elementsVector_
+  size_t inlineSize_;
+  union {
+    std::vector<IValue> elementsVector_;
+    IValue elementsInline_[kMaxInlineSize];
+  };
+};
+
 struct CAFFE2_API Tuple : c10::intrusive_ptr_target {
  private:
-  std::vector<IValue> elements_;
+  TupleElements elements_;
   mutable std::shared_ptr<TupleType> type_; // lazily computed for unnamed tuples
 
+  static TupleElements makeElements(IValue&& e1) {
+    return TupleElements(std::move(e1));
+  }
+  static TupleElements makeElements(IValue&& e1, IValue&& e2) {
+    return TupleElements(std::move(e1), std::move(e2));
+  }
+  static TupleElements makeElements(IValue&& e1, IValue&& e2, IValue&& e3) {
+    return TupleElements(std::move(e1), std::move(e2), std::move(e3));
+  }
+  template <typename... Args>
+  static TupleElements makeElements(Args&&... elements) {
+    return TupleElements(
+        std::vector<IValue>{IValue(std::forward<Args>(elements))...});
+  }
+
  public:
   // named tuples have additional type information, so we
   // directly create them tagged
   static c10::intrusive_ptr<Tuple> createNamed(
       std::vector<IValue> elements_,
       std::shared_ptr<TupleType> type_) {
-    return c10::make_intrusive<Tuple>(std::move(elements_), type_);
+    return c10::make_intrusive<Tuple>(
+        TupleElements(std::move(elements_)), type_);
   }
   static c10::intrusive_ptr<Tuple> create(std::vector<IValue> elements_) {
-    return c10::make_intrusive<Tuple>(std::move(elements_));
+    return c10::make_intrusive<Tuple>(TupleElements(std::move(elements_)));
   }
 
+  // Stores up to TupleElements::kMaxInlineSize elements inline.
   template <typename... Args>
   static c10::intrusive_ptr<Tuple> create(Args... elements_) {
-    return c10::make_intrusive<Tuple>(std::vector<IValue>{IValue(elements_)...});
+    return c10::make_intrusive<Tuple>(
+        makeElements(IValue(std::move(elements_))...));
   }
 
- const std::vector<IValue>& elements() const & {
+  const TupleElements& elements() const & {
     return elements_;
   }
-  operator const std::vector<IValue>&() const {
+  operator const TupleElements&() const {
     return elements();
   }
 
-  std::vector<IValue>& elements() & {
-    return elements_;
+  TupleElements elements() && {
+    return std::move(elements_);
   }
-  operator std::vector<IValue>&() {
-    return elements();
+
+  size_t size() const {
+    return elements_.size();
   }
 
-  std::vector<IValue>&& elements() && {
-    return std::move(elements_);
+  void setElements(std::vector<IValue>&& elements) {
+    elements_ = TupleElements(std::move(elements));
   }
+
+  void unsafeSetElement(size_t idx, IValue element) {
+    elements_[idx] = std::move(element);
+  }
+
   std::shared_ptr<TupleType> type() const;
 
   friend bool operator==(const ivalue::Tuple& lhs, const ivalue::Tuple& rhs);
 
  private:
-  Tuple(std::vector<IValue> elements, std::shared_ptr<TupleType> type = nullptr)
+  Tuple(TupleElements elements, std::shared_ptr<TupleType> type = nullptr)
     : elements_(std::move(elements)), type_(std::move(type)) {}
 
   friend class c10::intrusive_ptr<Tuple>;
@@ -1587,6 +1587,57 @@ TEST(NewOperatorRegistrationTest, dispatch) {
   }
 }
 
+TEST(NewOperatorRegistrationTest, callCached) {
+  int cpu_calls = 0;
+  int cuda_calls = 0;
+  auto m = MAKE_TORCH_LIBRARY(test);
+  m.def("fn(Tensor self) -> Tensor");
+  auto m_cpu = MAKE_TORCH_LIBRARY_IMPL(test, CPU);
+  m_cpu.impl("fn", [&](const Tensor& x) { cpu_calls++; return x; });
+
+  auto op = Dispatcher::singleton().findSchema({"test::fn", ""});
+  ASSERT_TRUE(op.has_value());
+  auto typed_op = op->typed<Tensor(const Tensor&)>();
+  c10::DispatchCache cache;
+  auto cpu_tensor = dummyTensor(c10::DispatchKey::CPU);
+  typed_op.callCached(cache, cpu_tensor);
+  typed_op.callCached(cache, cpu_tensor);
+  EXPECT_EQ(cpu_calls, 2);
+  EXPECT_EQ(cache.dispatch_key, c10::DispatchKey::CPU);
+
+  // Different arguments miss the cache
+  expectThrows<c10::Error>([&] {
+    typed_op.callCached(cache, dummyTensor(c10::DispatchKey::CUDA));
+  }, "Could not run 'test::fn' with arguments from the 'CUDA' backend");
+
+  {
+    // So does a registration
+    auto m_cuda = MAKE_TORCH_LIBRARY_IMPL(test, CUDA);
+    m_cuda.impl("fn", [&](const Tensor& x) { cuda_calls++; return x; });
+    typed_op.callCached(cache, dummyTensor(c10::DispatchKey::CUDA));
+    EXPECT_EQ(cuda_calls, 1);
+
+    // And a change of the thread local state
+    typed_op.callCached(cache, cpu_tensor);
+    EXPECT_EQ(cpu_calls, 3);
+    {
+      c10::impl::IncludeDispatchKeyGuard guard(c10::DispatchKey::CUDA);
+      typed_op.callCached(cache, cpu_tensor);
+      EXPECT_EQ(cuda_calls, 2);
+    }
+    typed_op.callCached(cache, cpu_tensor);
+    EXPECT_EQ(cpu_calls, 4);
+    typed_op.callCached(cache, dummyTensor(c10::DispatchKey::CUDA));
+    EXPECT_EQ(cuda_calls, 3);
+  }
+
+  // The CUDA kernel is gone
+  expectThrows<c10::Error>([&] {
+    typed_op.callCached(cache, dummyTensor(c10::DispatchKey::CUDA));
+  }, "Could not run 'test::fn' with arguments from the 'CUDA' backend");
+  EXPECT_EQ(cuda_calls, 3);
+}
+
 TEST(NewOperatorRegistrationTest, dispatchMultiple) {
   bool cpu_called = false;
   bool cuda_called = false;
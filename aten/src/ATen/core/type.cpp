@@ -541,9 +541,49 @@ TensorTypePtr TensorType::merge(TensorTypePtr other, bool merge_sizes) const {
       undef);
 }
 
-template <typename T>
-bool is_null_or_equal(c10::optional<T> a, c10::IntArrayRef b) {
-  return !a.has_value() || a.value() == b;
+// The dims that are known have to match, the symbolic ones match any size
+static bool matchSizes(const VaryingShape<int64_t>& a, c10::IntArrayRef b) {
+  if (!a.size().has_value()) {
+    return true;
+  }
+  if (*a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < b.size(); i++) {
+    if (a[i].has_value() && *a[i] != b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Same for the stride properties, merging the profiles of tensors of
+// different sizes leaves some of them unknown
+static bool matchStrideProps(
+    const VaryingShape<Stride>& a,
+    const VaryingShape<Stride>& b) {
+  if (!a.size().has_value()) {
+    return true;
+  }
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < *a.size(); i++) {
+    if (!a[i].has_value()) {
+      continue;
+    }
+    if (!b[i].has_value()) {
+      return false;
+    }
+    const Stride& as = *a[i];
+    const Stride& bs = *b[i];
+    if ((as.stride_index_ && as.stride_index_ != bs.stride_index_) ||
+        (as.contiguous_ && as.contiguous_ != bs.contiguous_) ||
+        (as.stride_ && as.stride_ != bs.stride_)) {
+      return false;
+    }
+  }
+  return true;
 }
 
 bool TensorType::matchTensor(const at::Tensor& t) {
@@ -562,12 +602,12 @@ bool TensorType::matchTensor(const at::Tensor& t) {
   // Here we know t.defined() == true and compare all other properties.
   bool rg = at::GradMode::is_enabled() && t.requires_grad();
   bool matched_strides = (!t.has_storage() && !stride_properties().isComplete())
-    || stride_properties() == computeStrideProps(t.sizes(), t.strides(), t.is_contiguous());
+    || matchStrideProps(stride_properties(), computeStrideProps(t.sizes(), t.strides(), t.is_contiguous()));
   return scalarType().value_or(t.scalar_type()) == t.scalar_type()
     && device().value_or(t.device()) == t.device()
     && requiresGrad().value_or(rg) == rg
     && matched_strides
-    && is_null_or_equal(sizes().concrete_sizes(), t.sizes());
+    && matchSizes(sizes(), t.sizes());
 }
 
 bool TensorType::operator==(const c10::Type& rhs) const {
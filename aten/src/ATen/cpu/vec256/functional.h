@@ -8,12 +8,13 @@
 namespace at { namespace vec256 {
 
 // TODO: Make this more efficient
-template <typename scalar_t, typename Op>
+// The trailing Vec template parameter lets vec512/functional.h reuse these
+// loops with a wider vector type; callers here never need to spell it.
+template <typename scalar_t, typename Op, typename Vec = vec256::Vec256<scalar_t>>
 inline scalar_t vec_reduce_all(
     const Op& vec_fun,
-    vec256::Vec256<scalar_t> acc_vec,
+    Vec acc_vec,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
   scalar_t acc_arr[Vec::size()];
   acc_vec.store(acc_arr);
   for (int64_t i = 1; i < size; i++) {
@@ -26,11 +27,10 @@ inline scalar_t vec_reduce_all(
   return acc_arr[0];
 }
 
-template <typename scalar_t, typename Op>
+template <typename scalar_t, typename Op, typename Vec = vec256::Vec256<scalar_t>>
 inline scalar_t reduce_all(const Op& vec_fun, scalar_t* data, int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
   if (size < Vec::size())
-    return vec_reduce_all(vec_fun, Vec::loadu(data, size), size);
+    return vec_reduce_all<scalar_t>(vec_fun, Vec::loadu(data, size), size);
   int64_t d = Vec::size();
   Vec acc_vec = Vec::loadu(data);
   for (; d < size - (size % Vec::size()); d += Vec::size()) {
@@ -41,18 +41,17 @@ inline scalar_t reduce_all(const Op& vec_fun, scalar_t* data, int64_t size) {
     Vec data_vec = Vec::loadu(data + d, size - d);
     acc_vec = Vec::set(acc_vec, vec_fun(acc_vec, data_vec), size - d);
   }
-  return vec_reduce_all(vec_fun, acc_vec, Vec::size());
+  return vec_reduce_all<scalar_t>(vec_fun, acc_vec, Vec::size());
 }
 
-template <typename scalar_t, typename MapOp, typename ReduceOp>
+template <typename scalar_t, typename MapOp, typename ReduceOp, typename Vec = vec256::Vec256<scalar_t>>
 inline scalar_t map_reduce_all(
     const MapOp& map_fun,
     const ReduceOp& red_fun,
     scalar_t* data,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
   if (size < Vec::size())
-    return vec_reduce_all(red_fun, map_fun(Vec::loadu(data, size)), size);
+    return vec_reduce_all<scalar_t>(red_fun, map_fun(Vec::loadu(data, size)), size);
   int64_t d = Vec::size();
   Vec acc_vec = map_fun(Vec::loadu(data));
   for (; d < size - (size % Vec::size()); d += Vec::size()) {
@@ -65,22 +64,21 @@ inline scalar_t map_reduce_all(
     data_vec = map_fun(data_vec);
     acc_vec = Vec::set(acc_vec, red_fun(acc_vec, data_vec), size - d);
   }
-  return vec_reduce_all(red_fun, acc_vec, Vec::size());
+  return vec_reduce_all<scalar_t>(red_fun, acc_vec, Vec::size());
 }
 
-template <typename scalar_t, typename MapOp, typename ReduceOp>
+template <typename scalar_t, typename MapOp, typename ReduceOp, typename Vec = vec256::Vec256<scalar_t>>
 inline scalar_t map2_reduce_all(
     const MapOp& map_fun,
     const ReduceOp& red_fun,
     const scalar_t* data,
     const scalar_t* data2,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
   if (size < Vec::size()) {
     Vec data_vec = Vec::loadu(data, size);
     Vec data2_vec = Vec::loadu(data2, size);
     data_vec = map_fun(data_vec, data2_vec);
-    return vec_reduce_all(red_fun, data_vec, size);
+    return vec_reduce_all<scalar_t>(red_fun, data_vec, size);
   }
   int64_t d = Vec::size();
   Vec acc_vec = map_fun(Vec::loadu(data), Vec::loadu(data2));
@@ -96,16 +94,15 @@ inline scalar_t map2_reduce_all(
     data_vec = map_fun(data_vec, data2_vec);
     acc_vec = Vec::set(acc_vec, red_fun(acc_vec, data_vec), size - d);
   }
-  return vec_reduce_all(red_fun, acc_vec, Vec::size());
+  return vec_reduce_all<scalar_t>(red_fun, acc_vec, Vec::size());
 }
 
-template <typename scalar_t, typename Op>
+template <typename scalar_t, typename Op, typename Vec = vec256::Vec256<scalar_t>>
 inline void map(
     const Op& vec_fun,
     scalar_t* output_data,
     const scalar_t* input_data,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
   int64_t d = 0;
   for (; d < size - (size % Vec::size()); d += Vec::size()) {
     Vec output_vec = vec_fun(Vec::loadu(input_data + d));
@@ -117,14 +114,13 @@ inline void map(
   }
 }
 
-template <typename scalar_t, typename Op>
+template <typename scalar_t, typename Op, typename Vec = vec256::Vec256<scalar_t>>
 inline void map2(
     const Op& vec_fun,
     scalar_t* output_data,
     scalar_t* input_data,
     scalar_t* input_data2,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
   int64_t d = 0;
   for (; d < size - (size % Vec::size()); d += Vec::size()) {
     Vec data_vec = Vec::loadu(input_data + d);
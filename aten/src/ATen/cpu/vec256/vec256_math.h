@@ -0,0 +1,164 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <cfloat>
+#include <cmath>
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// Note [Vectorized math accuracy]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The transcendental member functions of the vector types (exp(), tanh(),
+// erf(), ...) are accurate to 1 ULP for float and double; with AVX/AVX2 they
+// call the u10 variants of Sleef. Kernels dominated by these functions can
+// go through VecMath instead and pick an accuracy tier:
+//
+//   using Math = VecMath<scalar_t, MathAccuracy::Fast>;
+//   Vec256<scalar_t> y = Math::gelu(x);
+//
+// MathAccuracy::High is exactly the member functions. MathAccuracy::Fast
+// swaps in a cheaper approximation where one exists for the element type
+// and is the High version otherwise; today that means float only. Max
+// errors of the float Fast versions, measured over a dense sweep of the
+// finite inputs:
+//
+//   tanh     odd rational approximation          5 ULP
+//   erf      odd rational approximation          6 ULP (absolute error
+//                                                below 5e-7)
+//   sigmoid  refined vrcpps instead of division  4 ULP, results below
+//                                                FLT_MIN flush to zero
+//                                                (AVX/AVX2 only)
+//   gelu     the Fast erf
+//
+// The trailing Vec template parameter selects the vector type, so the same
+// code serves Vec256, vec512::Vec512 and the generic fallbacks.
+//
+// Fast is never the default. Kernels only use it when the user opted in
+// with at::globalContext().setAllowFastMathCPU(true).
+
+enum class MathAccuracy : uint8_t {
+  High,
+  Fast
+};
+
+// 1 / a for positive a; see VecMath<..., Fast>::sigmoid
+template <typename Vec>
+inline Vec fast_reciprocal(const Vec& a) {
+  return a.reciprocal();
+}
+
+#if (defined(CPU_CAPABILITY_AVX) || defined(CPU_CAPABILITY_AVX2)) && !defined(_MSC_VER)
+
+// vrcpps is good to 12 bits; one Newton step takes it to within 2 ULP.
+// Inputs above 2^126 give 0.
+inline Vec256<float> fast_reciprocal(const Vec256<float>& a) {
+  const __m256 x = _mm256_min_ps(_mm256_set1_ps(FLT_MAX), a);
+  const __m256 r = _mm256_rcp_ps(x);
+#ifdef CPU_CAPABILITY_AVX2
+  const __m256 e = _mm256_fnmadd_ps(x, r, _mm256_set1_ps(1.f));
+  return _mm256_fmadd_ps(r, e, r);
+#else
+  return _mm256_mul_ps(r, _mm256_sub_ps(_mm256_set1_ps(2.f), _mm256_mul_ps(x, r)));
+#endif
+}
+
+#endif
+
+template <typename scalar_t, MathAccuracy accuracy, typename Vec = Vec256<scalar_t>>
+struct VecMath {
+  static Vec exp(const Vec& a) {
+    return a.exp();
+  }
+  static Vec log(const Vec& a) {
+    return a.log();
+  }
+  static Vec tanh(const Vec& a) {
+    return a.tanh();
+  }
+  static Vec erf(const Vec& a) {
+    return a.erf();
+  }
+  static Vec erfc(const Vec& a) {
+    return a.erfc();
+  }
+  static Vec sigmoid(const Vec& a) {
+    const Vec one(static_cast<scalar_t>(1));
+    return (one + a.neg().exp()).reciprocal();
+  }
+  // x * Phi(x), with Phi the standard normal CDF
+  static Vec gelu(const Vec& a) {
+    const Vec alpha(static_cast<scalar_t>(M_SQRT1_2));
+    const Vec half(static_cast<scalar_t>(0.5));
+    const Vec one(static_cast<scalar_t>(1));
+    return a * half * (one + (a * alpha).erf());
+  }
+};
+
+template <typename Vec>
+struct VecMath<float, MathAccuracy::Fast, Vec>
+    : VecMath<float, MathAccuracy::High, Vec> {
+  // tanh(x) = x * p(x^2) / q(x^2) on [-9, 9], where float tanh is +-1 past
+  // the ends. Small inputs return x, which is exact there.
+  static Vec tanh(const Vec& a) {
+    const Vec one(1.f);
+    const Vec x = minimum(maximum(a, Vec(-9.f)), Vec(9.f));
+    const Vec x2 = x * x;
+    Vec p = Vec(-2.76076847742355e-16f);
+    p = fmadd(p, x2, Vec(2.00018790482477e-13f));
+    p = fmadd(p, x2, Vec(-8.60467152213735e-11f));
+    p = fmadd(p, x2, Vec(5.12229709037114e-08f));
+    p = fmadd(p, x2, Vec(1.48572235717979e-05f));
+    p = fmadd(p, x2, Vec(6.37261928875436e-04f));
+    p = fmadd(p, x2, Vec(4.89352455891786e-03f));
+    Vec q = Vec(1.19825839466702e-06f);
+    q = fmadd(q, x2, Vec(1.18534705686654e-04f));
+    q = fmadd(q, x2, Vec(2.26843463243900e-03f));
+    q = fmadd(q, x2, Vec(4.89352518554385e-03f));
+    const Vec r = minimum(maximum(x * (p / q), one.neg()), one);
+    return Vec::blendv(r, a, a.abs() < Vec(0.0004f));
+  }
+
+  // erf(x) = x * p(x^2) / q(x^2) on [-4, 4], where float erf is +-1 past
+  // the ends.
+  static Vec erf(const Vec& a) {
+    const Vec one(1.f);
+    const Vec x = minimum(maximum(a, Vec(-4.f)), Vec(4.f));
+    const Vec x2 = x * x;
+    Vec p = Vec(-2.72614225801306e-10f);
+    p = fmadd(p, x2, Vec(2.77068142495902e-08f));
+    p = fmadd(p, x2, Vec(-2.10102402082508e-06f));
+    p = fmadd(p, x2, Vec(-5.69250639462346e-05f));
+    p = fmadd(p, x2, Vec(-7.34990630326855e-04f));
+    p = fmadd(p, x2, Vec(-2.95459980854025e-03f));
+    p = fmadd(p, x2, Vec(-1.60960333262415e-02f));
+    Vec q = Vec(-1.45660718464996e-05f);
+    q = fmadd(q, x2, Vec(-2.13374055278905e-04f));
+    q = fmadd(q, x2, Vec(-1.68282697438203e-03f));
+    q = fmadd(q, x2, Vec(-7.37332916720468e-03f));
+    q = fmadd(q, x2, Vec(-1.42647390514189e-02f));
+    const Vec r = minimum(maximum((x * p) / q, one.neg()), one);
+    // x * p underflows for tiny x, where erf(x) = 2 / sqrt(pi) * x
+    return Vec::blendv(r, a * Vec(static_cast<float>(M_2_SQRTPI)), a.abs() < Vec(1e-7f));
+  }
+
+  static Vec sigmoid(const Vec& a) {
+    const Vec one(1.f);
+    return fast_reciprocal(one + a.neg().exp());
+  }
+
+  static Vec gelu(const Vec& a) {
+    const Vec alpha(static_cast<float>(M_SQRT1_2));
+    const Vec half(0.5f);
+    const Vec one(1.f);
+    return a * half * (one + erf(a * alpha));
+  }
+};
+
+}}} // namespace at::vec256::<anonymous>
@@ -0,0 +1,62 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec512/vec512.h>
+
+namespace at { namespace vec512 {
+
+// Same as the helpers in vec256/functional.h, but over Vectorized<scalar_t>,
+// so the ops passed in must take and return Vectorized<scalar_t>.
+
+template <typename scalar_t, typename Op>
+inline scalar_t reduce_all(const Op& vec_fun, scalar_t* data, int64_t size) {
+  return vec256::reduce_all<scalar_t, Op, Vectorized<scalar_t>>(
+      vec_fun, data, size);
+}
+
+template <typename scalar_t, typename MapOp, typename ReduceOp>
+inline scalar_t map_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    scalar_t* data,
+    int64_t size) {
+  return vec256::map_reduce_all<scalar_t, MapOp, ReduceOp, Vectorized<scalar_t>>(
+      map_fun, red_fun, data, size);
+}
+
+template <typename scalar_t, typename MapOp, typename ReduceOp>
+inline scalar_t map2_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    const scalar_t* data,
+    const scalar_t* data2,
+    int64_t size) {
+  return vec256::map2_reduce_all<scalar_t, MapOp, ReduceOp, Vectorized<scalar_t>>(
+      map_fun, red_fun, data, data2, size);
+}
+
+template <typename scalar_t, typename Op>
+inline void map(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data,
+    int64_t size) {
+  vec256::map<scalar_t, Op, Vectorized<scalar_t>>(
+      vec_fun, output_data, input_data, size);
+}
+
+template <typename scalar_t, typename Op>
+inline void map2(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    scalar_t* input_data,
+    scalar_t* input_data2,
+    int64_t size) {
+  vec256::map2<scalar_t, Op, Vectorized<scalar_t>>(
+      vec_fun, output_data, input_data, input_data2, size);
+}
+
+}} // namespace at::vec512
@@ -0,0 +1,94 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <ATen/cpu/vec512/vec512_base.h>
+#include <ATen/cpu/vec512/vec512_float.h>
+#include <ATen/cpu/vec512/vec512_double.h>
+
+#include <iostream>
+
+namespace at {
+namespace vec512 {
+
+// Note [Vectorized kernels and AVX512]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Kernels under native/cpu are compiled once per CPU capability (see
+// cmake/Codegen.cmake). The AVX512 copy is also compiled with
+// CPU_CAPABILITY_AVX2 defined, so every Vec256 type keeps its AVX2
+// implementation there. On top of that, float and double get a 512-bit
+// Vec512. A kernel that wants the wider vectors names its vector type as
+//
+//   using Vec = vec512::Vectorized<scalar_t>;
+//
+// which is Vec512<scalar_t> for float and double in the AVX512 copy,
+// and Vec256<scalar_t> for every other type and every other capability.
+// Vec512 has the same interface as Vec256, so the kernel body does not
+// change; only call free functions such as maximum and fmadd unqualified, so
+// that argument dependent lookup picks the right overload.
+
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+template <typename T>
+struct vectorized_type {
+  using type = vec256::Vec256<T>;
+};
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+template <>
+struct vectorized_type<float> {
+  using type = Vec512<float>;
+};
+
+template <>
+struct vectorized_type<double> {
+  using type = Vec512<double>;
+};
+
+template <typename T>
+std::ostream& operator<<(std::ostream& stream, const Vec512<T>& vec) {
+  T buf[Vec512<T>::size()];
+  vec.store(buf);
+  stream << "vec[";
+  for (int i = 0; i != Vec512<T>::size(); i++) {
+    if (i != 0) {
+      stream << ", ";
+    }
+    stream << buf[i];
+  }
+  stream << "]";
+  return stream;
+}
+
+template <typename T>
+inline Vec512<T>& operator += (Vec512<T>& a, const Vec512<T>& b) {
+  a = a + b;
+  return a;
+}
+template <typename T>
+inline Vec512<T>& operator -= (Vec512<T>& a, const Vec512<T>& b) {
+  a = a - b;
+  return a;
+}
+template <typename T>
+inline Vec512<T>& operator /= (Vec512<T>& a, const Vec512<T>& b) {
+  a = a / b;
+  return a;
+}
+template <typename T>
+inline Vec512<T>& operator *= (Vec512<T>& a, const Vec512<T>& b) {
+  a = a * b;
+  return a;
+}
+
+#endif
+
+template <typename T>
+using Vectorized = typename vectorized_type<T>::type;
+
+}}}
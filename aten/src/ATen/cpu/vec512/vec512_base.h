@@ -0,0 +1,30 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <cmath>
+#include <cstdint>
+
+#include <ATen/cpu/vec256/vec256.h>
+
+#if defined(__GNUC__)
+#define __at_align64__ __attribute__((aligned(64)))
+#elif defined(_WIN32)
+#define __at_align64__ __declspec(align(64))
+#else
+#define __at_align64__
+#endif
+
+namespace at {
+namespace vec512 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// Only the float and double specializations exist, and only when the
+// translation unit is compiled for CPU_CAPABILITY_AVX512. Kernels should not
+// name Vec512 directly; use Vectorized<T> from vec512.h, which picks Vec512
+// where it exists and falls back to Vec256 everywhere else.
+template <class T> class Vec512;
+
+}}}
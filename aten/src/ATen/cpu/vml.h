@@ -1,9 +1,11 @@
 #pragma once
 
 #include <ATen/Config.h>
+#include <ATen/Context.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/vec256_math.h>
 #include <c10/util/complex.h>
 
 // This header implements various unary operations using a MKL VML style
@@ -21,6 +23,10 @@
 // When MKL is available it will call into MKL's VML library similar to NumPy
 // If MKL is not available it will use SLEEF.
 
+// With at::globalContext().allowFastMathCPU() set, MKL runs in VML_LA
+// instead of VML_HA mode and the functions built with IMPLEMENT_VML_BUG_FAST
+// use the Fast tier of VecMath. See Note [Vectorized math accuracy]
+
 // This file might be compiled under AVX or AVX2 when called from e.g.
 // UnaryOpsKernel.cpp
 
@@ -104,6 +110,40 @@ inline void vrsqrt(scalar_t* out, scalar_t* in, int64_t size) {
     });                                                                           \
   }
 
+// Like IMPLEMENT_VML_BUG, but uses VecMath's Fast tier when fast math is
+// allowed
+#define IMPLEMENT_VML_BUG_FAST(op)                                                \
+  template <typename scalar_t>                                                    \
+  inline void v##op(scalar_t* out, const scalar_t* in, int64_t size) {            \
+    DL_RUNTIME_BUG(op, scalar_t)                                                  \
+    using Vec = Vec256<scalar_t>;                                                 \
+    const bool fast = at::globalContext().allowFastMathCPU();                     \
+    parallel_for(0, size, 2048, [out, in, fast](int64_t begin, int64_t end) {     \
+      if (fast) {                                                                 \
+        map([](const Vec& x) { return VecMath<scalar_t, MathAccuracy::Fast>::op(x); }, \
+            out + begin,                                                          \
+            in + begin,                                                           \
+            end - begin);                                                         \
+      } else {                                                                    \
+        map([](const Vec& x) { return x.op(); },                                  \
+            out + begin,                                                          \
+            in + begin,                                                           \
+            end - begin);                                                         \
+      }                                                                           \
+    });                                                                           \
+  }                                                                               \
+  template <>                                                                     \
+  inline void v##op<c10::BFloat16>(                                               \
+      c10::BFloat16* out, const c10::BFloat16* in, int64_t size) {                \
+    parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) {           \
+      DL_RUNTIME_BUG_BFLOAT16()                                                   \
+      map([](const Vec256<c10::BFloat16>& x) { return x.op(); },                  \
+          out + begin,                                                            \
+          in + begin,                                                             \
+          end - begin);                                                           \
+    });                                                                           \
+  }
+
 #define IMPLEMENT_VML(op)                                              \
   template <typename scalar_t>                                          \
   inline void v##op(scalar_t* out, const scalar_t* in, int64_t size) {  \
@@ -122,7 +162,7 @@ IMPLEMENT_VML_BUG(atan)
 IMPLEMENT_VML_BUG(ceil)
 IMPLEMENT_VML_BUG(cos)
 // IMPLEMENT_VML_BUG(cosh)
-IMPLEMENT_VML_BUG(erf)
+IMPLEMENT_VML_BUG_FAST(erf)
 IMPLEMENT_VML_BUG(erfc)
 IMPLEMENT_VML(erfinv)
 IMPLEMENT_VML_BUG(exp)
@@ -140,7 +180,7 @@ IMPLEMENT_VML_BUG(sqrt)
 IMPLEMENT_VML_BUG(round)
 IMPLEMENT_VML(rsqrt)
 IMPLEMENT_VML_BUG(tan)
-IMPLEMENT_VML_BUG(tanh)
+IMPLEMENT_VML_BUG_FAST(tanh)
 IMPLEMENT_VML_BUG(trunc)
 IMPLEMENT_VML_BUG(lgamma)
 
@@ -156,10 +196,12 @@ static_assert(
 #define IMPLEMENT_VML_MKL_STUB(op, mklop, type, mkltype)                    \
   template <>                                                           \
   inline void v##op(type * out, const type * in, int64_t size) {          \
+    const auto mode =                                                   \
+        (at::globalContext().allowFastMathCPU() ? VML_LA : VML_HA) |    \
+        VML_FTZDAZ_OFF | VML_ERRMODE_IGNORE;                            \
     int64_t max_mkl_ind = std::numeric_limits<MKL_INT>::max();          \
     if (size <= static_cast<int64_t>(max_mkl_ind)) {                    \
-      vm##mkltype##mklop(                                               \
-          size, in, out, VML_HA | VML_FTZDAZ_OFF | VML_ERRMODE_IGNORE); \
+      vm##mkltype##mklop(size, in, out, mode);                          \
     } else {                                                            \
       MKL_INT ind = 0;                                                  \
       int64_t chunks = size / max_mkl_ind;                              \
@@ -169,13 +211,13 @@ static_assert(
             max_mkl_ind,                                                \
             in + ind * max_mkl_ind,                                     \
             out + ind * max_mkl_ind,                                    \
-            VML_HA | VML_FTZDAZ_OFF | VML_ERRMODE_IGNORE);              \
+            mode);                                                      \
       }                                                                 \
       vm##mkltype##mklop(                                               \
           rest,                                                         \
           in + ind * max_mkl_ind,                                       \
           out + ind * max_mkl_ind,                                      \
-          VML_HA | VML_FTZDAZ_OFF | VML_ERRMODE_IGNORE);                \
+          mode);                                                        \
     }                                                                   \
   }
 
@@ -5,6 +5,16 @@
 #include <ATen/cuda/CUDABlas.h>
 #include <ATen/cuda/Exceptions.h>
 
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+#include <ATen/native/utils/ParamsHash.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <cublasLt.h>
+
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#endif
+
 #define CUDABLAS_POSINT_CHECK(FD, X)         \
   TORCH_CHECK(                               \
       (X > 0 && X <= INT_MAX),               \
@@ -286,6 +296,39 @@ void gemm<at::Half>(CUDABLAS_GEMM_ARGTYPES(at::Half)) {
 #endif
 }
 
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+template <>
+void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  cublasOperation_t opa = _cublasOpFromChar(transa);
+  cublasOperation_t opb = _cublasOpFromChar(transb);
+  float falpha = alpha;
+  float fbeta = beta;
+  _cublasAdjustLdLevel3(transa, transb, m, n, k, &lda, &ldb, &ldc);
+  GEMM_CHECK_ARGVALUES(at::BFloat16);
+  TORCH_CUDABLAS_CHECK(cublasGemmEx(
+      handle,
+      opa,
+      opb,
+      m,
+      n,
+      k,
+      &falpha,
+      a,
+      CUDA_R_16BF,
+      lda,
+      b,
+      CUDA_R_16BF,
+      ldb,
+      &fbeta,
+      c,
+      CUDA_R_16BF,
+      ldc,
+      CUDA_R_32F,
+      CUBLAS_GEMM_DFALT_TENSOR_OP));
+}
+#endif
+
 #ifdef __HIP_PLATFORM_HCC__
 template <>
 void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16)) {
@@ -324,6 +367,342 @@ void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16)) {
 }
 #endif
 
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+namespace {
+
+template <typename T, cublasStatus_t (*destructor)(T*)>
+struct CuBlasLtDeleter {
+  void operator()(T* x) {
+    // Like the cuBLAS handles, the descriptors may outlive the CUDA context
+    // at exit, so the status of the destruction is ignored.
+    if (x != nullptr) {
+      destructor(x);
+    }
+  }
+};
+
+using CuBlasLtMatmulDescriptor = std::unique_ptr<
+    cublasLtMatmulDescOpaque_t,
+    CuBlasLtDeleter<cublasLtMatmulDescOpaque_t, &cublasLtMatmulDescDestroy>>;
+using CuBlasLtMatrixLayout = std::unique_ptr<
+    cublasLtMatrixLayoutOpaque_t,
+    CuBlasLtDeleter<cublasLtMatrixLayoutOpaque_t, &cublasLtMatrixLayoutDestroy>>;
+using CuBlasLtMatmulPreference = std::unique_ptr<
+    cublasLtMatmulPreferenceOpaque_t,
+    CuBlasLtDeleter<
+        cublasLtMatmulPreferenceOpaque_t,
+        &cublasLtMatmulPreferenceDestroy>>;
+
+// The workspace the cuBLASLt heuristics may pick algorithms for.
+constexpr size_t kCuBlasLtWorkspaceBytes = 1024 * 1024;
+
+// Everything the descriptors and the algorithm of a matmul depend on. The
+// algorithm also depends on the alignment of the pointers, up to 16 bytes.
+// Hashed and compared as bytes, so it is zeroed before being filled in.
+struct CuBlasLtMatmulKey {
+  int device;
+  cublasComputeType_t compute_type;
+  cudaDataType_t ab_type;
+  cudaDataType_t c_type;
+  bool transpose_mat1;
+  bool transpose_mat2;
+  int64_t m;
+  int64_t n;
+  int64_t k;
+  int64_t mat1_ld;
+  int64_t mat2_ld;
+  int64_t result_ld;
+  cublasLtEpilogue_t epilogue;
+  uint32_t alignment;
+};
+
+struct CuBlasLtMatmul {
+  CuBlasLtMatmulDescriptor descriptor;
+  CuBlasLtMatrixLayout mat1_layout;
+  CuBlasLtMatrixLayout mat2_layout;
+  CuBlasLtMatrixLayout result_layout;
+  cublasLtMatmulAlgo_t algo;
+};
+
+uint32_t _cublasLtAlignment(const void* ptr) {
+  uint32_t alignment = 1;
+  const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  while (alignment < 16 && address % (alignment * 2) == 0) {
+    alignment *= 2;
+  }
+  return alignment;
+}
+
+// Returns the descriptors and the algorithm of the matmul, creating them and
+// running the heuristics the first time a thread sees the key. The cache is
+// per thread as the bias pointer is set on the descriptor for every call.
+CuBlasLtMatmul& _cublasLtGetMatmul(
+    cublasLtHandle_t handle,
+    const CuBlasLtMatmulKey& key,
+    cudaDataType_t scale_type) {
+  thread_local std::unordered_map<
+      CuBlasLtMatmulKey,
+      CuBlasLtMatmul,
+      at::native::ParamsHash<CuBlasLtMatmulKey>,
+      at::native::ParamsEqual<CuBlasLtMatmulKey>>
+      matmuls;
+  auto it = matmuls.find(key);
+  if (it != matmuls.end()) {
+    return it->second;
+  }
+
+  CuBlasLtMatmul matmul;
+  cublasLtMatmulDesc_t descriptor = nullptr;
+  TORCH_CUDABLAS_CHECK(
+      cublasLtMatmulDescCreate(&descriptor, key.compute_type, scale_type));
+  matmul.descriptor.reset(descriptor);
+  const cublasOperation_t transa =
+      key.transpose_mat1 ? CUBLAS_OP_T : CUBLAS_OP_N;
+  const cublasOperation_t transb =
+      key.transpose_mat2 ? CUBLAS_OP_T : CUBLAS_OP_N;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+      descriptor, CUBLASLT_MATMUL_DESC_TRANSA, &transa, sizeof(transa)));
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+      descriptor, CUBLASLT_MATMUL_DESC_TRANSB, &transb, sizeof(transb)));
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+      descriptor,
+      CUBLASLT_MATMUL_DESC_EPILOGUE,
+      &key.epilogue,
+      sizeof(key.epilogue)));
+
+  const auto create_layout = [](cudaDataType_t type,
+                                int64_t rows,
+                                int64_t cols,
+                                int64_t ld) {
+    cublasLtMatrixLayout_t layout = nullptr;
+    TORCH_CUDABLAS_CHECK(
+        cublasLtMatrixLayoutCreate(&layout, type, rows, cols, ld));
+    return CuBlasLtMatrixLayout(layout);
+  };
+  matmul.mat1_layout = key.transpose_mat1
+      ? create_layout(key.ab_type, key.k, key.m, key.mat1_ld)
+      : create_layout(key.ab_type, key.m, key.k, key.mat1_ld);
+  matmul.mat2_layout = key.transpose_mat2
+      ? create_layout(key.ab_type, key.n, key.k, key.mat2_ld)
+      : create_layout(key.ab_type, key.k, key.n, key.mat2_ld);
+  matmul.result_layout =
+      create_layout(key.c_type, key.m, key.n, key.result_ld);
+
+  cublasLtMatmulPreference_t preference_ = nullptr;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceCreate(&preference_));
+  CuBlasLtMatmulPreference preference(preference_);
+  const size_t workspace_size = kCuBlasLtWorkspaceBytes;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+      preference_,
+      CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+      &workspace_size,
+      sizeof(workspace_size)));
+  for (const cublasLtMatmulPreferenceAttributes_t attribute :
+       {CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_A_BYTES,
+        CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_B_BYTES,
+        CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_C_BYTES,
+        CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_D_BYTES}) {
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+        preference_, attribute, &key.alignment, sizeof(key.alignment)));
+  }
+
+  cublasLtMatmulHeuristicResult_t heuristic = {};
+  int algo_count = 0;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulAlgoGetHeuristic(
+      handle,
+      descriptor,
+      matmul.mat1_layout.get(),
+      matmul.mat2_layout.get(),
+      matmul.result_layout.get(),
+      matmul.result_layout.get(),
+      preference_,
+      1,
+      &heuristic,
+      &algo_count));
+  TORCH_CHECK(
+      algo_count > 0,
+      "at::cuda::blas: cuBLASLt has no algorithm for a matmul of sizes m = ",
+      key.m, ", n = ", key.n, ", k = ", key.k,
+      " and leading dimensions ", key.mat1_ld, ", ", key.mat2_ld, ", ",
+      key.result_ld);
+  matmul.algo = heuristic.algo;
+
+  return matmuls.emplace(key, std::move(matmul)).first->second;
+}
+
+// Runs result = epilogue(alpha * op(mat1) * op(mat2) + bias) on the current
+// stream, where alpha and beta point to values of scale_type and beta is 0.
+void _cublasLtMatmul(
+    CuBlasLtMatmulKey key,
+    cudaDataType_t scale_type,
+    const void* alpha,
+    const void* beta,
+    const void* mat1,
+    const void* mat2,
+    const void* bias,
+    void* result) {
+  char transa = key.transpose_mat1 ? 't' : 'n';
+  char transb = key.transpose_mat2 ? 't' : 'n';
+  _cublasAdjustLdLevel3(
+      transa, transb, key.m, key.n, key.k,
+      &key.mat1_ld, &key.mat2_ld, &key.result_ld);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias, key.m);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias, key.n);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias, key.k);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias, key.mat1_ld);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias, key.mat2_ld);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias, key.result_ld);
+
+  AT_CUDA_CHECK(cudaGetDevice(&key.device));
+  key.alignment = std::min(
+      std::min(_cublasLtAlignment(mat1), _cublasLtAlignment(mat2)),
+      _cublasLtAlignment(result));
+  if (bias != nullptr) {
+    key.alignment = std::min(key.alignment, _cublasLtAlignment(bias));
+  }
+
+  // cuBLASLt takes the cuBLAS handles.
+  cublasLtHandle_t handle = reinterpret_cast<cublasLtHandle_t>(
+      at::cuda::getCurrentCUDABlasHandle());
+  CuBlasLtMatmul& matmul = _cublasLtGetMatmul(handle, key, scale_type);
+  if (bias != nullptr) {
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+        matmul.descriptor.get(),
+        CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+        &bias,
+        sizeof(bias)));
+  }
+
+  auto workspace = c10::cuda::CUDACachingAllocator::get()->allocate(
+      kCuBlasLtWorkspaceBytes);
+  TORCH_CUDABLAS_CHECK(cublasLtMatmul(
+      handle,
+      matmul.descriptor.get(),
+      alpha,
+      mat1,
+      matmul.mat1_layout.get(),
+      mat2,
+      matmul.mat2_layout.get(),
+      beta,
+      result,
+      matmul.result_layout.get(),
+      result,
+      matmul.result_layout.get(),
+      &matmul.algo,
+      workspace.get(),
+      kCuBlasLtWorkspaceBytes,
+      at::cuda::getCurrentCUDAStream()));
+}
+
+template <typename Dtype>
+struct CuBlasLtDataType {};
+template <>
+struct CuBlasLtDataType<float> {
+  static constexpr cudaDataType_t value = CUDA_R_32F;
+};
+template <>
+struct CuBlasLtDataType<at::Half> {
+  static constexpr cudaDataType_t value = CUDA_R_16F;
+};
+template <>
+struct CuBlasLtDataType<at::BFloat16> {
+  static constexpr cudaDataType_t value = CUDA_R_16BF;
+};
+
+template <typename Dtype>
+void _gemm_and_bias(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(Dtype)) {
+  // Like cublasGemmEx for reduced precision, accumulate in float. float
+  // inputs use TF32 if cuBLAS may.
+  const cublasComputeType_t compute_type =
+      std::is_same<Dtype, float>::value && at::globalContext().allowTF32CuBLAS()
+      ? CUBLAS_COMPUTE_32F_FAST_TF32
+      : CUBLAS_COMPUTE_32F;
+  cublasLtEpilogue_t epilogue = CUBLASLT_EPILOGUE_BIAS;
+  if (activation == GEMMAndBiasActivationEpilogue::RELU) {
+    epilogue = CUBLASLT_EPILOGUE_RELU_BIAS;
+  }
+  if (activation == GEMMAndBiasActivationEpilogue::GELU) {
+#if CUDA_VERSION >= 11040
+    epilogue = CUBLASLT_EPILOGUE_GELU_BIAS;
+#else
+    TORCH_CHECK(false, "at::cuda::blas::gemm_and_bias: GELU needs CUDA 11.4");
+#endif
+  }
+
+  CuBlasLtMatmulKey key;
+  memset(&key, 0, sizeof(key));
+  key.compute_type = compute_type;
+  key.ab_type = CuBlasLtDataType<Dtype>::value;
+  key.c_type = CuBlasLtDataType<Dtype>::value;
+  key.transpose_mat1 = transpose_mat1;
+  key.transpose_mat2 = transpose_mat2;
+  key.m = m;
+  key.n = n;
+  key.k = k;
+  key.mat1_ld = mat1_ld;
+  key.mat2_ld = mat2_ld;
+  key.result_ld = result_ld;
+  key.epilogue = epilogue;
+  const float falpha = alpha;
+  const float fbeta = 0;
+  _cublasLtMatmul(key, CUDA_R_32F, &falpha, &fbeta, mat1, mat2, bias, result);
+}
+
+} // anonymous namespace
+
+template <>
+void gemm_and_bias<float>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(float)) {
+  _gemm_and_bias<float>(
+      transpose_mat1, transpose_mat2, m, n, k, alpha, mat1, mat1_ld, mat2,
+      mat2_ld, bias, result, result_ld, activation);
+}
+
+template <>
+void gemm_and_bias<at::Half>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::Half)) {
+  _gemm_and_bias<at::Half>(
+      transpose_mat1, transpose_mat2, m, n, k, alpha, mat1, mat1_ld, mat2,
+      mat2_ld, bias, result, result_ld, activation);
+}
+
+template <>
+void gemm_and_bias<at::BFloat16>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::BFloat16)) {
+  _gemm_and_bias<at::BFloat16>(
+      transpose_mat1, transpose_mat2, m, n, k, alpha, mat1, mat1_ld, mat2,
+      mat2_ld, bias, result, result_ld, activation);
+}
+
+void int8_gemm(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const int8_t* mat1,
+    int64_t mat1_ld,
+    const int8_t* mat2,
+    int64_t mat2_ld,
+    int32_t* result,
+    int64_t result_ld) {
+  CuBlasLtMatmulKey key;
+  memset(&key, 0, sizeof(key));
+  key.compute_type = CUBLAS_COMPUTE_32I;
+  key.ab_type = CUDA_R_8I;
+  key.c_type = CUDA_R_32I;
+  key.transpose_mat1 = transpose_mat1;
+  key.transpose_mat2 = transpose_mat2;
+  key.m = m;
+  key.n = n;
+  key.k = k;
+  key.mat1_ld = mat1_ld;
+  key.mat2_ld = mat2_ld;
+  key.result_ld = result_ld;
+  key.epilogue = CUBLASLT_EPILOGUE_DEFAULT;
+  const int32_t alpha = 1;
+  const int32_t beta = 0;
+  _cublasLtMatmul(key, CUDA_R_32I, &alpha, &beta, mat1, mat2, nullptr, result);
+}
+#endif // !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define GEMV_CHECK_ARGVALUES(Dtype)           \
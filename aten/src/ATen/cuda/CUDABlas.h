@@ -9,8 +9,10 @@
 
     dot<Dtype>(n, x, incx, y, incy, result)
 
-  where Dtype is double, float, at::Half or at::BFloat16 (ROCm, NOT for dot).
-  The functions are available in at::cuda::blas namespace.
+  where Dtype is double, float, at::Half or at::BFloat16 (ROCm and CUDA 11,
+  NOT for dot). The functions are available in at::cuda::blas namespace.
+
+  On CUDA 11 it also provides the cuBLASLt matmuls gemm_and_bias and int8_gemm.
  */
 
 #include <ATen/cuda/CUDAContext.h>
@@ -45,11 +47,59 @@ void gemm<float>(CUDABLAS_GEMM_ARGTYPES(float));
 #endif
 template <>
 void gemm<at::Half>(CUDABLAS_GEMM_ARGTYPES(at::Half));
-#ifdef __HIP_PLATFORM_HCC__
+#if defined(__HIP_PLATFORM_HCC__) || (defined(CUDA_VERSION) && CUDA_VERSION >= 11000)
 template <>
 void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16));
 #endif
 
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+enum GEMMAndBiasActivationEpilogue {
+  None,
+  RELU,
+  // The tanh approximation of GELU, only available from CUDA 11.4 on.
+  GELU,
+};
+
+// Computes result = activation(alpha * op(mat1) * op(mat2) + bias) with a
+// single cuBLASLt matmul, where op transposes if asked to and the bias, of m
+// elements, is broadcast over the n columns of the column-major result.
+// Dtype is float, at::Half or at::BFloat16. The matmul descriptors and the
+// algorithm of the cuBLASLt heuristics are cached per shape and alignment.
+#define CUDABLAS_GEMM_AND_BIAS_ARGTYPES(Dtype)                               \
+  bool transpose_mat1, bool transpose_mat2, int64_t m, int64_t n, int64_t k, \
+      Dtype alpha, const Dtype *mat1, int64_t mat1_ld, const Dtype *mat2,    \
+      int64_t mat2_ld, const Dtype *bias, Dtype *result, int64_t result_ld,  \
+      GEMMAndBiasActivationEpilogue activation
+
+template <typename Dtype>
+inline void gemm_and_bias(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(Dtype)) {
+  AT_ERROR("at::cuda::blas::gemm_and_bias: not implemented for ", typeid(Dtype).name());
+}
+
+template <>
+void gemm_and_bias<float>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(float));
+template <>
+void gemm_and_bias<at::Half>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::Half));
+template <>
+void gemm_and_bias<at::BFloat16>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::BFloat16));
+
+// Computes the int32 result = op(mat1) * op(mat2) of int8 matrices with
+// cuBLASLt, which uses the IMMA tensor cores for transposed mat1 and
+// non-transposed mat2.
+void int8_gemm(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const int8_t* mat1,
+    int64_t mat1_ld,
+    const int8_t* mat2,
+    int64_t mat2_ld,
+    int32_t* result,
+    int64_t result_ld);
+#endif
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define CUDABLAS_GEMV_ARGTYPES(Dtype)                                         \
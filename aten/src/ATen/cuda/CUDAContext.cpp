@@ -14,11 +14,15 @@ DeviceIndex num_gpus = -1;
 std::once_flag init_flag;
 std::deque<std::once_flag> device_flags;
 std::vector<cudaDeviceProp> device_properties;
+std::deque<std::once_flag> copy_stream_flags;
+std::vector<c10::optional<CUDAStream>> copy_streams;
 
 void initCUDAContextVectors() {
   num_gpus = c10::cuda::device_count();
   device_flags.resize(num_gpus);
   device_properties.resize(num_gpus);
+  copy_stream_flags.resize(num_gpus);
+  copy_streams.resize(num_gpus);
 }
 
 void initDeviceProperty(DeviceIndex device_index) {
@@ -55,6 +59,16 @@ Allocator* getCUDADeviceAllocator() {
   return c10::cuda::CUDACachingAllocator::get();
 }
 
+CUDAStream getCopyStream(DeviceIndex device) {
+  std::call_once(init_flag, initCUDAContextVectors);
+  if (device == -1) device = c10::cuda::current_device();
+  AT_ASSERT(device >= 0 && device < num_gpus);
+  std::call_once(copy_stream_flags[device], [device] {
+    copy_streams[device] = getStreamFromPool(/*isHighPriority=*/false, device);
+  });
+  return *copy_streams[device];
+}
+
 } // namespace cuda
 
 } // namespace at
@@ -60,6 +60,14 @@ TORCH_CUDA_API cudaDeviceProp* getDeviceProperties(int64_t device);
 
 TORCH_CUDA_API Allocator* getCUDADeviceAllocator();
 
+/**
+ * Returns the stream that non_blocking copies between the host and the given
+ * device are issued on when copy streams are enabled (see
+ * Context::useCUDACopyStreams). It is drawn from the stream pool once per
+ * device and never changes afterwards.
+ */
+TORCH_CUDA_API CUDAStream getCopyStream(DeviceIndex device = -1);
+
 /* Handles */
 TORCH_CUDA_API cusparseHandle_t getCurrentCUDASparseHandle();
 TORCH_CUDA_API cublasHandle_t getCurrentCUDABlasHandle();
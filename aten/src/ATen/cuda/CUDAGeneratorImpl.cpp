@@ -1,7 +1,10 @@
 #include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/cuda/CUDAGraphsUtils.cuh>
 #include <c10/cuda/CUDAFunctions.h>
 #include <ATen/Utils.h>
 
+#include <limits>
+
 namespace at {
 
 namespace cuda { namespace detail {
@@ -125,6 +128,58 @@ uint64_t CUDAGeneratorImpl::philox_offset_per_thread() {
   return philox_offset_per_thread_;
 }
 
+/**
+ * Gets the seed and philox offset to be used in curandStatePhilox4_32_10,
+ * in a form that stays valid when the kernel using them is captured into a
+ * CUDA graph and replayed. Increments the offset the same way as
+ * philox_engine_inputs.
+ *
+ * See Note [CUDA Graph-safe RNG states]
+ * See Note [Lock-free philox offsets]
+ */
+PhiloxCudaState CUDAGeneratorImpl::philox_cuda_state(uint64_t increment) {
+  if (at::cuda::currentStreamCaptureStatus() != at::cuda::CaptureStatus::None) {
+    TORCH_CHECK(graph_expects_this_gen_,
+                "philox_cuda_state for an unexpected CUDA generator used during capture. "
+                "Only the default CUDA generator of the device capture began on "
+                "can be used in a captured region.");
+    // Checks the increment before reserving it, so a failed check leaves the
+    // offset of the captured region alone.
+    uint32_t offset = this->offset_intragraph_.load();
+    do {
+      TORCH_CHECK(increment <= std::numeric_limits<uint32_t>::max() - offset,
+                  "The philox offset increment of the captured region overflows");
+    } while (!this->offset_intragraph_.compare_exchange_weak(
+        offset, offset + static_cast<uint32_t>(increment)));
+    return PhiloxCudaState(this->seed_.load(), this->offset_extragraph_, offset);
+  } else {
+    TORCH_CHECK(!graph_expects_this_gen_,
+                "CUDA generator expects graph capture to be underway, "
+                "but the current stream is not capturing.");
+    uint64_t offset = this->philox_offset_per_thread_.fetch_add(increment);
+    return PhiloxCudaState(this->seed_.load(), offset);
+  }
+}
+
+/**
+ * Called by CUDAGraph to prepare this instance for a graph capture region.
+ * offset_extragraph is the initial offset at the start of the graphed region.
+ * offset_intragraph tracks the offset in the graphed region.
+ */
+void CUDAGeneratorImpl::capture_prologue(int64_t* offset_extragraph) {
+  offset_extragraph_ = offset_extragraph;
+  offset_intragraph_ = 0;
+  graph_expects_this_gen_ = true;
+}
+
+/**
+ * Called by CUDAGraph to finalize a graph capture region for this instance.
+ */
+uint64_t CUDAGeneratorImpl::capture_epilogue() {
+  graph_expects_this_gen_ = false;
+  return offset_intragraph_;
+}
+
 /**
  * Gets the seed and philox offset value to be used in
  * curandStatePhilox4_32_10
@@ -140,13 +195,17 @@ uint64_t CUDAGeneratorImpl::philox_offset_per_thread() {
  * for philox is never smaller than the number of curand() calls. Increment
  * value > the number of curand() calls won't harm but anything less would mean
  * that you would be reusing random values from previous calls.
+ *
+ * The values can't be used by a kernel captured into a CUDA graph, use
+ * philox_cuda_state instead.
  * 
- * See Note [Acquire lock when using random generators]
+ * See Note [Lock-free philox offsets]
  */
 std::pair<uint64_t, uint64_t> CUDAGeneratorImpl::philox_engine_inputs(uint64_t increment) {
-  uint64_t offset = this->philox_offset_per_thread_;
-  this->philox_offset_per_thread_ += increment;
-  return std::make_pair(this->seed_, offset);
+  at::cuda::assertNotCapturing("Refactor this op to use CUDAGeneratorImpl::philox_cuda_state. "
+                               "Cannot call CUDAGeneratorImpl::philox_engine_inputs");
+  uint64_t offset = this->philox_offset_per_thread_.fetch_add(increment);
+  return std::make_pair(this->seed_.load(), offset);
 }
 
 /*
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <cuda_runtime_api.h>
+
+namespace at {
+
+struct CUDAGeneratorImpl;
+
+namespace cuda {
+
+using CaptureId_t = c10::cuda::CUDACachingAllocator::CaptureId_t;
+using MempoolId_t = c10::cuda::CUDACachingAllocator::MempoolId_t;
+
+// Standalone way to get a unique mempool id usable as a pool=... argument
+// to CUDAGraph::capture_begin
+TORCH_CUDA_API MempoolId_t graph_pool_handle();
+
+/*
+* A CUDAGraph records the kernels a region of host code issues to a stream
+* (capture_begin() ... capture_end()) and relaunches all of them with a single
+* cudaGraphLaunch (replay()), saving their CPU launch overhead. Requires
+* CUDA 11.0 or newer.
+*
+* - Capture must happen on a non-default stream. Replays read and write the
+*   memory the kernels used at capture, so inputs are copied into tensors
+*   allocated before or during capture, and outputs are read from the tensors
+*   the captured region produced.
+* - Allocations made during capture come from a private memory pool of the
+*   caching allocator that stays reserved until the graph is reset. Graphs
+*   that are always replayed in capture order may share a pool
+*   (capture_begin(other.pool())).
+* - Random ops drawing from the default CUDA generator of the capturing
+*   device produce fresh numbers on each replay; see
+*   Note [CUDA Graph-safe RNG states]. Ops using philox_engine_inputs, other
+*   generators, or synchronizing with the host can't be captured.
+*/
+struct TORCH_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  CUDAGraph(const CUDAGraph&) = delete;
+  CUDAGraph& operator=(const CUDAGraph&) = delete;
+
+  void capture_begin(MempoolId_t pool = {0, 0});
+  void capture_end();
+  void replay();
+  void reset();
+  MempoolId_t pool();
+
+ protected:
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+  cudaGraph_t graph_ = NULL;
+  cudaGraphExec_t graph_exec_ = NULL;
+#endif
+
+  // internal states so reset() can do its best cleaning up
+  // Set to true in capture_end if cudaStreamEndCapture succeeded
+  // Set back to false soon after, when graph_ is consumed by cudaGraphInstantiate
+  // to create graph_exec_, then graph_ is deleted
+  bool has_graph_ = false;
+  // Set to true in capture_end if cudaGraphInstantiate succeeded
+  bool has_graph_exec_ = false;
+
+  // uuid of this instance's current capture, retrieved from Cuda
+  CaptureId_t id_ = 0;
+
+  // uuid used to request a particular private mempool from CUDACachingAllocator.
+  // By default, this will be set to {id_, 0}.
+  //
+  // If capture_begin is called with "pool=other_graph.pool()", this graph's mempool_id_
+  // will be set to the other graph's mempool_id_, and therefore share a mempool with the
+  // other graph.
+  //
+  // If capture_begin is called with "pool=handle" where "handle" came from graph_pool_handle(),
+  // it will share a mempool with any other captures that used "pool=handle".
+  //
+  // Sharing a mempool across graphs saves memory, and it's safe if you
+  // know you'll replay those graphs in the same order you captured them.
+  MempoolId_t mempool_id_;
+
+  // Stream on which capture began
+  at::cuda::CUDAStream capture_stream_;
+
+  // Default generator on device where capture began
+  at::CUDAGeneratorImpl* capture_gen_ = nullptr;
+
+  // Device where capture occurred. Right now, for simplicity, we require all ops
+  // in a capture to run on the same device, but this is a limitation of CUDAGraph,
+  // not CUDA itself.  We can straightforwardly modify CUDAGraph to support multi-device
+  // captures if needed.
+  int capture_dev_ = 0;
+
+  // RNG state trackers
+  at::Tensor offset_extragraph_;
+  uint64_t wholegraph_increment_ = 0;
+};
+
+} // namespace cuda
+} // namespace at
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <ATen/detail/CUDAHooksInterface.h>
+
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace at {
+namespace cuda {
+
+// Protects against enum cudaStreamCaptureStatus implementation changes.
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+static_assert(int(cudaStreamCaptureStatus::cudaStreamCaptureStatusNone) == 0,
+              "unexpected int(cudaStreamCaptureStatusNone) value");
+static_assert(int(cudaStreamCaptureStatus::cudaStreamCaptureStatusActive) == 1,
+              "unexpected int(cudaStreamCaptureStatusActive) value");
+static_assert(int(cudaStreamCaptureStatus::cudaStreamCaptureStatusInvalidated) == 2,
+              "unexpected int(cudaStreamCaptureStatusInvalidated) value");
+#endif
+
+enum class CaptureStatus: int {
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+  None = int(cudaStreamCaptureStatus::cudaStreamCaptureStatusNone),
+  Active = int(cudaStreamCaptureStatus::cudaStreamCaptureStatusActive),
+  Invalidated = int(cudaStreamCaptureStatus::cudaStreamCaptureStatusInvalidated)
+#else
+  None = 0
+#endif
+};
+
+inline std::ostream& operator<<(std::ostream& os, CaptureStatus status) {
+  switch(status) {
+    case CaptureStatus::None:
+      os << "cudaStreamCaptureStatusNone";
+      break;
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+    case CaptureStatus::Active:
+      os << "cudaStreamCaptureStatusActive";
+      break;
+    case CaptureStatus::Invalidated:
+      os << "cudaStreamCaptureStatusInvalidated";
+      break;
+#endif
+    default:
+      TORCH_INTERNAL_ASSERT(false,
+                            "Unknown CUDA graph CaptureStatus",
+                            int(status));
+  }
+  return os;
+}
+
+// Capture status of the current stream. Doesn't create a CUDA context if none
+// exists.
+inline CaptureStatus currentStreamCaptureStatus() {
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+  // don't create a context if we don't have to
+  if (at::detail::getCUDAHooks().hasPrimaryContext(c10::cuda::current_device())) {
+    cudaStreamCaptureStatus is_capturing;
+    AT_CUDA_CHECK(cudaStreamIsCapturing(at::cuda::getCurrentCUDAStream(),
+                                        &is_capturing));
+    return CaptureStatus(is_capturing);
+  } else {
+    return CaptureStatus::None;
+  }
+#else
+  return CaptureStatus::None;
+#endif
+}
+
+inline void assertNotCapturing(std::string attempt) {
+  auto status = currentStreamCaptureStatus();
+  TORCH_CHECK(status == CaptureStatus::None,
+              attempt,
+              " during CUDA graph capture. If you need this call to be captured, "
+              "please file an issue. "
+              "Current cudaStreamCaptureStatus: ",
+              status);
+}
+
+namespace philox {
+
+// In-kernel call to retrieve philox seed and offset from a PhiloxCudaState
+// instance whether that instance was created with graph capture underway or
+// not. See Note [CUDA Graph-safe RNG states].
+__device__ __forceinline__ std::pair<uint64_t, uint64_t>
+unpack(at::PhiloxCudaState arg) {
+  if (arg.captured_) {
+    return std::make_pair(
+        arg.seed_,
+        static_cast<uint64_t>(*(arg.offset_.ptr) + arg.offset_intragraph_));
+  } else {
+    return std::make_pair(arg.seed_, arg.offset_.val);
+  }
+}
+
+} // namespace philox
+
+} // namespace cuda
+} // namespace at
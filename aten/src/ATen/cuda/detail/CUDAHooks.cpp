@@ -5,12 +5,14 @@
 #include <ATen/DeviceGuard.h>
 #include <ATen/DynamicLibrary.h>
 #include <ATen/cuda/CUDAConfig.h>
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/CUDADevice.h>
 #include <ATen/cuda/Exceptions.h>
 #include <ATen/cuda/PinnedMemoryAllocator.h>
 #include <ATen/cuda/nvrtc_stub/ATenNVRTC.h>
 #include <ATen/detail/CUDAHooksInterface.h>
 #include <ATen/native/cuda/CuFFTPlanCache.h>
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/util/Exception.h>
 
 #include <THC/THC.h>
@@ -185,6 +187,14 @@ Allocator* CUDAHooks::getCUDADeviceAllocator() const {
   return at::cuda::getCUDADeviceAllocator();
 }
 
+Stream CUDAHooks::getCopyStream(DeviceIndex device_index) const {
+  return at::cuda::getCopyStream(device_index);
+}
+
+void CUDAHooks::recordStream(const DataPtr& data_ptr, Stream stream) const {
+  c10::cuda::CUDACachingAllocator::recordStream(data_ptr, CUDAStream(stream));
+}
+
 bool CUDAHooks::compiledWithCuDNN() const {
   return AT_CUDNN_ENABLED();
 }
@@ -24,6 +24,8 @@ struct CUDAHooks : public at::CUDAHooksInterface {
   c10::optional<int64_t> getDevceIndexWithPrimaryContext() const override;
   Allocator* getCUDADeviceAllocator() const override;
   Allocator* getPinnedMemoryAllocator() const override;
+  Stream getCopyStream(DeviceIndex device_index) const override;
+  void recordStream(const DataPtr& data_ptr, Stream stream) const override;
   bool compiledWithCuDNN() const override;
   bool compiledWithMIOpen() const override;
   bool supportsDilatedConvolutionWithCuDNN() const override;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <c10/core/Allocator.h>
+#include <c10/core/Stream.h>
 #include <ATen/core/Generator.h>
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
@@ -125,6 +126,14 @@ struct CAFFE2_API CUDAHooksInterface {
     TORCH_CHECK(false, "CUDADeviceAllocator requires CUDA. ", CUDA_HELP);
   }
 
+  virtual Stream getCopyStream(DeviceIndex device_index) const {
+    TORCH_CHECK(false, "Cannot get the CUDA copy stream without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual void recordStream(const DataPtr& data_ptr, Stream stream) const {
+    TORCH_CHECK(false, "Cannot record a CUDA stream without ATen_cuda library. ", CUDA_HELP);
+  }
+
   virtual bool compiledWithCuDNN() const {
     return false;
   }
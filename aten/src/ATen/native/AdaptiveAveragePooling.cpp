@@ -1,12 +1,17 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
+#include <ATen/native/Pool.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <tuple>
 
 
 namespace at {
 namespace native {
 
+DEFINE_DISPATCH(adaptive_avg_pool2d_channels_last_kernel);
+DEFINE_DISPATCH(adaptive_avg_pool2d_channels_last_backward_kernel);
+
 namespace {
 
   inline int start_index(int a, int b, int c) {
@@ -128,6 +133,12 @@ namespace {
     auto osizeH = output_size[0];
     auto osizeW = output_size[1];
 
+    if (use_channels_last_pool2d(input)) {
+      output.resize_({input.size(0), sizeD, osizeH, osizeW}, at::MemoryFormat::ChannelsLast);
+      adaptive_avg_pool2d_channels_last_kernel(kCPU, output, input);
+      return;
+    }
+
     /* resize output */
     if (input.ndimension() == 3 || input.size(-4) == 1)
     {
@@ -259,6 +270,13 @@ namespace {
     int osizeH = gradOutput_.size(-2);
     int osizeW = gradOutput_.size(-1);
 
+    if (use_channels_last_pool2d(input)) {
+      gradInput.resize_(input.sizes(), at::MemoryFormat::ChannelsLast);
+      gradInput.zero_();
+      adaptive_avg_pool2d_channels_last_backward_kernel(kCPU, gradInput, gradOutput_);
+      return gradInput;
+    }
+
     /* get contiguous gradOutput */
     auto gradOutput = gradOutput_.contiguous();
 
@@ -326,7 +344,15 @@ namespace {
       return at::mkldnn_adaptive_avg_pool2d(input, output_size);
     }
 
-    // TODO: fastpath for Channels_last should be explored later;
+#if defined(C10_MOBILE)
+    if (output_size[0] == 1 && output_size[1] == 1 &&
+        xnnpack::use_global_average_pool(input)) {
+      return xnnpack::global_average_pool(input);
+    }
+#endif
+
+    // channels last input, including the global pool, goes to the channels
+    // last kernel of _adaptive_avg_pool2d
     if (input.suggest_memory_format() == at::MemoryFormat::Contiguous && !input.is_quantized() && output_size[0] == 1 && output_size[1] == 1) {
       // in this case, adaptive pooling is just computing mean over hw
       // dimensions, which can be done more efficiently
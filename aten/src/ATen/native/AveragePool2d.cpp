@@ -2,12 +2,16 @@
 #include <ATen/Parallel.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/Pool.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <tuple>
 
 
 namespace at {
 namespace native {
 
+DEFINE_DISPATCH(avg_pool2d_channels_last_kernel);
+DEFINE_DISPATCH(avg_pool2d_channels_last_backward_kernel);
+
 namespace {
 
 template <typename scalar_t>
@@ -141,6 +145,15 @@ void avg_pool2d_out_cpu_template(
     inputHeight, inputWidth,
     outputHeight, outputWidth);
 
+  if (use_channels_last_pool2d(input_)) {
+    output.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+    avg_pool2d_channels_last_kernel(
+        kCPU, output, input_,
+        kW, kH, dW, dH, padW, padH,
+        count_include_pad, divisor_override);
+    return;
+  }
+
   if (input_.ndimension() == 3) {
     output.resize_({nInputPlane, outputHeight, outputWidth});
   }
@@ -301,6 +314,16 @@ Tensor& avg_pool2d_backward_out_cpu_template(
     inputHeight, inputWidth,
     outputHeight, outputWidth);
 
+  if (use_channels_last_pool2d(input)) {
+    gradInput.resize_(input.sizes(), at::MemoryFormat::ChannelsLast);
+    gradInput.zero_();
+    avg_pool2d_channels_last_backward_kernel(
+        kCPU, gradInput, gradOutput_,
+        kW, kH, dW, dH, padW, padH,
+        count_include_pad, divisor_override);
+    return gradInput;
+  }
+
   /* get contiguous gradOutput */
   const Tensor gradOutput = gradOutput_.contiguous();
 
@@ -366,6 +389,12 @@ Tensor avg_pool2d_cpu(
   bool count_include_pad,
   c10::optional<int64_t> divisor_override)
 {
+#if defined(C10_MOBILE)
+  if (xnnpack::use_avg_pool2d(input, kernel_size, stride, padding, ceil_mode,
+                              count_include_pad, divisor_override)) {
+    return xnnpack::avg_pool2d(input, kernel_size, stride, padding, ceil_mode);
+  }
+#endif
   Tensor output = at::empty({0}, input.options());
   avg_pool2d_out_cpu_template(
     output,
@@ -300,6 +300,248 @@ template<> void lapackLuSolve<double>(char trans, int n, int nrhs, double *a, in
 template<> void lapackLuSolve<float>(char trans, int n, int nrhs, float *a, int lda, int *ipiv, float *b, int ldb, int *info) {
   sgetrs_(&trans, &n, &nrhs, a, &lda, ipiv, b, &ldb, info);
 }
+
+// Note [Batched linear algebra on small matrices]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A batch of many tiny matrices (say, the 6x6 covariances of a batch of Kalman
+// filters) spends most of its time in the per call overhead of LAPACK rather
+// than in the arithmetic. For square matrices of size up to
+// small_matrix_max_size, the kernels below replace getrf, gesv, getri, potrf,
+// potrs and trtrs. The size of the matrix is a template parameter so that the
+// compiler fully unrolls them. They follow the reference LAPACK algorithms
+// (partial pivoting on the largest |re| + |im|, the same info codes, b left
+// untouched by a singular trtrs) and work in place on the same column major
+// working copies.
+//
+// Both these kernels and the LAPACK calls are run in parallel over the batch by
+// batch_parallel_for, as long as the matrices are small enough that a single
+// LAPACK call could not use the whole machine by itself. Larger matrices are
+// left to the (possibly multithreaded) LAPACK library, one at a time.
+namespace {
+
+constexpr int64_t small_matrix_max_size = 8;
+constexpr int64_t batch_parallel_max_size = 128;
+
+static inline bool use_small_matrix_kernels(int64_t n) {
+  return n > 0 && n <= small_matrix_max_size;
+}
+
+template <typename F>
+static void batch_parallel_for(int64_t batch_size, int64_t n, const F& f) {
+  if (n > batch_parallel_max_size) {
+    f(0, batch_size);
+    return;
+  }
+  int64_t work_per_matrix = std::max<int64_t>(n * n * n, 1);
+  at::parallel_for(0, batch_size, std::max<int64_t>(at::internal::GRAIN_SIZE / work_per_matrix, 1), f);
+}
+
+// Calls Kernel<scalar_t, n>::apply(args...) for 1 <= n <= small_matrix_max_size
+template <template <typename, int> class Kernel, typename scalar_t, typename... Args>
+static inline void small_matrix_apply(int64_t n, Args... args) {
+  switch (n) {
+    case 1: Kernel<scalar_t, 1>::apply(args...); break;
+    case 2: Kernel<scalar_t, 2>::apply(args...); break;
+    case 3: Kernel<scalar_t, 3>::apply(args...); break;
+    case 4: Kernel<scalar_t, 4>::apply(args...); break;
+    case 5: Kernel<scalar_t, 5>::apply(args...); break;
+    case 6: Kernel<scalar_t, 6>::apply(args...); break;
+    case 7: Kernel<scalar_t, 7>::apply(args...); break;
+    case 8: Kernel<scalar_t, 8>::apply(args...); break;
+    default: TORCH_INTERNAL_ASSERT(false, "unexpected small matrix size ", n);
+  }
+}
+
+// |re| + |im|, what LAPACK pivots on
+template <typename scalar_t, typename value_t = typename c10::scalar_value_type<scalar_t>::type>
+static inline value_t small_abs1(scalar_t z) {
+  return std::abs(real_impl<scalar_t, value_t>(z)) + std::abs(imag_impl<scalar_t, value_t>(z));
+}
+
+template <typename scalar_t, typename value_t = typename c10::scalar_value_type<scalar_t>::type>
+static inline value_t small_abs2(scalar_t z) {
+  return real_impl<scalar_t, value_t>(conj_impl(z) * z);
+}
+
+// getrf
+template <typename scalar_t, int N>
+struct SmallLu {
+  static void apply(scalar_t* a, int* ipiv, int* info) {
+    using value_t = typename c10::scalar_value_type<scalar_t>::type;
+    *info = 0;
+    for (int j = 0; j < N; j++) {
+      int p = j;
+      value_t pivot_abs = small_abs1(a[j + j * N]);
+      for (int i = j + 1; i < N; i++) {
+        value_t v = small_abs1(a[i + j * N]);
+        if (v > pivot_abs) {
+          p = i;
+          pivot_abs = v;
+        }
+      }
+      ipiv[j] = p + 1;
+      if (a[p + j * N] != scalar_t(0)) {
+        if (p != j) {
+          for (int c = 0; c < N; c++) {
+            std::swap(a[j + c * N], a[p + c * N]);
+          }
+        }
+        for (int i = j + 1; i < N; i++) {
+          a[i + j * N] /= a[j + j * N];
+        }
+      } else if (*info == 0) {
+        *info = j + 1;
+      }
+      for (int c = j + 1; c < N; c++) {
+        scalar_t a_jc = a[j + c * N];
+        for (int i = j + 1; i < N; i++) {
+          a[i + c * N] -= a[i + j * N] * a_jc;
+        }
+      }
+    }
+  }
+};
+
+// trtrs, where trans is 'N', 'T' or 'C' as in LAPACK. With info == nullptr it
+// skips the singularity check, for the triangular solves of potrs and getrs.
+template <typename scalar_t, int N>
+struct SmallTriangularSolve {
+  static void apply(const scalar_t* a, scalar_t* b, int64_t nrhs,
+                    bool upper, char trans, bool unitriangular, int* info) {
+    if (info != nullptr) {
+      *info = 0;
+      if (!unitriangular) {
+        for (int i = 0; i < N; i++) {
+          if (a[i + i * N] == scalar_t(0)) {
+            *info = i + 1;
+            return;
+          }
+        }
+      }
+    }
+    // op(a), row major
+    scalar_t op_a[N][N];
+    for (int i = 0; i < N; i++) {
+      for (int k = 0; k < N; k++) {
+        op_a[i][k] = trans == 'N' ? a[i + k * N]
+                   : trans == 'T' ? a[k + i * N] : conj_impl(a[k + i * N]);
+      }
+    }
+    bool lower = upper != (trans == 'N');
+    for (int64_t c = 0; c < nrhs; c++) {
+      scalar_t* x = b + c * N;
+      if (lower) {
+        for (int i = 0; i < N; i++) {
+          scalar_t s = x[i];
+          for (int k = 0; k < i; k++) {
+            s -= op_a[i][k] * x[k];
+          }
+          x[i] = unitriangular ? s : s / op_a[i][i];
+        }
+      } else {
+        for (int i = N - 1; i >= 0; i--) {
+          scalar_t s = x[i];
+          for (int k = i + 1; k < N; k++) {
+            s -= op_a[i][k] * x[k];
+          }
+          x[i] = unitriangular ? s : s / op_a[i][i];
+        }
+      }
+    }
+  }
+};
+
+// getrs with trans = 'N', on the output of SmallLu
+template <typename scalar_t, int N>
+static inline void small_lu_solve(const scalar_t* lu, const int* ipiv, scalar_t* b, int64_t nrhs) {
+  for (int64_t c = 0; c < nrhs; c++) {
+    for (int i = 0; i < N; i++) {
+      std::swap(b[i + c * N], b[(ipiv[i] - 1) + c * N]);
+    }
+  }
+  SmallTriangularSolve<scalar_t, N>::apply(lu, b, nrhs, /*upper=*/false, 'N', /*unitriangular=*/true, nullptr);
+  SmallTriangularSolve<scalar_t, N>::apply(lu, b, nrhs, /*upper=*/true, 'N', /*unitriangular=*/false, nullptr);
+}
+
+// gesv
+template <typename scalar_t, int N>
+struct SmallSolve {
+  static void apply(scalar_t* a, scalar_t* b, int64_t nrhs, int* info) {
+    int ipiv[N];
+    SmallLu<scalar_t, N>::apply(a, ipiv, info);
+    if (*info == 0) {
+      small_lu_solve<scalar_t, N>(a, ipiv, b, nrhs);
+    }
+  }
+};
+
+// getrf followed by getri
+template <typename scalar_t, int N>
+struct SmallInverse {
+  static void apply(scalar_t* a, int* info) {
+    int ipiv[N];
+    SmallLu<scalar_t, N>::apply(a, ipiv, info);
+    if (*info != 0) {
+      return;
+    }
+    scalar_t inv[N * N];
+    for (int i = 0; i < N * N; i++) {
+      inv[i] = i % (N + 1) == 0 ? scalar_t(1) : scalar_t(0);
+    }
+    small_lu_solve<scalar_t, N>(a, ipiv, inv, N);
+    std::copy(inv, inv + N * N, a);
+  }
+};
+
+// potrf
+template <typename scalar_t, int N>
+struct SmallCholesky {
+  static void apply(scalar_t* a, bool upper, int* info) {
+    using value_t = typename c10::scalar_value_type<scalar_t>::type;
+    *info = 0;
+    for (int j = 0; j < N; j++) {
+      // a = U^H U is read from and written to the upper triangle, a = L L^H
+      // from and to the lower one
+      value_t d = real_impl<scalar_t, value_t>(a[j + j * N]);
+      for (int k = 0; k < j; k++) {
+        d -= small_abs2(upper ? a[k + j * N] : a[j + k * N]);
+      }
+      if (!(d > 0)) {
+        a[j + j * N] = scalar_t(d);
+        *info = j + 1;
+        return;
+      }
+      d = std::sqrt(d);
+      a[j + j * N] = scalar_t(d);
+      for (int i = j + 1; i < N; i++) {
+        if (upper) {
+          scalar_t s = a[j + i * N];
+          for (int k = 0; k < j; k++) {
+            s -= conj_impl(a[k + j * N]) * a[k + i * N];
+          }
+          a[j + i * N] = s / scalar_t(d);
+        } else {
+          scalar_t s = a[i + j * N];
+          for (int k = 0; k < j; k++) {
+            s -= a[i + k * N] * conj_impl(a[j + k * N]);
+          }
+          a[i + j * N] = s / scalar_t(d);
+        }
+      }
+    }
+  }
+};
+
+// potrs
+template <typename scalar_t, int N>
+struct SmallCholeskySolve {
+  static void apply(const scalar_t* a, scalar_t* b, int64_t nrhs, bool upper) {
+    SmallTriangularSolve<scalar_t, N>::apply(a, b, nrhs, upper, upper ? 'C' : 'N', /*unitriangular=*/false, nullptr);
+    SmallTriangularSolve<scalar_t, N>::apply(a, b, nrhs, upper, upper ? 'N' : 'C', /*unitriangular=*/false, nullptr);
+  }
+};
+
+} // anonymous namespace
 #endif
 
 // Below of the definitions of the functions operating on a batch that are going to be dispatched
@@ -320,19 +562,25 @@ static void apply_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
   auto n = A.size(-2);
   auto nrhs = b.size(-1);
 
-  auto ipiv = at::empty({n}, b.options().dtype(kInt));
-  auto ipiv_data = ipiv.data_ptr<int>();
-
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-    scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-    lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv_data, b_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  // See Note [Batched linear algebra on small matrices]
+  bool use_small = use_small_matrix_kernels(n);
+  batch_parallel_for(batch_size, n, [&](int64_t start, int64_t end) {
+    Tensor ipiv;
+    if (!use_small) {
+      ipiv = at::empty({n}, b.options().dtype(kInt));
     }
-  }
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+      if (use_small) {
+        small_matrix_apply<SmallSolve, scalar_t>(n, A_working_ptr, b_working_ptr, nrhs, &info);
+      } else {
+        lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv.data_ptr<int>(), b_working_ptr, n, &info);
+      }
+      infos[i] = info;
+    }
+  });
 #endif
 }
 
@@ -383,8 +631,17 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  auto ipiv = at::empty({n}, self.options().dtype(kInt));
-  auto ipiv_data = ipiv.data_ptr<int>();
+  // See Note [Batched linear algebra on small matrices]
+  if (use_small_matrix_kernels(n)) {
+    batch_parallel_for(batch_size, n, [&](int64_t start, int64_t end) {
+      int info;
+      for (int64_t i = start; i < end; i++) {
+        small_matrix_apply<SmallInverse, scalar_t>(n, &self_data[i * self_matrix_stride], &info);
+        infos[i] = info;
+      }
+    });
+    return;
+  }
 
   int info;
   // Run once, first to get the optimum work size
@@ -393,26 +650,31 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
   // and (batch_size - 1) calls to allocate and deallocate workspace using at::empty()
   int lwork = -1;
   scalar_t wkopt;
-  lapackGetri<scalar_t>(n, self_data, n, ipiv_data, &wkopt, lwork, &info);
+  int ipiv_query;
+  lapackGetri<scalar_t>(n, self_data, n, &ipiv_query, &wkopt, lwork, &info);
   lwork = static_cast<int>(real_impl<scalar_t, value_t>(wkopt));
-  Tensor work = at::empty({lwork}, self.options());
-  auto work_data = work.data_ptr<scalar_t>();
 
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv_data, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
+  batch_parallel_for(batch_size, n, [&](int64_t start, int64_t end) {
+    // pivots and workspace are per thread
+    auto ipiv = at::empty({n}, self.options().dtype(kInt));
+    auto ipiv_data = ipiv.data_ptr<int>();
+    Tensor work = at::empty({lwork}, self.options());
+    auto work_data = work.data_ptr<scalar_t>();
+
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv_data, &info);
+      infos[i] = info;
+      if (info != 0) {
+        continue;
+      }
 
-    // now compute the actual inverse
-    lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv_data, work_data, lwork, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+      // now compute the actual inverse
+      lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv_data, work_data, lwork, &info);
+      infos[i] = info;
     }
-  }
+  });
 #endif
 }
 
@@ -463,16 +725,21 @@ static void apply_cholesky_solve(Tensor& b, Tensor& A, bool upper, std::vector<i
   auto n = A.size(-2);
   auto nrhs = b.size(-1);
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-    scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-    lapackCholeskySolve<scalar_t>(uplo, n, nrhs, A_working_ptr, n, b_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  // See Note [Batched linear algebra on small matrices]
+  bool use_small = use_small_matrix_kernels(n);
+  batch_parallel_for(batch_size, n, [&](int64_t start, int64_t end) {
+    int info = 0;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+      if (use_small) {
+        small_matrix_apply<SmallCholeskySolve, scalar_t>(n, static_cast<const scalar_t*>(A_working_ptr), b_working_ptr, nrhs, upper);
+      } else {
+        lapackCholeskySolve<scalar_t>(uplo, n, nrhs, A_working_ptr, n, b_working_ptr, n, &info);
+      }
+      infos[i] = info;
     }
-  }
+  });
 #endif
 }
 
@@ -523,15 +790,20 @@ static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  // See Note [Batched linear algebra on small matrices]
+  bool use_small = use_small_matrix_kernels(n);
+  batch_parallel_for(batch_size, n, [&](int64_t start, int64_t end) {
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      if (use_small) {
+        small_matrix_apply<SmallCholesky, scalar_t>(n, self_working_ptr, upper, &info);
+      } else {
+        lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
+      }
+      infos[i] = info;
     }
-  }
+  });
 #endif
 }
 
@@ -587,12 +859,20 @@ static void apply_lu(Tensor& self, Tensor& pivots, Tensor& infos) {
   auto m = self.size(-2);
   auto n = self.size(-1);
 
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    int* pivots_working_ptr = &pivots_data[i * pivots_matrix_stride];
-    int* infos_working_ptr = &infos_data[i];
-    lapackLu<scalar_t>(m, n, self_working_ptr, m, pivots_working_ptr, infos_working_ptr);
-  }
+  // See Note [Batched linear algebra on small matrices]
+  bool use_small = m == n && use_small_matrix_kernels(n);
+  batch_parallel_for(batch_size, std::max(m, n), [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      int* pivots_working_ptr = &pivots_data[i * pivots_matrix_stride];
+      int* infos_working_ptr = &infos_data[i];
+      if (use_small) {
+        small_matrix_apply<SmallLu, scalar_t>(n, self_working_ptr, pivots_working_ptr, infos_working_ptr);
+      } else {
+        lapackLu<scalar_t>(m, n, self_working_ptr, m, pivots_working_ptr, infos_working_ptr);
+      }
+    }
+  });
 #endif
 }
 
@@ -648,12 +928,21 @@ static void apply_triangular_solve(Tensor& b, Tensor& A, bool upper, bool transp
   auto n = A.size(-2);
   auto nrhs = b.size(-1);
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-    scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-    lapackTriangularSolve<scalar_t>(uplo, trans, diag, n, nrhs, A_working_ptr, n, b_working_ptr, n, &info);
-  }
+  // See Note [Batched linear algebra on small matrices]
+  bool use_small = use_small_matrix_kernels(n);
+  batch_parallel_for(batch_size, n, [&](int64_t start, int64_t end) {
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+      if (use_small) {
+        small_matrix_apply<SmallTriangularSolve, scalar_t>(n, static_cast<const scalar_t*>(A_working_ptr), b_working_ptr, nrhs,
+                                                           upper, trans, unitriangular, &info);
+      } else {
+        lapackTriangularSolve<scalar_t>(uplo, trans, diag, n, nrhs, A_working_ptr, n, b_working_ptr, n, &info);
+      }
+    }
+  });
 #endif
 }
 
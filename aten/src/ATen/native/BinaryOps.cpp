@@ -7,6 +7,7 @@
 #include <ATen/MemoryOverlap.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/xnnpack/Engine.h>
 
 #include <torch/library.h>
 
@@ -56,6 +57,11 @@ Tensor& add_out(Tensor& result, const Tensor& self, const Tensor& other, Scalar
 }
 
 Tensor add(const Tensor& self, const Tensor& other, Scalar alpha) {
+#if defined(C10_MOBILE)
+  if (xnnpack::use_add(self, other, alpha)) {
+    return xnnpack::add(self, other);
+  }
+#endif
   Tensor result;
   auto iter = TensorIterator::binary_op(result, self, other);
   alpha_check(iter.dtype(), alpha);
@@ -34,6 +34,25 @@ using gemm_fn = void(*)(
 
 DECLARE_DISPATCH(gemm_fn, gemm_stub);
 
+// Strided batched gemm for many small matrices:
+//   c[i] = alpha * (a[i] @ b[i]) + beta * c[i]   for i in [0, batch_size)
+// Unlike gemm, operands are described by tensor strides rather than by BLAS
+// leading dimensions: each of a_strides, b_strides and c_strides holds the
+// {batch, row, column} strides in elements of a (m x k), b (k x n) and
+// c (m x n). A batch stride of 0 shares one matrix with the whole batch.
+// When beta is 0, c is not read. Only float and double are supported.
+// See Note [Batched small gemm]
+using gemm_batched_fn = void(*)(
+    at::ScalarType type,
+    int64_t batch_size, int64_t m, int64_t n, int64_t k,
+    Scalar alpha,
+    const void *a, const int64_t *a_strides,
+    const void *b, const int64_t *b_strides,
+    Scalar beta,
+    void *c, const int64_t *c_strides);
+
+DECLARE_DISPATCH(gemm_batched_fn, gemm_batched_stub);
+
 template <typename scalar_t>
 void gemm(
     TransposeType transa, TransposeType transb,
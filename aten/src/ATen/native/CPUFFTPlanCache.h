@@ -0,0 +1,184 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/utils/ParamsHash.h>
+
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace at { namespace native { namespace detail {
+
+// Plan cache of the CPU FFT backends, the CPU counterpart of
+// native/cuda/CuFFTPlanCache.h. _fft_mkl keeps committed DFTI descriptors in
+// it and, in builds without MKL, the portable backend in native/PocketFFT.cpp
+// keeps its factorizations and twiddle tables.
+
+constexpr int cpu_fft_max_rank = 3;
+
+// This POD struct is used to let us easily compute hashes of the
+// parameters.
+// It will be the **key** to the plan cache.
+struct CPUFFTParams
+{
+  at::ScalarType scalar_type_;
+  int64_t input_sizes_[cpu_fft_max_rank + 2];
+  int64_t input_strides_[cpu_fft_max_rank + 2];
+  uint8_t signal_ndim_;  // between 1 and cpu_fft_max_rank
+  bool complex_input_;
+  bool complex_output_;
+  int64_t signal_sizes_[cpu_fft_max_rank];
+  bool onesided_;
+  bool inverse_;
+  bool normalized_;
+};
+
+// NB: This can't be a constructor, because then CPUFFTParams
+// would not be a POD anymore.
+//
+// A DFTI descriptor bakes in the batch, the strides, the direction and the
+// scale, so MKL needs all of them in the key (with_layout). The portable
+// backend applies those at run time and only keys on the signal, so one plan
+// serves every batch size and layout.
+static inline void setCPUFFTParams(CPUFFTParams* params,
+    const Tensor& input, int64_t signal_ndim, bool complex_input,
+    bool complex_output, bool inverse, IntArrayRef checked_signal_sizes,
+    bool normalized, bool onesided, bool with_layout) {
+
+  memset(params, 0, sizeof(CPUFFTParams));
+  params->scalar_type_ = input.scalar_type();
+  params->signal_ndim_ = (uint8_t) signal_ndim;
+  params->complex_input_ = complex_input;
+  params->complex_output_ = complex_output;
+  for (size_t i = 0; i != checked_signal_sizes.size(); ++i) {
+    params->signal_sizes_[i] = checked_signal_sizes[i];
+  }
+  if (with_layout) {
+    for (int i = 0; i != input.dim(); ++i) {
+      params->input_sizes_[i] = input.size(i);
+      if (input.size(i) != 1) {
+        params->input_strides_[i] = input.stride(i);
+      }
+    }
+    params->onesided_ = onesided;
+    params->inverse_ = inverse;
+    params->normalized_ = normalized;
+  }
+}
+
+// The default max cache size is arbitrary, like CUFFT_DEFAULT_CACHE_SIZE.
+// Users can always configure it via torch.backends.cpu.fft_plan_cache.
+constexpr size_t CPU_FFT_DEFAULT_CACHE_SIZE = 4096;
+
+// Unlike CuFFTParamsLRUCache, this cache is thread-safe on its own: plans are
+// handed out as shared_ptrs so callers run them without holding the cache
+// lock, and an evicted plan stays alive until its last user is done.
+template <typename Plan>
+class CPUFFTParamsLRUCache {
+public:
+  using plan_ptr = std::shared_ptr<Plan>;
+  using kv_t = typename std::pair<CPUFFTParams, plan_ptr>;
+  using map_t = typename std::unordered_map<std::reference_wrapper<CPUFFTParams>,
+                                            typename std::list<kv_t>::iterator,
+                                            ParamsHash<CPUFFTParams>,
+                                            ParamsEqual<CPUFFTParams>>;
+
+  CPUFFTParamsLRUCache() : CPUFFTParamsLRUCache(CPU_FFT_DEFAULT_CACHE_SIZE) {}
+
+  CPUFFTParamsLRUCache(int64_t max_size) {
+    _set_max_size(max_size);
+  }
+
+  // If key is in this cache, return the cached plan. Otherwise, create one
+  // with make_plan(), which it is not holding the lock for, and cache it.
+  template <typename MakePlan>
+  plan_ptr get_or_create(CPUFFTParams key, MakePlan&& make_plan) {
+    {
+      std::lock_guard<std::mutex> guard(_mutex);
+      auto map_it = _cache_map.find(key);
+      // Hit, put to list front
+      if (map_it != _cache_map.end()) {
+        _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
+        return map_it->second->second;
+      }
+    }
+
+    // Miss
+    plan_ptr plan = make_plan();
+    std::lock_guard<std::mutex> guard(_mutex);
+    if (_max_size == 0) {
+      return plan;
+    }
+    // another thread may have made the same plan in the meantime
+    auto map_it = _cache_map.find(key);
+    if (map_it != _cache_map.end()) {
+      _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
+      return map_it->second->second;
+    }
+    // remove if needed
+    if (_usage_list.size() >= _max_size) {
+      _cache_map.erase(_usage_list.back().first);
+      _usage_list.pop_back();
+    }
+    // construct new plan at list front, then insert into _cache_map
+    _usage_list.emplace_front(key, plan);
+    auto kv_it = _usage_list.begin();
+    _cache_map.emplace(std::piecewise_construct,
+                std::forward_as_tuple(kv_it->first),
+                std::forward_as_tuple(kv_it));
+    return plan;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _cache_map.clear();
+    _usage_list.clear();
+  }
+
+  void resize(int64_t new_size) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _set_max_size(new_size);
+    while (_usage_list.size() > _max_size) {
+      _cache_map.erase(_usage_list.back().first);
+      _usage_list.pop_back();
+    }
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _cache_map.size();
+  }
+
+  size_t max_size() {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _max_size;
+  }
+
+private:
+  // Only sets size and does value check. Does not resize the data structures.
+  void _set_max_size(int64_t new_size) {
+    TORCH_CHECK(new_size >= 0,
+             "CPU FFT plan cache size must be non-negative, but got ", new_size);
+    _max_size = static_cast<size_t>(new_size);
+  }
+
+  std::mutex _mutex;
+  std::list<kv_t> _usage_list;
+  map_t _cache_map;
+  size_t _max_size;
+};
+
+// Implemented by whichever CPU backend _fft_mkl uses (native/mkl/SpectralOps.cpp)
+// and called from the native function counterparts in native/SpectralOps.cpp,
+// i.e., _cpu_fft_get_plan_cache_max_size, _cpu_fft_set_plan_cache_max_size,
+// _cpu_fft_get_plan_cache_size, and _cpu_fft_clear_plan_cache.
+int64_t cpu_fft_get_plan_cache_max_size_impl();
+void cpu_fft_set_plan_cache_max_size_impl(int64_t max_size);
+int64_t cpu_fft_get_plan_cache_size_impl();
+void cpu_fft_clear_plan_cache_impl();
+
+}}} // namespace at::native::detail
@@ -0,0 +1,145 @@
+#include <ATen/native/ConvBenchmarkCache.h>
+
+#include <ATen/Parallel.h>
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr CPUConvBackend kAllBackends[] = {
+  CPUConvBackend::Thnn,
+  CPUConvBackend::Mkldnn,
+  CPUConvBackend::Nnpack,
+  CPUConvBackend::Winograd3x3,
+  CPUConvBackend::DirectNHWC,
+  CPUConvBackend::Depthwise3x3Winograd,
+  CPUConvBackend::Depthwise,
+};
+
+constexpr const char* kCacheHeader = "# cpu convolution benchmark cache";
+
+std::mutex cache_mutex;
+
+std::unordered_map<std::string, CPUConvBackend>& cache() {
+  static std::unordered_map<std::string, CPUConvBackend> entries;
+  return entries;
+}
+
+void write_list(std::ostream& out, IntArrayRef values, char separator) {
+  for (size_t i = 0; i < values.size(); i++) {
+    if (i > 0) {
+      out << separator;
+    }
+    out << values[i];
+  }
+}
+
+} // namespace
+
+const char* cpu_conv_backend_name(CPUConvBackend backend) {
+  switch (backend) {
+    case CPUConvBackend::Thnn:
+      return "thnn";
+    case CPUConvBackend::Mkldnn:
+      return "mkldnn";
+    case CPUConvBackend::Nnpack:
+      return "nnpack";
+    case CPUConvBackend::Winograd3x3:
+      return "winograd3x3";
+    case CPUConvBackend::DirectNHWC:
+      return "direct_nhwc";
+    case CPUConvBackend::Depthwise3x3Winograd:
+      return "depthwise3x3_winograd";
+    case CPUConvBackend::Depthwise:
+      return "depthwise";
+  }
+  return "unknown";
+}
+
+std::string cpu_conv_benchmark_key(
+    const Tensor& input, const Tensor& weight, bool has_bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    int64_t groups, bool needs_grad) {
+  // no spaces, the key is the first field of a cache file line
+  std::ostringstream key;
+  key << c10::toString(input.scalar_type())
+      << (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast ? "/nhwc/" : "/nchw/");
+  write_list(key, input.sizes(), 'x');
+  key << '/';
+  write_list(key, weight.sizes(), 'x');
+  key << "/b" << has_bias << "/s";
+  write_list(key, stride, ',');
+  key << "/p";
+  write_list(key, padding, ',');
+  key << "/d";
+  write_list(key, dilation, ',');
+  key << "/g" << groups
+      << "/grad" << needs_grad
+      << "/t" << at::get_num_threads();
+  return key.str();
+}
+
+c10::optional<CPUConvBackend> cpu_conv_benchmark_lookup(const std::string& key) {
+  std::lock_guard<std::mutex> guard(cache_mutex);
+  auto it = cache().find(key);
+  if (it == cache().end()) {
+    return c10::nullopt;
+  }
+  return it->second;
+}
+
+void cpu_conv_benchmark_insert(const std::string& key, CPUConvBackend backend) {
+  std::lock_guard<std::mutex> guard(cache_mutex);
+  cache()[key] = backend;
+}
+
+void save_cpu_conv_benchmark_cache(const std::string& path) {
+  std::ofstream out(path);
+  TORCH_CHECK(out, "save_cpu_conv_benchmark_cache: could not open ", path, " for writing");
+  std::lock_guard<std::mutex> guard(cache_mutex);
+  out << kCacheHeader << "\n";
+  for (const auto& entry : cache()) {
+    out << entry.first << " " << cpu_conv_backend_name(entry.second) << "\n";
+  }
+  TORCH_CHECK(out, "save_cpu_conv_benchmark_cache: failed to write ", path);
+}
+
+void load_cpu_conv_benchmark_cache(const std::string& path) {
+  std::ifstream in(path);
+  TORCH_CHECK(in, "load_cpu_conv_benchmark_cache: could not open ", path);
+  std::unordered_map<std::string, CPUConvBackend> entries;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string key, name;
+    TORCH_CHECK(fields >> key >> name,
+        "load_cpu_conv_benchmark_cache: malformed line in ", path, ": ", line);
+    for (auto backend : kAllBackends) {
+      if (name == cpu_conv_backend_name(backend)) {
+        entries[key] = backend;
+        break;
+      }
+    }
+  }
+  std::lock_guard<std::mutex> guard(cache_mutex);
+  for (const auto& entry : entries) {
+    cache()[entry.first] = entry.second;
+  }
+}
+
+void clear_cpu_conv_benchmark_cache() {
+  std::lock_guard<std::mutex> guard(cache_mutex);
+  cache().clear();
+}
+
+}  // namespace native
+}  // namespace at
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <c10/util/Optional.h>
+
+#include <string>
+
+/*
+  Cache of the CPU convolution backend choices made in benchmark mode, see
+  Note [CPU convolution benchmark] in Convolution.cpp
+*/
+
+namespace at {
+namespace native {
+
+enum class CPUConvBackend : int8_t {
+  Thnn,
+  Mkldnn,
+  Nnpack,
+  Winograd3x3,
+  DirectNHWC,
+  Depthwise3x3Winograd,
+  Depthwise,
+};
+
+const char* cpu_conv_backend_name(CPUConvBackend backend);
+
+// Everything the timing of a convolution depends on: dtype, layout, sizes,
+// parameters, whether autograd is recording and the number of threads.
+std::string cpu_conv_benchmark_key(
+    const Tensor& input, const Tensor& weight, bool has_bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    int64_t groups, bool needs_grad);
+
+c10::optional<CPUConvBackend> cpu_conv_benchmark_lookup(const std::string& key);
+void cpu_conv_benchmark_insert(const std::string& key, CPUConvBackend backend);
+
+// The cache file has one "<key> <backend>" entry per line. Loading merges
+// the entries into the cache, skipping backends this build doesn't know.
+CAFFE2_API void save_cpu_conv_benchmark_cache(const std::string& path);
+CAFFE2_API void load_cpu_conv_benchmark_cache(const std::string& path);
+CAFFE2_API void clear_cpu_conv_benchmark_cache();
+
+}  // namespace native
+}  // namespace at
@@ -1,14 +1,20 @@
 #include <limits>
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
+#include <ATen/native/ConvBenchmarkCache.h>
+#include <ATen/native/cpu/Conv2dKernel.h>
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/native/utils/ParamUtils.h>
 #include <ATen/native/ConvUtils.h>
+#include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/xnnpack/Engine.h>
 
 #include <ATen/Config.h>
 #include <c10/macros/Macros.h>
 
+#include <chrono>
+
 #if AT_NNPACK_ENABLED()
 #include <nnpack.h>
 #endif
@@ -22,6 +28,14 @@ constexpr int MIOPEN_DIM_MAX = 5;
 namespace at { namespace native {
 
 DEFINE_DISPATCH(convolution_depthwise3x3_winograd_stub);
+DEFINE_DISPATCH(conv2d_winograd3x3_stub);
+DEFINE_DISPATCH(conv2d_direct_nhwc_stub);
+
+// Channel limits of the native small channel conv2d kernels, see
+// Note [Small channel conv2d] in cpu/Conv2dKernel.cpp. Past them the
+// unfolded gemm of thnn_conv2d is large enough to be efficient.
+constexpr int64_t kWinogradConvMaxChannels = 128;
+constexpr int64_t kDirectConvMaxChannels = 64;
 
 struct ConvParams {
   std::vector<int64_t> stride;
@@ -43,6 +57,12 @@ struct ConvParams {
   bool is_stride_nonpos() const;
   void view1d_as_2d();
   bool use_cpu_depthwise3x3_winograd(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_depthwise(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool supports_cpu_small_channel_conv2d(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_small_channel_conv2d(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_winograd3x3(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_direct_nhwc(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_benchmark(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
@@ -163,6 +183,107 @@ auto ConvParams::use_cpu_depthwise3x3_winograd(
 #endif
 }
 
+// thnn_conv_depthwise2d on CPU; any kernel size, stride, padding, dilation
+// and depthwise multiplier, with backward, see Note [CPU depthwise conv2d]
+// in cpu/DepthwiseConv2dKernel.cpp.
+auto ConvParams::use_cpu_depthwise(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  auto is_cpu_dense = [&](const at::Tensor& t) {
+    return t.device().type() == c10::DeviceType::CPU &&
+           t.layout() == at::kStrided &&
+           t.scalar_type() == input.scalar_type();
+  };
+  return (input.ndimension() == 4) &&
+         (weight.ndimension() == 4) &&
+         (input.scalar_type() == at::kFloat || input.scalar_type() == at::kDouble) &&
+         is_cpu_dense(input) &&
+         is_cpu_dense(weight) &&
+         (!bias.defined() || is_cpu_dense(bias)) &&
+         (input.size(1) == groups) &&
+         (groups > 1) &&
+         (weight.size(0) % input.size(1) == 0) &&
+         !transposed &&
+         (input.numel() > 0);
+}
+
+// Conditions shared by the native kernels of cpu/Conv2dKernel.h. They
+// compute the forward only, so anything that needs a gradient keeps going
+// through the differentiable ops.
+auto ConvParams::supports_cpu_small_channel_conv2d(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  auto is_cpu_float = [](const at::Tensor& t) {
+    return t.device().type() == c10::DeviceType::CPU &&
+           t.layout() == at::kStrided &&
+           t.scalar_type() == at::kFloat;
+  };
+  const bool needs_grad = at::GradMode::is_enabled() &&
+      (input.requires_grad() || weight.requires_grad() ||
+       (bias.defined() && bias.requires_grad()));
+  return (input.ndimension() == 4) &&
+         (weight.ndimension() == 4) &&
+         is_cpu_float(input) &&
+         is_cpu_float(weight) &&
+         (!bias.defined() || is_cpu_float(bias)) &&
+         (groups == 1) &&
+         !transposed &&
+         (input.numel() > 0) &&
+         !needs_grad;
+}
+
+auto ConvParams::use_cpu_small_channel_conv2d(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  return supports_cpu_small_channel_conv2d(input, weight, bias) &&
+         !use_nnpack(input);
+}
+
+auto ConvParams::use_cpu_winograd3x3(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  return use_cpu_small_channel_conv2d(input, weight, bias) &&
+         (weight.size(2) == 3) &&
+         (weight.size(3) == 3) &&
+         !is_strided() &&
+         !is_dilated() &&
+         (input.size(1) <= kWinogradConvMaxChannels) &&
+         (weight.size(0) <= kWinogradConvMaxChannels);
+}
+
+auto ConvParams::use_cpu_direct_nhwc(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  return use_cpu_small_channel_conv2d(input, weight, bias) &&
+         (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) &&
+         (input.size(1) <= kDirectConvMaxChannels) &&
+         (weight.size(0) <= kDirectConvMaxChannels);
+}
+
+auto ConvParams::use_cpu_benchmark(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  auto is_cpu_dense = [](const at::Tensor& t) {
+    return t.device().type() == c10::DeviceType::CPU &&
+           t.layout() == at::kStrided &&
+           (t.scalar_type() == at::kFloat || t.scalar_type() == at::kDouble);
+  };
+  return at::globalContext().benchmarkCPUConv() &&
+         (input.ndimension() == 4) &&
+         (weight.ndimension() == 4) &&
+         is_cpu_dense(input) &&
+         is_cpu_dense(weight) &&
+         (!bias.defined() || is_cpu_dense(bias)) &&
+         !transposed &&
+         (input.numel() > 0);
+}
+
 auto ConvParams::needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const -> bool {
   constexpr int64_t int_max = std::numeric_limits<int>::max();
   int64_t numel_input = input.numel();
@@ -232,12 +353,20 @@ auto ConvParams::use_mkldnn(const at::Tensor& input, const at::Tensor& weight) c
   if (!at::globalContext().userEnabledMkldnn()) {
     return false;
   }
-  return (input.is_mkldnn()) || // input is mkldnn Tensor
-    (input.options().backend() == at::Backend::CPU &&
-     input.scalar_type() == kFloat && // only on CPU Float Tensors
-     !transposed && // or transposed tensors
-     (groups > 1 || weight.size(2) > 3 || input.size(0) > 1
-      || input.size(0)*input.size(1)*input.size(2)*input.size(3) > 20480)); // for some case, native is faster
+  if (input.is_mkldnn()) { // input is mkldnn Tensor
+    return true;
+  }
+  if (input.options().backend() != at::Backend::CPU || transposed) { // or transposed tensors
+    return false;
+  }
+  // The native CPU convolutions have no bfloat16 kernels, so bfloat16
+  // always uses MKL-DNN where it has them.
+  if (input.scalar_type() == kBFloat16) {
+    return mkldnn_bf16_device_check();
+  }
+  return input.scalar_type() == kFloat && // only on CPU Float Tensors
+    (groups > 1 || weight.size(2) > 3 || input.size(0) > 1
+     || input.size(0)*input.size(1)*input.size(2)*input.size(3) > 20480); // for some case, native is faster
 #endif
   return false;
 }
@@ -549,6 +678,163 @@ static at::Tensor subtensor(at::Tensor& tensor, int dim, int groups, int g) {
   return tensor.narrow(dim, n * g, n).contiguous();
 }
 
+// Note [CPU convolution benchmark]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The CPU backends of _convolution are picked by the heuristics of the
+// use_* predicates, which are tuned on a few machines and can be far off on
+// others. With torch.backends.cpu.benchmark set, the first convolution of a
+// shape instead times every backend able to run it (see
+// cpu_conv_candidates), and the fastest is cached under a key covering
+// everything the timing depends on (cpu_conv_benchmark_key). The cache can
+// be saved to and loaded from a file, so a server can start with the
+// choices of a previous run. The candidates are forward kernels; when
+// autograd is recording, only the differentiable ops are candidates, so
+// the backward follows the backend that was picked.
+
+constexpr int kCPUConvBenchmarkIterations = 3;
+
+static std::vector<CPUConvBackend> cpu_conv_candidates(
+    const ConvParams& params, const Tensor& input, const Tensor& weight, const Tensor& bias) {
+  std::vector<CPUConvBackend> candidates = {CPUConvBackend::Thnn};
+#if AT_MKLDNN_ENABLED()
+  if (at::globalContext().userEnabledMkldnn() && input.scalar_type() == kFloat) {
+    candidates.push_back(CPUConvBackend::Mkldnn);
+  }
+#endif
+#if AT_NNPACK_ENABLED()
+  if (at::_nnpack_available() && input.scalar_type() == kFloat &&
+      params.groups == 1 && !params.is_dilated()) {
+    candidates.push_back(CPUConvBackend::Nnpack);
+  }
+#endif
+  if (params.supports_cpu_small_channel_conv2d(input, weight, bias)) {
+    if (weight.size(2) == 3 && weight.size(3) == 3 &&
+        !params.is_strided() && !params.is_dilated()) {
+      candidates.push_back(CPUConvBackend::Winograd3x3);
+    }
+    // It returns a channels last output, only pick it when the other
+    // backends would too.
+    if (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+      candidates.push_back(CPUConvBackend::DirectNHWC);
+    }
+  }
+  if (params.use_cpu_depthwise3x3_winograd(input, weight, bias)) {
+    candidates.push_back(CPUConvBackend::Depthwise3x3Winograd);
+  }
+  if (params.use_cpu_depthwise(input, weight, bias)) {
+    candidates.push_back(CPUConvBackend::Depthwise);
+  }
+  return candidates;
+}
+
+static Tensor cpu_conv_thnn(
+    const ConvParams& params, const Tensor& input, const Tensor& weight, const Tensor& bias) {
+  auto kernel_size = weight.sizes().slice(2);
+  if (params.is_dilated()) {
+    return at::slow_conv_dilated2d(
+        input, weight, kernel_size, bias, params.stride, params.padding, params.dilation);
+  }
+  return at::thnn_conv2d(input, weight, kernel_size, bias, params.stride, params.padding);
+}
+
+static Tensor cpu_conv_run(
+    CPUConvBackend backend, const ConvParams& params,
+    const Tensor& input_r, const Tensor& weight_r, const Tensor& bias_r) {
+  auto input = input_r;
+  auto weight = weight_r;
+  auto bias = bias_r;
+  switch (backend) {
+#if AT_MKLDNN_ENABLED()
+    case CPUConvBackend::Mkldnn:
+      return at::mkldnn_convolution(
+          input.contiguous(), weight.contiguous(), bias.defined() ? bias.contiguous() : bias,
+          params.padding, params.stride, params.dilation, params.groups);
+#endif
+#if AT_NNPACK_ENABLED()
+    case CPUConvBackend::Nnpack:
+      return at::_nnpack_spatial_convolution(
+          input.contiguous(), weight, bias, params.padding, params.stride);
+#endif
+    case CPUConvBackend::Winograd3x3:
+      return conv2d_winograd3x3_stub(
+          input.device().type(), input, weight, bias, params.padding);
+    case CPUConvBackend::DirectNHWC:
+      return conv2d_direct_nhwc_stub(
+          input.device().type(), input, weight, bias,
+          params.stride, params.padding, params.dilation);
+    case CPUConvBackend::Depthwise3x3Winograd:
+      return convolution_depthwise3x3_winograd_stub(
+          input.device().type(), input, weight, bias,
+          params.stride, params.padding, params.groups);
+    case CPUConvBackend::Depthwise:
+      return at::thnn_conv_depthwise2d(
+          input, weight, weight.sizes().slice(2), bias,
+          params.stride, params.padding, params.dilation);
+    default:
+      break;
+  }
+  input = input.contiguous();
+  if (params.groups == 1) {
+    return cpu_conv_thnn(params, input, weight, bias);
+  }
+  std::vector<Tensor> outputs(params.groups);
+  for (int g = 0; g < params.groups; ++g) {
+    auto input_g = subtensor(input, 1, params.groups, g);
+    auto weight_g = subtensor(weight, 0, params.groups, g);
+    auto bias_g = subtensor(bias, 0, params.groups, g);
+    outputs[g] = cpu_conv_thnn(params, input_g, weight_g, bias_g);
+  }
+  return at::cat(outputs, 1);
+}
+
+// Best of kCPUConvBenchmarkIterations runs after a warm up run. A backend
+// that fails on the shape is left out.
+static CPUConvBackend cpu_conv_benchmark(
+    const std::vector<CPUConvBackend>& candidates, const ConvParams& params,
+    const Tensor& input, const Tensor& weight, const Tensor& bias) {
+  at::NoGradGuard no_grad;
+  CPUConvBackend best = CPUConvBackend::Thnn;
+  double best_time = std::numeric_limits<double>::infinity();
+  for (auto backend : candidates) {
+    double time = std::numeric_limits<double>::infinity();
+    try {
+      cpu_conv_run(backend, params, input, weight, bias);
+      for (int i = 0; i < kCPUConvBenchmarkIterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        cpu_conv_run(backend, params, input, weight, bias);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        time = std::min(time, elapsed.count());
+      }
+    } catch (const c10::Error&) {
+      continue;
+    }
+    if (time < best_time) {
+      best_time = time;
+      best = backend;
+    }
+  }
+  return best;
+}
+
+static Tensor cpu_conv_benchmarked(
+    const ConvParams& params, const Tensor& input, const Tensor& weight, const Tensor& bias) {
+  const bool needs_grad = at::GradMode::is_enabled() &&
+      (input.requires_grad() || weight.requires_grad() ||
+       (bias.defined() && bias.requires_grad()));
+  const auto candidates = cpu_conv_candidates(params, input, weight, bias);
+  const auto key = cpu_conv_benchmark_key(
+      input, weight, bias.defined(), params.stride, params.padding, params.dilation,
+      params.groups, needs_grad);
+  auto backend = cpu_conv_benchmark_lookup(key);
+  // a loaded entry may name a backend this process can't use
+  if (!backend ||
+      std::find(candidates.begin(), candidates.end(), *backend) == candidates.end()) {
+    backend = cpu_conv_benchmark(candidates, params, input, weight, bias);
+    cpu_conv_benchmark_insert(key, *backend);
+  }
+  return cpu_conv_run(*backend, params, input, weight, bias);
+}
+
 
 at::Tensor conv1d(
     const Tensor& input, const Tensor& weight, const Tensor& bias,
@@ -671,7 +957,9 @@ at::Tensor _convolution(
       at::MemoryFormat::ChannelsLast : at::MemoryFormat::Contiguous;
 
   Tensor output;
-  if (params.is_depthwise(input, weight)) {
+  if (params.use_cpu_benchmark(input, weight, bias)) {
+    output = cpu_conv_benchmarked(params, input, weight, bias);
+  } else if (params.is_depthwise(input, weight)) {
       /* output.resize_(output_size(input, weight)); */
 
       auto kernel_size = weight.sizes().slice(2);
@@ -776,6 +1064,31 @@ at::Tensor _convolution(
         params.stride,
         params.padding,
         params.groups);
+  } else if (params.use_cpu_depthwise(input, weight, bias)) {
+    output = at::thnn_conv_depthwise2d(
+        input,
+        weight,
+        weight.sizes().slice(2),
+        bias,
+        params.stride,
+        params.padding,
+        params.dilation);
+  } else if (params.use_cpu_direct_nhwc(input, weight, bias)) {
+    output = conv2d_direct_nhwc_stub(
+        input.device().type(),
+        input,
+        weight,
+        bias,
+        params.stride,
+        params.padding,
+        params.dilation);
+  } else if (params.use_cpu_winograd3x3(input, weight, bias)) {
+    output = conv2d_winograd3x3_stub(
+        input.device().type(),
+        input,
+        weight,
+        bias,
+        params.padding);
   } else if (
         !params.transposed && (input.ndimension() == 5) &&
         (input.device().type() == c10::DeviceType::CPU) &&
@@ -0,0 +1,183 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ConvUtils.h>
+#include <ATen/native/cpu/DepthwiseConvKernel.h>
+
+#include <tuple>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(conv_depthwise2d_stub);
+DEFINE_DISPATCH(conv_depthwise2d_backward_input_stub);
+DEFINE_DISPATCH(conv_depthwise2d_backward_weight_stub);
+
+namespace {
+
+// CPU thnn_conv_depthwise2d, see Note [CPU depthwise conv2d] in
+// cpu/DepthwiseConv2dKernel.cpp
+
+void conv_depthwise2d_shape_check(
+    const Tensor& input,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  TORCH_CHECK(
+      input.dim() == 4,
+      "thnn_conv_depthwise2d: expected 4D input, but got input of size ", input.sizes());
+  TORCH_CHECK(
+      weight.dim() == 4 && weight.size(1) == 1,
+      "thnn_conv_depthwise2d: expected weight of size [out_channels, 1, kH, kW], but got ",
+      weight.sizes());
+  TORCH_CHECK(
+      input.size(1) > 0 && weight.size(0) % input.size(1) == 0,
+      "thnn_conv_depthwise2d: expected out_channels (", weight.size(0),
+      ") to be a multiple of the input channels (", input.size(1), ")");
+  TORCH_CHECK(
+      kernel_size.size() == 2 && kernel_size[0] == weight.size(2) &&
+          kernel_size[1] == weight.size(3),
+      "thnn_conv_depthwise2d: kernel_size ", kernel_size,
+      " doesn't match the weight of size ", weight.sizes());
+  TORCH_CHECK(
+      stride.size() == 2 && stride[0] > 0 && stride[1] > 0,
+      "thnn_conv_depthwise2d: expected positive stride, but got ", stride);
+  TORCH_CHECK(
+      padding.size() == 2 && padding[0] >= 0 && padding[1] >= 0,
+      "thnn_conv_depthwise2d: expected non-negative padding, but got ", padding);
+  TORCH_CHECK(
+      dilation.size() == 2 && dilation[0] > 0 && dilation[1] > 0,
+      "thnn_conv_depthwise2d: expected positive dilation, but got ", dilation);
+  TORCH_CHECK(
+      input.scalar_type() == weight.scalar_type(),
+      "thnn_conv_depthwise2d: expected input and weight of the same dtype, but got ",
+      input.scalar_type(), " and ", weight.scalar_type());
+  const auto output_size = conv_output_size(
+      input.sizes(), weight.sizes(), padding, stride, dilation);
+  TORCH_CHECK(
+      output_size[2] > 0 && output_size[3] > 0,
+      "thnn_conv_depthwise2d: input of size ", input.sizes(),
+      " is too small for the kernel, output size would be ", output_size);
+}
+
+// The channels last kernels have no depthwise multiplier.
+at::MemoryFormat conv_depthwise2d_memory_format(const Tensor& input, const Tensor& weight) {
+  return (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast &&
+          weight.size(0) == input.size(1))
+      ? at::MemoryFormat::ChannelsLast
+      : at::MemoryFormat::Contiguous;
+}
+
+} // namespace
+
+Tensor& thnn_conv_depthwise2d_forward_out_cpu(
+    Tensor& output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  conv_depthwise2d_shape_check(self, weight, kernel_size, stride, padding, dilation);
+  TORCH_CHECK(
+      !bias.defined() || (bias.dim() == 1 && bias.size(0) == weight.size(0)),
+      "thnn_conv_depthwise2d: expected bias of size [", weight.size(0), "], but got ",
+      bias.sizes());
+
+  const auto memory_format = conv_depthwise2d_memory_format(self, weight);
+  const Tensor input = self.contiguous(memory_format);
+  output.resize_(
+      conv_output_size(input.sizes(), weight.sizes(), padding, stride, dilation),
+      memory_format);
+  if (output.numel() == 0) {
+    return output;
+  }
+  conv_depthwise2d_stub(
+      kCPU, output, input, weight, bias, stride, padding, dilation);
+  return output;
+}
+
+Tensor thnn_conv_depthwise2d_forward_cpu(
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  Tensor output = at::empty({0}, self.options());
+  thnn_conv_depthwise2d_forward_out_cpu(
+      output, self, weight, kernel_size, bias, stride, padding, dilation);
+  return output;
+}
+
+std::tuple<Tensor&, Tensor&> thnn_conv_depthwise2d_backward_out_cpu(
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    const Tensor& grad_output_,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  conv_depthwise2d_shape_check(self, weight, kernel_size, stride, padding, dilation);
+  const auto output_size = conv_output_size(
+      self.sizes(), weight.sizes(), padding, stride, dilation);
+  TORCH_CHECK(
+      grad_output_.sizes() == IntArrayRef(output_size),
+      "thnn_conv_depthwise2d_backward: expected grad_output of size ", output_size,
+      ", but got ", grad_output_.sizes());
+
+  const auto memory_format = conv_depthwise2d_memory_format(self, weight);
+  const Tensor grad_output = grad_output_.contiguous(memory_format);
+  if (grad_input.defined()) {
+    grad_input.resize_(self.sizes(), memory_format);
+    if (grad_input.numel() > 0) {
+      conv_depthwise2d_backward_input_stub(
+          kCPU, grad_input, grad_output, weight, stride, padding, dilation);
+    }
+  }
+  if (grad_weight.defined()) {
+    grad_weight.resize_(weight.sizes(), at::MemoryFormat::Contiguous);
+    if (grad_output.numel() == 0) {
+      grad_weight.zero_();
+    } else {
+      conv_depthwise2d_backward_weight_stub(
+          kCPU, grad_weight, grad_output, self.contiguous(memory_format),
+          stride, padding, dilation);
+    }
+  }
+  return std::tuple<Tensor&, Tensor&>(grad_input, grad_weight);
+}
+
+std::tuple<Tensor, Tensor> thnn_conv_depthwise2d_backward_cpu(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    std::array<bool, 2> output_mask) {
+  Tensor grad_input;
+  Tensor grad_weight;
+
+  if (output_mask[0]) {
+    grad_input = at::empty({0}, grad_output.options());
+  }
+
+  if (output_mask[1]) {
+    grad_weight = at::empty({0}, grad_output.options());
+  }
+
+  thnn_conv_depthwise2d_backward_out_cpu(
+      grad_input, grad_weight, grad_output, self, weight,
+      kernel_size, stride, padding, dilation);
+  return std::make_tuple(grad_input, grad_weight);
+}
+
+} // namespace native
+} // namespace at
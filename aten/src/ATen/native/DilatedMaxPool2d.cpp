@@ -9,6 +9,9 @@
 namespace at {
 namespace native {
 
+DEFINE_DISPATCH(max_pool2d_channels_last_kernel);
+DEFINE_DISPATCH(max_pool2d_channels_last_backward_kernel);
+
 namespace {
 
 template <typename scalar_t>
@@ -171,6 +174,16 @@ void max_pool2d_with_indices_out_cpu_template(
     inputHeight, inputWidth,
     outputHeight, outputWidth);
 
+  if (use_channels_last_pool2d(input_)) {
+    output.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+    /* indices will contain the locations for each output point */
+    indices.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+    max_pool2d_channels_last_kernel(
+        kCPU, output, indices, input_,
+        kW, kH, dW, dH, padW, padH, dilationW, dilationH);
+    return;
+  }
+
   /* get contiguous input */
   Tensor input = input_.contiguous();
 
@@ -333,11 +346,17 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
   TORCH_CHECK((input.ndimension() == 3 || input.ndimension() == 4),
     "non-empty 3D or 4D (batch mode) tensor expected for input");
 
+  const bool channels_last = use_channels_last_pool2d(input);
+
   /* get contiguous gradOutput */
-  const Tensor gradOutput = gradOutput_.contiguous();
+  const Tensor gradOutput = channels_last ? gradOutput_ : gradOutput_.contiguous();
 
   /* resize */
-  gradInput.resize_as_(input);
+  if (channels_last) {
+    gradInput.resize_(input.sizes(), at::MemoryFormat::ChannelsLast);
+  } else {
+    gradInput.resize_as_(input);
+  }
   gradInput.zero_();
 
   /* sizes */
@@ -363,7 +382,11 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
     outputHeight_for_shape_check, outputWidth_for_shape_check);
 
   /* backprop */
-  if (input.ndimension() == 3)
+  if (channels_last)
+  {
+    max_pool2d_channels_last_backward_kernel(kCPU, gradInput, gradOutput, indices);
+  }
+  else if (input.ndimension() == 3)
   {
     AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
       "max_pool2d_with_indices_backward",
@@ -3,6 +3,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/native/Distance.h>
 
 namespace at { namespace native {
@@ -135,6 +136,83 @@ Tensor _cdist_forward(const Tensor& x1, const Tensor& x2, const double p, c10::o
   return result;
 }
 
+// cdist_topk keeps the distances of a tile of kCdistTopkRowTile rows of x1 to
+// about kCdistTopkTileElements / kCdistTopkRowTile rows of x2 at a time.
+constexpr int64_t kCdistTopkRowTile = 1024;
+constexpr int64_t kCdistTopkTileElements = 1 << 22;
+
+// Returns the distances and indices of the k nearest rows of x2 to each row
+// of x1, nearest first. The distance matrix is computed a tile at a time and
+// merged into a running top k per row, so memory stays O(r1 * k) rather than
+// O(r1 * r2). The selection is not differentiated; the distances of the
+// selected pairs are then recomputed directly, which makes them exact for
+// p = 2 and differentiable through norm.
+std::tuple<Tensor, Tensor> _cdist_topk(const Tensor& x1, const Tensor& x2, int64_t k, const double p) {
+  TORCH_CHECK(x1.dim() >= 2, "cdist_topk only supports at least 2D tensors, X1 got: ", x1.dim(), "D");
+  TORCH_CHECK(x2.dim() >= 2, "cdist_topk only supports at least 2D tensors, X2 got: ", x2.dim(), "D");
+  TORCH_CHECK(x1.size(-1) == x2.size(-1), "X1 and X2 must have the same number of columns. X1: ", x1.size(-1), " X2: ", x2.size(-1));
+  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), "cdist_topk only supports floating-point dtypes, X1 got: ", x1.scalar_type());
+  TORCH_CHECK(x1.scalar_type() == x2.scalar_type(), "X1 and X2 must have the same dtype. X1: ", x1.scalar_type(), " X2: ", x2.scalar_type());
+  TORCH_CHECK(p >= 0, "cdist_topk only supports non-negative p values");
+  const int64_t r1 = x1.size(-2);
+  const int64_t r2 = x2.size(-2);
+  const int64_t c = x1.size(-1);
+  TORCH_CHECK(k >= 0 && k <= r2, "cdist_topk: k (", k, ") must be between 0 and the number of rows of X2 (", r2, ")");
+
+  IntArrayRef batch_tensor1(x1.sizes().data(), x1.dim() - 2);
+  IntArrayRef batch_tensor2(x2.sizes().data(), x2.dim() - 2);
+  std::vector<int64_t> expand_batch_portion = infer_size(batch_tensor1, batch_tensor2);
+  const int64_t batch = std::accumulate(expand_batch_portion.begin(), expand_batch_portion.end(), 1, std::multiplies<int64_t>());
+  std::vector<int64_t> tensor1_expand_size(expand_batch_portion);
+  tensor1_expand_size.insert(tensor1_expand_size.end(), {r1, c});
+  std::vector<int64_t> tensor2_expand_size(expand_batch_portion);
+  tensor2_expand_size.insert(tensor2_expand_size.end(), {r2, c});
+  const Tensor tensor1 = x1.expand(tensor1_expand_size).reshape({batch, r1, c});
+  const Tensor tensor2 = x2.expand(tensor2_expand_size).reshape({batch, r2, c});
+
+  Tensor indices = at::empty({batch, r1, k}, x1.options().dtype(kLong));
+  if (k > 0) {
+    at::NoGradGuard no_grad;
+    const int64_t row_tile = std::min(r1, kCdistTopkRowTile);
+    const int64_t col_tile = std::max(k, kCdistTopkTileElements / std::max<int64_t>(row_tile, 1));
+    const c10::optional<int64_t> compute_mode =
+        p == 2 ? c10::optional<int64_t>(1) : c10::nullopt;
+    for (int64_t row = 0; row < r1; row += row_tile) {
+      const int64_t rows = std::min(row_tile, r1 - row);
+      const Tensor tile1 = tensor1.narrow(1, row, rows);
+      Tensor best_dist;
+      Tensor best_idx;
+      for (int64_t col = 0; col < r2; col += col_tile) {
+        const int64_t cols = std::min(col_tile, r2 - col);
+        Tensor dist = at::cdist(tile1, tensor2.narrow(1, col, cols), p, compute_mode);
+        Tensor idx = at::arange(col, col + cols, indices.options()).expand({batch, rows, cols});
+        if (best_dist.defined()) {
+          dist = at::cat({best_dist, dist}, -1);
+          idx = at::cat({best_idx, idx}, -1);
+        }
+        Tensor top_idx;
+        std::tie(best_dist, top_idx) = dist.topk(
+            std::min(k, dist.size(-1)), -1, /*largest=*/false, /*sorted=*/false);
+        best_idx = idx.gather(-1, top_idx);
+      }
+      indices.narrow(1, row, rows).copy_(best_idx);
+    }
+  }
+
+  const Tensor flat_indices =
+      (indices + at::arange(batch, indices.options()).mul_(r2).view({batch, 1, 1})).view(-1);
+  const Tensor neighbours =
+      tensor2.reshape({batch * r2, c}).index_select(0, flat_indices).view({batch, r1, k, c});
+  Tensor values = at::norm(tensor1.unsqueeze(2) - neighbours, p, -1);
+  Tensor order;
+  std::tie(values, order) = values.sort(-1);
+  indices = indices.gather(-1, order);
+
+  std::vector<int64_t> output_shape(expand_batch_portion);
+  output_shape.insert(output_shape.end(), {r1, k});
+  return std::make_tuple(values.view(output_shape), indices.view(output_shape));
+}
+
 Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& cdist) {
   TORCH_CHECK(x1.is_contiguous(), "_cdist_backward requires X1 to be contiguous");
   TORCH_CHECK(x2.is_contiguous(), "_cdist_backward requires X2 to be contiguous");
@@ -118,6 +118,7 @@ DEFINE_DISPATCH(bernoulli_scalar_stub);
 DEFINE_DISPATCH(cauchy_stub);
 DEFINE_DISPATCH(exponential_stub);
 DEFINE_DISPATCH(multinomial_stub);
+DEFINE_DISPATCH(multinomial_alias_draw_stub);
 DEFINE_DISPATCH(geometric_stub);
 DEFINE_DISPATCH(log_normal_stub);
 DEFINE_DISPATCH(uniform_stub);
@@ -490,4 +491,96 @@ Tensor multinomial(const Tensor& self, int64_t n_sample, bool with_replacement,
   return result;
 }
 
+// Builds the tables of Walker's alias method: category i is drawn with
+// probability q[i] / n_categories directly, and with probability
+// (1 - q[i]) / n_categories as the alias of J[i], so that drawing a sample
+// from the tables takes O(1). See _multinomial_alias_draw.
+std::tuple<Tensor, Tensor> _multinomial_alias_setup_cpu(const Tensor& probs) {
+  TORCH_CHECK(probs.dim() == 1,
+      "expected 1-D probability tensor, got ", probs.dim(), "-D probability tensor instead");
+  const int64_t inputsize = probs.numel();
+  Tensor J = at::empty({inputsize}, probs.options().dtype(kLong));
+  Tensor q = at::empty({inputsize}, probs.options());
+
+  AT_DISPATCH_FLOATING_TYPES(probs.scalar_type(), "multinomial_alias_setup_cpu", [&] {
+    const Tensor probs_contig = probs.contiguous();
+    const scalar_t* const probs_data = probs_contig.data_ptr<scalar_t>();
+    scalar_t* const q_data = q.data_ptr<scalar_t>();
+    int64_t* const J_data = J.data_ptr<int64_t>();
+    std::vector<int64_t> smaller(inputsize);
+    std::vector<int64_t> larger(inputsize);
+    int64_t small_c = 0;
+    int64_t large_c = 0;
+
+    for (int64_t i = 0; i < inputsize; i++) {
+      J_data[i] = -1;
+      q_data[i] = inputsize * probs_data[i];
+      if (q_data[i] < 1.0) {
+        smaller[small_c++] = i;
+      } else {
+        larger[large_c++] = i;
+      }
+    }
+
+    // Loop through and create little binary mixtures that
+    // appropriately allocate the larger outcomes over the
+    // overall uniform mixture.
+    while (small_c > 0 && large_c > 0) {
+      const int64_t large = larger[large_c - 1];
+      const int64_t small = smaller[small_c - 1];
+
+      J_data[small] = large;
+      q_data[large] -= 1.0 - q_data[small];
+
+      if (q_data[large] < 1.0) {
+        smaller[small_c - 1] = large;
+        large_c -= 1;
+      } else {
+        larger[large_c - 1] = large;
+        small_c -= 1;
+      }
+    }
+
+    scalar_t q_min = q_data[inputsize - 1];
+    scalar_t q_max = q_min;
+    for (int64_t i = 0; i < inputsize; i++) {
+      q_min = std::min(q_min, q_data[i]);
+      q_max = std::max(q_max, q_data[i]);
+    }
+    TORCH_CHECK(q_min >= 0, "q_min is less than 0");
+
+    for (int64_t i = 0; i < inputsize; i++) {
+      // sometimes an large index isn't added to J.
+      // fix it by making the probability 1 so that J isn't indexed.
+      if (J_data[i] < 0) {
+        q_data[i] = 1.0;
+      } else if (q_max > 1) {
+        q_data[i] /= q_max;
+      }
+    }
+  });
+  return std::make_tuple(J, q);
+}
+
+// Draws num_samples categories from the tables of _multinomial_alias_setup:
+// a uniformly random category i, or its alias J[i] with probability 1 - q[i].
+Tensor _multinomial_alias_draw(const Tensor& q, const Tensor& J, int64_t n_sample, c10::optional<Generator> gen) {
+  TORCH_CHECK(q.dim() == 1,
+      "expected 1-D probability table, got ", q.dim(), "-D probability table instead");
+  TORCH_CHECK(J.dim() == 1,
+      "expected 1-D alias table, got ", J.dim(), "-D alias table instead");
+  TORCH_CHECK(n_sample > 0, "cannot sample <= 0 samples");
+  TORCH_CHECK(at::isFloatingType(q.scalar_type()),
+      "expected a floating-point probability table, got: ", q.scalar_type());
+  TORCH_CHECK(J.scalar_type() == ScalarType::Long,
+      "expected a Long alias table, got: ", J.scalar_type());
+  TORCH_CHECK(q.device() == J.device(), "_multinomial_alias_draw arguments must have the same device");
+  TORCH_CHECK(q.numel() == J.numel() && J.numel() > 0,
+      "expected probability and alias tables of the same, nonzero size, got ",
+      q.numel(), " and ", J.numel());
+  Tensor result = at::empty({n_sample}, J.options());
+  multinomial_alias_draw_stub(result.device().type(), result, q.contiguous(), J.contiguous(), gen);
+  return result;
+}
+
 }} // namespace at::native
@@ -0,0 +1,128 @@
+#include <ATen/ATen.h>
+#include <ATen/native/ForeachUtils.h>
+
+namespace at { namespace native {
+
+// Slow paths of the _foreach_ ops: one regular op call per tensor. They serve
+// CPU tensors and the CUDA inputs the multi tensor apply kernels can't handle
+// (see can_use_fast_route).
+
+#define FOREACH_BINARY_OP_SCALAR(NAME)                                                                \
+void foreach_tensor_##NAME##_scalar_kernel_slow_(TensorList tensors, Scalar scalar) {                 \
+  check_foreach_api_restrictions(tensors);                                                            \
+                                                                                                      \
+  for (auto& t: tensors) {                                                                            \
+    t.NAME##_(scalar);                                                                                \
+  }                                                                                                   \
+}                                                                                                     \
+                                                                                                      \
+std::vector<Tensor> foreach_tensor_##NAME##_scalar_kernel_slow(TensorList tensors, Scalar scalar) {   \
+  check_foreach_api_restrictions(tensors);                                                            \
+                                                                                                      \
+  std::vector<Tensor> result;                                                                         \
+  result.reserve(tensors.size());                                                                     \
+  for (const auto& t: tensors) {                                                                      \
+    result.emplace_back(t.NAME(scalar));                                                              \
+  }                                                                                                   \
+                                                                                                      \
+  return result;                                                                                      \
+}
+
+#define FOREACH_BINARY_OP_LIST(NAME)                                                                  \
+void foreach_tensor_##NAME##_list_kernel_slow_(TensorList tensors1, TensorList tensors2) {            \
+  check_foreach_api_restrictions(tensors1, tensors2);                                                 \
+                                                                                                      \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                      \
+    tensors1[i].NAME##_(tensors2[i]);                                                                 \
+  }                                                                                                   \
+}                                                                                                     \
+                                                                                                      \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_slow(TensorList tensors1, TensorList tensors2) { \
+  check_foreach_api_restrictions(tensors1, tensors2);                                                 \
+                                                                                                      \
+  std::vector<Tensor> result;                                                                         \
+  result.reserve(tensors1.size());                                                                    \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                      \
+    result.emplace_back(tensors1[i].NAME(tensors2[i]));                                               \
+  }                                                                                                   \
+                                                                                                      \
+  return result;                                                                                      \
+}
+
+#define FOREACH_BINARY_OP_LIST_ALPHA(NAME)                                                            \
+void foreach_tensor_##NAME##_list_kernel_slow_(TensorList tensors1, TensorList tensors2, Scalar alpha) { \
+  check_foreach_api_restrictions(tensors1, tensors2);                                                 \
+                                                                                                      \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                      \
+    tensors1[i].NAME##_(tensors2[i], alpha);                                                          \
+  }                                                                                                   \
+}                                                                                                     \
+                                                                                                      \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_slow(TensorList tensors1, TensorList tensors2, Scalar alpha) { \
+  check_foreach_api_restrictions(tensors1, tensors2);                                                 \
+                                                                                                      \
+  std::vector<Tensor> result;                                                                         \
+  result.reserve(tensors1.size());                                                                    \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                      \
+    result.emplace_back(tensors1[i].NAME(tensors2[i], alpha));                                        \
+  }                                                                                                   \
+                                                                                                      \
+  return result;                                                                                      \
+}
+
+#define FOREACH_UNARY_OP(NAME)                                                                        \
+void foreach_tensor_##NAME##_slow_(TensorList tensors) {                                              \
+  check_foreach_api_restrictions(tensors);                                                            \
+                                                                                                      \
+  for (auto& t : tensors) {                                                                           \
+    t.NAME##_();                                                                                      \
+  }                                                                                                   \
+}                                                                                                     \
+                                                                                                      \
+std::vector<Tensor> foreach_tensor_##NAME##_slow(TensorList tensors) {                                \
+  check_foreach_api_restrictions(tensors);                                                            \
+                                                                                                      \
+  std::vector<Tensor> result;                                                                         \
+  result.reserve(tensors.size());                                                                     \
+  for (const auto& t : tensors) {                                                                     \
+    result.emplace_back(t.NAME());                                                                    \
+  }                                                                                                   \
+                                                                                                      \
+  return result;                                                                                      \
+}
+
+#define FOREACH_POINTWISE_OP(NAME)                                                                    \
+void foreach_tensor_##NAME##_slow_(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) { \
+  check_foreach_api_restrictions(input, tensors1, tensors2);                                          \
+                                                                                                      \
+  for (size_t i = 0; i < input.size(); i++) {                                                         \
+    input[i].NAME##_(tensors1[i], tensors2[i], scalar);                                               \
+  }                                                                                                   \
+}                                                                                                     \
+                                                                                                      \
+std::vector<Tensor> foreach_tensor_##NAME##_slow(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) { \
+  check_foreach_api_restrictions(input, tensors1, tensors2);                                          \
+                                                                                                      \
+  std::vector<Tensor> result;                                                                         \
+  result.reserve(input.size());                                                                       \
+  for (size_t i = 0; i < input.size(); i++) {                                                         \
+    result.emplace_back(input[i].NAME(tensors1[i], tensors2[i], scalar));                             \
+  }                                                                                                   \
+                                                                                                      \
+  return result;                                                                                      \
+}
+
+FOREACH_BINARY_OP_SCALAR(add);
+FOREACH_BINARY_OP_SCALAR(sub);
+FOREACH_BINARY_OP_SCALAR(mul);
+FOREACH_BINARY_OP_SCALAR(div);
+FOREACH_BINARY_OP_LIST_ALPHA(add);
+FOREACH_BINARY_OP_LIST_ALPHA(sub);
+FOREACH_BINARY_OP_LIST(mul);
+FOREACH_BINARY_OP_LIST(div);
+FOREACH_UNARY_OP(sqrt);
+FOREACH_UNARY_OP(exp);
+FOREACH_POINTWISE_OP(addcmul);
+FOREACH_POINTWISE_OP(addcdiv);
+
+}} // namespace at::native
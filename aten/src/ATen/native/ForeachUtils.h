@@ -0,0 +1,75 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at {
+namespace native {
+
+// Checks shared by the CPU and CUDA implementations of the _foreach_ ops.
+inline void check_foreach_api_restrictions(TensorList tensors) {
+  TORCH_CHECK(tensors.size() > 0, "Tensor list must have at least one tensor.");
+}
+
+inline void check_foreach_api_restrictions(TensorList tensors1, TensorList tensors2) {
+  TORCH_CHECK(tensors1.size() > 0, "Tensor list must have at least one tensor.");
+  TORCH_CHECK(tensors1.size() == tensors2.size(),
+              "Tensor lists must have the same number of tensors, got ",
+              tensors1.size(), " and ", tensors2.size());
+
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    TORCH_CHECK(tensors1[i].sizes() == tensors2[i].sizes(),
+                "Corresponding tensors in lists must have the same size, got ",
+                tensors1[i].sizes(), " and ", tensors2[i].sizes());
+  }
+}
+
+inline void check_foreach_api_restrictions(TensorList tensors1, TensorList tensors2, TensorList tensors3) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+  check_foreach_api_restrictions(tensors1, tensors3);
+}
+
+// The multi tensor apply kernels walk every tensor as one flat array of
+// elements, so they may only be used when all the tensors are strided,
+// non-overlapping and dense CUDA tensors of the same dtype on the same device,
+// and corresponding tensors of different lists have the same strides.
+// Anything else, including ops that would need type promotion and the dtypes
+// the kernels don't dispatch (Bool, BFloat16, complex), takes the slow
+// per-tensor path.
+inline bool can_use_fast_route(TensorList tensors1, TensorList tensors2 = {}, TensorList tensors3 = {}) {
+  auto expected_device = tensors1[0].device();
+  auto expected_dtype = tensors1[0].scalar_type();
+  if (expected_device.type() != at::kCUDA || expected_dtype == at::kBool ||
+      expected_dtype == at::kBFloat16 || at::isComplexType(expected_dtype)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    for (const TensorList& list : {tensors1, tensors2, tensors3}) {
+      if (list.empty()) {
+        continue;
+      }
+      const auto& t = list[i];
+      if (t.layout() != at::kStrided ||
+          t.device() != expected_device ||
+          t.scalar_type() != expected_dtype ||
+          !t.is_non_overlapping_and_dense() ||
+          t.strides() != tensors1[i].strides()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+inline bool can_use_fast_route(TensorList tensors, Scalar scalar) {
+  if (!can_use_fast_route(tensors)) {
+    return false;
+  }
+  // An integral tensor combined with a floating point scalar promotes.
+  auto dtype = tensors[0].scalar_type();
+  return !scalar.isComplex() &&
+         !(at::isIntegralType(dtype, /*includeBool=*/true) && scalar.isFloatingPoint());
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,80 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+
+#include <ATen/native/IncrementalAttention.h>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(incremental_attention_stub);
+
+// Decoding a sequence one step at a time attends a single new query to the
+// keys and values of all the steps so far. Growing the caches with cat and
+// computing the attention with bmm, softmax and bmm copies the whole cache
+// and makes three passes over it every step; here the caches grow in place
+// by append_, and one kernel computes the scores, their softmax and the
+// weighted sum of the values for each (batch, head) in a single pass.
+Tensor _incremental_attention(
+    const Tensor& query,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& key,
+    const Tensor& value,
+    c10::optional<double> scale) {
+  TORCH_CHECK(
+      query.dim() == 2,
+      "_incremental_attention: expected query of size (batch * heads, ",
+      "head_dim), but got ",
+      query.sizes());
+  TORCH_CHECK(
+      key_cache.dim() == 3 && value_cache.dim() == 3,
+      "_incremental_attention: expected caches of size (steps, batch * heads, ",
+      "head_dim), but got ",
+      key_cache.sizes(),
+      " and ",
+      value_cache.sizes());
+  TORCH_CHECK(
+      key_cache.size(1) == query.size(0) &&
+          key_cache.size(2) == query.size(1) &&
+          value_cache.size(1) == query.size(0),
+      "_incremental_attention: caches of size ",
+      key_cache.sizes(),
+      " and ",
+      value_cache.sizes(),
+      " do not match query of size ",
+      query.sizes());
+  TORCH_CHECK(
+      query.device() == key_cache.device() &&
+          query.device() == value_cache.device(),
+      "_incremental_attention: expected query and caches on the same device");
+  TORCH_CHECK(
+      query.scalar_type() == key_cache.scalar_type() &&
+          query.scalar_type() == value_cache.scalar_type(),
+      "_incremental_attention: expected query and caches of the same dtype");
+
+  key_cache.append_(key);
+  value_cache.append_(value);
+  TORCH_CHECK(
+      key_cache.size(0) == value_cache.size(0) && key_cache.size(0) > 0,
+      "_incremental_attention: expected as many key as value steps, but got ",
+      key_cache.size(0),
+      " and ",
+      value_cache.size(0));
+
+  Tensor out = at::empty(
+      {query.size(0), value_cache.size(2)}, query.options());
+  if (out.numel() == 0) {
+    return out;
+  }
+  incremental_attention_stub(
+      query.device().type(),
+      out,
+      query.contiguous(),
+      key_cache,
+      value_cache,
+      scale ? *scale : 1.0 / std::sqrt(static_cast<double>(query.size(1))));
+  return out;
+}
+
+}} // namespace at::native
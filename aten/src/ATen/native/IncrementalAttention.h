@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// out[n] = softmax(scale * key_cache[:, n] . query[n]) . value_cache[:, n]
+using incremental_attention_fn = void(*)(
+    Tensor& out,
+    const Tensor& query,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    double scale);
+
+DECLARE_DISPATCH(incremental_attention_fn, incremental_attention_stub);
+
+}} // namespace at::native
@@ -1,5 +1,8 @@
 #include <ATen/ATen.h>
+#include <ATen/Config.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
+#include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/xnnpack/Engine.h>
 #include <ATen/WrapDimUtilsMulti.h>
 #include <c10/macros/Macros.h>
@@ -13,8 +16,28 @@
 
 namespace at { namespace native {
 
+// The CPU addmm has no fast bfloat16 kernel, but MKL-DNN's inner product
+// does. mkldnn_linear has no derivative for dense tensors though, so this is
+// only for tensors that don't need gradients, e.g. the weights autocast
+// casts to bfloat16 for inference.
+static bool use_mkldnn_bf16_linear(const Tensor& input, const Tensor& weight, const Tensor& bias) {
+#if AT_MKLDNN_ENABLED()
+  const auto is_dense_cpu_bf16 = [](const Tensor& t) {
+    return t.device().is_cpu() && t.layout() == kStrided &&
+        t.scalar_type() == kBFloat16 && !(GradMode::is_enabled() && t.requires_grad());
+  };
+  return at::globalContext().userEnabledMkldnn() &&
+      input.dim() >= 2 && weight.dim() == 2 && input.numel() > 0 &&
+      is_dense_cpu_bf16(input) && is_dense_cpu_bf16(weight) &&
+      (!bias.defined() || (bias.dim() == 1 && is_dense_cpu_bf16(bias))) &&
+      mkldnn_bf16_device_check();
+#else
+  return false;
+#endif
+}
+
 Tensor linear(const Tensor& input, const Tensor& weight, const Tensor& bias) {
-  if (input.is_mkldnn()) {
+  if (input.is_mkldnn() || use_mkldnn_bf16_linear(input, weight, bias)) {
     return at::mkldnn_linear(input, weight, bias);
   }
 #if defined(C10_MOBILE)
@@ -26,6 +49,15 @@ Tensor linear(const Tensor& input, const Tensor& weight, const Tensor& bias) {
     // Fused op is marginally faster.
     return at::addmm(bias, input, weight.t());
   }
+  if (input.dim() > 2 && bias.defined() && bias.dim() == 1 &&
+      input.is_contiguous() && input.numel() > 0 && !input.has_names()) {
+    // The batch dimensions of a contiguous input fold into the rows of a
+    // single addmm, which on CUDA adds the bias in the epilogue of the matmul.
+    std::vector<int64_t> output_size = input.sizes().vec();
+    output_size.back() = weight.size(0);
+    return at::addmm(bias, input.view({-1, input.size(-1)}), weight.t())
+        .view(output_size);
+  }
   auto output = at::matmul(input, weight.t());
   if (bias.defined()) {
     output.add_(bias);
@@ -359,6 +359,11 @@ Tensor &addmm_cpu_(Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar
   return addmm_cpu_out(self, self, mat1, mat2, beta, alpha);
 }
 
+Tensor addmm_activation_cpu(const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha, bool use_gelu) {
+  Tensor result = addmm_cpu(self, mat1, mat2, beta, alpha);
+  return addmm_activation_(result, use_gelu);
+}
+
 Tensor& mm_cpu_out(Tensor & result, const Tensor & self, const Tensor & mat2) {
   TORCH_CHECK(self.dim() == 2, "self must be a matrix");
   TORCH_CHECK(mat2.dim() == 2, "mat2 must be a matrix");
@@ -419,11 +424,17 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
 // - When the operand size is small, computation are parallelized over the batch
 //   dimension using OMP and naive matrix multiplication is applied.
 // - When the operand size is larger than the threshold, if compiled with MKL, MKL's batch gemm is used.
+// - Otherwise, float and double matrices with no dimension above kBatchedGemmMaxSize go through
+//   cpublas::gemm_batched_stub, which handles any strides (see Note [Batched small gemm]).
 // - Otherwise, we use a series of matrix multiplications.
 // The threshold of 400 for the first has not been thoroughly benchmarked yet and may have room for further
 // optimization, it likely depends on the characteristics of the CPU, MKL will be different from non-MKL etc.,
 // but this seems to be a first starting point.
 
+// Past this size the packing of the batched kernel is no longer cheap next to
+// the multiplication and per-matrix BLAS calls win.
+constexpr int64_t kBatchedGemmMaxSize = 128;
+
 static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha, bool is_bmm_out) {
   // is_bmm_out: true for bmm_out, false for baddbmm_
   // self_or_result is "self" for baddbmm_ and "result" for bmm_out
@@ -481,6 +492,18 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
             && batch_items_contiguous_or_transposed(batch2)
             && self_or_result.is_contiguous()) {
     at::native::_baddbmm_mkl_(self_or_result, batch1, batch2, beta, alpha);
+  } else if ((self_or_result.scalar_type() == kFloat || self_or_result.scalar_type() == kDouble)
+            && batch1.scalar_type() == self_or_result.scalar_type()
+            && batch2.scalar_type() == self_or_result.scalar_type()
+            && std::max({res_rows, res_cols, contraction_size}) <= kBatchedGemmMaxSize) {
+    cpublas::gemm_batched_stub(
+        kCPU, self_or_result.scalar_type(),
+        bs, res_rows, res_cols, contraction_size,
+        alpha,
+        batch1.data_ptr(), batch1.strides().data(),
+        batch2.data_ptr(), batch2.strides().data(),
+        beta,
+        self_or_result.data_ptr(), self_or_result.strides().data());
   } else { // split along batch dimension
     if (is_bmm_out) {
       for (int64_t b = 0; b < bs; b++) {
@@ -8,6 +8,19 @@
 
 namespace at { namespace native {
 
+/*
+ * Applies the activation of _addmm_activation to a Tensor in place: ReLU, or
+ * the tanh approximation of GELU, which is what the cuBLASLt epilogue fuses.
+ */
+static inline Tensor& addmm_activation_(Tensor& self, bool use_gelu) {
+  if (!use_gelu) {
+    return self.relu_();
+  }
+  // 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+  Tensor inner = (self + self.pow(3).mul_(0.044715)).mul_(M_2_SQRTPI * M_SQRT1_2).tanh_();
+  return self.mul_(inner.add_(1)).mul_(0.5);
+}
+
 /*
  * Clones a Tensor so that the following conditions hold:
  * If we think of a Tensor of having size (B, M, N), where B is any number
@@ -10,6 +10,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/cpu/LossCTCKernel.h>
 
 #include <numeric>
 #include <type_traits>
@@ -17,6 +18,9 @@
 namespace at {
 namespace native {
 
+DEFINE_DISPATCH(ctc_loss_log_add_exp3_stub);
+DEFINE_DISPATCH(ctc_loss_grad_stub);
+
 namespace {
 
 // this ad-hoc converts from targets (l in [1]) to augmented targets (l' in [1]) note that no bound-checking is done
@@ -29,6 +33,14 @@ static inline int64_t get_target_prime(target_t* target, int64_t offset, int64_t
   }
 }
 
+// log(exp(a) + exp(b))
+template<typename scalar_t>
+static inline scalar_t log_add_exp(scalar_t a, scalar_t b) {
+  scalar_t m = std::max(a, b);
+  m = ((m == -std::numeric_limits<scalar_t>::infinity()) ? 0 : m);
+  return std::log(std::exp(a-m)+std::exp(b-m))+m;
+}
+
 // This kernel is a relatively straightforward implementation of the alpha calculation in the forward backward algorithm (section 4.1).
 // A (minor) twist is that we are using log-calculations to enhance numerical stability (log_probs and log_alpha).
 // The function returns the loss and the alphas, the alphas are kept for the backward step. The wrapper (ctc_loss below) hides
@@ -114,36 +126,35 @@ std::tuple<Tensor, Tensor> ctc_loss_cpu_template(const Tensor& log_probs, const
         log_alpha_a[0][1] = log_probs_a[0][get_target_prime(targets_data, tg_batch_offset, tg_target_stride, 1, BLANK)];
 
       // now the loop over the inputs
+      // This is eq (6) and (7): every alpha_t(s) is the log-sum-exp of the three alpha_{t-1} it can be reached from,
+      // which only depend on the previous t, so the positions s are computed together, vectorized.
+      // The largest summand is taken out of the logsumexp, and the third summand is masked out where the labels
+      // of s and s-2 are the same.
+      const int64_t num_states = 2*target_length+1;
+      std::vector<int64_t> targets_prime(num_states);
+      std::vector<scalar_t> skip_mask(num_states, neginf);
+      std::vector<scalar_t> emit(num_states);
+      for (int64_t s=0; s<num_states; s++) {
+        targets_prime[s] = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
+        if ((s > 1) && (targets_prime[s-2] != targets_prime[s])) {
+          skip_mask[s] = 0;
+        }
+      }
       for (int64_t t=1; t<input_length; t++) {
-        for (int64_t s=0; s<2*target_length+1; s++) {
-          auto current_target_prime = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
-          // this loop over s could be parallel/vectorized, too, but the required items are one index apart
-          // alternatively, one might consider moving s to the outer loop to cache current_target_prime more (but then it needs to be descending)
-          // for the cuda implementation, that gave a speed boost.
-          // This is eq (6) and (7), la1,2,3 are the three summands. We keep track of the maximum for the logsumexp calculation.
-
-          scalar_t la1 = log_alpha_a[t-1][s];
-          scalar_t lamax = la1;
-          scalar_t la2, la3;
-          if (s > 0) {
-            la2 = log_alpha_a[t-1][s-1];
-            if (la2 > lamax)
-              lamax = la2;
-          } else {
-            la2 = neginf;
-          }
-          if ((s > 1) && (get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s-2, BLANK) !=
-                          current_target_prime)) {
-            la3 = log_alpha_a[t-1][s-2];
-            if (la3 > lamax)
-              lamax = la3;
-          } else {
-            la3 = neginf;
-          }
-          if (lamax == neginf) // cannot do neginf-neginf
-            lamax = 0;
-          // this is the assignment of eq (6)
-          log_alpha_a[t][s] = std::log(std::exp(la1-lamax)+std::exp(la2-lamax)+std::exp(la3-lamax))+lamax + log_probs_a[t][current_target_prime];
+        for (int64_t s=0; s<num_states; s++) {
+          emit[s] = log_probs_a[t][targets_prime[s]];
+        }
+        const scalar_t* prev = &log_alpha_a[t-1][0];
+        scalar_t* cur = &log_alpha_a[t][0];
+        // s = 0 and 1 can only be reached from one and two states
+        cur[0] = prev[0] + emit[0];
+        if (num_states > 1) {
+          cur[1] = log_add_exp(prev[1], prev[0]) + emit[1];
+        }
+        if (num_states > 2) {
+          ctc_loss_log_add_exp3_stub(
+              kCPU, log_probs.scalar_type(), num_states - 2, prev + 2, prev + 1, prev,
+              skip_mask.data() + 2, emit.data() + 2, cur + 2);
         }
       }
       // the likelihood is the the sum of the last two alphas, eq (8), the loss is the negative log likelihood
@@ -153,10 +164,7 @@ std::tuple<Tensor, Tensor> ctc_loss_cpu_template(const Tensor& log_probs, const
       } else {
         scalar_t l1 = log_alpha_a[input_length-1][target_length*2];
         scalar_t l2 = log_alpha_a[input_length-1][target_length*2-1];
-        scalar_t m = std::max(l1, l2);
-        m = ((m == neginf) ? 0 : m);
-        scalar_t log_likelihood = std::log(std::exp(l1-m)+std::exp(l2-m))+m;
-        neg_log_likelihood_a[b] = -log_likelihood;
+        neg_log_likelihood_a[b] = -log_add_exp(l1, l2);
       }
     }
   });
@@ -245,42 +253,41 @@ Tensor ctc_loss_backward_cpu_template(const Tensor& grad_out, const Tensor& log_
         }
       }
 
-      // now loop applying eq (10) / (11)
+      // now loop applying eq (10) / (11), vectorized over s as the alphas in the forward
+      const int64_t num_states = 2*target_length+1;
+      std::vector<int64_t> targets_prime(num_states);
+      std::vector<scalar_t> skip_mask(num_states, neginf);
+      std::vector<scalar_t> emit(num_states);
+      for (int64_t s=0; s<num_states; s++) {
+        targets_prime[s] = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
+      }
+      for (int64_t s=0; s+2<num_states; s++) {
+        if (targets_prime[s+2] != targets_prime[s]) {
+          skip_mask[s] = 0;
+        }
+      }
       for (int64_t t=input_length-2; t>=0; t--) {
-        // this loop over s could be parallel/vectorized and doesn't really need to be descending...
-        // alternatively, one might consider moving s to the outer loop to cache current_target_prime more (but then it needs to be descending)
-        // for the cuda implementation, that gave a speed boost.
+        for (int64_t s=0; s<num_states; s++) {
+          emit[s] = log_probs_a[t][targets_prime[s]];
+        }
+        const scalar_t* next = &log_beta_a[t+1][0];
+        scalar_t* cur = &log_beta_a[t][0];
+        // the last two s can only be reached from one and two states
+        cur[2*target_length] = next[2*target_length] + emit[2*target_length];
+        if (target_length > 0) {
+          cur[2*target_length-1] = log_add_exp(next[2*target_length-1], next[2*target_length]) + emit[2*target_length-1];
+          ctc_loss_log_add_exp3_stub(
+              kCPU, log_probs.scalar_type(), 2*target_length-1, next, next + 1, next + 2,
+              skip_mask.data(), emit.data(), cur);
+        }
+
+        // now that we have beta, we fill in the sum of alpha*beta in eq (16)
+        // in contrast to the cuda implementation, we only parallelize over the batch, so we don't have a concurrency
+        // issue (several s can map to the same target character)
+        // collected[b, t, target'[s]] "log+=" log_alpha[t, s]+log_beta[t, s]
         for (int64_t s=2*target_length; s>=0; s--) {
-          scalar_t lb1 = log_beta_a[t+1][s];
-          scalar_t lbmax = lb1;
-          scalar_t lb2, lb3;
-          auto current_target_prime = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
-          if (s < 2*target_length) {
-            lb2 = log_beta_a[t+1][s+1];
-            if (lb2 > lbmax)
-              lbmax = lb2;
-          } else {
-            lb2 = neginf;
-          }
-          if ((s < 2*target_length-1) && (get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s+2, BLANK) !=
-                                          current_target_prime)) {
-            lb3 = log_beta_a[t+1][s+2];
-            if (lb3 > lbmax)
-              lbmax = lb3;
-          } else {
-            lb3 = neginf;
-          }
-          if (lbmax == neginf)
-            lbmax = 0;
-
-          log_beta_a[t][s] = std::log(std::exp(lb1-lbmax)+std::exp(lb2-lbmax)+std::exp(lb3-lbmax))+lbmax + log_probs_a[t][current_target_prime];
-          // one might check whether one can vectorize this better when done after the t-loop...
-          // now that we have beta, we fill in the sum of alpha*beta in eq (16)
-          // in contrast to the cuda implementation, we only parallelize over the batch, so we don't have a concurrency
-          // issue (several s can map to the same target character)
-          // collected[b, t, target'[s]] "log+=" log_alpha[t, s]+log_beta[t, s]
           scalar_t log_alpha_beta =  log_alpha_a[t][s] + log_beta_a[t][s];
-          scalar_t &lcab = grad_a[t][current_target_prime];
+          scalar_t &lcab = grad_a[t][targets_prime[s]];
           if (lcab == neginf) {
             lcab = log_alpha_beta;
           } else {
@@ -291,11 +298,15 @@ Tensor ctc_loss_backward_cpu_template(const Tensor& grad_out, const Tensor& log_
       }
 
       // now grad has the sum of eq (16)
-      // now we wrap up the calculation by adding in the remaining items of eq (16)
-      // this could be a great target for further vectorization.
+      // now we wrap up the calculation by adding in the remaining items of eq (16), vectorized over the labels
+      // where they are contiguous
       // grad is the output gradient, nll is the loss. Note that the likelihood -nll is the Z of eq (16)
       scalar_t gr =  grad_out.accessor<scalar_t, 1>()[b];
       for (int64_t t = 0; t < input_length; t++) { // or go for the full thing?
+        if (log_probs.stride(2) == 1) {
+          ctc_loss_grad_stub(kCPU, log_probs.scalar_type(), num_labels, &log_probs_a[t][0], nll, gr, &grad_a[t][0]);
+          continue;
+        }
         for (int64_t c = 0; c < num_labels; c++) {
           scalar_t& res = grad_a[t][c];
           scalar_t lp = log_probs_a[t][c];
@@ -1,5 +1,6 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
 
 #include <ATen/native/CPUBlas.h>
@@ -169,7 +170,6 @@ void slow_conv_transpose2d_out_cpu_template(
       "It is expected stride equals to 2, but got size ",
       output_padding.size());
 
-  Tensor columns = columns_;
   Tensor ones = ones_;
 
   int64_t kernel_height = kernel_size[0];
@@ -206,8 +206,6 @@ void slow_conv_transpose2d_out_cpu_template(
   Tensor input = input_.contiguous();
   Tensor weight = weight_.contiguous();
 
-  TORCH_CHECK(columns.is_contiguous(), "columns needs to be contiguous");
-
   Tensor bias = Tensor();
 
   if (bias_.defined()) {
@@ -235,11 +233,6 @@ void slow_conv_transpose2d_out_cpu_template(
   // Resize output
   output.resize_({batch_size, n_output_plane, output_height, output_width});
 
-  // Resize temporary columns
-  columns.resize_({n_output_plane * kernel_width * kernel_height,
-                   input_height * input_width});
-  columns.zero_();
-
   // Define a buffer of ones, for bias accumulation
   // Note: this buffer can be shared with other modules, it only ever gets
   // increased, and always contains ones.
@@ -252,83 +245,86 @@ void slow_conv_transpose2d_out_cpu_template(
 
   AT_DISPATCH_FLOATING_TYPES_AND(at::ScalarType::Long,
       input.scalar_type(), "slow_conv_transpose2d_out_cpu", [&] {
-        // For each elt in batch, do:
-        for (int elt = 0; elt < batch_size; elt++) {
-          // Helpers
-          Tensor input_n;
-          Tensor output_n;
+        // The samples are independent, every chunk of the batch unpacks them
+        // through its own columns
+        at::parallel_for(0, batch_size, 0, [&](int64_t begin, int64_t end) {
+          Tensor columns = at::empty(
+              {n_output_plane * kernel_width * kernel_height,
+               input_height * input_width},
+              input.options());
+          for (int64_t elt = begin; elt < end; elt++) {
+            // Matrix mulitply per output:
+            Tensor input_n = input.select(0, elt);
+            Tensor output_n = output.select(0, elt);
 
-          // Matrix mulitply per output:
-          input_n = input.select(0, elt);
-          output_n = output.select(0, elt);
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          int64_t m = weight.size(1) * weight.size(2) * weight.size(3);
-          int64_t n = columns.size(1);
-          int64_t k = weight.size(0);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          cpublas::gemm(
-              cpublas::NoTranspose,
-              cpublas::Transpose,
-              n,
-              m,
-              k,
-              1,
-              input_n.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              m,
-              0,
-              columns.data_ptr<scalar_t>(),
-              n);
-
-          // Unpack columns back into input:
-          col2im<scalar_t>(
-              columns.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_height,
-              output_width,
-              input_height,
-              input_width,
-              kernel_height,
-              kernel_width,
-              pad_height,
-              pad_width,
-              stride_height,
-              stride_width,
-              dilation_height,
-              dilation_width,
-              output_n.data_ptr<scalar_t>());
-
-          // Do Bias after:
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          int64_t m_ = n_output_plane;
-          int64_t n_ = output_height * output_width;
-          int64_t k_ = 1;
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          if (bias_.defined()) {
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            int64_t m = weight.size(1) * weight.size(2) * weight.size(3);
+            int64_t n = columns.size(1);
+            int64_t k = weight.size(0);
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
             cpublas::gemm(
-                cpublas::Transpose,
                 cpublas::NoTranspose,
-                n_,
-                m_,
-                k_,
-                1,
-                ones.data_ptr<scalar_t>(),
-                k_,
-                bias.data_ptr<scalar_t>(),
-                k_,
+                cpublas::Transpose,
+                n,
+                m,
+                k,
                 1,
-                output_n.data_ptr<scalar_t>(),
-                n_);
+                input_n.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                m,
+                0,
+                columns.data_ptr<scalar_t>(),
+                n);
+
+            // Unpack columns back into input:
+            col2im<scalar_t>(
+                columns.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_height,
+                output_width,
+                input_height,
+                input_width,
+                kernel_height,
+                kernel_width,
+                pad_height,
+                pad_width,
+                stride_height,
+                stride_width,
+                dilation_height,
+                dilation_width,
+                output_n.data_ptr<scalar_t>());
+
+            // Do Bias after:
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            int64_t m_ = n_output_plane;
+            int64_t n_ = output_height * output_width;
+            int64_t k_ = 1;
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            if (bias_.defined()) {
+              cpublas::gemm(
+                  cpublas::Transpose,
+                  cpublas::NoTranspose,
+                  n_,
+                  m_,
+                  k_,
+                  1,
+                  ones.data_ptr<scalar_t>(),
+                  k_,
+                  bias.data_ptr<scalar_t>(),
+                  k_,
+                  1,
+                  output_n.data_ptr<scalar_t>(),
+                  n_);
+            }
           }
-        }
+        });
 
         // Resize output
         if (is_batch) {
@@ -388,8 +384,6 @@ static void slow_conv_transpose2d_backward_out_cpu_template(
   int64_t n_input_plane = weight_.size(0);
   int64_t n_output_plane = weight_.size(1);
 
-  Tensor grad_columns = grad_columns_;
-
   slow_conv_transpose2d_shape_check(
       input_,
       grad_output_,
@@ -411,9 +405,6 @@ static void slow_conv_transpose2d_backward_out_cpu_template(
   Tensor grad_output = grad_output_.contiguous();
   Tensor weight = weight_.contiguous();
 
-  TORCH_CHECK(
-      grad_columns.is_contiguous(), "grad_columns needs to be contiguous");
-
   bool is_batch = false;
   if (input.dim() == 3) {
     // Force batch
@@ -437,63 +428,62 @@ static void slow_conv_transpose2d_backward_out_cpu_template(
   grad_input.resize_({batch_size, n_input_plane, input_height, input_width});
   grad_input.zero_();
 
-  // Resize temporary columns
-  grad_columns.resize_({n_output_plane * kernel_width * kernel_height,
-                        input_height * input_width});
-
   AT_DISPATCH_FLOATING_TYPES(
       grad_output.scalar_type(), "slow_conv_transpose2d_backward_out_cpu", [&] {
-        // Helpers
-        Tensor grad_input_n = Tensor();
-        Tensor grad_output_n = Tensor();
+        // The samples are independent, every chunk of the batch extracts the
+        // columns of its gradients on its own
+        at::parallel_for(0, batch_size, 0, [&](int64_t begin, int64_t end) {
+          Tensor grad_columns = at::empty(
+              {n_output_plane * kernel_width * kernel_height,
+               input_height * input_width},
+              grad_output.options());
+          for (int64_t elt = begin; elt < end; elt++) {
+            // Matrix mulitply per sample:
+            Tensor grad_input_n = grad_input.select(0, elt);
+            Tensor grad_output_n = grad_output.select(0, elt);
 
-        // For each elt in batch, do:
-        for (int elt = 0; elt < batch_size; elt++) {
-          // Matrix mulitply per sample:
-          grad_input_n = grad_input.select(0, elt);
-          grad_output_n = grad_output.select(0, elt);
+            // Extract columns:
+            im2col<scalar_t>(
+                grad_output_n.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_height,
+                output_width,
+                input_height,
+                input_width,
+                kernel_height,
+                kernel_width,
+                pad_height,
+                pad_width,
+                stride_height,
+                stride_width,
+                dilation_height,
+                dilation_width,
+                grad_columns.data_ptr<scalar_t>());
 
-          // Extract columns:
-          im2col<scalar_t>(
-              grad_output_n.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_height,
-              output_width,
-              input_height,
-              input_width,
-              kernel_height,
-              kernel_width,
-              pad_height,
-              pad_width,
-              stride_height,
-              stride_width,
-              dilation_height,
-              dilation_width,
-              grad_columns.data_ptr<scalar_t>());
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          int64_t m = weight.size(0);
-          int64_t n = grad_columns.size(1);
-          int64_t k = weight.size(1) * weight.size(2) * weight.size(3);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          cpublas::gemm(
-              cpublas::NoTranspose,
-              cpublas::NoTranspose,
-              n,
-              m,
-              k,
-              1,
-              grad_columns.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              k,
-              0,
-              grad_input_n.data_ptr<scalar_t>(),
-              n);
-        }
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            int64_t m = weight.size(0);
+            int64_t n = grad_columns.size(1);
+            int64_t k = weight.size(1) * weight.size(2) * weight.size(3);
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            cpublas::gemm(
+                cpublas::NoTranspose,
+                cpublas::NoTranspose,
+                n,
+                m,
+                k,
+                1,
+                grad_columns.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                k,
+                0,
+                grad_input_n.data_ptr<scalar_t>(),
+                n);
+          }
+        });
 
         // Resize output
         if (is_batch) {
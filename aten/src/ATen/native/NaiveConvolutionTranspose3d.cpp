@@ -1,5 +1,6 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
 
 #include <ATen/native/CPUBlas.h>
@@ -215,8 +216,6 @@ void slow_conv_transpose3d_out_cpu_template(
   int64_t output_padding_height = output_padding[1];
   int64_t output_padding_width = output_padding[2];
 
-  // internal columns buffer
-  Tensor& columns = finput;
   // internal ones buffer
   Tensor& ones = fgrad_input;
 
@@ -278,11 +277,6 @@ void slow_conv_transpose3d_out_cpu_template(
   output.resize_(
       {batch_size, n_output_plane, output_depth, output_height, output_width});
 
-  // Resize temporary columns
-  columns.resize_({n_output_plane * kernel_width * kernel_height * kernel_depth,
-                   input_depth * input_height * input_width});
-  columns.zero_();
-
   // Define a buffer of ones, for bias accumulation
   // Note: this buffer can be shared with other modules, it only ever gets
   // increased, and always contains ones.
@@ -296,91 +290,93 @@ void slow_conv_transpose3d_out_cpu_template(
 
   AT_DISPATCH_FLOATING_TYPES_AND(at::ScalarType::Long,
       input.scalar_type(), "slow_conv_transpose3d_out_cpu", [&] {
-        // Helpers
-        Tensor input_n;
-        Tensor output_n;
+        // The samples are independent, every chunk of the batch unpacks them
+        // through its own columns
+        at::parallel_for(0, batch_size, 0, [&](int64_t begin, int64_t end) {
+          Tensor columns = at::empty(
+              {n_output_plane * kernel_width * kernel_height * kernel_depth,
+               input_depth * input_height * input_width},
+              input.options());
+          for (int64_t elt = begin; elt < end; elt++) {
+            // Matrix mulitply per output:
+            Tensor input_n = input.select(0, elt);
+            Tensor output_n = output.select(0, elt);
 
-        int elt;
-        // For each elt in batch, do:
-        for (elt = 0; elt < batch_size; ++elt) {
-          // Matrix mulitply per output:
-          input_n = input.select(0, elt);
-          output_n = output.select(0, elt);
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          const int64_t m =
-              weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
-          const int64_t n = columns.size(1);
-          const int64_t k = weight.size(0);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          cpublas::gemm(
-              cpublas::NoTranspose,
-              cpublas::Transpose,
-              n,
-              m,
-              k,
-              1,
-              input_n.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              m,
-              0,
-              columns.data_ptr<scalar_t>(),
-              n);
-
-          // Unpack columns back into input:
-          at::native::col2vol<scalar_t>(
-              columns.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_depth,
-              output_height,
-              output_width,
-              input_depth,
-              input_height,
-              input_width,
-              kernel_depth,
-              kernel_height,
-              kernel_width,
-              padding_depth,
-              padding_height,
-              padding_width,
-              stride_depth,
-              stride_height,
-              stride_width,
-              dilation_depth,
-              dilation_height,
-              dilation_width,
-              output_n.data_ptr<scalar_t>());
-
-          // Do Bias after:
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          const int64_t m_ = n_output_plane;
-          const int64_t n_ = output_depth * output_height * output_width;
-          const int64_t k_ = 1;
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          if (bias.defined()) {
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            const int64_t m = weight.size(1) * weight.size(2) *
+                weight.size(3) * weight.size(4);
+            const int64_t n = columns.size(1);
+            const int64_t k = weight.size(0);
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
             cpublas::gemm(
-                cpublas::Transpose,
                 cpublas::NoTranspose,
-                n_,
-                m_,
-                k_,
-                1,
-                ones.data_ptr<scalar_t>(),
-                k_,
-                bias.data_ptr<scalar_t>(),
-                k_,
+                cpublas::Transpose,
+                n,
+                m,
+                k,
                 1,
-                output_n.data_ptr<scalar_t>(),
-                n_);
+                input_n.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                m,
+                0,
+                columns.data_ptr<scalar_t>(),
+                n);
+
+            // Unpack columns back into input:
+            at::native::col2vol<scalar_t>(
+                columns.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_depth,
+                output_height,
+                output_width,
+                input_depth,
+                input_height,
+                input_width,
+                kernel_depth,
+                kernel_height,
+                kernel_width,
+                padding_depth,
+                padding_height,
+                padding_width,
+                stride_depth,
+                stride_height,
+                stride_width,
+                dilation_depth,
+                dilation_height,
+                dilation_width,
+                output_n.data_ptr<scalar_t>());
+
+            // Do Bias after:
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            const int64_t m_ = n_output_plane;
+            const int64_t n_ = output_depth * output_height * output_width;
+            const int64_t k_ = 1;
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            if (bias.defined()) {
+              cpublas::gemm(
+                  cpublas::Transpose,
+                  cpublas::NoTranspose,
+                  n_,
+                  m_,
+                  k_,
+                  1,
+                  ones.data_ptr<scalar_t>(),
+                  k_,
+                  bias.data_ptr<scalar_t>(),
+                  k_,
+                  1,
+                  output_n.data_ptr<scalar_t>(),
+                  n_);
+            }
           }
-        }
+        });
 
         // Resize output
         if (is_batch) {
@@ -429,8 +425,6 @@ void slow_conv_transpose3d_backward_out_cpu_template(
       "It is expected stride equals to 3, but got size ",
       output_padding.size());
 
-  Tensor grad_columns = finput;
-
   int64_t kernel_depth = kernel_size[0];
   int64_t kernel_height = kernel_size[1];
   int64_t kernel_width = kernel_size[2];
@@ -513,72 +507,69 @@ void slow_conv_transpose3d_backward_out_cpu_template(
       {batch_size, n_input_plane, input_depth, input_height, input_width});
   grad_input.zero_();
 
-  // Resize temporary columns
-  grad_columns.resize_(
-      {n_output_plane * kernel_width * kernel_height * kernel_depth,
-       input_depth * input_height * input_width});
-
   AT_DISPATCH_FLOATING_TYPES(
       input.scalar_type(), "slow_conv_transpose3d_backward_out_cpu", [&] {
-        // Helpers
-        Tensor grad_input_n;
-        Tensor grad_output_n;
+        // The samples are independent, every chunk of the batch extracts the
+        // columns of its gradients on its own
+        at::parallel_for(0, batch_size, 0, [&](int64_t begin, int64_t end) {
+          Tensor grad_columns = at::empty(
+              {n_output_plane * kernel_width * kernel_height * kernel_depth,
+               input_depth * input_height * input_width},
+              grad_output.options());
+          for (int64_t elt = begin; elt < end; elt++) {
+            // Matrix mulitply per sample:
+            Tensor grad_input_n = grad_input.select(0, elt);
+            Tensor grad_output_n = grad_output.select(0, elt);
 
-        int elt;
-        // For each elt in batch, do:
-        for (elt = 0; elt < batch_size; ++elt) {
-          // Matrix mulitply per sample:
-          grad_input_n = grad_input.select(0, elt);
-          grad_output_n = grad_output.select(0, elt);
+            // Extract columns:
+            at::native::vol2col<scalar_t>(
+                grad_output_n.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_depth,
+                output_height,
+                output_width,
+                input_depth,
+                input_height,
+                input_width,
+                kernel_depth,
+                kernel_height,
+                kernel_width,
+                padding_depth,
+                padding_height,
+                padding_width,
+                stride_depth,
+                stride_height,
+                stride_width,
+                dilation_depth,
+                dilation_height,
+                dilation_width,
+                grad_columns.data_ptr<scalar_t>());
 
-          // Extract columns:
-          at::native::vol2col<scalar_t>(
-              grad_output_n.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_depth,
-              output_height,
-              output_width,
-              input_depth,
-              input_height,
-              input_width,
-              kernel_depth,
-              kernel_height,
-              kernel_width,
-              padding_depth,
-              padding_height,
-              padding_width,
-              stride_depth,
-              stride_height,
-              stride_width,
-              dilation_depth,
-              dilation_height,
-              dilation_width,
-              grad_columns.data_ptr<scalar_t>());
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          const int64_t m = weight.size(0);
-          const int64_t n = grad_columns.size(1);
-          const int64_t k =
-              weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          cpublas::gemm(
-              cpublas::NoTranspose,
-              cpublas::NoTranspose,
-              n,
-              m,
-              k,
-              1,
-              grad_columns.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              k,
-              0,
-              grad_input_n.data_ptr<scalar_t>(),
-              n);
-        }
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            const int64_t m = weight.size(0);
+            const int64_t n = grad_columns.size(1);
+            const int64_t k = weight.size(1) * weight.size(2) *
+                weight.size(3) * weight.size(4);
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            cpublas::gemm(
+                cpublas::NoTranspose,
+                cpublas::NoTranspose,
+                n,
+                m,
+                k,
+                1,
+                grad_columns.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                k,
+                0,
+                grad_input_n.data_ptr<scalar_t>(),
+                n);
+          }
+        });
 
         // Resize output
         if (is_batch) {
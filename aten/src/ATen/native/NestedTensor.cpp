@@ -0,0 +1,88 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/NestedTensorImpl.h>
+
+#include <cmath>
+
+namespace at {
+namespace native {
+
+// Packs the components back to back, so the result owns a copy of them.
+Tensor nested_tensor(TensorList tensors) {
+  TORCH_CHECK(!tensors.empty(), "nested_tensor: expected a non-empty list of tensors");
+  std::vector<int64_t> offsets = {0};
+  offsets.reserve(tensors.size() + 1);
+  for (size_t i = 0; i < tensors.size(); i++) {
+    const auto& t = tensors[i];
+    TORCH_CHECK(
+        t.dim() >= 1 && !isNested(t),
+        "nested_tensor: expected components of at least one dim, but component ", i,
+        " is of size ", t.sizes());
+    TORCH_CHECK(
+        t.sizes().slice(1) == tensors[0].sizes().slice(1),
+        "nested_tensor: components may only differ in the size of their first dim, but got ",
+        tensors[0].sizes(), " and ", t.sizes(), " for component ", i);
+    TORCH_CHECK(
+        t.scalar_type() == tensors[0].scalar_type() && t.device() == tensors[0].device(),
+        "nested_tensor: expected components of the same dtype and device, but component ", i,
+        " is ", t.toString(), " on ", t.device(), " and component 0 ", tensors[0].toString(),
+        " on ", tensors[0].device());
+    offsets.push_back(offsets.back() + t.size(0));
+  }
+  return makeNested(at::cat(tensors, 0), std::move(offsets));
+}
+
+Tensor nested_tensor_from_padded(const Tensor& padded, IntArrayRef lengths) {
+  TORCH_CHECK(
+      padded.dim() >= 2 && !isNested(padded),
+      "nested_tensor_from_padded: expected a padded tensor of at least two dims, but got ",
+      padded.sizes());
+  TORCH_CHECK(
+      static_cast<int64_t>(lengths.size()) == padded.size(0),
+      "nested_tensor_from_padded: expected ", padded.size(0), " lengths, but got ",
+      lengths.size());
+  std::vector<int64_t> offsets = {0};
+  offsets.reserve(lengths.size() + 1);
+  for (auto length : lengths) {
+    TORCH_CHECK(
+        length >= 0 && length <= padded.size(1),
+        "nested_tensor_from_padded: lengths must be in [0, ", padded.size(1), "], but got ",
+        length);
+    offsets.push_back(offsets.back() + length);
+  }
+  auto rows_size = padded.sizes().vec();
+  rows_size.erase(rows_size.begin());
+  rows_size[0] = padded.size(0) * padded.size(1);
+  auto buffer = padded.reshape(rows_size).index_select(
+      0, nestedPaddedRowIndices(offsets, padded.size(1), padded.device()));
+  return makeNested(buffer, std::move(offsets));
+}
+
+Tensor to_padded_tensor(const Tensor& self, double padding) {
+  TORCH_CHECK(false, "to_padded_tensor: expected a nested tensor, but got a ", self.toString());
+}
+
+// Queries, keys and values of size [B, L, *heads, E]; the padded form of
+// nested tensors, and what their NestedTensor kernel computes one component
+// at a time. Every query attends to all L keys.
+Tensor nested_attention(
+    const Tensor& query, const Tensor& key, const Tensor& value, c10::optional<double> scale) {
+  TORCH_CHECK(
+      query.dim() >= 3 && key.dim() == query.dim() && value.dim() == query.dim(),
+      "nested_attention: expected query, key and value of size [B, L, *heads, E], but got ",
+      query.sizes(), ", ", key.sizes(), " and ", value.sizes());
+  TORCH_CHECK(
+      key.size(1) == value.size(1),
+      "nested_attention: expected as many keys as values, but got ", key.size(1), " and ",
+      value.size(1));
+  const double scale_value = scale.has_value() ? *scale : 1.0 / std::sqrt(query.size(-1));
+  // [B, *heads (reversed), L, E]
+  const auto q = query.transpose(1, -2).mul(scale_value);
+  const auto k = key.transpose(1, -2);
+  const auto v = value.transpose(1, -2);
+  const auto attn = at::softmax(at::matmul(q, k.transpose(-2, -1)), -1);
+  return at::matmul(attn, v).transpose(1, -2);
+}
+
+} // namespace native
+} // namespace at
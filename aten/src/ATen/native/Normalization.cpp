@@ -142,6 +142,48 @@ void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
   }
 }
 
+/// Training forward on channels last contiguous input. Unlike the inference
+/// path above, this keeps the (input - mean) form: batch statistics are
+/// not folded into a constant term, which would cancel badly for inputs
+/// with a large mean.
+template<typename scalar_t>
+void batch_norm_cpu_train_channels_last(Tensor& output, const Tensor& input,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    const Tensor& save_mean, const Tensor& save_invstd) {
+
+  int64_t n_channel = input.size(1);
+  int64_t n_rows = input.numel() / n_channel;
+
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* mean_data = save_mean.data_ptr<scalar_t>();
+  auto weight_a = conditional_accessor_1d<scalar_t>(weight);
+  auto bias_a = conditional_accessor_1d<scalar_t>(bias);
+  auto invstd_a = save_invstd.accessor<scalar_t, 1>();
+
+  // output(n, h, w, c) = (input(n, h, w, c) - mean(c)) * scale(c) + shift(c)
+  std::vector<scalar_t> scale(n_channel);
+  std::vector<scalar_t> shift(n_channel);
+  for (int64_t c = 0; c < n_channel; c++) {
+    scale[c] = invstd_a[c] * (weight.defined() ? weight_a[c] : 1);
+    shift[c] = bias.defined() ? bias_a[c] : 0;
+  }
+  const scalar_t* scale_data = scale.data();
+  const scalar_t* shift_data = shift.data();
+
+  // Keep the inner loop simple so it vectorizes, as in
+  // batch_norm_cpu_inference_channels_last.
+  parallel_for(0, n_rows, internal::GRAIN_SIZE / n_channel, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const scalar_t* in = input_data + i * n_channel;
+      scalar_t* out = output_data + i * n_channel;
+      for (int64_t c = 0; c < n_channel; c++) {
+        out[c] = (in[c] - mean_data[c]) * scale_data[c] + shift_data[c];
+      }
+    }
+  });
+}
+
 template<typename scalar_t>
 std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     const Tensor& input, const Tensor& weight, const Tensor& bias,
@@ -175,6 +217,14 @@ std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     return std::make_tuple(output, save_mean, save_invstd);
   }
 
+  // Training on channels last input keeps the output channels last
+  if (train && input.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    Tensor output = at::empty_like(input, at::MemoryFormat::ChannelsLast);
+    batch_norm_cpu_train_channels_last<scalar_t>(
+      output, input, weight, bias, save_mean, save_invstd);
+    return std::make_tuple(output, save_mean, save_invstd);
+  }
+
   Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
 
   int64_t n_input = input.size(1);
@@ -230,29 +280,22 @@ std::tuple<Tensor,Tensor> batch_norm_cpu_update_stats_template(
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  // mean and biased variance of every feature in a single pass over the
+  // input, see Note [Vectorized reduce_contiguous]
+  std::vector<int64_t> reduce_dims{0};
+  for (int64_t d = 2; d < input.dim(); d++) {
+    reduce_dims.push_back(d);
+  }
+  Tensor var, mean;
+  std::tie(var, mean) = at::var_mean(input, reduce_dims, /*unbiased=*/false);
+  auto mean_a = mean.accessor<scalar_t, 1>();
+  auto var_a = var.accessor<scalar_t, 1>();
+
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
     for (int64_t f = b_begin; f < b_end; ++f) {
-      Tensor in = input.select(1, f);
-
-      // compute mean per input
-      auto iter = TensorIteratorConfig()
-        .add_input(in)
-        .build();
-      accscalar_t sum = 0;
-      cpu_serial_kernel(iter, [&](const scalar_t i) -> void {
-        sum += i;
-      });
-      scalar_t mean = sum / n;
+      scalar_t mean = mean_a[f];
       save_mean_a[f] = mean;
-
-      // compute variance per input
-      accscalar_t var_sum = 0;
-      iter = TensorIteratorConfig()
-        .add_input(in)
-        .build();
-      cpu_serial_kernel(iter, [&](const scalar_t i) -> void {
-        var_sum += (i - mean) * (i - mean);
-      });
+      accscalar_t var_sum = static_cast<accscalar_t>(var_a[f]) * n;
       save_var_transform_a[f] = VarTransform<accscalar_t>{}(var_sum / n, eps);
 
       // update running averages
@@ -269,6 +312,99 @@ std::tuple<Tensor,Tensor> batch_norm_cpu_update_stats_template(
 }
 
 
+/// Backward on channels last contiguous input and gradient. Every channel
+/// is a strided column of the (n * h * w) x c matrix of rows, so the
+/// per-channel reductions run over rows with blocks of channels in the inner
+/// loop rather than channel by channel.
+template<typename scalar_t>
+void batch_norm_backward_cpu_channels_last(
+    Tensor& grad_input, Tensor& grad_weight, Tensor& grad_bias,
+    const Tensor& grad_out, const Tensor& input, const Tensor& weight,
+    const Tensor& running_mean, const Tensor& running_var,
+    const Tensor& save_mean, const Tensor& save_invstd,
+    bool train, double eps) {
+
+  using accscalar_t = at::acc_type<scalar_t, false>;
+
+  int64_t n_channel = input.size(1);
+  int64_t n_rows = input.numel() / n_channel;
+
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* grad_out_data = grad_out.data_ptr<scalar_t>();
+  auto weight_a = conditional_accessor_1d<scalar_t>(weight);
+  auto save_mean_a = conditional_accessor_1d<scalar_t>(save_mean);
+  auto save_invstd_a = conditional_accessor_1d<scalar_t>(save_invstd);
+  auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
+  auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
+
+  std::vector<scalar_t> mean(n_channel);
+  std::vector<scalar_t> invstd(n_channel);
+  for (int64_t c = 0; c < n_channel; c++) {
+    if (train) {
+      mean[c] = save_mean_a[c];
+      invstd[c] = save_invstd_a[c];
+    } else {
+      mean[c] = running_mean_a[c];
+      invstd[c] = 1 / std::sqrt(running_var_a[c] + eps);
+    }
+  }
+
+  // sum of gradOutput and dot product of Q(X) and gradOutput per channel;
+  // each task owns a block of channels
+  constexpr int64_t kChannelBlock = 16;
+  std::vector<accscalar_t> sum(n_channel, 0);
+  std::vector<accscalar_t> dotp(n_channel, 0);
+  parallel_for(0, divup(n_channel, kChannelBlock), 1, [&](int64_t b_begin, int64_t b_end) {
+    const int64_t c_begin = b_begin * kChannelBlock;
+    const int64_t c_end = std::min(b_end * kChannelBlock, n_channel);
+    for (int64_t i = 0; i < n_rows; i++) {
+      const scalar_t* in = input_data + i * n_channel;
+      const scalar_t* go = grad_out_data + i * n_channel;
+      for (int64_t c = c_begin; c < c_end; c++) {
+        sum[c] += go[c];
+        dotp[c] += (in[c] - mean[c]) * go[c];
+      }
+    }
+  });
+
+  if (grad_input.defined()) {
+    // train: dL/dX = (dL/dY - mean(dL/dY) - Q(X) * dot(Q(X), dL/dY) / (n * sigma^2)) / sigma * w
+    // eval:  dL/dX = dL/dY / running_std * w
+    std::vector<scalar_t> proj(n_channel);
+    std::vector<scalar_t> grad_mean(n_channel);
+    std::vector<scalar_t> scale(n_channel);
+    for (int64_t c = 0; c < n_channel; c++) {
+      proj[c] = train ? (scalar_t) dotp[c] * invstd[c] * invstd[c] / n_rows : 0;
+      grad_mean[c] = train ? (scalar_t) (sum[c] / n_rows) : 0;
+      scale[c] = invstd[c] * (weight.defined() ? weight_a[c] : 1);
+    }
+    scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+    parallel_for(0, n_rows, internal::GRAIN_SIZE / n_channel, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const scalar_t* in = input_data + i * n_channel;
+        const scalar_t* go = grad_out_data + i * n_channel;
+        scalar_t* gi = grad_input_data + i * n_channel;
+        for (int64_t c = 0; c < n_channel; c++) {
+          gi[c] = (go[c] - grad_mean[c] - (in[c] - mean[c]) * proj[c]) * scale[c];
+        }
+      }
+    });
+  }
+
+  if (grad_weight.defined()) {
+    auto grad_weight_a = grad_weight.accessor<scalar_t, 1>();
+    for (int64_t c = 0; c < n_channel; c++) {
+      grad_weight_a[c] = dotp[c] * invstd[c];
+    }
+  }
+  if (grad_bias.defined()) {
+    auto grad_bias_a = grad_bias.accessor<scalar_t, 1>();
+    for (int64_t c = 0; c < n_channel; c++) {
+      grad_bias_a[c] = sum[c];
+    }
+  }
+}
+
 template<typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor& grad_out_, const Tensor& input, const Tensor& weight,
                                                                     const Tensor& running_mean, const Tensor& running_var, const Tensor& save_mean, const Tensor& save_invstd,
@@ -280,7 +416,11 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   Tensor grad_weight;
   Tensor grad_bias;
   if (grad_input_mask[0]) {
-    grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    grad_input = at::empty_like(input,
+        input.is_contiguous(at::MemoryFormat::ChannelsLast) &&
+        grad_out_.is_contiguous(at::MemoryFormat::ChannelsLast)
+            ? at::MemoryFormat::ChannelsLast
+            : LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   }
   if (grad_input_mask[1]) {
     grad_weight = at::empty_like(weight, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -302,6 +442,13 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  if (input.is_contiguous(at::MemoryFormat::ChannelsLast) &&
+      grad_out_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    batch_norm_backward_cpu_channels_last<scalar_t>(
+        grad_input, grad_weight, grad_bias, grad_out_, input, weight,
+        running_mean, running_var, save_mean, save_invstd, train, eps);
+    return std::make_tuple(grad_input, grad_weight, grad_bias);
+  }
 
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t f = b_begin; f < b_end; ++f) {
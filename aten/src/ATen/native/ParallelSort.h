@@ -0,0 +1,249 @@
+#pragma once
+
+#include <ATen/NumericUtils.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace at { namespace native {
+// This header is included both by kernels in native/cpu, which are compiled
+// once per CPU capability, and by regular translation units, so everything
+// here needs internal linkage.
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// Note [Parallel sort]
+// ~~~~~~~~~~~~~~~~~~~~
+// sort, topk and unique sort one slice at a time and only parallelize across
+// slices, so a single large slice (the usual case for ranking) ran on one
+// thread. The helpers here sort one large buffer with all threads:
+//
+// - parallel_radix_sort: stable LSD radix sort with 8 bit digits for bool,
+//   integer, float and double keys, carrying an int64 payload. Each
+//   pass builds per-chunk histograms in parallel, turns them into per-chunk
+//   output offsets and scatters in parallel; passes where every key has the
+//   same digit are skipped, so small integers only pay for their low bytes.
+// - parallel_merge_sort: stable sort for anything with a comparator. Chunks
+//   are sorted in parallel, then merged pairwise, one round per doubling.
+//
+// Floating point keys order NaN after +inf (before it when descending),
+// like the comparison sorts they replace. Work below kParallelSortMinSize
+// elements is left to the callers' existing serial paths.
+
+constexpr int64_t kParallelSortMinSize = 1 << 16;
+
+// Maps a key to unsigned bits whose integer order is the key order
+template <typename scalar_t, typename = void>
+struct RadixKey {
+  static constexpr bool value = false;
+};
+
+template <typename scalar_t>
+struct RadixKey<scalar_t, typename std::enable_if<std::is_integral<scalar_t>::value>::type> {
+  static constexpr bool value = true;
+  using bits_t = typename std::make_unsigned<
+      typename std::conditional<std::is_same<scalar_t, bool>::value, uint8_t, scalar_t>::type>::type;
+  static constexpr bits_t kSignBit =
+      std::is_signed<scalar_t>::value ? bits_t(1) << (sizeof(bits_t) * 8 - 1) : 0;
+
+  static bits_t to_bits(scalar_t v) {
+    return static_cast<bits_t>(v) ^ kSignBit;
+  }
+  static scalar_t from_bits(bits_t b) {
+    return static_cast<scalar_t>(b ^ kSignBit);
+  }
+};
+
+template <typename scalar_t, typename bits_type>
+struct FloatRadixKey {
+  static constexpr bool value = true;
+  using bits_t = bits_type;
+  static constexpr bits_t kSignBit = bits_t(1) << (sizeof(bits_t) * 8 - 1);
+
+  // Negative values flip all bits, positive ones only the sign bit. All NaNs
+  // become the largest key.
+  static bits_t to_bits(scalar_t v) {
+    if (_isnan(v)) {
+      return static_cast<bits_t>(~bits_t(0));
+    }
+    bits_t b;
+    std::memcpy(&b, &v, sizeof(b));
+    return (b & kSignBit) ? static_cast<bits_t>(~b) : static_cast<bits_t>(b | kSignBit);
+  }
+  static scalar_t from_bits(bits_t b) {
+    b = (b & kSignBit) ? static_cast<bits_t>(b ^ kSignBit) : static_cast<bits_t>(~b);
+    scalar_t v;
+    std::memcpy(&v, &b, sizeof(b));
+    return v;
+  }
+};
+
+template <>
+struct RadixKey<float> : FloatRadixKey<float, uint32_t> {};
+template <>
+struct RadixKey<double> : FloatRadixKey<double, uint64_t> {};
+
+// Splits [0, n) into one chunk per thread and runs f(chunk, begin, end) on
+// each chunk in parallel
+template <typename F>
+void parallel_chunks(int64_t n, int64_t nchunks, const F& f) {
+  const int64_t chunk_size = divup(n, nchunks);
+  at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      f(c, std::min(c * chunk_size, n), std::min((c + 1) * chunk_size, n));
+    }
+  });
+}
+
+// Sorts keys[0, n) and permutes indices[0, n) along with them. Stable.
+template <typename scalar_t>
+void parallel_radix_sort(scalar_t* keys, int64_t* indices, int64_t n, bool descending) {
+  using Key = RadixKey<scalar_t>;
+  using bits_t = typename Key::bits_t;
+  constexpr int kDigitBits = 8;
+  constexpr int kBuckets = 1 << kDigitBits;
+  const int64_t nchunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), n / (kParallelSortMinSize / 4)));
+
+  // Every pass sorts the bits rather than the keys, so the key transform
+  // runs once up front and once at the end.
+  std::vector<bits_t> bits(n), bits_buffer(n);
+  std::vector<int64_t> index_buffer(n);
+  const bits_t flip = descending ? static_cast<bits_t>(~bits_t(0)) : bits_t(0);
+  parallel_chunks(n, nchunks, [&](int64_t, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      bits[i] = Key::to_bits(keys[i]) ^ flip;
+    }
+  });
+
+  bits_t* src = bits.data();
+  bits_t* dst = bits_buffer.data();
+  int64_t* index_src = indices;
+  int64_t* index_dst = index_buffer.data();
+  std::vector<int64_t> offsets(nchunks * kBuckets);
+  for (int shift = 0; shift < static_cast<int>(sizeof(bits_t) * 8); shift += kDigitBits) {
+    std::fill(offsets.begin(), offsets.end(), 0);
+    parallel_chunks(n, nchunks, [&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* hist = offsets.data() + c * kBuckets;
+      for (int64_t i = begin; i < end; i++) {
+        hist[(src[i] >> shift) & (kBuckets - 1)]++;
+      }
+    });
+
+    // Bucket d of chunk c starts after all smaller digits and after digit d
+    // of the chunks before c, which keeps the pass stable.
+    bool trivial = false;
+    int64_t running = 0;
+    for (int d = 0; d < kBuckets; d++) {
+      const int64_t bucket_begin = running;
+      for (int64_t c = 0; c < nchunks; c++) {
+        const int64_t count = offsets[c * kBuckets + d];
+        offsets[c * kBuckets + d] = running;
+        running += count;
+      }
+      trivial |= (running - bucket_begin == n);
+    }
+    if (trivial) {
+      continue;
+    }
+
+    parallel_chunks(n, nchunks, [&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* offset = offsets.data() + c * kBuckets;
+      for (int64_t i = begin; i < end; i++) {
+        const int64_t pos = offset[(src[i] >> shift) & (kBuckets - 1)]++;
+        dst[pos] = src[i];
+        index_dst[pos] = index_src[i];
+      }
+    });
+    std::swap(src, dst);
+    std::swap(index_src, index_dst);
+  }
+
+  parallel_chunks(n, nchunks, [&](int64_t, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      keys[i] = Key::from_bits(src[i] ^ flip);
+    }
+    if (index_src != indices) {
+      std::copy(index_src + begin, index_src + end, indices + begin);
+    }
+  });
+}
+
+// Stable sort of data[0, n) by comp
+template <typename T, typename Compare>
+void parallel_merge_sort(T* data, int64_t n, const Compare& comp) {
+  const int64_t nchunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), n / (kParallelSortMinSize / 4)));
+  if (nchunks == 1) {
+    std::stable_sort(data, data + n, comp);
+    return;
+  }
+  parallel_chunks(n, nchunks, [&](int64_t, int64_t begin, int64_t end) {
+    std::stable_sort(data + begin, data + end, comp);
+  });
+
+  std::vector<T> buffer(n);
+  T* src = data;
+  T* dst = buffer.data();
+  for (int64_t width = divup(n, nchunks); width < n; width *= 2) {
+    const int64_t npairs = divup(n, 2 * width);
+    at::parallel_for(0, npairs, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; p++) {
+        const int64_t lo = p * 2 * width;
+        const int64_t mid = std::min(lo + width, n);
+        const int64_t hi = std::min(lo + 2 * width, n);
+        std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, comp);
+      }
+    });
+    std::swap(src, dst);
+  }
+  if (src != data) {
+    parallel_chunks(n, nchunks, [&](int64_t, int64_t begin, int64_t end) {
+      std::copy(src + begin, src + end, data + begin);
+    });
+  }
+}
+
+template <typename scalar_t>
+void parallel_sort_with_indices_impl(
+    scalar_t* keys, int64_t* indices, int64_t n, bool descending, std::true_type /*radix*/) {
+  parallel_radix_sort(keys, indices, n, descending);
+}
+
+template <typename scalar_t>
+void parallel_sort_with_indices_impl(
+    scalar_t* keys, int64_t* indices, int64_t n, bool descending, std::false_type /*radix*/) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  std::vector<elem_t> elems(n);
+  for (int64_t i = 0; i < n; i++) {
+    elems[i] = {keys[i], indices[i]};
+  }
+  if (descending) {
+    parallel_merge_sort(elems.data(), n, [](const elem_t& x, const elem_t& y) {
+      return (_isnan(x.first) && !_isnan(y.first)) || (x.first > y.first);
+    });
+  } else {
+    parallel_merge_sort(elems.data(), n, [](const elem_t& x, const elem_t& y) {
+      return (!_isnan(x.first) && _isnan(y.first)) || (x.first < y.first);
+    });
+  }
+  for (int64_t i = 0; i < n; i++) {
+    keys[i] = elems[i].first;
+    indices[i] = elems[i].second;
+  }
+}
+
+// Sorts keys[0, n), ascending or descending, and permutes indices[0, n)
+// along with them. Stable. Uses the radix sort when scalar_t has a RadixKey
+// and the merge sort otherwise.
+template <typename scalar_t>
+void parallel_sort_with_indices(scalar_t* keys, int64_t* indices, int64_t n, bool descending) {
+  parallel_sort_with_indices_impl(
+      keys, indices, n, descending,
+      std::integral_constant<bool, RadixKey<scalar_t>::value>());
+}
+
+}}} // namespace at::native::<anonymous>
@@ -0,0 +1,625 @@
+// define constants like M_PI and C keywords for MSVC
+#ifdef _MSC_VER
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+#include <math.h>
+#endif
+
+#include <ATen/native/PocketFFT.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/Utils.h>
+#include <ATen/native/SpectralOpsUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace at { namespace native {
+
+// Note [Portable CPU FFT]
+// ~~~~~~~~~~~~~~~~~~~~~~~
+// Builds without MKL (ARM, most AMD setups) get their CPU FFTs from here.
+// The algorithms follow pocketfft:
+//
+// - A complex transform of length n factors n into 4, 2 and odd primes and
+//   runs a recursive mixed-radix decimation in time, with hardcoded
+//   butterflies for radix 2, 3 and 4. Every level reads its input with a
+//   stride, so transforming a column needs no gather.
+// - When n has large prime factors, Bluestein's algorithm is cheaper: the
+//   transform becomes a convolution with a chirp, done with transforms of a
+//   2*3*5-smooth length of at least 2 * n - 1.
+// - A real transform of even length n packs the even and odd samples into
+//   one complex signal of length n / 2 and untangles the two halves with one
+//   extra twiddle pass. Odd lengths go through a complex transform.
+// - A multidimensional transform runs the 1-D ones along every signal
+//   dimension, the real one first for real-to-complex and last for
+//   complex-to-real, parallelized over the lines of the batch.
+//
+// Plans only depend on the signal, not on the batch or the strides, and live
+// in pocketfft_plan_cache(), see native/CPUFFTPlanCache.h.
+
+namespace detail {
+namespace pocketfft {
+
+template <typename T>
+using cmplx = std::complex<T>;
+
+std::vector<int64_t> factorize(int64_t n) {
+  std::vector<int64_t> factors;
+  while (n % 4 == 0) {
+    factors.push_back(4);
+    n /= 4;
+  }
+  if (n % 2 == 0) {
+    factors.push_back(2);
+    n /= 2;
+  }
+  for (int64_t p = 3; p * p <= n; p += 2) {
+    while (n % p == 0) {
+      factors.push_back(p);
+      n /= p;
+    }
+  }
+  if (n > 1) {
+    factors.push_back(n);
+  }
+  return factors;
+}
+
+// Rough operation count of the mixed-radix algorithm, as in pocketfft
+double cost_guess(int64_t n) {
+  // penalty for the radices without a hardcoded butterfly
+  constexpr double lfp = 1.1;
+  double result = 0;
+  for (int64_t f : factorize(n)) {
+    if (f == 4) {
+      result += 4;
+    } else {
+      result += f <= 5 ? f : lfp * f;
+    }
+  }
+  return result * n;
+}
+
+int64_t largest_prime_factor(int64_t n) {
+  int64_t result = 1;
+  for (int64_t f : factorize(n)) {
+    result = std::max(result, f == 4 ? 2 : f);
+  }
+  return result;
+}
+
+// Smallest 2*3*5-smooth number that is >= n
+int64_t good_size(int64_t n) {
+  int64_t best = 1;
+  while (best < n) {
+    best *= 2;
+  }
+  for (int64_t f2 = 1; f2 < best; f2 *= 2) {
+    for (int64_t f23 = f2; f23 < best; f23 *= 3) {
+      for (int64_t f235 = f23; f235 < best; f235 *= 5) {
+        if (f235 >= n) {
+          best = f235;
+        }
+      }
+    }
+  }
+  return best;
+}
+
+// exp(-2 pi i k / n) for k < count, computed in double
+template <typename T>
+std::vector<cmplx<T>> make_twiddles(int64_t n, int64_t count) {
+  std::vector<cmplx<T>> twiddles(count);
+  for (int64_t k = 0; k < count; k++) {
+    const double angle = 2 * M_PI * static_cast<double>(k) / static_cast<double>(n);
+    twiddles[k] = cmplx<T>(static_cast<T>(std::cos(angle)), static_cast<T>(-std::sin(angle)));
+  }
+  return twiddles;
+}
+
+template <typename T>
+inline cmplx<T> times_i(const cmplx<T>& z) {
+  return cmplx<T>(-z.imag(), z.real());
+}
+
+template <typename T>
+class ComplexPlan {
+ public:
+  explicit ComplexPlan(int64_t n) : n_(n) {
+    TORCH_INTERNAL_ASSERT(n >= 1);
+    if (n >= 50 && largest_prime_factor(n) * largest_prime_factor(n) > n) {
+      const int64_t m = good_size(2 * n - 1);
+      // the fudge factor is the one pocketfft uses
+      if (2 * cost_guess(m) * 1.5 < cost_guess(n)) {
+        init_bluestein(m);
+        return;
+      }
+    }
+    factors_ = factorize(n);
+    twiddles_ = make_twiddles<T>(n, n);
+    for (int64_t f : factors_) {
+      max_factor_ = std::max(max_factor_, f);
+    }
+  }
+
+  int64_t size() const {
+    return n_;
+  }
+
+  // Number of elements execute needs in scratch
+  int64_t scratch_size() const {
+    if (conv_plan_) {
+      return 2 * conv_plan_->size() + conv_plan_->scratch_size();
+    }
+    return max_factor_;
+  }
+
+  // out[k] = sum_j in[j * stride] * exp(-+2 pi i j k / n), unnormalized.
+  // out is contiguous and must not overlap in.
+  void execute(const cmplx<T>* in, int64_t stride, cmplx<T>* out,
+               bool inverse, cmplx<T>* scratch) const {
+    if (conv_plan_) {
+      bluestein(in, stride, out, inverse, scratch);
+    } else {
+      pass(in, stride, out, n_, 0, inverse, scratch);
+    }
+  }
+
+ private:
+  void init_bluestein(int64_t m) {
+    chirp_.resize(n_);
+    for (int64_t k = 0; k < n_; k++) {
+      // k^2 mod 2n keeps the angle small, and so accurate
+      const int64_t e = (k * k) % (2 * n_);
+      const double angle = M_PI * static_cast<double>(e) / static_cast<double>(n_);
+      chirp_[k] = cmplx<T>(static_cast<T>(std::cos(angle)), static_cast<T>(-std::sin(angle)));
+    }
+    conv_plan_.reset(new ComplexPlan<T>(m));
+    std::vector<cmplx<T>> kernel(m, cmplx<T>(0));
+    kernel[0] = std::conj(chirp_[0]);
+    for (int64_t k = 1; k < n_; k++) {
+      kernel[k] = kernel[m - k] = std::conj(chirp_[k]);
+    }
+    std::vector<cmplx<T>> scratch(conv_plan_->scratch_size());
+    chirp_fft_.resize(m);
+    conv_plan_->execute(kernel.data(), 1, chirp_fft_.data(), false, scratch.data());
+    // fold in the normalization of the inverse transform of the convolution
+    const T scale = T(1) / static_cast<T>(m);
+    for (auto& v : chirp_fft_) {
+      v *= scale;
+    }
+  }
+
+  // exp(-2 pi i j k / n) = chirp[j] * chirp[k] * conj(chirp[j - k]), so the
+  // transform is a convolution with conj(chirp). The inverse transform is
+  // the conjugate of the forward one of the conjugated input.
+  void bluestein(const cmplx<T>* in, int64_t stride, cmplx<T>* out,
+                 bool inverse, cmplx<T>* scratch) const {
+    const int64_t m = conv_plan_->size();
+    cmplx<T>* a = scratch;
+    cmplx<T>* c = scratch + m;
+    cmplx<T>* sub = scratch + 2 * m;
+    for (int64_t k = 0; k < n_; k++) {
+      const cmplx<T> x = in[k * stride];
+      a[k] = (inverse ? std::conj(x) : x) * chirp_[k];
+    }
+    std::fill(a + n_, a + m, cmplx<T>(0));
+    conv_plan_->execute(a, 1, c, false, sub);
+    for (int64_t k = 0; k < m; k++) {
+      c[k] *= chirp_fft_[k];
+    }
+    conv_plan_->execute(c, 1, a, true, sub);
+    for (int64_t k = 0; k < n_; k++) {
+      const cmplx<T> y = a[k] * chirp_[k];
+      out[k] = inverse ? std::conj(y) : y;
+    }
+  }
+
+  // Transform of length n with the factors from factor_idx on. Each of the
+  // p sub-transforms of length m = n / p takes every p-th input and writes
+  // out[r * m, (r + 1) * m), then the butterflies combine them in place.
+  void pass(const cmplx<T>* in, int64_t stride, cmplx<T>* out, int64_t n,
+            size_t factor_idx, bool inverse, cmplx<T>* tmp) const {
+    if (n == 1) {
+      out[0] = in[0];
+      return;
+    }
+    const int64_t p = factors_[factor_idx];
+    const int64_t m = n / p;
+    for (int64_t r = 0; r < p; r++) {
+      pass(in + r * stride, stride * p, out + r * m, m, factor_idx + 1, inverse, tmp);
+    }
+
+    // exp(-2 pi i e / n) == twiddles_[e * ts]
+    const int64_t ts = n_ / n;
+    auto twiddle = [&](int64_t e) {
+      return inverse ? std::conj(twiddles_[e]) : twiddles_[e];
+    };
+    switch (p) {
+      case 2:
+        for (int64_t k = 0; k < m; k++) {
+          const cmplx<T> a = out[k];
+          const cmplx<T> b = k == 0 ? out[m] : out[m + k] * twiddle(k * ts);
+          out[k] = a + b;
+          out[m + k] = a - b;
+        }
+        break;
+      case 3: {
+        const T sin60 = static_cast<T>((inverse ? 0.5 : -0.5) * std::sqrt(3.0));
+        for (int64_t k = 0; k < m; k++) {
+          const cmplx<T> t0 = out[k];
+          const cmplx<T> t1 = k == 0 ? out[m] : out[m + k] * twiddle(k * ts);
+          const cmplx<T> t2 = k == 0 ? out[2 * m] : out[2 * m + k] * twiddle(2 * k * ts);
+          const cmplx<T> s = t1 + t2;
+          const cmplx<T> c = t0 - s * T(0.5);
+          const cmplx<T> d = times_i(t1 - t2) * sin60;
+          out[k] = t0 + s;
+          out[m + k] = c + d;
+          out[2 * m + k] = c - d;
+        }
+        break;
+      }
+      case 4:
+        for (int64_t k = 0; k < m; k++) {
+          const cmplx<T> t0 = out[k];
+          cmplx<T> t1 = out[m + k];
+          cmplx<T> t2 = out[2 * m + k];
+          cmplx<T> t3 = out[3 * m + k];
+          if (k != 0) {
+            t1 *= twiddle(k * ts);
+            t2 *= twiddle(2 * k * ts);
+            t3 *= twiddle(3 * k * ts);
+          }
+          const cmplx<T> a = t0 + t2;
+          const cmplx<T> b = t0 - t2;
+          const cmplx<T> c = t1 + t3;
+          // -i (t1 - t3) forward, i (t1 - t3) inverse
+          const cmplx<T> d = inverse ? times_i(t1 - t3) : -times_i(t1 - t3);
+          out[k] = a + c;
+          out[m + k] = b + d;
+          out[2 * m + k] = a - c;
+          out[3 * m + k] = b - d;
+        }
+        break;
+      default: {
+        // exp(-2 pi i e / p) == twiddles_[e * tp]
+        const int64_t tp = n_ / p;
+        for (int64_t k = 0; k < m; k++) {
+          for (int64_t r = 0; r < p; r++) {
+            tmp[r] = out[r * m + k] * twiddle(r * k * ts);
+          }
+          for (int64_t q = 0; q < p; q++) {
+            cmplx<T> acc = tmp[0];
+            for (int64_t r = 1; r < p; r++) {
+              acc += tmp[r] * twiddle(((r * q) % p) * tp);
+            }
+            out[q * m + k] = acc;
+          }
+        }
+      }
+    }
+  }
+
+  int64_t n_;
+  std::vector<int64_t> factors_;
+  int64_t max_factor_ = 0;
+  // exp(-2 pi i k / n) for k < n
+  std::vector<cmplx<T>> twiddles_;
+  // Bluestein, when conv_plan_ is set
+  std::unique_ptr<ComplexPlan<T>> conv_plan_;
+  // exp(-pi i k^2 / n) for k < n
+  std::vector<cmplx<T>> chirp_;
+  // transform of the conjugated chirp padded to the convolution length
+  std::vector<cmplx<T>> chirp_fft_;
+};
+
+template <typename T>
+class RealPlan {
+ public:
+  explicit RealPlan(int64_t n)
+    : n_(n), plan_(n % 2 == 0 ? n / 2 : n) {
+    if (n % 2 == 0) {
+      twiddles_ = make_twiddles<T>(n, n / 2 + 1);
+    }
+  }
+
+  int64_t scratch_size() const {
+    return 2 * plan_.size() + plan_.scratch_size();
+  }
+
+  // out[k] for k <= n / 2: the transform of the n reals in[j * stride]
+  void forward(const T* in, int64_t stride, cmplx<T>* out, cmplx<T>* scratch) const {
+    const int64_t h = plan_.size();
+    cmplx<T>* z = scratch;
+    cmplx<T>* zt = scratch + h;
+    cmplx<T>* sub = scratch + 2 * h;
+    if (n_ % 2 != 0) {
+      for (int64_t j = 0; j < n_; j++) {
+        z[j] = cmplx<T>(in[j * stride], 0);
+      }
+      plan_.execute(z, 1, zt, false, sub);
+      std::copy(zt, zt + n_ / 2 + 1, out);
+      return;
+    }
+    for (int64_t j = 0; j < h; j++) {
+      z[j] = cmplx<T>(in[2 * j * stride], in[(2 * j + 1) * stride]);
+    }
+    plan_.execute(z, 1, zt, false, sub);
+    // zt = E + i O with E, O the transforms of the even and odd samples,
+    // and X[k] = E[k] + exp(-2 pi i k / n) O[k]
+    for (int64_t k = 0; k <= h; k++) {
+      const cmplx<T> a = zt[k % h];
+      const cmplx<T> b = std::conj(zt[(h - k) % h]);
+      const cmplx<T> even = (a + b) * T(0.5);
+      const cmplx<T> odd = -times_i(a - b) * T(0.5);
+      out[k] = even + twiddles_[k] * odd;
+    }
+  }
+
+  // out[j * out_stride] for j < n: the unnormalized inverse transform of the
+  // Hermitian signal whose first n / 2 + 1 values are in. The imaginary parts
+  // of in[0] and, for even n, in[n / 2] are ignored.
+  void inverse(const cmplx<T>* in, T* out, int64_t out_stride, cmplx<T>* scratch) const {
+    const int64_t h = plan_.size();
+    cmplx<T>* z = scratch;
+    cmplx<T>* zt = scratch + h;
+    cmplx<T>* sub = scratch + 2 * h;
+    const int64_t last = n_ / 2;
+    auto spectrum = [&](int64_t k) {
+      if (k == 0 || (n_ % 2 == 0 && k == last)) {
+        return cmplx<T>(in[k].real(), 0);
+      }
+      return in[k];
+    };
+    if (n_ % 2 != 0) {
+      for (int64_t k = 0; k < n_; k++) {
+        z[k] = k <= last ? spectrum(k) : std::conj(spectrum(n_ - k));
+      }
+      plan_.execute(z, 1, zt, true, sub);
+      for (int64_t j = 0; j < n_; j++) {
+        out[j * out_stride] = zt[j].real();
+      }
+      return;
+    }
+    // Inverts the untangling in forward; leaving out its factors 1/2 scales
+    // the length h transform up to a length n one.
+    for (int64_t k = 0; k < h; k++) {
+      const cmplx<T> a = spectrum(k);
+      const cmplx<T> b = std::conj(spectrum(h - k));
+      const cmplx<T> even = a + b;
+      const cmplx<T> odd = (a - b) * std::conj(twiddles_[k]);
+      z[k] = even + times_i(odd);
+    }
+    plan_.execute(z, 1, zt, true, sub);
+    for (int64_t j = 0; j < h; j++) {
+      out[2 * j * out_stride] = zt[j].real();
+      out[(2 * j + 1) * out_stride] = zt[j].imag();
+    }
+  }
+
+ private:
+  int64_t n_;
+  ComplexPlan<T> plan_;
+  // exp(-2 pi i k / n) for k <= n / 2, even n only
+  std::vector<cmplx<T>> twiddles_;
+};
+
+// The 1-D plans of every signal dimension. The last one is real for
+// real-to-complex and complex-to-real transforms.
+template <typename T>
+struct SignalPlans {
+  std::vector<std::unique_ptr<ComplexPlan<T>>> complex_dims;
+  std::unique_ptr<RealPlan<T>> real_last_dim;
+
+  SignalPlans(IntArrayRef signal_sizes, bool real) {
+    const int64_t ndim = signal_sizes.size();
+    for (int64_t d = 0; d < ndim; d++) {
+      if (d == ndim - 1 && real) {
+        complex_dims.emplace_back(nullptr);
+        real_last_dim.reset(new RealPlan<T>(signal_sizes[d]));
+      } else {
+        complex_dims.emplace_back(new ComplexPlan<T>(signal_sizes[d]));
+      }
+    }
+  }
+};
+
+} // namespace pocketfft
+
+struct PocketFFTPlan {
+  std::unique_ptr<pocketfft::SignalPlans<float>> float_plans;
+  std::unique_ptr<pocketfft::SignalPlans<double>> double_plans;
+
+  template <typename T>
+  const pocketfft::SignalPlans<T>& get() const;
+};
+
+template <>
+const pocketfft::SignalPlans<float>& PocketFFTPlan::get<float>() const {
+  return *float_plans;
+}
+
+template <>
+const pocketfft::SignalPlans<double>& PocketFFTPlan::get<double>() const {
+  return *double_plans;
+}
+
+CPUFFTParamsLRUCache<PocketFFTPlan>& pocketfft_plan_cache() {
+  static CPUFFTParamsLRUCache<PocketFFTPlan> cache;
+  return cache;
+}
+
+} // namespace detail
+
+namespace {
+
+using detail::pocketfft::ComplexPlan;
+using detail::pocketfft::cmplx;
+
+// Runs fn(line, scratch) for every line in [0, lines), in parallel. Every
+// task gets its own scratch of scratch_size complex values.
+template <typename T, typename Fn>
+void for_each_line(int64_t lines, int64_t line_size, int64_t scratch_size, const Fn& fn) {
+  const int64_t grain = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, line_size));
+  at::parallel_for(0, lines, grain, [&](int64_t begin, int64_t end) {
+    std::vector<cmplx<T>> scratch(scratch_size);
+    for (int64_t line = begin; line < end; line++) {
+      fn(line, scratch.data());
+    }
+  });
+}
+
+// In place complex transforms along a dimension of size n of the contiguous
+// buffer data, with outer elements before it and the product of the sizes
+// after it being inner_rest * last. Only the first `valid` of every `last`
+// elements of the innermost dimension are transformed, the rest of a
+// onesided buffer is filled by conjugate symmetry afterwards.
+template <typename T>
+void transform_dim(cmplx<T>* data, int64_t outer, int64_t n, int64_t inner_rest,
+                   int64_t last, int64_t valid, const ComplexPlan<T>& plan, bool inverse) {
+  const int64_t stride = inner_rest * last;
+  const int64_t columns = inner_rest * valid;
+  for_each_line<T>(outer * columns, n, n + plan.scratch_size(),
+      [&](int64_t line, cmplx<T>* scratch) {
+        const int64_t o = line / columns;
+        const int64_t column = line % columns;
+        cmplx<T>* start = data + o * n * stride + (column / valid) * last + column % valid;
+        plan.execute(start, stride, scratch, inverse, scratch + n);
+        for (int64_t j = 0; j < n; j++) {
+          start[j * stride] = scratch[j];
+        }
+      });
+}
+
+template <typename T>
+void pocketfft_impl(const Tensor& input, Tensor& output, int64_t signal_ndim,
+                    bool complex_input, bool complex_output, bool inverse,
+                    IntArrayRef signal_sizes, const detail::pocketfft::SignalPlans<T>& plans) {
+  const int64_t batch = input.size(0);
+  const int64_t n_last = signal_sizes[signal_ndim - 1];
+
+  // Complex transforms along the non-last signal dimensions of the contiguous
+  // complex buffer data, whose last dimension has size last of which the
+  // first valid are transformed
+  auto transform_leading_dims = [&](cmplx<T>* data, int64_t last, int64_t valid, bool inv) {
+    for (int64_t d = 0; d < signal_ndim - 1; d++) {
+      int64_t outer = batch;
+      for (int64_t i = 0; i < d; i++) {
+        outer *= signal_sizes[i];
+      }
+      int64_t inner_rest = 1;
+      for (int64_t i = d + 1; i < signal_ndim - 1; i++) {
+        inner_rest *= signal_sizes[i];
+      }
+      transform_dim<T>(data, outer, signal_sizes[d], inner_rest, last, valid,
+                       *plans.complex_dims[d], inv);
+    }
+  };
+  const int64_t lines = input.numel() / (complex_input ? 2 * input.size(signal_ndim) : input.size(signal_ndim));
+
+  if (complex_input && complex_output) {
+    const auto in = reinterpret_cast<const cmplx<T>*>(input.data_ptr<T>());
+    auto out = reinterpret_cast<cmplx<T>*>(output.data_ptr<T>());
+    const ComplexPlan<T>& plan = *plans.complex_dims[signal_ndim - 1];
+    for_each_line<T>(lines, n_last, plan.scratch_size(), [&](int64_t line, cmplx<T>* scratch) {
+      plan.execute(in + line * n_last, 1, out + line * n_last, inverse, scratch);
+    });
+    transform_leading_dims(out, n_last, n_last, inverse);
+  } else if (complex_output) {
+    // The transform of a real signal in the inverse direction is the
+    // conjugate of the forward one
+    const T* in = input.data_ptr<T>();
+    auto out = reinterpret_cast<cmplx<T>*>(output.data_ptr<T>());
+    const int64_t out_last = output.size(signal_ndim);
+    const int64_t valid = n_last / 2 + 1;
+    const auto& plan = *plans.real_last_dim;
+    for_each_line<T>(lines, n_last, plan.scratch_size(), [&](int64_t line, cmplx<T>* scratch) {
+      plan.forward(in + line * n_last, 1, out + line * out_last, scratch);
+    });
+    transform_leading_dims(out, out_last, valid, /*inv=*/false);
+    if (inverse) {
+      output.narrow(signal_ndim, 0, valid).select(-1, 1).neg_();
+    }
+  } else {
+    // The forward transform of a Hermitian signal is the inverse one of its
+    // conjugate
+    Tensor buffer = input;
+    if (signal_ndim > 1 || !inverse) {
+      buffer = input.clone(at::MemoryFormat::Contiguous);
+    }
+    if (!inverse) {
+      buffer.select(-1, 1).neg_();
+    }
+    auto data = reinterpret_cast<cmplx<T>*>(buffer.data_ptr<T>());
+    const int64_t in_last = input.size(signal_ndim);
+    transform_leading_dims(data, in_last, n_last / 2 + 1, /*inv=*/true);
+    T* out = output.data_ptr<T>();
+    const auto& plan = *plans.real_last_dim;
+    for_each_line<T>(lines, n_last, plan.scratch_size(), [&](int64_t line, cmplx<T>* scratch) {
+      plan.inverse(data + line * in_last, out + line * n_last, 1, scratch);
+    });
+  }
+}
+
+} // namespace
+
+Tensor _fft_pocketfft(const Tensor& self, int64_t signal_ndim,
+                      bool complex_input, bool complex_output,
+                      bool inverse, IntArrayRef checked_signal_sizes,
+                      bool normalized, bool onesided,
+                      IntArrayRef output_sizes) {
+  TORCH_CHECK(self.scalar_type() == ScalarType::Float || self.scalar_type() == ScalarType::Double,
+              "fft doesn't support tensor of type: ", toString(self.scalar_type()));
+  const Tensor input = self.contiguous();
+  Tensor output = at::empty(output_sizes, input.options());
+  if (input.numel() == 0 || output.numel() == 0) {
+    return output;
+  }
+
+  const bool real = !complex_input || !complex_output;
+  detail::CPUFFTParams params;
+  detail::setCPUFFTParams(&params, input, signal_ndim, complex_input,
+      complex_output, inverse, checked_signal_sizes, normalized, onesided,
+      /*with_layout=*/false);
+  auto plan = detail::pocketfft_plan_cache().get_or_create(params, [&] {
+    auto new_plan = std::make_shared<detail::PocketFFTPlan>();
+    if (input.scalar_type() == ScalarType::Float) {
+      new_plan->float_plans.reset(new detail::pocketfft::SignalPlans<float>(checked_signal_sizes, real));
+    } else {
+      new_plan->double_plans.reset(new detail::pocketfft::SignalPlans<double>(checked_signal_sizes, real));
+    }
+    return new_plan;
+  });
+
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "_fft_pocketfft", [&] {
+    pocketfft_impl<scalar_t>(input, output, signal_ndim, complex_input,
+                             complex_output, inverse, checked_signal_sizes,
+                             plan->get<scalar_t>());
+  });
+
+  // rescale if needed by normalized flag or inverse transform
+  if (normalized || inverse) {
+    auto signal_numel = at::prod_intlist(checked_signal_sizes);
+    double scale;
+    if (normalized) {
+      scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
+    } else {
+      scale = 1.0 / static_cast<double>(signal_numel);
+    }
+    if (!complex_input && complex_output && !onesided) {
+      // only the onesided half has been computed so far
+      auto n_last = checked_signal_sizes[signal_ndim - 1];
+      output.narrow(signal_ndim, 0, infer_ft_real_to_complex_onesided_size(n_last)).mul_(scale);
+    } else {
+      output.mul_(scale);
+    }
+  }
+  return output;
+}
+
+}} // namespace at::native
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/CPUFFTPlanCache.h>
+
+namespace at { namespace native {
+
+// Portable multithreaded FFT, used by _fft_mkl when ATen is built without
+// MKL. Takes the same arguments as _fft_with_size. For a real-to-complex
+// transform with onesided=false it only fills the onesided half of the
+// output, like MKL; see NOTE [ Fourier Transform Conjugate Symmetry ].
+Tensor _fft_pocketfft(const Tensor& input, int64_t signal_ndim,
+                      bool complex_input, bool complex_output,
+                      bool inverse, IntArrayRef checked_signal_sizes,
+                      bool normalized, bool onesided,
+                      IntArrayRef output_sizes);
+
+namespace detail {
+
+struct PocketFFTPlan;
+
+CPUFFTParamsLRUCache<PocketFFTPlan>& pocketfft_plan_cache();
+
+} // namespace detail
+
+}} // namespace at::native
@@ -0,0 +1,130 @@
+#include <ATen/native/PointwiseChain.h>
+
+#include <ATen/core/grad_mode.h>
+#include <ATen/native/TensorIterator.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(pointwise_chain_stub);
+
+PointwiseChain::PointwiseChain(const Tensor& self) {
+  TORCH_CHECK(self.defined(), "PointwiseChain: expected a defined tensor");
+  inputs_.push_back(self);
+}
+
+PointwiseChain& PointwiseChain::push(
+    PointwiseOpKind kind, const Tensor& other, Scalar scalar) {
+  int input = -1;
+  if (other.defined()) {
+    input = inputs_.size();
+    inputs_.push_back(other);
+  }
+  ops_.push_back({kind, input, scalar});
+  return *this;
+}
+
+PointwiseChain& PointwiseChain::add(const Tensor& other, Scalar alpha) {
+  return push(PointwiseOpKind::ADD, other, alpha);
+}
+
+PointwiseChain& PointwiseChain::sub(const Tensor& other, Scalar alpha) {
+  return push(PointwiseOpKind::SUB, other, alpha);
+}
+
+PointwiseChain& PointwiseChain::mul(const Tensor& other) {
+  return push(PointwiseOpKind::MUL, other, 1);
+}
+
+PointwiseChain& PointwiseChain::div(const Tensor& other) {
+  return push(PointwiseOpKind::DIV, other, 1);
+}
+
+PointwiseChain& PointwiseChain::add(Scalar other) {
+  return push(PointwiseOpKind::ADD_SCALAR, Tensor(), other);
+}
+
+PointwiseChain& PointwiseChain::mul(Scalar other) {
+  return push(PointwiseOpKind::MUL_SCALAR, Tensor(), other);
+}
+
+PointwiseChain& PointwiseChain::relu() {
+  return push(PointwiseOpKind::RELU, Tensor(), 0);
+}
+
+PointwiseChain& PointwiseChain::sigmoid() {
+  return push(PointwiseOpKind::SIGMOID, Tensor(), 0);
+}
+
+PointwiseChain& PointwiseChain::tanh() {
+  return push(PointwiseOpKind::TANH, Tensor(), 0);
+}
+
+bool PointwiseChain::can_fuse() const {
+  const ScalarType dtype = inputs_[0].scalar_type();
+  if (dtype != kFloat && dtype != kDouble) {
+    return false;
+  }
+  for (const auto& input : inputs_) {
+    if (!input.device().is_cpu() || input.layout() != kStrided ||
+        input.scalar_type() != dtype ||
+        (at::GradMode::is_enabled() && input.requires_grad())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Tensor PointwiseChain::run_unfused() const {
+  Tensor result = inputs_[0];
+  for (const auto& op : ops_) {
+    switch (op.kind) {
+      case PointwiseOpKind::ADD:
+        result = at::add(result, inputs_[op.input], op.scalar);
+        break;
+      case PointwiseOpKind::SUB:
+        result = at::sub(result, inputs_[op.input], op.scalar);
+        break;
+      case PointwiseOpKind::MUL:
+        result = at::mul(result, inputs_[op.input]);
+        break;
+      case PointwiseOpKind::DIV:
+        result = at::div(result, inputs_[op.input]);
+        break;
+      case PointwiseOpKind::ADD_SCALAR:
+        result = at::add(result, op.scalar);
+        break;
+      case PointwiseOpKind::MUL_SCALAR:
+        result = at::mul(result, op.scalar);
+        break;
+      case PointwiseOpKind::RELU:
+        result = at::relu(result);
+        break;
+      case PointwiseOpKind::SIGMOID:
+        result = at::sigmoid(result);
+        break;
+      case PointwiseOpKind::TANH:
+        result = at::tanh(result);
+        break;
+    }
+  }
+  return result;
+}
+
+Tensor PointwiseChain::run() const {
+  if (ops_.empty()) {
+    return inputs_[0].clone();
+  }
+  if (!can_fuse()) {
+    return run_unfused();
+  }
+  TensorIteratorConfig config;
+  config.add_output(Tensor());
+  for (const auto& input : inputs_) {
+    config.add_input(input);
+  }
+  auto iter = config.build();
+  pointwise_chain_stub(iter.device_type(), iter, ops_);
+  return iter.output();
+}
+
+}} // namespace at::native
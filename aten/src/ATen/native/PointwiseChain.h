@@ -0,0 +1,79 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { struct TensorIterator; }
+
+namespace at { namespace native {
+
+// Note [Fused pointwise chains]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// In eager mode `a.mul(b).add_(c).relu_()` runs three kernels, each making a
+// full pass over memory. For activation-heavy models on CPU the passes, not
+// the arithmetic, dominate. PointwiseChain records a sequence of elementwise
+// ops and runs all of them in a single TensorIterator loop:
+//
+//   Tensor out = PointwiseChain(a).mul(b).add(c).relu().run();
+//
+// The kernel works on blocks of elements small enough to stay in L1, so
+// every input is read once and the output written once, however long the
+// chain is. Inputs are broadcast together like in eager mode.
+//
+// The fused kernel handles float and double CPU tensors that all have the
+// same dtype. Anything else (other dtypes or devices, mixed dtypes, inputs
+// that require grad) runs the recorded ops one by one through the regular
+// operators, so the result is always the same as eager mode.
+
+enum class PointwiseOpKind : uint8_t {
+  ADD,         // self + alpha * other
+  SUB,         // self - alpha * other
+  MUL,         // self * other
+  DIV,         // self / other
+  ADD_SCALAR,  // self + scalar
+  MUL_SCALAR,  // self * scalar
+  RELU,
+  SIGMOID,
+  TANH
+};
+
+struct PointwiseOp {
+  PointwiseOpKind kind;
+  // Index of the tensor operand in the chain's inputs (input 0 is the
+  // chain's first argument), or -1 for ops without one.
+  int input;
+  // alpha for ADD and SUB, the scalar for ADD_SCALAR and MUL_SCALAR
+  Scalar scalar;
+};
+
+class CAFFE2_API PointwiseChain final {
+ public:
+  explicit PointwiseChain(const Tensor& self);
+
+  PointwiseChain& add(const Tensor& other, Scalar alpha = 1);
+  PointwiseChain& sub(const Tensor& other, Scalar alpha = 1);
+  PointwiseChain& mul(const Tensor& other);
+  PointwiseChain& div(const Tensor& other);
+  PointwiseChain& add(Scalar other);
+  PointwiseChain& mul(Scalar other);
+  PointwiseChain& relu();
+  PointwiseChain& sigmoid();
+  PointwiseChain& tanh();
+
+  // Runs the recorded ops and returns the result.
+  Tensor run() const;
+
+ private:
+  PointwiseChain& push(PointwiseOpKind kind, const Tensor& other, Scalar scalar);
+  bool can_fuse() const;
+  Tensor run_unfused() const;
+
+  SmallVector<Tensor, 4> inputs_;
+  SmallVector<PointwiseOp, 8> ops_;
+};
+
+// Operand 0 of the iterator is the output, operand i + 1 is input i.
+using pointwise_chain_fn = void(*)(TensorIterator&, ArrayRef<PointwiseOp>);
+DECLARE_DISPATCH(pointwise_chain_fn, pointwise_chain_stub);
+
+}} // namespace at::native
@@ -2,6 +2,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/div_rtn.h>
+#include <ATen/native/DispatchStub.h>
 #include <tuple>
 
 #pragma once
@@ -9,6 +10,37 @@
 namespace at {
 namespace native {
 
+// Channels last (NHWC) kernels of cpu/PoolKernel.cpp: they run over whole
+// rows of channels, so channels last input is pooled in place instead of
+// being converted to contiguous and back. Outputs and gradients come out
+// channels last too.
+using max_pool2d_fn = void(*)(Tensor& output, Tensor& indices, const Tensor& input,
+    int kW, int kH, int dW, int dH, int padW, int padH, int dilationW, int dilationH);
+using max_pool2d_backward_fn = void(*)(Tensor& grad_input, const Tensor& grad_output, const Tensor& indices);
+using avg_pool2d_fn = void(*)(Tensor& output, const Tensor& input,
+    int kW, int kH, int dW, int dH, int padW, int padH,
+    bool count_include_pad, c10::optional<int64_t> divisor_override);
+using avg_pool2d_backward_fn = void(*)(Tensor& grad_input, const Tensor& grad_output,
+    int kW, int kH, int dW, int dH, int padW, int padH,
+    bool count_include_pad, c10::optional<int64_t> divisor_override);
+using adaptive_avg_pool2d_fn = void(*)(Tensor& output, const Tensor& input);
+using adaptive_avg_pool2d_backward_fn = void(*)(Tensor& grad_input, const Tensor& grad_output);
+
+DECLARE_DISPATCH(max_pool2d_fn, max_pool2d_channels_last_kernel);
+DECLARE_DISPATCH(max_pool2d_backward_fn, max_pool2d_channels_last_backward_kernel);
+DECLARE_DISPATCH(avg_pool2d_fn, avg_pool2d_channels_last_kernel);
+DECLARE_DISPATCH(avg_pool2d_backward_fn, avg_pool2d_channels_last_backward_kernel);
+DECLARE_DISPATCH(adaptive_avg_pool2d_fn, adaptive_avg_pool2d_channels_last_kernel);
+DECLARE_DISPATCH(adaptive_avg_pool2d_backward_fn, adaptive_avg_pool2d_channels_last_backward_kernel);
+
+// Whether the channels last kernels above handle input
+static inline bool use_channels_last_pool2d(const Tensor& input) {
+  return input.dim() == 4 &&
+         input.numel() > 0 &&
+         input.suggest_memory_format() == at::MemoryFormat::ChannelsLast &&
+         (input.scalar_type() == kFloat || input.scalar_type() == kDouble);
+}
+
 namespace {
 
 template <typename dest_t, typename src_t>
@@ -2,8 +2,10 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/mkl/PackedOpContext.h>
 #include <ATen/native/quantized/cpu/packed_params.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
@@ -91,6 +93,8 @@ struct CellParams : public CellParamsBase {
   const Tensor& w_hh;
   const Tensor& b_ih_; /* optional */
   const Tensor& b_hh_; /* optional */
+  // w_hh and b_hh_ packed for the hidden state gemm, see prepack_hh_weights
+  c10::intrusive_ptr<cpu_prepacked::LinearOpContext> packed_hh;
 
   Tensor matmul_ih(const Tensor& input) const override {
     return at::matmul(input, w_ih.t());
@@ -102,6 +106,9 @@ struct CellParams : public CellParamsBase {
     return at::linear(input, w_ih, b_ih_);
   }
   Tensor linear_hh(const Tensor& h) const override {
+    if (packed_hh) {
+      return packed_hh->run(h);
+    }
     return at::linear(h, w_hh, b_hh_);
   }
   const Tensor& b_ih() const override {
@@ -525,6 +532,29 @@ static std::vector<CellParams> gather_params(TensorList params, bool has_biases)
   return result;
 }
 
+// The input projection of a layer is a single gemm over all timesteps, but
+// w_hh is multiplied by a new hidden state at every step. For CPU inference
+// over more than one step, pack it once up front instead of on every linear
+// call; see Note [CPU prepacked weights].
+static void prepack_hh_weights(
+    std::vector<CellParams>& params, const Tensor& input,
+    TensorList weights, int64_t steps) {
+  if (!input.device().is_cpu() || input.scalar_type() != at::kFloat || steps <= 1) {
+    return;
+  }
+  if (at::GradMode::is_enabled() &&
+      (input.requires_grad() ||
+       std::any_of(weights.begin(), weights.end(),
+                   [](const Tensor& w) { return w.requires_grad(); }))) {
+    return;
+  }
+  for (auto& p : params) {
+    p.packed_hh = cpu_prepacked::createLinearPrePackOpContext(
+        p.w_hh,
+        p.b_hh_.defined() ? c10::optional<Tensor>(p.b_hh_) : c10::nullopt);
+  }
+}
+
 // These gather_* functions are kept solely for the purposes of backward
 // compatbility in the legacy quantized_{lstm,gru} APIs
 
@@ -682,6 +712,14 @@ struct SimpleCell : Cell<Tensor, cell_params> {
   }
 };
 
+// The CPU _thnn_fused_*_cell kernels fuse the pointwise gate math of one
+// step; they take the gates already multiplied by the weights.
+inline bool use_fused_cpu_cell(const Tensor& input, const Tensor& hx) {
+  return input.device().is_cpu() && input.layout() == at::kStrided &&
+      (input.scalar_type() == at::kFloat || input.scalar_type() == at::kDouble) &&
+      input.dim() == 2 && hx.dim() == 2 && hx.scalar_type() == input.scalar_type();
+}
+
 // TODO: can use inplace ops?
 template <typename cell_params>
 struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
@@ -705,6 +743,14 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
       return std::make_tuple(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
     }
 
+    if (use_fused_cpu_cell(input, hx)) {
+      // The biases are already added by the linear calls
+      auto igates = pre_compute_input ? input : params.linear_ih(input);
+      auto hgates = params.linear_hh(hx);
+      auto result = at::_thnn_fused_lstm_cell(igates, hgates, cx);
+      return std::make_tuple(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
+    }
+
     const auto gates = params.linear_hh(hx).add_(
         pre_compute_input ? input : params.linear_ih(input));
     auto chunked_gates = gates.chunk(4, 1);
@@ -737,6 +783,11 @@ struct GRUCell : Cell<Tensor, cell_params> {
       // Slice off the workspace argument (it's needed only for AD).
       return std::move(std::get<0>(result));
     }
+    if (use_fused_cpu_cell(input, hidden)) {
+      auto igates = pre_compute_input ? input : params.linear_ih(input);
+      auto hgates = params.linear_hh(hidden);
+      return std::get<0>(at::_thnn_fused_gru_cell(igates, hgates, hidden));
+    }
     const auto chunked_igates = pre_compute_input
         ? input.chunk(3, 1)
         : params.linear_ih(input).chunk(3, 1);
@@ -1185,6 +1236,7 @@ bool _use_cudnn_rnn_flatten_weight() {
     check_device(_input, _params, hx);                                      \
     auto input = batch_first ? _input.transpose(0, 1) : _input;             \
     auto params = gather_params(_params, has_biases);                       \
+    prepack_hh_weights(params, input, _params, input.size(0));              \
     auto results =                                                          \
         _rnn_impl_with_concat<CELL, FullLayer, FullBidirectionalLayer>(     \
             input,                                                          \
@@ -1246,6 +1298,7 @@ bool _use_cudnn_rnn_flatten_weight() {
     }                                                                       \
     PackedSequence input{data, batch_sizes};                                \
     auto params = gather_params(_params, has_biases);                       \
+    prepack_hh_weights(params, data, _params, batch_sizes.size(0));         \
     auto result =                                                           \
         _rnn_impl_with_concat<CELL, PackedLayer, PackedBidirectionalLayer>( \
             input,                                                          \
@@ -1413,6 +1466,7 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
   check_device(_input, _params, hx);
   auto input = batch_first ? _input.transpose(0, 1) : _input;
   auto params = gather_params(_params, has_biases);
+  prepack_hh_weights(params, input, _params, input.size(0));
   auto results = _lstm_impl<FullLayer, FullBidirectionalLayer>(
       input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
   if (batch_first) {
@@ -1442,6 +1496,7 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
 
   PackedSequence input { data, batch_sizes };
   auto params = gather_params(_params, has_biases);
+  prepack_hh_weights(params, data, _params, batch_sizes.size(0));
   auto result = _lstm_impl<PackedLayer, PackedBidirectionalLayer>(
       input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
   auto & packed_output = std::get<0>(result);
@@ -1548,6 +1603,124 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_differentiable_gru_cell
                          std::move(grad_hx), std::move(grad_input_bias), std::move(grad_hidden_bias));
 }
 
+DEFINE_DISPATCH(fused_lstm_cell_stub);
+DEFINE_DISPATCH(fused_lstm_cell_backward_stub);
+DEFINE_DISPATCH(fused_gru_cell_stub);
+DEFINE_DISPATCH(fused_gru_cell_backward_stub);
+
+// Factor will be 3 for GRU and 4 for LSTM
+static void check_fused_cell_sizes(CheckedFrom c,
+                const TensorArg& input_gates, const TensorArg& hidden_gates,
+                const TensorArg& input_bias, const TensorArg& hidden_bias,
+                int64_t factor, const TensorArg& prev_hidden) {
+  checkDim(c, input_gates, 2);
+  checkSameSize(c, input_gates, hidden_gates);
+  int64_t gates_size = input_gates->size(1);
+
+  if (input_bias->defined()) {
+    checkDim(c, input_bias, 1);
+    checkNumel(c, input_bias, gates_size);
+    checkSameSize(c, input_bias, hidden_bias);
+  }
+
+  checkDim(c, prev_hidden, 2);
+  checkNumel(c, prev_hidden, input_gates->size(0) * gates_size / factor);
+  checkAllSameType(c, {input_gates, hidden_gates, prev_hidden});
+}
+
+static Tensor contiguous_if_defined(const Tensor& t) {
+  return t.defined() ? t.contiguous() : t;
+}
+
+std::tuple<Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_cpu(
+      const Tensor& input_gates, const Tensor& hidden_gates,
+      const Tensor& cx,
+      const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_sizes("_thnn_fused_lstm_cell_cpu",
+             {input_gates, "input_gates", 1}, {hidden_gates, "hidden_gates", 2},
+             {input_bias, "input_bias", 3}, {hidden_bias, "hidden_bias", 4},
+             /*factor=*/4, {cx, "prev_hidden", 5});
+
+  auto workspace = at::empty_like(input_gates, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto hy = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto cy = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  fused_lstm_cell_stub(kCPU, hy, cy, workspace,
+      input_gates.contiguous(), hidden_gates.contiguous(),
+      contiguous_if_defined(input_bias), contiguous_if_defined(hidden_bias),
+      cx.contiguous());
+  return std::make_tuple(hy, cy, workspace);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_backward_cpu(
+      const Tensor& grad_hy, const Tensor& grad_cy,
+      const Tensor& cx, const Tensor& cy,
+      const Tensor& workspace, bool has_bias) {
+  if (!grad_hy.defined() && !grad_cy.defined()) {
+    return std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>();
+  }
+  CheckedFrom c = "_thnn_fused_lstm_cell_backward_cpu";
+  const Tensor& defined_grad = grad_hy.defined() ? grad_hy : grad_cy;
+  TORCH_CHECK(defined_grad.dim() == 2, c, ": expected 2-D gradients, got ", defined_grad.sizes());
+  const auto exp_size = defined_grad.sizes();
+  TORCH_CHECK(!grad_hy.defined() || grad_hy.sizes() == exp_size, c, ": bad grad_hy size");
+  TORCH_CHECK(!grad_cy.defined() || grad_cy.sizes() == exp_size, c, ": bad grad_cy size");
+  TORCH_CHECK(cx.sizes() == exp_size && cy.sizes() == exp_size, c, ": bad cx or cy size");
+  TORCH_CHECK(workspace.dim() == 2 && workspace.numel() == exp_size[0] * exp_size[1] * 4,
+              c, ": bad workspace size");
+
+  auto grad_gates = at::empty_like(workspace, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto grad_cx = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  fused_lstm_cell_backward_stub(kCPU, grad_gates, grad_cx,
+      contiguous_if_defined(grad_hy), contiguous_if_defined(grad_cy),
+      cx.contiguous(), cy.contiguous(), workspace.contiguous());
+
+  auto grad_bias = has_bias ? grad_gates.sum(0, /*keepdim=*/false) : at::Tensor{};
+  return std::make_tuple(grad_gates, grad_gates, grad_cx, grad_bias, grad_bias);
+}
+
+static constexpr int64_t GRU_WORKSPACE_MULTIPLIER = 5;
+
+std::tuple<Tensor, Tensor> _thnn_fused_gru_cell_cpu(
+      const Tensor& input_gates, const Tensor& hidden_gates,
+      const Tensor& hx,
+      const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_sizes("_thnn_fused_gru_cell_cpu",
+             {input_gates, "input_gates", 1}, {hidden_gates, "hidden_gates", 2},
+             {input_bias, "input_bias", 3}, {hidden_bias, "hidden_bias", 4},
+             /*factor=*/3, {hx, "prev_hidden", 5});
+
+  auto workspace = at::empty({hx.size(0), hx.size(1) * GRU_WORKSPACE_MULTIPLIER}, hx.options());
+  auto hy = at::empty_like(hx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  fused_gru_cell_stub(kCPU, hy, workspace,
+      input_gates.contiguous(), hidden_gates.contiguous(),
+      contiguous_if_defined(input_bias), contiguous_if_defined(hidden_bias),
+      hx.contiguous());
+  return std::make_tuple(hy, workspace);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_gru_cell_backward_cpu(
+      const Tensor& grad_hy, const Tensor& workspace, bool has_bias) {
+  CheckedFrom c = "_thnn_fused_gru_cell_backward_cpu";
+  TORCH_CHECK(grad_hy.dim() == 2, c, ": expected a 2-D grad_hy, got ", grad_hy.sizes());
+  TORCH_CHECK(workspace.sizes() == IntArrayRef({grad_hy.size(0), grad_hy.size(1) * GRU_WORKSPACE_MULTIPLIER}),
+              c, ": bad workspace size");
+
+  int64_t hidden_size = workspace.size(1) / GRU_WORKSPACE_MULTIPLIER;
+  auto grad_input_gates = at::empty({workspace.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hidden_gates = at::empty({workspace.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hx = at::empty_like(grad_hy, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  fused_gru_cell_backward_stub(kCPU, grad_input_gates, grad_hidden_gates, grad_hx,
+      grad_hy.contiguous(), workspace.contiguous());
+
+  at::Tensor grad_input_bias, grad_hidden_bias;
+  if (has_bias) {
+    grad_input_bias = grad_input_gates.sum(0, /*keepdim=*/false);
+    grad_hidden_bias = grad_hidden_gates.sum(0, /*keepdim=*/false);
+  }
+
+  return std::make_tuple(grad_input_gates, grad_hidden_gates, grad_hx, grad_input_bias, grad_hidden_bias);
+}
+
 Tensor gru_cell(
     const Tensor& input, const Tensor& hx,
     const Tensor& w_ih, const Tensor& w_hh, const Tensor& b_ih, const Tensor& b_hh) {
@@ -27,6 +27,26 @@ DECLARE_DISPATCH(rnn_packed_fn, rnn_tanh_packed_miopen_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_miopen_stub);
 
+// Pointwise part of the fused LSTM and GRU cells, with the workspace layout
+// of the CUDA kernels: the activated gates for LSTM, and for GRU the
+// r, i, n gates, hx and the hidden part of n.
+using fused_lstm_cell_fn = void(*)(Tensor& hy, Tensor& cy, Tensor& workspace,
+    const Tensor& input_gates, const Tensor& hidden_gates,
+    const Tensor& input_bias, const Tensor& hidden_bias, const Tensor& cx);
+using fused_lstm_cell_backward_fn = void(*)(Tensor& grad_gates, Tensor& grad_cx,
+    const Tensor& grad_hy, const Tensor& grad_cy,
+    const Tensor& cx, const Tensor& cy, const Tensor& workspace);
+using fused_gru_cell_fn = void(*)(Tensor& hy, Tensor& workspace,
+    const Tensor& input_gates, const Tensor& hidden_gates,
+    const Tensor& input_bias, const Tensor& hidden_bias, const Tensor& hx);
+using fused_gru_cell_backward_fn = void(*)(Tensor& grad_input_gates, Tensor& grad_hidden_gates,
+    Tensor& grad_hx, const Tensor& grad_hy, const Tensor& workspace);
+
+DECLARE_DISPATCH(fused_lstm_cell_fn, fused_lstm_cell_stub);
+DECLARE_DISPATCH(fused_lstm_cell_backward_fn, fused_lstm_cell_backward_stub);
+DECLARE_DISPATCH(fused_gru_cell_fn, fused_gru_cell_stub);
+DECLARE_DISPATCH(fused_gru_cell_backward_fn, fused_gru_cell_backward_stub);
+
 inline void check_device(const Tensor& input, const TensorList& params, const TensorList& hiddens) {
   auto input_device = input.device();
 
@@ -33,6 +33,7 @@ DEFINE_DISPATCH(and_stub);
 DEFINE_DISPATCH(or_stub);
 DEFINE_DISPATCH(min_values_stub);
 DEFINE_DISPATCH(max_values_stub);
+DEFINE_DISPATCH(aminmax_stub);
 DEFINE_DISPATCH(argmax_stub);
 DEFINE_DISPATCH(argmin_stub);
 DEFINE_DISPATCH(cumsum_stub);
@@ -619,6 +620,24 @@ Tensor max_values(const Tensor& self, IntArrayRef dims, bool keepdim) {
   }
 }
 
+std::tuple<Tensor, Tensor> aminmax(const Tensor& self, c10::optional<int64_t> dim, bool keepdim) {
+  std::vector<int64_t> dims;
+  if (dim.has_value()) {
+    dims.push_back(maybe_wrap_dim(dim.value(), self.dim()));
+  }
+  if (self.device().type() != DeviceType::CPU) {
+    return std::make_tuple(at::min_values(self, dims, keepdim), at::max_values(self, dims, keepdim));
+  }
+  // one pass over the input for both results; see
+  // Note [Vectorized reduce_contiguous]
+  Tensor min = at::empty({0}, self.options());
+  Tensor max = at::empty({0}, self.options());
+  auto iter = make_reduction("aminmax", min, max, self, dims, keepdim, self.scalar_type());
+  TORCH_CHECK(iter.numel() > 0, "aminmax(): cannot compute aminmax over an empty dimension");
+  aminmax_stub(iter.device_type(), iter);
+  return std::make_tuple(min, max);
+}
+
 Tensor min_values(const Tensor& self, DimnameList dims, bool keepdim) {
   TORCH_CHECK(false, "NYI: min_values with names");
   return at::min_values(self, dimnames_to_positions(self, dims), keepdim);
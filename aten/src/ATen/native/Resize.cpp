@@ -79,6 +79,18 @@ Tensor& resize_(
   return self;
 }
 
+Tensor& append_cpu_(Tensor& self, const Tensor& other) {
+  const DimVector size = append_size(self, other);
+  const int64_t old_rows = self.size(0);
+  // other may be self or a view of it, whose sizes or data the resize changes.
+  const Tensor source = other.is_alias_of(self) ? other.clone() : other;
+  auto* self_ = self.unsafeGetTensorImpl();
+  maybe_grow_storage_cpu(self_, prod_intlist(size));
+  resize_impl_cpu_(self_, size, /*strides=*/c10::nullopt);
+  self.narrow(0, old_rows, size[0] - old_rows).copy_(source);
+  return self;
+}
+
 TORCH_LIBRARY_IMPL(aten, CPU, m) {
   m.impl_UNBOXED("resize_", resize_);
 }
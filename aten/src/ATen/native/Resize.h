@@ -29,6 +29,23 @@ static inline void maybe_resize_storage_cpu(TensorImpl* self, int64_t new_size)
   }
 }
 
+// Like maybe_resize_storage_cpu, but a storage that has to grow at least
+// doubles, so that growing a tensor a few elements at a time, as append_
+// does, reallocates and copies them O(log n) times instead of every time.
+// The storage keeps the extra bytes as capacity for the next resizes.
+static inline void maybe_grow_storage_cpu(TensorImpl* self, int64_t new_size) {
+  if (new_size > 0 && THTensor_getStoragePtr(self)) {
+    const int64_t capacity =
+        static_cast<int64_t>(self->storage().nbytes()) /
+            self->dtype().itemsize() -
+        self->storage_offset();
+    if (new_size > capacity) {
+      new_size = std::max(new_size, 2 * capacity);
+    }
+  }
+  maybe_resize_storage_cpu(self, new_size);
+}
+
 inline TensorImpl* resize_impl_cpu_(
     TensorImpl* self,
     IntArrayRef size,
@@ -27,4 +27,24 @@ inline Tensor& resize_named_tensor_(
       optional_memory_format.value());
   return self;
 }
+
+// The sizes of self after append_(other), which appends other to self along
+// the first dimension. other is either one slice of self along it, or several.
+inline DimVector append_size(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(!self.has_names(), "append_: named tensors are not supported");
+  TORCH_CHECK(self.dim() > 0, "append_: expected a tensor with dimensions");
+  TORCH_CHECK(
+      self.is_contiguous(), "append_: expected a contiguous tensor");
+  const bool one_slice = other.dim() == self.dim() - 1;
+  TORCH_CHECK(
+      (one_slice || other.dim() == self.dim()) &&
+          other.sizes().slice(one_slice ? 0 : 1) == self.sizes().slice(1),
+      "append_: cannot append a tensor of size ",
+      other.sizes(),
+      " to a tensor of size ",
+      self.sizes());
+  DimVector size(self.sizes().begin(), self.sizes().end());
+  size[0] += one_slice ? 1 : other.size(0);
+  return size;
+}
 }}
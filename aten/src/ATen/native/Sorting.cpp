@@ -1,13 +1,17 @@
 #include <ATen/native/Sorting.h>
 
 #include <ATen/ATen.h>
+#include <ATen/LegacyTHFunctionsCPU.h>
 #include <ATen/NumericUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/WrapDimUtils.h>
+#include <ATen/native/ParallelSort.h>
 #include <ATen/native/SortingUtils.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/NamedTensorUtils.h>
 
+#include <numeric>
+
 namespace at {
 namespace native {
 
@@ -183,6 +187,60 @@ std::tuple<Tensor, Tensor> kthvalue(
   return std::make_tuple(values, indices);
 }
 
+// Slices of at least kParallelSortMinSize elements are sorted with all
+// threads, smaller ones keep the TH quicksort. See Note [Parallel sort]
+std::tuple<Tensor&, Tensor&> sort_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  const ScalarType dtype = self.scalar_type();
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  const int64_t n = self.dim() > 0 ? self.size(dim) : 1;
+  const bool parallel_sortable =
+      isIntegralType(dtype, /*includeBool=*/false) || dtype == kFloat || dtype == kDouble;
+  if (n < kParallelSortMinSize || !parallel_sortable) {
+    return legacy::cpu::_th_sort_out(values, indices, self, dim_, descending);
+  }
+  TORCH_CHECK(
+      values.scalar_type() == dtype,
+      "output values must be of same type as input");
+  TORCH_CHECK(
+      indices.scalar_type() == kLong,
+      "output indices must be of scalar type Long");
+
+  // Sort a contiguous copy with the sorted dim innermost, one slice at a
+  // time, then write both results back through the outputs' strides.
+  Tensor keys = self.transpose(dim, -1).clone(at::MemoryFormat::Contiguous);
+  Tensor keys_indices = at::empty(keys.sizes(), self.options().dtype(kLong));
+  const int64_t nslices = keys.numel() / n;
+  AT_DISPATCH_ALL_TYPES(dtype, "sort_cpu", [&] {
+    scalar_t* keys_data = keys.data_ptr<scalar_t>();
+    int64_t* indices_data = keys_indices.data_ptr<int64_t>();
+    for (int64_t s = 0; s < nslices; s++) {
+      std::iota(indices_data + s * n, indices_data + (s + 1) * n, 0);
+      parallel_sort_with_indices(
+          keys_data + s * n, indices_data + s * n, n, descending);
+    }
+  });
+  values.resize_(self.sizes());
+  indices.resize_(self.sizes());
+  values.transpose(dim, -1).copy_(keys);
+  indices.transpose(dim, -1).copy_(keys_indices);
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> sort_cpu(
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  sort_out_cpu(values, indices, self, dim, descending);
+  return std::make_tuple(values, indices);
+}
+
 std::tuple<Tensor&, Tensor&> topk_out_cpu(
     Tensor& values,
     Tensor& indices,
@@ -5,41 +5,69 @@
 namespace at {
 namespace native {
 
-template <typename Fn>
-void dim_apply(TensorList tensors, int64_t dim, Fn f) {
-  AT_ASSERT(tensors.size() > 0);
-  auto t = tensors[0];
-  auto sizes = t.sizes();
-  int64_t ndim = t.dim();
+// Selects slice it of every tensor, i.e. the 1-d view along dim that
+// dim_apply hands to the it-th call of its function
+inline void dim_select_slice(
+    TensorList tensors,
+    int64_t dim,
+    int64_t it,
+    std::vector<Tensor>& narrowed_tensors) {
+  auto sizes = tensors[0].sizes();
+  int64_t ndim = tensors[0].dim();
+  narrowed_tensors.clear();
+  for (auto ti : tensors) {
+    int64_t i = it;
+    Tensor nt = ti;
+    for (int64_t d = 0; d < ndim; d++) {
+      if (d != dim) {
+        // this could be avoided for slower-changing dimensions if done
+        // better
+        nt = nt.select((d > dim ? 1 : 0), i % sizes[d]);
+        i = i / sizes[d];
+      }
+    }
+    narrowed_tensors.emplace_back(nt);
+  }
+}
+
+inline int64_t dim_apply_size(const Tensor& t, int64_t dim) {
   int64_t itersize = 1;
-  for (int64_t i = 0; i < ndim; i++) {
+  for (int64_t i = 0; i < t.dim(); i++) {
     if (i != dim) {
       itersize *= t.size(i);
     }
   }
+  return itersize;
+}
+
+template <typename Fn>
+void dim_apply(TensorList tensors, int64_t dim, Fn f) {
+  AT_ASSERT(tensors.size() > 0);
+  int64_t itersize = dim_apply_size(tensors[0], dim);
   parallel_for(0, itersize, 1, [&](int64_t i_begin, int64_t i_end) {
     std::vector<Tensor> narrowed_tensors;
     narrowed_tensors.reserve(tensors.size());
     for (int64_t it = i_begin; it < i_end; it++) {
-      narrowed_tensors.clear();
-      for (auto ti : tensors) {
-        int64_t i = it;
-        Tensor nt = ti;
-        for (int64_t d = 0; d < ndim; d++) {
-          if (d != dim) {
-            // this could be avoided for slower-changing dimensions if done
-            // better
-            nt = nt.select((d > dim ? 1 : 0), i % sizes[d]);
-            i = i / sizes[d];
-          }
-        }
-        narrowed_tensors.emplace_back(nt);
-      }
+      dim_select_slice(tensors, dim, it, narrowed_tensors);
       f(it, narrowed_tensors);
     }
   });
 }
 
+// Like dim_apply, but calls f on one slice at a time, for functions that
+// parallelize within the slice
+template <typename Fn>
+void dim_apply_sequential(TensorList tensors, int64_t dim, Fn f) {
+  AT_ASSERT(tensors.size() > 0);
+  int64_t itersize = dim_apply_size(tensors[0], dim);
+  std::vector<Tensor> narrowed_tensors;
+  narrowed_tensors.reserve(tensors.size());
+  for (int64_t it = 0; it < itersize; it++) {
+    dim_select_slice(tensors, dim, it, narrowed_tensors);
+    f(it, narrowed_tensors);
+  }
+}
+
 // ensure we get good values and indices for kthvalue, mode, median
 // this will always be with the reducing dim as 1-d
 inline void _reduction_with_indices_allocate_or_resize_output(
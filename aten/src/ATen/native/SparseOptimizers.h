@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Row updates of the fused sparse optimizer steps. `values` holds the nnz
+// gradient rows as given, possibly with duplicate rows. The gradient rows of
+// the i-th distinct parameter row `rows[i]` are
+// values[order[row_offsets[i]]], ..., values[order[row_offsets[i + 1] - 1]],
+// and they are summed before the update.
+using sparse_adagrad_fn = void(*)(Tensor& param, Tensor& state_sum,
+    const Tensor& values, const Tensor& rows, const Tensor& order,
+    const Tensor& row_offsets, double lr, double eps);
+using sparse_adam_fn = void(*)(Tensor& param, Tensor& exp_avg, Tensor& exp_avg_sq,
+    const Tensor& values, const Tensor& rows, const Tensor& order,
+    const Tensor& row_offsets, double step_size, double beta1, double beta2, double eps);
+
+DECLARE_DISPATCH(sparse_adagrad_fn, sparse_adagrad_stub);
+DECLARE_DISPATCH(sparse_adagrad_fn, rowwise_adagrad_stub);
+DECLARE_DISPATCH(sparse_adam_fn, sparse_adam_stub);
+
+}} // namespace at::native
@@ -10,6 +10,7 @@
 #include <ATen/Config.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/detail/CUDAHooksInterface.h>
+#include <ATen/native/CPUFFTPlanCache.h>
 #include <ATen/native/SpectralOpsUtils.h>
 
 #include <algorithm>
@@ -133,19 +134,37 @@ static inline Tensor _fft(const Tensor &self, const int64_t signal_ndim,
 // We call the following methods via CUDA hooks because they are really only
 // valid when CUDA is available. See native/cuda/CuFFTPlanCache.h for more details.
 int64_t _cufft_get_plan_cache_max_size(int64_t device_index) {
-  return detail::getCUDAHooks().cuFFTGetPlanCacheMaxSize(device_index);
+  return at::detail::getCUDAHooks().cuFFTGetPlanCacheMaxSize(device_index);
 }
 
 void _cufft_set_plan_cache_max_size(int64_t device_index, int64_t max_size) {
-  detail::getCUDAHooks().cuFFTSetPlanCacheMaxSize(device_index, max_size);
+  at::detail::getCUDAHooks().cuFFTSetPlanCacheMaxSize(device_index, max_size);
 }
 
 int64_t _cufft_get_plan_cache_size(int64_t device_index) {
-  return detail::getCUDAHooks().cuFFTGetPlanCacheSize(device_index);
+  return at::detail::getCUDAHooks().cuFFTGetPlanCacheSize(device_index);
 }
 
 void _cufft_clear_plan_cache(int64_t device_index) {
-  detail::getCUDAHooks().cuFFTClearPlanCache(device_index);
+  at::detail::getCUDAHooks().cuFFTClearPlanCache(device_index);
+}
+
+// The CPU FFT plan cache belongs to whichever backend _fft_mkl uses, see
+// native/CPUFFTPlanCache.h
+int64_t _cpu_fft_get_plan_cache_max_size() {
+  return detail::cpu_fft_get_plan_cache_max_size_impl();
+}
+
+void _cpu_fft_set_plan_cache_max_size(int64_t max_size) {
+  detail::cpu_fft_set_plan_cache_max_size_impl(max_size);
+}
+
+int64_t _cpu_fft_get_plan_cache_size() {
+  return detail::cpu_fft_get_plan_cache_size_impl();
+}
+
+void _cpu_fft_clear_plan_cache() {
+  detail::cpu_fft_clear_plan_cache_impl();
 }
 
 Tensor fft(const Tensor& self, const int64_t signal_ndim, const bool normalized) {
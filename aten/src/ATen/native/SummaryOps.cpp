@@ -2,14 +2,54 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 
 #include <tuple>
 
 namespace at { namespace native {
 
-///////////////// bincount /////////////////
 namespace {
 
+// Accumulates the histogram of n elements into the zeroed, nbins long out.
+// add(hist, begin, end) adds elements [begin, end) to hist. Large inputs are
+// split in as many chunks as there are threads, and each chunk is counted
+// into a private histogram of its own, so the threads never write to the
+// same bins; the private histograms are summed in chunk order at the end.
+// When the histogram is large compared to the input, the merge would cost
+// more than the counting saves, and the input is counted serially instead.
+template <typename hist_t, typename Add>
+void histogram_cpu(hist_t* out, int64_t nbins, int64_t n, const Add& add) {
+  const int64_t num_chunks = std::min<int64_t>(
+      at::get_num_threads(), divup(n, at::internal::GRAIN_SIZE));
+  if (num_chunks <= 1 || nbins * num_chunks > n) {
+    add(out, 0, n);
+    return;
+  }
+
+  std::vector<hist_t> partial(num_chunks * nbins, 0);
+  const int64_t chunk_size = divup(n, num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      add(partial.data() + c * nbins,
+          c * chunk_size,
+          std::min(n, (c + 1) * chunk_size));
+    }
+  });
+  const int64_t merge_grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / num_chunks);
+  at::parallel_for(0, nbins, merge_grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      hist_t sum = 0;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        sum += partial[c * nbins + b];
+      }
+      out[b] = sum;
+    }
+  });
+}
+
+///////////////// bincount /////////////////
+
 template <typename input_t, typename weights_t>
 Tensor _bincount_cpu_template(
     const Tensor& self,
@@ -38,20 +78,81 @@ Tensor _bincount_cpu_template(
   const input_t* self_p = self.data_ptr<input_t>();
   if (has_weights) {
     output = native::zeros({nbins}, weights.options());
-    weights_t* output_p = output.data_ptr<weights_t>();
     const weights_t* weights_p = weights.data_ptr<weights_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += weights_p[i];
-    }
+    histogram_cpu(
+        output.data_ptr<weights_t>(),
+        nbins,
+        self_size,
+        [&](weights_t* hist, int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            hist[self_p[i]] += weights_p[i];
+          }
+        });
   } else {
     output = native::zeros({nbins}, kLong);
-    int64_t* output_p = output.data_ptr<int64_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += 1L;
-    }
+    histogram_cpu(
+        output.data_ptr<int64_t>(),
+        nbins,
+        self_size,
+        [&](int64_t* hist, int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            hist[self_p[i]] += 1L;
+          }
+        });
   }
   return output;
 }
+
+///////////////// histc /////////////////
+template <typename input_t>
+void _histc_cpu_template(
+    Tensor& result,
+    const Tensor& self,
+    int64_t nbins,
+    input_t min,
+    input_t max) {
+  TORCH_CHECK(nbins > 0, "bins must be > 0");
+  result.resize_({nbins});
+  result.zero_();
+  input_t minvalue = min;
+  input_t maxvalue = max;
+  if (minvalue == maxvalue) {
+    minvalue = self.min().item<input_t>();
+    maxvalue = self.max().item<input_t>();
+  }
+  if (minvalue == maxvalue) {
+    minvalue = minvalue - 1;
+    maxvalue = maxvalue + 1;
+  }
+
+  TORCH_CHECK(
+      !(std::isinf(minvalue) || std::isinf(maxvalue) || std::isnan(minvalue) ||
+        std::isnan(maxvalue)),
+      "range of [",
+      minvalue,
+      ", ",
+      maxvalue,
+      "] is not finite");
+  TORCH_CHECK(minvalue < maxvalue, "max must be larger than min");
+
+  const Tensor input = self.contiguous();
+  const input_t* input_p = input.data_ptr<input_t>();
+  histogram_cpu(
+      result.data_ptr<input_t>(),
+      nbins,
+      input.numel(),
+      [&](input_t* hist, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const input_t value = input_p[i];
+          // The last bin is inclusive at both ends, so maxvalue lands in it.
+          if (value >= minvalue && value <= maxvalue) {
+            const int64_t bin = static_cast<int64_t>(
+                (value - minvalue) / (maxvalue - minvalue) * nbins);
+            hist[std::min(bin, nbins - 1)] += 1;
+          }
+        }
+      });
+}
 } // namespace
 
 Tensor
@@ -65,4 +166,27 @@ _bincount_cpu(const Tensor& self, const Tensor& weights, int64_t minlength) {
   });
 }
 
+Tensor& histc_out_cpu(
+    Tensor& result,
+    const Tensor& self,
+    int64_t bins,
+    Scalar min,
+    Scalar max) {
+  TORCH_CHECK(
+      result.scalar_type() == self.scalar_type(),
+      "histc: expected result of type ", self.scalar_type(),
+      " but got ", result.scalar_type());
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histc_cpu", [&] {
+    _histc_cpu_template<scalar_t>(
+        result, self, bins, min.to<scalar_t>(), max.to<scalar_t>());
+  });
+  return result;
+}
+
+Tensor histc_cpu(const Tensor& self, int64_t bins, Scalar min, Scalar max) {
+  Tensor result = at::empty({0}, self.options());
+  histc_out_cpu(result, self, bins, min, max);
+  return result;
+}
+
 }} // namespace at::native
@@ -464,26 +464,27 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
       }
     };
 
-    // parallel on inner loop in case the slice is large enough;
-    // otherwise parallel on outer loop
-    if (slice_size >= grain_size) {
+    // use a fast loop when self and result are contiguous and of the same
+    // data type: every index copies one row, so copy rows in parallel unless
+    // there are too few of them to keep the threads busy
+    if (iter.is_contiguous() && self.scalar_type() == result.scalar_type() &&
+        (slice_size < grain_size || numel >= at::get_num_threads())) {
+      auto slice_size_bytes = slice_size * elementSize(self.scalar_type());
+      at::parallel_for(0, numel, std::max<int64_t>(1, grain_size / slice_size), [&](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; i++) {
+          auto self_i = index_data[i];
+          TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_dim_size), "index out of range in self");
+          auto self_data = static_cast<char*>(selfSlice_data) + self_i * self_stride_bytes;
+          auto result_data = static_cast<char*>(resultSlice_data) + i * result_stride_bytes;
+          memcpy(result_data, self_data, slice_size_bytes);
+        }
+      });
+    } else if (slice_size >= grain_size) {
+      // parallel on inner loop in case the slice is large enough;
+      // otherwise parallel on outer loop
       outer_loop(0, numel);
     } else {
-      // use a fast loop when self and result are contiguous and of the same data type
-      if (iter.is_contiguous() && self.scalar_type() == result.scalar_type()) {
-        auto slice_size_bytes = slice_size * elementSize(self.scalar_type());
-        at::parallel_for(0, numel, grain_size / slice_size, [&](int64_t start, int64_t end) {
-          for (int64_t i = start; i < end; i++) {
-            auto self_i = index_data[i];
-            TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_dim_size), "index out of range in self");
-            auto self_data = static_cast<char*>(selfSlice_data) + self_i * self_stride_bytes;
-            auto result_data = static_cast<char*>(resultSlice_data) + i * result_stride_bytes;
-            memcpy(result_data, self_data, slice_size_bytes);
-          }
-        });
-      } else {
-        at::parallel_for(0, numel, grain_size / slice_size, outer_loop);
-      }
+      at::parallel_for(0, numel, grain_size / slice_size, outer_loop);
     }
   } else {
     TORCH_CHECK(result.dim() <= 1, "result.dim() (", result.dim(), ") must one or zero for given self.dim() (", self.dim(), ")");
@@ -603,6 +604,27 @@ Tensor scatter(const Tensor & self, int64_t dim, const Tensor & index, Scalar so
 Tensor & scatter_add_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
   TORCH_CHECK_INDEX(index.scalar_type() == ScalarType::Long,
                     "scatter_(): Expected dtype int64 for index.");
+  if (globalContext().deterministic() && self.device().type() == DeviceType::CUDA &&
+      self.dim() > 0 && index.dim() == self.dim() && src.dim() == self.dim()) {
+    // The CUDA kernel adds with atomics, in no particular order. For
+    // dim == 0, self[index[i][j][k]][j][k] += src[i][j][k] is also index_put_
+    // with the indices (index, j, k) broadcast to the shape of index, and
+    // that accumulates deterministically.
+    dim = maybe_wrap_dim(dim, self.dim());
+    std::vector<Tensor> indices;
+    Tensor src_ = src;
+    for (int64_t d = 0; d < self.dim(); d++) {
+      if (d == dim) {
+        indices.push_back(index);
+      } else {
+        std::vector<int64_t> shape(self.dim(), 1);
+        shape[d] = index.size(d);
+        indices.push_back(at::arange(index.size(d), index.options()).view(shape));
+      }
+      src_ = src_.narrow(d, 0, index.size(d));
+    }
+    return self.index_put_(indices, src_, /*accumulate=*/true);
+  }
   scatter_add_stub(self.device().type(), self, dim, index, src);
   return self;
 }
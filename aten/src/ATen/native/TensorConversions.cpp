@@ -2,6 +2,9 @@
 #include <ATen/NativeFunctions.h>
 #include <c10/util/Optional.h>
 
+#include <ATen/detail/CUDAHooksInterface.h>
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
 #include <c10/core/impl/DeviceGuardImplInterface.h>
 
 namespace at {
@@ -19,6 +22,64 @@ static inline Device ensure_has_index(Device device) {
   return impl->getDevice();
 }
 
+// Allocates the result of to(); a copy of self with the given options.
+static inline Tensor empty_for_to(const Tensor& self, const TensorOptions& options, MemoryFormat memory_format) {
+  if (memory_format == MemoryFormat::Preserve) {
+    if (self.is_non_overlapping_and_dense()) {
+      // Copy all strides
+      return at::empty_strided(self.sizes(), self.strides(), options.memory_format(c10::nullopt));
+    } else {
+      memory_format = self.suggest_memory_format();
+    }
+  }
+  // See Note [Explicit nullopt MemoryFormat argument]
+  return at::empty(self.sizes(), options.memory_format(memory_format), c10::nullopt);
+}
+
+// Note [CUDA copy streams]
+// With at::globalContext().useCUDACopyStreams() set, a non_blocking to() between
+// the CPU and a CUDA device is issued on the device's copy stream (see
+// at::cuda::getCopyStream) rather than on its current stream, so that it can
+// overlap with the kernels already queued on the current stream:
+//  - Host to device copies don't wait for the current stream. The result is
+//    allocated on the copy stream, and recordStream()ed on the current stream,
+//    which makes the caching allocator keep its memory alive for the work
+//    queued on the current stream.
+//  - Device to host copies wait for the work queued on the current stream,
+//    which produces the source, and copy into pinned memory so that they don't
+//    block the host.
+// In both cases, work queued on the current stream afterwards waits for the
+// copy, so the result can be used as with a regular non_blocking copy.
+static inline Tensor to_on_copy_stream(const Tensor& self, TensorOptions options, MemoryFormat memory_format) {
+  const bool to_cuda = options.device().is_cuda();
+  const Device cuda_device = to_cuda ? options.device() : self.device();
+  const auto& hooks = at::detail::getCUDAHooks();
+  const Stream copy_stream = hooks.getCopyStream(cuda_device.index());
+  const Stream current_stream = c10::impl::getDeviceGuardImpl(kCUDA)->getStream(cuda_device);
+
+  if (!to_cuda) {
+    c10::Event source_ready(kCUDA);
+    source_ready.record(current_stream);
+    source_ready.block(copy_stream);
+    options = options.pinned_memory(true);
+  }
+
+  Tensor r;
+  {
+    c10::StreamGuard guard(copy_stream);
+    r = empty_for_to(self, options, memory_format);
+    r.copy_(self, /*non_blocking=*/true);
+  }
+
+  c10::Event copied(kCUDA);
+  copied.record(copy_stream);
+  copied.block(current_stream);
+  if (to_cuda) {
+    hooks.recordStream(r.storage().data_ptr(), current_stream);
+  }
+  return r;
+}
+
 static inline Tensor to_impl(const Tensor& self, const TensorOptions& options, bool non_blocking, bool copy) {
   auto memory_format = options.memory_format_opt().value_or(MemoryFormat::Preserve);
 
@@ -29,18 +90,14 @@ static inline Tensor to_impl(const Tensor& self, const TensorOptions& options, b
     return self;
   }
 
-  if (memory_format == MemoryFormat::Preserve) {
-    if (self.is_non_overlapping_and_dense()) {
-      // Copy all strides
-      auto r = at::empty_strided(self.sizes(), self.strides(), options.memory_format(c10::nullopt));
-      r.copy_(self, non_blocking);
-      return r;
-    } else {
-      memory_format = self.suggest_memory_format();
-    }
+  if (non_blocking && at::globalContext().useCUDACopyStreams() &&
+      self.layout() == kStrided &&
+      ((self.is_cuda() && options.device().is_cpu()) ||
+       (self.device().is_cpu() && options.device().is_cuda()))) {
+    return to_on_copy_stream(self, options, memory_format);
   }
-  // See Note [Explicit nullopt MemoryFormat argument]
-  auto r = at::empty(self.sizes(), options.memory_format(memory_format), c10::nullopt);
+
+  auto r = empty_for_to(self, options, memory_format);
   r.copy_(self, non_blocking);
   return r;
 }
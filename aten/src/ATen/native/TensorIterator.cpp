@@ -1,10 +1,16 @@
 #include <ATen/native/TensorIterator.h>
 
 #include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <ATen/Dispatch.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/native/TypeProperties.h>
 #include <ATen/MemoryOverlap.h>
+#include <c10/util/TypeCast.h>
 
 namespace at {
 
@@ -242,18 +248,24 @@ void TensorIterator::compute_types(const TensorIteratorConfig& config) {
     // TODO: reuse temporaries when possible (e.g. for inplace operations)
     if (common_device == kCPU) {
       // Casts to outputs by creating temporaries of the correct dtype (if needed)
+      // (or leaves it to the loops, see Note [Buffered CPU casts])
       if (config.cast_common_dtype_to_outputs_ && op.is_output && op.current_dtype != common_dtype_) {
-        op.original_tensor = op.tensor;
-        op.tensor = at::empty_like(op.tensor,
-                                   op.tensor.options().dtype(common_dtype_),
-                                   LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+        if (!config.buffer_cpu_casts_) {
+          op.original_tensor = op.tensor;
+          op.tensor = at::empty_like(op.tensor,
+                                     op.tensor.options().dtype(common_dtype_),
+                                     LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+        }
         op.current_dtype = common_dtype_;
     }
 
-    // Promotes inputs by creating temporaries of the correct dtype
+    // Promotes inputs by creating temporaries of the correct dtype (or
+    // leaves it to the loops)
       if (config.promote_inputs_to_common_dtype_ && !op.is_output && op.current_dtype != common_dtype_) {
-        op.original_tensor = op.tensor;
-        op.tensor = op.tensor.to(common_dtype_);
+        if (!config.buffer_cpu_casts_) {
+          op.original_tensor = op.tensor;
+          op.tensor = op.tensor.to(common_dtype_);
+        }
         op.current_dtype = common_dtype_;
       }
     }
@@ -576,6 +588,56 @@ void TensorIterator::serial_for_each(loop_t loop, Range range) const {
   serial_for_each(LOOP_WRAPPER(ntensors(), loop), range);
 }
 
+// Note [Buffered CPU casts]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// On the CPU, the kernels only ever see operands in the common dtype. By
+// default, promote_inputs_to_common_dtype and cast_common_dtype_to_outputs
+// get there by converting whole inputs into temporaries up front, and whole
+// temporaries into the outputs at the end, so float_tensor + int_tensor
+// allocates, writes and reads back an extra tensor, and builds that make
+// temporaries are not recorded in the plan cache.
+//
+// With buffer_cpu_casts, the operands keep their tensors, with just
+// current_dtype set to the common dtype and buffered_dtype to the dtype of
+// the tensor. serial_for_each then runs the loop on chunks of at most
+// kBufferedCastSize elements, first converting the chunk of each such input
+// into a contiguous buffer in the common dtype (a single element for
+// broadcast inputs, which keep their zero stride), and afterwards the chunks
+// of such outputs back from theirs. The conversions are compiled for every
+// pair of dtypes with a separate loop for contiguous data that the compiler
+// vectorizes, so the kernels' loops stay vectorized and the data is converted
+// while it is in cache.
+//
+// The operands' data is not in their dtype(), so kernels must not read it
+// other than through for_each() / serial_for_each(), and
+// has_contiguous_first_dim() (and so is_contiguous()) is false for such
+// iterators to keep kernels off their direct data paths.
+
+static constexpr int64_t kBufferedCastSize = 256;
+
+static void buffered_cast(ScalarType src_dtype, const char* src, int64_t src_stride,
+                          ScalarType dst_dtype, char* dst, int64_t dst_stride, int64_t n) {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kHalf, kBool, kBFloat16, dst_dtype, "buffered_cast", [&] {
+    using dst_t = scalar_t;
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kHalf, kBool, kBFloat16, src_dtype, "buffered_cast", [&] {
+      if (src_stride == sizeof(scalar_t) && dst_stride == sizeof(dst_t)) {
+        // Separate so that the compiler vectorizes it
+        auto src_data = reinterpret_cast<const scalar_t*>(src);
+        auto dst_data = reinterpret_cast<dst_t*>(dst);
+        for (int64_t i = 0; i < n; i++) {
+          dst_data[i] = c10::static_cast_with_inter_type<dst_t, scalar_t>::apply(src_data[i]);
+        }
+      } else {
+        for (int64_t i = 0; i < n; i++) {
+          *reinterpret_cast<dst_t*>(dst + i * dst_stride) =
+              c10::static_cast_with_inter_type<dst_t, scalar_t>::apply(
+                  *reinterpret_cast<const scalar_t*>(src + i * src_stride));
+        }
+      }
+    });
+  });
+}
+
 void TensorIterator::serial_for_each(loop2d_t loop, Range range) const {
   if (range.size() == 0) {
     return;
@@ -585,6 +647,56 @@ void TensorIterator::serial_for_each(loop2d_t loop, Range range) const {
     strides.push_back(0);
   }
 
+  // See Note [Buffered CPU casts]
+  // loop is a function_ref: buffered_loop calls a copy of it, since loop is
+  // repointed at buffered_loop below.
+  const loop2d_t kernel = loop;
+  std::vector<char> buffers;
+  auto buffered_loop = [&](char** base, const int64_t* base_strides, int64_t size0, int64_t size1) {
+    const int ntensor = ntensors();
+    if (buffers.empty()) {
+      buffers.resize(ntensor * kBufferedCastSize * sizeof(c10::complex<double>));
+    }
+    PtrVector data(ntensor, nullptr);
+    PtrVector ptrs(ntensor, nullptr);
+    StrideVector chunk_strides(base_strides, base_strides + ntensor);
+    for (int arg = 0; arg < ntensor; arg++) {
+      if (operands_[arg].buffered_dtype != ScalarType::Undefined) {
+        chunk_strides[arg] = base_strides[arg] == 0 ? 0 : element_size(arg);
+      }
+    }
+    for (int64_t i = 0; i < size1; i++) {
+      for (int64_t begin = 0; begin < size0; begin += kBufferedCastSize) {
+        const int64_t n = std::min(kBufferedCastSize, size0 - begin);
+        for (int arg = 0; arg < ntensor; arg++) {
+          const auto& op = operands_[arg];
+          ptrs[arg] = base[arg] + i * base_strides[ntensor + arg] + begin * base_strides[arg];
+          if (op.buffered_dtype == ScalarType::Undefined) {
+            data[arg] = ptrs[arg];
+            continue;
+          }
+          data[arg] = &buffers[arg * kBufferedCastSize * sizeof(c10::complex<double>)];
+          if (!op.is_output || op.is_read_write) {
+            buffered_cast(op.buffered_dtype, ptrs[arg], base_strides[arg],
+                          op.current_dtype, data[arg], chunk_strides[arg],
+                          base_strides[arg] == 0 ? 1 : n);
+          }
+        }
+        kernel(data.data(), chunk_strides.data(), n, 1);
+        for (int arg = 0; arg < num_outputs_; arg++) {
+          const auto& op = operands_[arg];
+          if (op.buffered_dtype != ScalarType::Undefined) {
+            buffered_cast(op.current_dtype, data[arg], chunk_strides[arg],
+                          op.buffered_dtype, ptrs[arg], base_strides[arg], n);
+          }
+        }
+      }
+    }
+  };
+  if (has_buffered_casts_) {
+    loop = buffered_loop;
+  }
+
   auto base_ptrs = get_base_ptrs();
   if (ndim() <= 1) {
     auto ptrs = get_data_ptrs(base_ptrs, { range.begin });
@@ -685,6 +797,7 @@ TensorIterator TensorIterator::binary_op(Tensor& out, const Tensor& a,
      .promote_inputs_to_common_dtype(true)
      .cast_common_dtype_to_outputs(true)
      .enforce_safe_casting_to_output(true)
+     .buffer_cpu_casts(true)
      .build();
 }
 
@@ -697,6 +810,7 @@ TensorIterator TensorIterator::comparison_op(Tensor& out, const Tensor& a,
     .add_input(b)
     .allow_cpu_scalars(true)
     .promote_inputs_to_common_dtype(true)
+    .buffer_cpu_casts(true)
     .build();
 }
 
@@ -845,6 +959,7 @@ void TensorIterator::resize_outputs(const TensorIteratorConfig& config) {
         // Preserve legacy resizing behavior of out=... arguments
         // TODO: issue warning
         tensor.resize_(shape_);
+        has_resized_outputs_ = true;
         if (tensor.dim() == 4 && requires_channels_last_2d_output()) {
           // Temporary stick to 4d tensor, will update with arbitrary batched later on
           tensor.unsafeGetTensorImpl()->empty_tensor_restride(MemoryFormat::ChannelsLast);
@@ -1122,6 +1237,263 @@ FastSetupType TensorIterator::compute_fast_setup_type(const TensorIteratorConfig
   return FastSetupType::NONE;
 }
 
+// The result of TensorIterator::build() for one PlanKey, see
+// Note [TensorIterator plan cache]
+struct TensorIteratorPlan {
+  struct Operand {
+    StrideVector stride_bytes;
+    Device device = kCPU;
+    ScalarType target_dtype = ScalarType::Undefined;
+    ScalarType current_dtype = ScalarType::Undefined;
+    // Layout of the output tensor, used if the output has to be allocated
+    DimVector sizes;
+    DimVector strides;
+  };
+
+  DimVector shape;
+  DimVector perm;
+  bool has_coalesced_dimensions = false;
+  bool all_ops_same_shape = false;
+  ScalarType common_dtype = ScalarType::Undefined;
+  SmallVector<Operand, 4> operands;
+};
+
+namespace {
+
+using PlanKey = TensorIterator::PlanKey;
+
+// Plans a thread caches before it drops all of them
+constexpr size_t kMaxCachedPlans = 256;
+
+struct PlanKeyHash {
+  size_t operator()(const PlanKey& key) const {
+    size_t hash = key.size();
+    for (int64_t value : key) {
+      hash ^= std::hash<int64_t>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+};
+
+struct PlanCacheCounters {
+  // Only written by the owning thread, atomic so get_stats() can read them.
+  std::atomic<int64_t> hits{0};
+  std::atomic<int64_t> misses{0};
+  std::atomic<int64_t> uncacheable{0};
+};
+
+void bump(std::atomic<int64_t>& counter) {
+  counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+std::atomic<bool> plan_cache_enabled{false};
+
+struct ThreadPlanCache;
+
+// All live per-thread caches, and the counts of threads that have exited.
+struct PlanCacheRegistry {
+  std::mutex mutex;
+  std::unordered_set<ThreadPlanCache*> caches;
+  TensorIteratorPlanCacheStats retired;
+};
+
+PlanCacheRegistry& plan_cache_registry() {
+  // Leaked, thread_local caches may be destroyed after static destructors ran.
+  static PlanCacheRegistry* registry = new PlanCacheRegistry();
+  return *registry;
+}
+
+struct ThreadPlanCache {
+  ThreadPlanCache() {
+    auto& registry = plan_cache_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.caches.insert(this);
+  }
+
+  ~ThreadPlanCache() {
+    auto& registry = plan_cache_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired.hits += counters.hits.load(std::memory_order_relaxed);
+    registry.retired.misses += counters.misses.load(std::memory_order_relaxed);
+    registry.retired.uncacheable += counters.uncacheable.load(std::memory_order_relaxed);
+    registry.caches.erase(this);
+  }
+
+  std::unordered_map<PlanKey, TensorIteratorPlan, PlanKeyHash> plans;
+  PlanCacheCounters counters;
+};
+
+ThreadPlanCache& thread_plan_cache() {
+  static thread_local ThreadPlanCache cache;
+  return cache;
+}
+
+} // namespace
+
+namespace TensorIteratorPlanCache {
+
+void set_enabled(bool enabled) {
+  plan_cache_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool is_enabled() {
+  return plan_cache_enabled.load(std::memory_order_relaxed);
+}
+
+TensorIteratorPlanCacheStats get_stats() {
+  auto& registry = plan_cache_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  TensorIteratorPlanCacheStats stats = registry.retired;
+  for (ThreadPlanCache* cache : registry.caches) {
+    stats.hits += cache->counters.hits.load(std::memory_order_relaxed);
+    stats.misses += cache->counters.misses.load(std::memory_order_relaxed);
+    stats.uncacheable += cache->counters.uncacheable.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void reset_stats() {
+  auto& registry = plan_cache_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.retired = TensorIteratorPlanCacheStats();
+  for (ThreadPlanCache* cache : registry.caches) {
+    cache->counters.hits.store(0, std::memory_order_relaxed);
+    cache->counters.misses.store(0, std::memory_order_relaxed);
+    cache->counters.uncacheable.store(0, std::memory_order_relaxed);
+  }
+}
+
+void clear() {
+  thread_plan_cache().plans.clear();
+}
+
+} // namespace TensorIteratorPlanCache
+
+// Fills in `key` and, if a plan for it is cached, sets up the iterator from
+// it. Leaves `key` empty if the build cannot be cached.
+bool TensorIterator::lookup_plan(const TensorIteratorConfig& config, PlanKey& key) {
+  auto& cache = thread_plan_cache();
+  for (const auto& op : operands_) {
+    if (op.tensor.defined() && op.tensor.has_names()) {
+      bump(cache.counters.uncacheable);
+      return false;
+    }
+  }
+
+  key.push_back(
+      config.check_mem_overlap_ |
+      config.allow_cpu_scalars_ << 1 |
+      config.is_reduction_ << 2 |
+      config.resize_outputs_ << 3 |
+      config.check_all_same_dtype_ << 4 |
+      config.check_all_same_device_ << 5 |
+      config.enforce_safe_casting_to_output_ << 6 |
+      config.promote_inputs_to_common_dtype_ << 7 |
+      config.cast_common_dtype_to_outputs_ << 8 |
+      config.buffer_cpu_casts_ << 9);
+  key.push_back(num_outputs_);
+  if (config.static_dtype_and_device_.has_value()) {
+    const auto& device = config.static_dtype_and_device_->second;
+    key.push_back(static_cast<int64_t>(config.static_dtype_and_device_->first));
+    key.push_back(static_cast<int64_t>(device.type()) << 8 | (device.index() + 1));
+  } else {
+    key.push_back(-1);
+  }
+  if (config.static_shape_.has_value()) {
+    key.push_back(config.static_shape_->size());
+    key.append(config.static_shape_->begin(), config.static_shape_->end());
+  } else {
+    key.push_back(-1);
+  }
+  for (const auto& op : operands_) {
+    if (!op.tensor.defined()) {
+      key.push_back(-1);
+      continue;
+    }
+    // Wrapped numbers take part in type promotion differently (see
+    // update_result_type_state), and outputs that are also inputs are never
+    // resized.
+    const auto& device = op.device;
+    key.push_back(
+        static_cast<int64_t>(op.current_dtype) |
+        static_cast<int64_t>(device.type()) << 8 |
+        static_cast<int64_t>(device.index() + 1) << 16 |
+        static_cast<int64_t>(op.tensor.unsafeGetTensorImpl()->is_wrapped_number()) << 24 |
+        static_cast<int64_t>(op.is_read_write) << 25);
+    auto sizes = op.tensor.sizes();
+    auto strides = op.tensor.strides();
+    key.push_back(sizes.size());
+    key.append(sizes.begin(), sizes.end());
+    key.append(strides.begin(), strides.end());
+  }
+
+  auto it = cache.plans.find(key);
+  if (it == cache.plans.end()) {
+    return false;
+  }
+  const TensorIteratorPlan& plan = it->second;
+  shape_ = plan.shape;
+  perm_ = plan.perm;
+  has_coalesced_dimensions_ = plan.has_coalesced_dimensions;
+  all_ops_same_shape_ = plan.all_ops_same_shape;
+  common_dtype_ = plan.common_dtype;
+  for (int i = 0; i < ntensors(); i++) {
+    auto& op = operands_[i];
+    const auto& cached = plan.operands[i];
+    op.stride_bytes = cached.stride_bytes;
+    op.device = cached.device;
+    op.target_dtype = cached.target_dtype;
+    op.current_dtype = cached.current_dtype;
+    if (!op.tensor.defined()) {
+      op.tensor = at::empty_strided(cached.sizes, cached.strides, op.options());
+    }
+  }
+  bump(cache.counters.hits);
+  return true;
+}
+
+// Caches the result of a build for `key`, computed by lookup_plan().
+void TensorIterator::record_plan(PlanKey&& key) {
+  if (key.empty()) {
+    return;
+  }
+  auto& cache = thread_plan_cache();
+  bool cacheable = !has_resized_outputs_;
+  for (const auto& op : operands_) {
+    cacheable &= !op.original_tensor.defined();
+  }
+  if (!cacheable) {
+    bump(cache.counters.uncacheable);
+    return;
+  }
+
+  TensorIteratorPlan plan;
+  plan.shape = shape_;
+  plan.perm = perm_;
+  plan.has_coalesced_dimensions = has_coalesced_dimensions_;
+  plan.all_ops_same_shape = all_ops_same_shape_;
+  plan.common_dtype = common_dtype_;
+  for (int i = 0; i < ntensors(); i++) {
+    const auto& op = operands_[i];
+    TensorIteratorPlan::Operand cached;
+    cached.stride_bytes = op.stride_bytes;
+    cached.device = op.device;
+    cached.target_dtype = op.target_dtype;
+    cached.current_dtype = op.current_dtype;
+    if (op.is_output) {
+      cached.sizes = DimVector(op.tensor.sizes());
+      cached.strides = DimVector(op.tensor.strides());
+    }
+    plan.operands.push_back(std::move(cached));
+  }
+
+  if (cache.plans.size() >= kMaxCachedPlans) {
+    cache.plans.clear();
+  }
+  cache.plans.emplace(std::move(key), std::move(plan));
+  bump(cache.counters.misses);
+}
+
 TensorIterator::TensorIterator(TensorIteratorConfig& config) {
   build(config);
 }
@@ -1137,24 +1509,33 @@ void TensorIterator::build(TensorIteratorConfig& config) {
   // Check that the outputs have no internal overlap
   // and do not share memory with inputs.
   compute_mem_overlaps(config);
-  // Check that input dimensions are aligned correctly & compute outnames.
-  compute_names(config);
-  // compute the broadcasted shape
-  compute_shape(config);
-  // resize outputs if necessary
-  resize_outputs(config);
-  // compute the result dtype and device
-  compute_types(config);
-  // try fast setup output tensor, if failed, fallback to normal setup
-  if (!fast_set_up(config)) {
-    // compute each tensor's stride after broadcasting
-    compute_strides(config);
-    // re-order dimensions to improve coalescing
-    reorder_dimensions(config);
-    // allocate the output tensor if it's not provided
-    allocate_outputs();
-    // coalesce adjacent dimensions when possible
-    coalesce_dimensions();
+  // reuse the shape, dtype and stride computation of an earlier build with
+  // the same operand layouts, see Note [TensorIterator plan cache]
+  const bool use_plan_cache = TensorIteratorPlanCache::is_enabled();
+  PlanKey plan_key;
+  if (!use_plan_cache || !lookup_plan(config, plan_key)) {
+    // Check that input dimensions are aligned correctly & compute outnames.
+    compute_names(config);
+    // compute the broadcasted shape
+    compute_shape(config);
+    // resize outputs if necessary
+    resize_outputs(config);
+    // compute the result dtype and device
+    compute_types(config);
+    // try fast setup output tensor, if failed, fallback to normal setup
+    if (!fast_set_up(config)) {
+      // compute each tensor's stride after broadcasting
+      compute_strides(config);
+      // re-order dimensions to improve coalescing
+      reorder_dimensions(config);
+      // allocate the output tensor if it's not provided
+      allocate_outputs();
+      // coalesce adjacent dimensions when possible
+      coalesce_dimensions();
+    }
+    if (use_plan_cache) {
+      record_plan(std::move(plan_key));
+    }
   }
   // perform name inference
   propagate_names_to_outputs();
@@ -1163,6 +1544,7 @@ void TensorIterator::build(TensorIteratorConfig& config) {
     TORCH_INTERNAL_ASSERT(op.tensor.defined());
     op.data = op.tensor.data_ptr();
   }
+  mark_buffered_casts(config);
 
   // zero out offsets
   // If the tensor is a scalar, we leave room for it
@@ -1172,6 +1554,19 @@ void TensorIterator::build(TensorIteratorConfig& config) {
   view_offsets_ = DimVector(ndim_offsets, 0);
 }
 
+// See Note [Buffered CPU casts]
+void TensorIterator::mark_buffered_casts(const TensorIteratorConfig& config) {
+  if (!config.buffer_cpu_casts_ || common_dtype_ == ScalarType::Undefined) {
+    return;
+  }
+  for (auto& op : operands_) {
+    if (op.device.is_cpu() && op.tensor.scalar_type() != op.current_dtype) {
+      op.buffered_dtype = op.tensor.scalar_type();
+      has_buffered_casts_ = true;
+    }
+  }
+}
+
 SplitUntil32Bit TensorIterator::with_32bit_indexing() const {
   return SplitUntil32Bit(*this);
 }
@@ -99,6 +99,11 @@ struct CAFFE2_API OperandInfo {
   //value should be changed too.
   ScalarType current_dtype = ScalarType::Undefined;
 
+  // The dtype of the tensor when it differs from current_dtype because the
+  // operand is converted chunk by chunk in the loops instead of through a
+  // temporary, see Note [Buffered CPU casts]. Undefined otherwise.
+  ScalarType buffered_dtype = ScalarType::Undefined;
+
   bool is_type_defined() const { return target_dtype != ScalarType::Undefined; }
   TensorOptions options() const {
     return TensorOptions(target_dtype).device(device);
@@ -134,6 +139,9 @@ struct CAFFE2_API TensorIterator {
   using DimMask = std::bitset<64>;
   using PtrVector = SmallVector<char*, 4>;
   using StrideVector = SmallVector<int64_t, 6>;
+  /// Encodes everything build() depends on besides the data pointers, see
+  /// Note [TensorIterator plan cache]
+  using PlanKey = SmallVector<int64_t, 32>;
 
   TensorIterator(TensorIteratorConfig&);
 
@@ -286,6 +294,11 @@ struct CAFFE2_API TensorIterator {
   bool is_final_output() const { return final_output_; }
 
   bool has_contiguous_first_dim() const {
+    // The data of buffered operands is not in their dtype, so kernels must
+    // not read it directly. See Note [Buffered CPU casts]
+    if (has_buffered_casts_) {
+      return false;
+    }
     int num_tensors = ntensors();
     for (int i = 0; i < num_tensors; i++) {
       if (strides(i)[0] != element_size(i)) {
@@ -297,6 +310,8 @@ struct CAFFE2_API TensorIterator {
 
 protected:
   void build(TensorIteratorConfig&);
+  bool lookup_plan(const TensorIteratorConfig&, PlanKey&);
+  void record_plan(PlanKey&&);
 
   // Mutable reference as it moves tensors out of TensorIteratorConfig
   void populate_operands(TensorIteratorConfig&);
@@ -315,6 +330,7 @@ protected:
   void resize_outputs(const TensorIteratorConfig&);
   void propagate_names_to_outputs();
   void coalesce_dimensions();
+  void mark_buffered_casts(const TensorIteratorConfig&);
 
   template <int dim, MemoryFormat memory_format> bool requires_channels_last_nd_output();
   bool requires_channels_last_2d_output();
@@ -404,6 +420,14 @@ protected:
 
   // From TensorIteratorConfig
   bool is_reduction_ = false;
+
+  /// Set by resize_outputs() if it had to resize an output. The resize is a
+  /// side effect on the output, so such builds are not recorded in the plan
+  /// cache.
+  bool has_resized_outputs_ = false;
+
+  /// Whether some operand has a buffered_dtype, see Note [Buffered CPU casts]
+  bool has_buffered_casts_ = false;
 };
 
 class CAFFE2_API TensorIteratorConfig final {
@@ -500,6 +524,17 @@ public:
     return *this;
   }
 
+  // Sets the buffer_cpu_casts_ flag, which is false by default
+  // If true, the CPU inputs and outputs promote_inputs_to_common_dtype_ and
+  //   cast_common_dtype_to_outputs_ would make temporaries of are instead
+  //   converted chunk by chunk, by for_each() and serial_for_each(), into
+  //   buffers in the common dtype passed to the loops. Only kernels that go
+  //   through these loops can use it (see Note [Buffered CPU casts]).
+  TensorIteratorConfig& buffer_cpu_casts(const bool _buffer_cpu_casts) {
+    buffer_cpu_casts_ = _buffer_cpu_casts;
+    return *this;
+  }
+
   TensorIteratorConfig& resize_outputs(bool resize_outputs) {
     resize_outputs_ = resize_outputs;
     return *this;
@@ -552,10 +587,52 @@ private:
   bool enforce_safe_casting_to_output_ = false;
   bool promote_inputs_to_common_dtype_ = false;
   bool cast_common_dtype_to_outputs_ = false;
+  bool buffer_cpu_casts_ = false;
 };
 
 
 
+// Note [TensorIterator plan cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// For small tensors, computing the broadcast shape, dtypes, strides and the
+// dimension order in TensorIterator::build() can cost more than the kernel
+// itself. The results only depend on the operands' sizes, strides, dtypes
+// and devices and on the config flags, so when the plan cache is enabled
+// build() looks them up in a per-thread cache keyed by exactly those, and
+// on a hit copies the permuted and coalesced shape and strides (and the
+// layouts of outputs it has to allocate) from the earlier build. Checks
+// that depend on the data pointers, like memory overlap, always run.
+//
+// Builds with named tensors, with inputs or outputs that needed a temporary
+// for type promotion, or that resized an output are never cached. Each
+// thread keeps at most a fixed number of plans and drops all of them once it
+// runs out of room.
+//
+// The cache is off by default:
+//
+//   at::TensorIteratorPlanCache::set_enabled(true);
+
+struct TensorIteratorPlanCacheStats {
+  // COUNT: builds that reused a cached plan
+  int64_t hits = 0;
+  // COUNT: builds that computed a plan and added it to the cache
+  int64_t misses = 0;
+  // COUNT: builds whose plan cannot be cached
+  int64_t uncacheable = 0;
+};
+
+namespace TensorIteratorPlanCache {
+
+CAFFE2_API void set_enabled(bool enabled);
+CAFFE2_API bool is_enabled();
+// Statistics are summed over all threads.
+CAFFE2_API TensorIteratorPlanCacheStats get_stats();
+CAFFE2_API void reset_stats();
+// Drops the plans cached by the calling thread.
+CAFFE2_API void clear();
+
+} // namespace TensorIteratorPlanCache
+
 /// A container-like struct that acts as if it contains splits of a
 /// TensorIterator that can use 32-bit indexing. Taken together the splits cover
 /// the original TensorIterator.
@@ -786,6 +786,8 @@ Tensor repeat(const Tensor& self, IntArrayRef repeats) {
   return result;
 }
 
+// sizes and strides must keep the elements of self in the same order, see
+// TensorImpl::set_view_sizes_and_strides
 Tensor alias_with_sizes_and_strides(
     const Tensor& self,
     const c10::IntArrayRef sizes,
@@ -798,13 +800,13 @@ Tensor alias_with_sizes_and_strides(
         self.dtype(),
         get_qtensorimpl(self)->quantizer());
     impl->set_storage_offset(self.storage_offset());
-    impl->set_sizes_and_strides(sizes, strides);
+    impl->set_view_sizes_and_strides(*self.unsafeGetTensorImpl(), sizes, strides);
     self_ = Tensor(std::move(impl));
   } else {
     auto impl = c10::make_intrusive<TensorImpl>(
         Storage(self.storage()), self.key_set(), self.dtype());
     impl->set_storage_offset(self.storage_offset());
-    impl->set_sizes_and_strides(sizes, strides);
+    impl->set_view_sizes_and_strides(*self.unsafeGetTensorImpl(), sizes, strides);
     self_ = Tensor(std::move(impl));
   }
   namedinference::propagate_names(self_, self);
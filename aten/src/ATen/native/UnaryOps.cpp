@@ -20,6 +20,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/native/ComplexHelper.h>
+#include <ATen/native/xnnpack/Engine.h>
 
 #include <algorithm>
 #include <cmath>
@@ -295,7 +296,14 @@ Tensor square(const Tensor& self) { return at::pow(self, 2); }
 Tensor& square_(Tensor& self) { return at::pow_out(self, self, 2); }
 
 Tensor& sigmoid_out(Tensor& result, const Tensor& self) { return unary_op_impl_out(result, self, sigmoid_stub);  }
-Tensor sigmoid(const Tensor& self) { return unary_op_impl(self, at::sigmoid_out);  }
+Tensor sigmoid(const Tensor& self) {
+#if defined(C10_MOBILE)
+  if (xnnpack::use_sigmoid(self)) {
+    return xnnpack::sigmoid(self);
+  }
+#endif
+  return unary_op_impl(self, at::sigmoid_out);
+}
 Tensor& sigmoid_(Tensor& self) { return unary_op_impl_(self, at::sigmoid_out);  }
 
 Tensor& logit_out(
@@ -2,7 +2,11 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/ParallelSort.h>
 
+#include <cstring>
+#include <numeric>
 #include <set>
 #include <tuple>
 #include <unordered_map>
@@ -13,6 +17,240 @@ namespace native{
 
 namespace {
 
+// Note [Parallel unique]
+// ~~~~~~~~~~~~~~~~~~~~~~
+// unique of a large input hashes it with all threads instead of filling one
+// std::unordered_set:
+//
+// 1. Elements are partitioned into one shard per thread by the high bits of
+//    their hash, so equal elements always land in the same shard. Like the
+//    passes of parallel_radix_sort, this is a parallel histogram followed by
+//    a parallel scatter of element positions.
+// 2. Every shard is deduplicated independently into its own open addressing
+//    table (linear probing, at most half full), which assigns each element
+//    a shard-local id and counts it.
+// 3. Shards are concatenated into the output, and the local ids become the
+//    inverse indices. sorted=True sorts only the unique values afterwards
+//    and remaps the ids, which is much cheaper than sorting the input when
+//    there are few unique values.
+//
+// As with the hash set, NaN never compares equal, so every NaN is unique.
+// unique_consecutive needs no hashing: chunks count their run boundaries in
+// parallel and then write their runs at the prefix sums of those counts.
+
+constexpr int64_t kParallelUniqueMinSize = 1 << 16;
+
+// +0 and -0 compare equal, so they hash equal
+template <typename scalar_t>
+uint64_t unique_hash(scalar_t v) {
+  if (v == static_cast<scalar_t>(0)) {
+    return 0;
+  }
+  uint64_t h = 0;
+  std::memcpy(&h, &v, sizeof(scalar_t));
+  // splitmix64 finalizer
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  return h ^ (h >> 31);
+}
+
+// See Note [Parallel unique]
+template <typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> unique_cpu_parallel_template(
+    const Tensor& input,
+    const bool sorted,
+    const bool return_inverse,
+    const bool return_counts) {
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  int64_t numel = input.numel();
+  Tensor inverse_indices = at::empty({0}, input.options().dtype(kLong));
+  Tensor counts = at::empty({0}, input.options().dtype(kLong));
+
+  const int64_t nshards = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), numel / (kParallelUniqueMinSize / 4)));
+  auto shard_of = [nshards](scalar_t v) {
+    return static_cast<int64_t>((unique_hash(v) >> 32) % nshards);
+  };
+
+  // 1. order holds the element positions grouped by shard, in input order
+  // within each shard
+  std::vector<int64_t> offsets(nshards * nshards, 0);
+  parallel_chunks(numel, nshards, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t* hist = offsets.data() + c * nshards;
+    for (int64_t i = begin; i < end; i++) {
+      hist[shard_of(input_data[i])]++;
+    }
+  });
+  std::vector<int64_t> shard_begin(nshards + 1);
+  int64_t running = 0;
+  for (int64_t s = 0; s < nshards; s++) {
+    shard_begin[s] = running;
+    for (int64_t c = 0; c < nshards; c++) {
+      const int64_t count = offsets[c * nshards + s];
+      offsets[c * nshards + s] = running;
+      running += count;
+    }
+  }
+  shard_begin[nshards] = numel;
+  std::vector<int64_t> order(numel);
+  parallel_chunks(numel, nshards, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t* offset = offsets.data() + c * nshards;
+    for (int64_t i = begin; i < end; i++) {
+      order[offset[shard_of(input_data[i])]++] = i;
+    }
+  });
+
+  // 2. local_id[p] is the id of input_data[order[p]] within its shard
+  std::vector<int64_t> local_id(numel);
+  std::vector<std::vector<scalar_t>> shard_values(nshards);
+  std::vector<std::vector<int64_t>> shard_counts(nshards);
+  at::parallel_for(0, nshards, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t s = begin; s < end; s++) {
+      const int64_t lo = shard_begin[s];
+      const int64_t hi = shard_begin[s + 1];
+      int64_t capacity = 16;
+      while (capacity < 2 * (hi - lo)) {
+        capacity *= 2;
+      }
+      std::vector<int64_t> slots(capacity, -1);
+      auto& values = shard_values[s];
+      auto& shard_count = shard_counts[s];
+      for (int64_t p = lo; p < hi; p++) {
+        const scalar_t v = input_data[order[p]];
+        int64_t slot = unique_hash(v) & (capacity - 1);
+        while (slots[slot] >= 0 && values[slots[slot]] != v) {
+          slot = (slot + 1) & (capacity - 1);
+        }
+        if (slots[slot] < 0) {
+          slots[slot] = values.size();
+          values.push_back(v);
+          shard_count.push_back(0);
+        }
+        local_id[p] = slots[slot];
+        shard_count[slots[slot]]++;
+      }
+    }
+  });
+
+  // 3. concatenate the shards
+  std::vector<int64_t> shard_offset(nshards + 1, 0);
+  for (int64_t s = 0; s < nshards; s++) {
+    shard_offset[s + 1] = shard_offset[s] + shard_values[s].size();
+  }
+  const int64_t output_size = shard_offset[nshards];
+  Tensor output = at::empty({output_size}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  at::parallel_for(0, nshards, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t s = begin; s < end; s++) {
+      std::copy(shard_values[s].begin(), shard_values[s].end(), output_data + shard_offset[s]);
+    }
+  });
+
+  // rank[id] is where the unique value with id ends up after sorting
+  std::vector<int64_t> rank;
+  if (sorted) {
+    std::vector<int64_t> perm(output_size);
+    std::iota(perm.begin(), perm.end(), 0);
+    parallel_sort_with_indices(output_data, perm.data(), output_size, /*descending=*/false);
+    rank.resize(output_size);
+    for (int64_t j = 0; j < output_size; j++) {
+      rank[perm[j]] = j;
+    }
+  }
+  auto final_id = [&](int64_t s, int64_t id) {
+    return sorted ? rank[shard_offset[s] + id] : shard_offset[s] + id;
+  };
+
+  if (return_inverse || return_counts) {
+    inverse_indices.resize_(input.sizes());
+    int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
+    int64_t* counts_data = nullptr;
+    if (return_counts) {
+      counts.resize_({output_size});
+      counts_data = counts.data_ptr<int64_t>();
+    }
+    at::parallel_for(0, nshards, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t s = begin; s < end; s++) {
+        for (int64_t p = shard_begin[s]; p < shard_begin[s + 1]; p++) {
+          inverse_indices_data[order[p]] = final_id(s, local_id[p]);
+        }
+        if (counts_data) {
+          for (size_t id = 0; id < shard_counts[s].size(); id++) {
+            counts_data[final_id(s, id)] = shard_counts[s][id];
+          }
+        }
+      }
+    });
+  }
+  return std::make_tuple(output, inverse_indices, counts);
+}
+
+// See Note [Parallel unique]
+template <typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_parallel_template(
+    const Tensor& input,
+    const bool return_inverse,
+    const bool return_counts) {
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  int64_t numel = input.numel();
+  Tensor inverse_indices = at::empty({0}, input.options().dtype(kLong));
+  Tensor counts = at::empty({0}, input.options().dtype(kLong));
+
+  const int64_t nchunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), numel / (kParallelUniqueMinSize / 4)));
+  auto is_run_start = [&](int64_t i) {
+    return i == 0 || input_data[i] != input_data[i - 1];
+  };
+  // runs_before[c] is the number of runs starting before chunk c
+  std::vector<int64_t> runs_before(nchunks + 1, 0);
+  parallel_chunks(numel, nchunks, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t runs = 0;
+    for (int64_t i = begin; i < end; i++) {
+      runs += is_run_start(i);
+    }
+    runs_before[c + 1] = runs;
+  });
+  std::partial_sum(runs_before.begin(), runs_before.end(), runs_before.begin());
+  const int64_t output_size = runs_before[nchunks];
+
+  Tensor output = at::empty({output_size}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* inverse_data = nullptr;
+  if (return_inverse) {
+    inverse_indices.resize_(input.sizes());
+    inverse_data = inverse_indices.data_ptr<int64_t>();
+  }
+  std::vector<int64_t> run_start;
+  if (return_counts) {
+    run_start.resize(output_size + 1);
+    run_start[output_size] = numel;
+  }
+  parallel_chunks(numel, nchunks, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t id = runs_before[c] - 1;
+    for (int64_t i = begin; i < end; i++) {
+      if (is_run_start(i)) {
+        output_data[++id] = input_data[i];
+        if (return_counts) {
+          run_start[id] = i;
+        }
+      }
+      if (inverse_data) {
+        inverse_data[i] = id;
+      }
+    }
+  });
+  if (return_counts) {
+    counts.resize_({output_size});
+    int64_t* counts_data = counts.data_ptr<int64_t>();
+    at::parallel_for(0, output_size, kParallelUniqueMinSize, [&](int64_t begin, int64_t end) {
+      for (int64_t id = begin; id < end; id++) {
+        counts_data[id] = run_start[id + 1] - run_start[id];
+      }
+    });
+  }
+  return std::make_tuple(output, inverse_indices, counts);
+}
+
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -20,6 +258,9 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const bool return_inverse,
     const bool return_counts) {
   const Tensor& input = self.contiguous();
+  if (input.numel() >= kParallelUniqueMinSize) {
+    return unique_cpu_parallel_template<scalar_t>(input, sorted, return_inverse, return_counts);
+  }
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
   Tensor output;
@@ -75,6 +316,9 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
     const bool return_inverse,
     const bool return_counts) {
   const Tensor& input = self.contiguous();
+  if (input.numel() >= kParallelUniqueMinSize) {
+    return unique_consecutive_cpu_parallel_template<scalar_t>(input, return_inverse, return_counts);
+  }
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
   Tensor output = at::empty({numel}, input.options());
@@ -188,19 +432,23 @@ std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
 
   // sort indices using data
   if (!consecutive) {
-    std::sort(indices.begin(), indices.end(),
-      [&](int64_t a, int64_t b) -> bool {
-        for (int64_t i = 0; i < numel; ++i) {
-          scalar_t lhs = input_flat_ptr[i + a * numel];
-          scalar_t rhs = input_flat_ptr[i + b * numel];
-          if (lhs < rhs) {
-            return true;
-          } else if (lhs > rhs) {
-            return false;
-          }
+    auto less = [&](int64_t a, int64_t b) -> bool {
+      for (int64_t i = 0; i < numel; ++i) {
+        scalar_t lhs = input_flat_ptr[i + a * numel];
+        scalar_t rhs = input_flat_ptr[i + b * numel];
+        if (lhs < rhs) {
+          return true;
+        } else if (lhs > rhs) {
+          return false;
         }
-        return false;
-      });
+      }
+      return false;
+    };
+    if (static_cast<int64_t>(indices.size()) >= kParallelSortMinSize) {
+      parallel_merge_sort(indices.data(), indices.size(), less);
+    } else {
+      std::sort(indices.begin(), indices.end(), less);
+    }
   }
 
   Tensor input_sorted;
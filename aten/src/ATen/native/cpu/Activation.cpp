@@ -9,6 +9,7 @@
 #include <ATen/ATen.h>
 #include <ATen/Config.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/vec256_math.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/Parallel.h>
@@ -252,64 +253,78 @@ void elu_backward_kernel(TensorIterator& it, Scalar alpha, Scalar scale, Scalar
   });
 }
 
-// TODO(yangxm): Add another fast kernel using formula
-// y = 0.5x * (1 + tanh(sqrt(2/Pi) * (x + 0.044715x^3)))
-// and the fast tanh impl from Eigen.
+template <typename scalar_t, vec256::MathAccuracy accuracy>
+void GeluVecKernelImpl(TensorIterator& it) {
+  using Vec = vec256::Vec256<scalar_t>;
+  using Math = vec256::VecMath<scalar_t, accuracy>;
+  cpu_kernel_vec(
+      it,
+      [](scalar_t x) {
+        constexpr scalar_t kAlpha = M_SQRT1_2;
+        return x * scalar_t(0.5) * (scalar_t(1) + std::erf(x * kAlpha));
+      },
+      [](Vec x_vec) { return Math::gelu(x_vec); });
+}
+
+template <typename scalar_t, vec256::MathAccuracy accuracy>
+void GeluBackwardVecKernelImpl(TensorIterator& it) {
+  using Vec = vec256::Vec256<scalar_t>;
+  using Math = vec256::VecMath<scalar_t, accuracy>;
+  const Vec kAlphaVec(M_SQRT1_2);
+  const Vec kBetaVec(M_2_SQRTPI * M_SQRT1_2 * 0.5);
+  const Vec kOneVec(1);
+  const Vec kPointFiveVec(0.5);
+  const Vec kMinusPointFiveVec(-0.5);
+  cpu_kernel_vec(
+      it,
+      [](scalar_t dy, scalar_t x) {
+        constexpr scalar_t kAlpha = M_SQRT1_2;
+        constexpr scalar_t kBeta = M_2_SQRTPI * M_SQRT1_2 * 0.5;
+        const scalar_t cdf =
+            scalar_t(0.5) * (scalar_t(1) + std::erf(x * kAlpha));
+        const scalar_t pdf = kBeta * std::exp(x * x * scalar_t(-0.5));
+        return dy * (cdf + x * pdf);
+      },
+      [&](Vec dy_vec, Vec x_vec) {
+        const Vec cdf_vec =
+            kPointFiveVec * (kOneVec + Math::erf(x_vec * kAlphaVec));
+        const Vec pdf_vec =
+            kBetaVec * Math::exp(x_vec * x_vec * kMinusPointFiveVec);
+        return dy_vec * (cdf_vec + x_vec * pdf_vec);
+      });
+}
+
+// With fast math allowed GELU always takes the single pass vectorized
+// kernel, which beats the two MKL VML passes once erf is cheap.
+// See Note [Vectorized math accuracy]
 void GeluKernelImpl(TensorIterator& it) {
-  if (at::hasMKL() && it.is_contiguous()) {
+  if (at::globalContext().allowFastMathCPU()) {
+    AT_DISPATCH_FLOATING_TYPES(it.dtype(), "GeluKernelImpl", [&]() {
+      GeluVecKernelImpl<scalar_t, vec256::MathAccuracy::Fast>(it);
+    });
+  } else if (at::hasMKL() && it.is_contiguous()) {
     AT_DISPATCH_FLOATING_TYPES(it.dtype(), "GeluKernelImpl", [&]() {
       GeluMKLKernelImpl<scalar_t>(&it);
     });
   } else {
     AT_DISPATCH_FLOATING_TYPES(it.dtype(), "GeluKernelImpl", [&]() {
-      using Vec = vec256::Vec256<scalar_t>;
-      const Vec kAlphaVec(M_SQRT1_2);
-      const Vec kOneVec(1);
-      const Vec kPointFiveVec(0.5);
-      cpu_kernel_vec(
-          it,
-          [](scalar_t x) {
-            constexpr scalar_t kAlpha = M_SQRT1_2;
-            return x * scalar_t(0.5) * (scalar_t(1) + std::erf(x * kAlpha));
-          },
-          [&](Vec x_vec) {
-            return x_vec * kPointFiveVec *
-                (kOneVec + (x_vec * kAlphaVec).erf());
-          });
+      GeluVecKernelImpl<scalar_t, vec256::MathAccuracy::High>(it);
     });
   }
 }
 
 void GeluBackwardKernelImpl(TensorIterator& it) {
-  if (hasMKL() && it.is_contiguous()) {
+  if (at::globalContext().allowFastMathCPU()) {
+    AT_DISPATCH_FLOATING_TYPES(it.dtype(), "GeluBackwardKernelImpl", [&]() {
+      GeluBackwardVecKernelImpl<scalar_t, vec256::MathAccuracy::Fast>(it);
+    });
+  } else if (hasMKL() && it.is_contiguous()) {
     AT_DISPATCH_FLOATING_TYPES(it.dtype(), "GeluBackwardKernelImpl", [&]() {
       GeluBackwardMKLKernelImpl<scalar_t>(&it);
     });
   } else {
     AT_DISPATCH_FLOATING_TYPES(it.dtype(), "GeluBackwardKernelImpl", [&]() {
-      using Vec = vec256::Vec256<scalar_t>;
-      const Vec kAlphaVec(M_SQRT1_2);
-      const Vec kBetaVec(M_2_SQRTPI * M_SQRT1_2 * 0.5);
-      const Vec kOneVec(1);
-      const Vec kPointFiveVec(0.5);
-      const Vec kMinusPointFiveVec(-0.5);
-      cpu_kernel_vec(
-          it,
-          [](scalar_t dy, scalar_t x) {
-            constexpr scalar_t kAlpha = M_SQRT1_2;
-            constexpr scalar_t kBeta = M_2_SQRTPI * M_SQRT1_2 * 0.5;
-            const scalar_t cdf =
-                scalar_t(0.5) * (scalar_t(1) + std::erf(x * kAlpha));
-            const scalar_t pdf = kBeta * std::exp(x * x * scalar_t(-0.5));
-            return dy * (cdf + x * pdf);
-          },
-          [&](Vec dy_vec, Vec x_vec) {
-            const Vec cdf_vec =
-                kPointFiveVec * (kOneVec + (x_vec * kAlphaVec).erf());
-            const Vec pdf_vec =
-                kBetaVec * (x_vec * x_vec * kMinusPointFiveVec).exp();
-            return dy_vec * (cdf_vec + x_vec * pdf_vec);
-          });
+      GeluBackwardVecKernelImpl<scalar_t, vec256::MathAccuracy::High>(it);
     });
   }
 }
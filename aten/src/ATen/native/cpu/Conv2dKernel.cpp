@@ -0,0 +1,386 @@
+#include <ATen/native/cpu/Conv2dKernel.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/ConvUtils.h>
+#include <ATen/native/CPUBlas.h>
+
+namespace at {
+namespace native {
+namespace {
+
+// Note [Small channel conv2d]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Without MKL-DNN or NNPACK, float conv2d goes through thnn_conv2d, which
+// unfolds every input into a (C * kH * kW) x (oH * oW) column buffer and
+// runs one gemm per image. With few channels that gemm is small and skinny
+// while the buffer is nine times the input for a 3x3 kernel, so most of the
+// time goes into writing and re-reading columns. The kernels here never
+// materialize columns:
+//
+// - conv2d_winograd3x3 computes 3x3, stride 1 convolutions with Winograd
+//   F(2x2, 3x3). Every 2x2 output tile comes from a 4x4 input tile
+//   through 16 element-wise products summed over the input channels, 2.25x
+//   fewer multiplications than the direct form. The weight is transformed
+//   once per call. Input tiles are transformed in blocks of
+//   kWinogradTileBlock and the 16 channel reductions of a block run as one
+//   cpublas::gemm_batched_stub call (see Note [Batched small gemm]), so the
+//   scratch space per thread stays at 16 * kWinogradTileBlock *
+//   (C_in + C_out) floats. F(4x4, 3x3) would save more multiplications,
+//   but its transforms lose too much float precision to replace the exact
+//   kernels silently.
+// - conv2d_direct_nhwc computes any stride, padding and dilation directly
+//   on channels last input: every output pixel is a sum over the kernel
+//   window of a 1 x C_in input row times a C_in x C_out slice of the
+//   repacked weight, accumulated in Vec256 registers over the output
+//   channels. The output is channels last too, so a channels last model
+//   does not get converted back and forth around every convolution.
+//
+// ConvParams::use_cpu_winograd3x3 and ConvParams::use_cpu_direct_nhwc in
+// Convolution.cpp decide when these run.
+
+constexpr int64_t kWinogradTileBlock = 48;
+
+// 1-D F(2, 3) transforms; the 2-D ones apply them to rows, then columns.
+template <typename T>
+inline void winograd_f2k3_kernel_transform(const T g[3], T u[4]) {
+  u[0] = g[0];
+  u[1] = T(0.5) * (g[0] + g[1] + g[2]);
+  u[2] = T(0.5) * (g[0] - g[1] + g[2]);
+  u[3] = g[2];
+}
+
+template <typename T>
+inline void winograd_f2k3_input_transform(const T d[4], T v[4]) {
+  v[0] = d[0] - d[2];
+  v[1] = d[1] + d[2];
+  v[2] = d[2] - d[1];
+  v[3] = d[1] - d[3];
+}
+
+template <typename T>
+inline void winograd_f2k3_output_transform(const T m[4], T y[2]) {
+  y[0] = m[0] + m[1] + m[2];
+  y[1] = m[1] - m[2] - m[3];
+}
+
+// u[16][c_in][c_out] = G g G^T for every (c_out, c_in) kernel of weight
+void winograd_f2k3_transform_weight(
+    const float* weight, int64_t c_out, int64_t c_in, float* u) {
+  const int64_t plane = c_in * c_out;
+  for (int64_t oc = 0; oc < c_out; oc++) {
+    for (int64_t ic = 0; ic < c_in; ic++) {
+      const float* g = weight + (oc * c_in + ic) * 9;
+      float rows[4][3];
+      for (int64_t c = 0; c < 3; c++) {
+        const float col[3] = {g[c], g[3 + c], g[6 + c]};
+        float t[4];
+        winograd_f2k3_kernel_transform(col, t);
+        for (int64_t r = 0; r < 4; r++) {
+          rows[r][c] = t[r];
+        }
+      }
+      for (int64_t r = 0; r < 4; r++) {
+        float t[4];
+        winograd_f2k3_kernel_transform(rows[r], t);
+        for (int64_t c = 0; c < 4; c++) {
+          u[(r * 4 + c) * plane + ic * c_out + oc] = t[c];
+        }
+      }
+    }
+  }
+}
+
+// v[xi][t][ic] = B^T d B for the 4x4 tile d at (y0, x0) of channel ic, with
+// zeros outside the input
+void winograd_f2k3_transform_input_tile(
+    const float* input, int64_t c_in, int64_t in_h, int64_t in_w,
+    int64_t y0, int64_t x0, float* v, int64_t xi_stride) {
+  const bool interior = y0 >= 0 && x0 >= 0 && y0 + 4 <= in_h && x0 + 4 <= in_w;
+  for (int64_t ic = 0; ic < c_in; ic++) {
+    const float* plane = input + ic * in_h * in_w;
+    float d[4][4];
+    for (int64_t r = 0; r < 4; r++) {
+      const int64_t y = y0 + r;
+      for (int64_t c = 0; c < 4; c++) {
+        const int64_t x = x0 + c;
+        d[r][c] = (interior || (y >= 0 && y < in_h && x >= 0 && x < in_w))
+            ? plane[y * in_w + x] : 0.f;
+      }
+    }
+    float cols[4][4];
+    for (int64_t c = 0; c < 4; c++) {
+      const float col[4] = {d[0][c], d[1][c], d[2][c], d[3][c]};
+      float t[4];
+      winograd_f2k3_input_transform(col, t);
+      for (int64_t r = 0; r < 4; r++) {
+        cols[r][c] = t[r];
+      }
+    }
+    for (int64_t r = 0; r < 4; r++) {
+      float t[4];
+      winograd_f2k3_input_transform(cols[r], t);
+      for (int64_t c = 0; c < 4; c++) {
+        v[(r * 4 + c) * xi_stride + ic] = t[c];
+      }
+    }
+  }
+}
+
+// Writes the 2x2 tile A^T m A + bias at (y0, x0) of every output channel,
+// clipped to the output
+void winograd_f2k3_transform_output_tile(
+    const float* m, int64_t xi_stride, const float* bias,
+    int64_t c_out, int64_t out_h, int64_t out_w,
+    int64_t y0, int64_t x0, float* output) {
+  const int64_t rows = std::min<int64_t>(2, out_h - y0);
+  const int64_t cols = std::min<int64_t>(2, out_w - x0);
+  for (int64_t oc = 0; oc < c_out; oc++) {
+    float s[2][4];
+    for (int64_t c = 0; c < 4; c++) {
+      const float col[4] = {
+          m[c * xi_stride + oc], m[(4 + c) * xi_stride + oc],
+          m[(8 + c) * xi_stride + oc], m[(12 + c) * xi_stride + oc]};
+      float t[2];
+      winograd_f2k3_output_transform(col, t);
+      s[0][c] = t[0];
+      s[1][c] = t[1];
+    }
+    const float b = bias != nullptr ? bias[oc] : 0.f;
+    float* plane = output + oc * out_h * out_w;
+    for (int64_t r = 0; r < rows; r++) {
+      float y[2];
+      winograd_f2k3_output_transform(s[r], y);
+      for (int64_t c = 0; c < cols; c++) {
+        plane[(y0 + r) * out_w + x0 + c] = y[c] + b;
+      }
+    }
+  }
+}
+
+Tensor conv2d_winograd3x3_kernel(
+    const Tensor& input_,
+    const Tensor& weight_,
+    const Tensor& bias_,
+    IntArrayRef padding) {
+  const Tensor input = input_.contiguous();
+  const Tensor weight = weight_.contiguous();
+  const Tensor bias = bias_.defined() ? bias_.contiguous() : bias_;
+
+  const int64_t batch = input.size(0);
+  const int64_t c_in = input.size(1);
+  const int64_t in_h = input.size(2);
+  const int64_t in_w = input.size(3);
+  const int64_t c_out = weight.size(0);
+  const auto output_size = conv_output_size(
+      input.sizes(), weight.sizes(), padding, /*stride=*/{1, 1});
+  Tensor output = at::empty(output_size, input.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+  const int64_t out_h = output_size[2];
+  const int64_t out_w = output_size[3];
+  const int64_t tiles_h = divup(out_h, 2);
+  const int64_t tiles_w = divup(out_w, 2);
+  const int64_t tiles = tiles_h * tiles_w;
+  const int64_t blocks = divup(tiles, kWinogradTileBlock);
+
+  std::vector<float> u(16 * c_in * c_out);
+  winograd_f2k3_transform_weight(weight.data_ptr<float>(), c_out, c_in, u.data());
+
+  const float* input_data = input.data_ptr<float>();
+  const float* bias_data = bias.defined() ? bias.data_ptr<float>() : nullptr;
+  float* output_data = output.data_ptr<float>();
+  const int64_t v_xi_stride = kWinogradTileBlock * c_in;
+  const int64_t m_xi_stride = kWinogradTileBlock * c_out;
+  const int64_t v_strides[3] = {v_xi_stride, c_in, 1};
+  const int64_t u_strides[3] = {c_in * c_out, c_out, 1};
+  const int64_t m_strides[3] = {m_xi_stride, c_out, 1};
+
+  at::parallel_for(0, batch * blocks, 1, [&](int64_t begin, int64_t end) {
+    std::vector<float> v(16 * v_xi_stride);
+    std::vector<float> m(16 * m_xi_stride);
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t n = i / blocks;
+      const int64_t tile_begin = (i % blocks) * kWinogradTileBlock;
+      const int64_t tile_count = std::min(kWinogradTileBlock, tiles - tile_begin);
+      const float* input_n = input_data + n * c_in * in_h * in_w;
+      float* output_n = output_data + n * c_out * out_h * out_w;
+
+      for (int64_t t = 0; t < tile_count; t++) {
+        const int64_t tile = tile_begin + t;
+        winograd_f2k3_transform_input_tile(
+            input_n, c_in, in_h, in_w,
+            (tile / tiles_w) * 2 - padding[0], (tile % tiles_w) * 2 - padding[1],
+            v.data() + t * c_in, v_xi_stride);
+      }
+      // m[xi] = v[xi] @ u[xi] for the 16 tile elements
+      cpublas::gemm_batched_stub(
+          kCPU, kFloat,
+          16, tile_count, c_out, c_in,
+          1.0f,
+          v.data(), v_strides,
+          u.data(), u_strides,
+          0.0f,
+          m.data(), m_strides);
+      for (int64_t t = 0; t < tile_count; t++) {
+        const int64_t tile = tile_begin + t;
+        winograd_f2k3_transform_output_tile(
+            m.data() + t * c_out, m_xi_stride, bias_data,
+            c_out, out_h, out_w,
+            (tile / tiles_w) * 2, (tile % tiles_w) * 2, output_n);
+      }
+    }
+  });
+  return output;
+}
+
+struct DirectConvArgs {
+  int64_t in_h, in_w, c_in;
+  int64_t out_h, out_w, c_out;
+  // c_out rounded up to a whole number of vectors
+  int64_t c_out_padded;
+  int64_t kernel_h, kernel_w;
+  int64_t stride_h, stride_w;
+  int64_t pad_h, pad_w;
+  int64_t dilation_h, dilation_w;
+};
+
+// Output channels [oc0, oc0 + count) of the output pixel (oh, ow), with
+// count in ((kNumVec - 1) * Vec::size(), kNumVec * Vec::size()]
+template <int64_t kNumVec>
+void conv2d_direct_nhwc_pixel(
+    const DirectConvArgs& args,
+    const float* input_n, const float* weight, const float* bias,
+    int64_t oh, int64_t ow, int64_t oc0, int64_t count, float* out) {
+  using Vec = vec256::Vec256<float>;
+  constexpr int64_t kVecSize = Vec::size();
+
+  Vec acc[kNumVec];
+  for (int64_t j = 0; j < kNumVec; j++) {
+    acc[j] = Vec::loadu(bias + oc0 + j * kVecSize);
+  }
+  for (int64_t kh = 0; kh < args.kernel_h; kh++) {
+    const int64_t ih = oh * args.stride_h - args.pad_h + kh * args.dilation_h;
+    if (ih < 0 || ih >= args.in_h) {
+      continue;
+    }
+    for (int64_t kw = 0; kw < args.kernel_w; kw++) {
+      const int64_t iw = ow * args.stride_w - args.pad_w + kw * args.dilation_w;
+      if (iw < 0 || iw >= args.in_w) {
+        continue;
+      }
+      const float* x = input_n + (ih * args.in_w + iw) * args.c_in;
+      const float* w = weight + (kh * args.kernel_w + kw) * args.c_in * args.c_out_padded + oc0;
+      for (int64_t ic = 0; ic < args.c_in; ic++) {
+        const Vec x_ic(x[ic]);
+        for (int64_t j = 0; j < kNumVec; j++) {
+          acc[j] = vec256::fmadd(x_ic, Vec::loadu(w + j * kVecSize), acc[j]);
+        }
+        w += args.c_out_padded;
+      }
+    }
+  }
+  for (int64_t j = 0; j < kNumVec; j++) {
+    const int64_t remaining = count - j * kVecSize;
+    if (remaining >= kVecSize) {
+      acc[j].store(out + oc0 + j * kVecSize);
+    } else {
+      acc[j].store(out + oc0 + j * kVecSize, remaining);
+    }
+  }
+}
+
+Tensor conv2d_direct_nhwc_kernel(
+    const Tensor& input_,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  using Vec = vec256::Vec256<float>;
+  constexpr int64_t kVecSize = Vec::size();
+  constexpr int64_t kMaxVecs = 4;
+
+  const Tensor input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+  const auto output_size = conv_output_size(
+      input.sizes(), weight.sizes(), padding, stride, dilation);
+  Tensor output = at::empty(
+      output_size, input.options().memory_format(at::MemoryFormat::ChannelsLast));
+  if (output.numel() == 0) {
+    return output;
+  }
+
+  DirectConvArgs args;
+  args.in_h = input.size(2);
+  args.in_w = input.size(3);
+  args.c_in = input.size(1);
+  args.out_h = output_size[2];
+  args.out_w = output_size[3];
+  args.c_out = weight.size(0);
+  args.c_out_padded = divup(args.c_out, kVecSize) * kVecSize;
+  args.kernel_h = weight.size(2);
+  args.kernel_w = weight.size(3);
+  args.stride_h = stride[0];
+  args.stride_w = stride[1];
+  args.pad_h = padding[0];
+  args.pad_w = padding[1];
+  args.dilation_h = dilation[0];
+  args.dilation_w = dilation[1];
+
+  // [kernel_h][kernel_w][c_in][c_out_padded], zero padded so whole vectors
+  // can be loaded at the last output channels
+  Tensor weight_packed = at::zeros(
+      {args.kernel_h, args.kernel_w, args.c_in, args.c_out_padded}, weight.options());
+  weight_packed.narrow(3, 0, args.c_out).copy_(weight.permute({2, 3, 1, 0}));
+  Tensor bias_packed = at::zeros({args.c_out_padded}, weight.options());
+  if (bias.defined()) {
+    bias_packed.narrow(0, 0, args.c_out).copy_(bias);
+  }
+
+  const float* input_data = input.data_ptr<float>();
+  const float* weight_data = weight_packed.data_ptr<float>();
+  const float* bias_data = bias_packed.data_ptr<float>();
+  float* output_data = output.data_ptr<float>();
+  const int64_t batch = input.size(0);
+  const int64_t row_work =
+      args.out_w * args.c_out * args.c_in * args.kernel_h * args.kernel_w;
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / row_work);
+
+  at::parallel_for(0, batch * args.out_h, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      const int64_t n = row / args.out_h;
+      const int64_t oh = row % args.out_h;
+      const float* input_n = input_data + n * args.in_h * args.in_w * args.c_in;
+      for (int64_t ow = 0; ow < args.out_w; ow++) {
+        float* out = output_data + (row * args.out_w + ow) * args.c_out;
+        for (int64_t oc0 = 0; oc0 < args.c_out; oc0 += kMaxVecs * kVecSize) {
+          const int64_t count = std::min(kMaxVecs * kVecSize, args.c_out - oc0);
+          switch (divup(count, kVecSize)) {
+            case 1:
+              conv2d_direct_nhwc_pixel<1>(args, input_n, weight_data, bias_data, oh, ow, oc0, count, out);
+              break;
+            case 2:
+              conv2d_direct_nhwc_pixel<2>(args, input_n, weight_data, bias_data, oh, ow, oc0, count, out);
+              break;
+            case 3:
+              conv2d_direct_nhwc_pixel<3>(args, input_n, weight_data, bias_data, oh, ow, oc0, count, out);
+              break;
+            default:
+              conv2d_direct_nhwc_pixel<kMaxVecs>(args, input_n, weight_data, bias_data, oh, ow, oc0, count, out);
+          }
+        }
+      }
+    }
+  });
+  return output;
+}
+
+}  // namespace
+
+REGISTER_DISPATCH(conv2d_winograd3x3_stub, &conv2d_winograd3x3_kernel);
+REGISTER_DISPATCH(conv2d_direct_nhwc_stub, &conv2d_direct_nhwc_kernel);
+
+}  // namespace native
+}  // namespace at
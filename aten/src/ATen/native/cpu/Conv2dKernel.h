@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+/*
+  Native float conv2d kernels for small channel counts, see
+  Note [Small channel conv2d] in Conv2dKernel.cpp
+*/
+
+namespace at {
+namespace native {
+
+// Winograd F(2x2, 3x3): 3x3 kernel, stride 1, no dilation, groups 1.
+// Returns a contiguous output.
+using conv2d_winograd3x3_fn =
+    Tensor (*)(const Tensor& input, const Tensor& weight, const Tensor& bias, IntArrayRef padding);
+
+// Direct convolution over channels last input, groups 1. Returns a channels
+// last output.
+using conv2d_direct_nhwc_fn =
+    Tensor (*)(const Tensor& input, const Tensor& weight, const Tensor& bias,
+               IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation);
+
+DECLARE_DISPATCH(conv2d_winograd3x3_fn, conv2d_winograd3x3_stub);
+DECLARE_DISPATCH(conv2d_direct_nhwc_fn, conv2d_direct_nhwc_stub);
+
+}  // namespace native
+}  // namespace at
@@ -3,6 +3,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/Intrinsics.h>
 #include <ATen/native/cpu/Loops.h>
 #include <c10/util/TypeCast.h>
 
@@ -10,8 +11,191 @@ namespace at {
 namespace native {
 namespace {
 
+// Note [Blocked transpose copy]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A copy where the destination is contiguous along one of the two innermost
+// dimensions and the source along the other (transpose(), permute() and
+// channels last conversions followed by contiguous()) reads or writes with
+// a large stride in the inner loop, touching a new cache line per element.
+// Such copies are done in kTransposeBlock x kTransposeBlock tiles instead,
+// so that all cache lines of a tile are used before being evicted, and
+// every tile is made of 8x8 blocks that are transposed in registers for 4
+// and 8 byte elements. The copy is a bit copy, so the kernel only depends
+// on the element size.
+
+constexpr int64_t kTransposeBlock = 32;
+
+// dst[c * ld_dst + r] = src[r * ld_src + c] for r < rows, c < cols
+template <typename T>
+void transpose_block(const T* src, int64_t ld_src, T* dst, int64_t ld_dst, int64_t rows, int64_t cols) {
+  for (int64_t r = 0; r < rows; r++) {
+    for (int64_t c = 0; c < cols; c++) {
+      dst[c * ld_dst + r] = src[r * ld_src + c];
+    }
+  }
+}
+
+template <typename T>
+void transpose_8x8(const T* src, int64_t ld_src, T* dst, int64_t ld_dst) {
+  transpose_block(src, ld_src, dst, ld_dst, 8, 8);
+}
+
+#if (defined(CPU_CAPABILITY_AVX) || defined(CPU_CAPABILITY_AVX2)) && !defined(_MSC_VER)
+
+template <>
+void transpose_8x8<uint32_t>(const uint32_t* src, int64_t ld_src, uint32_t* dst, int64_t ld_dst) {
+  auto load = [&](int64_t r) { return _mm256_loadu_ps(reinterpret_cast<const float*>(src + r * ld_src)); };
+  const __m256 t0 = _mm256_unpacklo_ps(load(0), load(1));
+  const __m256 t1 = _mm256_unpackhi_ps(load(0), load(1));
+  const __m256 t2 = _mm256_unpacklo_ps(load(2), load(3));
+  const __m256 t3 = _mm256_unpackhi_ps(load(2), load(3));
+  const __m256 t4 = _mm256_unpacklo_ps(load(4), load(5));
+  const __m256 t5 = _mm256_unpackhi_ps(load(4), load(5));
+  const __m256 t6 = _mm256_unpacklo_ps(load(6), load(7));
+  const __m256 t7 = _mm256_unpackhi_ps(load(6), load(7));
+  const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  auto store = [&](int64_t c, __m256 v) { _mm256_storeu_ps(reinterpret_cast<float*>(dst + c * ld_dst), v); };
+  store(0, _mm256_permute2f128_ps(s0, s4, 0x20));
+  store(1, _mm256_permute2f128_ps(s1, s5, 0x20));
+  store(2, _mm256_permute2f128_ps(s2, s6, 0x20));
+  store(3, _mm256_permute2f128_ps(s3, s7, 0x20));
+  store(4, _mm256_permute2f128_ps(s0, s4, 0x31));
+  store(5, _mm256_permute2f128_ps(s1, s5, 0x31));
+  store(6, _mm256_permute2f128_ps(s2, s6, 0x31));
+  store(7, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+
+// An 8x8 block of 8 byte elements is four 4x4 blocks of one register row each
+inline void transpose_4x4(const uint64_t* src, int64_t ld_src, uint64_t* dst, int64_t ld_dst) {
+  auto load = [&](int64_t r) { return _mm256_loadu_pd(reinterpret_cast<const double*>(src + r * ld_src)); };
+  const __m256d t0 = _mm256_unpacklo_pd(load(0), load(1));
+  const __m256d t1 = _mm256_unpackhi_pd(load(0), load(1));
+  const __m256d t2 = _mm256_unpacklo_pd(load(2), load(3));
+  const __m256d t3 = _mm256_unpackhi_pd(load(2), load(3));
+  auto store = [&](int64_t c, __m256d v) { _mm256_storeu_pd(reinterpret_cast<double*>(dst + c * ld_dst), v); };
+  store(0, _mm256_permute2f128_pd(t0, t2, 0x20));
+  store(1, _mm256_permute2f128_pd(t1, t3, 0x20));
+  store(2, _mm256_permute2f128_pd(t0, t2, 0x31));
+  store(3, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+template <>
+void transpose_8x8<uint64_t>(const uint64_t* src, int64_t ld_src, uint64_t* dst, int64_t ld_dst) {
+  transpose_4x4(src, ld_src, dst, ld_dst);
+  transpose_4x4(src + 4, ld_src, dst + 4 * ld_dst, ld_dst);
+  transpose_4x4(src + 4 * ld_src, ld_src, dst + 4, ld_dst);
+  transpose_4x4(src + 4 * ld_src + 4, ld_src, dst + 4 * ld_dst + 4, ld_dst);
+}
+
+#endif
+
+template <typename T>
+void blocked_transpose(const T* src, int64_t ld_src, T* dst, int64_t ld_dst, int64_t rows, int64_t cols) {
+  for (int64_t r0 = 0; r0 < rows; r0 += kTransposeBlock) {
+    for (int64_t c0 = 0; c0 < cols; c0 += kTransposeBlock) {
+      const int64_t r_end = std::min(r0 + kTransposeBlock, rows);
+      const int64_t c_end = std::min(c0 + kTransposeBlock, cols);
+      for (int64_t r = r0; r < r_end; r += 8) {
+        for (int64_t c = c0; c < c_end; c += 8) {
+          const T* s = src + r * ld_src + c;
+          T* d = dst + c * ld_dst + r;
+          if (r + 8 <= r_end && c + 8 <= c_end) {
+            transpose_8x8(s, ld_src, d, ld_dst);
+          } else {
+            transpose_block(s, ld_src, d, ld_dst, std::min<int64_t>(8, r_end - r), std::min<int64_t>(8, c_end - c));
+          }
+        }
+      }
+    }
+  }
+}
+
+// See Note [Blocked transpose copy]
+static bool is_transpose_copy(TensorIterator& iter) {
+  if (iter.ndim() < 2 || iter.shape()[0] < 8 || iter.shape()[1] < 8) {
+    return false;
+  }
+  const int64_t size = iter.element_size(0);
+  if (size != 1 && size != 2 && size != 4 && size != 8) {
+    return false;
+  }
+  auto dst = iter.strides(0);
+  auto src = iter.strides(1);
+  if (dst[1] % size != 0 || src[0] % size != 0 || dst[0] % size != 0 || src[1] % size != 0) {
+    return false;
+  }
+  return (dst[0] == size && src[1] == size && src[0] != size) ||
+      (dst[1] == size && src[0] == size && dst[0] != size);
+}
+
+template <typename T>
+void transpose_copy_kernel(TensorIterator& iter) {
+  iter.for_each([](char** data, const int64_t* strides, int64_t size0, int64_t size1) {
+    constexpr int64_t size = sizeof(T);
+    T* dst = reinterpret_cast<T*>(data[0]);
+    const T* src = reinterpret_cast<const T*>(data[1]);
+    if (strides[0] == size) {
+      // dst is contiguous along dim 0 and src along dim 1
+      blocked_transpose(src, strides[1] / size, dst, strides[2] / size, size0, size1);
+    } else {
+      // dst is contiguous along dim 1 and src along dim 0
+      blocked_transpose(src, strides[3] / size, dst, strides[0] / size, size1, size0);
+    }
+  });
+}
+
+// float <-> Half and float <-> BFloat16 casts (to(dtype) and copy_, which
+// also serve checkpoint conversions and the gradient compression of DDP) go
+// through vec256::convert for the contiguous inner loops, which converts a
+// vector at a time with F16C and the AVX2 bfloat16 rounding.
+template <typename dst_t, typename src_t>
+void float_16bit_copy_kernel(TensorIterator& iter) {
+  iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == sizeof(dst_t) && strides[1] == sizeof(src_t)) {
+      vec256::convert(reinterpret_cast<const src_t*>(data[1]), reinterpret_cast<dst_t*>(data[0]), n);
+    } else {
+      for (int64_t i = 0; i < n; i++) {
+        *reinterpret_cast<dst_t*>(data[0] + i * strides[0]) =
+            static_cast<dst_t>(*reinterpret_cast<const src_t*>(data[1] + i * strides[1]));
+      }
+    }
+  });
+}
+
+static bool is_float_16bit_copy(ScalarType dst, ScalarType src) {
+  auto is_16bit = [](ScalarType t) { return t == ScalarType::Half || t == ScalarType::BFloat16; };
+  return (dst == ScalarType::Float && is_16bit(src)) || (src == ScalarType::Float && is_16bit(dst));
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
+  if (is_float_16bit_copy(dtype, iter.dtype(1))) {
+    switch (iter.dtype(1)) {
+      case ScalarType::Half: return float_16bit_copy_kernel<float, at::Half>(iter);
+      case ScalarType::BFloat16: return float_16bit_copy_kernel<float, at::BFloat16>(iter);
+      default: break;
+    }
+    switch (dtype) {
+      case ScalarType::Half: return float_16bit_copy_kernel<at::Half, float>(iter);
+      case ScalarType::BFloat16: return float_16bit_copy_kernel<at::BFloat16, float>(iter);
+      default: break;
+    }
+  }
+  if (dtype == iter.dtype(1) && is_transpose_copy(iter)) {
+    switch (iter.element_size(0)) {
+      case 1: return transpose_copy_kernel<uint8_t>(iter);
+      case 2: return transpose_copy_kernel<uint16_t>(iter);
+      case 4: return transpose_copy_kernel<uint32_t>(iter);
+      case 8: return transpose_copy_kernel<uint64_t>(iter);
+    }
+  }
   if (dtype == iter.dtype(1)) {
     if (dtype == ScalarType::Half) {
       cpu_kernel(iter, [=](at::Half a) -> at::Half { return a; });
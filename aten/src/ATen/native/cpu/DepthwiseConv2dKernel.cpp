@@ -0,0 +1,513 @@
+#include <ATen/native/cpu/DepthwiseConvKernel.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+
+namespace at {
+namespace native {
+namespace {
+
+// Note [CPU depthwise conv2d]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A depthwise convolution (groups == C_in, C_out = C_in * multiplier) used
+// to run on CPU as C_in separate single channel convolutions through
+// thnn_conv2d, one unfold and one 1 x (kH * kW) gemm per group and image,
+// which costs far more in bookkeeping than the kH * kW multiply-adds per
+// output it computes. Besides the 3x3 stride 1 forward of the NEON Winograd
+// kernel in DepthwiseConvKernel.cpp, the kernels here compute any kernel
+// size, stride, padding and dilation directly, forward and backward,
+// vectorized with Vec256 (AVX2, AVX or NEON, depending on the build):
+//
+// - on contiguous (NCHW) tensors, every (image, channel) plane is computed
+//   row by row: for every tap of the kernel, the range of the output row
+//   whose inputs are in bounds is worked out once, and the row is updated
+//   with one axpy of the input row. With stride 1 both rows are contiguous
+//   and the axpy is vectorized. The gradient of the input scatters the same
+//   way from the rows of grad_output, and the gradient of the weight is a
+//   dot product of the same rows per tap.
+// - on channels last (NHWC) tensors, every output pixel is a sum over the
+//   kernel window of inputs that are contiguous over the channels, so the
+//   kernels vectorize over the channels for every stride, with the weight
+//   repacked to [kH][kW][C]. The gradient of the input is gathered per
+//   input pixel, so that rows of the input are owned by one task.
+//
+// They implement thnn_conv_depthwise2d_forward and
+// thnn_conv_depthwise2d_backward on CPU, so autograd and double backward
+// work as on CUDA; ConvParams::use_cpu_depthwise in Convolution.cpp decides
+// when _convolution takes them.
+
+struct DepthwiseConvArgs {
+  int64_t batch;
+  int64_t channels;
+  int64_t multiplier;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+};
+
+DepthwiseConvArgs make_args(
+    IntArrayRef input_size, IntArrayRef output_size, IntArrayRef weight_size,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation) {
+  DepthwiseConvArgs args;
+  args.batch = input_size[0];
+  args.channels = input_size[1];
+  args.multiplier = weight_size[0] / input_size[1];
+  args.in_h = input_size[2];
+  args.in_w = input_size[3];
+  args.out_h = output_size[2];
+  args.out_w = output_size[3];
+  args.kernel_h = weight_size[2];
+  args.kernel_w = weight_size[3];
+  args.stride_h = stride[0];
+  args.stride_w = stride[1];
+  args.pad_h = padding[0];
+  args.pad_w = padding[1];
+  args.dilation_h = dilation[0];
+  args.dilation_w = dilation[1];
+  return args;
+}
+
+// [begin, end) of the outputs o whose input o * stride + offset is in
+// [0, size)
+inline void valid_output_range(
+    int64_t offset, int64_t stride, int64_t size, int64_t out_size,
+    int64_t& begin, int64_t& end) {
+  begin = offset >= 0 ? 0 : divup(-offset, stride);
+  end = offset >= size ? 0 : std::min(out_size, (size - 1 - offset) / stride + 1);
+  begin = std::min(begin, end);
+}
+
+// y[i * y_stride] += a * x[i * x_stride] for i in [0, n)
+template <typename scalar_t>
+inline void strided_axpy(
+    int64_t n, scalar_t a,
+    const scalar_t* x, int64_t x_stride,
+    scalar_t* y, int64_t y_stride) {
+  using Vec = vec256::Vec256<scalar_t>;
+  int64_t i = 0;
+  if (x_stride == 1 && y_stride == 1) {
+    const Vec a_vec(a);
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      vec256::fmadd(a_vec, Vec::loadu(x + i), Vec::loadu(y + i)).store(y + i);
+    }
+  }
+  for (; i < n; i++) {
+    y[i * y_stride] += a * x[i * x_stride];
+  }
+}
+
+// sum of x[i] * y[i * y_stride] for i in [0, n)
+template <typename scalar_t>
+inline scalar_t strided_dot(
+    int64_t n, const scalar_t* x, const scalar_t* y, int64_t y_stride) {
+  using Vec = vec256::Vec256<scalar_t>;
+  int64_t i = 0;
+  scalar_t sum = 0;
+  if (y_stride == 1 && n >= Vec::size()) {
+    Vec acc(0);
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      acc = vec256::fmadd(Vec::loadu(x + i), Vec::loadu(y + i), acc);
+    }
+    __at_align32__ scalar_t partial[Vec::size()];
+    acc.store(partial);
+    for (int64_t j = 0; j < Vec::size(); j++) {
+      sum += partial[j];
+    }
+  }
+  for (; i < n; i++) {
+    sum += x[i] * y[i * y_stride];
+  }
+  return sum;
+}
+
+template <typename scalar_t>
+inline vec256::Vec256<scalar_t> load_channels(const scalar_t* data, int64_t count) {
+  using Vec = vec256::Vec256<scalar_t>;
+  return count == Vec::size() ? Vec::loadu(data) : Vec::loadu(data, count);
+}
+
+template <typename scalar_t>
+inline void store_channels(const vec256::Vec256<scalar_t>& v, scalar_t* data, int64_t count) {
+  using Vec = vec256::Vec256<scalar_t>;
+  if (count == Vec::size()) {
+    v.store(data);
+  } else {
+    v.store(data, count);
+  }
+}
+
+// ---------------------------------------------------------------------
+// NCHW
+// ---------------------------------------------------------------------
+
+template <typename scalar_t>
+void conv_depthwise2d_nchw(
+    const DepthwiseConvArgs& args, const scalar_t* input_data,
+    const scalar_t* weight_data, const scalar_t* bias_data, scalar_t* output_data) {
+  const int64_t out_channels = args.channels * args.multiplier;
+  const int64_t kernel_hxw = args.kernel_h * args.kernel_w;
+  const int64_t plane_work = args.out_h * args.out_w * kernel_hxw;
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / plane_work);
+
+  at::parallel_for(0, args.batch * out_channels, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t plane = begin; plane < end; plane++) {
+      const int64_t n = plane / out_channels;
+      const int64_t oc = plane % out_channels;
+      const scalar_t* input = input_data +
+          (n * args.channels + oc / args.multiplier) * args.in_h * args.in_w;
+      const scalar_t* weight = weight_data + oc * kernel_hxw;
+      const scalar_t bias = bias_data ? bias_data[oc] : scalar_t(0);
+      for (int64_t oh = 0; oh < args.out_h; oh++) {
+        scalar_t* out = output_data + (plane * args.out_h + oh) * args.out_w;
+        std::fill(out, out + args.out_w, bias);
+        for (int64_t kh = 0; kh < args.kernel_h; kh++) {
+          const int64_t ih = oh * args.stride_h - args.pad_h + kh * args.dilation_h;
+          if (ih < 0 || ih >= args.in_h) {
+            continue;
+          }
+          for (int64_t kw = 0; kw < args.kernel_w; kw++) {
+            const int64_t offset = kw * args.dilation_w - args.pad_w;
+            int64_t ow_begin, ow_end;
+            valid_output_range(offset, args.stride_w, args.in_w, args.out_w, ow_begin, ow_end);
+            strided_axpy(
+                ow_end - ow_begin, weight[kh * args.kernel_w + kw],
+                input + ih * args.in_w + ow_begin * args.stride_w + offset, args.stride_w,
+                out + ow_begin, 1);
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void conv_depthwise2d_backward_input_nchw(
+    const DepthwiseConvArgs& args, const scalar_t* grad_output_data,
+    const scalar_t* weight_data, scalar_t* grad_input_data) {
+  const int64_t out_channels = args.channels * args.multiplier;
+  const int64_t kernel_hxw = args.kernel_h * args.kernel_w;
+  const int64_t plane_work = args.multiplier * args.out_h * args.out_w * kernel_hxw;
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / plane_work);
+
+  at::parallel_for(0, args.batch * args.channels, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t plane = begin; plane < end; plane++) {
+      const int64_t n = plane / args.channels;
+      const int64_t c = plane % args.channels;
+      scalar_t* grad_input = grad_input_data + plane * args.in_h * args.in_w;
+      std::fill(grad_input, grad_input + args.in_h * args.in_w, scalar_t(0));
+      for (int64_t j = 0; j < args.multiplier; j++) {
+        const int64_t oc = c * args.multiplier + j;
+        const scalar_t* grad_output = grad_output_data +
+            (n * out_channels + oc) * args.out_h * args.out_w;
+        const scalar_t* weight = weight_data + oc * kernel_hxw;
+        for (int64_t oh = 0; oh < args.out_h; oh++) {
+          const scalar_t* grad_out = grad_output + oh * args.out_w;
+          for (int64_t kh = 0; kh < args.kernel_h; kh++) {
+            const int64_t ih = oh * args.stride_h - args.pad_h + kh * args.dilation_h;
+            if (ih < 0 || ih >= args.in_h) {
+              continue;
+            }
+            for (int64_t kw = 0; kw < args.kernel_w; kw++) {
+              const int64_t offset = kw * args.dilation_w - args.pad_w;
+              int64_t ow_begin, ow_end;
+              valid_output_range(offset, args.stride_w, args.in_w, args.out_w, ow_begin, ow_end);
+              strided_axpy(
+                  ow_end - ow_begin, weight[kh * args.kernel_w + kw],
+                  grad_out + ow_begin, 1,
+                  grad_input + ih * args.in_w + ow_begin * args.stride_w + offset, args.stride_w);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void conv_depthwise2d_backward_weight_nchw(
+    const DepthwiseConvArgs& args, const scalar_t* grad_output_data,
+    const scalar_t* input_data, scalar_t* grad_weight_data) {
+  const int64_t out_channels = args.channels * args.multiplier;
+  const int64_t kernel_hxw = args.kernel_h * args.kernel_w;
+  const int64_t channel_work = args.batch * args.out_h * args.out_w * kernel_hxw;
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / channel_work);
+
+  at::parallel_for(0, out_channels, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t oc = begin; oc < end; oc++) {
+      const int64_t c = oc / args.multiplier;
+      for (int64_t kh = 0; kh < args.kernel_h; kh++) {
+        const int64_t offset_h = kh * args.dilation_h - args.pad_h;
+        int64_t oh_begin, oh_end;
+        valid_output_range(offset_h, args.stride_h, args.in_h, args.out_h, oh_begin, oh_end);
+        for (int64_t kw = 0; kw < args.kernel_w; kw++) {
+          const int64_t offset_w = kw * args.dilation_w - args.pad_w;
+          int64_t ow_begin, ow_end;
+          valid_output_range(offset_w, args.stride_w, args.in_w, args.out_w, ow_begin, ow_end);
+          scalar_t sum = 0;
+          for (int64_t n = 0; n < args.batch; n++) {
+            const scalar_t* grad_output = grad_output_data +
+                (n * out_channels + oc) * args.out_h * args.out_w;
+            const scalar_t* input = input_data +
+                (n * args.channels + c) * args.in_h * args.in_w;
+            for (int64_t oh = oh_begin; oh < oh_end; oh++) {
+              const int64_t ih = oh * args.stride_h + offset_h;
+              sum += strided_dot(
+                  ow_end - ow_begin,
+                  grad_output + oh * args.out_w + ow_begin,
+                  input + ih * args.in_w + ow_begin * args.stride_w + offset_w,
+                  args.stride_w);
+            }
+          }
+          grad_weight_data[oc * kernel_hxw + kh * args.kernel_w + kw] = sum;
+        }
+      }
+    }
+  });
+}
+
+// ---------------------------------------------------------------------
+// NHWC, multiplier 1; the weight is packed as [kernel_h][kernel_w][C]
+// ---------------------------------------------------------------------
+
+template <typename scalar_t>
+void conv_depthwise2d_nhwc(
+    const DepthwiseConvArgs& args, const scalar_t* input_data,
+    const scalar_t* weight_data, const scalar_t* bias_data, scalar_t* output_data) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t C = args.channels;
+  const int64_t row_work = args.out_w * C * args.kernel_h * args.kernel_w;
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / row_work);
+
+  at::parallel_for(0, args.batch * args.out_h, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      const int64_t n = row / args.out_h;
+      const int64_t oh = row % args.out_h;
+      const scalar_t* input = input_data + n * args.in_h * args.in_w * C;
+      for (int64_t ow = 0; ow < args.out_w; ow++) {
+        scalar_t* out = output_data + (row * args.out_w + ow) * C;
+        for (int64_t c0 = 0; c0 < C; c0 += Vec::size()) {
+          const int64_t count = std::min<int64_t>(Vec::size(), C - c0);
+          Vec acc = bias_data ? load_channels(bias_data + c0, count) : Vec(0);
+          for (int64_t kh = 0; kh < args.kernel_h; kh++) {
+            const int64_t ih = oh * args.stride_h - args.pad_h + kh * args.dilation_h;
+            if (ih < 0 || ih >= args.in_h) {
+              continue;
+            }
+            for (int64_t kw = 0; kw < args.kernel_w; kw++) {
+              const int64_t iw = ow * args.stride_w - args.pad_w + kw * args.dilation_w;
+              if (iw < 0 || iw >= args.in_w) {
+                continue;
+              }
+              acc = vec256::fmadd(
+                  load_channels(input + (ih * args.in_w + iw) * C + c0, count),
+                  load_channels(weight_data + (kh * args.kernel_w + kw) * C + c0, count),
+                  acc);
+            }
+          }
+          store_channels(acc, out + c0, count);
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void conv_depthwise2d_backward_input_nhwc(
+    const DepthwiseConvArgs& args, const scalar_t* grad_output_data,
+    const scalar_t* weight_data, scalar_t* grad_input_data) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t C = args.channels;
+  const int64_t row_work = args.in_w * C * args.kernel_h * args.kernel_w;
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / row_work);
+
+  at::parallel_for(0, args.batch * args.in_h, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      const int64_t n = row / args.in_h;
+      const int64_t ih = row % args.in_h;
+      const scalar_t* grad_output = grad_output_data + n * args.out_h * args.out_w * C;
+      for (int64_t iw = 0; iw < args.in_w; iw++) {
+        scalar_t* grad_in = grad_input_data + (row * args.in_w + iw) * C;
+        for (int64_t c0 = 0; c0 < C; c0 += Vec::size()) {
+          const int64_t count = std::min<int64_t>(Vec::size(), C - c0);
+          Vec acc(0);
+          for (int64_t kh = 0; kh < args.kernel_h; kh++) {
+            const int64_t h = ih + args.pad_h - kh * args.dilation_h;
+            if (h < 0 || h % args.stride_h != 0 || h / args.stride_h >= args.out_h) {
+              continue;
+            }
+            const int64_t oh = h / args.stride_h;
+            for (int64_t kw = 0; kw < args.kernel_w; kw++) {
+              const int64_t w = iw + args.pad_w - kw * args.dilation_w;
+              if (w < 0 || w % args.stride_w != 0 || w / args.stride_w >= args.out_w) {
+                continue;
+              }
+              const int64_t ow = w / args.stride_w;
+              acc = vec256::fmadd(
+                  load_channels(grad_output + (oh * args.out_w + ow) * C + c0, count),
+                  load_channels(weight_data + (kh * args.kernel_w + kw) * C + c0, count),
+                  acc);
+            }
+          }
+          store_channels(acc, grad_in + c0, count);
+        }
+      }
+    }
+  });
+}
+
+// Every task accumulates one kernel row of one block of channels, over the
+// whole batch, into the zero initialized packed gradient.
+template <typename scalar_t>
+void conv_depthwise2d_backward_weight_nhwc(
+    const DepthwiseConvArgs& args, const scalar_t* grad_output_data,
+    const scalar_t* input_data, scalar_t* grad_weight_data) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t C = args.channels;
+  const int64_t num_blocks = divup(C, Vec::size());
+  const int64_t task_work = args.batch * args.out_h * args.out_w * args.kernel_w * Vec::size();
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / task_work);
+
+  at::parallel_for(0, args.kernel_h * num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t task = begin; task < end; task++) {
+      const int64_t kh = task / num_blocks;
+      const int64_t c0 = (task % num_blocks) * Vec::size();
+      const int64_t count = std::min<int64_t>(Vec::size(), C - c0);
+      const int64_t offset_h = kh * args.dilation_h - args.pad_h;
+      int64_t oh_begin, oh_end;
+      valid_output_range(offset_h, args.stride_h, args.in_h, args.out_h, oh_begin, oh_end);
+      scalar_t* grad_weight = grad_weight_data + kh * args.kernel_w * C + c0;
+      for (int64_t n = 0; n < args.batch; n++) {
+        for (int64_t oh = oh_begin; oh < oh_end; oh++) {
+          const int64_t ih = oh * args.stride_h + offset_h;
+          const scalar_t* grad_out = grad_output_data + ((n * args.out_h + oh) * args.out_w) * C + c0;
+          const scalar_t* input = input_data + ((n * args.in_h + ih) * args.in_w) * C + c0;
+          for (int64_t kw = 0; kw < args.kernel_w; kw++) {
+            const int64_t offset_w = kw * args.dilation_w - args.pad_w;
+            int64_t ow_begin, ow_end;
+            valid_output_range(offset_w, args.stride_w, args.in_w, args.out_w, ow_begin, ow_end);
+            Vec acc = load_channels(grad_weight + kw * C, count);
+            for (int64_t ow = ow_begin; ow < ow_end; ow++) {
+              const int64_t iw = ow * args.stride_w + offset_w;
+              acc = vec256::fmadd(
+                  load_channels(grad_out + ow * C, count),
+                  load_channels(input + iw * C, count),
+                  acc);
+            }
+            store_channels(acc, grad_weight + kw * C, count);
+          }
+        }
+      }
+    }
+  });
+}
+
+// ---------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------
+
+// [C * multiplier, 1, kernel_h, kernel_w] to [kernel_h, kernel_w, C]
+Tensor pack_weight_nhwc(const Tensor& weight) {
+  return weight.permute({2, 3, 0, 1}).contiguous();
+}
+
+void conv_depthwise2d_kernel(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation) {
+  const auto args = make_args(
+      input.sizes(), output.sizes(), weight.sizes(), stride, padding, dilation);
+  const bool nchw = input.is_contiguous() && output.is_contiguous();
+  TORCH_INTERNAL_ASSERT(
+      nchw || (args.multiplier == 1 &&
+               input.is_contiguous(at::MemoryFormat::ChannelsLast) &&
+               output.is_contiguous(at::MemoryFormat::ChannelsLast)));
+  const Tensor weight_c = nchw ? weight.contiguous() : pack_weight_nhwc(weight);
+  const Tensor bias_c = bias.defined() ? bias.contiguous() : bias;
+
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "conv_depthwise2d_cpu", [&] {
+    const scalar_t* bias_data = bias_c.defined() ? bias_c.data_ptr<scalar_t>() : nullptr;
+    if (nchw) {
+      conv_depthwise2d_nchw<scalar_t>(
+          args, input.data_ptr<scalar_t>(), weight_c.data_ptr<scalar_t>(),
+          bias_data, output.data_ptr<scalar_t>());
+    } else {
+      conv_depthwise2d_nhwc<scalar_t>(
+          args, input.data_ptr<scalar_t>(), weight_c.data_ptr<scalar_t>(),
+          bias_data, output.data_ptr<scalar_t>());
+    }
+  });
+}
+
+void conv_depthwise2d_backward_input_kernel(
+    Tensor& grad_input, const Tensor& grad_output, const Tensor& weight,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation) {
+  const auto args = make_args(
+      grad_input.sizes(), grad_output.sizes(), weight.sizes(), stride, padding, dilation);
+  const bool nchw = grad_input.is_contiguous() && grad_output.is_contiguous();
+  TORCH_INTERNAL_ASSERT(
+      nchw || (args.multiplier == 1 &&
+               grad_input.is_contiguous(at::MemoryFormat::ChannelsLast) &&
+               grad_output.is_contiguous(at::MemoryFormat::ChannelsLast)));
+  const Tensor weight_c = nchw ? weight.contiguous() : pack_weight_nhwc(weight);
+
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "conv_depthwise2d_backward_input_cpu", [&] {
+    if (nchw) {
+      conv_depthwise2d_backward_input_nchw<scalar_t>(
+          args, grad_output.data_ptr<scalar_t>(), weight_c.data_ptr<scalar_t>(),
+          grad_input.data_ptr<scalar_t>());
+    } else {
+      conv_depthwise2d_backward_input_nhwc<scalar_t>(
+          args, grad_output.data_ptr<scalar_t>(), weight_c.data_ptr<scalar_t>(),
+          grad_input.data_ptr<scalar_t>());
+    }
+  });
+}
+
+void conv_depthwise2d_backward_weight_kernel(
+    Tensor& grad_weight, const Tensor& grad_output, const Tensor& input,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation) {
+  const auto args = make_args(
+      input.sizes(), grad_output.sizes(), grad_weight.sizes(), stride, padding, dilation);
+  const bool nchw = input.is_contiguous() && grad_output.is_contiguous();
+  TORCH_INTERNAL_ASSERT(grad_weight.is_contiguous());
+  TORCH_INTERNAL_ASSERT(
+      nchw || (args.multiplier == 1 &&
+               input.is_contiguous(at::MemoryFormat::ChannelsLast) &&
+               grad_output.is_contiguous(at::MemoryFormat::ChannelsLast)));
+
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "conv_depthwise2d_backward_weight_cpu", [&] {
+    if (nchw) {
+      conv_depthwise2d_backward_weight_nchw<scalar_t>(
+          args, grad_output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(),
+          grad_weight.data_ptr<scalar_t>());
+    } else {
+      Tensor grad_weight_packed = at::zeros(
+          {args.kernel_h, args.kernel_w, args.channels}, grad_weight.options());
+      conv_depthwise2d_backward_weight_nhwc<scalar_t>(
+          args, grad_output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(),
+          grad_weight_packed.data_ptr<scalar_t>());
+      grad_weight.copy_(grad_weight_packed.permute({2, 0, 1}).unsqueeze(1));
+    }
+  });
+}
+
+}  // namespace
+
+REGISTER_DISPATCH(conv_depthwise2d_stub, &conv_depthwise2d_kernel);
+REGISTER_DISPATCH(conv_depthwise2d_backward_input_stub, &conv_depthwise2d_backward_input_kernel);
+REGISTER_DISPATCH(conv_depthwise2d_backward_weight_stub, &conv_depthwise2d_backward_weight_kernel);
+
+}  // namespace native
+}  // namespace at
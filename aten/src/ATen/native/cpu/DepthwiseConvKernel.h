@@ -4,7 +4,9 @@
 #include <ATen/native/DispatchStub.h>
 
 /*
-  Depthwise 3x3 Winograd convolution operator
+  Depthwise 3x3 Winograd convolution operator, and the direct depthwise
+  conv2d kernels behind thnn_conv_depthwise2d on CPU, see
+  Note [CPU depthwise conv2d] in DepthwiseConv2dKernel.cpp
 */
 
 namespace at {
@@ -15,5 +17,23 @@ using convolution_depthwise3x3_winograd_fn =
 
 DECLARE_DISPATCH(convolution_depthwise3x3_winograd_fn, convolution_depthwise3x3_winograd_stub);
 
+// The direct kernels take float or double tensors that are either all
+// contiguous or all channels last, the latter only without a depthwise
+// multiplier, and write into outputs allocated with the sizes and memory
+// format of the result. The bias may be undefined.
+using conv_depthwise2d_fn =
+    void (*)(Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+             IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation);
+using conv_depthwise2d_backward_input_fn =
+    void (*)(Tensor& grad_input, const Tensor& grad_output, const Tensor& weight,
+             IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation);
+using conv_depthwise2d_backward_weight_fn =
+    void (*)(Tensor& grad_weight, const Tensor& grad_output, const Tensor& input,
+             IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation);
+
+DECLARE_DISPATCH(conv_depthwise2d_fn, conv_depthwise2d_stub);
+DECLARE_DISPATCH(conv_depthwise2d_backward_input_fn, conv_depthwise2d_backward_input_stub);
+DECLARE_DISPATCH(conv_depthwise2d_backward_weight_fn, conv_depthwise2d_backward_weight_stub);
+
 }  // namespace native
 }  // namespace at
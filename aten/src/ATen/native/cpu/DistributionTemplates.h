@@ -1,10 +1,15 @@
 #pragma once
 
+#include <ATen/Context.h>
 #include <ATen/Dispatch.h>
 #include <ATen/CPUApplyUtils.h>
+#include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
+#include <ATen/core/PhiloxRNGEngine.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <algorithm>
 #include <limits>
 #include <mutex>
 
@@ -81,6 +86,111 @@ struct RandomKernel {
   }
 };
 
+// ================================================== Parallel ========================================================
+
+/**
+ * Note [Parallel CPU random numbers]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * The kernels in this file draw from the generator a number at a time under
+ * its mutex, so filling a tensor runs on a single thread. With
+ * at::globalContext().parallelCPURNG() set, uniform_ and normal_ of contiguous
+ * float and double tensors, bernoulli_ with a scalar p of any contiguous
+ * tensor, and _multinomial_alias_draw, are filled with parallel_for instead:
+ * the op takes a single random64() from the generator as the key of a philox
+ * stream (ATen/core/PhiloxRNGEngine.h), and element i is computed from the
+ * numbers at position i * philox_randoms_per_element of the stream.
+ * Philox starts anywhere in its stream at no cost, so each chunk starts at
+ * its first element, and the output depends on the seed alone, not on the
+ * number of threads.
+ *
+ * The numbers differ from the ones the sequential kernels draw. As the
+ * generator only advances by the key, its state, manual_seed and fork_rng
+ * work as before.
+ */
+
+template <typename scalar_t>
+constexpr int philox_randoms_per_element() {
+  return sizeof(scalar_t) > sizeof(uint32_t) ? 2 : 1;
+}
+
+// Calls f(i, bits) for each i in [begin, end), where bits are the
+// randoms_per_element 32 bit numbers of element i of the philox stream of key.
+template <int randoms_per_element, typename func_t>
+void philox_for_each(int64_t begin, int64_t end, uint64_t key, const func_t& f) {
+  const uint64_t first = static_cast<uint64_t>(begin) * randoms_per_element;
+  at::philox_engine engine(key, /*subsequence=*/0, /*offset=*/first / 4);
+  for (uint64_t skip = 0; skip < first % 4; skip++) {
+    engine();
+  }
+  for (int64_t i = begin; i < end; i++) {
+    uint64_t bits = engine();
+    for (int r = 1; r < randoms_per_element; r++) {
+      bits = (bits << 32) | engine();
+    }
+    f(i, bits);
+  }
+}
+
+template<typename RNG>
+uint64_t philox_key(RNG generator) {
+  // See Note [Acquire lock when using random generators]
+  std::lock_guard<std::mutex> lock(generator->mutex_);
+  return generator->random64();
+}
+
+template <typename scalar_t>
+void uniform_fill_parallel(scalar_t* data, int64_t size, scalar_t from, scalar_t to, uint64_t key) {
+  at::parallel_for(0, size, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    philox_for_each<philox_randoms_per_element<scalar_t>()>(begin, end, key, [&](int64_t i, uint64_t bits) {
+      data[i] = static_cast<scalar_t>(transformation::uniform_real<scalar_t>(bits, from, to));
+    });
+  });
+}
+
+// The Box-Muller transform of normal_fill_16 on Vec256.
+template <typename scalar_t>
+void normal_fill_16_vec(scalar_t *data, const scalar_t mean, const scalar_t std) {
+  using Vec = vec256::Vec256<scalar_t>;
+  static_assert(8 % Vec::size() == 0, "normal_fill_16_vec needs whole vectors");
+  for (int64_t j = 0; j < 8; j += Vec::size()) {
+    const Vec u1 = Vec(1) - Vec::loadu(data + j); // [0, 1) -> (0, 1] for log.
+    const Vec u2 = Vec::loadu(data + j + 8);
+    const Vec radius = (u1.log() * Vec(-2)).sqrt();
+    const Vec theta = u2 * Vec(2.0 * M_PI);
+    (radius * theta.cos() * Vec(std) + Vec(mean)).store(data + j);
+    (radius * theta.sin() * Vec(std) + Vec(mean)).store(data + j + 8);
+  }
+}
+
+// The pairs of the transform are taken within blocks of 16 elements, like
+// normal_fill does, and the blocks are split between threads, so that the
+// pairs don't depend on the chunks either.
+template <typename scalar_t>
+void normal_fill_parallel(scalar_t* data, int64_t size, scalar_t mean, scalar_t std, uint64_t key) {
+  const int64_t num_blocks = (size + 15) / 16;
+  at::parallel_for(0, num_blocks, internal::GRAIN_SIZE / 16, [&](int64_t begin, int64_t end) {
+    scalar_t block[16];
+    for (int64_t b = begin; b < end; b++) {
+      const int64_t offset = b * 16;
+      philox_for_each<philox_randoms_per_element<scalar_t>()>(offset, offset + 16, key, [&](int64_t i, uint64_t bits) {
+        block[i - offset] = static_cast<scalar_t>(
+            transformation::uniform_real<scalar_t>(bits, static_cast<scalar_t>(0), static_cast<scalar_t>(1)));
+      });
+      normal_fill_16_vec<scalar_t>(block, mean, std);
+      std::copy(block, block + std::min<int64_t>(16, size - offset), data + offset);
+    }
+  });
+}
+
+template <typename scalar_t>
+void bernoulli_fill_parallel(scalar_t* data, int64_t size, double p, uint64_t key) {
+  at::parallel_for(0, size, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    philox_for_each<2>(begin, end, key, [&](int64_t i, uint64_t bits) {
+      data[i] = static_cast<scalar_t>(transformation::uniform_real<double>(bits, 0.0, 1.0) < p);
+    });
+  });
+}
+
 // ==================================================== Normal ========================================================
 
 #ifdef CPU_CAPABILITY_AVX2
@@ -173,7 +283,14 @@ void normal_fill(Tensor& self, const scalar_t mean, const scalar_t std, RNG gene
 template<typename RNG>
 void normal_kernel(Tensor& self, double mean, double std, RNG generator) {
   auto size = self.numel();
-  if (self.scalar_type() == ScalarType::Float && size >= 16 && self.is_contiguous()) {
+  if (globalContext().parallelCPURNG() && self.is_contiguous() &&
+      (self.scalar_type() == ScalarType::Float || self.scalar_type() == ScalarType::Double)) {
+    // See Note [Parallel CPU random numbers]
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "normal_kernel_cpu", [&] {
+      normal_fill_parallel<scalar_t>(self.data_ptr<scalar_t>(), size,
+          static_cast<scalar_t>(mean), static_cast<scalar_t>(std), philox_key(generator));
+    });
+  } else if (self.scalar_type() == ScalarType::Float && size >= 16 && self.is_contiguous()) {
 #ifdef CPU_CAPABILITY_AVX2
     normal_fill_AVX2(self, static_cast<float>(mean), static_cast<float>(std), generator);
 #else
@@ -208,6 +325,15 @@ struct NormalKernel {
 
 template<typename RNG>
 void uniform_kernel(TensorIterator& iter, double from_, double to_, RNG generator) {
+  if (globalContext().parallelCPURNG() && iter.is_contiguous() &&
+      (iter.dtype() == ScalarType::Float || iter.dtype() == ScalarType::Double)) {
+    // See Note [Parallel CPU random numbers]
+    AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "uniform_kernel_cpu", [&]() {
+      uniform_fill_parallel<scalar_t>(static_cast<scalar_t*>(iter.data_ptr(0)), iter.numel(),
+          static_cast<scalar_t>(from_), static_cast<scalar_t>(to_), philox_key(generator));
+    });
+    return;
+  }
   AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, iter.dtype(), "uniform_kernel_cpu", [&]() {
     std::lock_guard<std::mutex> lock(generator->mutex_);
     auto from = static_cast<scalar_t>(from_);
@@ -339,6 +465,13 @@ void bernoulli_kernel(Tensor& self, const Tensor& p_, RNG generator) {
 
 template<typename RNG>
 void bernoulli_kernel(Tensor& self, double p, RNG generator) {
+  if (globalContext().parallelCPURNG() && self.is_contiguous()) {
+    // See Note [Parallel CPU random numbers]
+    AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
+      bernoulli_fill_parallel<scalar_t>(self.data_ptr<scalar_t>(), self.numel(), p, philox_key(generator));
+    });
+    return;
+  }
   AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(generator->mutex_);
@@ -0,0 +1,89 @@
+#include <ATen/native/IncrementalAttention.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+
+namespace at { namespace native { namespace {
+
+template <typename scalar_t>
+void apply_incremental_attention(
+    Tensor& out,
+    const Tensor& query,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    double scale) {
+  // float accumulation for the reduced precision types, as on CUDA
+  using acc_t = typename std::conditional<
+      std::is_same<scalar_t, double>::value, double, float>::type;
+  const int64_t steps = key_cache.size(0);
+  const int64_t batch = key_cache.size(1);
+  const int64_t key_dim = key_cache.size(2);
+  const int64_t value_dim = value_cache.size(2);
+  const scalar_t* query_data = query.data_ptr<scalar_t>();
+  const scalar_t* key_data = key_cache.data_ptr<scalar_t>();
+  const scalar_t* value_data = value_cache.data_ptr<scalar_t>();
+  scalar_t* out_data = out.data_ptr<scalar_t>();
+  const acc_t scale_ = static_cast<acc_t>(scale);
+
+  const int64_t grain_size = std::max<int64_t>(
+      1, internal::GRAIN_SIZE / (steps * (key_dim + value_dim)));
+  parallel_for(0, batch, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<acc_t> scores(steps);
+    std::vector<acc_t> acc(value_dim);
+    for (int64_t n = begin; n < end; n++) {
+      const scalar_t* q = query_data + n * key_dim;
+      acc_t max_score = -std::numeric_limits<acc_t>::infinity();
+      for (int64_t t = 0; t < steps; t++) {
+        const scalar_t* k = key_data + (t * batch + n) * key_dim;
+        acc_t dot = 0;
+        for (int64_t d = 0; d < key_dim; d++) {
+          dot += static_cast<acc_t>(q[d]) * static_cast<acc_t>(k[d]);
+        }
+        scores[t] = dot * scale_;
+        max_score = std::max(max_score, scores[t]);
+      }
+
+      // The exponentials and the weighted sum of the values in one pass,
+      // normalized at the end
+      std::fill(acc.begin(), acc.end(), acc_t(0));
+      acc_t sum = 0;
+      for (int64_t t = 0; t < steps; t++) {
+        const acc_t p = std::exp(scores[t] - max_score);
+        sum += p;
+        const scalar_t* v = value_data + (t * batch + n) * value_dim;
+        for (int64_t d = 0; d < value_dim; d++) {
+          acc[d] += p * static_cast<acc_t>(v[d]);
+        }
+      }
+      scalar_t* o = out_data + n * value_dim;
+      for (int64_t d = 0; d < value_dim; d++) {
+        o[d] = static_cast<scalar_t>(acc[d] / sum);
+      }
+    }
+  });
+}
+
+void incremental_attention_kernel(
+    Tensor& out,
+    const Tensor& query,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    double scale) {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      kBFloat16, query.scalar_type(), "incremental_attention_cpu", [&] {
+        apply_incremental_attention<scalar_t>(
+            out, query, key_cache, value_cache, scale);
+      });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(incremental_attention_stub, &incremental_attention_kernel);
+
+}} // namespace at::native
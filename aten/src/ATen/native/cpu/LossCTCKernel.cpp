@@ -0,0 +1,85 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/native/cpu/LossCTCKernel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+
+namespace {
+
+template <typename scalar_t>
+void ctc_loss_log_add_exp3_impl(
+    int64_t n,
+    const scalar_t* a,
+    const scalar_t* b,
+    const scalar_t* c,
+    const scalar_t* c_mask,
+    const scalar_t* emit,
+    scalar_t* out) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec neginf(-std::numeric_limits<scalar_t>::infinity());
+  const Vec zero(0);
+  for (int64_t s = 0; s < n; s += Vec::size()) {
+    // The lanes past n are loaded as zeros and not stored
+    const int64_t count = std::min<int64_t>(Vec::size(), n - s);
+    const Vec va = Vec::loadu(a + s, count);
+    const Vec vb = Vec::loadu(b + s, count);
+    const Vec vc = Vec::loadu(c + s, count) + Vec::loadu(c_mask + s, count);
+    Vec vmax = vec256::maximum(vec256::maximum(va, vb), vc);
+    // cannot do neginf-neginf
+    vmax = Vec::blendv(vmax, zero, vmax == neginf);
+    const Vec sum = (va - vmax).exp() + (vb - vmax).exp() + (vc - vmax).exp();
+    (sum.log() + vmax + Vec::loadu(emit + s, count)).store(out + s, count);
+  }
+}
+
+void ctc_loss_log_add_exp3_kernel(
+    ScalarType dtype,
+    int64_t n,
+    const void* a,
+    const void* b,
+    const void* c,
+    const void* c_mask,
+    const void* emit,
+    void* out) {
+  AT_DISPATCH_FLOATING_TYPES(dtype, "ctc_loss_log_add_exp3", [&] {
+    ctc_loss_log_add_exp3_impl<scalar_t>(
+        n,
+        static_cast<const scalar_t*>(a),
+        static_cast<const scalar_t*>(b),
+        static_cast<const scalar_t*>(c),
+        static_cast<const scalar_t*>(c_mask),
+        static_cast<const scalar_t*>(emit),
+        static_cast<scalar_t*>(out));
+  });
+}
+
+void ctc_loss_grad_kernel(
+    ScalarType dtype,
+    int64_t n,
+    const void* log_probs,
+    double nll,
+    double grad_out,
+    void* grad) {
+  AT_DISPATCH_FLOATING_TYPES(dtype, "ctc_loss_grad", [&] {
+    using Vec = vec256::Vec256<scalar_t>;
+    const auto* lp = static_cast<const scalar_t*>(log_probs);
+    auto* res = static_cast<scalar_t*>(grad);
+    const Vec vnll(static_cast<scalar_t>(nll));
+    const Vec vgr(static_cast<scalar_t>(grad_out));
+    for (int64_t i = 0; i < n; i += Vec::size()) {
+      const int64_t count = std::min<int64_t>(Vec::size(), n - i);
+      const Vec vlp = Vec::loadu(lp + i, count);
+      const Vec vres = Vec::loadu(res + i, count);
+      ((vlp.exp() - (vres + vnll - vlp).exp()) * vgr).store(res + i, count);
+    }
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(ctc_loss_log_add_exp3_stub, &ctc_loss_log_add_exp3_kernel);
+REGISTER_DISPATCH(ctc_loss_grad_stub, &ctc_loss_grad_kernel);
+
+}}  // namespace at::native
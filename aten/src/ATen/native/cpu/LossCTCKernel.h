@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// One step of the alpha or beta recursion of the CTC loss over n positions s
+// of the extended target:
+//   out[s] = log(exp(a[s]) + exp(b[s]) + exp(c[s] + c_mask[s])) + emit[s]
+// c_mask is 0 where the transition of c is allowed and -inf where it is not.
+// The pointers are to ScalarType elements, out doesn't alias the inputs.
+using ctc_loss_log_add_exp3_fn = void(*)(
+    ScalarType, int64_t n, const void* a, const void* b, const void* c,
+    const void* c_mask, const void* emit, void* out);
+// Wraps up the gradient of the CTC loss over n labels of a time step:
+//   grad[i] = (exp(log_probs[i]) - exp(grad[i] + nll - log_probs[i])) * grad_out
+using ctc_loss_grad_fn = void(*)(
+    ScalarType, int64_t n, const void* log_probs, double nll, double grad_out,
+    void* grad);
+
+DECLARE_DISPATCH(ctc_loss_log_add_exp3_fn, ctc_loss_log_add_exp3_stub);
+DECLARE_DISPATCH(ctc_loss_grad_fn, ctc_loss_grad_stub);
+
+}}  // namespace at::native
@@ -0,0 +1,121 @@
+#include <ATen/native/PointwiseChain.h>
+
+#include <cstring>
+
+#include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/TensorIterator.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+using namespace vec256;
+
+// Elements per block. Every op in the chain runs over a block before the
+// next block is loaded, so the block buffers stay in L1.
+constexpr int64_t kPointwiseChainBlock = 256;
+
+template <typename scalar_t>
+void load_block(scalar_t* dst, const char* src, int64_t stride, int64_t n) {
+  if (stride == sizeof(scalar_t)) {
+    std::memcpy(dst, src, n * sizeof(scalar_t));
+  } else if (stride == 0) {
+    std::fill(dst, dst + n, *reinterpret_cast<const scalar_t*>(src));
+  } else {
+    for (int64_t i = 0; i < n; i++) {
+      dst[i] = *reinterpret_cast<const scalar_t*>(src + i * stride);
+    }
+  }
+}
+
+template <typename scalar_t>
+void store_block(char* dst, int64_t stride, const scalar_t* src, int64_t n) {
+  if (stride == sizeof(scalar_t)) {
+    std::memcpy(dst, src, n * sizeof(scalar_t));
+  } else {
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<scalar_t*>(dst + i * stride) = src[i];
+    }
+  }
+}
+
+// acc = op(acc, other) over n elements
+template <typename scalar_t>
+void apply_op(const PointwiseOp& op, scalar_t* acc, const scalar_t* other, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  const Vec scalar(op.scalar.to<scalar_t>());
+  const Vec zero(static_cast<scalar_t>(0));
+  const Vec one(static_cast<scalar_t>(1));
+  for (int64_t i = 0; i < n; i += Vec::size()) {
+    const int64_t count = std::min(n - i, (int64_t)Vec::size());
+    Vec a = Vec::loadu(acc + i, count);
+    Vec b = other ? Vec::loadu(other + i, count) : zero;
+    switch (op.kind) {
+      case PointwiseOpKind::ADD:
+        a = vec256::fmadd(b, scalar, a);
+        break;
+      case PointwiseOpKind::SUB:
+        a = a - b * scalar;
+        break;
+      case PointwiseOpKind::MUL:
+        a = a * b;
+        break;
+      case PointwiseOpKind::DIV:
+        a = a / b;
+        break;
+      case PointwiseOpKind::ADD_SCALAR:
+        a = a + scalar;
+        break;
+      case PointwiseOpKind::MUL_SCALAR:
+        a = a * scalar;
+        break;
+      case PointwiseOpKind::RELU:
+        a = vec256::maximum(a, zero);
+        break;
+      case PointwiseOpKind::SIGMOID:
+        a = (one + (zero - a).exp()).reciprocal();
+        break;
+      case PointwiseOpKind::TANH:
+        a = a.tanh();
+        break;
+    }
+    a.store(acc + i, count);
+  }
+}
+
+void pointwise_chain_kernel(TensorIterator& iter, ArrayRef<PointwiseOp> ops) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "pointwise_chain_cpu", [&]() {
+    const int ntensors = iter.ntensors();
+    iter.for_each([&](char** data, const int64_t* strides, int64_t size0, int64_t size1) {
+      scalar_t acc[kPointwiseChainBlock];
+      scalar_t other[kPointwiseChainBlock];
+      for (int64_t j = 0; j < size1; j++) {
+        for (int64_t begin = 0; begin < size0; begin += kPointwiseChainBlock) {
+          const int64_t n = std::min(size0 - begin, kPointwiseChainBlock);
+          auto ptr = [&](int arg) {
+            return data[arg] + j * strides[ntensors + arg] + begin * strides[arg];
+          };
+          load_block(acc, ptr(1), strides[1], n);
+          for (const auto& op : ops) {
+            const scalar_t* operand = nullptr;
+            if (op.input >= 0) {
+              load_block(other, ptr(op.input + 1), strides[op.input + 1], n);
+              operand = other;
+            }
+            apply_op(op, acc, operand, n);
+          }
+          store_block(ptr(0), strides[0], acc, n);
+        }
+      }
+    });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(pointwise_chain_stub, &pointwise_chain_kernel);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,511 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/Pool.h>
+#include <ATen/native/cpu/utils.h>
+
+namespace at {
+namespace native {
+namespace {
+
+// Channels last pooling: every output pixel reduces whole rows of channels,
+// which are contiguous, so the loops over channels run on Vec256. Forward
+// kernels parallelize over output pixels. Backward kernels scatter into
+// overlapping windows of grad_input and parallelize over the batch only.
+
+template <typename scalar_t>
+void cpu_max_pool2d_channels_last(
+    Tensor& output_,
+    Tensor& indices_,
+    const Tensor& input_,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  auto input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto output = output_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto indices = indices_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  auto input_data = input.data_ptr<scalar_t>();
+  auto output_data = output.data_ptr<scalar_t>();
+  auto indices_data = indices.data_ptr<int64_t>();
+
+  int64_t nbatch = input.size(0);
+  int64_t channels = input.size(1);
+  int64_t input_height = input.size(2);
+  int64_t input_width = input.size(3);
+  int64_t output_height = output.size(2);
+  int64_t output_width = output.size(3);
+
+  using Vec = vec256::Vec256<scalar_t>;
+  auto loop = [&](int64_t begin, int64_t end) {
+    int64_t n = 0;
+    int64_t oh = 0;
+    int64_t ow = 0;
+    data_index_init(begin, n, nbatch, oh, output_height, ow, output_width);
+
+    for (int64_t i = begin; i < end; i++) {
+      int64_t hstart = oh * dH - padH;
+      int64_t wstart = ow * dW - padW;
+      int64_t hend = std::min(hstart + (kH - 1) * dilationH + 1, input_height);
+      int64_t wend = std::min(wstart + (kW - 1) * dilationW + 1, input_width);
+      while (hstart < 0)
+        hstart += dilationH;
+      while (wstart < 0)
+        wstart += dilationW;
+
+      scalar_t* out = output_data + i * channels;
+      int64_t* ind = indices_data + i * channels;
+      std::fill(out, out + channels, -std::numeric_limits<scalar_t>::infinity());
+      std::fill(ind, ind + channels, hstart * input_width + wstart);
+
+      const scalar_t* input_n = input_data + n * input_height * input_width * channels;
+      for (int64_t y = hstart; y < hend; y += dilationH) {
+        for (int64_t x = wstart; x < wend; x += dilationW) {
+          int64_t index = y * input_width + x;
+          const scalar_t* in = input_n + index * channels;
+          int64_t d = 0;
+          for (; d < channels - (channels % Vec::size()); d += Vec::size()) {
+            Vec val = Vec::loadu(in + d);
+            Vec max_val = Vec::loadu(out + d);
+            // same as the contiguous kernel: a NaN wins and stays
+            Vec mask = (val > max_val) | val.isnan();
+            int unchanged = mask.zero_mask();
+            if (unchanged == (1 << Vec::size()) - 1) {
+              continue;
+            }
+            Vec::blendv(max_val, val, mask).store(out + d);
+            for (int64_t l = 0; l < Vec::size(); l++) {
+              if (!(unchanged & (1 << l))) {
+                ind[d + l] = index;
+              }
+            }
+          }
+          for (; d < channels; d++) {
+            scalar_t val = in[d];
+            if ((val > out[d]) || std::isnan(val)) {
+              out[d] = val;
+              ind[d] = index;
+            }
+          }
+        }
+      }
+      data_index_step(n, nbatch, oh, output_height, ow, output_width);
+    }
+  };
+  at::parallel_for(0, nbatch * output_height * output_width, at::internal::GRAIN_SIZE / channels, loop);
+
+  if (!output_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    output_.copy_(output);
+  }
+  if (!indices_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    indices_.copy_(indices);
+  }
+}
+
+template <typename scalar_t>
+void cpu_max_pool2d_backward_channels_last(
+    Tensor& grad_input_,
+    const Tensor& grad_output_,
+    const Tensor& indices_) {
+  auto grad_output = grad_output_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto indices = indices_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto grad_input = grad_input_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  auto grad_input_data = grad_input.data_ptr<scalar_t>();
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+  auto indices_data = indices.data_ptr<int64_t>();
+
+  int64_t nbatch = grad_input.size(0);
+  int64_t channels = grad_input.size(1);
+  int64_t input_image_size = grad_input.size(2) * grad_input.size(3);
+  int64_t output_image_size = grad_output.size(2) * grad_output.size(3);
+
+  at::parallel_for(0, nbatch, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t n = begin; n < end; n++) {
+      scalar_t* grad_input_n = grad_input_data + n * input_image_size * channels;
+      for (int64_t i = 0; i < output_image_size; i++) {
+        const scalar_t* grad_out = grad_output_data + (n * output_image_size + i) * channels;
+        const int64_t* ind = indices_data + (n * output_image_size + i) * channels;
+        for (int64_t d = 0; d < channels; d++) {
+          int64_t maxp = ind[d];
+          if (maxp != -1) {
+            grad_input_n[maxp * channels + d] += grad_out[d];
+          }
+        }
+      }
+    }
+  });
+
+  if (!grad_input_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    grad_input_.copy_(grad_input);
+  }
+}
+
+// Window of the output pixel (oh, ow) clipped to the input, and the divisor
+// of its average, as in avg_pool2d_out_frame
+struct AvgPoolWindow {
+  int64_t hstart, hend, wstart, wend;
+  int64_t divide_factor;
+};
+
+inline AvgPoolWindow avg_pool2d_window(
+    int64_t oh, int64_t ow,
+    int64_t input_height, int64_t input_width,
+    int kW, int kH, int dW, int dH, int padW, int padH,
+    bool count_include_pad, c10::optional<int64_t> divisor_override) {
+  AvgPoolWindow w;
+  w.hstart = oh * dH - padH;
+  w.wstart = ow * dW - padW;
+  w.hend = std::min(w.hstart + kH, input_height + padH);
+  w.wend = std::min(w.wstart + kW, input_width + padW);
+  int64_t pool_size = (w.hend - w.hstart) * (w.wend - w.wstart);
+  w.hstart = std::max(w.hstart, (int64_t) 0);
+  w.wstart = std::max(w.wstart, (int64_t) 0);
+  w.hend = std::min(w.hend, input_height);
+  w.wend = std::min(w.wend, input_width);
+
+  if (divisor_override.has_value()) {
+    w.divide_factor = divisor_override.value();
+  } else if (count_include_pad) {
+    w.divide_factor = pool_size;
+  } else {
+    w.divide_factor = (w.hend - w.hstart) * (w.wend - w.wstart);
+  }
+  return w;
+}
+
+// out[0:size] += in[0:size]
+template <typename scalar_t>
+inline void add_row(scalar_t* out, const scalar_t* in, int64_t size) {
+  using Vec = vec256::Vec256<scalar_t>;
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec out_vec = Vec::loadu(out + d) + Vec::loadu(in + d);
+    out_vec.store(out + d);
+  }
+  for (; d < size; d++) {
+    out[d] += in[d];
+  }
+}
+
+// out[0:size] += in[0:size] / divisor
+template <typename scalar_t>
+inline void add_row_div(scalar_t* out, const scalar_t* in, scalar_t divisor, int64_t size) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec divisor_vec(divisor);
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec out_vec = Vec::loadu(out + d) + Vec::loadu(in + d) / divisor_vec;
+    out_vec.store(out + d);
+  }
+  for (; d < size; d++) {
+    out[d] += in[d] / divisor;
+  }
+}
+
+// out[0:size] /= divisor
+template <typename scalar_t>
+inline void div_row(scalar_t* out, scalar_t divisor, int64_t size) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec divisor_vec(divisor);
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec out_vec = Vec::loadu(out + d) / divisor_vec;
+    out_vec.store(out + d);
+  }
+  for (; d < size; d++) {
+    out[d] /= divisor;
+  }
+}
+
+template <typename scalar_t>
+void cpu_avg_pool2d_channels_last(
+    Tensor& output_,
+    const Tensor& input_,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  auto input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto output = output_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  auto input_data = input.data_ptr<scalar_t>();
+  auto output_data = output.data_ptr<scalar_t>();
+
+  int64_t nbatch = input.size(0);
+  int64_t channels = input.size(1);
+  int64_t input_height = input.size(2);
+  int64_t input_width = input.size(3);
+  int64_t output_height = output.size(2);
+  int64_t output_width = output.size(3);
+
+  auto loop = [&](int64_t begin, int64_t end) {
+    int64_t n = 0;
+    int64_t oh = 0;
+    int64_t ow = 0;
+    data_index_init(begin, n, nbatch, oh, output_height, ow, output_width);
+
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* out = output_data + i * channels;
+      std::fill(out, out + channels, scalar_t(0));
+
+      auto w = avg_pool2d_window(
+          oh, ow, input_height, input_width,
+          kW, kH, dW, dH, padW, padH, count_include_pad, divisor_override);
+      if (w.hstart < w.hend && w.wstart < w.wend) {
+        const scalar_t* input_n = input_data + n * input_height * input_width * channels;
+        for (int64_t y = w.hstart; y < w.hend; y++) {
+          for (int64_t x = w.wstart; x < w.wend; x++) {
+            add_row(out, input_n + (y * input_width + x) * channels, channels);
+          }
+        }
+        div_row(out, static_cast<scalar_t>(w.divide_factor), channels);
+      }
+      data_index_step(n, nbatch, oh, output_height, ow, output_width);
+    }
+  };
+  at::parallel_for(0, nbatch * output_height * output_width, at::internal::GRAIN_SIZE / channels, loop);
+
+  if (!output_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    output_.copy_(output);
+  }
+}
+
+template <typename scalar_t>
+void cpu_avg_pool2d_backward_channels_last(
+    Tensor& grad_input_,
+    const Tensor& grad_output_,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  auto grad_output = grad_output_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto grad_input = grad_input_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  auto grad_input_data = grad_input.data_ptr<scalar_t>();
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+
+  int64_t nbatch = grad_input.size(0);
+  int64_t channels = grad_input.size(1);
+  int64_t input_height = grad_input.size(2);
+  int64_t input_width = grad_input.size(3);
+  int64_t output_height = grad_output.size(2);
+  int64_t output_width = grad_output.size(3);
+
+  at::parallel_for(0, nbatch, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t n = begin; n < end; n++) {
+      scalar_t* grad_input_n = grad_input_data + n * input_height * input_width * channels;
+      for (int64_t oh = 0; oh < output_height; oh++) {
+        for (int64_t ow = 0; ow < output_width; ow++) {
+          const scalar_t* grad_out = grad_output_data +
+              ((n * output_height + oh) * output_width + ow) * channels;
+          auto w = avg_pool2d_window(
+              oh, ow, input_height, input_width,
+              kW, kH, dW, dH, padW, padH, count_include_pad, divisor_override);
+          for (int64_t y = w.hstart; y < w.hend; y++) {
+            for (int64_t x = w.wstart; x < w.wend; x++) {
+              add_row_div(
+                  grad_input_n + (y * input_width + x) * channels, grad_out,
+                  static_cast<scalar_t>(w.divide_factor), channels);
+            }
+          }
+        }
+      }
+    }
+  });
+
+  if (!grad_input_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    grad_input_.copy_(grad_input);
+  }
+}
+
+// Input range of the adaptive pooling window a of b over c inputs, as in
+// AdaptiveAveragePooling.cpp
+inline int64_t adaptive_start_index(int64_t a, int64_t b, int64_t c) {
+  return (int64_t)std::floor((float)(a * c) / b);
+}
+
+inline int64_t adaptive_end_index(int64_t a, int64_t b, int64_t c) {
+  return (int64_t)std::ceil((float)((a + 1) * c) / b);
+}
+
+template <typename scalar_t>
+void cpu_adaptive_avg_pool2d_channels_last(
+    Tensor& output_,
+    const Tensor& input_) {
+  auto input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto output = output_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  auto input_data = input.data_ptr<scalar_t>();
+  auto output_data = output.data_ptr<scalar_t>();
+
+  int64_t nbatch = input.size(0);
+  int64_t channels = input.size(1);
+  int64_t input_height = input.size(2);
+  int64_t input_width = input.size(3);
+  int64_t output_height = output.size(2);
+  int64_t output_width = output.size(3);
+
+  auto loop = [&](int64_t begin, int64_t end) {
+    int64_t n = 0;
+    int64_t oh = 0;
+    int64_t ow = 0;
+    data_index_init(begin, n, nbatch, oh, output_height, ow, output_width);
+
+    for (int64_t i = begin; i < end; i++) {
+      int64_t ih0 = adaptive_start_index(oh, output_height, input_height);
+      int64_t ih1 = adaptive_end_index(oh, output_height, input_height);
+      int64_t iw0 = adaptive_start_index(ow, output_width, input_width);
+      int64_t iw1 = adaptive_end_index(ow, output_width, input_width);
+
+      scalar_t* out = output_data + i * channels;
+      std::fill(out, out + channels, scalar_t(0));
+      const scalar_t* input_n = input_data + n * input_height * input_width * channels;
+      for (int64_t ih = ih0; ih < ih1; ih++) {
+        for (int64_t iw = iw0; iw < iw1; iw++) {
+          add_row(out, input_n + (ih * input_width + iw) * channels, channels);
+        }
+      }
+      div_row(out, static_cast<scalar_t>(iw1 - iw0), channels);
+      div_row(out, static_cast<scalar_t>(ih1 - ih0), channels);
+      data_index_step(n, nbatch, oh, output_height, ow, output_width);
+    }
+  };
+  at::parallel_for(0, nbatch * output_height * output_width, at::internal::GRAIN_SIZE / channels, loop);
+
+  if (!output_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    output_.copy_(output);
+  }
+}
+
+template <typename scalar_t>
+void cpu_adaptive_avg_pool2d_backward_channels_last(
+    Tensor& grad_input_,
+    const Tensor& grad_output_) {
+  auto grad_output = grad_output_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto grad_input = grad_input_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  auto grad_input_data = grad_input.data_ptr<scalar_t>();
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+
+  int64_t nbatch = grad_input.size(0);
+  int64_t channels = grad_input.size(1);
+  int64_t input_height = grad_input.size(2);
+  int64_t input_width = grad_input.size(3);
+  int64_t output_height = grad_output.size(2);
+  int64_t output_width = grad_output.size(3);
+
+  at::parallel_for(0, nbatch, 0, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> grad_delta(channels);
+    for (int64_t n = begin; n < end; n++) {
+      scalar_t* grad_input_n = grad_input_data + n * input_height * input_width * channels;
+      for (int64_t oh = 0; oh < output_height; oh++) {
+        int64_t ih0 = adaptive_start_index(oh, output_height, input_height);
+        int64_t ih1 = adaptive_end_index(oh, output_height, input_height);
+        for (int64_t ow = 0; ow < output_width; ow++) {
+          int64_t iw0 = adaptive_start_index(ow, output_width, input_width);
+          int64_t iw1 = adaptive_end_index(ow, output_width, input_width);
+
+          const scalar_t* grad_out = grad_output_data +
+              ((n * output_height + oh) * output_width + ow) * channels;
+          std::copy(grad_out, grad_out + channels, grad_delta.begin());
+          div_row(grad_delta.data(), static_cast<scalar_t>(ih1 - ih0), channels);
+          div_row(grad_delta.data(), static_cast<scalar_t>(iw1 - iw0), channels);
+          for (int64_t ih = ih0; ih < ih1; ih++) {
+            for (int64_t iw = iw0; iw < iw1; iw++) {
+              add_row(grad_input_n + (ih * input_width + iw) * channels, grad_delta.data(), channels);
+            }
+          }
+        }
+      }
+    }
+  });
+
+  if (!grad_input_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    grad_input_.copy_(grad_input);
+  }
+}
+
+void max_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    Tensor& indices,
+    const Tensor& input,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "max_pool2d_channels_last", [&] {
+    cpu_max_pool2d_channels_last<scalar_t>(
+        output, indices, input, kW, kH, dW, dH, padW, padH, dilationW, dilationH);
+  });
+}
+
+void max_pool2d_channels_last_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_output,
+    const Tensor& indices) {
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "max_pool2d_backward_channels_last", [&] {
+    cpu_max_pool2d_backward_channels_last<scalar_t>(grad_input, grad_output, indices);
+  });
+}
+
+void avg_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "avg_pool2d_channels_last", [&] {
+    cpu_avg_pool2d_channels_last<scalar_t>(
+        output, input, kW, kH, dW, dH, padW, padH, count_include_pad, divisor_override);
+  });
+}
+
+void avg_pool2d_channels_last_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_output,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "avg_pool2d_backward_channels_last", [&] {
+    cpu_avg_pool2d_backward_channels_last<scalar_t>(
+        grad_input, grad_output, kW, kH, dW, dH, padW, padH, count_include_pad, divisor_override);
+  });
+}
+
+void adaptive_avg_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    const Tensor& input) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "adaptive_avg_pool2d_channels_last", [&] {
+    cpu_adaptive_avg_pool2d_channels_last<scalar_t>(output, input);
+  });
+}
+
+void adaptive_avg_pool2d_channels_last_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_output) {
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "adaptive_avg_pool2d_backward_channels_last", [&] {
+    cpu_adaptive_avg_pool2d_backward_channels_last<scalar_t>(grad_input, grad_output);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(max_pool2d_channels_last_kernel, &max_pool2d_channels_last_kernel_impl);
+REGISTER_DISPATCH(max_pool2d_channels_last_backward_kernel, &max_pool2d_channels_last_backward_kernel_impl);
+REGISTER_DISPATCH(avg_pool2d_channels_last_kernel, &avg_pool2d_channels_last_kernel_impl);
+REGISTER_DISPATCH(avg_pool2d_channels_last_backward_kernel, &avg_pool2d_channels_last_backward_kernel_impl);
+REGISTER_DISPATCH(adaptive_avg_pool2d_channels_last_kernel, &adaptive_avg_pool2d_channels_last_kernel_impl);
+REGISTER_DISPATCH(adaptive_avg_pool2d_channels_last_backward_kernel, &adaptive_avg_pool2d_channels_last_backward_kernel_impl);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,250 @@
+#include <ATen/native/RNN.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Each row of the gates holds the chunks of every gate back to back, so a
+// row is processed Vec::size() hidden units at a time; the tail goes through
+// the same code with partial loads and stores.
+
+template <typename scalar_t>
+inline vec256::Vec256<scalar_t> sigmoid(const vec256::Vec256<scalar_t>& x) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec one(scalar_t(1));
+  return one / (one + x.neg().exp());
+}
+
+inline int64_t rows_grain_size(int64_t row_size) {
+  return std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, row_size));
+}
+
+template <typename scalar_t>
+void fused_lstm_cell_kernel_impl(
+    Tensor& hy, Tensor& cy, Tensor& workspace,
+    const Tensor& input_gates, const Tensor& hidden_gates,
+    const Tensor& input_bias, const Tensor& hidden_bias, const Tensor& cx) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t batch = cx.size(0);
+  const int64_t H = cx.size(1);
+  const scalar_t* ig_data = input_gates.data_ptr<scalar_t>();
+  const scalar_t* hg_data = hidden_gates.data_ptr<scalar_t>();
+  const scalar_t* b1 = input_bias.defined() ? input_bias.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* b2 = hidden_bias.defined() ? hidden_bias.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* cx_data = cx.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+  scalar_t* cy_data = cy.data_ptr<scalar_t>();
+  scalar_t* ws_data = workspace.data_ptr<scalar_t>();
+
+  at::parallel_for(0, batch, rows_grain_size(4 * H), [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      const scalar_t* ig = ig_data + b * 4 * H;
+      const scalar_t* hg = hg_data + b * 4 * H;
+      scalar_t* ws = ws_data + b * 4 * H;
+      for (int64_t j = 0; j < H; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), H - j);
+        auto gate = [&](int64_t k) {
+          Vec g = Vec::loadu(ig + k * H + j, n) + Vec::loadu(hg + k * H + j, n);
+          if (b1 != nullptr) {
+            g = g + Vec::loadu(b1 + k * H + j, n) + Vec::loadu(b2 + k * H + j, n);
+          }
+          return g;
+        };
+        const Vec i = sigmoid(gate(0));
+        const Vec f = sigmoid(gate(1));
+        const Vec g = gate(2).tanh();
+        const Vec o = sigmoid(gate(3));
+        const Vec c = f * Vec::loadu(cx_data + b * H + j, n) + i * g;
+        (o * c.tanh()).store(hy_data + b * H + j, n);
+        c.store(cy_data + b * H + j, n);
+        i.store(ws + 0 * H + j, n);
+        f.store(ws + 1 * H + j, n);
+        g.store(ws + 2 * H + j, n);
+        o.store(ws + 3 * H + j, n);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void fused_lstm_cell_backward_kernel_impl(
+    Tensor& grad_gates, Tensor& grad_cx,
+    const Tensor& grad_hy, const Tensor& grad_cy,
+    const Tensor& cx, const Tensor& cy, const Tensor& workspace) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t batch = cx.size(0);
+  const int64_t H = cx.size(1);
+  const scalar_t* ghy_data = grad_hy.defined() ? grad_hy.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* gcy_data = grad_cy.defined() ? grad_cy.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* cx_data = cx.data_ptr<scalar_t>();
+  const scalar_t* cy_data = cy.data_ptr<scalar_t>();
+  const scalar_t* ws_data = workspace.data_ptr<scalar_t>();
+  scalar_t* gg_data = grad_gates.data_ptr<scalar_t>();
+  scalar_t* gcx_data = grad_cx.data_ptr<scalar_t>();
+
+  at::parallel_for(0, batch, rows_grain_size(4 * H), [&](int64_t begin, int64_t end) {
+    const Vec one(scalar_t(1));
+    for (int64_t b = begin; b < end; b++) {
+      const scalar_t* ws = ws_data + b * 4 * H;
+      scalar_t* gg = gg_data + b * 4 * H;
+      for (int64_t j = 0; j < H; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), H - j);
+        const int64_t offset = b * H + j;
+        const Vec i = Vec::loadu(ws + 0 * H + j, n);
+        const Vec f = Vec::loadu(ws + 1 * H + j, n);
+        const Vec g = Vec::loadu(ws + 2 * H + j, n);
+        const Vec o = Vec::loadu(ws + 3 * H + j, n);
+        const Vec go = ghy_data != nullptr ? Vec::loadu(ghy_data + offset, n) : Vec(scalar_t(0));
+        const Vec goc = gcy_data != nullptr ? Vec::loadu(gcy_data + offset, n) : Vec(scalar_t(0));
+        const Vec tanh_cy = Vec::loadu(cy_data + offset, n).tanh();
+        const Vec gc = go * o * (one - tanh_cy * tanh_cy) + goc;
+        (gc * g * (one - i) * i).store(gg + 0 * H + j, n);
+        (gc * Vec::loadu(cx_data + offset, n) * (one - f) * f).store(gg + 1 * H + j, n);
+        (gc * i * (one - g * g)).store(gg + 2 * H + j, n);
+        (go * tanh_cy * (one - o) * o).store(gg + 3 * H + j, n);
+        (gc * f).store(gcx_data + offset, n);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void fused_gru_cell_kernel_impl(
+    Tensor& hy, Tensor& workspace,
+    const Tensor& input_gates, const Tensor& hidden_gates,
+    const Tensor& input_bias, const Tensor& hidden_bias, const Tensor& hx) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t batch = hx.size(0);
+  const int64_t H = hx.size(1);
+  const scalar_t* ig_data = input_gates.data_ptr<scalar_t>();
+  const scalar_t* hg_data = hidden_gates.data_ptr<scalar_t>();
+  const scalar_t* b1 = input_bias.defined() ? input_bias.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* b2 = hidden_bias.defined() ? hidden_bias.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* hx_data = hx.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+  scalar_t* ws_data = workspace.data_ptr<scalar_t>();
+
+  at::parallel_for(0, batch, rows_grain_size(5 * H), [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      const scalar_t* ig = ig_data + b * 3 * H;
+      const scalar_t* hg = hg_data + b * 3 * H;
+      scalar_t* ws = ws_data + b * 5 * H;
+      for (int64_t j = 0; j < H; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), H - j);
+        auto load_bias = [&](const scalar_t* bias, int64_t k) {
+          return bias != nullptr ? Vec::loadu(bias + k * H + j, n) : Vec(scalar_t(0));
+        };
+        const Vec r = sigmoid(Vec::loadu(ig + 0 * H + j, n) + Vec::loadu(hg + 0 * H + j, n) +
+                              load_bias(b1, 0) + load_bias(b2, 0));
+        const Vec i = sigmoid(Vec::loadu(ig + 1 * H + j, n) + Vec::loadu(hg + 1 * H + j, n) +
+                              load_bias(b1, 1) + load_bias(b2, 1));
+        const Vec hn = Vec::loadu(hg + 2 * H + j, n) + load_bias(b2, 2);
+        const Vec ng = (Vec::loadu(ig + 2 * H + j, n) + load_bias(b1, 2) + r * hn).tanh();
+        const Vec h = Vec::loadu(hx_data + b * H + j, n);
+        (ng + i * (h - ng)).store(hy_data + b * H + j, n);
+        r.store(ws + 0 * H + j, n);
+        i.store(ws + 1 * H + j, n);
+        ng.store(ws + 2 * H + j, n);
+        h.store(ws + 3 * H + j, n);
+        hn.store(ws + 4 * H + j, n);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void fused_gru_cell_backward_kernel_impl(
+    Tensor& grad_input_gates, Tensor& grad_hidden_gates, Tensor& grad_hx,
+    const Tensor& grad_hy, const Tensor& workspace) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t batch = grad_hy.size(0);
+  const int64_t H = grad_hy.size(1);
+  const scalar_t* ghy_data = grad_hy.data_ptr<scalar_t>();
+  const scalar_t* ws_data = workspace.data_ptr<scalar_t>();
+  scalar_t* gig_data = grad_input_gates.data_ptr<scalar_t>();
+  scalar_t* ghg_data = grad_hidden_gates.data_ptr<scalar_t>();
+  scalar_t* ghx_data = grad_hx.data_ptr<scalar_t>();
+
+  at::parallel_for(0, batch, rows_grain_size(5 * H), [&](int64_t begin, int64_t end) {
+    const Vec one(scalar_t(1));
+    for (int64_t b = begin; b < end; b++) {
+      const scalar_t* ws = ws_data + b * 5 * H;
+      scalar_t* gi = gig_data + b * 3 * H;
+      scalar_t* gh = ghg_data + b * 3 * H;
+      for (int64_t j = 0; j < H; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), H - j);
+        const Vec r = Vec::loadu(ws + 0 * H + j, n);
+        const Vec i = Vec::loadu(ws + 1 * H + j, n);
+        const Vec ng = Vec::loadu(ws + 2 * H + j, n);
+        const Vec h = Vec::loadu(ws + 3 * H + j, n);
+        const Vec hn = Vec::loadu(ws + 4 * H + j, n);
+        const Vec go = Vec::loadu(ghy_data + b * H + j, n);
+        const Vec grad_i = go * (h - ng) * (one - i) * i;
+        const Vec grad_n = go * (one - i) * (one - ng * ng);
+        const Vec grad_r = grad_n * hn * (one - r) * r;
+        grad_r.store(gi + 0 * H + j, n);
+        grad_i.store(gi + 1 * H + j, n);
+        grad_n.store(gi + 2 * H + j, n);
+        grad_r.store(gh + 0 * H + j, n);
+        grad_i.store(gh + 1 * H + j, n);
+        (grad_n * r).store(gh + 2 * H + j, n);
+        (go * i).store(ghx_data + b * H + j, n);
+      }
+    }
+  });
+}
+
+void fused_lstm_cell_kernel(
+    Tensor& hy, Tensor& cy, Tensor& workspace,
+    const Tensor& input_gates, const Tensor& hidden_gates,
+    const Tensor& input_bias, const Tensor& hidden_bias, const Tensor& cx) {
+  AT_DISPATCH_FLOATING_TYPES(input_gates.scalar_type(), "fused_lstm_cell", [&] {
+    fused_lstm_cell_kernel_impl<scalar_t>(
+        hy, cy, workspace, input_gates, hidden_gates, input_bias, hidden_bias, cx);
+  });
+}
+
+void fused_lstm_cell_backward_kernel(
+    Tensor& grad_gates, Tensor& grad_cx,
+    const Tensor& grad_hy, const Tensor& grad_cy,
+    const Tensor& cx, const Tensor& cy, const Tensor& workspace) {
+  AT_DISPATCH_FLOATING_TYPES(workspace.scalar_type(), "fused_lstm_cell_backward", [&] {
+    fused_lstm_cell_backward_kernel_impl<scalar_t>(
+        grad_gates, grad_cx, grad_hy, grad_cy, cx, cy, workspace);
+  });
+}
+
+void fused_gru_cell_kernel(
+    Tensor& hy, Tensor& workspace,
+    const Tensor& input_gates, const Tensor& hidden_gates,
+    const Tensor& input_bias, const Tensor& hidden_bias, const Tensor& hx) {
+  AT_DISPATCH_FLOATING_TYPES(input_gates.scalar_type(), "fused_gru_cell", [&] {
+    fused_gru_cell_kernel_impl<scalar_t>(
+        hy, workspace, input_gates, hidden_gates, input_bias, hidden_bias, hx);
+  });
+}
+
+void fused_gru_cell_backward_kernel(
+    Tensor& grad_input_gates, Tensor& grad_hidden_gates,
+    Tensor& grad_hx, const Tensor& grad_hy, const Tensor& workspace) {
+  AT_DISPATCH_FLOATING_TYPES(workspace.scalar_type(), "fused_gru_cell_backward", [&] {
+    fused_gru_cell_backward_kernel_impl<scalar_t>(
+        grad_input_gates, grad_hidden_gates, grad_hx, grad_hy, workspace);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(fused_lstm_cell_stub, &fused_lstm_cell_kernel);
+REGISTER_DISPATCH(fused_lstm_cell_backward_stub, &fused_lstm_cell_backward_kernel);
+REGISTER_DISPATCH(fused_gru_cell_stub, &fused_gru_cell_kernel);
+REGISTER_DISPATCH(fused_gru_cell_backward_stub, &fused_gru_cell_backward_kernel);
+
+} // namespace native
+} // namespace at
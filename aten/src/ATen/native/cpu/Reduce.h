@@ -2,6 +2,7 @@
 
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/Parallel.h>
+#include <c10/util/C++17.h>
 #include <c10/util/TypeList.h>
 
 #include <sstream>
@@ -151,6 +152,48 @@ struct all_same : guts::conjunction<
   std::is_same<T, Args>...
 > {};
 
+// Note [Vectorized reduce_contiguous]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The ops passed to binary_kernel_reduce reduce one element at a time, so
+// a single accumulator is all the vectorization they get. Ops can
+// additionally define
+//
+//   acc_t reduce_contiguous(acc_t acc, const data_t* data, int64_t idx, int64_t n) const
+//
+// which adds the n contiguous inputs data[0, n), with indices idx, ...,
+// idx + n - 1, to acc. binary_kernel_reduce then calls it instead of reduce
+// for every inner loop whose input is contiguous, and the ops are free to
+// use Vec256 with one vector accumulator per output (min and max, mean and
+// m2, ...), so reductions with several outputs still read the input once.
+
+template <typename ops_t, typename = void>
+struct has_reduce_contiguous : std::false_type {};
+
+template <typename ops_t>
+struct has_reduce_contiguous<ops_t, guts::void_t<decltype(&ops_t::reduce_contiguous)>>
+    : std::true_type {};
+
+template <typename data_t, typename ops_t, typename acc_t>
+static inline acc_t reduce_inner_loop(
+    const ops_t& ops, acc_t acc, const char* in, int64_t stride, int64_t size, int64_t idx,
+    std::false_type /*has_reduce_contiguous*/) {
+  for (int64_t i = 0; i < size; ++i) {
+    acc = ops.reduce(acc, *(data_t*)in, idx + i);
+    in += stride;
+  }
+  return acc;
+}
+
+template <typename data_t, typename ops_t, typename acc_t>
+static inline acc_t reduce_inner_loop(
+    const ops_t& ops, acc_t acc, const char* in, int64_t stride, int64_t size, int64_t idx,
+    std::true_type /*has_reduce_contiguous*/) {
+  if (stride == sizeof(data_t)) {
+    return ops.reduce_contiguous(acc, (const data_t*)in, idx, size);
+  }
+  return reduce_inner_loop<data_t>(ops, acc, in, stride, size, idx, std::false_type());
+}
+
 // data_t is the input/output data type.
 // acc_t is a type that contains all the necessary data
 // to continue reducing.
@@ -176,6 +219,8 @@ struct all_same : guts::conjunction<
 //
 // If, on the other hand, there is only one, then we split the input into
 // into several pieces, reduce each separately, and then combine them.
+//
+// See Note [Vectorized reduce_contiguous] for ops that vectorize.
 
 template <typename ops_t, typename init_t>
 void binary_kernel_reduce(TensorIterator& iter, ops_t ops, init_t init) {
@@ -207,12 +252,9 @@ void binary_kernel_reduce(TensorIterator& iter, ops_t ops, init_t init) {
       int ntensors = sub_iter.ntensors();
       sub_iter.serial_for_each([&acc, &ops, num_outputs, ntensors, begin](char** data, const int64_t* strides, int64_t size) {
         AT_ASSERT(ntensors - num_outputs == 1);
-        char *in = data[ntensors - 1];
-        int64_t stride = strides[ntensors - 1];
-        for (int64_t i = 0; i < size; ++i) {
-          acc = ops.reduce(acc, *(data_t*)in, begin + i);
-          in += stride;
-        }
+        acc = reduce_inner_loop<data_t>(
+            ops, acc, data[ntensors - 1], strides[ntensors - 1], size, begin,
+            has_reduce_contiguous<ops_t>());
       }, {begin, end});
       return ops.translate_idx(acc, sub_iter.view_offsets()[0]);
     };
@@ -135,11 +135,73 @@ static void mean_kernel_impl(TensorIterator& iter) {
   });
 }
 
+constexpr int64_t kWelfordBlock = 256;
+
+// Sums the lanes of acc and adds data[begin, n) to the sum
+template <typename scalar_t>
+static inline scalar_t finish_vec_sum(Vec256<scalar_t> acc, const scalar_t* data, int64_t begin, int64_t n) {
+  scalar_t lanes[Vec256<scalar_t>::size()];
+  acc.store(lanes);
+  scalar_t sum = 0;
+  for (int64_t j = 0; j < Vec256<scalar_t>::size(); j++) {
+    sum += lanes[j];
+  }
+  for (int64_t j = begin; j < n; j++) {
+    sum += data[j];
+  }
+  return sum;
+}
+
+// WelfordOps with a vectorized reduce_contiguous, see
+// Note [Vectorized reduce_contiguous]. Contiguous inputs are converted to
+// double kWelfordBlock at a time, and every block is reduced exactly with
+// two passes while it is in L1, the mean and then the sum of squared
+// deviations from it, before being merged into the accumulator with
+// combine. That replaces a division per element with a few vector flops,
+// and the input is still read only once.
+template <typename scalar_t>
+struct WelfordVecOps : WelfordOps<scalar_t, double, int64_t, double, std::tuple<scalar_t, scalar_t>> {
+  using base_t = WelfordOps<scalar_t, double, int64_t, double, std::tuple<scalar_t, scalar_t>>;
+  using acc_t = typename base_t::acc_t;
+  using base_t::base_t;
+
+  acc_t reduce_contiguous(acc_t acc, const scalar_t* data, int64_t /*idx*/, int64_t n) const {
+    using Vec = Vec256<double>;
+    double buffer[kWelfordBlock];
+    for (int64_t begin = 0; begin < n; begin += kWelfordBlock) {
+      const int64_t len = std::min(kWelfordBlock, n - begin);
+      for (int64_t j = 0; j < len; j++) {
+        buffer[j] = static_cast<double>(data[begin + j]);
+      }
+      const int64_t vec_len = len - len % Vec::size();
+
+      Vec sum(0);
+      for (int64_t j = 0; j < vec_len; j += Vec::size()) {
+        sum = sum + Vec::loadu(buffer + j);
+      }
+      const double mean = finish_vec_sum(sum, buffer, vec_len, len) / len;
+
+      const Vec mean_vec(mean);
+      Vec m2(0);
+      for (int64_t j = 0; j < vec_len; j += Vec::size()) {
+        const Vec delta = Vec::loadu(buffer + j) - mean_vec;
+        m2 = vec256::fmadd(delta, delta, m2);
+      }
+      for (int64_t j = vec_len; j < len; j++) {
+        buffer[j] = (buffer[j] - mean) * (buffer[j] - mean);
+      }
+      acc = this->combine(
+          acc, acc_t(mean, finish_vec_sum(m2, buffer, vec_len, len), len, static_cast<double>(len)));
+    }
+    return acc;
+  }
+};
+
 static void std_var_kernel_impl(TensorIterator &iter, bool unbiased, bool take_sqrt) {
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "std_cpu", [&] {
+  AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, iter.dtype(), "std_cpu", [&] {
     binary_kernel_reduce(
       iter,
-      WelfordOps<scalar_t, double, int64_t, double, std::tuple<scalar_t, scalar_t>> { unbiased, take_sqrt },
+      WelfordVecOps<scalar_t> { unbiased, take_sqrt },
       WelfordData<double, int64_t, double>()
     );
   });
@@ -155,6 +217,26 @@ static void prod_kernel_impl(TensorIterator& iter) {
   });
 }
 
+// Wraps reduction ops that accumulate in float so they read and write
+// bfloat16. See Note [BFloat16 kernels compute in float]
+template <typename acc_ops_t>
+struct BFloat16AccOps : acc_ops_t {
+  BFloat16AccOps(acc_ops_t ops) : acc_ops_t(ops) {}
+
+  inline float reduce(float acc, BFloat16 data, int64_t idx) const {
+    return acc_ops_t::reduce(acc, static_cast<float>(data), idx);
+  }
+
+  inline BFloat16 project(float a) const {
+    return static_cast<BFloat16>(acc_ops_t::project(a));
+  }
+};
+
+template <typename acc_ops_t>
+static void norm_kernel_bfloat16(TensorIterator& iter, acc_ops_t ops, float init) {
+  binary_kernel_reduce(iter, BFloat16AccOps<acc_ops_t>(ops), init);
+}
+
 static void norm_kernel_tensor_iterator_impl(
     TensorIterator& iter,
     Scalar p) {
@@ -167,6 +249,23 @@ static void norm_kernel_tensor_iterator_impl(
     AT_ERROR("norm_kernel_tensor_iterator_impl expects norm to be integer or float");
   }
 
+  if (iter.dtype() == kBFloat16) {
+    if (val == 0) {
+      norm_kernel_bfloat16(iter, NormZeroOps<float>(), 0.f);
+    } else if (val == 1) {
+      norm_kernel_bfloat16(iter, NormOneOps<float>(), 0.f);
+    } else if (val == 2) {
+      norm_kernel_bfloat16(iter, NormTwoOps<float>(), 0.f);
+    } else if (val == INFINITY) {
+      norm_kernel_bfloat16(iter, AbsMaxOps<float>(), std::numeric_limits<float>::min());
+    } else if (val == -INFINITY) {
+      norm_kernel_bfloat16(iter, AbsMinOps<float>(), std::numeric_limits<float>::max());
+    } else {
+      norm_kernel_bfloat16(iter, NormOps<float> { val }, 0.f);
+    }
+    return;
+  }
+
 
   if (val == 0) {
     AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kHalf, iter.dtype(), "norm_cpu", [&] {
@@ -258,7 +357,7 @@ static void or_kernel_impl(TensorIterator& iter) {
 }
 
 static void min_values_kernel_impl(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kHalf, iter.dtype(), "min_values_cpu", [&iter] {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kHalf, kBFloat16, iter.dtype(), "min_values_cpu", [&iter] {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return min_impl(a, b); },
@@ -267,7 +366,7 @@ static void min_values_kernel_impl(TensorIterator& iter) {
 }
 
 static void max_values_kernel_impl(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kHalf, iter.dtype(), "max_values_cpu", [&iter] {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kHalf, kBFloat16, iter.dtype(), "max_values_cpu", [&iter] {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return max_impl(a, b); },
@@ -275,6 +374,63 @@ static void max_values_kernel_impl(TensorIterator& iter) {
   });
 }
 
+// min and max in one pass for aminmax, with NaN propagating to both
+template <typename scalar_t>
+struct MinMaxOps {
+  using acc_t = std::pair<scalar_t, scalar_t>;
+
+  inline acc_t reduce(acc_t acc, scalar_t data, int64_t /*idx*/) const {
+    return {min_impl(acc.first, data), max_impl(acc.second, data)};
+  }
+
+  // See Note [Vectorized reduce_contiguous]
+  acc_t reduce_contiguous(acc_t acc, const scalar_t* data, int64_t idx, int64_t n) const {
+    using Vec = Vec256<scalar_t>;
+    int64_t j = 0;
+    if (n >= Vec::size()) {
+      Vec min_vec = Vec::loadu(data);
+      Vec max_vec = min_vec;
+      for (j = Vec::size(); j + Vec::size() <= n; j += Vec::size()) {
+        const Vec v = Vec::loadu(data + j);
+        min_vec = minimum(min_vec, v);
+        max_vec = maximum(max_vec, v);
+      }
+      scalar_t min_lanes[Vec::size()];
+      scalar_t max_lanes[Vec::size()];
+      min_vec.store(min_lanes);
+      max_vec.store(max_lanes);
+      for (int64_t k = 0; k < Vec::size(); k++) {
+        acc = {min_impl(acc.first, min_lanes[k]), max_impl(acc.second, max_lanes[k])};
+      }
+    }
+    for (; j < n; j++) {
+      acc = reduce(acc, data[j], idx + j);
+    }
+    return acc;
+  }
+
+  inline acc_t combine(acc_t a, acc_t b) const {
+    return {min_impl(a.first, b.first), max_impl(a.second, b.second)};
+  }
+
+  inline std::tuple<scalar_t, scalar_t> project(acc_t acc) const {
+    return std::make_tuple(acc.first, acc.second);
+  }
+
+  static acc_t translate_idx(acc_t acc, int64_t /*base_idx*/) {
+    return acc;
+  }
+};
+
+static void aminmax_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES_AND2(kHalf, kBFloat16, iter.dtype(), "aminmax_cpu", [&] {
+    binary_kernel_reduce(
+      iter,
+      MinMaxOps<scalar_t>{},
+      std::pair<scalar_t, scalar_t>(upper_bound<scalar_t>(), lower_bound<scalar_t>()));
+  });
+}
+
 static void argmax_kernel_impl(TensorIterator &iter) {
   AT_DISPATCH_ALL_TYPES_AND(kHalf, iter.dtype(1), "argmax_cpu", [&] {
     binary_kernel_reduce(
@@ -303,6 +459,7 @@ REGISTER_DISPATCH(and_stub, &and_kernel_impl);
 REGISTER_DISPATCH(or_stub, &or_kernel_impl);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_impl);
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_impl);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_impl);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_impl);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_impl);
 REGISTER_DISPATCH(cumprod_stub, &cumprod_cpu_kernel);
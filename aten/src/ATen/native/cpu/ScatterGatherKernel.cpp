@@ -3,6 +3,10 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/TensorAdvancedIndexing.h>
 #include <ATen/Parallel.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <cstring>
 
 namespace at { namespace native {
 
@@ -318,7 +322,147 @@ struct cpu_scatter_gather_base_kernel {
   }
 };
 
+// Note [Row scatter/gather]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// Message passing in graph networks gathers and scatter-adds whole rows:
+//
+//   msg = x.gather(0, idx.view(-1, 1).expand(-1, F))
+//   out.scatter_add_(0, idx.view(-1, 1).expand(-1, F), msg)
+//
+// With dim == 0, an index that is expanded (stride 0) along every other
+// dimension and contiguous self and src with the index's trailing sizes,
+// every index entry moves one contiguous row, so these calls skip the
+// element by element TensorIterator loop. gather copies rows in parallel.
+// scatter_add adds rows with Vec256 and, to stay free of atomics, either
+// splits the columns between threads (long rows) or accumulates into one
+// partial result per thread that is summed into self at the end (many more
+// index rows than rows of self, which bounds the partial results by the
+// size of src). The partial results change the order of the additions, so
+// floating point results may differ in the last bits from the serial loop.
+
+constexpr int64_t kRowScatterMinColumns = 64;
+
+static bool is_row_scatter_gather(
+    const Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  if (dim != 0 || self.dim() == 0 || index.dim() != self.dim() || src.dim() != self.dim() ||
+      !self.is_contiguous() || !src.is_contiguous() ||
+      self.scalar_type() != src.scalar_type() || index.scalar_type() != ScalarType::Long) {
+    return false;
+  }
+  for (int64_t d = 1; d < index.dim(); d++) {
+    if (index.size(d) != self.size(d) || index.size(d) != src.size(d) ||
+        (index.stride(d) != 0 && index.size(d) != 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The dtypes cpu_row_scatter_add dispatches to; the others take the
+// elementwise loop.
+static bool is_row_scatter_add_type(ScalarType type) {
+  return at::isIntegralType(type, /*includeBool=*/false) ||
+      type == ScalarType::Float || type == ScalarType::Double;
+}
+
+// result[i] = src[index[i]] for rows of result and src
+template <typename scalar_t>
+void cpu_row_gather(Tensor& result, const Tensor& index, const Tensor& src) {
+  const int64_t nrows = index.size(0);
+  const int64_t row_size = index.numel() / nrows;
+  const int64_t src_rows = src.size(0);
+  const int64_t index_stride = index.stride(0);
+  const int64_t* index_data = index.data_ptr<int64_t>();
+  const scalar_t* src_data = src.data_ptr<scalar_t>();
+  scalar_t* result_data = result.data_ptr<scalar_t>();
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / row_size);
+  at::parallel_for(0, nrows, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t idx = index_data[i * index_stride];
+      TORCH_CHECK(idx >= 0 && idx < src_rows,
+        "index ", idx, " is out of bounds for dimension 0 with size ", src_rows);
+      std::memcpy(result_data + i * row_size, src_data + idx * row_size, row_size * sizeof(scalar_t));
+    }
+  });
+}
+
+template <typename scalar_t>
+void add_row(scalar_t* self_data, const scalar_t* src_data, int64_t n) {
+  using Vec = vec256::Vec256<scalar_t>;
+  int64_t j = 0;
+  for (; j + Vec::size() <= n; j += Vec::size()) {
+    (Vec::loadu(self_data + j) + Vec::loadu(src_data + j)).store(self_data + j);
+  }
+  for (; j < n; j++) {
+    self_data[j] += src_data[j];
+  }
+}
+
+// self[index[i]] += src[i] for rows of self and src
+template <typename scalar_t>
+void cpu_row_scatter_add(Tensor& self, const Tensor& index, const Tensor& src) {
+  const int64_t nrows = index.size(0);
+  const int64_t row_size = index.numel() / nrows;
+  const int64_t self_rows = self.size(0);
+  const int64_t index_stride = index.stride(0);
+  const int64_t* index_data = index.data_ptr<int64_t>();
+  const scalar_t* src_data = src.data_ptr<scalar_t>();
+  scalar_t* self_data = self.data_ptr<scalar_t>();
+  auto self_row = [&](int64_t i) {
+    const int64_t idx = index_data[i * index_stride];
+    TORCH_CHECK(idx >= 0 && idx < self_rows,
+      "index ", idx, " is out of bounds for dimension 0 with size ", self_rows);
+    return idx;
+  };
+
+  const int64_t num_threads = at::get_num_threads();
+  if (num_threads > 1 && row_size >= num_threads * kRowScatterMinColumns) {
+    at::parallel_for(0, row_size, kRowScatterMinColumns, [&](int64_t begin, int64_t end) {
+      for (int64_t i = 0; i < nrows; i++) {
+        add_row(self_data + self_row(i) * row_size + begin, src_data + i * row_size + begin, end - begin);
+      }
+    });
+  } else if (num_threads > 1 && nrows >= self_rows * num_threads &&
+             nrows * row_size >= internal::GRAIN_SIZE) {
+    const int64_t self_numel = self_rows * row_size;
+    Tensor partial = at::zeros({num_threads, self_numel}, self.options());
+    scalar_t* partial_data = partial.data_ptr<scalar_t>();
+    const int64_t chunk_size = divup(nrows, num_threads);
+    at::parallel_for(0, num_threads, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t t = begin; t < end; t++) {
+        scalar_t* partial_t = partial_data + t * self_numel;
+        for (int64_t i = t * chunk_size; i < std::min((t + 1) * chunk_size, nrows); i++) {
+          add_row(partial_t + self_row(i) * row_size, src_data + i * row_size, row_size);
+        }
+      }
+    });
+    const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / (row_size * num_threads));
+    at::parallel_for(0, self_rows, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t r = begin; r < end; r++) {
+        for (int64_t t = 0; t < num_threads; t++) {
+          add_row(self_data + r * row_size, partial_data + t * self_numel + r * row_size, row_size);
+        }
+      }
+    });
+  } else {
+    for (int64_t i = 0; i < nrows; i++) {
+      add_row(self_data + self_row(i) * row_size, src_data + i * row_size, row_size);
+    }
+  }
+}
+
 void gather_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim, const Tensor& index) {
+  dim = maybe_wrap_dim(dim, result.dim());
+  // See Note [Row scatter/gather]
+  if (index.numel() > 0 && is_row_scatter_gather(result, dim, index, self)) {
+    gather_shape_check(result, dim, index, self);
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(
+      ScalarType::Bool, ScalarType::Half, result.scalar_type(),
+      "gather_out_cpu", [&] {
+        cpu_row_gather<scalar_t>(result, index, self);
+      });
+    return;
+  }
   cpu_scatter_gather_base_kernel</*is_scatter_like=*/false>()(
     result, dim, index, self,
     "gather_out_cpu", tensor_assign);
@@ -335,6 +479,16 @@ void scatter_fill_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, Sca
 }
 
 void scatter_add_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  // See Note [Row scatter/gather]
+  if (index.numel() > 0 && is_row_scatter_add_type(self.scalar_type()) &&
+      is_row_scatter_gather(self, dim, index, src)) {
+    scatter_shape_check(self, dim, index, src);
+    AT_DISPATCH_ALL_TYPES(self.scalar_type(), "scatter_add_", [&] {
+      cpu_row_scatter_add<scalar_t>(self, index, src);
+    });
+    return;
+  }
   cpu_scatter_gather_base_kernel<>()(
     self, dim, index, src,
     "scatter_add_", reduce_add);
@@ -3,11 +3,13 @@
 #include <algorithm>
 #include <iterator>
 #include <numeric>
+#include <vector>
 
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/functional.h>
 #include <c10/util/Optional.h>
 
 // [Note AVX-SSE transitions] In general we avoid calls into cmath for code
@@ -28,7 +30,7 @@ inline void _vec_log_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec512::Vectorized<scalar_t>;
   static constexpr int64_t CHUNK_SIZE = (128 / sizeof(scalar_t)) * Vec::size();
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size * CHUNK_SIZE);
   if (grain_size < CHUNK_SIZE)
@@ -48,8 +50,8 @@ inline void _vec_log_softmax_lastdim(
           for (int64_t j = 0; j < loop_end; j++) {
             int64_t i = ii + j;
             scalar_t* input_data = input_data_base + i * dim_size;
-            max_input_arr[j] = vec256::reduce_all<scalar_t>(
-                [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
+            max_input_arr[j] = vec512::reduce_all<scalar_t>(
+                [](Vec& x, Vec& y) { return maximum(x, y); },
                 input_data,
                 dim_size);
           }
@@ -57,7 +59,7 @@ inline void _vec_log_softmax_lastdim(
             int64_t i = ii + j;
             scalar_t* input_data = input_data_base + i * dim_size;
             scalar_t max_input = max_input_arr[j];
-            tmp_sum_scalar[j] = vec256::map_reduce_all<scalar_t>(
+            tmp_sum_scalar[j] = vec512::map_reduce_all<scalar_t>(
                 [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
                 [](Vec x, Vec y) { return x + y; },
                 input_data,
@@ -65,7 +67,7 @@ inline void _vec_log_softmax_lastdim(
           }
           // See [Note AVX-SSE transitions] for why this should call the
           // vectorized version (aside from perf improvements).
-          vec256::map(
+          vec512::map(
               [](Vec x) { return x.log(); },
               tmp_sum_scalar,
               tmp_sum_scalar,
@@ -82,7 +84,7 @@ inline void _vec_log_softmax_lastdim(
             // is small, if we compute `max_input` plus `tmp_sum` before,
             // there would be a numerical problem. See an example in
             // https://github.com/pytorch/pytorch/issues/11752#issuecomment-422883379
-            vec256::map(
+            vec512::map(
                 [tmp_sum, max_input](Vec x) { return x - Vec(max_input) - Vec(tmp_sum); },
                 output_data,
                 input_data,
@@ -98,7 +100,7 @@ inline void _vec_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec512::Vectorized<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -111,19 +113,19 @@ inline void _vec_softmax_lastdim(
         for (int64_t i = begin; i < end; i++) {
           scalar_t* input_data = input_data_base + i * dim_size;
           scalar_t* output_data = output_data_base + i * dim_size;
-          scalar_t max_input = vec256::reduce_all<scalar_t>(
-              [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
+          scalar_t max_input = vec512::reduce_all<scalar_t>(
+              [](Vec& x, Vec& y) { return maximum(x, y); },
               input_data,
               dim_size);
-          vec256::map(
+          vec512::map(
               [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
               output_data,
               input_data,
               dim_size);
-          scalar_t tmp_sum = vec256::reduce_all<scalar_t>(
+          scalar_t tmp_sum = vec512::reduce_all<scalar_t>(
               [](Vec x, Vec y) { return x + y; }, output_data, dim_size);
           tmp_sum = 1 / tmp_sum;
-          vec256::map(
+          vec512::map(
               [tmp_sum](Vec x) { return x * Vec(tmp_sum); },
               output_data,
               output_data,
@@ -139,7 +141,7 @@ inline void _vec_host_softmax_backward_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec512::Vectorized<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -155,10 +157,10 @@ inline void _vec_host_softmax_backward_lastdim(
           scalar_t* output_data = output_data_base + i * dim_size;
           scalar_t sum;
           if (log_softmax) {
-            sum = vec256::reduce_all<scalar_t>(
+            sum = vec512::reduce_all<scalar_t>(
                 [](Vec& x, Vec& y) { return x + y; }, grad_data, dim_size);
           } else {
-            sum = vec256::map2_reduce_all<scalar_t>(
+            sum = vec512::map2_reduce_all<scalar_t>(
                 [](Vec x, Vec y) { return x * y; },
                 [](Vec x, Vec y) { return x + y; },
                 grad_data,
@@ -166,14 +168,14 @@ inline void _vec_host_softmax_backward_lastdim(
                 dim_size);
           }
           if (log_softmax) {
-            vec256::map2(
+            vec512::map2(
                 [sum](Vec x, Vec y) { return x - ((y.exp()) * Vec(sum)); },
                 grad_input_data,
                 grad_data,
                 output_data,
                 dim_size);
           } else {
-            vec256::map2(
+            vec512::map2(
                 [sum](Vec x, Vec y) { return (x - Vec(sum)) * y; },
                 grad_input_data,
                 grad_data,
@@ -184,6 +186,158 @@ inline void _vec_host_softmax_backward_lastdim(
       });
 }
 
+// See Note [BFloat16 kernels compute in float]. Each row is widened to float
+// once, the whole softmax runs on the float copy and the result is rounded
+// back to bfloat16 once.
+template <bool log_softmax>
+inline void _vec_bfloat16_softmax_lastdim(
+    const BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec512::Vectorized<float>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::vector<float> buffer(dim_size);
+        float* data = buffer.data();
+        for (int64_t i = begin; i < end; i++) {
+          vec256::convert(input_data_base + i * dim_size, data, dim_size);
+          float max_input = vec512::reduce_all<float>(
+              [](Vec& x, Vec& y) { return maximum(x, y); },
+              data,
+              dim_size);
+          if (log_softmax) {
+            float tmp_sum = vec512::map_reduce_all<float>(
+                [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+                [](Vec x, Vec y) { return x + y; },
+                data,
+                dim_size);
+            // See [Note AVX-SSE transitions]
+            vec512::map([](Vec x) { return x.log(); }, &tmp_sum, &tmp_sum, 1);
+            vec512::map(
+                [tmp_sum, max_input](Vec x) { return x - Vec(max_input) - Vec(tmp_sum); },
+                data,
+                data,
+                dim_size);
+          } else {
+            vec512::map(
+                [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+                data,
+                data,
+                dim_size);
+            float tmp_sum = vec512::reduce_all<float>(
+                [](Vec x, Vec y) { return x + y; }, data, dim_size);
+            tmp_sum = 1 / tmp_sum;
+            vec512::map(
+                [tmp_sum](Vec x) { return x * Vec(tmp_sum); },
+                data,
+                data,
+                dim_size);
+          }
+          vec256::convert(data, output_data_base + i * dim_size, dim_size);
+        }
+      });
+}
+
+inline void _vec_log_softmax_lastdim(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_bfloat16_softmax_lastdim</*log_softmax=*/true>(
+      input_data_base, output_data_base, outer_size, dim_size);
+}
+
+inline void _vec_softmax_lastdim(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_bfloat16_softmax_lastdim</*log_softmax=*/false>(
+      input_data_base, output_data_base, outer_size, dim_size);
+}
+
+template <bool log_softmax>
+inline void _vec_bfloat16_softmax_backward_lastdim(
+    BFloat16* grad_input_data_base,
+    const BFloat16* grad_data_base,
+    const BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec512::Vectorized<float>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::vector<float> buffer(2 * dim_size);
+        float* grad_data = buffer.data();
+        float* output_data = grad_data + dim_size;
+        for (int64_t i = begin; i < end; i++) {
+          vec256::convert(grad_data_base + i * dim_size, grad_data, dim_size);
+          vec256::convert(output_data_base + i * dim_size, output_data, dim_size);
+          float sum;
+          if (log_softmax) {
+            sum = vec512::reduce_all<float>(
+                [](Vec& x, Vec& y) { return x + y; }, grad_data, dim_size);
+            vec512::map2(
+                [sum](Vec x, Vec y) { return x - ((y.exp()) * Vec(sum)); },
+                grad_data,
+                grad_data,
+                output_data,
+                dim_size);
+          } else {
+            sum = vec512::map2_reduce_all<float>(
+                [](Vec x, Vec y) { return x * y; },
+                [](Vec x, Vec y) { return x + y; },
+                grad_data,
+                output_data,
+                dim_size);
+            vec512::map2(
+                [sum](Vec x, Vec y) { return (x - Vec(sum)) * y; },
+                grad_data,
+                grad_data,
+                output_data,
+                dim_size);
+          }
+          vec256::convert(grad_data, grad_input_data_base + i * dim_size, dim_size);
+        }
+      });
+}
+
+template <>
+inline void _vec_host_softmax_backward_lastdim<BFloat16, true>(
+    BFloat16* grad_input_data_base,
+    BFloat16* grad_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_bfloat16_softmax_backward_lastdim</*log_softmax=*/true>(
+      grad_input_data_base, grad_data_base, output_data_base, outer_size, dim_size);
+}
+
+template <>
+inline void _vec_host_softmax_backward_lastdim<BFloat16, false>(
+    BFloat16* grad_input_data_base,
+    BFloat16* grad_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_bfloat16_softmax_backward_lastdim</*log_softmax=*/false>(
+      grad_input_data_base, grad_data_base, output_data_base, outer_size, dim_size);
+}
+
 template <typename scalar_t, bool LogSoftMax>
 struct vec_host_softmax_lastdim {
   static void apply(Tensor& output, const Tensor& input) {
@@ -224,9 +378,10 @@ struct vec_host_softmax_backward_lastdim {
 };
 
 static void softmax_lastdim_kernel_impl(Tensor& result, const Tensor& self) {
-  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "softmax_lastdim_kernel_impl", [&] {
-    vec_host_softmax_lastdim<scalar_t, false>::apply(result, self);
-  });
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, self.scalar_type(),
+      "softmax_lastdim_kernel_impl",
+      [&] { vec_host_softmax_lastdim<scalar_t, false>::apply(result, self); });
 }
 
 static void log_softmax_lastdim_kernel_impl(
@@ -242,8 +397,9 @@ static void softmax_backward_lastdim_kernel_impl(
     Tensor& grad_input,
     const Tensor& grad,
     const Tensor& output) {
-  AT_DISPATCH_FLOATING_TYPES(
-      grad.scalar_type(), "softmax_backward_lastdim_kernel_impl", [&] {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, grad.scalar_type(),
+      "softmax_backward_lastdim_kernel_impl", [&] {
         vec_host_softmax_backward_lastdim<scalar_t, false>::apply(
             grad_input, grad, output);
       });
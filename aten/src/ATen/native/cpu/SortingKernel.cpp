@@ -2,6 +2,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/NumericUtils.h>
+#include <ATen/native/ParallelSort.h>
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
 
@@ -9,6 +10,97 @@ namespace at { namespace native {
 
 namespace {
 
+// Moves the top k elements of queue to its front, sorted if asked to
+template <typename scalar_t>
+void topk_select(
+    std::vector<std::pair<scalar_t, int64_t>>& queue,
+    int64_t k,
+    bool largest,
+    bool sorted) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  const int64_t n = queue.size();
+  auto use_partial_sort = k * 64 <= n;
+
+  // we want NaN to be sorted as top for numpy compatibility
+  if (use_partial_sort) {
+    if (largest) {
+      std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+        });
+    } else {
+      std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+        });
+    }
+  } else {
+    if (largest) {
+      std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+        });
+      if (sorted) {
+        std::sort(queue.begin(), queue.begin() + k - 1,
+          [](const elem_t& x, const elem_t& y) -> bool {
+            return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+          });
+      }
+    } else {
+      std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+        });
+      if (sorted) {
+        std::sort(queue.begin(), queue.begin() + k -1,
+          [](const elem_t& x, const elem_t& y) -> bool {
+            return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+          });
+      }
+    }
+  }
+}
+
+// topk of one large slice with all threads: every thread keeps the top k
+// of its chunk, and the top k of those candidates is the answer.
+// See Note [Parallel sort]
+template <typename scalar_t>
+void topk_parallel_slice(
+    TensorAccessor<scalar_t, 1> tmp_values,
+    TensorAccessor<scalar_t, 1> mode_values,
+    TensorAccessor<int64_t, 1> mode_indices,
+    int64_t k,
+    bool largest,
+    bool sorted) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  const int64_t n = tmp_values.size(0);
+  const int64_t nchunks = std::min<int64_t>(at::get_num_threads(), n / kParallelSortMinSize + 1);
+  std::vector<std::vector<elem_t>> candidates(nchunks);
+  parallel_chunks(n, nchunks, [&](int64_t c, int64_t begin, int64_t end) {
+    auto& queue = candidates[c];
+    queue.resize(end - begin);
+    for (int64_t j = begin; j < end; j++) {
+      queue[j - begin].first = tmp_values[j];
+      queue[j - begin].second = j;
+    }
+    const int64_t chunk_k = std::min<int64_t>(k, end - begin);
+    if (chunk_k > 0) {
+      topk_select(queue, chunk_k, largest, /*sorted=*/false);
+    }
+    queue.resize(chunk_k);
+  });
+
+  std::vector<elem_t> queue;
+  for (const auto& chunk : candidates) {
+    queue.insert(queue.end(), chunk.begin(), chunk.end());
+  }
+  topk_select(queue, k, largest, sorted);
+  for (int64_t j = 0; j < k; j++) {
+    mode_values[j] = queue[j].first;
+    mode_indices[j] = queue[j].second;
+  }
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -17,7 +109,26 @@ static void topk_kernel(
     int64_t dim,
     bool largest,
     bool sorted) {
+  const int64_t n = self.size(dim);
+  const int64_t nslices = dim_apply_size(self, dim);
+  // A few large slices leave threads idle in dim_apply; give each slice all
+  // of them instead.
+  const bool parallel_slices =
+      n >= kParallelSortMinSize && k > 0 && nslices < at::get_num_threads();
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
+    if (parallel_slices) {
+      dim_apply_sequential(
+          {self, values, indices},
+          dim,
+          [&](int64_t i, TensorList tl) {
+            topk_parallel_slice(
+                tl[0].accessor<scalar_t, 1>(),
+                tl[1].accessor<scalar_t, 1>(),
+                tl[2].accessor<int64_t, 1>(),
+                k, largest, sorted);
+          });
+      return;
+    }
     dim_apply(
         {self, values, indices},
         dim,
@@ -27,53 +138,13 @@ static void topk_kernel(
           auto mode_indices = tl[2].accessor<int64_t, 1>();
 
           auto n = tmp_values.size(0);
-          auto use_partial_sort = k * 64 <= n;
-
           using elem_t = std::pair<scalar_t, int64_t>;
           std::vector<elem_t> queue(n);
           for (int64_t j = 0; j < n; j++) {
             queue[j].first = tmp_values[j];
             queue[j].second = j;
           }
-
-          // we want NaN to be sorted as top for numpy compatibility
-          if (use_partial_sort) {
-            if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-            } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-            }
-          } else {
-            if (largest) {
-              std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k - 1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                  });
-              }
-            } else {
-              std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k -1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                  });
-              }
-            }
-          }
+          topk_select(queue, k, largest, sorted);
 
           for (int64_t j = 0; j < k; j++) {
             mode_values[j] = queue[j].first;
@@ -0,0 +1,153 @@
+#include <ATen/native/SparseOptimizers.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <vector>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Every distinct row is updated by one thread, so the rows of the parameter
+// and of the state need no synchronization. A row with a single gradient row
+// reads it in place; duplicates are summed into a per-thread buffer first.
+template <typename scalar_t, typename RowUpdate>
+void for_each_gradient_row(
+    const Tensor& values, const Tensor& rows, const Tensor& order,
+    const Tensor& row_offsets, const RowUpdate& update) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t D = values.size(1);
+  const int64_t num_rows = rows.numel();
+  const scalar_t* values_data = values.data_ptr<scalar_t>();
+  const int64_t* rows_data = rows.data_ptr<int64_t>();
+  const int64_t* order_data = order.data_ptr<int64_t>();
+  const int64_t* offsets_data = row_offsets.data_ptr<int64_t>();
+
+  const int64_t work_per_row = std::max<int64_t>(1, values.size(0) / std::max<int64_t>(num_rows, 1) * D);
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_row);
+  at::parallel_for(0, num_rows, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> buffer(D);
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t first = offsets_data[i];
+      const int64_t last = offsets_data[i + 1];
+      const scalar_t* g = values_data + order_data[first] * D;
+      if (last - first > 1) {
+        std::copy(g, g + D, buffer.data());
+        for (int64_t k = first + 1; k < last; k++) {
+          const scalar_t* other = values_data + order_data[k] * D;
+          for (int64_t j = 0; j < D; j += Vec::size()) {
+            const int64_t n = std::min<int64_t>(Vec::size(), D - j);
+            (Vec::loadu(buffer.data() + j, n) + Vec::loadu(other + j, n)).store(buffer.data() + j, n);
+          }
+        }
+        g = buffer.data();
+      }
+      update(rows_data[i], g);
+    }
+  });
+}
+
+void sparse_adagrad_kernel(
+    Tensor& param, Tensor& state_sum, const Tensor& values, const Tensor& rows,
+    const Tensor& order, const Tensor& row_offsets, double lr, double eps) {
+  AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "sparse_adagrad", [&] {
+    using Vec = vec256::Vec256<scalar_t>;
+    const int64_t D = param.size(1);
+    scalar_t* param_data = param.data_ptr<scalar_t>();
+    scalar_t* sum_data = state_sum.data_ptr<scalar_t>();
+    const Vec lr_vec(static_cast<scalar_t>(lr));
+    const Vec eps_vec(static_cast<scalar_t>(eps));
+    for_each_gradient_row<scalar_t>(values, rows, order, row_offsets, [&](int64_t row, const scalar_t* g) {
+      scalar_t* p = param_data + row * D;
+      scalar_t* s = sum_data + row * D;
+      for (int64_t j = 0; j < D; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), D - j);
+        const Vec g_vec = Vec::loadu(g + j, n);
+        const Vec s_vec = Vec::loadu(s + j, n) + g_vec * g_vec;
+        s_vec.store(s + j, n);
+        (Vec::loadu(p + j, n) - lr_vec * g_vec / (s_vec.sqrt() + eps_vec)).store(p + j, n);
+      }
+    });
+  });
+}
+
+void rowwise_adagrad_kernel(
+    Tensor& param, Tensor& state_sum, const Tensor& values, const Tensor& rows,
+    const Tensor& order, const Tensor& row_offsets, double lr, double eps) {
+  AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "rowwise_adagrad", [&] {
+    using Vec = vec256::Vec256<scalar_t>;
+    const int64_t D = param.size(1);
+    scalar_t* param_data = param.data_ptr<scalar_t>();
+    scalar_t* sum_data = state_sum.data_ptr<scalar_t>();
+    for_each_gradient_row<scalar_t>(values, rows, order, row_offsets, [&](int64_t row, const scalar_t* g) {
+      scalar_t* p = param_data + row * D;
+      Vec acc(scalar_t(0));
+      int64_t j = 0;
+      for (; j + Vec::size() <= D; j += Vec::size()) {
+        const Vec g_vec = Vec::loadu(g + j);
+        acc = acc + g_vec * g_vec;
+      }
+      scalar_t acc_lanes[Vec::size()];
+      acc.store(acc_lanes);
+      scalar_t squared_sum = 0;
+      for (int64_t k = 0; k < Vec::size(); k++) {
+        squared_sum += acc_lanes[k];
+      }
+      for (; j < D; j++) {
+        squared_sum += g[j] * g[j];
+      }
+      sum_data[row] += squared_sum / D;
+      const Vec step(static_cast<scalar_t>(lr / (std::sqrt(sum_data[row]) + eps)));
+      for (int64_t j = 0; j < D; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), D - j);
+        (Vec::loadu(p + j, n) - step * Vec::loadu(g + j, n)).store(p + j, n);
+      }
+    });
+  });
+}
+
+void sparse_adam_kernel(
+    Tensor& param, Tensor& exp_avg, Tensor& exp_avg_sq, const Tensor& values,
+    const Tensor& rows, const Tensor& order, const Tensor& row_offsets,
+    double step_size, double beta1, double beta2, double eps) {
+  AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "sparse_adam", [&] {
+    using Vec = vec256::Vec256<scalar_t>;
+    const int64_t D = param.size(1);
+    scalar_t* param_data = param.data_ptr<scalar_t>();
+    scalar_t* m_data = exp_avg.data_ptr<scalar_t>();
+    scalar_t* v_data = exp_avg_sq.data_ptr<scalar_t>();
+    const Vec step_vec(static_cast<scalar_t>(step_size));
+    const Vec beta1_vec(static_cast<scalar_t>(beta1));
+    const Vec beta2_vec(static_cast<scalar_t>(beta2));
+    const Vec one_minus_beta1(static_cast<scalar_t>(1 - beta1));
+    const Vec one_minus_beta2(static_cast<scalar_t>(1 - beta2));
+    const Vec eps_vec(static_cast<scalar_t>(eps));
+    for_each_gradient_row<scalar_t>(values, rows, order, row_offsets, [&](int64_t row, const scalar_t* g) {
+      scalar_t* p = param_data + row * D;
+      scalar_t* m = m_data + row * D;
+      scalar_t* v = v_data + row * D;
+      for (int64_t j = 0; j < D; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), D - j);
+        const Vec g_vec = Vec::loadu(g + j, n);
+        const Vec m_vec = beta1_vec * Vec::loadu(m + j, n) + one_minus_beta1 * g_vec;
+        const Vec v_vec = beta2_vec * Vec::loadu(v + j, n) + one_minus_beta2 * g_vec * g_vec;
+        m_vec.store(m + j, n);
+        v_vec.store(v + j, n);
+        (Vec::loadu(p + j, n) - step_vec * m_vec / (v_vec.sqrt() + eps_vec)).store(p + j, n);
+      }
+    });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(sparse_adagrad_stub, &sparse_adagrad_kernel);
+REGISTER_DISPATCH(rowwise_adagrad_stub, &rowwise_adagrad_kernel);
+REGISTER_DISPATCH(sparse_adam_stub, &sparse_adam_kernel);
+
+} // namespace native
+} // namespace at
@@ -1,4 +1,5 @@
 #include <ATen/Dispatch.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/ReduceOps.h>
 #include <ATen/native/cpu/Reduce.h>
@@ -11,39 +12,73 @@ namespace at {
 namespace native {
 namespace {
 
-template <typename scalar_t>
+// Loads an acc_t from memory holding scalar_t values
+template <typename acc_t, typename scalar_t>
 struct LoadImpl {
-  static scalar_t load(const char * C10_RESTRICT data, int64_t stride, int64_t index) {
+  static acc_t load(const char * C10_RESTRICT data, int64_t stride, int64_t index) {
     auto *ptr = reinterpret_cast<const scalar_t*>(data + index * stride);
-    return *ptr;
+    return static_cast<acc_t>(*ptr);
   }
 };
 
 template <typename scalar_t>
-struct LoadImpl<Vec256<scalar_t>> {
+struct LoadImpl<Vec256<scalar_t>, scalar_t> {
   static Vec256<scalar_t> load(const char * C10_RESTRICT data, int64_t stride, int64_t index) {
     auto *ptr = data + index * stride;
     return Vec256<scalar_t>::loadu(ptr);
   }
 };
 
-template <typename T>
-T load(const char * C10_RESTRICT data, int64_t stride, int64_t index) {
-  return LoadImpl<T>::load(data, stride, index);
+template <typename scalar_t>
+struct LoadImpl<vec512::Vec512<scalar_t>, scalar_t> {
+  static vec512::Vec512<scalar_t> load(const char * C10_RESTRICT data, int64_t stride, int64_t index) {
+    auto *ptr = data + index * stride;
+    return vec512::Vec512<scalar_t>::loadu(ptr);
+  }
+};
+
+// See Note [BFloat16 kernels compute in float]
+template <>
+struct LoadImpl<Vec256<float>, BFloat16> {
+  static Vec256<float> load(const char * C10_RESTRICT data, int64_t stride, int64_t index) {
+    auto *ptr = reinterpret_cast<const BFloat16*>(data + index * stride);
+    Vec256<float> result;
+    load_fp32_from_bf16(ptr, result);
+    return result;
+  }
+};
+
+template <typename acc_t, typename scalar_t = acc_t>
+acc_t load(const char * C10_RESTRICT data, int64_t stride, int64_t index) {
+  return LoadImpl<acc_t, scalar_t>::load(data, stride, index);
 }
 
+// The types a sum over scalar_t accumulates in: bfloat16 sums accumulate in
+// float, everything else in its own type.
+template <typename scalar_t>
+struct SumAccType {
+  using type = scalar_t;
+  using vec = vec512::Vectorized<scalar_t>;
+};
+
+template <>
+struct SumAccType<BFloat16> {
+  using type = float;
+  using vec = Vec256<float>;
+};
+
 template <typename scalar_t>
 void accumulate_result(char * C10_RESTRICT data, int64_t stride, int64_t index, scalar_t value) {
   auto * ptr = reinterpret_cast<scalar_t*>(data + index * stride);
   *ptr += value;
 }
 
-template <typename scalar_t, size_t numel>
+template <typename scalar_t, typename acc_t, size_t numel>
 void accumulate_result(char * C10_RESTRICT data, int64_t stride, int64_t index,
-    const std::array<scalar_t, numel> &values) {
+    const std::array<acc_t, numel> &values) {
   auto *base_ptr = data + stride * index;
   for (int64_t k = 0; k < numel; ++k) {
-    accumulate_result(base_ptr, stride, k, values[k]);
+    accumulate_result<scalar_t>(base_ptr, stride, k, values[k]);
   }
 }
 
@@ -91,8 +126,8 @@ A simplified recursive implementation would look like this:
     return sum;
   }
 */
-template <typename scalar_t, int64_t nrows>
-std::array<scalar_t, nrows> multi_row_sum(
+template <typename acc_t, int64_t nrows, typename scalar_t = acc_t>
+std::array<acc_t, nrows> multi_row_sum(
     const char * C10_RESTRICT in_data,
     const int64_t row_stride,
     const int64_t col_stride,
@@ -104,8 +139,8 @@ std::array<scalar_t, nrows> multi_row_sum(
   const int64_t level_step = (1 << level_power);
   const int64_t level_mask = level_step - 1;
 
-  scalar_t acc[num_levels][nrows];
-  std::fill_n(&acc[0][0], num_levels * nrows, scalar_t(0));
+  acc_t acc[num_levels][nrows];
+  std::fill_n(&acc[0][0], num_levels * nrows, acc_t(0));
 
   int64_t i = 0;
   for (; i + level_step <= size;) {
@@ -113,7 +148,7 @@ std::array<scalar_t, nrows> multi_row_sum(
       const char * sum_base = in_data + i * row_stride;
       #pragma unroll
       for (int64_t k = 0; k < nrows; ++k) {
-        acc[0][k] += load<scalar_t>(sum_base, col_stride, k);
+        acc[0][k] += load<acc_t, scalar_t>(sum_base, col_stride, k);
       }
     }
 
@@ -121,7 +156,7 @@ std::array<scalar_t, nrows> multi_row_sum(
       #pragma unroll
       for (int64_t k = 0; k < nrows; ++k) {
         acc[j][k] += acc[j-1][k];
-        acc[j-1][k] = scalar_t(0);
+        acc[j-1][k] = acc_t(0);
       }
 
       const auto mask = (level_mask << (j * level_power));
@@ -135,7 +170,7 @@ std::array<scalar_t, nrows> multi_row_sum(
     const char * sum_base = in_data + i * row_stride;
     #pragma unroll
     for (int64_t k = 0; k < nrows; ++k) {
-      acc[0][k] += load<scalar_t>(sum_base, col_stride, k);
+      acc[0][k] += load<acc_t, scalar_t>(sum_base, col_stride, k);
     }
   }
 
@@ -146,25 +181,25 @@ std::array<scalar_t, nrows> multi_row_sum(
     }
   }
 
-  std::array<scalar_t, nrows> ret;
+  std::array<acc_t, nrows> ret;
   for (int64_t k = 0; k < nrows; ++k) {
     ret[k] = acc[0][k];
   }
   return ret;
 }
 
-template <typename scalar_t>
-scalar_t row_sum(const char * C10_RESTRICT in_data,
-                 const int64_t in_stride, const int64_t size) {
+template <typename acc_t, typename scalar_t = acc_t>
+acc_t row_sum(const char * C10_RESTRICT in_data,
+              const int64_t in_stride, const int64_t size) {
   constexpr int64_t ilp_factor = 4;
 
   // Interpret row as a (-1, ilp_factor) shaped array to find partial sums
   const int64_t size_ilp = size / ilp_factor;
-  auto partial_sums = multi_row_sum<scalar_t, ilp_factor>(
+  auto partial_sums = multi_row_sum<acc_t, ilp_factor, scalar_t>(
       in_data, in_stride * ilp_factor, in_stride, size_ilp);
 
   for (int64_t i = size_ilp * ilp_factor; i < size; ++i) {
-    partial_sums[0] += load<scalar_t>(in_data, in_stride, i);
+    partial_sums[0] += load<acc_t, scalar_t>(in_data, in_stride, i);
   }
 
   for (int64_t k = 1; k < ilp_factor; ++k) {
@@ -178,26 +213,27 @@ template <typename scalar_t>
 void vectorized_inner_sum(
     char * C10_RESTRICT data[2], int64_t outer_stride, int64_t out_stride,
     int64_t size0, int64_t size1) {
-  using vec_t = Vec256<scalar_t>;
+  using acc_t = typename SumAccType<scalar_t>::type;
+  using vec_t = typename SumAccType<scalar_t>::vec;
   constexpr int64_t vec_stride = vec_t::size() * sizeof(scalar_t);
   const int64_t vec_size = size0 / vec_t::size();
 
   // Input is contiguous over the first (reduced) dimension
   for (int64_t j = 0; j < size1; ++j) {
     const auto *row_in = data[1] + j * outer_stride;
-    auto vec_acc = row_sum<vec_t>(row_in, vec_stride, vec_size);
+    auto vec_acc = row_sum<vec_t, scalar_t>(row_in, vec_stride, vec_size);
 
-    scalar_t final_acc = 0;
+    acc_t final_acc = 0;
     for (int64_t k = vec_size * vec_t::size(); k < size0; ++k) {
-      final_acc += load<scalar_t>(row_in, sizeof(scalar_t), k);
+      final_acc += load<acc_t, scalar_t>(row_in, sizeof(scalar_t), k);
     }
 
-    scalar_t partials[vec_t::size()];
+    acc_t partials[vec_t::size()];
     vec_acc.store(partials);
     for (int64_t k = 0; k < vec_t::size(); ++k) {
       final_acc += partials[k];
     }
-    accumulate_result(data[0], out_stride, j, final_acc);
+    accumulate_result<scalar_t>(data[0], out_stride, j, final_acc);
   }
 }
 
@@ -205,10 +241,11 @@ template <typename scalar_t>
 void scalar_inner_sum(
     char * C10_RESTRICT data[2], int64_t in_strides[2], int64_t out_stride,
     int64_t size0, int64_t size1) {
+  using acc_t = typename SumAccType<scalar_t>::type;
   for (int64_t j = 0; j < size1; ++j) {
     const auto *row_in = data[1] + j * in_strides[1];
-    scalar_t ans = row_sum<scalar_t>(row_in, in_strides[0], size0);
-    accumulate_result(data[0], out_stride, j, ans);
+    acc_t ans = row_sum<acc_t, scalar_t>(row_in, in_strides[0], size0);
+    accumulate_result<scalar_t>(data[0], out_stride, j, ans);
   }
 }
 
@@ -216,7 +253,8 @@ template <typename scalar_t>
 void vectorized_outer_sum(
     char * C10_RESTRICT data[2], int64_t inner_stride, int64_t out_stride,
     int64_t size0, int64_t size1) {
-  using vec_t = Vec256<scalar_t>;
+  using acc_t = typename SumAccType<scalar_t>::type;
+  using vec_t = typename SumAccType<scalar_t>::vec;
   constexpr int64_t nrows = 4;
   constexpr int64_t vec_stride = vec_t::size() * sizeof(scalar_t);
 
@@ -224,30 +262,30 @@ void vectorized_outer_sum(
   int64_t j = 0;
   for (; j + nrows * vec_t::size() <= size1; j += nrows * vec_t::size()) {
     const auto *row_in = data[1] + j * sizeof(scalar_t);
-    auto sums = multi_row_sum<vec_t, nrows>(row_in, inner_stride, vec_stride, size0);
+    auto sums = multi_row_sum<vec_t, nrows, scalar_t>(row_in, inner_stride, vec_stride, size0);
 
     for (int64_t i = 0; i < nrows; ++i) {
       const int64_t base_idx = j + i * vec_t::size();
 
-      std::array<scalar_t, vec_t::size()> ans;
+      std::array<acc_t, vec_t::size()> ans;
       sums[i].store(ans.data());
-      accumulate_result(data[0], out_stride, base_idx, ans);
+      accumulate_result<scalar_t>(data[0], out_stride, base_idx, ans);
     }
   }
 
   for (; j + vec_t::size() <= size1; j += vec_t::size()) {
     const auto *row_in = data[1] + j * sizeof(scalar_t);
-    const vec_t sums = row_sum<vec_t>(row_in, inner_stride, size0);
+    const vec_t sums = row_sum<vec_t, scalar_t>(row_in, inner_stride, size0);
 
-    std::array<scalar_t, vec_t::size()> ans;
+    std::array<acc_t, vec_t::size()> ans;
     sums.store(ans.data());
-    accumulate_result(data[0], out_stride, j, ans);
+    accumulate_result<scalar_t>(data[0], out_stride, j, ans);
   }
 
   for (; j < size1; ++j) {
     const auto *row_in = data[1] + j * sizeof(scalar_t);
-    scalar_t ans = row_sum<scalar_t>(row_in, inner_stride, size0);
-    accumulate_result(data[0], out_stride, j, ans);
+    acc_t ans = row_sum<acc_t, scalar_t>(row_in, inner_stride, size0);
+    accumulate_result<scalar_t>(data[0], out_stride, j, ans);
   }
 }
 
@@ -255,20 +293,20 @@ template <typename scalar_t>
 void scalar_outer_sum(
     char * C10_RESTRICT data[2], int64_t in_strides[2], int64_t out_stride,
     int64_t size0, int64_t size1) {
-
+  using acc_t = typename SumAccType<scalar_t>::type;
   constexpr int64_t nrows = 4;
   int64_t j = 0;
   for (; j + (nrows - 1) < size1; j += nrows) {
     const auto *row_in = data[1] + j * in_strides[1];
-    auto sums = multi_row_sum<scalar_t, nrows>(
+    auto sums = multi_row_sum<acc_t, nrows, scalar_t>(
         row_in, in_strides[0], in_strides[1], size0);
-    accumulate_result(data[0], out_stride, j, sums);
+    accumulate_result<scalar_t>(data[0], out_stride, j, sums);
   }
 
   for (; j < size1; ++j) {
     const auto *row_in = data[1] + j * in_strides[1];
-    scalar_t ans = row_sum<scalar_t>(row_in, in_strides[0], size0);
-    accumulate_result(data[0], out_stride, j, ans);
+    acc_t ans = row_sum<acc_t, scalar_t>(row_in, in_strides[0], size0);
+    accumulate_result<scalar_t>(data[0], out_stride, j, ans);
   }
 }
 
@@ -314,10 +352,10 @@ void sum_kernel_impl(TensorIterator &iter) {
           const int64_t out_stride = out_strides[1];
           TORCH_INTERNAL_ASSERT(out_strides[0] == 0);
 
-          if (in_strides[0] == sizeof(scalar_t) && size0 >= Vec256<scalar_t>::size()) {
+          if (in_strides[0] == sizeof(scalar_t) && size0 >= SumAccType<scalar_t>::vec::size()) {
             // Contiguous inner reduction
             vectorized_inner_sum<scalar_t>(data, in_strides[1], out_stride, size0, size1);
-          } else if (in_strides[1] == sizeof(scalar_t) && size1 >= Vec256<scalar_t>::size()) {
+          } else if (in_strides[1] == sizeof(scalar_t) && size1 >= SumAccType<scalar_t>::vec::size()) {
             // Contiguous outer reduction
             vectorized_outer_sum<scalar_t>(data, in_strides[0], out_stride, size0, size1);
           } else if (in_strides[0] < in_strides[1]) {
@@ -7,10 +7,12 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/NumericUtils.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <c10/util/Optional.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/ReduceOpsUtils.h>
 #include <ATen/native/cpu/Loops.h>
+#include <ATen/native/cpu/zmath.h>
 
 namespace at { namespace native { namespace {
 
@@ -69,6 +71,72 @@ static inline void compare_base_kernel(Tensor& result, Tensor& indices,
   }
 }
 
+// max(dim) and min(dim) along a contiguous dim, for real types: finds the
+// extreme value of kArgExtremeBlock elements at a time with Vec256 and only
+// scans a block element by element when it beats the running result,
+// which finds the same first maximum (minimum), or first NaN, as the
+// scalar loop while comparing whole vectors. The block is still in L1 for
+// the scan, so the input is read from memory once.
+constexpr int64_t kArgExtremeBlock = 256;
+
+template <typename scalar_t>
+struct has_vec_arg_extreme : std::integral_constant<bool,
+    std::is_floating_point<scalar_t>::value ||
+    (std::is_integral<scalar_t>::value && !std::is_same<scalar_t, bool>::value)> {};
+
+template <bool is_max, typename scalar_t>
+static inline scalar_t extreme_impl(scalar_t a, scalar_t b) {
+  return is_max ? max_impl(a, b) : min_impl(a, b);
+}
+
+template <bool is_max, typename scalar_t>
+static inline typename std::enable_if<!has_vec_arg_extreme<scalar_t>::value, bool>::type
+contiguous_arg_extreme(const scalar_t* /*data*/, int64_t /*n*/, scalar_t* /*value*/, int64_t* /*index*/) {
+  return false;
+}
+
+template <bool is_max, typename scalar_t>
+static inline typename std::enable_if<has_vec_arg_extreme<scalar_t>::value, bool>::type
+contiguous_arg_extreme(const scalar_t* data, int64_t n, scalar_t* value, int64_t* index) {
+  using Vec = vec256::Vec256<scalar_t>;
+  scalar_t best = data[0];
+  int64_t best_index = 0;
+  for (int64_t begin = 0; begin < n && !_isnan(best); begin += kArgExtremeBlock) {
+    const scalar_t* block = data + begin;
+    const int64_t len = std::min(kArgExtremeBlock, n - begin);
+    scalar_t block_best = block[0];
+    int64_t j = 1;
+    if (len >= Vec::size()) {
+      Vec acc = Vec::loadu(block);
+      for (j = Vec::size(); j + Vec::size() <= len; j += Vec::size()) {
+        acc = is_max ? vec256::maximum(acc, Vec::loadu(block + j)) : vec256::minimum(acc, Vec::loadu(block + j));
+      }
+      scalar_t lanes[Vec::size()];
+      acc.store(lanes);
+      for (int64_t k = 0; k < Vec::size(); k++) {
+        block_best = extreme_impl<is_max>(block_best, lanes[k]);
+      }
+    }
+    for (; j < len; j++) {
+      block_best = extreme_impl<is_max>(block_best, block[j]);
+    }
+
+    const bool is_nan = _isnan(block_best);
+    if (is_nan || (is_max ? block_best > best : block_best < best)) {
+      for (j = 0; j < len; j++) {
+        if (is_nan ? _isnan(block[j]) : block[j] == block_best) {
+          break;
+        }
+      }
+      best = block[j];
+      best_index = begin + j;
+    }
+  }
+  *value = best;
+  *index = best_index;
+  return true;
+}
+
 static void min_kernel_impl(
     Tensor& result,
     Tensor& indice,
@@ -85,6 +153,10 @@ static void min_kernel_impl(
     compare_base_kernel<scalar_t>(result, indice, self, wrap_dim, keepdim, [&] (
       scalar_t* result_data, int64_t* indice_data,
       const scalar_t* self_data, auto self_dim_stride) {
+        if (self_dim_stride == 1 &&
+            contiguous_arg_extreme</*is_max=*/false>(self_data, self_dim_size, result_data, indice_data)) {
+          return;
+        }
         using value_t = typename c10::scalar_value_type<scalar_t>::type;
         value_t (*zabs_)(scalar_t) = zabs<scalar_t, value_t>;
         scalar_t min_number = self_data[0];
@@ -122,6 +194,10 @@ static void max_kernel_impl(
     compare_base_kernel<scalar_t>(result, indice, self, wrap_dim, keepdim, [&] (
       scalar_t* result_data, int64_t* indice_data,
       const scalar_t* self_data, auto self_dim_stride) {
+        if (self_dim_stride == 1 &&
+            contiguous_arg_extreme</*is_max=*/true>(self_data, self_dim_size, result_data, indice_data)) {
+          return;
+        }
         using value_t = typename c10::scalar_value_type<scalar_t>::type;
         value_t (*zabs_)(scalar_t) = zabs<scalar_t, value_t>;
         scalar_t max_number = self_data[0];
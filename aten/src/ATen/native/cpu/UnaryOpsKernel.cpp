@@ -13,6 +13,8 @@
 #include <ATen/core/DistributionsHelper.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/vec256_math.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <ATen/cpu/vml.h>
 #include <ATen/native/Distributions.h>
 #include <ATen/native/Math.h>
@@ -32,16 +34,26 @@ namespace native {
 namespace {
 
 using namespace vec256;
+using namespace vec512;
 
 static void sigmoid_kernel(TensorIterator& iter) {
+  if (iter.dtype() == kFloat && at::globalContext().allowFastMathCPU()) {
+    // See Note [Vectorized math accuracy]
+    using Math = VecMath<float, MathAccuracy::Fast, Vectorized<float>>;
+    cpu_kernel_vec(
+        iter,
+        [=](float a) -> float { return 1.f / (1.f + std::exp(-a)); },
+        [=](Vectorized<float> a) { return Math::sigmoid(a); });
+    return;
+  }
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), "sigmoid_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return (static_cast<scalar_t>(1) / (static_cast<scalar_t>(1) + std::exp((-a)))); },
-        [=](Vec256<scalar_t> a) {
-          a = Vec256<scalar_t>(static_cast<scalar_t>(0)) - a;
+        [=](Vectorized<scalar_t> a) {
+          a = Vectorized<scalar_t>(static_cast<scalar_t>(0)) - a;
           a = a.exp();
-          a = Vec256<scalar_t>(static_cast<scalar_t>(1)) + a;
+          a = Vectorized<scalar_t>(static_cast<scalar_t>(1)) + a;
           a = a.reciprocal();
           return a;
         });
@@ -170,7 +182,7 @@ static void abs_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return abs_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.abs(); });
+        [=](Vectorized<scalar_t> a) { return a.abs(); });
   });
 }
 
@@ -256,7 +268,7 @@ static void reciprocal_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return static_cast<scalar_t>(1.0) / a; },
-        [=](Vec256<scalar_t> a) { return a.reciprocal(); });
+        [=](Vectorized<scalar_t> a) { return a.reciprocal(); });
   });
 }
 
@@ -265,7 +277,7 @@ static void neg_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return -a; },
-        [=](Vec256<scalar_t> a) { return a.neg(); });
+        [=](Vectorized<scalar_t> a) { return a.neg(); });
   });
 }
 
@@ -363,11 +375,11 @@ static void clamp_kernel(TensorIterator& iter, Scalar min_scalar, Scalar max_sca
     c10::scalar_value_type<scalar_t>::type (*zabs_)(scalar_t) = zabs;
     auto min = min_scalar.to<scalar_t>();
     auto max = max_scalar.to<scalar_t>();
-    auto min_vec = Vec256<scalar_t>(min);
-    auto max_vec = Vec256<scalar_t>(max);
+    auto min_vec = Vectorized<scalar_t>(min);
+    auto max_vec = Vectorized<scalar_t>(max);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) < zabs_(min) ? min : (zabs_(a) > zabs_(max) ? max : a); },
-     [=](Vec256<scalar_t> a) { return vec256::clamp(a, min_vec, max_vec); });
+     [=](Vectorized<scalar_t> a) { return clamp(a, min_vec, max_vec); });
   });
 }
 
@@ -375,10 +387,10 @@ static void clamp_max_kernel(TensorIterator& iter, Scalar max_scalar) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "clamp_max_cpu", [&]() {
     c10::scalar_value_type<scalar_t>::type (*zabs_)(scalar_t) = zabs;
     auto max = max_scalar.to<scalar_t>();
-    auto max_vec = Vec256<scalar_t>(max);
+    auto max_vec = Vectorized<scalar_t>(max);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) > zabs_(max) ? max : a; },
-     [=](Vec256<scalar_t> a) { return vec256::clamp_max(a, max_vec); });
+     [=](Vectorized<scalar_t> a) { return clamp_max(a, max_vec); });
   });
 }
 
@@ -386,10 +398,10 @@ static void clamp_min_kernel(TensorIterator& iter, Scalar min_scalar) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "clamp_min_cpu", [&]() {
     c10::scalar_value_type<scalar_t>::type (*zabs_)(scalar_t) = zabs;
     auto min = min_scalar.to<scalar_t>();
-    auto min_vec = Vec256<scalar_t>(min);
+    auto min_vec = Vectorized<scalar_t>(min);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) < zabs_(min) ? min : a; },
-     [=](Vec256<scalar_t> a) { return vec256::clamp_min(a, min_vec); });
+     [=](Vectorized<scalar_t> a) { return clamp_min(a, min_vec); });
   });
 }
 
@@ -414,7 +426,10 @@ void bernoulli_scalar_kernel(Tensor& self, double p, c10::optional<Generator> ge
 }
 #else
 void bernoulli_scalar_kernel(Tensor &self, double p, c10::optional<Generator> gen) {
-  if (cpuinfo_initialize() && cpuinfo_vendor_intel == cpuinfo_get_processor(0)->core->vendor) {
+  // See Note [Parallel CPU random numbers]
+  const bool parallel_rng = at::globalContext().parallelCPURNG() && self.is_contiguous();
+  if (!parallel_rng && cpuinfo_initialize() &&
+      cpuinfo_vendor_intel == cpuinfo_get_processor(0)->core->vendor) {
     CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
     int64_t seed;
     {
@@ -520,7 +535,7 @@ static void rsqrt_kernel(TensorIterator& iter) {
         [=](scalar_t a) -> scalar_t {
           return (static_cast<scalar_t>(1)) / std::sqrt(a);
         },
-        [=](Vec256<scalar_t> a) { return a.rsqrt(); });
+        [=](Vectorized<scalar_t> a) { return a.rsqrt(); });
   });
 }
 
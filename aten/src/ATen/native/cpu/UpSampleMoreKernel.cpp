@@ -347,6 +347,87 @@ void cpu_upsample_linear_channels_last(
   }
 }
 
+template <typename scalar_t, typename scale_type>
+void cpu_upsample_linear_backward_channels_last(
+    Tensor& grad_input_,
+    const Tensor& grad_output_,
+    bool align_corners,
+    const scale_type& scales) {
+  TORCH_CHECK(grad_input_.dtype() == grad_output_.dtype(), "expected dtype ", grad_output_.dtype(),
+              " for `grad_input` but got dtype ", grad_input_.dtype());
+  TORCH_CHECK(grad_input_.dim() == 4, "Upsample backward with NHWC format supports tensors with 4 dims.")
+
+  auto grad_output = grad_output_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto grad_input = grad_input_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  auto grad_output_data = grad_output.data_ptr<scalar_t>();
+  auto grad_input_data = grad_input.data_ptr<scalar_t>();
+
+  int64_t num_batches = grad_input.size(0);
+  int64_t channels = grad_input.size(1);
+  int64_t input_height = grad_input.size(2);
+  int64_t output_height = grad_output.size(2);
+  int64_t input_width = grad_input.size(3);
+  int64_t output_width = grad_output.size(3);
+
+  TORCH_CHECK(channels > 0, "expected input and output channels greater than 0 but got ", channels);
+  int64_t input_slice_size = input_height * input_width * channels;
+  int64_t output_slice_size = output_height * output_width * channels;
+
+  using Vec = vec256::Vec256<scalar_t>;
+  // output pixels of one image share input pixels, so images are the unit
+  // of parallelism
+  auto loop2d = [&](int64_t begin, int64_t end) {
+    const scalar_t height_scale = area_pixel_compute_scale<scalar_t>(
+        input_height, output_height, align_corners, scales[0]);
+    const scalar_t width_scale = area_pixel_compute_scale<scalar_t>(
+        input_width, output_width, align_corners, scales[1]);
+
+    auto input_indexr = [=](int64_t n, int64_t h, int64_t w) {
+      return grad_input_data + n * input_slice_size +
+          h * input_width * channels + w * channels;
+    };
+
+    // gin[0:size] += lambda * gout[0:size]
+    auto add_scaled = [](scalar_t* gin, const scalar_t* gout, scalar_t lambda, int64_t size) {
+      int64_t d = 0;
+      for (; d < size - (size % Vec::size()); d += Vec::size()) {
+        Vec gin_vec = Vec::loadu(gin + d) + Vec(lambda) * Vec::loadu(gout + d);
+        gin_vec.store(gin + d);
+      }
+      for (; d < size; d++) {
+        gin[d] += lambda * gout[d];
+      }
+    };
+
+    int64_t ih0, ih1, iw0, iw1;
+    scalar_t h0lambda, h1lambda, w0lambda, w1lambda;
+    for (int64_t n = begin; n < end; n++) {
+      for (int64_t oh = 0; oh < output_height; oh++) {
+        compute_source_index_and_lambda(
+            ih0, ih1, h0lambda, h1lambda, height_scale, oh, input_height, output_height, align_corners);
+        for (int64_t ow = 0; ow < output_width; ow++) {
+          compute_source_index_and_lambda(
+              iw0, iw1, w0lambda, w1lambda, width_scale, ow, input_width, output_width, align_corners);
+
+          const scalar_t* gout = grad_output_data + n * output_slice_size +
+              oh * output_width * channels + ow * channels;
+          add_scaled(input_indexr(n, ih0, iw0), gout, h0lambda * w0lambda, channels); /* i00 */
+          add_scaled(input_indexr(n, ih0, iw1), gout, h0lambda * w1lambda, channels); /* i01 */
+          add_scaled(input_indexr(n, ih1, iw0), gout, h1lambda * w0lambda, channels); /* i10 */
+          add_scaled(input_indexr(n, ih1, iw1), gout, h1lambda * w1lambda, channels); /* i11 */
+        }
+      }
+    }
+  };
+
+  at::parallel_for(0, num_batches, at::internal::GRAIN_SIZE / output_slice_size / 4, loop2d);
+
+  if (!grad_input_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    grad_input_.copy_(grad_input);
+  }
+}
+
 template <typename scalar_t, typename scale_type>
 void cpu_upsample_linear_backward(
     Tensor& grad_input_,
@@ -546,9 +627,15 @@ void upsample_bilinear2d_backward_kernel_impl(
     bool align_corners,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
-  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_bilinear2d_backward", [&] {
-    cpu_upsample_linear_backward<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_h, scales_w});
-  });
+  if (grad_output.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_bilinear2d_backward_channels_last", [&] {
+      cpu_upsample_linear_backward_channels_last<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_h, scales_w});
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "upsample_bilinear2d_backward", [&] {
+      cpu_upsample_linear_backward<scalar_t, scale_t>(grad_input, grad_output, align_corners, {scales_h, scales_w});
+    });
+  }
 }
 
 void upsample_trilinear3d_backward_kernel_impl(
@@ -1,18 +1,32 @@
 #include <ATen/native/layer_norm.h>
 
 #include <cmath>
+#include <vector>
 
 #include <ATen/ATen.h>
 #include <ATen/CPUApplyUtils.h>
 #include <ATen/Dispatch.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/functional.h>
 
 namespace at {
 namespace native {
 
 namespace {
 
+// The type mean, rstd and the backward sums are computed in. See
+// Note [BFloat16 kernels compute in float].
+template <typename T>
+struct LayerNormAccType {
+  using type = T;
+};
+
+template <>
+struct LayerNormAccType<BFloat16> {
+  using type = float;
+};
+
 template <typename T>
 void LayerNormKernelImplInternal(
     const Tensor& X,
@@ -20,7 +34,7 @@ void LayerNormKernelImplInternal(
     const Tensor& beta,
     int64_t M,
     int64_t N,
-    T eps,
+    typename LayerNormAccType<T>::type eps,
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
@@ -66,6 +80,70 @@ void LayerNormKernelImplInternal(
   });
 }
 
+// Each row is widened to float once, normalized there and rounded back to
+// bfloat16 once.
+template <>
+void LayerNormKernelImplInternal<BFloat16>(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    float eps,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  using Vec = vec512::Vectorized<float>;
+  DCHECK_EQ(X.numel(), M * N);
+  DCHECK(!gamma.defined() || gamma.numel() == N);
+  DCHECK(!beta.defined() || beta.numel() == N);
+  const BFloat16* X_data = X.data_ptr<BFloat16>();
+  BFloat16* Y_data = Y->data_ptr<BFloat16>();
+  BFloat16* mean_data = mean->data_ptr<BFloat16>();
+  BFloat16* rstd_data = rstd->data_ptr<BFloat16>();
+  // gamma and beta are shared by every row, so widen them up front.
+  const bool gamma_null = !gamma.defined();
+  const bool beta_null = !beta.defined();
+  std::vector<float> gamma_f(gamma_null ? 0 : N);
+  std::vector<float> beta_f(beta_null ? 0 : N);
+  if (!gamma_null) {
+    vec256::convert(gamma.data_ptr<BFloat16>(), gamma_f.data(), N);
+  }
+  if (!beta_null) {
+    vec256::convert(beta.data_ptr<BFloat16>(), beta_f.data(), N);
+  }
+  const float c = 1.0f / static_cast<float>(N);
+  at::parallel_for(0, M, 1, [&](int64_t start, int64_t end) {
+    std::vector<float> buffer(N);
+    float* X_ptr = buffer.data();
+    for (int64_t i = start; i < end; ++i) {
+      vec256::convert(X_data + i * N, X_ptr, N);
+      float mean_val = vec512::reduce_all<float>(
+          [](Vec& x, Vec& y) { return x + y; },
+          X_ptr,
+          N);
+      float rstd_val = vec512::map_reduce_all<float>(
+          [](Vec x) { return x * x; },
+          [](Vec x, Vec y) { return x + y; },
+          X_ptr,
+          N);
+      mean_val *= c;
+      rstd_val = std::max(rstd_val * c - mean_val * mean_val, 0.0f);
+      rstd_val = 1.0f / std::sqrt(rstd_val + eps);
+      const float scale = rstd_val;
+      const float bias = -rstd_val * mean_val;
+      for (int64_t j = 0; j < N; ++j) {
+        const float gamma_v = gamma_null ? 1.0f : gamma_f[j];
+        const float beta_v = beta_null ? 0.0f : beta_f[j];
+        X_ptr[j] = (X_ptr[j] * scale + bias) * gamma_v + beta_v;
+      }
+      vec256::convert(X_ptr, Y_data + i * N, N);
+      mean_data[i] = mean_val;
+      rstd_data[i] = rstd_val;
+    }
+  });
+}
+
 void LayerNormKernelImpl(
     const Tensor& X,
     const Tensor& gamma,
@@ -76,10 +154,12 @@ void LayerNormKernelImpl(
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
-  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "LayerNormKernelImpl", [&]() {
-    LayerNormKernelImplInternal<scalar_t>(
-        X, gamma, beta, M, N, static_cast<scalar_t>(eps), Y, mean, rstd);
-  });
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, X.scalar_type(), "LayerNormKernelImpl", [&]() {
+        using T_ACC = typename LayerNormAccType<scalar_t>::type;
+        LayerNormKernelImplInternal<scalar_t>(
+            X, gamma, beta, M, N, static_cast<T_ACC>(eps), Y, mean, rstd);
+      });
 }
 
 template <typename T>
@@ -94,6 +174,7 @@ void LayerNormBackwardKernelImplInternal(
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
+  using T_ACC = typename LayerNormAccType<T>::type;
   DCHECK_EQ(dY.numel(), M * N);
   DCHECK_EQ(X.numel(), M * N);
   DCHECK_EQ(mean.numel(), M);
@@ -107,48 +188,55 @@ void LayerNormBackwardKernelImplInternal(
       gamma.defined() ? gamma.template data_ptr<T>() : nullptr;
   T* dX_data = dX->defined() ? dX->template data_ptr<T>() : nullptr;
   T* dgamma_data = dgamma->defined() ? dgamma->template data_ptr<T>() : nullptr;
-  if (dgamma_data != nullptr) {
-    std::memset(dgamma_data, 0, N * sizeof(T));
-  }
   T* dbeta_data = dbeta->defined() ? dbeta->template data_ptr<T>() : nullptr;
-  if (dbeta_data != nullptr) {
-    std::memset(dbeta_data, 0, N * sizeof(T));
-  }
-  const T scale = T(1) / static_cast<T>(N);
+  // dgamma and dbeta sum over all M rows, so accumulate them in T_ACC and
+  // round once at the end.
+  std::vector<T_ACC> dgamma_acc(dgamma_data != nullptr ? N : 0, T_ACC(0));
+  std::vector<T_ACC> dbeta_acc(dbeta_data != nullptr ? N : 0, T_ACC(0));
+  const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
   const bool gamma_null = gamma_data == nullptr;
   for (int64_t i = 0; i < M; ++i) {
     const T* dY_ptr = dY_data + i * N;
     const T* X_ptr = X_data + i * N;
+    const T_ACC mean_v = static_cast<T_ACC>(mean_data[i]);
+    const T_ACC rstd_v = static_cast<T_ACC>(rstd_data[i]);
     if (dX_data != nullptr) {
       T* dX_ptr = dX_data + i * N;
-      T ds = 0;
-      T db = 0;
+      T_ACC ds = 0;
+      T_ACC db = 0;
       for (int64_t j = 0; j < N; ++j) {
-        const T gamma_v = gamma_null ? T(1) : gamma_data[j];
-        ds += dY_ptr[j] * X_ptr[j] * gamma_v;
-        db += dY_ptr[j] * gamma_v;
+        const T_ACC gamma_v = gamma_null ? T_ACC(1) : static_cast<T_ACC>(gamma_data[j]);
+        ds += static_cast<T_ACC>(dY_ptr[j]) * static_cast<T_ACC>(X_ptr[j]) * gamma_v;
+        db += static_cast<T_ACC>(dY_ptr[j]) * gamma_v;
       }
-      const T a = rstd_data[i];
-      const T b = (db * mean_data[i] - ds) * a * a * a * scale;
-      const T c = -b * mean_data[i] - db * a * scale;
+      const T_ACC a = rstd_v;
+      const T_ACC b = (db * mean_v - ds) * a * a * a * scale;
+      const T_ACC c = -b * mean_v - db * a * scale;
       for (int64_t j = 0; j < N; ++j) {
-        const T gamma_v = gamma_null ? T(1) : gamma_data[j];
-        dX_ptr[j] = a * dY_ptr[j] * gamma_v + b * X_ptr[j] + c;
+        const T_ACC gamma_v = gamma_null ? T_ACC(1) : static_cast<T_ACC>(gamma_data[j]);
+        dX_ptr[j] = a * static_cast<T_ACC>(dY_ptr[j]) * gamma_v +
+            b * static_cast<T_ACC>(X_ptr[j]) + c;
       }
     }
     if (dgamma_data != nullptr) {
-      const T a = rstd_data[i];
-      const T b = -a * mean_data[i];
+      const T_ACC a = rstd_v;
+      const T_ACC b = -a * mean_v;
       for (int64_t j = 0; j < N; ++j) {
-        dgamma_data[j] += dY_ptr[j] * (a * X_ptr[j] + b);
+        dgamma_acc[j] += static_cast<T_ACC>(dY_ptr[j]) * (a * static_cast<T_ACC>(X_ptr[j]) + b);
       }
     }
     if (dbeta_data != nullptr) {
       for (int64_t j = 0; j < N; ++j) {
-        dbeta_data[j] += dY_ptr[j];
+        dbeta_acc[j] += static_cast<T_ACC>(dY_ptr[j]);
       }
     }
   }
+  if (dgamma_data != nullptr) {
+    vec256::convert(dgamma_acc.data(), dgamma_data, N);
+  }
+  if (dbeta_data != nullptr) {
+    vec256::convert(dbeta_acc.data(), dbeta_data, N);
+  }
 }
 
 void LayerNormBackwardKernelImpl(
@@ -162,8 +250,8 @@ void LayerNormBackwardKernelImpl(
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
-  AT_DISPATCH_FLOATING_TYPES(
-      X.scalar_type(), "LayerNormBackwardKernelImpl", [&]() {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, X.scalar_type(), "LayerNormBackwardKernelImpl", [&]() {
         LayerNormBackwardKernelImplInternal<scalar_t>(
             dY, X, mean, rstd, gamma, M, N, dX, dgamma, dbeta);
       });
@@ -0,0 +1,37 @@
+#pragma once
+
+namespace at {
+namespace native {
+
+// data_index_init and data_index_step walk a flat index range over a set of
+// nested dimensions, innermost last: data_index_init(offset, x, X, y, Y)
+// sets x and y to the coordinates of offset in an X x Y grid, and
+// data_index_step(x, X, y, Y) advances them by one element, returning true
+// when the whole grid wrapped around.
+template <typename T>
+inline T data_index_init(T offset) {
+  return offset;
+}
+
+template <typename T, typename... Args>
+inline T data_index_init(T offset, T &x, const T &X, Args &&... args) {
+  offset = data_index_init(offset, std::forward<Args>(args)...);
+  x = offset % X;
+  return offset / X;
+}
+
+inline bool data_index_step() {
+  return true;
+}
+
+template <typename T, typename... Args>
+inline bool data_index_step(T &x, const T &X, Args &&... args) {
+  if (data_index_step(std::forward<Args>(args)...)) {
+    x = ((x + 1) == X) ? 0 : (x + 1);
+    return x == 0;
+  }
+  return false;
+}
+
+} // namespace native
+} // namespace at
@@ -528,6 +528,49 @@ void magmaLuSolveBatched<float>(
   auto storage_##name = pin_memory<type>(size); \
   name = static_cast<type*>(storage_##name.data());
 
+// Note [Small batched matrices]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// MAGMA runs the factorizations with one thread block, or one host call, per
+// matrix, which leaves most of the device idle for large batches of small
+// matrices. Matrices of up to small_matrix_max_size rows are instead
+// factorized by one thread each, straight from the column-major working copy.
+// For sizes of up to small_matrix_max_unrolled_size the size is a template
+// parameter, so the loops unroll and the matrix is kept in registers; the
+// other sizes use a runtime size and local memory. These kernels need
+// neither MAGMA nor any other library.
+constexpr int64_t small_matrix_max_size = 16;
+constexpr int64_t small_matrix_max_unrolled_size = 8;
+constexpr int small_matrix_threads = 128;
+
+// Launches kernel<scalar_t, N> for the sizes it is unrolled for, and
+// kernel<scalar_t, 0> with the runtime size for the others.
+#define LAUNCH_SMALL_MATRIX_KERNEL(kernel, n, grid, block, stream, ...)  \
+  switch (n) {                                                           \
+    case 1: kernel<scalar_t, 1><<<grid, block, 0, stream>>>(__VA_ARGS__); break; \
+    case 2: kernel<scalar_t, 2><<<grid, block, 0, stream>>>(__VA_ARGS__); break; \
+    case 3: kernel<scalar_t, 3><<<grid, block, 0, stream>>>(__VA_ARGS__); break; \
+    case 4: kernel<scalar_t, 4><<<grid, block, 0, stream>>>(__VA_ARGS__); break; \
+    case 5: kernel<scalar_t, 5><<<grid, block, 0, stream>>>(__VA_ARGS__); break; \
+    case 6: kernel<scalar_t, 6><<<grid, block, 0, stream>>>(__VA_ARGS__); break; \
+    case 7: kernel<scalar_t, 7><<<grid, block, 0, stream>>>(__VA_ARGS__); break; \
+    case 8: kernel<scalar_t, 8><<<grid, block, 0, stream>>>(__VA_ARGS__); break; \
+    default: kernel<scalar_t, 0><<<grid, block, 0, stream>>>(__VA_ARGS__); break; \
+  }
+
+static inline bool use_small_matrix_kernels(const Tensor& self) {
+  return self.size(-1) <= small_matrix_max_size;
+}
+
+// Copies the device infos of the small matrix kernels to the host vector
+// batchCheckErrors / singleCheckErrors take.
+static inline void copy_small_matrix_infos(const Tensor& infos_tensor, std::vector<int64_t>& infos) {
+  auto infos_cpu = infos_tensor.to(at::kCPU);
+  auto infos_data = infos_cpu.data_ptr<int>();
+  for (size_t i = 0; i < infos.size(); i++) {
+    infos[i] = infos_data[i];
+  }
+}
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ solve ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 template <typename scalar_t>
@@ -816,6 +859,93 @@ Tensor _cholesky_solve_helper_cuda(const Tensor& self, const Tensor& A, bool upp
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ cholesky ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+// Lower Cholesky factorization of each n x n column-major matrix, in place,
+// one thread per matrix. See Note [Small batched matrices]. As with LAPACK,
+// info is the order of the first leading minor that is not positive definite,
+// and the strictly upper triangle is left untouched.
+template <typename scalar_t, int N>
+__global__ void small_cholesky_kernel(scalar_t* self_data, int64_t matrix_stride,
+                                      int n_, int64_t batch_size, int* infos) {
+  constexpr int max_n = N > 0 ? N : small_matrix_max_size;
+  const int n = N > 0 ? N : n_;
+  const int64_t batch = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (batch >= batch_size) {
+    return;
+  }
+  scalar_t* A = self_data + batch * matrix_stride;
+
+  scalar_t a[max_n][max_n];
+#pragma unroll
+  for (int j = 0; j < max_n; j++) {
+#pragma unroll
+    for (int i = j; i < max_n; i++) {
+      if (i < n) {
+        a[i][j] = A[j * n + i];
+      }
+    }
+  }
+
+  int info = 0;
+#pragma unroll
+  for (int j = 0; j < max_n; j++) {
+    if (j < n && info == 0) {
+      scalar_t d = a[j][j];
+#pragma unroll
+      for (int k = 0; k < j; k++) {
+        d -= a[j][k] * a[j][k];
+      }
+      // Also catches NaNs
+      if (!(d > 0)) {
+        info = j + 1;
+      } else {
+        d = ::sqrt(d);
+        a[j][j] = d;
+#pragma unroll
+        for (int i = j + 1; i < max_n; i++) {
+          if (i < n) {
+            scalar_t s = a[i][j];
+#pragma unroll
+            for (int k = 0; k < j; k++) {
+              s -= a[i][k] * a[j][k];
+            }
+            a[i][j] = s / d;
+          }
+        }
+      }
+    }
+  }
+
+#pragma unroll
+  for (int j = 0; j < max_n; j++) {
+#pragma unroll
+    for (int i = j; i < max_n; i++) {
+      if (i < n) {
+        A[j * n + i] = a[i][j];
+      }
+    }
+  }
+  infos[batch] = info;
+}
+
+template <typename scalar_t>
+static void apply_small_cholesky(Tensor& self, std::vector<int64_t>& infos) {
+  int n = static_cast<int>(self.size(-1));
+  int64_t batch_size = batchCount(self);
+  if (batch_size == 0) {
+    return;
+  }
+  auto infos_tensor = at::empty({batch_size}, self.options().dtype(at::kInt));
+
+  dim3 block(small_matrix_threads);
+  dim3 grid((batch_size + small_matrix_threads - 1) / small_matrix_threads);
+  auto stream = at::cuda::getCurrentCUDAStream();
+  LAUNCH_SMALL_MATRIX_KERNEL(small_cholesky_kernel, n, grid, block, stream,
+      self.data_ptr<scalar_t>(), matrixStride(self), n, batch_size, infos_tensor.data_ptr<int>());
+  AT_CUDA_CHECK(cudaGetLastError());
+
+  copy_small_matrix_infos(infos_tensor, infos);
+}
+
 template <typename scalar_t>
 static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos) {
 #ifndef USE_MAGMA
@@ -887,7 +1017,11 @@ Tensor _cholesky_helper_cuda(const Tensor& self, bool upper) {
   }
 
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cholesky_cuda", [&]{
-    apply_cholesky<scalar_t>(self_working_copy, false, infos);
+    if (use_small_matrix_kernels(self_working_copy)) {
+      apply_small_cholesky<scalar_t>(self_working_copy, infos);
+    } else {
+      apply_cholesky<scalar_t>(self_working_copy, false, infos);
+    }
   });
   if (self.dim() > 2) {
     batchCheckErrors(infos, "cholesky_cuda");
@@ -1177,6 +1311,181 @@ std::tuple<Tensor,Tensor> _qr_helper_cuda(const Tensor& self, bool some) {
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ symeig ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+// Cyclic Jacobi sweeps before giving up on the off-diagonal elements of a
+// matrix converging to zero; the convergence is quadratic, so sizes up to
+// small_matrix_max_size usually need fewer than 10.
+constexpr int small_symeig_max_sweeps = 30;
+
+// Eigenvalues, in ascending order, and optionally eigenvectors of each n x n
+// symmetric column-major matrix, with the cyclic Jacobi method, one thread
+// per matrix. See Note [Small batched matrices]. Only the triangle selected by
+// upper is read, and the eigenvectors overwrite the matrix. info is the number
+// of off-diagonal elements that did not converge to zero.
+template <typename scalar_t, int N>
+__global__ void small_symeig_kernel(scalar_t* self_data, scalar_t* eigvals_data, int64_t matrix_stride,
+                                    int n_, int64_t batch_size, bool eigenvectors, bool upper,
+                                    scalar_t eps, int* infos) {
+  constexpr int max_n = N > 0 ? N : small_matrix_max_size;
+  const int n = N > 0 ? N : n_;
+  const int64_t batch = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (batch >= batch_size) {
+    return;
+  }
+  scalar_t* A = self_data + batch * matrix_stride;
+
+  scalar_t a[max_n][max_n];
+  scalar_t v[max_n][max_n];
+  scalar_t norm = 0;
+#pragma unroll
+  for (int j = 0; j < max_n; j++) {
+#pragma unroll
+    for (int i = 0; i < max_n; i++) {
+      if (i < n && j < n) {
+        const bool in_triangle = upper ? i <= j : i >= j;
+        a[i][j] = in_triangle ? A[j * n + i] : A[i * n + j];
+        v[i][j] = i == j ? 1 : 0;
+        norm += a[i][j] * a[i][j];
+      }
+    }
+  }
+  // The rotations keep the Frobenius norm, so this is relative to the norm
+  // of the matrix throughout.
+  const scalar_t tol = eps * eps * norm;
+
+  for (int sweep = 0; sweep < small_symeig_max_sweeps; sweep++) {
+    scalar_t off = 0;
+#pragma unroll
+    for (int p = 0; p < max_n; p++) {
+#pragma unroll
+      for (int q = p + 1; q < max_n; q++) {
+        if (q < n) {
+          off += a[p][q] * a[p][q];
+        }
+      }
+    }
+    // Also stops on NaNs
+    if (!(off > tol)) {
+      break;
+    }
+
+#pragma unroll
+    for (int p = 0; p < max_n; p++) {
+#pragma unroll
+      for (int q = p + 1; q < max_n; q++) {
+        if (q < n && a[p][q] != 0) {
+          // The rotation J = [c s; -s c] in the (p, q) plane for which
+          // J^T A J has a zero (p, q) element, taking the smaller angle.
+          const scalar_t theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+          const scalar_t t = (theta >= 0 ? 1 : -1) / (::fabs(theta) + ::sqrt(theta * theta + 1));
+          const scalar_t c = 1 / ::sqrt(t * t + 1);
+          const scalar_t s = t * c;
+#pragma unroll
+          for (int k = 0; k < max_n; k++) {
+            if (k < n) {
+              const scalar_t akp = a[k][p], akq = a[k][q];
+              a[k][p] = c * akp - s * akq;
+              a[k][q] = s * akp + c * akq;
+              const scalar_t vkp = v[k][p], vkq = v[k][q];
+              v[k][p] = c * vkp - s * vkq;
+              v[k][q] = s * vkp + c * vkq;
+            }
+          }
+#pragma unroll
+          for (int k = 0; k < max_n; k++) {
+            if (k < n) {
+              const scalar_t apk = a[p][k], aqk = a[q][k];
+              a[p][k] = c * apk - s * aqk;
+              a[q][k] = s * apk + c * aqk;
+            }
+          }
+          a[p][q] = 0;
+          a[q][p] = 0;
+        }
+      }
+    }
+  }
+
+  int info = 0;
+#pragma unroll
+  for (int p = 0; p < max_n; p++) {
+#pragma unroll
+    for (int q = p + 1; q < max_n; q++) {
+      if (q < n && a[p][q] * a[p][q] > tol) {
+        info++;
+      }
+    }
+  }
+
+  // Sorts with compile-time indices only, so that the unrolled sizes stay in
+  // registers.
+  scalar_t w[max_n];
+#pragma unroll
+  for (int i = 0; i < max_n; i++) {
+    if (i < n) {
+      w[i] = a[i][i];
+    }
+  }
+#pragma unroll
+  for (int i = 0; i < max_n; i++) {
+#pragma unroll
+    for (int j = i + 1; j < max_n; j++) {
+      if (j < n && w[j] < w[i]) {
+        const scalar_t wi = w[i];
+        w[i] = w[j];
+        w[j] = wi;
+#pragma unroll
+        for (int k = 0; k < max_n; k++) {
+          if (k < n) {
+            const scalar_t vki = v[k][i];
+            v[k][i] = v[k][j];
+            v[k][j] = vki;
+          }
+        }
+      }
+    }
+  }
+
+  scalar_t* eigvals = eigvals_data + batch * n;
+#pragma unroll
+  for (int i = 0; i < max_n; i++) {
+    if (i < n) {
+      eigvals[i] = w[i];
+    }
+  }
+  if (eigenvectors) {
+#pragma unroll
+    for (int j = 0; j < max_n; j++) {
+#pragma unroll
+      for (int i = 0; i < max_n; i++) {
+        if (i < n && j < n) {
+          A[j * n + i] = v[i][j];
+        }
+      }
+    }
+  }
+  infos[batch] = info;
+}
+
+template <typename scalar_t>
+static void apply_small_symeig(Tensor& self, Tensor& eigvals, bool eigenvectors, bool upper, std::vector<int64_t>& infos) {
+  int n = static_cast<int>(self.size(-1));
+  int64_t batch_size = batchCount(self);
+  if (batch_size == 0) {
+    return;
+  }
+  auto infos_tensor = at::empty({batch_size}, self.options().dtype(at::kInt));
+
+  dim3 block(small_matrix_threads);
+  dim3 grid((batch_size + small_matrix_threads - 1) / small_matrix_threads);
+  auto stream = at::cuda::getCurrentCUDAStream();
+  LAUNCH_SMALL_MATRIX_KERNEL(small_symeig_kernel, n, grid, block, stream,
+      self.data_ptr<scalar_t>(), eigvals.data_ptr<scalar_t>(), matrixStride(self), n, batch_size,
+      eigenvectors, upper, std::numeric_limits<scalar_t>::epsilon(), infos_tensor.data_ptr<int>());
+  AT_CUDA_CHECK(cudaGetLastError());
+
+  copy_small_matrix_infos(infos_tensor, infos);
+}
+
 template <typename scalar_t>
 static void apply_symeig(Tensor& self, Tensor& eigvals, bool eigenvectors, bool upper, std::vector<int64_t>& infos) {
 #ifndef USE_MAGMA
@@ -1237,8 +1546,10 @@ std::tuple<Tensor, Tensor> _symeig_helper_cuda(const Tensor& self, bool eigenvec
   // The driver routine magma_(d/s)syev_gpu accepts a tensor on the CPU for eigvalenvalues.
   // The data is later moved to the appropriate device.
   // In the case where self.numel() == 0, we just return an empty tensor of
-  // dimensions on the CUDA (to avoid the unnecessary "to(at::kCUDA)")
-  auto eigvals_working_copy = self.numel() == 0
+  // dimensions on the CUDA (to avoid the unnecessary "to(at::kCUDA)"), and
+  // the small matrix kernels write the eigenvalues on the device as well.
+  bool small = use_small_matrix_kernels(self);
+  auto eigvals_working_copy = (self.numel() == 0 || small)
                               ? at::empty(self_sizes, self.options())
                               : at::empty(self_sizes, self.options().device(at::kCPU));
 
@@ -1248,7 +1559,11 @@ std::tuple<Tensor, Tensor> _symeig_helper_cuda(const Tensor& self, bool eigenvec
 
   auto self_working_copy = cloneBatchedColumnMajor(self);
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "symeig_cuda", [&]{
-    apply_symeig<scalar_t>(self_working_copy, eigvals_working_copy, eigenvectors, upper, infos);
+    if (small) {
+      apply_small_symeig<scalar_t>(self_working_copy, eigvals_working_copy, eigenvectors, upper, infos);
+    } else {
+      apply_symeig<scalar_t>(self_working_copy, eigvals_working_copy, eigenvectors, upper, infos);
+    }
   });
 
   if (self.dim() > 2) {
@@ -3,12 +3,16 @@
 #include <ATen/Dispatch.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/CUDAEvent.h>
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <c10/cuda/CUDAStream.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
 #include <THC/THC.h>
 
+#include <mutex>
+#include <vector>
+
 #ifdef __HIP_PLATFORM_HCC__
 #include <hip/hip_version.h>
 #endif
@@ -18,6 +22,53 @@ namespace native {
 
 using namespace at::cuda;
 
+// Copies between GPUs without P2P access are staged through contiguous
+// temporaries. Above this size they are done in chunks, which bounds the
+// temporaries and lets the unpacking of a chunk on the destination overlap
+// the packing of the next one on the source.
+constexpr int64_t kStagedCopyChunkBytes = 32 * 1024 * 1024;
+
+// Whether the link between two GPUs is NVLink. CUDA only reports native peer
+// atomics over NVLink, never over PCIe.
+static bool is_nvlink_peer(int64_t device, int64_t peer_device) {
+#ifdef __HIP_PLATFORM_HCC__
+  return false;
+#else
+  static std::mutex mutex;
+  static std::vector<int> native_atomics;
+  std::lock_guard<std::mutex> lock(mutex);
+  const int64_t num_devices = at::cuda::getNumGPUs();
+  if (native_atomics.empty()) {
+    native_atomics.assign(num_devices * num_devices, -1);
+  }
+  int& supported = native_atomics[device * num_devices + peer_device];
+  if (supported == -1) {
+    AT_CUDA_CHECK(cudaDeviceGetP2PAttribute(
+        &supported, cudaDevP2PAttrNativeAtomicSupported, device, peer_device));
+  }
+  return supported != 0;
+#endif
+}
+
+// The device to run a strided copy between two GPUs with P2P access on. The
+// source device reads its memory and writes the peer's, as writes to the peer
+// are posted while reads wait for the link. Over NVLink the cost of a read is
+// small enough that a copy converting to a wider dtype runs on the
+// destination instead: reading the narrower source elements moves fewer bytes
+// over the link than writing the wider destination ones.
+static Device strided_copy_device(TensorIterator& iter) {
+  Device dst_device = iter.device(0);
+  Device src_device = iter.device(1);
+  if (src_device == dst_device ||
+      iter.element_size(0) <= iter.element_size(1) ||
+      !is_nvlink_peer(dst_device.index(), src_device.index())) {
+    return src_device;
+  }
+  const bool dst_can_access_src = THCState_getPeerToPeerAccess(
+      globalContext().getTHCState(), dst_device.index(), src_device.index());
+  return dst_can_access_src ? dst_device : src_device;
+}
+
 // device-to-device copy, does type conversion
 void copy_device_to_device(TensorIterator& iter, bool non_blocking) {
   int64_t numel = iter.numel();
@@ -30,27 +81,31 @@ void copy_device_to_device(TensorIterator& iter, bool non_blocking) {
   Device dst_device = iter.device(0);
   Device src_device = iter.device(1);
 
-  CUDAGuard device_guard(src_device);
+  // Memcpys are performed on the source device, and copy kernels on the
+  // device strided_copy_device picks, using the current stream on that
+  // device. We fully synchronize on both src and dst's current streams for
+  // completion of the copy. We have to explicitly do this for non-contig
+  // copies. This mimics the behavior of cross-device cudaMemcpyAsync on the
+  // default stream.
+  Device copy_device = memcpy_eligible ? src_device : strided_copy_device(iter);
+  Device other_device = copy_device == src_device ? dst_device : src_device;
 
-  // We always perform the copy on the source device, using the current stream
-  // on the source device, and we fully synchronize on both src and dst's
-  // current streams for completion of the copy. We have to explicitly do this
-  // for non-contig copies. This mimics the behavior of cross-device
-  // cudaMemcpyAsync on the default stream.
-  CUDAStream copy_stream = getCurrentCUDAStream(src_device.index());
+  CUDAGuard device_guard(copy_device);
+  CUDAStream copy_stream = getCurrentCUDAStream(copy_device.index());
   if (src_device != dst_device) {
     // This is a cross-device copy on the src current stream and dst current
     // stream. We perform a two-way barrier between both devices' streams
     // before the copy. This ensures that any write-after-write and
     // write-after-read dependencies on the destination side are handled, so
     // that no one is operating on the dst memory when we perform the copy.
-    // src waits on dst barrier (src already waits on src)
-    CUDAEvent dst_ready;
-    device_guard.set_device(dst_device);
-    dst_ready.record(getCurrentCUDAStream(dst_device.index()));
+    // The copying device waits on the other device's barrier (it already
+    // waits on itself).
+    CUDAEvent other_ready;
+    device_guard.set_device(other_device);
+    other_ready.record(getCurrentCUDAStream(other_device.index()));
 
-    device_guard.set_device(src_device);
-    dst_ready.block(copy_stream);
+    device_guard.set_device(copy_device);
+    other_ready.block(copy_stream);
   }
 
   if (memcpy_eligible) {
@@ -79,15 +134,15 @@ void copy_device_to_device(TensorIterator& iter, bool non_blocking) {
   }
 
   if (src_device != dst_device) {
-    // dst waits on src barrier (dst already waits on dst). We cannot
-    // operate on dst's copy until the copy is complete.
+    // The other device waits on the copying device's barrier. We cannot
+    // operate on dst's copy, nor write to src, until the copy is complete.
 
-    // Still on src_device, record stream event
-    CUDAEvent src_ready;
-    src_ready.record(copy_stream);
+    // Still on copy_device, record stream event
+    CUDAEvent copy_done;
+    copy_done.record(copy_stream);
 
-    device_guard.set_device(dst_device);
-    src_ready.block(getCurrentCUDAStream(dst_device.index()));
+    device_guard.set_device(other_device);
+    copy_done.block(getCurrentCUDAStream(other_device.index()));
   }
 
   AT_CUDA_CHECK(cudaGetLastError());
@@ -138,6 +193,24 @@ static void copy_kernel_cuda(TensorIterator& iter, bool non_blocking) {
     // NB: this involves recursive calls to copy. Be careful that those copies
     // don't require temporaries or you will cause an infinite recursion!
     auto& dst = iter.tensor(0);
+
+    // Large copies between GPUs are staged a chunk of the outermost
+    // dimension at a time. The chunks are smaller, so this recursion ends.
+    if (dst_device.is_cuda() && src_device.is_cuda() && dst.dim() > 0 &&
+        dst.size(0) > 1 &&
+        dst.numel() * iter.element_size(0) > kStagedCopyChunkBytes) {
+      const Tensor src = iter.tensor(1).expand_as(dst);
+      const int64_t slice_bytes =
+          std::max<int64_t>(dst.numel() / dst.size(0) * iter.element_size(0), 1);
+      const int64_t chunk_size =
+          std::max<int64_t>(kStagedCopyChunkBytes / slice_bytes, 1);
+      for (int64_t start = 0; start < dst.size(0); start += chunk_size) {
+        const int64_t length = std::min(chunk_size, dst.size(0) - start);
+        dst.narrow(0, start, length).copy_(src.narrow(0, start, length), non_blocking);
+      }
+      return;
+    }
+
     Tensor dst_contig;
     Tensor src_contig;
 
@@ -190,6 +263,13 @@ static void copy_kernel_cuda(TensorIterator& iter, bool non_blocking) {
   CUDAStream stream = getCurrentCUDAStream();
 
   if (non_blocking) {
+    if (kind == cudaMemcpyDeviceToHost && !at::detail::getCUDAHooks().isPinnedPtr(dst)) {
+      TORCH_WARN_ONCE(
+          "A non_blocking copy from a CUDA device into pageable CPU memory is ",
+          "synchronous: the driver stages it through a pinned buffer and only ",
+          "returns once the copy is done. Copy into pinned memory (see ",
+          "Tensor.pin_memory) to make it asynchronous.");
+    }
     AT_CUDA_CHECK(cudaMemcpyAsync(dst, src, nbytes, kind, stream));
     void* ptr = (dst_device == kCPU ? dst : src);
     AT_CUDA_CHECK(THCCachingHostAllocator_recordEvent(ptr, stream));
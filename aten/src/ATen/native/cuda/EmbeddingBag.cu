@@ -17,6 +17,7 @@
 #include <thrust/device_vector.h>
 
 #include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
+#include <ATen/native/cuda/MemoryAccess.cuh>
 
 #include <c10/macros/Macros.h>
 
@@ -110,6 +111,192 @@ __global__ void EmbeddingBag_updateOutputKernel(
 }
 
 
+// Small embeddings are summed a warp per bag instead, as a thread per bag x
+// feature leaves most of a warp idle and reads a row a feature at a time. The
+// warp is split into groups of lanes_per_row lanes, each group reads a
+// different row of the bag, vec_size features per lane, and the partial sums
+// of the groups are reduced with shuffles at the end of the bag. This kernel
+// assumes that the rows of `weight` are contiguous, and that featureSize and
+// weight_stride0 are multiples of vec_size.
+template <typename scalar_t, int vec_size>
+__global__ void EmbeddingBag_updateOutputKernel_warp_per_bag(
+    const int64_t *input, const int64_t *offsets, const scalar_t *weight,
+    scalar_t *output, int64_t *offset2bag, int64_t numIndices, int64_t numBags,
+    int64_t featureSize, int64_t weight_stride0, int lanes_per_row, int mode,
+    int64_t *bag_size, const scalar_t* per_sample_weights,
+    int64_t per_sample_weights_stride) {
+
+  using accscalar_t = acc_type<scalar_t, true>;
+  using vec_t = memory::aligned_vector<scalar_t, vec_size>;
+
+  const int lane = threadIdx.x;
+  const int group = lane / lanes_per_row;
+  const int rows_per_step = C10_WARP_SIZE / lanes_per_row;
+  const int64_t featureDim = (lane % lanes_per_row) * vec_size;
+  const bool active = featureDim < featureSize;
+
+  for (int64_t bag = blockIdx.x * blockDim.y + threadIdx.y; bag < numBags;
+       bag += gridDim.x * blockDim.y) {
+    int64_t begin = bag == 0 ? 0 : offsets[bag]; // forces first offset to be 0 instead of asserting on it
+    int64_t end = (bag < numBags - 1) ? (offsets[bag + 1]) : numIndices;
+    CUDA_KERNEL_ASSERT(end >= begin);
+
+    accscalar_t weightFeatSum[vec_size];
+#pragma unroll
+    for (int i = 0; i < vec_size; i++) {
+      weightFeatSum[i] = 0;
+    }
+    if (active) {
+      for (int64_t emb = begin + group; emb < end; emb += rows_per_step) {
+        const vec_t weightValue = *reinterpret_cast<const vec_t*>(
+            weight + input[emb] * weight_stride0 + featureDim);
+        const accscalar_t scaleWeightBy = per_sample_weights
+            ? static_cast<accscalar_t>(per_sample_weights[emb * per_sample_weights_stride])
+            : static_cast<accscalar_t>(1);
+#pragma unroll
+        for (int i = 0; i < vec_size; i++) {
+          weightFeatSum[i] += scaleWeightBy * static_cast<accscalar_t>(weightValue.val[i]);
+        }
+      }
+    }
+
+    // The lanes summing the same features are lanes_per_row apart.
+    for (int laneMask = lanes_per_row; laneMask < C10_WARP_SIZE; laneMask *= 2) {
+#pragma unroll
+      for (int i = 0; i < vec_size; i++) {
+        weightFeatSum[i] += WARP_SHFL_XOR(weightFeatSum[i], laneMask);
+      }
+    }
+
+    for (int64_t emb = begin + lane; emb < end; emb += C10_WARP_SIZE) {
+      offset2bag[emb] = bag;
+    }
+    if (mode == MODE_MEAN) {
+      if (lane == 0) {
+        bag_size[bag] = end - begin;
+      }
+      if (end > begin) {
+#pragma unroll
+        for (int i = 0; i < vec_size; i++) {
+          weightFeatSum[i] = weightFeatSum[i] / static_cast<accscalar_t>(end - begin);
+        }
+      }
+    }
+
+    if (group == 0 && active) {
+      vec_t outputValue;
+#pragma unroll
+      for (int i = 0; i < vec_size; i++) {
+        outputValue.val[i] = static_cast<scalar_t>(weightFeatSum[i]);
+      }
+      *reinterpret_cast<vec_t*>(output + bag * featureSize + featureDim) = outputValue;
+    }
+  }
+}
+
+// Returns the number of features each lane of
+// EmbeddingBag_updateOutputKernel_warp_per_bag reads, or 0 if the kernel
+// doesn't apply to the bags.
+template <typename scalar_t>
+int embedding_bag_warp_per_bag_vec_size(const Tensor& weight, int64_t mode) {
+  const int64_t featureSize = weight.size(1);
+  if (mode == MODE_MAX || featureSize == 0 || weight.stride(1) != 1) {
+    return 0;
+  }
+  int vec_size = memory::can_vectorize_up_to<scalar_t>(
+      reinterpret_cast<char*>(weight.data_ptr<scalar_t>()));
+  while (vec_size > 1 &&
+         (featureSize % vec_size != 0 || weight.stride(0) % vec_size != 0)) {
+    vec_size /= 2;
+  }
+  return featureSize <= C10_WARP_SIZE * vec_size ? vec_size : 0;
+}
+
+template <typename scalar_t, int vec_size>
+void embedding_bag_update_output_warp_per_bag(
+    const Tensor& weight, const Tensor& indices, const Tensor& offsets,
+    Tensor& output, Tensor& offset2bag, Tensor& bag_size, int64_t numBags,
+    int64_t mode, const Tensor& per_sample_weights) {
+  const int64_t featureSize = weight.size(1);
+  int lanes_per_row = 1;
+  while (lanes_per_row * vec_size < featureSize) {
+    lanes_per_row *= 2;
+  }
+
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  dim3 block = dim3(C10_WARP_SIZE, 256 / C10_WARP_SIZE);
+  int grid = 1024;
+  EmbeddingBag_updateOutputKernel_warp_per_bag<scalar_t, vec_size>
+      <<<grid, block, 0, stream>>>(
+      indices.data_ptr<int64_t>(), offsets.data_ptr<int64_t>(),
+      weight.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(),
+      offset2bag.data_ptr<int64_t>(), indices.size(0), numBags, featureSize,
+      weight.stride(0), lanes_per_row, mode, bag_size.data_ptr<int64_t>(),
+      per_sample_weights.defined() ? per_sample_weights.data_ptr<scalar_t>() : NULL,
+      per_sample_weights.defined() ? per_sample_weights.stride(0) : 0);
+}
+
+
+
+// The number of sorted indices each warp of
+// EmbeddingBag_accGradParametersKernel_sum_avg accumulates.
+constexpr int64_t kSumAvgBackwardIndicesPerWarp = 32;
+
+// Accumulates the gradient of the sorted indices in a single pass: each warp
+// takes kSumAvgBackwardIndicesPerWarp consecutive sorted indices, sums the
+// scaled gradients of the bags of each run of equal indices into registers,
+// and writes every run out once, a feature per lane. A run only the warp sees
+// is stored as is; a run continuing in the neighbouring warps is atomically
+// added, so this is not deterministic. grad and gradWeight are contiguous and
+// gradWeight is zeroed beforehand.
+template <typename scalar_t>
+__global__ void EmbeddingBag_accGradParametersKernel_sum_avg(
+    const int64_t *sorted_indices, const int64_t *orig_indices,
+    const scalar_t *gradOutput, const int64_t *offset2bag,
+    const int64_t *bag_size, const scalar_t* per_sample_weights,
+    int64_t per_sample_weights_stride, scalar_t *gradWeight, int64_t numel,
+    int64_t stride, bool mode_mean) {
+
+  using accscalar_t = acc_type<scalar_t, true>;
+
+  const int64_t warp = blockIdx.x * blockDim.y + threadIdx.y;
+  const int64_t start = warp * kSumAvgBackwardIndicesPerWarp;
+  if (start >= numel) {
+    return;
+  }
+  const int64_t end = ::min(start + kSumAvgBackwardIndicesPerWarp, numel);
+  const bool shared_first = start > 0 && sorted_indices[start - 1] == sorted_indices[start];
+  const bool shared_last = end < numel && sorted_indices[end] == sorted_indices[end - 1];
+
+  for (int64_t featureDim = threadIdx.x; featureDim < stride; featureDim += blockDim.x) {
+    accscalar_t weightFeatSum = 0;
+    bool shared = shared_first;
+    for (int64_t i = start; i < end; i++) {
+      const int64_t origIndex = orig_indices[i];
+      const int64_t bag = offset2bag[origIndex];
+      accscalar_t scale = per_sample_weights
+          ? static_cast<accscalar_t>(per_sample_weights[origIndex * per_sample_weights_stride])
+          : static_cast<accscalar_t>(1);
+      if (mode_mean) {
+        scale /= static_cast<accscalar_t>(bag_size[bag]);
+      }
+      weightFeatSum += scale * static_cast<accscalar_t>(gradOutput[bag * stride + featureDim]);
+
+      const int64_t index = sorted_indices[i];
+      if (i == end - 1 || sorted_indices[i + 1] != index) {
+        scalar_t *gradWeightFeat = gradWeight + index * stride + featureDim;
+        if (shared || (i == end - 1 && shared_last)) {
+          gpuAtomicAdd(gradWeightFeat, static_cast<scalar_t>(weightFeatSum));
+        } else {
+          *gradWeightFeat = static_cast<scalar_t>(weightFeatSum);
+        }
+        weightFeatSum = 0;
+        shared = false;
+      }
+    }
+  }
+}
+
 
 Tensor embedding_bag_backward_cuda_sum_avg(
                                    const Tensor &grad,
@@ -157,6 +344,32 @@ Tensor embedding_bag_backward_cuda_sum_avg(
                         ThrustLTOp<int64_t>());
   }
 
+  // Without the frequencies, small gradients of floating types are accumulated
+  // in a single pass, unless asked to be deterministic.
+  if (!scale_grad_by_freq && !globalContext().deterministic() &&
+      grad.scalar_type() != at::ScalarType::BFloat16) {
+#ifdef __HIP_PLATFORM_HCC__
+    dim3 block = dim3(64, 4);
+#else
+    dim3 block = dim3(32, 8);
+#endif
+    int grid = THCCeilDiv(THCCeilDiv((int64_t)numel, kSumAvgBackwardIndicesPerWarp),
+                          (int64_t)block.y);
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+        grad.scalar_type(), "embedding_bag_backward_cuda_sum_avg", [&] {
+          EmbeddingBag_accGradParametersKernel_sum_avg<
+              scalar_t><<<grid, block, 0, stream>>>(
+              sorted_indices.data_ptr<int64_t>(), orig_indices.data_ptr<int64_t>(),
+              grad.data_ptr<scalar_t>(), offset2bag.data_ptr<int64_t>(),
+              bag_size.data_ptr<int64_t>(),
+              per_sample_weights.defined() ? per_sample_weights.data_ptr<scalar_t>() : NULL,
+              per_sample_weights.defined() ? per_sample_weights.stride(0) : 0,
+              grad_weight.data_ptr<scalar_t>(), numel, stride, mode == MODE_MEAN);
+        });
+    AT_CUDA_CHECK(cudaGetLastError());
+    return grad_weight;
+  }
+
   Tensor count;
   if (scale_grad_by_freq) {
     count = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -320,6 +533,23 @@ _embedding_bag_cuda(const Tensor &weight, const Tensor &indices,
   int grid = 1024;
   AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, weight.scalar_type(), "embedding_bag_cuda", [&] {
     AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "embedding_bag_cuda", [&] {
+      switch (embedding_bag_warp_per_bag_vec_size<scalar_t>(weight, mode)) {
+        case 4:
+          embedding_bag_update_output_warp_per_bag<scalar_t, 4>(
+              weight, indices, offsets, output, offset2bag, bag_size, numBags,
+              mode, per_sample_weights);
+          return;
+        case 2:
+          embedding_bag_update_output_warp_per_bag<scalar_t, 2>(
+              weight, indices, offsets, output, offset2bag, bag_size, numBags,
+              mode, per_sample_weights);
+          return;
+        case 1:
+          embedding_bag_update_output_warp_per_bag<scalar_t, 1>(
+              weight, indices, offsets, output, offset2bag, bag_size, numBags,
+              mode, per_sample_weights);
+          return;
+      }
       EmbeddingBag_updateOutputKernel<scalar_t><<<grid, block, 0, stream>>>(
           indices.data_ptr<int64_t>(), offsets.data_ptr<int64_t>(),
           weight.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(),
@@ -0,0 +1,87 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+#include <functional>
+
+namespace at { namespace native {
+
+// out = Op(a, alpha * b); mul and div pass alpha = 1.
+template<template<class> class Op>
+std::vector<Tensor> foreach_binary_op(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  auto tensor_lists = make_tensor_lists({tensors1, tensors2}, /*with_result=*/true);
+
+  AT_DISPATCH_ALL_TYPES_AND(kHalf, tensors1[0].scalar_type(), "foreach_binary_op_list_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    auto a = alpha.to<opmath_t>();
+    foreach_apply<2, scalar_t>(tensor_lists, [a] __device__ (opmath_t x, opmath_t y) -> opmath_t {
+      return Op<opmath_t>()(x, a * y);
+    });
+  });
+  return tensor_lists[2];
+}
+
+template<template<class> class Op>
+void foreach_binary_op_(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  auto tensor_lists = make_tensor_lists({tensors1, tensors2}, /*with_result=*/false);
+
+  AT_DISPATCH_ALL_TYPES_AND(kHalf, tensors1[0].scalar_type(), "foreach_binary_op_list_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    auto a = alpha.to<opmath_t>();
+    foreach_apply_<2, scalar_t>(tensor_lists, [a] __device__ (opmath_t x, opmath_t y) -> opmath_t {
+      return Op<opmath_t>()(x, a * y);
+    });
+  });
+}
+
+// A floating point alpha isn't allowed with integral tensors, which the slow
+// path reports.
+#define FOREACH_BINARY_OP_LIST_ALPHA(NAME, OP)                                                       \
+void foreach_tensor_##NAME##_list_kernel_cuda_(TensorList tensors1, TensorList tensors2, Scalar alpha) { \
+  check_foreach_api_restrictions(tensors1, tensors2);                                                \
+  if (!can_use_fast_route(tensors1, tensors2) || !can_use_fast_route(tensors1, alpha)) {             \
+    return at::native::foreach_tensor_##NAME##_list_kernel_slow_(tensors1, tensors2, alpha);         \
+  }                                                                                                  \
+                                                                                                     \
+  foreach_binary_op_<OP>(tensors1, tensors2, alpha);                                                 \
+}                                                                                                    \
+                                                                                                     \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_cuda(TensorList tensors1, TensorList tensors2, Scalar alpha) { \
+  check_foreach_api_restrictions(tensors1, tensors2);                                                \
+  if (!can_use_fast_route(tensors1, tensors2) || !can_use_fast_route(tensors1, alpha)) {             \
+    return at::native::foreach_tensor_##NAME##_list_kernel_slow(tensors1, tensors2, alpha);          \
+  }                                                                                                  \
+                                                                                                     \
+  return foreach_binary_op<OP>(tensors1, tensors2, alpha);                                           \
+}
+
+// Integer division isn't supported by div, so integral tensors take the slow
+// path for the usual error.
+#define FOREACH_BINARY_OP_LIST(NAME, OP, INTEGRAL_OK)                                                \
+void foreach_tensor_##NAME##_list_kernel_cuda_(TensorList tensors1, TensorList tensors2) {           \
+  check_foreach_api_restrictions(tensors1, tensors2);                                                \
+  if (!can_use_fast_route(tensors1, tensors2) ||                                                     \
+      (!INTEGRAL_OK && isIntegralType(tensors1[0].scalar_type(), /*includeBool=*/true))) {           \
+    return at::native::foreach_tensor_##NAME##_list_kernel_slow_(tensors1, tensors2);                \
+  }                                                                                                  \
+                                                                                                     \
+  foreach_binary_op_<OP>(tensors1, tensors2, /*alpha=*/1);                                           \
+}                                                                                                    \
+                                                                                                     \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_cuda(TensorList tensors1, TensorList tensors2) { \
+  check_foreach_api_restrictions(tensors1, tensors2);                                                \
+  if (!can_use_fast_route(tensors1, tensors2) ||                                                     \
+      (!INTEGRAL_OK && isIntegralType(tensors1[0].scalar_type(), /*includeBool=*/true))) {           \
+    return at::native::foreach_tensor_##NAME##_list_kernel_slow(tensors1, tensors2);                 \
+  }                                                                                                  \
+                                                                                                     \
+  return foreach_binary_op<OP>(tensors1, tensors2, /*alpha=*/1);                                     \
+}
+
+FOREACH_BINARY_OP_LIST_ALPHA(add, std::plus);
+FOREACH_BINARY_OP_LIST_ALPHA(sub, std::minus);
+FOREACH_BINARY_OP_LIST(mul, std::multiplies, true);
+FOREACH_BINARY_OP_LIST(div, std::divides, false);
+
+}} // namespace at::native
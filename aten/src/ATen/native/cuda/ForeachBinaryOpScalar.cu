@@ -0,0 +1,71 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+#include <functional>
+
+namespace at { namespace native {
+
+// Like div_kernel_cuda, divides by a scalar by multiplying with its reciprocal.
+template<typename T>
+struct MultipliesReciprocal {
+  __device__ __forceinline__ T operator()(T a, T b) const { return a * (T(1) / b); }
+};
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_binary_op(TensorList tensors, Scalar scalar) {
+  auto tensor_lists = make_tensor_lists({tensors}, /*with_result=*/true);
+
+  AT_DISPATCH_ALL_TYPES_AND(kHalf, tensors[0].scalar_type(), "foreach_binary_op_scalar_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    auto s = scalar.to<opmath_t>();
+    foreach_apply<1, scalar_t>(tensor_lists, [s] __device__ (opmath_t a) -> opmath_t {
+      return Op<opmath_t>()(a, s);
+    });
+  });
+  return tensor_lists[1];
+}
+
+template<template<class> class Op>
+void foreach_binary_op_(TensorList tensors, Scalar scalar) {
+  auto tensor_lists = make_tensor_lists({tensors}, /*with_result=*/false);
+
+  AT_DISPATCH_ALL_TYPES_AND(kHalf, tensors[0].scalar_type(), "foreach_binary_op_scalar_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    auto s = scalar.to<opmath_t>();
+    foreach_apply_<1, scalar_t>(tensor_lists, [s] __device__ (opmath_t a) -> opmath_t {
+      return Op<opmath_t>()(a, s);
+    });
+  });
+}
+
+// Integer division isn't supported by div, so integral tensors take the slow
+// path for the usual error.
+#define FOREACH_BINARY_OP_SCALAR(NAME, OP, INTEGRAL_OK)                                              \
+void foreach_tensor_##NAME##_scalar_kernel_cuda_(TensorList tensors, Scalar scalar) {              \
+  check_foreach_api_restrictions(tensors);                                                           \
+  if (!can_use_fast_route(tensors, scalar) ||                                                        \
+      (!INTEGRAL_OK && isIntegralType(tensors[0].scalar_type(), /*includeBool=*/true))) {            \
+    return at::native::foreach_tensor_##NAME##_scalar_kernel_slow_(tensors, scalar);                 \
+  }                                                                                                  \
+                                                                                                     \
+  foreach_binary_op_<OP>(tensors, scalar);                                                           \
+}                                                                                                    \
+                                                                                                     \
+std::vector<Tensor> foreach_tensor_##NAME##_scalar_kernel_cuda(TensorList tensors, Scalar scalar) {  \
+  check_foreach_api_restrictions(tensors);                                                           \
+  if (!can_use_fast_route(tensors, scalar) ||                                                        \
+      (!INTEGRAL_OK && isIntegralType(tensors[0].scalar_type(), /*includeBool=*/true))) {            \
+    return at::native::foreach_tensor_##NAME##_scalar_kernel_slow(tensors, scalar);                  \
+  }                                                                                                  \
+                                                                                                     \
+  return foreach_binary_op<OP>(tensors, scalar);                                                     \
+}
+
+FOREACH_BINARY_OP_SCALAR(add, std::plus, true);
+FOREACH_BINARY_OP_SCALAR(sub, std::minus, true);
+FOREACH_BINARY_OP_SCALAR(mul, std::multiplies, true);
+FOREACH_BINARY_OP_SCALAR(div, MultipliesReciprocal, false);
+
+}} // namespace at::native
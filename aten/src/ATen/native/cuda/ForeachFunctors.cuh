@@ -0,0 +1,150 @@
+#pragma once
+
+#include <ATen/AccumulateType.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+
+namespace at { namespace native {
+
+namespace {
+
+// Points args[i] at the current chunk of the current tensor of list i.
+// Returns whether all of them can be accessed with vectorized loads.
+template<int depth, typename T>
+__device__ __forceinline__ bool init_args(
+    T** args,
+    TensorListMetadata<depth>& tl,
+    int chunk_idx,
+    int64_t chunk_size,
+    int tensor_loc) {
+  bool all_aligned = true;
+  #pragma unroll
+  for (int i = 0; i < depth; i++) {
+    args[i] = (T*)tl.addresses[i][tensor_loc];
+    args[i] += chunk_idx * chunk_size;
+
+    if (!is_aligned(args[i])) {
+      all_aligned = false;
+    }
+  }
+  return all_aligned;
+}
+
+template<typename Op, typename opmath_t>
+__device__ __forceinline__ opmath_t apply_op(Op& op, opmath_t (&r_args)[1][kILP], int ii) {
+  return op(r_args[0][ii]);
+}
+
+template<typename Op, typename opmath_t>
+__device__ __forceinline__ opmath_t apply_op(Op& op, opmath_t (&r_args)[2][kILP], int ii) {
+  return op(r_args[0][ii], r_args[1][ii]);
+}
+
+template<typename Op, typename opmath_t>
+__device__ __forceinline__ opmath_t apply_op(Op& op, opmath_t (&r_args)[3][kILP], int ii) {
+  return op(r_args[0][ii], r_args[1][ii], r_args[2][ii]);
+}
+
+} // anonymous namespace
+
+// Functor for multi_tensor_apply: reads the first r_args_depth lists, applies
+// `op` elementwise in opmath_t (float for Half), and writes the result to list
+// res_arg_index. In-place ops use res_arg_index == 0 and depth == r_args_depth;
+// out-of-place ops pass the result list last, i.e. depth == r_args_depth + 1
+// and res_arg_index == r_args_depth.
+template<typename T, int depth, int r_args_depth, int res_arg_index>
+struct ElementwiseOpFunctor {
+  using opmath_t = at::acc_type<T, /*is_cuda=*/true>;
+
+  template<typename Op>
+  __device__ __forceinline__ void operator() (
+      int64_t chunk_size,
+      TensorListMetadata<depth>& tl,
+      Op op) {
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int64_t n = tl.numel_for_tensor[tensor_loc];
+
+    T* args[depth];
+    bool all_aligned = init_args<depth>(args, tl, chunk_idx, chunk_size, tensor_loc);
+    n -= chunk_idx * chunk_size;
+
+    opmath_t r_args[r_args_depth][kILP];
+
+    // Vectorized path: every thread handles kILP consecutive elements.
+    if (n % kILP == 0 && chunk_size % kILP == 0 && all_aligned) {
+      for (int64_t i_start = threadIdx.x; i_start * kILP < n && i_start * kILP < chunk_size; i_start += blockDim.x) {
+        #pragma unroll
+        for (int i = 0; i < r_args_depth; i++) {
+          T r_in[kILP];
+          load_store(r_in, args[i], 0, i_start);
+          #pragma unroll
+          for (int ii = 0; ii < kILP; ii++) {
+            r_args[i][ii] = static_cast<opmath_t>(r_in[ii]);
+          }
+        }
+        T r_out[kILP];
+        #pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+          r_out[ii] = static_cast<T>(apply_op(op, r_args, ii));
+        }
+        load_store(args[res_arg_index], r_out, i_start, 0);
+      }
+    } else {
+      for (int64_t i_start = 0; i_start < n && i_start < chunk_size; i_start += blockDim.x * kILP) {
+        #pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+          int64_t i = i_start + threadIdx.x + ii * blockDim.x;
+          #pragma unroll
+          for (int d = 0; d < r_args_depth; d++) {
+            r_args[d][ii] = (i < n && i < chunk_size) ? static_cast<opmath_t>(args[d][i]) : opmath_t(0);
+          }
+        }
+        #pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+          int64_t i = i_start + threadIdx.x + ii * blockDim.x;
+          if (i < n && i < chunk_size) {
+            args[res_arg_index][i] = static_cast<T>(apply_op(op, r_args, ii));
+          }
+        }
+      }
+    }
+  }
+};
+
+// Runs `op` over the first tensor list in place (foreach_apply_) or into the
+// results appended as the last list (foreach_apply). The tensors must pass
+// can_use_fast_route.
+template<int r_args_depth, typename scalar_t, typename Op>
+void foreach_apply_(std::vector<std::vector<at::Tensor>>& tensor_lists, Op op) {
+  multi_tensor_apply<r_args_depth>(
+      tensor_lists, ElementwiseOpFunctor<scalar_t, r_args_depth, r_args_depth, 0>(), op);
+}
+
+template<int r_args_depth, typename scalar_t, typename Op>
+void foreach_apply(std::vector<std::vector<at::Tensor>>& tensor_lists, Op op) {
+  multi_tensor_apply<r_args_depth + 1>(
+      tensor_lists, ElementwiseOpFunctor<scalar_t, r_args_depth + 1, r_args_depth, r_args_depth>(), op);
+}
+
+// Builds the tensor lists of a foreach op; for the out-of-place version,
+// allocates the results and appends them as the last list.
+inline std::vector<std::vector<at::Tensor>> make_tensor_lists(
+    std::initializer_list<TensorList> inputs,
+    bool with_result) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.reserve(inputs.size() + 1);
+  for (const auto& list : inputs) {
+    tensor_lists.emplace_back(list.vec());
+  }
+  if (with_result) {
+    std::vector<at::Tensor> result;
+    result.reserve(tensor_lists[0].size());
+    for (const auto& t : tensor_lists[0]) {
+      result.emplace_back(at::empty_like(t));
+    }
+    tensor_lists.emplace_back(std::move(result));
+  }
+  return tensor_lists;
+}
+
+}} // namespace at::native
@@ -0,0 +1,72 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+// Same arithmetic as the addcmul and addcdiv kernels in PointwiseOpsKernel.cu.
+template<typename T>
+struct Addcmul {
+  __device__ __forceinline__ T operator()(T a, T b, T c, T value) const { return a + value * b * c; }
+};
+
+template<typename T>
+struct Addcdiv {
+  __device__ __forceinline__ T operator()(T a, T b, T c, T value) const { return a + value * (b / c); }
+};
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_pointwise_op(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) {
+  auto tensor_lists = make_tensor_lists({input, tensors1, tensors2}, /*with_result=*/true);
+
+  AT_DISPATCH_ALL_TYPES_AND(kHalf, input[0].scalar_type(), "foreach_pointwise_op_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    auto s = scalar.to<opmath_t>();
+    foreach_apply<3, scalar_t>(tensor_lists, [s] __device__ (opmath_t a, opmath_t b, opmath_t c) -> opmath_t {
+      return Op<opmath_t>()(a, b, c, s);
+    });
+  });
+  return tensor_lists[3];
+}
+
+template<template<class> class Op>
+void foreach_pointwise_op_(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) {
+  auto tensor_lists = make_tensor_lists({input, tensors1, tensors2}, /*with_result=*/false);
+
+  AT_DISPATCH_ALL_TYPES_AND(kHalf, input[0].scalar_type(), "foreach_pointwise_op_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    auto s = scalar.to<opmath_t>();
+    foreach_apply_<3, scalar_t>(tensor_lists, [s] __device__ (opmath_t a, opmath_t b, opmath_t c) -> opmath_t {
+      return Op<opmath_t>()(a, b, c, s);
+    });
+  });
+}
+
+// addcdiv doesn't support integer division, so integral tensors take the slow
+// path for the usual error.
+#define FOREACH_POINTWISE_OP(NAME, OP, INTEGRAL_OK)                                                  \
+void foreach_tensor_##NAME##_cuda_(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) { \
+  check_foreach_api_restrictions(input, tensors1, tensors2);                                         \
+  if (!can_use_fast_route(input, tensors1, tensors2) || !can_use_fast_route(input, scalar) ||        \
+      (!INTEGRAL_OK && isIntegralType(input[0].scalar_type(), /*includeBool=*/true))) {              \
+    return at::native::foreach_tensor_##NAME##_slow_(input, tensors1, tensors2, scalar);             \
+  }                                                                                                  \
+                                                                                                     \
+  foreach_pointwise_op_<OP>(input, tensors1, tensors2, scalar);                                      \
+}                                                                                                    \
+                                                                                                     \
+std::vector<Tensor> foreach_tensor_##NAME##_cuda(TensorList input, TensorList tensors1, TensorList tensors2, Scalar scalar) { \
+  check_foreach_api_restrictions(input, tensors1, tensors2);                                         \
+  if (!can_use_fast_route(input, tensors1, tensors2) || !can_use_fast_route(input, scalar) ||        \
+      (!INTEGRAL_OK && isIntegralType(input[0].scalar_type(), /*includeBool=*/true))) {              \
+    return at::native::foreach_tensor_##NAME##_slow(input, tensors1, tensors2, scalar);              \
+  }                                                                                                  \
+                                                                                                     \
+  return foreach_pointwise_op<OP>(input, tensors1, tensors2, scalar);                                \
+}
+
+FOREACH_POINTWISE_OP(addcmul, Addcmul, true);
+FOREACH_POINTWISE_OP(addcdiv, Addcdiv, false);
+
+}} // namespace at::native
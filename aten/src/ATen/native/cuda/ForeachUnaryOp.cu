@@ -0,0 +1,66 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+// Device functors of the unary ops; Half inputs are computed in float.
+template<typename T>
+struct Sqrt {
+  __device__ __forceinline__ T operator()(T a) const { return ::sqrt(a); }
+};
+
+template<typename T>
+struct Exp {
+  __device__ __forceinline__ T operator()(T a) const { return ::exp(a); }
+};
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_unary_op(TensorList tensors) {
+  auto tensor_lists = make_tensor_lists({tensors}, /*with_result=*/true);
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors[0].scalar_type(), "foreach_unary_op_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    foreach_apply<1, scalar_t>(tensor_lists, Op<opmath_t>());
+  });
+  return tensor_lists[1];
+}
+
+template<template<class> class Op>
+void foreach_unary_op_(TensorList tensors) {
+  auto tensor_lists = make_tensor_lists({tensors}, /*with_result=*/false);
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors[0].scalar_type(), "foreach_unary_op_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    foreach_apply_<1, scalar_t>(tensor_lists, Op<opmath_t>());
+  });
+}
+
+// The unary ops are only implemented for floating point types; integral
+// tensors take the slow path for the usual error.
+#define FOREACH_UNARY_OP(NAME, OP)                                                                   \
+void foreach_tensor_##NAME##_cuda_(TensorList tensors) {                                             \
+  check_foreach_api_restrictions(tensors);                                                           \
+  if (!can_use_fast_route(tensors) ||                                                                \
+      isIntegralType(tensors[0].scalar_type(), /*includeBool=*/true)) {                              \
+    return at::native::foreach_tensor_##NAME##_slow_(tensors);                                       \
+  }                                                                                                  \
+                                                                                                     \
+  foreach_unary_op_<OP>(tensors);                                                                    \
+}                                                                                                    \
+                                                                                                     \
+std::vector<Tensor> foreach_tensor_##NAME##_cuda(TensorList tensors) {                               \
+  check_foreach_api_restrictions(tensors);                                                           \
+  if (!can_use_fast_route(tensors) ||                                                                \
+      isIntegralType(tensors[0].scalar_type(), /*includeBool=*/true)) {                              \
+    return at::native::foreach_tensor_##NAME##_slow(tensors);                                        \
+  }                                                                                                  \
+                                                                                                     \
+  return foreach_unary_op<OP>(tensors);                                                              \
+}
+
+FOREACH_UNARY_OP(sqrt, Sqrt);
+FOREACH_UNARY_OP(exp, Exp);
+
+}} // namespace at::native
@@ -0,0 +1,148 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/IncrementalAttention.h>
+#include <ATen/native/cuda/PersistentSoftmax.cuh>
+
+namespace at { namespace native {
+
+namespace {
+
+// One block per (batch, head) attends its query to all the steps of the
+// caches. Warps compute the scores of a step each, kept in shared memory for
+// the softmax, then the threads sum the values weighted by them, several
+// steps at once when the head is narrower than the block.
+template <typename scalar_t, typename acc_t>
+__global__ void incremental_attention_kernel(
+    scalar_t* out,
+    const scalar_t* query,
+    const scalar_t* keys,
+    const scalar_t* values,
+    int steps,
+    int batch,
+    int key_dim,
+    int value_dim,
+    acc_t scale) {
+  constexpr int WARPS = SOFTMAX_BLOCK_THREADS / C10_WARP_SIZE;
+  extern __shared__ char shared_scores[];
+  acc_t* scores = reinterpret_cast<acc_t*>(shared_scores);
+  __shared__ acc_t reduce_buffer[WARPS];
+  __shared__ acc_t partial[SOFTMAX_BLOCK_THREADS];
+
+  const int n = blockIdx.x;
+  const int warp = threadIdx.x / C10_WARP_SIZE;
+  const int lane = threadIdx.x % C10_WARP_SIZE;
+  const scalar_t* q = query + static_cast<int64_t>(n) * key_dim;
+
+  acc_t max_score = -std::numeric_limits<acc_t>::infinity();
+  for (int t = warp; t < steps; t += WARPS) {
+    const scalar_t* k =
+        keys + (static_cast<int64_t>(t) * batch + n) * key_dim;
+    acc_t dot = 0;
+    for (int d = lane; d < key_dim; d += C10_WARP_SIZE) {
+      dot += static_cast<acc_t>(q[d]) * static_cast<acc_t>(k[d]);
+    }
+    warp_reduce<acc_t, 1, C10_WARP_SIZE, Add>(&dot);
+    dot *= scale;
+    if (lane == 0) {
+      scores[t] = dot;
+    }
+    max_score = max_score < dot ? dot : max_score;
+  }
+  max_score = block_reduce<acc_t, Max>(max_score, reduce_buffer);
+
+  acc_t sum = 0;
+  for (int t = threadIdx.x; t < steps; t += blockDim.x) {
+    const acc_t p = std::exp(scores[t] - max_score);
+    scores[t] = p;
+    sum += p;
+  }
+  const acc_t inv_sum = acc_t(1) / block_reduce<acc_t, Add>(sum, reduce_buffer);
+
+  const int64_t value_stride = static_cast<int64_t>(batch) * value_dim;
+  const scalar_t* v = values + static_cast<int64_t>(n) * value_dim;
+  scalar_t* o = out + static_cast<int64_t>(n) * value_dim;
+  const int groups =
+      value_dim < SOFTMAX_BLOCK_THREADS ? SOFTMAX_BLOCK_THREADS / value_dim : 1;
+  if (groups == 1) {
+    for (int d = threadIdx.x; d < value_dim; d += blockDim.x) {
+      acc_t acc = 0;
+      for (int t = 0; t < steps; t++) {
+        acc += scores[t] * static_cast<acc_t>(v[t * value_stride + d]);
+      }
+      o[d] = static_cast<scalar_t>(acc * inv_sum);
+    }
+    return;
+  }
+  const int d = threadIdx.x % value_dim;
+  const int group = threadIdx.x / value_dim;
+  acc_t acc = 0;
+  if (group < groups) {
+    for (int t = group; t < steps; t += groups) {
+      acc += scores[t] * static_cast<acc_t>(v[t * value_stride + d]);
+    }
+  }
+  partial[threadIdx.x] = acc;
+  __syncthreads();
+  if (threadIdx.x < value_dim) {
+    for (int g = 1; g < groups; g++) {
+      acc += partial[g * value_dim + threadIdx.x];
+    }
+    o[threadIdx.x] = static_cast<scalar_t>(acc * inv_sum);
+  }
+}
+
+void incremental_attention_kernel_cuda(
+    Tensor& out,
+    const Tensor& query,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    double scale) {
+  const int64_t steps = key_cache.size(0);
+  const int64_t batch = key_cache.size(1);
+  const int64_t key_dim = key_cache.size(2);
+  const int64_t value_dim = value_cache.size(2);
+  TORCH_CHECK(
+      key_cache.numel() <= std::numeric_limits<int>::max() &&
+          value_cache.numel() <= std::numeric_limits<int>::max(),
+      "_incremental_attention: caches too large");
+  const size_t shared_bytes = steps * (query.scalar_type() == kDouble ? 8 : 4);
+  const size_t max_shared_bytes =
+      at::cuda::getCurrentDeviceProperties()->sharedMemPerBlock -
+      (SOFTMAX_BLOCK_THREADS + SOFTMAX_BLOCK_THREADS / C10_WARP_SIZE) * 8;
+  if (shared_bytes > max_shared_bytes) {
+    // Too many steps to keep their scores in shared memory
+    const Tensor scores =
+        at::bmm(key_cache.transpose(0, 1), query.unsqueeze(2)).squeeze(2);
+    const Tensor p = at::softmax(scores * scale, 1);
+    out.copy_(at::bmm(p.unsqueeze(1), value_cache.transpose(0, 1)).squeeze(1));
+    return;
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      query.scalar_type(), "incremental_attention_cuda", [&] {
+        using acc_t = acc_type<scalar_t, /*is_cuda=*/true>;
+        incremental_attention_kernel<scalar_t, acc_t>
+            <<<batch,
+               SOFTMAX_BLOCK_THREADS,
+               shared_bytes,
+               at::cuda::getCurrentCUDAStream()>>>(
+                out.data_ptr<scalar_t>(),
+                query.data_ptr<scalar_t>(),
+                key_cache.data_ptr<scalar_t>(),
+                value_cache.data_ptr<scalar_t>(),
+                steps,
+                batch,
+                key_dim,
+                value_dim,
+                static_cast<acc_t>(scale));
+        AT_CUDA_CHECK(cudaGetLastError());
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(incremental_attention_stub, &incremental_attention_kernel_cuda);
+
+}} // namespace at::native
@@ -18,8 +18,11 @@
 #include <thrust/sort.h>
 #include <THC/THCAtomics.cuh>
 
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/macros/Macros.h>
 
+#include <cub/cub.cuh>
+
 namespace {
 
 template <typename scalar_t, int SZ>
@@ -180,6 +183,44 @@ static std::tuple<Tensor, Tensor, int64_t, int64_t, int64_t, std::vector<int64_t
 
 
 namespace {
+// Sorts the row indices `keys`, all in [0, num_rows), along with their original
+// positions. The sort is stable, so indexing_backward_kernel adds the values of
+// a row in the order of the indices and the sums are deterministic.
+void sort_row_indices(const Tensor & keys, int64_t num_rows, Tensor & sorted_keys,
+                      Tensor & orig_indices, cudaStream_t stream) {
+  const int64_t num_keys = keys.numel();
+  const auto positions = at::arange(num_keys, keys.options());
+  if (num_keys < std::numeric_limits<int>::max()) {
+    // The radix sort only needs to look at the bits a row index can have
+    int end_bit = 1;
+    while (end_bit < 63 && (int64_t(1) << end_bit) < num_rows) {
+      end_bit++;
+    }
+    size_t temp_storage_bytes = 0;
+    AT_CUDA_CHECK(cub::DeviceRadixSort::SortPairs(
+        nullptr, temp_storage_bytes,
+        keys.data_ptr<int64_t>(), sorted_keys.data_ptr<int64_t>(),
+        positions.data_ptr<int64_t>(), orig_indices.data_ptr<int64_t>(),
+        static_cast<int>(num_keys), 0, end_bit, stream));
+    auto& allocator = *c10::cuda::CUDACachingAllocator::get();
+    auto temp_storage = allocator.allocate(temp_storage_bytes);
+    AT_CUDA_CHECK(cub::DeviceRadixSort::SortPairs(
+        temp_storage.get(), temp_storage_bytes,
+        keys.data_ptr<int64_t>(), sorted_keys.data_ptr<int64_t>(),
+        positions.data_ptr<int64_t>(), orig_indices.data_ptr<int64_t>(),
+        static_cast<int>(num_keys), 0, end_bit, stream));
+  } else {
+    sorted_keys.copy_(keys);
+    orig_indices.copy_(positions);
+    auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+    auto policy = thrust::cuda::par(allocator).on(stream);
+    using device_ptr = thrust::device_ptr<int64_t>;
+    auto sorted_data = device_ptr(sorted_keys.data_ptr<int64_t>());
+    auto orig_data = device_ptr(orig_indices.data_ptr<int64_t>());
+    thrust::stable_sort_by_key(policy, sorted_data, sorted_data + num_keys, orig_data);
+  }
+}
+
 void index_put_accum_kernel(Tensor & self, TensorList indices, const Tensor & value, bool unsafe) {
   if (indices.size() > (size_t)self.dim()) {
     TORCH_CHECK_INDEX(false, "too many indices for tensor of dimension ", self.dim(), " (got ", indices.size(), ")");
@@ -193,31 +234,13 @@ void index_put_accum_kernel(Tensor & self, TensorList indices, const Tensor & va
   if (num_indices > 0 && sliceSize > 0) {
       const bool permuted = !src.is_contiguous();
       auto src_ = permuted ? src.contiguous() : src;
-      linearIndex = linearIndex.reshape(-1);
+      linearIndex = linearIndex.reshape(-1).contiguous();
       auto sorted_indices = at::empty_like(linearIndex, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
       auto orig_indices = at::empty_like(linearIndex, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-      using device_ptr = thrust::device_ptr<int64_t>;
       const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
 
       linearIndex.floor_divide_(sliceSize);
-      {
-      sorted_indices.copy_(linearIndex);
-      auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
-      auto policy = thrust::cuda::par(allocator).on(stream);
-
-      // Fill sortedOrigIndices with sequential indices
-      const auto count_iter = thrust::counting_iterator<int64_t>(0);
-      auto orig_data = device_ptr(orig_indices.data_ptr<int64_t>());
-      thrust::copy(policy, count_iter, count_iter + num_indices, orig_data);
-
-      // Sort the inputs into sorted with the corresponding indices; we
-      // don't need a stable or multidimensional sort, so just use Thrust
-      // directly
-      // Sort; a stable sort is not required
-      // NB - not passing comparator causes thrust to use radix sort, and it hurts perf A LOT, at least for medium (few K) sized indices
-      auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
-      thrust::sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data, ThrustLTOp<int64_t>());
-      }
+      sort_row_indices(linearIndex, src.numel() / sliceSize, sorted_indices, orig_indices, stream);
       TORCH_INTERNAL_ASSERT(linearIndex.numel()*sliceSize*nElemBefore == value.numel(), "number of flattened indices did not match number of elements in the value tensor", linearIndex.numel()*sliceSize*nElemBefore, value.numel());
       const int UNROLL = 4;
       const int indices_per_block = 4;
@@ -242,7 +265,7 @@ void index_put_accum_kernel(Tensor & self, TensorList indices, const Tensor & va
       });
       AT_CUDA_CHECK(cudaGetLastError());
       if (permuted)
-          self.copy_(src_.permute(inversePerm));
+          self.copy_(inversePerm.empty() ? src_ : src_.permute(inversePerm));
   }
 }
 
@@ -424,6 +447,31 @@ bool indexShouldBeMajor(cuda::detail::TensorInfo<scalar_t, unsigned int> &info,
   return false;
 }
 
+// Whether index_add_ sorts the indices and accumulates the rows added to more
+// than once with index_put_accum_kernel, instead of with atomics. The atomics
+// serialize on the rows that are added to many times, and do so in no
+// particular order.
+static bool indexAddShouldSort(const Tensor & self, int64_t dim, const Tensor & source,
+                               ptrdiff_t numIndex, int64_t selfAddDimSize) {
+  // index_put_accum_kernel reads source in the layout of self
+  if (source.dim() != self.dim()) {
+    return false;
+  }
+  for (int64_t d = 0; d < self.dim(); d++) {
+    if (d != dim && source.size(d) != self.size(d)) {
+      return false;
+    }
+  }
+  if (globalContext().deterministic()) {
+    return true;
+  }
+  // On average, each row is added to numIndex / selfAddDimSize times. Half and
+  // BFloat16 atomics are compare-and-swap loops, which contend sooner.
+  const bool reducedPrecision =
+      self.scalar_type() == kHalf || self.scalar_type() == kBFloat16;
+  return numIndex > (reducedPrecision ? 1 : 4) * selfAddDimSize;
+}
+
 Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
   dim = maybe_wrap_dim(dim, self.dim());
 
@@ -460,6 +508,17 @@ Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const
   if (sliceSize == 0) {
     return self;
   }
+  if (indexAddShouldSort(self_, dim, source_, numIndex, selfAddDimSize)) {
+    // self.index_add_(dim, index, source) is
+    // self.index_put_({:, ..., :, index}, source, accumulate=true)
+    std::vector<Tensor> indices(dim);
+    indices.emplace_back(index.reshape(-1));
+    index_put_accum_kernel(self_, indices, source_, /*unsafe=*/false);
+    return self;
+  }
+  if (isFloatingType(self.scalar_type())) {
+    globalContext().alertNotDeterministic("index_add_cuda_");
+  }
   const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
   bool indContig = index.is_contiguous();
 
@@ -2,6 +2,7 @@
 #include <ATen/LegacyTHFunctionsCUDA.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/cuda/CUDABlas.h>
+#include <ATen/native/LinearAlgebraUtils.h>
 
 namespace at { namespace native {
 
@@ -51,9 +52,49 @@ Tensor prepare_matrix_for_cublas(Tensor& tensor, bool& transpose_tensor) {
 
 namespace {
 
-Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha) {
+enum class Activation {
+  None,
+  RELU,
+  GELU,
+};
+
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+cuda::blas::GEMMAndBiasActivationEpilogue activation_to_gemm_and_bias_epilogue(Activation a) {
+  switch (a) {
+    case Activation::None:
+      return cuda::blas::GEMMAndBiasActivationEpilogue::None;
+    case Activation::RELU:
+      return cuda::blas::GEMMAndBiasActivationEpilogue::RELU;
+    case Activation::GELU:
+      return cuda::blas::GEMMAndBiasActivationEpilogue::GELU;
+    default:
+      TORCH_CHECK(false);
+      return cuda::blas::GEMMAndBiasActivationEpilogue::None;
+  }
+}
+#endif
+
+Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha, Activation activation = Activation::None) {
   TORCH_CHECK(mat1.dim() == 2 && mat2.dim() == 2, "tensors must be 2-D");
 
+  // A bias of the size of the columns of the result, as linear calls addmm
+  // with, is added by the epilogue of a cuBLASLt matmul, along with the
+  // activation, instead of being copied into the result beforehand.
+  bool useLtInterface = false;
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  at::ScalarType self_type = self.scalar_type();
+  useLtInterface = &result != &self && self.dim() == 1 && self.stride(0) == 1 &&
+      self.size(0) == mat2.size(1) && self.size(0) > 1 && mat1.size(1) > 0 &&
+      mat1.scalar_type() == self_type && mat2.scalar_type() == self_type &&
+      (self_type == at::ScalarType::Float || self_type == at::ScalarType::Half ||
+       self_type == at::ScalarType::BFloat16) &&
+      beta.to<double>() == 1.0 &&
+#if CUDA_VERSION < 11040
+      activation != Activation::GELU &&
+#endif
+      true;
+#endif
+
   Tensor self_;
   if (&result != &self) {
     std::tie(self_) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm");
@@ -70,7 +111,8 @@ Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& ma
 
   if (&result != &self) {
     at::native::resize_as_(result, self_);
-    if (beta.to<double>() != 0.0) {
+    useLtInterface = useLtInterface && result.is_contiguous();
+    if (beta.to<double>() != 0.0 && !useLtInterface) {
       at::native::copy_(result, self_);
     }
   }
@@ -106,6 +148,29 @@ Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& ma
   int64_t result_ld = result_.stride(transpose_result ? 0 : 1);
   at::ScalarType scalar_type = self_.scalar_type();
 
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  if (useLtInterface) {
+    // The result is contiguous with more than one column, so it is computed
+    // transposed, and the bias runs along the rows of the column-major result
+    // cuBLASLt sees.
+    TORCH_INTERNAL_ASSERT(transpose_result && result_.is_same(result));
+    AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, scalar_type, "addmm_cuda_lt", [&] {
+      at::cuda::blas::gemm_and_bias<scalar_t>(
+        transpose_mat1,
+        transpose_mat2,
+        m, n, k,
+        alpha.to<scalar_t>(),
+        mat1_.data_ptr<scalar_t>(), mat1_ld,
+        mat2_.data_ptr<scalar_t>(), mat2_ld,
+        self.data_ptr<scalar_t>(),
+        result_.data_ptr<scalar_t>(), result_ld,
+        activation_to_gemm_and_bias_epilogue(activation)
+      );
+    });
+    return result;
+  }
+#endif
+
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, scalar_type, "addmm_cuda", [&] {
     scalar_t alpha_val = alpha.to<scalar_t>();
     scalar_t beta_val = beta.to<scalar_t>();
@@ -126,6 +191,9 @@ Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& ma
   if (result.data_ptr() != result_.data_ptr()) {
     result.copy_(result_);
   }
+  if (activation != Activation::None) {
+    addmm_activation_(result, activation == Activation::GELU);
+  }
   return result;
 }
 
@@ -165,6 +233,55 @@ Tensor& addmm__cuda(Tensor& self, const Tensor& mat1, const Tensor& mat2,
   return self;
 }
 
+Tensor addmm_activation_cuda(const Tensor& self, const Tensor& mat1, const Tensor& mat2,
+                             Scalar beta, Scalar alpha, bool use_gelu) {
+  Tensor out = at::empty({0}, self.options());
+  {
+    at::NoNamesGuard guard;
+    addmm_out_cuda_impl(out, self, mat1, mat2, beta, alpha,
+                        use_gelu ? Activation::GELU : Activation::RELU);
+  }
+  at::namedinference::propagate_names_for_addmm(out, mat1, mat2, self);
+  return out;
+}
+
+Tensor _int_mm_cuda(const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.dim() == 2 && mat2.dim() == 2, "_int_mm: tensors must be 2-D");
+  TORCH_CHECK(self.size(1) == mat2.size(0), "_int_mm: self dim 1 must match mat2 dim 0");
+  TORCH_CHECK(self.scalar_type() == at::ScalarType::Char && mat2.scalar_type() == at::ScalarType::Char,
+              "_int_mm: expected int8 tensors, but got ", self.scalar_type(), " and ", mat2.scalar_type());
+  TORCH_CHECK(self.size(1) % 8 == 0 && mat2.size(1) % 8 == 0,
+              "_int_mm: self dim 1 and mat2 dim 1 must be multiples of 8");
+
+  Tensor result = at::empty({self.size(0), mat2.size(1)}, self.options().dtype(at::kInt));
+  if (result.numel() == 0) {
+    return result;
+  }
+  if (self.size(1) == 0) {
+    return result.zero_();
+  }
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  // The IMMA kernels take a transposed first and a non transposed second
+  // matrix. In column-major, the row-major result is mat2^T * self^T, which
+  // is that for a column-major mat2 (like the transposed weight of linear)
+  // and a row-major self.
+  const Tensor self_ = self.contiguous();
+  const Tensor mat2_ = mat2.t().contiguous().t();
+  const int64_t m = self.size(0);
+  const int64_t k = self.size(1);
+  const int64_t n = mat2.size(1);
+  at::cuda::blas::int8_gemm(
+      true, false,
+      n, m, k,
+      mat2_.data_ptr<int8_t>(), k,
+      self_.data_ptr<int8_t>(), k,
+      result.data_ptr<int32_t>(), n);
+#else
+  TORCH_CHECK(false, "_int_mm: needs cuBLASLt, which is only used from CUDA 11 on");
+#endif
+  return result;
+}
+
 template<typename scalar_t>
 void addr_impl_ger_cuda(Tensor &out, const Tensor &self,
                         const Tensor& vec1, const Tensor& vec2,
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/cuda/MemoryAccess.cuh>
+
+#include <vector>
+
+namespace at { namespace native {
+
+// Multi tensor apply runs an elementwise functor over lists of tensors with
+// a handful of kernel launches instead of one launch per tensor.
+//
+// Every tensor is cut into chunks of kChunkSize elements and each CUDA block
+// processes one chunk. The addresses and sizes of the tensors, and the
+// (tensor, chunk) pair of each block, travel to the kernel by value in a
+// TensorListMetadata. Kernel arguments are limited to 4KB, so a launch covers
+// at most depth_to_max_tensors tensors and depth_to_max_blocks blocks; longer
+// lists, or huge tensors, are split over several launches.
+//
+// `depth` is the number of tensor lists: e.g. 2 for out = op(in), 3 for
+// out = op(in1, in2). The i-th tensor of every list must have the same number
+// of elements and layout; see can_use_fast_route in ForeachUtils.h.
+
+static constexpr int64_t kILP = 4;
+static constexpr int64_t kChunkSize = 65536;
+static constexpr int64_t kBlockSize = 512;
+
+static constexpr int depth_to_max_tensors[5] = {110, 64, 48, 36, 30};
+static constexpr int depth_to_max_blocks[5] = {320, 320, 320, 320, 320};
+
+template<int n> struct TensorListMetadata {
+  void* addresses[n][depth_to_max_tensors[n-1]];
+  int64_t numel_for_tensor[depth_to_max_tensors[n-1]];
+  unsigned char block_to_tensor[depth_to_max_blocks[n-1]];
+  int block_to_chunk[depth_to_max_blocks[n-1]];
+};
+
+template<typename T>
+__device__ __forceinline__ bool is_aligned(T* p) {
+  return ((uint64_t)p) % (kILP * sizeof(T)) == 0;
+}
+
+template<typename T>
+__device__ __forceinline__ void load_store(T* dst, T* src, int64_t dst_offset, int64_t src_offset) {
+  using LT = at::native::memory::aligned_vector<T, kILP>;
+  ((LT*)dst)[dst_offset] = ((LT*)src)[src_offset];
+}
+
+template<typename T, typename U, typename... ArgTypes>
+C10_LAUNCH_BOUNDS_1(kBlockSize)
+__global__ void multi_tensor_apply_kernel(
+    T tensorListMeta,
+    U callable,
+    ArgTypes... args) {
+  // Hand the chunk information to the functor, which processes it however it likes.
+  callable(kChunkSize, tensorListMeta, args...);
+}
+
+template<int depth, typename T, typename... ArgTypes>
+void multi_tensor_apply(
+    std::vector<std::vector<at::Tensor>>& tensor_lists,
+    T callable,
+    ArgTypes... args) {
+  TORCH_CHECK(tensor_lists.size() == depth, "Number of tensor lists has to match the depth.");
+  const auto n_tensors = tensor_lists[0].size();
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  TensorListMetadata<depth> tensorListMeta;
+  int loc_block_info = 0;
+  int loc_tensor_info = 0;
+
+  auto launch = [&]() {
+    multi_tensor_apply_kernel<<<loc_block_info, kBlockSize, 0, stream>>>(
+        tensorListMeta, callable, args...);
+    AT_CUDA_CHECK(cudaGetLastError());
+  };
+
+  for (size_t t = 0; t < n_tensors; t++) {
+    const auto numel = tensor_lists[0][t].numel();
+    if (numel == 0) {
+      continue;
+    }
+
+    tensorListMeta.numel_for_tensor[loc_tensor_info] = numel;
+    for (int d = 0; d < depth; d++) {
+      tensorListMeta.addresses[d][loc_tensor_info] = tensor_lists[d][t].data_ptr();
+    }
+    loc_tensor_info++;
+
+    const auto chunks = (numel + kChunkSize - 1) / kChunkSize;
+    for (int64_t chunk = 0; chunk < chunks; chunk++) {
+      tensorListMeta.block_to_tensor[loc_block_info] = loc_tensor_info - 1;
+      tensorListMeta.block_to_chunk[loc_block_info] = chunk;
+      loc_block_info++;
+
+      const bool tensors_full = (loc_tensor_info == depth_to_max_tensors[depth-1] &&
+                                 chunk == chunks - 1);
+      const bool blocks_full = (loc_block_info == depth_to_max_blocks[depth-1]);
+
+      if (tensors_full || blocks_full) {
+        launch();
+        loc_block_info = 0;
+        if (chunk == chunks - 1) {
+          loc_tensor_info = 0;
+        } else {
+          // The current tensor still has chunks left: carry it over to the
+          // front of the next launch.
+          tensorListMeta.numel_for_tensor[0] = tensorListMeta.numel_for_tensor[loc_tensor_info - 1];
+          for (int d = 0; d < depth; d++) {
+            tensorListMeta.addresses[d][0] = tensorListMeta.addresses[d][loc_tensor_info - 1];
+          }
+          loc_tensor_info = 1;
+        }
+      }
+    }
+  }
+
+  if (loc_block_info > 0) {
+    launch();
+  }
+}
+
+}} // namespace at::native
@@ -4,6 +4,8 @@
 #include <ATen/native/UnaryOps.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAGraphsUtils.cuh>
+#include <ATen/CUDAGeneratorImpl.h>
 #include <ATen/native/cuda/LaunchUtils.h>
 #include <ATen/AccumulateType.h>
 
@@ -399,8 +401,62 @@ void multinomial_kernel_impl(Tensor& result, const Tensor& self, const int64_t n
     result.resize_({n_sample});
   }
 }
+
+// Each sample takes one curand_uniform2_double: x picks the category and y
+// decides between it and its alias, see _multinomial_alias_draw.
+template <typename scalar_t>
+__global__ void
+multinomialAliasDraw(int64_t n_sample,
+                     int64_t* dest,
+                     const int64_t* J,
+                     const scalar_t* q,
+                     int64_t categories,
+                     PhiloxCudaState philox_args) {
+  const int64_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  auto seeds = at::cuda::philox::unpack(philox_args);
+  curandStatePhilox4_32_10_t state;
+  curand_init(seeds.first, idx, seeds.second, &state);
+
+  for (int64_t sample = idx; sample < n_sample;
+       sample += blockDim.x * gridDim.x) {
+    // curand returns numbers in (0, 1], flip them to [0, 1)
+    const double2 rand = curand_uniform2_double(&state);
+    const int64_t category = ::min(
+        static_cast<int64_t>((1.0 - rand.x) * categories), categories - 1);
+    const bool keep =
+        (1.0 - rand.y) < static_cast<double>(q[category]);
+    dest[sample] = keep ? category : J[category];
+  }
+}
+
+void multinomial_alias_draw_kernel_impl(Tensor& result, const Tensor& q, const Tensor& J, c10::optional<Generator> generator) {
+  auto gen = get_generator_or_default<CUDAGeneratorImpl>(generator, cuda::detail::getDefaultCUDAGenerator());
+  const int64_t n_sample = result.numel();
+  const int64_t block_size = 256;
+  const unsigned int blocks_per_sm = at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor / block_size;
+  dim3 block(block_size);
+  dim3 grid((n_sample + block_size - 1) / block_size);
+  grid.x = std::min((unsigned int)at::cuda::getCurrentDeviceProperties()->multiProcessorCount * blocks_per_sm, grid.x);
+  // a curand_uniform2_double takes 4 numbers of the stream
+  const int64_t counter_offset = ((n_sample - 1) / (block_size * grid.x) + 1) * 4;
+  // See Note [Lock-free philox offsets]
+  PhiloxCudaState rng_engine_inputs = gen->philox_cuda_state(counter_offset);
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(q.scalar_type(), "multinomial_alias_draw_cuda", [&] {
+    multinomialAliasDraw<scalar_t>
+        <<<grid, block, 0, at::cuda::getCurrentCUDAStream()>>>(
+            n_sample,
+            result.data_ptr<int64_t>(),
+            J.data_ptr<int64_t>(),
+            q.data_ptr<scalar_t>(),
+            J.numel(),
+            rng_engine_inputs);
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
+}
 }
 
 REGISTER_DISPATCH(multinomial_stub, &multinomial_kernel_impl);
+REGISTER_DISPATCH(multinomial_alias_draw_stub, &multinomial_alias_draw_kernel_impl);
 
 }}
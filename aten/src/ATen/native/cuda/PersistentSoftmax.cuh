@@ -7,6 +7,8 @@
 #include <stdint.h>
 #include <cuda_fp16.h>
 #include <c10/macros/Macros.h>
+#include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/cuda/MemoryAccess.cuh>
 
 namespace {
 
@@ -231,6 +233,173 @@ __global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad,
     }
 }
 
+// The softmax_block_* methods cover the samples too long for a single warp: 1024 < element_count <= 4096.
+// One "BLOCK" of SOFTMAX_BLOCK_THREADS threads works on one sample, and every thread keeps ITERATIONS * ILP
+// elements of it in registers, so that, like the warp methods, the sample is read from global memory once.
+// Every iteration loads ILP consecutive elements per thread as one aligned vector; ILP is 1 when the
+// samples are not suitably aligned.
+constexpr int SOFTMAX_BLOCK_THREADS = 256;
+constexpr int SOFTMAX_BLOCK_MAX_ELEMENTS = 4096;
+
+// Reduces val over the block and returns the result to every thread.
+template <typename acc_t, template<typename> class ReduceOp>
+__device__ __forceinline__ acc_t block_reduce(acc_t val, acc_t* shared) {
+    constexpr int WARPS = SOFTMAX_BLOCK_THREADS / C10_WARP_SIZE;
+    ReduceOp<acc_t> r;
+    warp_reduce<acc_t, 1, C10_WARP_SIZE, ReduceOp>(&val);
+    // shared may still be read by a previous reduction
+    __syncthreads();
+    if (threadIdx.x % C10_WARP_SIZE == 0)
+        shared[threadIdx.x / C10_WARP_SIZE] = val;
+    __syncthreads();
+    val = shared[0];
+    #pragma unroll
+    for (int i = 1;  i < WARPS;  ++i) {
+        val = r(val, shared[i]);
+    }
+    return val;
+}
+
+template <typename input_t, typename output_t, typename acc_t, int ILP, int ITERATIONS, bool is_log_softmax>
+__global__ void softmax_block_forward(output_t *dst, const input_t *src, int stride, int element_count)
+{
+    using LoadT = at::native::memory::aligned_vector<input_t, ILP>;
+    using StoreT = at::native::memory::aligned_vector<output_t, ILP>;
+    __shared__ acc_t shared[SOFTMAX_BLOCK_THREADS / C10_WARP_SIZE];
+
+    src += static_cast<int64_t>(blockIdx.x) * stride;
+    dst += static_cast<int64_t>(blockIdx.x) * stride;
+
+    // load data from global memory
+    acc_t elements[ITERATIONS][ILP];
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        int element_index = (it * SOFTMAX_BLOCK_THREADS + threadIdx.x) * ILP;
+        if (element_index < element_count) {
+            LoadT v = *reinterpret_cast<const LoadT*>(src + element_index);
+            #pragma unroll
+            for (int j = 0;  j < ILP;  ++j) {
+                elements[it][j] = v.val[j];
+            }
+        } else {
+            #pragma unroll
+            for (int j = 0;  j < ILP;  ++j) {
+                elements[it][j] = -std::numeric_limits<acc_t>::infinity();
+            }
+        }
+    }
+
+    // compute max_value
+    acc_t max_value = elements[0][0];
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        #pragma unroll
+        for (int j = 0;  j < ILP;  ++j) {
+            max_value = (max_value > elements[it][j]) ? max_value : elements[it][j];
+        }
+    }
+    max_value = block_reduce<acc_t, Max>(max_value, shared);
+
+    acc_t sum = 0;
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        #pragma unroll
+        for (int j = 0;  j < ILP;  ++j) {
+            if (is_log_softmax) {
+              sum += std::exp(elements[it][j] - max_value);
+            } else {
+              elements[it][j] = std::exp(elements[it][j] - max_value);
+              sum += elements[it][j];
+            }
+        }
+    }
+    sum = block_reduce<acc_t, Add>(sum, shared);
+
+    // store result
+    if (is_log_softmax) sum = std::log(sum);
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        int element_index = (it * SOFTMAX_BLOCK_THREADS + threadIdx.x) * ILP;
+        if (element_index < element_count) {
+            StoreT out;
+            #pragma unroll
+            for (int j = 0;  j < ILP;  ++j) {
+                if (is_log_softmax) {
+                    out.val[j] = elements[it][j] - max_value - sum;
+                } else {
+                    out.val[j] = elements[it][j] / sum;
+                }
+            }
+            *reinterpret_cast<StoreT*>(dst + element_index) = out;
+        }
+    }
+}
+
+template <typename input_t, typename output_t, typename acc_t, int ILP, int ITERATIONS, bool is_log_softmax>
+__global__ void softmax_block_backward(output_t *gradInput, const input_t *grad, const input_t *output, int stride, int element_count)
+{
+    using LoadT = at::native::memory::aligned_vector<input_t, ILP>;
+    using StoreT = at::native::memory::aligned_vector<output_t, ILP>;
+    __shared__ acc_t shared[SOFTMAX_BLOCK_THREADS / C10_WARP_SIZE];
+
+    const int64_t offset = static_cast<int64_t>(blockIdx.x) * stride;
+    grad += offset;
+    output += offset;
+    gradInput += offset;
+
+    // load data from global memory
+    acc_t grad_reg[ITERATIONS][ILP];
+    acc_t output_reg[ITERATIONS][ILP];
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        int element_index = (it * SOFTMAX_BLOCK_THREADS + threadIdx.x) * ILP;
+        if (element_index < element_count) {
+            LoadT g = *reinterpret_cast<const LoadT*>(grad + element_index);
+            LoadT o = *reinterpret_cast<const LoadT*>(output + element_index);
+            #pragma unroll
+            for (int j = 0;  j < ILP;  ++j) {
+                grad_reg[it][j] = g.val[j];
+                output_reg[it][j] = o.val[j];
+            }
+        } else {
+            #pragma unroll
+            for (int j = 0;  j < ILP;  ++j) {
+                grad_reg[it][j] = acc_t(0);
+                output_reg[it][j] = acc_t(0);
+            }
+        }
+    }
+
+    acc_t sum = 0;
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        #pragma unroll
+        for (int j = 0;  j < ILP;  ++j) {
+            sum += grad_reg[it][j];
+        }
+    }
+    sum = block_reduce<acc_t, Add>(sum, shared);
+
+    // store result
+    #pragma unroll
+    for (int it = 0;  it < ITERATIONS;  ++it) {
+        int element_index = (it * SOFTMAX_BLOCK_THREADS + threadIdx.x) * ILP;
+        if (element_index < element_count) {
+            StoreT out;
+            #pragma unroll
+            for (int j = 0;  j < ILP;  ++j) {
+                // compute gradients
+                if (is_log_softmax) {
+                    out.val[j] = (grad_reg[it][j] - std::exp(output_reg[it][j]) * sum);
+                } else {
+                    out.val[j] = (grad_reg[it][j] - output_reg[it][j] * sum);
+                }
+            }
+            *reinterpret_cast<StoreT*>(gradInput + element_index) = out;
+        }
+    }
+}
+
 } // end of anonymous namespace
 
 template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
@@ -383,3 +552,103 @@ void dispatch_softmax_backward(output_t *grad_input, const input_t *grad, const
     }
 }
 
+// Vectorized loads of a sample need the pointer and the stride between the samples to be aligned to ILP elements.
+template<int ILP, typename scalar_t>
+bool softmax_block_can_vectorize(const scalar_t *ptr, int softmax_elements, int softmax_elements_stride)
+{
+    return softmax_elements % ILP == 0 && softmax_elements_stride % ILP == 0 &&
+        reinterpret_cast<uintptr_t>(ptr) % (ILP * sizeof(scalar_t)) == 0;
+}
+
+template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
+void dispatch_softmax_block_forward(output_t *dst, const input_t *src, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= SOFTMAX_BLOCK_MAX_ELEMENTS );
+    if (softmax_elements == 0 || batch_count == 0) {
+        return;
+    }
+    constexpr int ILP = 4;
+    // Number of vectors of ILP elements each thread holds; must match the ITERATIONS template argument.
+    const int iterations = softmax_elements <= 1024 ? 1 : (softmax_elements <= 2048 ? 2 : 4);
+    const bool vectorize = softmax_block_can_vectorize<ILP>(src, softmax_elements, softmax_elements_stride) &&
+        softmax_block_can_vectorize<ILP>(dst, softmax_elements, softmax_elements_stride);
+    dim3 blocks(batch_count);
+    dim3 threads(SOFTMAX_BLOCK_THREADS);
+    auto stream = at::cuda::getCurrentCUDAStream();
+    switch (vectorize ? iterations : iterations * ILP) {
+        case 1:
+            softmax_block_forward<input_t, output_t, acc_t, ILP, 1, is_log_softmax>
+                <<<blocks, threads, 0, stream>>>(dst, src, softmax_elements_stride, softmax_elements);
+            break;
+        case 2:
+            softmax_block_forward<input_t, output_t, acc_t, ILP, 2, is_log_softmax>
+                <<<blocks, threads, 0, stream>>>(dst, src, softmax_elements_stride, softmax_elements);
+            break;
+        case 4:
+            if (vectorize) {
+                softmax_block_forward<input_t, output_t, acc_t, ILP, 4, is_log_softmax>
+                    <<<blocks, threads, 0, stream>>>(dst, src, softmax_elements_stride, softmax_elements);
+            } else {
+                softmax_block_forward<input_t, output_t, acc_t, 1, 4, is_log_softmax>
+                    <<<blocks, threads, 0, stream>>>(dst, src, softmax_elements_stride, softmax_elements);
+            }
+            break;
+        case 8:
+            softmax_block_forward<input_t, output_t, acc_t, 1, 8, is_log_softmax>
+                <<<blocks, threads, 0, stream>>>(dst, src, softmax_elements_stride, softmax_elements);
+            break;
+        case 16:
+            softmax_block_forward<input_t, output_t, acc_t, 1, 16, is_log_softmax>
+                <<<blocks, threads, 0, stream>>>(dst, src, softmax_elements_stride, softmax_elements);
+            break;
+        default:
+            break;
+    }
+}
+
+template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
+void dispatch_softmax_block_backward(output_t *grad_input, const input_t *grad, const input_t *output, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= SOFTMAX_BLOCK_MAX_ELEMENTS );
+    if (softmax_elements == 0 || batch_count == 0) {
+        return;
+    }
+    constexpr int ILP = 4;
+    // Number of vectors of ILP elements each thread holds; must match the ITERATIONS template argument.
+    const int iterations = softmax_elements <= 1024 ? 1 : (softmax_elements <= 2048 ? 2 : 4);
+    const bool vectorize = softmax_block_can_vectorize<ILP>(grad_input, softmax_elements, softmax_elements_stride) &&
+        softmax_block_can_vectorize<ILP>(grad, softmax_elements, softmax_elements_stride) &&
+        softmax_block_can_vectorize<ILP>(output, softmax_elements, softmax_elements_stride);
+    dim3 blocks(batch_count);
+    dim3 threads(SOFTMAX_BLOCK_THREADS);
+    auto stream = at::cuda::getCurrentCUDAStream();
+    switch (vectorize ? iterations : iterations * ILP) {
+        case 1:
+            softmax_block_backward<input_t, output_t, acc_t, ILP, 1, is_log_softmax>
+                <<<blocks, threads, 0, stream>>>(grad_input, grad, output, softmax_elements_stride, softmax_elements);
+            break;
+        case 2:
+            softmax_block_backward<input_t, output_t, acc_t, ILP, 2, is_log_softmax>
+                <<<blocks, threads, 0, stream>>>(grad_input, grad, output, softmax_elements_stride, softmax_elements);
+            break;
+        case 4:
+            if (vectorize) {
+                softmax_block_backward<input_t, output_t, acc_t, ILP, 4, is_log_softmax>
+                    <<<blocks, threads, 0, stream>>>(grad_input, grad, output, softmax_elements_stride, softmax_elements);
+            } else {
+                softmax_block_backward<input_t, output_t, acc_t, 1, 4, is_log_softmax>
+                    <<<blocks, threads, 0, stream>>>(grad_input, grad, output, softmax_elements_stride, softmax_elements);
+            }
+            break;
+        case 8:
+            softmax_block_backward<input_t, output_t, acc_t, 1, 8, is_log_softmax>
+                <<<blocks, threads, 0, stream>>>(grad_input, grad, output, softmax_elements_stride, softmax_elements);
+            break;
+        case 16:
+            softmax_block_backward<input_t, output_t, acc_t, 1, 16, is_log_softmax>
+                <<<blocks, threads, 0, stream>>>(grad_input, grad, output, softmax_elements_stride, softmax_elements);
+            break;
+        default:
+            break;
+    }
+}
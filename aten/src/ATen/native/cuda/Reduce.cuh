@@ -73,6 +73,16 @@ struct ReduceConfig {
 
   static constexpr int MAX_NUM_THREADS = 512;
   static constexpr int input_vec_size = 4;
+  // Number of input vectors a thread loads before reducing them, so that
+  // more than one load is in flight on the vectorized-input path.
+  static constexpr int input_vec_unroll = 2;
+
+  // 2 and 1 byte inputs are loaded 8 at a time, 16 and 8 bytes respectively,
+  // rather than 4.
+  template <typename scalar_t>
+  static constexpr int input_vec_size_for() {
+    return sizeof(scalar_t) >= 4 ? input_vec_size : 2 * input_vec_size;
+  }
 
   ReduceConfig(int element_size_bytes, int num_outputs, int num_inputs)
     : element_size_bytes(element_size_bytes)
@@ -288,7 +298,8 @@ struct ReduceOp {
 
   static constexpr float acc_buffer_multiplier = (float)sizeof(arg_t) / sizeof(out_scalar_t);
 
-  static constexpr int input_vec_size = ReduceConfig::input_vec_size;
+  static constexpr int input_vec_size = ReduceConfig::input_vec_size_for<scalar_t>();
+  static constexpr int input_vec_unroll = ReduceConfig::input_vec_unroll;
 
   ops_t ops;
   arg_t ident;
@@ -482,6 +493,27 @@ struct ReduceOp {
 #endif
     load_t *values_vector = reinterpret_cast<load_t*>(&values[0]);
 
+    // Issue input_vec_unroll loads before reducing any of them.
+#ifndef __HIP_PLATFORM_HCC__
+    load_t unrolled[input_vec_unroll];
+#else
+    ROCm_Bug<load_t, input_vec_unroll> unrolled;
+#endif
+    while ((idx + (input_vec_unroll - 1) * stride) * input_vec_size + input_vec_size - 1 < end) {
+      #pragma unroll
+      for (int u = 0; u < input_vec_unroll; u++) {
+        unrolled[u] = reinterpret_cast<const load_t*>(data)[idx + u * stride];
+      }
+      #pragma unroll
+      for (int u = 0; u < input_vec_unroll; u++) {
+        #pragma unroll
+        for (index_t i = 0; i < input_vec_size; i++) {
+          value_list[i] = ops.reduce(value_list[i], unrolled[u].val[i], shift + (idx + u * stride) * input_vec_size + i);
+        }
+      }
+      idx += stride * input_vec_unroll;
+    }
+
     while (idx * input_vec_size + input_vec_size - 1 < end) {
       *values_vector = reinterpret_cast<const load_t*>(data)[idx];
       #pragma unroll
@@ -1072,7 +1104,10 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
     config.output_mult[1] = config.split_output(block_height);
   }
 
-  constexpr int min_values_per_thread = 16;
+  // On the vectorized input path a value is a single element of the vectors
+  // a thread loads input_vec_unroll at a time, so it takes more of them to
+  // keep the loads of each thread busy.
+  const int min_values_per_thread = config.vectorize_input ? 16 * ReduceConfig::input_vec_unroll : 16;
   constexpr int max_values_per_thread = 256;
   const int blocks_per_sm = at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor / (block_width * block_height);
   const int num_mp = at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
@@ -29,6 +29,25 @@ Tensor& resize_cuda_(
   return self;
 }
 
+} // namespace
+
+Tensor& append_cuda_(Tensor& self, const Tensor& other) {
+  const DimVector size = append_size(self, other);
+  const int64_t old_rows = self.size(0);
+  // other may be self or a view of it, whose sizes or data the resize changes.
+  const Tensor source = other.is_alias_of(self) ? other.clone() : other;
+  auto* self_ = self.unsafeGetTensorImpl();
+  {
+    cuda::CUDAGuard guard(self_->storage().device());
+    maybe_grow_storage_cuda(self_, prod_intlist(size));
+  }
+  resize_impl_cuda_(self_, size, /*strides=*/c10::nullopt);
+  self.narrow(0, old_rows, size[0] - old_rows).copy_(source);
+  return self;
+}
+
+namespace {
+
 TORCH_LIBRARY_IMPL(aten, CUDA, m) {
   m.impl_UNBOXED("resize_", resize_cuda_);
 }
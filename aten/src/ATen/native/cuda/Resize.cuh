@@ -32,6 +32,20 @@ static inline void maybe_resize_storage_cuda(TensorImpl* self, int64_t new_size)
   }
 }
 
+// See maybe_grow_storage_cpu
+static inline void maybe_grow_storage_cuda(TensorImpl* self, int64_t new_size) {
+  if (new_size > 0 && THTensor_getStoragePtr(self)) {
+    const int64_t capacity =
+        static_cast<int64_t>(self->storage().nbytes()) /
+            self->dtype().itemsize() -
+        self->storage_offset();
+    if (new_size > capacity) {
+      new_size = std::max(new_size, 2 * capacity);
+    }
+  }
+  maybe_resize_storage_cuda(self, new_size);
+}
+
 inline TensorImpl* resize_impl_cuda_(
     TensorImpl* self,
     IntArrayRef size,
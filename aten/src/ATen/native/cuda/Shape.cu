@@ -9,11 +9,14 @@
 
 #include <THC/THC.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace at {
 namespace native {
 
 constexpr int CAT_ARRAY_BATCH_SIZE = 1024;
-constexpr int CAT_ARRAY_MAX_INPUT_DIMS = 4;
+constexpr int CAT_ARRAY_MAX_INPUT_DIMS = 5;
 
 namespace {
 
@@ -63,6 +66,10 @@ struct CatArrInputTensor {
   IndexType offset;
   IndexType dimSize;
   IndexType nElements;
+  // The strides of a non-contiguous input, in the same (possibly permuted)
+  // order as the output's
+  bool isContiguous;
+  IndexType inputStride[CAT_ARRAY_MAX_INPUT_DIMS];
 };
 
 template<typename IndexType, unsigned int MaxDims>
@@ -83,7 +90,8 @@ struct OutputTensorSizeStride {
   * concatDim: dimension along which we are concatenating
   * dimStride: the stride of the output tensor at the concatDim
   *
-  * The most important assumption made is that the input tensors are contiguous.
+  * Contiguous inputs are read linearly; the others through their own strides,
+  * so inputs of any layout are copied by the same launch.
   */
 template <typename T, typename IndexType, int Dims>
 #ifdef __HIP_PLATFORM_HCC__
@@ -108,12 +116,25 @@ __global__ void CatArrayBatchedCopy(
 
     IndexType stride = gridDim.x * blockDim.x;
 
-    while( tid < nElements){
-    IndexType elementOffset = CatArrIndexToOffset<IndexType, Dims>::compute(
-                  os.outputSize, os.outputStride, dimSize, concatDim, tid);
-    output[dataOffset + elementOffset] = data[tid];
+    if (inputs[blockIdx.y].isContiguous) {
+      while( tid < nElements){
+      IndexType elementOffset = CatArrIndexToOffset<IndexType, Dims>::compute(
+                    os.outputSize, os.outputStride, dimSize, concatDim, tid);
+      output[dataOffset + elementOffset] = data[tid];
 
-    tid += stride;
+      tid += stride;
+      }
+    } else {
+      const IndexType* inputStride = inputs[blockIdx.y].inputStride;
+      while( tid < nElements){
+      IndexType elementOffset = CatArrIndexToOffset<IndexType, Dims>::compute(
+                    os.outputSize, os.outputStride, dimSize, concatDim, tid);
+      IndexType inputOffset = CatArrIndexToOffset<IndexType, Dims>::compute(
+                    os.outputSize, inputStride, dimSize, concatDim, tid);
+      output[dataOffset + elementOffset] = data[inputOffset];
+
+      tid += stride;
+      }
     }
 }
 
@@ -157,28 +178,41 @@ void parallel_cat(Tensor &out, const TensorList &inputs, int64_t dimension,
   OutputTensorSizeStride<unsigned int, CAT_ARRAY_MAX_INPUT_DIMS> param;
 
   // Next, let's initialize the size, stride arrays for the output Tensor.
-  if (memory_format == c10::MemoryFormat::Contiguous) {
-    for (int i = 0; i < nDims; ++i) {
-      param.outputSize[i] = at::native::size(out, i);
-      param.outputStride[i] = out.stride(i);
+  // For channels last, permute the semantics of dims from NCHW to NHWC so that
+  // the inputs in that format are contiguous. The strides of the other inputs
+  // are permuted the same way.
+  TORCH_CHECK(memory_format == c10::MemoryFormat::Contiguous ||
+              memory_format == c10::MemoryFormat::ChannelsLast ||
+              memory_format == c10::MemoryFormat::ChannelsLast3d,
+              "unsupported memory format");
+  auto permutedDim = [&](int i) {
+    if (memory_format == c10::MemoryFormat::Contiguous || i == 0) {
+      return i;
     }
-  } else if (memory_format == c10::MemoryFormat::ChannelsLast || memory_format == c10::MemoryFormat::ChannelsLast3d) {
-    // permute the semantics of dims from NCHW to NHWC so that the input
-    // tensor is now contiguous
-    param.outputSize[0] = at::native::size(out, 0);
-    param.outputStride[0] = out.stride(0);
-    for (int i = 1; i < nDims - 1; ++i) {
-      param.outputSize[i] = at::native::size(out, i + 1);
-      param.outputStride[i] = out.stride(i + 1);
-    }
-    param.outputSize[nDims - 1] = at::native::size(out, 1);
-    param.outputStride[nDims - 1] = out.stride(1);
-  } else {
-    TORCH_CHECK(false, "unsupported memory format");
+    return i == nDims - 1 ? 1 : i + 1;
+  };
+  for (int i = 0; i < nDims; ++i) {
+    param.outputSize[i] = at::native::size(out, permutedDim(i));
+    param.outputStride[i] = out.stride(permutedDim(i));
   }
 
   at::cuda::CUDAStream stream = at::cuda::getCurrentCUDAStream();
 
+  // The concat dimension in the permuted order; dimension itself keeps
+  // indexing the sizes of the inputs
+  int catDim = dimension;
+  if (memory_format != c10::MemoryFormat::Contiguous) {
+    switch (dimension) {
+    case 0:
+      break;
+    case 1:
+      catDim = nDims - 1;
+      break;
+    default:
+      catDim = dimension - 1;
+    }
+  }
+
   // Now we loop
   int batchCounter = 0;
   int64_t offset = 0;
@@ -201,6 +235,12 @@ void parallel_cat(Tensor &out, const TensorList &inputs, int64_t dimension,
         stackInputs[batchCounter].offset = offset;
         stackInputs[batchCounter].dimSize = dimSize;
         stackInputs[batchCounter].nElements = inputs[i+batchCounter].numel();
+        stackInputs[batchCounter].isContiguous =
+          inputs[i+batchCounter].is_contiguous(memory_format);
+        for (int d = 0; d < nDims; ++d) {
+          stackInputs[batchCounter].inputStride[d] =
+            inputs[i+batchCounter].stride(permutedDim(d));
+        }
 
         // update offset
         offset += dimSize;
@@ -221,22 +261,11 @@ void parallel_cat(Tensor &out, const TensorList &inputs, int64_t dimension,
     getCatGrid(batchCounter, catGrid);
 
 
-    if (memory_format != c10::MemoryFormat::Contiguous) {
-      switch (dimension) {
-      case 0:
-        break;
-      case 1:
-        dimension = nDims - dimension;
-        break;
-      default:
-        dimension--;
-      }
-    }
-    // Template Declarations for dim = 1, 2, 3, 4
+    // Template Declarations for dim = 1, 2, 3, 4, 5
 #define HANDLE_CASE(DIMS) \
     CatArrayBatchedCopy<scalar_t, unsigned int, DIMS><<<\
         catGrid, applyBlock, 0, stream.stream()>>>(\
-            data, d_inputs, param, dimension, param.outputStride[dimension]);
+            data, d_inputs, param, catDim, param.outputStride[catDim]);
     switch (nDims) {
       case 1:
         HANDLE_CASE(1);
@@ -250,6 +279,9 @@ void parallel_cat(Tensor &out, const TensorList &inputs, int64_t dimension,
       case 4:
         HANDLE_CASE(4);
         break;
+      case 5:
+        HANDLE_CASE(5);
+        break;
     }
 #undef HANDLE_CASE
     AT_CUDA_CHECK(cudaGetLastError());
@@ -361,23 +393,21 @@ Tensor& cat_out_cuda(Tensor& out, TensorList inputs, int64_t dimension) {
     return out;
   }
 
-  // We parallelize the copy if all 6 conditions pass:
+  // We parallelize the copy if all 5 conditions pass:
   //
   // 1. There is more than one input tensor
-  // 2. No empty inputs
-  // 3. The out tensor is 32-bit indexable
-  // 4. The number of dimensions is <= 4
-  // 5. All input tensors are contiguous (output tensor may be non-contig)
-  // 6. All input tensors can use 32-bit indexing
+  // 2. The out tensor is 32-bit indexable
+  // 3. The number of dimensions is <= 5
+  // 4. All input tensors can use 32-bit indexing
+  // 5. All input tensors have the type of the output
+  //
+  // The inputs may have any strides, and the skipped empty inputs are left
+  // out of the launch.
 
   const bool all32BitIndexable = std::all_of(inputs.begin(), inputs.end(),
     [] (const Tensor& t) {
       return at::cuda::detail::canUse32BitIndexMath(t);
     });
-  const bool allContiguous = std::all_of(inputs.begin(), inputs.end(),
-    [=](const Tensor& t) {
-      return !t.defined() || t.is_contiguous(memory_format);
-    });
   ScalarType firstType = inputs[0].scalar_type();
   bool allSameType = std::all_of(inputs.begin(), inputs.end(),
     [firstType](const Tensor& t) {
@@ -385,17 +415,22 @@ Tensor& cat_out_cuda(Tensor& out, TensorList inputs, int64_t dimension) {
     });
   allSameType = allSameType && (out.scalar_type() == firstType);
   if (inputs.size() > 1 &&
-      !hasSkippedInput &&
       out.dim() <= CAT_ARRAY_MAX_INPUT_DIMS &&
       at::cuda::detail::canUse32BitIndexMath(out) &&
-      allContiguous &&
       all32BitIndexable &&
       allSameType) {
+    std::vector<Tensor> notSkippedInputs;
+    if (hasSkippedInput) {
+      notSkippedInputs.reserve(inputs.size());
+      std::copy_if(inputs.begin(), inputs.end(), std::back_inserter(notSkippedInputs),
+                   [&](const Tensor& t) { return !should_skip(t); });
+    }
+    TensorList catInputs = hasSkippedInput ? TensorList(notSkippedInputs) : inputs;
 
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(
         at::ScalarType::Half, at::ScalarType::Bool, at::ScalarType::BFloat16,
         out.scalar_type(), "cat_cuda", [&]() {
-      parallel_cat<scalar_t>(out, inputs, dimension, nDims, memory_format);
+      parallel_cat<scalar_t>(out, catInputs, dimension, nDims, memory_format);
     });
 
   } else {
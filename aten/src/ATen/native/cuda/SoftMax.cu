@@ -713,6 +713,9 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
         if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
           dispatch_softmax_forward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
               output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
+        } else if (dim_size <= SOFTMAX_BLOCK_MAX_ELEMENTS) {
+          dispatch_softmax_block_forward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
+              output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
           constexpr int ILP = sizeof(float4) / sizeof(scalar_t);
           dim3 block = SoftMax_getBlockSize(ILP, dim_size);
@@ -725,6 +728,9 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
         if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
           dispatch_softmax_forward<scalar_t, accscalar_t, accscalar_t, is_log_softmax>(
               output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
+        } else if (dim_size <= SOFTMAX_BLOCK_MAX_ELEMENTS) {
+          dispatch_softmax_block_forward<scalar_t, accscalar_t, accscalar_t, is_log_softmax>(
+              output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
           constexpr int ILP = sizeof(float4) / sizeof(accscalar_t);
           dim3 block = SoftMax_getBlockSize(ILP, dim_size);
@@ -803,6 +809,9 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
       if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
         dispatch_softmax_backward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
             gI.data_ptr<scalar_t>(), grad.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
+      } else if (dim_size <= SOFTMAX_BLOCK_MAX_ELEMENTS) {
+        dispatch_softmax_block_backward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
+            gI.data_ptr<scalar_t>(), grad.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
       } else {
         constexpr int ILP = sizeof(float4) / sizeof(scalar_t);
         dim3 block = SoftMax_getBlockSize(ILP, dim_size);
@@ -815,6 +824,9 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
       if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
         dispatch_softmax_backward<accscalar_t, scalar_t, accscalar_t, is_log_softmax>(
             gI.data_ptr<scalar_t>(), grad.data_ptr<accscalar_t>(), output.data_ptr<accscalar_t>(), dim_size, dim_size, outer_size);
+      } else if (dim_size <= SOFTMAX_BLOCK_MAX_ELEMENTS) {
+        dispatch_softmax_block_backward<accscalar_t, scalar_t, accscalar_t, is_log_softmax>(
+            gI.data_ptr<scalar_t>(), grad.data_ptr<accscalar_t>(), output.data_ptr<accscalar_t>(), dim_size, dim_size, outer_size);
       } else {
         constexpr int ILP = sizeof(float4) / sizeof(accscalar_t);
         dim3 block = SoftMax_getBlockSize(ILP, dim_size);
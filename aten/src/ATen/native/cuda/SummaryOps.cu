@@ -9,6 +9,7 @@ namespace at {
 namespace cuda {
 #define THRESH_NUMBER_BINS_FOR_MULTI_BLOCK_MEM 100
 #define THRESH_NUMBER_BINS_FOR_GLOBAL_MEM 1000
+#define MAX_NUMBER_PASSES_FOR_SHARED_MEM 4
 #define FOR_KERNEL_LOOP(i, lim)                                      \
   for (IndexType i = blockIdx.x * blockDim.x + threadIdx.x; i < lim; \
        i += gridDim.x * blockDim.x)
@@ -54,6 +55,8 @@ __global__ void kernelHistogram1D(
     input_t minvalue,
     input_t maxvalue,
     IndexType totalElements,
+    IndexType binBegin, /* first bin of the pass (SHARED only) */
+    IndexType binEnd, /* end of the bins of the pass (SHARED only) */
     Op getOp) {
   extern __shared__ unsigned char my_smem[];
   output_t* smem = nullptr;
@@ -62,8 +65,11 @@ __global__ void kernelHistogram1D(
     ////////////////////////// Shared memory //////////////////////////
     // atomically add to block specific shared memory
     // then atomically add to the global output tensor
+    // only bins [binBegin, binEnd) are counted, the others are left to the
+    // other passes
     smem = reinterpret_cast<output_t*>(my_smem);
-    for (IndexType i = threadIdx.x; i < a.sizes[0]; i += blockDim.x) {
+    const IndexType passBins = binEnd - binBegin;
+    for (IndexType i = threadIdx.x; i < passBins; i += blockDim.x) {
       smem[i] = 0;
     }
     __syncthreads();
@@ -75,16 +81,18 @@ __global__ void kernelHistogram1D(
       if (bVal >= minvalue && bVal <= maxvalue) {
         // Use value at `b` as an offset of `smem`
         const IndexType bin = getBin<input_t, IndexType>(bVal, minvalue, maxvalue, nbins);
-        gpuAtomicAdd(&smem[bin], getOp(linearIndex));
+        if (bin >= binBegin && bin < binEnd) {
+          gpuAtomicAdd(&smem[bin - binBegin], getOp(linearIndex));
+        }
       }
     }
     __syncthreads();
     // NOTE: atomically update output bin count.
     //   Atomic update is imp since __syncthread() will only synchronize threads
     //   in a given block, not across blocks.
-    for (IndexType i = threadIdx.x; i < a.sizes[0]; i += blockDim.x) {
+    for (IndexType i = threadIdx.x; i < passBins; i += blockDim.x) {
       const IndexType aOffset =
-          detail::IndexToOffset<output_t, IndexType, ADims>::get(i, a);
+          detail::IndexToOffset<output_t, IndexType, ADims>::get(binBegin + i, a);
       gpuAtomicAdd(&a.data[aOffset], smem[i]);
     }
 
@@ -140,25 +148,33 @@ __global__ void kernelHistogram1D(
   }
 }
 
-#define HANDLE_CASE(MEMORY_TYPE, WEIGHTS_OP, SHARED_MEM)                   \
+#define HANDLE_CASE(MEMORY_TYPE, WEIGHTS_OP, SHARED_MEM, BIN_BEGIN, BIN_END) \
   kernelHistogram1D<output_t, input_t, IndexType, 1, 2, -1, MEMORY_TYPE>    \
       <<<grid,                                                             \
          block,                                                            \
          SHARED_MEM,                                                       \
          getCurrentCUDAStream()>>>(                    \
-          aInfo, pInfo, bInfo, nbins, minvalue, maxvalue, totalElements, WEIGHTS_OP);        \
+          aInfo, pInfo, bInfo, nbins, minvalue, maxvalue, totalElements,   \
+          BIN_BEGIN, BIN_END, WEIGHTS_OP);                                 \
   AT_ASSERTM(cudaGetLastError() == cudaSuccess, "kernelHistogram1D failed");
 
 #define HANDLE_SWITCH_CASE(mType, getOp)                                   \
   switch (mType) {                                                         \
     case CUDAHistogramMemoryType::SHARED:                                  \
-      HANDLE_CASE(CUDAHistogramMemoryType::SHARED, getOp, sharedMem);      \
+      for (IndexType binBegin = 0; binBegin < nbins;                       \
+           binBegin += binsPerPass) {                                      \
+        const IndexType binEnd = std::min<IndexType>(                      \
+            nbins, binBegin + binsPerPass);                                \
+        HANDLE_CASE(                                                       \
+            CUDAHistogramMemoryType::SHARED, getOp,                        \
+            (binEnd - binBegin) * sizeof(output_t) + 8, binBegin, binEnd); \
+      }                                                                    \
       break;                                                               \
     case CUDAHistogramMemoryType::MULTI_BLOCK:                             \
-      HANDLE_CASE(CUDAHistogramMemoryType::MULTI_BLOCK, getOp, 0);         \
+      HANDLE_CASE(CUDAHistogramMemoryType::MULTI_BLOCK, getOp, 0, 0, nbins); \
       break;                                                               \
     default:                                                               \
-      HANDLE_CASE(CUDAHistogramMemoryType::GLOBAL, getOp, 0);              \
+      HANDLE_CASE(CUDAHistogramMemoryType::GLOBAL, getOp, 0, 0, nbins);    \
   }
 
 inline int64_t getFreeGlobalMemory() {
@@ -183,6 +199,11 @@ inline int64_t getFreeGlobalMemory() {
     case: #bins < THRESH_NUMBER_BINS_FOR_MULTI_BLOCK_MEM and enough shared mem
         SHARED: Each block atomically adds to it's own **shared** hist copy,
         then atomically updates the global tensor.
+    case: more bins, but the input is large enough for the per block copies
+        to pay off, and at most MAX_NUMBER_PASSES_FOR_SHARED_MEM shared
+        memory sized ranges of bins cover them all
+        SHARED, in passes: each pass reads the whole input and counts the
+        bins of one range in shared memory, ignoring the other values.
     case: #bins < THRESH_NUMBER_BINS_FOR_GLOBAL_MEM and enough global mem
         MULTI_BLOCK: Each block atomically adds to it's own **global** hist
         copy, then atomically updates the global tensor.
@@ -222,10 +243,23 @@ bool CUDA_tensor_histogram(
   auto sharedMem = nbins * sizeof(output_t) + 8; // 8 guard bytes
   auto maxGlobalMem = getFreeGlobalMemory();
   auto multiBlockMem = nbins * grid.x * sizeof(output_t) + 8; // 8 guard bytes
+  // the most bins a block can count in shared memory at once, and the
+  // number of passes a SHARED histogram of all the bins takes
+  const int64_t maxSharedBins =
+      (static_cast<int64_t>(maxSharedMem) - 8) / sizeof(output_t) - 1;
+  const int64_t sharedPasses = (nbins + maxSharedBins - 1) / maxSharedBins;
+  // spread the bins evenly over the passes
+  const int64_t binsPerPass = (nbins + sharedPasses - 1) / sharedPasses;
   // determine memory type to use in the kernel
   if (nbins < THRESH_NUMBER_BINS_FOR_MULTI_BLOCK_MEM &&
       sharedMem < maxSharedMem) {
     memType = CUDAHistogramMemoryType::SHARED;
+  } else if (
+      sharedPasses <= MAX_NUMBER_PASSES_FOR_SHARED_MEM &&
+      nbins * static_cast<int64_t>(grid.x) < totalElements) {
+    // every block merges its copy of the bins into the output, which only
+    // pays off when there are more elements than merged bins
+    memType = CUDAHistogramMemoryType::SHARED;
   } else if (
       nbins < THRESH_NUMBER_BINS_FOR_GLOBAL_MEM &&
       multiBlockMem < (maxGlobalMem / 2)) {
@@ -263,6 +297,7 @@ bool CUDA_tensor_histogram(
 #undef HANDLE_CASE
 #undef HANDLE_SWITCH_CASE
 #undef FOR_KERNEL_LOOP
+#undef MAX_NUMBER_PASSES_FOR_SHARED_MEM
 #undef THRESH_NUMBER_BINS_FOR_GLOBAL_MEM
 #undef THRESH_NUMBER_BINS_FOR_MULTI_BLOCK_MEM
 } // namespace cuda
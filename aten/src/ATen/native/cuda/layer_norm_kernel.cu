@@ -2,14 +2,19 @@
 
 #include <ATen/ATen.h>
 #include <ATen/AccumulateType.h>
+#include <ATen/CUDAGeneratorImpl.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAGraphsUtils.cuh>
 #include <ATen/cuda/detail/IndexUtils.cuh>
 #include <ATen/native/cuda/block_reduce.cuh>
+#include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/cuda/MemoryAccess.cuh>
 #include <THC/THCDeviceUtils.cuh>
 
 #include <c10/cuda/CUDAMathCompat.h>
+#include <curand_kernel.h>
 
 namespace at {
 namespace native {
@@ -19,6 +24,14 @@ namespace {
 constexpr int kCUDANumThreads = 256;
 constexpr int kColwiseReduceTileSize = 32;
 
+// Rows of at most kPersistentMaxN elements are handled by the persistent
+// kernels below: one block of kPersistentNumThreads threads per row, every
+// thread keeping kIterations vectors of ILP elements of the row in registers,
+// so X (and dY) is read from global memory only once.
+constexpr int kPersistentNumThreads = 256;
+constexpr int kPersistentVecSize = 4;
+constexpr int64_t kPersistentMaxN = 4096;
+
 template <typename T>
 __global__ void RowwiseMomentsCUDAKernel(
     int64_t N,
@@ -147,6 +160,370 @@ __global__ void LayerNormBackwardCUDAKenrel(
   }
 }
 
+// Like cuda_utils::BlockReduceSum, but returns the result to every thread.
+template <typename T>
+__device__ __forceinline__ T BlockAllReduceSum(T val, T* shared) {
+  val = cuda_utils::BlockReduceSum<T>(val, shared);
+  if (threadIdx.x == 0) {
+    shared[0] = val;
+  }
+  __syncthreads();
+  return shared[0];
+}
+
+// Normalizes the row i held in registers into Y_row, writing its moments to
+// mean and rstd.
+template <typename T, int kIterations, int ILP>
+__device__ __forceinline__ void PersistentLayerNormRow(
+    int64_t i,
+    int64_t N,
+    T eps,
+    const acc_type<T, true> (&x)[kIterations][ILP],
+    acc_type<T, true> sum,
+    const T* gamma,
+    const T* beta,
+    T* mean,
+    T* rstd,
+    T* Y_row) {
+  using T_ACC = acc_type<T, true>;
+  using vec_t = memory::aligned_vector<T, ILP>;
+  __shared__ T_ACC m_shared[C10_WARP_SIZE];
+  __shared__ T_ACC v_shared[C10_WARP_SIZE];
+  const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
+  const T_ACC m = BlockAllReduceSum<T_ACC>(sum, m_shared) * scale;
+
+  // The row is in registers, so the variance is computed from the centered
+  // values instead of E[X^2] - E[X]^2.
+  T_ACC sum_sq = 0;
+#pragma unroll
+  for (int it = 0; it < kIterations; ++it) {
+    const int64_t j = (it * kPersistentNumThreads + threadIdx.x) * ILP;
+    if (j < N) {
+#pragma unroll
+      for (int k = 0; k < ILP; ++k) {
+        const T_ACC d = x[it][k] - m;
+        sum_sq += d * d;
+      }
+    }
+  }
+  const T_ACC var = BlockAllReduceSum<T_ACC>(sum_sq, v_shared) * scale;
+  const T_ACC r = c10::cuda::compat::rsqrt(var + static_cast<T_ACC>(eps));
+  if (threadIdx.x == 0) {
+    mean[i] = m;
+    rstd[i] = r;
+  }
+
+#pragma unroll
+  for (int it = 0; it < kIterations; ++it) {
+    const int64_t j = (it * kPersistentNumThreads + threadIdx.x) * ILP;
+    if (j < N) {
+      vec_t gamma_v;
+      vec_t beta_v;
+      if (gamma != nullptr) {
+        gamma_v = *reinterpret_cast<const vec_t*>(gamma + j);
+      }
+      if (beta != nullptr) {
+        beta_v = *reinterpret_cast<const vec_t*>(beta + j);
+      }
+      vec_t out;
+#pragma unroll
+      for (int k = 0; k < ILP; ++k) {
+        const T_ACC g =
+            gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma_v.val[k]);
+        const T_ACC b =
+            beta == nullptr ? T_ACC(0) : static_cast<T_ACC>(beta_v.val[k]);
+        out.val[k] = (x[it][k] - m) * r * g + b;
+      }
+      *reinterpret_cast<vec_t*>(Y_row + j) = out;
+    }
+  }
+}
+
+template <typename T, int kIterations, int ILP>
+__global__ void LayerNormForwardPersistentCUDAKernel(
+    int64_t N,
+    T eps,
+    const T* X,
+    const T* gamma,
+    const T* beta,
+    T* mean,
+    T* rstd,
+    T* Y) {
+  using T_ACC = acc_type<T, true>;
+  using vec_t = memory::aligned_vector<T, ILP>;
+  const int64_t i = blockIdx.x;
+  const T* X_row = X + i * N;
+
+  T_ACC x[kIterations][ILP];
+  T_ACC sum = 0;
+#pragma unroll
+  for (int it = 0; it < kIterations; ++it) {
+    const int64_t j = (it * kPersistentNumThreads + threadIdx.x) * ILP;
+    if (j < N) {
+      const vec_t v = *reinterpret_cast<const vec_t*>(X_row + j);
+#pragma unroll
+      for (int k = 0; k < ILP; ++k) {
+        x[it][k] = static_cast<T_ACC>(v.val[k]);
+        sum += x[it][k];
+      }
+    }
+  }
+  PersistentLayerNormRow<T, kIterations, ILP>(
+      i, N, eps, x, sum, gamma, beta, mean, rstd, Y + i * N);
+}
+
+// dropout(X) + R, with the keep probability p, followed by the layer norm of
+// the sum, which stays in registers. The sum S and the mask are written out
+// for the backward. Each thread draws the randoms of its elements from its
+// own philox subsequence, four at a time, so the mask never goes through
+// global memory before it is used.
+template <typename T, int kIterations, int ILP>
+__global__ void DropoutAddLayerNormForwardPersistentCUDAKernel(
+    int64_t N,
+    T eps,
+    acc_type<T, true> p,
+    PhiloxCudaState philox_args,
+    const T* X,
+    const T* R,
+    const T* gamma,
+    const T* beta,
+    T* S,
+    uint8_t* mask,
+    T* mean,
+    T* rstd,
+    T* Y) {
+  using T_ACC = acc_type<T, true>;
+  using vec_t = memory::aligned_vector<T, ILP>;
+  using mask_vec_t = memory::aligned_vector<uint8_t, ILP>;
+  const int64_t i = blockIdx.x;
+  const int64_t row_offset = i * N;
+
+  const auto seeds = at::cuda::philox::unpack(philox_args);
+  curandStatePhilox4_32_10_t state;
+  curand_init(
+      seeds.first,
+      i * kPersistentNumThreads + threadIdx.x,
+      seeds.second,
+      &state);
+  const T_ACC pinv = T_ACC(1) / p;
+
+  T_ACC x[kIterations][ILP];
+  T_ACC sum = 0;
+  float4 rand;
+#pragma unroll
+  for (int it = 0; it < kIterations; ++it) {
+    // One float4 serves ILP == 4 elements, or four iterations of ILP == 1.
+    if (ILP == 4 || it % 4 == 0) {
+      rand = curand_uniform4(&state);
+    }
+    const int64_t j = (it * kPersistentNumThreads + threadIdx.x) * ILP;
+    if (j < N) {
+      const vec_t x_v = *reinterpret_cast<const vec_t*>(X + row_offset + j);
+      const vec_t r_v = *reinterpret_cast<const vec_t*>(R + row_offset + j);
+      vec_t s_v;
+      mask_vec_t mask_v;
+#pragma unroll
+      for (int k = 0; k < ILP; ++k) {
+        const bool keep = (&rand.x)[ILP == 4 ? k : it % 4] < p;
+        s_v.val[k] =
+            (keep ? static_cast<T_ACC>(x_v.val[k]) * pinv : T_ACC(0)) +
+            static_cast<T_ACC>(r_v.val[k]);
+        mask_v.val[k] = keep;
+        // Normalize S as it is stored, which is what the backward reads.
+        x[it][k] = static_cast<T_ACC>(s_v.val[k]);
+        sum += x[it][k];
+      }
+      *reinterpret_cast<vec_t*>(S + row_offset + j) = s_v;
+      *reinterpret_cast<mask_vec_t*>(mask + row_offset + j) = mask_v;
+    }
+  }
+  PersistentLayerNormRow<T, kIterations, ILP>(
+      i, N, eps, x, sum, gamma, beta, mean, rstd, Y + row_offset);
+}
+
+// The dropout(X) + R part of DropoutAddLayerNormForwardPersistentCUDAKernel
+// for rows too long to be held in registers. The layer norm of S is then
+// computed by the general kernels.
+template <typename T>
+__global__ void DropoutAddCUDAKernel(
+    int64_t N,
+    acc_type<T, true> p,
+    PhiloxCudaState philox_args,
+    const T* X,
+    const T* R,
+    T* S,
+    uint8_t* mask) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t i = blockIdx.x;
+  const int64_t row_offset = i * N;
+
+  const auto seeds = at::cuda::philox::unpack(philox_args);
+  curandStatePhilox4_32_10_t state;
+  curand_init(
+      seeds.first,
+      i * kPersistentNumThreads + threadIdx.x,
+      seeds.second,
+      &state);
+  const T_ACC pinv = T_ACC(1) / p;
+
+  for (int64_t base = 0; base < N;
+       base += kPersistentNumThreads * kPersistentVecSize) {
+    const float4 rand = curand_uniform4(&state);
+#pragma unroll
+    for (int k = 0; k < kPersistentVecSize; ++k) {
+      const int64_t j = base + k * kPersistentNumThreads + threadIdx.x;
+      if (j < N) {
+        const bool keep = (&rand.x)[k] < p;
+        S[row_offset + j] =
+            (keep ? static_cast<T_ACC>(X[row_offset + j]) * pinv : T_ACC(0)) +
+            static_cast<T_ACC>(R[row_offset + j]);
+        mask[row_offset + j] = keep;
+      }
+    }
+  }
+}
+
+// Fuses ComputeInternalGradientsCUDAKernel,
+// ComputeGradientFusedParamsCUDAKernel and LayerNormBackwardCUDAKenrel for
+// one row held in registers. If mask is not null, dX * mask * mask_scale, the
+// gradient of the input of a fused dropout, is written to dX_masked too.
+template <typename T, int kIterations, int ILP>
+__global__ void LayerNormBackwardPersistentCUDAKernel(
+    int64_t N,
+    const T* dY,
+    const T* X,
+    const T* mean,
+    const T* rstd,
+    const T* gamma,
+    T* dX,
+    const uint8_t* mask,
+    acc_type<T, true> mask_scale,
+    T* dX_masked) {
+  using T_ACC = acc_type<T, true>;
+  using vec_t = memory::aligned_vector<T, ILP>;
+  using mask_vec_t = memory::aligned_vector<uint8_t, ILP>;
+  __shared__ T_ACC ds_shared[C10_WARP_SIZE];
+  __shared__ T_ACC db_shared[C10_WARP_SIZE];
+  const int64_t i = blockIdx.x;
+  const T* dY_row = dY + i * N;
+  const T* X_row = X + i * N;
+  T* dX_row = dX + i * N;
+
+  // dY * gamma and X.
+  T_ACC dy_g[kIterations][ILP];
+  T_ACC x[kIterations][ILP];
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+#pragma unroll
+  for (int it = 0; it < kIterations; ++it) {
+    const int64_t j = (it * kPersistentNumThreads + threadIdx.x) * ILP;
+    if (j < N) {
+      const vec_t dy_v = *reinterpret_cast<const vec_t*>(dY_row + j);
+      const vec_t x_v = *reinterpret_cast<const vec_t*>(X_row + j);
+      vec_t gamma_v;
+      if (gamma != nullptr) {
+        gamma_v = *reinterpret_cast<const vec_t*>(gamma + j);
+      }
+#pragma unroll
+      for (int k = 0; k < ILP; ++k) {
+        const T_ACC g =
+            gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma_v.val[k]);
+        dy_g[it][k] = static_cast<T_ACC>(dy_v.val[k]) * g;
+        x[it][k] = static_cast<T_ACC>(x_v.val[k]);
+        sum1 += dy_g[it][k] * x[it][k];
+        sum2 += dy_g[it][k];
+      }
+    }
+  }
+  const T_ACC ds = BlockAllReduceSum<T_ACC>(sum1, ds_shared);
+  const T_ACC db = BlockAllReduceSum<T_ACC>(sum2, db_shared);
+
+  const T_ACC mean_v = static_cast<T_ACC>(mean[i]);
+  const T_ACC rstd_v = static_cast<T_ACC>(rstd[i]);
+  const T_ACC s = T_ACC(1) / static_cast<T_ACC>(N);
+  const T_ACC c1 = (db * mean_v - ds) * rstd_v * rstd_v * rstd_v * s;
+  const T_ACC c2 = -(c1 * mean_v + db * rstd_v * s);
+#pragma unroll
+  for (int it = 0; it < kIterations; ++it) {
+    const int64_t j = (it * kPersistentNumThreads + threadIdx.x) * ILP;
+    if (j < N) {
+      vec_t out;
+#pragma unroll
+      for (int k = 0; k < ILP; ++k) {
+        out.val[k] = rstd_v * dy_g[it][k] + c1 * x[it][k] + c2;
+      }
+      *reinterpret_cast<vec_t*>(dX_row + j) = out;
+      if (mask != nullptr) {
+        const mask_vec_t mask_v =
+            *reinterpret_cast<const mask_vec_t*>(mask + i * N + j);
+        vec_t out_masked;
+#pragma unroll
+        for (int k = 0; k < ILP; ++k) {
+          out_masked.val[k] = static_cast<T_ACC>(out.val[k]) *
+              static_cast<T_ACC>(mask_v.val[k]) * mask_scale;
+        }
+        *reinterpret_cast<vec_t*>(dX_masked + i * N + j) = out_masked;
+      }
+    }
+  }
+}
+
+// Vectorized accesses need N and every (non null) row pointer to be aligned
+// to kPersistentVecSize elements.
+template <typename T>
+bool CanVectorizePersistent(int64_t N, std::initializer_list<const T*> ptrs) {
+  if (N % kPersistentVecSize != 0) {
+    return false;
+  }
+  for (const T* ptr : ptrs) {
+    if (reinterpret_cast<uintptr_t>(ptr) % (kPersistentVecSize * sizeof(T)) !=
+        0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Number of vectors of kPersistentVecSize elements each thread holds.
+inline int PersistentIterations(int64_t N) {
+  return N <= 1024 ? 1 : (N <= 2048 ? 2 : 4);
+}
+
+// Launches the instantiation of the persistent KERNEL matching N and the
+// alignment of the data, with one block for each of the M rows, on
+// cuda_stream.
+#define DISPATCH_LAYER_NORM_PERSISTENT(KERNEL, T, N, VECTORIZE, ...)       \
+  switch ((VECTORIZE) ? PersistentIterations(N)                            \
+                      : PersistentIterations(N) * kPersistentVecSize) {    \
+    case 1:                                                                \
+      KERNEL<T, 1, kPersistentVecSize>                                     \
+          <<<M, kPersistentNumThreads, 0, cuda_stream>>>(__VA_ARGS__);     \
+      break;                                                               \
+    case 2:                                                                \
+      KERNEL<T, 2, kPersistentVecSize>                                     \
+          <<<M, kPersistentNumThreads, 0, cuda_stream>>>(__VA_ARGS__);     \
+      break;                                                               \
+    case 4:                                                                \
+      if (VECTORIZE) {                                                     \
+        KERNEL<T, 4, kPersistentVecSize>                                   \
+            <<<M, kPersistentNumThreads, 0, cuda_stream>>>(__VA_ARGS__);   \
+      } else {                                                             \
+        KERNEL<T, 4, 1>                                                    \
+            <<<M, kPersistentNumThreads, 0, cuda_stream>>>(__VA_ARGS__);   \
+      }                                                                    \
+      break;                                                               \
+    case 8:                                                                \
+      KERNEL<T, 8, 1>                                                      \
+          <<<M, kPersistentNumThreads, 0, cuda_stream>>>(__VA_ARGS__);     \
+      break;                                                               \
+    case 16:                                                               \
+      KERNEL<T, 16, 1>                                                     \
+          <<<M, kPersistentNumThreads, 0, cuda_stream>>>(__VA_ARGS__);     \
+      break;                                                               \
+    default:                                                               \
+      TORCH_INTERNAL_ASSERT(false);                                        \
+  }
+
 template <typename T>
 __global__ void GammaBetaBackwardSimpleCUDAKernel(
     int64_t M,
@@ -275,11 +652,29 @@ void LayerNormKernelImplInternal(
   T* mean_data = mean->data_ptr<T>();
   T* rstd_data = rstd->data_ptr<T>();
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
-  RowwiseMomentsCUDAKernel<T>
-      <<<M, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
-          N, eps, X_data, mean_data, rstd_data);
-  LayerNormForwardCUDAKernel<T><<<M, kCUDANumThreads, 0, cuda_stream>>>(
-      N, X_data, mean_data, rstd_data, gamma_data, beta_data, Y_data);
+  if (N <= kPersistentMaxN) {
+    const bool vectorize = CanVectorizePersistent<T>(
+        N, {X_data, gamma_data, beta_data, Y_data});
+    DISPATCH_LAYER_NORM_PERSISTENT(
+        LayerNormForwardPersistentCUDAKernel,
+        T,
+        N,
+        vectorize,
+        N,
+        eps,
+        X_data,
+        gamma_data,
+        beta_data,
+        mean_data,
+        rstd_data,
+        Y_data);
+  } else {
+    RowwiseMomentsCUDAKernel<T>
+        <<<M, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+            N, eps, X_data, mean_data, rstd_data);
+    LayerNormForwardCUDAKernel<T><<<M, kCUDANumThreads, 0, cuda_stream>>>(
+        N, X_data, mean_data, rstd_data, gamma_data, beta_data, Y_data);
+  }
   AT_CUDA_CHECK(cudaGetLastError());
 }
 
@@ -313,7 +708,10 @@ void LayerNormBackwardKernelImplInternal(
     int64_t N,
     Tensor* dX,
     Tensor* dgamma,
-    Tensor* dbeta) {
+    Tensor* dbeta,
+    const Tensor& mask /* optional */,
+    double mask_scale,
+    Tensor* dX_masked) {
   using T_ACC = acc_type<T, true>;
   DCHECK_EQ(dY.numel(), M * N);
   DCHECK_EQ(X.numel(), M * N);
@@ -327,8 +725,32 @@ void LayerNormBackwardKernelImplInternal(
   const T* gamma_data =
       gamma.defined() ? gamma.template data_ptr<T>() : nullptr;
   T* dX_data = dX->defined() ? dX->template data_ptr<T>() : nullptr;
+  const uint8_t* mask_data =
+      mask.defined() ? mask.template data_ptr<uint8_t>() : nullptr;
+  T* dX_masked_data =
+      mask.defined() ? dX_masked->template data_ptr<T>() : nullptr;
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
-  if (dX_data != nullptr) {
+  if (dX_data != nullptr && N <= kPersistentMaxN) {
+    const bool vectorize =
+        CanVectorizePersistent<T>(
+            N, {dY_data, X_data, gamma_data, dX_data, dX_masked_data}) &&
+        reinterpret_cast<uintptr_t>(mask_data) % kPersistentVecSize == 0;
+    DISPATCH_LAYER_NORM_PERSISTENT(
+        LayerNormBackwardPersistentCUDAKernel,
+        T,
+        N,
+        vectorize,
+        N,
+        dY_data,
+        X_data,
+        mean_data,
+        rstd_data,
+        gamma_data,
+        dX_data,
+        mask_data,
+        static_cast<T_ACC>(mask_scale),
+        dX_masked_data);
+  } else if (dX_data != nullptr) {
     const auto kAccType = (X.scalar_type() == kHalf || X.scalar_type() == kBFloat16) ? kFloat : X.scalar_type();
     Tensor ds = at::empty({M}, X.options().dtype(kAccType));
     Tensor db = at::empty({M}, X.options().dtype(kAccType));
@@ -361,6 +783,18 @@ void LayerNormBackwardKernelImplInternal(
         scale_data,
         bias_data,
         dX_data);
+    if (mask_data != nullptr) {
+      const T_ACC scale_v = static_cast<T_ACC>(mask_scale);
+      auto iter = TensorIteratorConfig()
+                      .check_all_same_dtype(false)
+                      .add_output(*dX_masked)
+                      .add_input(*dX)
+                      .add_input(mask)
+                      .build();
+      gpu_kernel(iter, [scale_v] GPU_LAMBDA(T dx, uint8_t m) -> T {
+        return static_cast<T_ACC>(dx) * static_cast<T_ACC>(m) * scale_v;
+      });
+    }
   }
   if (dgamma->defined() || dbeta->defined()) {
     T* dgamma_data =
@@ -413,11 +847,100 @@ void LayerNormBackwardKernelImpl(
       X.scalar_type(), "LayerNormBackwardKernelImpl", [&]() {
         AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "LayerNormBackwardKernelImpl", [&] {
           LayerNormBackwardKernelImplInternal<scalar_t>(
-              dY, X, mean, rstd, gamma, M, N, dX, dgamma, dbeta);
+              dY,
+              X,
+              mean,
+              rstd,
+              gamma,
+              M,
+              N,
+              dX,
+              dgamma,
+              dbeta,
+              /*mask=*/Tensor(),
+              /*mask_scale=*/0,
+              /*dX_masked=*/nullptr);
         });
       });
 }
 
+// Number of philox values each thread of the dropout + add + layer norm
+// kernels consumes: one float4 for every kPersistentVecSize of its elements.
+int64_t DropoutAddLayerNormCounterOffset(int64_t N) {
+  const int64_t draws = N <= kPersistentMaxN
+      ? PersistentIterations(N)
+      : (N + kPersistentNumThreads * kPersistentVecSize - 1) /
+          (kPersistentNumThreads * kPersistentVecSize);
+  return draws * 4;
+}
+
+template <typename T>
+void DropoutAddLayerNormKernelImplInternal(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    double p,
+    T eps,
+    PhiloxCudaState philox_args,
+    Tensor* Y,
+    Tensor* S,
+    Tensor* mask,
+    Tensor* mean,
+    Tensor* rstd) {
+  using T_ACC = acc_type<T, true>;
+  DCHECK_EQ(X.numel(), M * N);
+  DCHECK_EQ(R.numel(), M * N);
+  DCHECK(!gamma.defined() || gamma.numel() == N);
+  DCHECK(!beta.defined() || beta.numel() == N);
+  const T* X_data = X.data_ptr<T>();
+  const T* R_data = R.data_ptr<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+  T* Y_data = Y->data_ptr<T>();
+  T* S_data = S->data_ptr<T>();
+  uint8_t* mask_data = mask->data_ptr<uint8_t>();
+  T* mean_data = mean->data_ptr<T>();
+  T* rstd_data = rstd->data_ptr<T>();
+  const T_ACC p_v = static_cast<T_ACC>(p);
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  if (N <= kPersistentMaxN) {
+    const bool vectorize =
+        CanVectorizePersistent<T>(
+            N, {X_data, R_data, gamma_data, beta_data, S_data, Y_data}) &&
+        reinterpret_cast<uintptr_t>(mask_data) % kPersistentVecSize == 0;
+    DISPATCH_LAYER_NORM_PERSISTENT(
+        DropoutAddLayerNormForwardPersistentCUDAKernel,
+        T,
+        N,
+        vectorize,
+        N,
+        eps,
+        p_v,
+        philox_args,
+        X_data,
+        R_data,
+        gamma_data,
+        beta_data,
+        S_data,
+        mask_data,
+        mean_data,
+        rstd_data,
+        Y_data);
+  } else {
+    DropoutAddCUDAKernel<T><<<M, kPersistentNumThreads, 0, cuda_stream>>>(
+        N, p_v, philox_args, X_data, R_data, S_data, mask_data);
+    RowwiseMomentsCUDAKernel<T>
+        <<<M, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+            N, eps, S_data, mean_data, rstd_data);
+    LayerNormForwardCUDAKernel<T><<<M, kCUDANumThreads, 0, cuda_stream>>>(
+        N, S_data, mean_data, rstd_data, gamma_data, beta_data, Y_data);
+  }
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
 } // namespace
 
 std::tuple<Tensor, Tensor, Tensor> layer_norm_cuda(
@@ -464,6 +987,144 @@ std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cuda(
   return std::make_tuple(std::move(dX), std::move(dgamma), std::move(dbeta));
 }
 
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>
+fused_dropout_add_layer_norm_cuda(
+    const Tensor& input,
+    const Tensor& residual,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t M,
+    int64_t N,
+    double p,
+    double eps,
+    c10::optional<Generator> gen_) {
+  TORCH_CHECK(
+      input.sizes() == residual.sizes(),
+      "Expected residual to be of the same shape as input, but got input of "
+      "shape ",
+      input.sizes(),
+      " and residual of shape ",
+      residual.sizes());
+  TORCH_CHECK(
+      input.scalar_type() == residual.scalar_type(),
+      "Expected residual to be of the same dtype as input, but got ",
+      residual.scalar_type(),
+      " and ",
+      input.scalar_type());
+  TORCH_CHECK(
+      p > 0 && p <= 1,
+      "keep probability has to be in (0, 1], but got ",
+      p);
+  const Tensor X = input.contiguous();
+  const Tensor R = residual.contiguous();
+  Tensor Y = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor S = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor mask = at::empty(X.sizes(), X.options().dtype(kByte));
+  Tensor mean = at::empty({M}, X.options());
+  Tensor rstd = at::empty({M}, X.options());
+  if (M > 0) {
+    auto gen = get_generator_or_default<CUDAGeneratorImpl>(
+        gen_, cuda::detail::getDefaultCUDAGenerator());
+    // See Note [Lock-free philox offsets]
+    PhiloxCudaState rng_engine_inputs =
+        gen->philox_cuda_state(DropoutAddLayerNormCounterOffset(N));
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::ScalarType::Half,
+        at::ScalarType::BFloat16,
+        X.scalar_type(),
+        "DropoutAddLayerNormKernelImpl",
+        [&]() {
+          AT_SKIP_BFLOAT16_IF_NOT_ROCM(
+              scalar_t, "DropoutAddLayerNormKernelImpl", [&] {
+                DropoutAddLayerNormKernelImplInternal<scalar_t>(
+                    X,
+                    R,
+                    gamma,
+                    beta,
+                    M,
+                    N,
+                    p,
+                    static_cast<scalar_t>(eps),
+                    rng_engine_inputs,
+                    &Y,
+                    &S,
+                    &mask,
+                    &mean,
+                    &rstd);
+              });
+        });
+  }
+  return std::make_tuple(
+      std::move(Y),
+      std::move(S),
+      std::move(mask),
+      std::move(mean),
+      std::move(rstd));
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor>
+fused_dropout_add_layer_norm_backward_cuda(
+    const Tensor& dY,
+    const Tensor& S,
+    const Tensor& mask,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t M,
+    int64_t N,
+    double p,
+    std::array<bool, 4> grad_input_mask) {
+  // The gradient of the residual is the gradient of S, which the one of the
+  // input is the masked and scaled copy of.
+  Tensor dS;
+  Tensor dX;
+  Tensor dgamma;
+  Tensor dbeta;
+  if (grad_input_mask[0] || grad_input_mask[1]) {
+    dS = at::native::empty_like(S, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  }
+  if (grad_input_mask[0]) {
+    dX = at::native::empty_like(S, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  }
+  if (grad_input_mask[2]) {
+    dgamma = M > 0 ? at::native::empty_like(gamma, LEGACY_CONTIGUOUS_MEMORY_FORMAT) : at::native::zeros_like(gamma, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  }
+  if (grad_input_mask[3]) {
+    dbeta = M > 0 ? at::native::empty_like(gamma, LEGACY_CONTIGUOUS_MEMORY_FORMAT) : at::native::zeros_like(gamma, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  }
+  if (M > 0) {
+    const Tensor mask_contig = mask.contiguous();
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::ScalarType::Half,
+        at::ScalarType::BFloat16,
+        S.scalar_type(),
+        "DropoutAddLayerNormBackwardKernelImpl",
+        [&]() {
+          AT_SKIP_BFLOAT16_IF_NOT_ROCM(
+              scalar_t, "DropoutAddLayerNormBackwardKernelImpl", [&] {
+                LayerNormBackwardKernelImplInternal<scalar_t>(
+                    dY,
+                    S,
+                    mean,
+                    rstd,
+                    gamma,
+                    M,
+                    N,
+                    &dS,
+                    &dgamma,
+                    &dbeta,
+                    dX.defined() ? mask_contig : Tensor(),
+                    1. / p,
+                    &dX);
+              });
+        });
+  }
+  return std::make_tuple(
+      std::move(dX),
+      grad_input_mask[1] ? std::move(dS) : Tensor(),
+      std::move(dgamma),
+      std::move(dbeta));
+}
 
 REGISTER_DISPATCH(LayerNormKernel, &LayerNormKernelImpl);
 REGISTER_DISPATCH(LayerNormBackwardKernel, &LayerNormBackwardKernelImpl);
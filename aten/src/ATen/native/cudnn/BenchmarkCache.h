@@ -0,0 +1,14 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+#include <string>
+
+namespace at { namespace native {
+
+// Saves and loads the convolution algorithms chosen by cuDNN, see
+// Note [cuDNN benchmark cache file] in Conv.cpp
+TORCH_CUDA_API void save_cudnn_benchmark_cache(const std::string& path);
+TORCH_CUDA_API void load_cudnn_benchmark_cache(const std::string& path);
+
+}}  // namespace at::native
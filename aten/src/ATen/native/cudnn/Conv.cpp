@@ -7,6 +7,7 @@
 #include <ATen/cuda/CUDAConfig.h>
 #include <ATen/cuda/Exceptions.h>
 #include <ATen/native/ConvUtils.h>
+#include <ATen/native/cudnn/BenchmarkCache.h>
 
 #if !AT_CUDNN_ENABLED()
 
@@ -70,12 +71,21 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
   AT_ERROR("cudnn_convolution_transpose_backward: ATen not compiled with cuDNN support");
 }
 
+void save_cudnn_benchmark_cache(const std::string& path) {
+  AT_ERROR("save_cudnn_benchmark_cache: ATen not compiled with cuDNN support");
+}
+
+void load_cudnn_benchmark_cache(const std::string& path) {
+  AT_ERROR("load_cudnn_benchmark_cache: ATen not compiled with cuDNN support");
+}
+
 }}
 
 #else  // AT_CUDNN_ENABLED
 
 #include <THC/THC.h>
 
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cudnn/cudnn-wrapper.h>
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
@@ -88,6 +98,7 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 #include <iterator>
 #include <sstream>
 #include <algorithm>
+#include <fstream>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
@@ -215,6 +226,8 @@ struct ConvolutionParams
   int dilation[max_dim];
   int64_t groups;
   bool deterministic;
+  // algorithm timings differ between GPU models
+  int device_id;
   // NB: transposed purposely omitted: transposed just swaps
   // forward and backward, so you can reuse the benchmark entry,
 };
@@ -250,6 +263,7 @@ void setConvolutionParams(
   // CuDNN, but it doesn't seem worth the effort to actually do this.
   params->groups = groups;
   params->deterministic = deterministic;
+  params->device_id = input.get_device();
 }
 
 // Convenience struct for passing around descriptors and data
@@ -292,12 +306,180 @@ struct BenchmarkCache {
     std::lock_guard<std::mutex> guard(mutex);
     map[params] = results;
   }
+
+  std::vector<std::pair<ConvolutionParams, T>> entries() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return {map.begin(), map.end()};
+  }
 };
 
 BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
 BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
 BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
 
+// Note [cuDNN benchmark cache file]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// What cudnnFind picks only depends on the ConvolutionParams, the GPU
+// model, the cuDNN version and the driver, so other processes can reuse
+// it instead of running cudnnFind again. The file is text, a header line
+//
+//   cudnn_benchmark_cache <cuDNN version> <driver version>
+//
+// followed by one tab separated entry per line,
+//
+//   <fwd|bwd_data|bwd_filter> <device name> <ConvolutionParams> <algo>
+//
+// A file written with another cuDNN or driver version is skipped with a
+// warning. Entries are keyed by device name rather than ordinal, and are
+// loaded for every device of this process with that name.
+
+constexpr const char* kBenchmarkCacheMagic = "cudnn_benchmark_cache";
+
+static std::string device_name(int device) {
+  return at::cuda::getDeviceProperties(device)->name;
+}
+
+static int driver_version() {
+  int version = 0;
+  AT_CUDA_CHECK(cudaDriverGetVersion(&version));
+  return version;
+}
+
+static void write_params(std::ostream& out, const ConvolutionParams& params) {
+  auto write = [&](const int* values, int n) {
+    for (int i = 0; i < n; i++) {
+      out << ' ' << values[i];
+    }
+  };
+  out << static_cast<int>(params.dataType);
+  write(params.input_size, 2 + max_dim);
+  write(params.input_stride, 2 + max_dim);
+  write(params.weight_size, 2 + max_dim);
+  write(params.padding, max_dim);
+  write(params.stride, max_dim);
+  write(params.dilation, max_dim);
+  out << ' ' << params.groups << ' ' << params.deterministic;
+}
+
+static bool read_params(std::istream& in, ConvolutionParams* params) {
+  auto read = [&](int* values, int n) {
+    for (int i = 0; i < n; i++) {
+      in >> values[i];
+    }
+  };
+  memset(params, 0, sizeof(ConvolutionParams));
+  int data_type = 0;
+  in >> data_type;
+  params->dataType = static_cast<cudnnDataType_t>(data_type);
+  read(params->input_size, 2 + max_dim);
+  read(params->input_stride, 2 + max_dim);
+  read(params->weight_size, 2 + max_dim);
+  read(params->padding, max_dim);
+  read(params->stride, max_dim);
+  read(params->dilation, max_dim);
+  in >> params->groups >> params->deterministic;
+  return static_cast<bool>(in);
+}
+
+template <typename perf_t>
+static void save_entries(std::ostream& out, const char* kind, BenchmarkCache<perf_t>& cache) {
+  for (const auto& entry : cache.entries()) {
+    const perf_t& perf = entry.second;
+    out << kind << '\t' << device_name(entry.first.device_id) << '\t';
+    write_params(out, entry.first);
+    out << '\t' << static_cast<int>(perf.algo)
+        << ' ' << static_cast<int>(perf.mathType)
+        << ' ' << perf.memory
+        << ' ' << static_cast<int>(perf.determinism) << '\n';
+  }
+}
+
+template <typename perf_t>
+static bool load_entry(
+    const std::string& params_field, const std::string& perf_field,
+    const std::vector<int>& devices, BenchmarkCache<perf_t>& cache) {
+  ConvolutionParams params;
+  std::istringstream params_in(params_field);
+  if (!read_params(params_in, &params)) {
+    return false;
+  }
+  perf_t perf;
+  memset(&perf, 0, sizeof(perf_t));
+  int algo = 0, math_type = 0, determinism = 0;
+  std::istringstream perf_in(perf_field);
+  if (!(perf_in >> algo >> math_type >> perf.memory >> determinism)) {
+    return false;
+  }
+  perf.algo = static_cast<decltype(perf.algo)>(algo);
+  perf.status = CUDNN_STATUS_SUCCESS;
+  perf.mathType = static_cast<cudnnMathType_t>(math_type);
+  perf.determinism = static_cast<cudnnDeterminism_t>(determinism);
+  for (int device : devices) {
+    params.device_id = device;
+    cache.insert(params, perf);
+  }
+  return true;
+}
+
+void save_cudnn_benchmark_cache(const std::string& path) {
+  std::ofstream out(path);
+  TORCH_CHECK(out, "save_cudnn_benchmark_cache: could not open ", path, " for writing");
+  out << kBenchmarkCacheMagic << ' ' << cudnnGetVersion() << ' ' << driver_version() << '\n';
+  save_entries(out, "fwd", fwd_algos);
+  save_entries(out, "bwd_data", bwd_data_algos);
+  save_entries(out, "bwd_filter", bwd_filter_algos);
+  TORCH_CHECK(out, "save_cudnn_benchmark_cache: failed to write ", path);
+}
+
+void load_cudnn_benchmark_cache(const std::string& path) {
+  std::ifstream in(path);
+  TORCH_CHECK(in, "load_cudnn_benchmark_cache: could not open ", path);
+  std::string magic;
+  size_t cudnn_version = 0;
+  int driver = 0;
+  in >> magic >> cudnn_version >> driver;
+  TORCH_CHECK(in && magic == kBenchmarkCacheMagic,
+      "load_cudnn_benchmark_cache: ", path, " is not a cuDNN benchmark cache");
+  if (cudnn_version != cudnnGetVersion() || driver != driver_version()) {
+    TORCH_WARN("load_cudnn_benchmark_cache: ignoring ", path, ", it was written with cuDNN ",
+               cudnn_version, " and driver ", driver, " but this process uses cuDNN ",
+               cudnnGetVersion(), " and driver ", driver_version());
+    return;
+  }
+
+  std::unordered_map<std::string, std::vector<int>> devices_by_name;
+  for (int device = 0; device < c10::cuda::device_count(); device++) {
+    devices_by_name[device_name(device)].push_back(device);
+  }
+
+  std::string line;
+  std::getline(in, line);  // rest of the header line
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string kind, name, params_field, perf_field;
+    std::getline(fields, kind, '\t');
+    std::getline(fields, name, '\t');
+    std::getline(fields, params_field, '\t');
+    std::getline(fields, perf_field, '\t');
+    auto it = devices_by_name.find(name);
+    if (it == devices_by_name.end()) {
+      continue;
+    }
+    bool ok = false;
+    if (kind == "fwd") {
+      ok = load_entry(params_field, perf_field, it->second, fwd_algos);
+    } else if (kind == "bwd_data") {
+      ok = load_entry(params_field, perf_field, it->second, bwd_data_algos);
+    } else if (kind == "bwd_filter") {
+      ok = load_entry(params_field, perf_field, it->second, bwd_filter_algos);
+    }
+    TORCH_CHECK(ok, "load_cudnn_benchmark_cache: malformed line in ", path, ": ", line);
+  }
+}
+
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
 struct Workspace {
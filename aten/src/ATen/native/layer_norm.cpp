@@ -79,6 +79,43 @@ Tensor layer_norm(
   return std::get<0>(at::native_layer_norm(X, gamma, beta, M, N, eps));
 }
 
+Tensor dropout_add_layer_norm(
+    const Tensor& input,
+    const Tensor& residual,
+    double p,
+    bool train,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double eps) {
+  TORCH_CHECK(
+      p >= 0 && p <= 1,
+      "dropout probability has to be between 0 and 1, but got ",
+      p);
+  // The fused kernel keeps the dropout mask it generates in the forward for
+  // the backward, see _fused_dropout_add_layer_norm.
+  if (train && p > 0 && p < 1 && input.is_cuda() && input.numel() > 0 &&
+      input.sizes().equals(residual.sizes()) &&
+      input.scalar_type() == residual.scalar_type() && !input.has_names() &&
+      !residual.has_names()) {
+    auto inputs =
+        _prepare_layer_norm_inputs(input, normalized_shape, weight, bias);
+    auto X = std::get<0>(inputs);
+    auto gamma = std::get<1>(inputs);
+    auto beta = std::get<2>(inputs);
+    auto M = std::get<3>(inputs);
+    auto N = std::get<4>(inputs);
+    return std::get<0>(at::_fused_dropout_add_layer_norm(
+        X, residual.contiguous(), gamma, beta, M, N, 1 - p, eps));
+  }
+  return at::layer_norm(
+      at::dropout(input, p, train) + residual,
+      normalized_shape,
+      weight,
+      bias,
+      eps);
+}
+
 DEFINE_DISPATCH(LayerNormKernel);
 DEFINE_DISPATCH(LayerNormBackwardKernel);
 
@@ -0,0 +1,257 @@
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <ATen/core/grad_mode.h>
+#include <ATen/native/mkl/PackedOpContext.h>
+
+#include <climits>
+
+#if AT_MKL_ENABLED()
+#include <mkl.h>
+#endif // AT_MKL_ENABLED
+
+namespace at {
+namespace native {
+namespace cpu_prepacked {
+
+// See Note [CPU prepacked weights]
+
+namespace {
+
+bool packable(const Tensor& weight, const c10::optional<Tensor>& bias) {
+  return weight.device().is_cpu() &&
+         weight.layout() == kStrided &&
+         weight.scalar_type() == kFloat &&
+         (!bias || (bias->device().is_cpu() &&
+                    bias->layout() == kStrided &&
+                    bias->scalar_type() == kFloat));
+}
+
+bool usable(const Tensor& input) {
+  return input.device().is_cpu() &&
+         input.layout() == kStrided &&
+         input.scalar_type() == kFloat &&
+         !(GradMode::is_enabled() && input.requires_grad());
+}
+
+c10::optional<Tensor> defined_or_nullopt(c10::optional<Tensor>&& bias) {
+  if (bias && bias->defined()) {
+    return std::move(bias);
+  }
+  return c10::nullopt;
+}
+
+} // namespace
+
+LinearOpContext::LinearOpContext(
+    Tensor&& weight,
+    c10::optional<Tensor>&& bias)
+    : orig_weight_(std::move(weight)),
+      orig_bias_(defined_or_nullopt(std::move(bias))) {
+  TORCH_CHECK(
+      orig_weight_.dim() == 2,
+      "cpu_prepacked::linear_prepack: expected a 2-D weight, got a ",
+      orig_weight_.dim(), "-D one");
+  TORCH_CHECK(
+      !orig_bias_ ||
+          (orig_bias_->dim() == 1 && orig_bias_->size(0) == orig_weight_.size(0)),
+      "cpu_prepacked::linear_prepack: expected a bias of size [",
+      orig_weight_.size(0), "], got ", orig_bias_->sizes());
+  if (!packable(orig_weight_, orig_bias_)) {
+    return;
+  }
+
+  const int64_t n = orig_weight_.size(0);
+  const int64_t k = orig_weight_.size(1);
+#if AT_MKL_ENABLED()
+  if (n > 0 && k > 0 && n <= INT_MAX && k <= INT_MAX) {
+    // y = x @ weight^T, so the n x k row major weight is op(B) = B^T. The
+    // packed layout of B does not depend on m.
+    const Tensor weight_contig = orig_weight_.contiguous();
+    const size_t bytes = cblas_sgemm_pack_get_size(CblasBMatrix, 1, n, k);
+    packed_weight_ = at::empty(
+        {static_cast<int64_t>(bytes)}, orig_weight_.options().dtype(kByte));
+    cblas_sgemm_pack(
+        CblasRowMajor, CblasBMatrix, CblasTrans,
+        1, n, k,
+        1.0f,
+        weight_contig.data_ptr<float>(), k,
+        reinterpret_cast<float*>(packed_weight_.data_ptr()));
+    mkl_packed_ = true;
+    return;
+  }
+#endif // AT_MKL_ENABLED
+  packed_weight_ = orig_weight_.t().contiguous();
+}
+
+Tensor LinearOpContext::run(const Tensor& input) {
+  const Tensor bias = orig_bias_ ? *orig_bias_ : Tensor();
+  if (!packed_weight_.defined() || !usable(input) || input.dim() == 0) {
+    return at::linear(input, orig_weight_, bias);
+  }
+
+  const int64_t n = orig_weight_.size(0);
+  const int64_t k = orig_weight_.size(1);
+  TORCH_CHECK(
+      input.size(-1) == k,
+      "cpu_prepacked::linear_run: expected the last dimension of input to be ",
+      k, ", got input of size ", input.sizes());
+  const Tensor x = input.reshape({-1, k}).contiguous();
+  const int64_t m = x.size(0);
+  std::vector<int64_t> output_size = input.sizes().vec();
+  output_size.back() = n;
+
+  if (mkl_packed_) {
+#if AT_MKL_ENABLED()
+    if (m > INT_MAX) {
+      return at::linear(input, orig_weight_, bias);
+    }
+    Tensor output = bias.defined()
+        ? bias.expand({m, n}).contiguous()
+        : at::empty({m, n}, x.options());
+    if (m > 0) {
+      cblas_sgemm_compute(
+          CblasRowMajor, CblasNoTrans, CblasPacked,
+          m, n, k,
+          x.data_ptr<float>(), k,
+          reinterpret_cast<const float*>(packed_weight_.data_ptr()), k,
+          bias.defined() ? 1.0f : 0.0f,
+          output.data_ptr<float>(), n);
+    }
+    return output.view(output_size);
+#endif // AT_MKL_ENABLED
+  }
+
+  const Tensor output = bias.defined()
+      ? at::addmm(bias, x, packed_weight_)
+      : at::mm(x, packed_weight_);
+  return output.view(output_size);
+}
+
+c10::intrusive_ptr<LinearOpContext> LinearOpContext::create_context(
+    Tensor&& weight,
+    c10::optional<Tensor>&& bias) {
+  return c10::make_intrusive<LinearOpContext>(std::move(weight), std::move(bias));
+}
+
+Conv2dOpContext::Conv2dOpContext(
+    Tensor&& weight,
+    c10::optional<Tensor>&& bias,
+    std::vector<int64_t>&& stride,
+    std::vector<int64_t>&& padding,
+    std::vector<int64_t>&& dilation,
+    int64_t groups)
+    : orig_weight_(std::move(weight)),
+      orig_bias_(defined_or_nullopt(std::move(bias))),
+      stride_(std::move(stride)),
+      padding_(std::move(padding)),
+      dilation_(std::move(dilation)),
+      groups_(groups) {
+  TORCH_CHECK(
+      orig_weight_.dim() == 4,
+      "cpu_prepacked::conv2d_prepack: expected a 4-D weight, got a ",
+      orig_weight_.dim(), "-D one");
+  TORCH_CHECK(
+      stride_.size() == 2 && padding_.size() == 2 && dilation_.size() == 2,
+      "cpu_prepacked::conv2d_prepack: expected 2 values each for stride, ",
+      "padding and dilation");
+  TORCH_CHECK(
+      groups_ > 0,
+      "cpu_prepacked::conv2d_prepack: expected groups to be positive, got ",
+      groups_);
+#if AT_MKLDNN_ENABLED()
+  if (packable(orig_weight_, orig_bias_)) {
+    packed_weight_ = at::mkldnn_reorder_conv2d_weight(
+        orig_weight_.contiguous().to_mkldnn(),
+        padding_, stride_, dilation_, groups_);
+  }
+#endif // AT_MKLDNN_ENABLED
+}
+
+Tensor Conv2dOpContext::run(const Tensor& input, const bool relu) {
+  const Tensor bias = orig_bias_ ? *orig_bias_ : Tensor();
+  const bool mkldnn_input = input.is_mkldnn();
+  if (!packed_weight_.defined() ||
+      !(usable(input) || (mkldnn_input && input.scalar_type() == kFloat)) ||
+      input.dim() != 4 || input.size(1) != orig_weight_.size(1) * groups_ ||
+      input.numel() == 0) {
+    // at::conv2d also reports any shape error
+    Tensor output = at::conv2d(
+        mkldnn_input ? input.to_dense() : input,
+        orig_weight_, bias, stride_, padding_, dilation_, groups_);
+    if (relu) {
+      output = at::relu(output);
+    }
+    // an opaque input always gets an opaque output
+    return mkldnn_input ? output.to_mkldnn() : output;
+  }
+  // mkldnn_convolution keeps the layout of its input
+  const Tensor mkldnn_ready_input = mkldnn_input ? input : input.contiguous();
+  if (relu) {
+    return at::mkldnn_convolution_relu(
+        mkldnn_ready_input, packed_weight_, bias,
+        padding_, stride_, dilation_, groups_);
+  }
+  return at::mkldnn_convolution(
+      mkldnn_ready_input, packed_weight_, bias,
+      padding_, stride_, dilation_, groups_);
+}
+
+c10::intrusive_ptr<Conv2dOpContext> Conv2dOpContext::create_context(
+    Tensor&& weight,
+    c10::optional<Tensor>&& bias,
+    std::vector<int64_t>&& stride,
+    std::vector<int64_t>&& padding,
+    std::vector<int64_t>&& dilation,
+    int64_t groups) {
+  return c10::make_intrusive<Conv2dOpContext>(
+      std::move(weight),
+      std::move(bias),
+      std::move(stride),
+      std::move(padding),
+      std::move(dilation),
+      groups);
+}
+
+c10::intrusive_ptr<LinearOpContext> createLinearPrePackOpContext(
+    Tensor weight,
+    c10::optional<Tensor> bias) {
+  return LinearOpContext::create_context(std::move(weight), std::move(bias));
+}
+
+Tensor linear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<LinearOpContext>& op_context) {
+  return op_context->run(input);
+}
+
+c10::intrusive_ptr<Conv2dOpContext> createConv2dPrePackOpContext(
+    Tensor weight,
+    c10::optional<Tensor> bias,
+    std::vector<int64_t> stride,
+    std::vector<int64_t> padding,
+    std::vector<int64_t> dilation,
+    int64_t groups) {
+  return Conv2dOpContext::create_context(
+      std::move(weight),
+      std::move(bias),
+      std::move(stride),
+      std::move(padding),
+      std::move(dilation),
+      groups);
+}
+
+Tensor conv2d_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<Conv2dOpContext>& op_context) {
+  return op_context->run(input);
+}
+
+Tensor conv2d_relu_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<Conv2dOpContext>& op_context) {
+  return op_context->run(input, /*relu=*/true);
+}
+
+} // namespace cpu_prepacked
+} // namespace native
+} // namespace at
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <ATen/Tensor.h>
+
+namespace at {
+namespace native {
+namespace cpu_prepacked {
+
+// Note [CPU prepacked weights]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Eager fp32 linear and conv2d repack their weight inside MKL/OpenBLAS or
+// MKL-DNN on every call. The op contexts here do that work once, when
+// the context is created, and keep the packed weight for every later run:
+//
+// - LinearOpContext packs the weight with cblas_sgemm_pack and runs
+//   cblas_sgemm_compute. Without MKL it keeps a contiguous transposed copy
+//   of the weight, which is the layout gemm reads fastest.
+// - Conv2dOpContext reorders the weight into the blocked layout MKL-DNN
+//   picks for the convolution and runs mkldnn_convolution. Without MKL-DNN
+//   it keeps the weight as is.
+//
+// The contexts are for fp32 inference: like the XNNPACK ones, they do not
+// propagate gradients to the weight. Inputs that are not float CPU tensors,
+// or that require grad, go through the regular at::linear / at::conv2d
+// with the original weight, so a context always computes the same function
+// as the op it replaced. The original weight and bias are also what gets
+// serialized; loading repacks them.
+//
+// torch::jit::insertCpuPrePackedOps (torch/csrc/jit/passes/cpu_prepack.h)
+// puts these contexts into frozen modules, and
+// torch::jit::convertFrozenOpsToMKLDNN (torch/csrc/jit/passes/mkldnn_rewrite.h)
+// additionally runs the ops between them on opaque MKL-DNN tensors.
+
+using SerializationTypeLinearPrePack = std::tuple<
+    Tensor,
+    c10::optional<Tensor>>;
+using SerializationTypeConv2dPrePack = std::tuple<
+    Tensor,
+    c10::optional<Tensor>,
+    std::vector<int64_t>,
+    std::vector<int64_t>,
+    std::vector<int64_t>,
+    int64_t>;
+
+class LinearOpContext : public torch::jit::CustomClassHolder {
+ private:
+  Tensor orig_weight_;
+  c10::optional<Tensor> orig_bias_;
+  // cblas_sgemm_pack buffer when mkl_packed_, else the transposed weight
+  Tensor packed_weight_;
+  bool mkl_packed_ = false;
+
+ public:
+  LinearOpContext(Tensor&& weight, c10::optional<Tensor>&& bias);
+
+  SerializationTypeLinearPrePack unpack() {
+    return std::make_tuple(orig_weight_, orig_bias_);
+  }
+
+  Tensor run(const Tensor& input);
+
+  static c10::intrusive_ptr<LinearOpContext> create_context(
+      Tensor&& weight,
+      c10::optional<Tensor>&& bias);
+};
+
+class Conv2dOpContext : public torch::jit::CustomClassHolder {
+ private:
+  Tensor orig_weight_;
+  c10::optional<Tensor> orig_bias_;
+  std::vector<int64_t> stride_;
+  std::vector<int64_t> padding_;
+  std::vector<int64_t> dilation_;
+  int64_t groups_;
+  // MKL-DNN tensor in the layout the convolution wants; undefined when the
+  // weight could not be reordered
+  Tensor packed_weight_;
+
+ public:
+  Conv2dOpContext(
+      Tensor&& weight,
+      c10::optional<Tensor>&& bias,
+      std::vector<int64_t>&& stride,
+      std::vector<int64_t>&& padding,
+      std::vector<int64_t>&& dilation,
+      int64_t groups);
+
+  SerializationTypeConv2dPrePack unpack() {
+    return std::make_tuple(
+        orig_weight_, orig_bias_, stride_, padding_, dilation_, groups_);
+  }
+
+  Tensor run(const Tensor& input, bool relu = false);
+
+  static c10::intrusive_ptr<Conv2dOpContext> create_context(
+      Tensor&& weight,
+      c10::optional<Tensor>&& bias,
+      std::vector<int64_t>&& stride,
+      std::vector<int64_t>&& padding,
+      std::vector<int64_t>&& dilation,
+      int64_t groups);
+};
+
+c10::intrusive_ptr<LinearOpContext> createLinearPrePackOpContext(
+    Tensor weight,
+    c10::optional<Tensor> bias);
+
+Tensor linear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<LinearOpContext>& op_context);
+
+c10::intrusive_ptr<Conv2dOpContext> createConv2dPrePackOpContext(
+    Tensor weight,
+    c10::optional<Tensor> bias,
+    std::vector<int64_t> stride,
+    std::vector<int64_t> padding,
+    std::vector<int64_t> dilation,
+    int64_t groups);
+
+Tensor conv2d_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<Conv2dOpContext>& op_context);
+
+Tensor conv2d_relu_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<Conv2dOpContext>& op_context);
+
+} // namespace cpu_prepacked
+} // namespace native
+} // namespace at
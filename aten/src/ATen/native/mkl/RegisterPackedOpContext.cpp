@@ -0,0 +1,64 @@
+#include <torch/library.h>
+#include <ATen/native/mkl/PackedOpContext.h>
+#include <ATen/Tensor.h>
+#include <torch/custom_class.h>
+
+namespace at {
+namespace native {
+namespace cpu_prepacked {
+
+TORCH_LIBRARY(cpu_prepacked, m) {
+  m.class_<LinearOpContext>("LinearOpContext")
+    .def_pickle(
+        [](const c10::intrusive_ptr<LinearOpContext>& op_context)
+            -> SerializationTypeLinearPrePack { // __getstate__
+          return op_context->unpack();
+        },
+        [](SerializationTypeLinearPrePack state)
+            -> c10::intrusive_ptr<LinearOpContext> { // __setstate__
+          return createLinearPrePackOpContext(
+              std::move(std::get<0>(state)),
+              std::move(std::get<1>(state)));
+        });
+
+  m.class_<Conv2dOpContext>("Conv2dOpContext")
+    .def_pickle(
+        [](const c10::intrusive_ptr<Conv2dOpContext>& op_context)
+            -> SerializationTypeConv2dPrePack { // __getstate__
+          return op_context->unpack();
+        },
+        [](SerializationTypeConv2dPrePack state)
+            -> c10::intrusive_ptr<Conv2dOpContext> { // __setstate__
+          return createConv2dPrePackOpContext(
+              std::move(std::get<0>(state)),
+              std::move(std::get<1>(state)),
+              std::move(std::get<2>(state)),
+              std::move(std::get<3>(state)),
+              std::move(std::get<4>(state)),
+              std::move(std::get<5>(state)));
+        });
+
+  m.def("linear_prepack(Tensor W, Tensor? B=None) -> __torch__.torch.classes.cpu_prepacked.LinearOpContext");
+  m.def("linear_run(Tensor X, __torch__.torch.classes.cpu_prepacked.LinearOpContext W_prepack) -> Tensor Y");
+  m.def("conv2d_prepack(Tensor W, Tensor? B, int[2] stride, int[2] padding, int[2] dilation, int groups) -> __torch__.torch.classes.cpu_prepacked.Conv2dOpContext");
+  m.def("conv2d_run(Tensor X, __torch__.torch.classes.cpu_prepacked.Conv2dOpContext W_prepack) -> Tensor Y");
+  m.def("conv2d_relu_run(Tensor X, __torch__.torch.classes.cpu_prepacked.Conv2dOpContext W_prepack) -> Tensor Y");
+}
+
+TORCH_LIBRARY_IMPL(cpu_prepacked, CPU, m) {
+  m.impl("linear_prepack", TORCH_FN(createLinearPrePackOpContext));
+  m.impl("linear_run", TORCH_FN(linear_run));
+  m.impl("conv2d_prepack", TORCH_FN(createConv2dPrePackOpContext));
+  m.impl("conv2d_run", TORCH_FN(conv2d_run));
+  m.impl("conv2d_relu_run", TORCH_FN(conv2d_relu_run));
+}
+
+// Opaque MKL-DNN activations, see Note [CPU prepacked weights]
+TORCH_LIBRARY_IMPL(cpu_prepacked, MkldnnCPU, m) {
+  m.impl("conv2d_run", TORCH_FN(conv2d_run));
+  m.impl("conv2d_relu_run", TORCH_FN(conv2d_relu_run));
+}
+
+} // namespace cpu_prepacked
+} // namespace native
+} // namespace at
@@ -1,45 +1,21 @@
-#include <ATen/ATen.h>
-#include <ATen/NativeFunctions.h>
-#include <ATen/native/SpectralOpsUtils.h>
-#include <ATen/Config.h>
-
-#if !AT_MKL_ENABLED()
-
-namespace at { namespace native {
-
-Tensor _fft_mkl(const Tensor& input, int64_t signal_ndim,
-                bool complex_input, bool complex_output,
-                bool inverse, IntArrayRef checked_signal_sizes,
-                bool normalized, bool onesided,
-                IntArrayRef output_sizes) {
-  AT_ERROR("fft: ATen not compiled with MKL support");
-}
-
-}}
-
-#else // AT_MKL_ENABLED
-
 #include <ATen/ATen.h>
 #include <ATen/Config.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
 #include <ATen/Utils.h>
+#include <ATen/native/CPUFFTPlanCache.h>
+#include <ATen/native/SpectralOpsUtils.h>
 
 #include <algorithm>
 #include <vector>
 #include <numeric>
 #include <cmath>
 
-#include <mkl_dfti.h>
-#include <ATen/mkl/Exceptions.h>
-#include <ATen/mkl/Descriptors.h>
-#include <ATen/mkl/Limits.h>
-
-
 namespace at { namespace native {
 
-// In real-to-complex transform, MKL FFT only fills half of the values due to
+// In real-to-complex transform, MKL FFT (and the portable backend in
+// native/PocketFFT.cpp) only fills half of the values due to
 // conjugate symmetry. See native/SpectralUtils.h for more details.
 // The following structs are used to fill in the other half with symmetry in
 // case of real-to-complex transform with onesided=False flag.
@@ -144,6 +120,101 @@ static inline void _fft_fill_with_conjugate_symmetry_(Tensor& input,
   });
 }
 
+#if !AT_MKL_ENABLED()
+
+}} // namespace at::native
+
+#include <ATen/native/PocketFFT.h>
+
+namespace at { namespace native {
+
+// See Note [Portable CPU FFT] in native/PocketFFT.cpp
+Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
+                bool complex_input, bool complex_output,
+                bool inverse, IntArrayRef checked_signal_sizes,
+                bool normalized, bool onesided,
+                IntArrayRef output_sizes) {
+  Tensor output = _fft_pocketfft(self, signal_ndim, complex_input,
+                                 complex_output, inverse, checked_signal_sizes,
+                                 normalized, onesided, output_sizes);
+  // now if needed, fill out the other half using Hermitian symmetry dim
+  if (!complex_input && complex_output && !onesided && output.numel() > 0) {
+    auto size_last_signal_dim = checked_signal_sizes[signal_ndim - 1];
+    auto start_slice = infer_ft_real_to_complex_onesided_size(size_last_signal_dim);
+    _fft_fill_with_conjugate_symmetry_(output, signal_ndim, size_last_signal_dim, start_slice);
+  }
+  return output;
+}
+
+namespace detail {
+
+int64_t cpu_fft_get_plan_cache_max_size_impl() {
+  return pocketfft_plan_cache().max_size();
+}
+
+void cpu_fft_set_plan_cache_max_size_impl(int64_t max_size) {
+  pocketfft_plan_cache().resize(max_size);
+}
+
+int64_t cpu_fft_get_plan_cache_size_impl() {
+  return pocketfft_plan_cache().size();
+}
+
+void cpu_fft_clear_plan_cache_impl() {
+  pocketfft_plan_cache().clear();
+}
+
+} // namespace detail
+
+}} // namespace at::native
+
+#else // AT_MKL_ENABLED
+
+}} // namespace at::native
+
+#include <mkl_dfti.h>
+#include <ATen/mkl/Exceptions.h>
+#include <ATen/mkl/Descriptors.h>
+#include <ATen/mkl/Limits.h>
+
+namespace at { namespace native {
+
+namespace {
+
+// A committed descriptor, the value in the plan cache
+struct DftiPlan {
+  DftiDescriptor descriptor;
+  // serializes the computations of the threads sharing the descriptor
+  std::mutex mutex;
+};
+
+detail::CPUFFTParamsLRUCache<DftiPlan>& dfti_plan_cache() {
+  static detail::CPUFFTParamsLRUCache<DftiPlan> cache;
+  return cache;
+}
+
+} // namespace
+
+namespace detail {
+
+int64_t cpu_fft_get_plan_cache_max_size_impl() {
+  return dfti_plan_cache().max_size();
+}
+
+void cpu_fft_set_plan_cache_max_size_impl(int64_t max_size) {
+  dfti_plan_cache().resize(max_size);
+}
+
+int64_t cpu_fft_get_plan_cache_size_impl() {
+  return dfti_plan_cache().size();
+}
+
+void cpu_fft_clear_plan_cache_impl() {
+  dfti_plan_cache().clear();
+}
+
+} // namespace detail
+
 // MKL DFTI
 Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
                 bool complex_input, bool complex_output,
@@ -213,51 +284,63 @@ Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
   } else {
     signal_type = complex_output ? DFTI_COMPLEX : DFTI_REAL;
   }
-  // create descriptor with signal size
-  std::vector<MKL_LONG> mkl_signal_sizes(checked_signal_sizes.begin(), checked_signal_sizes.end());
-  DftiDescriptor descriptor;
-  descriptor.init(prec, signal_type, signal_ndim, mkl_signal_sizes.data());
-  // out of place FFT
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_PLACEMENT, DFTI_NOT_INPLACE));
-  // batch mode
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_NUMBER_OF_TRANSFORMS, batch));
-
-  auto istrides = input.strides();
-  auto ostrides = output.strides();
-  // batch dim stride, i.e., dist between each data
-  MKL_LONG idist = complex_input ? istrides[0] >> 1 : istrides[0];
-  MKL_LONG odist = complex_output ? ostrides[0] >> 1 : ostrides[0];
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_DISTANCE, idist));
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_DISTANCE, odist));
-  // signal strides
-  // first val is offset, set to zero (ignored)
-  std::vector<MKL_LONG> mkl_istrides(1 + signal_ndim, 0), mkl_ostrides(1 + signal_ndim, 0);
-  for (int64_t i = 1; i <= signal_ndim; i++) {
-    mkl_istrides[i] = complex_input ? istrides[i] >> 1 : istrides[i];
-    mkl_ostrides[i] = complex_output ? ostrides[i] >> 1 : ostrides[i];
-  }
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_STRIDES, mkl_istrides.data()));
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_STRIDES, mkl_ostrides.data()));
-  // if conjugate domain of real is involved, set standard CCE storage type
-  // this will become default in MKL in future
-  if (!complex_input || !complex_output) {
-    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX));
-  }
-  // rescale if needed by normalized flag or inverse transform
-  if (normalized || inverse) {
-    auto signal_numel = at::prod_intlist(checked_signal_sizes);
-    double double_scale;
-    if (normalized) {
-      double_scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
-    } else {
-      double_scale = 1.0 / static_cast<double>(signal_numel);
+  // Committing a descriptor costs much more than most transforms, so they
+  // are cached, see native/CPUFFTPlanCache.h
+  detail::CPUFFTParams params;
+  detail::setCPUFFTParams(&params, input, signal_ndim, complex_input,
+      complex_output, inverse, checked_signal_sizes, normalized, onesided,
+      /*with_layout=*/true);
+  auto plan = dfti_plan_cache().get_or_create(params, [&] {
+    // create descriptor with signal size
+    std::vector<MKL_LONG> mkl_signal_sizes(checked_signal_sizes.begin(), checked_signal_sizes.end());
+    auto new_plan = std::make_shared<DftiPlan>();
+    DftiDescriptor& descriptor = new_plan->descriptor;
+    descriptor.init(prec, signal_type, signal_ndim, mkl_signal_sizes.data());
+    // out of place FFT
+    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_PLACEMENT, DFTI_NOT_INPLACE));
+    // batch mode
+    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_NUMBER_OF_TRANSFORMS, batch));
+
+    auto istrides = input.strides();
+    auto ostrides = output.strides();
+    // batch dim stride, i.e., dist between each data
+    MKL_LONG idist = complex_input ? istrides[0] >> 1 : istrides[0];
+    MKL_LONG odist = complex_output ? ostrides[0] >> 1 : ostrides[0];
+    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_DISTANCE, idist));
+    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_DISTANCE, odist));
+    // signal strides
+    // first val is offset, set to zero (ignored)
+    std::vector<MKL_LONG> mkl_istrides(1 + signal_ndim, 0), mkl_ostrides(1 + signal_ndim, 0);
+    for (int64_t i = 1; i <= signal_ndim; i++) {
+      mkl_istrides[i] = complex_input ? istrides[i] >> 1 : istrides[i];
+      mkl_ostrides[i] = complex_output ? ostrides[i] >> 1 : ostrides[i];
     }
-    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(),
-      inverse ? DFTI_BACKWARD_SCALE : DFTI_FORWARD_SCALE,
-      prec == DFTI_DOUBLE ? double_scale : static_cast<float>(double_scale)));
-  }
-  // finalize
-  MKL_DFTI_CHECK(DftiCommitDescriptor(descriptor.get()));
+    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_STRIDES, mkl_istrides.data()));
+    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_STRIDES, mkl_ostrides.data()));
+    // if conjugate domain of real is involved, set standard CCE storage type
+    // this will become default in MKL in future
+    if (!complex_input || !complex_output) {
+      MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX));
+    }
+    // rescale if needed by normalized flag or inverse transform
+    if (normalized || inverse) {
+      auto signal_numel = at::prod_intlist(checked_signal_sizes);
+      double double_scale;
+      if (normalized) {
+        double_scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
+      } else {
+        double_scale = 1.0 / static_cast<double>(signal_numel);
+      }
+      MKL_DFTI_CHECK(DftiSetValue(descriptor.get(),
+        inverse ? DFTI_BACKWARD_SCALE : DFTI_FORWARD_SCALE,
+        prec == DFTI_DOUBLE ? double_scale : static_cast<float>(double_scale)));
+    }
+    // finalize
+    MKL_DFTI_CHECK(DftiCommitDescriptor(descriptor.get()));
+    return new_plan;
+  });
+  const DftiDescriptor& descriptor = plan->descriptor;
+  std::lock_guard<std::mutex> guard(plan->mutex);
   // run
   if (!inverse) {
     MKL_DFTI_CHECK(DftiComputeForward(descriptor.get(), input.data_ptr(), output.data_ptr()));
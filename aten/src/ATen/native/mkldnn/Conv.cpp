@@ -12,6 +12,12 @@ at::Tensor mkldnn_convolution(
   AT_ERROR("mkldnn_convolution_forward: ATen not compiled with MKLDNN support");
 }
 
+at::Tensor mkldnn_convolution_relu(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias,
+    IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups) {
+  AT_ERROR("mkldnn_convolution_relu: ATen not compiled with MKLDNN support");
+}
+
 at::Tensor mkldnn_convolution_backward_input(
     IntArrayRef input_size, const at::Tensor& grad_output, const at::Tensor& weight,
     IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups, bool bias_defined) {
@@ -38,21 +44,6 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> mkldnn_convolution_backward(
 #include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/ConvUtils.h>
 
-namespace {
-// Helper function for getting an ideep tensor out of an aten Tensor.
-// Note in case the aten Tensor is a dense tensor, the returned ideep
-// tensor is just a view of the storage of the aten dense tensor, so
-// caller needs to make sure the aten dense tensor's lifetime is
-// longer than the ideep tensor.
-inline ideep::tensor get_mkldnn_tensor(const at::Tensor& tensor) {
-  if (tensor.is_mkldnn()) {
-    return at::native::itensor_from_mkldnn(tensor);
-  } else {
-    return at::native::itensor_view_from_dense(tensor);
-  }
-}
-}
-
 namespace at { namespace native {
 
 ideep::tensor _mkldnn_convolution(
@@ -62,7 +53,8 @@ ideep::tensor _mkldnn_convolution(
     at::IntArrayRef padding,
     at::IntArrayRef stride,
     at::IntArrayRef dilation,
-    int64_t groups) {
+    int64_t groups,
+    const ideep::attr_t& attr = ideep::attr_t()) {
 
   auto kernel_size = w.get_dims();
 
@@ -82,7 +74,11 @@ ideep::tensor _mkldnn_convolution(
         {dilation.begin(), dilation.end()},
         {padding.begin(), padding.end()},
         {padding.begin(), padding.end()},
-        groups);
+        groups,
+        ideep::scale_t(),
+        ideep::scale_t(),
+        ideep::scale_t(),
+        attr);
   } else {
     ideep::convolution_forward::compute(
         x,
@@ -93,24 +89,31 @@ ideep::tensor _mkldnn_convolution(
         {dilation.begin(), dilation.end()},
         {padding.begin(), padding.end()},
         {padding.begin(), padding.end()},
-        groups);
+        groups,
+        ideep::scale_t(),
+        ideep::scale_t(),
+        ideep::scale_t(),
+        attr);
   }
   return y;
 }
 
-at::Tensor mkldnn_convolution(
+namespace {
+
+at::Tensor mkldnn_convolution_impl(
     const at::Tensor& input,
     const at::Tensor& weight,
     const at::Tensor& bias,
     IntArrayRef padding,
     IntArrayRef stride,
     IntArrayRef dilation,
-    int64_t groups) {
-  const ideep::tensor mkldnn_input = get_mkldnn_tensor(input);
-  const ideep::tensor mkldnn_weight = get_mkldnn_tensor(weight);
+    int64_t groups,
+    const ideep::attr_t& attr) {
+  const ideep::tensor mkldnn_input = itensor_from_tensor(input);
+  const ideep::tensor mkldnn_weight = itensor_from_tensor(weight);
   c10::optional<ideep::tensor> mkldnn_bias{c10::nullopt};
   if (bias.defined()) {
-    mkldnn_bias = get_mkldnn_tensor(bias);
+    mkldnn_bias = itensor_from_tensor(bias);
   }
 
   ideep::tensor mkldnn_output = _mkldnn_convolution(
@@ -120,7 +123,8 @@ at::Tensor mkldnn_convolution(
       padding,
       stride,
       dilation,
-      groups);
+      groups,
+      attr);
 
   if (input.is_mkldnn()) {
     return new_with_itensor_mkldnn(std::move(mkldnn_output), input.options());
@@ -130,12 +134,45 @@ at::Tensor mkldnn_convolution(
   }
 }
 
+} // namespace
+
+at::Tensor mkldnn_convolution(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias,
+    IntArrayRef padding,
+    IntArrayRef stride,
+    IntArrayRef dilation,
+    int64_t groups) {
+  return mkldnn_convolution_impl(
+      input, weight, bias, padding, stride, dilation, groups, ideep::attr_t());
+}
+
+at::Tensor mkldnn_convolution_relu(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias,
+    IntArrayRef padding,
+    IntArrayRef stride,
+    IntArrayRef dilation,
+    int64_t groups) {
+  return mkldnn_convolution_impl(
+      input,
+      weight,
+      bias,
+      padding,
+      stride,
+      dilation,
+      groups,
+      ideep::attr_t::fuse_relu());
+}
+
 Tensor mkldnn_convolution_backward_input(
     IntArrayRef input_size, const at::Tensor& grad_output, const at::Tensor& weight,
     IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups, bool bias_defined)
 {
-  auto mkldnn_grad_output = get_mkldnn_tensor(grad_output);
-  auto mkldnn_weight = get_mkldnn_tensor(weight);
+  auto mkldnn_grad_output = itensor_from_tensor(grad_output);
+  auto mkldnn_weight = itensor_from_tensor(weight);
 
   ideep::tensor mkldnn_grad_input;
   ideep::convolution_backward_data::compute(
@@ -157,8 +194,8 @@ std::tuple<at::Tensor, at::Tensor> mkldnn_convolution_backward_weights(
     IntArrayRef weight_size, const at::Tensor& grad_output, const at::Tensor& input,
     IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups, bool bias_defined)
 {
-  const ideep::tensor mkldnn_grad_output = get_mkldnn_tensor(grad_output);
-  const ideep::tensor mkldnn_input = get_mkldnn_tensor(input);
+  const ideep::tensor mkldnn_grad_output = itensor_from_tensor(grad_output);
+  const ideep::tensor mkldnn_input = itensor_from_tensor(input);
 
   ideep::tensor mkldnn_grad_weight, mkldnn_grad_bias;
   if (bias_defined) {
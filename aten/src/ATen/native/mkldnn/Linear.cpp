@@ -30,19 +30,28 @@ Tensor mkldnn_linear(
     const Tensor& bias) {
   TORCH_CHECK(self.dim() >= 2,
       "mkldnn_linear: input needs to has dim at least 2, input dim ", self.dim());
-  TORCH_CHECK(self.is_mkldnn(),
-      "mkldnn_linear: input needs to be mkldnn layout");
-  TORCH_CHECK(weight.is_mkldnn() && bias.is_mkldnn(),
-      "mkldnn_linear: weight and bias need to be mkldnn layout");
+  // Dense inputs, which the bfloat16 path of linear passes, are computed
+  // on views of their storage and give a dense output.
+  const bool is_dense = !self.is_mkldnn();
+  if (is_dense) {
+    TORCH_CHECK(!weight.is_mkldnn() && (!bias.defined() || !bias.is_mkldnn()),
+        "mkldnn_linear: weight and bias need to be dense for a dense input");
+  } else {
+    TORCH_CHECK(weight.is_mkldnn() && bias.is_mkldnn(),
+        "mkldnn_linear: weight and bias need to be mkldnn layout");
+  }
 
   // reshape first if input dim is greater than 2 and the reshape will cost a memory copy.
   auto self_reshaped = self.dim() > 2 ? self.reshape({-1, self.size(self.dim() - 1)}) : self;
-  const ideep::tensor x = itensor_from_mkldnn(self_reshaped);
-  const ideep::tensor w = itensor_from_mkldnn(weight);
+  const Tensor self_storage = is_dense ? self_reshaped.contiguous() : self_reshaped;
+  const Tensor weight_storage = is_dense ? weight.contiguous() : weight;
+  const ideep::tensor x = itensor_from_tensor(self_storage);
+  const ideep::tensor w = itensor_from_tensor(weight_storage);
 
   ideep::tensor y;
   if (bias.defined()) {
-    const ideep::tensor b = itensor_from_mkldnn(bias);
+    const Tensor bias_storage = is_dense ? bias.contiguous() : bias;
+    const ideep::tensor b = itensor_from_tensor(bias_storage);
     ideep::inner_product_forward::compute(x, w, b, y);
   } else {
     ideep::inner_product_forward::compute(x, w, y);
@@ -52,10 +61,14 @@ Tensor mkldnn_linear(
   std::vector<int64_t> output_size(input_size.begin(), input_size.end() - 1);
   output_size.push_back(weight.size(0));
 
+  Tensor output = new_with_itensor_mkldnn(std::move(y), self.options());
+  if (is_dense) {
+    output = mkldnn_to_dense(output);
+  }
   if (self.dim() > 2) {
-    return new_with_itensor_mkldnn(std::move(y), self.options()).reshape(output_size);
+    return output.reshape(output_size);
   }
-  return new_with_itensor_mkldnn(std::move(y), self.options());
+  return output;
 }
 
 } // namespace native
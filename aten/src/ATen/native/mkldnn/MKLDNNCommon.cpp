@@ -40,6 +40,17 @@ using IDeepTensorWrapperPtr = c10::intrusive_ptr<IDeepTensorWrapper>;
 using MKLDNNTensorImpl = OpaqueTensorImpl<IDeepTensorWrapperPtr>;
 using MKLDNNTensor = Tensor;
 
+ideep::tensor::data_type get_mkldnn_dtype(ScalarType type) {
+  switch (type) {
+    case ScalarType::Float:
+      return ideep::tensor::data_type::f32;
+    case ScalarType::BFloat16:
+      return ideep::tensor::data_type::bf16;
+    default:
+      TORCH_CHECK(false, "MKL-DNN tensors only support float and bfloat16, got ", type);
+  }
+}
+
 Tensor new_with_itensor_mkldnn(ideep::tensor&& it, const TensorOptions& options) {
   // NOTE: int32_t dims from ideep::tensor but sizes needs int64_t
   // TODO: support int64_t dims in ideep::tensor to avoid extra conversion
@@ -66,12 +77,21 @@ ideep::tensor itensor_view_from_dense(const Tensor& tensor) {
   TORCH_CHECK(
       tensor.layout() == Layout::Strided,
       "itensor_view_from_dense expects dense tensor input");
-  TORCH_CHECK(tensor.scalar_type() == ScalarType::Float,
-             "itensor_view_from_dense expects float tensor input");
+  TORCH_CHECK(
+      tensor.scalar_type() == ScalarType::Float ||
+          tensor.scalar_type() == ScalarType::BFloat16,
+      "itensor_view_from_dense expects float or bfloat16 tensor input");
   TORCH_INTERNAL_ASSERT(at::impl::variable_excluded_from_dispatch());
   return {{{tensor.sizes().cbegin(), tensor.sizes().cend()},
-           ideep::tensor::data_type::f32},
-          tensor.template data_ptr<float>()};
+           get_mkldnn_dtype(tensor.scalar_type())},
+          tensor.data_ptr()};
+}
+
+ideep::tensor itensor_from_tensor(const Tensor& tensor) {
+  if (tensor.is_mkldnn()) {
+    return itensor_from_mkldnn(tensor);
+  }
+  return itensor_view_from_dense(tensor);
 }
 }}
 
@@ -8,6 +8,10 @@
 
 namespace at { namespace native {
 
+// Mapping of the ScalarTypes MKL-DNN tensors support (float and bfloat16) to
+// ideep data types
+ideep::tensor::data_type get_mkldnn_dtype(ScalarType type);
+
 // Construct aten MKL-DNN tensor given an ideep tensor
 Tensor new_with_itensor_mkldnn(ideep::tensor&& it, const TensorOptions& options);
 
@@ -17,6 +21,11 @@ ideep::tensor& itensor_from_mkldnn(const Tensor& mkldnn_tensor);
 // Construct an `ideep::tensor` "view" from dense tensor, note the
 // ideep::tensor will share the underlying buffer
 ideep::tensor itensor_view_from_dense(const Tensor& tensor);
+
+// The `ideep::tensor` of an MKL-DNN tensor, or a view of a dense tensor (see
+// itensor_view_from_dense), so the caller needs to keep a dense tensor alive
+// for as long as it uses the ideep::tensor.
+ideep::tensor itensor_from_tensor(const Tensor& tensor);
 }}
 
 #endif // AT_MKLDNN_ENABLED
@@ -16,7 +16,8 @@ Tensor mkldnn_to_dense(const Tensor& mkldnn_tensor) {
     std::vector<int64_t>(dims.begin(), dims.end()),
     mkldnn_tensor.options().layout(c10::kStrided));
   if (stensor.is_empty()) return cpu_tensor;
-  auto pub_tensor = stensor.to_public(cpu_tensor.template data_ptr<float>());
+  auto pub_tensor = stensor.to_public(
+      cpu_tensor.data_ptr(), get_mkldnn_dtype(cpu_tensor.scalar_type()));
   cpu_tensor.as_strided_(dims, pub_tensor.get_strides());
   return cpu_tensor;
 }
@@ -26,8 +27,9 @@ Tensor dense_to_mkldnn(const Tensor& cpu_tensor) {
              "dense_to_mkldnn expects CPU tensor input");
   TORCH_CHECK(cpu_tensor.layout() == Layout::Strided,
              "dense_to_mkldnn expects strided tensor input");
-  TORCH_CHECK(cpu_tensor.scalar_type() == ScalarType::Float,
-             "dense_to_mkldnn expects float tensor input");
+  TORCH_CHECK(cpu_tensor.scalar_type() == ScalarType::Float ||
+                 cpu_tensor.scalar_type() == ScalarType::BFloat16,
+             "dense_to_mkldnn expects float or bfloat16 tensor input");
   TORCH_CHECK(cpu_tensor.dim() <= 5,
              "Can't convert cpu tensor with the number of dimensions > 5");
   // TODO: consider to convert non-contiguous tensor to `ideep::tensor` directly.
@@ -35,8 +37,8 @@ Tensor dense_to_mkldnn(const Tensor& cpu_tensor) {
   Tensor mkldnn_tensor = empty_mkldnn(cpu_tensor_cont.sizes(), cpu_tensor_cont.options());
   ideep::tensor& dtensor = itensor_from_mkldnn(mkldnn_tensor);
   dtensor.feed_from(dtensor.get_dims(),
-                    ideep::tensor::data_type::f32,
-                    (cpu_tensor_cont.template data_ptr<float>()));
+                    get_mkldnn_dtype(cpu_tensor_cont.scalar_type()),
+                    cpu_tensor_cont.data_ptr());
   return mkldnn_tensor;
 }
 
@@ -1,5 +1,6 @@
 #include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/Pool.h>
+#include <cpuinfo.h>
 
 namespace at { namespace native {
 
@@ -31,4 +32,9 @@ std::vector<int64_t> pool_output_sizes(
    return output_size;
 }
 
+bool mkldnn_bf16_device_check() {
+  return cpuinfo_initialize() && cpuinfo_has_x86_avx512bw() &&
+      cpuinfo_has_x86_avx512vl() && cpuinfo_has_x86_avx512dq();
+}
+
 }}
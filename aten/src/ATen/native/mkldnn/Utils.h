@@ -1,5 +1,6 @@
 #pragma once
 
+#include <c10/macros/Export.h>
 #include <c10/util/ArrayRef.h>
 #include <vector>
 
@@ -13,4 +14,8 @@ std::vector<int64_t> pool_output_sizes(
     IntArrayRef padding_r,
     IntArrayRef dilation,
     bool ceil_mode);
+
+// Whether MKL-DNN has bfloat16 kernels for this CPU, which it implements
+// with AVX512 (BW, VL and DQ).
+TORCH_API bool mkldnn_bf16_device_check();
 }}
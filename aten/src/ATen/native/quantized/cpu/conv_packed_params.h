@@ -13,6 +13,11 @@ struct ConvPackedParamsBase : public torch::jit::CustomClassHolder {
       const at::Tensor& input,
       double output_scale,
       int64_t output_zero_point) = 0;
+  // float -> float, with the activation quantized with qparams computed from
+  // its range on every call
+  virtual at::Tensor apply_dynamic(
+      const at::Tensor& input,
+      bool reduce_range) = 0;
 
   virtual std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() = 0;
 
@@ -2019,17 +2019,29 @@ void fake_quantize_tensor_kernel(
     int64_t quant_min,
     int64_t quant_max) {
   float inv_scale = 1.0f / sc;
+  const Vec256<float> inv_scale_vec(inv_scale);
+  const Vec256<float> scale_vec(sc);
+  const Vec256<float> zero_point_vec(z_point);
+  const Vec256<float> quant_min_vec(quant_min);
+  const Vec256<float> quant_max_vec(quant_max);
   auto iter = TensorIterator::unary_op(output, input);
-  cpu_kernel(iter, [&](float self) -> float {
-    return (std::fmin(
-                std::fmax(
-                    static_cast<int64_t>(
-                        z_point + std::nearbyint(self * inv_scale)),
-                    quant_min),
-                quant_max) -
-            z_point) *
-        sc;
-  });
+  cpu_kernel_vec(
+      iter,
+      [&](float self) -> float {
+        return (std::fmin(
+                    std::fmax(
+                        static_cast<int64_t>(
+                            z_point + std::nearbyint(self * inv_scale)),
+                        quant_min),
+                    quant_max) -
+                z_point) *
+            sc;
+      },
+      [&](Vec256<float> self) -> Vec256<float> {
+        auto q = (self * inv_scale_vec).round() + zero_point_vec;
+        return (vec256::clamp(q, quant_min_vec, quant_max_vec) - zero_point_vec) *
+            scale_vec;
+      });
 }
 
 void fake_quantize_grad_tensor_kernel(
@@ -2041,10 +2053,61 @@ void fake_quantize_grad_tensor_kernel(
     int64_t quant_min,
     int64_t quant_max) {
   float inv_scale = 1.0f / sc;
+  const Vec256<float> inv_scale_vec(inv_scale);
+  const Vec256<float> zero_point_vec(z_point);
+  const Vec256<float> quant_min_vec(quant_min);
+  const Vec256<float> quant_max_vec(quant_max);
   auto iter = TensorIterator::binary_op(input_grad, input, output_grad);
-  cpu_kernel(iter, [&](float x, float dy) -> float {
-    int64_t xq = static_cast<int64_t>(z_point + std::nearbyint(x * inv_scale));
-    return dy * (xq >= quant_min && xq <= quant_max);
+  cpu_kernel_vec(
+      iter,
+      [&](float x, float dy) -> float {
+        int64_t xq = static_cast<int64_t>(z_point + std::nearbyint(x * inv_scale));
+        return dy * (xq >= quant_min && xq <= quant_max);
+      },
+      [&](Vec256<float> x, Vec256<float> dy) -> Vec256<float> {
+        auto xq = (x * inv_scale_vec).round() + zero_point_vec;
+        return dy & (xq >= quant_min_vec) & (xq <= quant_max_vec);
+      });
+}
+
+// Fake quantizes a contiguous input and records which of its values fell
+// within [quant_min, quant_max], the only ones the gradient flows through, so
+// the backward pass needs neither the input nor the qparams.
+void fake_quantize_tensor_cachemask_kernel(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  using Vec = Vec256<float>;
+  const float inv_scale = 1.0f / sc;
+  const Vec inv_scale_vec(inv_scale);
+  const Vec scale_vec(sc);
+  const Vec zero_point_vec(z_point);
+  const Vec quant_min_vec(quant_min);
+  const Vec quant_max_vec(quant_max);
+  const float* input_data = input.data_ptr<float>();
+  float* output_data = output.data_ptr<float>();
+  bool* mask_data = mask.data_ptr<bool>();
+  at::parallel_for(0, input.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t i = begin;
+    __at_align32__ float q_lanes[Vec::size()];
+    for (; i + Vec::size() <= end; i += Vec::size()) {
+      auto q = (Vec::loadu(input_data + i) * inv_scale_vec).round() + zero_point_vec;
+      q.store(q_lanes);
+      for (int64_t k = 0; k < Vec::size(); k++) {
+        mask_data[i + k] = q_lanes[k] >= quant_min && q_lanes[k] <= quant_max;
+      }
+      ((vec256::clamp(q, quant_min_vec, quant_max_vec) - zero_point_vec) * scale_vec)
+          .store(output_data + i);
+    }
+    for (; i < end; i++) {
+      const int64_t q = static_cast<int64_t>(z_point + std::nearbyint(input_data[i] * inv_scale));
+      mask_data[i] = q >= quant_min && q <= quant_max;
+      output_data[i] = (std::min(std::max(q, quant_min), quant_max) - z_point) * sc;
+    }
   });
 }
 
@@ -2095,11 +2158,16 @@ void fake_quantize_learnable_zero_point_grad_tensor_kernel(
   });
 }
 
+// The per channel TensorIterators broadcast the scale and the zero point, so
+// their strides are 0 over an inner loop that stays within a channel, which
+// is the case the vectorized loops below handle. (That leaves out the inner
+// loops running across the channels, e.g. for axis = dim - 1.)
 void fake_quant_per_channel_cpu(
     TensorIterator& iter,
     int64_t quant_min,
     int64_t quant_max) {
-  cpu_kernel(iter, [=](float self, float scale, int64_t zero_point) -> float {
+  using Vec = Vec256<float>;
+  auto scalar_op = [=](float self, float scale, int64_t zero_point) -> float {
     float inv_scale = 1.0f / scale;
     return (std::fmin(
                 std::fmax(
@@ -2109,6 +2177,36 @@ void fake_quant_per_channel_cpu(
                 quant_max) -
             zero_point) *
         scale;
+  };
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == sizeof(float) && strides[1] == sizeof(float) &&
+        strides[2] == 0 && strides[3] == 0) {
+      float* out = reinterpret_cast<float*>(data[0]);
+      const float* self = reinterpret_cast<const float*>(data[1]);
+      const float scale = *reinterpret_cast<const float*>(data[2]);
+      const int64_t zero_point = *reinterpret_cast<const int64_t*>(data[3]);
+      const Vec inv_scale_vec(1.0f / scale);
+      const Vec scale_vec(scale);
+      const Vec zero_point_vec(zero_point);
+      const Vec quant_min_vec(quant_min);
+      const Vec quant_max_vec(quant_max);
+      int64_t i = 0;
+      for (; i + Vec::size() <= n; i += Vec::size()) {
+        auto q = (Vec::loadu(self + i) * inv_scale_vec + zero_point_vec).round();
+        ((vec256::clamp(q, quant_min_vec, quant_max_vec) - zero_point_vec) * scale_vec)
+            .store(out + i);
+      }
+      for (; i < n; i++) {
+        out[i] = scalar_op(self[i], scale, zero_point);
+      }
+      return;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<float*>(data[0] + i * strides[0]) = scalar_op(
+          *reinterpret_cast<float*>(data[1] + i * strides[1]),
+          *reinterpret_cast<float*>(data[2] + i * strides[2]),
+          *reinterpret_cast<int64_t*>(data[3] + i * strides[3]));
+    }
   });
 }
 
@@ -2116,13 +2214,101 @@ void fake_quant_grad_per_channel_cpu(
     TensorIterator& iter,
     int64_t quant_min,
     int64_t quant_max) {
-  cpu_kernel(
-      iter, [=](float x, float dy, float scale, int64_t zero_point) -> float {
-        float inv_scale = 1.0f / scale;
-        int64_t xq =
-            static_cast<int64_t>(zero_point + std::nearbyint(x * inv_scale));
-        return dy * (xq >= quant_min && xq <= quant_max);
-      });
+  using Vec = Vec256<float>;
+  auto scalar_op = [=](float x, float dy, float scale, int64_t zero_point) -> float {
+    float inv_scale = 1.0f / scale;
+    int64_t xq =
+        static_cast<int64_t>(zero_point + std::nearbyint(x * inv_scale));
+    return dy * (xq >= quant_min && xq <= quant_max);
+  };
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == sizeof(float) && strides[1] == sizeof(float) &&
+        strides[2] == sizeof(float) && strides[3] == 0 && strides[4] == 0) {
+      float* dx = reinterpret_cast<float*>(data[0]);
+      const float* x = reinterpret_cast<const float*>(data[1]);
+      const float* dy = reinterpret_cast<const float*>(data[2]);
+      const float scale = *reinterpret_cast<const float*>(data[3]);
+      const int64_t zero_point = *reinterpret_cast<const int64_t*>(data[4]);
+      const Vec inv_scale_vec(1.0f / scale);
+      const Vec zero_point_vec(zero_point);
+      const Vec quant_min_vec(quant_min);
+      const Vec quant_max_vec(quant_max);
+      int64_t i = 0;
+      for (; i + Vec::size() <= n; i += Vec::size()) {
+        auto xq = (Vec::loadu(x + i) * inv_scale_vec).round() + zero_point_vec;
+        (Vec::loadu(dy + i) & (xq >= quant_min_vec) & (xq <= quant_max_vec))
+            .store(dx + i);
+      }
+      for (; i < n; i++) {
+        dx[i] = scalar_op(x[i], dy[i], scale, zero_point);
+      }
+      return;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<float*>(data[0] + i * strides[0]) = scalar_op(
+          *reinterpret_cast<float*>(data[1] + i * strides[1]),
+          *reinterpret_cast<float*>(data[2] + i * strides[2]),
+          *reinterpret_cast<float*>(data[3] + i * strides[3]),
+          *reinterpret_cast<int64_t*>(data[4] + i * strides[4]));
+    }
+  });
+}
+
+// Per channel counterpart of fake_quantize_tensor_cachemask_kernel. The input
+// is contiguous, so each of its size_to_dim_(axis) * channels blocks of
+// size_from_dim_(axis + 1) values shares its qparams.
+void fake_quant_per_channel_cachemask_cpu(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    const Tensor& scale,
+    const Tensor& zero_point,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max) {
+  using Vec = Vec256<float>;
+  const int64_t channels = input.size(axis);
+  const int64_t batches = size_to_dim_(axis, input.sizes());
+  const int64_t elements_per_channel = size_from_dim_(axis + 1, input.sizes());
+  const float* input_data = input.data_ptr<float>();
+  const float* scale_data = scale.data_ptr<float>();
+  const int64_t* zero_point_data = zero_point.data_ptr<int64_t>();
+  float* output_data = output.data_ptr<float>();
+  bool* mask_data = mask.data_ptr<bool>();
+  const int64_t grain_size = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, elements_per_channel));
+  at::parallel_for(0, batches * channels, grain_size, [&](int64_t begin, int64_t end) {
+    __at_align32__ float q_lanes[Vec::size()];
+    for (int64_t block = begin; block < end; block++) {
+      const int64_t c = block % channels;
+      const float sc = scale_data[c];
+      const float inv_scale = 1.0f / sc;
+      const int64_t z_point = zero_point_data[c];
+      const Vec inv_scale_vec(inv_scale);
+      const Vec scale_vec(sc);
+      const Vec zero_point_vec(z_point);
+      const Vec quant_min_vec(quant_min);
+      const Vec quant_max_vec(quant_max);
+      const float* x = input_data + block * elements_per_channel;
+      float* y = output_data + block * elements_per_channel;
+      bool* m = mask_data + block * elements_per_channel;
+      int64_t i = 0;
+      for (; i + Vec::size() <= elements_per_channel; i += Vec::size()) {
+        auto q = (Vec::loadu(x + i) * inv_scale_vec + zero_point_vec).round();
+        q.store(q_lanes);
+        for (int64_t k = 0; k < Vec::size(); k++) {
+          m[i + k] = q_lanes[k] >= quant_min && q_lanes[k] <= quant_max;
+        }
+        ((vec256::clamp(q, quant_min_vec, quant_max_vec) - zero_point_vec) * scale_vec)
+            .store(y + i);
+      }
+      for (; i < elements_per_channel; i++) {
+        const int64_t q = static_cast<int64_t>(std::nearbyint(x[i] * inv_scale + z_point));
+        m[i] = q >= quant_min && q <= quant_max;
+        y[i] = (std::min(std::max(q, quant_min), quant_max) - z_point) * sc;
+      }
+    }
+  });
 }
 
 void fake_quantize_learnable_scale_grad_channel_kernel(
@@ -2532,7 +2718,9 @@ void dequantize_tensor_per_tensor_affine_cpu(
 }
 #endif // USE_FBGEMM
 
-// TODO: add fbgemm for per channel
+// The elements_per_channel values of every (batch, channel) block are
+// contiguous and share their qparams, so the blocks are quantized with the
+// vectorized quantize of Vec256<scalar_t>, like fbgemm does per tensor.
 void quantize_tensor_per_channel_affine_cpu(
     Tensor rtensor,
     Tensor qtensor,
@@ -2541,6 +2729,7 @@ void quantize_tensor_per_channel_affine_cpu(
     int64_t axis) {
   AT_DISPATCH_QINT_TYPES(
       qtensor.scalar_type(), "quantize_tensor_per_channel_affine_cpu", [&]() {
+        using Vec = Vec256<scalar_t>;
         int64_t batches = size_to_dim_(axis, rtensor.sizes());
         int64_t elements_per_channel =
             size_from_dim_(axis + 1, rtensor.sizes());
@@ -2549,16 +2738,30 @@ void quantize_tensor_per_channel_affine_cpu(
         auto zero_points_data = zero_points.data_ptr<int64_t>();
         const float* rdata = rtensor.data_ptr<float>();
         auto qdata = qtensor.data_ptr<scalar_t>();
-        for (auto b = 0; b < batches; ++b) {
-          for (auto c = 0; c < channel; ++c) {
-            for (auto e = 0; e < elements_per_channel; ++e) {
-              auto i = b * channel * elements_per_channel +
-                  c * elements_per_channel + e;
-              qdata[i] = quantize_val<scalar_t>(
-                  scales_data[c], zero_points_data[c], rdata[i]);
+        int64_t grain_size = std::max<int64_t>(
+            1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, elements_per_channel));
+        at::parallel_for(0, batches * channel, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t block = begin; block < end; ++block) {
+            const int64_t c = block % channel;
+            const float scale = scales_data[c];
+            const float inverse_scale = 1.0f / scale;
+            const int32_t zero_point = zero_points_data[c];
+            const float* src = rdata + block * elements_per_channel;
+            scalar_t* dst = qdata + block * elements_per_channel;
+            int64_t e = 0;
+            for (; e + Vec::size() <= elements_per_channel; e += Vec::size()) {
+              typename Vec::float_vec_return_type float_vals;
+              for (int i = 0; i < Vec::float_num_vecs(); ++i) {
+                float_vals[i] = Vec256<float>::loadu(src + e + i * Vec256<float>::size());
+              }
+              Vec::quantize(float_vals, scale, zero_point, inverse_scale).store(dst + e);
+            }
+            for (; e < elements_per_channel; ++e) {
+              dst[e] = quantize_val<scalar_t>(
+                  scales_data[c], zero_points_data[c], src[e]);
             }
           }
-        }
+        });
       });
 }
 
@@ -2570,6 +2773,7 @@ void dequantize_tensor_per_channel_affine_cpu(
     int64_t axis) {
   AT_DISPATCH_QINT_TYPES(
       qtensor.scalar_type(), "dequantize_tensor_per_channel_affine_cpu", [&]() {
+        using Vec = Vec256<scalar_t>;
         int64_t batches = size_to_dim_(axis, rtensor.sizes());
         int64_t elements_per_channel =
             size_from_dim_(axis + 1, rtensor.sizes());
@@ -2578,18 +2782,34 @@ void dequantize_tensor_per_channel_affine_cpu(
         auto zero_points_data = zero_points.data_ptr<int64_t>();
         const auto* qd = qtensor.data_ptr<scalar_t>();
         float* rd = rtensor.data_ptr<float>();
-        for (auto b = 0; b < batches; ++b) {
-          for (auto c = 0; c < channel; ++c) {
-            for (auto e = 0; e < elements_per_channel; ++e) {
-              auto i = b * channel * elements_per_channel +
-                  c * elements_per_channel + e;
+        int64_t grain_size = std::max<int64_t>(
+            1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, elements_per_channel));
+        at::parallel_for(0, batches * channel, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t block = begin; block < end; ++block) {
+            const int64_t c = block % channel;
+            const float scale = scales_data[c];
+            const float zero_point = zero_points_data[c];
+            const Vec256<float> scale_vec(scale);
+            const Vec256<float> zero_point_vec(zero_point);
+            const Vec256<float> scale_neg_zp_premul_vec(-zero_point * scale);
+            const scalar_t* src = qd + block * elements_per_channel;
+            float* dst = rd + block * elements_per_channel;
+            int64_t e = 0;
+            for (; e + Vec::size() <= elements_per_channel; e += Vec::size()) {
+              auto float_vals = Vec::loadu(src + e).dequantize(
+                  scale_vec, zero_point_vec, scale_neg_zp_premul_vec);
+              for (int i = 0; i < Vec::float_num_vecs(); ++i) {
+                float_vals[i].store(dst + e + i * Vec256<float>::size());
+              }
+            }
+            for (; e < elements_per_channel; ++e) {
               // We need to convert the qint8 value to float to ensure the
               // subtraction subexpression returns a float
-              rd[i] = (static_cast<float>(qd[i].val_) - zero_points_data[c]) *
+              dst[e] = (static_cast<float>(src[e].val_) - zero_points_data[c]) *
                   scales_data[c];
             }
           }
-        }
+        });
       });
 }
 
@@ -2630,10 +2850,12 @@ REGISTER_DISPATCH(qbatch_norm_stub, &q_batch_norm_kernel<false>);
 REGISTER_DISPATCH(qbatch_norm_relu_stub, &q_batch_norm_kernel<true>);
 REGISTER_DISPATCH(fake_quant_tensor_stub, &fake_quantize_tensor_kernel);
 REGISTER_DISPATCH(fake_quant_grad_tensor_stub, &fake_quantize_grad_tensor_kernel);
+REGISTER_DISPATCH(fake_quant_tensor_cachemask_stub, &fake_quantize_tensor_cachemask_kernel);
 REGISTER_DISPATCH(fake_quant_grad_learnable_scale_tensor_stub, &fake_quantize_learnable_scale_grad_tensor_kernel);
 REGISTER_DISPATCH(fake_quant_grad_learnable_zero_point_tensor_stub, &fake_quantize_learnable_zero_point_grad_tensor_kernel);
 REGISTER_DISPATCH(fake_quant_per_channel_stub, &fake_quant_per_channel_cpu);
 REGISTER_DISPATCH(fake_quant_grad_per_channel_stub, &fake_quant_grad_per_channel_cpu);
+REGISTER_DISPATCH(fake_quant_per_channel_cachemask_stub, &fake_quant_per_channel_cachemask_cpu);
 REGISTER_DISPATCH(fake_quant_grad_learnable_scale_channel_stub, &fake_quantize_learnable_scale_grad_channel_kernel);
 REGISTER_DISPATCH(fake_quant_grad_learnable_zero_point_channel_stub, &fake_quantize_learnable_zero_point_grad_channel_kernel);
 REGISTER_DISPATCH(
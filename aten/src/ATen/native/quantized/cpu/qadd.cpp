@@ -4,6 +4,8 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/quantized/Quantizer.h>
+#include <ATen/native/quantized/cpu/conv_packed_params.h>
+#include <ATen/native/quantized/cpu/packed_params.h>
 #include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
@@ -265,6 +267,65 @@ Tensor qadd_scalar_tensor_out(Tensor qa, Tensor b, Tensor out) {
   return qadd_scalar_out(qa, b.item(), out);
 }
 
+// Adds qother to y, the output of a conv or linear just computed at its own
+// quantization parameters. Apart from QNNPACK, which makes its own output, the
+// sum is written over y, so that the residual add of a block neither
+// allocates nor touches a second full size activation.
+template <bool ReLUFused = false>
+Tensor qadd_into(Tensor y, const Tensor& qother, double scale, int64_t zero_point) {
+  check_inputs(y, qother);
+  TORCH_CHECK(
+      y.sizes() == qother.sizes(),
+      "The tensor added to the conv or linear output must have its shape, got ",
+      qother.sizes(), " and ", y.sizes());
+#ifdef USE_PYTORCH_QNNPACK
+  if (at::globalContext().qEngine() == at::QEngine::QNNPACK &&
+      y.scalar_type() == kQUInt8 && qother.scalar_type() == kQUInt8) {
+    return qnnpack_add<ReLUFused>(y, qother, scale, zero_point);
+  }
+#endif
+  // The add kernel reads every element of y before it writes the sum over it,
+  // so an alias of y with the output quantizer works as the output.
+  Tensor out = y.alias();
+  out.set_quantizer_(
+      make_per_tensor_affine_quantizer(scale, zero_point, y.scalar_type()));
+  return _add_out<ReLUFused>(out, y, qother);
+}
+
+// conv2d followed by the add of qother, as in the residual blocks of ResNets.
+// The conv output is quantized with conv_scale and conv_zero_point, as it
+// would be before a separate quantized::add, so the results are the same.
+template <bool ReLUFused = false>
+Tensor qconv2d_add(
+    Tensor qx,
+    Tensor qother,
+    const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+    double conv_scale,
+    int64_t conv_zero_point,
+    double output_scale,
+    int64_t output_zero_point) {
+  return qadd_into<ReLUFused>(
+      packed_weight->apply(qx, conv_scale, conv_zero_point),
+      qother,
+      output_scale,
+      output_zero_point);
+}
+
+Tensor qlinear_add(
+    Tensor qx,
+    Tensor qother,
+    const c10::intrusive_ptr<LinearPackedParamsBase>& packed_weight,
+    double linear_scale,
+    int64_t linear_zero_point,
+    double output_scale,
+    int64_t output_zero_point) {
+  return qadd_into(
+      packed_weight->apply(std::move(qx), linear_scale, linear_zero_point),
+      qother,
+      output_scale,
+      output_zero_point);
+}
+
 TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl("add",                 TORCH_FN(qadd</*ReLUFused=*/false>));
   m.impl("add_relu",            TORCH_FN(qadd</*ReLUFused=*/true>));
@@ -278,6 +339,9 @@ TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl("add_scalar_relu.Tensor", TORCH_FN(qadd_scalar_tensor</*ReLUFused=*/true>));
   m.impl("add_scalar_out.Tensor", TORCH_FN(qadd_scalar_tensor_out</*ReLUFused=*/false>));
   m.impl("add_scalar_relu_out.Tensor", TORCH_FN(qadd_scalar_tensor_out</*ReLUFused=*/true>));
+  m.impl("conv2d_add",          TORCH_FN(qconv2d_add</*ReLUFused=*/false>));
+  m.impl("conv2d_add_relu",     TORCH_FN(qconv2d_add</*ReLUFused=*/true>));
+  m.impl("linear_add",          TORCH_FN(qlinear_add));
 }
 
 TORCH_LIBRARY_IMPL(_quantized, QuantizedCPU, m) {
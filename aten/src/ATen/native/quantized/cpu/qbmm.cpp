@@ -0,0 +1,256 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <torch/library.h>
+#include <ATen/quantized/Quantizer.h>
+#include <ATen/native/quantized/affine_quantizer.h>
+#include <ATen/native/quantized/cpu/fbgemm_utils.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Requantization parameters of C = A x B for every column of C: a single
+// entry for per tensor quantized B, one per column for B quantized per
+// channel along its last dim.
+struct QBmmParams {
+  std::vector<float> act_times_b_scale;
+  std::vector<float> output_multiplier;
+  std::vector<int32_t> b_zero_point;
+};
+
+QBmmParams make_qbmm_params(const Tensor& qa, const Tensor& qb, double output_scale) {
+  QBmmParams params;
+  const float a_scale = qa.q_scale();
+  if (qb.qscheme() == kPerTensorAffine) {
+    params.act_times_b_scale.push_back(a_scale * static_cast<float>(qb.q_scale()));
+    params.b_zero_point.push_back(qb.q_zero_point());
+  } else {
+    Tensor scales = qb.q_per_channel_scales().to(kFloat).contiguous();
+    Tensor zero_points = qb.q_per_channel_zero_points().to(kInt).contiguous();
+    const float* scales_data = scales.data_ptr<float>();
+    const int32_t* zero_points_data = zero_points.data_ptr<int32_t>();
+    for (int64_t n = 0; n < scales.numel(); n++) {
+      params.act_times_b_scale.push_back(a_scale * scales_data[n]);
+      params.b_zero_point.push_back(zero_points_data[n]);
+    }
+  }
+  for (float s : params.act_times_b_scale) {
+    params.output_multiplier.push_back(s / static_cast<float>(output_scale));
+  }
+  return params;
+}
+
+#ifdef USE_FBGEMM
+// fbgemm multiplies uint8 by int8, so B is shifted to int8 (b - 128) along
+// with its zero points. B is packed per batch: unlike a linear weight it is
+// an activation and changes with every call.
+void qbmm_fbgemm(
+    const Tensor& qa_contig,
+    const Tensor& qb_contig,
+    const QBmmParams& params,
+    Tensor& qc) {
+  const int64_t batch_size = qa_contig.size(0);
+  const int64_t M = qa_contig.size(1);
+  const int64_t K = qa_contig.size(2);
+  const int64_t N = qb_contig.size(2);
+  const bool per_channel = params.b_zero_point.size() > 1;
+  const uint8_t* a_data =
+      reinterpret_cast<const uint8_t*>(qa_contig.data_ptr<c10::quint8>());
+  const uint8_t* b_data =
+      reinterpret_cast<const uint8_t*>(qb_contig.data_ptr<c10::quint8>());
+  uint8_t* c_data = reinterpret_cast<uint8_t*>(qc.data_ptr<c10::quint8>());
+  const int32_t a_zero_point = qa_contig.q_zero_point();
+  const int32_t c_zero_point = qc.q_zero_point();
+  std::vector<int32_t> b_zero_point_int8(params.b_zero_point.size());
+  for (size_t i = 0; i < b_zero_point_int8.size(); i++) {
+    b_zero_point_int8[i] = params.b_zero_point[i] - 128;
+  }
+
+  at::parallel_for(0, batch_size, 1, [&](int64_t begin, int64_t end) {
+    std::vector<int8_t> b_int8(K * N);
+    std::vector<int32_t> col_offsets(N);
+    std::vector<int32_t> buffer(M * N);
+    for (int64_t b = begin; b < end; b++) {
+      const uint8_t* b_batch = b_data + b * K * N;
+      std::fill(col_offsets.begin(), col_offsets.end(), 0);
+      for (int64_t k = 0; k < K; k++) {
+        for (int64_t n = 0; n < N; n++) {
+          const int8_t value = static_cast<int8_t>(b_batch[k * N + n] ^ 0x80);
+          b_int8[k * N + n] = value;
+          col_offsets[n] += value;
+        }
+      }
+      for (int64_t n = 0; n < N; n++) {
+        col_offsets[n] -= b_zero_point_int8[per_channel ? n : 0] * K;
+      }
+
+      fbgemm::PackBMatrix<int8_t> packB(
+          /*trans=*/fbgemm::matrix_op_t::NoTranspose,
+          /*nRow=*/K,
+          /*nCol=*/N,
+          /*smat=*/b_int8.data(),
+          /*ld=*/N,
+          /*pmat=*/nullptr,
+          /*groups=*/1);
+      fbgemm::PackAWithRowOffset<uint8_t> packA(
+          /*trans=*/fbgemm::matrix_op_t::NoTranspose,
+          /*nRow=*/M,
+          /*nCol=*/K,
+          /*smat=*/a_data + b * M * K,
+          /*ld=*/K,
+          /*pmat=*/nullptr);
+      fbgemm::DoNothing<> doNothingObj{};
+
+      if (per_channel) {
+        fbgemm::ReQuantizeOutput<
+            /*FUSE_RELU=*/false,
+            fbgemm::QuantizationGranularity::OUT_CHANNEL,
+            float>
+            outputProcObj(
+                doNothingObj,
+                params.output_multiplier.data(),
+                c_zero_point,
+                a_zero_point,
+                b_zero_point_int8.data(),
+                packA.getRowOffsetBuffer(),
+                col_offsets.data(),
+                /*bias=*/nullptr,
+                N, /* nCol */
+                1 /* groups */,
+                params.act_times_b_scale.data());
+        fbgemm::fbgemmPacked(
+            packA, packB, c_data + b * M * N, buffer.data(), N, outputProcObj,
+            /*thread_id=*/0, /*num_threads=*/1);
+      } else {
+        fbgemm::ReQuantizeOutput<
+            /*FUSE_RELU=*/false,
+            fbgemm::QuantizationGranularity::TENSOR,
+            float>
+            outputProcObj(
+                doNothingObj,
+                params.output_multiplier.data(),
+                c_zero_point,
+                a_zero_point,
+                b_zero_point_int8.data(),
+                packA.getRowOffsetBuffer(),
+                col_offsets.data(),
+                /*bias=*/nullptr,
+                N, /* nCol */
+                1 /* groups */,
+                params.act_times_b_scale.data());
+        fbgemm::fbgemmPacked(
+            packA, packB, c_data + b * M * N, buffer.data(), N, outputProcObj,
+            /*thread_id=*/0, /*num_threads=*/1);
+      }
+    }
+  });
+}
+#endif // USE_FBGEMM
+
+// Integer reference: accumulates (a - a_zp) * (b - b_zp) in int32 for a row
+// of C, then requantizes the row.
+void qbmm_reference(
+    const Tensor& qa_contig,
+    const Tensor& qb_contig,
+    const QBmmParams& params,
+    Tensor& qc) {
+  const int64_t batch_size = qa_contig.size(0);
+  const int64_t M = qa_contig.size(1);
+  const int64_t K = qa_contig.size(2);
+  const int64_t N = qb_contig.size(2);
+  const bool per_channel = params.b_zero_point.size() > 1;
+  const uint8_t* a_data =
+      reinterpret_cast<const uint8_t*>(qa_contig.data_ptr<c10::quint8>());
+  const uint8_t* b_data =
+      reinterpret_cast<const uint8_t*>(qb_contig.data_ptr<c10::quint8>());
+  c10::quint8* c_data = qc.data_ptr<c10::quint8>();
+  const int32_t a_zero_point = qa_contig.q_zero_point();
+  const int64_t c_zero_point = qc.q_zero_point();
+
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, K * N));
+  at::parallel_for(0, batch_size * M, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<int32_t> acc(N);
+    for (int64_t row = begin; row < end; row++) {
+      const int64_t b = row / M;
+      const uint8_t* a = a_data + row * K;
+      const uint8_t* b_batch = b_data + b * K * N;
+      std::fill(acc.begin(), acc.end(), 0);
+      for (int64_t k = 0; k < K; k++) {
+        const int32_t a_value = int32_t(a[k]) - a_zero_point;
+        const uint8_t* b_row = b_batch + k * N;
+        if (per_channel) {
+          for (int64_t n = 0; n < N; n++) {
+            acc[n] += a_value * (int32_t(b_row[n]) - params.b_zero_point[n]);
+          }
+        } else {
+          const int32_t b_zero_point = params.b_zero_point[0];
+          for (int64_t n = 0; n < N; n++) {
+            acc[n] += a_value * (int32_t(b_row[n]) - b_zero_point);
+          }
+        }
+      }
+      c10::quint8* c = c_data + row * N;
+      for (int64_t n = 0; n < N; n++) {
+        c[n] = requantize_from_int<c10::quint8>(
+            params.output_multiplier[per_channel ? n : 0], c_zero_point, acc[n]);
+      }
+    }
+  });
+}
+
+// C = A x B for batches of matrices, uint8 * uint8 -> uint8. A is quantized
+// per tensor; B either per tensor or per channel along its last dim, in which
+// case every column of C is requantized with its own multiplier. This covers
+// both products of an attention layer (Q x K^T and softmax(.) x V).
+Tensor quantized_bmm(
+    const Tensor& qa,
+    const Tensor& qb,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(qa.dim() == 3 && qb.dim() == 3,
+              "quantized::bmm: expected 3-D tensors, but got ", qa.dim(), "-D and ", qb.dim(), "-D");
+  TORCH_CHECK(qa.scalar_type() == kQUInt8 && qb.scalar_type() == kQUInt8,
+              "quantized::bmm: expected quint8 inputs");
+  TORCH_CHECK(qa.qscheme() == kPerTensorAffine,
+              "quantized::bmm: only per tensor quantization is supported for the first input");
+  TORCH_CHECK(qb.qscheme() == kPerTensorAffine ||
+                  (qb.qscheme() == kPerChannelAffine && qb.q_per_channel_axis() == 2),
+              "quantized::bmm: the second input must be quantized per tensor or per channel along its last dim");
+  TORCH_CHECK(qa.size(0) == qb.size(0) && qa.size(2) == qb.size(1),
+              "quantized::bmm: cannot multiply ", qa.sizes(), " by ", qb.sizes());
+
+  Tensor qc = at::_empty_affine_quantized(
+      {qa.size(0), qa.size(1), qb.size(2)},
+      qa.options(),
+      output_scale,
+      output_zero_point);
+  if (qc.numel() == 0) {
+    return qc;
+  }
+  Tensor qa_contig = qa.contiguous();
+  Tensor qb_contig = qb.contiguous();
+  const QBmmParams params = make_qbmm_params(qa, qb, output_scale);
+
+#ifdef USE_FBGEMM
+  if (at::globalContext().qEngine() == at::QEngine::FBGEMM &&
+      qa.size(2) > 0 && fbgemm::fbgemmSupportedCPU()) {
+    qbmm_fbgemm(qa_contig, qb_contig, params, qc);
+    return qc;
+  }
+#endif // USE_FBGEMM
+  qbmm_reference(qa_contig, qb_contig, params, qc);
+  return qc;
+}
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
+  m.impl("bmm", TORCH_FN(quantized_bmm));
+}
+
+} // namespace
+
+}} // namespace at::native
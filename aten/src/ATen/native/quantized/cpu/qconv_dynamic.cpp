@@ -0,0 +1,142 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <torch/library.h>
+#include <ATen/native/quantized/cpu/conv_packed_params.h>
+#include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cpu/quant_utils.h>
+
+#include <algorithm>
+
+// Dynamic quantization of convolutions, the counterpart of
+// qlinear_dynamic.cpp: the activation is quantized to uint8 with qparams
+// computed from its range on every call, so no calibration is needed, and the
+// output is dequantized back to float. The int8 convolution in between is
+// the static one, requantizing its int32 accumulators with the qparams of the
+// input.
+
+#ifdef USE_FBGEMM
+template <int kSpatialDim>
+at::Tensor PackedConvWeight<kSpatialDim>::apply_dynamic(
+    const at::Tensor& input,
+    bool reduce_range) {
+  // We make a strong guarantee that models using these operators will have
+  // the same numerics across different machines. Therefore, we do not provide
+  // a fallback path and rather fail loudly if we cannot run FBGEMM.
+  TORCH_CHECK(
+      fbgemm::fbgemmSupportedCPU(), "Your CPU does not support FBGEMM.");
+  TORCH_CHECK(
+      input.scalar_type() == c10::kFloat,
+      "quantized::conv", kSpatialDim, "d_dynamic: expected a float input");
+
+  auto input_contig = input.contiguous();
+  float x_min = 0;
+  float x_max = 0;
+  if (input_contig.numel() > 0) {
+    fbgemm::FindMinMax(
+        /*m=*/input_contig.data_ptr<float>(),
+        /*min=*/&x_min,
+        /*max=*/&x_max,
+        /*len=*/input_contig.numel());
+  }
+
+  // Input tensor is quantized as 8-bit unsigned values
+  auto q_params = quant_utils::ChooseQuantizationParams(
+      /*min=*/x_min,
+      /*max=*/x_max,
+      /*qmin=*/0,
+      /*qmax=*/255,
+      /*preserve_sparsity=*/false,
+      /*force_scale_power_of_two=*/false,
+      /*reduce_range=*/reduce_range);
+
+  at::Tensor q_input = at::quantize_per_tensor(
+      input_contig, q_params.scale, q_params.zero_point, c10::kQUInt8);
+  at::Tensor output = apply(q_input, q_params.scale, q_params.zero_point);
+  return output.dequantize();
+}
+
+template at::Tensor PackedConvWeight<2>::apply_dynamic(
+    const at::Tensor& input,
+    bool reduce_range);
+
+template at::Tensor PackedConvWeight<3>::apply_dynamic(
+    const at::Tensor& input,
+    bool reduce_range);
+
+#endif // USE_FBGEMM
+
+#ifdef USE_PYTORCH_QNNPACK
+template <int kSpatialDim>
+at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_dynamic(
+    const at::Tensor& input,
+    bool /* reduce_range */) {
+  TORCH_CHECK(
+      input.scalar_type() == c10::kFloat,
+      "quantized::conv", kSpatialDim, "d_dynamic: expected a float input");
+
+  auto input_contig = input.contiguous();
+  float x_min = 0;
+  float x_max = 0;
+  if (input_contig.numel() > 0) {
+    x_min = input_contig.min().item<float>();
+    x_max = input_contig.max().item<float>();
+  }
+
+  // QNNPACK does not need the reduced range, its kernels do not saturate
+  auto q_params = quant_utils::ChooseQuantizationParams(
+      /*min=*/x_min,
+      /*max=*/x_max,
+      /*qmin=*/0,
+      /*qmax=*/255);
+
+  at::Tensor q_input = at::quantize_per_tensor(
+      input_contig, q_params.scale, q_params.zero_point, c10::kQUInt8);
+  at::Tensor output = apply(q_input, q_params.scale, q_params.zero_point);
+  return output.dequantize();
+}
+
+template at::Tensor PackedConvWeightsQnnp<2>::apply_dynamic(
+    const at::Tensor& input,
+    bool reduce_range);
+
+#endif // USE_PYTORCH_QNNPACK
+
+namespace at {
+namespace native {
+namespace {
+
+template <int kSpatialDim>
+class QConvDynamicInt8 final {
+ public:
+  static at::Tensor run(
+      at::Tensor input,
+      const c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>>& packed_weight,
+      bool reduce_range) {
+    return packed_weight->apply_dynamic(input, reduce_range);
+  }
+};
+
+class QConv1dDynamicInt8 final {
+ public:
+  static at::Tensor run(
+      at::Tensor input,
+      const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+      bool reduce_range) {
+    // N, C, L -> N, C, 1, L
+    input = input.unsqueeze(quant_utils::kConv1dSqueezeDim + 2);
+    at::Tensor output = packed_weight->apply_dynamic(input, reduce_range);
+    // N, C, 1, L -> N, C, L
+    return output.squeeze_(quant_utils::kConv1dSqueezeDim + 2);
+  }
+};
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("conv1d_dynamic", TORCH_FN(QConv1dDynamicInt8::run));
+  m.impl("conv2d_dynamic", TORCH_FN(QConvDynamicInt8<2>::run));
+  m.impl("conv3d_dynamic", TORCH_FN(QConvDynamicInt8<3>::run));
+}
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -8,292 +8,421 @@
 
 #include <ATen/Parallel.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
 namespace at {
 namespace native {
 
-Tensor embedding_bag_byte_rowwise_offsets(
+namespace {
+
+const int64_t MODE_SUM = 0;
+const int64_t MODE_MEAN = 1;
+const int64_t MODE_MAX = 2;
+
+// Note [Fused rowwise quantized EmbeddingBag]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// All the quantized embedding_bag ops run through embedding_bag_nbit_impl.
+// The prepack ops in qembeddingbag_prepack.cpp fuse the scale and bias of
+// every row into the row itself:
+//
+//   8-bit:    | D uint8 values                 | fp32 scale | fp32 bias |
+//   4/2-bit:  | D * bit_width / 8 bytes packed | fp16 scale | fp16 bias |
+//
+// with lower bits holding the lower columns in the sub-byte formats.
+//
+// With pruning (sparse=True), rows were removed from the table and the
+// indices refer to the unpruned table. compressed_indices_mapping maps an
+// unpruned row to its row in the table, or to -1 if it was pruned, in which
+// case it contributes nothing (it still counts towards the bag size for
+// mode='mean', as the row was there before pruning).
+//
+// The FBGEMM kernels are JIT compiled for the instruction set of the machine
+// (AVX2/AVX-512) and cover mode='sum' and mode='mean', except for pruned
+// 8-bit tables. Everything else goes through embedding_bag_nbit_reference,
+// which is parallelized over bags like the FBGEMM calls are.
+
+int64_t embedding_dim_from_packed_cols(int64_t bit_width, int64_t packed_cols) {
+  if (bit_width == 8) {
+    // NB: -8 to account for the fp32 scale and bias
+    return packed_cols - 2 * sizeof(float);
+  }
+  // NB: the last 4 bytes are the fp16 scale and bias
+  return (packed_cols - 2 * sizeof(at::Half)) * (8 / bit_width);
+}
+
+template <int BIT_WIDTH>
+inline void dequantize_row_scale_bias(
+    const uint8_t* row, int64_t D, float* scale, float* bias) {
+  if (BIT_WIDTH == 8) {
+    const float* scale_bias = reinterpret_cast<const float*>(row + D);
+    *scale = scale_bias[0];
+    *bias = scale_bias[1];
+  } else {
+    constexpr int NUM_ELEM_PER_BYTE = 8 / BIT_WIDTH;
+    const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+        row + (D + NUM_ELEM_PER_BYTE - 1) / NUM_ELEM_PER_BYTE);
+    *scale = scale_bias[0];
+    *bias = scale_bias[1];
+  }
+}
+
+template <int BIT_WIDTH>
+inline float quantized_value(const uint8_t* row, int64_t j) {
+  if (BIT_WIDTH == 8) {
+    return row[j];
+  }
+  constexpr int NUM_ELEM_PER_BYTE = 8 / BIT_WIDTH;
+  return (row[j / NUM_ELEM_PER_BYTE] >> ((j % NUM_ELEM_PER_BYTE) * BIT_WIDTH)) &
+      ((1 << BIT_WIDTH) - 1);
+}
+
+// offsets has output_size + 1 entries, the last one being the number of
+// indices.
+template <int BIT_WIDTH>
+void embedding_bag_nbit_reference(
+    const uint8_t* weight_data,
+    int64_t num_rows,
+    int64_t row_bytes,
+    int64_t D,
+    const int64_t* indices_data,
+    const int64_t* offsets_data,
+    int64_t output_size,
+    int64_t mode,
+    const float* per_sample_weights_data,
+    const int32_t* compressed_indices_mapping_data,
+    int64_t compressed_index_size,
+    float* output_data) {
+  int64_t index_size = offsets_data[output_size];
+  int64_t avg_bag_size = index_size / std::max<int64_t>(output_size, 1);
+  int64_t grain_size = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, avg_bag_size * D));
+
+  at::parallel_for(0, output_size, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t m = start; m < end; ++m) {
+      float* out = output_data + m * D;
+      const float init =
+          mode == MODE_MAX ? -std::numeric_limits<float>::infinity() : 0.f;
+      std::fill(out, out + D, init);
+      bool found = false;
+
+      for (int64_t i = offsets_data[m]; i < offsets_data[m + 1]; ++i) {
+        int64_t idx = indices_data[i];
+        if (compressed_indices_mapping_data) {
+          TORCH_CHECK(
+              idx >= 0 && idx < compressed_index_size,
+              "embedding_bag: index ", idx, " is out of bounds for the ",
+              compressed_index_size, " rows of the unpruned table");
+          idx = compressed_indices_mapping_data[idx];
+          if (idx == -1) {
+            continue;
+          }
+        }
+        TORCH_CHECK(
+            idx >= 0 && idx < num_rows,
+            "embedding_bag: index ", idx, " is out of bounds for the ",
+            num_rows, " rows of the table");
+        found = true;
+
+        const uint8_t* row = weight_data + idx * row_bytes;
+        float scale, bias;
+        dequantize_row_scale_bias<BIT_WIDTH>(row, D, &scale, &bias);
+        if (mode == MODE_MAX) {
+          for (int64_t j = 0; j < D; ++j) {
+            out[j] = std::max(
+                out[j], std::fma(scale, quantized_value<BIT_WIDTH>(row, j), bias));
+          }
+        } else {
+          if (per_sample_weights_data) {
+            scale *= per_sample_weights_data[i];
+            bias *= per_sample_weights_data[i];
+          }
+          for (int64_t j = 0; j < D; ++j) {
+            out[j] = std::fma(scale, quantized_value<BIT_WIDTH>(row, j), out[j] + bias);
+          }
+        }
+      }
+
+      if (mode == MODE_MAX && !found) {
+        // like embedding_bag, an empty bag is all zeros
+        std::fill(out, out + D, 0.f);
+      } else if (mode == MODE_MEAN) {
+        int64_t bag_size = offsets_data[m + 1] - offsets_data[m];
+        if (bag_size > 0) {
+          for (int64_t j = 0; j < D; ++j) {
+            out[j] /= bag_size;
+          }
+        }
+      }
+    }
+  });
+}
+
+#ifdef USE_FBGEMM
+template <typename OffsetType>
+std::vector<OffsetType> offsets_with_end(const Tensor& offsets, int64_t index_size, bool include_last_offset) {
+  auto offsets_contig = offsets.to(kLong).contiguous();
+  const int64_t* data = offsets_contig.data_ptr<int64_t>();
+  std::vector<OffsetType> result(data, data + offsets.numel());
+  if (!include_last_offset) {
+    result.push_back(index_size);
+  }
+  return result;
+}
+#endif
+
+Tensor embedding_bag_nbit_impl(
+    int64_t bit_width,
     const Tensor& weight,
-    const Tensor& indices,
+    const Tensor& indices_,
     const Tensor& offsets,
-    const bool /* scale_grad_by_freq */,
-    const int64_t /* mode */,
-    bool /* sparse */,
+    int64_t mode,
+    bool pruned_weights,
     const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
     bool include_last_offset) {
-  TORCH_CHECK(weight.scalar_type() == at::kByte);
-  TORCH_CHECK(weight.ndimension() == 2);
-  auto offsets_data = offsets.data_ptr<int64_t>();
-  const auto weight_data = weight.data_ptr<uint8_t>();
-  const auto indices_data = indices.data_ptr<int64_t>();
+  TORCH_CHECK(weight.scalar_type() == at::kByte, "embedding_bag: expected a prepacked uint8 weight");
+  TORCH_CHECK(weight.dim() == 2, "embedding_bag: expected a 2-D weight");
+  TORCH_CHECK(indices_.dim() == 1, "embedding_bag: expected 1-D indices");
+  TORCH_CHECK(offsets.dim() == 1, "embedding_bag: expected 1-D offsets");
+  TORCH_CHECK(
+      mode == MODE_SUM || mode == MODE_MEAN || mode == MODE_MAX,
+      "embedding_bag: unknown mode ", mode);
+  TORCH_CHECK(
+      !per_sample_weights_.has_value() || mode == MODE_SUM,
+      "embedding_bag: per_sample_weights only supported with mode='sum'");
+  if (include_last_offset) {
+    TORCH_CHECK(
+        offsets.size(0) >= 1,
+        "include_last_offset: number of offset should be at least 1");
+  }
 
+  const Tensor weight_contig = weight.contiguous();
+  const Tensor indices = indices_.to(kLong).contiguous();
+  const uint8_t* weight_data = weight_contig.data_ptr<uint8_t>();
+  const int64_t* indices_data = indices.data_ptr<int64_t>();
   const int64_t N = weight.size(0);
-  const int64_t D = weight.size(1) - 8; // NB: -8 to account for scale and bias
-  const int64_t M = offsets.size(0);
-
-  int64_t output_size = M - 1;
-  std::vector<int64_t> offsets_include_last;
+  const int64_t row_bytes = weight.size(1);
+  const int64_t D = embedding_dim_from_packed_cols(bit_width, row_bytes);
+  const int64_t index_size = indices.numel();
+  const int64_t output_size =
+      include_last_offset ? offsets.size(0) - 1 : offsets.size(0);
+
+  Tensor per_sample_weights;
+  const float* per_sample_weights_data = nullptr;
+  if (per_sample_weights_.has_value()) {
+    per_sample_weights = per_sample_weights_.value().to(kFloat).contiguous();
+    TORCH_CHECK(
+        per_sample_weights.numel() == index_size,
+        "embedding_bag: expected one per_sample_weight per index");
+    per_sample_weights_data = per_sample_weights.data_ptr<float>();
+  }
 
-  if (!include_last_offset) {
-    output_size = M;
-    offsets_include_last.resize(M + 1);
-    std::memcpy(offsets_include_last.data(), offsets.data_ptr<int64_t>(),
-      sizeof(int64_t) * M);
-    offsets_include_last[M] = indices.numel();
-    offsets_data = offsets_include_last.data();
+  Tensor mapping;
+  const int32_t* compressed_indices_mapping_data = nullptr;
+  int64_t compressed_index_size = 0;
+  if (pruned_weights) {
+    TORCH_CHECK(
+        compressed_indices_mapping.has_value(),
+        "embedding_bag: compressed_indices_mapping is required for pruned weights (sparse=True)");
+    mapping = compressed_indices_mapping.value().to(kInt).contiguous();
+    compressed_index_size = mapping.numel();
+    compressed_indices_mapping_data = mapping.data_ptr<int32_t>();
   }
 
-  std::vector<int64_t> shape = {output_size, D};
-  auto output = at::empty(shape, weight.options().dtype(at::kFloat));
-  auto* output_data = output.data_ptr<float>();
+  auto output = at::empty({output_size, D}, weight.options().dtype(at::kFloat));
+  float* output_data = output.data_ptr<float>();
+  if (output_size == 0 || D == 0) {
+    return output;
+  }
 
 #ifdef USE_FBGEMM
-
-  auto kernel_i8_i64 =
-    fbgemm::GenerateEmbeddingSpMDM<uint8_t, int64_t, int64_t>(
-      /*block_size=*/D,
-      /*has_weight=*/per_sample_weights_.has_value(),
-      /*normalize_by_lengths=*/false,
-      /*prefetch=*/16, // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-      /*is_weight_positional=*/false,
-      /*use_offsets=*/true
-    );
-
-  if (weight.is_contiguous()) {
-    at::parallel_for(0, output_size, 1,
-      [&](int64_t start_idx, int64_t end_idx) {
-        bool success = kernel_i8_i64(
+  constexpr int prefetch_distance = 16;
+  const bool fbgemm_mode = mode == MODE_SUM || mode == MODE_MEAN;
+  if (fbgemm_mode && bit_width == 8 && !pruned_weights) {
+    auto offsets_data = offsets_with_end<int64_t>(offsets, index_size, include_last_offset);
+    auto kernel_i8_i64 =
+        fbgemm::GenerateEmbeddingSpMDM<uint8_t, int64_t, int64_t>(
+            /*block_size=*/D,
+            /*has_weight=*/per_sample_weights_data != nullptr,
+            /*normalize_by_lengths=*/mode == MODE_MEAN,
+            /*prefetch=*/prefetch_distance,
+            /*is_weight_positional=*/false,
+            /*use_offsets=*/true);
+    at::parallel_for(0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+      bool success = kernel_i8_i64(
           /*output_size=*/end_idx - start_idx,
           /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
           /*data_size=*/N,
           /*input=*/weight_data,
           /*indices=*/indices_data + offsets_data[start_idx],
-          /*offsets_or_lengths=*/offsets_data + start_idx,
+          /*offsets_or_lengths=*/offsets_data.data() + start_idx,
           /*weights=*/
-          per_sample_weights_
-            ? per_sample_weights_.value().data_ptr<float>() +
-                offsets_data[start_idx]
-            : nullptr,
-          /*out=*/output_data + start_idx * D
-          );
-
+          per_sample_weights_data
+              ? per_sample_weights_data + offsets_data[start_idx]
+              : nullptr,
+          /*out=*/output_data + start_idx * D);
       TORCH_CHECK(
-        success,
-        "FBGEMM GenerateEmbeddingSpMDM kernel failed for 8-bit input");
-    });
-  } else {
-    auto weight_contig = weight.contiguous();
-    const auto weight_data_contig = weight_contig.data_ptr<uint8_t>();
-    at::parallel_for(
-      0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
-        bool success = kernel_i8_i64(
-          /*output_size=*/end_idx - start_idx,
-          /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
-          /*data_size=*/N,
-          /*input=*/weight_data_contig,
-          /*indices=*/indices_data + offsets_data[start_idx],
-          /*offsets_or_lengths=*/offsets_data + start_idx,
-          /*weights=*/
-          per_sample_weights_
-            ? per_sample_weights_.value().data_ptr<float>() +
-                offsets_data[start_idx]
-            : nullptr,
-            /*out=*/output_data + start_idx * D
-        );
-        TORCH_CHECK(
           success,
           "FBGEMM GenerateEmbeddingSpMDM kernel failed for 8-bit input");
     });
-
+    return output;
+  }
+  if (fbgemm_mode && bit_width != 8) {
+    TORCH_CHECK(D % 2 == 0, "block size must be divisible by 2");
+    // FBGEMM expects the offsets of the n-bit kernels to be of int type.
+    auto offsets_data = offsets_with_end<int>(offsets, index_size, include_last_offset);
+    if (!pruned_weights) {
+      auto kernel_64_ = fbgemm::GenerateEmbeddingSpMDMNBit<std::int64_t>(
+          /*bit rate=*/bit_width,
+          /*block size=*/D,
+          /*has weights=*/per_sample_weights_data != nullptr,
+          /*normalize_by_lengths=*/mode == MODE_MEAN,
+          /*prefetch distance=*/prefetch_distance,
+          /*is_weight_positional=*/false,
+          /*use_offsets=*/true);
+      at::parallel_for(0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+        bool success = kernel_64_(
+            /*output_size=*/end_idx - start_idx,
+            /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
+            /*data_size=*/N,
+            /*input=*/weight_data,
+            /*indices=*/indices_data + offsets_data[start_idx],
+            /*offsets=*/offsets_data.data() + start_idx,
+            /*weights=*/
+            per_sample_weights_data
+                ? per_sample_weights_data + offsets_data[start_idx]
+                : nullptr,
+            /*output=*/output_data + start_idx * D);
+        TORCH_CHECK(
+            success,
+            "FBGEMM GenerateEmbeddingSpMDMNBit kernel failed for ",
+            bit_width, "-bit input");
+      });
+    } else {
+      auto kernel_64_ =
+          fbgemm::GenerateEmbeddingSpMDMNBitRowWiseSparse<std::int64_t>(
+              /*bit rate=*/bit_width,
+              /*block_size=*/D,
+              /*has weights=*/per_sample_weights_data != nullptr,
+              /*normalize_by_lengths=*/mode == MODE_MEAN,
+              /*prefetch distance*/prefetch_distance,
+              /*is_weight_positional*/ false,
+              /*use_offsets*/ true);
+      at::parallel_for(0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+        bool success = kernel_64_(
+            /*output_size=*/end_idx - start_idx,
+            /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
+            /*data_size=*/compressed_index_size,
+            /*input=*/weight_data,
+            /*indices=*/indices_data + offsets_data[start_idx],
+            /*offsets=*/offsets_data.data() + start_idx,
+            /*weights=*/
+            per_sample_weights_data
+                ? per_sample_weights_data + offsets_data[start_idx]
+                : nullptr,
+            /*output=*/output_data + start_idx * D,
+            /*compressed_indices_table=*/compressed_indices_mapping_data);
+        TORCH_CHECK(
+            success,
+            "FBGEMM GenerateEmbeddingSpMDMNBitRowWiseSparse kernel failed for ",
+            bit_width, "-bit input");
+      });
+    }
+    return output;
   }
 #endif
+
+  auto offsets_contig = offsets.to(kLong).contiguous();
+  std::vector<int64_t> offsets_data(
+      offsets_contig.data_ptr<int64_t>(),
+      offsets_contig.data_ptr<int64_t>() + offsets.numel());
+  if (!include_last_offset) {
+    offsets_data.push_back(index_size);
+  }
+  TORCH_CHECK(
+      offsets_data[0] == 0,
+      "offsets[0] has to be 0, i.e., the first sequence in the mini-batch has to start from position 0. However, got ",
+      offsets_data[0]);
+  TORCH_CHECK(
+      offsets_data[output_size] <= index_size,
+      "offsets[-1] can not be greater than input's length ", index_size,
+      " but got offsets[-1] of ", offsets_data[output_size]);
+  for (int64_t m = 0; m < output_size; ++m) {
+    TORCH_CHECK(
+        offsets_data[m] <= offsets_data[m + 1],
+        "embedding_bag: offsets must be non-decreasing");
+  }
+
+  auto run_reference = [&](auto bits) {
+    embedding_bag_nbit_reference<decltype(bits)::value>(
+        weight_data, N, row_bytes, D, indices_data, offsets_data.data(),
+        output_size, mode, per_sample_weights_data,
+        compressed_indices_mapping_data, compressed_index_size, output_data);
+  };
+  switch (bit_width) {
+    case 8: run_reference(std::integral_constant<int, 8>()); break;
+    case 4: run_reference(std::integral_constant<int, 4>()); break;
+    case 2: run_reference(std::integral_constant<int, 2>()); break;
+    default: TORCH_CHECK(false, "embedding_bag: unsupported bit width ", bit_width);
+  }
   return output;
 }
 
-Tensor embedding_bag_4bit_rowwise_offsets(
+Tensor embedding_bag_byte_rowwise_offsets(
     const Tensor& weight,
     const Tensor& indices,
     const Tensor& offsets,
     const bool /* scale_grad_by_freq */,
-    const int64_t /* mode */,
+    const int64_t mode,
     bool sparse,
     const c10::optional<Tensor>& per_sample_weights_,
     const c10::optional<Tensor>& compressed_indices_mapping,
     bool include_last_offset) {
-  TORCH_CHECK(weight.ndimension() == 2);
-  TORCH_CHECK(indices.ndimension() == 1);
-  TORCH_CHECK(offsets.ndimension() == 1);
-
-  // FBGEMM expects the offsets to be of int type.
-  at::Tensor offsets_new = offsets.toType(ScalarType::Int);
-
-  auto offsets_data = offsets_new.data_ptr<int>();
-  const auto weight_data = weight.data_ptr<uint8_t>();
-  uint8_t* input_data = nullptr;
-  if (!weight.is_contiguous()) {
-    auto weight_contig = weight.contiguous();
-    input_data = weight_contig.data_ptr<uint8_t>();
-  } else {
-    input_data = weight.data_ptr<uint8_t>();
-  }
-
-  // Get compressed indices for sparse op.
-  int32_t* compressed_indices_mapping_data = nullptr;
-  int compressed_index_size = 0;
-  if (sparse) {
-    compressed_index_size = compressed_indices_mapping.value().numel();
-    compressed_indices_mapping_data =
-        compressed_indices_mapping.value().data_ptr<int32_t>();
-  }
-
-  const auto indices_data = indices.data_ptr<int64_t>();
-  const int64_t N = weight.size(0);
-  const int64_t D =
-      (weight.size(1) - 4) * 2; // NB: 2-byte fp16 scale and 2-byte zero_offset
-  const int64_t M = offsets.size(0);
-
-  int64_t output_size = M - 1;
-  std::vector<int> offsets_include_last_val;
-  if (!include_last_offset) {
-    output_size = M;
-    offsets_include_last_val.resize(M + 1);
-    // Avoid `null pointer passed as argument 2` ASAN violation when ofests
-    // tensor is empty.
-    if (M > 0) {
-      std::memcpy(offsets_include_last_val.data(), offsets_data, sizeof(int) * M);
-    }
-    offsets_include_last_val[M] = indices.numel();
-    offsets_data = offsets_include_last_val.data();
-  }
-
-  const std::vector<int64_t> shape = {output_size, D};
-  auto output = at::empty(shape, weight.options().dtype(at::kFloat));
-  auto* output_data = output.data_ptr<float>();
-  const int64_t block_size = output.size(1);
-  TORCH_CHECK(block_size % 2 == 0, "block size must be divisible by 2");
-  const int index_size = indices.numel();
-  constexpr int prefetch_distance = 16;
-#ifdef USE_FBGEMM
-  if (!sparse) {
-    // Generate the fbgemm kernel
-    auto kernel_64_ = fbgemm::GenerateEmbeddingSpMDMNBit<std::int64_t>(
-        /*bit rate=*/4,
-        /*block size=*/block_size,
-        /*has weights=*/per_sample_weights_.has_value(),
-        /*normalize_by_lengths=*/false,
-        /*prefetch distance=*/prefetch_distance,
-        /*is_weight_positional=*/false,
-        /*use_offsets=*/true);
-
-    bool success = kernel_64_(
-        /*output_size=*/output_size,
-        /*index_size=*/index_size,
-        /*data_size=*/N,
-        /*input=*/input_data,
-        /*indices=*/indices_data,
-        /*offsets=*/offsets_data,
-        /*weights=*/
-        per_sample_weights_.has_value() ? per_sample_weights_.value().data_ptr<float>()
-                            : nullptr,
-        /*output=*/output_data);
-
-    TORCH_CHECK(
-        success,
-        "FBGEMM GenerateEmbeddingSpMDMNBit kernel failed for 4-bit input");
-  } else {
-    auto kernel_64_ =
-        fbgemm::GenerateEmbeddingSpMDMNBitRowWiseSparse<std::int64_t>(
-            /*bit rate=*/4,
-            /*block_size=*/block_size,
-            /*has weights=*/per_sample_weights_.has_value(),
-            /*normalize_by_lengths=*/false,
-            /*prefetch distance*/prefetch_distance,
-            /*is_weight_positional*/ false,
-            /*use_offsets*/ true);
-    bool success = kernel_64_(
-        /*output_size=*/output_size,
-        /*index_size=*/index_size,
-        /*data_size=*/compressed_index_size,
-        /*input=*/weight_data,
-        /*indices=*/indices_data,
-        /*offsets=*/offsets_data,
-        /*weights=*/
-        per_sample_weights_.has_value() ? per_sample_weights_.value().data_ptr<float>()
-                            : nullptr,
-        /*output=*/output_data,
-        /*compressed_indices_table=*/compressed_indices_mapping_data);
-    TORCH_CHECK(
-        success,
-        "FBGEMM GenerateEmbeddingSpMDMNBitRowWiseSparse kernel failed for 4-bit input");
-  }
-#else
-
-  auto accessor = offsets.accessor<int64_t, 1>();
-  std::vector<int> lengths_data;
-
-  int64_t lower = accessor[0];
-  for (int64_t i = 1; i < offsets.numel(); ++i) {
-    lengths_data.push_back(accessor[i] - lower);
-    lower = accessor[i];
-  }
-  if (!include_last_offset) {
-    lengths_data.push_back(indices.numel() - lower);
-  }
-
-  int64_t current = 0;
-  float* per_sample_weights_data;
-  if (per_sample_weights_.has_value()) {
-    per_sample_weights_data = per_sample_weights_.value().data_ptr<float>();
-  }
-  for (int m = 0; m < output_size; ++m) {
-    memset(output_data, 0, block_size * sizeof(float));
-    TORCH_CHECK(
-        current + lengths_data[m] <= index_size,
-        "Expect the lengths data to be less than indices size");
-
-    for (int i = 0; i < lengths_data[m]; ++i, ++current) {
-      int64_t idx;
-      if (!sparse) {
-        idx = indices_data[current];
-        TORCH_CHECK((idx >= 0 && idx < N), "Invalid indices data");
-      } else {
-        int64_t uncompressed_idx = indices_data[current];
-        TORCH_CHECK(
-            uncompressed_idx >= 0 && uncompressed_idx < compressed_index_size,
-            "Invalid indices data for Sparse Op.")
-        idx = compressed_indices_mapping_data[uncompressed_idx];
-        if (idx == -1) {
-          continue;
-        }
-      }
-      const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
-          input_data + (idx + 1) * weight.size(1) - 2 * sizeof(at::Half));
-
-      float weight_val = 1.0f;
-      if (per_sample_weights_.has_value()) {
-        weight_val = per_sample_weights_data[current];
-      }
-      const float scale = weight_val * scale_bias[0];
-      const float bias = weight_val * scale_bias[1];
-
-      for (int j = 0; j < block_size; ++j) {
-        uint8_t quantized =
-            input_data[idx * weight.size(1) + j / /*NUM_ELEM_PER_BYTE*/ 2];
-        quantized >>= (j % 2) * 4;
-        quantized &= (1 << 4) - 1;
+  return embedding_bag_nbit_impl(
+      8, weight, indices, offsets, mode, sparse, per_sample_weights_,
+      compressed_indices_mapping, include_last_offset);
+}
 
-        output_data[j] = fma(scale, quantized, output_data[j] + bias);
-      }
-    } // for each i
-    output_data += block_size;
-  } // for each m
+Tensor embedding_bag_4bit_rowwise_offsets(
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const bool /* scale_grad_by_freq */,
+    const int64_t mode,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  return embedding_bag_nbit_impl(
+      4, weight, indices, offsets, mode, sparse, per_sample_weights_,
+      compressed_indices_mapping, include_last_offset);
+}
 
-#endif
-  return output;
+Tensor embedding_bag_2bit_rowwise_offsets(
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const bool /* scale_grad_by_freq */,
+    const int64_t mode,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  return embedding_bag_nbit_impl(
+      2, weight, indices, offsets, mode, sparse, per_sample_weights_,
+      compressed_indices_mapping, include_last_offset);
 }
 
+} // namespace
+
 TORCH_LIBRARY_IMPL(quantized, CPU, m) {
     m.impl("embedding_bag_byte_rowwise_offsets", embedding_bag_byte_rowwise_offsets);
     m.impl("embedding_bag_4bit_rowwise_offsets", embedding_bag_4bit_rowwise_offsets);
+    m.impl("embedding_bag_2bit_rowwise_offsets", embedding_bag_2bit_rowwise_offsets);
 }
 
 }
@@ -51,19 +51,21 @@ Tensor qembeddingbag_byte_prepack(const Tensor& weight) {
   return output;
 }
 
-Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
+// Packs BIT_RATE (4 or 2) bit values with an fp16 scale and bias per row, see
+// Note [Fused rowwise quantized EmbeddingBag] in qembeddingbag.cpp.
+template <int BIT_RATE>
+Tensor qembeddingbag_nbit_prepack_helper(const Tensor& weight) {
   int64_t embedding_rows = weight.size(0);
   int64_t embedding_cols = weight.size(1);
 
   Tensor weight_contig = weight.contiguous(weight.suggest_memory_format());
 
-  const auto weight_data = weight.data_ptr<float>();
-  constexpr int BIT_RATE = 4;
+  const auto weight_data = weight_contig.data_ptr<float>();
   constexpr int NUM_ELEM_PER_BYTE = 8 / BIT_RATE;
   TORCH_CHECK(
       weight_contig.size(weight.dim() - 1) % NUM_ELEM_PER_BYTE == 0,
-      "FloatToFused4BitRowwiseQuantizedOp only works for the number of "
-      "columns a multiple of 2");
+      "FloatToFused", BIT_RATE, "BitRowwiseQuantizedOp only works for the number of "
+      "columns a multiple of ", NUM_ELEM_PER_BYTE);
 
   // The "fused" representation stores the scale and bias with the
   // row-wise quantized data in one tensor.
@@ -120,8 +122,8 @@ Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
           0,
           std::min<int>(
               lrintf((X - Xmin) * inverse_scale), (1 << BIT_RATE) - 1));
-      // We pack 2 4-bit values in a byte. Index 0 is packed in the lower 4-bits
-      // and index 1 is packed in the upper 4-bits.
+      // We pack NUM_ELEM_PER_BYTE values in a byte, with the lower indices in
+      // the lower bits.
       if (col % NUM_ELEM_PER_BYTE == 0) {
         output_row[col / NUM_ELEM_PER_BYTE] = quantized;
       } else {
@@ -133,9 +135,18 @@ Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
   return output;
 }
 
+Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
+  return qembeddingbag_nbit_prepack_helper<4>(weight);
+}
+
+Tensor qembeddingbag_2bit_prepack(const Tensor& weight) {
+  return qembeddingbag_nbit_prepack_helper<2>(weight);
+}
+
 TORCH_LIBRARY_IMPL(quantized, CPU, m) {
   m.impl("embedding_bag_byte_prepack", qembeddingbag_byte_prepack);
   m.impl("embedding_bag_4bit_prepack", qembeddingbag_4bit_prepack);
+  m.impl("embedding_bag_2bit_prepack", qembeddingbag_2bit_prepack);
 }
 
 } // namespace
@@ -35,12 +35,12 @@ Tensor qembeddingbag_byte_unpack(const Tensor& packed_weight) {
   return output;
 }
 
-Tensor qembeddingbag_4bit_unpack(const Tensor& packed_weight) {
+template <int BIT_RATE>
+Tensor qembeddingbag_nbit_unpack_helper(const Tensor& packed_weight) {
   const auto input_rows = packed_weight.size(0);
   const auto input_columns = packed_weight.size(1);
   const auto* input_data = packed_weight.data_ptr<uint8_t>();
-  constexpr int NUM_ELEM_PER_BYTE = 2;
-  constexpr int BIT_RATE = 4;
+  constexpr int NUM_ELEM_PER_BYTE = 8 / BIT_RATE;
 
   // The last 4 bytes per row are two fp16 scale and zero_point.
   // The rest of input_columns is the number of values in the original row.
@@ -74,9 +74,18 @@ Tensor qembeddingbag_4bit_unpack(const Tensor& packed_weight) {
   return output;
 }
 
+Tensor qembeddingbag_4bit_unpack(const Tensor& packed_weight) {
+  return qembeddingbag_nbit_unpack_helper<4>(packed_weight);
+}
+
+Tensor qembeddingbag_2bit_unpack(const Tensor& packed_weight) {
+  return qembeddingbag_nbit_unpack_helper<2>(packed_weight);
+}
+
 TORCH_LIBRARY_IMPL(quantized, CPU, m) {
   m.impl("embedding_bag_byte_unpack", qembeddingbag_byte_unpack);
   m.impl("embedding_bag_4bit_unpack", qembeddingbag_4bit_unpack);
+  m.impl("embedding_bag_2bit_unpack", qembeddingbag_2bit_unpack);
 }
 } // namespace
 } // namespace native
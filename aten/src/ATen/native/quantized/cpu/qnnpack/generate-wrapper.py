@@ -103,6 +103,12 @@ QNNPACK_SOURCES = {
         "q8gemm/8x8-aarch64-neon.S",
         "q8gemm/8x8-dq-aarch64-neon.S",
     ],
+    # AArch64 uKernels for the ARMv8.2 dot product extension
+    "defined(__aarch64__) && defined(__ARM_FEATURE_DOTPROD)": [
+        "q8conv/8x8c4-neondot.c",
+        "q8gemm/8x8c4-dq-neondot.c",
+        "q8gemm/8x8c4-neondot.c",
+    ],
 }
 
 BANNER = "/* Auto-generated by generate-wrappers.py script. Do not modify */"
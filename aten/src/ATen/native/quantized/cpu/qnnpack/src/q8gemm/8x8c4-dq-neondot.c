@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <arm_neon.h>
+
+#include <qnnpack/q8gemm.h>
+#include <q8gemm/8x8c4-neondot-inl.h>
+
+void pytorch_q8gemm_dq_ukernel_8x8c4__neondot(
+    size_t mr,
+    size_t nr,
+    size_t k,
+    const uint8_t* restrict a,
+    size_t a_stride,
+    const void* restrict w,
+    const float* restrict b,
+    float* restrict c,
+    size_t c_stride,
+    size_t output_channel_index,
+    const struct pytorch_qnnp_conv_dynamic_quantization_params
+        quantization_params[RESTRICT_STATIC 1]) {
+  /* The bias is added in float, after the multipliers. */
+  const int32x4_t vzero[2] = {
+      vdupq_n_s32(0),
+      vdupq_n_s32(0),
+  };
+  w = (const void*)((uintptr_t)w + 32);
+
+  const uint8_t* am[8];
+  am[0] = a;
+  for (size_t m = 1; m < 8; m++) {
+    am[m] = m < mr ? (const uint8_t*)((uintptr_t)am[m - 1] + a_stride)
+                   : am[m - 1];
+  }
+
+  struct pytorch_q8dot_accumulators_8x8 acc;
+  pytorch_q8dot_init_8x8(&acc);
+  pytorch_q8dot_accumulate_8x8(&acc, k, am, w);
+
+  int32x4_t vacc[8][2];
+  // Assumes that kernel_zero_points is an array padded with necessary elements
+  // in order to make it multiple of 8.
+  pytorch_q8dot_finalize_8x8(
+      &acc,
+      vzero,
+      (uint8_t)quantization_params->input_zero_point,
+      vld1_u8(&quantization_params->kernel_zero_points[output_channel_index]),
+      vacc);
+
+  const float32x4_t vmultiplier[2] = {
+      vld1q_f32(&quantization_params->multipliers[output_channel_index]),
+      vld1q_f32(&quantization_params->multipliers[output_channel_index + 4]),
+  };
+  const float32x4_t vbias[2] = {
+      vld1q_f32(b),
+      vld1q_f32(b + 4),
+  };
+
+  float* cm[8];
+  cm[0] = c;
+  for (size_t m = 1; m < 8; m++) {
+    cm[m] = m < mr ? cm[m - 1] + c_stride : cm[m - 1];
+  }
+
+  float32x4_t vout[8][2];
+  for (size_t m = 0; m < 8; m++) {
+    for (size_t n = 0; n < 2; n++) {
+      vout[m][n] = vaddq_f32(
+          vmulq_f32(vmultiplier[n], vcvtq_f32_s32(vacc[m][n])), vbias[n]);
+    }
+  }
+
+  size_t column = 0;
+  if (nr >= 4) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1q_f32(cm[m], vout[m][0]);
+      cm[m] += 4;
+    }
+    nr -= 4;
+    column = 1;
+  }
+  if (nr >= 4) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1q_f32(cm[m], vout[m][1]);
+    }
+    return;
+  }
+  if (nr >= 2) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1_f32(cm[m], vget_low_f32(vout[m][column]));
+      cm[m] += 2;
+      vout[m][column] = vextq_f32(vout[m][column], vout[m][column], 2);
+    }
+    nr -= 2;
+  }
+  if (nr != 0) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1q_lane_f32(cm[m], vout[m][column], 0);
+    }
+  }
+}
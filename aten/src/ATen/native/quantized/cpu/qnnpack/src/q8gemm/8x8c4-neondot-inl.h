@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <arm_neon.h>
+
+#include <qnnpack/params.h>
+
+/*
+ * Shared parts of the 8x8c4 microkernels for ARMv8.2 cores with the UDOT
+ * instruction (cpuinfo_has_arm_neon_dot).
+ *
+ * The weights are packed with kr = 4: each column of an 8 column block holds
+ * 4 consecutive uint8 weights of the reduction dimension, so a single UDOT
+ * multiplies and sums 4 of them with 4 inputs for 4 columns at a time. As the
+ * products are of the raw uint8 values, the zero points are taken out at the
+ * end instead:
+ *
+ *   sum((a - za) * (b - zb)) =
+ *       sum(a * b) - zb * sum(a) - za * sum(b) + k * za * zb
+ *
+ * where the input sums, sum(a), come from extra UDOTs with a vector of ones
+ * and the weight sums, sum(b), likewise. The packing pads the weights with
+ * their zero point and the tail of the inputs is zero, so the padding cancels
+ * out as long as k counts the padded reduction size. All sums fit in 32 bits
+ * for any reduction size QNNPACK supports, and the subtractions wrap to the
+ * exact signed result.
+ */
+
+struct pytorch_q8dot_accumulators_8x8 {
+  /* sum(a * b): [row][columns 0-3, columns 4-7] */
+  uint32x4_t vacc[8][2];
+  /* sum(a) of rows 2i and 2i + 1, each split over two lanes */
+  uint32x4_t vasum[4];
+  /* sum(b) of columns 0-3 and 4-7 */
+  uint32x4_t vbsum[2];
+  /* padded reduction size */
+  size_t k;
+};
+
+static inline void pytorch_q8dot_init_8x8(
+    struct pytorch_q8dot_accumulators_8x8* acc) {
+  for (size_t m = 0; m < 8; m++) {
+    acc->vacc[m][0] = vdupq_n_u32(0);
+    acc->vacc[m][1] = vdupq_n_u32(0);
+  }
+  for (size_t m = 0; m < 4; m++) {
+    acc->vasum[m] = vdupq_n_u32(0);
+  }
+  acc->vbsum[0] = vdupq_n_u32(0);
+  acc->vbsum[1] = vdupq_n_u32(0);
+  acc->k = 0;
+}
+
+static inline void pytorch_q8dot_step_8x8(
+    struct pytorch_q8dot_accumulators_8x8* acc,
+    const uint8x8_t va[8],
+    const uint8x16_t vb0123c0123,
+    const uint8x16_t vb4567c0123,
+    const uint8x16_t vb0123c4567,
+    const uint8x16_t vb4567c4567) {
+  const uint8x16_t vones = vdupq_n_u8(1);
+  for (size_t m = 0; m < 8; m++) {
+    acc->vacc[m][0] = vdotq_lane_u32(acc->vacc[m][0], vb0123c0123, va[m], 0);
+    acc->vacc[m][1] = vdotq_lane_u32(acc->vacc[m][1], vb4567c0123, va[m], 0);
+    acc->vacc[m][0] = vdotq_lane_u32(acc->vacc[m][0], vb0123c4567, va[m], 1);
+    acc->vacc[m][1] = vdotq_lane_u32(acc->vacc[m][1], vb4567c4567, va[m], 1);
+  }
+  for (size_t m = 0; m < 4; m++) {
+    acc->vasum[m] = vdotq_u32(
+        acc->vasum[m], vcombine_u8(va[2 * m], va[2 * m + 1]), vones);
+  }
+  acc->vbsum[0] = vdotq_u32(acc->vbsum[0], vb0123c0123, vones);
+  acc->vbsum[1] = vdotq_u32(acc->vbsum[1], vb4567c0123, vones);
+  acc->vbsum[0] = vdotq_u32(acc->vbsum[0], vb0123c4567, vones);
+  acc->vbsum[1] = vdotq_u32(acc->vbsum[1], vb4567c4567, vones);
+}
+
+/*
+ * Accumulates k inputs of each of the 8 rows against the packed weights, and
+ * returns the weights past the ones read.
+ */
+static inline const void* pytorch_q8dot_accumulate_8x8(
+    struct pytorch_q8dot_accumulators_8x8* acc,
+    size_t k,
+    const uint8_t* a[8],
+    const void* w) {
+  uint8x8_t va[8];
+  for (; k >= 8; k -= 8) {
+    for (size_t m = 0; m < 8; m++) {
+      va[m] = vld1_u8(a[m]);
+      a[m] += 8;
+    }
+    const uint8x16_t vb0123c0123 = vld1q_u8(w);
+    const uint8x16_t vb4567c0123 = vld1q_u8((const uint8_t*)w + 16);
+    const uint8x16_t vb0123c4567 = vld1q_u8((const uint8_t*)w + 32);
+    const uint8x16_t vb4567c4567 = vld1q_u8((const uint8_t*)w + 48);
+    w = (const void*)((uintptr_t)w + 64);
+
+    pytorch_q8dot_step_8x8(
+        acc, va, vb0123c0123, vb4567c0123, vb0123c4567, vb4567c4567);
+    acc->k += 8;
+  }
+  if (k != 0) {
+    /* Like the other NEON kernels, load the last 8 bytes of each row and
+     * shift the k valid ones down, which zeroes the rest. */
+    const size_t a_predecrement = 8 - k;
+    const int64x1_t va_shift = vmov_n_s64(-8 * a_predecrement);
+    for (size_t m = 0; m < 8; m++) {
+      va[m] = vreinterpret_u8_u64(vshl_u64(
+          vreinterpret_u64_u8(vld1_u8(a[m] - a_predecrement)), va_shift));
+      a[m] += k;
+    }
+    const uint8x16_t vb0123c0123 = vld1q_u8(w);
+    const uint8x16_t vb4567c0123 = vld1q_u8((const uint8_t*)w + 16);
+    w = (const void*)((uintptr_t)w + 32);
+    uint8x16_t vb0123c4567 = vdupq_n_u8(0);
+    uint8x16_t vb4567c4567 = vdupq_n_u8(0);
+    acc->k += 4;
+    if (k > 4) {
+      vb0123c4567 = vld1q_u8(w);
+      vb4567c4567 = vld1q_u8((const uint8_t*)w + 16);
+      w = (const void*)((uintptr_t)w + 32);
+      acc->k += 4;
+    }
+
+    pytorch_q8dot_step_8x8(
+        acc, va, vb0123c0123, vb4567c0123, vb0123c4567, vb4567c4567);
+  }
+  return w;
+}
+
+/*
+ * Takes the zero points out of the accumulators and adds the bias.
+ */
+static inline void pytorch_q8dot_finalize_8x8(
+    const struct pytorch_q8dot_accumulators_8x8* acc,
+    const int32x4_t vbias[2],
+    const uint8_t input_zero_point,
+    const uint8x8_t vb_zero_point,
+    int32x4_t vout[8][2]) {
+  const uint16x8_t vxb_zero_point = vmovl_u8(vb_zero_point);
+  const int32x4_t vzb[2] = {
+      vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vxb_zero_point))),
+      vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(vxb_zero_point))),
+  };
+  const int32_t za = (int32_t)input_zero_point;
+
+  /* bias - za * sum(b) + k * za * zb, the same for all rows */
+  int32x4_t vcolumn[2];
+  for (size_t n = 0; n < 2; n++) {
+    vcolumn[n] = vmlsq_n_s32(
+        vbias[n], vreinterpretq_s32_u32(acc->vbsum[n]), za);
+    vcolumn[n] = vmlaq_n_s32(vcolumn[n], vzb[n], (int32_t)acc->k * za);
+  }
+
+  for (size_t m = 0; m < 4; m++) {
+    /* sum(a) of rows 2m and 2m + 1 */
+    const int32x2_t vasum = vreinterpret_s32_u32(
+        vget_low_u32(vpaddq_u32(acc->vasum[m], acc->vasum[m])));
+    for (size_t n = 0; n < 2; n++) {
+      vout[2 * m][n] = vmlsq_lane_s32(
+          vaddq_s32(vreinterpretq_s32_u32(acc->vacc[2 * m][n]), vcolumn[n]),
+          vzb[n],
+          vasum,
+          0);
+      vout[2 * m + 1][n] = vmlsq_lane_s32(
+          vaddq_s32(
+              vreinterpretq_s32_u32(acc->vacc[2 * m + 1][n]), vcolumn[n]),
+          vzb[n],
+          vasum,
+          1);
+    }
+  }
+}
+
+/*
+ * Requantizes the 8x8 int32 outputs and stores the mr x nr valid ones, as
+ * pytorch_q8gemm_ukernel_8x8__neon does on AArch64.
+ */
+static inline void pytorch_q8dot_requantize_store_8x8(
+    int32x4_t vacc[8][2],
+    size_t mr,
+    size_t nr,
+    uint8_t* c,
+    size_t c_stride,
+    size_t output_channel_index,
+    const union pytorch_qnnp_conv_quantization_params* quantization_params) {
+  const float32x4_t requantization_scale[2] = {
+      vld1q_f32(&quantization_params->neon
+                     .requantization_scales[output_channel_index]),
+      vld1q_f32(&quantization_params->neon
+                     .requantization_scales[output_channel_index + 4]),
+  };
+  const int16x8_t voutput_zero_point =
+      vld1q_dup_s16(&quantization_params->neon.output_zero_point);
+  const uint8x16_t voutput_min =
+      vld1q_dup_u8(&quantization_params->neon.output_min);
+  const uint8x16_t voutput_max =
+      vld1q_dup_u8(&quantization_params->neon.output_max);
+
+  /* rows 2m and 2m + 1 */
+  uint8x16_t vout[4];
+  for (size_t m = 0; m < 4; m++) {
+    int16x8_t vrow[2];
+    for (size_t r = 0; r < 2; r++) {
+      const int32x4_t vacc0123 = vcvtnq_s32_f32(vmulq_f32(
+          vcvtq_f32_s32(vacc[2 * m + r][0]), requantization_scale[0]));
+      const int32x4_t vacc4567 = vcvtnq_s32_f32(vmulq_f32(
+          vcvtq_f32_s32(vacc[2 * m + r][1]), requantization_scale[1]));
+      vrow[r] = vqaddq_s16(
+          vqmovn_high_s32(vqmovn_s32(vacc0123), vacc4567), voutput_zero_point);
+    }
+    vout[m] = vqmovun_high_s16(vqmovun_s16(vrow[0]), vrow[1]);
+    vout[m] = vminq_u8(vmaxq_u8(vout[m], voutput_min), voutput_max);
+  }
+
+  uint8_t* cm[8];
+  cm[0] = c;
+  for (size_t m = 1; m < 8; m++) {
+    cm[m] = m < mr ? (uint8_t*)((uintptr_t)cm[m - 1] + c_stride) : cm[m - 1];
+  }
+
+  if (nr == 8) {
+    for (size_t m = 0; m < 4; m++) {
+      vst1_u8(cm[2 * m], vget_low_u8(vout[m]));
+      vst1_u8(cm[2 * m + 1], vget_high_u8(vout[m]));
+    }
+    return;
+  }
+  if (nr >= 4) {
+    for (size_t m = 0; m < 4; m++) {
+      vst1q_lane_u32(
+          __builtin_assume_aligned(cm[2 * m], 1),
+          vreinterpretq_u32_u8(vout[m]),
+          0);
+      vst1q_lane_u32(
+          __builtin_assume_aligned(cm[2 * m + 1], 1),
+          vreinterpretq_u32_u8(vout[m]),
+          2);
+      cm[2 * m] += 4;
+      cm[2 * m + 1] += 4;
+      vout[m] = vextq_u8(vout[m], vout[m], 4);
+    }
+    nr -= 4;
+  }
+  if (nr >= 2) {
+    for (size_t m = 0; m < 4; m++) {
+      vst1q_lane_u16(
+          __builtin_assume_aligned(cm[2 * m], 1),
+          vreinterpretq_u16_u8(vout[m]),
+          0);
+      vst1q_lane_u16(
+          __builtin_assume_aligned(cm[2 * m + 1], 1),
+          vreinterpretq_u16_u8(vout[m]),
+          4);
+      cm[2 * m] += 2;
+      cm[2 * m + 1] += 2;
+      vout[m] = vextq_u8(vout[m], vout[m], 2);
+    }
+    nr -= 2;
+  }
+  if (nr != 0) {
+    for (size_t m = 0; m < 4; m++) {
+      vst1q_lane_u8(cm[2 * m], vout[m], 0);
+      vst1q_lane_u8(cm[2 * m + 1], vout[m], 8);
+    }
+  }
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <arm_neon.h>
+
+#include <qnnpack/q8gemm.h>
+#include <q8gemm/8x8c4-neondot-inl.h>
+
+void pytorch_q8gemm_ukernel_8x8c4__neondot(
+    size_t mr,
+    size_t nr,
+    size_t k,
+    const uint8_t* restrict a,
+    size_t a_stride,
+    const void* restrict w,
+    uint8_t* restrict c,
+    size_t c_stride,
+    size_t output_channel_index,
+    const union pytorch_qnnp_conv_quantization_params
+        quantization_params[restrict static 1]) {
+  const int32x4_t vbias[2] = {
+      vld1q_s32(w),
+      vld1q_s32((const int32_t*)w + 4),
+  };
+  w = (const void*)((uintptr_t)w + 32);
+
+  const uint8_t* am[8];
+  am[0] = a;
+  for (size_t m = 1; m < 8; m++) {
+    am[m] = m < mr ? (const uint8_t*)((uintptr_t)am[m - 1] + a_stride)
+                   : am[m - 1];
+  }
+
+  struct pytorch_q8dot_accumulators_8x8 acc;
+  pytorch_q8dot_init_8x8(&acc);
+  pytorch_q8dot_accumulate_8x8(&acc, k, am, w);
+
+  int32x4_t vacc[8][2];
+  pytorch_q8dot_finalize_8x8(
+      &acc,
+      vbias,
+      (uint8_t)quantization_params->neon.input_zero_point,
+      vld1_u8(&quantization_params->neon
+                   .kernel_zero_points[output_channel_index]),
+      vacc);
+
+  pytorch_q8dot_requantize_store_8x8(
+      vacc, mr, nr, c, c_stride, output_channel_index, quantization_params);
+}
@@ -0,0 +1,5 @@
+/* Auto-generated by generate-wrappers.py script. Do not modify */
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_DOTPROD)
+#include <q8conv/8x8c4-neondot.c>
+#endif /* defined(__aarch64__) && defined(__ARM_FEATURE_DOTPROD) */
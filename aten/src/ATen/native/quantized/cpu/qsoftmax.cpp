@@ -0,0 +1,153 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/WrapDimUtils.h>
+#include <torch/library.h>
+#include <ATen/quantized/Quantizer.h>
+#include <ATen/native/quantized/cpu/init_qnnpack.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <caffe2/utils/threadpool/pthreadpool-cpp.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace at {
+namespace native {
+
+namespace {
+
+#ifdef USE_PYTORCH_QNNPACK
+// QNNPACK only supports the output scale 1/256 and zero point 0, which
+// covers softmax outputs in [0, 1) exactly.
+Tensor qnnpack_softmax(const Tensor& qx_contig, Tensor& qy) {
+  initQNNPACK();
+
+  const int64_t channels = qx_contig.size(-1);
+  const int64_t batch_size = qx_contig.numel() / channels;
+
+  pytorch_qnnp_operator_t softargmax_op{nullptr};
+  const pytorch_qnnp_status createStatus = pytorch_qnnp_create_softargmax_nc_q8(
+    channels,
+    qx_contig.q_scale() /* input scale */,
+    qy.q_zero_point() /* output zero point */,
+    qy.q_scale() /* output scale */,
+    0 /* flags */,
+    &softargmax_op);
+  TORCH_INTERNAL_ASSERT(createStatus == pytorch_qnnp_status_success,
+                        "failed to create QNNPACK softmax operator");
+  std::unique_ptr<pytorch_qnnp_operator, QnnpackOperatorDeleter>
+      qnnpack_uniq_ptr(softargmax_op);
+
+  const pytorch_qnnp_status setupStatus = pytorch_qnnp_setup_softargmax_nc_q8(
+    softargmax_op,
+    batch_size,
+    (uint8_t*)qx_contig.data_ptr<c10::quint8>() /* input data */,
+    channels /* input stride */,
+    (uint8_t*)qy.data_ptr<c10::quint8>() /* output data */,
+    channels /* output stride */);
+  TORCH_INTERNAL_ASSERT(setupStatus == pytorch_qnnp_status_success,
+                        "failed to setup QNNPACK softmax operator");
+
+  pthreadpool_t threadpool = caffe2::pthreadpool_();
+  const pytorch_qnnp_status runStatus =
+    pytorch_qnnp_run_operator(softargmax_op, threadpool);
+  TORCH_INTERNAL_ASSERT(runStatus == pytorch_qnnp_status_success,
+                        "failed to run QNNPACK softmax operator");
+  return qy;
+}
+#endif  // USE_PYTORCH_QNNPACK
+
+// softmax(x)_i = exp(x_i - max(x)) / sum_j exp(x_j - max(x)) only depends on
+// the differences q_max - q_i of the quantized values, which take at most 256
+// values, so the exponentials come from a table.
+template <typename scalar_t>
+void qsoftmax_lastdim_kernel(const Tensor& qx_contig, Tensor& qy) {
+  using underlying_t = typename scalar_t::underlying;
+  constexpr int64_t kTableSize =
+      int64_t(std::numeric_limits<underlying_t>::max()) -
+      int64_t(std::numeric_limits<underlying_t>::min()) + 1;
+  const int64_t channels = qx_contig.size(-1);
+  const int64_t outer_size = qx_contig.numel() / channels;
+  const float input_scale = qx_contig.q_scale();
+  const float inv_output_scale = 1.0f / qy.q_scale();
+  const int64_t output_zero_point = qy.q_zero_point();
+  const int64_t qmin = std::numeric_limits<underlying_t>::min();
+  const int64_t qmax = std::numeric_limits<underlying_t>::max();
+
+  std::array<float, kTableSize> exp_table;
+  for (int64_t d = 0; d < kTableSize; d++) {
+    exp_table[d] = std::exp(-input_scale * d);
+  }
+
+  const underlying_t* x_data =
+      reinterpret_cast<const underlying_t*>(qx_contig.data_ptr<scalar_t>());
+  underlying_t* y_data = reinterpret_cast<underlying_t*>(qy.data_ptr<scalar_t>());
+  at::parallel_for(0, outer_size, at::internal::GRAIN_SIZE / channels + 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const underlying_t* x = x_data + i * channels;
+      underlying_t* y = y_data + i * channels;
+      const int32_t x_max = *std::max_element(x, x + channels);
+      float sum = 0;
+      for (int64_t j = 0; j < channels; j++) {
+        sum += exp_table[x_max - x[j]];
+      }
+      const float multiplier = inv_output_scale / sum;
+      for (int64_t j = 0; j < channels; j++) {
+        const int64_t q = output_zero_point + lrintf(exp_table[x_max - x[j]] * multiplier);
+        y[j] = static_cast<underlying_t>(std::min(std::max(q, qmin), qmax));
+      }
+    }
+  });
+}
+
+Tensor quantized_softmax(
+    const Tensor& qx,
+    int64_t dim,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(qx.qscheme() == kPerTensorAffine,
+              "quantized::softmax only supports per tensor quantized inputs");
+  TORCH_CHECK(qx.dim() > 0, "quantized::softmax: expected a non-scalar input");
+  dim = maybe_wrap_dim(dim, qx.dim());
+  // Computed along the last dim of a contiguous tensor, then moved back
+  const bool transposed = dim != qx.dim() - 1;
+  Tensor qx_contig = transposed ? qx.transpose(dim, -1).contiguous() : qx.contiguous();
+  Tensor qy = at::_empty_affine_quantized(
+      qx_contig.sizes(),
+      qx.options(),
+      output_scale,
+      output_zero_point);
+  if (qx.numel() == 0) {
+    return transposed ? qy.transpose(dim, -1) : qy;
+  }
+
+#ifdef USE_PYTORCH_QNNPACK
+  if (at::globalContext().qEngine() == at::QEngine::QNNPACK &&
+      qx.scalar_type() == kQUInt8 &&
+      static_cast<float>(output_scale) == 1.0f / 256.0f &&
+      output_zero_point == 0) {
+    qnnpack_softmax(qx_contig, qy);
+    return transposed ? qy.transpose(dim, -1) : qy;
+  }
+#endif  // USE_PYTORCH_QNNPACK
+
+  // The table covers every value of the underlying type, hence no qint32
+  if (qx.scalar_type() == kQUInt8) {
+    qsoftmax_lastdim_kernel<c10::quint8>(qx_contig, qy);
+  } else if (qx.scalar_type() == kQInt8) {
+    qsoftmax_lastdim_kernel<c10::qint8>(qx_contig, qy);
+  } else {
+    TORCH_CHECK(false, "quantized::softmax only supports quint8 and qint8 inputs, but got ",
+                qx.scalar_type());
+  }
+  return transposed ? qy.transpose(dim, -1) : qy;
+}
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
+  m.impl("softmax", TORCH_FN(quantized_softmax));
+}
+
+} // namespace
+
+}} // namespace at::native
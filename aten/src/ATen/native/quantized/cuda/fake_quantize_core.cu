@@ -1,9 +1,11 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/native/quantized/fake_quant_affine.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
+#include <algorithm>
 #include <cmath>
 
 /* Fake quantize a tensor
@@ -119,7 +121,92 @@ void _fake_quantize_grad_learnable_zero_point_tensor_kernel_cuda(
     });
 }
 
+// Fake quantize a contiguous tensor and record, for the backward pass, which
+// of its values were within [quant_min, quant_max] before clamping. The per
+// tensor kernel uses scale_val and zero_point_val, the per channel one reads
+// the qparams of the channel of every value.
+template <bool kPerChannel>
+__global__ void fake_quantize_cachemask_kernel_cuda(
+    const float* __restrict__ input,
+    float* __restrict__ output,
+    bool* __restrict__ mask,
+    int64_t numel,
+    float scale_val,
+    int64_t zero_point_val,
+    const float* __restrict__ scale,
+    const int64_t* __restrict__ zero_point,
+    int64_t channels,
+    int64_t elements_per_channel,
+    int64_t quant_min,
+    int64_t quant_max) {
+  for (int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; i < numel;
+       i += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    float sc = scale_val;
+    int64_t z_point = zero_point_val;
+    int64_t xq;
+    // Same rounding as the per tensor and per channel kernels above
+    if (kPerChannel) {
+      const int64_t c = (i / elements_per_channel) % channels;
+      sc = scale[c];
+      z_point = zero_point[c];
+      xq = static_cast<int64_t>(std::nearbyint(input[i] * (1.0f / sc) + z_point));
+    } else {
+      xq = static_cast<int64_t>(z_point + std::nearbyint(input[i] * (1.0f / sc)));
+    }
+    mask[i] = xq >= quant_min && xq <= quant_max;
+    output[i] = (std::min(std::max(xq, quant_min), quant_max) - z_point) * sc;
+  }
+}
+
+template <bool kPerChannel>
+void launch_fake_quantize_cachemask_kernel_cuda(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float scale_val,
+    int64_t zero_point_val,
+    const float* scale,
+    const int64_t* zero_point,
+    int64_t channels,
+    int64_t elements_per_channel,
+    int64_t quant_min,
+    int64_t quant_max) {
+  const int64_t numel = input.numel();
+  constexpr int64_t threads = 512;
+  const int64_t max_blocks = at::cuda::getCurrentDeviceProperties()->maxGridSize[0];
+  const int64_t blocks = std::min((numel + threads - 1) / threads, max_blocks);
+  fake_quantize_cachemask_kernel_cuda<kPerChannel>
+      <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(
+          input.data_ptr<float>(),
+          output.data_ptr<float>(),
+          mask.data_ptr<bool>(),
+          numel,
+          scale_val,
+          zero_point_val,
+          scale,
+          zero_point,
+          channels,
+          elements_per_channel,
+          quant_min,
+          quant_max);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+void fake_quantize_tensor_cachemask_kernel_cuda(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  launch_fake_quantize_cachemask_kernel_cuda</*kPerChannel=*/false>(
+      output, mask, input, scale, zero_point, nullptr, nullptr, 1, 1,
+      quant_min, quant_max);
+}
+
 REGISTER_DISPATCH(fake_quant_tensor_stub, &fake_quantize_tensor_kernel_cuda);
+REGISTER_DISPATCH(fake_quant_tensor_cachemask_stub, &fake_quantize_tensor_cachemask_kernel_cuda);
 REGISTER_DISPATCH(fake_quant_grad_tensor_stub, &fake_quantize_grad_tensor_kernel_cuda);
 REGISTER_DISPATCH(fake_quant_grad_learnable_scale_tensor_stub, &_fake_quantize_grad_learnable_scale_tensor_kernel_cuda);
 REGISTER_DISPATCH(fake_quant_grad_learnable_zero_point_tensor_stub, &_fake_quantize_grad_learnable_zero_point_tensor_kernel_cuda);
@@ -200,7 +287,23 @@ void _fake_quantize_grad_learnable_zero_point_channel_kernel_cuda(
     });
 }
 
+void fake_quant_per_channel_cachemask_cuda(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    const Tensor& scale,
+    const Tensor& zero_point,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max) {
+  launch_fake_quantize_cachemask_kernel_cuda</*kPerChannel=*/true>(
+      output, mask, input, 0.f, 0, scale.data_ptr<float>(),
+      zero_point.data_ptr<int64_t>(), input.size(axis),
+      size_from_dim_(axis + 1, input.sizes()), quant_min, quant_max);
+}
+
 REGISTER_DISPATCH(fake_quant_per_channel_stub, &fake_quant_per_channel_cuda);
+REGISTER_DISPATCH(fake_quant_per_channel_cachemask_stub, &fake_quant_per_channel_cachemask_cuda);
 REGISTER_DISPATCH(fake_quant_grad_per_channel_stub, &fake_quant_grad_per_channel_cuda);
 REGISTER_DISPATCH(fake_quant_grad_learnable_scale_channel_stub, &_fake_quantize_grad_learnable_scale_channel_kernel_cuda);
 REGISTER_DISPATCH(fake_quant_grad_learnable_zero_point_channel_stub, &_fake_quantize_grad_learnable_zero_point_channel_kernel_cuda);
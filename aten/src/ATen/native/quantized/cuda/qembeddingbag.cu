@@ -0,0 +1,327 @@
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <torch/library.h>
+
+#include <c10/macros/Macros.h>
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int64_t MODE_SUM = 0;
+constexpr int64_t MODE_MEAN = 1;
+constexpr int64_t MODE_MAX = 2;
+
+// Bags handled by a block, one per warp
+constexpr int kWarpsPerBlock = 4;
+// Columns a lane handles at a time, the vectorized path loads them at once
+constexpr int kColsPerLane = 4;
+
+// The tables use the fused rowwise layout of the CPU ops, see
+// Note [Fused rowwise quantized EmbeddingBag] in cpu/qembeddingbag.cpp, so a
+// table prepacked on CPU can just be moved to the GPU. Unless
+// D % kColsPerLane == 0, the rows are not aligned for the scale and bias,
+// which are then read byte by byte.
+template <typename T, bool kAligned>
+__device__ __forceinline__ T load_scalar(const uint8_t* p) {
+  if (kAligned) {
+    return *reinterpret_cast<const T*>(p);
+  }
+  T value;
+  memcpy(&value, p, sizeof(T));
+  return value;
+}
+
+template <int BIT_WIDTH, bool kVectorized>
+__device__ __forceinline__ void row_scale_bias(
+    const uint8_t* row, int64_t D, float* scale, float* bias) {
+  if (BIT_WIDTH == 8) {
+    *scale = load_scalar<float, kVectorized>(row + D);
+    *bias = load_scalar<float, kVectorized>(row + D + sizeof(float));
+  } else {
+    constexpr int NUM_ELEM_PER_BYTE = 8 / BIT_WIDTH;
+    const uint8_t* scale_bias = row + (D + NUM_ELEM_PER_BYTE - 1) / NUM_ELEM_PER_BYTE;
+    *scale = __half2float(load_scalar<__half, kVectorized>(scale_bias));
+    *bias = __half2float(load_scalar<__half, kVectorized>(scale_bias + sizeof(__half)));
+  }
+}
+
+// Quantized values of the columns j..j+kColsPerLane-1 of a row. The
+// vectorized path reads them with one 32-bit (8-bit) or 16-bit (4-bit) load,
+// which needs D % kColsPerLane == 0 for the rows to stay aligned.
+template <int BIT_WIDTH, bool kVectorized>
+__device__ __forceinline__ void load_quantized(
+    const uint8_t* row, int64_t j, int64_t D, float* values) {
+  constexpr int NUM_ELEM_PER_BYTE = 8 / BIT_WIDTH;
+  constexpr uint32_t kMask = (1u << BIT_WIDTH) - 1;
+  if (kVectorized) {
+    uint32_t packed = BIT_WIDTH == 8
+        ? *reinterpret_cast<const uint32_t*>(row + j)
+        : *reinterpret_cast<const uint16_t*>(row + j / NUM_ELEM_PER_BYTE);
+#pragma unroll
+    for (int k = 0; k < kColsPerLane; k++) {
+      values[k] = (packed >> (k * BIT_WIDTH)) & kMask;
+    }
+  } else {
+#pragma unroll
+    for (int k = 0; k < kColsPerLane; k++) {
+      const int64_t col = j + k;
+      values[k] = col < D
+          ? (row[col / NUM_ELEM_PER_BYTE] >> ((col % NUM_ELEM_PER_BYTE) * BIT_WIDTH)) & kMask
+          : 0.f;
+    }
+  }
+}
+
+// Every bag is reduced by one warp: the lanes split the columns, so the rows
+// of the bag are read with coalesced loads and every lane accumulates its
+// columns in registers, with no communication between the lanes.
+//
+// offsets has output_size + 1 entries, the last one being the number of
+// indices.
+template <int BIT_WIDTH, bool kVectorized>
+__global__ void embedding_bag_nbit_rowwise_offsets_kernel(
+    const uint8_t* __restrict__ weight,
+    int64_t num_rows,
+    int64_t row_bytes,
+    int64_t D,
+    const int64_t* __restrict__ indices,
+    const int64_t* __restrict__ offsets,
+    int64_t output_size,
+    int64_t mode,
+    const float* __restrict__ per_sample_weights,
+    const int32_t* __restrict__ compressed_indices_mapping,
+    int64_t compressed_index_size,
+    float* __restrict__ output) {
+  for (int64_t bag = blockIdx.x * blockDim.y + threadIdx.y; bag < output_size;
+       bag += gridDim.x * blockDim.y) {
+    const int64_t begin = offsets[bag];
+    const int64_t end = offsets[bag + 1];
+    CUDA_KERNEL_ASSERT(end >= begin);
+    float* out = output + bag * D;
+
+    for (int64_t j = threadIdx.x * kColsPerLane; j < D; j += blockDim.x * kColsPerLane) {
+      float acc[kColsPerLane];
+#pragma unroll
+      for (int k = 0; k < kColsPerLane; k++) {
+        acc[k] = mode == MODE_MAX ? -INFINITY : 0.f;
+      }
+      bool found = false;
+
+      for (int64_t i = begin; i < end; i++) {
+        int64_t idx = indices[i];
+        if (compressed_indices_mapping) {
+          CUDA_KERNEL_ASSERT(idx >= 0 && idx < compressed_index_size);
+          idx = compressed_indices_mapping[idx];
+          if (idx == -1) {
+            continue;
+          }
+        }
+        CUDA_KERNEL_ASSERT(idx >= 0 && idx < num_rows);
+        found = true;
+
+        const uint8_t* row = weight + idx * row_bytes;
+        float scale, bias;
+        row_scale_bias<BIT_WIDTH, kVectorized>(row, D, &scale, &bias);
+        float values[kColsPerLane];
+        load_quantized<BIT_WIDTH, kVectorized>(row, j, D, values);
+        if (mode == MODE_MAX) {
+#pragma unroll
+          for (int k = 0; k < kColsPerLane; k++) {
+            acc[k] = fmaxf(acc[k], fmaf(scale, values[k], bias));
+          }
+        } else {
+          if (per_sample_weights) {
+            scale *= per_sample_weights[i];
+            bias *= per_sample_weights[i];
+          }
+#pragma unroll
+          for (int k = 0; k < kColsPerLane; k++) {
+            acc[k] = fmaf(scale, values[k], acc[k] + bias);
+          }
+        }
+      }
+
+      if (mode == MODE_MAX && !found) {
+        // like embedding_bag, an empty bag is all zeros
+#pragma unroll
+        for (int k = 0; k < kColsPerLane; k++) {
+          acc[k] = 0.f;
+        }
+      } else if (mode == MODE_MEAN && end > begin) {
+        const float inv_bag_size = 1.f / (end - begin);
+#pragma unroll
+        for (int k = 0; k < kColsPerLane; k++) {
+          acc[k] *= inv_bag_size;
+        }
+      }
+
+      if (kVectorized) {
+        *reinterpret_cast<float4*>(out + j) = make_float4(acc[0], acc[1], acc[2], acc[3]);
+      } else {
+#pragma unroll
+        for (int k = 0; k < kColsPerLane; k++) {
+          if (j + k < D) {
+            out[j + k] = acc[k];
+          }
+        }
+      }
+    }
+  }
+}
+
+int64_t embedding_dim_from_packed_cols(int64_t bit_width, int64_t packed_cols) {
+  if (bit_width == 8) {
+    // NB: -8 to account for the fp32 scale and bias
+    return packed_cols - 2 * sizeof(float);
+  }
+  // NB: the last 4 bytes are the fp16 scale and bias
+  return (packed_cols - 2 * sizeof(at::Half)) * (8 / bit_width);
+}
+
+template <int BIT_WIDTH>
+Tensor embedding_bag_nbit_impl_cuda(
+    const Tensor& weight,
+    const Tensor& indices_,
+    const Tensor& offsets,
+    int64_t mode,
+    bool pruned_weights,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  static_assert(BIT_WIDTH == 8 || BIT_WIDTH == 4, "unsupported bit width");
+  TORCH_CHECK(weight.scalar_type() == at::kByte, "embedding_bag: expected a prepacked uint8 weight");
+  TORCH_CHECK(weight.dim() == 2, "embedding_bag: expected a 2-D weight");
+  TORCH_CHECK(indices_.dim() == 1, "embedding_bag: expected 1-D indices");
+  TORCH_CHECK(offsets.dim() == 1, "embedding_bag: expected 1-D offsets");
+  TORCH_CHECK(
+      indices_.device() == weight.device() && offsets.device() == weight.device(),
+      "embedding_bag: expected weight, indices and offsets on the same device");
+  TORCH_CHECK(
+      mode == MODE_SUM || mode == MODE_MEAN || mode == MODE_MAX,
+      "embedding_bag: unknown mode ", mode);
+  TORCH_CHECK(
+      !per_sample_weights_.has_value() || mode == MODE_SUM,
+      "embedding_bag: per_sample_weights only supported with mode='sum'");
+  if (include_last_offset) {
+    TORCH_CHECK(
+        offsets.size(0) >= 1,
+        "include_last_offset: number of offset should be at least 1");
+  }
+  const c10::cuda::CUDAGuard device_guard(weight.device());
+
+  const Tensor weight_contig = weight.contiguous();
+  const Tensor indices = indices_.to(kLong).contiguous();
+  const int64_t N = weight.size(0);
+  const int64_t row_bytes = weight.size(1);
+  const int64_t D = embedding_dim_from_packed_cols(BIT_WIDTH, row_bytes);
+  const int64_t index_size = indices.numel();
+  const int64_t output_size =
+      include_last_offset ? offsets.size(0) - 1 : offsets.size(0);
+
+  Tensor offsets_with_end = offsets.to(kLong);
+  if (!include_last_offset) {
+    offsets_with_end = at::cat({offsets_with_end, at::full({1}, index_size, offsets_with_end.options())});
+  }
+  offsets_with_end = offsets_with_end.contiguous();
+
+  Tensor per_sample_weights;
+  const float* per_sample_weights_data = nullptr;
+  if (per_sample_weights_.has_value()) {
+    per_sample_weights = per_sample_weights_.value().to(kFloat).contiguous();
+    TORCH_CHECK(
+        per_sample_weights.numel() == index_size,
+        "embedding_bag: expected one per_sample_weight per index");
+    TORCH_CHECK(
+        per_sample_weights.device() == weight.device(),
+        "embedding_bag: expected per_sample_weights on the device of the weight");
+    per_sample_weights_data = per_sample_weights.data_ptr<float>();
+  }
+
+  Tensor mapping;
+  const int32_t* compressed_indices_mapping_data = nullptr;
+  int64_t compressed_index_size = 0;
+  if (pruned_weights) {
+    TORCH_CHECK(
+        compressed_indices_mapping.has_value(),
+        "embedding_bag: compressed_indices_mapping is required for pruned weights (sparse=True)");
+    mapping = compressed_indices_mapping.value().to(weight.device(), kInt).contiguous();
+    compressed_index_size = mapping.numel();
+    compressed_indices_mapping_data = mapping.data_ptr<int32_t>();
+  }
+
+  auto output = at::empty({output_size, D}, weight.options().dtype(at::kFloat));
+  if (output_size == 0 || D == 0) {
+    return output;
+  }
+
+  const uint8_t* weight_data = weight_contig.data_ptr<uint8_t>();
+  const bool vectorized = D % kColsPerLane == 0 &&
+      reinterpret_cast<uintptr_t>(weight_data) % sizeof(uint32_t) == 0;
+  const dim3 block(C10_WARP_SIZE, kWarpsPerBlock);
+  const int64_t max_grid = at::cuda::getCurrentDeviceProperties()->maxGridSize[0];
+  const dim3 grid(std::min<int64_t>((output_size + kWarpsPerBlock - 1) / kWarpsPerBlock, max_grid));
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  auto launch = [&](auto kernel) {
+    kernel<<<grid, block, 0, stream>>>(
+        weight_data, N, row_bytes, D,
+        indices.data_ptr<int64_t>(), offsets_with_end.data_ptr<int64_t>(),
+        output_size, mode, per_sample_weights_data,
+        compressed_indices_mapping_data, compressed_index_size,
+        output.data_ptr<float>());
+  };
+  if (vectorized) {
+    launch(embedding_bag_nbit_rowwise_offsets_kernel<BIT_WIDTH, true>);
+  } else {
+    launch(embedding_bag_nbit_rowwise_offsets_kernel<BIT_WIDTH, false>);
+  }
+  AT_CUDA_CHECK(cudaGetLastError());
+  return output;
+}
+
+Tensor embedding_bag_byte_rowwise_offsets_cuda(
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const bool /* scale_grad_by_freq */,
+    const int64_t mode,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  return embedding_bag_nbit_impl_cuda<8>(
+      weight, indices, offsets, mode, sparse, per_sample_weights_,
+      compressed_indices_mapping, include_last_offset);
+}
+
+Tensor embedding_bag_4bit_rowwise_offsets_cuda(
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const bool /* scale_grad_by_freq */,
+    const int64_t mode,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  return embedding_bag_nbit_impl_cuda<4>(
+      weight, indices, offsets, mode, sparse, per_sample_weights_,
+      compressed_indices_mapping, include_last_offset);
+}
+
+} // namespace
+
+TORCH_LIBRARY_IMPL(quantized, CUDA, m) {
+    m.impl("embedding_bag_byte_rowwise_offsets", embedding_bag_byte_rowwise_offsets_cuda);
+    m.impl("embedding_bag_4bit_rowwise_offsets", embedding_bag_4bit_rowwise_offsets_cuda);
+}
+
+}
+}
@@ -11,6 +11,7 @@ namespace native {
 
 // Use REGISTER_DISPATCH to run CPU and CUDA backend.
 DEFINE_DISPATCH(fake_quant_per_channel_stub);
+DEFINE_DISPATCH(fake_quant_per_channel_cachemask_stub);
 DEFINE_DISPATCH(fake_quant_grad_per_channel_stub);
 DEFINE_DISPATCH(fake_quant_grad_learnable_scale_channel_stub);
 DEFINE_DISPATCH(fake_quant_grad_learnable_zero_point_channel_stub);
@@ -82,6 +83,80 @@ Tensor fake_quantize_per_channel_affine(
   return Y;
 }
 
+/* Per channel fake-quantizes the 'inputs' tensor, saving a mask for the
+backward pass, see fake_quantize_per_tensor_affine_cachemask.
+Args:
+  X: Forward input tensor.
+  scale: scale of per channel affine quantization
+  zero_point: zero_point of per channel affine quantization
+  axis: int specifying the axis to be quantized
+  quant_min: minimum quantized value
+  quant_max: maximum quantized value
+Returns:
+  Fake quantized tensor (float dtype) and the bool mask of the values of X
+  within [quant_min, quant_max] after quantization.
+
+*/
+std::tuple<Tensor, Tensor> fake_quantize_per_channel_affine_cachemask(
+    const Tensor& self,
+    const Tensor& scale,
+    const Tensor& zero_point,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max) {
+  TORCH_CHECK(self.scalar_type() == ScalarType::Float);
+  TORCH_CHECK(scale.scalar_type() == ScalarType::Float,
+              "Scale must be Float, found ", scale.scalar_type());
+  TORCH_CHECK(zero_point.scalar_type() == ScalarType::Long,
+              "Zero-point must be Long, found ", zero_point.scalar_type());
+  TORCH_CHECK(scale.dim() == 1, "scale should be a 1-D tensor");
+  TORCH_CHECK(zero_point.dim() == 1, "zero point should be a 1-D tensor");
+  TORCH_CHECK(
+      axis >= 0 && axis < self.dim(),
+      "`axis` must be between 0 and number of dimensions of input");
+  TORCH_CHECK(
+      scale.numel() == zero_point.numel(),
+      "scale and zero-point need to have the same dimensions");
+  TORCH_CHECK(
+      scale.numel() == self.size(axis),
+      "dimensions of scale and zero-point are not consistent with input tensor")
+
+  TORCH_CHECK(
+      quant_min <= quant_max,
+      "`quant_min` should be less than or \
+        equal to `quant_max`.");
+
+  TORCH_CHECK(
+      at::min(zero_point).item().toLong() >= quant_min &&
+          at::max(zero_point).item().toLong() <= quant_max,
+      "`zero_point` must be between `quant_min` and `quant_max`.");
+
+  auto X = self.contiguous();
+  auto Y = at::empty_like(X, X.options(), MemoryFormat::Contiguous);
+  auto mask = at::empty_like(X, X.options().dtype(at::kBool), MemoryFormat::Contiguous);
+  if (X.numel() > 0) {
+    fake_quant_per_channel_cachemask_stub(
+        X.device().type(), Y, mask, X, scale.contiguous(),
+        zero_point.contiguous(), axis, quant_min, quant_max);
+  }
+  return std::make_tuple(Y, mask);
+}
+
+Tensor fake_quantize_per_channel_affine_cachemask_backward(
+    const Tensor& dY,
+    const Tensor& mask) {
+  TORCH_CHECK(mask.scalar_type() == ScalarType::Bool);
+  TORCH_CHECK(mask.numel() == dY.numel(),
+      "`mask` and `dY` are not the same size: ",
+      "`mask` is size ", mask.numel(), " and `dY` is size ", dY.numel());
+  if (dY.numel() <= 0) {
+    return dY;
+  }
+  // Note: no additional kernels needed, since mask is pre-computed
+  // and we can use the existing tensor multiplication kernels.
+  return dY * mask;
+}
+
 /* Backward path for per-channel fake-quantization of the 'inputs' tensor.
 
 Args:
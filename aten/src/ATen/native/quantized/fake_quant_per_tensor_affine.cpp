@@ -11,6 +11,7 @@ namespace native {
 
 // Use REGISTER_DISPATCH to run CPU and CUDA backend.
 DEFINE_DISPATCH(fake_quant_tensor_stub);
+DEFINE_DISPATCH(fake_quant_tensor_cachemask_stub);
 DEFINE_DISPATCH(fake_quant_grad_tensor_stub);
 DEFINE_DISPATCH(fake_quant_grad_learnable_scale_tensor_stub);
 DEFINE_DISPATCH(fake_quant_grad_learnable_zero_point_tensor_stub);
@@ -48,6 +49,63 @@ Tensor fake_quantize_per_tensor_affine(
   return Y;
 }
 
+/* Fake-quantizes the 'inputs' tensor, saving a mask for the backward pass.
+Args:
+  X: Forward input tensor.
+  scale: scale of per tensor affine quantization
+  zero_point: zero_point of per tensor affine quantization
+  quant_min: minimum quantized value
+  quant_max: maximum quantized value
+Returns:
+  Fake quantized tensor (float dtype) and the bool mask of the values of X
+  within [quant_min, quant_max] after quantization.
+
+Unlike fake_quantize_per_tensor_affine, whose backward quantizes X again,
+the backward only multiplies the gradient by the mask, and autograd keeps the
+1 byte mask alive instead of the float input.
+*/
+std::tuple<Tensor, Tensor> fake_quantize_per_tensor_affine_cachemask(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  TORCH_CHECK(self.scalar_type() == ScalarType::Float);
+  TORCH_CHECK(
+      quant_min <= quant_max,
+      "`quant_min` should be less than or \
+        equal to `quant_max`.");
+  TORCH_CHECK(
+      zero_point >= quant_min && zero_point <= quant_max,
+      "`zero_point` must be between `quant_min` and `quant_max`.");
+
+  // Elementwise, so the kernel runs over the memory of X in whichever
+  // (dense) memory format it is, and Y and the mask share its strides.
+  auto X = self.contiguous(self.suggest_memory_format());
+  auto Y = at::empty_like(X, X.options(), MemoryFormat::Preserve);
+  auto mask = at::empty_like(X, X.options().dtype(at::kBool), MemoryFormat::Preserve);
+  if (X.numel() > 0) {
+    fake_quant_tensor_cachemask_stub(
+        X.device().type(), Y, mask, X, scale, zero_point, quant_min, quant_max);
+  }
+  return std::make_tuple(Y, mask);
+}
+
+Tensor fake_quantize_per_tensor_affine_cachemask_backward(
+    const Tensor& dY,
+    const Tensor& mask) {
+  TORCH_CHECK(mask.scalar_type() == ScalarType::Bool);
+  TORCH_CHECK(mask.numel() == dY.numel(),
+      "`mask` and `dY` are not the same size: ",
+      "`mask` is size ", mask.numel(), " and `dY` is size ", dY.numel());
+  if (dY.numel() <= 0) {
+    return dY;
+  }
+  // Note: no additional kernels needed, since mask is pre-computed
+  // and we can use the existing tensor multiplication kernels.
+  return dY * mask;
+}
+
 /* Backward path to fake-quantize the 'inputs' tensor.
 
 Args:
@@ -0,0 +1,210 @@
+// Basic functions on sparse CSR tensors
+
+#include <ATen/ATen.h>
+#include <ATen/Layout.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+int64_t _nnz_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->nnz();
+}
+
+Tensor crow_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->crow_indices().alias();
+}
+
+Tensor col_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->col_indices().alias();
+}
+
+Tensor values_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->values().alias();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+namespace {
+
+SparseCsrTensor new_sparse_csr(const TensorOptions& options) {
+  TORCH_INTERNAL_ASSERT(impl::variable_excluded_from_dispatch());
+  DispatchKey dispatch_key;
+  if (options.device().is_cuda()) {
+    dispatch_key = DispatchKey::SparseCsrCUDA;
+  } else {
+    TORCH_CHECK(options.device().is_cpu(), "sparse CSR tensors are only supported on CPU and CUDA, but got device ", options.device());
+    dispatch_key = DispatchKey::SparseCsrCPU;
+  }
+  return detail::make_tensor<SparseCsrTensorImpl>(
+      DispatchKeySet(dispatch_key), options.dtype());
+}
+
+// NOTE: There is no guarantee that the member tensors don't contain
+// AutogradMeta. However, we want to maintain the invariant that the members
+// of a sparse CSR tensor don't contain AutogradMeta, like the indices_ and
+// values_ of a COO tensor, so we shallow-copy them here.
+Tensor shallow_copy_without_autograd(const Tensor& t) {
+  return Tensor(t.unsafeGetTensorImpl()->shallow_copy_and_detach(
+    /*version_counter=*/t.unsafeGetTensorImpl()->version_counter(),
+    /*allow_tensor_metadata_change=*/true));
+}
+
+SparseCsrTensor new_with_tensors_sparse_csr(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  SparseCsrTensor self = new_sparse_csr(values.options());
+  get_sparse_csr_impl(self)->set_member_tensors_unsafe(
+      shallow_copy_without_autograd(crow_indices),
+      shallow_copy_without_autograd(col_indices),
+      shallow_copy_without_autograd(values),
+      size);
+  return self;
+}
+
+// Row index of every nonzero of a CSR matrix, i.e. the COO row indices.
+Tensor rows_from_crow_indices(const Tensor& crow_indices) {
+  int64_t nrows = crow_indices.size(0) - 1;
+  Tensor counts = crow_indices.narrow(0, 1, nrows) - crow_indices.narrow(0, 0, nrows);
+  return at::repeat_interleave(at::arange(nrows, crow_indices.options().dtype(kLong)), counts.to(kLong));
+}
+
+// CSR matrix from COO row and column indices that are sorted by row.
+SparseCsrTensor sparse_csr_from_sorted_coo(
+    const Tensor& rows,
+    const Tensor& cols,
+    const Tensor& values,
+    IntArrayRef size) {
+  int64_t nrows = size[0];
+  Tensor crow_indices = at::zeros({nrows + 1}, rows.options().dtype(kLong));
+  if (rows.numel() > 0) {
+    crow_indices.narrow(0, 1, nrows).copy_(at::bincount(rows, {}, nrows).cumsum(0));
+  }
+  return new_with_tensors_sparse_csr(crow_indices, cols.to(kLong).contiguous(), values.contiguous(), size);
+}
+
+} // anonymous namespace
+
+// Checks everything set_member_tensors_unsafe trusts: that crow_indices starts
+// at 0, ends at nnz and is non-decreasing, and that the column indices are in
+// bounds. Like _validate_sparse_coo_tensor_args, this synchronizes with the
+// device the indices are on.
+void _validate_sparse_csr_tensor_args(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, IntArrayRef size) {
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-dimensional, but got size ", size);
+  TORCH_CHECK(!crow_indices.is_sparse() && !crow_indices.is_sparse_csr() &&
+              !col_indices.is_sparse() && !col_indices.is_sparse_csr() &&
+              !values.is_sparse() && !values.is_sparse_csr(),
+      "crow_indices, col_indices and values must be dense tensors");
+  TORCH_CHECK(crow_indices.dim() == 1 && col_indices.dim() == 1 && values.dim() == 1,
+      "crow_indices, col_indices and values must be 1-dimensional, but got ",
+      crow_indices.sizes(), ", ", col_indices.sizes(), " and ", values.sizes());
+  TORCH_CHECK(crow_indices.scalar_type() == col_indices.scalar_type(),
+      "crow_indices and col_indices must have the same dtype, but got ", crow_indices.scalar_type(), " and ", col_indices.scalar_type());
+  TORCH_CHECK(crow_indices.scalar_type() == kInt || crow_indices.scalar_type() == kLong,
+      "crow_indices and col_indices must be int32 or int64 tensors, but got ", crow_indices.scalar_type());
+  TORCH_CHECK(crow_indices.size(0) == size[0] + 1,
+      "crow_indices must have nrows + 1 = ", size[0] + 1, " entries, but got ", crow_indices.size(0));
+  TORCH_CHECK(col_indices.size(0) == values.size(0),
+      "col_indices and values must have same nnz, but got nnz from col_indices: ", col_indices.size(0),
+      ", nnz from values: ", values.size(0));
+
+  int64_t nnz = values.size(0);
+  TORCH_CHECK(crow_indices.select(0, 0).item<int64_t>() == 0, "crow_indices[0] must be 0");
+  TORCH_CHECK(crow_indices.select(0, size[0]).item<int64_t>() == nnz,
+      "crow_indices[nrows] must be nnz = ", nnz, ", but got ", crow_indices.select(0, size[0]).item<int64_t>());
+  if (size[0] > 0) {
+    TORCH_CHECK((crow_indices.narrow(0, 1, size[0]) >= crow_indices.narrow(0, 0, size[0])).all().item<bool>(),
+        "crow_indices must be non-decreasing");
+  }
+  if (nnz > 0) {
+    int64_t min_col = col_indices.min().item<int64_t>();
+    int64_t max_col = col_indices.max().item<int64_t>();
+    TORCH_CHECK(min_col >= 0, "found negative column index ", min_col);
+    TORCH_CHECK(max_col < size[1], "column index ", max_col, " is out of bounds for ncols = ", size[1]);
+  }
+}
+
+Tensor sparse_csr_tensor(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values_,
+                         IntArrayRef size, const TensorOptions& options) {
+  TORCH_CHECK(!options.has_layout() || options.layout() == kSparseCsr, "expected sparse CSR layout, but got layout ", options.layout());
+  TORCH_CHECK(!options.pinned_memory(), "Only dense CPU tensors can be pinned");
+
+  Tensor values = values_;
+  if (options.has_dtype()) {
+    values = values.to(typeMetaToScalarType(options.dtype()));
+  }
+  Device device = options.has_device() ? options.device() : values.device();
+  at::native::_validate_sparse_csr_tensor_args(crow_indices, col_indices, values, size);
+  return new_with_tensors_sparse_csr(
+      crow_indices.to(device), col_indices.to(device), values.to(device), size);
+}
+
+// The number of columns is inferred from the largest column index.
+Tensor sparse_csr_tensor(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values,
+                         const TensorOptions& options) {
+  TORCH_CHECK(crow_indices.dim() == 1 && crow_indices.size(0) > 0,
+      "crow_indices must be a non-empty 1-dimensional tensor, but got ", crow_indices.sizes());
+  int64_t nrows = crow_indices.size(0) - 1;
+  int64_t ncols = col_indices.numel() > 0 ? col_indices.max().item<int64_t>() + 1 : 0;
+  return at::native::sparse_csr_tensor(crow_indices, col_indices, values, {nrows, ncols}, options);
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+Tensor sparse_csr_to_dense(const SparseCsrTensor& self) {
+  Tensor dense = at::zeros(self.sizes(), self.options().layout(kStrided));
+  if (self._nnz() > 0) {
+    auto impl = get_sparse_csr_impl(self);
+    Tensor rows = rows_from_crow_indices(impl->crow_indices());
+    // accumulate, since duplicate entries are summed
+    dense.index_put_({rows, impl->col_indices().to(kLong)}, impl->values(), /*accumulate=*/true);
+  }
+  return dense;
+}
+
+Tensor sparse_csr_to_sparse(const SparseCsrTensor& self) {
+  auto impl = get_sparse_csr_impl(self);
+  Tensor rows = rows_from_crow_indices(impl->crow_indices());
+  Tensor indices = at::stack({rows, impl->col_indices().to(kLong)});
+  // Not coalesced: the columns of a row need not be sorted or unique
+  return at::_sparse_coo_tensor_unsafe(indices, impl->values(), self.sizes(), self.options().layout(kSparse));
+}
+
+SparseCsrTensor dense_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.dim() == 2, "to_sparse_csr: expected a 2-dimensional tensor, but got ", self.dim(), "D tensor");
+  // nonzero() lists the nonzeros in row major order, i.e. sorted by row
+  Tensor nz = self.nonzero();
+  Tensor rows = nz.select(1, 0);
+  Tensor cols = nz.select(1, 1);
+  return sparse_csr_from_sorted_coo(rows, cols, self.index({rows, cols}), self.sizes());
+}
+
+SparseCsrTensor sparse_to_sparse_csr(const at::sparse::SparseTensor& self) {
+  TORCH_CHECK(self.sparse_dim() == 2 && self.dense_dim() == 0,
+      "to_sparse_csr: expected a sparse matrix with scalar values, but got sparse_dim = ", self.sparse_dim(),
+      " and dense_dim = ", self.dense_dim());
+  // a coalesced tensor is sorted by row
+  auto coalesced = self.coalesce();
+  Tensor indices = coalesced._indices();
+  return sparse_csr_from_sorted_coo(indices.select(0, 0), indices.select(0, 1), coalesced._values(), self.sizes());
+}
+
+SparseCsrTensor sparse_csr_to_sparse_csr(const SparseCsrTensor& self) {
+  return self;
+}
+
+}} // namespace at::native
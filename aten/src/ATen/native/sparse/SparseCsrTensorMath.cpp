@@ -0,0 +1,182 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+// --------------------------------------------------------------------
+// addmm(D1, S, D2, beta, alpha) -> D  [broadcasts], S in CSR layout
+//
+// D = beta * D1 + alpha * mm(S, D2)
+// --------------------------------------------------------------------
+
+namespace {
+
+// Every row of the result only depends on its own row of S, so rows are
+// computed in parallel without any synchronization. dim_k == 1 is the
+// matrix-vector product mv() reaches through mm(): it accumulates a dot
+// product per row instead of an axpy per nonzero.
+template <typename scalar_t, typename index_t>
+void s_addmm_out_sparse_csr_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_k, Tensor& r, Scalar alpha,
+                                         const Tensor& crow_indices, const Tensor& col_indices,
+                                         const Tensor& values, const Tensor& dense) {
+  scalar_t cast_alpha = alpha.to<scalar_t>();
+
+  const index_t* crow_ptr = crow_indices.data_ptr<index_t>();
+  const index_t* col_ptr = col_indices.data_ptr<index_t>();
+  const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+  const scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
+  scalar_t* r_ptr = r.data_ptr<scalar_t>();
+
+  int64_t dense_stride0 = dense.stride(0);
+  int64_t dense_stride1 = dense.stride(1);
+  int64_t r_stride0 = r.stride(0);
+  int64_t r_stride1 = r.stride(1);
+
+  // aim for GRAIN_SIZE multiply-adds per task
+  int64_t work_per_row = std::max<int64_t>(1, (nnz / std::max<int64_t>(dim_i, 1)) * dim_k);
+  int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_row);
+
+  if (dim_k == 1) {
+    at::parallel_for(0, dim_i, grain_size, [&](int64_t start, int64_t end) {
+      for (int64_t row = start; row < end; row++) {
+        scalar_t sum = 0;
+        for (int64_t p = crow_ptr[row]; p < crow_ptr[row + 1]; p++) {
+          sum += values_ptr[p] * dense_ptr[col_ptr[p] * dense_stride0];
+        }
+        r_ptr[row * r_stride0] += cast_alpha * sum;
+      }
+    });
+    return;
+  }
+
+  at::parallel_for(0, dim_i, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; row++) {
+      scalar_t* r_row = r_ptr + row * r_stride0;
+      for (int64_t p = crow_ptr[row]; p < crow_ptr[row + 1]; p++) {
+        scalar_t val = cast_alpha * values_ptr[p];
+        const scalar_t* dense_row = dense_ptr + col_ptr[p] * dense_stride0;
+        for (int64_t k = 0; k < dim_k; k++) {
+          r_row[k * r_stride1] += val * dense_row[k * dense_stride1];
+        }
+      }
+    }
+  });
+}
+
+} // anonymous namespace
+
+Tensor& s_addmm_out_sparse_csr_dense_cpu(
+    Tensor& r,
+    const Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha
+) {
+  AT_ASSERT(!t.is_cuda());
+  TORCH_CHECK(!r.is_cuda(), "addmm: expected 'out' to be CPU tensor, but got CUDA tensor");
+  TORCH_CHECK(!sparse.is_cuda(), "addmm: expected 'mat1' to be a CPU tensor, but got a CUDA tensor");
+  TORCH_CHECK(!dense.is_cuda(), "addmm: expected 'mat2' to be a CPU tensor, but got a CUDA tensor");
+  TORCH_CHECK(!dense.is_sparse() && !dense.is_sparse_csr(), "addmm: expected 'mat2' to be a dense tensor");
+  TORCH_CHECK(dense.dim() == 2, "addmm: matrices expected, got ", dense.dim(), "D tensor");
+  TORCH_CHECK(dense.scalar_type() == sparse.scalar_type(),
+      "addmm: expected 'mat1' and 'mat2' to have the same dtype, but got ", sparse.scalar_type(), " and ", dense.scalar_type());
+
+  // ixj * jxk = ixk
+  int64_t dim_i = sparse.size(0);
+  int64_t dim_j = sparse.size(1);
+  int64_t dim_k = dense.size(1);
+
+  TORCH_CHECK(dense.size(0) == dim_j,
+      "addmm: Argument #3 (dense): Expected dim 0 size ", dim_j, ", got ", dense.size(0));
+  TORCH_CHECK(t.size(0) == dim_i,
+      "addmm: Argument #1 (t): Expected dim 0 size ", dim_i, ", got ", t.size(0));
+  TORCH_CHECK(t.size(1) == dim_k,
+      "addmm: Argument #1 (t): Expected dim 1 size ", dim_k, ", got ", t.size(1));
+
+  r.resize_({dim_i, dim_k});
+
+  // r = beta * t
+  if (beta.toComplexDouble() == 0.) {
+    r.zero_();
+  } else if (beta.toComplexDouble() == 1.) {
+    if (!at::sparse::is_same_tensor(r, t)) {
+      r.copy_(t);
+    }
+  } else {
+    at::mul_out(r, t, scalar_to_tensor(beta));
+  }
+
+  int64_t nnz = sparse._nnz();
+  if (nnz == 0 || dim_k == 0) {
+    return r;
+  }
+
+  // The indices were validated when the tensor was constructed, so unlike the
+  // COO kernel the worker does not bounds check them.
+  auto impl = get_sparse_csr_impl(sparse);
+  Tensor crow_indices = impl->crow_indices().contiguous();
+  Tensor col_indices = impl->col_indices().contiguous();
+  Tensor values = impl->values().contiguous();
+
+  AT_DISPATCH_ALL_TYPES(
+      values.scalar_type(), "addmm_sparse_csr_dense", [&] {
+        if (crow_indices.scalar_type() == kInt) {
+          s_addmm_out_sparse_csr_dense_worker<scalar_t, int32_t>(nnz, dim_i, dim_k, r, alpha, crow_indices, col_indices, values, dense);
+        } else {
+          s_addmm_out_sparse_csr_dense_worker<scalar_t, int64_t>(nnz, dim_i, dim_k, r, alpha, crow_indices, col_indices, values, dense);
+        }
+      }
+  );
+
+  return r;
+}
+
+Tensor& addmm_out_sparse_csr_dense_cpu(
+    Tensor& result,
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha
+) {
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  return s_addmm_out_sparse_csr_dense_cpu(result, b_self, mat1, mat2, beta, alpha);
+}
+
+Tensor addmm_sparse_csr_dense_cpu(
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha
+) {
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  Tensor r = at::empty({0}, b_self.options());
+  s_addmm_out_sparse_csr_dense_cpu(r, b_self, mat1, mat2, beta, alpha);
+  return r;
+}
+
+// NB: Purposely no broadcasting version of addmm inplace
+Tensor& s_addmm_sparse_csr_dense_cpu_(
+    Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha
+) {
+  return s_addmm_out_sparse_csr_dense_cpu(t, t, sparse, dense, beta, alpha);
+}
+
+}} // namespace at::native
@@ -0,0 +1,139 @@
+// Fused optimizer steps for the sparse gradients of embedding tables.
+//
+// torch.optim coalesces a sparse gradient, then builds several sparse
+// temporaries (sparse_mask of the state, the squared values, the update) and
+// adds them back into dense tensors. Here the uncoalesced gradient is only
+// grouped by row, which is all the non-linear updates need, and every
+// touched row of the parameter and of its state is updated in place in a
+// single pass, in parallel over the rows.
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseTensorUtils.h>
+#include <ATen/native/SparseOptimizers.h>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+using namespace at::sparse;
+
+DEFINE_DISPATCH(sparse_adagrad_stub);
+DEFINE_DISPATCH(rowwise_adagrad_stub);
+DEFINE_DISPATCH(sparse_adam_stub);
+
+namespace {
+
+void check_sparse_optimizer_args(const char* name, const Tensor& self, const SparseTensor& grad, TensorList states) {
+  TORCH_CHECK(!self.is_sparse() && self.dim() == 2 && self.is_contiguous(),
+      name, ": expected a contiguous 2-D dense parameter");
+  TORCH_CHECK(grad.is_sparse() && grad.sparse_dim() == 1 && grad.dense_dim() == 1,
+      name, ": expected a sparse gradient with one sparse and one dense dimension, e.g. the gradient of an embedding");
+  TORCH_CHECK(grad.sizes() == self.sizes(),
+      name, ": expected the gradient to have the size of the parameter ", self.sizes(),
+      ", but got ", grad.sizes());
+  TORCH_CHECK(grad.scalar_type() == self.scalar_type(),
+      name, ": expected the gradient to have the dtype of the parameter ", self.scalar_type(),
+      ", but got ", grad.scalar_type());
+  for (const auto& state : states) {
+    TORCH_CHECK(!state.is_sparse() && state.is_contiguous() && state.scalar_type() == self.scalar_type(),
+        name, ": expected contiguous dense optimizer state of dtype ", self.scalar_type());
+  }
+}
+
+// Groups the nnz gradient rows by the parameter row they belong to: returns
+// the distinct rows, the order of the gradient rows grouped by row, and the
+// offsets of the groups in that order. This is the part of coalesce() the
+// updates need, without summing the duplicate rows into a new tensor.
+std::tuple<Tensor, Tensor, Tensor> group_rows(const SparseTensor& grad) {
+  Tensor indices = grad._indices().select(0, 0);
+  int64_t num_rows = grad.size(0);
+  int64_t nnz = indices.numel();
+  Tensor sorted_indices, order;
+  if (grad.is_coalesced()) {
+    sorted_indices = indices.contiguous();
+    order = at::arange(nnz, indices.options());
+  } else {
+    std::tie(sorted_indices, order) = indices.sort();
+  }
+
+  const int64_t* sorted = sorted_indices.data_ptr<int64_t>();
+  std::vector<int64_t> rows, offsets;
+  rows.reserve(nnz);
+  offsets.reserve(nnz + 1);
+  for (int64_t i = 0; i < nnz; i++) {
+    if (i == 0 || sorted[i] != sorted[i - 1]) {
+      TORCH_CHECK(sorted[i] >= 0 && sorted[i] < num_rows,
+          "sparse optimizer: gradient index ", sorted[i], " is out of bounds for ", num_rows, " rows");
+      rows.push_back(sorted[i]);
+      offsets.push_back(i);
+    }
+  }
+  offsets.push_back(nnz);
+
+  auto options = indices.options();
+  Tensor rows_tensor = at::empty({static_cast<int64_t>(rows.size())}, options);
+  Tensor offsets_tensor = at::empty({static_cast<int64_t>(offsets.size())}, options);
+  std::copy(rows.begin(), rows.end(), rows_tensor.data_ptr<int64_t>());
+  std::copy(offsets.begin(), offsets.end(), offsets_tensor.data_ptr<int64_t>());
+  return std::make_tuple(rows_tensor, order.contiguous(), offsets_tensor);
+}
+
+} // anonymous namespace
+
+// state_sum += g * g
+// self -= lr * g / (sqrt(state_sum) + eps)
+// like torch.optim.Adagrad, with g the summed gradient of a row.
+Tensor& _sparse_adagrad_sparse_cpu_(Tensor& self, Tensor& state_sum, const SparseTensor& grad, double lr, double eps) {
+  check_sparse_optimizer_args("_sparse_adagrad_", self, grad, {state_sum});
+  TORCH_CHECK(state_sum.sizes() == self.sizes(), "_sparse_adagrad_: expected state_sum to have the size of the parameter");
+  if (grad._nnz() == 0) {
+    return self;
+  }
+  Tensor rows, order, row_offsets;
+  std::tie(rows, order, row_offsets) = group_rows(grad);
+  sparse_adagrad_stub(kCPU, self, state_sum, grad._values().contiguous(), rows, order, row_offsets, lr, eps);
+  return self;
+}
+
+// The state is one value per row, the running sum of the mean of g * g:
+// state_sum[row] += mean(g * g)
+// self[row] -= lr * g / (sqrt(state_sum[row]) + eps)
+// like the RowWiseSparseAdagrad operator of caffe2.
+Tensor& _rowwise_adagrad_sparse_cpu_(Tensor& self, Tensor& state_sum, const SparseTensor& grad, double lr, double eps) {
+  check_sparse_optimizer_args("_rowwise_adagrad_", self, grad, {state_sum});
+  TORCH_CHECK(state_sum.dim() == 1 && state_sum.size(0) == self.size(0),
+      "_rowwise_adagrad_: expected state_sum to have one value per row of the parameter");
+  if (grad._nnz() == 0) {
+    return self;
+  }
+  Tensor rows, order, row_offsets;
+  std::tie(rows, order, row_offsets) = group_rows(grad);
+  rowwise_adagrad_stub(kCPU, self, state_sum, grad._values().contiguous(), rows, order, row_offsets, lr, eps);
+  return self;
+}
+
+// exp_avg = beta1 * exp_avg + (1 - beta1) * g
+// exp_avg_sq = beta2 * exp_avg_sq + (1 - beta2) * g * g
+// self -= lr * sqrt(1 - beta2^step) / (1 - beta1^step) * exp_avg / (sqrt(exp_avg_sq) + eps)
+// like torch.optim.SparseAdam, where `step` counts this step.
+Tensor& _sparse_adam_sparse_cpu_(Tensor& self, Tensor& exp_avg, Tensor& exp_avg_sq, const SparseTensor& grad,
+                                 double lr, double beta1, double beta2, double eps, int64_t step) {
+  check_sparse_optimizer_args("_sparse_adam_", self, grad, {exp_avg, exp_avg_sq});
+  TORCH_CHECK(exp_avg.sizes() == self.sizes() && exp_avg_sq.sizes() == self.sizes(),
+      "_sparse_adam_: expected exp_avg and exp_avg_sq to have the size of the parameter");
+  TORCH_CHECK(step >= 1, "_sparse_adam_: expected step >= 1, but got ", step);
+  if (grad._nnz() == 0) {
+    return self;
+  }
+  Tensor rows, order, row_offsets;
+  std::tie(rows, order, row_offsets) = group_rows(grad);
+  double bias_correction1 = 1 - std::pow(beta1, step);
+  double bias_correction2 = 1 - std::pow(beta2, step);
+  double step_size = lr * std::sqrt(bias_correction2) / bias_correction1;
+  sparse_adam_stub(kCPU, self, exp_avg, exp_avg_sq, grad._values().contiguous(), rows, order, row_offsets,
+                   step_size, beta1, beta2, eps);
+  return self;
+}
+
+}} // namespace at::native
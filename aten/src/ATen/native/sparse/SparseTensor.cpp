@@ -10,6 +10,8 @@
 
 #include <TH/THBlasUtils.h>
 
+#include <numeric>
+
 namespace at { namespace native {
 
 using namespace at::sparse;
@@ -353,6 +355,83 @@ SparseTensor& copy_sparse_(SparseTensor& self, const SparseTensor& src, bool non
   return self._coalesced_(src.is_coalesced());
 }
 
+namespace {
+
+constexpr int kCoalesceRadixBits = 8;
+constexpr int64_t kCoalesceRadix = 1 << kCoalesceRadixBits;
+
+// Splits [0, n) into at most one chunk per thread, none smaller than
+// GRAIN_SIZE, and calls f(chunk, begin, end) for every chunk in parallel.
+template <typename F>
+void for_each_chunk(int64_t n, int64_t num_chunks, const F& f) {
+  const int64_t chunk_size = divup(n, num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      f(c, std::min(n, c * chunk_size), std::min(n, (c + 1) * chunk_size));
+    }
+  });
+}
+
+// Sorts the n keys along with their positions, with an LSD radix sort of
+// kCoalesceRadixBits digits. At every pass, each chunk of the input counts
+// its digits, the counts are scanned into the first output position of each
+// digit of each chunk, and the chunks scatter their keys there in parallel.
+// Every pass is stable, so equal keys keep the order of their positions.
+void radix_sort_with_positions(int64_t* keys, int64_t* positions, int64_t n) {
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), divup(n, at::internal::GRAIN_SIZE)));
+  const int64_t min_key = *std::min_element(keys, keys + n);
+  const uint64_t key_range =
+      static_cast<uint64_t>(*std::max_element(keys, keys + n)) - static_cast<uint64_t>(min_key);
+
+  std::vector<int64_t> keys_buffer(n);
+  std::vector<int64_t> positions_buffer(n);
+  int64_t* src_keys = keys;
+  int64_t* src_positions = positions;
+  int64_t* dst_keys = keys_buffer.data();
+  int64_t* dst_positions = positions_buffer.data();
+  std::vector<int64_t> offsets(num_chunks * kCoalesceRadix);
+
+  for (int shift = 0; shift < 64 && (key_range >> shift) != 0; shift += kCoalesceRadixBits) {
+    const auto digit = [&](int64_t key) {
+      return ((static_cast<uint64_t>(key) - static_cast<uint64_t>(min_key)) >> shift) &
+          (kCoalesceRadix - 1);
+    };
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* chunk_counts = offsets.data() + c * kCoalesceRadix;
+      for (int64_t i = begin; i < end; i++) {
+        chunk_counts[digit(src_keys[i])]++;
+      }
+    });
+    int64_t offset = 0;
+    for (int64_t d = 0; d < kCoalesceRadix; d++) {
+      for (int64_t c = 0; c < num_chunks; c++) {
+        const int64_t count = offsets[c * kCoalesceRadix + d];
+        offsets[c * kCoalesceRadix + d] = offset;
+        offset += count;
+      }
+    }
+    for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* chunk_offsets = offsets.data() + c * kCoalesceRadix;
+      for (int64_t i = begin; i < end; i++) {
+        const int64_t dst = chunk_offsets[digit(src_keys[i])]++;
+        dst_keys[dst] = src_keys[i];
+        dst_positions[dst] = src_positions[i];
+      }
+    });
+    std::swap(src_keys, dst_keys);
+    std::swap(src_positions, dst_positions);
+  }
+
+  if (src_keys != keys) {
+    std::copy(src_keys, src_keys + n, keys);
+    std::copy(src_positions, src_positions + n, positions);
+  }
+}
+
+} // namespace
+
 SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   AT_ASSERT(self.defined());
   TORCH_INTERNAL_ASSERT(at::impl::variable_excluded_from_dispatch());
@@ -375,7 +454,7 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   int64_t dense_dim = self.dense_dim();
   int64_t nnz = self._nnz();
 
-  LongTensor indices_scalar = flatten_indices(indices, self.sizes());
+  LongTensor indicesBuffer = flatten_indices(indices, self.sizes(), /*force_clone=*/true).contiguous();
 
   SparseTensor dst = new_sparse(self.options());
   get_sparse_impl(dst)->resize_(sparse_dim, dense_dim, self.sizes());
@@ -384,44 +463,67 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   Tensor newValues = at::empty(values.sizes(), values.options());
   alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
+  std::vector<int64_t> indicesPermutation(nnz);
+  std::iota(indicesPermutation.begin(), indicesPermutation.end(), 0);
+  int64_t* const indicesBuffer_ptr = indicesBuffer.data_ptr<int64_t>();
+  radix_sort_with_positions(indicesBuffer_ptr, indicesPermutation.data(), nnz);
+
+  // The sorted indices are split in runs of equal ones, each of which
+  // becomes one entry of the result. The chunks count the runs starting in
+  // them, and the runs are then merged in parallel, each in sorted order.
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), divup(nnz, at::internal::GRAIN_SIZE)));
+  const auto starts_run = [&](int64_t j) {
+    return j == 0 || indicesBuffer_ptr[j] != indicesBuffer_ptr[j - 1];
+  };
+  std::vector<int64_t> chunkRuns(num_chunks + 1, 0);
+  for_each_chunk(nnz, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+    for (int64_t j = begin; j < end; j++) {
+      chunkRuns[c + 1] += starts_run(j);
+    }
+  });
+  std::partial_sum(chunkRuns.begin(), chunkRuns.end(), chunkRuns.begin());
+  const int64_t newNnz = chunkRuns[num_chunks];
+  std::vector<int64_t> runStarts(newNnz + 1, nnz);
+  for_each_chunk(nnz, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t run = chunkRuns[c];
+    for (int64_t j = begin; j < end; j++) {
+      if (starts_run(j)) {
+        runStarts[run++] = j;
+      }
+    }
+  });
+
   // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
   auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
   auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
 
-  int64_t i = -1;
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "coalesce", [&] {
-        int64_t prev = -1;
         int64_t blockSize = values.stride(0);
         scalar_t* values_ptr = values.data_ptr<scalar_t>();
         scalar_t* newValues_ptr = newValues.data_ptr<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-            }
-          } else {
-            ++i;
+        const int64_t grain_size = std::max<int64_t>(
+            1, at::internal::GRAIN_SIZE / ((1 + blockSize) * divup(nnz, newNnz)));
+        at::parallel_for(0, newNnz, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            const int64_t first = indicesPermutation[runStarts[i]];
             for (int64_t d = 0; d < sparse_dim; d++) {
-              newIndicesAccessor[d][i] = indicesAccessor[d][pos];
+              newIndicesAccessor[d][i] = indicesAccessor[d][first];
             }
             if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
+              THBlas_copy<scalar_t>(blockSize, values_ptr + first * blockSize, 1, newValues_ptr + i * blockSize, 1);
+              for (int64_t j = runStarts[i] + 1; j < runStarts[i + 1]; j++) {
+                const int64_t pos = indicesPermutation[j];
+                THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
+              }
             }
           }
-          prev = curr;
-        }
+        });
     });
 
   dst._coalesced_(true);
-  get_sparse_impl(dst)->set_nnz_and_narrow(i + 1);
+  get_sparse_impl(dst)->set_nnz_and_narrow(newNnz);
 
   return dst;
 }
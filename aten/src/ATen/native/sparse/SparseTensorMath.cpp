@@ -12,6 +12,7 @@
 #include <TH/THBlasUtils.h>
 
 #include <algorithm>
+#include <numeric>
 
 namespace at { namespace native {
 
@@ -582,6 +583,42 @@ void add_dense_sparse_worker_cpu(Tensor& r, Scalar value, const SparseTensor& sp
   });
 }
 
+// Adds the dense blocks of the values of a coalesced hybrid tensor to r,
+// whose dense dimensions are contiguous. The indices of a coalesced tensor
+// are unique, so the nonzeros update disjoint blocks of r in parallel.
+template <typename scalar_t>
+void add_dense_sparse_hybrid_worker_cpu(Tensor& r, Scalar value, const SparseTensor& sparse, const Tensor& indices, const Tensor& values) {
+  auto indices_accessor = indices.accessor<int64_t, 2>();
+
+  const int64_t block_size = values[0].numel();
+  scalar_t* values_ptr = values.data_ptr<scalar_t>();
+  scalar_t* r_ptr = r.data_ptr<scalar_t>();
+  scalar_t cast_value = value.to<scalar_t>();
+
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, block_size));
+  at::parallel_for(0, sparse._nnz(), grain_size, [&](int64_t start, int64_t end) {
+    for (auto k = start; k < end; k++) {
+      int64_t index = 0;
+      for (int64_t d = 0; d < sparse.sparse_dim(); d++) {
+        index += r.stride(d) * indices_accessor[d][k];
+      }
+      THBlas_axpy<scalar_t>(block_size, cast_value, values_ptr + k * block_size, 1, r_ptr + index, 1);
+    }
+  });
+}
+
+// Whether the dimensions of t from dim on are laid out contiguously.
+bool is_contiguous_from_dim(const Tensor& t, int64_t dim) {
+  int64_t expected_stride = 1;
+  for (int64_t d = t.dim() - 1; d >= dim; d--) {
+    if (t.size(d) != 1 && t.stride(d) != expected_stride) {
+      return false;
+    }
+    expected_stride *= t.size(d);
+  }
+  return true;
+}
+
 Tensor& add_out_dense_sparse_cpu(Tensor& r, const Tensor& dense, const SparseTensor& sparse_, Scalar value) {
   AT_ASSERT(!r.is_sparse());
   AT_ASSERT(!dense.is_sparse());
@@ -619,7 +656,13 @@ Tensor& add_out_dense_sparse_cpu(Tensor& r, const Tensor& dense, const SparseTen
   }
 
   // accessors rely on nnz test
-  if (nDim > nDimI) {
+  if (nDim > nDimI && is_contiguous_from_dim(resultBuffer, nDimI)) {
+    valuesBuffer = valuesBuffer.contiguous();
+    AT_DISPATCH_ALL_TYPES(
+        commonDtype, "add_dense_sparse", [&] {
+          add_dense_sparse_hybrid_worker_cpu<scalar_t>(resultBuffer, value, sparse, indices, valuesBuffer);
+        });
+  } else if (nDim > nDimI) {
     auto indices_accessor = indices.accessor<int64_t, 2>();
     for (int64_t k = 0; k < sparse._nnz(); k++) {
       Tensor dstBuffer = resultBuffer;
@@ -791,23 +834,43 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
   int64_t dense_stride1 = dense.stride(1);
   int64_t r_stride0 = r.stride(0);
   int64_t r_stride1 = r.stride(1);
+
+  // Bucket the nonzeros by row, keeping their order within each row, so
+  // that the rows of r can be updated in parallel, each by its nonzeros in
+  // the order of the sequential loop.
+  std::vector<int64_t> row_offsets(dim_i + 1, 0);
   for (i = 0; i < nnz; i++) {
-    scalar_t val = values_accessor[i];
     int64_t row = indices_accessor[0][i];
     int64_t col = indices_accessor[1][i];
-    if (col >= 0 && col < dim_j && row >= 0 && row < dim_i) {
-      THBlas_axpy<scalar_t>(dim_k,
-            cast_alpha * val,
-            dense_ptr + col * dense_stride0, dense_stride1,
-            r_ptr + row * r_stride0, r_stride1);
-    } else {
-      if (col < 0 || col >= dim_j) {
-        AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
-      } else {
-        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
-      }
+    if (col < 0 || col >= dim_j) {
+      AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
+    } else if (row < 0 || row >= dim_i) {
+      AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+    }
+    row_offsets[row + 1]++;
+  }
+  std::partial_sum(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+  std::vector<int64_t> row_nonzeros(nnz);
+  {
+    std::vector<int64_t> next(row_offsets.begin(), row_offsets.end() - 1);
+    for (i = 0; i < nnz; i++) {
+      row_nonzeros[next[indices_accessor[0][i]]++] = i;
     }
   }
+
+  const int64_t row_cost = std::max<int64_t>(1, divup(nnz, dim_i) * dim_k);
+  at::parallel_for(0, dim_i, std::max<int64_t>(1, at::internal::GRAIN_SIZE / row_cost), [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; row++) {
+      for (int64_t p = row_offsets[row]; p < row_offsets[row + 1]; p++) {
+        const int64_t k = row_nonzeros[p];
+        const int64_t col = indices_accessor[1][k];
+        THBlas_axpy<scalar_t>(dim_k,
+              cast_alpha * values_accessor[k],
+              dense_ptr + col * dense_stride0, dense_stride1,
+              r_ptr + row * r_stride0, r_stride1);
+      }
+    }
+  });
 };
 
 Tensor& s_addmm_out_sparse_dense_cpu(
@@ -0,0 +1,169 @@
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+#include <ATen/native/sparse/cuda/SparseCUDABlas.cuh>
+#include <ATen/cuda/CUDAUtils.h>
+#include <ATen/ExpandUtils.h>
+
+#include <cusparse.h>
+#include <cuda_runtime_api.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+// --------------------------------------------------------------------
+// addmm(Tensor, SparseCsrTensor, Tensor, Scalar, Scalar)  [broadcasts]
+// --------------------------------------------------------------------
+
+namespace {
+
+// Same as s_addmm_out_sparse_dense_cuda_worker, minus the COO -> CSR
+// conversion: the CSR tensor already has the layout csrmm2 wants. cuSPARSE
+// takes int32 indices, so int64 ones are narrowed here.
+template <typename scalar_t>
+void s_addmm_out_sparse_csr_dense_cuda_worker(int64_t nnz, int64_t m, int64_t n, int64_t k, Tensor& r_, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, const Tensor& dense) {
+  scalar_t cast_beta = beta.to<scalar_t>();
+  scalar_t cast_alpha = alpha.to<scalar_t>();
+  IntTensor crow_indices_int = crow_indices.to(kInt).contiguous();
+  IntTensor col_indices_int = col_indices.to(kInt).contiguous();
+  Tensor values_ = values.contiguous();
+
+  Tensor r__;
+  if (cast_beta == 0) {
+    r_.zero_();
+  } else if (cast_beta == 1) {
+    if (!at::sparse::is_same_tensor(t, r_)) {
+      r_.copy_(t);
+    }
+  } else {
+    at::mul_out(r_, t, scalar_to_tensor(beta));
+  }
+
+  if(r_.stride(0) == 1 && r_.stride(1) == r_.size(0)) {
+    r__ = r_;
+  } else {
+    // csrmm2 writes a column-major result
+    r__ = r_.transpose(0, 1).clone(at::MemoryFormat::Contiguous);
+    r__.transpose_(0, 1);
+  }
+
+  if (nnz > 0) {
+    Tensor dense_;
+    char transpose_dense;
+    if(dense.stride(0) == 1 && dense.stride(1) == dense.size(0)) {
+      transpose_dense = 'n';
+      dense_ = dense;
+    } else if(dense.stride(1) == 1 && dense.stride(0) != dense.size(1)) {
+      transpose_dense = 't';
+      dense_ = dense;
+    } else {
+      transpose_dense = 't';
+      dense_ = dense.contiguous();
+    }
+
+    // beta was already applied to r_ above
+    sparse::cuda::csrmm2(
+      'n',
+      transpose_dense,
+      m,
+      n,
+      k,
+      nnz,
+      cast_alpha,
+      values_.data_ptr<scalar_t>(),
+      crow_indices_int.data_ptr<int32_t>(),
+      col_indices_int.data_ptr<int32_t>(),
+      dense_.data_ptr<scalar_t>(),
+      (transpose_dense == 'n' ? dense_.stride(1) : dense_.stride(0)),
+      scalar_t(1),
+      r__.data_ptr<scalar_t>(),
+      r__.stride(1));
+  }
+  if (!at::sparse::is_same_tensor(r__, r_)) {
+    r_.copy_(r__);
+  }
+}
+
+} // anonymous namespace
+
+Tensor& s_addmm_out_sparse_csr_dense_cuda(Tensor& r_, const Tensor& t, const SparseCsrTensor& sparse, const Tensor& dense, Scalar beta, Scalar alpha) {
+  TORCH_CHECK(t.is_cuda(), "addmm: expected 'self' to be CUDA, but got CPU");
+  TORCH_CHECK(r_.is_cuda(), "addmm: expected 'out' to be CUDA, but got CPU");
+  TORCH_CHECK(sparse.is_cuda(), "addmm: expected 'mat1' to be CUDA, but got CPU");
+  TORCH_CHECK(dense.is_cuda(), "addmm: expected 'mat2' to be CUDA, but got CPU");
+
+  TORCH_CHECK(cuda::check_device({sparse, r_, t, dense}));
+
+  TORCH_CHECK(!dense.is_sparse() && !dense.is_sparse_csr(), "addmm: expected 'mat2' to be a dense tensor");
+  TORCH_CHECK(dense.dim() == 2, "addmm: 2D tensor expected, got ", dense.dim(), "D tensor");
+  TORCH_CHECK(dense.scalar_type() == sparse.scalar_type(),
+      "addmm: expected 'mat1' and 'mat2' to have the same dtype, but got ", sparse.scalar_type(), " and ", dense.scalar_type());
+
+  // mxk * kxn = mxn
+  int64_t m = sparse.size(0);
+  int64_t k = sparse.size(1);
+  int64_t n = dense.size(1);
+
+  TORCH_CHECK(t.size(0) == m,
+      "addmm: Argument #1 (t): Expected dim 0 size ", m, ", got ", t.size(0));
+  TORCH_CHECK(t.size(1) == n,
+      "addmm: Argument #1 (t): Expected dim 1 size ", n, ", got ", t.size(1));
+  TORCH_CHECK(dense.size(0) == k,
+      "addmm: Argument #3 (dense): Expected dim 0 size ", k, ", got ", dense.size(0));
+
+  r_.resize_({m, n});
+
+  int64_t nnz = sparse._nnz();
+  auto impl = get_sparse_csr_impl(sparse);
+
+  AT_DISPATCH_FLOATING_TYPES(
+    impl->values().scalar_type(), "addmm_sparse_csr_dense_cuda", [&] {
+      s_addmm_out_sparse_csr_dense_cuda_worker<scalar_t>(nnz, m, n, k, r_, beta, t, alpha, impl->crow_indices(), impl->col_indices(), impl->values(), dense);
+    }
+  );
+
+  return r_;
+}
+
+Tensor& addmm_out_sparse_csr_dense_cuda(
+    Tensor& result,
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha
+) {
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  return s_addmm_out_sparse_csr_dense_cuda(result, b_self, mat1, mat2, beta, alpha);
+}
+
+Tensor addmm_sparse_csr_dense_cuda(
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha
+) {
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  Tensor r = at::empty({0}, b_self.options());
+  s_addmm_out_sparse_csr_dense_cuda(r, b_self, mat1, mat2, beta, alpha);
+  return r;
+}
+
+Tensor& s_addmm_sparse_csr_dense_cuda_(
+    Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha
+) {
+  return s_addmm_out_sparse_csr_dense_cuda(t, t, sparse, dense, beta, alpha);
+}
+
+}} // namespace at::native
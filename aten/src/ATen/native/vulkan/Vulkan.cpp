@@ -1,9 +1,11 @@
 #include <stdio.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <iostream>
 #include <numeric>
+#include <sstream>
 
 #include <c10/util/ArrayRef.h>
 #include <c10/util/Exception.h>
@@ -40,9 +42,16 @@ VContext::VContext(bool enableValidationLayers)
   createInstance();
   findPhysicalDevice();
   createDevice();
+  memoryPool_ = std::make_unique<VMemoryPool>(device_, physicalDevice_);
+  computeUnitFactory_ = std::make_unique<ComputeUnitFactory>();
+  commandBatch_ = std::make_unique<VCommandBatch>(device_, queue_, commandPool_);
 }
 
 VContext::~VContext() {
+  commandBatch_->flush();
+  commandBatch_.reset();
+  computeUnitFactory_.reset();
+  memoryPool_.reset();
   vkDestroyCommandPool(device_, commandPool_, nullptr);
   if (enableValidationLayers_) {
     auto func = (PFN_vkDestroyDebugReportCallbackEXT)vkGetInstanceProcAddr(
@@ -259,20 +268,151 @@ bool is_available() {
   return initVulkanContextOnce();
 }
 
-uint32_t findMemoryType(
-    VkPhysicalDevice& physicalDevice,
-    uint32_t memoryTypeBits,
-    VkMemoryPropertyFlags properties) {
-  VkPhysicalDeviceMemoryProperties memoryProperties;
-  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
-  for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
-    if ((memoryTypeBits & (1 << i)) &&
-        ((memoryProperties.memoryTypes[i].propertyFlags & properties) ==
-         properties)) {
-      return i;
+VMemoryPool::VMemoryPool(VkDevice device, VkPhysicalDevice physicalDevice)
+    : device_(device) {
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties_);
+  VkPhysicalDeviceProperties physicalDeviceProperties;
+  vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+  nonCoherentAtomSize_ = physicalDeviceProperties.limits.nonCoherentAtomSize;
+}
+
+VMemoryPool::~VMemoryPool() {
+  for (auto& it : pools_) {
+    for (auto& block : it.second.blocks) {
+      if (block.mappedData) {
+        vkUnmapMemory(device_, block.deviceMemory);
+      }
+      vkFreeMemory(device_, block.deviceMemory, nullptr);
     }
   }
-  return -1;
+}
+
+VkDeviceSize VMemoryPool::sizeClass(VkDeviceSize size) {
+  if (size <= 4 * kMinSizeClass) {
+    return ROUND_UP(std::max<VkDeviceSize>(size, 1), kMinSizeClass);
+  }
+  VkDeviceSize powerOfTwo = 4 * kMinSizeClass;
+  while (2 * powerOfTwo < size) {
+    powerOfTwo *= 2;
+  }
+  return ROUND_UP(size, powerOfTwo / 4);
+}
+
+VMemoryPool::Block& VMemoryPool::allocateBlock(
+    Pool& pool,
+    uint32_t memoryTypeIndex,
+    VkDeviceSize size,
+    bool mapped) {
+  VkMemoryAllocateInfo allocateInfo{};
+  allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocateInfo.allocationSize = size;
+  allocateInfo.memoryTypeIndex = memoryTypeIndex;
+  Block block{VK_NULL_HANDLE, size, 0, nullptr};
+  VK_CHECK(
+      vkAllocateMemory(device_, &allocateInfo, nullptr, &block.deviceMemory));
+  if (mapped) {
+    VK_CHECK(vkMapMemory(
+        device_, block.deviceMemory, 0, VK_WHOLE_SIZE, 0, &block.mappedData));
+  }
+  deviceMemoryAllocations_++;
+  deviceMemoryBytes_ += size;
+  pool.blocks.push_back(block);
+  return pool.blocks.back();
+}
+
+VMemory VMemoryPool::allocate(
+    const VkMemoryRequirements& memoryRequirements,
+    VkMemoryPropertyFlags memoryProperties,
+    bool linear) {
+  uint32_t memoryTypeIndex = memoryProperties_.memoryTypeCount;
+  for (uint32_t i = 0; i < memoryProperties_.memoryTypeCount; ++i) {
+    if ((memoryRequirements.memoryTypeBits & (1 << i)) &&
+        ((memoryProperties_.memoryTypes[i].propertyFlags & memoryProperties) ==
+         memoryProperties)) {
+      memoryTypeIndex = i;
+      break;
+    }
+  }
+  TORCH_CHECK(
+      memoryTypeIndex < memoryProperties_.memoryTypeCount,
+      "Vulkan: Could not find a memory type with properties ",
+      memoryProperties);
+  const bool mapped =
+      memoryProperties_.memoryTypes[memoryTypeIndex].propertyFlags &
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+  // Mapped ranges are flushed and invalidated whole, which needs them to be
+  // aligned to nonCoherentAtomSize.
+  const auto alignment = mapped
+      ? std::max(memoryRequirements.alignment, nonCoherentAtomSize_)
+      : memoryRequirements.alignment;
+  const auto size = sizeClass(memoryRequirements.size);
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  numRequests_++;
+  allocations_++;
+  allocatedBytes_ += size;
+  auto& pool = pools_[std::make_pair(memoryTypeIndex, linear)];
+  auto& freeList = pool.freeLists[size];
+  for (auto it = freeList.rbegin(); it != freeList.rend(); ++it) {
+    if (it->offset % alignment == 0) {
+      VMemory memory = *it;
+      freeList.erase(std::next(it).base());
+      numReused_++;
+      cachedBytes_ -= size;
+      return memory;
+    }
+  }
+
+  Block* block = nullptr;
+  VkDeviceSize offset = 0;
+  if (size > kMaxSuballocationSize) {
+    block = &allocateBlock(pool, memoryTypeIndex, size, mapped);
+  } else {
+    for (auto& candidate : pool.blocks) {
+      offset = ROUND_UP(candidate.used, alignment);
+      if (offset + size <= candidate.size) {
+        block = &candidate;
+        break;
+      }
+    }
+    if (!block) {
+      block = &allocateBlock(pool, memoryTypeIndex, kBlockSize, mapped);
+      offset = 0;
+    }
+  }
+  block->used = offset + size;
+
+  VMemory memory;
+  memory.deviceMemory = block->deviceMemory;
+  memory.offset = offset;
+  memory.size = size;
+  memory.mappedData =
+      mapped ? static_cast<char*>(block->mappedData) + offset : nullptr;
+  memory.memoryTypeIndex = memoryTypeIndex;
+  memory.linear = linear;
+  return memory;
+}
+
+void VMemoryPool::free(const VMemory& memory) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& pool = pools_[std::make_pair(memory.memoryTypeIndex, memory.linear)];
+  pool.freeLists[memory.size].push_back(memory);
+  allocations_--;
+  allocatedBytes_ -= memory.size;
+  cachedBytes_ += memory.size;
+}
+
+VulkanMemoryStats VMemoryPool::stats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  VulkanMemoryStats stats;
+  stats.device_memory_allocations = deviceMemoryAllocations_;
+  stats.device_memory_bytes = deviceMemoryBytes_;
+  stats.allocations = allocations_;
+  stats.allocated_bytes = allocatedBytes_;
+  stats.cached_bytes = cachedBytes_;
+  stats.num_requests = numRequests_;
+  stats.num_reused = numReused_;
+  return stats;
 }
 
 void VBuffer::MapMemory::flushWriteToDevice() {
@@ -303,7 +443,6 @@ VBuffer::VBuffer(
     VkDescriptorType descriptorType)
     : bufferSizeBytes_(bufferSizeBytes), descriptorType_(descriptorType) {
   auto device = context().device();
-  auto physicalDevice = context().physicalDevice();
   VkBufferCreateInfo bufferCreateInfo{};
   bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
   bufferCreateInfo.size = bufferSizeBytes_;
@@ -312,21 +451,44 @@ VBuffer::VBuffer(
   VK_CHECK(vkCreateBuffer(device, &bufferCreateInfo, nullptr, &buffer_));
   VkMemoryRequirements memoryRequirements;
   vkGetBufferMemoryRequirements(device, buffer_, &memoryRequirements);
-  VkMemoryAllocateInfo allocateInfo{};
-  allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocateInfo.allocationSize = memoryRequirements.size;
-  allocateInfo.memoryTypeIndex = findMemoryType(
-      physicalDevice,
-      memoryRequirements.memoryTypeBits,
+  memory_ = context().memoryPool().allocate(
+      memoryRequirements,
       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
-          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-  VK_CHECK(vkAllocateMemory(device, &allocateInfo, nullptr, &bufferMemory_));
-  VK_CHECK(vkBindBufferMemory(device, buffer_, bufferMemory_, 0));
+          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+      true /* linear */);
+  VK_CHECK(vkBindBufferMemory(
+      device, buffer_, memory_.deviceMemory, memory_.offset));
+}
+
+VBuffer::VBuffer(VBuffer&& other) noexcept
+    : bufferSizeBytes_(other.bufferSizeBytes_),
+      descriptorType_(other.descriptorType_),
+      buffer_(other.buffer_),
+      memory_(other.memory_) {
+  other.buffer_ = VK_NULL_HANDLE;
+}
+
+VBuffer& VBuffer::operator=(VBuffer&& other) noexcept {
+  std::swap(bufferSizeBytes_, other.bufferSizeBytes_);
+  std::swap(descriptorType_, other.descriptorType_);
+  std::swap(buffer_, other.buffer_);
+  std::swap(memory_, other.memory_);
+  return *this;
 }
 
 VBuffer::~VBuffer() {
-  vkFreeMemory(context().device(), bufferMemory_, nullptr);
-  vkDestroyBuffer(context().device(), buffer_, nullptr);
+  if (buffer_ == VK_NULL_HANDLE) {
+    return;
+  }
+  auto device = context().device();
+  auto buffer = buffer_;
+  auto memory = memory_;
+  auto memoryPool = &context().memoryPool();
+  context().commandBatch().releaseAfterFlush(
+      [device, buffer, memory, memoryPool]() {
+        vkDestroyBuffer(device, buffer, nullptr);
+        memoryPool->free(memory);
+      });
 }
 
 void VBuffer::copy_from_device_to_host(void* outputData, int64_t size) {
@@ -415,7 +577,6 @@ void VBuffer::addBufferMemoryBarrier(
 VImage::VImage(ImageSize imageSize, ImageSize dataSize)
     : imageSize_(imageSize), dataSize_(dataSize) {
   auto device = context().device();
-  auto physicalDevice = context().physicalDevice();
 
   VkImageCreateInfo imageInfo{};
   imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -440,16 +601,10 @@ VImage::VImage(ImageSize imageSize, ImageSize dataSize)
 
   VkMemoryRequirements memReqs{};
   vkGetImageMemoryRequirements(device, image_, &memReqs);
-  VkMemoryAllocateInfo allocInfo{};
-  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocInfo.allocationSize = memReqs.size;
-  allocInfo.memoryTypeIndex = findMemoryType(
-      physicalDevice,
-      memReqs.memoryTypeBits,
-      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-  VK_CHECK(vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory_));
-  VK_CHECK(vkBindImageMemory(device, image_, imageMemory_, 0));
+  memory_ = context().memoryPool().allocate(
+      memReqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false /* linear */);
+  VK_CHECK(vkBindImageMemory(
+      device, image_, memory_.deviceMemory, memory_.offset));
 
   VkImageViewCreateInfo imageViewCreateInfo = makeImageViewCreateInfo();
   VK_CHECK(
@@ -459,11 +614,45 @@ VImage::VImage(ImageSize imageSize, ImageSize dataSize)
   VK_CHECK(vkCreateSampler(device, &samplerCreateInfo, nullptr, &sampler_));
 }
 
+VImage::VImage(VImage&& other) noexcept
+    : imageSize_(other.imageSize_),
+      dataSize_(other.dataSize_),
+      image_(other.image_),
+      memory_(other.memory_),
+      imageView_(other.imageView_),
+      sampler_(other.sampler_),
+      imageLayout_(other.imageLayout_) {
+  other.image_ = VK_NULL_HANDLE;
+}
+
+VImage& VImage::operator=(VImage&& other) noexcept {
+  std::swap(imageSize_, other.imageSize_);
+  std::swap(dataSize_, other.dataSize_);
+  std::swap(image_, other.image_);
+  std::swap(memory_, other.memory_);
+  std::swap(imageView_, other.imageView_);
+  std::swap(sampler_, other.sampler_);
+  std::swap(imageLayout_, other.imageLayout_);
+  return *this;
+}
+
 VImage::~VImage() {
-  vkFreeMemory(context().device(), imageMemory_, nullptr);
-  vkDestroySampler(context().device(), sampler_, nullptr);
-  vkDestroyImageView(context().device(), imageView_, nullptr);
-  vkDestroyImage(context().device(), image_, nullptr);
+  if (image_ == VK_NULL_HANDLE) {
+    return;
+  }
+  auto device = context().device();
+  auto image = image_;
+  auto memory = memory_;
+  auto imageView = imageView_;
+  auto sampler = sampler_;
+  auto memoryPool = &context().memoryPool();
+  context().commandBatch().releaseAfterFlush(
+      [device, image, memory, imageView, sampler, memoryPool]() {
+        vkDestroySampler(device, sampler, nullptr);
+        vkDestroyImageView(device, imageView, nullptr);
+        vkDestroyImage(device, image, nullptr);
+        memoryPool->free(memory);
+      });
 }
 
 VkImageViewCreateInfo VImage::makeImageViewCreateInfo() const {
@@ -559,7 +748,7 @@ void VImage::addImageMemoryBarrier(
     VkCommandBuffer commandBuffer,
     VkImageLayout newLayout) const {
   VkImageLayout oldLayout = imageLayout_;
-  if (oldLayout == newLayout) {
+  if (oldLayout == newLayout && newLayout != VK_IMAGE_LAYOUT_GENERAL) {
     return;
   }
 
@@ -594,6 +783,14 @@ void VImage::addImageMemoryBarrier(
       newLayout == VK_IMAGE_LAYOUT_GENERAL) {
     barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
     barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  } else if (
+      oldLayout == VK_IMAGE_LAYOUT_GENERAL &&
+      newLayout == VK_IMAGE_LAYOUT_GENERAL) {
+    // Dispatches of the command batch writing the same image one after the
+    // other are not ordered without the barrier.
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
   } else {
     TORCH_INTERNAL_ASSERT(
         false, "Vulkan: Unsupported Vulkan Image Layout transition");
@@ -798,23 +995,8 @@ void ComputeUnit::createComputePipelineCompile(
 }
 #endif
 
-void ComputeUnit::createCommandBuffer(VkDescriptorSet& descriptorSet) {
-  auto device = context().device();
-  VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
-  commandBufferAllocateInfo.sType =
-      VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  commandBufferAllocateInfo.commandPool = context().commandPool();
-  commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  commandBufferAllocateInfo.commandBufferCount = 1;
-
-  VK_CHECK(vkAllocateCommandBuffers(
-      device, &commandBufferAllocateInfo, &commandBuffer_));
-
-  VkCommandBufferBeginInfo beginInfo{};
-  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-  VK_CHECK(vkBeginCommandBuffer(commandBuffer_, &beginInfo));
-
+void ComputeUnit::bindCommandBuffer(VkDescriptorSet& descriptorSet) {
+  commandBuffer_ = context().commandBatch().commandBuffer();
   vkCmdBindPipeline(commandBuffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
   vkCmdBindDescriptorSets(
       commandBuffer_,
@@ -857,10 +1039,6 @@ void ComputeUnit::dispatchCommandBuffer(
   vkCmdDispatch(commandBuffer_, groupCountX, groupCountY, groupCountZ);
 }
 
-void ComputeUnit::endCommandBuffer() {
-  VK_CHECK(vkEndCommandBuffer(commandBuffer_));
-}
-
 void ComputeUnit::dispatchCommandBuffer(
     uint32_t gridX,
     uint32_t gridY,
@@ -872,22 +1050,161 @@ void ComputeUnit::dispatchCommandBuffer(
       UP_DIV(gridZ, workGroupSize.z));
 }
 
-void ComputeUnit::submitAndWaitCommandBuffer() {
-  VkSubmitInfo submitInfo{};
-  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &commandBuffer_;
+std::string ComputeUnitFactory::getCacheKey(
+    const char* key,
+    WorkGroupSize workGroupSize) {
+  std::stringstream ss;
+  ss << key << ':' << workGroupSize.x << ':' << workGroupSize.y << ':'
+     << workGroupSize.z;
+  return ss.str();
+}
+
+#ifdef USE_VULKAN_SHADERC_RUNTIME
+ComputeUnit& ComputeUnitFactory::get(
+    const char* key,
+    const char* glslSrc,
+    const VkDescriptorSetLayout& descrSetLayout,
+    WorkGroupSize workGroupSize) {
+  auto& computeUnit = computeUnits_[getCacheKey(key, workGroupSize)];
+  if (!computeUnit) {
+    computeUnit =
+        std::make_unique<ComputeUnit>(glslSrc, descrSetLayout, workGroupSize);
+  }
+  return *computeUnit;
+}
+#else
+ComputeUnit& ComputeUnitFactory::get(
+    const char* key,
+    const uint32_t* spvCode,
+    const unsigned int spvCodeSize,
+    const VkDescriptorSetLayout& descrSetLayout,
+    WorkGroupSize workGroupSize) {
+  auto& computeUnit = computeUnits_[getCacheKey(key, workGroupSize)];
+  if (!computeUnit) {
+    computeUnit = std::make_unique<ComputeUnit>(
+        spvCode, spvCodeSize, descrSetLayout, workGroupSize);
+  }
+  return *computeUnit;
+}
+#endif
+
+VCommandBatch::VCommandBatch(
+    VkDevice device,
+    VkQueue queue,
+    VkCommandPool commandPool)
+    : device_(device), queue_(queue), commandPool_(commandPool) {
+  VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+  commandBufferAllocateInfo.sType =
+      VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  commandBufferAllocateInfo.commandPool = commandPool_;
+  commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  commandBufferAllocateInfo.commandBufferCount = 1;
+  VK_CHECK(vkAllocateCommandBuffers(
+      device_, &commandBufferAllocateInfo, &commandBuffer_));
 
-  VkFence fence;
   VkFenceCreateInfo fenceCreateInfo{};
   fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
   fenceCreateInfo.flags = 0;
-  VK_CHECK(vkCreateFence(context().device(), &fenceCreateInfo, NULL, &fence))
+  VK_CHECK(vkCreateFence(device_, &fenceCreateInfo, nullptr, &fence_));
+
+  const VkDescriptorType descrTypes[] = {
+      VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+      VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
+  std::vector<VkDescriptorPoolSize> poolSizes;
+  for (const auto descrType : descrTypes) {
+    poolSizes.push_back(VkDescriptorPoolSize{
+        descrType, kDescriptorPoolMaxSets * kMaxDescriptorsPerSet});
+  }
+  createDescriptorPool(
+      device_,
+      poolSizes.data(),
+      poolSizes.size(),
+      kDescriptorPoolMaxSets,
+      &descriptorPool_);
+}
+
+VCommandBatch::~VCommandBatch() {
+  flush();
+  vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+  for (const auto& it : descriptorSetLayouts_) {
+    vkDestroyDescriptorSetLayout(device_, it.second, nullptr);
+  }
+  vkDestroyFence(device_, fence_, nullptr);
+  vkFreeCommandBuffers(device_, commandPool_, 1, &commandBuffer_);
+}
 
-  VK_CHECK(vkQueueSubmit(context().queue(), 1, &submitInfo, fence));
-  vkWaitForFences(context().device(), 1, &fence, VK_TRUE, kFenceTimeoutNanos);
+VkCommandBuffer VCommandBatch::commandBuffer() {
+  if (!recording_) {
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CHECK(vkBeginCommandBuffer(commandBuffer_, &beginInfo));
+    recording_ = true;
+  }
+  return commandBuffer_;
+}
 
-  vkDestroyFence(context().device(), fence, NULL);
+void VCommandBatch::allocateDescriptorSet(
+    const std::vector<VkDescriptorType>& descrTypes,
+    VkDescriptorSetLayout* descrSetLayout,
+    VkDescriptorSet* descrSet) {
+  auto& layout = descriptorSetLayouts_[descrTypes];
+  if (layout == VK_NULL_HANDLE) {
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    uint32_t i = 0;
+    for (const auto& descrType : descrTypes) {
+      TORCH_INTERNAL_ASSERT(
+          std::count(descrTypes.begin(), descrTypes.end(), descrType) <=
+              kMaxDescriptorsPerSet,
+          "Vulkan: Too many descriptors of the same type in a set");
+      bindings.push_back(descriptorSetLayoutBinding(i, descrType));
+      i++;
+    }
+    createDescriptorSetLayout(device_, bindings.data(), i, &layout);
+  }
+  if (descriptorSetsAllocated_ == kDescriptorPoolMaxSets) {
+    flush();
+  }
+  ::at::native::vulkan::detail::allocateDescriptorSet(
+      device_, descriptorPool_, &layout, descrSet);
+  descriptorSetsAllocated_++;
+  *descrSetLayout = layout;
+}
+
+void VCommandBatch::releaseAfterFlush(std::function<void()> release) {
+  if (recording_) {
+    releases_.push_back(std::move(release));
+  } else {
+    release();
+  }
+}
+
+void VCommandBatch::flush() {
+  if (recording_) {
+    VK_CHECK(vkEndCommandBuffer(commandBuffer_));
+    recording_ = false;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer_;
+    VK_CHECK(vkQueueSubmit(queue_, 1, &submitInfo, fence_));
+    VK_CHECK(
+        vkWaitForFences(device_, 1, &fence_, VK_TRUE, kFenceTimeoutNanos));
+    VK_CHECK(vkResetFences(device_, 1, &fence_));
+    VK_CHECK(vkResetCommandPool(device_, commandPool_, 0));
+  }
+  if (descriptorSetsAllocated_ > 0) {
+    VK_CHECK(vkResetDescriptorPool(device_, descriptorPool_, 0));
+    descriptorSetsAllocated_ = 0;
+  }
+  auto releases = std::move(releases_);
+  releases_.clear();
+  for (const auto& release : releases) {
+    release();
+  }
 }
 
 VBuffer makeUniformConstBuffer(void* ptr, VkDeviceSize size) {
@@ -898,7 +1215,6 @@ VBuffer makeUniformConstBuffer(void* ptr, VkDeviceSize size) {
 
 // VBuffer <-> VImage
 void copy_buffer_to_image(const VBuffer& buffer, VImage& image) {
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   struct ConstBlock {
     int32_t w;
@@ -909,31 +1225,21 @@ void copy_buffer_to_image(const VBuffer& buffer, VImage& image) {
       makeUniformConstBuffer((void*)&constBlock, sizeof(constBlock));
 
   VkDescriptorSetLayout descrSetLayout{};
-  VkDescriptorSetLayoutBinding bindings[] = {
-      descriptorSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE),
-      descriptorSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
-      descriptorSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)};
-  createDescriptorSetLayout(
-      device, bindings, 3 /* bindingsCount */, &descrSetLayout);
-
-  VkDescriptorPool descrPool{};
-  VkDescriptorPoolSize poolSizes[] = {{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1},
-                                      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
-                                      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}};
-  createDescriptorPool(
-      device, poolSizes, 3 /* poolSizeCount */, 1 /* maxSets */, &descrPool);
-
   VkDescriptorSet descrSet{};
-  allocateDescriptorSet(device, descrPool, &descrSetLayout, &descrSet);
+  context().commandBatch().allocateDescriptorSet(
+      {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER},
+      &descrSetLayout,
+      &descrSet);
 
   image.bindStorageImage(descrSet, 0);
   buffer.bind(descrSet, 1);
   constBuffer.bind(descrSet, 2);
   WorkGroupSize workGroupSize{8, 8, 1};
-  ComputeUnit computeUnit{at::native::vulkan::GLSL_SPV(nchw_to_image),
-                          descrSetLayout,
-                          workGroupSize};
-  computeUnit.createCommandBuffer(descrSet);
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(nchw_to_image), descrSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descrSet);
 
   image.addImageMemoryBarrierToGeneral(computeUnit.commandBuffer());
   buffer.addBufferMemoryBarrier(
@@ -945,18 +1251,12 @@ void copy_buffer_to_image(const VBuffer& buffer, VImage& image) {
       VK_ACCESS_SHADER_READ_BIT);
   computeUnit.dispatchCommandBuffer(
       image.w(), image.h(), image.d(), workGroupSize);
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-
-  vkDestroyDescriptorPool(device, descrPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descrSetLayout, nullptr);
 }
 
 void copy_image_to_buffer(
     const VImage& image,
     VBuffer& buffer,
     bool addBufferMemoryBarrierForHost) {
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   TORCH_INTERNAL_ASSERT(
       buffer.sizeBytes() >= image.capacityBytes(),
@@ -970,34 +1270,22 @@ void copy_image_to_buffer(
       makeUniformConstBuffer((void*)&constBlock, sizeof(constBlock));
 
   VkDescriptorSetLayout descrSetLayout{};
-  VkDescriptorSetLayoutBinding bindings[] = {
-      descriptorSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER),
-      descriptorSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
-      descriptorSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)};
-  createDescriptorSetLayout(
-      device, bindings, 3 /* bindingsCount */, &descrSetLayout);
-
-  VkDescriptorPool descrPool{};
-  VkDescriptorPoolSize poolSizes[] = {
-      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1},
-      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
-      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}};
-  createDescriptorPool(
-      device, poolSizes, 3 /* poolSizeCount */, 1 /* maxSets */, &descrPool);
-
   VkDescriptorSet descrSet{};
-  allocateDescriptorSet(device, descrPool, &descrSetLayout, &descrSet);
+  context().commandBatch().allocateDescriptorSet(
+      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER},
+      &descrSetLayout,
+      &descrSet);
 
   image.bindShaderRead(descrSet, 0);
   buffer.bind(descrSet, 1);
   constBuffer.bind(descrSet, 2);
 
   WorkGroupSize workGroupSize{8, 8, 1};
-  ComputeUnit computeUnit{at::native::vulkan::GLSL_SPV(image_to_nchw),
-                          descrSetLayout,
-                          workGroupSize};
-
-  computeUnit.createCommandBuffer(descrSet);
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(image_to_nchw), descrSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descrSet);
   image.addImageMemoryBarrierToShaderRead(computeUnit.commandBuffer());
   computeUnit.dispatchCommandBuffer(
       image.w(), image.h(), image.d(), workGroupSize);
@@ -1009,11 +1297,6 @@ void copy_image_to_buffer(
         VK_PIPELINE_STAGE_HOST_BIT,
         VK_ACCESS_HOST_READ_BIT);
   }
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-
-  vkDestroyDescriptorPool(device, descrPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descrSetLayout, nullptr);
 } // VBuffer <-> VImage
 
 // VulkanTensor
@@ -1139,6 +1422,9 @@ class VulkanTensor::Impl {
   void set_data_from_host(const float* inputData) {
     if (!has_storage()) {
       allocate_storage();
+    } else {
+      // The recorded dispatches may still read the buffer.
+      context().commandBatch().flush();
     }
     buffer_->copy_from_host_to_device(
         (const void*)inputData, sizeof(float) * numel_);
@@ -1151,6 +1437,7 @@ class VulkanTensor::Impl {
           *(const_cast<VBuffer*>(buffer())),
           true /* memory barrier for host memory map */);
     }
+    context().commandBatch().flush();
     buffer_->copy_from_device_to_host(outputData, sizeof(float) * numel_);
   }
 
@@ -1251,6 +1538,14 @@ std::ostream& operator<<(std::ostream& s, const WorkGroupSize& workGroupSize) {
 }
 
 } // namespace detail
+
+VulkanMemoryStats memory_stats() {
+  if (!detail::gContext) {
+    return VulkanMemoryStats{};
+  }
+  return detail::context().memoryPool().stats();
+}
+
 } // namespace vulkan
 } // namespace native
 } // namespace at
@@ -3,7 +3,12 @@
 #include <c10/util/Optional.h>
 #include <array>
 #include <cstring>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #ifdef USE_VULKAN_WRAPPER
@@ -14,15 +19,18 @@
 
 #ifdef USE_VULKAN_SHADERC_RUNTIME
 #include <ATen/native/vulkan/glsl.h>
-#define GLSL_SPV(name) name##_glsl
+#define GLSL_SPV(name) #name, name##_glsl
 #else
 #include <ATen/native/vulkan/spv.h>
-#define GLSL_SPV(name) name##_spv, name##_spv_len
+#define GLSL_SPV(name) #name, name##_spv, name##_spv_len
 #endif
 
 namespace at {
 namespace native {
 namespace vulkan {
+
+struct VulkanMemoryStats;
+
 namespace detail {
 
 static constexpr bool kEnableValidationLayers = true;
@@ -30,6 +38,9 @@ bool is_available();
 
 class VContext;
 const VContext& context();
+class ComputeUnitFactory;
+class VCommandBatch;
+class VMemoryPool;
 
 // VulkanTensor is a handle that holds shared pointer to VulkanTensor:Impl,
 // that owns Tensor representation on GPU.
@@ -163,6 +174,15 @@ class VContext final {
   inline VkQueue queue() const {
     return queue_;
   }
+  inline ComputeUnitFactory& computeUnitFactory() const {
+    return *computeUnitFactory_;
+  }
+  inline VCommandBatch& commandBatch() const {
+    return *commandBatch_;
+  }
+  inline VMemoryPool& memoryPool() const {
+    return *memoryPool_;
+  }
 
  private:
   void createInstance();
@@ -180,6 +200,86 @@ class VContext final {
   uint32_t queueFamilyIndex_;
   bool enableValidationLayers_;
   VkCommandPool commandPool_;
+  std::unique_ptr<VMemoryPool> memoryPool_;
+  std::unique_ptr<ComputeUnitFactory> computeUnitFactory_;
+  std::unique_ptr<VCommandBatch> commandBatch_;
+};
+
+// A range of a VkDeviceMemory suballocated by VMemoryPool. mappedData points
+// to the start of the range if the memory is host visible, as the pool keeps
+// its host visible memory mapped.
+struct VMemory final {
+  VkDeviceMemory deviceMemory{VK_NULL_HANDLE};
+  VkDeviceSize offset{0};
+  VkDeviceSize size{0};
+  void* mappedData{nullptr};
+  uint32_t memoryTypeIndex{0};
+  bool linear{true};
+};
+
+// Suballocates the memory of VBuffers and VImages from large VkDeviceMemory
+// blocks, as drivers (Android ones especially) are slow to allocate device
+// memory and cap the number of allocations.
+//
+// Sizes are rounded up to size classes, four per power of two, and the
+// ranges freed are kept in per class free lists to be reused by the next
+// allocations of the class, e.g. by the tensors of the next inference. The
+// memory is only returned to the driver when the context is destroyed.
+// Linear (buffer) and optimal tiling (image) resources are pooled separately,
+// so that they never share a bufferImageGranularity page.
+class VMemoryPool final {
+ public:
+  static constexpr VkDeviceSize kBlockSize = 32 * 1024 * 1024;
+  // Larger allocations get a block of their own.
+  static constexpr VkDeviceSize kMaxSuballocationSize = kBlockSize / 4;
+  static constexpr VkDeviceSize kMinSizeClass = 256;
+
+  VMemoryPool(VkDevice device, VkPhysicalDevice physicalDevice);
+  ~VMemoryPool();
+  VMemoryPool(const VMemoryPool&) = delete;
+  VMemoryPool& operator=(const VMemoryPool&) = delete;
+
+  VMemory allocate(
+      const VkMemoryRequirements& memoryRequirements,
+      VkMemoryPropertyFlags memoryProperties,
+      bool linear);
+  void free(const VMemory& memory);
+
+  VulkanMemoryStats stats() const;
+
+  static VkDeviceSize sizeClass(VkDeviceSize size);
+
+ private:
+  struct Block {
+    VkDeviceMemory deviceMemory;
+    VkDeviceSize size;
+    VkDeviceSize used;
+    void* mappedData;
+  };
+  struct Pool {
+    std::vector<Block> blocks;
+    std::unordered_map<VkDeviceSize, std::vector<VMemory>> freeLists;
+  };
+
+  Block& allocateBlock(
+      Pool& pool,
+      uint32_t memoryTypeIndex,
+      VkDeviceSize size,
+      bool mapped);
+
+  VkDevice device_;
+  VkPhysicalDeviceMemoryProperties memoryProperties_;
+  VkDeviceSize nonCoherentAtomSize_;
+  // Keyed on the memory type index and whether resources are linear.
+  std::map<std::pair<uint32_t, bool>, Pool> pools_;
+  mutable std::mutex mutex_;
+  int64_t deviceMemoryAllocations_{0};
+  int64_t deviceMemoryBytes_{0};
+  int64_t allocations_{0};
+  int64_t allocatedBytes_{0};
+  int64_t cachedBytes_{0};
+  int64_t numRequests_{0};
+  int64_t numReused_{0};
 };
 
 class VBuffer final {
@@ -190,16 +290,13 @@ class VBuffer final {
         VkDevice device,
         VkDeviceMemory deviceMemory,
         VkDeviceSize offset,
-        VkDeviceSize size)
+        VkDeviceSize size,
+        void* mappedMemory)
         : device_(device),
           deviceMemory_(deviceMemory),
           offset_(offset),
-          size_(size) {
-      vkMapMemory(device_, deviceMemory_, 0, size, 0, &mappedMemory_);
-    }
-    ~MapMemory() {
-      vkUnmapMemory(device_, deviceMemory_);
-    }
+          size_(size),
+          mappedMemory_(mappedMemory) {}
     MapMemory(const MapMemory&) = delete;
     MapMemory& operator=(const MapMemory&) = delete;
     MapMemory(MapMemory&&) = default;
@@ -228,8 +325,8 @@ class VBuffer final {
 
   VBuffer(const VBuffer&) = delete;
   VBuffer& operator=(const VBuffer&) = delete;
-  VBuffer(VBuffer&&) = default;
-  VBuffer& operator=(VBuffer&&) = default;
+  VBuffer(VBuffer&& other) noexcept;
+  VBuffer& operator=(VBuffer&& other) noexcept;
 
   static inline VBuffer makeUniformBuffer(VkDeviceSize bufferSize) {
     return VBuffer{bufferSize,
@@ -238,7 +335,11 @@ class VBuffer final {
   }
 
   MapMemory map() {
-    return MapMemory{context().device(), bufferMemory_, 0, bufferSizeBytes_};
+    return MapMemory{context().device(),
+                     memory_.deviceMemory,
+                     memory_.offset,
+                     memory_.size,
+                     memory_.mappedData};
   }
 
   void copy_from_device_to_host(void* outputData, int64_t size);
@@ -266,7 +367,7 @@ class VBuffer final {
   VkDeviceSize bufferSizeBytes_;
   VkDescriptorType descriptorType_;
   VkBuffer buffer_;
-  VkDeviceMemory bufferMemory_;
+  VMemory memory_;
 };
 
 VBuffer makeUniformConstBuffer(void* ptr, VkDeviceSize size);
@@ -286,8 +387,8 @@ class VImage final {
   ~VImage();
   VImage(const VImage&) = delete;
   VImage& operator=(const VImage&) = delete;
-  VImage(VImage&&) = default;
-  VImage& operator=(VImage&&) = default;
+  VImage(VImage&& other) noexcept;
+  VImage& operator=(VImage&& other) noexcept;
 
   inline auto w() const {
     return imageSize_[0];
@@ -338,7 +439,7 @@ class VImage final {
   ImageSize imageSize_;
   ImageSize dataSize_;
   VkImage image_;
-  VkDeviceMemory imageMemory_;
+  VMemory memory_;
   VkImageView imageView_;
   VkSampler sampler_;
   // Holds current image layout that will be used in
@@ -385,7 +486,6 @@ struct WorkGroupSize {
 
 class ComputeUnit final {
  public:
-  static constexpr uint64_t kFenceTimeoutNanos = 100000000000;
 #ifdef USE_VULKAN_SHADERC_RUNTIME
   ComputeUnit(
       const char* glslSrc,
@@ -423,7 +523,10 @@ class ComputeUnit final {
       WorkGroupSize& workGroupSize);
 #endif
 
-  void createCommandBuffer(VkDescriptorSet& descriptorSet);
+  // Binds the pipeline and the descriptorSet in the command buffer of the
+  // context command batch, which the following barriers and dispatches of the
+  // unit are recorded into.
+  void bindCommandBuffer(VkDescriptorSet& descriptorSet);
   void addMemoryBarrier(
       VkPipelineStageFlags srcStageMask,
       VkAccessFlags srcAccessMask,
@@ -438,8 +541,6 @@ class ComputeUnit final {
       uint32_t gridY,
       uint32_t gridZ,
       WorkGroupSize workGroupSize);
-  void submitAndWaitCommandBuffer();
-  void endCommandBuffer();
   inline VkCommandBuffer commandBuffer() {
     return commandBuffer_;
   }
@@ -451,6 +552,99 @@ class ComputeUnit final {
   VkShaderModule computeShaderModule_;
 };
 
+// Creating a pipeline compiles the shader for the device, which takes longer
+// than running most of the ops. ComputeUnitFactory keeps the ComputeUnits
+// for the lifetime of the context, keyed on the shader name and the work group
+// size that is specialized into the pipeline.
+class ComputeUnitFactory final {
+ public:
+  ComputeUnitFactory() = default;
+  ComputeUnitFactory(const ComputeUnitFactory&) = delete;
+  ComputeUnitFactory& operator=(const ComputeUnitFactory&) = delete;
+
+#ifdef USE_VULKAN_SHADERC_RUNTIME
+  ComputeUnit& get(
+      const char* key,
+      const char* glslSrc,
+      const VkDescriptorSetLayout& descrSetLayout,
+      WorkGroupSize workGroupSize);
+#else
+  ComputeUnit& get(
+      const char* key,
+      const uint32_t* spvCode,
+      const unsigned int spvCodeSize,
+      const VkDescriptorSetLayout& descrSetLayout,
+      WorkGroupSize workGroupSize);
+#endif
+
+ private:
+  std::string getCacheKey(const char* key, WorkGroupSize workGroupSize);
+
+  std::unordered_map<std::string, std::unique_ptr<ComputeUnit>> computeUnits_;
+};
+
+// Ops record their dispatches into the single command buffer of
+// VCommandBatch, ordered by the pipeline barriers of the images and buffers
+// they use, instead of submitting a command buffer per op and waiting for
+// it. The batch is submitted once, when the results are read by the host
+// (VulkanTensor::copy_data_to_host), or earlier when the descriptor pool it
+// allocates the descriptor sets of the dispatches from is exhausted.
+//
+// Vulkan objects used by the recorded dispatches must live until the batch is
+// flushed, even if the ops that created them (e.g. uniform buffers of
+// parameters) or the tensors that own them are gone: their destruction is
+// deferred with releaseAfterFlush.
+//
+// Like the rest of the backend, VCommandBatch is not thread safe.
+class VCommandBatch final {
+ public:
+  static constexpr uint64_t kFenceTimeoutNanos = 100000000000;
+  static constexpr uint32_t kDescriptorPoolMaxSets = 256;
+  // Per descriptor type, the most descriptors of a set that the pool is
+  // sized for.
+  static constexpr uint32_t kMaxDescriptorsPerSet = 4;
+
+  VCommandBatch(VkDevice device, VkQueue queue, VkCommandPool commandPool);
+  ~VCommandBatch();
+  VCommandBatch(const VCommandBatch&) = delete;
+  VCommandBatch& operator=(const VCommandBatch&) = delete;
+
+  // Returns the command buffer the batch records into, beginning it if
+  // nothing is recorded yet.
+  VkCommandBuffer commandBuffer();
+
+  inline bool empty() const {
+    return !recording_;
+  }
+
+  // Returns the cached layout for descrTypes (bound at binding 0, 1, ...) and
+  // allocates a descriptor set of it, which is valid until the next flush.
+  void allocateDescriptorSet(
+      const std::vector<VkDescriptorType>& descrTypes,
+      VkDescriptorSetLayout* descrSetLayout,
+      VkDescriptorSet* descrSet);
+
+  // Calls release after the recorded commands completed, or right away if
+  // nothing is recorded.
+  void releaseAfterFlush(std::function<void()> release);
+
+  // Submits the recorded commands and waits for them to complete.
+  void flush();
+
+ private:
+  VkDevice device_;
+  VkQueue queue_;
+  VkCommandPool commandPool_;
+  VkCommandBuffer commandBuffer_;
+  VkFence fence_;
+  VkDescriptorPool descriptorPool_;
+  uint32_t descriptorSetsAllocated_{0};
+  bool recording_{false};
+  std::map<std::vector<VkDescriptorType>, VkDescriptorSetLayout>
+      descriptorSetLayouts_;
+  std::vector<std::function<void()>> releases_;
+};
+
 std::ostream& operator<<(std::ostream& s, const WorkGroupSize& workGroupSize);
 std::ostream& operator<<(std::ostream& s, const ImageSize& imageSize);
 std::ostream& operator<<(std::ostream& s, const ImageSizes& imageSizes);
@@ -54,6 +54,25 @@ struct ContextConv2D final {
   static constexpr float kMax = std::numeric_limits<float>::infinity();
 };
 
+// Device memory of the Vulkan tensors, see VMemoryPool.
+struct VulkanMemoryStats final {
+  // VkDeviceMemory allocated from the driver.
+  int64_t device_memory_allocations = 0;
+  int64_t device_memory_bytes = 0;
+  // Memory in use by tensors, with sizes rounded up to their size class.
+  int64_t allocations = 0;
+  int64_t allocated_bytes = 0;
+  // Memory freed by tensors and kept for reuse.
+  int64_t cached_bytes = 0;
+  // Allocations requested since the context was created, and the number of
+  // them served with memory freed by earlier tensors.
+  int64_t num_requests = 0;
+  int64_t num_reused = 0;
+};
+
+// Returns zeros if the Vulkan context is not created yet.
+VulkanMemoryStats memory_stats();
+
 } // namespace vulkan
 } // namespace native
 } // namespace at
@@ -26,7 +26,6 @@ void upsample_nearest2d(
     int64_t _C,
     float scaleH,
     float scaleW) {
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   int64_t C = _N * _C;
   struct ConstBlock {
@@ -41,34 +40,26 @@ void upsample_nearest2d(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  context().commandBatch().allocateDescriptorSet(
+      descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
   constBuffer.bind(descriptorSet, 2);
 
   WorkGroupSize workGroupSize{8, 8, 1};
-  ComputeUnit computeUnit{at::native::vulkan::GLSL_SPV(upsampleNearest2d),
-                          descriptorSetLayout,
-                          workGroupSize};
-  computeUnit.createCommandBuffer(descriptorSet);
-  input.image()->addImageMemoryBarrierToShaderRead(computeUnit.commandBuffer());
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(upsampleNearest2d), descriptorSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descriptorSet);
+  auto commandBuffer = computeUnit.commandBuffer();
+  output.image()->addImageMemoryBarrierToGeneral(commandBuffer);
+  input.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   computeUnit.dispatchCommandBuffer(OW, OH, C, workGroupSize);
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void add(
@@ -90,7 +81,6 @@ void add(
   auto H = sizes[2];
   auto W = sizes[3];
 
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   struct ConstBlock {
     int32_t W;
@@ -102,19 +92,14 @@ void add(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  context().commandBatch().allocateDescriptorSet(
+      descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input0.image()->bindShaderRead(descriptorSet, 1);
@@ -122,18 +107,14 @@ void add(
   constBuffer.bind(descriptorSet, 3);
 
   WorkGroupSize workGroupSize{8, 8, 1};
-  ComputeUnit computeUnit{
-      at::native::vulkan::GLSL_SPV(add), descriptorSetLayout, workGroupSize};
-  computeUnit.createCommandBuffer(descriptorSet);
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(add), descriptorSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descriptorSet);
   auto commandBuffer = computeUnit.commandBuffer();
   output.image()->addImageMemoryBarrierToGeneral(commandBuffer);
   input0.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   input1.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   computeUnit.dispatchCommandBuffer(W, H, C, workGroupSize);
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 VBuffer kernelNCHW_OCHW_repack_O4C4HWi4o4(
@@ -233,7 +214,6 @@ void conv2d_depthwise(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
@@ -241,13 +221,8 @@ void conv2d_depthwise(
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  auto device = context().device();
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  context().commandBatch().allocateDescriptorSet(
+      descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
@@ -256,22 +231,15 @@ void conv2d_depthwise(
   constBuffer.bind(descriptorSet, 4);
 
   WorkGroupSize workGroupSize{8, 8, 1};
-  ComputeUnit computeUnit =
-      ComputeUnit{at::native::vulkan::GLSL_SPV(conv2d_dw_clamp),
-                  descriptorSetLayout,
-                  workGroupSize};
-  computeUnit.createCommandBuffer(descriptorSet);
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(conv2d_dw_clamp), descriptorSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descriptorSet);
   auto commandBuffer = computeUnit.commandBuffer();
   output.image()->addImageMemoryBarrierToGeneral(commandBuffer);
   input.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   weight.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   computeUnit.dispatchCommandBuffer(
       params.OW, params.OH, params.OC_4, workGroupSize);
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void conv2d_depthwise(
@@ -345,28 +313,22 @@ void conv2d_prepack_weights_to_image(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      context().device(),
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  context().commandBatch().allocateDescriptorSet(
+      descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   image.bindStorageImage(descriptorSet, 0);
   kernelBuffer.bind(descriptorSet, 1);
   constBuffer.bind(descriptorSet, 2);
 
   WorkGroupSize workGroupSize{1, 1, 1};
-  ComputeUnit computeUnit{at::native::vulkan::GLSL_SPV(KO4C4HW_to_image),
-                          descriptorSetLayout,
-                          workGroupSize};
-  computeUnit.createCommandBuffer(descriptorSet);
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(KO4C4HW_to_image), descriptorSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descriptorSet);
   auto commandBuffer = computeUnit.commandBuffer();
   image.addImageMemoryBarrierToGeneral(commandBuffer);
   kernelBuffer.addBufferMemoryBarrier(
@@ -377,11 +339,6 @@ void conv2d_prepack_weights_to_image(
       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
       VK_ACCESS_SHADER_READ_BIT);
   computeUnit.dispatchCommandBuffer(C_4, OC_4, KH * KW, workGroupSize);
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(context().device(), descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(
-      context().device(), descriptorSetLayout, nullptr);
 }
 
 VImage conv2d_prepack_weights_image(
@@ -449,9 +406,7 @@ void conv2d(
                 outputMax};
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
-  auto device = context().device();
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
@@ -459,12 +414,8 @@ void conv2d(
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  context().commandBatch().allocateDescriptorSet(
+      descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
@@ -473,10 +424,9 @@ void conv2d(
   constBuffer.bind(descriptorSet, 4);
 
   WorkGroupSize workGroupSize{1, 1, params.OC_4};
-  ComputeUnit computeUnit{at::native::vulkan::GLSL_SPV(conv2d_nogroup_clamp),
-                          descriptorSetLayout,
-                          workGroupSize};
-  computeUnit.createCommandBuffer(descriptorSet);
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(conv2d_nogroup_clamp), descriptorSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descriptorSet);
   auto commandBuffer = computeUnit.commandBuffer();
   output.image()->addImageMemoryBarrierToGeneral(commandBuffer);
   input.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
@@ -485,11 +435,6 @@ void conv2d(
       UP_DIV(params.OW, 4 * workGroupSize.x),
       UP_DIV(params.OH, workGroupSize.y),
       UP_DIV(params.OC_4, workGroupSize.z));
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void conv2d(
@@ -611,7 +556,6 @@ void clamp(
   auto W = sizes[3];
   auto C_4 = UP_DIV(C, 4);
 
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   struct ConstBlock {
     int32_t W;
@@ -625,35 +569,26 @@ void clamp(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  context().commandBatch().allocateDescriptorSet(
+      descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
   constBuffer.bind(descriptorSet, 2);
 
   WorkGroupSize workGroupSize{8, 8, 1};
-  ComputeUnit computeUnit{
-      at::native::vulkan::GLSL_SPV(clamp), descriptorSetLayout, workGroupSize};
-  computeUnit.createCommandBuffer(descriptorSet);
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(clamp), descriptorSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descriptorSet);
   auto commandBuffer = computeUnit.commandBuffer();
   output.image()->addImageMemoryBarrierToGeneral(commandBuffer);
   input.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   computeUnit.dispatchCommandBuffer(W, H, C, workGroupSize);
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void addmm(
@@ -692,7 +627,6 @@ void addmm(
   uint32_t TW = tSizes[1];
   uint32_t TC = 1;
 
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
 
   struct ConstBlock {
@@ -708,7 +642,6 @@ void addmm(
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
@@ -716,12 +649,8 @@ void addmm(
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  context().commandBatch().allocateDescriptorSet(
+      descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   m1.image()->bindShaderRead(descriptorSet, 1);
@@ -730,19 +659,15 @@ void addmm(
   constBuffer.bind(descriptorSet, 4);
 
   WorkGroupSize workGroupSize{8, 8, 1};
-  ComputeUnit computeUnit{
-      at::native::vulkan::GLSL_SPV(addmm), descriptorSetLayout, workGroupSize};
-  computeUnit.createCommandBuffer(descriptorSet);
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(addmm), descriptorSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descriptorSet);
   auto commandBuffer = computeUnit.commandBuffer();
   output.image()->addImageMemoryBarrierToGeneral(commandBuffer);
   m1.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   m2.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   t.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   computeUnit.dispatchCommandBuffer(OW, OH, C_4, workGroupSize);
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 void mean(VulkanTensor& output, const VulkanTensor& input) {
@@ -753,7 +678,6 @@ void mean(VulkanTensor& output, const VulkanTensor& input) {
   auto W = isizes[3];
   auto C_4 = UP_DIV(N * C, 4);
 
-  auto device = context().device();
   auto physicalDevice = context().physicalDevice();
   struct ConstBlock {
     int32_t W;
@@ -765,35 +689,26 @@ void mean(VulkanTensor& output, const VulkanTensor& input) {
   VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
 
   VkDescriptorSetLayout descriptorSetLayout{};
-  VkDescriptorPool descriptorPool{};
   VkDescriptorSet descriptorSet{};
   std::vector<VkDescriptorType> descriptorTypes{
       VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
-  createDescriptorSetLayoutSinglePool(
-      device,
-      descriptorTypes,
-      &descriptorSetLayout,
-      &descriptorPool,
-      &descriptorSet);
+  context().commandBatch().allocateDescriptorSet(
+      descriptorTypes, &descriptorSetLayout, &descriptorSet);
 
   output.image()->bindStorageImage(descriptorSet, 0);
   input.image()->bindShaderRead(descriptorSet, 1);
   constBuffer.bind(descriptorSet, 2);
 
   WorkGroupSize workGroupSize{1, 1, 1};
-  ComputeUnit computeUnit{
-      at::native::vulkan::GLSL_SPV(mean), descriptorSetLayout, workGroupSize};
-  computeUnit.createCommandBuffer(descriptorSet);
+  auto& computeUnit = context().computeUnitFactory().get(
+      GLSL_SPV(mean), descriptorSetLayout, workGroupSize);
+  computeUnit.bindCommandBuffer(descriptorSet);
   auto commandBuffer = computeUnit.commandBuffer();
   output.image()->addImageMemoryBarrierToGeneral(commandBuffer);
   input.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
   computeUnit.dispatchCommandBuffer(1, 1, C_4, workGroupSize);
-  computeUnit.endCommandBuffer();
-  computeUnit.submitAndWaitCommandBuffer();
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
 } // namespace detail
@@ -0,0 +1,163 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/xnnpack/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// XNNPACK's _nc element-wise operators process a batch of rows of channels.
+// Since the activations here don't depend on the position of an element, the
+// tensor is treated as numel() rows of a single channel, which lets these ops
+// run on tensors of any rank and memory format as long as they are dense.
+
+bool use_unary(const Tensor& input) {
+  return xnnpack::internal::available() &&
+      // Input
+      (1 <= input.dim()) &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      !input.requires_grad() &&
+      true;
+}
+
+using CreateUnary = xnn_status (*)(size_t, size_t, size_t, uint32_t, xnn_operator_t*);
+using SetupUnary = xnn_status (*)(xnn_operator_t, size_t, const float*, float*, pthreadpool_t);
+
+void unary_impl(
+    const Tensor& input,
+    Tensor& output,
+    const CreateUnary create,
+    const SetupUnary setup,
+    const char* const name) {
+  using namespace internal;
+
+  xnn_operator_t unary_op{};
+
+  const xnn_status create_status = create(
+      1u,           // channels
+      1u,           // input_stride
+      1u,           // output_stride
+      0u,           // flags
+      &unary_op);   // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_", name, "_nc_f32 failed!");
+
+  Operator unary_scoped_op(unary_op);
+
+  const xnn_status setup_status = setup(
+      unary_op,                   // operator
+      input.numel(),              // batch_size
+      input.data_ptr<float>(),    // input
+      output.data_ptr<float>(),   // output
+      caffe2::pthreadpool_());    // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_", name, "_nc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      unary_op,                 // operator
+      caffe2::pthreadpool_());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+}
+
+Tensor unary(
+    const Tensor& input,
+    const CreateUnary create,
+    const SetupUnary setup,
+    const char* const name) {
+  using namespace internal;
+
+  // The memory format of the input is kept, so that an NHWC region of the
+  // graph stays in NHWC across the activations.
+  const c10::MemoryFormat memory_format = input.suggest_memory_format();
+
+  const Tensor padded_input = allocate_padded_contiguous_if_needed(
+      input,
+      memory_format);
+
+  Tensor output = empty_with_tail_padding(
+      padded_input.sizes(),
+      padded_input.options().dtype(),
+      memory_format,
+      padded_input.names());
+
+  unary_impl(padded_input, output, create, setup, name);
+
+  return output;
+}
+
+} // namespace
+
+bool use_hardswish(const Tensor& input) {
+  return use_unary(input);
+}
+
+Tensor hardswish(const Tensor& input) {
+  return unary(
+      input,
+      xnn_create_hardswish_nc_f32,
+      xnn_setup_hardswish_nc_f32,
+      "hardswish");
+}
+
+Tensor& hardswish_(Tensor& input) {
+  using namespace internal;
+
+  const Tensor padded_input = allocate_padded_contiguous_if_needed(
+      input,
+      input.suggest_memory_format());
+
+  // Operate in place if the input is already dense and tail padded.
+  if (input.data_ptr() == padded_input.data_ptr()) {
+    unary_impl(
+        input,
+        input,
+        xnn_create_hardswish_nc_f32,
+        xnn_setup_hardswish_nc_f32,
+        "hardswish");
+    return input;
+  }
+
+  Tensor output = empty_with_tail_padding(
+      padded_input.sizes(),
+      padded_input.options().dtype(),
+      input.suggest_memory_format(),
+      padded_input.names());
+
+  unary_impl(
+      padded_input,
+      output,
+      xnn_create_hardswish_nc_f32,
+      xnn_setup_hardswish_nc_f32,
+      "hardswish");
+
+  return input.copy_(output);
+}
+
+bool use_sigmoid(const Tensor& input) {
+  return use_unary(input);
+}
+
+Tensor sigmoid(const Tensor& input) {
+  return unary(
+      input,
+      xnn_create_sigmoid_nc_f32,
+      xnn_setup_sigmoid_nc_f32,
+      "sigmoid");
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
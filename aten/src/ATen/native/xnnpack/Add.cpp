@@ -0,0 +1,138 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/ExpandUtils.h>
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/xnnpack/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// The number of dimensions xnn_setup_add_nd_f32 broadcasts over.
+constexpr int64_t kMaxDims = 4;
+
+// XNNPACK broadcasts the shapes of the inputs as they are laid out in memory,
+// which, for an NHWC tensor, is the N, H, W, C permutation of its sizes.
+std::vector<size_t> memory_shape(
+    const IntArrayRef sizes,
+    const c10::MemoryFormat memory_format) {
+  using namespace internal;
+
+  if (MemoryFormat::ChannelsLast == memory_format) {
+    return {
+      static_cast<size_t>(sizes[Layout::Activation4D::batch]),
+      static_cast<size_t>(sizes[Layout::Activation4D::height]),
+      static_cast<size_t>(sizes[Layout::Activation4D::width]),
+      static_cast<size_t>(sizes[Layout::Activation4D::channels]),
+    };
+  }
+
+  return std::vector<size_t>(sizes.begin(), sizes.end());
+}
+
+} // namespace
+
+// Supports NHWC and NCHW FP32 addition, with NumPy style broadcasting, of
+// tensors of up to 4 dimensions.  The memory format of self is used for the
+// computation and the output, so an NHWC region of the graph stays in NHWC.
+
+bool use_add(
+    const Tensor& self,
+    const Tensor& other,
+    const Scalar alpha) {
+  const bool channels_last =
+      (MemoryFormat::ChannelsLast == self.suggest_memory_format());
+
+  return xnnpack::internal::available() &&
+      // Inputs
+      (c10::DeviceType::CPU == self.device().type()) &&
+      (c10::DeviceType::CPU == other.device().type()) &&
+      (kFloat == self.scalar_type()) &&
+      (kFloat == other.scalar_type()) &&
+      !self.requires_grad() &&
+      !other.requires_grad() &&
+      (1 <= self.dim()) && (kMaxDims >= self.dim()) &&
+      (1 <= other.dim()) && (kMaxDims >= other.dim()) &&
+      (self.numel() > 0) && (other.numel() > 0) &&
+      !self.has_names() && !other.has_names() &&
+      // NHWC inputs are only broadcast against other 4D tensors, as the
+      // dimensions wouldn't line up otherwise.
+      (!channels_last || (4 == other.dim())) &&
+      // Alpha
+      (1.0 == alpha.toDouble()) &&
+      true;
+}
+
+Tensor add(
+    const Tensor& self,
+    const Tensor& other) {
+  using namespace internal;
+
+  const c10::MemoryFormat memory_format = self.suggest_memory_format();
+
+  const Tensor self_padded_contig = allocate_padded_contiguous_if_needed(
+      self,
+      memory_format);
+
+  const Tensor other_padded_contig = allocate_padded_contiguous_if_needed(
+      other,
+      memory_format);
+
+  Tensor output_padded_contig = empty_with_tail_padding(
+      infer_size(self.sizes(), other.sizes()),
+      self_padded_contig.options().dtype(),
+      memory_format,
+      DimnameList{});
+
+  const std::vector<size_t> self_shape =
+      memory_shape(self_padded_contig.sizes(), memory_format);
+  const std::vector<size_t> other_shape =
+      memory_shape(other_padded_contig.sizes(), memory_format);
+
+  xnn_operator_t add_op{};
+
+  const xnn_status create_status = xnn_create_add_nd_f32(
+      -std::numeric_limits<float>::infinity(),  // output_min
+      +std::numeric_limits<float>::infinity(),  // output_max
+      0u,                                       // flags
+      &add_op);                                 // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_add_nd_f32 failed!");
+
+  Operator add_scoped_op(add_op);
+
+  const xnn_status setup_status = xnn_setup_add_nd_f32(
+      add_op,                                     // operator
+      self_shape.size(),                          // num_input1_dims
+      self_shape.data(),                          // input1_shape
+      other_shape.size(),                         // num_input2_dims
+      other_shape.data(),                         // input2_shape
+      self_padded_contig.data_ptr<float>(),       // input1
+      other_padded_contig.data_ptr<float>(),      // input2
+      output_padded_contig.data_ptr<float>(),     // output
+      caffe2::pthreadpool_());                    // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_add_nd_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      add_op,                   // operator
+      caffe2::pthreadpool_());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig;
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
@@ -0,0 +1,297 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/Pool.h>
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/xnnpack/Factory.h>
+#include <ATen/native/xnnpack/Pooling.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+
+// Supports NHWC and NCHW FP32 average pooling with any
+//  - kernel size
+//  - padding
+//  - stride
+//
+// XNNPACK leaves the padding out of the average, so padding is only supported
+// along with count_include_pad == false.
+
+bool use_avg_pool2d(
+    const Tensor& input,
+    const IntArrayRef kernel_,
+    IntArrayRef stride_,
+    const IntArrayRef padding_,
+    const bool ceil_mode,
+    const bool count_include_pad,
+    const c10::optional<int64_t> divisor_override) {
+  using namespace internal;
+
+  // Make sure we are not dealing with an unorthodox configuration.
+  if (kernel_.empty() || padding_.empty()) {
+    return false;
+  }
+
+  // Stride can be legitimately empty, in which case it is to be defaulted to kernel size.
+  if (stride_.empty()) {
+    stride_ = kernel_;
+  }
+
+  // Normalize the parameters.  Average pooling has no dilation.
+  const internal::pooling::Parameters parameters{
+    kernel_,
+    padding_,
+    stride_,
+    {1, 1},
+  };
+
+  if ((parameters.kernel[Layout::Parameter::height] <= 0) ||
+      (parameters.kernel[Layout::Parameter::width] <= 0) ||
+      (parameters.stride[Layout::Parameter::height] <= 0) ||
+      (parameters.stride[Layout::Parameter::width] <= 0) ||
+      (4 != input.dim())) {
+    return false;
+  }
+
+  // See use_max_pool2d for why ceil mode is only supported when it doesn't
+  // change the output size.
+  const auto output_size = [&](const int64_t input_size, const size_t dim, const bool ceil) {
+    return pooling_output_shape(
+        input_size,
+        parameters.kernel[dim],
+        parameters.padding[dim],
+        parameters.stride[dim],
+        parameters.dilation[dim],
+        ceil);
+  };
+
+  const int64_t input_height = input.size(Layout::Activation4D::height);
+  const int64_t input_width = input.size(Layout::Activation4D::width);
+
+  const int64_t output_height =
+      output_size(input_height, Layout::Parameter::height, ceil_mode);
+  const int64_t output_width =
+      output_size(input_width, Layout::Parameter::width, ceil_mode);
+
+  const bool output_size_eq =
+      (output_height == output_size(input_height, Layout::Parameter::height, false)) &&
+      (output_width == output_size(input_width, Layout::Parameter::width, false));
+
+  const bool padded = (parameters.padding[Layout::Parameter::height] > 0) ||
+      (parameters.padding[Layout::Parameter::width] > 0);
+
+  // Here are the list of conditions required for this code path to be taken:
+  // * Input must be 4D CPU float tensor with no gradients.
+  // * Kernel must be a 2D IntArrayRef containing two positive numbers.
+  //   Furthermore, 1x1 kernels are not valid as XNNPACK prohibits their use.
+  // * Padding must be a 2D IntArrayRef containing two non-negative numbers,
+  //   and padded elements must not count towards the average.
+  // * Stride must be a 2D IntArrayRef containing two positive numbers.
+  // * Ceil mode must not change the output size.
+  // * There must be no divisor override.
+  // * Finally, the output must have a valid shape.
+  return xnnpack::internal::available() &&
+      // Input
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      !input.requires_grad() &&
+      // Kernel
+      ((parameters.kernel[Layout::Parameter::height] *
+        parameters.kernel[Layout::Parameter::width]) > 1) &&
+      // Padding
+      (parameters.padding[Layout::Parameter::height] >= 0) &&
+      (parameters.padding[Layout::Parameter::width] >= 0) &&
+      (!padded || !count_include_pad) &&
+      // Ceil Mode
+      (!ceil_mode || output_size_eq) &&
+      // Divisor
+      !divisor_override.has_value() &&
+      // Output
+      (output_height > 0) &&
+      (output_width > 0) &&
+      true;
+}
+
+Tensor avg_pool2d(
+    const Tensor& input,
+    const IntArrayRef kernel_,
+    IntArrayRef stride_,
+    const IntArrayRef padding_,
+    const bool ceil_mode) {
+  using namespace internal;
+
+  // A call to avg_pool2d must have been gated by a call to use_avg_pool2d, so
+  // the parameters are guaranteed to be valid at this point.  Still, stride can
+  // be empty, and the parameters not normalized.
+
+  if (stride_.empty()) {
+    stride_ = kernel_;
+  }
+
+  const internal::pooling::Parameters parameters{
+    kernel_,
+    padding_,
+    stride_,
+    {1, 1},
+  };
+
+  const Tensor input_padded_contig_nhwc = allocate_padded_contiguous_if_needed(
+      input,
+      MemoryFormat::ChannelsLast);
+
+  Tensor output_padded_contig_nhwc = empty_with_tail_padding(
+      {
+        input_padded_contig_nhwc.size(Layout::Activation4D::batch),
+        input_padded_contig_nhwc.size(Layout::Activation4D::channels),
+        pooling_output_shape(
+            input_padded_contig_nhwc.size(Layout::Activation4D::height),
+            parameters.kernel[Layout::Parameter::height],
+            parameters.padding[Layout::Parameter::height],
+            parameters.stride[Layout::Parameter::height],
+            parameters.dilation[Layout::Parameter::height],
+            ceil_mode),
+        pooling_output_shape(
+            input_padded_contig_nhwc.size(Layout::Activation4D::width),
+            parameters.kernel[Layout::Parameter::width],
+            parameters.padding[Layout::Parameter::width],
+            parameters.stride[Layout::Parameter::width],
+            parameters.dilation[Layout::Parameter::width],
+            ceil_mode),
+      },
+      input_padded_contig_nhwc.options().dtype(),
+      MemoryFormat::ChannelsLast,
+      input_padded_contig_nhwc.names());
+
+  xnn_operator_t avg_pool_op{};
+
+  const xnn_status create_status = xnn_create_average_pooling2d_nhwc_f32(
+      parameters.padding[Layout::Parameter::height],                  // input_padding_top
+      parameters.padding[Layout::Parameter::width],                   // input_padding_right
+      parameters.padding[Layout::Parameter::height],                  // input_padding_bottom
+      parameters.padding[Layout::Parameter::width],                   // input_padding_left
+      parameters.kernel[Layout::Parameter::height],                   // pooling_height
+      parameters.kernel[Layout::Parameter::width],                    // pooling_width
+      parameters.stride[Layout::Parameter::height],                   // stride_height
+      parameters.stride[Layout::Parameter::width],                    // stride_width
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // channels
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // input_pixel_stride - NHWC Contiguous
+      output_padded_contig_nhwc.size(Layout::Activation4D::channels), // output_pixel_stride - NHWC Contiguous
+      -std::numeric_limits<float>::infinity(),                        // output_min
+      +std::numeric_limits<float>::infinity(),                        // output_max
+      0u,                                                             // flags
+      &avg_pool_op);                                                  // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_average_pooling2d_nhwc_f32 failed!");
+
+  Operator avg_pool_scoped_op(avg_pool_op);
+
+  const xnn_status setup_status = xnn_setup_average_pooling2d_nhwc_f32(
+      avg_pool_op,                                                  // operator
+      input_padded_contig_nhwc.size(Layout::Activation4D::batch),   // batch_size
+      input_padded_contig_nhwc.size(Layout::Activation4D::height),  // input_height
+      input_padded_contig_nhwc.size(Layout::Activation4D::width),   // input_width
+      input_padded_contig_nhwc.data_ptr<float>(),                   // input
+      output_padded_contig_nhwc.data_ptr<float>(),                  // output
+      caffe2::pthreadpool_());                                      // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_average_pooling2d_nhwc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      avg_pool_op,              // operator
+      caffe2::pthreadpool_());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig_nhwc.contiguous(input.suggest_memory_format());
+}
+
+// Supports NHWC and NCHW FP32 global average pooling, i.e. adaptive average
+// pooling to a 1x1 output.
+
+bool use_global_average_pool(const Tensor& input) {
+  using namespace internal;
+
+  return xnnpack::internal::available() &&
+      // Input
+      (4 == input.dim()) &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      !input.requires_grad() &&
+      (input.size(Layout::Activation4D::height) > 0) &&
+      (input.size(Layout::Activation4D::width) > 0) &&
+      true;
+}
+
+Tensor global_average_pool(const Tensor& input) {
+  using namespace internal;
+
+  const Tensor input_padded_contig_nhwc = allocate_padded_contiguous_if_needed(
+      input,
+      MemoryFormat::ChannelsLast);
+
+  Tensor output_padded_contig_nhwc = empty_with_tail_padding(
+      {
+        input_padded_contig_nhwc.size(Layout::Activation4D::batch),
+        input_padded_contig_nhwc.size(Layout::Activation4D::channels),
+        1,
+        1,
+      },
+      input_padded_contig_nhwc.options().dtype(),
+      MemoryFormat::ChannelsLast,
+      input_padded_contig_nhwc.names());
+
+  xnn_operator_t global_avg_pool_op{};
+
+  const xnn_status create_status = xnn_create_global_average_pooling_nwc_f32(
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // channels
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // input_stride - NHWC Contiguous
+      output_padded_contig_nhwc.size(Layout::Activation4D::channels), // output_stride - NHWC Contiguous
+      -std::numeric_limits<float>::infinity(),                        // output_min
+      +std::numeric_limits<float>::infinity(),                        // output_max
+      0u,                                                             // flags
+      &global_avg_pool_op);                                           // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_global_average_pooling_nwc_f32 failed!");
+
+  Operator global_avg_pool_scoped_op(global_avg_pool_op);
+
+  // The height and width of an NHWC tensor are contiguous, so they are pooled
+  // as a single spatial dimension.
+  const xnn_status setup_status = xnn_setup_global_average_pooling_nwc_f32(
+      global_avg_pool_op,                                           // operator
+      input_padded_contig_nhwc.size(Layout::Activation4D::batch),   // batch_size
+      input_padded_contig_nhwc.size(Layout::Activation4D::height) *
+          input_padded_contig_nhwc.size(Layout::Activation4D::width), // width
+      input_padded_contig_nhwc.data_ptr<float>(),                   // input
+      output_padded_contig_nhwc.data_ptr<float>(),                  // output
+      caffe2::pthreadpool_());                                      // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_global_average_pooling_nwc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      global_avg_pool_op,       // operator
+      caffe2::pthreadpool_());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig_nhwc.contiguous(input.suggest_memory_format());
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
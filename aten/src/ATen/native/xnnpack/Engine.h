@@ -66,6 +66,52 @@ Tensor max_pool2d(
     float output_min = -std::numeric_limits<float>::infinity(),
     float output_max = +std::numeric_limits<float>::infinity());
 
+//
+// Average Pooling
+//
+
+bool use_avg_pool2d(
+    const Tensor& input,
+    IntArrayRef kernel,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override);
+
+Tensor avg_pool2d(
+    const Tensor& input,
+    IntArrayRef kernel,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode);
+
+bool use_global_average_pool(const Tensor& input);
+
+Tensor global_average_pool(const Tensor& input);
+
+//
+// Activations
+//
+
+bool use_hardswish(const Tensor& input);
+
+Tensor hardswish(const Tensor& input);
+
+Tensor& hardswish_(Tensor& input);
+
+bool use_sigmoid(const Tensor& input);
+
+Tensor sigmoid(const Tensor& input);
+
+//
+// Add
+//
+
+bool use_add(const Tensor& self, const Tensor& other, Scalar alpha);
+
+Tensor add(const Tensor& self, const Tensor& other);
+
 } // namespace xnnpack
 } // namespace native
 } // namespace at
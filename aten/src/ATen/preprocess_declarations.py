@@ -28,7 +28,8 @@ type_map = {
 all_types = type_map['floating_point'] + type_map['integral'] + type_map['quantized']
 type_map['all'] = all_types
 
-all_backends = ['CPU', 'CUDA', 'SparseCPU', 'SparseCUDA', 'MkldnnCPU', 'QuantizedCPU', 'QuantizedCUDA', 'Vulkan']
+all_backends = ['CPU', 'CUDA', 'SparseCPU', 'SparseCUDA', 'SparseCsrCPU', 'SparseCsrCUDA', 'MkldnnCPU',
+                'QuantizedCPU', 'QuantizedCUDA', 'Vulkan']
 default_backends = ['CPU', 'CUDA']
 
 
@@ -1,5 +1,6 @@
 #include <ATen/record_function.h>
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <random>
 
@@ -19,8 +20,17 @@ RecordFunctionHandle next_unique_record_function_handle() {
 }
 
 // Thread local vector of callbacks, holds pairs (callbacks, unique_id);
-// must be sorted in increasing handles order
-thread_local RecordFunctionCallbacks sorted_tls_callbacks_;
+// must be sorted in increasing handles order. The vector is never modified
+// once set, adding or removing a callback makes a new one, so that
+// ThreadLocalState propagates the callbacks across threads by pointer;
+// nullptr when there are no callbacks
+thread_local std::shared_ptr<const RecordFunctionCallbacks>
+    sorted_tls_callbacks_;
+
+const RecordFunctionCallbacks& tlsCallbacks() {
+  static const RecordFunctionCallbacks no_callbacks;
+  return sorted_tls_callbacks_ ? *sorted_tls_callbacks_ : no_callbacks;
+}
 
 std::atomic<int64_t> defaultNodeId(-1);
 
@@ -30,7 +40,9 @@ class CallbackManager {
     // note: monotonically increasing callbacks_unique_id keeps
     // sorted_tls_callbacks_ sorted
     auto handle = next_unique_callback_handle();
-    sorted_tls_callbacks_.emplace_back(std::move(cb), handle);
+    auto callbacks = std::make_shared<RecordFunctionCallbacks>(tlsCallbacks());
+    callbacks->emplace_back(std::move(cb), handle);
+    sorted_tls_callbacks_ = std::move(callbacks);
     return handle;
   }
 
@@ -57,7 +69,18 @@ class CallbackManager {
       }
       return false;
     };
-    auto found = find_and_remove(sorted_tls_callbacks_);
+    bool found = false;
+    if (sorted_tls_callbacks_) {
+      auto callbacks =
+          std::make_shared<RecordFunctionCallbacks>(*sorted_tls_callbacks_);
+      found = find_and_remove(*callbacks);
+      if (found) {
+        sorted_tls_callbacks_ = callbacks->empty()
+            ? nullptr
+            : std::shared_ptr<const RecordFunctionCallbacks>(
+                  std::move(callbacks));
+      }
+    }
     if (!found) {
       found = find_and_remove(sorted_global_callbacks_);
     }
@@ -71,7 +94,7 @@ class CallbackManager {
   }
 
   void clearThreadLocalCallbacks() {
-    sorted_tls_callbacks_.clear();
+    sorted_tls_callbacks_ = nullptr;
   }
 
   inline bool hasGlobalCallbacks() const {
@@ -79,7 +102,7 @@ class CallbackManager {
   }
 
   inline bool hasThreadLocalCallbacks() const {
-    return !sorted_tls_callbacks_.empty();
+    return sorted_tls_callbacks_ != nullptr;
   }
 
   // init is called by RecordFunction in constructor to
@@ -92,7 +115,7 @@ class CallbackManager {
     bool found_needs_ids = false;
     auto init_handles = [
         scope, &found_active_cb, &found_needs_inputs, &found_needs_ids](
-          CallbackHandles& handles, RecordFunctionCallbacks& cbs) {
+          CallbackHandles& handles, const RecordFunctionCallbacks& cbs) {
       handles.clear();
       for (const auto& cb : cbs) {
         if (cb.first.shouldRun(scope)) {
@@ -108,7 +131,7 @@ class CallbackManager {
       }
     };
 
-    init_handles(rec_fn.sorted_active_tls_handles_, sorted_tls_callbacks_);
+    init_handles(rec_fn.sorted_active_tls_handles_, tlsCallbacks());
     init_handles(rec_fn.sorted_active_global_handles_, sorted_global_callbacks_);
     rec_fn.active = found_active_cb;
     rec_fn.needs_inputs = found_needs_inputs;
@@ -124,7 +147,7 @@ class CallbackManager {
         /* is_start */ true,
         rf);
     mergeRunCallbacks(
-        sorted_tls_callbacks_,
+        tlsCallbacks(),
         rf.sorted_active_tls_handles_,
         /* is_start */ true,
         rf);
@@ -138,7 +161,7 @@ class CallbackManager {
         /* is_start */ false,
         rf);
     mergeRunCallbacks(
-        sorted_tls_callbacks_,
+        tlsCallbacks(),
         rf.sorted_active_tls_handles_,
         /* is_start */ false,
         rf);
@@ -216,18 +239,48 @@ thread_local bool tls_record_function_enabled_ = true;
 const double kLowProb = 0.001;
 thread_local int tries_left_ = 0;
 
+// Sampling runs on every RecordFunction with sampled callbacks, so it uses
+// a thread local xorshift64* generator rather than a std::mt19937 and a
+// distribution object: a coin flip costs a few arithmetic operations.
+struct FastRNG {
+  FastRNG() {
+    std::random_device rd;
+    state_ = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    if (state_ == 0) {
+      state_ = 0x9E3779B97F4A7C15ULL;
+    }
+  }
+
+  inline uint64_t next() {
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return state_ * 0x2545F4914F6CDD1DULL;
+  }
+
+  // Uniform in [0, 1)
+  inline double nextDouble() {
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+ private:
+  uint64_t state_;
+};
+
+inline FastRNG& rng() {
+  static thread_local FastRNG gen;
+  return gen;
+}
+
 int sample_geometric() {
-  static thread_local auto gen =
-      std::make_unique<std::mt19937>(std::random_device()());
-  std::geometric_distribution<int> dist(kLowProb);
-  return dist(*gen);
+  // Number of failures before the first success, by inversion;
+  // 1 - u is in (0, 1]
+  return static_cast<int>(
+      std::floor(std::log(1.0 - rng().nextDouble()) / std::log1p(-kLowProb)));
 }
 
-double sample_zero_one() {
-  static thread_local auto gen =
-      std::make_unique<std::mt19937>(std::random_device()());
-  std::uniform_real_distribution<double> dist(0.0, 1.0);
-  return dist(*gen);
+inline double sample_zero_one() {
+  return rng().nextDouble();
 }
 
 } // namespace
@@ -264,20 +317,16 @@ bool RecordFunctionCallback::shouldRun(RecordScope scope) const {
   return true;
 }
 
-RecordFunctionCallbacks _getTLSCallbacks() {
+std::shared_ptr<const RecordFunctionCallbacks> _getTLSCallbacks() {
   return sorted_tls_callbacks_;
 }
 
-void _setTLSCallbacks(const RecordFunctionCallbacks& callbacks) {
-  // keep the original handles
-  sorted_tls_callbacks_ = callbacks;
-  std::sort(
-      sorted_tls_callbacks_.begin(),
-      sorted_tls_callbacks_.end(),
-      [](const std::pair<RecordFunctionCallback, CallbackHandle>& l,
-          const std::pair<RecordFunctionCallback, CallbackHandle>& r) {
-        return l.second < r.second;
-  });
+void _setTLSCallbacks(
+    const std::shared_ptr<const RecordFunctionCallbacks>& callbacks) {
+  // keeps the original handles, and the order they are sorted in
+  if (sorted_tls_callbacks_ != callbacks) {
+    sorted_tls_callbacks_ = callbacks;
+  }
 }
 
 bool hasCallbacks() {
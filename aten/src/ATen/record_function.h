@@ -239,7 +239,7 @@ class TORCH_API RecordFunctionCallback {
   }
 
   RecordFunctionCallback& samplingProb(double sampling_prob) {
-    TORCH_CHECK(sampling_prob >= 0.0 && sampling_prob_ <= 1.0,
+    TORCH_CHECK(sampling_prob >= 0.0 && sampling_prob <= 1.0,
         "Invalid sampling probability");
     sampling_prob_ = sampling_prob;
     return *this;
@@ -440,8 +440,11 @@ class TORCH_API DisableRecordFunctionGuard : public RecordFunctionGuard {
   virtual ~DisableRecordFunctionGuard() {}
 };
 
-// Internal, used in ThreadLocalState to propagate TLS callbacks across threads
-TORCH_API RecordFunctionCallbacks _getTLSCallbacks();
-TORCH_API void _setTLSCallbacks(const RecordFunctionCallbacks& callbacks);
+// Internal, used in ThreadLocalState to propagate TLS callbacks across threads.
+// The callbacks are immutable and shared between the threads; nullptr when
+// there are none
+TORCH_API std::shared_ptr<const RecordFunctionCallbacks> _getTLSCallbacks();
+TORCH_API void _setTLSCallbacks(
+    const std::shared_ptr<const RecordFunctionCallbacks>& callbacks);
 
 } // namespace at
@@ -114,6 +114,48 @@ TEST(TestStream, MultithreadGetAndSetTest) {
   ASSERT_NE_CUDA(s0, s1);
 }
 
+// Ensures each thread keeps its own per-thread stream
+TEST(TestStream, PerThreadStreamTest) {
+  if (!at::cuda::is_available()) return;
+  const auto per_thread_fun =
+      [](at::optional<at::cuda::CUDAStream>& cur_thread_stream) {
+        cur_thread_stream = {at::cuda::getPerThreadCUDAStream()};
+        ASSERT_EQ_CUDA(*cur_thread_stream, at::cuda::getPerThreadCUDAStream());
+      };
+  at::optional<at::cuda::CUDAStream> s0, s1;
+
+  std::thread t0{per_thread_fun, std::ref(s0)};
+  t0.join();
+  std::thread t1{per_thread_fun, std::ref(s1)};
+  t1.join();
+
+  ASSERT_NE_CUDA(*s0, at::cuda::getDefaultCUDAStream());
+  ASSERT_NE_CUDA(s0, s1);
+}
+
+// Ensures threads with the same affinity share their per-thread stream
+TEST(TestStream, StreamAffinityTest) {
+  if (!at::cuda::is_available()) return;
+  const auto affinity_fun =
+      [](size_t index, at::optional<at::cuda::CUDAStream>& cur_thread_stream) {
+        at::cuda::setStreamAffinity(index);
+        cur_thread_stream = {at::cuda::getCurrentCUDAStream()};
+        ASSERT_EQ_CUDA(*cur_thread_stream, at::cuda::getPerThreadCUDAStream());
+      };
+  at::optional<at::cuda::CUDAStream> s0, s1, s2;
+
+  std::thread t0{affinity_fun, 0, std::ref(s0)};
+  std::thread t1{affinity_fun, 0, std::ref(s1)};
+  std::thread t2{affinity_fun, 1, std::ref(s2)};
+  t0.join();
+  t1.join();
+  t2.join();
+
+  ASSERT_EQ_CUDA(s0, s1);
+  ASSERT_NE_CUDA(s0, s2);
+  ASSERT_NE_CUDA(*s0, at::cuda::getDefaultCUDAStream());
+}
+
 // CUDA Guard
 TEST(TestStream, CUDAGuardTest) {
   if (!at::cuda::is_available()) return;
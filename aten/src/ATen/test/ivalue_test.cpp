@@ -60,6 +60,32 @@ TEST(IValueTest, Tuple) {
       std::get<1>(t_).item().to<float>(), std::get<1>(t).item().to<float>());
 }
 
+TEST(IValueTest, InlineTuple) {
+  auto small = c10::ivalue::Tuple::create(IValue(1), IValue("two"));
+  auto large = c10::ivalue::Tuple::create(
+      std::vector<IValue>{IValue(1), IValue(2), IValue(3), IValue(4)});
+  ASSERT_EQ(small->size(), 2);
+  ASSERT_EQ(small->elements()[1].toStringRef(), "two");
+  ASSERT_EQ(large->size(), 4);
+  ASSERT_EQ(large->elements().back().toInt(), 4);
+  ASSERT_EQ(
+      *small,
+      *c10::ivalue::Tuple::create(std::vector<IValue>{IValue(1), IValue("two")}));
+
+  c10::ivalue::TupleElements copied = small->elements();
+  c10::ivalue::TupleElements moved = std::move(copied);
+  ASSERT_EQ(moved.size(), 2);
+  ASSERT_EQ(moved[0].toInt(), 1);
+  moved = large->elements();
+  ASSERT_EQ(moved.size(), 4);
+
+  std::vector<IValue> elements = small->elements().vec();
+  ASSERT_EQ(elements.size(), 2);
+  small->setElements(std::vector<IValue>{IValue(5)});
+  ASSERT_EQ(small->size(), 1);
+  ASSERT_EQ(small->elements()[0].toInt(), 5);
+}
+
 TEST(IValueTest, unsafeRemoveAttr) {
   auto cu = std::make_shared<CompilationUnit>();
   auto cls = ClassType::create("foo.bar", cu);
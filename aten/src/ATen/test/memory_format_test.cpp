@@ -190,3 +190,29 @@ TEST(MemoryFormatTest, SliceFirstMemoryFormat) {
   // sliceFirst(t, 2, MemoryFormat::ChannelsLast);
   sliceFirst(t, 2, MemoryFormat::Contiguous);
 }
+
+TEST(MemoryFormatTest, ViewMemoryFormat) {
+  for (auto size : sizes) {
+    for (auto memory_format : {at::MemoryFormat::ChannelsLast, at::MemoryFormat::Contiguous}) {
+      Tensor t = at::rand(size).contiguous(memory_format);
+      // alias keeps the sizes and strides, and so all of the flags
+      Tensor alias = t.view(size);
+      EXPECT_TRUE(alias.suggest_memory_format() == t.suggest_memory_format());
+      EXPECT_EQ(alias.is_contiguous(), t.is_contiguous());
+      EXPECT_EQ(
+          alias.is_contiguous(at::MemoryFormat::ChannelsLast),
+          t.is_contiguous(at::MemoryFormat::ChannelsLast));
+      EXPECT_EQ(alias.is_non_overlapping_and_dense(), t.is_non_overlapping_and_dense());
+    }
+  }
+
+  Tensor t = at::rand({2, 3, 4, 5}).contiguous(at::MemoryFormat::ChannelsLast);
+  // a channels last tensor viewed as 5-d or 3-d tensors
+  Tensor v = t.view({2, 3, 4, 5, 1});
+  EXPECT_FALSE(v.is_contiguous());
+  EXPECT_TRUE(v.is_non_overlapping_and_dense());
+  v = at::rand({2, 3, 4, 5}).view({6, 4, 5});
+  EXPECT_TRUE(v.is_contiguous());
+  EXPECT_TRUE(v.is_non_overlapping_and_dense());
+  EXPECT_EQ(v.view({2, 3, 4, 5}).suggest_memory_format(), at::MemoryFormat::Contiguous);
+}
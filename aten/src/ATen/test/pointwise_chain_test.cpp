@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <ATen/ATen.h>
+#include <ATen/native/PointwiseChain.h>
+
+using namespace at;
+using at::native::PointwiseChain;
+
+TEST(PointwiseChainTest, MatchesEager) {
+  for (auto dtype : {kFloat, kDouble}) {
+    auto a = at::randn({37, 129}, dtype);
+    auto b = at::randn({37, 129}, dtype);
+    auto c = at::randn({129}, dtype);
+    auto expected = a.mul(b).add_(c).relu_();
+    auto result = PointwiseChain(a).mul(b).add(c).relu().run();
+    ASSERT_TRUE(result.allclose(expected));
+  }
+}
+
+TEST(PointwiseChainTest, StridedInputs) {
+  auto a = at::randn({300, 40}).t();
+  auto b = at::randn({40, 1});
+  auto expected = at::tanh(at::sigmoid(a.sub(b, 0.5).div(b).mul(3).add(1)));
+  auto result =
+      PointwiseChain(a).sub(b, 0.5).div(b).mul(3).add(1).sigmoid().tanh().run();
+  ASSERT_EQ(result.sizes(), expected.sizes());
+  ASSERT_TRUE(result.allclose(expected));
+}
+
+TEST(PointwiseChainTest, FallsBackForUnsupportedInputs) {
+  // integer tensors and mixed dtypes run op by op
+  auto a = at::randint(-5, 5, {10}, kLong);
+  auto b = at::randint(-5, 5, {10}, kLong);
+  ASSERT_TRUE(PointwiseChain(a).mul(b).relu().run().equal(a.mul(b).relu()));
+
+  auto f = at::randn({10});
+  auto d = at::randn({10}, kDouble);
+  auto result = PointwiseChain(f).add(d).run();
+  ASSERT_EQ(result.scalar_type(), kDouble);
+  ASSERT_TRUE(result.allclose(f.add(d)));
+}
+
+TEST(PointwiseChainTest, EmptyChainCopies) {
+  auto a = at::randn({4});
+  auto result = PointwiseChain(a).run();
+  ASSERT_TRUE(result.equal(a));
+  ASSERT_NE(result.data_ptr(), a.data_ptr());
+}
@@ -210,3 +210,110 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   config.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(config.build());
 }
+
+TEST(TensorIteratorTest, PlanCacheReusesPlan) {
+  TensorIteratorPlanCache::set_enabled(true);
+  TensorIteratorPlanCache::clear();
+  TensorIteratorPlanCache::reset_stats();
+  // Transposed and broadcast inputs take the slow setup path
+  auto a = at::randn({4, 3}).t();
+  auto b = at::randn({3, 1});
+  Tensor out1, out2;
+  auto iter1 = TensorIterator::binary_op(out1, a, b);
+  auto iter2 = TensorIterator::binary_op(out2, a, b);
+  auto stats = TensorIteratorPlanCache::get_stats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.hits, 1);
+
+  EXPECT_EQ(iter1.shape(), iter2.shape());
+  for (int i = 0; i < iter1.ntensors(); i++) {
+    EXPECT_EQ(iter1.strides(i), iter2.strides(i));
+    EXPECT_EQ(iter1.dtype(i), iter2.dtype(i));
+  }
+  EXPECT_EQ(iter1.output().sizes(), iter2.output().sizes());
+  EXPECT_EQ(iter1.output().strides(), iter2.output().strides());
+  EXPECT_NE(iter1.data_ptr(0), iter2.data_ptr(0));
+
+  // Different strides need a different plan
+  Tensor out3;
+  TensorIterator::binary_op(out3, a.contiguous(), b);
+  EXPECT_EQ(TensorIteratorPlanCache::get_stats().misses, 2);
+  TensorIteratorPlanCache::set_enabled(false);
+}
+
+TEST(TensorIteratorTest, PlanCacheSkipsPromotion) {
+  TensorIteratorPlanCache::set_enabled(true);
+  TensorIteratorPlanCache::reset_stats();
+  // The CPU inputs are promoted through temporaries, which are not cached
+  auto a = at::ones({2, 2}, at::dtype(at::kFloat));
+  auto b = at::ones({2, 2}, at::dtype(at::kDouble));
+  for (int i = 0; i < 2; i++) {
+    Tensor out;
+    auto iter = at::TensorIteratorConfig()
+        .add_output(out)
+        .add_input(a)
+        .add_input(b)
+        .promote_inputs_to_common_dtype(true)
+        .build();
+    EXPECT_EQ(iter.dtype(1), at::kDouble);
+  }
+  auto stats = TensorIteratorPlanCache::get_stats();
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.uncacheable, 2);
+  TensorIteratorPlanCache::set_enabled(false);
+}
+
+TEST(TensorIteratorTest, PlanCacheCachesBufferedCasts) {
+  TensorIteratorPlanCache::set_enabled(true);
+  TensorIteratorPlanCache::clear();
+  TensorIteratorPlanCache::reset_stats();
+  // binary_op converts in the loops instead of through temporaries
+  auto a = at::ones({2, 2}, at::dtype(at::kFloat));
+  auto b = at::ones({2, 2}, at::dtype(at::kDouble));
+  for (int i = 0; i < 2; i++) {
+    Tensor out;
+    auto iter = TensorIterator::binary_op(out, a, b);
+    EXPECT_EQ(iter.dtype(1), at::kDouble);
+    EXPECT_EQ(iter.tensor(1).scalar_type(), at::kFloat);
+  }
+  auto stats = TensorIteratorPlanCache::get_stats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.hits, 1);
+  TensorIteratorPlanCache::set_enabled(false);
+}
+
+TEST(TensorIteratorTest, BufferedCasts) {
+  // Longer than a chunk, with transposed, broadcast and scalar operands
+  auto a = at::randn({700, 3}, at::dtype(at::kDouble)).t();
+  auto b = at::randint(-100, 100, {3, 700}, at::dtype(at::kInt));
+  auto c = at::randint(-100, 100, {700}, at::dtype(at::kLong));
+  auto expected = a.to(at::kDouble) + b.to(at::kDouble);
+  EXPECT_TRUE(at::add(a, b).equal(expected));
+  EXPECT_TRUE(at::add(b, a).equal(expected));
+  EXPECT_TRUE(at::mul(b, c).equal(b.to(at::kLong) * c));
+  EXPECT_TRUE(at::add(b, at::scalar_tensor(2.5)).equal(b.to(at::kFloat) + 2.5));
+  EXPECT_TRUE(at::lt(b, a).equal(b.to(at::kDouble) < a));
+
+  // Outputs in another dtype than the common one, also in place
+  auto out = at::empty({3, 700}, at::dtype(at::kFloat));
+  at::add_out(out, a, b);
+  EXPECT_TRUE(out.equal(expected.to(at::kFloat)));
+  auto d = at::randn({3, 700}, at::dtype(at::kFloat));
+  auto d_expected = (d.to(at::kDouble) + a).to(at::kFloat);
+  d.add_(a);
+  EXPECT_TRUE(d.equal(d_expected));
+}
+
+TEST(TensorIteratorTest, PlanCacheMatchesUncachedResults) {
+  auto a = at::randn({2, 3, 4}).permute({2, 0, 1});
+  auto b = at::randn({2, 1});
+  auto expected = at::add(a, b);
+  TensorIteratorPlanCache::set_enabled(true);
+  for (int i = 0; i < 3; i++) {
+    auto result = at::add(a, b);
+    EXPECT_TRUE(result.equal(expected));
+    EXPECT_EQ(result.strides(), expected.strides());
+  }
+  TensorIteratorPlanCache::set_enabled(false);
+  EXPECT_GT(TensorIteratorPlanCache::get_stats().hits, 0);
+}
@@ -4,9 +4,13 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <string.h>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace at;
 
@@ -36,6 +40,54 @@ TEST(TestParallel, NestedParallel) {
   });
 }
 
+TEST(TestParallel, UnevenWorkCoversRangeOnce) {
+  // Ranges may be split and rebalanced between threads (e.g. by the work
+  // stealing backend), but every index must still be visited exactly once.
+  const int64_t size = 10000;
+  std::vector<std::atomic<int>> visits(size);
+  for (auto& v : visits) {
+    v = 0;
+  }
+  at::parallel_for(0, size, 16, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      visits[i]++;
+      if (i < size / 10) {
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+      }
+    }
+  });
+  for (int64_t i = 0; i < size; ++i) {
+    ASSERT_EQ(visits[i], 1);
+  }
+}
+
+TEST(TestParallel, NestedParallelForCoversRangeOnce) {
+  // Inner loops either run serially or recruit idle workers, depending on
+  // the backend, but must visit every index once and leave the outer
+  // task's state alone.
+  const int64_t outer = 8;
+  const int64_t inner = 1000;
+  std::vector<std::atomic<int>> visits(outer * inner);
+  for (auto& v : visits) {
+    v = 0;
+  }
+  at::parallel_for(0, outer, 1, [&](int64_t begin, int64_t end) {
+    const int thread_num = at::get_thread_num();
+    for (int64_t i = begin; i < end; ++i) {
+      at::parallel_for(0, inner, 10, [&](int64_t b, int64_t e) {
+        for (int64_t j = b; j < e; ++j) {
+          visits[i * inner + j]++;
+        }
+      });
+      ASSERT_TRUE(at::in_parallel_region());
+      ASSERT_EQ(at::get_thread_num(), thread_num);
+    }
+  });
+  for (auto& v : visits) {
+    ASSERT_EQ(v, 1);
+  }
+}
+
 TEST(TestParallel, Exceptions) {
   // parallel case
   ASSERT_THROW(
@@ -664,6 +664,18 @@ TEST(Vec256TestFloat, check_fmadd) {
   ASSERT_TRUE(check_almost_equal(ref_res, vec_res, 1e-6));
 }
 
+TEST(Vec256TestFloat, check_isnan) {
+  __at_align32__ float values[Vec256<float>::size()];
+  for (int64_t i = 0; i < Vec256<float>::size(); i++) {
+    values[i] = (i % 3 == 0) ? NAN : static_cast<float>(i);
+  }
+  int mask = Vec256<float>::loadu(values).isnan().zero_mask();
+  for (int64_t i = 0; i < Vec256<float>::size(); i++) {
+    // zero_mask has the bits set for the lanes that are not NaN
+    ASSERT_EQ((mask >> i) & 1, (i % 3 == 0) ? 0 : 1);
+  }
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   at::manual_seed(42);
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+
+#include <ATen/cpu/vec512/vec512.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+// This file is compiled with the flags of the AVX512 kernels (see
+// caffe2/CMakeLists.txt), so it does not touch tensors: every test only runs
+// Vec512 code on plain arrays, after checking that the CPU has AVX512.
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+using namespace at::vec512;
+
+namespace {
+
+bool has_avx512() {
+  return at::native::get_cpu_capability() >= at::native::CPUCapability::AVX512;
+}
+
+template <typename T>
+class Vec512Test : public ::testing::Test {
+ protected:
+  using Vec = Vectorized<T>;
+  static constexpr int kSize = Vec::size();
+
+  void SetUp() override {
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<T> dist(-10, 10);
+    for (int i = 0; i < kSize; ++i) {
+      a[i] = dist(gen);
+      b[i] = dist(gen);
+      // Make some lanes equal so that the comparisons see both outcomes.
+      if (i % 3 == 0) {
+        b[i] = a[i];
+      }
+      c[i] = dist(gen);
+    }
+  }
+
+  // Compares lane by lane, including the bit pattern of the all ones lanes
+  // produced by the comparison operators.
+  void check_equal(const Vec& vec, const T* expected) {
+    __at_align64__ T res[kSize];
+    vec.store(res);
+    for (int i = 0; i < kSize; ++i) {
+      ASSERT_EQ(std::memcmp(&res[i], &expected[i], sizeof(T)), 0)
+          << "lane " << i << ": " << res[i] << " vs " << expected[i];
+    }
+  }
+
+  static T all_ones() {
+    T ones;
+    std::memset(&ones, 0xFF, sizeof(T));
+    return ones;
+  }
+
+  // gtest allocates the fixture with new, which does not honor over-aligned
+  // members before C++17, so these are only ever read with loadu.
+  T a[kSize];
+  T b[kSize];
+  T c[kSize];
+};
+
+using Vec512Types = ::testing::Types<float, double>;
+TYPED_TEST_CASE(Vec512Test, Vec512Types);
+
+} // namespace
+
+TYPED_TEST(Vec512Test, Size) {
+  using T = TypeParam;
+  ASSERT_EQ(Vectorized<T>::size() * sizeof(T), 64);
+}
+
+// Checks both loads and stores, full and partial.
+TYPED_TEST(Vec512Test, LoadStore) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int kSize = Vec::size();
+  if (!has_avx512()) {
+    return;
+  }
+  this->check_equal(Vec::loadu(this->a), this->a);
+
+  for (int count = 0; count <= kSize; ++count) {
+    // Partial loads zero the tail.
+    __at_align64__ T expected[kSize];
+    for (int i = 0; i < kSize; ++i) {
+      expected[i] = i < count ? this->a[i] : T(0);
+    }
+    this->check_equal(Vec::loadu(this->a, count), expected);
+
+    // Partial stores leave the tail alone.
+    __at_align64__ T out[kSize];
+    std::memcpy(out, this->b, sizeof(out));
+    Vec::loadu(this->a).store(out, count);
+    for (int i = 0; i < kSize; ++i) {
+      ASSERT_EQ(out[i], i < count ? this->a[i] : this->b[i]);
+    }
+  }
+}
+
+TYPED_TEST(Vec512Test, Arange) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int kSize = Vec::size();
+  if (!has_avx512()) {
+    return;
+  }
+  __at_align64__ T expected[kSize];
+  for (int i = 0; i < kSize; ++i) {
+    expected[i] = T(7) + i * T(5);
+  }
+  this->check_equal(Vec::arange(T(7), T(5)), expected);
+}
+
+TYPED_TEST(Vec512Test, Arithmetic) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int kSize = Vec::size();
+  if (!has_avx512()) {
+    return;
+  }
+  const auto a = Vec::loadu(this->a);
+  const auto b = Vec::loadu(this->b);
+  const auto c = Vec::loadu(this->c);
+  __at_align64__ T expected[kSize];
+
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] + this->b[i];
+  this->check_equal(a + b, expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] - this->b[i];
+  this->check_equal(a - b, expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] * this->b[i];
+  this->check_equal(a * b, expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] / this->b[i];
+  this->check_equal(a / b, expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = std::fma(this->a[i], this->b[i], this->c[i]);
+  this->check_equal(fmadd(a, b, c), expected);
+
+  for (int i = 0; i < kSize; ++i) expected[i] = std::max(this->a[i], this->b[i]);
+  this->check_equal(maximum(a, b), expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = std::min(this->a[i], this->b[i]);
+  this->check_equal(minimum(a, b), expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = std::min(std::max(this->a[i], T(-1)), T(1));
+  this->check_equal(clamp(a, Vec(-1), Vec(1)), expected);
+
+  for (int i = 0; i < kSize; ++i) expected[i] = std::abs(this->a[i]);
+  this->check_equal(a.abs(), expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = -this->a[i];
+  this->check_equal(a.neg(), expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = std::trunc(this->a[i]);
+  this->check_equal(a.trunc(), expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = std::floor(this->a[i]);
+  this->check_equal(a.floor(), expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = std::ceil(this->a[i]);
+  this->check_equal(a.ceil(), expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = std::sqrt(std::abs(this->a[i]));
+  this->check_equal(a.abs().sqrt(), expected);
+
+  auto acc = a;
+  acc += b;
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] + this->b[i];
+  this->check_equal(acc, expected);
+}
+
+TYPED_TEST(Vec512Test, Compare) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int kSize = Vec::size();
+  if (!has_avx512()) {
+    return;
+  }
+  const auto a = Vec::loadu(this->a);
+  const auto b = Vec::loadu(this->b);
+  const T ones = this->all_ones();
+  __at_align64__ T expected[kSize];
+
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] == this->b[i] ? ones : T(0);
+  this->check_equal(a == b, expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] != this->b[i] ? ones : T(0);
+  this->check_equal(a != b, expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] < this->b[i] ? ones : T(0);
+  this->check_equal(a < b, expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] <= this->b[i] ? ones : T(0);
+  this->check_equal(a <= b, expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] > this->b[i] ? ones : T(0);
+  this->check_equal(a > b, expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] >= this->b[i] ? ones : T(0);
+  this->check_equal(a >= b, expected);
+
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] == this->b[i] ? T(1) : T(0);
+  this->check_equal(a.eq(b), expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] < this->b[i] ? T(1) : T(0);
+  this->check_equal(a.lt(b), expected);
+  for (int i = 0; i < kSize; ++i) expected[i] = this->a[i] >= this->b[i] ? T(1) : T(0);
+  this->check_equal(a.ge(b), expected);
+}
+
+// Checks blendv, set and the bitwise ops on comparison masks.
+TYPED_TEST(Vec512Test, BlendAndMask) {
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  constexpr int kSize = Vec::size();
+  if (!has_avx512()) {
+    return;
+  }
+  const auto a = Vec::loadu(this->a);
+  const auto b = Vec::loadu(this->b);
+  const auto mask = a < b;
+  __at_align64__ T expected[kSize];
+
+  for (int i = 0; i < kSize; ++i) {
+    expected[i] = this->a[i] < this->b[i] ? this->b[i] : this->a[i];
+  }
+  this->check_equal(Vec::blendv(a, b, mask), expected);
+
+  for (int count = 0; count <= kSize; ++count) {
+    for (int i = 0; i < kSize; ++i) {
+      expected[i] = i < count ? this->b[i] : this->a[i];
+    }
+    this->check_equal(Vec::set(a, b, count), expected);
+  }
+
+  // (a < b) & a keeps a where a < b and zeroes every other lane.
+  for (int i = 0; i < kSize; ++i) {
+    expected[i] = this->a[i] < this->b[i] ? this->a[i] : T(0);
+  }
+  this->check_equal(mask & a, expected);
+
+  // (a < b) | (a > b) is a != b.
+  const T ones = this->all_ones();
+  for (int i = 0; i < kSize; ++i) {
+    expected[i] = this->a[i] != this->b[i] ? ones : T(0);
+  }
+  this->check_equal((a < b) | (a > b), expected);
+
+  // x ^ x is 0.
+  for (int i = 0; i < kSize; ++i) {
+    expected[i] = T(0);
+  }
+  this->check_equal(mask ^ mask, expected);
+}
+
+#endif
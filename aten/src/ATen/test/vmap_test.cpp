@@ -850,4 +850,231 @@ TEST(VmapTest, TestBatchedTensorPermute) {
   }
 }
 
+TEST(VmapTest, TestMultiBatchVmapTransformTensorList) {
+  {
+    // Batch dims get moved to the front, aligned, and expanded
+    int64_t B0 = 5, B1 = 7;
+    Tensor x = at::randn({2, B0});
+    Tensor y = at::randn({B1, 3});
+    Tensor batched_x = makeBatched(x, {{/*lvl*/0, /*dim*/1}});
+    Tensor batched_y = makeBatched(y, {{/*lvl*/1, /*dim*/0}});
+
+    auto outputs = MultiBatchVmapTransform::logicalToPhysical({batched_x, batched_y});
+    ASSERT_EQ(outputs.size(), 2);
+    ASSERT_EQ(outputs[0].numBatchDims(), 2);
+    ASSERT_EQ(outputs[0].tensor().data_ptr(), x.data_ptr());
+    ASSERT_TRUE(at::allclose(outputs[0].tensor(), x.t().unsqueeze(1).expand({B0, B1, 2})));
+    ASSERT_EQ(outputs[1].tensor().data_ptr(), y.data_ptr());
+    ASSERT_TRUE(at::allclose(outputs[1].tensor(), y.expand({B0, B1, 3})));
+  }
+  {
+    // Regular Tensors get a batch dim for each level; the example dims
+    // are not padded.
+    int64_t B0 = 5;
+    Tensor x = at::randn({B0, 2, 3});
+    Tensor y = at::randn({3});
+    Tensor batched_x = makeBatched(x, {{/*lvl*/0, /*dim*/0}});
+
+    auto outputs = MultiBatchVmapTransform::logicalToPhysical({batched_x, y});
+    ASSERT_TRUE(outputs[0].tensor().is_same(x));
+    std::vector<int64_t> expected_size = {B0, 3};
+    ASSERT_EQ(outputs[1].tensor().sizes(), expected_size);
+    ASSERT_EQ(outputs[1].tensor().data_ptr(), y.data_ptr());
+    ASSERT_TRUE(at::allclose(outputs[1].tensor(), y.expand({B0, 3})));
+  }
+}
+
+TEST(VmapTest, TestBatchedTensorPointwise) {
+  {
+    // unary
+    Tensor x = at::randn({2, 3, 5});
+    Tensor batched = makeBatched(x, {{/*lvl*/0, /*dim*/1}});
+    const auto& out = maybeGetBatched(batched.exp())->value();
+    ASSERT_TRUE(at::allclose(out, x.exp().permute({1, 0, 2})));
+  }
+  {
+    // batched + unbatched, with alpha
+    Tensor x = at::randn({2, 3});
+    Tensor y = at::randn({3});
+    Tensor batched = makeBatched(x, {{/*lvl*/0, /*dim*/0}});
+    const auto& out = maybeGetBatched(at::add(batched, y, /*alpha*/2))->value();
+    ASSERT_TRUE(at::allclose(out, at::add(x, y, /*alpha*/2)));
+  }
+  {
+    // batched (level 0) / batched (level 1)
+    Tensor x = at::randn({2, 3});
+    Tensor y = at::rand({5, 3}) + 1;
+    Tensor batched_x = makeBatched(x, {{/*lvl*/0, /*dim*/0}});
+    Tensor batched_y = makeBatched(y, {{/*lvl*/1, /*dim*/0}});
+    const auto& out = maybeGetBatched(batched_x / batched_y)->value();
+    std::vector<int64_t> expected_size = {2, 5, 3};
+    ASSERT_EQ(out.sizes(), expected_size);
+    ASSERT_TRUE(at::allclose(out, x.unsqueeze(1) / y));
+  }
+}
+
+TEST(VmapTest, TestBatchedTensorReductions) {
+  {
+    // Reducing over all of the dims only reduces over the logical dims
+    Tensor x = at::randn({2, 3, 5});
+    Tensor batched = makeBatched(x, {{/*lvl*/0, /*dim*/1}});
+    const auto& sum = maybeGetBatched(batched.sum())->value();
+    ASSERT_TRUE(at::allclose(sum, x.sum(std::vector<int64_t>{0, 2})));
+    const auto& mean = maybeGetBatched(batched.mean())->value();
+    ASSERT_TRUE(at::allclose(mean, x.mean(std::vector<int64_t>{0, 2})));
+  }
+  {
+    // mean over some dims
+    Tensor x = at::randn({2, 3, 5, 7});
+    Tensor batched = makeBatched(x, {{/*lvl*/0, /*dim*/0}});
+    const auto& out = maybeGetBatched(batched.mean(-1, /*keepdim*/true))->value();
+    ASSERT_TRUE(at::allclose(out, x.mean(-1, /*keepdim*/true)));
+  }
+  {
+    // Edge case: logical scalars
+    Tensor x = at::randn({2});
+    Tensor batched = makeBatched(x, {{/*lvl*/0, /*dim*/0}});
+    ASSERT_TRUE(at::allclose(maybeGetBatched(batched.sum())->value(), x));
+    ASSERT_TRUE(at::allclose(maybeGetBatched(batched.sum(0))->value(), x));
+    const auto& out = maybeGetBatched(batched.mean(0, /*keepdim*/true))->value();
+    ASSERT_EQ(out.sizes(), x.sizes());
+    ASSERT_TRUE(at::allclose(out, x));
+  }
+}
+
+// Runs `op` on every example of the batched inputs, i.e. what vmap does
+// without batching rules.
+template <typename Op>
+static Tensor loopOverBatch(Op op, const Tensor& x, int64_t x_bdim, const Tensor& y, int64_t y_bdim) {
+  const auto batch_size = x_bdim >= 0 ? x.size(x_bdim) : y.size(y_bdim);
+  std::vector<Tensor> results;
+  for (int64_t idx = 0; idx < batch_size; idx++) {
+    results.push_back(op(
+        x_bdim >= 0 ? x.select(x_bdim, idx) : x,
+        y_bdim >= 0 ? y.select(y_bdim, idx) : y));
+  }
+  return at::stack(results);
+}
+
+TEST(VmapTest, TestBatchedTensorMatmul) {
+  const auto options = at::TensorOptions().dtype(kDouble);
+  const auto matmul = [](const Tensor& x, const Tensor& y) { return at::matmul(x, y); };
+  std::vector<std::vector<int64_t>> shapes = {{3}, {2, 3}, {4, 2, 3}};
+  // Every combination of 1, 2, and 3-D operands, with either or both batched.
+  for (const auto& x_shape : shapes) {
+    for (const auto& y_shape : shapes) {
+      std::vector<int64_t> y_logical_shape = y_shape;
+      if (y_logical_shape.size() == 1) {
+        y_logical_shape.back() = 3;
+      } else {
+        y_logical_shape.end()[-2] = 3;
+        y_logical_shape.back() = 5;
+      }
+      for (int64_t which = 0; which < 3; which++) {
+        const int64_t x_bdim = which != 1 ? 0 : -1;
+        const int64_t y_bdim = which != 0 ? y_logical_shape.size() : -1;
+        std::vector<int64_t> x_physical_shape = x_shape;
+        std::vector<int64_t> y_physical_shape = y_logical_shape;
+        if (x_bdim >= 0) {
+          x_physical_shape.insert(x_physical_shape.begin() + x_bdim, 7);
+        }
+        if (y_bdim >= 0) {
+          y_physical_shape.insert(y_physical_shape.begin() + y_bdim, 7);
+        }
+        Tensor x = at::randn(x_physical_shape, options);
+        Tensor y = at::randn(y_physical_shape, options);
+        Tensor batched_x = x_bdim >= 0 ? makeBatched(x, {{/*lvl*/0, x_bdim}}) : x;
+        Tensor batched_y = y_bdim >= 0 ? makeBatched(y, {{/*lvl*/0, y_bdim}}) : y;
+
+        const auto& out = maybeGetBatched(at::matmul(batched_x, batched_y))->value();
+        ASSERT_TRUE(at::allclose(out, loopOverBatch(matmul, x, x_bdim, y, y_bdim)));
+      }
+    }
+  }
+  {
+    // mm, mv, dot, and bmm
+    Tensor x = at::randn({7, 2, 3}, options);
+    Tensor y = at::randn({3, 5}, options);
+    Tensor v = at::randn({7, 3}, options);
+    Tensor batched_x = makeBatched(x, {{/*lvl*/0, /*dim*/0}});
+    Tensor batched_v = makeBatched(v, {{/*lvl*/0, /*dim*/0}});
+    ASSERT_TRUE(at::allclose(maybeGetBatched(batched_x.mm(y))->value(), x.matmul(y)));
+    ASSERT_TRUE(at::allclose(
+        maybeGetBatched(batched_x.mv(batched_v))->value(),
+        x.matmul(v.unsqueeze(-1)).squeeze(-1)));
+    ASSERT_TRUE(at::allclose(
+        maybeGetBatched(batched_v.dot(batched_v))->value(), (v * v).sum(-1)));
+    ASSERT_THROW(batched_x.mm(v), c10::Error);
+
+    Tensor b = at::randn({4, 7, 3, 5}, options);
+    Tensor batched_b = makeBatched(b, {{/*lvl*/0, /*dim*/1}});
+    Tensor mat = at::randn({4, 2, 3}, options);
+    ASSERT_TRUE(at::allclose(
+        maybeGetBatched(mat.bmm(batched_b))->value(),
+        mat.matmul(b.transpose(0, 1))));
+    ASSERT_THROW(mat.narrow(0, 0, 1).bmm(batched_b), c10::Error);
+  }
+}
+
+TEST(VmapTest, TestBatchedTensorConv2d) {
+  const auto options = at::TensorOptions().dtype(kDouble);
+  const auto conv = [](const Tensor& input, const Tensor& weight) {
+    return at::conv2d(input, weight, /*bias*/{}, /*stride*/1, /*padding*/1, /*dilation*/1, /*groups*/2);
+  };
+  Tensor input = at::randn({5, 3, 4, 6, 6}, options);
+  Tensor weight = at::randn({5, 6, 2, 3, 3}, options);
+  Tensor bias = at::randn({5, 6}, options);
+  Tensor batched_input = makeBatched(input, {{/*lvl*/0, /*dim*/0}});
+  Tensor batched_weight = makeBatched(weight, {{/*lvl*/0, /*dim*/0}});
+  Tensor batched_bias = makeBatched(bias, {{/*lvl*/0, /*dim*/0}});
+  {
+    // batched input, shared weight
+    const auto& out = maybeGetBatched(conv(batched_input, weight[0]))->value();
+    ASSERT_TRUE(at::allclose(out, loopOverBatch(conv, input, 0, weight[0], -1)));
+  }
+  {
+    // per-example weights
+    const auto& out = maybeGetBatched(conv(input[0], batched_weight))->value();
+    ASSERT_TRUE(at::allclose(out, loopOverBatch(conv, input[0], -1, weight, 0)));
+    const auto& both = maybeGetBatched(conv(batched_input, batched_weight))->value();
+    ASSERT_TRUE(at::allclose(both, loopOverBatch(conv, input, 0, weight, 0)));
+  }
+  {
+    // bias, batched or not
+    const auto& out = maybeGetBatched(at::conv2d(
+        batched_input, batched_weight, bias[0], 1, 1, 1, 2))->value();
+    ASSERT_TRUE(at::allclose(
+        out, loopOverBatch(conv, input, 0, weight, 0) + bias[0].view({6, 1, 1})));
+    const auto& batched_out = maybeGetBatched(at::conv2d(
+        batched_input, weight[0], batched_bias, 1, 1, 1, 2))->value();
+    ASSERT_TRUE(at::allclose(
+        batched_out,
+        loopOverBatch(conv, input, 0, weight[0], -1) + bias.view({5, 1, 6, 1, 1})));
+  }
+}
+
+TEST(VmapTest, TestBatchedTensorEmbedding) {
+  const auto embedding = [](const Tensor& weight, const Tensor& indices) {
+    return at::embedding(weight, indices);
+  };
+  Tensor weight = at::randn({5, 10, 3});
+  Tensor indices = at::randint(10, {5, 2, 4}, at::TensorOptions().dtype(kLong));
+  Tensor batched_weight = makeBatched(weight, {{/*lvl*/0, /*dim*/0}});
+  Tensor batched_indices = makeBatched(indices, {{/*lvl*/0, /*dim*/0}});
+  {
+    // batched indices, shared weight
+    const auto& out = maybeGetBatched(embedding(weight[0], batched_indices))->value();
+    ASSERT_TRUE(at::allclose(out, loopOverBatch(embedding, weight[0], -1, indices, 0)));
+  }
+  {
+    // per-example weights
+    const auto& out = maybeGetBatched(embedding(batched_weight, indices[0]))->value();
+    ASSERT_TRUE(at::allclose(out, loopOverBatch(embedding, weight, 0, indices[0], -1)));
+    const auto& both = maybeGetBatched(embedding(batched_weight, batched_indices))->value();
+    ASSERT_TRUE(at::allclose(both, loopOverBatch(embedding, weight, 0, indices, 0)));
+    // Indices can't reach into the weight of another example.
+    ASSERT_THROW(embedding(batched_weight, indices[0] + 10), c10::Error);
+  }
+}
+
 } // namespace
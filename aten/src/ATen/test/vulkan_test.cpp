@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/core/dispatch/Dispatcher.h>
+#include <ATen/native/vulkan/VulkanCommon.h>
 #include <ATen/vulkan/Context.h>
 
 bool checkRtol(const at::Tensor& diff, const std::vector<at::Tensor> inputs) {
@@ -62,6 +63,46 @@ TEST(VulkanTest, add) {
   ASSERT_TRUE(almostEqual(t_out, t_out_expected));
 }
 
+TEST(VulkanTest, addChain) {
+  if (!at::vulkan::is_available())
+    return;
+  // More ops than the descriptor sets of a command batch, with intermediate
+  // results released before the batch is submitted. The sums are integers,
+  // which the half precision images represent exactly.
+  auto t_in = at::ones({1, 2, 2, 3}, at::device(at::kCPU).dtype(at::kFloat));
+  auto t_out_expected = t_in;
+  auto tv_in = t_in.vulkan();
+  auto tv_out = tv_in;
+  for (int i = 0; i < 300; ++i) {
+    t_out_expected = at::add(t_out_expected, t_in);
+    tv_out = at::add(tv_out, tv_in);
+  }
+  auto t_out = tv_out.cpu();
+
+  ASSERT_TRUE(exactlyEqual(t_out, t_out_expected));
+}
+
+TEST(VulkanTest, memoryReuse) {
+  if (!at::vulkan::is_available())
+    return;
+  auto t_in0 = at::rand({1, 4, 8, 8}, at::device(at::kCPU).dtype(at::kFloat));
+  auto t_in1 = at::rand({1, 4, 8, 8}, at::device(at::kCPU).dtype(at::kFloat));
+  auto run = [&]() {
+    auto tv_out = at::add(t_in0.vulkan(), t_in1.vulkan(), 2);
+    return tv_out.cpu();
+  };
+  run();
+  const auto stats0 = at::native::vulkan::memory_stats();
+  auto t_out = run();
+  const auto stats1 = at::native::vulkan::memory_stats();
+
+  ASSERT_TRUE(almostEqual(t_out, at::add(t_in0, t_in1, 2)));
+  // The second inference reuses the memory of the first one.
+  ASSERT_EQ(stats1.device_memory_allocations, stats0.device_memory_allocations);
+  ASSERT_EQ(stats1.allocations, stats0.allocations);
+  ASSERT_GT(stats1.num_reused, stats0.num_reused);
+}
+
 TEST(VulkanTest, conv2d) {
   if (!at::vulkan::is_available())
     return;
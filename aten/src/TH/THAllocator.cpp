@@ -497,6 +497,12 @@ int THRefcountedMapAllocator::decref()
   return --map_info->refcount == 0;
 }
 
+int THRefcountedMapAllocator::refcount() const
+{
+  THMapInfo *map_info = static_cast<THMapInfo*>(base_ptr_);
+  return map_info->refcount.load();
+}
+
 #else
 
 
@@ -90,6 +90,9 @@ class CAFFE2_API THRefcountedMapAllocator
 
   void incref();
   int decref();
+  // Number of handles which currently hold the shared memory segment, across
+  // all processes.
+  int refcount() const;
   void close() override;
 
   virtual ~THRefcountedMapAllocator() { close(); }
@@ -4,65 +4,124 @@
 
 
 #include <cuda_runtime_api.h>
+#include <algorithm>
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
-#include <set>
 #include <utility>
+#include <vector>
 
 namespace {
 
-struct BlockSize
+using Stat = THCCachingHostAllocatorStats::Stat;
+
+constexpr size_t kMinBlockSize = 512;  // all sizes are rounded to at least 512 bytes
+constexpr size_t kClassesPerPow2 = 4;  // size classes per power of two
+constexpr size_t kPreallocBlocks = 1;  // extra blocks allocated on a size class miss
+
+// Rounds size up to its size class. Classes below kMinBlockSize collapse to
+// kMinBlockSize; above it there are kClassesPerPow2 classes per power of two,
+// so at most 25% of a block is lost to rounding.
+size_t round_size(size_t size)
 {
-  size_t  size; // allocation size
-  void*   ptr;  // host memory pointer
+  if (size <= kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  size_t pow2 = kMinBlockSize;
+  while (pow2 < size) {
+    pow2 <<= 1;
+  }
+  const size_t step = (pow2 >> 1) / kClassesPerPow2;
+  return step * ((size + step - 1) / step);
+}
 
-  BlockSize(size_t size, void* ptr=NULL) : size(size), ptr(ptr) {}
-};
+void update_stat(Stat& stat, int64_t amount)
+{
+  stat.current += amount;
+
+  THAssert(stat.current >= 0);
+
+  stat.peak = std::max(stat.current, stat.peak);
+  if (amount > 0) {
+    stat.allocated += amount;
+  }
+  if (amount < 0) {
+    stat.freed += -amount;
+  }
+}
+
+void reset_accumulated_stat(Stat& stat)
+{
+  stat.allocated = 0;
+  stat.freed = 0;
+}
 
-struct Block : public BlockSize
+void reset_peak_stat(Stat& stat)
 {
-  bool  allocated;    // true if the block is currently allocated
-  int   event_count;  // number of outstanding cuda events
+  stat.peak = stat.current;
+}
+
+struct Block
+{
+  size_t  size;         // allocation size (a size class)
+  void*   ptr;          // host memory pointer
+  bool    allocated;    // true if the block is currently allocated
+  int     event_count;  // number of outstanding cuda events
   std::unordered_set<at::cuda::CUDAStream> streams;
 
   Block(size_t size, void* ptr, bool allocated) :
-      BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
+      size(size), ptr(ptr), allocated(allocated), event_count(0), streams() {}
 };
 
-static bool BlockComparator(const BlockSize& a, const BlockSize& b)
-{
-  // sort by size, break ties with pointer
-  if (a.size != b.size) {
-    return a.size < b.size;
-  }
-  return (uintptr_t)a.ptr < (uintptr_t)b.ptr;
-}
-
 struct HostAllocator
 {
-  typedef bool (*Comparison)(const BlockSize&, const BlockSize&);
-
   // lock around all operations
   std::mutex mutex;
 
   // blocks by pointer
   std::unordered_map<void*, Block> blocks;
 
-  // pointers that are ready to be allocated (event_count=0)
-  std::set<BlockSize, Comparison> available;
+  // pointers that are ready to be allocated (event_count=0), by size class
+  std::unordered_map<size_t, std::vector<void*>> available;
 
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
 
-  HostAllocator() : available(BlockComparator) {}
+  // allocator statistics
+  THCCachingHostAllocatorStats stats;
+
+  // pending background allocations: (size class, count)
+  std::deque<std::pair<size_t, size_t>> prealloc_requests;
+  std::condition_variable prealloc_cv;
+  std::unique_ptr<std::thread> prealloc_thread;
+  bool shutting_down = false;
+
+  ~HostAllocator()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      shutting_down = true;
+      prealloc_requests.clear();
+    }
+    prealloc_cv.notify_all();
+    if (prealloc_thread) {
+      prealloc_thread->join();
+    }
+  }
 
   cudaError_t malloc(void** ptr, size_t size)
   {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_lock<std::mutex> lock(mutex);
+
+    *ptr = nullptr;
+    if (size == 0) {
+      return cudaSuccess;
+    }
 
     // process outstanding cuda events which may have occurred
     cudaError_t err = processEvents();
@@ -70,39 +129,40 @@ struct HostAllocator
       return err;
     }
 
-    // search for the smallest block which can hold this allocation
-    BlockSize search_key(size);
-    auto it = available.lower_bound(search_key);
-    if (it != available.end()) {
-      Block& block = blocks.at(it->ptr);
+    // reuse a cached block of the same size class
+    size = round_size(size);
+    auto& bin = available[size];
+    if (!bin.empty()) {
+      Block& block = blocks.at(bin.back());
       THAssert(!block.allocated && block.event_count == 0);
+      bin.pop_back();
       block.allocated = true;
       *ptr = block.ptr;
-      available.erase(it);
+      stats.num_cache_hits += 1;
+      update_stat(stats.allocation, 1);
+      update_stat(stats.allocated_bytes, size);
       return cudaSuccess;
     }
 
-    // Pinned memory pointers allocated by any device can be directly used by any
-    // other device, regardless of the current device at the time of allocation,
-    // since we assume unified addressing.
-    // So we grab any existing primary context, if available.
-    // See pytorch/pytorch#21081.
-    at::OptionalDeviceGuard device_guard;
-    auto primary_ctx_device_index = at::detail::getCUDAHooks().getDevceIndexWithPrimaryContext();
-    if (primary_ctx_device_index.has_value()) {
-      device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
-    }
-
-    // note that cudaHostAlloc may not touch pointer if size is 0
-    *ptr = 0;
+    // Requests for this size class are likely to keep coming (e.g. one per
+    // batch), so have the background thread get the next block ready while
+    // we allocate this one.
+    requestPrealloc(size, kPreallocBlocks);
 
-    // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+    // allocate a new block if no cached allocation is found; don't hold the
+    // lock while cudaHostAlloc pins the pages
+    lock.unlock();
+    err = allocatePinned(ptr, size);
+    lock.lock();
     if (err != cudaSuccess) {
       return err;
     }
 
     blocks.insert({*ptr, Block(size, *ptr, true)});
+    update_stat(stats.segment, 1);
+    update_stat(stats.reserved_bytes, size);
+    update_stat(stats.allocation, 1);
+    update_stat(stats.allocated_bytes, size);
     return cudaSuccess;
   }
 
@@ -129,6 +189,8 @@ struct HostAllocator
     // free (on valid memory) shouldn't fail, so mark unallocated before
     // we process the streams.
     block.allocated = false;
+    update_stat(stats.allocation, -1);
+    update_stat(stats.allocated_bytes, -block.size);
 
     // insert CUDA events for each stream on which this block was used. This
     err = insertEvents(block);
@@ -138,7 +200,7 @@ struct HostAllocator
 
     if (block.event_count == 0) {
       // the block can be re-used if there are no outstanding cuda events
-      available.insert(block);
+      available[block.size].push_back(block.ptr);
     }
     return cudaSuccess;
   }
@@ -185,7 +247,7 @@ struct HostAllocator
       Block& block = blocks.at(e.second);
       block.event_count--;
       if (block.event_count == 0 && !block.allocated) {
-        available.insert(block);
+        available[block.size].push_back(block.ptr);
       }
       cuda_events.pop_front();
     }
@@ -196,6 +258,9 @@ struct HostAllocator
   {
     std::lock_guard<std::mutex> lock(mutex);
 
+    // drop pending background allocations
+    prealloc_requests.clear();
+
     // remove events for freed blocks
     for (auto it = cuda_events.begin(); it != cuda_events.end(); ++it) {
       cudaEvent_t event = it->first;
@@ -217,6 +282,8 @@ struct HostAllocator
       Block& block = it->second;
       if (!block.allocated) {
         THCudaCheckWarn(cudaFreeHost(block.ptr));
+        update_stat(stats.segment, -1);
+        update_stat(stats.reserved_bytes, -block.size);
         it = blocks.erase(it);
       } else {
         ++it;
@@ -224,6 +291,41 @@ struct HostAllocator
     }
   }
 
+  void reserve(size_t size, size_t count)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (size == 0 || count == 0) {
+      return;
+    }
+    requestPrealloc(round_size(size), count);
+  }
+
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+  }
+
+  void resetAccumulatedStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    reset_accumulated_stat(stats.allocation);
+    reset_accumulated_stat(stats.segment);
+    reset_accumulated_stat(stats.allocated_bytes);
+    reset_accumulated_stat(stats.reserved_bytes);
+    stats.num_cache_hits = 0;
+    stats.num_preallocated = 0;
+  }
+
+  void resetPeakStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    reset_peak_stat(stats.allocation);
+    reset_peak_stat(stats.segment);
+    reset_peak_stat(stats.allocated_bytes);
+    reset_peak_stat(stats.reserved_bytes);
+  }
+
   cudaError_t insertEvents(Block& block)
   {
     cudaError_t err;
@@ -251,6 +353,73 @@ struct HostAllocator
     cudaSetDevice(prev_device);
     return err;
   }
+
+ private:
+
+  // All private methods except allocatePinned must be called with the
+  // mutex held.
+
+  static cudaError_t allocatePinned(void** ptr, size_t size)
+  {
+    // Pinned memory pointers allocated by any device can be directly used by any
+    // other device, regardless of the current device at the time of allocation,
+    // since we assume unified addressing.
+    // So we grab any existing primary context, if available.
+    // See pytorch/pytorch#21081.
+    at::OptionalDeviceGuard device_guard;
+    auto primary_ctx_device_index = at::detail::getCUDAHooks().getDevceIndexWithPrimaryContext();
+    if (primary_ctx_device_index.has_value()) {
+      device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
+    }
+
+    *ptr = nullptr;
+    return cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+  }
+
+  void requestPrealloc(size_t size, size_t count)
+  {
+    if (shutting_down) {
+      return;
+    }
+    prealloc_requests.emplace_back(size, count);
+    if (!prealloc_thread) {
+      prealloc_thread.reset(new std::thread([this]() { preallocLoop(); }));
+    }
+    prealloc_cv.notify_one();
+  }
+
+  void preallocLoop()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      prealloc_cv.wait(lock, [this]() {
+        return shutting_down || !prealloc_requests.empty();
+      });
+      if (shutting_down) {
+        return;
+      }
+      auto request = prealloc_requests.front();
+      prealloc_requests.pop_front();
+
+      for (size_t i = 0; i < request.second && !shutting_down; ++i) {
+        void* ptr = nullptr;
+        lock.unlock();
+        cudaError_t err = allocatePinned(&ptr, request.first);
+        lock.lock();
+        if (err != cudaSuccess) {
+          // Preallocation is best effort; the next malloc will report the
+          // error if the system is really out of pinned memory.
+          cudaGetLastError();
+          break;
+        }
+        blocks.insert({ptr, Block(request.first, ptr, false)});
+        available[request.first].push_back(ptr);
+        stats.num_preallocated += 1;
+        update_stat(stats.segment, 1);
+        update_stat(stats.reserved_bytes, request.first);
+      }
+    }
+  }
 };
 
 }  // namespace
@@ -267,6 +436,26 @@ void THCCachingHostAllocator_emptyCache()
   allocator.emptyCache();
 }
 
+void THCCachingHostAllocator_reserve(size_t size, size_t count)
+{
+  allocator.reserve(size, count);
+}
+
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return allocator.getStats();
+}
+
+void THCCachingHostAllocator_resetAccumulatedStats()
+{
+  allocator.resetAccumulatedStats();
+}
+
+void THCCachingHostAllocator_resetPeakStats()
+{
+  allocator.resetPeakStats();
+}
+
 static void THCCachingHostDeleter(void* ptr) {
   allocator.free(ptr);
 }
@@ -4,6 +4,7 @@
 #include <THC/THCGeneral.h>
 
 
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAStream.h>
 
 //
@@ -19,10 +20,37 @@
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
 // Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// blocks, unlike the caching device allocator. Requests are instead rounded up
+// to a size class (four per power of two) and served from the free list of
+// that class. When a class misses, one extra block of that class is allocated
+// on a background thread, so that the next request of the same shape (e.g.
+// the next batch of a data loader) does not stall on cudaHostAlloc.
+//
+// This is the allocator behind at::cuda::getPinnedMemoryAllocator(), so
+// Tensor::pin_memory() (and with it the Python DataLoader's pin thread) and
+// C++ code share the same cache.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
+// Struct containing pinned memory allocator summary statistics.
+struct THCCachingHostAllocatorStats {
+  using Stat = c10::cuda::CUDACachingAllocator::Stat;
+
+  // COUNT: allocations requested by client code
+  Stat allocation;
+  // COUNT: number of pinned blocks obtained from cudaHostAlloc
+  Stat segment;
+  // SUM: bytes requested by client code (rounded to the size class)
+  Stat allocated_bytes;
+  // SUM: bytes held by this allocator (both free and used)
+  Stat reserved_bytes;
+
+  // COUNT: allocations served from a free list
+  int64_t num_cache_hits = 0;
+  // COUNT: blocks allocated ahead of time on the background thread
+  int64_t num_preallocated = 0;
+};
+
 // Records an event in the specified stream. The allocation 'ptr' will not be
 // re-used until the event has occurred.
 THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUDAStream stream);
@@ -30,4 +58,12 @@ THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUD
 // Releases cached pinned memory allocations via cudaHostFree
 THC_API void THCCachingHostAllocator_emptyCache(void);
 
+// Asynchronously allocates `count` blocks big enough for `size` bytes each
+// and adds them to the cache.
+THC_API void THCCachingHostAllocator_reserve(size_t size, size_t count);
+
+THC_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+THC_API void THCCachingHostAllocator_resetAccumulatedStats(void);
+THC_API void THCCachingHostAllocator_resetPeakStats(void);
+
 #endif
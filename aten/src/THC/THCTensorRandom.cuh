@@ -10,18 +10,6 @@
 #define MAX_NUM_BLOCKS 200
 #define BLOCK_SIZE 256
 
-template <typename T>
-__global__ void
-multinomialAliasDrawKernel(int size, int64_t *output, int64_t *J, T *q, int64_t K,  T *uniform, T *bernoulli){
-  int64_t idx = blockIdx.x * BLOCK_SIZE + threadIdx.x;
-  if (idx < size) {
-    int64_t rand_ind = ScalarConvert<T, int64_t>::to(uniform[idx]);
-    T bern_uniform = bernoulli[idx];
-    int _mask = (int) THCNumerics<T>::lt(bern_uniform, q[rand_ind]);
-    output[idx] = J[rand_ind]*(1 -_mask) + rand_ind * _mask;
-  }
-}
-
 template <typename T>
 __global__ void
 aliasMultinomialFilter(T *q, T *probs, int64_t *smaller, int64_t *larger, int64_t *J_data, int64_t *larger_short_data, int64_t *smaller_short_data, T one, int64_t inputsize){
@@ -9,7 +9,9 @@
 #include <THC/THCTensorTypeUtils.cuh>
 
 #include <THC/THCThrustAllocator.cuh>
+#include <cub/cub.cuh>
 #include <thrust/device_ptr.h>
+#include <thrust/for_each.h>
 #include <thrust/sort.h>
 #if CUDA_VERSION >= 7000 || defined(__HIP_PLATFORM_HCC__)
 #include <thrust/system/cuda/execution_policy.h>
@@ -97,6 +99,30 @@ struct GlobalIndexToPerSliceIndex {
   const int64_t sliceSize;
 };
 
+// For sorting with cub; the radix sort orders NaNs by their bits, so they
+// are all made the positive quiet NaN first, which sorts above +inf like the
+// comparators above put NaN above every other value
+template <typename T>
+struct CanonicalizeNaN {
+  __device__ inline void operator()(T& v) const {
+    if (THCNumerics<T>::isnan(v)) {
+      v = static_cast<T>(NAN);
+    }
+  }
+};
+
+// For sorting with cub; the start offset of each slice, the segments cub
+// sorts independently
+struct SliceToOffset {
+  SliceToOffset(int size) : sliceSize(size) {}
+
+  __host__ __device__ inline int operator()(int slice) const {
+    return slice * sliceSize;
+  }
+
+  const int sliceSize;
+};
+
 void THCudaLongTensor_fillSliceWithIndex(THCState* state,
                                          THCudaLongTensor* t,
                                          int dim);
@@ -69,41 +69,5 @@ void THCTensor_(multinomialAliasSetup)(THCState *state, THCTensor *_probs, THCud
   THCTensor_free(state, probs);
 }
 
-void THCTensor_(multinomialAliasDraw)(THCState *state, THCudaLongTensor *self, THCTensor *_q, THCudaLongTensor *_J, int n_sample, c10::optional<at::Generator> gen_){
-  THArgCheck(_q->dim() == 1, 1,
-             "expected 1-D probability table, got %d-D probability table instead",
-             _q->dim());
-  THArgCheck(_J->dim() == 1, 2,
-             "expected 1-D alias table, got %d-D alias table instead",
-             _J->dim());
-  THArgCheck(n_sample > 0, 3, "cannot sample <= 0 samples");
-  THAssert(THCTensor_(isContiguous)(state, _q));
-  THAssert(THCudaLongTensor_isContiguous(state, _J));
-  int64_t K = THCudaLongTensor_nElement(state, _J);
-  THCudaLongTensor_resize1d(state, self, n_sample);
-  ptrdiff_t size = THCudaLongTensor_nElement(state, self);
-
-  THCTensor *uniform = THCTensor_(newWithSize1d)(state, n_sample);
-  THCTensor *bernoulli = THCTensor_(newWithSize1d)(state, n_sample);
-
-  auto out_uniform = THTensor_wrap(uniform);
-  auto out_bernoulli = THTensor_wrap(bernoulli);
-  at::native::uniform_(out_uniform, 0, K, gen_);
-  at::native::uniform_(out_bernoulli, 0, 1, gen_);
-
-  multinomialAliasDrawKernel
-    <<<THCCeilDiv((int)n_sample+BLOCK_SIZE-1, BLOCK_SIZE), BLOCK_SIZE, 0, c10::cuda::getCurrentCUDAStream()>>>(
-          size,
-          THCudaLongTensor_data(state, self),
-          THCudaLongTensor_data(state, _J),
-          THCTensor_(data)(state, _q),
-          K,
-          THCTensor_(data)(state, uniform),
-          THCTensor_(data)(state, bernoulli)
-          );
-  THCTensor_(free)(state, uniform);
-  THCTensor_(free)(state, bernoulli);
-}
-
 #endif
 #endif
@@ -272,6 +272,110 @@ void THCTensor_(sortViaThrust)(THCState* state,
   THCudaLongTensor_freeCopyTo(state, trContigIndices, indices);
 }
 
+// cub's radix sort handles the native integer and floating point types
+#if defined(THC_REAL_IS_BYTE) || defined(THC_REAL_IS_CHAR) || \
+    defined(THC_REAL_IS_SHORT) || defined(THC_REAL_IS_INT) || \
+    defined(THC_REAL_IS_LONG) || defined(THC_REAL_IS_FLOAT) || \
+    defined(THC_REAL_IS_DOUBLE)
+#define THC_SORT_VIA_CUB
+
+void THCTensor_(sortViaCub)(THCState* state,
+                            THCTensor* sorted,
+                            THCudaLongTensor* indices,
+                            THCTensor* input,
+                            int dim, bool dir) {
+  int nDims = THCTensor_(nDimensionLegacyAll)(state, input);
+
+  ptrdiff_t totalElements = THCTensor_(nElement)(state, input);
+  int64_t sliceSize = THCTensor_(sizeLegacyNoScalars)(state, input, dim);
+  ptrdiff_t numSlices = totalElements / sliceSize;
+
+  // Unlike the Thrust sort above, the segmented radix sort sorts each slice
+  // on its own, in one pass over the data, with the slices given as
+  // [offset, offset + sliceSize) segments of the keys. As for Thrust, the
+  // slices have to be innermost and contiguous.
+  THCTensor* trKeys = THCTensor_(newWithTensor)(state, input);
+  if (dim != nDims - 1) {
+    THCTensor_(transpose)(state, trKeys, NULL, dim, nDims - 1);
+  }
+#if defined(THC_REAL_IS_FLOAT) || defined(THC_REAL_IS_DOUBLE)
+  // The NaNs are rewritten, so the keys are always copied
+  THCTensor* keysIn = THCTensor_(newClone)(state, trKeys);
+#else
+  THCTensor* keysIn = THCTensor_(newContiguous)(state, trKeys);
+#endif
+  THCTensor_(free)(state, trKeys);
+
+  THCTensor* keysOut = THCTensor_(new)(state);
+  THCTensor_(resizeAs)(state, keysOut, keysIn);
+  THCudaLongTensor* valuesIn = THCudaLongTensor_new(state);
+  THCudaLongTensor_resize(state, valuesIn, keysIn->sizes(), {});
+  THCudaLongTensor_fillSliceWithIndex(state, valuesIn, nDims - 1);
+  THCudaLongTensor* valuesOut = THCudaLongTensor_new(state);
+  THCudaLongTensor_resizeAs(state, valuesOut, valuesIn);
+
+  cudaStream_t stream = c10::cuda::getCurrentCUDAStream();
+
+#if defined(THC_REAL_IS_FLOAT) || defined(THC_REAL_IS_DOUBLE)
+  THCThrustAllocator thrustAlloc(state);
+  thrust::device_ptr<scalar_t> keyIter(THCTensor_(data)(state, keysIn));
+  thrust::for_each(
+#if CUDA_VERSION >= 7000 || defined __HIP_PLATFORM_HCC__
+    thrust::cuda::par(thrustAlloc).on(stream),
+#endif
+    keyIter, keyIter + totalElements, CanonicalizeNaN<scalar_t>());
+#endif
+
+  cub::CountingInputIterator<int> sliceIter(0);
+  cub::TransformInputIterator<int, SliceToOffset, cub::CountingInputIterator<int>>
+    beginOffsets(sliceIter, SliceToOffset(sliceSize));
+  cub::TransformInputIterator<int, SliceToOffset, cub::CountingInputIterator<int>>
+    endOffsets(sliceIter + 1, SliceToOffset(sliceSize));
+
+  const scalar_t* keysInData = THCTensor_(data)(state, keysIn);
+  scalar_t* keysOutData = THCTensor_(data)(state, keysOut);
+  const int64_t* valuesInData = THCudaLongTensor_data(state, valuesIn);
+  int64_t* valuesOutData = THCudaLongTensor_data(state, valuesOut);
+
+  // The first call only computes the size of the temporary storage, which
+  // then comes from the caching allocator
+  size_t tempStorageBytes = 0;
+  void* tempStorage = nullptr;
+  for (int pass = 0; pass < 2; ++pass) {
+    if (pass == 1) {
+      tempStorage = THCudaMalloc(state, tempStorageBytes);
+    }
+    if (dir) {
+      THCudaCheck(cub::DeviceSegmentedRadixSort::SortPairsDescending(
+        tempStorage, tempStorageBytes,
+        keysInData, keysOutData, valuesInData, valuesOutData,
+        (int) totalElements, (int) numSlices, beginOffsets, endOffsets,
+        0, sizeof(scalar_t) * 8, stream));
+    } else {
+      THCudaCheck(cub::DeviceSegmentedRadixSort::SortPairs(
+        tempStorage, tempStorageBytes,
+        keysInData, keysOutData, valuesInData, valuesOutData,
+        (int) totalElements, (int) numSlices, beginOffsets, endOffsets,
+        0, sizeof(scalar_t) * 8, stream));
+    }
+  }
+  THCudaFree(state, tempStorage);
+
+  THCTensor_(free)(state, keysIn);
+  THCudaLongTensor_free(state, valuesIn);
+
+  // Reverse the transposition as needed
+  if (dim != nDims - 1) {
+    THCTensor_(transpose)(state, keysOut, NULL, dim, nDims - 1);
+    THCudaLongTensor_transpose(state, valuesOut, NULL, dim, nDims - 1);
+  }
+  // Then copy back to the expected output
+  THCTensor_(freeCopyTo)(state, keysOut, sorted);
+  THCudaLongTensor_freeCopyTo(state, valuesOut, indices);
+}
+
+#endif
+
 void THCTensor_(sort)(THCState* state,
                       THCTensor *sorted,
                       THCudaLongTensor *indices,
@@ -319,6 +423,12 @@ void THCTensor_(sort)(THCState* state,
     // Sort using our in-place k/v kernel that supports arbitrary
     // layout
     THCTensor_(sortKeyValueInplace)(state, sorted, indices, dim, order);
+#ifdef THC_SORT_VIA_CUB
+  } else if (THCTensor_(nElement)(state, input) < INT_MAX) {
+    // Larger slices are sorted by cub's segmented radix sort, which indexes
+    // the whole tensor with int
+    THCTensor_(sortViaCub)(state, sorted, indices, input, dim, (bool) order);
+#endif
   } else {
     // Otherwise, fall back upon Thrust, which handles all other cases
     // (potentially slowly, with extra copies/memory allocations)
@@ -328,4 +438,6 @@ void THCTensor_(sort)(THCState* state,
   THCudaCheck(cudaGetLastError());
 }
 
+#undef THC_SORT_VIA_CUB
+
 #endif
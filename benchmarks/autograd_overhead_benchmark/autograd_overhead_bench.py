@@ -0,0 +1,72 @@
+"""Microbenchmarks for the per-op overhead of autograd.
+
+Each case runs forward + backward over num_ops tiny ops, so that the time is
+dominated by graph construction (one Node per op) and by the engine, rather
+than by the kernels. Results are reported per op.
+
+    python autograd_overhead_bench.py --num-ops 1000 --static-graph
+"""
+import argparse
+import timeit
+
+import torch
+
+
+def chain(x, w, num_ops):
+    # Every op depends on the previous one
+    for _ in range(num_ops):
+        x = x * w
+    return x.sum()
+
+
+def wide(x, w, num_ops):
+    # Independent ops accumulating into the same leaves
+    return sum((x * w).sum() for _ in range(num_ops))
+
+
+def mixed(x, w, num_ops):
+    # Ops saving tensors of different kinds for backward
+    for i in range(num_ops // 4):
+        x = (x + w).tanh() * w
+        x = x[:, :1].expand_as(x) if i % 2 else x.relu()
+    return x.sum()
+
+
+CASES = {
+    'chain': chain,
+    'wide': wide,
+    'mixed': mixed,
+}
+
+
+def run_bench(args):
+    torch.set_num_threads(1)
+    torch.autograd.set_static_graph(args.static_graph)
+    x = torch.randn(args.size, args.size, requires_grad=True)
+    w = torch.randn(args.size, args.size, requires_grad=True)
+
+    print("{:<8} {:>16} {:>22}".format("case", "forward (us/op)", "fwd + bwd (us/op)"))
+    for name, fn in CASES.items():
+        def forward():
+            fn(x, w, args.num_ops)
+
+        def forward_backward():
+            fn(x, w, args.num_ops).backward()
+
+        results = []
+        for stmt in [forward, forward_backward]:
+            stmt()  # warmup
+            times = timeit.repeat(stmt, number=args.iters, repeat=args.repeat)
+            results.append(min(times) / args.iters / args.num_ops * 1e6)
+        print("{:<8} {:>16.3f} {:>22.3f}".format(name, *results))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Benchmark the per-op overhead of autograd')
+    parser.add_argument('--num-ops', type=int, default=1000)
+    parser.add_argument('--size', type=int, default=2, help='side of the (square) tensors')
+    parser.add_argument('--iters', type=int, default=10)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--static-graph', action='store_true',
+                        help='replay backward graphs with torch.autograd.set_static_graph')
+    run_bench(parser.parse_args())
@@ -65,7 +65,18 @@ def allequal(iterator):
     return all(first == rest for rest in iterator)
 
 
-def benchmark_process_group(pg, benchmark, use_ddp_for_single_rank=True):
+# Built-in DDP communication hooks that can be compared with --comm-hooks
+COMM_HOOKS = {
+    "fp16": dict(comm_hook_type=dist.BuiltinCommHookType.FP16_COMPRESS),
+    "bf16": dict(comm_hook_type=dist.BuiltinCommHookType.BF16_COMPRESS),
+    "powersgd": dict(comm_hook_type=dist.BuiltinCommHookType.POWER_SGD,
+                     matrix_approximation_rank=4),
+    "topk": dict(comm_hook_type=dist.BuiltinCommHookType.TOP_K,
+                 compress_ratio=0.01),
+}
+
+
+def benchmark_process_group(pg, benchmark, use_ddp_for_single_rank=True, comm_hook=None):
     torch.manual_seed(pg.rank())
     torch.cuda.manual_seed(pg.rank())
 
@@ -84,6 +95,8 @@ def benchmark_process_group(pg, benchmark, use_ddp_for_single_rank=True):
             broadcast_buffers=False,
             process_group=pg,
             bucket_cap_mb=benchmark.bucket_size)
+        if comm_hook:
+            model._register_builtin_comm_hook(**COMM_HOOKS[comm_hook])
 
     measurements = []
     warmup_iterations = 5
@@ -156,6 +169,15 @@ def sweep(benchmark):
     for i in range(1, (dist.get_world_size() // 8) + 1):
         append_benchmark("   %dM/8G" % i, range(i * 8))
 
+    # Compressed gradients, on all the machines
+    num_machines = max(dist.get_world_size() // 8, 1)
+    num_gpus = min(dist.get_world_size(), 8) * num_machines
+    for comm_hook in benchmark.comm_hooks:
+        append_benchmark(
+            "%s %dM/%dG" % (comm_hook, num_machines, num_gpus // num_machines),
+            range(num_gpus),
+            {"comm_hook": comm_hook})
+
     # Run benchmarks in order of increasing number of GPUs
     print_header()
     results = []
@@ -165,17 +187,22 @@ def sweep(benchmark):
         measurements = run_benchmark(benchmark, ranks, opts)
         if "warmup" not in prefix:
             print_measurements(prefix, benchmark.batch_size, measurements)
-            results.append({"ranks": ranks, "measurements": measurements})
+            results.append({
+                "ranks": ranks,
+                "comm_hook": (opts or {}).get("comm_hook"),
+                "measurements": measurements,
+            })
 
     return results
 
 
 class Benchmark(object):
-    def __init__(self, device, distributed_backend, bucket_size):
+    def __init__(self, device, distributed_backend, bucket_size, comm_hooks=()):
         self.device = device
         self.batch_size = 32
         self.distributed_backend = distributed_backend
         self.bucket_size = bucket_size
+        self.comm_hooks = comm_hooks
 
     def __str__(self):
         raise NotImplementedError
@@ -191,11 +218,12 @@ class Benchmark(object):
 
 
 class TorchvisionBenchmark(Benchmark):
-    def __init__(self, device, distributed_backend, bucket_size, model):
+    def __init__(self, device, distributed_backend, bucket_size, model, comm_hooks=()):
         super(TorchvisionBenchmark, self).__init__(
             device,
             distributed_backend,
             bucket_size,
+            comm_hooks,
         )
         self.model = model
 
@@ -222,7 +250,13 @@ def main():
     parser.add_argument("--master-port", type=str, required=True)
     parser.add_argument("--model", type=str)
     parser.add_argument("--json", type=str, metavar="PATH", help="Write file with benchmark results")
+    parser.add_argument("--comm-hooks", type=str, default="",
+                        help="Comma separated built-in comm hooks to compare with plain allreduce, "
+                        "among: " + ", ".join(sorted(COMM_HOOKS)))
     args = parser.parse_args()
+    comm_hooks = [hook for hook in args.comm_hooks.split(",") if hook]
+    for hook in comm_hooks:
+        assert hook in COMM_HOOKS, "Unknown comm hook: {}".format(hook)
 
     num_gpus_per_node = torch.cuda.device_count()
     assert num_gpus_per_node == 8, "Expected 8 GPUs per machine"
@@ -250,6 +284,8 @@ def main():
         print("* CUDA version: {}".format(torch.version.cuda))
         print("* Distributed backend: {}".format(args.distributed_backend))
         print("* Maximum bucket size: {}MB".format(args.bucket_size))
+        if comm_hooks:
+            print("* Comm hooks: {}".format(", ".join(comm_hooks)))
         print("")
         print("--- nvidia-smi topo -m ---")
         print("")
@@ -267,7 +303,8 @@ def main():
                 device=device,
                 distributed_backend=args.distributed_backend,
                 bucket_size=args.bucket_size,
-                model=args.model))
+                model=args.model,
+                comm_hooks=comm_hooks))
     else:
         for model in ["resnet50", "resnet101", "resnext50_32x4d", "resnext101_32x8d"]:
             benchmarks.append(
@@ -275,7 +312,8 @@ def main():
                     device=device,
                     distributed_backend=args.distributed_backend,
                     bucket_size=args.bucket_size,
-                    model=model))
+                    model=model,
+                    comm_hooks=comm_hooks))
 
     benchmark_results = []
     for benchmark in benchmarks:
@@ -295,6 +333,7 @@ def main():
             "cuda_version": torch.version.cuda,
             "distributed_backend": args.distributed_backend,
             "bucket_size": args.bucket_size,
+            "comm_hooks": comm_hooks,
             "benchmark_results": benchmark_results,
         }
         with open(args.json, 'w') as f:
@@ -66,11 +66,17 @@ def main():
             # Sanity check: ignore if number of ranks is not equal
             if len(xa["ranks"]) != len(xb["ranks"]):
                 continue
+            # Only compare runs using the same comm hook
+            comm_hook = xa.get("comm_hook")
+            if comm_hook != xb.get("comm_hook"):
+                continue
 
             ngpus = len(xa["ranks"])
             ma = sorted(xa["measurements"])
             mb = sorted(xb["measurements"])
             print("{:>4d} GPUs:".format(ngpus), end='')  # noqa: E999
+            if comm_hook:
+                print(" ({})".format(comm_hook), end='')  # noqa: E999
             for p in [75, 95]:
                 va = np.percentile(ma, p)
                 vb = np.percentile(mb, p)
@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+#
+# Measure RPC and RRef latency and throughput.
+#
+# This program spawns N workers on the local machine for every RPC agent
+# under test (ProcessGroupAgent and TensorPipeAgent). Worker 0 drives the
+# benchmarks against the other workers, round robin, and reports:
+#
+# - the latency percentiles of an echo RPC,
+# - the message throughput by payload size, with many RPCs in flight,
+# - the bandwidth of round trips of tensor payloads,
+# - the cost of creating, forking and deleting an RRef,
+# - the latency of a distributed autograd backward pass through all workers,
+#
+# followed by the getMetrics() counters of the agent of worker 0.
+#
+
+import argparse
+import json
+import os
+import time
+
+import numpy as np
+import torch
+import torch.distributed.autograd as dist_autograd
+import torch.distributed.rpc as rpc
+import torch.multiprocessing as mp
+
+
+if not torch._six.PY3:
+    raise RuntimeError("RPC benchmark requires Python 3")
+
+
+BACKENDS = {
+    "process_group": rpc.BackendType.PROCESS_GROUP,
+    "tensorpipe": rpc.BackendType.TENSORPIPE,
+}
+
+
+def identity(x):
+    return x
+
+
+def rref_to_here(rref):
+    return rref.to_here()
+
+
+def num_owner_rrefs():
+    return int(rpc._rref_context_get_debug_info()["num_owner_rrefs"])
+
+
+def worker_name(rank):
+    return "worker{}".format(rank)
+
+
+def percentiles(samples):
+    samples = np.array(samples) * 1e6
+    return {
+        "p50_us": float(np.percentile(samples, 50)),
+        "p90_us": float(np.percentile(samples, 90)),
+        "p99_us": float(np.percentile(samples, 99)),
+    }
+
+
+class Benchmarks(object):
+    def __init__(self, args):
+        self.args = args
+        self.peers = [worker_name(rank) for rank in range(1, args.world_size)]
+
+    def peer(self, i):
+        return self.peers[i % len(self.peers)]
+
+    def echo_latency(self):
+        samples = []
+        for i in range(self.args.warmup + self.args.iters):
+            start = time.perf_counter()
+            rpc.rpc_sync(self.peer(i), identity, args=(i,))
+            if i >= self.args.warmup:
+                samples.append(time.perf_counter() - start)
+        return percentiles(samples)
+
+    def message_throughput(self):
+        results = {}
+        for size in self.args.payload_sizes:
+            payload = b"x" * size
+            for _ in range(self.args.warmup):
+                rpc.rpc_sync(self.peer(0), identity, args=(payload,))
+            start = time.perf_counter()
+            futs = [
+                rpc.rpc_async(self.peer(i), identity, args=(payload,))
+                for i in range(self.args.iters)
+            ]
+            for fut in futs:
+                fut.wait()
+            elapsed = time.perf_counter() - start
+            results[size] = {
+                "messages_per_s": self.args.iters / elapsed,
+                "MB_per_s": 2 * size * self.args.iters / elapsed / 1e6,
+            }
+        return results
+
+    def tensor_bandwidth(self):
+        results = {}
+        for size in self.args.payload_sizes:
+            tensor = torch.empty(size, dtype=torch.uint8)
+            samples = []
+            for i in range(self.args.warmup + self.args.iters):
+                start = time.perf_counter()
+                rpc.rpc_sync(self.peer(i), identity, args=(tensor,))
+                if i >= self.args.warmup:
+                    samples.append(time.perf_counter() - start)
+            # Both directions of the round trip carry the tensor
+            result = percentiles(samples)
+            result["MB_per_s"] = 2 * size / float(np.median(samples)) / 1e6
+            results[size] = result
+        return results
+
+    def rref_fork_delete(self):
+        # Creates an RRef on a worker and shares it with the next one, which
+        # adds a fork, then deletes the last user reference. The deletions
+        # are asynchronous, so they are timed together until the owners are
+        # told.
+        create_samples = []
+        fork_samples = []
+        start_all = time.perf_counter()
+        for i in range(self.args.warmup + self.args.iters):
+            start = time.perf_counter()
+            rref = rpc.remote(self.peer(i), torch.ones, args=(1,))
+            rref.to_here()
+            created = time.perf_counter()
+            rpc.rpc_sync(self.peer(i + 1), rref_to_here, args=(rref,))
+            forked = time.perf_counter()
+            del rref
+            if i >= self.args.warmup:
+                create_samples.append(created - start)
+                fork_samples.append(forked - created)
+            if i + 1 == self.args.warmup:
+                start_all = time.perf_counter()
+        # Waits until the owners have deleted all the RRefs
+        while any(rpc.rpc_sync(peer, num_owner_rrefs) for peer in self.peers):
+            time.sleep(1e-3)
+        total = time.perf_counter() - start_all
+        return {
+            "create": percentiles(create_samples),
+            "fork": percentiles(fork_samples),
+            "create_fork_delete_per_rref_us": total / self.args.iters * 1e6,
+        }
+
+    def dist_autograd_backward(self):
+        # A forward pass that goes through every worker, so that the backward
+        # pass does too.
+        samples = []
+        for i in range(self.args.warmup + self.args.iters):
+            with dist_autograd.context() as context_id:
+                t = torch.rand(self.args.autograd_size, requires_grad=True)
+                out = t
+                for peer in self.peers:
+                    out = rpc.rpc_sync(peer, torch.mul, args=(out, t))
+                loss = out.sum()
+                start = time.perf_counter()
+                dist_autograd.backward(context_id, [loss])
+                if i >= self.args.warmup:
+                    samples.append(time.perf_counter() - start)
+        return percentiles(samples)
+
+    def run(self):
+        results = {}
+        for name in self.args.benchmarks:
+            results[name] = getattr(self, name)()
+        return results
+
+
+ALL_BENCHMARKS = [
+    "echo_latency",
+    "message_throughput",
+    "tensor_bandwidth",
+    "rref_fork_delete",
+    "dist_autograd_backward",
+]
+
+
+def run_worker(rank, args, backend, queue):
+    os.environ["MASTER_ADDR"] = args.master_addr
+    os.environ["MASTER_PORT"] = str(args.master_port)
+    if backend == "process_group":
+        options = rpc.ProcessGroupRpcBackendOptions(
+            num_send_recv_threads=args.num_threads)
+    else:
+        options = rpc.TensorPipeRpcBackendOptions(
+            num_worker_threads=args.num_threads)
+    rpc.init_rpc(
+        worker_name(rank),
+        backend=BACKENDS[backend],
+        rank=rank,
+        world_size=args.world_size,
+        rpc_backend_options=options,
+    )
+    if rank == 0:
+        results = Benchmarks(args).run()
+        results["metrics"] = rpc.api._get_current_rpc_agent().get_metrics()
+        queue.put(results)
+    rpc.shutdown()
+
+
+def print_results(backend, results):
+    print()
+    print("--- {} ---".format(backend))
+    print()
+    for name in ALL_BENCHMARKS:
+        if name not in results:
+            continue
+        print("{}:".format(name))
+        result = results[name]
+        if name in ["message_throughput", "tensor_bandwidth"]:
+            for size, entry in result.items():
+                print("  {:>10} bytes: {}".format(size, format_entry(entry)))
+        elif name == "rref_fork_delete":
+            for key, entry in result.items():
+                print("  {}: {}".format(key, format_entry(entry)))
+        else:
+            print("  {}".format(format_entry(result)))
+    print("metrics:")
+    for key, value in sorted(results["metrics"].items()):
+        print("  {}: {}".format(key, value))
+
+
+def format_entry(entry):
+    if not isinstance(entry, dict):
+        return "{:.1f}".format(entry)
+    return ", ".join("{} {:.1f}".format(k, v) for k, v in entry.items())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RPC benchmark")
+    parser.add_argument("--world-size", type=int, default=4)
+    parser.add_argument(
+        "--backends", nargs="*", default=list(BACKENDS.keys()),
+        choices=list(BACKENDS.keys()))
+    parser.add_argument(
+        "--benchmarks", nargs="*", default=ALL_BENCHMARKS,
+        choices=ALL_BENCHMARKS)
+    parser.add_argument("--iters", type=int, default=1000)
+    parser.add_argument("--warmup", type=int, default=100)
+    parser.add_argument(
+        "--payload-sizes", nargs="*", type=int,
+        default=[16, 1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024])
+    parser.add_argument("--autograd-size", type=int, default=1024)
+    parser.add_argument("--num-threads", type=int, default=16)
+    parser.add_argument("--master-addr", type=str, default="localhost")
+    parser.add_argument("--master-port", type=int, default=29500)
+    parser.add_argument("--json", type=str, metavar="PATH",
+                        help="Write file with benchmark results")
+    args = parser.parse_args()
+
+    if args.world_size < 2:
+        raise ValueError("The benchmarks need at least one worker besides the driver")
+
+    print("-----------------------------------")
+    print("PyTorch RPC benchmark suite")
+    print("-----------------------------------")
+    print()
+    print("* PyTorch version: {}".format(torch.__version__))
+    print("* Workers: {}".format(args.world_size))
+
+    ctx = mp.get_context("spawn")
+    base_port = args.master_port
+    all_results = {}
+    for i, backend in enumerate(args.backends):
+        queue = ctx.SimpleQueue()
+        # Every agent gets a fresh port, as the previous one may linger
+        args.master_port = base_port + i
+        mp.spawn(
+            run_worker,
+            args=(args, backend, queue),
+            nprocs=args.world_size,
+            join=True,
+        )
+        all_results[backend] = queue.get()
+        print_results(backend, all_results[backend])
+
+    if args.json:
+        report = {
+            "pytorch_version": torch.__version__,
+            "world_size": args.world_size,
+            "iters": args.iters,
+            "results": all_results,
+        }
+        with open(args.json, "w") as f:
+            json.dump(report, f)
+
+
+if __name__ == "__main__":
+    main()
@@ -62,6 +62,36 @@ def pytorch_lstm_creator(**kwargs):
         backward=simple_backward)
 
 
+def pytorch_lstm_inference_creator(**kwargs):
+    input, hidden, _, module = lstm_inputs(return_module=True, **kwargs)
+
+    def forward(input, hidden):
+        with torch.no_grad():
+            return module(input, hidden)
+
+    return ModelDef(
+        inputs=[input, hidden],
+        params=flatten_list(module.all_weights),
+        forward=forward,
+        backward_setup=None,
+        backward=None)
+
+
+def pytorch_gru_creator(**kwargs):
+    input, hidden, _, module = gru_inputs(return_module=True, **kwargs)
+    return ModelDef(
+        inputs=[input, hidden],
+        params=flatten_list(module.all_weights),
+        forward=module,
+        backward_setup=gru_backward_setup,
+        backward=simple_backward)
+
+
+def gru_backward_setup(gru_outputs, seed=None):
+    output, _ = gru_outputs
+    return simple_backward_setup(output, seed)
+
+
 def lstm_creator(script=True, **kwargs):
     input, hidden, params, _ = lstm_inputs(return_module=False, **kwargs)
     inputs = [input, hidden] + params[0]
@@ -358,6 +388,17 @@ def lstm_inputs(seqLength=100, numLayers=1, inputSize=512, hiddenSize=512,
         return x, (hx, cx), lstm.all_weights, None
 
 
+# returns: x, hx, all_weights, gru module with all_weights as params
+def gru_inputs(seqLength=100, numLayers=1, inputSize=512, hiddenSize=512,
+               miniBatch=64, return_module=False, device='cuda', seed=None):
+    if seed is not None:
+        torch.manual_seed(seed)
+    x = torch.randn(seqLength, miniBatch, inputSize, device=device)
+    hx = torch.randn(numLayers, miniBatch, hiddenSize, device=device)
+    gru = torch.nn.GRU(inputSize, hiddenSize, numLayers).to(device)
+    return x, hx, gru.all_weights, gru if return_module else None
+
+
 def lstm_factory(cell, script):
     def dynamic_rnn(input, hidden, wih, whh, bih, bhh):
         # type: (Tensor, Tuple[Tensor, Tensor], Tensor, Tensor, Tensor, Tensor) -> Tuple[Tensor, Tuple[Tensor, Tensor]]
@@ -0,0 +1,82 @@
+import argparse
+import timeit
+import torch
+import torch.nn as nn
+from torch.quantization import default_qconfig, prepare_jit
+
+# Measures how long the TorchScript passes take on large graphs: a chain of
+# --num-blocks residual conv-bn-relu blocks, inlined into a single graph.
+
+
+class Block(nn.Module):
+    def __init__(self, channels):
+        super(Block, self).__init__()
+        self.conv = nn.Conv2d(channels, channels, 3, padding=1)
+        self.bn = nn.BatchNorm2d(channels)
+        self.relu = nn.ReLU()
+
+    def forward(self, x):
+        y = self.relu(self.bn(self.conv(x)))
+        y += x
+        return y
+
+
+def make_model(num_blocks, channels=4):
+    return nn.Sequential(*[Block(channels) for _ in range(num_blocks)]).eval()
+
+
+def inlined_graph(scripted):
+    graph = scripted.graph.copy()
+    torch._C._jit_pass_inline(graph)
+    return graph
+
+
+def prepare_cases(num_blocks):
+    model = make_model(num_blocks)
+    scripted = torch.jit.script(model)
+    graph = inlined_graph(scripted)
+    print('{} blocks, {} nodes in the inlined graph'.format(
+        num_blocks, len(list(graph.nodes()))))
+
+    rewrite_patterns = [("""
+graph(%x, %w, %b, %s, %p, %d, %g):
+    %r = aten::conv2d(%x, %w, %b, %s, %p, %d, %g)
+    %y = aten::{}(%r)
+    return (%y)""".format(op), """
+graph(%x, %w, %b, %s, %p, %d, %g):
+    %r = aten::conv2d(%x, %w, %b, %s, %p, %d, %g)
+    %y = aten::{}(%r)
+    return (%y)""".format(op)) for op in ('relu', 'sigmoid', 'tanh', 'hardtanh', 'elu')]
+
+    def rewrite():
+        g = graph.copy()
+        for pattern, replacement in rewrite_patterns:
+            torch._C._jit_pass_custom_pattern_based_rewrite_graph(pattern, replacement, g)
+
+    return {
+        'script': lambda: torch.jit.script(make_model(num_blocks)),
+        'remove_mutation': lambda: torch._C._jit_pass_remove_mutation(graph.copy()),
+        'cse': lambda: torch._C._jit_pass_cse(graph.copy()),
+        'pattern_rewrite': rewrite,
+        'prepare_jit': lambda: prepare_jit(scripted, {'': default_qconfig}),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark TorchScript graph compile time')
+    parser.add_argument('--num-blocks', type=int, nargs='*', default=[100, 1000])
+    parser.add_argument('--repeats', type=int, default=3)
+    parser.add_argument('--cases', nargs='*', default=None)
+    args = parser.parse_args()
+
+    for num_blocks in args.num_blocks:
+        cases = prepare_cases(num_blocks)
+        names = args.cases if args.cases else list(cases.keys())
+        print('{:>20} {:>12}'.format('pass', 'time (ms)'))
+        for name in names:
+            elapsed = min(timeit.repeat(cases[name], number=1, repeat=args.repeats)) * 1e3
+            print('{:>20} {:>12.1f}'.format(name, elapsed))
+
+
+if __name__ == '__main__':
+    main()
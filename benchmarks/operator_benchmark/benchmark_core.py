@@ -10,6 +10,8 @@ import json
 import torch
 import copy
 import ast
+import csv
+import os
 
 # needs to be imported after torch
 import torch.utils.cpp_extension as cpp_extension # noqa
@@ -172,6 +174,8 @@ class BenchmarkRunner(object):
         self.num_runs = args.num_runs
         self.print_per_iter = False
         self.operator_range = benchmark_utils.get_operator_range(args.operator_range)
+        # The results of the tests run, for the results file and the baseline
+        self.results = []
         # 100 is the default warmup iterations
         if self.args.warmup_iterations == -1:
             self.args.warmup_iterations = 100
@@ -232,6 +236,90 @@ class BenchmarkRunner(object):
                 print("{} Execution Time (us) : {:.3f}\n".format(
                     mode, reported_run_time_us[0]))
 
+    def _print_counters(self, counters):
+        print("# Op: {}\n"
+              "# Cycles / iter: {:.0f}, Instructions / iter: {:.0f}, "
+              "LLC misses / iter: {:.1f}, Bytes / iter: {}\n".format(
+                  counters["op"], counters["cycles"], counters["instructions"],
+                  counters["llc_misses"], counters["bytes"]))
+
+    def _use_cpp_backend(self, test_case):
+        return (self.args.cpp_backend and test_case.framework == "PyTorch" and
+                not test_case.test_config.run_backward)
+
+    def _measure_cpp_forward(self, test_case):
+        """ Runs the forward of the op from C++ with the iteration count of
+            the Python backend. Returns the time per iteration in us of every
+            run and the counters of the median run.
+        """
+        runs = [test_case.run_cpp_forward(self.iters, self.args.warmup_iterations)
+                for _ in range(self.num_runs)]
+        runs_by_time = sorted(runs, key=lambda run: run["time_us"])
+        return [run["time_us"] for run in runs], runs_by_time[len(runs) // 2]
+
+    def _record_result(self, test_case, backend, reported_time, counters):
+        result = {
+            "test_name": test_case.test_config.test_name,
+            "framework": test_case.framework,
+            "mode": "Backward" if test_case.test_config.run_backward else "Forward",
+            "backend": backend,
+            "time_us": float(np.percentile(np.array(reported_time), 50)),
+        }
+        if counters is not None:
+            for key in ("cycles", "instructions", "llc_misses", "bytes"):
+                result[key] = counters[key]
+        self.results.append(result)
+
+    def _write_results(self, path):
+        """ Writes the results to a JSON file, or to a CSV file when the path
+            ends with .csv
+        """
+        if path.endswith(".csv"):
+            fields = []
+            for result in self.results:
+                fields += [key for key in result if key not in fields]
+            with open(path, "w") as f:
+                writer = csv.DictWriter(f, fieldnames=fields)
+                writer.writeheader()
+                writer.writerows(self.results)
+        else:
+            with open(path, "w") as f:
+                json.dump(self.results, f, indent=2)
+
+    def _compare_with_baseline(self, path):
+        """ Compares the timings with the results stored in the baseline file,
+            in either of the formats written by _write_results. Returns the
+            number of tests which are slower than their baseline by more than
+            the regression threshold.
+        """
+        with open(path) as f:
+            if path.endswith(".csv"):
+                baseline = list(csv.DictReader(f))
+            else:
+                baseline = json.load(f)
+
+        def key(result):
+            return (result["test_name"], result["framework"], result["mode"],
+                    result["backend"])
+
+        baseline = {key(result): float(result["time_us"]) for result in baseline}
+        print("# Comparison with the baseline {} (threshold: {:.0%})".format(
+            path, self.args.regression_threshold))
+        regressions = 0
+        for result in self.results:
+            if key(result) not in baseline:
+                continue
+            base_time = baseline[key(result)]
+            ratio = result["time_us"] / base_time if base_time > 0 else 1.0
+            regressed = ratio > 1 + self.args.regression_threshold
+            regressions += regressed
+            print("{}{} ({}, {}): {:.3f} us vs {:.3f} us, {:+.1%}".format(
+                "REGRESSION " if regressed else "", result["test_name"],
+                result["mode"], result["backend"], result["time_us"], base_time,
+                ratio - 1))
+        print("# {} regression(s)".format(regressions))
+        return regressions
+
     def _predict_num_iter_needed(self, i):
         return (i * self.multiplier)
 
@@ -390,6 +478,16 @@ class BenchmarkRunner(object):
                 else:
                     launch_func = self._launch_forward
 
+                if self._use_cpp_backend(test_case):
+                    try:
+                        reported_time, counters = self._measure_cpp_forward(test_case)
+                        self._print_perf_result(reported_time, test_case)
+                        self._print_counters(counters)
+                        self._record_result(test_case, "cpp", reported_time, counters)
+                        continue
+                    except RuntimeError as e:
+                        print("# Falling back to the Python backend: {}".format(e))
+
                 # Warmup
                 launch_func(test_case, self.args.warmup_iterations, print_per_iter=False)
                 # Actual Execution
@@ -398,3 +496,13 @@ class BenchmarkRunner(object):
                                  for _ in range(self.num_runs)]
 
                 self._print_perf_result(reported_time, test_case)
+                self._record_result(
+                    test_case, "jit" if self.use_jit else "python", reported_time, None)
+
+        if self.args.list_tests or self.args.list_ops:
+            return 0
+        if self.args.output_file:
+            self._write_results(self.args.output_file)
+        if self.args.baseline_file and os.path.exists(self.args.baseline_file):
+            return self._compare_with_baseline(self.args.baseline_file)
+        return 0
@@ -126,6 +126,24 @@ class PyTorchOperatorTestCase(object):
         self.place_holder_tensor = torch.ones(1)
         self.framework = "PyTorch"
         self.time_series = []
+        self._cpp_graph = None
+
+    def run_cpp_forward(self, num_runs, warmup_iters=0):
+        """ Run the forward path of an op from C++: the op traced from the
+            forward is called through the dispatcher in a loop, so the time
+            doesn't include any Python overhead. Returns a dictionary with the
+            time (us), cycles, instructions and LLC misses per iteration, and
+            the bytes of the inputs and outputs. Raises a RuntimeError when the
+            forward isn't a single op on CPU tensors.
+        """
+        # The extension built from pt_extension, not torch.utils.cpp_extension
+        import cpp_extension as op_bench_extension
+        if self._cpp_graph is None:
+            traced = torch.jit.trace(
+                self.op_bench._wrap_forward, self.place_holder_tensor, check_trace=False)
+            self._cpp_graph = traced.graph
+        return op_bench_extension._benchmark_traced_op(
+            self._cpp_graph, num_runs, warmup_iters)
 
     def run_jit_forward(self, num_runs, print_per_iter=False, cuda_sync=False):
         """ Run the forward path of an op with JIT mode
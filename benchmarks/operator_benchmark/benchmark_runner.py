@@ -4,6 +4,7 @@ from __future__ import print_function
 from __future__ import unicode_literals
 
 import argparse
+import sys
 
 import torch
 
@@ -122,6 +123,33 @@ def main():
         help="Only run the forward path of operators"
     )
 
+    parser.add_argument(
+        "--cpp_backend",
+        type=benchmark_utils.str2bool,
+        nargs='?',
+        const=True,
+        default=False,
+        help="Run the forward of single op PyTorch tests from C++ through the dispatcher, "
+             "and collect hardware counters with perf_event_open (requires pt_extension)"
+    )
+
+    parser.add_argument(
+        "--output_file",
+        help="Write the results to this file, as CSV if it ends with .csv, as JSON otherwise",
+        default=None)
+
+    parser.add_argument(
+        "--baseline_file",
+        help="Compare the results with the ones stored in this file by --output_file, "
+             "and exit with a non-zero status on regressions",
+        default=None)
+
+    parser.add_argument(
+        "--regression_threshold",
+        help="Relative slowdown over the baseline reported as a regression",
+        type=float,
+        default=0.1)
+
     parser.add_argument(
         '--framework',
         help='Comma-delimited list of frameworks to test (Caffe2, PyTorch)',
@@ -150,7 +178,9 @@ def main():
     if args.mkl_num_threads:
         benchmark_utils.set_mkl_threads(args.mkl_num_threads)
 
-    benchmark_core.BenchmarkRunner(args).run()
+    regressions = benchmark_core.BenchmarkRunner(args).run()
+    if regressions:
+        sys.exit(1)
 
 
 if __name__ == "__main__":
@@ -0,0 +1,59 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+
+import operator_benchmark as op_bench
+import torch
+import torch.nn.functional as F
+
+
+"""Microbenchmarks for the CTC loss, on speech recognition shapes: about 100
+frames per second of audio, and character or subword vocabularies."""
+
+ctc_loss_configs_short = op_bench.config_list(
+    attr_names=["T", "N", "C", "S"],
+    attrs=[
+        [150, 16, 32, 40],
+    ],
+    cross_product_configs={
+        'device': ['cpu'],
+    },
+    tags=["short"]
+)
+
+# The inputs are long enough for the targets, so that the losses are finite
+ctc_loss_configs_long = op_bench.config_list(
+    attr_names=["T", "N", "C", "S"],
+    attrs=[
+        [500, 32, 32, 100],
+        [500, 32, 1024, 100],
+        [1500, 32, 32, 300],
+        [1500, 32, 1024, 300],
+    ],
+    cross_product_configs={
+        'device': ['cpu', 'cuda'],
+    },
+    tags=["long"]
+)
+
+
+class CTCLossBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, T, N, C, S, device):
+        self.log_probs = torch.randn(T, N, C, device=device).log_softmax(2).detach().requires_grad_(self.auto_set())
+        self.targets = torch.randint(1, C, (N, S), dtype=torch.long, device=device)
+        self.input_lengths = torch.full((N,), T, dtype=torch.long)
+        self.target_lengths = torch.randint(S // 2, S + 1, (N,), dtype=torch.long)
+        self.set_module_name("ctc_loss")
+
+    def forward(self):
+        return F.ctc_loss(self.log_probs, self.targets, self.input_lengths, self.target_lengths)
+
+
+op_bench.generate_pt_test(ctc_loss_configs_short + ctc_loss_configs_long, CTCLossBenchmark)
+op_bench.generate_pt_gradient_test(ctc_loss_configs_short + ctc_loss_configs_long, CTCLossBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
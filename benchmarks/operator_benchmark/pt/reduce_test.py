@@ -0,0 +1,52 @@
+import operator_benchmark as op_bench
+import torch
+
+"""Microbenchmarks for reductions along the contiguous dimension, where few
+outputs leave each output many inputs to reduce."""
+
+# M outputs, each reducing N contiguous inputs
+reduce_configs_short = op_bench.cross_product_configs(
+    M=[1, 16],
+    N=[1024 * 1024],
+    dtype=[torch.float, torch.half],
+    device=['cuda'],
+    tags=['short']
+)
+
+reduce_configs_long = op_bench.cross_product_configs(
+    M=[1, 4, 16],
+    N=[1024 * 1024 + 1, 16 * 1024 * 1024],
+    dtype=[torch.float, torch.half],
+    device=['cuda'],
+    tags=['long']
+)
+
+
+class ReduceBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, dtype, device, op_func):
+        self.input_tensor = torch.rand(M, N, device=device).to(dtype)
+        self.op_func = op_func
+
+    def forward(self):
+        return self.op_func(self.input_tensor, -1)
+
+
+reduce_ops_list = op_bench.op_list(
+    attr_names=['op_name', 'op_func'],
+    attrs=[
+        ['sum', torch.sum],
+        ['mean', torch.mean],
+        ['norm', lambda x, dim: torch.norm(x, dim=dim)],
+        ['max', lambda x, dim: torch.max(x, dim)],
+        ['argmax', torch.argmax],
+    ],
+)
+
+
+op_bench.generate_pt_tests_from_op_list(reduce_ops_list,
+                                        reduce_configs_short + reduce_configs_long,
+                                        ReduceBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
@@ -1,6 +1,20 @@
 #include <torch/extension.h>
 #include <torch/script.h>
 
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+
+#include <chrono>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using torch::Tensor;
 
 Tensor consume(Tensor a) {
@@ -15,6 +29,221 @@ Tensor consume(Tensor a) {
 auto reg = torch::RegisterOperators()
   .op("operator_benchmark::_consume", &consume);
 
+namespace {
+
+// The hardware counters of the calling thread, read with perf_event_open. The
+// work of the intra-op threads isn't counted, so the counters are best read
+// with a single thread. A counter which can't be opened (e.g. when
+// perf_event_paranoid forbids it, or outside of Linux) reads -1.
+class PerfCounters {
+ public:
+  enum Counter { kCycles, kInstructions, kLLCMisses, kNumCounters };
+
+  PerfCounters() {
+#ifdef __linux__
+    const uint64_t configs[kNumCounters] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES};
+    for (int i = 0; i < kNumCounters; i++) {
+      struct perf_event_attr attr = {};
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[i];
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds_[i] = syscall(
+          __NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+          /*group_fd=*/-1, /*flags=*/0);
+    }
+#endif
+  }
+
+  ~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  void start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  void stop() {
+#ifdef __linux__
+    for (int i = 0; i < kNumCounters; i++) {
+      uint64_t value = 0;
+      if (fds_[i] >= 0) {
+        ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fds_[i], &value, sizeof(value)) == sizeof(value)) {
+          values_[i] = static_cast<int64_t>(value);
+        }
+      }
+    }
+#endif
+  }
+
+  int64_t value(Counter counter) const {
+    return values_[counter];
+  }
+
+ private:
+  int fds_[kNumCounters] = {-1, -1, -1};
+  int64_t values_[kNumCounters] = {-1, -1, -1};
+};
+
+int64_t tensor_bytes(const c10::IValue& value) {
+  if (value.isTensor()) {
+    const auto& tensor = value.toTensor();
+    return tensor.defined() ? tensor.numel() * tensor.element_size() : 0;
+  }
+  int64_t bytes = 0;
+  if (value.isTensorList()) {
+    for (const Tensor& tensor : value.toTensorList()) {
+      bytes += tensor.numel() * tensor.element_size();
+    }
+  } else if (value.isTuple()) {
+    for (const auto& element : value.toTuple()->elements()) {
+      bytes += tensor_bytes(element);
+    }
+  }
+  return bytes;
+}
+
+bool is_cpu(const c10::IValue& value) {
+  if (value.isTensor()) {
+    return !value.toTensor().defined() || value.toTensor().device().is_cpu();
+  }
+  if (value.isTensorList()) {
+    for (const Tensor& tensor : value.toTensorList()) {
+      if (!tensor.device().is_cpu()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Runs the only operator of the graph traced from the forward of an operator
+// benchmark, calling it through the dispatcher with the inputs the trace
+// recorded as constants, so that no Python or interpreter overhead is
+// measured. Returns the time and the hardware counters per iteration.
+py::dict benchmark_traced_op(
+    const std::shared_ptr<torch::jit::Graph>& graph,
+    int64_t iters,
+    int64_t warmup_iters) {
+  TORCH_CHECK(iters > 0, "iters must be positive");
+  const torch::jit::Node* op_node = nullptr;
+  for (const auto* node : graph->nodes()) {
+    if (node->kind() == torch::jit::prim::Constant ||
+        node->kind() == torch::jit::prim::ListConstruct ||
+        node->kind().toQualString() ==
+            std::string("operator_benchmark::_consume")) {
+      continue;
+    }
+    TORCH_CHECK(
+        op_node == nullptr,
+        "The C++ backend only runs the benchmarks of a single operator, but "
+        "the forward runs ", op_node->kind().toQualString(), " and ",
+        node->kind().toQualString());
+    op_node = node;
+  }
+  TORCH_CHECK(op_node != nullptr, "The forward doesn't run any operator");
+  TORCH_CHECK(
+      op_node->maybeSchema() != nullptr,
+      op_node->kind().toQualString(), " has no schema");
+  const auto& schema = op_node->schema();
+  const auto op = c10::Dispatcher::singleton().findSchema(
+      {schema.name(), schema.overload_name()});
+  TORCH_CHECK(
+      op.has_value(),
+      schema.name(), ".", schema.overload_name(),
+      " isn't registered with the dispatcher");
+
+  torch::jit::Stack inputs;
+  for (const auto* input : op_node->inputs()) {
+    auto value = torch::jit::toIValue(input);
+    if (!value && input->node()->kind() == torch::jit::prim::ListConstruct) {
+      auto list = torch::jit::runNodeIfInputsAreConstant(input->node());
+      if (list) {
+        value = list->at(0);
+      }
+    }
+    TORCH_CHECK(
+        value.has_value(),
+        "The inputs of ", schema.name(), " must be constants of the trace");
+    TORCH_CHECK(
+        is_cpu(*value), "The C++ backend only runs operators on CPU tensors");
+    inputs.push_back(std::move(*value));
+  }
+
+  int64_t bytes = 0;
+  PerfCounters counters;
+  std::chrono::steady_clock::time_point start, end;
+  {
+    py::gil_scoped_release no_gil;
+    torch::jit::Stack stack;
+    for (const auto& input : inputs) {
+      bytes += tensor_bytes(input);
+    }
+    stack = inputs;
+    op->callBoxed(&stack);
+    for (const auto& output : stack) {
+      bytes += tensor_bytes(output);
+    }
+    for (int64_t i = 0; i < warmup_iters; i++) {
+      stack = inputs;
+      op->callBoxed(&stack);
+    }
+
+    counters.start();
+    start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < iters; i++) {
+      stack = inputs;
+      op->callBoxed(&stack);
+    }
+    end = std::chrono::steady_clock::now();
+    counters.stop();
+  }
+
+  auto per_iter = [&](int64_t value) {
+    return value < 0 ? -1.0 : static_cast<double>(value) / iters;
+  };
+  py::dict result;
+  result["op"] = schema.name() +
+      (schema.overload_name().empty() ? "" : "." + schema.overload_name());
+  result["time_us"] =
+      std::chrono::duration<double, std::micro>(end - start).count() / iters;
+  result["cycles"] = per_iter(counters.value(PerfCounters::kCycles));
+  result["instructions"] =
+      per_iter(counters.value(PerfCounters::kInstructions));
+  result["llc_misses"] = per_iter(counters.value(PerfCounters::kLLCMisses));
+  // The bytes of the inputs and outputs, the least memory traffic.
+  result["bytes"] = bytes;
+  return result;
+}
+
+} // namespace
+
 PYBIND11_MODULE(cpp_extension, m) {
   m.def("_consume", &consume, "consume");
+  m.def(
+      "_benchmark_traced_op",
+      &benchmark_traced_op,
+      "Runs the operator of a traced forward through the dispatcher",
+      py::arg("graph"),
+      py::arg("iters"),
+      py::arg("warmup_iters") = 0);
 }
@@ -0,0 +1,72 @@
+import torch
+import time
+import argparse
+
+NUM_REPEATS = 1000
+NUM_REPEAT_OF_REPEATS = 1000
+
+
+def bench(fn):
+    bench_times = []
+    for _ in range(NUM_REPEAT_OF_REPEATS):
+        time_start = time.time()
+        for _ in range(NUM_REPEATS):
+            fn()
+        bench_times.append(time.time() - time_start)
+
+    bench_time = float(torch.min(torch.Tensor(bench_times))) / 1000
+    bench_std = float(torch.std(torch.Tensor(bench_times))) / 1000
+
+    return bench_time, bench_std
+
+
+def main():
+    global NUM_REPEATS
+    global NUM_REPEAT_OF_REPEATS
+
+    parser = argparse.ArgumentParser(
+        description="Run the argument parsing benchmarks."
+    )
+    parser.add_argument(
+        "--nreps",
+        "-n",
+        type=int,
+        default=NUM_REPEATS,
+        help="The number of repeats for one measurement.",
+    )
+    parser.add_argument(
+        "--nrepreps",
+        "-m",
+        type=int,
+        default=NUM_REPEAT_OF_REPEATS,
+        help="The number of measurements.",
+    )
+    args = parser.parse_args()
+
+    NUM_REPEATS = args.nreps
+    NUM_REPEAT_OF_REPEATS = args.nrepreps
+
+    x = torch.ones(1)
+    y = torch.ones(1)
+
+    # Each of these binds to an overload which isn't the first one tried.
+    cases = [
+        ("x.add(y)", lambda: x.add(y)),
+        ("x.add(1)", lambda: x.add(1)),
+        ("x.mul(y)", lambda: x.mul(y)),
+        ("torch.add(x, y)", lambda: torch.add(x, y)),
+        ("torch.add(x, y, alpha=2)", lambda: torch.add(x, y, alpha=2)),
+    ]
+
+    for name, fn in cases:
+        bench_min, bench_std = bench(fn)
+        print(
+            "{0} had a minimum time of {1} us"
+            " and a standard deviation of {2} us.".format(
+                name, bench_min, bench_std
+            )
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -6,11 +6,11 @@ import torch.autograd.profiler as profiler
 for with_cuda in [False, True]:
     model = models.resnet18()
     inputs = torch.randn(5, 3, 224, 224)
-    sort_key = "self_cpu_memory_usage"
+    sort_key = "cpu_memory_peak"
     if with_cuda and torch.cuda.is_available():
         model = model.cuda()
         inputs = inputs.cuda()
-        sort_key = "self_cuda_memory_usage"
+        sort_key = "cuda_memory_peak"
         print("Profiling CUDA Resnet model")
     else:
         print("Profiling CPU Resnet model")
@@ -20,3 +20,5 @@ for with_cuda in [False, True]:
             model(inputs)
 
     print(prof.key_averages(group_by_input_shape=True).table(sort_by=sort_key, row_limit=-1))
+    # The allocations over time, along the ops
+    prof.export_chrome_trace("resnet_memory_{}.json".format("cuda" if inputs.is_cuda else "cpu"))
@@ -0,0 +1,48 @@
+import torch
+from pyarkbench import Benchmark, Timer, default_args
+
+
+class Model(torch.nn.Module):
+    def __init__(self, num_tensors, size):
+        super(Model, self).__init__()
+        self.params = torch.nn.ParameterList(
+            [torch.nn.Parameter(torch.ones(size, size)) for i in range(num_tensors)])
+
+    def forward(self, x):
+        for p in self.params:
+            x = x + p
+        return x
+
+
+class ParallelLoad(Benchmark):
+    """Loads archives with many tensor records, torch.jit.load reads them on
+    the inter-op threads"""
+
+    def benchmark(self):
+        results = {}
+        for name, num_tensors, size in (("Big", 32, 1024), ("Small", 2000, 16)):
+            m = torch.jit.script(Model(num_tensors, size))
+            torch.jit.save(m, "parallel_load.pt")
+            with Timer() as jit_load:
+                torch.jit.load("parallel_load.pt")
+            with Timer() as jit_load_mmap:
+                torch.jit.load("parallel_load.pt", mmap=True)
+
+            torch.save(m.state_dict(), "parallel_load.zip")
+            with Timer() as load:
+                torch.load("parallel_load.zip")
+            with Timer() as load_mmap:
+                torch.load("parallel_load.zip", mmap=True)
+
+            results[name + " Tensors jit.load"] = jit_load.ms_duration
+            results[name + " Tensors jit.load mmap"] = jit_load_mmap.ms_duration
+            results[name + " Tensors load"] = load.ms_duration
+            results[name + " Tensors load mmap"] = load_mmap.ms_duration
+        return results
+
+
+if __name__ == '__main__':
+    print("Inter-op threads:", torch.get_num_interop_threads())
+    bench = ParallelLoad(*default_args.bench())
+    results = bench.run()
+    bench.print_stats(results, stats=['mean', 'median'])
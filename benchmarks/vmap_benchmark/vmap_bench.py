@@ -0,0 +1,79 @@
+import argparse
+import timeit
+import torch
+import torch.nn.functional as F
+from torch import vmap
+
+# Compares vmap against running the function on every example in a Python
+# loop, for ops that have batching rules.
+
+
+def loop(func, in_dims):
+    def wrapped(*args):
+        batch_size = next(arg.size(dim) for arg, dim in zip(args, in_dims) if dim is not None)
+        return torch.stack([
+            func(*[arg if dim is None else arg.select(dim, idx) for arg, dim in zip(args, in_dims)])
+            for idx in range(batch_size)
+        ])
+    return wrapped
+
+
+def prepare_cases(batch_size):
+    weight = torch.randn(64, 64)
+    conv_weight = torch.randn(16, 8, 3, 3)
+    table = torch.randn(1000, 32)
+    return {
+        'pointwise': (
+            lambda x, y: (x * y + x).tanh(),
+            (torch.randn(batch_size, 128), torch.randn(batch_size, 128)), (0, 0)),
+        'sum': (
+            lambda x: x.sum(-1).mean(),
+            (torch.randn(batch_size, 32, 32),), (0,)),
+        'mm': (
+            lambda x: x.mm(weight),
+            (torch.randn(batch_size, 16, 64),), (0,)),
+        'per_example_mm': (
+            lambda x, w: x.mm(w),
+            (torch.randn(batch_size, 16, 64), torch.randn(batch_size, 64, 64)), (0, 0)),
+        'dot': (
+            torch.dot,
+            (torch.randn(batch_size, 256), torch.randn(batch_size, 256)), (0, 0)),
+        'conv2d': (
+            lambda x: F.conv2d(x, conv_weight, padding=1),
+            (torch.randn(batch_size, 4, 8, 16, 16),), (0,)),
+        'per_example_conv2d': (
+            lambda x, w: F.conv2d(x, w, padding=1),
+            (torch.randn(batch_size, 4, 8, 16, 16), torch.randn(batch_size, 16, 8, 3, 3)), (0, 0)),
+        'embedding': (
+            lambda idx: F.embedding(idx, table),
+            (torch.randint(1000, (batch_size, 20)),), (0,)),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark vmap against a Python loop')
+    parser.add_argument('--batch-size', type=int, default=64)
+    parser.add_argument('--repeats', type=int, default=20)
+    parser.add_argument('--num-threads', type=int, default=1)
+    parser.add_argument('--cases', nargs='*', default=None)
+    args = parser.parse_args()
+
+    torch.set_num_threads(args.num_threads)
+    cases = prepare_cases(args.batch_size)
+    names = args.cases if args.cases else list(cases.keys())
+
+    print('{:>20} {:>12} {:>12} {:>8}'.format('case', 'loop (ms)', 'vmap (ms)', 'speedup'))
+    for name in names:
+        func, inputs, in_dims = cases[name]
+        batched = vmap(func, in_dims)
+        looped = loop(func, in_dims)
+        assert torch.allclose(batched(*inputs), looped(*inputs), rtol=1e-4, atol=1e-4)
+
+        loop_time = min(timeit.repeat(lambda: looped(*inputs), number=1, repeat=args.repeats)) * 1e3
+        vmap_time = min(timeit.repeat(lambda: batched(*inputs), number=1, repeat=args.repeats)) * 1e3
+        print('{:>20} {:>12.3f} {:>12.3f} {:>7.1f}x'.format(
+            name, loop_time, vmap_time, loop_time / vmap_time))
+
+
+if __name__ == '__main__':
+    main()
@@ -16,6 +16,9 @@
 
 #include "benchmark/benchmark.h"
 
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/core/impl/SlabAllocator.h>
 #include <c10/util/Logging.h>
 
 #if defined(__GNUC__)
@@ -55,4 +58,43 @@ static void BM_NoAPILogging(benchmark::State& state) {
 }
 BENCHMARK(BM_NoAPILogging);
 
+// Metadata allocated for every op result: a StorageImpl and a TensorImpl with
+// four dims (sizes/strides of up to five dims live inline in the TensorImpl).
+static void BM_TensorImplCreation(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto storage = c10::make_intrusive<c10::StorageImpl>(
+        c10::StorageImpl::use_byte_size_t(),
+        0,
+        c10::GetCPUAllocator(),
+        true);
+    auto impl = c10::make_intrusive<c10::TensorImpl>(
+        c10::Storage(std::move(storage)),
+        c10::DispatchKey::CPU,
+        caffe2::TypeMeta::Make<float>());
+    impl->set_sizes_contiguous({1, 2, 3, 4});
+    benchmark::DoNotOptimize(impl.get());
+  }
+}
+BENCHMARK(BM_TensorImplCreation);
+
+static void BM_SlabAllocate(benchmark::State& state) {
+  const size_t size = state.range(0);
+  while (state.KeepRunning()) {
+    void* ptr = c10::impl::slab_allocate(size);
+    benchmark::DoNotOptimize(ptr);
+    c10::impl::slab_deallocate(ptr, size);
+  }
+}
+BENCHMARK(BM_SlabAllocate)->Arg(sizeof(c10::StorageImpl))->Arg(sizeof(c10::TensorImpl));
+
+static void BM_OperatorNew(benchmark::State& state) {
+  const size_t size = state.range(0);
+  while (state.KeepRunning()) {
+    void* ptr = ::operator new(size);
+    benchmark::DoNotOptimize(ptr);
+    ::operator delete(ptr);
+  }
+}
+BENCHMARK(BM_OperatorNew)->Arg(sizeof(c10::StorageImpl))->Arg(sizeof(c10::TensorImpl));
+
 BENCHMARK_MAIN();
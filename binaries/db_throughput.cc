@@ -32,16 +32,39 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_int(
+    num_parallel_cursor_threads,
+    0,
+    "If positive, read the db with a ParallelCursor using this many threads, "
+    "each reading its own range of keys ahead of the test.");
+C10_DEFINE_int(
+    readahead,
+    16,
+    "The number of chunks the ParallelCursor reads ahead.");
+C10_DEFINE_int(
+    read_chunk_size,
+    32,
+    "The number of records in a chunk of the ParallelCursor.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
 using caffe2::db::DBReader;
+using caffe2::db::ParallelCursor;
 using caffe2::string;
 
 void TestThroughputWithDB() {
   std::unique_ptr<DB> in_db(caffe2::db::CreateDB(
       FLAGS_input_db_type, FLAGS_input_db, caffe2::db::READ));
-  std::unique_ptr<Cursor> cursor(in_db->NewCursor());
+  std::unique_ptr<Cursor> cursor;
+  if (FLAGS_num_parallel_cursor_threads > 0) {
+    cursor.reset(new ParallelCursor(
+        in_db.get(),
+        FLAGS_num_parallel_cursor_threads,
+        FLAGS_readahead,
+        FLAGS_read_chunk_size));
+  } else {
+    cursor = in_db->NewCursor();
+  }
   for (int iter_id = 0; iter_id < FLAGS_repeat; ++iter_id) {
     caffe2::Timer timer;
     for (int i = 0; i < FLAGS_report_interval; ++i) {
@@ -82,6 +105,12 @@ void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
 
 void TestThroughputWithReader() {
   caffe2::db::DBReader reader(FLAGS_input_db_type, FLAGS_input_db);
+  if (FLAGS_num_parallel_cursor_threads > 0) {
+    reader.ReadInParallel(
+        FLAGS_num_parallel_cursor_threads,
+        FLAGS_readahead,
+        FLAGS_read_chunk_size);
+  }
   std::vector<std::unique_ptr<std::thread>> reading_threads(
       FLAGS_num_read_threads);
   for (int i = 0; i < reading_threads.size(); ++i) {
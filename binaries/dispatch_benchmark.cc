@@ -0,0 +1,76 @@
+#include <torch/torch.h>
+#include <torch/library.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+
+#include "c10/util/Flags.h"
+
+#include <chrono>
+#include <iostream>
+
+C10_DEFINE_int(iter, 1000000, "Number of iterations");
+C10_DEFINE_int(warmup_iter, 10000, "Number of warmup iterations");
+
+// Per op overhead of the dispatcher: a no-op kernel is called through
+// Dispatcher::call and Dispatcher::callCached, and a small add through the
+// whole stack (VariableType, BackendSelect, ...) for reference.
+
+namespace {
+
+at::Tensor noop(const at::Tensor& self) {
+  return self;
+}
+
+TORCH_LIBRARY(_dispatch_bench, m) {
+  m.def("noop(Tensor self) -> Tensor");
+}
+
+TORCH_LIBRARY_IMPL(_dispatch_bench, CPU, m) {
+  m.impl("noop", noop);
+}
+
+template <typename Fn>
+float nsPerCall(Fn fn) {
+  for (auto idx = 0; idx < FLAGS_warmup_iter; ++idx) {
+    fn();
+  }
+  typedef std::chrono::high_resolution_clock clock;
+  typedef std::chrono::nanoseconds ns;
+  std::chrono::time_point<clock> start_time = clock::now();
+  for (auto idx = 0; idx < FLAGS_iter; ++idx) {
+    fn();
+  }
+  auto duration = static_cast<float>(
+      std::chrono::duration_cast<ns>(clock::now() - start_time).count());
+  return duration / FLAGS_iter;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cout << "Failed to parse command line flags" << std::endl;
+    return -1;
+  }
+
+  auto op = c10::Dispatcher::singleton()
+      .findSchemaOrThrow("_dispatch_bench::noop", "")
+      .typed<at::Tensor(const at::Tensor&)>();
+  auto x = torch::ones({1});
+  auto y = torch::ones({1});
+
+  auto call_ns = nsPerCall([&]() { op.call(x); });
+  std::cout << "Dispatcher::call: " << call_ns << " ns per op" << std::endl;
+
+  c10::DispatchCache cache;
+  auto cached_ns = nsPerCall([&]() { op.callCached(cache, x); });
+  std::cout << "Dispatcher::callCached: " << cached_ns << " ns per op" << std::endl;
+
+  {
+    at::AutoNonVariableTypeMode non_var_type_mode(true);
+    auto add_ns = nsPerCall([&]() { at::add(x, y); });
+    std::cout << "at::add (no autograd): " << add_ns << " ns per op" << std::endl;
+  }
+  auto add_ns = nsPerCall([&]() { at::add(x, y); });
+  std::cout << "at::add: " << add_ns << " ns per op" << std::endl;
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "ATen/Parallel.h"
+
+#include "c10/util/Flags.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+C10_DEFINE_int(size, 4096, "Number of loop iterations handed to parallel_for");
+C10_DEFINE_int(grain_size, 1, "parallel_for grain size");
+C10_DEFINE_int(work, 1000, "Average amount of work per iteration");
+C10_DEFINE_int(iter, 100, "Number of parallel_for calls per workload");
+C10_DEFINE_int(warmup_iter, 10, "Number of warmup calls per workload");
+C10_DEFINE_int(intra_op_threads, 0, "Number of intra-op threads");
+
+namespace {
+
+std::vector<double> out;
+
+// Spends roughly `amount` units of work on iteration i.
+inline void do_work(int64_t i, int64_t amount) {
+  double acc = i;
+  for (int64_t k = 0; k < amount; ++k) {
+    acc = std::sqrt(acc + k);
+  }
+  out[i] = acc;
+}
+
+// Every iteration costs the same.
+void uniform(int64_t begin, int64_t end) {
+  for (int64_t i = begin; i < end; ++i) {
+    do_work(i, FLAGS_work);
+  }
+}
+
+// Cost grows linearly with the index, like the rows of a triangular matrix.
+void triangular(int64_t begin, int64_t end) {
+  for (int64_t i = begin; i < end; ++i) {
+    do_work(i, 2 * FLAGS_work * i / FLAGS_size);
+  }
+}
+
+// A few iterations carry almost all of the work, like a ragged batch.
+void ragged(int64_t begin, int64_t end) {
+  for (int64_t i = begin; i < end; ++i) {
+    do_work(i, i % 64 == 0 ? 64 * FLAGS_work : 1);
+  }
+}
+
+template <typename F>
+void run(const char* name, const F& f) {
+  typedef std::chrono::high_resolution_clock clock;
+  typedef std::chrono::microseconds us;
+
+  for (auto i = 0; i < FLAGS_warmup_iter; ++i) {
+    at::parallel_for(0, FLAGS_size, FLAGS_grain_size, f);
+  }
+  auto start_time = clock::now();
+  for (auto i = 0; i < FLAGS_iter; ++i) {
+    at::parallel_for(0, FLAGS_size, FLAGS_grain_size, f);
+  }
+  auto duration = static_cast<float>(
+      std::chrono::duration_cast<us>(clock::now() - start_time).count());
+  std::cout << name << ": " << (duration / FLAGS_iter) << " us per call"
+            << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cout << "Failed to parse command line flags" << std::endl;
+    return -1;
+  }
+  at::init_num_threads();
+  if (FLAGS_intra_op_threads > 0) {
+    at::set_num_threads(FLAGS_intra_op_threads);
+  }
+  out.resize(FLAGS_size);
+
+  std::cout << at::get_parallel_info() << std::endl;
+  run("uniform", uniform);
+  run("triangular", triangular);
+  run("ragged", ragged);
+  return 0;
+}
@@ -0,0 +1,334 @@
+/**
+ * Sweeps the intra-op threads, inter-op threads and the number of model
+ * instances (concurrent callers) for a TorchScript model, reports the
+ * throughput and latency of every configuration along with the Pareto optimal
+ * ones, and writes the chosen configuration into a file that
+ * at::init_num_threads reads at startup when ATEN_THREAD_CONFIG points to it.
+ *
+ * The inter-op thread pool can't be resized once created, so every
+ * configuration is measured in a fresh process: the tuner runs itself with
+ * the --trial_* flags set and parses the result line the trial prints.
+ */
+
+#include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+#include "c10/util/Flags.h"
+#include "c10/util/numa.h"
+#include "torch/csrc/autograd/grad_mode.h"
+#include "torch/script.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+C10_DEFINE_string(model, "", "The TorchScript model to tune.");
+C10_DEFINE_string(
+    input_dims,
+    "",
+    "The dimensions of the inputs of the model, as comma separated numbers, "
+    "with a semicolon between the inputs.");
+C10_DEFINE_string(
+    input_type,
+    "",
+    "The types of the inputs (float/int64/uint8_t), with a semicolon between "
+    "the inputs.");
+C10_DEFINE_string(
+    intra_op_threads,
+    "",
+    "Comma separated intra-op thread counts to try. Defaults to the powers of "
+    "two up to the number of cores.");
+C10_DEFINE_string(
+    inter_op_threads,
+    "1,2,4",
+    "Comma separated inter-op thread counts to try.");
+C10_DEFINE_string(
+    instances,
+    "",
+    "Comma separated numbers of model instances (concurrent callers) to try. "
+    "Defaults to the powers of two up to the number of cores. The instances "
+    "are spread over the NUMA nodes when NUMA is enabled.");
+C10_DEFINE_bool(
+    oversubscribe,
+    false,
+    "Also try the configurations which use more threads than cores.");
+C10_DEFINE_int(warmup, 10, "The number of warmup iterations per instance.");
+C10_DEFINE_int(iter, 100, "The number of iterations per instance.");
+C10_DEFINE_double(
+    max_p99_ms,
+    0,
+    "If positive, the configuration written is the one with the highest "
+    "throughput among those with a p99 latency under this budget.");
+C10_DEFINE_string(
+    output,
+    "thread_config.txt",
+    "The file the chosen configuration is written to.");
+C10_DEFINE_int(trial_intra_op_threads, 0, "Internal: runs a single trial.");
+C10_DEFINE_int(trial_inter_op_threads, 0, "Internal: runs a single trial.");
+C10_DEFINE_int(trial_instances, 0, "Internal: runs a single trial.");
+
+namespace {
+
+const char* kTrialResult = "TRIAL_RESULT";
+
+struct Trial {
+  int intra_op_threads;
+  int inter_op_threads;
+  int instances;
+  double throughput{0};
+  double latency_p50_ms{0};
+  double latency_p99_ms{0};
+};
+
+std::vector<std::string> split(char separator, const std::string& string) {
+  std::vector<std::string> pieces;
+  std::stringstream ss(string);
+  std::string item;
+  while (getline(ss, item, separator)) {
+    if (!item.empty()) {
+      pieces.push_back(std::move(item));
+    }
+  }
+  return pieces;
+}
+
+std::vector<int> parse_counts(const std::string& counts, int max_count) {
+  std::vector<int> values;
+  if (counts.empty()) {
+    for (int value = 1; value <= max_count; value *= 2) {
+      values.push_back(value);
+    }
+    return values;
+  }
+  for (const auto& count : split(',', counts)) {
+    values.push_back(c10::stoi(count));
+    TORCH_CHECK(
+        values.back() > 0, "Thread and instance counts must be positive");
+  }
+  return values;
+}
+
+std::vector<c10::IValue> create_inputs() {
+  const auto dims_list = split(';', FLAGS_input_dims);
+  const auto type_list = split(';', FLAGS_input_type);
+  TORCH_CHECK(
+      dims_list.size() == type_list.size(),
+      "Input dims and type should have the same number of items.");
+  std::vector<c10::IValue> inputs;
+  for (size_t i = 0; i < dims_list.size(); ++i) {
+    std::vector<int64_t> dims;
+    for (const auto& dim : split(',', dims_list[i])) {
+      dims.push_back(c10::stoi(dim));
+    }
+    at::ScalarType type;
+    if (type_list[i] == "float") {
+      type = at::kFloat;
+    } else if (type_list[i] == "int64") {
+      type = at::kLong;
+    } else if (type_list[i] == "uint8_t") {
+      type = at::kByte;
+    } else {
+      TORCH_CHECK(false, "Unsupported input type: ", type_list[i]);
+    }
+    inputs.push_back(at::ones(dims, at::TensorOptions(type)));
+  }
+  return inputs;
+}
+
+// Measures the configuration set by the --trial_* flags in this process.
+int run_trial() {
+  at::set_num_interop_threads(FLAGS_trial_inter_op_threads);
+  at::set_num_threads(FLAGS_trial_intra_op_threads);
+  torch::autograd::AutoGradMode no_grad(false);
+  auto module = torch::jit::load(FLAGS_model);
+  module.eval();
+  const auto inputs = create_inputs();
+
+  const int instances = FLAGS_trial_instances;
+  std::vector<std::vector<double>> latencies(instances);
+  std::vector<std::thread> callers;
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  for (int i = 0; i < instances; ++i) {
+    callers.emplace_back([&, i]() {
+      if (c10::IsNUMAEnabled()) {
+        c10::NUMABind(i % c10::GetNumNUMANodes());
+      }
+      at::init_num_threads();
+      torch::autograd::AutoGradMode no_grad(false);
+      for (int j = 0; j < FLAGS_warmup; ++j) {
+        module.forward(inputs);
+      }
+      for (int j = 0; j < FLAGS_iter; ++j) {
+        const auto iter_start = Clock::now();
+        module.forward(inputs);
+        latencies[i].push_back(
+            std::chrono::duration<double, std::milli>(Clock::now() - iter_start)
+                .count());
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  const double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::vector<double> all;
+  for (const auto& instance_latencies : latencies) {
+    all.insert(all.end(), instance_latencies.begin(), instance_latencies.end());
+  }
+  std::sort(all.begin(), all.end());
+  TORCH_CHECK(!all.empty(), "--iter must be positive");
+  auto percentile = [&](double p) {
+    return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+  };
+  // The warmup iterations are included in the wall time, so the throughput is
+  // slightly underestimated by the same ratio for every configuration.
+  const double throughput =
+      instances * (FLAGS_warmup + FLAGS_iter) / seconds;
+  std::cout << kTrialResult << " " << throughput << " " << percentile(0.5)
+            << " " << percentile(0.99) << std::endl;
+  return 0;
+}
+
+bool run_in_subprocess(const char* self, Trial& trial) {
+  std::ostringstream cmd;
+  cmd << "\"" << self << "\""
+      << " --model=\"" << FLAGS_model << "\""
+      << " --input_dims=\"" << FLAGS_input_dims << "\""
+      << " --input_type=\"" << FLAGS_input_type << "\""
+      << " --warmup=" << FLAGS_warmup << " --iter=" << FLAGS_iter
+      << " --trial_intra_op_threads=" << trial.intra_op_threads
+      << " --trial_inter_op_threads=" << trial.inter_op_threads
+      << " --trial_instances=" << trial.instances;
+  FILE* pipe = popen(cmd.str().c_str(), "r");
+  if (pipe == nullptr) {
+    return false;
+  }
+  bool found = false;
+  char line[1024];
+  while (fgets(line, sizeof(line), pipe) != nullptr) {
+    std::istringstream ss(line);
+    std::string tag;
+    ss >> tag;
+    if (tag == kTrialResult) {
+      found = static_cast<bool>(
+          ss >> trial.throughput >> trial.latency_p50_ms >>
+          trial.latency_p99_ms);
+    }
+  }
+  return pclose(pipe) == 0 && found;
+}
+
+// A trial is Pareto optimal if no other trial has both a higher throughput
+// and a lower p99 latency.
+bool is_pareto_optimal(const Trial& trial, const std::vector<Trial>& trials) {
+  for (const auto& other : trials) {
+    if (other.throughput >= trial.throughput &&
+        other.latency_p99_ms <= trial.latency_p99_ms &&
+        (other.throughput > trial.throughput ||
+         other.latency_p99_ms < trial.latency_p99_ms)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  c10::SetUsageMessage(
+      "Tunes the threading configuration of a TorchScript model.\n"
+      "Example usage:\n"
+      "./thread_config_tuner"
+      " --model=<model_file>"
+      " --input_dims=1,3,224,224"
+      " --input_type=float"
+      " --max_p99_ms=20"
+      " --output=thread_config.txt");
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cerr << "Failed to parse command line flags!" << std::endl;
+    return 1;
+  }
+  TORCH_CHECK(!FLAGS_model.empty(), "--model must be given");
+  if (FLAGS_trial_instances > 0) {
+    return run_trial();
+  }
+
+  const int cores =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  std::vector<Trial> trials;
+  for (int intra : parse_counts(FLAGS_intra_op_threads, cores)) {
+    for (int inter : parse_counts(FLAGS_inter_op_threads, cores)) {
+      for (int instances : parse_counts(FLAGS_instances, cores)) {
+        if (!FLAGS_oversubscribe && intra * instances > cores) {
+          continue;
+        }
+        Trial trial{intra, inter, instances};
+        if (!run_in_subprocess(argv[0], trial)) {
+          std::cerr << "Trial with " << intra << " intra-op threads, " << inter
+                    << " inter-op threads and " << instances
+                    << " instances failed" << std::endl;
+          continue;
+        }
+        trials.push_back(trial);
+      }
+    }
+  }
+  if (trials.empty()) {
+    std::cerr << "No configuration could be measured" << std::endl;
+    return 1;
+  }
+
+  std::cout << std::setw(8) << "intra" << std::setw(8) << "inter"
+            << std::setw(11) << "instances" << std::setw(14) << "iters/sec"
+            << std::setw(12) << "p50 (ms)" << std::setw(12) << "p99 (ms)"
+            << "  pareto" << std::endl;
+  const Trial* best = nullptr;
+  for (const auto& trial : trials) {
+    const bool pareto = is_pareto_optimal(trial, trials);
+    std::cout << std::setw(8) << trial.intra_op_threads << std::setw(8)
+              << trial.inter_op_threads << std::setw(11) << trial.instances
+              << std::setw(14) << std::fixed << std::setprecision(1)
+              << trial.throughput << std::setw(12) << std::setprecision(3)
+              << trial.latency_p50_ms << std::setw(12) << trial.latency_p99_ms
+              << (pareto ? "  *" : "") << std::endl;
+    const bool in_budget =
+        FLAGS_max_p99_ms <= 0 || trial.latency_p99_ms <= FLAGS_max_p99_ms;
+    if (pareto && in_budget &&
+        (best == nullptr || trial.throughput > best->throughput)) {
+      best = &trial;
+    }
+  }
+  if (best == nullptr) {
+    std::cerr << "No configuration meets the p99 budget of " << FLAGS_max_p99_ms
+              << " ms" << std::endl;
+    return 1;
+  }
+
+  std::ofstream output(FLAGS_output);
+  output << "# Written by thread_config_tuner for " << FLAGS_model << "\n"
+         << "# Point ATEN_THREAD_CONFIG to this file to apply it.\n"
+         << "intra_op_threads=" << best->intra_op_threads << "\n"
+         << "inter_op_threads=" << best->inter_op_threads << "\n"
+         << "# Not read by ATen: the number of model instances to serve.\n"
+         << "instances=" << best->instances << "\n";
+  TORCH_CHECK(output.good(), "Error writing ", FLAGS_output);
+  std::cout << "Wrote the configuration with " << best->intra_op_threads
+            << " intra-op threads, " << best->inter_op_threads
+            << " inter-op threads and " << best->instances << " instances to "
+            << FLAGS_output << std::endl;
+  return 0;
+}
@@ -2,6 +2,8 @@
 
 #include <benchmark/benchmark.h>
 #include <memory>
+#include <thread>
+#include <vector>
 
 using c10::intrusive_ptr;
 using c10::intrusive_ptr_target;
@@ -32,6 +34,35 @@ static void BM_IntrusivePtrCtorDtor(benchmark::State& state) {
 }
 BENCHMARK(BM_IntrusivePtrCtorDtor);
 
+// With USE_BIASED_REFCOUNT, only the thread that created an object gets the
+// non-atomic fast path; this measures the cost for every other thread.
+static void BM_IntrusivePtrCtorDtorOtherThread(benchmark::State& state) {
+  intrusive_ptr<Foo> var;
+  std::thread([&var]() { var = make_intrusive<Foo>(0); }).join();
+  while (state.KeepRunning()) {
+    volatile intrusive_ptr<Foo> var2 = var;
+  }
+}
+BENCHMARK(BM_IntrusivePtrCtorDtorOtherThread);
+
+// Hands an object to another thread and drops it there, which is the slow
+// path for biased refcounting.
+static void BM_IntrusivePtrHandoff(benchmark::State& state) {
+  const size_t kLength = state.range(0);
+  std::vector<intrusive_ptr<Foo> > vararray(kLength);
+  while (state.KeepRunning()) {
+    for (int i = 0; i < kLength; ++i) {
+      vararray[i] = make_intrusive<Foo>(i);
+    }
+    std::thread([&vararray]() {
+      for (auto& var : vararray) {
+        var.reset();
+      }
+    }).join();
+  }
+}
+BENCHMARK(BM_IntrusivePtrHandoff)->RangeMultiplier(8)->Range(16, 4096);
+
 static void BM_SharedPtrCtorDtor(benchmark::State& state) {
   std::shared_ptr<Bar> var = std::make_shared<Bar>(0);
   while (state.KeepRunning()) {
@@ -69,6 +100,25 @@ static void BM_SharedPtrArray(benchmark::State& state) {
   }
 }
 BENCHMARK(BM_SharedPtrArray)->RangeMultiplier(2)->Range(16, 4096);
+
+// Pushes copies of a handful of objects onto a vector that is reused, like
+// the JIT interpreter stack does.
+static void BM_IntrusivePtrStack(benchmark::State& state) {
+  std::vector<intrusive_ptr<Foo> > vars;
+  for (int i = 0; i < 4; ++i) {
+    vars.push_back(make_intrusive<Foo>(i));
+  }
+  const size_t kLength = state.range(0);
+  std::vector<intrusive_ptr<Foo> > stack;
+  stack.reserve(kLength);
+  while (state.KeepRunning()) {
+    for (int i = 0; i < kLength; ++i) {
+      stack.push_back(vars[i % vars.size()]);
+    }
+    stack.clear();
+  }
+}
+BENCHMARK(BM_IntrusivePtrStack)->RangeMultiplier(8)->Range(16, 4096);
 } // namespace
 
 
@@ -19,6 +19,14 @@ C10_DEFINE_bool(
 
 namespace c10 {
 
+namespace {
+
+// Allocations smaller than this are never split across NUMA nodes: they are
+// too small for the per-node slabs to line up with intra-op chunks anyway.
+constexpr size_t kNUMAPartitionMinBytes = 1048576;
+
+} // namespace
+
 void memset_junk(void* data, size_t num) {
   // This garbage pattern is NaN when interpreted as floating point values,
   // or as very large integer values.
@@ -71,8 +79,14 @@ void* alloc_cpu(size_t nbytes) {
       nbytes,
       " bytes. Buy new RAM!");
 
-  // move data to a thread's NUMA node
-  NUMAMove(data, nbytes, GetCurrentNUMANode());
+  if (nbytes >= kNUMAPartitionMinBytes && IsNUMAPartitioned()) {
+    // spread data over all NUMA nodes, matching how parallel_for assigns
+    // chunks to nodes
+    NUMAMovePartitioned(data, nbytes);
+  } else {
+    // move data to a thread's NUMA node
+    NUMAMove(data, nbytes, GetCurrentNUMANode());
+  }
   CHECK(
       !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
       !FLAGS_caffe2_cpu_allocator_do_junk_fill)
@@ -152,8 +166,15 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
     if (C10_UNLIKELY(!pointer)) {
       return;
     }
-    // TODO: enable with better TLS support on mobile
-    // profiledCPUMemoryReporter().Delete(pointer);
+    if (PreGuardBytes >= sizeof(int64_t)) {
+      const int64_t nbytes = *static_cast<const int64_t*>(pointer);
+      if (C10_UNLIKELY(nbytes != 0)) {
+        reportMemoryUsageToProfiler(
+            static_cast<uint8_t*>(pointer) + PreGuardBytes,
+            -nbytes,
+            c10::Device(c10::DeviceType::CPU));
+      }
+    }
     c10::free_cpu(pointer);
   }
 
@@ -169,7 +190,21 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
 
     auto alloc_size = PreGuardBytes + nbytes + PostGuardBytes;
     void* const data = c10::alloc_cpu(alloc_size);
-    //  profiledCPUMemoryReporter().New(data, alloc_size);
+    // Instead of the locked table of profiledCPUMemoryReporter, the size of
+    // the allocations reported to the memory profiler is kept in their
+    // pre-guard bytes for the deleter, and 0 for the others. QNNPACK only
+    // reads, and ignores, the last 8 of these bytes.
+    if (PreGuardBytes >= sizeof(int64_t)) {
+      int64_t reported_bytes = 0;
+      if (C10_UNLIKELY(memoryProfilingEnabled())) {
+        reported_bytes = nbytes;
+        reportMemoryUsageToProfiler(
+            reinterpret_cast<uint8_t*>(data) + PreGuardBytes,
+            reported_bytes,
+            c10::Device(c10::DeviceType::CPU));
+      }
+      *static_cast<int64_t*>(data) = reported_bytes;
+    }
     return {
         reinterpret_cast<uint8_t*>(data) + PreGuardBytes,
         data,
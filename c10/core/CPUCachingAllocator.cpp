@@ -0,0 +1,552 @@
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/DeviceType.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace c10 {
+namespace CPUCachingAllocator {
+
+//
+// Size-class caching allocator for CPU memory.
+//
+// - Requests are rounded up to a size class. Classes are spaced four per
+//   power of two, so at most 25% of a block is wasted by rounding.
+// - Every block is prefixed by a gAlignment-sized header recording its size
+//   class, so the deleter can find the right free list without any lookup.
+//   The pointer handed to the client is the one right after the header;
+//   DataPtr's data and context are the same pointer, which keeps
+//   raw_allocate()/raw_deleter() working.
+// - Freed blocks go on the calling thread's free list. Once a thread holds
+//   more than kMaxThreadCacheBytes of cached blocks, further frees spill into
+//   the global pool. Allocations that miss the thread cache try the global
+//   pool before falling back to alloc_cpu().
+// - If alloc_cpu() fails, every cached block is released and the allocation
+//   is retried once.
+// - Blocks larger than kMaxCachedSize bypass the cache entirely.
+//
+
+namespace {
+
+constexpr size_t kMinBlockShift = 6;              // smallest size class is 64 bytes
+constexpr size_t kMinBlockSize = 1 << kMinBlockShift;
+constexpr size_t kMaxCachedShift = 28;            // largest cached size class is 256 MiB
+constexpr size_t kMaxCachedSize = size_t(1) << kMaxCachedShift;
+constexpr size_t kClassesPerPow2Shift = 2;        // four size classes per power of two
+constexpr size_t kNumSizeClasses =
+    1 + ((kMaxCachedShift - kMinBlockShift) << kClassesPerPow2Shift);
+constexpr size_t kSmallSize = 1048576;            // largest "small" allocation is 1 MiB
+constexpr size_t kMaxThreadCacheBytes = 67108864; // a thread caches at most 64 MiB
+constexpr size_t kHeaderSize = gAlignment;
+
+static_assert(
+    sizeof(size_t) <= kHeaderSize,
+    "block header must fit in the alignment padding");
+
+typedef std::array<std::vector<void*>, kNumSizeClasses> FreeLists;
+
+inline size_t floor_log2(size_t x) {
+#if defined(_MSC_VER)
+  size_t result = 0;
+  while (x >>= 1) {
+    ++result;
+  }
+  return result;
+#else
+  return (sizeof(unsigned long long) * 8 - 1) -
+      __builtin_clzll(static_cast<unsigned long long>(x));
+#endif
+}
+
+// Rounds nbytes up to the size of its class.
+inline size_t round_size(size_t nbytes) {
+  if (nbytes <= kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  const size_t step_shift = floor_log2(nbytes - 1) - kClassesPerPow2Shift;
+  return ((nbytes + (size_t(1) << step_shift) - 1) >> step_shift) << step_shift;
+}
+
+// Maps a rounded size to its free-list index, or kNumSizeClasses if blocks of
+// this size are not cached.
+inline size_t size_class(size_t size) {
+  if (size <= kMinBlockSize) {
+    return 0;
+  }
+  if (size > kMaxCachedSize) {
+    return kNumSizeClasses;
+  }
+  const size_t log2 = floor_log2(size - 1);
+  const size_t step = (size >> (log2 - kClassesPerPow2Shift)) -
+      (size_t(1) << kClassesPerPow2Shift) - 1;
+  return 1 + ((log2 - kMinBlockShift) << kClassesPerPow2Shift) + step;
+}
+
+inline size_t& block_size(void* data) {
+  return *reinterpret_cast<size_t*>(static_cast<char*>(data) - kHeaderSize);
+}
+
+inline void* block_base(void* data) {
+  return static_cast<char*>(data) - kHeaderSize;
+}
+
+typedef std::bitset<static_cast<size_t>(StatType::NUM_TYPES)> StatTypes;
+
+// Stats are updated from every thread without holding a common lock, so the
+// live copies are atomic and only turned into plain Stat on snapshot.
+struct AtomicStat {
+  std::atomic<int64_t> current{0};
+  std::atomic<int64_t> peak{0};
+  std::atomic<int64_t> allocated{0};
+  std::atomic<int64_t> freed{0};
+};
+
+typedef std::array<AtomicStat, static_cast<size_t>(StatType::NUM_TYPES)>
+    AtomicStatArray;
+
+struct AtomicDeviceStats {
+  AtomicStatArray allocation;
+  AtomicStatArray segment;
+  AtomicStatArray inactive;
+  AtomicStatArray allocated_bytes;
+  AtomicStatArray reserved_bytes;
+  AtomicStatArray inactive_bytes;
+  std::atomic<int64_t> num_alloc_retries{0};
+  std::atomic<int64_t> num_ooms{0};
+  std::atomic<int64_t> num_cache_hits{0};
+};
+
+void update_stat(AtomicStat& stat, int64_t amount) {
+  const int64_t current =
+      stat.current.fetch_add(amount, std::memory_order_relaxed) + amount;
+
+  TORCH_INTERNAL_ASSERT(current >= 0, "Negative tracked stat in CPU allocator (likely logic error).");
+
+  int64_t peak = stat.peak.load(std::memory_order_relaxed);
+  while (current > peak &&
+         !stat.peak.compare_exchange_weak(
+             peak, current, std::memory_order_relaxed)) {
+  }
+  if (amount > 0) {
+    stat.allocated.fetch_add(amount, std::memory_order_relaxed);
+  }
+  if (amount < 0) {
+    stat.freed.fetch_add(-amount, std::memory_order_relaxed);
+  }
+}
+
+void reset_accumulated_stat(AtomicStat& stat) {
+  stat.allocated.store(0, std::memory_order_relaxed);
+  stat.freed.store(0, std::memory_order_relaxed);
+}
+
+void reset_peak_stat(AtomicStat& stat) {
+  stat.peak.store(
+      stat.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void update_stat_array(AtomicStatArray& stat_array, int64_t amount, const StatTypes& stat_types) {
+  for (size_t stat_type = 0; stat_type < stat_types.size(); ++stat_type) {
+    if (stat_types[stat_type]) {
+      update_stat(stat_array[stat_type], amount);
+    }
+  }
+}
+
+void copy_stat_array(StatArray& dst, const AtomicStatArray& src) {
+  for (size_t stat_type = 0; stat_type < dst.size(); ++stat_type) {
+    dst[stat_type].current = src[stat_type].current.load(std::memory_order_relaxed);
+    dst[stat_type].peak = src[stat_type].peak.load(std::memory_order_relaxed);
+    dst[stat_type].allocated = src[stat_type].allocated.load(std::memory_order_relaxed);
+    dst[stat_type].freed = src[stat_type].freed.load(std::memory_order_relaxed);
+  }
+}
+
+StatTypes get_stat_types(size_t size) {
+  StatTypes stat_types;
+  stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+  stat_types[static_cast<size_t>(
+      size <= kSmallSize ? StatType::SMALL_POOL : StatType::LARGE_POOL)] = true;
+  return stat_types;
+}
+
+void fill_block(void* data, size_t nbytes) {
+  if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+    memset(data, 0, nbytes);
+  } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    memset_junk(data, nbytes);
+  }
+}
+
+struct ThreadCache;
+
+} // namespace
+
+class CPUCachingAllocatorImpl {
+ public:
+  // Allocates a block of at least nbytes and returns the client pointer.
+  void* malloc(size_t nbytes);
+
+  // Returns a block obtained from malloc() to the cache.
+  void free(void* data);
+
+  /** returns cached blocks to the system allocator **/
+  void emptyCache();
+
+  DeviceStats getStats() const;
+  void resetAccumulatedStats();
+  void resetPeakStats();
+
+  void register_thread_cache(ThreadCache* cache);
+  void unregister_thread_cache(ThreadCache* cache);
+
+  // Moves a block into the global pool. The block must already be counted as
+  // inactive.
+  void push_global(size_t cls, void* data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    global_blocks_[cls].push_back(data);
+  }
+
+  AtomicDeviceStats stats;
+
+ private:
+  void* pop_global(size_t cls);
+  void* system_alloc(size_t size);
+  void release_block(void* data);
+  void release_blocks(std::vector<void*>& blocks);
+
+  // lock around the global pool and the set of thread caches
+  std::mutex mutex_;
+
+  // cached blocks not owned by any thread
+  FreeLists global_blocks_;
+
+  // every live thread cache, so that emptyCache() can drain them
+  std::unordered_set<ThreadCache*> thread_caches_;
+};
+
+// Leaked on purpose: thread caches flush into it at thread exit and tensors
+// may be freed during static destruction.
+static CPUCachingAllocatorImpl& caching_allocator() {
+  static CPUCachingAllocatorImpl* allocator = new CPUCachingAllocatorImpl();
+  return *allocator;
+}
+
+namespace {
+
+// Per-thread free lists. The owning thread is the only one that allocates
+// from or frees into a cache; the mutex is only ever contended while
+// emptyCache() drains it from another thread.
+struct ThreadCache {
+  ThreadCache() {
+    caching_allocator().register_thread_cache(this);
+  }
+
+  ~ThreadCache() {
+    caching_allocator().unregister_thread_cache(this);
+  }
+
+  void* pop(size_t cls) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& blocks = free_blocks[cls];
+    if (blocks.empty()) {
+      return nullptr;
+    }
+    void* data = blocks.back();
+    blocks.pop_back();
+    cached_bytes -= block_size(data);
+    return data;
+  }
+
+  // Returns false if the cache is over budget and the block was not taken.
+  bool push(size_t cls, void* data) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t size = block_size(data);
+    if (cached_bytes + size > kMaxThreadCacheBytes) {
+      return false;
+    }
+    free_blocks[cls].push_back(data);
+    cached_bytes += size;
+    return true;
+  }
+
+  std::mutex mutex;
+  FreeLists free_blocks;
+  size_t cached_bytes = 0;
+};
+
+// The ThreadCache itself is only reachable through a trivially destructible
+// pointer, so that frees issued after the thread cache has been torn down
+// (e.g. from other thread_local or static destructors) safely fall back to
+// the global pool instead of touching a destroyed object.
+thread_local ThreadCache* tls_cache = nullptr;
+thread_local bool tls_cache_destroyed = false;
+
+struct ThreadCacheHolder {
+  ThreadCacheHolder() : cache(new ThreadCache()) {
+    tls_cache = cache;
+  }
+  ~ThreadCacheHolder() {
+    tls_cache = nullptr;
+    tls_cache_destroyed = true;
+    delete cache;
+  }
+  ThreadCache* cache;
+};
+
+ThreadCache* local_cache() {
+  if (C10_LIKELY(tls_cache != nullptr)) {
+    return tls_cache;
+  }
+  if (tls_cache_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadCacheHolder holder;
+  return holder.cache;
+}
+
+} // namespace
+
+void CPUCachingAllocatorImpl::register_thread_cache(ThreadCache* cache) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  thread_caches_.insert(cache);
+}
+
+void CPUCachingAllocatorImpl::unregister_thread_cache(ThreadCache* cache) {
+  // Lock order is always global mutex first, then the thread cache mutex.
+  std::lock_guard<std::mutex> lock(mutex_);
+  thread_caches_.erase(cache);
+  std::lock_guard<std::mutex> cache_lock(cache->mutex);
+  for (size_t cls = 0; cls < kNumSizeClasses; ++cls) {
+    auto& src = cache->free_blocks[cls];
+    auto& dst = global_blocks_[cls];
+    dst.insert(dst.end(), src.begin(), src.end());
+    src.clear();
+  }
+  cache->cached_bytes = 0;
+}
+
+void* CPUCachingAllocatorImpl::pop_global(size_t cls) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& blocks = global_blocks_[cls];
+  if (blocks.empty()) {
+    return nullptr;
+  }
+  void* data = blocks.back();
+  blocks.pop_back();
+  return data;
+}
+
+void* CPUCachingAllocatorImpl::system_alloc(size_t size) {
+  void* base = nullptr;
+  try {
+    base = alloc_cpu(size + kHeaderSize);
+  } catch (const c10::Error&) {
+    // Release everything we are caching and try once more.
+    stats.num_alloc_retries.fetch_add(1, std::memory_order_relaxed);
+    emptyCache();
+    try {
+      base = alloc_cpu(size + kHeaderSize);
+    } catch (const c10::Error&) {
+      stats.num_ooms.fetch_add(1, std::memory_order_relaxed);
+      throw;
+    }
+  }
+
+  void* data = static_cast<char*>(base) + kHeaderSize;
+  block_size(data) = size;
+
+  const StatTypes stat_types = get_stat_types(size);
+  update_stat_array(stats.segment, 1, stat_types);
+  update_stat_array(stats.reserved_bytes, size, stat_types);
+  return data;
+}
+
+void* CPUCachingAllocatorImpl::malloc(size_t nbytes) {
+  // We might have clowny upstream code that tries to alloc a negative number
+  // of bytes. Let's catch it early.
+  CAFFE_ENFORCE(
+    ((ptrdiff_t)nbytes) >= 0,
+    "CPUCachingAllocator seems to have been called with negative number: ", nbytes);
+
+  const size_t size = round_size(nbytes);
+  const size_t cls = size_class(size);
+  const StatTypes stat_types = get_stat_types(size);
+
+  void* data = nullptr;
+  if (cls < kNumSizeClasses) {
+    ThreadCache* cache = local_cache();
+    if (cache) {
+      data = cache->pop(cls);
+    }
+    if (!data) {
+      data = pop_global(cls);
+    }
+  }
+
+  if (data) {
+    stats.num_cache_hits.fetch_add(1, std::memory_order_relaxed);
+    update_stat_array(stats.inactive, -1, stat_types);
+    update_stat_array(stats.inactive_bytes, -size, stat_types);
+    fill_block(data, nbytes);
+  } else {
+    data = system_alloc(size);
+  }
+
+  update_stat_array(stats.allocation, 1, stat_types);
+  update_stat_array(stats.allocated_bytes, size, stat_types);
+  return data;
+}
+
+void CPUCachingAllocatorImpl::free(void* data) {
+  const size_t size = block_size(data);
+  const size_t cls = size_class(size);
+  const StatTypes stat_types = get_stat_types(size);
+
+  update_stat_array(stats.allocation, -1, stat_types);
+  update_stat_array(stats.allocated_bytes, -size, stat_types);
+
+  if (cls == kNumSizeClasses) {
+    release_block(data);
+    return;
+  }
+
+  update_stat_array(stats.inactive, 1, stat_types);
+  update_stat_array(stats.inactive_bytes, size, stat_types);
+
+  ThreadCache* cache = local_cache();
+  if (!cache || !cache->push(cls, data)) {
+    push_global(cls, data);
+  }
+}
+
+void CPUCachingAllocatorImpl::release_block(void* data) {
+  const size_t size = block_size(data);
+  const StatTypes stat_types = get_stat_types(size);
+  update_stat_array(stats.segment, -1, stat_types);
+  update_stat_array(stats.reserved_bytes, -size, stat_types);
+  free_cpu(block_base(data));
+}
+
+void CPUCachingAllocatorImpl::release_blocks(std::vector<void*>& blocks) {
+  for (void* data : blocks) {
+    const StatTypes stat_types = get_stat_types(block_size(data));
+    update_stat_array(stats.inactive, -1, stat_types);
+    update_stat_array(stats.inactive_bytes, -block_size(data), stat_types);
+    release_block(data);
+  }
+  blocks.clear();
+  blocks.shrink_to_fit();
+}
+
+void CPUCachingAllocatorImpl::emptyCache() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& blocks : global_blocks_) {
+    release_blocks(blocks);
+  }
+  for (ThreadCache* cache : thread_caches_) {
+    std::lock_guard<std::mutex> cache_lock(cache->mutex);
+    for (auto& blocks : cache->free_blocks) {
+      release_blocks(blocks);
+    }
+    cache->cached_bytes = 0;
+  }
+}
+
+DeviceStats CPUCachingAllocatorImpl::getStats() const {
+  DeviceStats result;
+  copy_stat_array(result.allocation, stats.allocation);
+  copy_stat_array(result.segment, stats.segment);
+  copy_stat_array(result.inactive, stats.inactive);
+  copy_stat_array(result.allocated_bytes, stats.allocated_bytes);
+  copy_stat_array(result.reserved_bytes, stats.reserved_bytes);
+  copy_stat_array(result.inactive_bytes, stats.inactive_bytes);
+  result.num_alloc_retries = stats.num_alloc_retries.load(std::memory_order_relaxed);
+  result.num_ooms = stats.num_ooms.load(std::memory_order_relaxed);
+  result.num_cache_hits = stats.num_cache_hits.load(std::memory_order_relaxed);
+  return result;
+}
+
+void CPUCachingAllocatorImpl::resetAccumulatedStats() {
+  for (size_t statType = 0; statType < static_cast<size_t>(StatType::NUM_TYPES); ++statType) {
+    reset_accumulated_stat(stats.allocation[statType]);
+    reset_accumulated_stat(stats.segment[statType]);
+    reset_accumulated_stat(stats.inactive[statType]);
+    reset_accumulated_stat(stats.allocated_bytes[statType]);
+    reset_accumulated_stat(stats.reserved_bytes[statType]);
+    reset_accumulated_stat(stats.inactive_bytes[statType]);
+  }
+
+  stats.num_alloc_retries.store(0, std::memory_order_relaxed);
+  stats.num_ooms.store(0, std::memory_order_relaxed);
+  stats.num_cache_hits.store(0, std::memory_order_relaxed);
+}
+
+void CPUCachingAllocatorImpl::resetPeakStats() {
+  for (size_t statType = 0; statType < static_cast<size_t>(StatType::NUM_TYPES); ++statType) {
+    reset_peak_stat(stats.allocation[statType]);
+    reset_peak_stat(stats.segment[statType]);
+    reset_peak_stat(stats.inactive[statType]);
+    reset_peak_stat(stats.allocated_bytes[statType]);
+    reset_peak_stat(stats.reserved_bytes[statType]);
+    reset_peak_stat(stats.inactive_bytes[statType]);
+  }
+}
+
+namespace {
+
+void raw_delete(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  profiledCPUMemoryReporter().Delete(ptr);
+  caching_allocator().free(ptr);
+}
+
+struct CachingCPUAllocator final : public at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    if (nbytes == 0) {
+      return {nullptr, nullptr, &raw_delete, at::Device(DeviceType::CPU)};
+    }
+    void* data = caching_allocator().malloc(nbytes);
+    profiledCPUMemoryReporter().New(data, nbytes);
+    return {data, data, &raw_delete, at::Device(DeviceType::CPU)};
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return &raw_delete;
+  }
+};
+
+CachingCPUAllocator g_caching_cpu_allocator;
+
+} // namespace
+
+Allocator* get() {
+  return &g_caching_cpu_allocator;
+}
+
+void emptyCache() {
+  caching_allocator().emptyCache();
+}
+
+DeviceStats getDeviceStats() {
+  return caching_allocator().getStats();
+}
+
+void resetAccumulatedStats() {
+  caching_allocator().resetAccumulatedStats();
+}
+
+void resetPeakStats() {
+  caching_allocator().resetPeakStats();
+}
+
+} // namespace CPUCachingAllocator
+} // namespace c10
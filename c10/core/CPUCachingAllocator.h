@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+// A caching allocator for CPU tensors.
+//
+// DefaultCPUAllocator hands every allocation straight to posix_memalign and
+// every deallocation straight to free. For steady-state workloads that
+// allocate the same shapes over and over (e.g. inference with fixed input
+// sizes) this means the system allocator is on the hot path of every op.
+//
+// This allocator rounds requests up to a size class and keeps freed blocks on
+// per-thread free lists, so repeated allocations of the same size are served
+// without touching malloc. When a thread's cache grows past a fixed budget,
+// blocks spill into a global pool that is shared by all threads. Blocks
+// larger than the largest size class are not cached.
+//
+// The fast path is not lock-free: every thread cache has its own mutex, but
+// it is uncontended unless emptyCache() is draining that cache from another
+// thread. The mutex of the global pool is only taken when a thread cache
+// misses or is over budget.
+//
+// The allocator is opt-in: it is not registered by default. Call
+//
+//   c10::SetCPUAllocator(c10::CPUCachingAllocator::get());
+//
+// to make it the CPU allocator. emptyCache() releases every cached block
+// (including those held by other threads' caches) back to the system.
+//
+// The statistics mirror CUDACachingAllocator::DeviceStats so that tooling can
+// treat both allocators uniformly.
+
+namespace CPUCachingAllocator {
+
+struct Stat {
+  int64_t current = 0;
+  int64_t peak = 0;
+  int64_t allocated = 0;
+  int64_t freed = 0;
+};
+
+enum struct StatType : uint64_t {
+  AGGREGATE = 0,
+  SMALL_POOL = 1,
+  LARGE_POOL = 2,
+  NUM_TYPES = 3  // remember to update this whenever a new stat type is added
+};
+
+typedef std::array<Stat, static_cast<size_t>(StatType::NUM_TYPES)> StatArray;
+
+// Struct containing memory allocator summary statistics.
+struct DeviceStats {
+  // COUNT: allocations requested by client code
+  StatArray allocation;
+  // COUNT: number of blocks obtained from the system allocator.
+  StatArray segment;
+  // COUNT: number of inactive blocks sitting in a free list
+  StatArray inactive;
+
+  // SUM: bytes requested by client code
+  StatArray allocated_bytes;
+  // SUM: bytes reserved by this memory allocator (both free and used)
+  StatArray reserved_bytes;
+  // SUM: bytes within inactive blocks sitting in a free list
+  StatArray inactive_bytes;
+
+  // COUNT: total number of failed system allocations necessitating cache
+  // flushes.
+  int64_t num_alloc_retries = 0;
+
+  // COUNT: total number of OOMs (i.e. failed system allocations after cache
+  // flush)
+  int64_t num_ooms = 0;
+
+  // COUNT: allocations served from a free list without calling the system
+  // allocator.
+  int64_t num_cache_hits = 0;
+};
+
+C10_API Allocator* get();
+C10_API void emptyCache();
+C10_API DeviceStats getDeviceStats();
+C10_API void resetAccumulatedStats();
+C10_API void resetPeakStats();
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -26,6 +26,10 @@ const char* toString(DispatchKey t) {
       return "HIP";
     case DispatchKey::SparseHIP:
       return "SparseHIP";
+    case DispatchKey::SparseCsrCPU:
+      return "SparseCsrCPU";
+    case DispatchKey::SparseCsrCUDA:
+      return "SparseCsrCUDA";
     case DispatchKey::FPGA:
       return "FPGA";
     case DispatchKey::MSNPU:
@@ -42,12 +46,16 @@ const char* toString(DispatchKey t) {
       return "Autograd";
     case DispatchKey::BackendSelect:
       return "BackendSelect";
+    case DispatchKey::NestedTensor:
+      return "NestedTensor";
     case DispatchKey::Batched:
       return "Batched";
     case DispatchKey::TESTING_ONLY_GenericMode:
       return "TESTING_ONLY_GenericMode";
     case DispatchKey::Autocast:
       return "Autocast";
+    case DispatchKey::AutocastCPU:
+      return "AutocastCPU";
     case DispatchKey::TESTING_ONLY_GenericWrapper:
       return "TESTING_ONLY_GenericWrapper";
     case DispatchKey::Profiler:
@@ -99,6 +99,8 @@ enum class DispatchKey : uint8_t {
   SparseCUDA, // registered at build/aten/src/ATen/SparseCUDAType.cpp
   SparseHIP, // TODO: I think this is not actually used, due to Note
              // [Masquerading as CUDA]
+  SparseCsrCPU, // registered at build/aten/src/ATen/SparseCsrCPUType.cpp
+  SparseCsrCUDA, // registered at build/aten/src/ATen/SparseCsrCUDAType.cpp
 
   // Here are reserved backends for user-defined backends, see Note [Private use
   // DispatchKey]
@@ -208,7 +210,9 @@ enum class DispatchKey : uint8_t {
 
   // Autocasting precedes VariableTypeId, to ensure casts are autograd-exposed
   // and inputs are saved for backward in the post-autocast type.
+  // Autocast casts CUDA ops to float16, AutocastCPU casts CPU ops to bfloat16.
   Autocast,
+  AutocastCPU,
 
   // Here are some reserved pre-autograd keys for user-defined backends, see
   // Note [Private use DispatchKey]
@@ -221,6 +225,11 @@ enum class DispatchKey : uint8_t {
   // autograd; for example, error checking, tracing, profiling or vmap.  They
   // go here.
 
+  // This is the dispatch key for NestedTensorImpl, a batch of tensors that
+  // differ in the size of their first dim, packed into one buffer. See
+  // aten/src/ATen/NestedTensorImpl.h.
+  NestedTensor,
+
   // This is the dispatch key for BatchedTensorImpl, which is used to implement
   // batching rules for vmap.
   Batched,
@@ -2,6 +2,7 @@
 
 #include <c10/core/Allocator.h>
 #include <c10/core/ScalarType.h>
+#include <c10/core/impl/SlabAllocator.h>
 
 #include <c10/util/intrusive_ptr.h>
 
@@ -47,6 +48,14 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
   StorageImpl(const StorageImpl&) = delete;
   ~StorageImpl() = default;
 
+  // See c10/core/impl/SlabAllocator.h.
+  static void* operator new(size_t size) {
+    return impl::slab_allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    impl::slab_deallocate(ptr, size);
+  }
+
   void reset() {
     data_ptr_.clear();
     size_bytes_ = 0;
@@ -99,6 +99,49 @@ bool TensorImpl::compute_contiguous() const {
   return is_contiguous;
 }
 
+uint8_t TensorImpl::compute_memory_format_flags() const {
+  // Note:
+  // Dim 0, 1, 2 will never be a channels last 2d/3d format
+  // Dim 3+ is possibly be a channels last 2d format (Dim 4 only at this point)
+  // Dim 4+ is possibly be a channels last 3d format (Dim 5 only at this point)
+  uint8_t flags = 0;
+  switch (dim()) {
+    case 4:
+      if (compute_channels_last_contiguous_2d()) {
+        flags |= kChannelsLastContiguous;
+      }
+      if (compute_strides_like_channels_last_2d()) {
+        flags |= kChannelsLast;
+      }
+      break;
+    case 5:
+      if (compute_channels_last_contiguous_2d()) {
+        flags |= kChannelsLastContiguous;
+      } else if (compute_channels_last_contiguous_3d()) {
+        flags |= kChannelsLast3dContiguous;
+      }
+      if (!(flags & kChannelsLast3dContiguous) &&
+          compute_strides_like_channels_last_2d()) {
+        flags |= kChannelsLast;
+      } else if (compute_strides_like_channels_last_3d()) {
+        flags |= kChannelsLast3d;
+      }
+      break;
+    default:
+      // kChannelsLast and kChannelsLast3d are suggested memory_format.
+      // Being channels_last_contiguous doesn't necessarily mean the tensor is
+      // strided like channels_last: for strides on channel dimension could suggest
+      // desired memory_layout, but it doesn't affect memory storage
+      break;
+  }
+  if (is_contiguous_ ||
+      (flags & (kChannelsLastContiguous | kChannelsLast3dContiguous)) ||
+      compute_non_overlapping_and_dense()) {
+    flags |= kNonOverlappingAndDense;
+  }
+  return flags;
+}
+
 bool TensorImpl::compute_channels_last_contiguous_2d() const {
   // Please don't combine these code, constant array is used here to let
   // compiler fully unroll the loop to get better performance
@@ -218,10 +261,10 @@ bool TensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
   AT_ASSERT(compute_contiguous() == is_contiguous_);
 #endif
   if (memory_format == at::MemoryFormat::ChannelsLast) {
-      return is_channels_last_contiguous_;
+      return memory_format_flags() & kChannelsLastContiguous;
   }
   else if (memory_format == at::MemoryFormat::ChannelsLast3d) {
-      return is_channels_last_3d_contiguous_;
+      return memory_format_flags() & kChannelsLast3dContiguous;
   }
   return is_contiguous_;
 }
@@ -292,11 +335,9 @@ void TensorImpl::copy_tensor_metadata(
   dest_impl->device_opt_ = src_impl->device_opt_;
   dest_impl->key_set_ = src_impl->key_set_;
   dest_impl->is_contiguous_ = src_impl->is_contiguous_;
-  dest_impl->is_channels_last_contiguous_ = src_impl->is_channels_last_contiguous_;
-  dest_impl->is_channels_last_3d_contiguous_ = src_impl->is_channels_last_3d_contiguous_;
-  dest_impl->is_channels_last_ = src_impl->is_channels_last_;
-  dest_impl->is_channels_last_3d_ = src_impl->is_channels_last_3d_;
-  dest_impl->is_non_overlapping_and_dense_ = src_impl->is_non_overlapping_and_dense_;
+  dest_impl->memory_format_flags_.store(
+      src_impl->memory_format_flags_.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
   dest_impl->is_wrapped_number_ = src_impl->is_wrapped_number_;
   dest_impl->reserved_ = src_impl->reserved_;
   dest_impl->set_version_counter(version_counter);
@@ -10,6 +10,7 @@
 #include <c10/core/TensorOptions.h>
 #include <c10/core/DispatchKeySet.h>
 #include <c10/core/impl/LocalDispatchKeySet.h>
+#include <c10/core/impl/SlabAllocator.h>
 #include <c10/core/CopyBytes.h>
 
 #include <c10/util/Exception.h>
@@ -355,6 +356,15 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   TensorImpl(TensorImpl&&) = default;
   TensorImpl& operator=(TensorImpl&&) = default;
 
+  // TensorImpls (including subclasses, which pass their own size) come from
+  // the slab allocator, see c10/core/impl/SlabAllocator.h.
+  static void* operator new(size_t size) {
+    return impl::slab_allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    impl::slab_deallocate(ptr, size);
+  }
+
   /**
    * Release (decref) storage, and any other external allocations.  This
    * override is for `intrusive_ptr_target` and is used to implement weak
@@ -437,6 +447,12 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
            key_set_.has(DispatchKey::SparseHIP);
   }
 
+  bool is_sparse_csr() const {
+    // NB: This method is not virtual and avoid dispatches for performance reasons.
+    return key_set_.has(DispatchKey::SparseCsrCPU) ||
+           key_set_.has(DispatchKey::SparseCsrCUDA);
+  }
+
   bool is_quantized() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::QuantizedCPU) ||
@@ -452,6 +468,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::CUDA) ||
         key_set_.has(DispatchKey::SparseCUDA) ||
+        key_set_.has(DispatchKey::SparseCsrCUDA) ||
         key_set_.has(DispatchKey::QuantizedCUDA);
   }
 
@@ -489,6 +506,8 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // NB: This method is not virtual and avoid dispatches for perf.
     if (is_sparse()) {
       return kSparse;
+    } else if (is_sparse_csr()) {
+      return kSparseCsr;
     } else if (is_mkldnn()) {
       return kMkldnn;
     } else {
@@ -793,6 +812,38 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     refresh_contiguous();
   }
 
+  /**
+   * Set the sizes and strides of a view of src that has the elements of src
+   * in the same order, like view() and alias(). Such a view is contiguous
+   * exactly when src is, so its contiguity is taken from src instead of being
+   * computed; when the sizes and strides are the ones of src, so are the
+   * memory format flags.
+   *
+   * WARNING: This function does not check if the requested
+   * sizes/strides are in bounds for the storage that is allocated;
+   * this is the responsibility of the caller
+   */
+  void set_view_sizes_and_strides(
+      const TensorImpl& src,
+      IntArrayRef new_size,
+      IntArrayRef new_stride) {
+    TORCH_CHECK(allow_tensor_metadata_change(), "set_view_sizes_and_strides ", err_msg_tensor_metadata_change_not_allowed);
+    TORCH_INTERNAL_ASSERT(new_size.size() == new_stride.size());
+    sizes_.assign(new_size.begin(), new_size.end());
+    strides_.assign(new_stride.begin(), new_stride.end());
+    numel_ = src.numel_;
+    is_contiguous_ = src.is_contiguous_;
+    if (new_size.equals(src.sizes_) && new_stride.equals(src.strides_)) {
+      memory_format_flags_.store(
+          src.memory_format_flags_.load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    } else {
+      memory_format_flags_.store(kMemoryFormatFlagsStale, std::memory_order_relaxed);
+    }
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(numel_ == compute_numel());
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(is_contiguous_ == compute_contiguous());
+  }
+
   /**
    * Return the size of a tensor at some dimension.
    */
@@ -899,7 +950,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    * One TensorImpl can be copied to another TensorImpl if they have the same
    * DispatchKeySet. The only two special cases (for legacy reason) are:
    * CPU is compatible with CUDA and SparseCPU is
-   * compatible with SparseCUDA.
+   * compatible with SparseCUDA (and SparseCsrCPU with SparseCsrCUDA).
    */
   inline bool has_compatible_shallow_copy_type(DispatchKeySet from) {
     auto is_dense = [](DispatchKeySet ts) {
@@ -912,7 +963,12 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
              ts.has(DispatchKey::SparseCUDA) ||
              ts.has(DispatchKey::SparseHIP);
     };
-    return (key_set_ == from) || (is_dense(key_set_) && is_dense(from)) || (is_sparse(key_set_) && is_sparse(from));
+    auto is_sparse_csr = [](DispatchKeySet ts) {
+      return ts.has(DispatchKey::SparseCsrCPU) ||
+             ts.has(DispatchKey::SparseCsrCUDA);
+    };
+    return (key_set_ == from) || (is_dense(key_set_) && is_dense(from)) || (is_sparse(key_set_) && is_sparse(from)) ||
+           (is_sparse_csr(key_set_) && is_sparse_csr(from));
   }
 
   /**
@@ -1414,15 +1470,15 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   }
 
   bool is_strides_like_channels_last() const {
-    return is_channels_last_;
+    return memory_format_flags() & kChannelsLast;
   }
 
   bool is_strides_like_channels_last_3d() const {
-    return is_channels_last_3d_;
+    return memory_format_flags() & kChannelsLast3d;
   }
 
   bool is_non_overlapping_and_dense() const {
-    return is_non_overlapping_and_dense_;
+    return memory_format_flags() & kNonOverlappingAndDense;
   }
 
 private:
@@ -1511,6 +1567,22 @@ private:
 
   bool compute_non_overlapping_and_dense() const;
 
+  /**
+   * Compute the memory format flags, in memory_format_flags_, based on the
+   * sizes and strides of a tensor.
+   */
+  uint8_t compute_memory_format_flags() const;
+
+  uint8_t memory_format_flags() const {
+    uint8_t flags = memory_format_flags_.load(std::memory_order_relaxed);
+    if (C10_UNLIKELY(flags & kMemoryFormatFlagsStale)) {
+      // Concurrent readers compute and store the same flags
+      flags = compute_memory_format_flags();
+      memory_format_flags_.store(flags, std::memory_order_relaxed);
+    }
+    return flags;
+  }
+
 protected:
   /**
    * Recompute the cached numel of a tensor.  Call this if you modify sizes.
@@ -1525,36 +1597,9 @@ protected:
    */
   void refresh_contiguous() {
     is_contiguous_ = compute_contiguous();
-    // Note:
-    // Dim 0, 1, 2 will never be a channels last 2d/3d format
-    // Dim 3+ is possibly be a channels last 2d format (Dim 4 only at this point)
-    // Dim 4+ is possibly be a channels last 3d format (Dim 5 only at this point)
-    switch (dim()) {
-      case 4:
-        is_channels_last_contiguous_ = compute_channels_last_contiguous_2d();
-        is_channels_last_3d_contiguous_ = false;
-        is_channels_last_ = compute_strides_like_channels_last_2d();
-        is_channels_last_3d_ = false;
-        is_non_overlapping_and_dense_ = is_contiguous_ || is_channels_last_contiguous_ || compute_non_overlapping_and_dense();
-        break;
-      case 5:
-        is_channels_last_contiguous_ = compute_channels_last_contiguous_2d();
-        is_channels_last_3d_contiguous_ = !is_channels_last_contiguous_ && compute_channels_last_contiguous_3d();
-        is_channels_last_ = !is_channels_last_3d_contiguous_ && compute_strides_like_channels_last_2d();
-        is_channels_last_3d_ = !is_channels_last_ && compute_strides_like_channels_last_3d();
-        is_non_overlapping_and_dense_ = is_contiguous_ || is_channels_last_contiguous_ || is_channels_last_3d_contiguous_|| compute_non_overlapping_and_dense();
-        break;
-      default:
-        is_channels_last_contiguous_ = false;
-        is_channels_last_3d_contiguous_ = false;
-        // is_channels_last_ and is_channels_last_3d_ are suggested memory_format.
-        // Being channels_last_contiguous doesn't necessarily mean the tensor is
-        // strided like channels_last: for strides on channel dimension could suggest
-        // desired memory_layout, but it doesn't affect memory storage
-        is_channels_last_ = false;
-        is_channels_last_3d_ = false;
-        is_non_overlapping_and_dense_ = is_contiguous_ || compute_non_overlapping_and_dense();
-    }
+    // The memory format flags take more work to compute, and most tensors,
+    // views in particular, are never asked for them
+    memory_format_flags_.store(kMemoryFormatFlagsStale, std::memory_order_relaxed);
   }
 
   /**
@@ -1667,30 +1712,40 @@ protected:
   // should pack this into a bitfield.
   bool is_contiguous_ = true;
 
-  // Tensor is stored in the channels last 2d memory format, when dimensions
-  // order is (N)CHW and C-strides < W-strides < H-strides (< N-strides)
-  // (If size of any dimension is equal to 1, this dimension strides value
-  // is not taken into account).
-  bool is_channels_last_ = false;
-
-  // Channels last contiguous tensor is channel last tensor which occupies
-  // contiguous memory block.
-  bool is_channels_last_contiguous_ = false;
-
-  // Tensor is stored in the channels last 3d memory format, when dimensions
-  // order is (N)CDHW and C-strides < W-strides < H-strides < D - strides (< N-strides)
-  // (If size of any dimension is equal to 1, this dimension strides value
-  // is not taken into account).
-  bool is_channels_last_3d_ = false;
-
-  // Channels last 3d contiguous tensor is channel last 3d tensor which occupies
-  // contiguous memory block.
-  bool is_channels_last_3d_contiguous_ = false;
+  // The bits of memory_format_flags_
+  enum MemoryFormatFlags : uint8_t {
+    // Tensor is stored in the channels last 2d memory format, when dimensions
+    // order is (N)CHW and C-strides < W-strides < H-strides (< N-strides)
+    // (If size of any dimension is equal to 1, this dimension strides value
+    // is not taken into account).
+    kChannelsLast = 1 << 0,
+
+    // Channels last contiguous tensor is channel last tensor which occupies
+    // contiguous memory block.
+    kChannelsLastContiguous = 1 << 1,
+
+    // Tensor is stored in the channels last 3d memory format, when dimensions
+    // order is (N)CDHW and C-strides < W-strides < H-strides < D - strides (< N-strides)
+    // (If size of any dimension is equal to 1, this dimension strides value
+    // is not taken into account).
+    kChannelsLast3d = 1 << 2,
+
+    // Channels last 3d contiguous tensor is channel last 3d tensor which occupies
+    // contiguous memory block.
+    kChannelsLast3dContiguous = 1 << 3,
+
+    // Dense tensor is the tensor that store values in a contiguous block of memory.
+    // Non-overlapping tensor is the tensor in which elements occupy individual
+    // non-repetitive memory.
+    kNonOverlappingAndDense = 1 << 4,
+
+    // The other bits are to be computed from the sizes and strides
+    kMemoryFormatFlagsStale = 1 << 7,
+  };
 
-  // Dense tensor is the tensor that store values in a contiguous block of memory.
-  // Non-overlapping tensor is the tensor in which elements occupy individual
-  // non-repetitive memory.
-  bool is_non_overlapping_and_dense_ = false;
+  // Computed on first use after the sizes or strides change, see
+  // refresh_contiguous(). Atomic, as const methods compute them.
+  mutable std::atomic<uint8_t> memory_format_flags_{0};
 
   bool is_wrapped_number_ = false;
 
@@ -1747,6 +1802,8 @@ protected:
 //    vtable pointer
 //    strong refcount           TODO: pack these into one word
 //    weak refcount
+//    (optional) biased refcount owner thread
+//    (optional) biased refcount
 //    storage pointer
 //    autograd metadata pointer
 //    version counter pointer
@@ -1774,8 +1831,15 @@ protected:
 //    tensor type id
 //    miscellaneous bitfield
 //
+#ifdef C10_USE_BIASED_REFCOUNT
 static_assert(sizeof(void*) != sizeof(int64_t) || // if 64-bit...
-              sizeof(TensorImpl) == sizeof(int64_t) * 31,
+              sizeof(TensorImpl) == sizeof(int64_t) * 32,
               "You changed the size of TensorImpl on 64-bit arch."
               "See Note [TensorImpl size constraints] on how to proceed.");
+#else
+static_assert(sizeof(void*) != sizeof(int64_t) || // if 64-bit...
+              sizeof(TensorImpl) == sizeof(int64_t) * 30,
+              "You changed the size of TensorImpl on 64-bit arch."
+              "See Note [TensorImpl size constraints] on how to proceed.");
+#endif
 } // namespace c10
@@ -419,6 +419,15 @@ struct C10_API TensorOptions {
           default:
             AT_ERROR("Unsupported device type for sparse layout: ", device().type());
         }
+      case Layout::SparseCsr:
+        switch (device().type()) {
+          case DeviceType::CPU:
+            return DispatchKey::SparseCsrCPU;
+          case DeviceType::CUDA:
+            return DispatchKey::SparseCsrCUDA;
+          default:
+            AT_ERROR("Unsupported device type for sparse CSR layout: ", device().type());
+        }
       case Layout::Mkldnn:
         switch (device().type()) {
           case DeviceType::CPU:
@@ -651,6 +660,10 @@ inline DeviceType computeDeviceType(DispatchKey tid) {
     return DeviceType::CUDA;
   } else if (tid == DispatchKey::SparseHIP) {
     return DeviceType::HIP;
+  } else if (tid == DispatchKey::SparseCsrCPU) {
+    return DeviceType::CPU;
+  } else if (tid == DispatchKey::SparseCsrCUDA) {
+    return DeviceType::CUDA;
   } else if (tid == DispatchKey::MkldnnCPU) {
     return DeviceType::CPU;
   } else if (tid == DispatchKey::Vulkan) {
@@ -0,0 +1,232 @@
+#include <c10/core/impl/SlabAllocator.h>
+
+#include <c10/util/Flags.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+C10_DEFINE_bool(
+    caffe2_slab_allocate_tensor_metadata,
+    false,
+    "If set, allocate TensorImpl and StorageImpl objects from per-thread "
+    "slabs. Overridden by PYTORCH_SLAB_ALLOCATE_TENSOR_METADATA.");
+
+namespace c10 {
+namespace impl {
+
+namespace {
+
+constexpr size_t kSlabGranularity = 16;
+constexpr size_t kNumSlabClasses = kMaxSlabObjectSize / kSlabGranularity;
+constexpr size_t kSlabBytes = 65536;
+// A thread keeps at most this many free objects per size class; the oldest
+// half moves to the global pool when it goes over.
+constexpr size_t kMaxThreadCacheObjects = 256;
+constexpr size_t kBatchObjects = kMaxThreadCacheObjects / 2;
+
+static_assert(
+    alignof(std::max_align_t) <= kSlabGranularity,
+    "slab objects must be suitably aligned for any type");
+
+struct FreeObject {
+  FreeObject* next;
+};
+
+struct FreeList {
+  FreeObject* head = nullptr;
+  size_t length = 0;
+
+  void push(void* ptr) {
+    auto* object = static_cast<FreeObject*>(ptr);
+    object->next = head;
+    head = object;
+    ++length;
+  }
+
+  void* pop() {
+    FreeObject* object = head;
+    head = object->next;
+    --length;
+    return object;
+  }
+
+  // Moves up to `count` objects from this list to `dst`.
+  void move_to(FreeList& dst, size_t count) {
+    while (head != nullptr && count-- > 0) {
+      dst.push(pop());
+    }
+  }
+
+  // Keeps the `count` most recently pushed objects and moves the rest to
+  // `dst`.
+  void trim_to(FreeList& dst, size_t count) {
+    if (length <= count) {
+      return;
+    }
+    FreeObject* last = head;
+    for (size_t i = 1; i < count; ++i) {
+      last = last->next;
+    }
+    FreeList rest;
+    rest.head = count == 0 ? head : last->next;
+    rest.length = length - count;
+    if (count == 0) {
+      head = nullptr;
+    } else {
+      last->next = nullptr;
+    }
+    length = count;
+    rest.move_to(dst, rest.length);
+  }
+};
+
+typedef std::array<FreeList, kNumSlabClasses> FreeLists;
+
+inline size_t slab_class(size_t size) {
+  return size == 0 ? 0 : (size - 1) / kSlabGranularity;
+}
+
+// Carves a new slab into objects of class `cls` and adds them to `list`.
+void carve_slab(size_t cls, FreeList& list) {
+  const size_t object_size = (cls + 1) * kSlabGranularity;
+  char* slab = static_cast<char*>(::operator new(kSlabBytes));
+  for (size_t offset = 0; offset + object_size <= kSlabBytes;
+       offset += object_size) {
+    list.push(slab + offset);
+  }
+}
+
+// Free objects not owned by any thread. Leaked on purpose: thread caches
+// flush into it at thread exit and tensors may be freed during static
+// destruction.
+struct GlobalPool {
+  std::mutex mutex;
+  FreeLists free_lists;
+};
+
+GlobalPool& global_pool() {
+  static GlobalPool* pool = new GlobalPool();
+  return *pool;
+}
+
+struct ThreadCache {
+  ~ThreadCache() {
+    auto& pool = global_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    for (size_t cls = 0; cls < kNumSlabClasses; ++cls) {
+      free_lists[cls].move_to(pool.free_lists[cls], free_lists[cls].length);
+    }
+  }
+
+  void* allocate(size_t cls) {
+    FreeList& list = free_lists[cls];
+    if (C10_UNLIKELY(list.head == nullptr)) {
+      auto& pool = global_pool();
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      if (pool.free_lists[cls].head == nullptr) {
+        carve_slab(cls, pool.free_lists[cls]);
+      }
+      pool.free_lists[cls].move_to(list, kBatchObjects);
+    }
+    return list.pop();
+  }
+
+  void deallocate(size_t cls, void* ptr) {
+    FreeList& list = free_lists[cls];
+    list.push(ptr);
+    if (C10_UNLIKELY(list.length > kMaxThreadCacheObjects)) {
+      auto& pool = global_pool();
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      list.trim_to(pool.free_lists[cls], kBatchObjects);
+    }
+  }
+
+  FreeLists free_lists;
+};
+
+// As in CPUCachingAllocator, the cache is only reachable through a trivially
+// destructible pointer, so that objects freed after the thread cache has been
+// torn down (e.g. from other thread_local destructors) go straight to the
+// global pool.
+thread_local ThreadCache* tls_cache = nullptr;
+thread_local bool tls_cache_destroyed = false;
+
+struct ThreadCacheHolder {
+  ThreadCacheHolder() {
+    tls_cache = &cache;
+  }
+  ~ThreadCacheHolder() {
+    tls_cache = nullptr;
+    tls_cache_destroyed = true;
+  }
+  ThreadCache cache;
+};
+
+ThreadCache* local_cache() {
+  if (C10_LIKELY(tls_cache != nullptr)) {
+    return tls_cache;
+  }
+  if (tls_cache_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadCacheHolder holder;
+  return &holder.cache;
+}
+
+// Read once, at the first allocation: objects allocated with one setting
+// must be freed with it. The environment variable lets Python processes,
+// which don't parse the flags, set it before any tensor exists.
+bool slab_enabled() {
+  static const bool enabled = []() {
+    const char* env = std::getenv("PYTORCH_SLAB_ALLOCATE_TENSOR_METADATA");
+    if (env != nullptr) {
+      return std::strcmp(env, "1") == 0;
+    }
+    return FLAGS_caffe2_slab_allocate_tensor_metadata;
+  }();
+  return enabled;
+}
+
+} // namespace
+
+void* slab_allocate(size_t size) {
+  if (size > kMaxSlabObjectSize || !slab_enabled()) {
+    return ::operator new(size);
+  }
+  const size_t cls = slab_class(size);
+  if (ThreadCache* cache = local_cache()) {
+    return cache->allocate(cls);
+  }
+  auto& pool = global_pool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  FreeList& list = pool.free_lists[cls];
+  if (list.head == nullptr) {
+    carve_slab(cls, list);
+  }
+  return list.pop();
+}
+
+void slab_deallocate(void* ptr, size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (size > kMaxSlabObjectSize || !slab_enabled()) {
+    ::operator delete(ptr);
+    return;
+  }
+  const size_t cls = slab_class(size);
+  if (ThreadCache* cache = local_cache()) {
+    cache->deallocate(cls, ptr);
+    return;
+  }
+  auto& pool = global_pool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.free_lists[cls].push(ptr);
+}
+
+} // namespace impl
+} // namespace c10
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+#include <c10/macros/Macros.h>
+
+// Slab allocator for small, short-lived c10 objects.
+//
+// Every tensor created by an op allocates a TensorImpl and (usually) a
+// StorageImpl. In loops over small tensors the general purpose heap shows up
+// next to the arithmetic, so TensorImpl and StorageImpl overload operator
+// new/delete to use this allocator instead.
+//
+// Objects are binned by size in 16-byte steps up to kMaxSlabObjectSize. Each
+// thread serves its allocations from its own free lists without locking;
+// the free lists are refilled from a global pool, or by carving a new 64 KiB
+// slab, and spill excess objects back into the global pool. Objects may be
+// freed on any thread. Slabs are never returned to the system: the memory of
+// the peak number of live objects stays held for the life of the process.
+//
+// The slabs are off by default. Set PYTORCH_SLAB_ALLOCATE_TENSOR_METADATA=1 in
+// the environment, or --caffe2_slab_allocate_tensor_metadata before the first
+// tensor is created, to turn them on; the environment variable wins over the
+// flag. The setting is read once, at the first allocation, and can't change
+// afterwards.
+
+namespace c10 {
+namespace impl {
+
+constexpr size_t kMaxSlabObjectSize = 1024;
+
+C10_API void* slab_allocate(size_t size);
+
+// `size` must be the size passed to slab_allocate().
+C10_API void slab_deallocate(void* ptr, size_t size);
+
+} // namespace impl
+} // namespace c10
@@ -1,5 +1,7 @@
 #include <c10/core/thread_pool.h>
 
+#include <algorithm>
+
 namespace c10 {
 
 ThreadPool::ThreadPool(
@@ -132,6 +134,210 @@ void ThreadPool::main_loop(std::size_t index) {
   } // while running_
 }
 
+NUMAThreadPool::NUMAThreadPool(
+    int pool_size,
+    int num_nodes,
+    std::function<void()> init_thread) {
+  TORCH_CHECK(num_nodes > 0, "NUMAThreadPool needs at least one NUMA node");
+  if (pool_size < 0) {
+    pool_size = defaultNumThreads();
+  }
+  pools_.reserve(num_nodes);
+  for (int node = 0; node < num_nodes; ++node) {
+    int node_size = pool_size / num_nodes + (node < pool_size % num_nodes);
+    pools_.emplace_back(new ThreadPool(
+        std::max(node_size, 1), node, [node, init_thread]() {
+          NUMABind(node);
+          if (init_thread) {
+            init_thread();
+          }
+        }));
+  }
+}
+
+void NUMAThreadPool::run(std::function<void()> func) {
+  size_t node = next_node_.fetch_add(1, std::memory_order_relaxed);
+  pools_[node % pools_.size()]->run(std::move(func));
+}
+
+void NUMAThreadPool::runOnNode(int numa_node_id, std::function<void()> func) {
+  if (numa_node_id < 0 || numa_node_id >= static_cast<int>(pools_.size())) {
+    run(std::move(func));
+    return;
+  }
+  pools_[numa_node_id]->run(std::move(func));
+}
+
+size_t NUMAThreadPool::size() const {
+  size_t total = 0;
+  for (const auto& pool : pools_) {
+    total += pool->size();
+  }
+  return total;
+}
+
+size_t NUMAThreadPool::numAvailable() const {
+  size_t total = 0;
+  for (const auto& pool : pools_) {
+    total += pool->numAvailable();
+  }
+  return total;
+}
+
+bool NUMAThreadPool::inThreadPool() const {
+  for (const auto& pool : pools_) {
+    if (pool->inThreadPool()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace {
+// Pool and queue index of the current thread, if it is a worker of a
+// WorkStealingThreadPool
+thread_local WorkStealingThreadPool* current_pool = nullptr;
+thread_local size_t current_queue = 0;
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(
+    int pool_size,
+    std::function<void()> init_thread) {
+  size_t num_threads = pool_size < 0 ? defaultNumThreads() : pool_size;
+  queues_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    queues_.emplace_back(new Queue());
+  }
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this, i, init_thread]() {
+      if (init_thread) {
+        init_thread();
+      }
+      this->main_loop(i);
+    });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    running_ = false;
+    wakeup_.notify_all();
+  }
+  for (auto& t : threads_) {
+    try {
+      t.join();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
+size_t WorkStealingThreadPool::size() const {
+  return threads_.size();
+}
+
+size_t WorkStealingThreadPool::numAvailable() const {
+  return threads_.size() - std::min(busy_.load(), threads_.size());
+}
+
+bool WorkStealingThreadPool::inThreadPool() const {
+  return current_pool == this;
+}
+
+void WorkStealingThreadPool::run(std::function<void()> func) {
+  if (threads_.size() == 0) {
+    throw std::runtime_error("No threads to run a task");
+  }
+  size_t index = current_pool == this
+      ? current_queue
+      : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+  // Counted before the push, so that pending_ never underflows. A worker
+  // seeing the count before the task may spin until the push is done.
+  pending_.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.push_back(std::move(func));
+  }
+  // Workers increment sleeping_ before checking pending_, so either they see
+  // this task or we see them sleeping.
+  if (sleeping_.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    wakeup_.notify_one();
+  }
+}
+
+bool WorkStealingThreadPool::popTask(
+    size_t index,
+    std::function<void()>& task) {
+  if (pending_.load() == 0) {
+    return false;
+  }
+  if (index < queues_.size()) {
+    Queue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      pending_.fetch_sub(1);
+      return true;
+    }
+  }
+  size_t start = index < queues_.size() ? index + 1 : 0;
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    Queue& queue = *queues_[(start + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      pending_.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::runTask(std::function<void()>& task) {
+  ++busy_;
+  try {
+    task();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Exception in thread pool task: " << e.what();
+  } catch (...) {
+    LOG(ERROR) << "Exception in thread pool task: unknown";
+  }
+  --busy_;
+  // Destroy the task right away, see ThreadPool::main_loop
+  task = nullptr;
+}
+
+bool WorkStealingThreadPool::runPendingTask() {
+  std::function<void()> task;
+  if (!popTask(current_pool == this ? current_queue : queues_.size(), task)) {
+    return false;
+  }
+  runTask(task);
+  return true;
+}
+
+void WorkStealingThreadPool::main_loop(size_t index) {
+  current_pool = this;
+  current_queue = index;
+  std::function<void()> task;
+  while (running_) {
+    if (popTask(index, task)) {
+      runTask(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    ++sleeping_;
+    while (pending_.load() == 0 && running_) {
+      wakeup_.wait(lock);
+    }
+    --sleeping_;
+  }
+}
+
 C10_DEFINE_SHARED_REGISTRY(
     ThreadPoolRegistry,
     TaskThreadPoolBase,
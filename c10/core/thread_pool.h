@@ -1,11 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <c10/util/Optional.h>
 #include <c10/util/intrusive_ptr.h>
@@ -114,6 +118,94 @@ class C10_API TaskThreadPool : public c10::ThreadPool {
       }) {}
 };
 
+// A thread pool made of one ThreadPool per NUMA node. Worker threads of the
+// pool for node `n` are bound to node `n`, so memory they first touch is
+// allocated there. Tasks submitted with run() are spread round-robin over the
+// nodes; runOnNode() places a task on a specific node.
+class C10_API NUMAThreadPool : public c10::TaskThreadPoolBase {
+ public:
+  // `pool_size` threads are split as evenly as possible over `num_nodes`
+  // nodes; every node gets at least one thread.
+  NUMAThreadPool(
+      int pool_size,
+      int num_nodes,
+      std::function<void()> init_thread = nullptr);
+
+  void run(std::function<void()> func) override;
+
+  void runOnNode(int numa_node_id, std::function<void()> func);
+
+  size_t size() const override;
+
+  size_t numAvailable() const override;
+
+  bool inThreadPool() const override;
+
+  int numNodes() const {
+    return pools_.size();
+  }
+
+ private:
+  std::vector<std::unique_ptr<ThreadPool>> pools_;
+  std::atomic<size_t> next_node_{0};
+};
+
+// A thread pool where every worker thread owns a queue of tasks, protected
+// by its own lock. Tasks submitted from a worker go to the back of the
+// worker's queue, and the worker takes them back from there (last in first
+// out, so the data they use is likely still in cache). Tasks submitted from
+// other threads are spread round-robin over the queues. A worker whose queue
+// is empty steals the oldest task of another queue. This avoids contention on
+// a single queue when many tasks are submitted at once, e.g. by TorchScript
+// forks.
+class C10_API WorkStealingThreadPool : public c10::TaskThreadPoolBase {
+ public:
+  explicit WorkStealingThreadPool(
+      int pool_size,
+      std::function<void()> init_thread = nullptr);
+
+  ~WorkStealingThreadPool();
+
+  void run(std::function<void()> func) override;
+
+  size_t size() const override;
+
+  size_t numAvailable() const override;
+
+  bool inThreadPool() const override;
+
+  /**
+   * Runs one pending task on the calling thread, if there is any, and
+   * returns whether it did. Threads waiting on the result of tasks of this
+   * pool can call this to help instead of blocking.
+   */
+  bool runPendingTask();
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  // Takes a task from the back of queue `index`, or else steals one from the
+  // front of the other queues. `index` is size() for non worker threads.
+  bool popTask(size_t index, std::function<void()>& task);
+  void runTask(std::function<void()>& task);
+  void main_loop(size_t index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  // Number of tasks in the queues
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> busy_{0};
+  std::atomic<size_t> next_queue_{0};
+  // Idle workers sleep until pending_ is non zero
+  std::mutex sleep_mutex_;
+  std::condition_variable wakeup_;
+  std::atomic<size_t> sleeping_{0};
+  std::atomic_bool running_{true};
+};
+
 C10_DECLARE_SHARED_REGISTRY(
     ThreadPoolRegistry,
     TaskThreadPoolBase,
@@ -3,10 +3,13 @@
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAFunctions.h>
+#include <c10/util/Backtrace.h>
 #include <c10/util/UniqueVoidPtr.h>
 
 #include <cuda_runtime_api.h>
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <bitset>
 #include <deque>
 #include <iterator>
@@ -18,6 +21,16 @@
 #include <unordered_set>
 #include <vector>
 
+#if !defined(__HIP_PLATFORM_HCC__) && !defined(_WIN32) && CUDART_VERSION >= 10020
+#include <cuda.h>
+#include <dlfcn.h>
+#define C10_CUDA_EXPANDABLE_SEGMENTS
+#endif
+
+#if !defined(__HIP_PLATFORM_HCC__) && CUDART_VERSION >= 11000
+#define C10_CUDA_GRAPHS
+#endif
+
 namespace c10 {
 
 C10_DEFINE_REGISTRY(FreeCudaMemoryCallbacksRegistry, FreeMemoryCallback);
@@ -51,6 +64,36 @@ namespace CUDACachingAllocator {
 // ensure that the block is not reused before each recorded stream completes
 // work.
 //
+// Expandable segments (PYTORCH_CUDA_EXPANDABLE_SEGMENTS=1, CUDA >= 10.2):
+//
+// - Instead of cudaMalloc'ing a new segment for every large pool miss, the
+//   allocator reserves one virtual address range per stream, as large as the
+//   device memory, and maps physical pages (cuMemCreate/cuMemMap) onto the
+//   end of it on demand.
+// - Because the mapped part of a segment is always one contiguous range,
+//   a free block at the end of the segment is merged with the newly mapped
+//   pages, and neighbouring free blocks can always be coalesced. This avoids
+//   the fragmentation caused by many partially used kLargeBuffer segments.
+// - emptyCache() unmaps the pages of the free block at the end of each
+//   segment.
+// - Small allocations still use cudaMalloc'd kSmallBuffer segments. Memory in
+//   expandable segments cannot be shared through CUDA IPC.
+//
+// CUDA graphs (CUDA >= 11.0, see ATen/cuda/CUDAGraph.h):
+//
+// - A captured graph replays with the addresses its kernels saw at capture,
+//   so memory it used must not be handed to anyone else until the graph is
+//   destroyed. While a capture is underway, allocations from the capturing
+//   stream(s) come from a private pool of the graph, with its own small and
+//   large BlockPools, instead of the global ones.
+// - Blocks of a private pool freed during or after capture go back to that
+//   pool and may only be reused by allocations of the same capture (or of
+//   later captures sharing the pool). Once every graph using a pool was
+//   destroyed, emptyCache() and the OOM retry may release its memory.
+// - Querying or synchronizing events and cudaFree are illegal while a stream
+//   captures, so process_events() and cache flushes are skipped until the
+//   capture ends.
+//
 
 
 namespace {
@@ -66,6 +109,8 @@ constexpr size_t kRoundLarge = 2097152;     // round up large allocs to 2 MiB
 
 typedef std::bitset<static_cast<size_t>(StatType::NUM_TYPES)> StatTypes;
 
+struct ExpandableSegment;
+
 void update_stat(Stat& stat, int64_t amount) {
   stat.current += amount;
 
@@ -98,8 +143,17 @@ void update_stat_array(StatArray& stat_array, int64_t amount, const StatTypes& s
 }
 
 struct Block;
+struct PrivatePool;
 typedef bool (*Comparison)(const Block*, const Block*);
-typedef std::set<Block*, Comparison> BlockPool;
+
+struct BlockPool {
+  BlockPool(Comparison comparator, bool small, PrivatePool* private_pool = nullptr) :
+    blocks(comparator), is_small(small), owner_PrivatePool(private_pool) {}
+
+  std::set<Block*, Comparison> blocks;
+  const bool is_small;
+  PrivatePool* owner_PrivatePool; // nullptr for the global pools
+};
 
 struct Block {
   int           device;      // gpu
@@ -112,15 +166,19 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  ExpandableSegment* expandable_segment; // owning segment, if expandable
+  uint64_t      free_order;  // when the block was last returned to its pool
 
   Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
     device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable_segment(nullptr), free_order(0) { }
 
   // constructor for search key
   Block(int device, cudaStream_t stream, size_t size) :
     device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable_segment(nullptr), free_order(0) { }
 
   bool is_split() const {
     return (prev != nullptr) || (next != nullptr);
@@ -138,6 +196,32 @@ static bool BlockComparator(const Block* a, const Block* b)
   return (uintptr_t)a->ptr < (uintptr_t)b->ptr;
 }
 
+// Memory of a CUDA graph, see notifyCaptureBegin(). Several graphs may share
+// a pool if they are replayed in the order they were captured.
+struct PrivatePool {
+  PrivatePool() :
+    use_count(1),
+    cudaMalloc_count(0),
+    large_blocks(BlockComparator, /*small=*/false, this),
+    small_blocks(BlockComparator, /*small=*/true, this) {}
+  PrivatePool(const PrivatePool&) = delete;
+  PrivatePool& operator=(const PrivatePool&) = delete;
+
+  // number of live graphs using the pool
+  int use_count;
+  // number of segments cudaMalloc'd into the pool that have not been
+  // cudaFreed yet
+  int cudaMalloc_count;
+  BlockPool large_blocks;
+  BlockPool small_blocks;
+};
+
+struct MempoolIdHash {
+  std::size_t operator()(const MempoolId_t& mempool_id) const noexcept {
+    return mempool_id.first != 0 ? mempool_id.first : mempool_id.second;
+  }
+};
+
 static std::string format_size(uint64_t size) {
   std::ostringstream os;
   os.precision(2);
@@ -157,6 +241,147 @@ static std::string format_size(uint64_t size) {
   return os.str();
 }
 
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+
+// The virtual memory management API is only exposed by the driver. libcuda is
+// loaded lazily so that c10_cuda keeps working on machines without a driver
+// and does not pick up a link-time dependency on it.
+struct DriverAPI {
+#define C10_FORALL_DRIVER_API(_) \
+  _(cuGetErrorString)            \
+  _(cuMemGetAllocationGranularity) \
+  _(cuMemCreate)                 \
+  _(cuMemRelease)                \
+  _(cuMemAddressReserve)         \
+  _(cuMemAddressFree)            \
+  _(cuMemMap)                    \
+  _(cuMemUnmap)                  \
+  _(cuMemSetAccess)
+#define CREATE_MEMBER(name) decltype(&name) name##_;
+  C10_FORALL_DRIVER_API(CREATE_MEMBER)
+#undef CREATE_MEMBER
+
+  // Returns nullptr if libcuda or one of its entry points is missing.
+  static const DriverAPI* get() {
+    static const DriverAPI* api = load();
+    return api;
+  }
+
+ private:
+  static const DriverAPI* load() {
+    void* handle = dlopen("libcuda.so.1", RTLD_LAZY | RTLD_LOCAL);
+    if (!handle) {
+      return nullptr;
+    }
+    static DriverAPI api;
+#define LOOKUP_ENTRY(name)                                             \
+    api.name##_ = reinterpret_cast<decltype(&name)>(dlsym(handle, #name)); \
+    if (!api.name##_) {                                                \
+      return nullptr;                                                  \
+    }
+    C10_FORALL_DRIVER_API(LOOKUP_ENTRY)
+#undef LOOKUP_ENTRY
+    return &api;
+  }
+#undef C10_FORALL_DRIVER_API
+};
+
+#define C10_CUDA_DRIVER_CHECK(EXPR)                                  \
+  do {                                                               \
+    CUresult __err = EXPR;                                           \
+    if (__err != CUDA_SUCCESS) {                                     \
+      const char* err_str = nullptr;                                 \
+      DriverAPI::get()->cuGetErrorString_(__err, &err_str);          \
+      TORCH_CHECK(false, "CUDA driver error: ", err_str ? err_str : "unknown"); \
+    }                                                                \
+  } while (0)
+
+// A virtual address range whose prefix [0, size()) is backed by physical
+// pages. Pages are only ever mapped and unmapped at the end of the range.
+struct ExpandableSegment {
+  ExpandableSegment(int device, cudaStream_t stream, size_t max_size, size_t page_size) :
+    device(device), stream(stream), page_size(page_size), tail(nullptr) {
+    this->max_size = page_size * ((max_size + page_size - 1) / page_size);
+    C10_CUDA_DRIVER_CHECK(DriverAPI::get()->cuMemAddressReserve_(
+        &base, this->max_size, page_size, 0, 0));
+  }
+
+  char* ptr() const {
+    return reinterpret_cast<char*>(base);
+  }
+
+  size_t size() const {
+    return handles.size() * page_size;
+  }
+
+  // Maps pages until at least new_size bytes are backed. Returns false,
+  // leaving the segment unchanged, if the device is out of memory.
+  bool grow(size_t new_size) {
+    const DriverAPI* driver = DriverAPI::get();
+    const size_t old_pages = handles.size();
+    const size_t new_pages = (new_size + page_size - 1) / page_size;
+    if (new_pages * page_size > max_size) {
+      return false;
+    }
+
+    CUmemAllocationProp prop = {};
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    for (size_t i = old_pages; i < new_pages; ++i) {
+      CUmemGenericAllocationHandle handle;
+      CUresult err = driver->cuMemCreate_(&handle, page_size, &prop, 0);
+      if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+        unmap(old_pages);
+        return false;
+      }
+      C10_CUDA_DRIVER_CHECK(err);
+      handles.push_back(handle);
+      C10_CUDA_DRIVER_CHECK(driver->cuMemMap_(base + i * page_size, page_size, 0, handle, 0));
+    }
+
+    CUmemAccessDesc desc = {};
+    desc.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    desc.location.id = device;
+    desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+    C10_CUDA_DRIVER_CHECK(driver->cuMemSetAccess_(
+        base + old_pages * page_size, (new_pages - old_pages) * page_size, &desc, 1));
+    return true;
+  }
+
+  // Unmaps and releases every page at or past page index `num_pages`.
+  void unmap(size_t num_pages) {
+    const DriverAPI* driver = DriverAPI::get();
+    while (handles.size() > num_pages) {
+      const size_t i = handles.size() - 1;
+      C10_CUDA_DRIVER_CHECK(driver->cuMemUnmap_(base + i * page_size, page_size));
+      C10_CUDA_DRIVER_CHECK(driver->cuMemRelease_(handles.back()));
+      handles.pop_back();
+    }
+  }
+
+  // Unmaps everything and gives the address range back. Deliberately not a
+  // destructor: segments still alive at exit are left to the driver.
+  void release() {
+    unmap(0);
+    C10_CUDA_DRIVER_CHECK(DriverAPI::get()->cuMemAddressFree_(base, max_size));
+  }
+
+  int device;
+  cudaStream_t stream;
+  CUdeviceptr base;
+  size_t max_size;
+  size_t page_size;
+  std::vector<CUmemGenericAllocationHandle> handles;
+  Block* tail; // block ending at ptr() + size()
+};
+
+#else
+
+struct ExpandableSegment {};
+
+#endif // C10_CUDA_EXPANDABLE_SEGMENTS
+
 struct AllocParams {
   AllocParams(int device, size_t size, cudaStream_t stream, BlockPool* pool, size_t alloc_size,
               DeviceStats& stats) :
@@ -202,11 +427,52 @@ class DeviceCachingAllocator {
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
 
+  // whether large allocations come from expandable segments
+  bool use_expandable_segments;
+
+  // expandable segment per stream
+  std::unordered_map<cudaStream_t, std::unique_ptr<ExpandableSegment>> expandable_segments;
+
+  // cap on reserved memory; 0 if unlimited
+  size_t allowed_memory_maximum = 0;
+
+  // soft limit on reserved memory; 0 if unlimited
+  size_t soft_memory_limit = 0;
+
+  // whether the soft limit callbacks already ran for the current excursion
+  // above the soft limit
+  bool soft_limit_exceeded = false;
+
+  // incremented every time a block is returned to a pool
+  uint64_t free_counter = 0;
+
+  // allocation history: ring buffer of the last max_trace_entries events
+  bool record_history = false;
+  bool record_backtraces = false;
+  size_t max_trace_entries = 0;
+  size_t next_trace_entry = 0;
+  std::vector<TraceEntry> trace_entries;
+
+  // Members specific to CUDA graphs
+
+  // private pools of CUDA graphs
+  std::unordered_map<MempoolId_t, std::unique_ptr<PrivatePool>, MempoolIdHash> graph_pools;
+  // private pools no live graph uses anymore, whose memory may be released
+  std::map<MempoolId_t, PrivatePool*> graph_pools_freeable;
+  // maps a capture underway to the private pool it allocates from
+  std::unordered_map<CaptureId_t, MempoolId_t> capture_to_pool_map;
+  // number of captures underway on this device
+  int captures_underway = 0;
+  // blocks freed during capture whose uses on other streams still need
+  // events, which can only be recorded once no capture is underway
+  std::vector<Block*> needs_events_deferred_until_no_capture;
+
  public:
 
   DeviceCachingAllocator() :
-      large_blocks(BlockComparator),
-      small_blocks(BlockComparator) {}
+      large_blocks(BlockComparator, /*small=*/false),
+      small_blocks(BlockComparator, /*small=*/true),
+      use_expandable_segments(expandable_segments_requested()) {}
 
   // All public methods (except the above) acquire the allocator mutex.
   // Thus, do not call a public method from another public method.
@@ -215,11 +481,14 @@ class DeviceCachingAllocator {
   {
     std::unique_lock<std::recursive_mutex> lock(mutex);
 
-    // process outstanding cudaEvents
-    process_events();
+    if (C10_LIKELY(captures_underway == 0)) {
+      // process outstanding cudaEvents. Querying events recorded by a
+      // capturing stream is illegal.
+      process_events();
+    }
 
     size = round_size(size);
-    auto& pool = get_pool(size);
+    auto& pool = get_pool(size, stream);
     const size_t alloc_size = get_allocation_size(size);
     AllocParams params(device, size, stream, &pool, alloc_size, stats);
     params.stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
@@ -229,11 +498,12 @@ class DeviceCachingAllocator {
       // Search pool
       get_free_block(params)
       // Trigger callbacks and retry search
-      || (trigger_free_memory_callbacks(params) && get_free_block(params))
+      || (captures_underway == 0 && trigger_free_memory_callbacks(params) && get_free_block(params))
       // Attempt allocate
       || alloc_block(params, false)
-      // Free all non-split cached blocks and retry alloc.
-      || (free_cached_blocks() && alloc_block(params, true));
+      // Free all non-split cached blocks and retry alloc. cudaFree is
+      // illegal during capture.
+      || (captures_underway == 0 && free_cached_blocks() && alloc_block(params, true));
 
     TORCH_INTERNAL_ASSERT((!block_found && params.err != cudaSuccess) || params.block);
     if (!block_found) {
@@ -243,6 +513,7 @@ class DeviceCachingAllocator {
         C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
 
         stats.num_ooms += 1;
+        record_trace(TraceEventAction::OOM, 0, alloc_size, stream, device);
 
         // "total capacity": total global memory on GPU
         // "already allocated": memory allocated by the program using the
@@ -261,13 +532,18 @@ class DeviceCachingAllocator {
         // Note that at this point free_cached_blocks has already returned all
         // possible "cached" memory to the driver. The only remaining "cached"
         // memory is split from a larger block that is partially in-use.
+        std::string allowed_info;
+        if (allowed_memory_maximum != 0) {
+          allowed_info = "; " + format_size(allowed_memory_maximum) + " allowed";
+        }
         TORCH_CHECK_WITH(CUDAOutOfMemoryError, false,
           "CUDA out of memory. Tried to allocate ", format_size(alloc_size),
           " (GPU ", device, "; ",
           format_size(device_total), " total capacity; ",
           format_size(stats.allocated_bytes[static_cast<size_t>(StatType::AGGREGATE)].current),
           " already allocated; ",
-          format_size(device_free), " free; ",
+          format_size(device_free), " free",
+          allowed_info, "; ",
           format_size(stats.reserved_bytes[static_cast<size_t>(StatType::AGGREGATE)].current),
           " reserved in total by PyTorch)");
       } else {
@@ -284,6 +560,7 @@ class DeviceCachingAllocator {
       remaining = block;
 
       block = new Block(device, stream, size, &pool, block->ptr);
+      block->expandable_segment = remaining->expandable_segment;
       block->prev = remaining->prev;
       if (block->prev) {
         block->prev->next = block;
@@ -293,7 +570,7 @@ class DeviceCachingAllocator {
       remaining->prev = block;
       remaining->ptr = static_cast<char*>(remaining->ptr) + size;
       remaining->size -= size;
-      pool.insert(remaining);
+      pool.blocks.insert(remaining);
 
       if (already_split) {
         // An already-split inactive block is being shrunk by size bytes.
@@ -321,6 +598,8 @@ class DeviceCachingAllocator {
     update_stat_array(stats.active, 1, params.stat_types);
     update_stat_array(stats.active_bytes, block->size, params.stat_types);
 
+    record_trace(TraceEventAction::ALLOC, block->ptr, block->size, block->stream, block->device);
+
     return block;
   }
 
@@ -339,8 +618,16 @@ class DeviceCachingAllocator {
     update_stat_array(stats.allocation, -1, {stat_types});
     update_stat_array(stats.allocated_bytes, -block->size, {stat_types});
 
+    record_trace(TraceEventAction::FREE, block->ptr, block->size, block->stream, block->device);
+
     if (!block->stream_uses.empty()) {
-      insert_events(block);
+      if (C10_UNLIKELY(captures_underway)) {
+        // Events recorded by a capturing stream can't be queried, so the
+        // block waits for the end of the capture
+        needs_events_deferred_until_no_capture.push_back(block);
+      } else {
+        insert_events(block);
+      }
     } else {
       free_block(block);
     }
@@ -376,6 +663,8 @@ class DeviceCachingAllocator {
   /** returns cached blocks to the system allocator **/
   void emptyCache() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(captures_underway == 0,
+        "emptyCache() is not allowed while a CUDA graph is being captured");
     free_cached_blocks();
   }
 
@@ -433,6 +722,82 @@ class DeviceCachingAllocator {
     }
   }
 
+  /** Sets the cap on reserved memory; 0 removes it **/
+  void setMemoryLimit(size_t limit) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    allowed_memory_maximum = limit;
+  }
+
+  /** Sets the soft limit on reserved memory; 0 removes it **/
+  void setSoftMemoryLimit(size_t limit) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    soft_memory_limit = limit;
+    soft_limit_exceeded = false;
+  }
+
+  /** Starts, stops or resizes the allocation history **/
+  void recordHistory(bool enabled, size_t max_entries, bool backtraces) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    record_history = enabled && max_entries > 0;
+    record_backtraces = backtraces;
+    if (!record_history || max_entries != max_trace_entries) {
+      trace_entries.clear();
+      trace_entries.shrink_to_fit();
+      next_trace_entry = 0;
+    }
+    max_trace_entries = record_history ? max_entries : 0;
+  }
+
+  /** Returns the recorded allocation history, oldest event first **/
+  std::vector<TraceEntry> history() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<TraceEntry> result;
+    result.reserve(trace_entries.size());
+    // Once the ring buffer is full, next_trace_entry points at the oldest
+    // entry.
+    result.insert(result.end(), trace_entries.begin() + next_trace_entry, trace_entries.end());
+    result.insert(result.end(), trace_entries.begin(), trace_entries.begin() + next_trace_entry);
+    return result;
+  }
+
+  /** Routes allocations of capture graph_id to the private pool mempool_id, creating it if needed **/
+  void notifyCaptureBegin(CaptureId_t graph_id, MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = graph_pools.find(mempool_id);
+    if (it == graph_pools.end()) {
+      graph_pools.emplace(mempool_id, std::unique_ptr<PrivatePool>(new PrivatePool()));
+    } else if (it->second->use_count++ == 0) {
+      // The pool was released by the graphs that used it, but still holds
+      // memory; it is in use again.
+      graph_pools_freeable.erase(mempool_id);
+    }
+    const bool inserted = capture_to_pool_map.emplace(graph_id, mempool_id).second;
+    TORCH_INTERNAL_ASSERT(inserted, "capture ", graph_id, " was already assigned a private pool");
+    captures_underway++;
+  }
+
+  /** Stops routing allocations of capture graph_id to its private pool **/
+  void notifyCaptureEnd(CaptureId_t graph_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_INTERNAL_ASSERT(captures_underway > 0);
+    captures_underway--;
+    const size_t erased = capture_to_pool_map.erase(graph_id);
+    TORCH_INTERNAL_ASSERT(erased == 1, "capture ", graph_id, " has no private pool");
+  }
+
+  /** Called when a graph using mempool_id is destroyed; the pool's memory may be released once no graph uses it **/
+  void notifyCaptureDestroy(MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = graph_pools.find(mempool_id);
+    TORCH_INTERNAL_ASSERT(it != graph_pools.end(), "unknown private pool");
+    const int use_count = --(it->second->use_count);
+    TORCH_INTERNAL_ASSERT(use_count >= 0);
+    if (use_count == 0) {
+      const bool inserted = graph_pools_freeable.emplace(mempool_id, it->second.get()).second;
+      TORCH_INTERNAL_ASSERT(inserted);
+    }
+  }
+
   /** Dump a complete snapshot of the memory held by the allocator. Potentially VERY expensive. **/
   std::vector<SegmentInfo> snapshot() const {
     std::lock_guard<std::recursive_mutex> lock(mutex);
@@ -448,7 +813,8 @@ class DeviceCachingAllocator {
       SegmentInfo& segment_info = result.back();
       segment_info.device = head_block->device;
       segment_info.address = reinterpret_cast<int64_t>(head_block->ptr);
-      segment_info.is_large = (head_block->pool == &large_blocks);
+      segment_info.is_large = !head_block->pool->is_small;
+      segment_info.is_expandable = (head_block->expandable_segment != nullptr);
 
       const Block* block = head_block;
       while (block != nullptr) {
@@ -490,10 +856,39 @@ class DeviceCachingAllocator {
 
   // All private methods do not acquire the allocator mutex.
 
+  void record_trace(TraceEventAction action, const void* ptr, size_t size, cudaStream_t stream, int device) {
+    if (C10_LIKELY(!record_history)) {
+      return;
+    }
+    TraceEntry entry;
+    entry.action = action;
+    entry.device = device;
+    entry.address = reinterpret_cast<int64_t>(ptr);
+    entry.size = size;
+    entry.stream = stream;
+    entry.time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (record_backtraces) {
+      entry.backtrace = c10::get_backtrace(/*frames_to_skip=*/2);
+    }
+    if (trace_entries.size() < max_trace_entries) {
+      trace_entries.emplace_back(std::move(entry));
+      next_trace_entry = trace_entries.size() % max_trace_entries;
+    } else {
+      trace_entries[next_trace_entry] = std::move(entry);
+      next_trace_entry = (next_trace_entry + 1) % max_trace_entries;
+    }
+  }
+
   std::vector<const Block*> get_all_blocks() const {
     std::vector<const Block*> blocks;
-    blocks.insert(blocks.end(), small_blocks.begin(), small_blocks.end());
-    blocks.insert(blocks.end(), large_blocks.begin(), large_blocks.end());
+    blocks.insert(blocks.end(), small_blocks.blocks.begin(), small_blocks.blocks.end());
+    blocks.insert(blocks.end(), large_blocks.blocks.begin(), large_blocks.blocks.end());
+    for (const auto& gp : graph_pools) {
+      const PrivatePool& private_pool = *gp.second;
+      blocks.insert(blocks.end(), private_pool.small_blocks.blocks.begin(), private_pool.small_blocks.blocks.end());
+      blocks.insert(blocks.end(), private_pool.large_blocks.blocks.begin(), private_pool.large_blocks.blocks.end());
+    }
     blocks.insert(blocks.end(), active_blocks.begin(), active_blocks.end());
     return blocks;
   }
@@ -519,7 +914,8 @@ class DeviceCachingAllocator {
     }
 
     active_blocks.erase(block);
-    pool.insert(block);
+    block->free_order = ++free_counter;
+    pool.blocks.insert(block);
 
     if (block->is_split()) {
       net_change_inactive_split_blocks += 1;
@@ -559,13 +955,34 @@ class DeviceCachingAllocator {
 
     const size_t subsumed_size = src->size;
     dst->size += subsumed_size;
-    pool.erase(src);
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    if (src->expandable_segment && src->expandable_segment->tail == src) {
+      src->expandable_segment->tail = dst;
+    }
+#endif
+    pool.blocks.erase(src);
     delete src;
 
     return subsumed_size;
   }
 
-  BlockPool& get_pool(size_t size) {
+  BlockPool& get_pool(size_t size, cudaStream_t stream) {
+#ifdef C10_CUDA_GRAPHS
+    if (C10_UNLIKELY(captures_underway)) {
+      CaptureId_t id;
+      cudaStreamCaptureStatus status;
+      C10_CUDA_CHECK(cudaStreamGetCaptureInfo(stream, &status, &id));
+      if (status != cudaStreamCaptureStatusNone) {
+        auto it0 = capture_to_pool_map.find(id);
+        TORCH_INTERNAL_ASSERT(it0 != capture_to_pool_map.end(),
+            "allocation from a stream taking part in a capture the allocator was not notified of");
+        auto it1 = graph_pools.find(it0->second);
+        TORCH_INTERNAL_ASSERT(it1 != graph_pools.end());
+        PrivatePool& private_pool = *it1->second;
+        return size <= kSmallSize ? private_pool.small_blocks : private_pool.large_blocks;
+      }
+    }
+#endif
     if (size <= kSmallSize) {
       return small_blocks;
     } else {
@@ -574,23 +991,15 @@ class DeviceCachingAllocator {
   }
 
   StatType get_stat_type_for_pool(const BlockPool& pool) {
-    if (&pool == &small_blocks) {
-      return StatType::SMALL_POOL;
-    } else if (&pool == &large_blocks) {
-      return StatType::LARGE_POOL;
-    } else {
-      AT_ERROR("get_stat_type_for_pool: invalid pool");
-    }
+    return pool.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL;
   }
 
   bool should_split(const Block* block, size_t size) {
     size_t remaining = block->size - size;
-    if (block->pool == &small_blocks) {
+    if (block->pool->is_small) {
       return remaining >= kMinBlockSize;
-    } else if (block->pool == &large_blocks) {
-      return remaining > kSmallSize;
     } else {
-      AT_ERROR("should_split: invalid pool");
+      return remaining > kSmallSize;
     }
   }
 
@@ -606,11 +1015,11 @@ class DeviceCachingAllocator {
 
   bool get_free_block(AllocParams& p) {
     BlockPool& pool = *p.pool;
-    auto it = pool.lower_bound(&p.search_key);
-    if (it == pool.end() || (*it)->stream != p.stream())
+    auto it = pool.blocks.lower_bound(&p.search_key);
+    if (it == pool.blocks.end() || (*it)->stream != p.stream())
       return false;
     p.block = *it;
-    pool.erase(it);
+    pool.blocks.erase(it);
     return true;
   }
 
@@ -631,6 +1040,15 @@ class DeviceCachingAllocator {
       stats.num_alloc_retries += 1;
     }
 
+    if (!enforce_memory_limits(p.device(), size)) {
+      p.err = cudaErrorMemoryAllocation;
+      return false;
+    }
+
+    if (use_expandable_segments && p.pool == &large_blocks) {
+      return alloc_expandable_block(p);
+    }
+
     p.err = cudaMalloc(&ptr, size);
     if (p.err != cudaSuccess) {
       if (!isRetry || p.err == cudaErrorMemoryAllocation)
@@ -638,9 +1056,15 @@ class DeviceCachingAllocator {
       return false;
     }
 
+    if (p.pool->owner_PrivatePool) {
+      // The block stays in the private pool until the pool is freed
+      p.pool->owner_PrivatePool->cudaMalloc_count++;
+    }
+
     p.block = new Block(p.device(), p.stream(), size, p.pool, (char*)ptr);
     update_stat_array(stats.segment, 1, p.stat_types);
     update_stat_array(stats.reserved_bytes, size, p.stat_types);
+    record_trace(TraceEventAction::SEGMENT_MAP, ptr, size, p.stream(), p.device());
 
     return (p.block != nullptr);
   }
@@ -654,34 +1078,285 @@ class DeviceCachingAllocator {
     // Free all non-split cached blocks
     free_blocks(large_blocks);
     free_blocks(small_blocks);
+    release_expandable_segments();
+
+    // Free the cached blocks of private pools no graph uses anymore. A pool
+    // goes away once all of its segments were released.
+    auto it = graph_pools_freeable.begin();
+    while (it != graph_pools_freeable.end()) {
+      PrivatePool* private_pool = it->second;
+      free_blocks(private_pool->large_blocks);
+      free_blocks(private_pool->small_blocks);
+      if (private_pool->cudaMalloc_count == 0) {
+        const size_t erased = graph_pools.erase(it->first);
+        TORCH_INTERNAL_ASSERT(erased == 1);
+        it = graph_pools_freeable.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return true;
+  }
+
+  static bool expandable_segments_requested() {
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    const char* env = std::getenv("PYTORCH_CUDA_EXPANDABLE_SEGMENTS");
+    if (env == nullptr || std::string(env) != "1") {
+      return false;
+    }
+    if (!DriverAPI::get()) {
+      TORCH_WARN_ONCE(
+          "PYTORCH_CUDA_EXPANDABLE_SEGMENTS is set but the CUDA driver does "
+          "not provide the virtual memory management API; ignoring it.");
+      return false;
+    }
     return true;
+#else
+    return false;
+#endif
   }
 
-  void free_blocks(BlockPool& blocks)
+  /** grows the expandable segment of p's stream so that its free tail can hold p.size() bytes */
+  bool alloc_expandable_block(AllocParams& p) {
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    const DriverAPI* driver = DriverAPI::get();
+    auto& segment = expandable_segments[p.stream()];
+    if (!segment) {
+      size_t device_free;
+      size_t device_total;
+      C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+
+      CUmemAllocationProp prop = {};
+      prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+      prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+      prop.location.id = p.device();
+      size_t page_size = 0;
+      C10_CUDA_DRIVER_CHECK(driver->cuMemGetAllocationGranularity_(
+          &page_size, &prop, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
+      segment.reset(new ExpandableSegment(p.device(), p.stream(), device_total, page_size));
+    }
+
+    Block* tail = segment->tail;
+    const bool tail_is_free = tail && !tail->allocated && tail->event_count == 0;
+    const bool tail_was_split = tail && tail->is_split();
+    const size_t old_size = segment->size();
+    const size_t needed = p.size() - (tail_is_free ? std::min(tail->size, p.size()) : 0);
+    if (!segment->grow(old_size + needed)) {
+      if (old_size == 0) {
+        segment->release();
+        expandable_segments.erase(p.stream());
+      }
+      p.err = cudaErrorMemoryAllocation;
+      return false;
+    }
+    const size_t mapped = segment->size() - old_size;
+
+    if (old_size == 0) {
+      update_stat_array(stats.segment, 1, p.stat_types);
+    }
+    update_stat_array(stats.reserved_bytes, mapped, p.stat_types);
+    record_trace(TraceEventAction::SEGMENT_MAP, segment->ptr() + old_size, mapped, p.stream(), p.device());
+
+    Block* block = new Block(p.device(), p.stream(), mapped, p.pool, segment->ptr() + old_size);
+    block->expandable_segment = segment.get();
+    block->prev = tail;
+    if (tail) {
+      tail->next = block;
+    }
+    segment->tail = block;
+
+    if (tail_is_free) {
+      // The free tail is absorbed into the newly mapped block. If the tail
+      // was counted as an inactive split block, the merged block takes its
+      // place.
+      try_merge_blocks(block, tail, *p.pool);
+      if (tail_was_split) {
+        update_stat_array(stats.inactive_split_bytes, mapped, p.stat_types);
+      }
+    } else if (tail) {
+      // A new inactive split block is created behind an active block.
+      update_stat_array(stats.inactive_split, 1, p.stat_types);
+      update_stat_array(stats.inactive_split_bytes, block->size, p.stat_types);
+    }
+
+    p.block = block;
+    return true;
+#else
+    p.err = cudaErrorMemoryAllocation;
+    return false;
+#endif
+  }
+
+  /** unmaps the free pages at the end of every expandable segment */
+  void release_expandable_segments()
   {
-    // Frees all non-split blocks
-    auto it = blocks.begin();
-    while (it != blocks.end()) {
-      Block* block = *it;
-      if (!block->prev && !block->next) {
-        C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+
+    auto it = expandable_segments.begin();
+    while (it != expandable_segments.end()) {
+      ExpandableSegment* segment = it->second.get();
+      Block* tail = segment->tail;
+      if (!tail || tail->allocated || tail->event_count > 0) {
+        ++it;
+        continue;
+      }
+
+      const size_t tail_offset = static_cast<char*>(tail->ptr) - segment->ptr();
+      const size_t keep_pages = (tail_offset + segment->page_size - 1) / segment->page_size;
+      const size_t unmapped = segment->size() - keep_pages * segment->page_size;
+      if (unmapped == 0) {
+        ++it;
+        continue;
+      }
+
+      const bool tail_was_split = tail->is_split();
+      large_blocks.blocks.erase(tail);
+      segment->unmap(keep_pages);
+      tail->size -= unmapped;
+      record_trace(
+          TraceEventAction::SEGMENT_UNMAP, segment->ptr() + segment->size(),
+          unmapped, segment->stream, segment->device);
+      update_stat_array(stats.reserved_bytes, -unmapped, stat_types);
+      if (tail_was_split) {
+        update_stat_array(stats.inactive_split_bytes, -unmapped, stat_types);
+      }
 
-        StatTypes stat_types;
-        stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
-        stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
+      if (tail->size == 0) {
+        if (tail_was_split) {
+          update_stat_array(stats.inactive_split, -1, stat_types);
+        }
+        segment->tail = tail->prev;
+        if (tail->prev) {
+          tail->prev->next = nullptr;
+        }
+        delete tail;
+      } else {
+        large_blocks.blocks.insert(tail);
+      }
+
+      if (segment->size() == 0) {
+        segment->release();
         update_stat_array(stats.segment, -1, stat_types);
-        update_stat_array(stats.reserved_bytes, -block->size, stat_types);
+        it = expandable_segments.erase(it);
+      } else {
+        ++it;
+      }
+    }
+#endif
+  }
+
+  static bool is_releasable(const Block* block) {
+    return !block->prev && !block->next && !block->expandable_segment;
+  }
+
+  /** cudaFrees a cached, non-split block. The caller removes it from its pool. */
+  void release_block(Block* block)
+  {
+    C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+    record_trace(TraceEventAction::SEGMENT_UNMAP, block->ptr, block->size, block->stream, block->device);
+
+    if (block->pool->owner_PrivatePool) {
+      TORCH_INTERNAL_ASSERT(block->pool->owner_PrivatePool->cudaMalloc_count > 0);
+      block->pool->owner_PrivatePool->cudaMalloc_count--;
+    }
+
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
+    update_stat_array(stats.segment, -1, stat_types);
+    update_stat_array(stats.reserved_bytes, -block->size, stat_types);
 
+    delete block;
+  }
+
+  void free_blocks(BlockPool& pool)
+  {
+    // Frees all non-split blocks
+    auto it = pool.blocks.begin();
+    while (it != pool.blocks.end()) {
+      Block* block = *it;
+      if (is_releasable(block)) {
         auto cur = it;
         ++it;
-        blocks.erase(cur);
-        delete block;
+        pool.blocks.erase(cur);
+        release_block(block);
       } else {
         ++it;
       }
     }
   }
 
+  /** frees non-split cached blocks, least recently freed first, until at least `bytes` are released */
+  size_t free_lru_blocks(size_t bytes)
+  {
+    std::vector<Block*> candidates;
+    for (BlockPool* pool : {&large_blocks, &small_blocks}) {
+      for (Block* block : pool->blocks) {
+        if (is_releasable(block)) {
+          candidates.push_back(block);
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Block* a, const Block* b) {
+      return a->free_order < b->free_order;
+    });
+
+    size_t freed = 0;
+    for (Block* block : candidates) {
+      if (freed >= bytes) {
+        break;
+      }
+      freed += block->size;
+      block->pool->blocks.erase(block);
+      release_block(block);
+    }
+    return freed;
+  }
+
+  /** makes room for reserving `size` more bytes under the hard and soft limits. returns false if the hard limit can't be met. */
+  bool enforce_memory_limits(int device, size_t size)
+  {
+    if (allowed_memory_maximum == 0 && soft_memory_limit == 0) {
+      return true;
+    }
+    const auto reserved = [&]() -> size_t {
+      return stats.reserved_bytes[static_cast<size_t>(StatType::AGGREGATE)].current;
+    };
+    if (C10_UNLIKELY(captures_underway)) {
+      // Nothing can be released during capture
+      return allowed_memory_maximum == 0 || reserved() + size <= allowed_memory_maximum;
+    }
+
+    if (allowed_memory_maximum != 0 && reserved() + size > allowed_memory_maximum) {
+      free_lru_blocks(reserved() + size - allowed_memory_maximum);
+      if (reserved() + size > allowed_memory_maximum) {
+        release_expandable_segments();
+      }
+      if (reserved() + size > allowed_memory_maximum) {
+        return false;
+      }
+    }
+
+    if (soft_memory_limit != 0) {
+      if (reserved() + size > soft_memory_limit) {
+        free_lru_blocks(reserved() + size - soft_memory_limit);
+      }
+      if (reserved() + size <= soft_memory_limit) {
+        soft_limit_exceeded = false;
+      } else if (!soft_limit_exceeded) {
+        soft_limit_exceeded = true;
+        for (const auto& name : FreeCudaMemoryCallbacksRegistry()->Keys()) {
+          FreeCudaMemoryCallbacksRegistry()->Create(name)->ExecuteSoftLimit(
+              device, reserved() + size, soft_memory_limit);
+        }
+      }
+    }
+    return true;
+  }
+
   cudaEvent_t create_event_internal() {
     cudaEvent_t event;
     C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
@@ -695,6 +1370,8 @@ class DeviceCachingAllocator {
   void synchronize_and_free_events() {
     // Synchronize on outstanding events and then free associated blocks.
 
+    insert_events_deferred_until_no_capture();
+
     for (auto& e : cuda_events) {
       cudaEvent_t event = e.first;
       Block* block = e.second;
@@ -731,8 +1408,19 @@ class DeviceCachingAllocator {
     C10_CUDA_CHECK(cudaSetDevice(prev_device));
   }
 
+  void insert_events_deferred_until_no_capture()
+  {
+    for (Block* block : needs_events_deferred_until_no_capture) {
+      TORCH_INTERNAL_ASSERT(!block->stream_uses.empty());
+      insert_events(block);
+    }
+    needs_events_deferred_until_no_capture.clear();
+  }
+
   void process_events()
   {
+    insert_events_deferred_until_no_capture();
+
     // Process outstanding cudaEvents. Events that are completed are removed
     // from the queue, and the 'event_count' for the corresponding allocation
     // is decremented. Stops at the first event which has not been completed.
@@ -763,9 +1451,9 @@ class DeviceCachingAllocator {
   }
 
   // Accumulates sizes of all memory blocks for given device in given pool
-  void cache_info_aux(BlockPool& blocks, size_t* total, size_t* largest)
+  void cache_info_aux(BlockPool& pool, size_t* total, size_t* largest)
   {
-    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+    for (auto it = pool.blocks.begin(); it != pool.blocks.end(); ++it) {
       size_t blocksize = (*it)->size;
       *total += blocksize;
       if (blocksize > *largest) {
@@ -787,6 +1475,12 @@ class THCCachingAllocator {
   // lock around calls to cudaFree (to prevent deadlocks with NCCL)
   mutable std::mutex cuda_free_mutex;
 
+  // last recordHistory() settings, applied to device allocators created
+  // later by init()
+  bool record_history = false;
+  size_t max_trace_entries = 0;
+  bool record_backtraces = false;
+
   void add_allocated_block(Block* block) {
     std::lock_guard<std::mutex> lock(mutex);
     allocated_blocks[block->ptr] = block;
@@ -814,11 +1508,15 @@ class THCCachingAllocator {
   }
 
   void init(int device_count) {
+    std::lock_guard<std::mutex> lock(mutex);
     int size = device_allocator.size();
     if (size < device_count) {
       device_allocator.resize(device_count);
       for (int i = size; i < device_count; i++) {
         device_allocator[i] = std::unique_ptr<DeviceCachingAllocator>(new DeviceCachingAllocator());
+        if (record_history) {
+          device_allocator[i]->recordHistory(true, max_trace_entries, record_backtraces);
+        }
       }
     }
   }
@@ -892,6 +1590,31 @@ class THCCachingAllocator {
 
     return result;
   }
+
+  void recordHistory(bool enabled, size_t max_entries, bool backtraces) {
+    std::lock_guard<std::mutex> lock(mutex);
+    record_history = enabled && max_entries > 0;
+    max_trace_entries = max_entries;
+    record_backtraces = backtraces;
+    int count = device_allocator.size();
+    for (int i = 0; i < count; i++) {
+      device_allocator[i]->recordHistory(enabled, max_entries, backtraces);
+    }
+  }
+
+  std::vector<TraceEntry> history() {
+    std::vector<TraceEntry> result;
+    int count = device_allocator.size();
+    for (int i = 0; i < count; i++) {
+      auto entries = device_allocator[i]->history();
+      result.insert(
+          result.end(),
+          std::make_move_iterator(entries.begin()),
+          std::make_move_iterator(entries.end()));
+    }
+
+    return result;
+  }
 };
 
 THCCachingAllocator caching_allocator;
@@ -972,6 +1695,54 @@ std::vector<SegmentInfo> snapshot() {
   return caching_allocator.snapshot();
 }
 
+void setMemoryFraction(double fraction, int device) {
+  assertValidDevice(device);
+  TORCH_CHECK(
+      fraction > 0 && fraction <= 1,
+      "invalid fraction: ", fraction, ". Please set within (0, 1].");
+  size_t device_free;
+  size_t device_total;
+  {
+    cuda::CUDAGuard device_guard(device);
+    C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+  }
+  caching_allocator.device_allocator[device]->setMemoryLimit(
+      static_cast<size_t>(fraction * device_total));
+}
+
+void setMemoryLimit(size_t limit_bytes, int device) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->setMemoryLimit(limit_bytes);
+}
+
+void setSoftMemoryLimit(size_t limit_bytes, int device) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->setSoftMemoryLimit(limit_bytes);
+}
+
+void recordHistory(bool enabled, size_t max_entries, bool record_backtraces) {
+  caching_allocator.recordHistory(enabled, max_entries, record_backtraces);
+}
+
+std::vector<TraceEntry> history() {
+  return caching_allocator.history();
+}
+
+void notifyCaptureBegin(int device, CaptureId_t graph_id, MempoolId_t mempool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureBegin(graph_id, mempool_id);
+}
+
+void notifyCaptureEnd(int device, CaptureId_t graph_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureEnd(graph_id);
+}
+
+void notifyCaptureDestroy(int device, MempoolId_t mempool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureDestroy(mempool_id);
+}
+
 //
 // In CUDA IPC, sender sends a tensor to receiver, getIpcDevPtr
 // is called by the receiving process to map the CUDA memory from the sending
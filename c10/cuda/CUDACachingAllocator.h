@@ -8,6 +8,7 @@
 
 #include <array>
 #include <mutex>
+#include <utility>
 
 namespace c10 {
 
@@ -21,6 +22,12 @@ class C10_CUDA_API FreeMemoryCallback {
  public:
   virtual ~FreeMemoryCallback() {};
   virtual bool Execute() = 0;
+  // Caching allocator will execute every registered callback's
+  // ExecuteSoftLimit when the memory it reserves on `device` crosses the soft
+  // limit set with setSoftMemoryLimit(), and releasing its own cached blocks
+  // was not enough to get back below it. Implementations may, for instance,
+  // ask other processes sharing the device to shrink their caches.
+  virtual void ExecuteSoftLimit(int device, size_t reserved_bytes, size_t soft_limit) {}
 };
 
 C10_DECLARE_REGISTRY(FreeCudaMemoryCallbacksRegistry, FreeMemoryCallback);
@@ -102,9 +109,42 @@ struct SegmentInfo {
   int64_t allocated_size = 0;
   int64_t active_size = 0;
   bool is_large = false;
+  // true if the segment is a virtual address range that grows on demand
+  // (PYTORCH_CUDA_EXPANDABLE_SEGMENTS=1)
+  bool is_expandable = false;
   std::vector<BlockInfo> blocks;
 };
 
+// Kind of allocator event recorded in the allocation history.
+enum struct TraceEventAction : uint8_t {
+  ALLOC,         // client code received a block
+  FREE,          // client code released a block
+  SEGMENT_MAP,   // new device memory was obtained (cudaMalloc or page map)
+  SEGMENT_UNMAP, // device memory was given back (cudaFree or page unmap)
+  OOM            // an allocation failed after flushing the cache
+};
+
+// A single entry of the allocation history (see recordHistory()).
+struct TraceEntry {
+  TraceEventAction action = TraceEventAction::ALLOC;
+  int64_t device = 0;
+  int64_t address = 0;
+  int64_t size = 0;
+  cudaStream_t stream = nullptr;
+  // microseconds since epoch
+  int64_t time_us = 0;
+  // empty unless backtraces are recorded
+  std::string backtrace;
+};
+
+// Identifies a CUDA graph capture, as reported by cudaStreamGetCaptureInfo.
+using CaptureId_t = unsigned long long;
+
+// Identifies a private memory pool for CUDA graphs. {capture id, 0} is the
+// pool a graph creates for itself, {0, id} a pool obtained from
+// at::cuda::graph_pool_handle() before any capture uses it.
+using MempoolId_t = std::pair<CaptureId_t, CaptureId_t>;
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void* raw_alloc_with_stream(size_t nbytes, cudaStream_t stream);
 C10_CUDA_API void raw_delete(void* ptr);
@@ -120,6 +160,40 @@ C10_CUDA_API void resetAccumulatedStats(int device);
 C10_CUDA_API void resetPeakStats(int device);
 C10_CUDA_API std::vector<SegmentInfo> snapshot();
 
+// Caps the memory reserved by the caching allocator on `device` to `fraction`
+// of the device's total memory. Once the cap is reached, cached blocks are
+// released in least-recently-freed order before falling back to an
+// out-of-memory error.
+C10_CUDA_API void setMemoryFraction(double fraction, int device);
+// Same as setMemoryFraction(), with the cap given in bytes. 0 removes the
+// cap.
+C10_CUDA_API void setMemoryLimit(size_t limit_bytes, int device);
+// Sets a soft limit on the memory reserved on `device`. Exceeding it first
+// releases cached blocks in least-recently-freed order, then triggers
+// FreeMemoryCallback::ExecuteSoftLimit; the allocation itself still succeeds.
+// 0 removes the soft limit.
+C10_CUDA_API void setSoftMemoryLimit(size_t limit_bytes, int device);
+
+// Enables or disables recording of allocator events on every device. Each
+// device keeps the most recent `max_entries` events in a ring buffer;
+// disabling recording clears the buffers. Capturing a backtrace per event is
+// expensive and only done if `record_backtraces` is set. When recording is
+// off, the allocator's hot path does not touch the history at all. The
+// setting also applies to devices whose allocator is initialized later.
+C10_CUDA_API void recordHistory(bool enabled, size_t max_entries, bool record_backtraces);
+// Returns the recorded events of all devices, oldest first per device.
+C10_CUDA_API std::vector<TraceEntry> history();
+
+// CUDA graphs support. While a capture is underway on `device`, allocations
+// from streams taking part in capture `graph_id` come from the private pool
+// `mempool_id`, and blocks of that pool are never handed to allocations
+// outside of it. Memory in the pool stays reserved until every graph using it
+// was destroyed (notifyCaptureDestroy), so replays can keep reading and
+// writing the addresses baked in at capture.
+C10_CUDA_API void notifyCaptureBegin(int device, CaptureId_t graph_id, MempoolId_t mempool_id);
+C10_CUDA_API void notifyCaptureEnd(int device, CaptureId_t graph_id);
+C10_CUDA_API void notifyCaptureDestroy(int device, MempoolId_t mempool_id);
+
 C10_CUDA_API std::mutex* getFreeMutex();
 
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
@@ -6,7 +6,9 @@
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <cstdlib>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include <iostream>
@@ -39,9 +41,22 @@ struct LeakyStreamInternals {
 
 // Global stream state and constants
 static DeviceIndex num_gpus = -1;
-static constexpr int kStreamsPerPoolBits = 5;
-static constexpr int kStreamsPerPool = 1 << kStreamsPerPoolBits;
+static constexpr int kStreamsPerPoolBits = 8;
+static constexpr int kMaxStreamsPerPool = 1 << kStreamsPerPoolBits;
+static constexpr int kDefaultStreamsPerPool = 32;
 static constexpr unsigned int kDefaultFlags = cudaStreamNonBlocking;
+// Like cudaStreamPerThread, the per-thread streams synchronize with the
+// legacy default stream, so code that still enqueues work on it (or calls
+// the synchronous CUDA APIs) keeps its ordering with them.
+static constexpr unsigned int kPerThreadFlags = cudaStreamDefault;
+
+// The number of streams of each pool, PYTORCH_CUDA_STREAM_POOL_SIZE (at most
+// kMaxStreamsPerPool), and whether every thread starts on a stream of its own
+// from the per-thread pool instead of on the default stream,
+// PYTORCH_CUDA_PER_THREAD_DEFAULT_STREAM=1. Both are read once, when the
+// streams are first used.
+static int streams_per_pool = kDefaultStreamsPerPool;
+static bool per_thread_default_streams = false;
 
 // Note: stream priority is not supported by HIP
 // Note: lower numbers are higher priorities, zero is default priority
@@ -68,22 +83,33 @@ static LeakyStreamInternals default_streams[C10_COMPILE_TIME_MAX_GPUS];
 static std::once_flag device_flags[C10_COMPILE_TIME_MAX_GPUS];
 static std::atomic<uint32_t> low_priority_counters[C10_COMPILE_TIME_MAX_GPUS];
 static std::atomic<uint32_t> high_priority_counters[C10_COMPILE_TIME_MAX_GPUS];
-static std::array<LeakyStreamInternals, kStreamsPerPool>
+static std::array<LeakyStreamInternals, kMaxStreamsPerPool>
     low_priority_streams[C10_COMPILE_TIME_MAX_GPUS];
-static std::array<LeakyStreamInternals, kStreamsPerPool>
+static std::array<LeakyStreamInternals, kMaxStreamsPerPool>
     high_priority_streams[C10_COMPILE_TIME_MAX_GPUS];
 
+// Per-thread streams
+// Note: a thread is assigned an index into the per-thread pools, the same on
+// every device, the first time it needs its per-thread stream, round-robin
+// unless it set one with setStreamAffinity. The pool of a device is lazily
+// created like the low and high priority pools.
+static std::once_flag per_thread_device_flags[C10_COMPILE_TIME_MAX_GPUS];
+static std::atomic<uint32_t> per_thread_counter{0};
+static std::array<LeakyStreamInternals, kMaxStreamsPerPool>
+    per_thread_streams[C10_COMPILE_TIME_MAX_GPUS];
+
 // Note [StreamId assignment]
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~
 // How do we assign stream IDs?
 //
-// -- 25 bits -- -- 2 bits --  -- 5 bits -----
+// -- 22 bits -- -- 2 bits --  -- 8 bits -----
 // zeros         StreamIdType  stream id index
 //
 // Where StreamIdType:
 //  00 = default stream
 //  01 = low priority stream
 //  10 = high priority stream
+//  11 = per-thread stream
 //
 // This is not really for efficiency; it's just easier to write the code
 // to extract the index if we do this with bitmasks :)
@@ -104,6 +130,7 @@ enum class StreamIdType : uint8_t {
   DEFAULT = 0x0,
   LOW = 0x1,
   HIGH = 0x2,
+  PER_THREAD = 0x3,
 };
 
 std::ostream& operator<<(std::ostream& stream, StreamIdType s) {
@@ -117,6 +144,9 @@ std::ostream& operator<<(std::ostream& stream, StreamIdType s) {
     case StreamIdType::HIGH:
       stream << "HIGH";
       break;
+    case StreamIdType::PER_THREAD:
+      stream << "PER_THREAD";
+      break;
     default:
       stream << static_cast<uint8_t>(s);
       break;
@@ -178,6 +208,14 @@ static StreamId CUDAStream_getStreamId(const LeakyStreamInternals* ptr) {
         StreamIdType::HIGH, ptr - high_priority_streams[device_index].data());
   }
 
+  // Check if it's a per-thread stream
+  if (pointer_within<LeakyStreamInternals>(
+          ptr, per_thread_streams[device_index])) {
+    return makeStreamId(
+        StreamIdType::PER_THREAD,
+        ptr - per_thread_streams[device_index].data());
+  }
+
   AT_ASSERTM(
       0,
       "Could not compute stream ID for ",
@@ -188,7 +226,31 @@ static StreamId CUDAStream_getStreamId(const LeakyStreamInternals* ptr) {
 }
 
 // Thread-local current streams
+// Note: a null entry stands for the stream a thread starts on, which is only
+// looked up, and its pool created, when the device is first used.
 static thread_local LeakyStreamInternals** current_streams = nullptr;
+// Thread-local index into the per-thread pools, -1 until assigned
+static thread_local int64_t stream_affinity = -1;
+
+static int readStreamPoolSize() {
+  const char* env = std::getenv("PYTORCH_CUDA_STREAM_POOL_SIZE");
+  if (env == nullptr) {
+    return kDefaultStreamsPerPool;
+  }
+  const int size = std::atoi(env);
+  TORCH_CHECK(
+      size >= 1 && size <= kMaxStreamsPerPool,
+      "PYTORCH_CUDA_STREAM_POOL_SIZE has to be between 1 and ",
+      kMaxStreamsPerPool,
+      ", but got ",
+      env);
+  return size;
+}
+
+static bool readPerThreadDefaultStreams() {
+  const char* env = std::getenv("PYTORCH_CUDA_PER_THREAD_DEFAULT_STREAM");
+  return env != nullptr && std::string(env) == "1";
+}
 
 // Populates global values and creates a default stream for each device.
 // Note: the default stream on each device is signified by a nullptr,
@@ -207,6 +269,9 @@ static void initGlobalStreamState() {
       C10_COMPILE_TIME_MAX_GPUS,
       "). Increase that and recompile.");
 
+  streams_per_pool = readStreamPoolSize();
+  per_thread_default_streams = readPerThreadDefaultStreams();
+
   // Initializes default streams
   for (auto i = decltype(num_gpus){0}; i < num_gpus; ++i) {
     default_streams[i].device_index = i;
@@ -222,7 +287,7 @@ static void initDeviceStreamState(DeviceIndex device_index) {
   // with it.
   CUDAGuard device_guard{device_index};
 
-  for (auto i = decltype(kStreamsPerPool){0}; i < kStreamsPerPool; ++i) {
+  for (auto i = decltype(streams_per_pool){0}; i < streams_per_pool; ++i) {
     auto& lowpri_stream = low_priority_streams[device_index][i];
     auto& hipri_stream = high_priority_streams[device_index][i];
 
@@ -243,6 +308,18 @@ static void initDeviceStreamState(DeviceIndex device_index) {
   }
 }
 
+// Creates the per-thread stream pool for the specified device
+// Warning: only call once per device!
+static void initPerThreadStreamState(DeviceIndex device_index) {
+  CUDAGuard device_guard{device_index};
+
+  for (auto i = decltype(streams_per_pool){0}; i < streams_per_pool; ++i) {
+    auto& stream = per_thread_streams[device_index][i];
+    stream.device_index = device_index;
+    C10_CUDA_CHECK(cudaStreamCreateWithFlags(&stream.stream, kPerThreadFlags));
+  }
+}
+
 // Init front-end to ensure initialization only occurs once
 static void initCUDAStreamsOnce() {
   // Inits default streams (once, globally)
@@ -252,11 +329,11 @@ static void initCUDAStreamsOnce() {
     return;
   }
 
-  // Inits current streams (thread local) to default streams
+  // Inits current streams (thread local) to the streams the thread starts on
   current_streams =
       (LeakyStreamInternals**)malloc(num_gpus * sizeof(LeakyStreamInternals*));
   for (auto i = decltype(num_gpus){0}; i < num_gpus; ++i) {
-    current_streams[i] = &default_streams[i];
+    current_streams[i] = nullptr;
   }
 }
 
@@ -269,7 +346,27 @@ static inline void check_gpu(DeviceIndex device_index) {
 // Note: Streams are returned round-robin (see note in CUDAStream.h)
 static uint32_t get_idx(std::atomic<uint32_t>& counter) {
   auto raw_idx = counter++;
-  return raw_idx % kStreamsPerPool;
+  return raw_idx % streams_per_pool;
+}
+
+// Returns the per-thread stream of the calling thread on the device
+static LeakyStreamInternals* perThreadStream(DeviceIndex device_index) {
+  std::call_once(
+      per_thread_device_flags[device_index],
+      initPerThreadStreamState,
+      device_index);
+  if (stream_affinity < 0) {
+    stream_affinity = get_idx(per_thread_counter);
+  }
+  return &per_thread_streams[device_index][stream_affinity % streams_per_pool];
+}
+
+// Returns the stream the calling thread starts on, on the device
+static LeakyStreamInternals* threadDefaultStream(DeviceIndex device_index) {
+  if (per_thread_default_streams || stream_affinity >= 0) {
+    return perThreadStream(device_index);
+  }
+  return &default_streams[device_index];
 }
 
 // See Note [StreamId assignment]
@@ -293,6 +390,8 @@ LeakyStreamInternals* CUDAStream_internals(CUDAStream s) {
       return &low_priority_streams[device_index][si];
     case StreamIdType::HIGH:
       return &high_priority_streams[device_index][si];
+    case StreamIdType::PER_THREAD:
+      return &per_thread_streams[device_index][si];
     default:
       AT_ASSERTM(
           0,
@@ -359,9 +458,36 @@ CUDAStream getCurrentCUDAStream(DeviceIndex device_index) {
     device_index = current_device();
   }
   check_gpu(device_index);
+  if (!current_streams[device_index]) {
+    current_streams[device_index] = threadDefaultStream(device_index);
+  }
   return CUDAStream_fromInternals(current_streams[device_index]);
 }
 
+CUDAStream getPerThreadCUDAStream(DeviceIndex device_index) {
+  initCUDAStreamsOnce();
+  if (device_index == -1) {
+    device_index = current_device();
+  }
+  check_gpu(device_index);
+  return CUDAStream_fromInternals(perThreadStream(device_index));
+}
+
+void setStreamAffinity(size_t index) {
+  initCUDAStreamsOnce();
+  stream_affinity = index % streams_per_pool;
+  // Every device goes back to the stream the thread starts on, which is now
+  // its per-thread stream.
+  for (auto i = decltype(num_gpus){0}; i < num_gpus; ++i) {
+    current_streams[i] = nullptr;
+  }
+}
+
+bool perThreadDefaultStreamsEnabled() {
+  std::call_once(init_flag, initGlobalStreamState);
+  return per_thread_default_streams;
+}
+
 void setCurrentCUDAStream(CUDAStream stream) {
   initCUDAStreamsOnce();
   auto ptr = CUDAStream_internals(stream);
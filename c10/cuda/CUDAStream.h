@@ -18,14 +18,15 @@
 * are backed by cuStreams, but they use several pools to minimize the costs
 * associated with creating, retaining, and destroying cuStreams.
 *
-* There are three pools per device, and a device's pools are lazily created.
+* There are four pools per device, and a device's pools are lazily created.
 *
 * The first pool contains only the default stream. When the default stream
 * is requested it's returned.
 *
 * The second pool is the "low priority" or "default priority" streams. In
 * HIP builds there is no distinction between streams in this pool and streams
-* in the third pool (below). There are 32 of these streams per device, and
+* in the third pool (below). There are 32 of these streams per device (or
+* PYTORCH_CUDA_STREAM_POOL_SIZE, up to 256), and
 * when a stream is requested one of these streams is returned round-robin.
 * That is, the first stream requested is at index 0, the second at index 1...
 * to index 31, then index 0 again.
@@ -37,6 +38,17 @@
 * The third pool is the "high priority" streams. The third pool acts like
 * the second pool except the streams are created with a higher priority.
 *
+* The fourth pool is the "per-thread" streams, of the same size. Instead of
+* handing them out on every request, each thread is given one of them, once:
+* round-robin, or the one picked with setStreamAffinity. Like
+* cudaStreamPerThread, and unlike the streams of the other pools, they
+* synchronize with the legacy default stream. With
+* PYTORCH_CUDA_PER_THREAD_DEFAULT_STREAM=1, every thread starts on its
+* per-thread stream instead of the default stream, so that the work of
+* threads that do not set a stream, e.g. the workers of an inference server,
+* can overlap. Tensors shared between the threads then need the same care as
+* tensors shared between streams.
+*
 * These pools suggest that stream users should prefer many short-lived streams,
 * as the cost of acquiring and releasing streams is effectively zero. If
 * many longer-lived streams are required in performance critical scenarios
@@ -219,6 +231,28 @@ CAFFE2_API CUDAStream getCurrentCUDAStream(DeviceIndex device_index = -1);
  */
 CAFFE2_API void setCurrentCUDAStream(CUDAStream stream);
 
+/**
+ * Get the per-thread stream of the calling thread, for the passed CUDA
+ * device, or for the current device if no device index is passed.  See the
+ * stream pool note above.
+ */
+CAFFE2_API CUDAStream getPerThreadCUDAStream(DeviceIndex device_index = -1);
+
+/**
+ * Give the calling thread the per-thread streams at index (modulo the pool
+ * size), and make them its current streams, on every device.  Meant for the
+ * worker threads of a server, which can then be pinned to distinct streams,
+ * e.g. one per worker, whether or not the per-thread default streams are
+ * enabled.
+ */
+CAFFE2_API void setStreamAffinity(size_t index);
+
+/**
+ * Whether threads start on their per-thread stream rather than the default
+ * stream, i.e. PYTORCH_CUDA_PER_THREAD_DEFAULT_STREAM=1.
+ */
+CAFFE2_API bool perThreadDefaultStreamsEnabled();
+
 C10_API std::ostream& operator<<(std::ostream& stream, const CUDAStream& s);
 
 } // namespace cuda
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <thread>
+
+using namespace c10;
+
+namespace {
+
+int64_t aggregate(const CPUCachingAllocator::StatArray& stats) {
+  return stats[static_cast<size_t>(CPUCachingAllocator::StatType::AGGREGATE)]
+      .current;
+}
+
+} // namespace
+
+TEST(CPUCachingAllocatorTest, ReusesFreedBlocks) {
+  auto* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+
+  void* first = nullptr;
+  {
+    DataPtr ptr = allocator->allocate(1000);
+    ASSERT_NE(ptr.get(), nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr.get()) % gAlignment, 0);
+    first = ptr.get();
+  }
+  const auto before = CPUCachingAllocator::getDeviceStats();
+  ASSERT_EQ(aggregate(before.allocation), 0);
+  ASSERT_EQ(aggregate(before.inactive), 1);
+
+  // A request that rounds up to the same size class hits the cache.
+  DataPtr ptr = allocator->allocate(990);
+  ASSERT_EQ(ptr.get(), first);
+  const auto after = CPUCachingAllocator::getDeviceStats();
+  ASSERT_EQ(after.num_cache_hits, before.num_cache_hits + 1);
+  ASSERT_EQ(aggregate(after.segment), aggregate(before.segment));
+  ASSERT_EQ(aggregate(after.inactive), 0);
+}
+
+TEST(CPUCachingAllocatorTest, EmptyCacheReleasesAllThreads) {
+  auto* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+
+  {
+    DataPtr ptr = allocator->allocate(4096);
+  }
+  std::thread t([&]() {
+    DataPtr ptr = allocator->allocate(2 * 1048576);
+  });
+  t.join();
+  ASSERT_EQ(aggregate(CPUCachingAllocator::getDeviceStats().inactive), 2);
+
+  CPUCachingAllocator::emptyCache();
+  const auto stats = CPUCachingAllocator::getDeviceStats();
+  ASSERT_EQ(aggregate(stats.inactive), 0);
+  ASSERT_EQ(aggregate(stats.inactive_bytes), 0);
+  ASSERT_EQ(aggregate(stats.reserved_bytes), 0);
+}
+
+TEST(CPUCachingAllocatorTest, CrossThreadFree) {
+  auto* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+
+  DataPtr ptr = allocator->allocate(256);
+  std::thread t([&]() { ptr.clear(); });
+  t.join();
+
+  // The exiting thread handed its cache to the global pool.
+  DataPtr reused = allocator->allocate(256);
+  ASSERT_GT(CPUCachingAllocator::getDeviceStats().num_cache_hits, 0);
+  CPUCachingAllocator::emptyCache();
+}
+
+TEST(CPUCachingAllocatorTest, RawAllocate) {
+  auto* allocator = CPUCachingAllocator::get();
+  void* data = allocator->raw_allocate(128);
+  ASSERT_NE(data, nullptr);
+  allocator->raw_deallocate(data);
+}
+
+TEST(CPUCachingAllocatorTest, SetCPUAllocator) {
+  auto* prev = GetCPUAllocator();
+  SetCPUAllocator(CPUCachingAllocator::get());
+  ASSERT_EQ(GetCPUAllocator(), CPUCachingAllocator::get());
+  SetCPUAllocator(prev);
+}
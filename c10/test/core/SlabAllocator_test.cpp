@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/impl/SlabAllocator.h>
+#include <c10/util/Flags.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+C10_DECLARE_bool(caffe2_slab_allocate_tensor_metadata);
+
+using namespace c10::impl;
+
+namespace {
+// The setting is read at the first allocation, so it is turned on before any
+// test runs.
+const bool slabs_enabled = (FLAGS_caffe2_slab_allocate_tensor_metadata = true);
+} // namespace
+
+TEST(SlabAllocatorTest, ReusesFreedObjects) {
+  void* first = slab_allocate(200);
+  slab_deallocate(first, 200);
+  // Same size class, same thread: the object comes straight back.
+  void* second = slab_allocate(195);
+  ASSERT_EQ(first, second);
+  slab_deallocate(second, 195);
+}
+
+TEST(SlabAllocatorTest, ObjectsAreAlignedAndDistinct) {
+  std::vector<void*> ptrs;
+  std::set<void*> unique;
+  for (int i = 0; i < 1000; ++i) {
+    void* ptr = slab_allocate(48);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t), 0);
+    ptrs.push_back(ptr);
+    unique.insert(ptr);
+  }
+  ASSERT_EQ(unique.size(), ptrs.size());
+  for (void* ptr : ptrs) {
+    slab_deallocate(ptr, 48);
+  }
+}
+
+TEST(SlabAllocatorTest, CrossThreadFree) {
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 1000; ++i) {
+    ptrs.push_back(slab_allocate(96));
+  }
+  std::thread t([&]() {
+    for (void* ptr : ptrs) {
+      slab_deallocate(ptr, 96);
+    }
+  });
+  t.join();
+  // The exiting thread handed its free objects to the global pool.
+  void* ptr = slab_allocate(96);
+  ASSERT_NE(ptr, nullptr);
+  slab_deallocate(ptr, 96);
+}
+
+TEST(SlabAllocatorTest, LargeObjectsUseHeap) {
+  void* ptr = slab_allocate(kMaxSlabObjectSize + 1);
+  ASSERT_NE(ptr, nullptr);
+  slab_deallocate(ptr, kMaxSlabObjectSize + 1);
+}
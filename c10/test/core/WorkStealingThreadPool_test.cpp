@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/thread_pool.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace c10;
+
+namespace {
+
+void waitFor(const std::atomic<int>& counter, int expected) {
+  while (counter.load() != expected) {
+    std::this_thread::yield();
+  }
+}
+
+} // namespace
+
+TEST(WorkStealingThreadPoolTest, RunsAllTasks) {
+  WorkStealingThreadPool pool(4);
+  ASSERT_EQ(pool.size(), 4);
+  ASSERT_FALSE(pool.inThreadPool());
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 1000; ++i) {
+    pool.run([&]() { ++counter; });
+  }
+  waitFor(counter, 1000);
+}
+
+TEST(WorkStealingThreadPoolTest, NestedTasksAreStolen) {
+  WorkStealingThreadPool pool(4);
+  std::atomic<int> counter{0};
+  std::atomic<int> in_pool{0};
+  // All the nested tasks are pushed to the queue of a single worker, the
+  // other ones have to steal them.
+  pool.run([&]() {
+    for (int i = 0; i < 100; ++i) {
+      pool.run([&]() {
+        in_pool += pool.inThreadPool();
+        ++counter;
+      });
+    }
+  });
+  waitFor(counter, 100);
+  ASSERT_EQ(in_pool.load(), 100);
+}
+
+TEST(WorkStealingThreadPoolTest, WaitingThreadHelps) {
+  WorkStealingThreadPool pool(1);
+  std::atomic<bool> started{false};
+  std::atomic<bool> release{false};
+  // Keep the only worker busy, the calling thread has to run the next task
+  pool.run([&]() {
+    started = true;
+    while (!release) {
+      std::this_thread::yield();
+    }
+  });
+  while (!started) {
+    std::this_thread::yield();
+  }
+  std::atomic<int> counter{0};
+  pool.run([&]() { ++counter; });
+  while (counter.load() == 0) {
+    pool.runPendingTask();
+  }
+  ASSERT_FALSE(pool.runPendingTask());
+  release = true;
+}
@@ -3,8 +3,10 @@
 #include <gtest/gtest.h>
 #include <map>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 using c10::intrusive_ptr;
 using c10::intrusive_ptr_target;
@@ -1613,6 +1615,68 @@ TEST(
   EXPECT_TRUE(wasDestructed);
 }
 
+TEST(
+    IntrusivePtrTest,
+    givenPtr_whenDestructedOnOtherThread_thenIsDestructed) {
+  bool resourcesReleased = false;
+  bool wasDestructed = false;
+  intrusive_ptr<DestructableMock> obj =
+      make_intrusive<DestructableMock>(&resourcesReleased, &wasDestructed);
+  std::thread t([moved = std::move(obj)]() mutable { moved.reset(); });
+  t.join();
+  // With biased refcounting the object is handed back to this thread, which
+  // merges it the next time it touches a refcount.
+  intrusive_ptr<SomeClass> other = make_intrusive<SomeClass>();
+  intrusive_ptr<SomeClass> copy = other;
+  EXPECT_TRUE(resourcesReleased);
+  EXPECT_TRUE(wasDestructed);
+}
+
+TEST(
+    IntrusivePtrTest,
+    givenPtr_whenCreatingThreadExitsFirst_thenIsDestructedAtEnd) {
+  bool resourcesReleased = false;
+  bool wasDestructed = false;
+  intrusive_ptr<DestructableMock> obj;
+  std::thread t([&]() {
+    obj = make_intrusive<DestructableMock>(&resourcesReleased, &wasDestructed);
+  });
+  t.join();
+  EXPECT_EQ(1, obj.use_count());
+  obj.reset();
+  EXPECT_TRUE(resourcesReleased);
+  EXPECT_TRUE(wasDestructed);
+}
+
+TEST(IntrusivePtrTest, givenPtr_whenCopiedConcurrently_thenCountsCorrectly) {
+  bool resourcesReleased = false;
+  bool wasDestructed = false;
+  intrusive_ptr<DestructableMock> obj =
+      make_intrusive<DestructableMock>(&resourcesReleased, &wasDestructed);
+  auto copy_many = [&obj]() {
+    std::vector<intrusive_ptr<DestructableMock>> copies;
+    for (int i = 0; i < 10000; ++i) {
+      copies.push_back(obj);
+      if (i % 3 == 0) {
+        copies.pop_back();
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back(copy_many);
+  }
+  copy_many();
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(1, obj.use_count());
+  EXPECT_FALSE(resourcesReleased);
+  obj.reset();
+  EXPECT_TRUE(resourcesReleased);
+  EXPECT_TRUE(wasDestructed);
+}
+
 namespace {
 template <class T>
 struct IntrusiveAndWeak final {
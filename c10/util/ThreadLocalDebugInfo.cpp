@@ -27,7 +27,9 @@ std::shared_ptr<ThreadLocalDebugInfo> ThreadLocalDebugInfo::current() {
 /* static */
 void ThreadLocalDebugInfo::_forceCurrentDebugInfo(
     const std::shared_ptr<ThreadLocalDebugInfo>& info) {
-  debug_info = info;
+  if (debug_info != info) {
+    debug_info = info;
+  }
 }
 
 /* static */
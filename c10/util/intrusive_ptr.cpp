@@ -1 +1,104 @@
 #include <c10/util/intrusive_ptr.h>
+
+#ifdef C10_USE_BIASED_REFCOUNT
+#include <mutex>
+#include <vector>
+
+namespace c10 {
+namespace detail {
+
+namespace {
+
+constexpr int kRunning = 0;
+constexpr int kPending = 1;
+constexpr int kExited = 2;
+
+// BiasedRefcountThread plus the queue of objects other threads handed back.
+// These are never freed: objects keep a raw pointer to their owner for as
+// long as they live, which may well be longer than the owner thread.
+struct ThreadRecord : BiasedRefcountThread {
+  std::mutex mutex;
+  std::vector<intrusive_ptr_target*> queue;
+};
+
+void enter_exit_state(ThreadRecord* record);
+
+struct ThreadExitGuard {
+  ThreadRecord* record = nullptr;
+  ~ThreadExitGuard() {
+    if (record) {
+      enter_exit_state(record);
+    }
+  }
+};
+
+} // namespace
+
+BiasedRefcountThread* biased_refcount_register_thread() {
+  static thread_local ThreadExitGuard guard;
+  if (!guard.record) {
+    guard.record = new ThreadRecord();
+  }
+  return guard.record;
+}
+
+void biased_refcount_process_queue(BiasedRefcountThread* self) {
+  auto* record = static_cast<ThreadRecord*>(self);
+  std::vector<intrusive_ptr_target*> queue;
+  {
+    std::lock_guard<std::mutex> lock(record->mutex);
+    if (record->state.load(std::memory_order_relaxed) != kPending) {
+      return;
+    }
+    queue.swap(record->queue);
+    record->state.store(kRunning, std::memory_order_relaxed);
+  }
+  for (auto* target : queue) {
+    if (target->merge_refcount_(intrusive_ptr_target::kQueued)) {
+      target->release_merged_();
+    }
+  }
+}
+
+void biased_refcount_enqueue(
+    BiasedRefcountThread* owner,
+    intrusive_ptr_target* target) {
+  auto* record = static_cast<ThreadRecord*>(owner);
+  {
+    std::lock_guard<std::mutex> lock(record->mutex);
+    if (record->state.load(std::memory_order_relaxed) != kExited) {
+      record->queue.push_back(target);
+      record->state.store(kPending, std::memory_order_relaxed);
+      return;
+    }
+  }
+  // The owner is gone and will never touch biased_refcount_ again; the mutex
+  // makes its last write visible to us, so we can merge on its behalf.
+  if (target->merge_refcount_(intrusive_ptr_target::kQueued)) {
+    target->release_merged_();
+  }
+}
+
+namespace {
+
+void enter_exit_state(ThreadRecord* record) {
+  // Objects queued after this point are merged by the thread that queued
+  // them. Those already queued are merged here, which may release them and
+  // queue more, so keep going until the queue is empty.
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(record->mutex);
+      if (record->queue.empty()) {
+        record->state.store(kExited, std::memory_order_relaxed);
+        return;
+      }
+    }
+    biased_refcount_process_queue(record);
+  }
+}
+
+} // namespace
+
+} // namespace detail
+} // namespace c10
+#endif
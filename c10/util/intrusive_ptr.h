@@ -15,6 +15,30 @@ namespace raw {
     inline void incref(intrusive_ptr_target * self);
   }
 }
+#ifdef C10_USE_BIASED_REFCOUNT
+namespace detail {
+  // Per-thread state for biased refcounting, see
+  // Note [Biased reference counting]
+  struct BiasedRefcountThread {
+    // Nonzero if the slow path must be taken: either other threads queued
+    // objects for this thread to merge, or this thread is exiting.
+    std::atomic<int> state{0};
+  };
+  C10_API BiasedRefcountThread* biased_refcount_register_thread();
+  C10_API void biased_refcount_process_queue(BiasedRefcountThread* self);
+  C10_API void biased_refcount_enqueue(
+      BiasedRefcountThread* owner,
+      intrusive_ptr_target* target);
+
+  inline BiasedRefcountThread* biased_refcount_current_thread() {
+    static thread_local BiasedRefcountThread* current = nullptr;
+    if (C10_UNLIKELY(current == nullptr)) {
+      current = biased_refcount_register_thread();
+    }
+    return current;
+  }
+}
+#endif
 /**
  * intrusive_ptr<T> is an alternative to shared_ptr<T> that has better
  * performance because it does the refcounting intrusively
@@ -63,8 +87,45 @@ class C10_API intrusive_ptr_target {
   //    atomically increment the use count, if it is greater than 0.
   //    If it is not, you must report that the storage is dead.
   //
+  // Note [Biased reference counting]
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Most objects are only ever touched by the thread that created them, yet
+  // every copy of an intrusive_ptr pays for an atomic read-modify-write. When
+  // c10 is built with USE_BIASED_REFCOUNT, the strong refcount is split in two
+  // (see "Biased Reference Counting", Choi et al., PACT 2018):
+  //
+  //  - biased_refcount_ is only ever modified by owner_, the thread that
+  //    created the object (in make_intrusive), using plain loads and stores.
+  //
+  //  - refcount_ is the shared refcount, modified atomically by every other
+  //    thread. It may become negative when other threads drop references that
+  //    the owner handed to them.
+  //
+  // The object is alive while biased_refcount_ + refcount_ > 0. When the
+  // owner drops its last biased reference it "merges" the object: it sets
+  // kMerged in refcount_, and from then on every thread (including the owner)
+  // uses the atomic path. When a non-owner makes the shared count negative it
+  // sets kQueued and hands the object to the owner, which merges it the next
+  // time it touches a refcount (or, if the owner has exited, merges it
+  // itself). An object is released exactly once, by the thread whose atomic
+  // operation leaves refcount_ at kMerged + kZero.
+  //
+  // The weakcount is always atomic.
   mutable std::atomic<size_t> refcount_;
   mutable std::atomic<size_t> weakcount_;
+#ifdef C10_USE_BIASED_REFCOUNT
+  // Owner thread, never changes once set by make_intrusive.
+  mutable std::atomic<detail::BiasedRefcountThread*> owner_;
+  // Only written by owner_; kUnbiased once the object has been merged.
+  mutable std::atomic<size_t> biased_refcount_;
+
+  // Layout of refcount_: the low 60 bits hold the shared count offset by
+  // kZero (so that it can go negative), followed by two flag bits.
+  static constexpr size_t kZero = size_t(1) << 59;
+  static constexpr size_t kQueued = size_t(1) << 60;
+  static constexpr size_t kMerged = size_t(1) << 61;
+  static constexpr size_t kUnbiased = static_cast<size_t>(-1);
+#endif
 
   template <typename T, typename NullType>
   friend class intrusive_ptr;
@@ -74,6 +135,158 @@ class C10_API intrusive_ptr_target {
   friend class weak_intrusive_ptr;
   friend inline void raw::weak_intrusive_ptr::incref(intrusive_ptr_target* self);
 
+#ifdef C10_USE_BIASED_REFCOUNT
+  friend C10_API void detail::biased_refcount_process_queue(
+      detail::BiasedRefcountThread* self);
+  friend C10_API void detail::biased_refcount_enqueue(
+      detail::BiasedRefcountThread* owner,
+      intrusive_ptr_target* target);
+
+  // Returns the calling thread, or nullptr if it is exiting. Merges every
+  // object other threads queued for it first.
+  static detail::BiasedRefcountThread* biased_current_thread_() noexcept {
+    auto* current = detail::biased_refcount_current_thread();
+    if (C10_UNLIKELY(current->state.load(std::memory_order_relaxed) != 0)) {
+      detail::biased_refcount_process_queue(current);
+      if (current->state.load(std::memory_order_relaxed) != 0) {
+        return nullptr;
+      }
+    }
+    return current;
+  }
+
+  // Returns true if the calling thread may use the non-atomic fast path on
+  // this object.
+  bool biased_owned_() const noexcept {
+    auto* owner = owner_.load(std::memory_order_relaxed);
+    return owner != nullptr && owner == biased_current_thread_() &&
+        biased_refcount_.load(std::memory_order_relaxed) != kUnbiased;
+  }
+
+  // Merges the biased refcount into the shared one and clears `clear`
+  // (kQueued or 0) from it. Must be called by the owner, or by any thread
+  // once the owner has exited. Returns true if the object must be released.
+  bool merge_refcount_(size_t clear) const noexcept {
+    size_t biased = biased_refcount_.load(std::memory_order_relaxed);
+    size_t delta = -clear;
+    if (biased != kUnbiased) {
+      biased_refcount_.store(kUnbiased, std::memory_order_relaxed);
+      delta += biased + kMerged;
+    }
+    return refcount_.fetch_add(delta, std::memory_order_acq_rel) + delta ==
+        kMerged + kZero;
+  }
+
+  void refcount_init_() const noexcept {
+    auto* current = biased_current_thread_();
+    if (current != nullptr) {
+      owner_.store(current, std::memory_order_relaxed);
+      biased_refcount_.store(1, std::memory_order_relaxed);
+    } else {
+      refcount_.store(kMerged + kZero + 1, std::memory_order_relaxed);
+    }
+  }
+
+  size_t refcount_load_() const noexcept {
+    size_t shared = refcount_.load(std::memory_order_acquire);
+    size_t biased = biased_refcount_.load(std::memory_order_relaxed);
+    size_t count = (shared & (kQueued - 1)) - kZero;
+    if (biased != kUnbiased && (shared & kMerged) == 0) {
+      count += biased;
+    }
+    // A concurrent merge may make the sum transiently negative.
+    return static_cast<int64_t>(count) < 0 ? 0 : count;
+  }
+
+  void refcount_incref_() const {
+    if (biased_owned_()) {
+      biased_refcount_.store(
+          biased_refcount_.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+    } else {
+      refcount_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  bool refcount_decref_() const noexcept {
+    if (biased_owned_()) {
+      size_t biased = biased_refcount_.load(std::memory_order_relaxed) - 1;
+      if (biased != 0) {
+        biased_refcount_.store(biased, std::memory_order_relaxed);
+        return false;
+      }
+      biased_refcount_.store(0, std::memory_order_relaxed);
+      return merge_refcount_(0);
+    }
+    size_t shared = refcount_.load(std::memory_order_relaxed);
+    size_t new_shared;
+    do {
+      new_shared = shared - 1;
+      if ((new_shared & (kMerged | kQueued)) == 0 && new_shared < kZero) {
+        // We just dropped a reference the owner counted in biased_refcount_.
+        new_shared |= kQueued;
+      }
+    } while (!refcount_.compare_exchange_weak(
+        shared, new_shared, std::memory_order_acq_rel));
+    if ((new_shared & kQueued) != 0 && (shared & kQueued) == 0) {
+      detail::biased_refcount_enqueue(
+          owner_.load(std::memory_order_relaxed),
+          const_cast<intrusive_ptr_target*>(this));
+      return false;
+    }
+    return new_shared == kMerged + kZero;
+  }
+
+  // Called once the last strong reference is gone, see reset_().
+  void release_merged_() noexcept {
+    release_resources();
+    if (--weakcount_ == 0) {
+      delete this;
+    }
+  }
+
+  bool refcount_try_incref_() const noexcept {
+    // An unmerged object is alive (anything queued has not been released
+    // yet), a merged one is alive while its shared count is nonzero.
+    size_t shared = refcount_.load();
+    do {
+      if (shared == kMerged + kZero) {
+        return false;
+      }
+    } while (!refcount_.compare_exchange_weak(shared, shared + 1));
+    return true;
+  }
+#else
+  void refcount_init_() const noexcept {
+    ++refcount_;
+  }
+
+  size_t refcount_load_() const noexcept {
+    return refcount_.load();
+  }
+
+  void refcount_incref_() const {
+    size_t new_refcount = ++refcount_;
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        new_refcount != 1,
+        "intrusive_ptr: Cannot increase refcount after it reached zero.");
+  }
+
+  bool refcount_decref_() const noexcept {
+    return --refcount_ == 0;
+  }
+
+  bool refcount_try_incref_() const noexcept {
+    auto refcount = refcount_.load();
+    do {
+      if (refcount == 0) {
+        return false;
+      }
+    } while (!refcount_.compare_exchange_weak(refcount, refcount + 1));
+    return true;
+  }
+#endif
+
  protected:
   // protected destructor. We never want to destruct intrusive_ptr_target*
   // directly.
@@ -94,7 +307,7 @@ class C10_API intrusive_ptr_target {
 #  pragma GCC diagnostic ignored "-Wexceptions"
 #endif
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
-        refcount_.load() == 0,
+        refcount_load_() == 0,
         "Tried to destruct an intrusive_ptr_target that still has intrusive_ptr to it");
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
         weakcount_.load() == 0,
@@ -106,7 +319,15 @@ class C10_API intrusive_ptr_target {
 #endif
   }
 
+#ifdef C10_USE_BIASED_REFCOUNT
+  constexpr intrusive_ptr_target() noexcept
+      : refcount_(kZero),
+        weakcount_(0),
+        owner_(nullptr),
+        biased_refcount_(kUnbiased) {}
+#else
   constexpr intrusive_ptr_target() noexcept : refcount_(0), weakcount_(0) {}
+#endif
 
   // intrusive_ptr_target supports copy and move: but refcount and weakcount don't
   // participate (since they are intrinsic properties of the memory location)
@@ -184,15 +405,12 @@ class intrusive_ptr final {
 
   void retain_() {
     if (target_ != NullType::singleton()) {
-      size_t new_refcount = ++target_->refcount_;
-      TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
-          new_refcount != 1,
-          "intrusive_ptr: Cannot increase refcount after it reached zero.");
+      target_->refcount_incref_();
     }
   }
 
   void reset_() noexcept {
-    if (target_ != NullType::singleton() && --target_->refcount_ == 0) {
+    if (target_ != NullType::singleton() && target_->refcount_decref_()) {
       // justification for const_cast: release_resources is basically a destructor
       // and a destructor always mutates the object, even for const objects.
       const_cast<std::remove_const_t<TTarget>*>(target_)->release_resources();
@@ -313,7 +531,7 @@ class intrusive_ptr final {
     if (target_ == NullType::singleton()) {
       return 0;
     }
-    return target_->refcount_.load();
+    return target_->refcount_load_();
   }
 
   size_t weak_use_count() const noexcept {
@@ -356,7 +574,7 @@ class intrusive_ptr final {
     // We can't use retain_(), because we also have to increase weakcount
     // and because we allow raising these values from 0, which retain_()
     // has an assertion against.
-    ++result.target_->refcount_;
+    result.target_->refcount_init_();
     ++result.target_->weakcount_;
 
     return result;
@@ -370,7 +588,7 @@ class intrusive_ptr final {
   static intrusive_ptr unsafe_reclaim_from_nonowning(TTarget* raw_ptr) {
     // See Note [Stack allocated intrusive_ptr_target safety]
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
-        raw_ptr == NullType::singleton() || raw_ptr->refcount_.load() > 0,
+        raw_ptr == NullType::singleton() || raw_ptr->refcount_load_() > 0,
         "intrusive_ptr: Can only reclaim pointers that are owned by someone");
     auto ptr = reclaim(raw_ptr); // doesn't increase refcount
     ptr.retain_();
@@ -568,7 +786,7 @@ class weak_intrusive_ptr final {
     if (target_ == NullType::singleton()) {
       return 0;
     }
-    return target_->refcount_.load(); // refcount, not weakcount!
+    return target_->refcount_load_(); // refcount, not weakcount!
   }
 
   size_t weak_use_count() const noexcept {
@@ -583,14 +801,11 @@ class weak_intrusive_ptr final {
   }
 
   intrusive_ptr<TTarget, NullType> lock() const noexcept {
-    auto refcount = target_->refcount_.load();
-    do {
-      if (refcount == 0) {
-        // Object already destructed, no strong references left anymore.
-        // Return nullptr.
-        return intrusive_ptr<TTarget, NullType>(NullType::singleton());
-      }
-    } while (!target_->refcount_.compare_exchange_weak(refcount, refcount + 1));
+    if (!target_->refcount_try_incref_()) {
+      // Object already destructed, no strong references left anymore.
+      // Return nullptr.
+      return intrusive_ptr<TTarget, NullType>(NullType::singleton());
+    }
     return intrusive_ptr<TTarget, NullType>(target_);
   }
 
@@ -623,7 +838,7 @@ class weak_intrusive_ptr final {
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
         owning_weak_ptr == NullType::singleton() ||
         owning_weak_ptr->weakcount_.load() > 1 ||
-            (owning_weak_ptr->refcount_.load() == 0 &&
+            (owning_weak_ptr->refcount_load_() == 0 &&
              owning_weak_ptr->weakcount_.load() > 0),
         "weak_intrusive_ptr: Can only weak_intrusive_ptr::reclaim() owning pointers that were created using weak_intrusive_ptr::release().");
     return weak_intrusive_ptr(owning_weak_ptr);
@@ -692,7 +907,7 @@ namespace intrusive_ptr {
   // NullType::singleton to this function
   inline void incref(intrusive_ptr_target* self) {
     if (self) {
-      ++self->refcount_;
+      self->refcount_incref_();
     }
   }
 
@@ -1,6 +1,11 @@
 #include <c10/util/numa.h>
 
 C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
+C10_DEFINE_bool(
+    caffe2_cpu_numa_partitioned,
+    false,
+    "If set together with caffe2_cpu_numa_enabled, split large CPU allocations "
+    "into per-node slabs and run intra-op work on the node owning the data.");
 
 #if defined(__linux__) && defined(C10_USE_NUMA) && !defined(C10_MOBILE)
 #include <numa.h>
@@ -103,6 +108,45 @@ int GetCurrentNUMANode() {
   return n;
 }
 
+bool IsNUMAPartitioned() {
+  return FLAGS_caffe2_cpu_numa_partitioned && IsNUMAEnabled() &&
+      GetNumNUMANodes() > 1;
+}
+
+int GetNUMANodeForPartition(size_t index, size_t count) {
+  if (!IsNUMAEnabled() || count == 0) {
+    return -1;
+  }
+  AT_ASSERT(index < count);
+  return static_cast<int>(index * GetNumNUMANodes() / count);
+}
+
+void NUMAMovePartitioned(void* ptr, size_t size) {
+  if (!IsNUMAEnabled()) {
+    return;
+  }
+  AT_ASSERT(ptr);
+
+  const size_t num_nodes = GetNumNUMANodes();
+  const uintptr_t page_size = getpagesize();
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+  const uintptr_t end = begin + size;
+  // Slab boundaries are rounded down to a page, so each page belongs to
+  // exactly one node; the first slab also covers the partial leading page.
+  uintptr_t slab_start = begin & ~(page_size - 1);
+  for (size_t node = 0; node < num_nodes && slab_start < end; ++node) {
+    uintptr_t slab_end = node + 1 == num_nodes
+        ? end
+        : (begin + size / num_nodes * (node + 1)) & ~(page_size - 1);
+    if (slab_end <= slab_start) {
+      continue;
+    }
+    NUMAMove(
+        reinterpret_cast<void*>(slab_start), slab_end - slab_start, node);
+    slab_start = slab_end;
+  }
+}
+
 #else // C10_ENABLE_NUMA
 
 bool IsNUMAEnabled() {
@@ -127,6 +171,17 @@ int GetCurrentNUMANode() {
   return -1;
 }
 
+bool IsNUMAPartitioned() {
+  return false;
+}
+
+int GetNUMANodeForPartition(size_t index, size_t count) {
+  return -1;
+}
+
+void NUMAMovePartitioned(void* ptr, size_t size) {
+}
+
 #endif // C10_NUMA_ENABLED
 
 } // namespace c10
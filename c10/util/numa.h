@@ -4,6 +4,7 @@
 #include <c10/util/Optional.h>
 
 C10_DECLARE_bool(caffe2_cpu_numa_enabled);
+C10_DECLARE_bool(caffe2_cpu_numa_partitioned);
 
 namespace c10 {
 
@@ -37,4 +38,26 @@ C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
  */
 C10_API int GetCurrentNUMANode();
 
+/**
+ * Check whether the partitioned NUMA policy is in effect. Under this policy
+ * large CPU allocations are split into one contiguous slab per NUMA node, and
+ * the intra-op thread pool runs each chunk of a parallel region on the node
+ * that owns the matching slab.
+ */
+C10_API bool IsNUMAPartitioned();
+
+/**
+ * Get the NUMA node owning part `index` out of `count` equal, contiguous
+ * parts of a partitioned range. Both the allocator and the intra-op thread
+ * pool use this mapping, so that chunk `i` of `n` of a parallel region runs
+ * on the node holding slab `i` of `n` of a partitioned allocation.
+ */
+C10_API int GetNUMANodeForPartition(size_t index, size_t count);
+
+/**
+ * Spread the memory pointed to by `ptr` of a given size over all NUMA nodes,
+ * one contiguous slab per node (see GetNUMANodeForPartition)
+ */
+C10_API void NUMAMovePartitioned(void* ptr, size_t size);
+
 } // namespace c10
@@ -171,6 +171,208 @@ class MiniDB : public DB {
 REGISTER_CAFFE2_DB(MiniDB, MiniDB);
 REGISTER_CAFFE2_DB(minidb, MiniDB);
 
+ParallelCursor::ParallelCursor(
+    DB* db,
+    int num_threads,
+    int readahead,
+    int chunk_size)
+    : db_(db),
+      num_threads_(num_threads),
+      readahead_(readahead),
+      chunk_size_(chunk_size) {
+  CAFFE_ENFORCE(db_ != nullptr, "Passed null db");
+  CAFFE_ENFORCE_GT(num_threads_, 0);
+  CAFFE_ENFORCE_GT(readahead_, 0);
+  CAFFE_ENFORCE_GT(chunk_size_, 0);
+  supports_seek_ = db_->NewCursor()->SupportsSeek();
+  Start(nullptr);
+}
+
+ParallelCursor::~ParallelCursor() {
+  Stop();
+}
+
+void ParallelCursor::Seek(const string& key) {
+  CAFFE_ENFORCE(supports_seek_, "The db cursors don't support seeking.");
+  Stop();
+  Start(&key);
+}
+
+void ParallelCursor::SeekToFirst() {
+  Stop();
+  Start(nullptr);
+}
+
+void ParallelCursor::Next() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  CAFFE_ENFORCE(WaitForCurrent(lock), "Cursor is at invalid location!");
+  current_++;
+  if (current_ == chunks_.front()->records.size()) {
+    PopChunk();
+  }
+}
+
+string ParallelCursor::key() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  CAFFE_ENFORCE(WaitForCurrent(lock), "Cursor is at invalid location!");
+  return chunks_.front()->records[current_].first;
+}
+
+string ParallelCursor::value() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  CAFFE_ENFORCE(WaitForCurrent(lock), "Cursor is at invalid location!");
+  return chunks_.front()->records[current_].second;
+}
+
+bool ParallelCursor::Valid() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return WaitForCurrent(lock);
+}
+
+bool ParallelCursor::WaitForCurrent(std::unique_lock<std::mutex>& lock) {
+  while (true) {
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    if (chunks_.empty()) {
+      if (planned_all_) {
+        return false;
+      }
+    } else if (chunks_.front()->ready) {
+      if (current_ < chunks_.front()->records.size()) {
+        return true;
+      }
+      // The records of the chunk were removed after it was planned.
+      PopChunk();
+      continue;
+    }
+    cv_.wait(lock);
+  }
+}
+
+void ParallelCursor::PopChunk() {
+  chunks_.pop_front();
+  if (num_taken_ > 0) {
+    num_taken_--;
+  }
+  current_ = 0;
+  cv_.notify_all();
+}
+
+void ParallelCursor::Start(const string* key) {
+  const bool has_key = key != nullptr;
+  const string start_key = has_key ? *key : string();
+  threads_.emplace_back([this, has_key, start_key]() {
+    Plan(has_key ? &start_key : nullptr);
+  });
+  if (supports_seek_) {
+    for (int i = 0; i < num_threads_; i++) {
+      threads_.emplace_back([this]() { ReadChunks(); });
+    }
+  }
+}
+
+void ParallelCursor::Stop() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  chunks_.clear();
+  num_taken_ = 0;
+  current_ = 0;
+  planned_all_ = false;
+  stopping_ = false;
+  error_ = nullptr;
+}
+
+void ParallelCursor::Plan(const string* key) {
+  try {
+    // The cursor is created by the thread using it, as LMDB cursors belong to
+    // a transaction which shouldn't move between threads.
+    auto cursor = db_->NewCursor();
+    if (key) {
+      cursor->Seek(*key);
+    } else {
+      cursor->SeekToFirst();
+    }
+    while (cursor->Valid()) {
+      auto chunk = make_unique<Chunk>();
+      if (supports_seek_) {
+        // Only walks the keys, the reading threads read the values.
+        chunk->first_key = cursor->key();
+        for (; chunk->num_records < chunk_size_ && cursor->Valid();
+             cursor->Next()) {
+          chunk->num_records++;
+        }
+      } else {
+        for (; chunk->num_records < chunk_size_ && cursor->Valid();
+             cursor->Next()) {
+          chunk->records.emplace_back(cursor->key(), cursor->value());
+          chunk->num_records++;
+        }
+        chunk->ready = true;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() {
+        return stopping_ || chunks_.size() < static_cast<size_t>(readahead_);
+      });
+      if (stopping_) {
+        return;
+      }
+      chunks_.push_back(std::move(chunk));
+      cv_.notify_all();
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    planned_all_ = true;
+  } catch (...) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    error_ = std::current_exception();
+  }
+  cv_.notify_all();
+}
+
+void ParallelCursor::ReadChunks() {
+  try {
+    auto cursor = db_->NewCursor();
+    while (true) {
+      Chunk* chunk;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() {
+          return stopping_ || num_taken_ < chunks_.size();
+        });
+        if (stopping_) {
+          return;
+        }
+        chunk = chunks_[num_taken_++].get();
+      }
+      // The chunk stays in chunks_ until it is ready, so it can be filled
+      // without the lock.
+      chunk->records.reserve(chunk->num_records);
+      for (cursor->Seek(chunk->first_key);
+           cursor->Valid() && chunk->records.size() <
+               static_cast<size_t>(chunk->num_records);
+           cursor->Next()) {
+        chunk->records.emplace_back(cursor->key(), cursor->value());
+      }
+      std::lock_guard<std::mutex> guard(mutex_);
+      chunk->ready = true;
+      cv_.notify_all();
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      error_ = std::current_exception();
+    }
+    cv_.notify_all();
+  }
+}
+
 void DBReaderSerializer::Serialize(
     const void* pointer,
     TypeMeta typeMeta,
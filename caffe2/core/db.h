@@ -1,7 +1,11 @@
 #ifndef CAFFE2_CORE_DB_H_
 #define CAFFE2_CORE_DB_H_
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 #include "c10/util/Registry.h"
 #include "caffe2/core/blob_serialization.h"
@@ -121,6 +125,74 @@ inline unique_ptr<DB> CreateDB(
   return result;
 }
 
+/**
+ * A cursor which reads the db ahead of the caller with a pool of threads, each
+ * with its own cursor of the db. A planning thread walks the keys and cuts
+ * them into key ranges of chunk_size records; the reading threads seek to the
+ * first key of a range and read its values. The chunks are returned in the
+ * order of the db, and at most readahead chunks are read ahead of the caller,
+ * which bounds the memory held.
+ *
+ * The db must allow several cursors at once, as LMDB and LevelDB do. When its
+ * cursors can't seek, the planning thread reads the values itself, so that
+ * the reads only overlap with the work of the caller.
+ */
+class CAFFE2_API ParallelCursor final : public Cursor {
+ public:
+  ParallelCursor(DB* db, int num_threads, int readahead, int chunk_size);
+  ~ParallelCursor() override;
+
+  void Seek(const string& key) override;
+  bool SupportsSeek() override {
+    return supports_seek_;
+  }
+  void SeekToFirst() override;
+  void Next() override;
+  string key() override;
+  string value() override;
+  bool Valid() override;
+
+ private:
+  struct Chunk {
+    string first_key;
+    int num_records{0};
+    vector<std::pair<string, string>> records;
+    bool ready{false};
+  };
+
+  // Starts reading from the key, or from the first key if it is null.
+  void Start(const string* key);
+  void Stop();
+  void Plan(const string* key);
+  void ReadChunks();
+  // Waits until the current record is read or the end of the db is reached,
+  // and returns whether there is a current record.
+  bool WaitForCurrent(std::unique_lock<std::mutex>& lock);
+  // Drops the front chunk once its records are consumed. Must hold mutex_.
+  void PopChunk();
+
+  DB* db_;
+  const int num_threads_;
+  const int readahead_;
+  const int chunk_size_;
+  bool supports_seek_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // The chunks planned and not consumed yet, in the order of the db. The
+  // front one holds the current record.
+  std::deque<std::unique_ptr<Chunk>> chunks_;
+  // The number of chunks at the front of chunks_ taken by a reading thread.
+  size_t num_taken_{0};
+  size_t current_{0};
+  bool planned_all_{false};
+  bool stopping_{false};
+  std::exception_ptr error_;
+  std::vector<std::thread> threads_;
+
+  C10_DISABLE_COPY_AND_ASSIGN(ParallelCursor);
+};
+
 /**
  * Returns whether or not a database exists given the database type and path.
  */
@@ -208,6 +280,24 @@ class CAFFE2_API DBReader {
     InitializeCursor(num_shards, shard_id);
   }
 
+  /**
+   * Reads the db ahead with a ParallelCursor, with num_threads reading
+   * threads and readahead chunks of chunk_size records, and moves back to the
+   * beginning of the shard.
+   */
+  void ReadInParallel(
+      const int32_t num_threads,
+      const int32_t readahead,
+      const int32_t chunk_size) {
+    CAFFE_ENFORCE(db_ != nullptr, "Reader not initialized.");
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    // The old cursor goes first, since some dbs allow a single cursor.
+    cursor_.reset();
+    cursor_ = make_unique<ParallelCursor>(
+        db_.get(), num_threads, readahead, chunk_size);
+    MoveToBeginning();
+  }
+
  public:
   /**
    * Read a set of key and value from the db and move to next. Thread safe.
@@ -1,5 +1,6 @@
 #include "caffe2/core/net_async_base.h"
 
+#include "c10/core/CPUAllocator.h"
 #include "caffe2/core/net_async_tracing.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/timer.h"
@@ -56,6 +57,12 @@ C10_DEFINE_bool(
     false,
     "Run root tasks in current thread instread of scheduling to threadpool");
 
+C10_DEFINE_bool(
+    caffe2_net_async_reuse_memory,
+    false,
+    "If set, recycle the buffers of the intermediate blobs of the net once "
+    "their last operator ran");
+
 namespace caffe2 {
 
 std::vector<int>& AsyncNetBase::getStreamCounters() {
@@ -109,6 +116,150 @@ AsyncNetBase::AsyncNetBase(
   if (tracer_) {
     LOG(INFO) << "Tracing net: " << net_def->name();
   }
+
+  if (options_.reuse_memory_) {
+    setupMemoryReuse(ws);
+  }
+}
+
+void AsyncNetBase::setupMemoryReuse(Workspace* ws) {
+  std::unordered_set<std::string> excluded;
+  for (const auto& name : external_input_) {
+    excluded.insert(name);
+  }
+  for (const auto& name : external_output_) {
+    excluded.insert(name);
+  }
+
+  std::unordered_map<std::string, int> blob_ids;
+  op_reused_blobs_.resize(operators_.size());
+  op_produced_blobs_.resize(operators_.size());
+  for (size_t op_id = 0; op_id < operators_.size(); ++op_id) {
+    const auto* op = operators_[op_id];
+    const auto& def = op->debug_def();
+    // The outputs of the asynchronous and non-CPU operators may still be
+    // written after RunAsync returns.
+    const bool sync_cpu = op->device_option().device_type() == PROTO_CPU &&
+        !op->HasAsyncPart();
+    std::unordered_set<std::string> inputs(
+        def.input().begin(), def.input().end());
+    std::unordered_set<std::string> names(inputs);
+    names.insert(def.output().begin(), def.output().end());
+    for (const auto& name : names) {
+      if (excluded.count(name)) {
+        continue;
+      }
+      auto it = blob_ids.find(name);
+      if (it == blob_ids.end()) {
+        // A blob read before it is written holds the value of the previous
+        // run.
+        if (!sync_cpu || inputs.count(name)) {
+          excluded.insert(name);
+          continue;
+        }
+        it = blob_ids.emplace(name, reused_blobs_.size()).first;
+        reused_blobs_.push_back(ReusedBlob{ws->GetBlob(name), 0, 0});
+        op_produced_blobs_[op_id].push_back(it->second);
+      } else if (!sync_cpu) {
+        excluded.insert(name);
+        continue;
+      }
+      reused_blobs_[it->second].num_uses++;
+      op_reused_blobs_[op_id].push_back(it->second);
+    }
+  }
+
+  // Drops the blobs excluded after their first use.
+  std::vector<int> new_ids(reused_blobs_.size(), -1);
+  std::vector<ReusedBlob> reused_blobs;
+  for (const auto& entry : blob_ids) {
+    if (!excluded.count(entry.first)) {
+      new_ids[entry.second] = reused_blobs.size();
+      reused_blobs.push_back(reused_blobs_[entry.second]);
+    }
+  }
+  reused_blobs_ = std::move(reused_blobs);
+  for (auto* op_blobs : {&op_reused_blobs_, &op_produced_blobs_}) {
+    for (auto& blobs : *op_blobs) {
+      std::vector<int> kept;
+      for (const auto id : blobs) {
+        if (new_ids[id] >= 0) {
+          kept.push_back(new_ids[id]);
+        }
+      }
+      blobs = std::move(kept);
+    }
+  }
+  blob_uses_left_.reset(new std::atomic<int>[reused_blobs_.size()]);
+  VLOG(1) << "Recycling the buffers of " << reused_blobs_.size()
+          << " blobs in net " << Name();
+}
+
+void AsyncNetBase::acquireBuffers(int op_id) {
+  for (const auto id : op_produced_blobs_[op_id]) {
+    auto& reused = reused_blobs_[id];
+    if (reused.nbytes == 0 || !BlobIsTensorType(*reused.blob, CPU)) {
+      continue;
+    }
+    auto* impl = BlobGetMutableTensor(reused.blob, CPU)->unsafeGetTensorImpl();
+    if (impl->storage().data() != nullptr) {
+      continue;
+    }
+    // The tensor keeps its sizes and type from the previous run, so the
+    // operator keeps the buffer if the sizes don't grow.
+    auto storage = buffer_pool_.take(reused.nbytes);
+    if (storage) {
+      impl->set_storage_keep_dtype(std::move(storage));
+    }
+  }
+}
+
+void AsyncNetBase::releaseBuffers(int op_id) {
+  for (const auto id : op_reused_blobs_[op_id]) {
+    if (--blob_uses_left_[id] != 0) {
+      continue;
+    }
+    auto& reused = reused_blobs_[id];
+    if (!BlobIsTensorType(*reused.blob, CPU)) {
+      continue;
+    }
+    auto* tensor = BlobGetMutableTensor(reused.blob, CPU);
+    const auto& storage = tensor->storage();
+    reused.nbytes = storage.nbytes();
+    // Only the buffers of plain types allocated by the CPU allocator, which
+    // nothing else refers to, can be handed to another blob.
+    if (storage.data() != nullptr && storage.unique() &&
+        tensor->dtype().placementNew() == nullptr &&
+        tensor->dtype().placementDelete() == nullptr &&
+        storage.data_ptr().get_deleter() ==
+            GetCPUAllocator()->raw_deleter()) {
+      buffer_pool_.give(storage);
+    }
+    tensor->FreeMemory();
+  }
+}
+
+c10::Storage AsyncNetBufferPool::take(size_t nbytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = buffers_.lower_bound(nbytes);
+  if (it == buffers_.end()) {
+    return c10::Storage();
+  }
+  auto storage = std::move(it->second);
+  bytes_ -= it->first;
+  buffers_.erase(it);
+  return storage;
+}
+
+void AsyncNetBufferPool::give(c10::Storage storage) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  bytes_ += storage.nbytes();
+  buffers_.emplace(storage.nbytes(), std::move(storage));
+}
+
+size_t AsyncNetBufferPool::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
 }
 
 bool AsyncNetBase::handleRunError() {
@@ -366,6 +517,9 @@ void AsyncNetBase::reset() {
     task_op_node.runtime_parent_count_ = parents(task_id).size();
     task_op_node.scheduled_.clear();
   }
+  for (size_t id = 0; id < reused_blobs_.size(); ++id) {
+    blob_uses_left_[id] = reused_blobs_[id].num_uses;
+  }
 
   success_ = true;
 }
@@ -406,6 +560,9 @@ bool AsyncNetBase::run(int task_id, int stream_id) noexcept {
     for (auto& op_id : chains_[task_id]) {
       op = operators_[op_id];
       bool success = false;
+      if (options_.reuse_memory_) {
+        acquireBuffers(op_id);
+      }
       if (!options_.report_stats_) {
         TRACE_EVENT(
             tracing::TRACE_OP,
@@ -430,6 +587,9 @@ bool AsyncNetBase::run(int task_id, int stream_id) noexcept {
         handleChainError(task_id, op, "Failed to execute an op");
         return false;
       }
+      if (options_.reuse_memory_) {
+        releaseBuffers(op_id);
+      }
     }
 
     op = nullptr;
@@ -588,6 +748,7 @@ ExecutionOptions::ExecutionOptions(
   }
 
   use_dfs_scheduling_ = false;
+  reuse_memory_ = FLAGS_caffe2_net_async_reuse_memory;
 
   for (int arg_idx = 0; arg_idx < net_def->arg_size(); ++arg_idx) {
     auto& arg = net_def->arg(arg_idx);
@@ -599,6 +760,10 @@ ExecutionOptions::ExecutionOptions(
       CAFFE_ENFORCE(arg.has_i(), "deferrable_mode should be an int");
       use_dfs_scheduling_ = arg.i() == 1; // corr. to DFS scheduling
     }
+    if (arg.has_name() && arg.name() == "reuse_memory") {
+      CAFFE_ENFORCE(arg.has_i(), "reuse_memory should be an int");
+      reuse_memory_ = arg.i() == 1;
+    }
   }
 
   if (FLAGS_caffe2_net_async_profile_operators) {
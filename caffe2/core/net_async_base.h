@@ -1,7 +1,10 @@
 #ifndef CAFFE2_CORE_NET_ASYNC_BASE_H_
 #define CAFFE2_CORE_NET_ASYNC_BASE_H_
 
+#include <map>
+
 #include <c10/macros/Macros.h>
+#include "c10/core/Storage.h"
 #include "c10/core/thread_pool.h"
 #include "c10/util/Registry.h"
 #include "caffe2/core/common.h"
@@ -24,6 +27,7 @@ C10_DECLARE_bool(caffe2_net_async_use_single_pool);
 C10_DECLARE_bool(caffe2_net_async_use_per_net_pools);
 C10_DECLARE_bool(caffe2_net_async_run_root_tasks_inline);
 C10_DECLARE_bool(caffe2_net_async_profile_operators);
+C10_DECLARE_bool(caffe2_net_async_reuse_memory);
 
 namespace caffe2 {
 
@@ -55,6 +59,24 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // recycle the buffers of the intermediate blobs once they are dead
+  bool reuse_memory_ = false;
+};
+
+// The CPU buffers of the dead intermediate blobs of a net, which the blobs
+// produced later take instead of allocating.
+class CAFFE2_API AsyncNetBufferPool {
+ public:
+  // Returns the smallest buffer of at least `nbytes`, or a null storage if
+  // there's none.
+  c10::Storage take(size_t nbytes);
+  void give(c10::Storage storage);
+  size_t bytes() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::multimap<size_t, c10::Storage> buffers_;
+  size_t bytes_ = 0;
 };
 
 struct CAFFE2_API AsyncNetCancelled : public std::exception {
@@ -124,6 +146,11 @@ class CAFFE2_API AsyncNetBase : public NetBase {
 
   bool isStreamFree(int task_id, int stream_id) const;
 
+  // Memory reuse, see ExecutionOptions::reuse_memory_
+  void setupMemoryReuse(Workspace* ws);
+  void acquireBuffers(int op_id);
+  void releaseBuffers(int op_id);
+
   virtual void reset();
 
   bool handleRunError() override;
@@ -163,6 +190,23 @@ class CAFFE2_API AsyncNetBase : public NetBase {
 
   ProfDAGCounters counters_;
 
+  // The intermediate blobs whose buffers are recycled: blobs which aren't
+  // inputs or outputs of the net, which are only used by synchronous CPU
+  // operators, and which are written before they are read in every run.
+  struct ReusedBlob {
+    Blob* blob;
+    // The number of operators using the blob in a run.
+    int num_uses;
+    // The size of the buffer of the blob in the previous run.
+    size_t nbytes;
+  };
+  std::vector<ReusedBlob> reused_blobs_;
+  // Per operator, the reused blobs it uses, and those it writes first.
+  std::vector<std::vector<int>> op_reused_blobs_;
+  std::vector<std::vector<int>> op_produced_blobs_;
+  std::unique_ptr<std::atomic<int>[]> blob_uses_left_;
+  AsyncNetBufferPool buffer_pool_;
+
   C10_DISABLE_COPY_AND_ASSIGN(AsyncNetBase);
 
  private:
@@ -3,7 +3,24 @@
 namespace caffe2 {
 REGISTER_CPU_OPERATOR(CreateDB, CreateDBOp<CPUContext>);
 
-OPERATOR_SCHEMA(CreateDB).NumInputs(0).NumOutputs(1);
+OPERATOR_SCHEMA(CreateDB)
+    .NumInputs(0)
+    .NumOutputs(1)
+    .Arg("db_type", "(string, default \"leveldb\") the type of the db.")
+    .Arg("db", "(string) the path of the db.")
+    .Arg("num_shards", "(int, default 1) the number of shards of the db.")
+    .Arg("shard_id", "(int, default 0) the shard read by the reader.")
+    .Arg(
+        "num_read_threads",
+        "(int, default 0) if positive, the reader reads the db ahead with "
+        "this many threads, each reading its own range of keys.")
+    .Arg(
+        "readahead",
+        "(int, default 16) the number of chunks read ahead when "
+        "num_read_threads is positive.")
+    .Arg(
+        "read_chunk_size",
+        "(int, default 32) the number of records in a chunk read ahead.");
 
 NO_GRADIENT(CreateDB);
 }  // namespace caffe2
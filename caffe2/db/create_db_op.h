@@ -19,13 +19,24 @@ class CreateDBOp final : public Operator<Context> {
         num_shards_(
             OperatorBase::template GetSingleArgument<int>("num_shards", 1)),
         shard_id_(
-            OperatorBase::template GetSingleArgument<int>("shard_id", 0)) {
+            OperatorBase::template GetSingleArgument<int>("shard_id", 0)),
+        num_read_threads_(OperatorBase::template GetSingleArgument<int>(
+            "num_read_threads",
+            0)),
+        readahead_(
+            OperatorBase::template GetSingleArgument<int>("readahead", 16)),
+        read_chunk_size_(OperatorBase::template GetSingleArgument<int>(
+            "read_chunk_size",
+            32)) {
     CAFFE_ENFORCE_GT(db_name_.size(), 0, "Must specify a db name.");
   }
 
   bool RunOnDevice() final {
-    OperatorBase::Output<db::DBReader>(0)->Open(
-        db_type_, db_name_, num_shards_, shard_id_);
+    auto* reader = OperatorBase::Output<db::DBReader>(0);
+    reader->Open(db_type_, db_name_, num_shards_, shard_id_);
+    if (num_read_threads_ > 0) {
+      reader->ReadInParallel(num_read_threads_, readahead_, read_chunk_size_);
+    }
     return true;
   }
 
@@ -34,6 +45,9 @@ class CreateDBOp final : public Operator<Context> {
   string db_name_;
   uint32_t num_shards_;
   uint32_t shard_id_;
+  int num_read_threads_;
+  int readahead_;
+  int read_chunk_size_;
   C10_DISABLE_COPY_AND_ASSIGN(CreateDBOp);
 };
 
@@ -89,6 +89,51 @@ TEST(DBSeekTest, LMDB) {
   DBSeekTestWrapper("lmdb");
 }
 
+static void ParallelCursorTestWrapper(const string& db_type) {
+  std::string name = std::tmpnam(nullptr);
+  if (!CreateAndFill(db_type, name)) {
+    EXPECT_TRUE(0);
+  } else {
+    std::unique_ptr<DB> db(CreateDB(db_type, name, READ));
+    // Chunks of 3 records, so that the reads and seeks cross chunks.
+    ParallelCursor cursor(db.get(), 4, 2, 3);
+    EXPECT_TRUE(cursor.SupportsSeek());
+    TestCursor(&cursor);
+    // All the records are returned in order.
+    cursor.SeekToFirst();
+    for (int i = 0; i < kMaxItems; ++i) {
+      std::stringstream ss;
+      ss << std::setw(2) << std::setfill('0') << i;
+      ASSERT_TRUE(cursor.Valid());
+      EXPECT_EQ(cursor.key(), ss.str());
+      EXPECT_EQ(cursor.value(), ss.str());
+      cursor.Next();
+    }
+    EXPECT_FALSE(cursor.Valid());
+  }
+}
+
+TEST(ParallelCursorTest, LevelDB) {
+  ParallelCursorTestWrapper("leveldb");
+}
+
+TEST(ParallelCursorTest, MiniDB) {
+  // MiniDB cursors can't seek, so a single thread reads ahead.
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("minidb", name);
+  std::unique_ptr<DB> db(CreateDB("minidb", name, READ));
+  ParallelCursor cursor(db.get(), 4, 2, 3);
+  EXPECT_FALSE(cursor.SupportsSeek());
+  int num_records = 0;
+  for (; cursor.Valid(); cursor.Next()) {
+    EXPECT_EQ(cursor.key(), cursor.value());
+    ++num_records;
+  }
+  EXPECT_EQ(num_records, kMaxItems);
+  cursor.SeekToFirst();
+  EXPECT_EQ(cursor.key(), "00");
+}
+
 TEST(DBReaderTest, Reader) {
   std::string name = std::tmpnam(nullptr);
   CreateAndFill("leveldb", name);
@@ -200,5 +245,20 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(DBReaderShardedTest, ParallelReader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+
+  std::unique_ptr<DBReader> reader(new DBReader("leveldb", name, 3, 1));
+  reader->ReadInParallel(2, 2, 2);
+  string key;
+  string value;
+  for (const char* expected : {"01", "04", "07", "01", "04"}) {
+    reader->Read(&key, &value);
+    EXPECT_EQ(key, expected);
+    EXPECT_EQ(value, expected);
+  }
+}
+
 } // namespace db
 } // namespace caffe2
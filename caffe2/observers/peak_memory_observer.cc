@@ -0,0 +1,86 @@
+#include "peak_memory_observer.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace caffe2 {
+
+PeakMemoryOperatorObserver::PeakMemoryOperatorObserver(
+    OperatorBase* op,
+    PeakMemoryNetObserver* netObserver)
+    : ObserverBase<OperatorBase>(op), netObserver_(netObserver) {
+  CAFFE_ENFORCE(netObserver_, "Observers can't operate outside of the net");
+}
+
+void PeakMemoryOperatorObserver::Stop() {
+  netObserver_->update();
+}
+
+std::unique_ptr<ObserverBase<OperatorBase>> PeakMemoryOperatorObserver::rnnCopy(
+    OperatorBase* subject,
+    int rnn_order) const {
+  return std::unique_ptr<ObserverBase<OperatorBase>>(
+      new PeakMemoryOperatorObserver(subject, netObserver_));
+}
+
+PeakMemoryNetObserver::PeakMemoryNetObserver(NetBase* subject)
+    : OperatorAttachingNetObserver<
+          PeakMemoryOperatorObserver,
+          PeakMemoryNetObserver>(subject, this) {
+  std::unordered_set<const Blob*> blobs;
+  for (auto* op : subject->GetOperators()) {
+    blobs.insert(op->Inputs().begin(), op->Inputs().end());
+    blobs.insert(op->Outputs().begin(), op->Outputs().end());
+  }
+  blobs_.assign(blobs.begin(), blobs.end());
+}
+
+size_t PeakMemoryNetObserver::current_bytes() const {
+  std::unordered_set<const void*> buffers;
+  size_t bytes = 0;
+  for (const auto* blob : blobs_) {
+    if (!blob || !BlobIsTensorType(*blob, CPU)) {
+      continue;
+    }
+    const auto& storage = blob->Get<Tensor>().storage();
+    if (storage.data() != nullptr && buffers.insert(storage.data()).second) {
+      bytes += storage.nbytes();
+    }
+  }
+  return bytes;
+}
+
+void PeakMemoryNetObserver::update() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  run_peak_bytes_ = std::max(run_peak_bytes_, current_bytes());
+}
+
+void PeakMemoryNetObserver::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  run_peak_bytes_ = current_bytes();
+}
+
+void PeakMemoryNetObserver::Stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  peak_bytes_ = run_peak_bytes_;
+  max_peak_bytes_ = std::max(max_peak_bytes_, peak_bytes_);
+  VLOG(1) << "This net iteration held at most " << peak_bytes_
+          << " bytes of tensors.";
+}
+
+size_t PeakMemoryNetObserver::peak_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return peak_bytes_;
+}
+
+size_t PeakMemoryNetObserver::max_peak_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_peak_bytes_;
+}
+
+std::string PeakMemoryNetObserver::debugInfo() {
+  return "The net's tensors held at most " + c10::to_string(max_peak_bytes()) +
+      " bytes.";
+}
+
+} // namespace caffe2
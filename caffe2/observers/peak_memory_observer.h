@@ -0,0 +1,69 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/observers/operator_attaching_net_observer.h"
+
+namespace caffe2 {
+
+class PeakMemoryNetObserver;
+
+class CAFFE2_API PeakMemoryOperatorObserver final
+    : public ObserverBase<OperatorBase> {
+ public:
+  explicit PeakMemoryOperatorObserver(OperatorBase* op) = delete;
+  PeakMemoryOperatorObserver(
+      OperatorBase* op,
+      PeakMemoryNetObserver* netObserver);
+  std::unique_ptr<ObserverBase<OperatorBase>> rnnCopy(
+      OperatorBase* subject,
+      int rnn_order) const override;
+
+ private:
+  void Stop() override;
+
+  PeakMemoryNetObserver* netObserver_;
+};
+
+// Tracks the bytes held by the CPU tensors of the blobs the operators of the
+// net use, which is measured after every operator, and reports the largest
+// value of a run. The buffers of the tensors sharing their data are counted
+// once, and the free buffers kept by the net for reuse aren't counted.
+//
+// With an asynchronous net, the tensors of the operators running at the same
+// time are measured while they may be resized, so the peak is approximate
+// unless the net runs a single operator at a time.
+class CAFFE2_API PeakMemoryNetObserver final
+    : public OperatorAttachingNetObserver<
+          PeakMemoryOperatorObserver,
+          PeakMemoryNetObserver> {
+ public:
+  explicit PeakMemoryNetObserver(NetBase* subject);
+
+  // The peak of the last run.
+  size_t peak_bytes() const;
+  // The largest peak of all the runs.
+  size_t max_peak_bytes() const;
+
+  std::string debugInfo() override;
+
+  friend class PeakMemoryOperatorObserver;
+
+ private:
+  void Start() override;
+  void Stop() override;
+  void update();
+  size_t current_bytes() const;
+
+  std::vector<const Blob*> blobs_;
+  mutable std::mutex mutex_;
+  size_t run_peak_bytes_ = 0;
+  size_t peak_bytes_ = 0;
+  size_t max_peak_bytes_ = 0;
+};
+
+} // namespace caffe2
@@ -0,0 +1,77 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "peak_memory_observer.h"
+
+#include <gtest/gtest.h>
+
+namespace caffe2 {
+
+namespace {
+
+constexpr int kSize = 1000;
+
+// A chain of operators, each of which only reads the output of the previous
+// one, so at most two of the intermediate blobs need to be alive at once.
+unique_ptr<NetBase> CreateNetTestHelper(Workspace* ws, bool reuse_memory) {
+  NetDef net_def;
+  net_def.set_type("async_scheduling");
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("ConstantFill");
+    op.add_output("hidden0");
+    auto& shape = *(op.add_arg());
+    shape.set_name("shape");
+    shape.add_ints(kSize);
+    auto& value = *(op.add_arg());
+    value.set_name("value");
+    value.set_f(-1.0);
+  }
+  for (int i = 1; i < 4; ++i) {
+    auto& op = *(net_def.add_op());
+    op.set_type("Relu");
+    op.add_input("hidden" + c10::to_string(i - 1));
+    op.add_output("hidden" + c10::to_string(i));
+  }
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("Relu");
+    op.add_input("hidden3");
+    op.add_output("out");
+  }
+  net_def.add_external_output("out");
+  auto& arg = *(net_def.add_arg());
+  arg.set_name("reuse_memory");
+  arg.set_i(reuse_memory);
+
+  return CreateNet(net_def, ws);
+}
+
+size_t PeakBytes(bool reuse_memory) {
+  Workspace ws;
+  unique_ptr<NetBase> net(CreateNetTestHelper(&ws, reuse_memory));
+  auto net_ob = std::make_unique<PeakMemoryNetObserver>(net.get());
+  const auto* ob = net_ob.get();
+  net->AttachObserver(std::move(net_ob));
+  for (int i = 0; i < 3; ++i) {
+    CAFFE_ENFORCE(net->Run());
+    const auto& out = ws.GetBlob("out")->Get<Tensor>();
+    EXPECT_EQ(out.numel(), kSize);
+    EXPECT_EQ(out.data<float>()[0], 0.0f);
+  }
+  return ob->max_peak_bytes();
+}
+
+} // namespace
+
+TEST(PeakMemoryObserverTest, ReuseMemory) {
+  const size_t blobBytes = kSize * sizeof(float);
+  // All the blobs keep their buffers.
+  EXPECT_EQ(PeakBytes(/*reuse_memory=*/false), 5 * blobBytes);
+  // The input and the output of the running operator are alive, along with
+  // the output of the net from the previous run.
+  EXPECT_EQ(PeakBytes(/*reuse_memory=*/true), 3 * blobBytes);
+}
+
+} // namespace caffe2
@@ -6,6 +6,7 @@
 #include "caffe2/core/operator.h"
 #include "caffe2/operators/fused_rowwise_nbit_conversion_ops.h"
 #include "caffe2/operators/reducer_functors.h"
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h"
 #include "caffe2/utils/math.h"
 #ifdef USE_FBGEMM
 #include "fbgemm/FbgemmEmbedding.h"
@@ -160,50 +161,20 @@ class SparseLengthsFusedNBitRowwiseOp final : public Operator<Context> {
 
     return false;
 #else
-    C10_LOG_EVERY_N(WARNING, 10)
-        << "Running slow path because FBGEMM is not available";
-
-    int64_t current = 0;
-    for (int m = 0; m < output_size; ++m) {
-      memset(output_data, 0, block_size * sizeof(float));
-      if (current + lengths_data[m] > index_size) {
-        return false;
-      }
-      for (int i = 0; i < lengths_data[m]; ++i, ++current) {
-        IndexType idx = indices_data[current];
-        if (idx < 0 || idx >= data_size) {
-          return false;
-        }
-
-        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
-            input_data + (idx + 1) * data.size(1) - 2 * sizeof(at::Half));
-
-        float weight = 1.0f;
-        if (with_weights) {
-          weight = weights[current];
-        }
-        const float scale = weight * scale_bias[0];
-        const float bias = weight * scale_bias[1];
-
-        for (int j = 0; j < block_size; ++j) {
-          uint8_t quantized =
-              input_data[idx * data.size(1) + j / NUM_ELEM_PER_BYTE];
-          quantized >>= (j % NUM_ELEM_PER_BYTE) * BIT_RATE;
-          quantized &= (1 << BIT_RATE) - 1;
-
-          output_data[j] = std::fma(scale, quantized, output_data[j] + bias);
-        }
-      } // for each i
-      if (is_mean && lengths_data[m]) {
-        float scale = 1.0f / lengths_data[m];
-        for (int j = 0; j < block_size; ++j) {
-          output_data[j] *= scale;
-        }
-      }
-      output_data += block_size;
-    } // for each m
+    FusedNBitRowwiseEmbeddingLookup(
+        BIT_RATE,
+        block_size,
+        output_size,
+        index_size,
+        data_size,
+        input_data,
+        indices_data,
+        lengths_data,
+        weights,
+        is_mean,
+        output_data);
 
-    return current == index_size;
+    return true;
 #endif // USE_FBGEMM
   }
 
@@ -0,0 +1,2185 @@
+//// --------------------------
+//// ATTENTION:
+//// THIS CODE IS AUTOGENERATED
+//// BY hp_emblookup_codegen.py
+//// DO NOT MODIFY!!!
+//// --------------------------
+
+#include <c10/util/Half.h>
+#include <immintrin.h>
+#include <cstring>
+namespace caffe2 {
+
+// Loads the 8 4-bit values packed in the 4 bytes at p as floats.
+static inline __m256 Load4Bit__avx2_fma(const uint8_t* p) {
+  int32_t packed;
+  std::memcpy(&packed, p, sizeof(packed));
+  const __m128i vpacked = _mm_cvtsi32_si128(packed);
+  const __m256i vbytes = _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+      vpacked,
+      _mm_setr_epi8(
+          0, 0, 1, 1, 2, 2, 3, 3,
+          -1, -1, -1, -1, -1, -1, -1, -1)));
+  const __m256i vshift = _mm256_setr_epi32(
+      0, 4, 0, 4, 0, 4, 0, 4);
+  return _mm256_cvtepi32_ps(_mm256_and_si256(
+      _mm256_srlv_epi32(vbytes, vshift), _mm256_set1_epi32(15)));
+}
+
+// Loads the 8 2-bit values packed in the 2 bytes at p as floats.
+static inline __m256 Load2Bit__avx2_fma(const uint8_t* p) {
+  uint16_t packed;
+  std::memcpy(&packed, p, sizeof(packed));
+  const __m128i vpacked = _mm_cvtsi32_si128(packed);
+  const __m256i vbytes = _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+      vpacked,
+      _mm_setr_epi8(
+          0, 0, 0, 0, 1, 1, 1, 1,
+          -1, -1, -1, -1, -1, -1, -1, -1)));
+  const __m256i vshift = _mm256_setr_epi32(
+      0, 2, 4, 6, 0, 2, 4, 6);
+  return _mm256_cvtepi32_ps(_mm256_and_si256(
+      _mm256_srlv_epi32(vbytes, vshift), _mm256_set1_epi32(3)));
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused4BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int prefdist_T0 = 16;
+  const int fused_block_size = block_size / 2 + 4;
+  int dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 16 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      __m256 vop64 = _mm256_setzero_ps();
+      __m256 vop72 = _mm256_setzero_ps();
+      __m256 vop80 = _mm256_setzero_ps();
+      __m256 vop88 = _mm256_setzero_ps();
+      __m256 vop96 = _mm256_setzero_ps();
+      __m256 vop104 = _mm256_setzero_ps();
+      __m256 vop112 = _mm256_setzero_ps();
+      __m256 vop120 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (16)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (20)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (24)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (28)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop64 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (32)),
+            _mm256_add_ps(vop64, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[32])
+        vop72 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (36)),
+            _mm256_add_ps(vop72, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[36])
+        vop80 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (40)),
+            _mm256_add_ps(vop80, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[40])
+        vop88 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (44)),
+            _mm256_add_ps(vop88, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[44])
+        vop96 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (48)),
+            _mm256_add_ps(vop96, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[48])
+        vop104 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (52)),
+            _mm256_add_ps(vop104, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[52])
+        vop112 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (56)),
+            _mm256_add_ps(vop112, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[56])
+        vop120 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (60)),
+            _mm256_add_ps(vop120, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[60])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+        _mm256_storeu_ps(&op[64], vop64);
+        _mm256_storeu_ps(&op[72], vop72);
+        _mm256_storeu_ps(&op[80], vop80);
+        _mm256_storeu_ps(&op[88], vop88);
+        _mm256_storeu_ps(&op[96], vop96);
+        _mm256_storeu_ps(&op[104], vop104);
+        _mm256_storeu_ps(&op[112], vop112);
+        _mm256_storeu_ps(&op[120], vop120);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+        _mm256_storeu_ps(&op[64], _mm256_mul_ps(vop64, vlen_inv));
+        _mm256_storeu_ps(&op[72], _mm256_mul_ps(vop72, vlen_inv));
+        _mm256_storeu_ps(&op[80], _mm256_mul_ps(vop80, vlen_inv));
+        _mm256_storeu_ps(&op[88], _mm256_mul_ps(vop88, vlen_inv));
+        _mm256_storeu_ps(&op[96], _mm256_mul_ps(vop96, vlen_inv));
+        _mm256_storeu_ps(&op[104], _mm256_mul_ps(vop104, vlen_inv));
+        _mm256_storeu_ps(&op[112], _mm256_mul_ps(vop112, vlen_inv));
+        _mm256_storeu_ps(&op[120], _mm256_mul_ps(vop120, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 8 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (16)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (20)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (24)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (28)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 4 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 2 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 8 <= block_size; j += 8) {
+        _mm256_storeu_ps(op + j, _mm256_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j],
+              _mm256_fmadd_ps(
+                  vwgt,
+                  Load4Bit__avx2_fma(&ip[j / 2]),
+                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));
+          _mm_prefetch(
+              reinterpret_cast<const char*>(&ip_next_T0[j / 2]), _MM_HINT_T0);
+        }
+        for (; j < block_size; j++) {
+          const uint8_t quantized =
+              (ip[j / 2] >> ((j % 2) * 4)) & 15;
+          op[j] = std::fma(wgt, (float)quantized, bio + op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m256 vlen_inv = _mm256_set1_ps(len_inv);
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused4BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_false__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused4BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused4BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_true__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused4BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int prefdist_T0 = 16;
+  const int fused_block_size = block_size / 4 + 4;
+  int dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 16 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      __m256 vop64 = _mm256_setzero_ps();
+      __m256 vop72 = _mm256_setzero_ps();
+      __m256 vop80 = _mm256_setzero_ps();
+      __m256 vop88 = _mm256_setzero_ps();
+      __m256 vop96 = _mm256_setzero_ps();
+      __m256 vop104 = _mm256_setzero_ps();
+      __m256 vop112 = _mm256_setzero_ps();
+      __m256 vop120 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (2)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (6)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (10)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[10])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (14)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[14])
+        vop64 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (16)),
+            _mm256_add_ps(vop64, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop72 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (18)),
+            _mm256_add_ps(vop72, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[18])
+        vop80 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (20)),
+            _mm256_add_ps(vop80, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop88 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (22)),
+            _mm256_add_ps(vop88, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[22])
+        vop96 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (24)),
+            _mm256_add_ps(vop96, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop104 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (26)),
+            _mm256_add_ps(vop104, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[26])
+        vop112 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (28)),
+            _mm256_add_ps(vop112, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop120 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (30)),
+            _mm256_add_ps(vop120, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[30])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+        _mm256_storeu_ps(&op[64], vop64);
+        _mm256_storeu_ps(&op[72], vop72);
+        _mm256_storeu_ps(&op[80], vop80);
+        _mm256_storeu_ps(&op[88], vop88);
+        _mm256_storeu_ps(&op[96], vop96);
+        _mm256_storeu_ps(&op[104], vop104);
+        _mm256_storeu_ps(&op[112], vop112);
+        _mm256_storeu_ps(&op[120], vop120);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+        _mm256_storeu_ps(&op[64], _mm256_mul_ps(vop64, vlen_inv));
+        _mm256_storeu_ps(&op[72], _mm256_mul_ps(vop72, vlen_inv));
+        _mm256_storeu_ps(&op[80], _mm256_mul_ps(vop80, vlen_inv));
+        _mm256_storeu_ps(&op[88], _mm256_mul_ps(vop88, vlen_inv));
+        _mm256_storeu_ps(&op[96], _mm256_mul_ps(vop96, vlen_inv));
+        _mm256_storeu_ps(&op[104], _mm256_mul_ps(vop104, vlen_inv));
+        _mm256_storeu_ps(&op[112], _mm256_mul_ps(vop112, vlen_inv));
+        _mm256_storeu_ps(&op[120], _mm256_mul_ps(vop120, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 8 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (2)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (6)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (10)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[10])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (14)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[14])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 4 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (2)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (6)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 2 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (2)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 8 <= block_size; j += 8) {
+        _mm256_storeu_ps(op + j, _mm256_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j],
+              _mm256_fmadd_ps(
+                  vwgt,
+                  Load2Bit__avx2_fma(&ip[j / 4]),
+                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));
+          _mm_prefetch(
+              reinterpret_cast<const char*>(&ip_next_T0[j / 4]), _MM_HINT_T0);
+        }
+        for (; j < block_size; j++) {
+          const uint8_t quantized =
+              (ip[j / 4] >> ((j % 4) * 2)) & 3;
+          op[j] = std::fma(wgt, (float)quantized, bio + op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m256 vlen_inv = _mm256_set1_ps(len_inv);
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_false__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_true__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused4BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int64_t prefdist_T0 = 16;
+  const int64_t fused_block_size = block_size / 2 + 4;
+  int64_t dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 16 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      __m256 vop64 = _mm256_setzero_ps();
+      __m256 vop72 = _mm256_setzero_ps();
+      __m256 vop80 = _mm256_setzero_ps();
+      __m256 vop88 = _mm256_setzero_ps();
+      __m256 vop96 = _mm256_setzero_ps();
+      __m256 vop104 = _mm256_setzero_ps();
+      __m256 vop112 = _mm256_setzero_ps();
+      __m256 vop120 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (16)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (20)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (24)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (28)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop64 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (32)),
+            _mm256_add_ps(vop64, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[32])
+        vop72 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (36)),
+            _mm256_add_ps(vop72, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[36])
+        vop80 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (40)),
+            _mm256_add_ps(vop80, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[40])
+        vop88 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (44)),
+            _mm256_add_ps(vop88, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[44])
+        vop96 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (48)),
+            _mm256_add_ps(vop96, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[48])
+        vop104 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (52)),
+            _mm256_add_ps(vop104, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[52])
+        vop112 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (56)),
+            _mm256_add_ps(vop112, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[56])
+        vop120 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (60)),
+            _mm256_add_ps(vop120, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[60])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+        _mm256_storeu_ps(&op[64], vop64);
+        _mm256_storeu_ps(&op[72], vop72);
+        _mm256_storeu_ps(&op[80], vop80);
+        _mm256_storeu_ps(&op[88], vop88);
+        _mm256_storeu_ps(&op[96], vop96);
+        _mm256_storeu_ps(&op[104], vop104);
+        _mm256_storeu_ps(&op[112], vop112);
+        _mm256_storeu_ps(&op[120], vop120);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+        _mm256_storeu_ps(&op[64], _mm256_mul_ps(vop64, vlen_inv));
+        _mm256_storeu_ps(&op[72], _mm256_mul_ps(vop72, vlen_inv));
+        _mm256_storeu_ps(&op[80], _mm256_mul_ps(vop80, vlen_inv));
+        _mm256_storeu_ps(&op[88], _mm256_mul_ps(vop88, vlen_inv));
+        _mm256_storeu_ps(&op[96], _mm256_mul_ps(vop96, vlen_inv));
+        _mm256_storeu_ps(&op[104], _mm256_mul_ps(vop104, vlen_inv));
+        _mm256_storeu_ps(&op[112], _mm256_mul_ps(vop112, vlen_inv));
+        _mm256_storeu_ps(&op[120], _mm256_mul_ps(vop120, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 8 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (16)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (20)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (24)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (28)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 4 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 2 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load4Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 8 <= block_size; j += 8) {
+        _mm256_storeu_ps(op + j, _mm256_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 2]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j],
+              _mm256_fmadd_ps(
+                  vwgt,
+                  Load4Bit__avx2_fma(&ip[j / 2]),
+                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));
+          _mm_prefetch(
+              reinterpret_cast<const char*>(&ip_next_T0[j / 2]), _MM_HINT_T0);
+        }
+        for (; j < block_size; j++) {
+          const uint8_t quantized =
+              (ip[j / 2] >> ((j % 2) * 4)) & 15;
+          op[j] = std::fma(wgt, (float)quantized, bio + op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m256 vlen_inv = _mm256_set1_ps(len_inv);
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused4BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused4BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused4BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_true__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused4BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int64_t prefdist_T0 = 16;
+  const int64_t fused_block_size = block_size / 4 + 4;
+  int64_t dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 16 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      __m256 vop64 = _mm256_setzero_ps();
+      __m256 vop72 = _mm256_setzero_ps();
+      __m256 vop80 = _mm256_setzero_ps();
+      __m256 vop88 = _mm256_setzero_ps();
+      __m256 vop96 = _mm256_setzero_ps();
+      __m256 vop104 = _mm256_setzero_ps();
+      __m256 vop112 = _mm256_setzero_ps();
+      __m256 vop120 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (2)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (6)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (10)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[10])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (14)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[14])
+        vop64 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (16)),
+            _mm256_add_ps(vop64, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop72 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (18)),
+            _mm256_add_ps(vop72, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[18])
+        vop80 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (20)),
+            _mm256_add_ps(vop80, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop88 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (22)),
+            _mm256_add_ps(vop88, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[22])
+        vop96 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (24)),
+            _mm256_add_ps(vop96, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop104 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (26)),
+            _mm256_add_ps(vop104, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[26])
+        vop112 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (28)),
+            _mm256_add_ps(vop112, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop120 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (30)),
+            _mm256_add_ps(vop120, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[30])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+        _mm256_storeu_ps(&op[64], vop64);
+        _mm256_storeu_ps(&op[72], vop72);
+        _mm256_storeu_ps(&op[80], vop80);
+        _mm256_storeu_ps(&op[88], vop88);
+        _mm256_storeu_ps(&op[96], vop96);
+        _mm256_storeu_ps(&op[104], vop104);
+        _mm256_storeu_ps(&op[112], vop112);
+        _mm256_storeu_ps(&op[120], vop120);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+        _mm256_storeu_ps(&op[64], _mm256_mul_ps(vop64, vlen_inv));
+        _mm256_storeu_ps(&op[72], _mm256_mul_ps(vop72, vlen_inv));
+        _mm256_storeu_ps(&op[80], _mm256_mul_ps(vop80, vlen_inv));
+        _mm256_storeu_ps(&op[88], _mm256_mul_ps(vop88, vlen_inv));
+        _mm256_storeu_ps(&op[96], _mm256_mul_ps(vop96, vlen_inv));
+        _mm256_storeu_ps(&op[104], _mm256_mul_ps(vop104, vlen_inv));
+        _mm256_storeu_ps(&op[112], _mm256_mul_ps(vop112, vlen_inv));
+        _mm256_storeu_ps(&op[120], _mm256_mul_ps(vop120, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 8 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (2)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (6)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (8)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (10)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[10])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (12)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (14)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[14])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 4 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (2)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (4)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (6)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 2 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (0)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            Load2Bit__avx2_fma(ip + (2)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 8 <= block_size; j += 8) {
+        _mm256_storeu_ps(op + j, _mm256_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + block_size / 4]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j],
+              _mm256_fmadd_ps(
+                  vwgt,
+                  Load2Bit__avx2_fma(&ip[j / 4]),
+                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));
+          _mm_prefetch(
+              reinterpret_cast<const char*>(&ip_next_T0[j / 4]), _MM_HINT_T0);
+        }
+        for (; j < block_size; j++) {
+          const uint8_t quantized =
+              (ip[j / 4] >> ((j % 4) * 2)) & 3;
+          op[j] = std::fma(wgt, (float)quantized, bio + op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m256 vlen_inv = _mm256_set1_ps(len_inv);
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_true__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+} // namespace caffe2
@@ -0,0 +1,257 @@
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h"
+
+#include <c10/util/Half.h>
+#include "caffe2/core/logging.h"
+#include "caffe2/perfkernels/common.h"
+
+namespace caffe2 {
+
+/**
+ * Base implementation does runtime dispatch for each segment of reduction
+ * @return false if there is an out-of-bound error
+ */
+template <
+    int BIT_RATE,
+    typename IndexType,
+    typename OutType,
+    bool IS_WEIGHT_POSITIONAL = false>
+static bool FusedNBitRowwiseEmbeddingLookupGenericSlow(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const IndexType* indices,
+    const int* lengths,
+    const float* weights, // optional, can be null for sum reducer
+    bool normalize_by_lengths,
+    OutType* out) {
+  constexpr int NUM_ELEM_PER_BYTE = 8 / BIT_RATE;
+  // block_size is the number of elements and fused_block_size is the size of
+  // an entire row, including scale and bias.
+  const int64_t fused_block_size =
+      block_size / NUM_ELEM_PER_BYTE + 2 * sizeof(at::Half);
+  int64_t current = 0;
+  for (int m = 0; m < output_size; ++m) {
+    memset(out, 0, sizeof(OutType) * block_size);
+    if (current + lengths[m] > index_size) {
+      return false;
+    }
+    for (int i = 0; i < lengths[m]; ++i) {
+      int64_t idx = indices[current];
+      if (idx < 0 || idx >= data_size) {
+        return false;
+      }
+#ifdef __GNUC__
+      if (current + 1 < index_size) {
+        __builtin_prefetch(
+            input + fused_block_size * indices[current + 1], 0, 1);
+      }
+#endif // __GNUC__
+
+      const uint8_t* row = input + fused_block_size * idx;
+      const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+          row + block_size / NUM_ELEM_PER_BYTE);
+
+      float weight = 1.0f;
+      if (weights) {
+        weight = weights[IS_WEIGHT_POSITIONAL ? i : current];
+      }
+      const float scale = weight * scale_bias[0];
+      const float bias = weight * scale_bias[1];
+
+      for (int j = 0; j < block_size; ++j) {
+        uint8_t quantized = row[j / NUM_ELEM_PER_BYTE];
+        quantized >>= (j % NUM_ELEM_PER_BYTE) * BIT_RATE;
+        quantized &= (1 << BIT_RATE) - 1;
+
+        out[j] = std::fma(scale, quantized, out[j] + bias);
+      }
+
+      ++current;
+    }
+    if (normalize_by_lengths && lengths[m]) {
+      float scale = 1.f / lengths[m];
+      for (int j = 0; j < block_size; ++j) {
+        out[j] *= scale;
+      }
+    }
+    out += block_size;
+  }
+  return current == index_size;
+}
+
+// Proxy back to generic implementation
+#define FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(IndexType, OutType, BIT_RATE)                   \
+  bool                                                                                              \
+      Fused##BIT_RATE##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base(     \
+          const int64_t block_size,                                                                 \
+          const int64_t output_size,                                                                \
+          const int64_t index_size,                                                                 \
+          const int64_t data_size,                                                                  \
+          const uint8_t* input,                                                                     \
+          const IndexType* indices,                                                                 \
+          const int* lengths,                                                                       \
+          const float* weights,                                                                     \
+          bool normalize_by_lengths,                                                                \
+          OutType* out) {                                                                           \
+    return FusedNBitRowwiseEmbeddingLookupGenericSlow<                                              \
+        BIT_RATE,                                                                                   \
+        IndexType,                                                                                  \
+        OutType,                                                                                    \
+        false>(                                                                                     \
+        block_size,                                                                                 \
+        output_size,                                                                                \
+        index_size,                                                                                 \
+        data_size,                                                                                  \
+        input,                                                                                      \
+        indices,                                                                                    \
+        lengths,                                                                                    \
+        weights,                                                                                    \
+        normalize_by_lengths,                                                                       \
+        out);                                                                                       \
+  }                                                                                                 \
+  decltype(                                                                                         \
+      Fused##BIT_RATE##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
+      Fused##BIT_RATE##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx2_fma; \
+  decltype(                                                                                         \
+      Fused##BIT_RATE##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
+      Fused##BIT_RATE##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx512;   \
+  bool Fused##BIT_RATE##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType(                  \
+      const int64_t block_size,                                                                     \
+      const int64_t output_size,                                                                    \
+      const int64_t index_size,                                                                     \
+      const int64_t data_size,                                                                      \
+      const uint8_t* input,                                                                         \
+      const IndexType* indices,                                                                     \
+      const int* lengths,                                                                           \
+      const float* weights,                                                                         \
+      bool normalize_by_lengths,                                                                    \
+      OutType* out) {                                                                               \
+    AVX512_DO(                                                                                      \
+        Fused##BIT_RATE##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                                 \
+        output_size,                                                                                \
+        index_size,                                                                                 \
+        data_size,                                                                                  \
+        input,                                                                                      \
+        indices,                                                                                    \
+        lengths,                                                                                    \
+        weights,                                                                                    \
+        normalize_by_lengths,                                                                       \
+        out);                                                                                       \
+    AVX2_FMA_DO(                                                                                    \
+        Fused##BIT_RATE##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                                 \
+        output_size,                                                                                \
+        index_size,                                                                                 \
+        data_size,                                                                                  \
+        input,                                                                                      \
+        indices,                                                                                    \
+        lengths,                                                                                    \
+        weights,                                                                                    \
+        normalize_by_lengths,                                                                       \
+        out);                                                                                       \
+    BASE_DO(                                                                                        \
+        Fused##BIT_RATE##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                                 \
+        output_size,                                                                                \
+        index_size,                                                                                 \
+        data_size,                                                                                  \
+        input,                                                                                      \
+        indices,                                                                                    \
+        lengths,                                                                                    \
+        weights,                                                                                    \
+        normalize_by_lengths,                                                                       \
+        out);                                                                                       \
+  }
+
+#define FUSED_NBIT_ROWWISE_EMBEDDING_DISPATCH(IndexType, OutType)                \
+  template <>                                                                    \
+  void FusedNBitRowwiseEmbeddingLookup<IndexType, uint8_t, OutType, false>(      \
+      const int bit_rate,                                                        \
+      const int64_t block_size,                                                  \
+      const int64_t output_size,                                                 \
+      const int64_t index_size,                                                  \
+      const int64_t data_size,                                                   \
+      const uint8_t* input,                                                      \
+      const IndexType* indices,                                                  \
+      const int* lengths,                                                        \
+      const float* weights,                                                      \
+      bool normalize_by_lengths,                                                 \
+      OutType* out) {                                                            \
+    const int32_t one = 1;                                                       \
+    CAFFE_ENFORCE_EQ(                                                            \
+        reinterpret_cast<const uint8_t*>(&one)[0],                               \
+        1,                                                                       \
+        "FusedNBitRowwiseEmbeddingLookup is not supported on this platform");    \
+    CAFFE_ENFORCE(                                                               \
+        bit_rate == 2 || bit_rate == 4,                                          \
+        "FusedNBitRowwiseEmbeddingLookup supports bit rates 2 and 4, not ",      \
+        bit_rate);                                                               \
+    CAFFE_ENFORCE_EQ(                                                            \
+        block_size % (8 / bit_rate),                                             \
+        0,                                                                       \
+        "block size must be divisible by ",                                      \
+        8 / bit_rate);                                                           \
+    bool success = bit_rate == 4                                                 \
+        ? Fused4BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType(       \
+              block_size,                                                        \
+              output_size,                                                       \
+              index_size,                                                        \
+              data_size,                                                         \
+              input,                                                             \
+              indices,                                                           \
+              lengths,                                                           \
+              weights,                                                           \
+              normalize_by_lengths,                                              \
+              out)                                                               \
+        : Fused2BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType(       \
+              block_size,                                                        \
+              output_size,                                                       \
+              index_size,                                                        \
+              data_size,                                                         \
+              input,                                                             \
+              indices,                                                           \
+              lengths,                                                           \
+              weights,                                                           \
+              normalize_by_lengths,                                              \
+              out);                                                              \
+    if (success) {                                                               \
+      return;                                                                    \
+    }                                                                            \
+    int64_t current = 0;                                                         \
+    for (int m = 0; m < output_size; ++m) {                                      \
+      for (int i = 0; i < lengths[m]; ++i) {                                     \
+        CAFFE_ENFORCE_LT(current, index_size);                                   \
+        IndexType idx = indices[current];                                        \
+        CAFFE_ENFORCE(                                                           \
+            0 <= idx && idx < data_size,                                         \
+            "Index ",                                                            \
+            current,                                                             \
+            " is out of bounds: ",                                               \
+            idx,                                                                 \
+            ", range 0 to ",                                                     \
+            data_size);                                                          \
+        ++current;                                                               \
+      }                                                                          \
+    }                                                                            \
+    CAFFE_ENFORCE_EQ(                                                            \
+        current,                                                                 \
+        index_size,                                                              \
+        "Your input seems to be incorrect: the sum of lengths values should be " \
+        "the size of the indices tensor, but it appears not.");                  \
+  }
+
+FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(int32_t, float, 4);
+FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(int32_t, float, 2);
+FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(int64_t, float, 4);
+FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(int64_t, float, 2);
+
+FUSED_NBIT_ROWWISE_EMBEDDING_DISPATCH(int32_t, float);
+FUSED_NBIT_ROWWISE_EMBEDDING_DISPATCH(int64_t, float);
+
+#undef FUSED_NBIT_ROWWISE_EMBEDDING_DISPATCH
+#undef FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION
+
+} // namespace caffe2
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+namespace caffe2 {
+
+/**
+ * Embedding lookup with reduction of fused N-bit rowwise quantized data.
+ *
+ * `input` of size data_size * (block_size / (8 / bit_rate) + 4B)
+ * `indices` of size index_size
+ * `lengths` of size output_size
+ * `weights` nullptr or array of size index_size
+ * `out` of size output_size * block_size
+ * sum(lengths[i]) == index_size
+ *
+ * bit_rate is 2 or 4, and block_size, the number of quantized values per row,
+ * must be a multiple of 8 / bit_rate. Each row holds the values packed in
+ * bytes from the lowest bits up, followed by an fp16 scale and an fp16 bias.
+ * The values are dequantized in registers, without the rows ever being
+ * expanded in memory.
+ *
+ * Behavior is roughly equivalent to pseudocode:
+ *
+ * pos = 0
+ * fused_block_size = block_size / (8 / bit_rate) + 4B // values, scale, bias
+ * for (i = 0..output_size-1)
+ *   for (k = 0..block_size-1)
+ *     out[i*block_size + k] = 0
+ *   for (j = 0..lengths[i]-1)
+ *     row = input + indices[pos]*fused_block_size
+ *     for (k = 0..block_size-1)
+ *       out[i*block_size + k] += (scale(row) * value(row, k) + bias(row)) *
+ *           (weights ? weights[IS_WEIGHT_POSITIONAL ? j : pos] : 1.0)
+ *     pos += 1
+ *   if (normalize_weights && lengths[i] > 0)
+ *     for (k = 0..block_size-1)
+ *       out[i*block_size + k] /= lengths[i]
+ *
+ */
+
+template <
+    typename IndexType,
+    typename InType,
+    typename OutType,
+    bool IS_WEIGHT_POSITIONAL = false>
+void FusedNBitRowwiseEmbeddingLookup(
+    const int bit_rate,
+    const std::int64_t block_size,
+    const std::int64_t output_size,
+    const std::int64_t index_size,
+    const std::int64_t data_size,
+    const InType* input,
+    const IndexType* indices,
+    const int* lengths,
+    const float* weights, // optional, can be null for non-weighted sum
+    bool normalize_by_lengths,
+    OutType* out);
+} // namespace caffe2
@@ -6,44 +6,162 @@ import sys
 
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
+# The vector types and intrinsics of each instruction set the kernels are
+# generated for. "width" is the number of floats in a vector register.
+isa_info = {
+    "avx2": {
+        "suffix": "__avx2_fma",
+        "vec": "__m256",
+        "ivec": "__m256i",
+        "pfx": "_mm256",
+        "width": 8,
+        "half_load": "_mm_loadu_si128",
+        "half_vec": "__m128i",
+        "uint8_load": "_mm_loadl_epi64",
+    },
+    "avx512": {
+        "suffix": "__avx512",
+        "vec": "__m512",
+        "ivec": "__m512i",
+        "pfx": "_mm512",
+        "width": 16,
+        "half_load": "_mm256_loadu_si256",
+        "half_vec": "__m256i",
+        "uint8_load": "_mm_loadu_si128",
+    },
+}
+
+
+def nbit_load_fn(bit_rate, isa):
+    return "Load{}Bit{}".format(bit_rate, isa["suffix"])
+
+
+def nbit_load(bit_rate, isa):
+    """Returns the helper which loads a vector of bit_rate-bit values, and
+    dequantizes them in registers: the packed bytes are spread to the lane of
+    each value, and shifted and masked to get the value."""
+    width = isa["width"]
+    num_elem_per_byte = 8 // bit_rate
+    num_bytes = width * bit_rate // 8
+    pfx = isa["pfx"]
+    shuffle = [
+        str(i // num_elem_per_byte) if i < width else "-1" for i in range(16)
+    ]
+    shift = [str((i % num_elem_per_byte) * bit_rate) for i in range(width)]
+
+    code = []
+    code.append(
+        "// Loads the {} {}-bit values packed in the {} bytes at p as floats.".format(
+            width, bit_rate, num_bytes
+        )
+    )
+    code.append(
+        "static inline {} {}(const uint8_t* p) {{".format(
+            isa["vec"], nbit_load_fn(bit_rate, isa)
+        )
+    )
+    if num_bytes == 8:
+        code.append(
+            "  const __m128i vpacked = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));"  # noqa
+        )
+    else:
+        packed_type = "uint16_t" if num_bytes == 2 else "int32_t"
+        code.append("  {} packed;".format(packed_type))
+        code.append("  std::memcpy(&packed, p, sizeof(packed));")
+        code.append("  const __m128i vpacked = _mm_cvtsi32_si128(packed);")
+    code.append("  const {} vbytes = {}_cvtepu8_epi32(_mm_shuffle_epi8(".format(
+        isa["ivec"], pfx
+    ))
+    code.append("      vpacked,")
+    code.append("      _mm_setr_epi8(")
+    code.append("          " + ", ".join(shuffle[:8]) + ",")
+    code.append("          " + ", ".join(shuffle[8:]) + ")));")
+    code.append("  const {} vshift = {}_setr_epi32(".format(isa["ivec"], pfx))
+    for i in range(0, width, 8):
+        code.append(
+            "      " + ", ".join(shift[i : i + 8]) + (");" if i + 8 >= width else ",")
+        )
+    code.append("  return {}_cvtepi32_ps({}_and_si{}(".format(
+        pfx, pfx, width * 32
+    ))
+    code.append(
+        "      {}_srlv_epi32(vbytes, vshift), {}_set1_epi32({})));".format(
+            pfx, pfx, (1 << bit_rate) - 1
+        )
+    )
+    code.append("}")
+    code.append("")
+    return code
+
+
+def unroll(
+    uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets, bit_rate
+):
+    pfx = isa["pfx"]
 
-def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
-        if InType == "float":
+        if bit_rate:
+            code.append(
+                "        vop%d = %s_fmadd_ps(\n"
+                "            vwgt,\n"
+                "            %s(ip + (%d)),\n"
+                "            %s_add_ps(vop%d, vbio));"
+                % (
+                    regid,
+                    pfx,
+                    nbit_load_fn(bit_rate, isa),
+                    regid * bit_rate // 8,
+                    pfx,
+                    regid,
+                )
+            )
+        elif InType == "float":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
-                % (regid, regid, regid)
+                "        vop%d = %s_fmadd_ps(vwgt, %s_loadu_ps(ip + (%d)), vop%d);"  # noqa
+                % (regid, pfx, pfx, regid, regid)
             )
         elif InType == "at::Half":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtph_ps(\n"
-                "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))),\n"  # noqa
-                "            vop%d);" % (regid, regid, regid)
+                "            %s_cvtph_ps(\n"
+                "                %s(reinterpret_cast<const %s*>(ip + (%d)))),\n"  # noqa
+                "            vop%d);"
+                % (
+                    regid,
+                    pfx,
+                    pfx,
+                    isa["half_load"],
+                    isa["half_vec"],
+                    regid,
+                    regid,
+                )
             )
         elif InType == "uint8_t":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
-                "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
-                "            _mm256_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                "            %s_cvtepi32_ps(%s_cvtepu8_epi32(\n"
+                "                %s(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
+                "            %s_add_ps(vop%d, vbio));"
+                % (regid, pfx, pfx, pfx, isa["uint8_load"], regid, pfx, regid)
             )
         else:
             assert False
 
+        prefetch_offset = regid * bit_rate // 8 if bit_rate else regid
         if prefetch:
             code.append(
                 "        _mm_prefetch(\n"
                 "            reinterpret_cast<const char*>(&ip_next_T0[%d]), _MM_HINT_T0);"
-                % (regid)
+                % (prefetch_offset)
             )
         else:
             code.append(
-                "        // skip unnecessary prefetch of (&ip_next_T0[%d])" % (regid)
+                "        // skip unnecessary prefetch of (&ip_next_T0[%d])"
+                % (prefetch_offset)
             )
 
         return code
@@ -66,8 +184,10 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = isa["width"] * i
+        code.append(
+            "      {} vop{} = {}_setzero_ps();".format(isa["vec"], j, pfx)
+        )
 
     # inner loop
     if use_offsets:
@@ -110,7 +230,15 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-        if fused:
+        if bit_rate:
+            code.append(
+                "        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(\n"  # noqa
+                "            &input[idx * fused_block_size + block_size / %d]);"
+                % (8 // bit_rate)
+            )
+            code.append("        bio = wgt * scale_bias[1];")
+            code.append("        wgt = wgt * scale_bias[0];")
+        elif fused:
             code.append(
                 "        const float* scale_bias = reinterpret_cast<const float*>(\n"
                 "            &input[idx * fused_block_size + block_size]);"
@@ -120,7 +248,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        {} vbio = {}_set1_ps(bio);".format(isa["vec"], pfx))
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -128,7 +256,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(isa["vec"], pfx))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -150,9 +278,9 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = isa["width"] * i
         cachelinesize = 64
-        byteoffset = sizeof[InType] * j
+        byteoffset = j * bit_rate // 8 if bit_rate else sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
         code.extend(compute(j, InType, use_weights, isa, prefetch))
     code.append("      }")
@@ -162,23 +290,30 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     else:
         code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = isa["width"] * i
+        code.append(
+            "        {}_storeu_ps(&op[{}], vop{});".format(pfx, j, j)
+        )
     code.append("      } else {")
     # inv of length
     if use_offsets:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / length);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / length);".format(
+                isa["vec"], pfx
+            )
+        )
     else:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / lengths[rangeIndex]);".format(
+                isa["vec"], pfx
+            )
+        )
     for i in range(0, uf):
-        j = 8 * i
+        j = isa["width"] * i
         code.append(
-            "        _mm256_storeu_ps(&op["
-            + str(j)
-            + "], _mm256_mul_ps("
-            + "vop"
-            + str(j)
-            + ", vlen_inv));"
+            "        {}_storeu_ps(&op[{}], {}_mul_ps(vop{}, vlen_inv));".format(
+                pfx, j, pfx, j
+            )
         )
     code.append("      }")
 
@@ -186,42 +321,69 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     return code
 
 
-def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
+def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets, bit_rate):
+    pfx = isa["pfx"]
+    width = isa["width"]
+
     def compute(InType, use_weights, isa):
         code = []
-        if InType == "float":
+        if bit_rate:
+            code.append(
+                "          {}_storeu_ps(\n"
+                "              &op[j],\n"
+                "              {}_fmadd_ps(\n"
+                "                  vwgt,\n"
+                "                  {}(&ip[j / {}]),\n"
+                "                  {}_add_ps({}_loadu_ps(&op[j]), vbio)));".format(
+                    pfx,
+                    pfx,
+                    nbit_load_fn(bit_rate, isa),
+                    8 // bit_rate,
+                    pfx,
+                    pfx,
+                )
+            )
+        elif InType == "float":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          {}_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt, _mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])));"  # noqa
+                "              {}_fmadd_ps(\n"
+                "                  vwgt, {}_loadu_ps(&ip[j]), {}_loadu_ps(&op[j])));".format(  # noqa
+                    pfx, pfx, pfx, pfx
+                )
             )
         elif InType == "at::Half":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          {}_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              {}_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtph_ps(_mm_loadu_si128(\n"
-                "                      reinterpret_cast<const __m128i*>(&ip[j]))),\n"
-                "                  _mm256_loadu_ps(&op[j])));"
+                "                  {}_cvtph_ps({}(\n"
+                "                      reinterpret_cast<const {}*>(&ip[j]))),\n"
+                "                  {}_loadu_ps(&op[j])));".format(
+                    pfx, pfx, pfx, isa["half_load"], isa["half_vec"], pfx
+                )
             )
         elif InType == "uint8_t":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          {}_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              {}_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"  # noqa
+                "                  {}_cvtepi32_ps({}_cvtepu8_epi32({}(\n"  # noqa
                 "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
-                "                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));"
+                "                  {}_add_ps({}_loadu_ps(&op[j]), vbio)));".format(
+                    pfx, pfx, pfx, pfx, isa["uint8_load"], pfx, pfx
+                )
             )
         else:
             assert False
 
         code.append(
             "          _mm_prefetch(\n"
-            "              reinterpret_cast<const char*>(&ip_next_T0[j]), _MM_HINT_T0);"
+            "              reinterpret_cast<const char*>(&ip_next_T0[{}]), _MM_HINT_T0);".format(  # noqa
+                "j / {}".format(8 // bit_rate) if bit_rate else "j"
+            )
         )
 
         return code
@@ -249,8 +411,10 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append(
+        "      for (; j + {} <= block_size; j += {}) {{".format(width, width)
+    )
+    code.append("        {}_storeu_ps(op + j, {}_setzero_ps());".format(pfx, pfx))
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -297,7 +461,15 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-        if fused:
+        if bit_rate:
+            code.append(
+                "        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(\n"  # noqa
+                "            &input[idx * fused_block_size + block_size / %d]);"
+                % (8 // bit_rate)
+            )
+            code.append("        bio = wgt * scale_bias[1];")
+            code.append("        wgt = wgt * scale_bias[0];")
+        elif fused:
             code.append(
                 "        const float* scale_bias = reinterpret_cast<const float*>(\n"
                 "            &input[idx * fused_block_size + block_size]);"
@@ -307,7 +479,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        {} vbio = {}_set1_ps(bio);".format(isa["vec"], pfx))
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -315,7 +487,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(isa["vec"], pfx))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -337,12 +509,26 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append(
+        "        for (; j + {} <= block_size; j += {}) {{".format(width, width)
+    )
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
     code.append("        for (; j < block_size; j++) {")
-    if InType == "float":
+    if bit_rate:
+        num_elem_per_byte = 8 // bit_rate
+        code.append(
+            "          const uint8_t quantized =\n"
+            "              (ip[j / {}] >> ((j % {}) * {})) & {};".format(
+                num_elem_per_byte,
+                num_elem_per_byte,
+                bit_rate,
+                (1 << bit_rate) - 1,
+            )
+        )
+        code.append("          op[j] = std::fma(wgt, (float)quantized, bio + op[j]);")
+    elif InType == "float":
         code.append("          op[j] = std::fma(wgt, ip[j], op[j]);")
     elif InType == "at::Half":
         code.append("          vtmp1[0] = ip[j];")
@@ -366,12 +552,16 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     else:
         code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
         code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append("        {} vlen_inv = {}_set1_ps(len_inv);".format(isa["vec"], pfx))
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "        for (; j + {} <= block_size; j += {}) {{".format(width, width)
+    )
+    code.append(
+        "          {}_storeu_ps(\n"
+        "              &op[j], {}_mul_ps({}_loadu_ps(&op[j]), vlen_inv));".format(
+            pfx, pfx, pfx
+        )
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -388,29 +578,48 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
+parser.add_argument(
+    "--fused-nbit",
+    action="store_true",
+    help="generate the lookups of the fused 4-bit and 2-bit rowwise quantized data",
+)
 parser.add_argument("--use-offsets", action="store_true")
+parser.add_argument("--isa", choices=sorted(isa_info.keys()), default="avx2")
 opts = parser.parse_args()
+assert not (opts.fused_nbit and opts.use_offsets), "--use-offsets isn't supported"
+isa = isa_info[opts.isa]
 if opts.filename:
     filename = opts.filename
+elif opts.fused_nbit:
+    filename = "embedding_lookup_fused_nbit_rowwise_{}.cc".format(opts.isa)
 elif opts.fused:
     if opts.use_offsets:
-        filename = "embedding_lookup_fused_8bit_rowwise_idx_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
     if opts.use_offsets:
-        filename = "embedding_lookup_idx_avx2.cc"
+        filename = "embedding_lookup_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_avx2.cc"
-
-options = [
-    ["int32_t", "int", "float", "float", "float", "float"],
-    ["int64_t", "int64_t", "float", "float", "float", "float"],
-    ["int32_t", "int", "half", "at::Half", "float", "float"],
-    ["int64_t", "int64_t", "half", "at::Half", "float", "float"],
-    ["int32_t", "int", "uint8_t", "uint8_t", "float", "float"],
-    ["int64_t", "int64_t", "uint8_t", "uint8_t", "float", "float"],
-]
+        filename = "embedding_lookup_{}.cc".format(opts.isa)
+
+if opts.fused_nbit:
+    options = [
+        ["int32_t", "int", "uint8_t", "uint8_t", "float", "float", bit_rate]
+        for bit_rate in [4, 2]
+    ] + [
+        ["int64_t", "int64_t", "uint8_t", "uint8_t", "float", "float", bit_rate]
+        for bit_rate in [4, 2]
+    ]
+else:
+    options = [
+        ["int32_t", "int", "float", "float", "float", "float", None],
+        ["int64_t", "int64_t", "float", "float", "float", "float", None],
+        ["int32_t", "int", "half", "at::Half", "float", "float", None],
+        ["int64_t", "int64_t", "half", "at::Half", "float", "float", None],
+        ["int32_t", "int", "uint8_t", "uint8_t", "float", "float", None],
+        ["int64_t", "int64_t", "uint8_t", "uint8_t", "float", "float", None],
+    ]
 
 code = []
 # includes
@@ -423,12 +632,20 @@ code.append("//// --------------------------\n")
 
 code.append("#include <c10/util/Half.h>")
 code.append("#include <immintrin.h>")
+if opts.fused_nbit:
+    code.append("#include <cstring>")
 
 code.append("namespace caffe2 {\n")
+if opts.fused_nbit:
+    for bit_rate in [4, 2]:
+        code += nbit_load(bit_rate, isa)
 for o in options:
-    [IndexTypeName, IndexType, InTypeName, InType, OutTypeName, OutType] = o
+    [IndexTypeName, IndexType, InTypeName, InType, OutTypeName, OutType, bit_rate] = o
 
-    prefix = "Fused8BitRowwise" if opts.fused else ""
+    if bit_rate:
+        prefix = "Fused{}BitRowwise".format(bit_rate)
+    else:
+        prefix = "Fused8BitRowwise" if opts.fused else ""
     code.append("template <bool IS_WEIGHT_POSITIONAL>")
     if opts.use_offsets:
         fn_base = "{}EmbeddingLookupIdx_{}_{}_{}".format(
@@ -438,7 +655,7 @@ for o in options:
         fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
             prefix, IndexTypeName, InTypeName, OutTypeName
         )
-    suffix = "__avx2_fma"
+    suffix = isa["suffix"]
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -454,7 +671,7 @@ for o in options:
     else:
         args.append("    const int* lengths,")
     args.append("    const float* weights,")
-    if not opts.fused:
+    if not (opts.fused or opts.fused_nbit):
         args.append("    const float* scale_bias,")
     args.append("    bool normalize_by_lengths,")
     args.append("    " + OutType + "* out) {")
@@ -463,10 +680,19 @@ for o in options:
     code.append("  const " + IndexType + " prefdist_T0 = 16;")
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
-    offset = (8 // sizeof[InType]) if opts.fused else 0
-    code.append(
-        "  const {} fused_block_size = block_size + {};".format(IndexType, offset)
-    )
+    if bit_rate:
+        # The row holds block_size / (8 / bit_rate) bytes of packed values, and
+        # an fp16 scale and bias.
+        code.append(
+            "  const {} fused_block_size = block_size / {} + 4;".format(
+                IndexType, 8 // bit_rate
+            )
+        )
+    else:
+        offset = (8 // sizeof[InType]) if opts.fused else 0
+        code.append(
+            "  const {} fused_block_size = block_size + {};".format(IndexType, offset)
+        )
     if opts.use_offsets:
         code.append("  int64_t dataInd = 0;")
     else:
@@ -474,17 +700,26 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    for i, block_size in enumerate([128, 64, 32, 16]):
+        code.append(
+            "  {}if (block_size == {}) {{".format("} else " if i else "", block_size)
+        )
+        code += unroll(
+            block_size // isa["width"],
+            IndexType,
+            InType,
+            OutType,
+            True,
+            isa,
+            opts.fused,
+            opts.use_offsets,
+            bit_rate,
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    code += generic(
+        IndexType, InType, OutType, True, isa, opts.fused, opts.use_offsets, bit_rate
+    )
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
@@ -511,7 +746,7 @@ for o in options:
         else:
             code.append("      lengths,")
         code.append("      weights,")
-        if not opts.fused:
+        if not (opts.fused or opts.fused_nbit):
             code.append("      scale_bias,")
         code.append("      normalize_by_lengths,")
         code.append("      out);")
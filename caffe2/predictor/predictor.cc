@@ -41,42 +41,80 @@ Predictor::Predictor(
           optimization)) {}
 
 Predictor::Predictor(PredictorConfig config) : config_(std::move(config)) {
-  const auto& initialized_vec = config_.ws->Blobs();
+  if (!config_.thread_local_workspaces) {
+    create_net(config_.ws.get(), /*local_blobs=*/false);
+  }
+}
+
+void Predictor::create_net(Workspace* ws, bool local_blobs) {
+  if (local_blobs) {
+    // The outputs of the ops would be created in the parent workspace if it
+    // has a blob of the same name, and the parameters would be overwritten.
+    for (const auto& op : config_.predict_net->op()) {
+      for (const auto& output : op.output()) {
+        ws->CreateLocalBlob(output);
+      }
+    }
+  }
+  const auto& initialized_vec = ws->Blobs();
   const std::unordered_set<std::string> initialized{initialized_vec.begin(),
                                                     initialized_vec.end()};
   for (const auto& name : config_.predict_net->external_input()) {
     if (!initialized.count(name)) {
-      auto* blob = config_.ws->CreateBlob(name);
+      auto* blob = ws->CreateBlob(name);
       BlobGetMutableTensor(blob, CPU);
     }
   }
-  CAFFE_ENFORCE(config_.ws->CreateNet(config_.predict_net));
+  CAFFE_ENFORCE(ws->CreateNet(config_.predict_net));
+}
+
+Workspace* Predictor::run_workspace() {
+  if (!config_.thread_local_workspaces) {
+    return config_.ws.get();
+  }
+  auto* ws = thread_ws_.get();
+  if (!ws) {
+    auto child = make_unique<Workspace>(config_.ws.get());
+    create_net(child.get(), /*local_blobs=*/true);
+    ws = child.get();
+    thread_ws_.reset(std::move(child));
+  }
+  return ws;
+}
+
+Blob* Predictor::input_blob(Workspace* ws, const std::string& name) {
+  if (config_.thread_local_workspaces) {
+    // The inputs shadow the blobs of the same names in the parent workspace.
+    return ws->CreateLocalBlob(name);
+  }
+  return getBlob(ws, name);
 }
 
 bool Predictor::operator()(const TensorList& inputs, TensorList* outputs) {
   CAFFE_ENFORCE(
       inputs.size() <=
       static_cast<unsigned>(config_.predict_net->external_input_size()));
+  auto* ws = run_workspace();
   for (size_t i = 0; i < inputs.size(); ++i) {
     // This is evil and shares the same underlying tensor
     BlobSetTensor(
-        getBlob(config_.ws.get(), config_.predict_net->external_input(i)),
+        input_blob(ws, config_.predict_net->external_input(i)),
         inputs[i].UnsafeSharedInstance());
   }
 
-  if (!config_.ws->RunNet(config_.predict_net->name())) {
+  if (!ws->RunNet(config_.predict_net->name())) {
     return false;
   }
   outputs->clear();
   for (size_t i = 0; i < config_.predict_net->external_output_size(); ++i) {
     outputs->emplace_back(
-        getTensor(config_.ws.get(), config_.predict_net->external_output(i))
+        getTensor(ws, config_.predict_net->external_output(i))
             .UnsafeSharedInstance());
   }
   return true;
 }
 
-bool Predictor::run_map_workspace(const TensorMap& inputs) {
+bool Predictor::run_map_workspace(Workspace* ws, const TensorMap& inputs) {
   if (!config_.input_names.empty()) {
     CAFFE_ENFORCE_EQ(inputs.size(), input_names().size());
   }
@@ -90,35 +128,35 @@ bool Predictor::run_map_workspace(const TensorMap& inputs) {
     }
     // This is evil and shares the same underlying tensor
     BlobSetTensor(
-        getBlob(config_.ws.get(), input.first),
-        input.second.UnsafeSharedInstance());
+        input_blob(ws, input.first), input.second.UnsafeSharedInstance());
   }
 
-  return config_.ws->RunNet(config_.predict_net->name());
+  return ws->RunNet(config_.predict_net->name());
 }
 
 bool Predictor::operator()(const TensorMap& inputs, TensorList* outputs) {
-  if (!run_map_workspace(inputs)) {
+  auto* ws = run_workspace();
+  if (!run_map_workspace(ws, inputs)) {
     return false;
   }
   outputs->clear();
   for (size_t i = 0; i < config_.predict_net->external_output_size(); ++i) {
     outputs->push_back(
-        getTensor(config_.ws.get(), config_.predict_net->external_output(i))
+        getTensor(ws, config_.predict_net->external_output(i))
             .UnsafeSharedInstance());
   }
   return true;
 }
 
 bool Predictor::operator()(const TensorMap& inputs, TensorMap* outputs) {
-  if (!run_map_workspace(inputs)) {
+  auto* ws = run_workspace();
+  if (!run_map_workspace(ws, inputs)) {
     return false;
   }
 
   for (const std::string& outputName : output_names()) {
     outputs->emplace(
-        outputName,
-        getTensor(config_.ws.get(), outputName).UnsafeSharedInstance());
+        outputName, getTensor(ws, outputName).UnsafeSharedInstance());
   }
   return true;
 }
@@ -3,6 +3,7 @@
 #include <unordered_set>
 #include "caffe2/core/net.h"
 #include "caffe2/core/tensor.h"
+#include "caffe2/predictor/ThreadLocalPtr.h"
 #include "caffe2/predictor/predictor_config.h"
 
 namespace caffe2 {
@@ -36,6 +37,10 @@ class CAFFE2_API Predictor {
   // NOTE: output is a part of thread local workspace
   // and is only valid until the next predictor execution.
 
+  // With PredictorConfig::thread_local_workspaces, the predictor can be run
+  // from several threads at once, and the outputs of a thread are valid until
+  // its next execution.
+
   // Returns true on success
   virtual bool operator()(const TensorList& inputs, TensorList* outputs);
 
@@ -50,6 +55,8 @@ class CAFFE2_API Predictor {
     return *config_.predict_net;
   };
 
+  // The workspace of the parameters, which doesn't hold the inputs and the
+  // outputs with PredictorConfig::thread_local_workspaces.
   Workspace* ws() {
     return config_.ws.get();
   };
@@ -63,9 +70,18 @@ class CAFFE2_API Predictor {
   }
 
  private:
-  bool run_map_workspace(const TensorMap& inputs);
+  bool run_map_workspace(Workspace* ws, const TensorMap& inputs);
+  // The workspace the net runs in for the calling thread.
+  Workspace* run_workspace();
+  Blob* input_blob(Workspace* ws, const std::string& name);
+  void create_net(Workspace* ws, bool local_blobs);
 
  protected:
   PredictorConfig config_;
+
+ private:
+  // Declared after config_, so that the workspaces of the threads are
+  // destroyed before the workspace of the parameters they refer to.
+  ThreadLocalPtr<Workspace> thread_ws_;
 };
 } // namespace caffe2
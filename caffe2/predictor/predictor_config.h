@@ -39,6 +39,12 @@ struct CAFFE2_API PredictorConfig {
   // tensor. Once tensor support intrusive_ptr, we'll get rid of this and use
   // parameters to construct Workspace
   std::shared_ptr<Workspace> ws;
+
+  // If true, ws only holds the parameters and the predictor never writes to
+  // it, so that it can be shared by the threads running the predictor: every
+  // thread gets a child workspace of its own for the inputs, the activations
+  // and the net, and the parameters are kept once however many threads serve.
+  bool thread_local_workspaces{false};
 };
 
 CAFFE2_API Workspace makeWorkspace(std::shared_ptr<PredictorParameters> parameters);
@@ -6,6 +6,8 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 namespace caffe2 {
 
 namespace {
@@ -205,4 +207,44 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
 }
 
+TEST_F(PredictorTest, ThreadLocalWorkspaces) {
+  auto inputData = randomTensor({1, 4}, ctx_.get());
+  Predictor::TensorList input;
+  input.emplace_back(BlobGetMutableTensor(inputData.get(), CPU)->Alias());
+  Predictor::TensorList expected;
+  (*p_)(input, &expected);
+
+  auto config =
+      makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec));
+  config.thread_local_workspaces = true;
+  Predictor p(config);
+  const auto numBlobs = config.ws->Blobs().size();
+
+  std::vector<Predictor::TensorList> outputs(4);
+  std::vector<std::thread> threads;
+  for (auto& output : outputs) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 10; ++i) {
+        p(input, &output);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& output : outputs) {
+    EXPECT_EQ(output.size(), 1);
+    EXPECT_EQ(output.front().sizes(), expected.front().sizes());
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(
+          output.front().data<float>()[i], expected.front().data<float>()[i]);
+    }
+  }
+  // The threads ran in workspaces of their own, and left the parameters alone.
+  EXPECT_EQ(config.ws->Blobs().size(), numBlobs);
+  EXPECT_FALSE(config.ws->HasBlob("data"));
+  EXPECT_FALSE(config.ws->HasBlob("y"));
+}
+
 } // namespace caffe2
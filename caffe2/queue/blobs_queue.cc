@@ -1,6 +1,7 @@
 #include "caffe2/queue/blobs_queue.h"
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -29,15 +30,19 @@ BlobsQueue::BlobsQueue(
     size_t numBlobs,
     bool enforceUniqueName,
     const std::vector<std::string>& fieldNames)
-    : numBlobs_(numBlobs), name_(queueName), stats_(queueName) {
+    : numBlobs_(numBlobs),
+      capacity_(capacity),
+      queue_(new Slot[capacity]),
+      name_(queueName),
+      stats_(queueName) {
+  CAFFE_ENFORCE_GT(capacity, 0, "The capacity of a queue must be positive.");
   if (!fieldNames.empty()) {
     CAFFE_ENFORCE_EQ(
         fieldNames.size(), numBlobs, "Wrong number of fieldNames provided.");
     stats_.queue_dequeued_bytes.setDetails(fieldNames);
   }
-  queue_.reserve(capacity);
   for (size_t i = 0; i < capacity; ++i) {
-    std::vector<Blob*> blobs;
+    auto& blobs = queue_[i].blobs;
     blobs.reserve(numBlobs);
     for (size_t j = 0; j < numBlobs; ++j) {
       const auto blobName = queueName + "_" + to_string(i) + "_" + to_string(j);
@@ -49,9 +54,7 @@ BlobsQueue::BlobsQueue(
       }
       blobs.push_back(ws->CreateBlob(blobName));
     }
-    queue_.push_back(blobs);
   }
-  DCHECK_EQ(queue_.size(), capacity);
 }
 
 bool BlobsQueue::blockingRead(
@@ -61,22 +64,25 @@ bool BlobsQueue::blockingRead(
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_read_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  auto canRead = [this]() {
-    CAFFE_ENFORCE_LE(reader_, writer_);
-    return reader_ != writer_;
-  };
+  CAFFE_ENFORCE(inputs.size() >= numBlobs_);
   // Decrease queue balance before reading to indicate queue read pressure
   // is being increased (-ve queue balance indicates more reads than writes)
   CAFFE_EVENT(stats_, queue_balance, -1);
-  if (timeout_secs > 0) {
-    std::chrono::milliseconds timeout_ms(int(timeout_secs * 1000));
-    cv_.wait_for(
-        g, timeout_ms, [this, canRead]() { return closing_ || canRead(); });
-  } else {
-    cv_.wait(g, [this, canRead]() { return closing_ || canRead(); });
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(int(timeout_secs * 1000));
+  bool read = doRead(inputs);
+  bool timedOut = false;
+  while (!read && !closing_ && !timedOut) {
+    const auto key = notEmpty_.prepareWait();
+    read = doRead(inputs);
+    if (read || closing_) {
+      notEmpty_.cancelWait();
+      break;
+    }
+    timedOut = !notEmpty_.wait(key, timeout_secs > 0 ? &deadline : nullptr);
+    read = doRead(inputs);
   }
-  if (!canRead()) {
+  if (!read) {
     if (timeout_secs > 0 && !closing_) {
       LOG(ERROR) << "DequeueBlobs timed out in " << timeout_secs << " secs";
       CAFFE_SDT(queue_read_end, name, (void*)this, SDT_TIMEOUT);
@@ -85,19 +91,7 @@ bool BlobsQueue::blockingRead(
     }
     return false;
   }
-  DCHECK(canRead());
-  auto& result = queue_[reader_ % queue_.size()];
-  CAFFE_ENFORCE(inputs.size() >= result.size());
-  for (auto i = 0; i < result.size(); ++i) {
-    auto bytes = BlobStat::sizeBytes(*result[i]);
-    CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
-    using std::swap;
-    swap(*(inputs[i]), *(result[i]));
-  }
-  CAFFE_SDT(queue_read_end, name, (void*)this, writer_ - reader_);
   CAFFE_EVENT(stats_, queue_dequeued_records);
-  ++reader_;
-  cv_.notify_all();
   CAFFE_EVENT(stats_, read_time_ns, readTimer.NanoSeconds());
   return true;
 }
@@ -107,16 +101,14 @@ bool BlobsQueue::tryWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_NONBLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  if (!canWrite()) {
+  CAFFE_ENFORCE(inputs.size() >= numBlobs_);
+  if (!doWrite(inputs)) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
     return false;
   }
-  // Increase queue balance before writing to indicate queue write pressure is
-  // being increased (+ve queue balance indicates more writes than reads)
+  // Increase queue balance to indicate queue write pressure is being
+  // increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  DCHECK(canWrite());
-  doWrite(inputs);
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
   return true;
 }
@@ -126,17 +118,25 @@ bool BlobsQueue::blockingWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
+  CAFFE_ENFORCE(inputs.size() >= numBlobs_);
   // Increase queue balance before writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  cv_.wait(g, [this]() { return closing_ || canWrite(); });
-  if (!canWrite()) {
+  bool written = doWrite(inputs);
+  while (!written && !closing_) {
+    const auto key = notFull_.prepareWait();
+    written = doWrite(inputs);
+    if (written || closing_) {
+      notFull_.cancelWait();
+      break;
+    }
+    notFull_.wait(key);
+    written = doWrite(inputs);
+  }
+  if (!written) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
     return false;
   }
-  DCHECK(canWrite());
-  doWrite(inputs);
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
   return true;
 }
@@ -144,29 +144,125 @@ bool BlobsQueue::blockingWrite(const std::vector<Blob*>& inputs) {
 void BlobsQueue::close() {
   closing_ = true;
 
-  std::lock_guard<std::mutex> g(mutex_);
-  cv_.notify_all();
+  notEmpty_.notifyAll();
+  notFull_.notifyAll();
 }
 
-bool BlobsQueue::canWrite() {
-  // writer is always within [reader, reader + size)
-  // we can write if reader is within [reader, reader + size)
-  CAFFE_ENFORCE_LE(reader_, writer_);
-  CAFFE_ENFORCE_LE(writer_, reader_ + queue_.size());
-  return writer_ != reader_ + queue_.size();
+bool BlobsQueue::doRead(const std::vector<Blob*>& inputs) {
+  int64_t pos = reader_.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &queue_[pos % capacity_];
+    const int64_t expected = 2 * (pos / capacity_) + 1;
+    const int64_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence == expected) {
+      if (reader_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (sequence < expected) {
+      // The write of this position hasn't finished yet.
+      return false;
+    } else {
+      // Another reader took this position.
+      pos = reader_.load(std::memory_order_relaxed);
+    }
+  }
+  auto& result = slot->blobs;
+  for (auto i = 0; i < result.size(); ++i) {
+    auto bytes = BlobStat::sizeBytes(*result[i]);
+    CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
+    using std::swap;
+    swap(*(inputs[i]), *(result[i]));
+  }
+  // Frees the slot for the write of the next turn.
+  slot->sequence.store(2 * (pos / capacity_ + 1), std::memory_order_release);
+  notFull_.notifyAll();
+  CAFFE_SDT(
+      queue_read_end,
+      name_.c_str(),
+      (void*)this,
+      writer_.load(std::memory_order_relaxed) - pos - 1);
+  return true;
 }
 
-void BlobsQueue::doWrite(const std::vector<Blob*>& inputs) {
-  auto& result = queue_[writer_ % queue_.size()];
-  CAFFE_ENFORCE(inputs.size() >= result.size());
-  const auto& name = name_.c_str();
+bool BlobsQueue::doWrite(const std::vector<Blob*>& inputs) {
+  int64_t pos = writer_.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &queue_[pos % capacity_];
+    const int64_t expected = 2 * (pos / capacity_);
+    const int64_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence == expected) {
+      if (writer_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (sequence < expected) {
+      // The read of this slot from the previous turn hasn't finished yet.
+      return false;
+    } else {
+      // Another writer took this position.
+      pos = writer_.load(std::memory_order_relaxed);
+    }
+  }
+  auto& result = slot->blobs;
   for (auto i = 0; i < result.size(); ++i) {
     using std::swap;
     swap(*(inputs[i]), *(result[i]));
   }
+  slot->sequence.store(2 * (pos / capacity_) + 1, std::memory_order_release);
+  notEmpty_.notifyAll();
   CAFFE_SDT(
-      queue_write_end, name, (void*)this, reader_ + queue_.size() - writer_);
-  ++writer_;
+      queue_write_end,
+      name_.c_str(),
+      (void*)this,
+      reader_.load(std::memory_order_relaxed) + capacity_ - pos);
+  return true;
+}
+
+uint64_t BlobsQueue::EventCount::prepareWait() {
+  waiters_.fetch_add(1, std::memory_order_seq_cst);
+  // Pairs with the fence in notifyAll().
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  return epoch_.load(std::memory_order_acquire);
+}
+
+void BlobsQueue::EventCount::cancelWait() {
+  waiters_.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+bool BlobsQueue::EventCount::wait(
+    uint64_t key,
+    const std::chrono::steady_clock::time_point* deadline) {
+  bool notified = true;
+  {
+    std::unique_lock<std::mutex> g(mutex_);
+    auto changed = [this, key]() {
+      return epoch_.load(std::memory_order_relaxed) != key;
+    };
+    if (deadline) {
+      notified = cv_.wait_until(g, *deadline, changed);
+    } else {
+      cv_.wait(g, changed);
+    }
+  }
+  waiters_.fetch_sub(1, std::memory_order_seq_cst);
+  return notified;
+}
+
+void BlobsQueue::EventCount::notifyAll() {
+  // Orders the change of the state before the check for waiters, against the
+  // waiters announcing themselves before checking the state again, so that
+  // either the notifier sees the waiter, or the waiter sees the new state.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    epoch_.fetch_add(1, std::memory_order_release);
+  }
   cv_.notify_all();
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -20,6 +21,11 @@ namespace caffe2 {
 // Containing blobs are owned by the workspace.
 // On read, we swap out the underlying data for the blob passed in for blobs
 
+// Readers and writers claim their slot with a compare-and-swap on the reader_
+// or writer_ position, and hand the slot over to each other through its
+// sequence number, so they only contend on the mutex of an EventCount when
+// the queue is empty or full and they have to sleep.
+
 class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
  public:
   BlobsQueue(
@@ -45,17 +51,51 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
   }
 
  private:
-  bool canWrite();
-  void doWrite(const std::vector<Blob*>& inputs);
+  // Lets threads sleep until another thread changes the state they wait on,
+  // without a lock on the paths which don't sleep. A waiter calls
+  // prepareWait(), checks the state again, and then either cancelWait() or
+  // wait() with the key. A notifier changes the state, and then notifyAll().
+  class EventCount {
+   public:
+    uint64_t prepareWait();
+    void cancelWait();
+    // Returns false if the deadline passed before a notification.
+    bool wait(
+        uint64_t key,
+        const std::chrono::steady_clock::time_point* deadline = nullptr);
+    void notifyAll();
+
+   private:
+    std::atomic<uint64_t> epoch_{0};
+    std::atomic<int64_t> waiters_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+  };
+
+  struct Slot {
+    // 2 * turn while the slot is free for the write of the given turn (the
+    // position divided by the capacity), 2 * turn + 1 once written and until
+    // it is read.
+    std::atomic<int64_t> sequence{0};
+    std::vector<Blob*> blobs;
+  };
+
+  bool doRead(const std::vector<Blob*>& inputs);
+  bool doWrite(const std::vector<Blob*>& inputs);
 
   std::atomic<bool> closing_{false};
 
   size_t numBlobs_;
-  std::mutex mutex_; // protects all variables in the class.
-  std::condition_variable cv_;
-  int64_t reader_{0};
-  int64_t writer_{0};
-  std::vector<std::vector<Blob*>> queue_;
+  const int64_t capacity_;
+  std::unique_ptr<Slot[]> queue_;
+  // The padding keeps the readers and the writers from sharing cache lines.
+  char padding0_[64];
+  std::atomic<int64_t> reader_{0};
+  char padding1_[64];
+  std::atomic<int64_t> writer_{0};
+  char padding2_[64];
+  EventCount notEmpty_;
+  EventCount notFull_;
   const std::string name_;
 
   struct QueueStats {
@@ -0,0 +1,168 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "caffe2/core/workspace.h"
+#include "caffe2/queue/blobs_queue.h"
+#include <gtest/gtest.h>
+
+namespace caffe2 {
+
+namespace {
+
+std::shared_ptr<BlobsQueue> createQueue(Workspace* ws, size_t capacity) {
+  return std::make_shared<BlobsQueue>(
+      ws, "queue", capacity, 1 /* numBlobs */, true /* enforceUniqueName */);
+}
+
+bool tryWriteValue(BlobsQueue* queue, int value) {
+  Blob blob;
+  *blob.GetMutable<int>() = value;
+  return queue->tryWrite({&blob});
+}
+
+bool blockingWriteValue(BlobsQueue* queue, int value) {
+  Blob blob;
+  *blob.GetMutable<int>() = value;
+  return queue->blockingWrite({&blob});
+}
+
+// Returns -1 if the read failed.
+int blockingReadValue(BlobsQueue* queue, float timeout_secs = 0.0f) {
+  Blob blob;
+  if (!queue->blockingRead({&blob}, timeout_secs)) {
+    return -1;
+  }
+  return blob.Get<int>();
+}
+
+} // namespace
+
+TEST(BlobsQueueTest, FirstInFirstOut) {
+  Workspace ws;
+  auto queue = createQueue(&ws, 3);
+  // Several turns around the circular buffer.
+  for (int turn = 0; turn < 4; ++turn) {
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(tryWriteValue(queue.get(), 3 * turn + i));
+    }
+    EXPECT_FALSE(tryWriteValue(queue.get(), -1));
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(blockingReadValue(queue.get()), 3 * turn + i);
+    }
+  }
+}
+
+TEST(BlobsQueueTest, CapacityOne) {
+  Workspace ws;
+  auto queue = createQueue(&ws, 1);
+  EXPECT_TRUE(tryWriteValue(queue.get(), 0));
+  EXPECT_FALSE(tryWriteValue(queue.get(), 1));
+  EXPECT_EQ(blockingReadValue(queue.get()), 0);
+
+  constexpr int kNumValues = 10000;
+  std::thread writer([&queue]() {
+    for (int i = 0; i < kNumValues; ++i) {
+      EXPECT_TRUE(blockingWriteValue(queue.get(), i));
+    }
+  });
+  for (int i = 0; i < kNumValues; ++i) {
+    EXPECT_EQ(blockingReadValue(queue.get()), i);
+  }
+  writer.join();
+}
+
+TEST(BlobsQueueTest, ConcurrentReadersAndWriters) {
+  constexpr int kNumThreads = 4;
+  constexpr int kValuesPerWriter = 5000;
+  Workspace ws;
+  auto queue = createQueue(&ws, 8);
+
+  std::vector<std::atomic<int>> seen(kNumThreads * kValuesPerWriter);
+  for (auto& count : seen) {
+    count = 0;
+  }
+  std::atomic<int> numRead{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&queue, t]() {
+      for (int i = 0; i < kValuesPerWriter; ++i) {
+        EXPECT_TRUE(blockingWriteValue(queue.get(), t * kValuesPerWriter + i));
+      }
+    });
+    threads.emplace_back([&queue, &seen, &numRead]() {
+      for (;;) {
+        const int value = blockingReadValue(queue.get());
+        if (value < 0) {
+          // closed once every value was read
+          return;
+        }
+        ++seen[value];
+        if (++numRead == kNumThreads * kValuesPerWriter) {
+          queue->close();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(numRead, kNumThreads * kValuesPerWriter);
+  for (const auto& count : seen) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+TEST(BlobsQueueTest, CloseWakesBlockedReader) {
+  Workspace ws;
+  auto queue = createQueue(&ws, 2);
+  std::atomic<bool> done{false};
+  std::thread reader([&queue, &done]() {
+    EXPECT_EQ(blockingReadValue(queue.get()), -1);
+    done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(done);
+  queue->close();
+  reader.join();
+  EXPECT_TRUE(done);
+}
+
+TEST(BlobsQueueTest, CloseWakesBlockedWriter) {
+  Workspace ws;
+  auto queue = createQueue(&ws, 1);
+  EXPECT_TRUE(tryWriteValue(queue.get(), 0));
+  std::atomic<bool> done{false};
+  std::thread writer([&queue, &done]() {
+    EXPECT_FALSE(blockingWriteValue(queue.get(), 1));
+    done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(done);
+  queue->close();
+  writer.join();
+  EXPECT_TRUE(done);
+}
+
+TEST(BlobsQueueTest, ReadTimeout) {
+  Workspace ws;
+  auto queue = createQueue(&ws, 2);
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(blockingReadValue(queue.get(), 0.1f), -1);
+  EXPECT_GE(
+      std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+
+  // A write during the wait ends it before the deadline.
+  std::thread writer([&queue]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(blockingWriteValue(queue.get(), 7));
+  });
+  EXPECT_EQ(blockingReadValue(queue.get(), 10.0f), 7);
+  writer.join();
+}
+
+} // namespace caffe2
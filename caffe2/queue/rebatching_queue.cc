@@ -1,101 +1,88 @@
 #include "rebatching_queue.h"
-#include "caffe2/utils/smart_tensor_printer.h"
+
+#include <algorithm>
 
 namespace caffe2 {
 
 namespace {
 
+// The sizes of the element of the tensor at the row, or of the tensor itself.
+std::vector<int64_t> elementDims(const TensorCPU& tensor, int64_t row) {
+  auto dims = tensor.sizes().vec();
+  if (row >= 0) {
+    dims.erase(dims.begin());
+  }
+  return dims;
+}
+
+} // anonymous namespace
+
 // This concat function will always create a new first dimension to concat
-void concat(
+void RebatchingQueue::concat(
     CPUContext& context,
-    const std::vector<std::vector<TensorCPU>>& inputs,
+    const std::vector<Element>& inputs,
     const std::vector<TensorCPU*>& outputs) {
   CAFFE_ENFORCE(!inputs.empty());
 
   const auto& inputZero = inputs[0];
-  const auto numTensors = inputZero.size();
+  const auto numTensors = inputZero.tensors->size();
   const auto numRows = inputs.size();
 
   // Precompute the output sizes to avoid resizing
-  std::vector<std::vector<int64_t>> outputDims(numTensors);
-
-  for (size_t i = 0; i < numTensors; ++i) {
-    SmartTensorPrinter::PrintTensor(inputZero.at(i));
-    outputDims[i] = inputZero.at(i).sizes().vec();
-    outputDims[i].insert(outputDims[i].begin(), numRows);
-  }
-
-  // Resize to the final output size
+  std::vector<std::vector<int64_t>> elementSizes(numTensors);
   std::vector<void*> destinations(numTensors);
   for (size_t i = 0; i < numTensors; ++i) {
-    outputs[i]->Resize(outputDims[i]);
-    destinations[i] = outputs[i]->raw_mutable_data(inputZero[i].meta());
+    const auto& tensor = inputZero.tensors->at(i);
+    elementSizes[i] = elementDims(tensor, inputZero.row);
+    auto outputDims = elementSizes[i];
+    outputDims.insert(outputDims.begin(), numRows);
+    // Resize to the final output size
+    outputs[i]->Resize(outputDims);
+    destinations[i] = outputs[i]->raw_mutable_data(tensor.dtype());
   }
 
-  for (size_t i = 0; i < numRows; ++i) {
-    CAFFE_ENFORCE_EQ(inputs[i].size(), numTensors);
+  for (size_t i = 0; i < numRows;) {
+    const auto& tensors = *inputs[i].tensors;
+    CAFFE_ENFORCE_EQ(tensors.size(), numTensors);
+
+    // The rows which follow each other in the same batch are copied at once.
+    size_t runLength = 1;
+    while (inputs[i].row >= 0 && i + runLength < numRows &&
+           inputs[i + runLength].tensors == inputs[i].tensors &&
+           inputs[i + runLength].row == inputs[i].row + runLength) {
+      ++runLength;
+    }
 
     for (int j = 0; j < numTensors; ++j) {
-      const auto& input = inputs[i][j];
+      const auto& input = tensors[j];
 
-      CAFFE_ENFORCE(inputZero[j].meta() == input.dtype());
-      CAFFE_ENFORCE_EQ(inputZero[j].itemsize(), input.itemsize());
-      CAFFE_ENFORCE_EQ(inputZero[j].ndim(), input.dim());
-      for (int k = 0; k < input.dim(); ++k) {
-        CAFFE_ENFORCE_EQ(input.sizes()[k], inputZero[j].size(k));
-      }
+      CAFFE_ENFORCE(inputZero.tensors->at(j).dtype() == input.dtype());
+      CAFFE_ENFORCE(elementDims(input, inputs[i].row) == elementSizes[j]);
 
+      const auto elementSize =
+          inputs[i].row >= 0 ? input.size_from_dim(1) : input.numel();
       // Skip empty tensors
-      if (input.numel() == 0) {
+      if (elementSize == 0) {
         continue;
       }
 
+      const auto itemSize = input.itemsize();
+      const auto rowOffset = std::max<int64_t>(inputs[i].row, 0);
       context.CopyItemsToCPU(
           input.dtype(),
-          input.numel(),
-          input.raw_data() /* src */,
+          elementSize * runLength,
+          (const char*)input.raw_data() +
+              rowOffset * elementSize * itemSize /* src */,
           destinations[j] /* dst */
       );
 
       destinations[j] =
-          (char*)destinations[j] + input.numel() * input.itemsize();
+          (char*)destinations[j] + elementSize * runLength * itemSize;
     }
-  }
-}
 
-std::vector<std::vector<TensorCPU>> split(
-    CPUContext& context,
-    const std::vector<const TensorCPU*>& inputs) {
-  CAFFE_ENFORCE(!inputs.empty());
-
-  const auto outputSize = inputs[0]->sizes().at(0);
-  std::vector<std::vector<TensorCPU>> outputs(outputSize);
-
-  for (const auto* inputPtr : inputs) {
-    CAFFE_ENFORCE(inputPtr);
-
-    const auto& input = *inputPtr;
-    const auto innerSize = input.size_from_dim(1);
-    const auto itemSize = input.dtype().itemsize();
-
-    auto outputDims = input.sizes().vec();
-    CAFFE_ENFORCE(!outputDims.empty());
-    outputDims.erase(outputDims.begin());
-    CAFFE_ENFORCE_EQ(input.sizes().at(0), outputSize);
-
-    for (int i = 0; i < outputSize; ++i) {
-      outputs[i].push_back(Tensor(outputDims, CPU));
-      context.CopyItemsToCPU(
-          input.dtype(),
-          innerSize,
-          (char*)input.raw_data() + i * innerSize * itemSize /* src */,
-          outputs[i].back().raw_mutable_data(input.dtype()) /* dst */);
-    }
+    i += runLength;
   }
-
-  return outputs;
 }
-} // anonymous namespace
 
 RebatchingQueue::RebatchingQueue(size_t capacity, size_t numBlobs)
     : capacity_(capacity), numBlobs_(numBlobs), queue_(capacity) {}
@@ -112,7 +99,7 @@ bool RebatchingQueue::dequeue(
     CPUContext& context,
     size_t numElements,
     const std::vector<TensorCPU*>& outputs) {
-  std::vector<std::vector<TensorCPU>> results;
+  std::vector<Element> results;
   results.reserve(numElements);
 
   for (;;) {
@@ -158,32 +145,48 @@ bool RebatchingQueue::canWrite() const {
 bool RebatchingQueue::enqueueOne(
     CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs.emplace_back();
-  auto& tensorVector = splittedInputs.back();
-  tensorVector.reserve(inputs.size());
+  auto tensors = std::make_shared<std::vector<TensorCPU>>();
+  tensors->reserve(inputs.size());
   for (const auto* tensorPtr : inputs) {
-    tensorVector.push_back(tensorPtr->Clone());
+    tensors->push_back(tensorPtr->Clone());
   }
 
-  return enqueue(std::move(splittedInputs));
+  std::vector<Element> elements;
+  elements.push_back(Element{std::move(tensors), -1});
+  return enqueue(std::move(elements));
 }
 
 bool RebatchingQueue::enqueueMany(
-    CPUContext& context,
+    CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
   CAFFE_ENFORCE_EQ(numBlobs_, inputs.size());
+  CAFFE_ENFORCE(!inputs.empty());
 
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs = split(context, inputs);
-  return enqueue(std::move(splittedInputs));
+  // The batch is copied once, and its rows are enqueued as the elements.
+  auto tensors = std::make_shared<std::vector<TensorCPU>>();
+  tensors->reserve(inputs.size());
+  CAFFE_ENFORCE(inputs[0]);
+  CAFFE_ENFORCE_GE(inputs[0]->dim(), 1);
+  const auto numRows = inputs[0]->size(0);
+  for (const auto* tensorPtr : inputs) {
+    CAFFE_ENFORCE(tensorPtr);
+    CAFFE_ENFORCE_GE(tensorPtr->dim(), 1);
+    CAFFE_ENFORCE_EQ(tensorPtr->size(0), numRows);
+    tensors->push_back(tensorPtr->Clone());
+  }
+
+  std::vector<Element> elements;
+  elements.reserve(numRows);
+  for (int64_t i = 0; i < numRows; ++i) {
+    elements.push_back(Element{tensors, i});
+  }
+  return enqueue(std::move(elements));
 }
 
-bool RebatchingQueue::enqueue(
-    std::vector<std::vector<TensorCPU>> splittedInputs) {
+bool RebatchingQueue::enqueue(std::vector<Element> elements) {
   int idx = 0;
   for (;;) {
-    if (idx >= splittedInputs.size()) {
+    if (idx >= elements.size()) {
       break;
     }
 
@@ -199,8 +202,8 @@ bool RebatchingQueue::enqueue(
       }
 
       do {
-        queue_[head_++ % capacity()] = std::move(splittedInputs[idx++]);
-      } while (canWrite() && idx < splittedInputs.size());
+        queue_[head_++ % capacity()] = std::move(elements[idx++]);
+      } while (canWrite() && idx < elements.size());
     }
 
     cvEmpty_.notify_all();
@@ -17,6 +17,12 @@ namespace caffe2 {
 // atomic index + circular queue optimizations or pull something more
 // heavy-weight later
 
+// The elements of a batch enqueued with enqueueMany are not split into tensors
+// of their own: the queue holds a single copy of the batch, which every
+// element refers to by its row, and dequeue copies each run of consecutive
+// rows of a batch into the outputs at once. A batch is freed when its last
+// element is dequeued.
+
 class RebatchingQueue {
  public:
   RebatchingQueue(size_t capacity, size_t numBlobs);
@@ -45,7 +51,18 @@ class RebatchingQueue {
   void close();
 
  private:
-  bool enqueue(std::vector<std::vector<TensorCPU>> splittedInputs);
+  struct Element {
+    std::shared_ptr<const std::vector<TensorCPU>> tensors;
+    // The row of the tensors, or -1 if the tensors are the element itself.
+    int64_t row;
+  };
+
+  static void concat(
+      CPUContext& context,
+      const std::vector<Element>& inputs,
+      const std::vector<TensorCPU*>& outputs);
+
+  bool enqueue(std::vector<Element> elements);
 
   bool canWrite() const;
   bool canRead() const;
@@ -63,6 +80,6 @@ class RebatchingQueue {
   std::condition_variable cvEmpty_;
   std::condition_variable cvOverflow_;
 
-  std::vector<std::vector<TensorCPU>> queue_;
+  std::vector<Element> queue_;
 };
 } // caffe2
@@ -0,0 +1,152 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "caffe2/queue/rebatching_queue.h"
+#include <gtest/gtest.h>
+
+namespace caffe2 {
+
+namespace {
+
+// A {rows, 2} float tensor whose row i is {first + i, -(first + i)}.
+TensorCPU createBatch(int64_t rows, float first) {
+  TensorCPU tensor(std::vector<int64_t>{rows, 2}, CPU);
+  auto* data = tensor.mutable_data<float>();
+  for (int64_t i = 0; i < rows; ++i) {
+    data[2 * i] = first + i;
+    data[2 * i + 1] = -(first + i);
+  }
+  return tensor;
+}
+
+void expectRows(const TensorCPU& tensor, const std::vector<float>& firsts) {
+  ASSERT_EQ(tensor.dim(), 2);
+  ASSERT_EQ(tensor.size(0), static_cast<int64_t>(firsts.size()));
+  ASSERT_EQ(tensor.size(1), 2);
+  const auto* data = tensor.data<float>();
+  for (size_t i = 0; i < firsts.size(); ++i) {
+    EXPECT_EQ(data[2 * i], firsts[i]);
+    EXPECT_EQ(data[2 * i + 1], -firsts[i]);
+  }
+}
+
+} // namespace
+
+TEST(RebatchingQueueTest, RowsOfABatch) {
+  CPUContext context;
+  RebatchingQueue queue(8, 1);
+
+  auto batch = createBatch(5, 0);
+  EXPECT_TRUE(queue.enqueueMany(context, {&batch}));
+  // The queue keeps its own copy of the batch.
+  batch.mutable_data<float>()[0] = 100;
+
+  TensorCPU output(CPU);
+  EXPECT_TRUE(queue.dequeue(context, 3, {&output}));
+  expectRows(output, {0, 1, 2});
+  EXPECT_TRUE(queue.dequeue(context, 2, {&output}));
+  expectRows(output, {3, 4});
+}
+
+TEST(RebatchingQueueTest, MixedBatchesAndElements) {
+  CPUContext context;
+  RebatchingQueue queue(8, 1);
+
+  auto first = createBatch(2, 0);
+  auto second = createBatch(3, 10);
+  TensorCPU element(std::vector<int64_t>{2}, CPU);
+  element.mutable_data<float>()[0] = 20;
+  element.mutable_data<float>()[1] = -20;
+
+  EXPECT_TRUE(queue.enqueueMany(context, {&first}));
+  EXPECT_TRUE(queue.enqueueOne(context, {&element}));
+  EXPECT_TRUE(queue.enqueueMany(context, {&second}));
+
+  TensorCPU output(CPU);
+  // Crosses from the first batch to the element and into the second batch.
+  EXPECT_TRUE(queue.dequeue(context, 4, {&output}));
+  expectRows(output, {0, 1, 20, 10});
+  EXPECT_TRUE(queue.dequeue(context, 2, {&output}));
+  expectRows(output, {11, 12});
+}
+
+TEST(RebatchingQueueTest, CapacityOne) {
+  CPUContext context;
+  RebatchingQueue queue(1, 1);
+
+  constexpr int kNumBatches = 100;
+  constexpr int kRows = 4;
+  std::thread producer([&queue]() {
+    CPUContext producerContext;
+    for (int i = 0; i < kNumBatches; ++i) {
+      auto batch = createBatch(kRows, i * kRows);
+      EXPECT_TRUE(queue.enqueueMany(producerContext, {&batch}));
+    }
+  });
+
+  TensorCPU output(CPU);
+  for (int i = 0; i < kNumBatches * kRows; ++i) {
+    EXPECT_TRUE(queue.dequeue(context, 1, {&output}));
+    expectRows(output, {static_cast<float>(i)});
+  }
+  producer.join();
+}
+
+TEST(RebatchingQueueTest, CloseReturnsRemainingRows) {
+  CPUContext context;
+  RebatchingQueue queue(8, 1);
+
+  auto batch = createBatch(3, 0);
+  EXPECT_TRUE(queue.enqueueMany(context, {&batch}));
+  queue.close();
+  EXPECT_TRUE(queue.isClosed());
+  EXPECT_FALSE(queue.enqueueMany(context, {&batch}));
+
+  TensorCPU output(CPU);
+  EXPECT_TRUE(queue.dequeue(context, 5, {&output}));
+  expectRows(output, {0, 1, 2});
+  EXPECT_FALSE(queue.dequeue(context, 1, {&output}));
+}
+
+TEST(RebatchingQueueTest, CloseWakesBlockedDequeue) {
+  RebatchingQueue queue(2, 1);
+  std::atomic<bool> done{false};
+  std::thread consumer([&queue, &done]() {
+    CPUContext consumerContext;
+    TensorCPU output(CPU);
+    EXPECT_FALSE(queue.dequeue(consumerContext, 1, {&output}));
+    done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(done);
+  queue.close();
+  consumer.join();
+  EXPECT_TRUE(done);
+}
+
+TEST(RebatchingQueueTest, CloseWakesBlockedEnqueue) {
+  CPUContext context;
+  RebatchingQueue queue(2, 1);
+  std::atomic<bool> done{false};
+  std::thread producer([&queue, &done]() {
+    CPUContext producerContext;
+    // Only two of the rows fit.
+    auto batch = createBatch(3, 0);
+    EXPECT_FALSE(queue.enqueueMany(producerContext, {&batch}));
+    done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(done);
+  queue.close();
+  producer.join();
+  EXPECT_TRUE(done);
+
+  // The rows enqueued before the close can still be read.
+  TensorCPU output(CPU);
+  EXPECT_TRUE(queue.dequeue(context, 2, {&output}));
+  expectRows(output, {0, 1});
+}
+
+} // namespace caffe2
@@ -1,12 +1,70 @@
 #include "miniz.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include "caffe2/serialize/crc_alt.h"
 
+namespace {
+
+// Buffers at least this large are checksummed on several threads, in chunks
+// of at least kMinChunkSize bytes whose CRCs are then combined.
+constexpr size_t kParallelThreshold = 16 << 20;
+constexpr size_t kMinChunkSize = 4 << 20;
+
+// Number of threads currently checksumming chunks, shared by all the callers
+// so that concurrent readers (see PyTorchStreamReader::getRecords) don't
+// oversubscribe the machine.
+std::atomic<size_t> num_crc_threads{0};
+
+uint32_t crc32_parallel(const uint8_t* data, size_t length, uint32_t crc) {
+  size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  size_t num_chunks = std::min(max_threads, length / kMinChunkSize);
+  size_t wanted = num_chunks - 1;
+  size_t busy = num_crc_threads.fetch_add(wanted);
+  size_t extra = busy >= max_threads ? 0 : std::min(wanted, max_threads - busy);
+  num_crc_threads -= wanted - extra;
+  if (extra == 0) {
+    return crc32_fast(data, length, crc);
+  }
+  num_chunks = extra + 1;
+
+  size_t chunk_size = length / num_chunks;
+  std::vector<uint32_t> crcs(num_chunks);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_chunks; ++i) {
+    size_t begin = i * chunk_size;
+    size_t end = i + 1 == num_chunks ? length : begin + chunk_size;
+    threads.emplace_back(
+        [&crcs, data, begin, end, i]() {
+          crcs[i] = crc32_fast(data + begin, end - begin);
+        });
+  }
+  crcs[0] = crc32_fast(data, chunk_size, crc);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  num_crc_threads -= extra;
+
+  uint32_t result = crcs[0];
+  for (size_t i = 1; i < num_chunks; ++i) {
+    size_t end = i + 1 == num_chunks ? length : (i + 1) * chunk_size;
+    result = crc32_combine(result, crcs[i], end - i * chunk_size);
+  }
+  return result;
+}
+
+} // namespace
+
 extern "C" {
 // See: miniz.h
-#if defined(USE_EXTERNAL_MZCRC) 
+#if defined(USE_EXTERNAL_MZCRC)
 mz_ulong mz_crc32(mz_ulong crc, const mz_uint8* ptr, size_t buf_len) {
+  if (buf_len >= kParallelThreshold) {
+    return crc32_parallel(ptr, buf_len, crc);
+  }
   auto z = crc32_fast(ptr, buf_len, crc);
   return z;
 };
@@ -2,9 +2,19 @@
 #include <c10/util/Exception.h>
 #include "caffe2/core/common.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
 namespace caffe2 {
 namespace serialize {
 
+#ifdef _WIN32
+
 FileAdapter::FileAdapter(const std::string& file_name) {
   file_stream_.open(file_name, std::ifstream::in | std::ifstream::binary);
   if (!file_stream_) {
@@ -22,7 +32,59 @@ size_t FileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
   return istream_adapter_->read(pos, buf, n, what);
 }
 
+bool FileAdapter::supportsConcurrentReads() const {
+  return false;
+}
+
 FileAdapter::~FileAdapter() {}
 
+#else
+
+FileAdapter::FileAdapter(const std::string& file_name) {
+  fd_ = open(file_name.c_str(), O_RDONLY);
+  if (fd_ == -1) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  struct stat st;
+  if (fstat(fd_, &st) == -1) {
+    close(fd_);
+    AT_ERROR("stat failed, file path: ", file_name, ": ", strerror(errno));
+  }
+  size_ = st.st_size;
+}
+
+size_t FileAdapter::size() const {
+  return size_;
+}
+
+size_t FileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  size_t done = 0;
+  while (done < n) {
+    auto ret = pread(fd_, static_cast<char*>(buf) + done, n - done, pos + done);
+    if (ret == -1 && errno == EINTR) {
+      continue;
+    }
+    if (ret == -1) {
+      AT_ERROR("file reader failed: ", what, ": ", strerror(errno));
+    }
+    if (ret == 0) {
+      break;
+    }
+    done += ret;
+  }
+  return done;
+}
+
+bool FileAdapter::supportsConcurrentReads() const {
+  return true;
+}
+
+FileAdapter::~FileAdapter() {
+  close(fd_);
+}
+
+#endif
+
 } // namespace serialize
 } // namespace caffe2
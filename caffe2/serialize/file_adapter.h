@@ -10,6 +10,9 @@
 namespace caffe2 {
 namespace serialize {
 
+// this is a reader implemented with positional reads (pread) of the file, so
+// that it can be read from several threads at once. It goes through an
+// std::ifstream on Windows.
 class CAFFE2_API FileAdapter final : public ReadAdapterInterface {
  public:
   C10_DISABLE_COPY_AND_ASSIGN(FileAdapter);
@@ -17,11 +20,17 @@ class CAFFE2_API FileAdapter final : public ReadAdapterInterface {
   size_t size() const override;
   size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const override;
+  bool supportsConcurrentReads() const override;
   ~FileAdapter();
 
  private:
+#ifdef _WIN32
   std::ifstream file_stream_;
   std::unique_ptr<IStreamAdapter> istream_adapter_;
+#else
+  int fd_ = -1;
+  size_t size_ = 0;
+#endif
 };
 
 } // namespace serialize
@@ -5,6 +5,11 @@
 #include <ostream>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #include <c10/core/Allocator.h>
 #include <c10/core/CPUAllocator.h>
@@ -48,6 +53,190 @@ static std::string basename(const std::string& name) {
   return name.substr(start, end - start);
 }
 
+// Runs task(i) for i in [0, num_tasks) on up to num_threads threads, including
+// the calling one, and rethrows the first exception of the tasks.
+static void parallelFor(
+    size_t num_tasks,
+    size_t num_threads,
+    const std::function<void(size_t)>& task) {
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto run_tasks = [&]() {
+    for (size_t i = next++; i < num_tasks; i = next++) {
+      try {
+        task(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < std::min(num_threads, num_tasks); ++t) {
+    threads.emplace_back(run_tasks);
+  }
+  run_tasks();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+static size_t hardwareThreads() {
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// Zip extra field of the records compressed in chunks:
+//   'P' 'C' payload_size:u16 format:u8 chunk_size:u32
+//   compressed_chunk_size:u32 for every chunk
+// all little endian. The chunks hold chunk_size uncompressed bytes, but for
+// the last one.
+constexpr char kChunkedExtraFieldId[] = {'P', 'C'};
+constexpr uint8_t kChunkedDeflateFormat = 1;
+constexpr size_t kChunkedExtraHeaderSize = 4 + 1 + 4;
+// Leaves room in the 64KB of extra fields of the local header for the zip64
+// one
+constexpr size_t kMaxCompressionChunks = 15000;
+
+static void appendLE(std::string& buf, uint64_t value, size_t num_bytes) {
+  for (size_t i = 0; i < num_bytes; ++i) {
+    buf.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+static uint64_t readLE(const uint8_t* buf, size_t num_bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < num_bytes; ++i) {
+    value |= static_cast<uint64_t>(buf[i]) << (8 * i);
+  }
+  return value;
+}
+
+// CRC-32 of the concatenation of two buffers, from their CRC-32s and the
+// length of the second one, as zlib's crc32_combine computes it
+static mz_uint32 gf2MatrixTimes(const mz_uint32* mat, mz_uint32 vec) {
+  mz_uint32 sum = 0;
+  for (; vec; vec >>= 1, ++mat) {
+    if (vec & 1) {
+      sum ^= *mat;
+    }
+  }
+  return sum;
+}
+
+static void gf2MatrixSquare(mz_uint32* square, const mz_uint32* mat) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = gf2MatrixTimes(mat, mat[n]);
+  }
+}
+
+static mz_uint32 crc32Combine(mz_uint32 crc1, mz_uint32 crc2, size_t len2) {
+  if (len2 == 0) {
+    return crc1;
+  }
+  mz_uint32 even[32];
+  mz_uint32 odd[32];
+  // The operator for one zero bit in odd
+  odd[0] = 0xedb88320u;
+  mz_uint32 row = 1;
+  for (int n = 1; n < 32; ++n) {
+    odd[n] = row;
+    row <<= 1;
+  }
+  // Two zero bits in even, then four in odd
+  gf2MatrixSquare(even, odd);
+  gf2MatrixSquare(odd, even);
+  // Applies len2 zero bytes to crc1
+  while (true) {
+    gf2MatrixSquare(even, odd);
+    if (len2 & 1) {
+      crc1 = gf2MatrixTimes(even, crc1);
+    }
+    len2 >>= 1;
+    if (len2 == 0) {
+      break;
+    }
+    gf2MatrixSquare(odd, even);
+    if (len2 & 1) {
+      crc1 = gf2MatrixTimes(odd, crc1);
+    }
+    len2 >>= 1;
+    if (len2 == 0) {
+      break;
+    }
+  }
+  return crc1 ^ crc2;
+}
+
+// Deflates a chunk on its own, so that it doesn't refer to the data of the
+// previous ones. The chunks but the last end with a sync flush, which ends on
+// a byte boundary without ending the deflate stream, so that the deflated
+// chunks put one after the other are a single deflate stream.
+static std::string deflateChunk(const void* data, size_t size, bool last) {
+  std::unique_ptr<tdefl_compressor, decltype(&free)> comp(
+      static_cast<tdefl_compressor*>(malloc(sizeof(tdefl_compressor))), &free);
+  if (!comp) {
+    throw std::bad_alloc();
+  }
+  // Raw deflate, as in zip files
+  tdefl_init(
+      comp.get(),
+      nullptr,
+      nullptr,
+      tdefl_create_comp_flags_from_zip_params(
+          MZ_DEFAULT_LEVEL, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+  // With room for the sync flush
+  std::string out(mz_compressBound(size) + 16, '\0');
+  size_t in_size = size;
+  size_t out_size = out.size();
+  tdefl_status status = tdefl_compress(
+      comp.get(),
+      data,
+      &in_size,
+      &out[0],
+      &out_size,
+      last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH);
+  if (status != (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY) ||
+      in_size != size) {
+    CAFFE_THROW("PytorchStreamWriter failed compressing a chunk");
+  }
+  out.resize(out_size);
+  return out;
+}
+
+// Inflates a chunk, which has no references to the previous ones, into a
+// buffer of its exact uncompressed size
+static void inflateChunk(
+    const uint8_t* data,
+    size_t size,
+    uint8_t* out,
+    size_t out_size,
+    bool last) {
+  tinfl_decompressor decomp;
+  tinfl_init(&decomp);
+  size_t in_size = size;
+  size_t written = out_size;
+  tinfl_status status = tinfl_decompress(
+      &decomp,
+      data,
+      &in_size,
+      out,
+      out,
+      &written,
+      TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF |
+          (last ? 0 : TINFL_FLAG_HAS_MORE_INPUT));
+  // The stream only ends with the last chunk; the CRC-32 of the record
+  // catches any other corruption
+  if (status < TINFL_STATUS_DONE || written != out_size) {
+    CAFFE_THROW("PytorchStreamReader failed inflating a chunk");
+  }
+}
+
 size_t PyTorchStreamReader::read(uint64_t pos, char* buf, size_t n) {
   return in_->read(pos, buf, n, "reading file");
 }
@@ -118,6 +307,8 @@ void PyTorchStreamReader::init() {
   std::tie(version_ptr, version_size) = getRecord("version");
   std::string version(static_cast<const char*>(version_ptr.get()), version_size);
   version_ = caffe2::stoull(version);
+  // Records can be returned in place when the input is mapped in memory
+  mappable_ = static_cast<bool>(in_->map(0, 0));
   AT_ASSERTM(
       version_ >= kMinSupportedFileFormatVersion,
       "Attempted to read a PyTorch file with version ",
@@ -150,6 +341,10 @@ constexpr int MZ_ZIP_LOCAL_DIR_HEADER_SIZE = 30;
 constexpr int MZ_ZIP_LDH_FILENAME_LEN_OFS = 26;
 constexpr int MZ_ZIP_LDH_EXTRA_LEN_OFS = 28;
 
+static int64_t read_le_16(uint8_t* buf) {
+  return buf[0] + (buf[1] << 8);
+}
+
 static size_t getPadding(
     size_t cursor,
     size_t filename_size,
@@ -219,6 +414,21 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data for ", name.c_str());
+  at::DataPtr chunked;
+  if (stat.m_method == MZ_DEFLATED && getChunkedRecord(name, key, &chunked)) {
+    return std::make_tuple(std::move(chunked), stat.m_uncomp_size);
+  }
+  // Uncompressed records aligned for tensor data, as the writer stores them,
+  // don't need to be copied
+  if (mappable_ && stat.m_method == 0) {
+    size_t offset = getRecordOffset(name);
+    if (offset % kFieldAlignment == 0) {
+      at::DataPtr mapped = in_->map(offset, stat.m_uncomp_size);
+      if (mapped) {
+        return std::make_tuple(std::move(mapped), stat.m_uncomp_size);
+      }
+    }
+  }
   at::DataPtr retval = c10::GetCPUAllocator()->allocate(stat.m_uncomp_size);
   mz_zip_reader_extract_to_mem(ar_.get(), key, retval.get(), stat.m_uncomp_size, 0);
   valid("reading file ", name.c_str());
@@ -226,8 +436,138 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   return std::make_tuple(std::move(retval), stat.m_uncomp_size);
 }
 
-static int64_t read_le_16(uint8_t* buf) {
-  return buf[0] + (buf[1] << 8);
+bool PyTorchStreamReader::getChunkedRecord(
+    const std::string& name,
+    size_t key,
+    at::DataPtr* data) {
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), key, &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+
+  // Looks for the chunk sizes in the extra fields of the local header
+  uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
+  in_->read(
+      stat.m_local_header_ofs,
+      local_header,
+      MZ_ZIP_LOCAL_DIR_HEADER_SIZE,
+      "reading file header");
+  size_t filename_len = read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS);
+  size_t extra_len = read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+  std::vector<uint8_t> extra(extra_len);
+  in_->read(
+      stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len,
+      extra.data(),
+      extra_len,
+      "reading file header");
+  const uint8_t* field = nullptr;
+  size_t field_size = 0;
+  for (size_t pos = 0; pos + 4 <= extra_len;) {
+    size_t size = readLE(&extra[pos + 2], 2);
+    if (extra[pos] == kChunkedExtraFieldId[0] &&
+        extra[pos + 1] == kChunkedExtraFieldId[1] &&
+        pos + 4 + size <= extra_len) {
+      field = &extra[pos + 4];
+      field_size = size;
+      break;
+    }
+    pos += 4 + size;
+  }
+  if (!field || field_size < 5 || field[0] != kChunkedDeflateFormat) {
+    return false;
+  }
+  const size_t chunk_size = readLE(field + 1, 4);
+  const size_t num_chunks = (field_size - 5) / 4;
+  const size_t size = stat.m_uncomp_size;
+  std::vector<size_t> offsets(num_chunks + 1, 0);
+  for (size_t i = 0; i < num_chunks; ++i) {
+    offsets[i + 1] = offsets[i] + readLE(field + 5 + 4 * i, 4);
+  }
+  if (chunk_size == 0 || num_chunks != (size + chunk_size - 1) / chunk_size ||
+      offsets.back() != stat.m_comp_size) {
+    CAFFE_THROW("PytorchStreamReader found invalid chunks in file ", name);
+  }
+
+  std::vector<uint8_t> compressed(stat.m_comp_size);
+  size_t offset = stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE +
+      filename_len + extra_len;
+  if (in_->read(offset, compressed.data(), compressed.size(), "reading file") !=
+      compressed.size()) {
+    CAFFE_THROW("PytorchStreamReader failed reading file ", name);
+  }
+  at::DataPtr retval = c10::GetCPUAllocator()->allocate(size);
+  uint8_t* out = static_cast<uint8_t*>(retval.get());
+  std::vector<mz_uint32> crcs(num_chunks);
+  parallelFor(num_chunks, hardwareThreads(), [&](size_t i) {
+    const size_t begin = i * chunk_size;
+    const size_t n = std::min(chunk_size, size - begin);
+    inflateChunk(
+        compressed.data() + offsets[i],
+        offsets[i + 1] - offsets[i],
+        out + begin,
+        n,
+        i + 1 == num_chunks);
+    crcs[i] = mz_crc32(MZ_CRC32_INIT, out + begin, n);
+  });
+  mz_uint32 crc = crcs[0];
+  for (size_t i = 1; i < num_chunks; ++i) {
+    crc = crc32Combine(
+        crc, crcs[i], std::min(chunk_size, size - i * chunk_size));
+  }
+  if (crc != stat.m_crc32) {
+    CAFFE_THROW("PytorchStreamReader failed reading file ", name);
+  }
+  *data = std::move(retval);
+  return true;
+}
+
+std::vector<std::tuple<at::DataPtr, size_t>> PyTorchStreamReader::getRecords(
+    const std::vector<std::string>& names,
+    size_t num_threads) {
+  std::vector<std::tuple<at::DataPtr, size_t>> records(names.size());
+  struct PendingRead {
+    size_t index;
+    size_t offset;
+    size_t size;
+    mz_uint32 crc32;
+  };
+  std::vector<PendingRead> pending;
+  bool parallel = !mappable_ && num_threads > 1 && in_->supportsConcurrentReads();
+  // miniz is not thread safe, the records are located on this thread
+  for (size_t i = 0; i < names.size(); ++i) {
+    const auto& name = names[i];
+    mz_zip_archive_file_stat stat;
+    if (parallel) {
+      mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
+      valid("retrieving file meta-data for ", name.c_str());
+    }
+    if (!parallel || stat.m_method != 0) {
+      records[i] = getRecord(name);
+      continue;
+    }
+    records[i] = std::make_tuple(
+        c10::GetCPUAllocator()->allocate(stat.m_uncomp_size),
+        stat.m_uncomp_size);
+    pending.push_back(
+        {i, getRecordOffset(name), stat.m_uncomp_size, stat.m_crc32});
+  }
+
+  parallelFor(pending.size(), num_threads, [&](size_t i) {
+    const auto& r = pending[i];
+    void* buf = std::get<0>(records[r.index]).get();
+    if (in_->read(r.offset, buf, r.size, "reading file") != r.size ||
+        mz_crc32(MZ_CRC32_INIT, static_cast<const mz_uint8*>(buf), r.size) !=
+            r.crc32) {
+      CAFFE_THROW("PytorchStreamReader failed reading file ", names[r.index]);
+    }
+  });
+  return records;
+}
+
+size_t PyTorchStreamReader::getRecordSize(const std::string& name) {
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+  return stat.m_uncomp_size;
 }
 
 size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
@@ -293,7 +633,9 @@ void PyTorchStreamWriter::setup(const string& file_name) {
     file_stream_.open(
         file_name,
         std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
-    valid("opening archive ", file_name.c_str());
+    if (!file_stream_) {
+      CAFFE_THROW("PytorchStreamWriter failed opening archive ", file_name);
+    }
     writer_func_ = [this](const void* buf, size_t nbytes) -> size_t {
       file_stream_.write(static_cast<const char*>(buf), nbytes);
       return !file_stream_ ? 0 : nbytes;
@@ -311,6 +653,13 @@ void PyTorchStreamWriter::setMinVersion(const uint64_t version) {
   version_ = std::max(version, version_);
 }
 
+void PyTorchStreamWriter::setCompressRecords(
+    bool compress_records,
+    size_t num_threads) {
+  compress_records_ = compress_records;
+  compression_threads_ = num_threads > 0 ? num_threads : hardwareThreads();
+}
+
 void PyTorchStreamWriter::writeRecord(
     const std::string& name,
     const void* data,
@@ -318,6 +667,13 @@ void PyTorchStreamWriter::writeRecord(
     bool compress) {
   AT_ASSERT(!finalized_);
   AT_ASSERT(!archive_name_plus_slash_.empty());
+  // The cpu cost of compressing very small records isn't well spent
+  static constexpr size_t kMinToCompress = 200;
+  compress = compress || (compress_records_ && size > kMinToCompress);
+  if (compress && size >= 2 * kCompressionChunkSize) {
+    writeChunkedRecord(name, data, size);
+    return;
+  }
   std::string full_name = archive_name_plus_slash_ + name;
   size_t padding_size =
       getPadding(ar_->m_archive_size, full_name.size(), size, padding_);
@@ -340,6 +696,64 @@ void PyTorchStreamWriter::writeRecord(
   valid("writing file ", name.c_str());
 }
 
+void PyTorchStreamWriter::writeChunkedRecord(
+    const std::string& name,
+    const void* data,
+    size_t size) {
+  const size_t chunk_size = std::max(
+      kCompressionChunkSize,
+      (size + kMaxCompressionChunks - 1) / kMaxCompressionChunks);
+  const size_t num_chunks = (size + chunk_size - 1) / chunk_size;
+  std::vector<std::string> chunks(num_chunks);
+  std::vector<mz_uint32> crcs(num_chunks);
+  parallelFor(num_chunks, compression_threads_, [&](size_t i) {
+    const auto* begin = static_cast<const uint8_t*>(data) + i * chunk_size;
+    const size_t n = std::min(chunk_size, size - i * chunk_size);
+    chunks[i] = deflateChunk(begin, n, i + 1 == num_chunks);
+    crcs[i] = mz_crc32(MZ_CRC32_INIT, begin, n);
+  });
+
+  std::string extra(kChunkedExtraFieldId, sizeof(kChunkedExtraFieldId));
+  appendLE(extra, 1 + 4 + 4 * num_chunks, 2);
+  extra.push_back(static_cast<char>(kChunkedDeflateFormat));
+  appendLE(extra, chunk_size, 4);
+  size_t compressed_size = 0;
+  mz_uint32 crc = crcs[0];
+  for (size_t i = 0; i < num_chunks; ++i) {
+    appendLE(extra, chunks[i].size(), 4);
+    compressed_size += chunks[i].size();
+    if (i > 0) {
+      crc = crc32Combine(
+          crc, crcs[i], std::min(chunk_size, size - i * chunk_size));
+    }
+  }
+  AT_ASSERT(extra.size() == kChunkedExtraHeaderSize + 4 * num_chunks);
+  std::string compressed;
+  compressed.reserve(compressed_size);
+  for (auto& chunk : chunks) {
+    compressed += chunk;
+    std::string().swap(chunk);
+  }
+
+  std::string full_name = archive_name_plus_slash_ + name;
+  mz_zip_writer_add_mem_ex_v2(
+      ar_.get(),
+      full_name.c_str(),
+      compressed.data(),
+      compressed.size(),
+      nullptr,
+      0,
+      MZ_ZIP_FLAG_COMPRESSED_DATA,
+      size,
+      crc,
+      nullptr,
+      extra.data(),
+      extra.size(),
+      nullptr,
+      0);
+  valid("writing file ", name.c_str());
+}
+
 void PyTorchStreamWriter::writeEndOfFile() {
   // Rewrites version info
   std::string version = c10::to_string(version_);
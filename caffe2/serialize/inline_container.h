@@ -39,11 +39,17 @@ typedef struct mz_zip_archive mz_zip_archive;
 //
 // The PyTorchStreamWriter also ensures additional useful properties for these
 // files
-// 1. All files are stored uncompressed.
-// 2. All files in the archive are aligned to 64 byte boundaries such that
-//    it is possible to mmap the entire file and get an aligned pointer to
-//    tensor data.
+// 1. All files are stored uncompressed, unless compression is asked for.
+// 2. All uncompressed files in the archive are aligned to 64 byte boundaries
+//    such that it is possible to mmap the entire file and get an aligned
+//    pointer to tensor data.
 // 3. We universally write in ZIP64 format for consistency.
+// 4. Large compressed files are deflated in independent chunks of at least
+//    kCompressionChunkSize bytes on several threads. The deflated chunks
+//    form a single deflate stream, which any zip tool reads, and their
+//    sizes are listed in an extra field of the local header ("PC", for
+//    PyTorch chunks) so that PyTorchStreamReader inflates them on several
+//    threads too.
 
 // The PyTorchStreamReader also provides additional properties:
 // 1. It can read zip files that are created with common
@@ -52,6 +58,8 @@ typedef struct mz_zip_archive mz_zip_archive;
 // 2. It provides a getRecordOffset function which returns the offset into the
 //    raw file where file data lives. If the file was written with
 //    PyTorchStreamWriter it is guaranteed to be 64 byte aligned.
+// 3. When reading through a MmapFileAdapter, getRecord returns the aligned
+//    uncompressed records in place, without copying them.
 
 // PyTorchReader/Writer handle checking the version number on the archive format
 // and ensure that all files are written to a archive_name directory so they
@@ -147,6 +155,8 @@ static_assert(kProducedBytecodeVersion >= kProducedFileFormatVersion,
 
 // Writer-specific constants
 constexpr uint64_t kFieldAlignment = 64;
+// Uncompressed size of the chunks of the large compressed records
+constexpr size_t kCompressionChunkSize = 1 << 20;
 
 class CAFFE2_API PyTorchStreamReader final {
  public:
@@ -156,6 +166,13 @@ class CAFFE2_API PyTorchStreamReader final {
 
   // return dataptr, size
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
+  // same as getRecord for each of the names. When the input supports
+  // concurrent reads, the uncompressed records are read and checked on
+  // num_threads threads.
+  std::vector<std::tuple<at::DataPtr, size_t>> getRecords(
+      const std::vector<std::string>& names,
+      size_t num_threads);
+  size_t getRecordSize(const std::string& name);
   size_t getRecordOffset(const std::string& name);
   bool hasRecord(const std::string& name);
   std::vector<std::string> getAllRecords();
@@ -170,6 +187,12 @@ class CAFFE2_API PyTorchStreamReader final {
   size_t read(uint64_t pos, char* buf, size_t n);
   void valid(const char* what, const char* info = "");
   size_t getRecordID(const std::string& name);
+  // Inflates a record written in chunks on several threads, returns false if
+  // the record has no chunk sizes
+  bool getChunkedRecord(
+      const std::string& name,
+      size_t key,
+      at::DataPtr* data);
 
   friend size_t
   istream_read_func(void* pOpaque, uint64_t file_ofs, void* pBuf, size_t n);
@@ -178,6 +201,7 @@ class CAFFE2_API PyTorchStreamReader final {
   std::string archive_name_plus_slash_;
   std::unique_ptr<ReadAdapterInterface> in_;
   int64_t version_;
+  bool mappable_ = false;
 };
 
 class CAFFE2_API PyTorchStreamWriter final {
@@ -188,6 +212,11 @@ class CAFFE2_API PyTorchStreamWriter final {
 
   void setMinVersion(const uint64_t version);
 
+  // Compresses the records written from now on, except for tiny ones, as if
+  // writeRecord was called with compress set. Large records are deflated in
+  // chunks on num_threads threads, all available hardware threads if 0.
+  void setCompressRecords(bool compress_records, size_t num_threads = 0);
+
   void writeRecord(
       const std::string& name,
       const void* data,
@@ -208,6 +237,10 @@ class CAFFE2_API PyTorchStreamWriter final {
  private:
   void setup(const std::string& file_name);
   void valid(const char* what, const char* info = "");
+  void writeChunkedRecord(
+      const std::string& name,
+      const void* data,
+      size_t size);
   size_t current_pos_ = 0;
   std::unique_ptr<mz_zip_archive> ar_;
   std::string archive_name_;
@@ -216,6 +249,8 @@ class CAFFE2_API PyTorchStreamWriter final {
   std::ofstream file_stream_;
   std::function<size_t(const void*, size_t)> writer_func_;
   uint64_t version_ = kProducedFileFormatVersion;
+  bool compress_records_ = false;
+  size_t compression_threads_ = 1;
   bool finalized_ = false;
   bool err_seen_ = false;
   friend size_t ostream_write_func(
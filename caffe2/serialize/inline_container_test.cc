@@ -1,10 +1,13 @@
 #include <cstdio>
 #include <string>
 #include <array>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
+#include "miniz.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -63,6 +66,164 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(PyTorchStreamWriterAndReader, GetRecordsInParallel) {
+  std::vector<std::string> names;
+  std::vector<std::vector<char>> data;
+  {
+    PyTorchStreamWriter writer("parallel.zip");
+    for (int i = 0; i < 50; ++i) {
+      names.push_back("data/" + c10::to_string(i));
+      data.emplace_back(i * 37 + 1);
+      for (size_t j = 0; j < data.back().size(); ++j) {
+        data.back()[j] = i + j;
+      }
+      writer.writeRecord(names.back(), data.back().data(), data.back().size());
+    }
+    writer.writeEndOfFile();
+  }
+
+  PyTorchStreamReader reader("parallel.zip");
+  auto records = reader.getRecords(names, 4);
+  ASSERT_EQ(records.size(), names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    ASSERT_EQ(std::get<1>(records[i]), data[i].size());
+    ASSERT_EQ(reader.getRecordSize(names[i]), data[i].size());
+    ASSERT_EQ(
+        memcmp(std::get<0>(records[i]).get(), data[i].data(), data[i].size()),
+        0);
+  }
+  std::remove("parallel.zip");
+}
+
+TEST(PyTorchStreamWriterAndReader, LargeRecordChecksum) {
+  // Large enough to be checksummed in parallel chunks
+  std::vector<uint8_t> data(40 << 20);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = (i * 2654435761u) >> 13;
+  }
+  mz_ulong expected = MZ_CRC32_INIT;
+  for (size_t begin = 0; begin < data.size(); begin += 1 << 20) {
+    expected = mz_crc32(expected, data.data() + begin, 1 << 20);
+  }
+  ASSERT_EQ(mz_crc32(MZ_CRC32_INIT, data.data(), data.size()), expected);
+
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  writer.writeRecord("large", data.data(), data.size());
+  writer.writeEndOfFile();
+
+  std::istringstream iss(oss.str());
+  PyTorchStreamReader reader(&iss);
+  at::DataPtr data_ptr;
+  int64_t size;
+  std::tie(data_ptr, size) = reader.getRecord("large");
+  ASSERT_EQ(size, data.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data.data(), data.size()), 0);
+}
+
+TEST(PyTorchStreamWriterAndReader, CompressRecords) {
+  // Compressible, and large enough to be deflated in chunks in parallel
+  std::vector<uint8_t> large((5 << 20) + 12345);
+  for (size_t i = 0; i < large.size(); ++i) {
+    large[i] = (i / 7) % 251;
+  }
+  std::vector<uint8_t> medium(100000);
+  for (size_t i = 0; i < medium.size(); ++i) {
+    medium[i] = i % 13;
+  }
+  std::array<char, 127> small;
+  for (int i = 0; i < small.size(); ++i) {
+    small[i] = small.size() - i;
+  }
+
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  writer.setCompressRecords(true, 4);
+  writer.writeRecord("large", large.data(), large.size());
+  writer.writeRecord("medium", medium.data(), medium.size());
+  writer.writeRecord("small", small.data(), small.size());
+  writer.writeEndOfFile();
+  ASSERT_LT(oss.str().size(), large.size() / 4);
+
+  std::istringstream iss(oss.str());
+  PyTorchStreamReader reader(&iss);
+  at::DataPtr data_ptr;
+  int64_t size;
+  std::tie(data_ptr, size) = reader.getRecord("large");
+  ASSERT_EQ(size, large.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), large.data(), large.size()), 0);
+  std::tie(data_ptr, size) = reader.getRecord("medium");
+  ASSERT_EQ(size, medium.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), medium.data(), medium.size()), 0);
+  // Too small to be compressed, so still aligned
+  std::tie(data_ptr, size) = reader.getRecord("small");
+  ASSERT_EQ(size, small.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), small.data(), small.size()), 0);
+  ASSERT_EQ(reader.getRecordOffset("small") % 64, 0);
+
+  // The chunks form a single deflate stream that other zip readers inflate
+  mz_zip_archive archive;
+  memset(&archive, 0, sizeof(archive));
+  const std::string buffer = oss.str();
+  ASSERT_TRUE(mz_zip_reader_init_mem(&archive, buffer.data(), buffer.size(), 0));
+  size_t extracted_size;
+  void* extracted = mz_zip_reader_extract_file_to_heap(
+      &archive, "archive/large", &extracted_size, 0);
+  ASSERT_NE(extracted, nullptr);
+  ASSERT_EQ(extracted_size, large.size());
+  ASSERT_EQ(memcmp(extracted, large.data(), large.size()), 0);
+  mz_free(extracted);
+  mz_zip_reader_end(&archive);
+}
+
+#ifndef _WIN32
+TEST(PyTorchStreamWriterAndReader, LoadMmapped) {
+  std::array<char, 127> data1;
+  for (int i = 0; i < data1.size(); ++i) {
+    data1[i] = data1.size() - i;
+  }
+  {
+    PyTorchStreamWriter writer("mmapped.zip");
+    writer.writeRecord("key1", data1.data(), data1.size());
+    writer.writeEndOfFile();
+  }
+
+  at::DataPtr data_ptr;
+  int64_t size;
+  size_t off1;
+  {
+    PyTorchStreamReader reader(
+        std::make_unique<MmapFileAdapter>("mmapped.zip"));
+    at::DataPtr version_ptr;
+    std::tie(version_ptr, size) = reader.getRecord("version");
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+    off1 = reader.getRecordOffset("key1");
+    // The record points into the mapping of the file
+    ASSERT_EQ(
+        static_cast<char*>(data_ptr.get()) - off1,
+        static_cast<char*>(version_ptr.get()) -
+            reader.getRecordOffset("version"));
+  }
+  // and outlives the reader
+  ASSERT_EQ(size, data1.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  ASSERT_EQ(off1 % 64, 0);
+
+  // Writes are not seen in the file
+  static_cast<char*>(data_ptr.get())[0] = 0;
+  PyTorchStreamReader reader("mmapped.zip");
+  std::tie(data_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  std::remove("mmapped.zip");
+}
+#endif
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
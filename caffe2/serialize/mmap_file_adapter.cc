@@ -0,0 +1,106 @@
+#include "caffe2/serialize/mmap_file_adapter.h"
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+namespace {
+template <typename Mapping>
+void deleteMappingRef(void* ctx) {
+  delete static_cast<std::shared_ptr<Mapping>*>(ctx);
+}
+} // namespace
+
+struct MmapFileAdapter::Mapping {
+  ~Mapping() {
+#ifndef _WIN32
+    if (data) {
+      munmap(data, size);
+    }
+#endif
+  }
+
+  void* data = nullptr;
+  size_t size = 0;
+};
+
+MmapFileAdapter::MmapFileAdapter(const std::string& file_name)
+    : mapping_(std::make_shared<Mapping>()) {
+#ifdef _WIN32
+  AT_ERROR("memory mapped files are not supported on Windows: ", file_name);
+#else
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd == -1) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    close(fd);
+    AT_ERROR("stat failed, file path: ", file_name, ": ", strerror(errno));
+  }
+  size_t size = st.st_size;
+  if (size > 0) {
+    void* data =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      AT_ERROR("mmap failed, file path: ", file_name, ": ", strerror(errno));
+    }
+    mapping_->data = data;
+    mapping_->size = size;
+  }
+  // The mapping stays valid once the file is closed
+  close(fd);
+#endif
+}
+
+size_t MmapFileAdapter::size() const {
+  return mapping_->size;
+}
+
+size_t MmapFileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos >= mapping_->size) {
+    return 0;
+  }
+  n = std::min<size_t>(n, mapping_->size - pos);
+  memcpy(buf, static_cast<char*>(mapping_->data) + pos, n);
+  return n;
+}
+
+at::DataPtr MmapFileAdapter::map(uint64_t pos, size_t n) const {
+  if (pos > mapping_->size || n > mapping_->size - pos) {
+    return at::DataPtr();
+  }
+  // Each record holds a reference on the mapping
+  auto ctx = new std::shared_ptr<Mapping>(mapping_);
+  return at::DataPtr(
+      static_cast<char*>(mapping_->data) + pos,
+      ctx,
+      &deleteMappingRef<Mapping>,
+      at::kCPU);
+}
+
+bool MmapFileAdapter::isMapped(const at::DataPtr& data_ptr) {
+  return data_ptr.get_deleter() == &deleteMappingRef<Mapping>;
+}
+
+bool MmapFileAdapter::supportsConcurrentReads() const {
+  return true;
+}
+
+MmapFileAdapter::~MmapFileAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
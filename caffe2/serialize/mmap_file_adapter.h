@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// this is a reader that maps the whole file in memory. The records read
+// through PyTorchStreamReader point into the mapping instead of being copied,
+// so that the tensor storages of a loaded archive don't need memory of their
+// own. The mapping is private: writes to the tensors are copied on write and
+// never reach the file. It is unmapped once the adapter and all the records
+// are gone.
+class CAFFE2_API MmapFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapFileAdapter);
+  explicit MmapFileAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr map(uint64_t pos, size_t n) const override;
+  bool supportsConcurrentReads() const override;
+  ~MmapFileAdapter();
+
+  // Whether data_ptr was returned by map, and so doesn't own memory of its own
+  static bool isMapped(const at::DataPtr& data_ptr);
+
+ private:
+  struct Mapping;
+  std::shared_ptr<Mapping> mapping_;
+};
+
+} // namespace serialize
+} // namespace caffe2
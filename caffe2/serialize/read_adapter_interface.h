@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "c10/core/Allocator.h"
 #include "c10/macros/Macros.h"
 
 namespace caffe2 {
@@ -16,6 +17,11 @@ class CAFFE2_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // returns the n bytes at pos in place, if the reader has the whole input in
+  // memory, or an empty DataPtr if they can only be read into a buffer
+  virtual at::DataPtr map(uint64_t pos, size_t n) const;
+  // whether read() may be called from several threads at once
+  virtual bool supportsConcurrentReads() const;
   virtual ~ReadAdapterInterface();
 };
 
@@ -253,6 +253,30 @@ else()
       ${LIBNVTOOLSEXT})
 endif()
 
+# cupti, shipped with the toolkit in extras/CUPTI
+if(CAFFE2_USE_CUPTI)
+  find_library(CUPTI_LIBRARY_PATH cupti
+    PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/lib64 ${CUDA_TOOLKIT_ROOT_DIR}/lib64
+    NO_DEFAULT_PATH)
+  find_path(CUPTI_INCLUDE_DIR cupti.h
+    PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/include ${CUDA_INCLUDE_DIRS}
+    NO_DEFAULT_PATH)
+  if(CUPTI_LIBRARY_PATH AND CUPTI_INCLUDE_DIR)
+    add_library(torch::cupti INTERFACE IMPORTED)
+    set_property(
+        TARGET torch::cupti PROPERTY INTERFACE_LINK_LIBRARIES
+        ${CUPTI_LIBRARY_PATH})
+    set_property(
+        TARGET torch::cupti PROPERTY INTERFACE_INCLUDE_DIRECTORIES
+        ${CUPTI_INCLUDE_DIR})
+  else()
+    message(WARNING
+      "CUPTI not found, the profiler won't be able to trace CUDA kernels. "
+      "Turn this warning off with -DUSE_CUPTI=OFF.")
+    set(CAFFE2_USE_CUPTI OFF)
+  endif()
+endif()
+
 # cudnn
 # static linking is handled by USE_STATIC_CUDNN environment variable
 if(CAFFE2_USE_CUDNN)
@@ -332,6 +356,15 @@ else()
     set_property(
         TARGET caffe2::cublas PROPERTY INTERFACE_LINK_LIBRARIES
         ${CUDA_CUBLAS_LIBRARIES})
+    # at::cuda::blas calls cuBLASLt directly from CUDA 11 on.
+    if(CUDA_VERSION VERSION_GREATER_EQUAL 11.0)
+      find_library(CUDA_cublasLt_LIBRARY cublasLt
+          HINTS ${CUDA_TOOLKIT_ROOT_DIR}
+          PATH_SUFFIXES lib64 lib/x64 lib)
+      set_property(
+          TARGET caffe2::cublas APPEND PROPERTY INTERFACE_LINK_LIBRARIES
+          ${CUDA_cublasLt_LIBRARY})
+    endif()
 endif()
 set_property(
     TARGET caffe2::cublas PROPERTY INTERFACE_INCLUDE_DIRECTORIES
@@ -153,6 +153,8 @@
 #       OMP - use OpenMP for intra-op and native backend for inter-op tasks
 #       NATIVE - use native thread pool for both intra- and inter-op tasks
 #       TBB - using TBB for intra- and native thread pool for inter-op parallelism
+#       WORK_STEALING - like NATIVE, with parallel_for ranges rebalanced
+#         between threads by work stealing
 #
 #   USE_TBB
 #      enable TBB support
@@ -450,6 +450,48 @@ TEST(DataTest, TensorDatasetConstructsFromInitializerListOfTensors) {
       torch::tensor({0, 0, 1, 0, 0}, torch::kFloat32).allclose(dataset.get(2)));
 }
 
+TEST(DataTest, RecordDatasetReadsWhatRecordWriterWrote) {
+  auto tempfile = c10::make_tempfile();
+  std::vector<torch::Tensor> records;
+  {
+    datasets::RecordWriter writer(tempfile.name);
+    for (int64_t i = 0; i < 50; ++i) {
+      // Records of different sizes, including an empty one.
+      records.push_back(torch::arange(i % 7, torch::kInt32) + i);
+      writer.write(records.back());
+    }
+    ASSERT_EQ(writer.size(), 50);
+  }
+
+  for (auto mode :
+       {datasets::RecordDataset::Mode::kMmap,
+        datasets::RecordDataset::Mode::kRead}) {
+    datasets::RecordDataset dataset(tempfile.name, mode);
+    ASSERT_EQ(dataset.size().value(), 50);
+    const auto as_record = [](const torch::Tensor& tensor) {
+      return torch::from_blob(
+          tensor.data_ptr(),
+          {static_cast<int64_t>(tensor.nbytes())},
+          torch::kByte);
+    };
+    ASSERT_TRUE(dataset.get(10).data.equal(as_record(records[10])));
+
+    // Out of order, repeated and consecutive indices.
+    const std::vector<size_t> indices = {49, 3, 4, 5, 0, 3, 27, 28};
+    auto batch = dataset.get_batch(indices);
+    ASSERT_EQ(batch.size(), indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      ASSERT_TRUE(batch[i].data.equal(as_record(records[indices[i]])));
+    }
+    ASSERT_THROWS_WITH(dataset.get(50), "out of range");
+
+    // Writing to a record doesn't change the file.
+    batch[0].data.fill_(0);
+    ASSERT_TRUE(dataset.get(49).data.equal(as_record(records[49])));
+  }
+  std::remove((tempfile.name + ".index").c_str());
+}
+
 TEST(DataTest, StackTransformWorksForExample) {
   struct D : public datasets::Dataset<D> {
     Example<> get(size_t index) override {
@@ -1030,6 +1072,8 @@ TEST(DataLoaderTest, DataLoaderOptionsDefaultAsExpected) {
   ASSERT_EQ(full_options.max_jobs, 0);
   ASSERT_FALSE(full_options.timeout.has_value());
   ASSERT_TRUE(full_options.enforce_ordering);
+  ASSERT_FALSE(full_options.pin_memory);
+  ASSERT_FALSE(full_options.device.has_value());
 }
 
 TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
@@ -1039,6 +1083,67 @@ TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
   ASSERT_EQ(full_options.max_jobs, 2 * 10);
 }
 
+TEST(DataLoaderTest, DataLoaderOptionsPrefetchFactorSetsMaxJobs) {
+  FullDataLoaderOptions full_options(
+      DataLoaderOptions(32).workers(10).prefetch_factor(4));
+  ASSERT_EQ(full_options.max_jobs, 4 * 10);
+  FullDataLoaderOptions explicit_options(
+      DataLoaderOptions(32).workers(10).prefetch_factor(4).max_jobs(3));
+  ASSERT_EQ(explicit_options.max_jobs, 3);
+}
+
+struct RangeExampleDataset : datasets::Dataset<RangeExampleDataset> {
+  torch::data::Example<> get(size_t index) override {
+    return {torch::full({2}, static_cast<double>(index)),
+            torch::full({1}, static_cast<double>(index))};
+  }
+  torch::optional<size_t> size() const override {
+    return 20;
+  }
+};
+
+TEST(DataLoaderTest, MovesBatchesToDevice) {
+  auto data_loader = torch::data::make_data_loader(
+      RangeExampleDataset{}.map(transforms::Stack<>()),
+      DataLoaderOptions(5).workers(2).device(torch::kCPU));
+  size_t batches = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.data.device().is_cpu());
+    ASSERT_EQ(batch.data.size(0), 5);
+    ASSERT_TRUE(batch.data.select(1, 0).equal(batch.target.squeeze(1)));
+    batches++;
+  }
+  ASSERT_EQ(batches, 4);
+}
+
+TEST(DataLoaderTest, PinsMemoryAndCopiesBatchesToDevice_CUDA) {
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        RangeExampleDataset{}.map(transforms::Stack<>()),
+        DataLoaderOptions(5).workers(workers).pin_memory(true).device(
+            torch::kCUDA));
+    std::vector<torch::Tensor> targets;
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.data.device().is_cuda());
+      ASSERT_TRUE(batch.target.device().is_cuda());
+      ASSERT_EQ(batch.data.device().index(), 0);
+      targets.push_back(batch.target.squeeze(1));
+    }
+    ASSERT_TRUE(torch::cat(targets).cpu().equal(
+        torch::arange(20, torch::kDouble)));
+  }
+}
+
+TEST(DataLoaderTest, PinsMemoryOfBatches_CUDA) {
+  auto data_loader = torch::data::make_data_loader(
+      RangeExampleDataset{}.map(transforms::Stack<>()),
+      DataLoaderOptions(5).workers(2).pin_memory(true));
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.data.is_pinned());
+    ASSERT_TRUE(batch.target.is_pinned());
+  }
+}
+
 TEST(DataLoaderTest, MakeDataLoaderDefaultsAsExpected) {
   auto data_loader = torch::data::make_data_loader(
       DummyDataset().map(transforms::Lambda<int>([](int x) { return x + 1; })));
@@ -2223,6 +2328,69 @@ TEST(DataLoaderTest, ChunkDatasetCrossChunkShuffle) {
   }
 }
 
+TEST(DataLoaderTest, ChunkDatasetShuffleShards) {
+  const size_t chunk_size = 10;
+  const size_t num_chunks = 8;
+  const size_t batch_size = 4;
+
+  struct D : public datasets::ChunkDataReader<int> {
+   public:
+    using BatchType = datasets::ChunkDataReader<int>::ChunkType;
+
+    BatchType read_chunk(size_t chunk_index) override {
+      BatchType batch_data(chunk_size);
+      std::iota(
+          batch_data.begin(), batch_data.end(), chunk_index * chunk_size);
+      return batch_data;
+    }
+
+    size_t chunk_count() override {
+      return num_chunks;
+    };
+
+    void reset() override{};
+  };
+
+  for (size_t preloader_count : {1, 3}) {
+    for (size_t shuffle_shard_count : {1, 4}) {
+      datasets::SharedBatchDataset<datasets::ChunkDataset<
+          D,
+          samplers::SequentialSampler,
+          samplers::SequentialSampler>>
+          dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+              D,
+              samplers::SequentialSampler,
+              samplers::SequentialSampler>>(
+              D{},
+              samplers::SequentialSampler(0),
+              samplers::SequentialSampler(0),
+              datasets::ChunkDatasetOptions(preloader_count, batch_size, 40)
+                  .shuffle_shard_count(shuffle_shard_count));
+
+      auto data_loader = torch::data::make_data_loader(
+          dataset, DataLoaderOptions(batch_size).workers(2));
+
+      std::vector<int> result;
+      bool mixes_chunks = false;
+      for (auto& batch : *data_loader) {
+        ASSERT_LE(batch.size(), batch_size);
+        for (int example : batch) {
+          mixes_chunks |= example / chunk_size != batch[0] / chunk_size;
+        }
+        result.insert(result.end(), batch.begin(), batch.end());
+      }
+
+      // Every example comes out exactly once, and batches are drawn across
+      // the chunks in the buffer.
+      std::sort(result.begin(), result.end());
+      std::vector<int> expected_result(chunk_size * num_chunks);
+      std::iota(expected_result.begin(), expected_result.end(), 0);
+      ASSERT_EQ(result, expected_result);
+      ASSERT_TRUE(mixes_chunks);
+    }
+  }
+}
+
 TEST(DataLoaderTest, CustomPreprocessPolicy) {
   const size_t chunk_size = 5;
   const size_t batch_size = 10;
@@ -0,0 +1,67 @@
+#include <torch/torch.h>
+#include <chrono>
+#include <iostream>
+
+// Makes image-like examples, with some CPU work per example to stand in for
+// decoding and augmentation.
+struct SyntheticDataset : torch::data::datasets::Dataset<SyntheticDataset> {
+  explicit SyntheticDataset(size_t size) : size_(size) {}
+
+  torch::data::Example<> get(size_t index) override {
+    auto image = torch::rand({3, 128, 128});
+    image = (image - image.mean()) / image.std();
+    return {image, torch::full({1}, static_cast<int64_t>(index % 10))};
+  }
+
+  torch::optional<size_t> size() const override {
+    return size_;
+  }
+
+  size_t size_;
+};
+
+void Loader_Throughput(
+    size_t numExamples,
+    torch::data::DataLoaderOptions options,
+    const char* name) {
+  auto loader = torch::data::make_data_loader(
+      SyntheticDataset(numExamples).map(torch::data::transforms::Stack<>()),
+      options);
+  size_t examples = 0;
+  torch::Tensor checksum;
+  auto start = std::chrono::system_clock::now();
+  for (auto& batch : *loader) {
+    // The training step would consume the batch here.
+    auto sum = batch.target.sum();
+    checksum = checksum.defined() ? checksum + sum : sum;
+    examples += batch.data.size(0);
+  }
+  // Waits for the work queued on the device, if any.
+  checksum.item<int64_t>();
+  auto usec = std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::system_clock::now() - start)
+                  .count();
+  std::cout << name << "(workers=" << options.workers()
+            << ", prefetch_factor=" << options.prefetch_factor() << "): "
+            << static_cast<double>(examples) * 1e6 / static_cast<double>(usec)
+            << " examples/sec\n";
+}
+
+int main(int argc, char** argv) {
+  const size_t N = 4096;
+  const size_t batchSize = 64;
+  for (size_t workers : {0, 2, 4, 8}) {
+    for (size_t prefetchFactor : {1, 2, 4}) {
+      auto options = torch::data::DataLoaderOptions(batchSize)
+                         .workers(workers)
+                         .prefetch_factor(prefetchFactor);
+      Loader_Throughput(N, options, "CPU");
+      if (torch::cuda::is_available()) {
+        Loader_Throughput(N, options.device(torch::kCUDA), "CUDA");
+        Loader_Throughput(
+            N, options.pin_memory(true).device(torch::kCUDA), "PinnedCUDA");
+      }
+    }
+  }
+  return 0;
+}
@@ -572,6 +572,29 @@ void testWriteTracking() {
     AT_ASSERT(aliasDb.hasWriters(add));
     AT_ASSERT(aliasDb.isMutable(add));
   }
+  {
+    // Removing writes keeps track of the locations other nodes still write to
+    auto graph = std::make_shared<Graph>();
+    std::unordered_map<std::string, Value*> vmap;
+    parseIR(
+        R"IR(
+  graph(%x: Tensor, %y : Tensor):
+    %c1 : int = prim::Constant[value=1]()
+    %z : Tensor = aten::mul(%x, %y)
+    %a : Tensor = aten::add_(%z, %y, %c1)
+    %b : Tensor = aten::add_(%z, %y, %c1)
+    return (%b)
+    )IR",
+        &*graph,
+        vmap);
+    AliasDb aliasDb(graph);
+    ASSERT_TRUE(aliasDb.hasWriters(vmap["z"]));
+    aliasDb.removeWrites(vmap["a"]->node());
+    ASSERT_TRUE(aliasDb.hasWriters(vmap["z"]));
+    aliasDb.removeWrites(vmap["b"]->node());
+    ASSERT_FALSE(aliasDb.hasWriters(vmap["z"]));
+    ASSERT_FALSE(aliasDb.hasWriters(vmap["x"]));
+  }
 }
 
 void testContainerAliasing() {
@@ -277,5 +277,54 @@ void testDifferentiateWithRequiresGrad() {
       ->run(*grad_spec.df);
 }
 
+void testDifferentiateWithRecompute() {
+  const auto make_graph = []() {
+    auto graph = std::make_shared<Graph>();
+    const auto type = TensorType::create(
+        at::ScalarType::Float,
+        at::kCPU,
+        c10::VaryingShape<int64_t>{std::vector<int64_t>{2, 3}},
+        c10::VaryingShape<int64_t>{std::vector<int64_t>{3, 1}},
+        true);
+    // Builds graph sigmoid(a * b) * a
+    auto* a = graph->addInput()->setType(type);
+    auto* b = graph->addInput()->setType(type);
+    auto* ab = graph->insert(aten::mul, {a, b});
+    auto* s = graph->insert(aten::sigmoid, {ab});
+    graph->registerOutput(graph->insert(aten::mul, {s, a}));
+    return graph;
+  };
+
+  auto saved_graph = make_graph();
+  auto saved = differentiate(saved_graph);
+  auto recomputed_graph = make_graph();
+  auto recomputed = differentiate(recomputed_graph, true);
+
+  // a * b and its sigmoid are computed again from the inputs in df, instead
+  // of being extra outputs of f
+  ASSERT_EQ(recomputed.f_real_outputs, 1);
+  ASSERT_EQ(recomputed.df_input_captured_inputs, std::vector<size_t>({0, 1}));
+  ASSERT_TRUE(recomputed.f->outputs().size() < saved.f->outputs().size());
+  testing::FileCheck()
+      .check("aten::mul")
+      ->check("aten::sigmoid")
+      ->check("prim::GradOf")
+      ->run(*recomputed.df);
+
+  LowerGradOf(*saved.df);
+  LowerGradOf(*recomputed.df);
+  tensor_list inputs = {at::randn({2, 3}), at::randn({2, 3})};
+  tensor_list grads = {at::randn({2, 3})};
+  ASSERT_EQ(recomputed.df_input_vjps.size(), 1);
+  // the vjps of the temporaries saved in f are undefined
+  tensor_list saved_vjps = grads;
+  saved_vjps.resize(saved.df_input_vjps.size());
+  tensor_list saved_outputs, saved_grads, outputs, input_grads;
+  std::tie(saved_outputs, saved_grads) = runGradient(saved, inputs, saved_vjps);
+  std::tie(outputs, input_grads) = runGradient(recomputed, inputs, grads);
+  assertAllClose(outputs, saved_outputs);
+  assertAllClose(input_grads, saved_grads);
+}
+
 } // namespace jit
 } // namespace torch
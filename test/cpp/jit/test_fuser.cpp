@@ -4,6 +4,7 @@
 #include "ATen/core/interned_strings.h"
 #include "torch/csrc/autograd/generated/variable_factories.h"
 #include "torch/csrc/autograd/variable.h"
+#include "torch/csrc/jit/codegen/fuser/disk_cache.h"
 #include "torch/csrc/jit/codegen/fuser/interface.h"
 #include "torch/csrc/jit/frontend/code_template.h"
 #include "torch/csrc/jit/frontend/tracer.h"
@@ -42,6 +43,12 @@
 
 #include <c10/util/Exception.h>
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <cstddef>
 #include <functional>
@@ -249,5 +256,55 @@ void testRegisterFusionCachesKernel() {
   // and therefore share a KernelSpec to share kernels for specializations
   ASSERT_EQ(second_key, expected_key);
 }
+
+void testFuserDiskCache() {
+#ifndef _WIN32
+  char cache_dir[] = "/tmp/pytorch_fuser_cache_XXXXXX";
+  ASSERT_NE(mkdtemp(cache_dir), nullptr);
+  std::string old_cache_dir = fuser::diskCacheDir();
+  fuser::diskCacheDir() = cache_dir;
+
+  int num_compiles = 0;
+  auto compile = [&](const std::string& name, const std::string& binary) {
+    return [&num_compiles, name, binary]() {
+      ++num_compiles;
+      return fuser::CachedKernel{name, binary};
+    };
+  };
+  const auto code = "void kernel_0(float* x) { kernel_0_helper(x); }";
+  auto kernel = fuser::compileWithDiskCache(
+      "kernel_0", code, "g++", compile("kernel_0", "binary"));
+  ASSERT_EQ(num_compiles, 1);
+
+  // Found again, with the name of the cached kernel
+  const auto renamed_code = "void kernel_7(float* x) { kernel_0_helper(x); }";
+  kernel = fuser::compileWithDiskCache(
+      "kernel_7", renamed_code, "g++", compile("kernel_7", "other"));
+  ASSERT_EQ(num_compiles, 1);
+  ASSERT_EQ(kernel.name, "kernel_0");
+  ASSERT_EQ(kernel.binary, "binary");
+
+  // A different config or different code is compiled again
+  kernel = fuser::compileWithDiskCache(
+      "kernel_0", code, "clang++", compile("kernel_0", "clang"));
+  ASSERT_EQ(num_compiles, 2);
+  ASSERT_EQ(kernel.binary, "clang");
+  const auto helper_code = "void kernel_0(float* x) { kernel_1_helper(x); }";
+  fuser::compileWithDiskCache(
+      "kernel_0", helper_code, "g++", compile("kernel_0", "binary"));
+  ASSERT_EQ(num_compiles, 3);
+
+  DIR* dir = opendir(cache_dir);
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name != "." && name != "..") {
+      unlink((std::string(cache_dir) + "/" + name).c_str());
+    }
+  }
+  closedir(dir);
+  rmdir(cache_dir);
+  fuser::diskCacheDir() = old_cache_dir;
+#endif
+}
 } // namespace jit
 } // namespace torch
@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/mobile/import.h>
 #include <torch/csrc/jit/mobile/module.h>
+#include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/custom_class.h>
 #include <torch/torch.h>
@@ -121,6 +122,131 @@ void testLiteInterpreterInline() {
   AT_ASSERT(output.toTensor().item<float>() == 7.0);
 }
 
+void testLiteInterpreterStackSize() {
+  Module m("m");
+  m.define(R"JIT(
+  def add(self, x):
+      return x + 1
+
+  def forward(self, x, n: int):
+      for i in range(n):
+          if i % 2 == 0:
+              x = self.add(x)
+          else:
+              x = x * 2
+      return x
+  )JIT");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  // x and the constants 1 and alpha of aten::add
+  ASSERT_GE(bc.find_method("add")->stack_size(), 3);
+  ASSERT_GT(bc.find_method("forward")->stack_size(), 0);
+  // The interpreter states are reused across calls
+  for (int64_t n = 0; n < 5; ++n) {
+    std::vector<torch::jit::IValue> inputs({torch::ones({}), n});
+    auto expected = m.forward(inputs).toTensor();
+    auto output = bc.run_method("forward", inputs).toTensor();
+    ASSERT_TRUE(output.equal(expected));
+  }
+}
+
+void testLiteInterpreterSharedOperators() {
+  Module m("m");
+  // The calls of the same overload share their entry of the operator table
+  m.define(R"JIT(
+  def forward(self, x, y):
+      a = x + 1
+      b = a + y
+      c = b + 2
+      d = c * y
+      return d + y
+  )JIT");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  std::vector<torch::jit::IValue> inputs({torch::ones({2}), torch::full({2}, 3)});
+  auto expected = m.forward(inputs).toTensor();
+  auto output = bc.run_method("forward", inputs).toTensor();
+  ASSERT_TRUE(output.equal(expected));
+}
+
+void testLiteInterpreterLoadMmapped() {
+#ifndef _WIN32
+  struct MemoryObserver : public MobileModuleObserver {
+    MemoryObserver(size_t& mapped_bytes, size_t& copied_bytes)
+        : mapped_bytes_(mapped_bytes), copied_bytes_(copied_bytes) {}
+    void onLoadModelMemory(size_t mapped_bytes, size_t copied_bytes) override {
+      mapped_bytes_ = mapped_bytes;
+      copied_bytes_ = copied_bytes;
+    }
+    size_t& mapped_bytes_;
+    size_t& copied_bytes_;
+  };
+
+  Module m("m");
+  auto weight = torch::randn({64, 64});
+  m.register_parameter("weight", weight, false);
+  m.define(R"JIT(
+    def forward(self, x):
+      return torch.mm(x, self.weight)
+  )JIT");
+  m._save_for_mobile("mmapped.ptl");
+
+  size_t mapped_bytes = 0;
+  size_t copied_bytes = 0;
+  observerConfig().setModuleObserver(
+      std::make_unique<MemoryObserver>(mapped_bytes, copied_bytes));
+  mobile::Module bc = _load_for_mobile("mmapped.ptl", c10::nullopt, true);
+  observerConfig().setModuleObserver(nullptr);
+  std::remove("mmapped.ptl");
+
+  // The weight and the pickles point into the mapping
+  ASSERT_GE(mapped_bytes, weight.numel() * weight.element_size());
+  ASSERT_EQ(copied_bytes, 0);
+  auto x = torch::randn({2, 64});
+  std::vector<torch::jit::IValue> inputs({x});
+  ASSERT_TRUE(bc.forward(inputs).toTensor().equal(torch::mm(x, weight)));
+#endif
+}
+
+void testLiteInterpreterOpObserver() {
+  Module m("m");
+  m.define(R"(
+    def forward(self, x):
+      y = x + 1
+      return torch.mm(y, y)
+  )");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  auto x = torch::ones({8, 8});
+
+  auto stats_observer = std::make_unique<MobileOpStatsObserver>();
+  MobileOpStatsObserver* observer = stats_observer.get();
+  observerConfig().setOpObserver(std::move(stats_observer));
+  for (int i = 0; i < 3; ++i) {
+    bc.forward({x});
+  }
+  auto summary = observer->summary();
+  observer->reset();
+  ASSERT_TRUE(observer->summary().empty());
+  observerConfig().setOpObserver(nullptr);
+
+  auto mm = std::find_if(
+      summary.begin(), summary.end(), [](const MobileOpStats& stats) {
+        return stats.op_name == "aten::mm";
+      });
+  ASSERT_NE(mm, summary.end());
+  ASSERT_EQ(mm->count, 3);
+  ASSERT_GE(mm->total_ns, mm->max_ns);
+  // Each mm allocates its 8x8 float output
+  ASSERT_GE(mm->allocated_bytes, 3 * 8 * 8 * 4);
+  for (size_t i = 1; i < summary.size(); ++i) {
+    ASSERT_GE(summary[i - 1].total_ns, summary[i].total_ns);
+  }
+}
+
 void testLiteInterpreterTuple() {
   Module m("m");
   m.define(R"JIT(
@@ -38,6 +38,7 @@
 #include "torch/csrc/jit/runtime/argument_spec.h"
 #include "torch/csrc/jit/runtime/autodiff.h"
 #include "torch/csrc/jit/runtime/custom_operator.h"
+#include "torch/csrc/jit/runtime/instruction.h"
 #include "torch/csrc/jit/runtime/interpreter.h"
 #include "torch/csrc/jit/runtime/symbolic_script.h"
 #include "torch/csrc/jit/serialization/import.h"
@@ -482,6 +483,38 @@ void testControlFlow() {
   ASSERT_EQ(256, run_binary("while_test", 2, 0));
 }
 
+void testRegisterOps() {
+  auto cu = compile(R"JIT(
+    def foo(a, b):
+        c = a * b
+        d = c + a
+        return d * c + b
+  )JIT");
+  auto graph = cu->get_function("foo").graph();
+  auto a = at::randn({2, 3});
+  auto b = at::randn({2, 3});
+  auto c = a * b;
+  auto expected = (c + a) * c + b;
+
+  auto count = [](const Code& code, OpCode op) {
+    const auto& instructions = code.instructions();
+    return std::count_if(
+        instructions.begin(), instructions.end(), [&](const Instruction& i) {
+          return i.op == op;
+        });
+  };
+  for (bool emit_register_ops : {true, false}) {
+    Code code(graph, "", 0, emit_register_ops);
+    // c is used twice, so it lives in a register
+    ASSERT_EQ(count(code, OPR) > 0, emit_register_ops);
+    ASSERT_EQ(count(code, STORE) > 0, !emit_register_ops);
+    InterpreterState interp(code);
+    Stack stack{a, b};
+    interp.run(stack);
+    ASSERT_TRUE(stack.at(0).toTensor().allclose(expected));
+  }
+}
+
 void testProto() {
   ::ONNX_NAMESPACE::ModelProto proto;
   proto.set_producer_name("foo");
@@ -1075,10 +1108,15 @@ void testRecordFunction() {
     std::thread t_child([state]() {
       ThreadLocalStateGuard g_tls(state);
       RECORD_USER_SCOPE("test_in_thread");
+      // the callbacks are shared with the parent thread, adding one here
+      // leaves the parent's unchanged
+      addThreadLocalCallback(RecordFunctionCallback(
+          [](const RecordFunction&) {}, [](const RecordFunction&) {}));
     });
     t_child.join();
     TORCH_CHECK(recorded_op == "test_in_thread");
     removeCallback(handle);
+    TORCH_CHECK(!hasThreadLocalCallbacks());
   });
   t.join();
   clearCallbacks();
@@ -121,5 +121,60 @@ void testTypeTags() {
   }
 }
 
+void testPickleTensorViews() {
+  auto base = torch::arange(24, torch::kFloat).reshape({4, 6});
+  auto view = base.slice(/*dim=*/1, /*start=*/2, /*end=*/5);
+  auto param = torch::ones({3}, torch::requires_grad());
+  auto tuple = c10::ivalue::Tuple::create({base, view, param});
+
+  auto loaded = torch::pickle_load(torch::pickle_save(tuple)).toTuple();
+  const auto& elements = loaded->elements();
+  auto loaded_base = elements.at(0).toTensor();
+  auto loaded_view = elements.at(1).toTensor();
+  auto loaded_param = elements.at(2).toTensor();
+  ASSERT_TRUE(loaded_base.equal(base));
+  ASSERT_TRUE(loaded_view.equal(view));
+  ASSERT_TRUE(loaded_param.equal(param));
+  // The views share the storage of their base
+  ASSERT_EQ(
+      loaded_view.storage().data_ptr().get(),
+      loaded_base.storage().data_ptr().get());
+  ASSERT_EQ(loaded_view.storage_offset(), view.storage_offset());
+  ASSERT_EQ(loaded_view.strides(), view.strides());
+  ASSERT_FALSE(loaded_view.requires_grad());
+  ASSERT_TRUE(loaded_param.requires_grad());
+}
+
+void testLazyMethodCompilation() {
+  const auto script = R"JIT(
+    def double(self, x):
+        return x + x
+
+    def forward(self, x):
+        return self.double(x) * 3
+  )JIT";
+
+  Module m("__torch__.m");
+  m.define(script);
+  std::stringstream ss;
+  m.save(ss);
+
+  auto old_lazy = lazyMethodCompilationEnabled();
+  setLazyMethodCompilationEnabled(true);
+  c10::optional<Module> loaded;
+  {
+    // The methods are compiled after the archive is gone
+    std::istringstream iss(ss.str());
+    loaded = torch::jit::load(iss);
+  }
+  setLazyMethodCompilationEnabled(old_lazy);
+
+  auto x = torch::ones({2, 2});
+  auto out = loaded->forward({x}).toTensor();
+  ASSERT_TRUE(out.equal(x * 6));
+  auto& fn = loaded->get_method("double").function();
+  ASSERT_EQ(fn.getSchema().name(), "double");
+}
+
 } // namespace jit
 } // namespace torch
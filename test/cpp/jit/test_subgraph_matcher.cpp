@@ -479,6 +479,61 @@ graph(%a, %b):
   }
 }
 
+void testIndexedMatches() {
+  Graph graph;
+  parseIR(
+      R"IR(
+graph(%a, %b, %c):
+  %d = aten::mul(%a, %b)
+  %e = aten::relu(%d)
+  %x = prim::If(%c)
+    block0():
+      %x1 = aten::mul(%a, %e)
+      %x2 = aten::relu(%x1)
+      -> (%x2)
+    block1():
+      %x3 = aten::add(%b, %e)
+      -> (%x3)
+  return (%x))IR",
+      &graph);
+  const NodesByKind nodes_by_kind = indexNodesByKind(graph);
+
+  // Matching with the index finds the same matches, in the same order
+  for (const char* pattern_str : {
+           R"IR(
+graph(%x, %y):
+  %z = aten::mul(%x, %y)
+  %r = aten::relu(%z)
+  return (%r))IR",
+           R"IR(
+graph(%x, %y):
+  %z = aten::add(%x, %y)
+  return (%z))IR",
+           R"IR(
+graph(%x, %y):
+  %z = aten::sub(%x, %y)
+  return (%z))IR"}) {
+    Graph pattern;
+    parseIR(pattern_str, &pattern);
+    auto matches = findPatternMatches(pattern, graph);
+    auto indexed_matches = findPatternMatches(pattern, graph, nodes_by_kind);
+    ASSERT_EQ(matches.size(), indexed_matches.size());
+    for (size_t i = 0; i < matches.size(); i++) {
+      ASSERT_EQ(matches[i].anchor, indexed_matches[i].anchor);
+      ASSERT_EQ(matches[i].nodes_map, indexed_matches[i].nodes_map);
+    }
+  }
+  Graph pattern;
+  parseIR(
+      R"IR(
+graph(%x, %y):
+  %z = aten::mul(%x, %y)
+  %r = aten::relu(%z)
+  return (%r))IR",
+      &pattern);
+  ASSERT_EQ(findPatternMatches(pattern, graph, nodes_by_kind).size(), 2);
+}
+
 void testBadPattern() {
   Graph graph, pattern1, pattern2;
   parseIR(
@@ -524,6 +579,7 @@ void testSubgraphMatching() {
   testMatchInBasicBlocks1();
   testMatchInBasicBlocks2();
   testMatchesAttributes();
+  testIndexedMatches();
   testBadPattern();
 }
 
@@ -16,6 +16,7 @@ namespace jit {
   _(CallStackCaching)                  \
   _(CodeTemplate)                      \
   _(ControlFlow)                       \
+  _(RegisterOps)                       \
   _(CreateAutodiffSubgraphs)           \
   _(CustomOperators)                   \
   _(CustomOperatorAliasing)            \
@@ -24,11 +25,13 @@ namespace jit {
   _(SchemaMatching)                    \
   _(Differentiate)                     \
   _(DifferentiateWithRequiresGrad)     \
+  _(DifferentiateWithRecompute)        \
   _(FromQualString)                    \
   _(InternedStrings)                   \
   _(PassManagement)                    \
   _(Proto)                             \
   _(RegisterFusionCachesKernel)        \
+  _(FuserDiskCache)                    \
   _(SchemaParser)                      \
   _(TopologicalIndex)                  \
   _(TopologicalMove)                   \
@@ -69,6 +72,8 @@ namespace jit {
   _(ExtraFilesHookPreference)          \
   _(SaveExtraFilesHook)                \
   _(TypeTags)                          \
+  _(PickleTensorViews)                 \
+  _(LazyMethodCompilation)             \
   _(DCE)                               \
   _(CustomFusionNestedBlocks)          \
   _(ClassDerive)                       \
@@ -95,6 +100,10 @@ namespace jit {
   _(LiteInterpreterSetState)           \
   _(TorchbindIValueAPI)                \
   _(LiteInterpreterDict)               \
+  _(LiteInterpreterStackSize)          \
+  _(LiteInterpreterSharedOperators)    \
+  _(LiteInterpreterLoadMmapped)        \
+  _(LiteInterpreterOpObserver)         \
   _(FusionAliasing)
 
 #if defined(USE_CUDA)
@@ -105,5 +105,182 @@ void testKernel_3() {
   }
 }
 
+void testKernelSumAndMean() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Float(5:32,32:1, device=cpu)):
+        %1 : int[] = prim::Constant[value=[1]]()
+        %2 : bool = prim::Constant[value=1]()
+        %3 : None = prim::Constant()
+        %4 : Float(5:1,1:1) = aten::sum(%0, %1, %2, %3)
+        %5 : Float(5:32,32:1) = aten::mul(%0, %4)
+        %6 : int[] = prim::Constant[value=[0]]()
+        %7 : bool = prim::Constant[value=0]()
+        %8 : Float(32:1) = aten::mean(%5, %6, %7, %3)
+        return (%8))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto a = at::rand({5, 32}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto ref = (a * a.sum({1}, true)).mean({0});
+  TensorExprKernel k(graph);
+  std::vector<at::Tensor> inputs = {a};
+  std::vector<IValue> stack = fmap<IValue>(inputs);
+  k.run(stack);
+  auto o = stack[0].toTensor();
+  ASSERT_TRUE(at::allclose(o, ref, 1e-5, 1e-5));
+}
+
+void testKernelSoftmax() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Float(5:32,32:1, device=cpu),
+            %1 : Float(32:1, device=cpu)):
+        %2 : int = prim::Constant[value=1]()
+        %3 : int = prim::Constant[value=-1]()
+        %4 : int = prim::Constant[value=0]()
+        %5 : None = prim::Constant()
+        %6 : Float(5:32,32:1) = aten::add(%0, %1, %2)
+        %7 : Float(5:32,32:1) = aten::softmax(%6, %3, %5)
+        %8 : Float(5:32,32:1) = aten::log_softmax(%6, %4, %5)
+        %9 : Float(5:32,32:1) = aten::add(%7, %8, %2)
+        return (%9))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto a = at::randn({5, 32}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto b = at::randn({32}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto ref = at::softmax(a + b, -1) + at::log_softmax(a + b, 0);
+  TensorExprKernel k(graph);
+  std::vector<at::Tensor> inputs = {a, b};
+  std::vector<IValue> stack = fmap<IValue>(inputs);
+  k.run(stack);
+  auto o = stack[0].toTensor();
+  ASSERT_TRUE(at::allclose(o, ref, 1e-5, 1e-5));
+}
+
+void testKernelLayerNorm() {
+  KernelScope kernel_scope;
+
+  // bias + layer_norm + gelu, as in the feed forward layers of transformers
+  const auto graph_string = R"IR(
+      graph(%0 : Float(4:64,64:1, device=cpu),
+            %1 : Float(64:1, device=cpu),
+            %2 : Float(64:1, device=cpu),
+            %3 : Float(64:1, device=cpu)):
+        %4 : int = prim::Constant[value=1]()
+        %5 : int[] = prim::Constant[value=[64]]()
+        %6 : float = prim::Constant[value=1.0000000000000001e-05]()
+        %7 : bool = prim::Constant[value=0]()
+        %8 : Float(4:64,64:1) = aten::add(%0, %1, %4)
+        %9 : Float(4:64,64:1) = aten::layer_norm(%8, %5, %2, %3, %6, %7)
+        %10 : Float(4:64,64:1) = aten::gelu(%9)
+        return (%10))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto x = at::randn({4, 64}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto bias = at::randn({64}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto weight = at::randn({64}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto norm_bias = at::randn({64}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto ref = at::gelu(at::layer_norm(x + bias, {64}, weight, norm_bias));
+  TensorExprKernel k(graph);
+  std::vector<at::Tensor> inputs = {x, bias, weight, norm_bias};
+  std::vector<IValue> stack = fmap<IValue>(inputs);
+  k.run(stack);
+  auto o = stack[0].toTensor();
+  ASSERT_TRUE(at::allclose(o, ref, 1e-4, 1e-4));
+}
+
+void testKernelSymbolicShapes() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Tensor,
+            %1 : Tensor,
+            %2 : Float(8:1, device=cpu)):
+        %3 : int = prim::Constant[value=1]()
+        %4 : int = prim::Constant[value=0]()
+        %5 : None = prim::Constant()
+        %6 : Tensor = aten::mul(%0, %1)
+        %7 : Tensor = aten::add(%6, %2, %3)
+        %8 : Tensor = aten::softmax(%7, %4, %5)
+        return (%8))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  // The first dim varied across the profiled runs, the strides of the inputs
+  // are passed at runtime
+  auto symbolicType = TensorType::create(
+      at::kFloat,
+      at::kCPU,
+      c10::SymbolicShape(std::vector<c10::ShapeSymbol>(
+          {c10::ShapeSymbol::newSymbol(),
+           c10::ShapeSymbol::fromStaticSize(8)})),
+      c10::VaryingShape<c10::Stride>(2),
+      false);
+  for (Value* v : {graph->inputs()[0], graph->inputs()[1]}) {
+    v->setType(symbolicType);
+  }
+  for (Node* n : graph->nodes()) {
+    if (n->kind() != prim::Constant) {
+      n->output()->setType(symbolicType);
+    }
+  }
+
+  TensorExprKernel k(graph);
+  auto check = [&](const at::Tensor& a, const at::Tensor& b) {
+    auto bias = at::rand({8}, TensorOptions(kCPU).dtype(at::kFloat));
+    auto ref = at::softmax(a * b + bias, 0);
+    std::vector<IValue> stack = {a, b, bias};
+    k.run(stack);
+    auto o = stack[0].toTensor();
+    ASSERT_EQ(o.sizes(), ref.sizes());
+    ASSERT_TRUE(at::allclose(o, ref, 1e-5, 1e-5));
+  };
+  // The same kernel runs for all the sizes of the symbolic dim
+  check(
+      at::rand({4, 8}, TensorOptions(kCPU).dtype(at::kFloat)),
+      at::rand({4, 8}, TensorOptions(kCPU).dtype(at::kFloat)));
+  check(
+      at::rand({37, 8}, TensorOptions(kCPU).dtype(at::kFloat)),
+      at::rand({37, 8}, TensorOptions(kCPU).dtype(at::kFloat)));
+  check(
+      at::rand({8, 5}, TensorOptions(kCPU).dtype(at::kFloat)).transpose(0, 1),
+      at::rand({5, 8}, TensorOptions(kCPU).dtype(at::kFloat)));
+  // Inputs disagreeing on the size of the symbol run the graph as is
+  check(
+      at::rand({3, 8}, TensorOptions(kCPU).dtype(at::kFloat)),
+      at::rand({1, 8}, TensorOptions(kCPU).dtype(at::kFloat)));
+}
+
+void testKernelAsyncCompilation() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Float(5:3,3:1, device=cpu),
+            %1 : Float(5:3,3:1, device=cpu)):
+        %2 : Float(5:3,3:1) = aten::mul(%0, %1)
+        %3 : Float(5:3,3:1) = aten::add(%2, %0, %1)
+        return (%3))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto a = at::rand({5, 3}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto b = at::rand({5, 3}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto ref = a * b + a * b;
+  // The first runs go through the interpreter, the next ones through the
+  // kernel once it is compiled
+  TensorExprKernel k(graph, /*compileAsync=*/true);
+  for (int r = 0; r < 100; r++) {
+    std::vector<IValue> stack = fmap<IValue>(std::vector<at::Tensor>{a, b});
+    k.run(stack);
+    auto o = stack[0].toTensor();
+    ASSERT_TRUE(at::allclose(o, ref));
+  }
+}
+
 } // namespace jit
 } // namespace torch
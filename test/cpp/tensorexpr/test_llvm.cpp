@@ -3,6 +3,7 @@
 
 #include "test/cpp/tensorexpr/padded_buffer.h"
 #include "test/cpp/tensorexpr/test_utils.h"
+#include "torch/csrc/jit/codegen/fuser/disk_cache.h"
 #include "torch/csrc/jit/tensorexpr/buffer.h"
 #include "torch/csrc/jit/tensorexpr/eval.h"
 #include "torch/csrc/jit/tensorexpr/function.h"
@@ -15,6 +16,12 @@
 
 #include <numeric>
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
 namespace torch {
 namespace jit {
 using namespace torch::jit::tensorexpr;
@@ -1383,6 +1390,113 @@ void testLLVMRFactorVectorizedReduction() {
   ExpectAllNear(b_v, b_ref, 1e-5);
 }
 
+void testLLVMObjectCache() {
+#ifndef _WIN32
+  char cache_dir[] = "/tmp/te_llvm_cache_XXXXXX";
+  ASSERT_NE(mkdtemp(cache_dir), nullptr);
+  std::string old_cache_dir = fuser::diskCacheDir();
+  fuser::diskCacheDir() = cache_dir;
+
+  // The entries of the cache, or all its files
+  auto cachedFiles = [&](bool entries_only) {
+    std::vector<std::string> files;
+    DIR* dir = opendir(cache_dir);
+    while (dirent* entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      const std::string suffix = ".kernel";
+      bool is_entry = name.size() > suffix.size() &&
+          name.compare(name.size() - suffix.size(), suffix.size(), suffix) ==
+              0;
+      if (name != "." && name != ".." && (is_entry || !entries_only)) {
+        files.push_back(std::string(cache_dir) + "/" + name);
+      }
+    }
+    closedir(dir);
+    return files;
+  };
+
+  const int N = 1024;
+  std::vector<float> a_vec(N);
+  std::iota(a_vec.begin(), a_vec.end(), 0.0f);
+  // The second kernel is loaded from the object written by the first one
+  for (int i = 0; i < 2; i++) {
+    KernelScope kernel_scope;
+    Buffer a(BufHandle("a", {N}, kFloat));
+    Tensor* b = Compute("b", {{N, "i"}}, [&](const VarHandle& i) {
+      return sin(Load::make(a, {i}, 1)) + 1.0f;
+    });
+    Buffer b_buf(BufHandle(b->func_var()));
+    LoopNest l({b});
+    LLVMCodeGen cg(l.root_stmt(), {a, b_buf});
+
+    std::vector<float> b_vec(N, 0.0f);
+    std::vector<void*> args({a_vec.data(), b_vec.data()});
+    ASSERT_EQ(cg.value<int>(args), 0);
+    for (int j = 0; j < N; j++) {
+      ASSERT_NEAR(b_vec[j], std::sin(a_vec[j]) + 1.0f, 1e-5);
+    }
+    ASSERT_EQ(cachedFiles(/*entries_only=*/true).size(), 1);
+  }
+
+  for (const auto& file : cachedFiles(/*entries_only=*/false)) {
+    unlink(file.c_str());
+  }
+  rmdir(cache_dir);
+  fuser::diskCacheDir() = old_cache_dir;
+#endif
+}
+
+void testLLVMParallelFor() {
+  KernelScope kernel_scope;
+  const int M = 64;
+  const int N = 32;
+  Buffer a(BufHandle("a", {M, N}, kFloat));
+  Buffer b(BufHandle("b", {N}, kFloat));
+  Tensor* c = Compute(
+      "c", {{M, "m"}, {N, "n"}}, [&](const VarHandle& m, const VarHandle& n) {
+        return a(m, n) + b(n) * cast<float>(m);
+      });
+  Tensor* d = Reduce(
+      "d",
+      {{M, "m"}},
+      Sum(),
+      [&](const VarHandle& m, const VarHandle& n) { return c->call(m, n); },
+      {{N, "n"}});
+  LoopNest l({c, d});
+  l.setParallel(l.getLoopStmtsFor(c)[0]);
+  l.setParallel(l.getLoopStmtsFor(d)[0]);
+  l.prepareForCodegen();
+  Stmt* s = IRSimplifier::simplify(l.root_stmt());
+
+  std::ostringstream oss;
+  oss << *s;
+  ASSERT_NE(oss.str().find("/* parallel */"), std::string::npos);
+
+  Buffer c_buf(BufHandle(c->func_var()));
+  Buffer d_buf(BufHandle(d->func_var()));
+  LLVMCodeGen cg(s, {a, b, c_buf, d_buf});
+
+  PaddedBuffer<float> a_v(M, N, "a_v");
+  PaddedBuffer<float> b_v(N, "b_v");
+  PaddedBuffer<float> c_v(M, N, "c_v");
+  PaddedBuffer<float> d_v(M, "d_v");
+  PaddedBuffer<float> c_ref(M, N, "c_ref");
+  PaddedBuffer<float> d_ref(M, "d_ref");
+  for (int m = 0; m < M; m++) {
+    d_ref(m) = 0;
+    for (int n = 0; n < N; n++) {
+      a_v(m, n) = m * n;
+      b_v(n) = n;
+      c_ref(m, n) = a_v(m, n) + b_v(n) * m;
+      d_ref(m) += c_ref(m, n);
+    }
+  }
+
+  cg.call({a_v, b_v, c_v, d_v});
+  ExpectAllNear(c_v, c_ref, 1e-5);
+  ExpectAllNear(d_v, d_ref, 1e-5);
+}
+
 } // namespace jit
 } // namespace torch
 
@@ -62,5 +62,32 @@ void testFuserPass_2() {
       ->run(*g);
 }
 
+void testFuserPass_Reductions() {
+  KernelScope kernel_scope;
+  const auto graph_string = R"IR(
+    graph(%0 : Float(4:64,64:1, device=cpu),
+          %1 : Float(64:1, device=cpu)):
+      %2 : int = prim::Constant[value=1]()
+      %3 : int[] = prim::Constant[value=[64]]()
+      %4 : None = prim::Constant()
+      %5 : float = prim::Constant[value=1.0000000000000001e-05]()
+      %6 : bool = prim::Constant[value=0]()
+      %7 : Float(4:64,64:1, device=cpu) = aten::add(%0, %1, %2)
+      %8 : Float(4:64,64:1, device=cpu) = aten::layer_norm(%7, %3, %4, %4, %5, %6)
+      %9 : Float(4:64,64:1, device=cpu) = aten::gelu(%8)
+      return (%9))IR";
+  auto g = std::make_shared<Graph>();
+  torch::jit::parseIR(graph_string, g.get());
+
+  g->lint();
+  FuseTensorExprs(g);
+
+  // The pointwise ops around the reduction go in the same group.
+  testing::FileCheck()
+      .check("tensorexpr::Group_0")
+      ->check_next("return")
+      ->run(*g);
+}
+
 } // namespace jit
 } // namespace torch
@@ -191,8 +191,14 @@ namespace jit {
   _(Kernel_1)                               \
   _(Kernel_2)                               \
   _(Kernel_3)                               \
+  _(KernelSumAndMean)                       \
+  _(KernelSoftmax)                          \
+  _(KernelLayerNorm)                        \
+  _(KernelSymbolicShapes)                   \
+  _(KernelAsyncCompilation)                 \
   _(FuserPass_1)                            \
-  _(FuserPass_2)
+  _(FuserPass_2)                            \
+  _(FuserPass_Reductions)
 
 #define TH_FORALL_TENSOREXPR_TESTS_LLVM(_) \
   _(LLVMByteImmTest)                       \
@@ -316,7 +322,9 @@ namespace jit {
   _(LLVMVectorizerLoadStoreTest)           \
   _(LLVMSimpleReduction)                   \
   _(LLVMRFactorReduction)                  \
-  _(LLVMRFactorVectorizedReduction)
+  _(LLVMRFactorVectorizedReduction)        \
+  _(LLVMObjectCache)                       \
+  _(LLVMParallelFor)
 
 #define TH_FORALL_TENSOREXPR_TESTS_CUDA(_) \
   _(CudaTestVectorAdd01)                   \
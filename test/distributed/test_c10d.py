@@ -43,6 +43,8 @@ if not c10d.is_available():
     print('c10d not available, skipping tests')
     sys.exit(0)
 
+from torch.distributed.nn import ShardedEmbeddingBag
+
 
 if platform == 'darwin':
     LOOPBACK = 'lo0'
@@ -215,6 +217,30 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.multi_set(["key0", "key1", "key2"], ["value0", "value1", "value2"])
+        fs.set("key3", "value3")
+        self.assertEqual(
+            [b"value2", b"value3", b"value0"],
+            fs.multi_get(["key2", "key3", "key0"]))
+        self.assertEqual([], fs.multi_get([]))
+        with self.assertRaises(ValueError):
+            fs.multi_set(["key4"], [])
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
+    def _test_compare_set(self, fs):
+        # A missing key is only set if the expected value is empty
+        self.assertEqual(b"expected", fs.compare_set("key", "expected", "value0"))
+        self.assertEqual(b"value0", fs.compare_set("key", "", "value0"))
+        self.assertEqual(b"value0", fs.compare_set("key", "wrong", "value1"))
+        self.assertEqual(b"value1", fs.compare_set("key", "value0", "value1"))
+        self.assertEqual(b"value1", fs.get("key"))
+
+    def test_compare_set(self):
+        self._test_compare_set(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -799,6 +825,55 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
     def test_allreduce_basics_cuda(self):
         self._test_allreduce_basics(lambda t: t.clone().cuda())
 
+    @skip_if_not_multigpu
+    def test_allreduce_chunked_cuda(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Large enough to be staged through the host in several chunks, with
+        # more chunks than staging buffers.
+        numel = 5 * 1024 * 1024 + 3
+        for _ in range(2):
+            tensor = torch.full((numel,), float(self.rank + 1)).cuda()
+            pg.allreduce(tensor).wait()
+            self.assertEqual(
+                torch.full((numel,), float(self.world_size * (self.world_size + 1) / 2)),
+                tensor.cpu(),
+            )
+
+        # Non-contiguous tensors are staged in one piece
+        tensor = torch.full((4, 6), float(self.rank + 1)).cuda().t()
+        pg.allreduce(tensor).wait()
+        self.assertEqual(
+            torch.full((6, 4), float(self.world_size * (self.world_size + 1) / 2)),
+            tensor.cpu(),
+        )
+
+    def test_allreduce_autotune(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        opts = self.opts(threads=8)
+        opts.allreduce_algorithm = c10d.ProcessGroupGloo.AllreduceAlgorithm.AUTOTUNE
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, opts)
+
+        # Several allreduces of the same size are in flight while the first
+        # one benchmarks the algorithms.
+        numels = [1, 1000, 1000, 1000, 100000, 1]
+        tensors = [torch.full((n,), float(self.rank + 1)) for n in numels]
+        work = [pg.allreduce(t) for t in tensors]
+        for w in work:
+            w.wait()
+        expected = float(self.world_size * (self.world_size + 1) / 2)
+        for t in tensors:
+            self.assertEqual(torch.full_like(t, expected), t)
+
+        tuned = pg._get_tuned_allreduce_algorithms()
+        self.assertEqual([4, 4096, 524288], sorted(tuned.keys()))
+        for algorithm in tuned.values():
+            self.assertIn(algorithm, [
+                c10d.ProcessGroupGloo.AllreduceAlgorithm.RING,
+                c10d.ProcessGroupGloo.AllreduceAlgorithm.BCUBE,
+            ])
+
     def _test_allreduce_stress(self, inputs):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts(threads=8))
@@ -1554,6 +1629,100 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
                 self.assertEqual(torch.full([10, 10], float(self.world_size)), tensor)
             del pg
 
+    def test_allgather_base(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        input = torch.full([2, 3], float(self.rank))
+        output = torch.zeros(self.world_size * 6)
+        pg._allgather_base(output, input).wait()
+        expected = torch.arange(self.world_size).float().repeat_interleave(6)
+        self.assertEqual(expected, output)
+
+        with self.assertRaisesRegex(ValueError, "world size times the elements"):
+            pg._allgather_base(torch.zeros(5), input)
+
+    def test_reduce_scatter(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Rank r sends r + i to rank i
+        inputs = [
+            torch.full([2, 2], float(self.rank + i)) for i in range(self.world_size)
+        ]
+        output = torch.zeros(2, 2)
+        pg.reduce_scatter([output], [inputs]).wait()
+        expected = sum(r + self.rank for r in range(self.world_size))
+        self.assertEqual(torch.full([2, 2], float(expected)), output)
+
+        with self.assertRaisesRegex(ValueError, "one tensor per rank"):
+            pg.reduce_scatter([output], [inputs[:1]])
+
+    def test_zero_redundancy_optimizer(self):
+        from torch.distributed.optim import ZeroRedundancyOptimizer
+
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        torch.manual_seed(0)
+        model = nn.Sequential(nn.Linear(5, 7), nn.ReLU(), nn.Linear(7, 3))
+        reference = copy.deepcopy(model)
+        # Small buckets, so that there are several of them, with padding
+        optimizer = ZeroRedundancyOptimizer(
+            model.parameters(), torch.optim.Adam, group=pg,
+            bucket_cap_mb=40 * 4 / (1024 * 1024), lr=0.1)
+        reference_optimizer = torch.optim.Adam(reference.parameters(), lr=0.1)
+
+        # Only a shard of the Adam state is kept on every rank
+        numel = sum(p.numel() for p in model.parameters())
+        shard_numel = sum(p.numel() for p in optimizer.param_groups[0]["params"])
+        self.assertLess(shard_numel, numel)
+
+        for step in range(3):
+            inputs = [torch.randn(4, 5) for _ in range(self.world_size)]
+            optimizer.zero_grad()
+            model(inputs[self.rank]).sum().backward()
+            optimizer.step()
+
+            # The reference sees the average gradient of all the ranks
+            reference_optimizer.zero_grad()
+            reference(torch.cat(inputs)).sum().div(self.world_size).backward()
+            reference_optimizer.step()
+
+            for p, q in zip(model.parameters(), reference.parameters()):
+                self.assertEqual(p, q)
+
+    def test_hierarchical_allreduce(self):
+        # Two "nodes" of world_size / 2 processes each
+        store = c10d.FileStore(self.file_name, self.world_size)
+        local_size = self.world_size // 2
+        node, local_rank = divmod(self.rank, local_size)
+        intra_node_group = c10d.ProcessGroupGloo(
+            c10d.PrefixStore("intra/%d" % node, store), local_rank, local_size)
+        inter_node_group = c10d.ProcessGroupGloo(
+            c10d.PrefixStore("inter/%d" % local_rank, store), node, 2)
+        global_group = c10d.ProcessGroupGloo(
+            c10d.PrefixStore("global", store), self.rank, self.world_size)
+        expected = float(sum(range(1, self.world_size + 1)))
+        for intra_node_reduce_scatter in [False, True]:
+            pg = c10d._hierarchical_process_group(
+                intra_node_group, inter_node_group, global_group,
+                intra_node_reduce_scatter=intra_node_reduce_scatter)
+
+            # Sizes that are and aren't a multiple of the number of processes
+            # per node, and a non contiguous tensor.
+            for tensor in [
+                torch.full([4 * local_size], float(self.rank + 1)),
+                torch.full([5, 3], float(self.rank + 1)),
+                torch.full([3, 5], float(self.rank + 1)).t(),
+            ]:
+                pg.allreduce(tensor).wait()
+                self.assertEqual(torch.full(tensor.size(), expected), tensor)
+
+        tensor = torch.full([10], float(self.rank))
+        pg.broadcast(tensor, root=0).wait()
+        self.assertEqual(torch.zeros(10), tensor)
+
 
 @requires_nccl()
 class ProcessGroupNCCLTest(TestCase):
@@ -1722,6 +1891,57 @@ class ProcessGroupNCCLTest(TestCase):
             for s_idx, t in enumerate(device_ts):
                 self.assertEqual(torch.tensor([s_idx]), t)
 
+    def test_allreduce_coalesced_ops(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        # Tensors of different types and shapes, more than fit in one group
+        tensors = [
+            torch.full((i % 5 + 1,), i, dtype=torch.float if i % 2 else torch.long).cuda(0)
+            for i in range(3000)
+        ]
+        expected = [t.clone() * self.world_size for t in tensors]
+        opts = c10d.AllreduceCoalescedOptions()
+        opts.reduceOp = c10d.ReduceOp.SUM
+        pg.allreduce_coalesced(tensors, opts).wait()
+        self.assertEqual(expected, tensors)
+
+        with self.assertRaisesRegex(RuntimeError, "same GPU device"):
+            pg.allreduce_coalesced([torch.ones(1).cuda(0), torch.ones(1).cuda(1)])
+
+    def test_broadcast_coalesced_ops(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        tensors = [torch.full((i + 1, 2), i).cuda(1) for i in range(10)]
+        # A non-contiguous, but dense, tensor
+        tensors.append(torch.arange(6).view(2, 3).t().cuda(1))
+        expected = [t.clone() for t in tensors]
+        opts = c10d.BroadcastOptions()
+        opts.rootRank = self.rank
+        pg.broadcast_coalesced(tensors, opts).wait()
+        self.assertEqual(expected, tensors)
+
+        # Goes through ProcessGroupNCCL::broadcast_coalesced
+        c10d._broadcast_coalesced(pg, tensors, 256)
+        self.assertEqual(expected, tensors)
+
+    def test_allgather_coalesced_ops(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        inputs = [torch.full((i + 1,), i).cuda(0) for i in range(10)]
+        inputs.append(torch.arange(6).view(2, 3).t().cuda(0))
+        outputs = [
+            [torch.zeros_like(t) for t in inputs] for _ in range(self.world_size)
+        ]
+        pg.allgather_coalesced(outputs, inputs).wait()
+        for output_list in outputs:
+            self.assertEqual(inputs, output_list)
+
+        with self.assertRaisesRegex(RuntimeError, "one output per input"):
+            pg.allgather_coalesced([inputs[:1]] * self.world_size, inputs)
+
     def test_reduce_scatter_ops(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
@@ -3156,6 +3376,35 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         with self.assertRaisesRegex(RuntimeError, "register_comm_hook can only be called once."):
             model._register_comm_hook(None, dummy_hook)
 
+    @requires_gloo()
+    def test_ddp_builtin_comm_hooks_cpu(self):
+        """
+        The gradients of TestDdpCommHook are a rank 1 matrix of 0.25 on every
+        rank, which all the built-in hooks reduce exactly.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        for comm_hook_type in [
+            dist.BuiltinCommHookType.FP16_COMPRESS,
+            dist.BuiltinCommHookType.BF16_COMPRESS,
+            dist.BuiltinCommHookType.POWER_SGD,
+            dist.BuiltinCommHookType.TOP_K,
+        ]:
+            model = DistributedDataParallel(
+                TestDdpCommHook(),
+                process_group=process_group
+            )
+            model._register_builtin_comm_hook(comm_hook_type, compress_ratio=1.0)
+
+            # Run twice, so that the error feedback is used
+            for _ in range(2):
+                model.zero_grad()
+                output = model(8, self.rank)
+                output.mean().backward()
+                for p in model.parameters():
+                    self.assertEqual(p.grad, 0.25 * torch.ones(2, 2))
+
 
 class ReducerModule(nn.Module):
     def __init__(self):
@@ -3211,14 +3460,15 @@ class ReducerTest(TestCase):
         buckets = [list(indices) for _, indices in group_by_dtype]
         dist.Reducer(parameters, buckets, self.process_group)
 
-    def _create_reducer_for_models(self, models, find_unused_parameters=False):
+    def _create_reducer_for_models(self, models, find_unused_parameters=False, gradient_as_bucket_view=False):
         parameters = [list(model.parameters()) for model in models]
         group_by_dtype = groupby(
             range(len(parameters[0])),
             key=lambda i: parameters[0][i].dtype)
         buckets = [list(indices) for _, indices in group_by_dtype]
         return dist.Reducer(parameters, buckets, self.process_group,
-                            find_unused_parameters=find_unused_parameters)
+                            find_unused_parameters=find_unused_parameters,
+                            gradient_as_bucket_view=gradient_as_bucket_view)
 
     def test_forward_backward_single_replica(self):
         batch_size = 10
@@ -3271,6 +3521,41 @@ class ReducerTest(TestCase):
         # is considered being globally unused, it will be kept untouched as None.
         self.assertEqual(None, model.fc3.weight.grad)
 
+    def _create_single_dtype_reducer(self, find_unused_parameters):
+        model = ReducerModule()
+        parameters = list(model.parameters())
+        buckets = [list(range(len(parameters)))]
+        reducer = dist.Reducer([parameters], buckets, self.process_group,
+                               find_unused_parameters=find_unused_parameters)
+        return model, reducer
+
+    def test_rebuild_buckets_in_ready_order(self):
+        batch_size = 10
+        model, reducer = self._create_single_dtype_reducer(find_unused_parameters=False)
+        loss = nn.CrossEntropyLoss()
+        self.assertEqual([[0, 1, 2]], reducer._get_bucket_indices())
+        for _ in range(2):
+            input = torch.rand([batch_size, 2])
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            # The gradients are ready from the last layer to the first one.
+            self.assertEqual([[2, 1, 0]], reducer._get_bucket_indices())
+
+    def test_rebuild_buckets_unused_parameters(self):
+        batch_size = 10
+        model, reducer = self._create_single_dtype_reducer(find_unused_parameters=True)
+        loss = nn.CrossEntropyLoss()
+        input = torch.rand([batch_size, 2])
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        output = loss(model(input, use_fc3=False), target)
+        reducer.prepare_for_backward(output)
+        output.backward()
+        # fc3 is marked ready with the first gradient, the one of fc2.
+        self.assertEqual([[2, 1, 0]], reducer._get_bucket_indices())
+        self.assertEqual(None, model.fc3.weight.grad)
+
     def test_forward_backward_optimizer(self):
         batch_size = 10
         model = self._create_mixed_precision_model()
@@ -3292,6 +3577,79 @@ class ReducerTest(TestCase):
             output.backward()
             optimizer.step()
 
+    def test_bucket_finalized_hook(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        reference = copy.deepcopy(model)
+        reducer = self._create_reducer_for_models([model])
+        lr = 0.1
+        finalized = []
+
+        def sgd_step(bucket_index, params, grads):
+            finalized.append(bucket_index)
+            with torch.no_grad():
+                for p, g in zip(params, grads):
+                    p.add_(g, alpha=-lr)
+
+        reducer._register_bucket_finalized_hook(sgd_step)
+        with self.assertRaisesRegex(RuntimeError, "can only be called once"):
+            reducer._register_bucket_finalized_hook(sgd_step)
+
+        loss = nn.CrossEntropyLoss()
+        reference_optimizer = torch.optim.SGD(reference.parameters(), lr=lr)
+        input = torch.rand([batch_size, 2], dtype=torch.double)
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        num_buckets = len(reducer._get_bucket_indices())
+        output = loss(model(input), target)
+        reducer.prepare_for_backward(output)
+        output.backward()
+        reference_optimizer.zero_grad()
+        loss(reference(input), target).backward()
+        reference_optimizer.step()
+
+        # Every bucket is finalized once, in order, and the hook stepped the
+        # parameters like the optimizer.
+        self.assertEqual(list(range(num_buckets)), finalized)
+        for p, q in zip(model.parameters(), reference.parameters()):
+            self.assertEqual(p, q)
+
+    def test_forward_backward_gradient_as_bucket_view(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        reference = copy.deepcopy(model)
+        reducer = self._create_reducer_for_models(
+            [model], find_unused_parameters=True, gradient_as_bucket_view=True)
+        loss = nn.CrossEntropyLoss()
+        optimizer = torch.optim.SGD(model.parameters(), lr=0.1)
+        reference_optimizer = torch.optim.SGD(reference.parameters(), lr=0.1)
+
+        # The grads are views of the buckets right away.
+        for p in model.parameters():
+            self.assertEqual(torch.zeros_like(p), p.grad)
+            self.assertIsNotNone(p.grad._base)
+
+        for i in range(3):
+            input = torch.rand([batch_size, 2], dtype=torch.double)
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            # The first iteration resets a grad, which must be set to a view
+            # of its bucket again.
+            if i == 0:
+                model.fc2.weight.grad = None
+            # zero_grad zeroes the views in place.
+            optimizer.zero_grad()
+            reference_optimizer.zero_grad()
+
+            output = loss(model(input, use_fc3=(i > 0)), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            loss(reference(input, use_fc3=(i > 0)), target).backward()
+
+            for p, ref_p in zip(model.parameters(), reference.parameters()):
+                self.assertIsNotNone(p.grad._base)
+                self.assertEqual(ref_p.grad if ref_p.grad is not None else torch.zeros_like(p), p.grad)
+            optimizer.step()
+            reference_optimizer.step()
+
 
 class ComputeBucketAssignmentTest(TestCase):
     def test_single_limit_single_dtype(self):
@@ -3578,6 +3936,34 @@ class CommTest(MultiProcessTestCase):
         device = torch.device('cuda:%d' % self.rank)
         self._test_broadcast_coalesced(process_group, device)
 
+    @requires_nccl()
+    @skip_if_not_multigpu
+    def test_batch_send_recv_nccl(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+        device = torch.device('cuda:%d' % self.rank)
+        peer = 1 - self.rank
+        P2POp = c10d.ProcessGroupNCCL.P2POp
+
+        # Each rank sends and receives several tensors in one group, in the
+        # order of the sends of the other rank.
+        sizes = [7, 1, 30]
+        sent = [torch.full((size,), float(self.rank + i), device=device) for i, size in enumerate(sizes)]
+        received = [torch.empty(size, device=device) for size in sizes]
+        ops = [P2POp(True, tensor, peer) for tensor in sent]
+        ops += [P2POp(False, tensor, peer) for tensor in received]
+        process_group._batch_send_recv(ops).wait()
+        for i, size in enumerate(sizes):
+            self.assertEqual(received[i], torch.full((size,), float(peer + i), device=device))
+
+        # Single sends and receives, once the pair has its communicator.
+        tensor = torch.full((3,), self.rank + 10., device=device)
+        if self.rank == 0:
+            process_group.send([tensor], peer, 0).wait()
+        else:
+            process_group.recv([tensor], peer, 0).wait()
+            self.assertEqual(tensor, torch.full((3,), 10., device=device))
+
     @requires_gloo()
     @skip_if_not_multigpu
     def test_broadcast_coalesced_gloo_cuda(self):
@@ -3598,6 +3984,84 @@ class CommTest(MultiProcessTestCase):
         self._test_broadcast_coalesced(process_group, device)
 
 
+@requires_gloo()
+class ShardedEmbeddingBagTest(MultiProcessTestCase):
+    def setUp(self):
+        super(ShardedEmbeddingBagTest, self).setUp()
+        self._fork_processes()
+
+    def tearDown(self):
+        super(ShardedEmbeddingBagTest, self).tearDown()
+        try:
+            os.remove(self.file_name)
+        except OSError:
+            pass
+
+    @property
+    def world_size(self):
+        return 2
+
+    def _process_group(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        return c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+    def _batch(self, num_embeddings, rank):
+        # The same on all ranks, so every rank can compute the reference.
+        generator = torch.Generator().manual_seed(rank)
+        indices, offsets = [], []
+        for n in num_embeddings:
+            lengths = torch.randint(0, 4, (3 + rank,), generator=generator)
+            indices.append(torch.randint(0, n, (int(lengths.sum()),), generator=generator))
+            offsets.append(lengths.cumsum(0) - lengths)
+        return indices, offsets
+
+    def _test_sharded_embedding_bag(self, num_embeddings, embedding_dims, sharding_type, mode):
+        torch.manual_seed(0)
+        tables = [torch.randn(n, dim, requires_grad=True) for n, dim in zip(num_embeddings, embedding_dims)]
+        module = ShardedEmbeddingBag(
+            num_embeddings, embedding_dims, sharding_type, mode=mode, process_group=self._process_group())
+        with torch.no_grad():
+            for weight, (table, row_begin, num_rows, _) in zip(module.weight, module.local_shards):
+                weight.copy_(tables[table][row_begin:row_begin + num_rows])
+
+        # The reference runs the batches of all ranks on the full tables.
+        for rank in range(self.world_size):
+            indices, offsets = self._batch(num_embeddings, rank)
+            expected = torch.cat([
+                F.embedding_bag(i, table, o, mode=mode) for i, o, table in zip(indices, offsets, tables)], 1)
+            (expected * (rank + 1)).sum().backward()
+            if rank == self.rank:
+                output = module(indices, offsets)
+                self.assertEqual(output, expected)
+        (output * (self.rank + 1)).sum().backward()
+
+        for weight, (table, row_begin, num_rows, _) in zip(module.weight, module.local_shards):
+            self.assertEqual(weight.grad, tables[table].grad[row_begin:row_begin + num_rows])
+
+    def test_table_wise(self):
+        self._test_sharded_embedding_bag([10, 4, 7], [3, 5, 2], c10d.ShardingType.TABLE_WISE, 'sum')
+
+    def test_row_wise(self):
+        self._test_sharded_embedding_bag([10, 7], [3, 2], c10d.ShardingType.ROW_WISE, 'sum')
+
+    def test_table_wise_mean(self):
+        self._test_sharded_embedding_bag([10, 4], [3, 5], c10d.ShardingType.TABLE_WISE, 'mean')
+
+    def test_row_wise_mean(self):
+        self._test_sharded_embedding_bag([10, 7], [3, 2], c10d.ShardingType.ROW_WISE, 'mean')
+
+    def test_invalid_inputs(self):
+        process_group = self._process_group()
+        with self.assertRaisesRegex(RuntimeError, 'needs a table for every rank'):
+            ShardedEmbeddingBag([10], [3], process_group=process_group)
+        module = ShardedEmbeddingBag(
+            [10, 7], [3, 2], c10d.ShardingType.ROW_WISE, process_group=process_group)
+        indices, offsets = self._batch([10, 7], self.rank)
+        indices[1] = torch.cat([indices[1], torch.tensor([7])])
+        with self.assertRaisesRegex(RuntimeError, 'out of range'):
+            module(indices, offsets)
+
+
 if __name__ == '__main__':
     assert not torch.cuda._initialized, "test_distributed must not have initialized CUDA context on main process"
 
@@ -1025,3 +1025,50 @@ class TestFreezing(JitTestCase):
         fm = torch._C._freeze_module(m._c, ["modify_a"])
         FileCheck().check('prim::GetAttr[name="a"]').run(fm.forward.graph)
         FileCheck().check('prim::GetAttr[name="b"]').run(fm.modify_a.graph)
+
+    def test_freeze_module_channels_last(self):
+        class Module(nn.Module):
+            def __init__(self):
+                super(Module, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.bn = nn.BatchNorm2d(8)
+                self.conv2 = nn.Conv2d(8, 8, 3, padding=1)
+
+            def forward(self, x):
+                y = torch.relu(self.bn(self.conv1(x)))
+                y = self.conv2(y) + y
+                return torch.flatten(torch.max_pool2d(y, 2), 1)
+
+        m = torch.jit.script(Module().eval())
+        fm = torch._C._freeze_module(m._c)
+        torch._C._jit_pass_convert_frozen_ops_to_channels_last(fm)
+        # one conversion into the region and one out of it
+        FileCheck().check_count("aten::contiguous", 2, exactly=True) \
+                   .run(fm.forward.graph)
+        for node in fm.forward.graph.findAllNodes("aten::conv2d"):
+            weight = node.inputsAt(1).toIValue()
+            self.assertTrue(weight.is_contiguous(memory_format=torch.channels_last))
+
+        input = torch.randn(2, 3, 16, 16)
+        with torch.no_grad():
+            self.assertEqual(fm.forward(input), m.forward(input), atol=1e-4, rtol=1e-4)
+
+    def test_freeze_module_channels_last_outside_uses(self):
+        class Module(nn.Module):
+            def __init__(self):
+                super(Module, self).__init__()
+                self.conv = nn.Conv2d(3, 4, 1)
+
+            def forward(self, x):
+                y = self.conv(x)
+                return y.view(y.size(0), -1), y + x.sum()
+
+        m = torch.jit.script(Module().eval())
+        fm = torch._C._freeze_module(m._c)
+        torch._C._jit_pass_convert_frozen_ops_to_channels_last(fm)
+        # the view outside of the region sees a contiguous tensor
+        input = torch.randn(2, 3, 5, 5)
+        with torch.no_grad():
+            for out, ref in zip(fm.forward(input), m.forward(input)):
+                self.assertTrue(out.is_contiguous())
+                self.assertEqual(out, ref)
@@ -1,5 +1,6 @@
 import os
 import sys
+import unittest
 
 import torch
 
@@ -7,6 +8,7 @@ import torch
 pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
 sys.path.append(pytorch_test_dir)
 from torch.testing._internal.jit_utils import JitTestCase
+from torch.testing._internal.common_utils import GRAPH_EXECUTOR, ProfilingMode, num_profiled_runs
 
 if __name__ == '__main__':
     raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
@@ -111,3 +113,33 @@ class TestLogging(JitTestCase):
             self.assertEqual(logger.get_counter_val('foo'), 1)
         finally:
             torch.jit._logging.set_logger(old_logger)
+
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING, "skip if profiling isn't enabled")
+    def test_specialized_plan_cache(self):
+        @torch.jit.script
+        def foo(x):
+            return x * 2.0 + 1.0
+
+        counters = ['pytorch_runtime.specialized_plan_cache_' + c for c in ('hit', 'miss', 'full')]
+        small, large, larger = torch.rand(2, 3), torch.rand(4, 5), torch.rand(6, 7)
+        logger = torch.jit._logging.LockingLogger()
+        old_logger = torch.jit._logging.set_logger(logger)
+        old_num_specializations = torch._C._jit_set_num_specializations(2)
+        try:
+            with num_profiled_runs(1):
+                # each shape is profiled once, then gets a plan of its own
+                for x in (small, small, large, large):
+                    self.assertEqual(foo(x), x * 2.0 + 1.0)
+                self.assertEqual([logger.get_counter_val(c) for c in counters], [0, 2, 0])
+
+                # alternating between them reuses the plans
+                for x in (small, large, small, large):
+                    self.assertEqual(foo(x), x * 2.0 + 1.0)
+                self.assertEqual([logger.get_counter_val(c) for c in counters], [4, 2, 0])
+
+                # with the cache full, another shape runs the first plan
+                self.assertEqual(foo(larger), larger * 2.0 + 1.0)
+                self.assertEqual([logger.get_counter_val(c) for c in counters], [4, 2, 1])
+        finally:
+            torch._C._jit_set_num_specializations(old_num_specializations)
+            torch.jit._logging.set_logger(old_logger)
@@ -3,6 +3,7 @@ import torch
 import torch.utils.bundled_inputs
 
 import io
+import tempfile
 
 from torch.jit.mobile import _load_for_lite_interpreter
 
@@ -35,6 +36,26 @@ class TestLiteScriptModule(unittest.TestCase):
         torch.testing.assert_allclose(script_module_result, mobile_module_run_method_result)
 
 
+    def test_load_mobile_module_mmap(self):
+        class MyTestModule(torch.nn.Module):
+            def __init__(self):
+                super(MyTestModule, self).__init__()
+                self.weight = torch.nn.Parameter(torch.randn(4, 4))
+
+            def forward(self, x):
+                return torch.mm(x, self.weight)
+
+        input = torch.randn(2, 4)
+        script_module = torch.jit.script(MyTestModule())
+        with tempfile.NamedTemporaryFile() as f:
+            f.write(script_module._save_to_buffer_for_lite_interpreter())
+            f.flush()
+            mobile_module = _load_for_lite_interpreter(f.name, mmap=True)
+            torch.testing.assert_allclose(script_module(input), mobile_module(input))
+
+        with self.assertRaisesRegex(ValueError, "mmap requires a file name"):
+            _load_for_lite_interpreter(io.BytesIO(), mmap=True)
+
     def test_find_and_run_method(self):
         class MyTestModule(torch.nn.Module):
             def forward(self, arg):
@@ -1372,7 +1372,11 @@ class TestQuantizeJitOps(QuantizationTestCase):
                  torch.randn(1, 2, 5, 5, dtype=torch.float)]]
         for tracing in [True, False]:
             m = self.checkGraphModeOp(QuantizedAdd(), data, "quantized::add", tracing)
-            FileCheck().check_count("quantized::add", 3, exactly=True) \
+            # the first add takes the output of conv1 and only that, so it
+            # is fused with the conv
+            FileCheck().check_count("quantized::conv2d_add(", 1, exactly=True) \
+                       .run(m.graph)
+            FileCheck().check_count("quantized::add(", 2, exactly=True) \
                        .run(m.graph)
             FileCheck().check_not("aten::add") \
                        .check_not("aten::add_") \
@@ -1477,7 +1481,9 @@ class TestQuantizeJitOps(QuantizationTestCase):
                        AddInplaceFunctionalRelu(), InplaceAddInplaceFunctionalRelu()]:
             for tracing in [True, False]:
                 m = self.checkGraphModeOp(m_orig, data, "quantized::add_relu(", tracing=tracing)
-                FileCheck().check_count("quantized::add_relu(", 2, exactly=True) \
+                FileCheck().check_count("quantized::conv2d_add_relu(", 1, exactly=True) \
+                           .run(m.graph)
+                FileCheck().check_count("quantized::add_relu(", 1, exactly=True) \
                            .run(m.graph)
                 FileCheck().check_not("aten::add(") \
                            .check_not("aten::add_(") \
@@ -1534,12 +1540,14 @@ class TestQuantizeJitOps(QuantizationTestCase):
                              (NonQuantizedAdd(), False),
                              (NonQuantizedInplaceAdd(), False)]:
             for tracing in [True, False]:
-                op = "quantized::add" if quantized else "aten::add"
+                # the add of conv outputs is fused with conv1
+                op = "quantized::conv2d_add(" if quantized else "aten::add"
                 m = self.checkGraphModeOp(m, data, op, tracing)
                 # TODO: remove after refactor of checkGraphModeOp
                 if quantized:
                     FileCheck().check_not("aten::add") \
                                .check_not("aten::add_") \
+                               .check_not("quantized::add(") \
                                .run(m.graph)
                 else:
                     FileCheck().check_not("quantized::add") \
@@ -1683,15 +1691,37 @@ class TestQuantizeJitOps(QuantizationTestCase):
                   AddFunctionalRelu(), InplaceAddFunctionalRelu(),
                   AddInplaceFunctionalRelu(), InplaceAddInplaceFunctionalRelu()]:
             for tracing in [True, False]:
-                m = self.checkGraphModeOp(m, data, "quantized::add_relu(", tracing)
+                m = self.checkGraphModeOp(m, data, "quantized::conv2d_add_relu(", tracing)
                 FileCheck().check_not("aten::add(") \
                            .check_not("aten::add_(") \
                            .check_not("aten::relu(") \
                            .check_not("aten::relu_(") \
                            .check_not("quantized::add(") \
+                           .check_not("quantized::add_relu(") \
                            .check_not("quantized::relu(") \
                            .run(m.graph)
 
+    @skipIfNoFBGEMM
+    def test_quantized_linear_add(self):
+        class LinearAdd(torch.nn.Module):
+            def __init__(self):
+                super(LinearAdd, self).__init__()
+                self.linear1 = torch.nn.Linear(5, 5).float()
+                self.linear2 = torch.nn.Linear(5, 5).float()
+
+            def forward(self, x, y):
+                # y is also the input of linear1, so only linear1 is fused
+                y = self.linear2(y)
+                return y + self.linear1(y)
+
+        data = [[torch.rand((2, 5), dtype=torch.float),
+                 torch.rand((2, 5), dtype=torch.float)]]
+        for tracing in [True, False]:
+            m = self.checkGraphModeOp(LinearAdd(), data, "quantized::linear_add(", tracing)
+            FileCheck().check_count("quantized::linear(", 1, exactly=True) \
+                       .check_not("quantized::add(") \
+                       .run(m.graph)
+
     @skipIfNoFBGEMM
     def test_quantized_add_scalar_relu(self):
         class AddScalarRelu(torch.nn.Module):
@@ -2220,6 +2250,36 @@ class TestQuantizeJitOps(QuantizationTestCase):
             FileCheck().check_not("aten::instance_norm") \
                        .run(m.graph)
 
+    def test_softmax(self):
+        class Softmax(torch.nn.Module):
+            def __init__(self, dim):
+                super(Softmax, self).__init__()
+                self.dim = dim
+
+            def forward(self, x):
+                return torch.softmax(x, self.dim)
+
+        data = [[torch.rand((2, 3, 5), dtype=torch.float)] for _ in range(2)]
+        for dim, tracing in itertools.product([1, -1], [True, False]):
+            m = self.checkGraphModeOp(Softmax(dim), data, "quantized::softmax", tracing)
+            FileCheck().check_not("aten::softmax") \
+                       .run(m.graph)
+
+    def test_quantized_bmm(self):
+        class QuantizedBmm(torch.nn.Module):
+            def __init__(self):
+                super(QuantizedBmm, self).__init__()
+
+            def forward(self, x, y):
+                return torch.bmm(x, y)
+
+        data = [[torch.rand((2, 3, 4), dtype=torch.float),
+                 torch.rand((2, 4, 5), dtype=torch.float)]]
+        for tracing in [True, False]:
+            m = self.checkGraphModeOp(QuantizedBmm(), data, "quantized::bmm", tracing)
+            FileCheck().check_not("aten::bmm") \
+                       .run(m.graph)
+
     @skipIfNoFBGEMM
     def test_dequantize_tuple(self):
         """ Make sure dequantize can support Tuple of tensor
@@ -793,6 +793,43 @@ class TestDynamicQuantizedModule(QuantizationTestCase):
         # Smoke test extra_repr
         self.assertTrue('QuantizedLinear' in str(quantized_float_linear))
 
+    @override_qengines
+    def test_conv_api(self):
+        """test API functionality for nn.quantized.dynamic.Conv1d/2d/3d"""
+        F = torch.nn.functional
+        options = [(1, nn.Conv1d, nnqd.Conv1d, F.conv1d, torch.ops.quantized.conv1d_dynamic),
+                   (2, nn.Conv2d, nnqd.Conv2d, F.conv2d, torch.ops.quantized.conv2d_dynamic)]
+        if torch.backends.quantized.engine == 'fbgemm':
+            options.append((3, nn.Conv3d, nnqd.Conv3d, F.conv3d, torch.ops.quantized.conv3d_dynamic))
+        for spatial_dim, float_cls, dynamic_cls, float_conv_fn, dynamic_conv_op in options:
+            float_conv = float_cls(4, 6, 3, padding=1).float()
+            with torch.no_grad():
+                float_conv.weight.mul_(0.1)
+            float_conv.qconfig = torch.quantization.default_dynamic_qconfig
+            qconv = dynamic_cls.from_float(float_conv)
+            X = torch.rand(2, 4, *([7] * spatial_dim)).float()
+
+            # Check if the module implementation matches calling the
+            # ops directly
+            Y = qconv(X)
+            self.assertEqual(Y.dtype, torch.float)
+            self.assertEqual(Y, dynamic_conv_op(X, qconv._packed_params, reduce_range=True))
+
+            # Only the activation quantization separates the result from the
+            # float convolution with the quantized weight
+            Y_ref = float_conv_fn(X, qconv.weight().dequantize(), float_conv.bias, padding=1)
+            self.assertEqual(Y, Y_ref, atol=0.05, rtol=0)
+
+            # Smoke test extra_repr
+            self.assertTrue('DynamicQuantizedConv' in str(qconv))
+
+        # quantize_dynamic swaps the convolutions it is asked to
+        model = torch.nn.Sequential(torch.nn.Conv1d(4, 4, 3), torch.nn.ReLU(), torch.nn.Linear(5, 2))
+        qmodel = torch.quantization.quantize_dynamic(model, {torch.nn.Conv1d, torch.nn.Linear})
+        self.assertEqual(type(qmodel[0]), nnqd.Conv1d)
+        self.assertEqual(type(qmodel[2]), nnqd.Linear)
+        qmodel(torch.rand(3, 4, 7))
+
     @given(
         dtype=st.sampled_from([torch.qint8, torch.float16]),
         bidirectional=st.booleans(),
@@ -20,6 +20,7 @@ hu.assert_deadline_disabled()
 
 from torch.testing._internal.common_utils import TestCase
 from torch.testing._internal.common_quantization import skipIfNoFBGEMM
+from torch.testing._internal.common_cuda import TEST_CUDA
 from torch.testing._internal.common_quantized import _quantize, _dequantize, _calculate_dynamic_qparams, \
     override_quantized_engine, supported_qengines, override_qengines
 
@@ -738,6 +739,49 @@ class TestQuantizedOps(TestCase):
             self.assertEqual(qCrelu_hat, qCrelu_out_hat,
                              msg="AddReLU.out failed")
 
+    """Tests that conv2d and linear fused with the add that follows them match
+    the separate ops."""
+    @override_qengines
+    def test_qconv2d_linear_add(self):
+        # QNNPACK only takes unsigned activations and per tensor weights
+        x = torch.quantize_per_tensor(
+            torch.randn(2, 4, 8, 8), scale=0.05, zero_point=128, dtype=torch.quint8)
+        w = torch.quantize_per_tensor(
+            torch.randn(6, 4, 3, 3), scale=0.02, zero_point=0, dtype=torch.qint8)
+        b = torch.randn(6)
+        other = torch.quantize_per_tensor(
+            torch.randn(2, 6, 8, 8), scale=0.1, zero_point=120, dtype=torch.quint8)
+        conv_scale, conv_zero_point = 0.2, 110
+        scale, zero_point = 0.15, 100
+
+        packed = torch.ops.quantized.conv2d_prepack(w, b, [1, 1], [1, 1], [1, 1], 1)
+        y = torch.ops.quantized.conv2d(x, packed, conv_scale, conv_zero_point)
+        for fused, add in [(torch.ops.quantized.conv2d_add, torch.ops.quantized.add),
+                           (torch.ops.quantized.conv2d_add_relu, torch.ops.quantized.add_relu)]:
+            ref = add(y, other, scale, zero_point)
+            out = fused(x, other, packed, conv_scale, conv_zero_point, scale, zero_point)
+            self.assertEqual(out.q_scale(), scale)
+            self.assertEqual(out.q_zero_point(), zero_point)
+            self.assertEqual(out.int_repr(), ref.int_repr())
+
+        x = torch.quantize_per_tensor(
+            torch.randn(5, 16), scale=0.05, zero_point=128, dtype=torch.quint8)
+        w = torch.quantize_per_tensor(
+            torch.randn(8, 16), scale=0.02, zero_point=0, dtype=torch.qint8)
+        other = torch.quantize_per_tensor(
+            torch.randn(5, 8), scale=0.1, zero_point=120, dtype=torch.quint8)
+        packed = torch.ops.quantized.linear_prepack(w, torch.randn(8))
+        ref = torch.ops.quantized.add(
+            torch.ops.quantized.linear(x, packed, conv_scale, conv_zero_point),
+            other, scale, zero_point)
+        out = torch.ops.quantized.linear_add(
+            x, other, packed, conv_scale, conv_zero_point, scale, zero_point)
+        self.assertEqual(out.int_repr(), ref.int_repr())
+
+        with self.assertRaisesRegex(RuntimeError, "must have its shape"):
+            torch.ops.quantized.linear_add(
+                x, other.reshape(8, 5), packed, conv_scale, conv_zero_point, scale, zero_point)
+
     """Tests the correctness of the mul and mul_relu op."""
     def test_qmul_relu_same_qparams(self):
         for dtype in [torch.quint8, torch.qint8, torch.qint32]:
@@ -850,6 +894,49 @@ class TestQuantizedOps(TestCase):
                              msg="mulReLU.out failed")
 
     """Tests the correctness of the mul and mul_relu op."""
+    """Tests the correctness of the quantized bmm op."""
+    def test_qbmm(self):
+        A = torch.rand(3, 4, 17)
+        B = torch.randn(3, 17, 6)
+        scale_C = 0.05
+        zero_point_C = 60
+        qA = torch.quantize_per_tensor(A, scale=0.01, zero_point=3, dtype=torch.quint8)
+        qB_per_tensor = torch.quantize_per_tensor(B, scale=0.02, zero_point=128, dtype=torch.quint8)
+        qB_per_channel = torch.quantize_per_channel(
+            B, scales=torch.rand(6).double() * 0.02 + 0.01,
+            zero_points=torch.randint(100, 150, (6,)), axis=2, dtype=torch.quint8)
+        for qengine in supported_qengines:
+            with override_quantized_engine(qengine):
+                for qB in [qB_per_tensor, qB_per_channel, qB_per_tensor.transpose(1, 2).contiguous().transpose(1, 2)]:
+                    C = torch.bmm(qA.dequantize(), qB.dequantize()).numpy()
+                    qC = _quantize(C, scale_C, zero_point_C)
+                    qC_hat = torch.ops.quantized.bmm(qA, qB, scale_C, zero_point_C)
+                    self.assertEqual(qC_hat.q_scale(), scale_C)
+                    self.assertEqual(qC_hat.q_zero_point(), zero_point_C)
+                    # the integer accumulation only differs from the float
+                    # reference by the rounding of the requantization
+                    np.testing.assert_array_almost_equal(
+                        qC, qC_hat.int_repr().numpy(), decimal=0)
+
+    """Tests the correctness of the quantized softmax op."""
+    def test_qsoftmax(self):
+        X = torch.randn(2, 7, 33) * 3
+        for dtype, dim in itertools.product([torch.quint8, torch.qint8], [0, 1, -1]):
+            zero_point = 128 if dtype == torch.quint8 else 0
+            qX = torch.quantize_per_tensor(X, scale=0.05, zero_point=zero_point, dtype=dtype)
+            # the default output qparams of the fixed qparams ops, and
+            # arbitrary ones
+            output_zero_point = 0 if dtype == torch.quint8 else -128
+            for scale, zero_point in [(1.0 / 256, output_zero_point), (0.002, 10)]:
+                for qengine in supported_qengines:
+                    with override_quantized_engine(qengine):
+                        Y = torch.softmax(qX.dequantize(), dim).numpy()
+                        qY = _quantize(Y, scale, zero_point, dtype=np_dtype[dtype])
+                        qY_hat = torch.ops.quantized.softmax(qX, dim, scale, zero_point)
+                        self.assertEqual(qY_hat.shape, X.shape)
+                        np.testing.assert_array_almost_equal(
+                            qY, qY_hat.int_repr().numpy(), decimal=0)
+
     def test_qmul_broadcast(self):
         mul_relu = torch.ops.quantized.mul_relu
         mul = torch.ops.quantized.mul
@@ -2741,8 +2828,8 @@ class TestQuantizedEmbeddingBag(TestCase):
         # compare against C2 to ensure numerical equivalency.
         from caffe2.python import core, workspace
         conversion_op = "FloatToFused8BitRowwiseQuantized"
-        if bit_rate == 4:
-            conversion_op = "FloatToFused4BitRowwiseQuantized"
+        if bit_rate in (4, 2):
+            conversion_op = "FloatToFused{}BitRowwiseQuantized".format(bit_rate)
 
         def get_c2_weights(weights):
             workspace.ResetWorkspace()
@@ -2754,10 +2841,10 @@ class TestQuantizedEmbeddingBag(TestCase):
                 )
             )
             emb_q = workspace.FetchBlob("quantized_weights")
-            if bit_rate == 4:
+            if bit_rate in (4, 2):
                 workspace.RunOperatorOnce(
                     core.CreateOperator(
-                        "Fused4BitRowwiseQuantizedToFloat", ["quantized_weights"], ["dequantized_weights"]
+                        "Fused{}BitRowwiseQuantizedToFloat".format(bit_rate), ["quantized_weights"], ["dequantized_weights"]
                     )
                 )
                 dequantized_data = torch.from_numpy(workspace.FetchBlob("dequantized_weights"))
@@ -2792,6 +2879,15 @@ class TestQuantizedEmbeddingBag(TestCase):
 
         self._test_embedding_bag_unpack_fn(pack_fn, unpack_fn, num_embeddings, embedding_dim, bit_rate=4)
 
+    """ Tests the correctness of the embedding_bag_2bit pack/unpack op against C2 """
+    @given(num_embeddings=st.integers(10, 100),
+           embedding_dim=st.integers(5, 50).filter(lambda x: x % 4 == 0),)
+    def test_embedding_bag_2bit_unpack(self, num_embeddings, embedding_dim):
+        pack_fn = torch.ops.quantized.embedding_bag_2bit_prepack
+        unpack_fn = torch.ops.quantized.embedding_bag_2bit_unpack
+
+        self._test_embedding_bag_unpack_fn(pack_fn, unpack_fn, num_embeddings, embedding_dim, bit_rate=2)
+
     def embedding_bag_rowwise_offsets_run(
             self, bit_rate, num_embeddings,
             embedding_dim, num_offsets, enable_per_sample_weights,
@@ -2801,6 +2897,9 @@ class TestQuantizedEmbeddingBag(TestCase):
         if bit_rate == 4:
             pt_op = torch.ops.quantized.embedding_bag_4bit_rowwise_offsets
             pt_prepack_op = torch.ops.quantized.embedding_bag_4bit_prepack
+        elif bit_rate == 2:
+            pt_op = torch.ops.quantized.embedding_bag_2bit_rowwise_offsets
+            pt_prepack_op = torch.ops.quantized.embedding_bag_2bit_prepack
 
         weights = torch.from_numpy((np.random.random_sample((
             num_embeddings, embedding_dim)) + 1).astype(np.float32))
@@ -2895,6 +2994,110 @@ class TestQuantizedEmbeddingBag(TestCase):
                                                include_last_offset, atol=0.1,
                                                rtol=1e-2)
 
+    """ Tests the correctness of the embedding_bag_2bit quantized operator """
+    @given(num_embeddings=st.integers(10, 100),
+           embedding_dim=st.integers(5, 50).filter(lambda x: x % 4 == 0),
+           num_offsets=st.integers(1, 20),
+           enable_per_sample_weights=st.booleans(),
+           include_last_offset=st.booleans())
+    def test_embedding_bag_2bit_rowwise_offsets(self, num_embeddings,
+                                                embedding_dim, num_offsets,
+                                                enable_per_sample_weights,
+                                                include_last_offset):
+        self.embedding_bag_rowwise_offsets_run(2, num_embeddings,
+                                               embedding_dim, num_offsets,
+                                               enable_per_sample_weights,
+                                               include_last_offset, atol=1.0,
+                                               rtol=1e-1)
+
+    """ Tests all modes and pruned tables against embedding_bag on the dequantized weights """
+    @given(bit_rate=st.sampled_from([8, 4, 2]),
+           mode=st.sampled_from(['sum', 'mean', 'max']),
+           pruned=st.booleans(),
+           include_last_offset=st.booleans())
+    def test_embedding_bag_rowwise_offsets_modes(self, bit_rate, mode, pruned, include_last_offset):
+        prefix = 'byte' if bit_rate == 8 else '{}bit'.format(bit_rate)
+        pack_fn = getattr(torch.ops.quantized, 'embedding_bag_{}_prepack'.format(prefix))
+        unpack_fn = getattr(torch.ops.quantized, 'embedding_bag_{}_unpack'.format(prefix))
+        pt_op = getattr(torch.ops.quantized, 'embedding_bag_{}_rowwise_offsets'.format(prefix))
+
+        num_embeddings, embedding_dim = 40, 16
+        weights = torch.randn(num_embeddings, embedding_dim)
+        indices = torch.randint(0, num_embeddings, (50,))
+        offsets = torch.tensor([0, 5, 5, 17, 30, 49])
+        if include_last_offset:
+            offsets = torch.cat((offsets, torch.tensor([indices.numel()])))
+
+        mapping = None
+        # a pruned row is skipped, like an all zeros one for 'sum' and 'mean'
+        kept = torch.ones(num_embeddings, dtype=torch.bool)
+        if pruned:
+            kept[::3] = False
+            mapping = torch.full((num_embeddings,), -1, dtype=torch.int32)
+            mapping[kept] = torch.arange(int(kept.sum()), dtype=torch.int32)
+        q_weights = pack_fn(weights[kept].contiguous())
+
+        result = pt_op(q_weights, indices, offsets, mode={'sum': 0, 'mean': 1, 'max': 2}[mode],
+                       sparse=pruned, compressed_indices_mapping=mapping,
+                       include_last_offset=include_last_offset)
+
+        dequantized = torch.zeros(num_embeddings, embedding_dim)
+        dequantized[kept] = unpack_fn(q_weights)
+        if pruned and mode == 'max':
+            # drop the pruned rows from the bags instead
+            bags = []
+            bounds = offsets.tolist() + ([] if include_last_offset else [indices.numel()])
+            for begin, end in zip(bounds[:-1], bounds[1:]):
+                bag = [i for i in indices[begin:end].tolist() if kept[i]]
+                bags.append(dequantized[bag].max(0)[0] if bag else torch.zeros(embedding_dim))
+            reference_result = torch.stack(bags)
+        else:
+            reference_result = torch.nn.functional.embedding_bag(
+                indices, dequantized, offsets, mode=mode, include_last_offset=include_last_offset)
+        torch.testing.assert_allclose(result, reference_result, atol=1e-4, rtol=1e-4)
+
+    """ Tests the CUDA kernels against the CPU ops on the same prepacked tables """
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    @given(bit_rate=st.sampled_from([8, 4]),
+           embedding_dim=st.sampled_from([16, 18, 64, 130]),
+           mode=st.sampled_from(['sum', 'mean', 'max']),
+           pruned=st.booleans(),
+           enable_per_sample_weights=st.booleans(),
+           include_last_offset=st.booleans())
+    def test_embedding_bag_rowwise_offsets_cuda(self, bit_rate, embedding_dim, mode, pruned,
+                                                enable_per_sample_weights, include_last_offset):
+        assume(mode == 'sum' or not enable_per_sample_weights)
+        prefix = 'byte' if bit_rate == 8 else '{}bit'.format(bit_rate)
+        pack_fn = getattr(torch.ops.quantized, 'embedding_bag_{}_prepack'.format(prefix))
+        pt_op = getattr(torch.ops.quantized, 'embedding_bag_{}_rowwise_offsets'.format(prefix))
+
+        num_embeddings = 40
+        num_kept = num_embeddings
+        mapping = None
+        if pruned:
+            kept = torch.ones(num_embeddings, dtype=torch.bool)
+            kept[::3] = False
+            num_kept = int(kept.sum())
+            mapping = torch.full((num_embeddings,), -1, dtype=torch.int32)
+            mapping[kept] = torch.arange(num_kept, dtype=torch.int32)
+        q_weights = pack_fn(torch.randn(num_kept, embedding_dim))
+        indices = torch.randint(0, num_embeddings, (50,))
+        offsets = torch.tensor([0, 5, 5, 17, 30, 49])
+        if include_last_offset:
+            offsets = torch.cat((offsets, torch.tensor([indices.numel()])))
+        per_sample_weights = torch.rand(indices.numel()) if enable_per_sample_weights else None
+
+        def run(device):
+            def to(t):
+                return t.to(device) if t is not None else None
+            return pt_op(to(q_weights), to(indices), to(offsets),
+                         mode={'sum': 0, 'mean': 1, 'max': 2}[mode], sparse=pruned,
+                         per_sample_weights=to(per_sample_weights),
+                         compressed_indices_mapping=to(mapping),
+                         include_last_offset=include_last_offset)
+
+        torch.testing.assert_allclose(run('cuda').cpu(), run('cpu'), atol=1e-4, rtol=1e-4)
+
 
 class TestQuantizedConv(unittest.TestCase):
     def _test_qconv_unpack_impl(
@@ -559,6 +559,29 @@ class TestFakeQuantizePerTensor(TestCase):
         Y_prime.backward(dout)
         np.testing.assert_allclose(dX.cpu(), X.grad.cpu().detach().numpy(), rtol=tolerance, atol=tolerance)
 
+    @given(device=st.sampled_from(['cpu', 'cuda'] if torch.cuda.is_available() else ['cpu']),
+           shape=st.sampled_from([(7,), (4, 33), (2, 3, 17, 9)]),
+           channels_last=st.booleans())
+    def test_cachemask_per_tensor(self, device, shape, channels_last):
+        r"""Tests the cachemask op against the fake quantize op and its backward.
+        """
+        scale, zero_point, quant_min, quant_max = 0.02, 10, 0, 255
+        X = (torch.randn(shape, device=device) * 3).requires_grad_()
+        if channels_last and X.dim() == 4:
+            X = X.detach().contiguous(memory_format=torch.channels_last).requires_grad_()
+        Y = torch.fake_quantize_per_tensor_affine(X, scale, zero_point, quant_min, quant_max)
+        Y_prime, mask = torch.fake_quantize_per_tensor_affine_cachemask(
+            X, scale, zero_point, quant_min, quant_max)
+        self.assertEqual(Y, Y_prime)
+        self.assertEqual(mask.dtype, torch.bool)
+        self.assertFalse(mask.requires_grad)
+
+        dout = torch.rand(shape, device=device)
+        dX, = torch.autograd.grad(Y, X, dout)
+        dX_prime, = torch.autograd.grad(Y_prime, X, dout)
+        self.assertEqual(dX, dX_prime)
+        self.assertEqual(dX_prime, dout * mask)
+
     def _test_learnable_forward_per_tensor(self, X, device, scale_base, zero_point_base):
         X_base = torch.tensor(X).to(device)
 
@@ -907,6 +930,28 @@ class TestFakeQuantizePerChannel(TestCase):
         Y_prime.backward(dout)
         np.testing.assert_allclose(dX.cpu().detach().numpy(), X.grad.cpu().detach().numpy(), rtol=tolerance, atol=tolerance)
 
+    @given(device=st.sampled_from(['cpu', 'cuda'] if torch.cuda.is_available() else ['cpu']),
+           shape=st.sampled_from([(5, 7), (4, 3, 33), (2, 3, 17, 9)]),
+           axis=st.integers(0, 1))
+    def test_cachemask_per_channel(self, device, shape, axis):
+        r"""Tests the cachemask op against the fake quantize op and its backward.
+        """
+        quant_min, quant_max = -128, 127
+        X = (torch.randn(shape, device=device) * 3).requires_grad_()
+        scale = torch.rand(shape[axis], device=device) * 0.05 + 0.005
+        zero_point = torch.randint(-20, 20, (shape[axis],), dtype=torch.int64, device=device)
+        Y = torch.fake_quantize_per_channel_affine(X, scale, zero_point, axis, quant_min, quant_max)
+        Y_prime, mask = torch.fake_quantize_per_channel_affine_cachemask(
+            X, scale, zero_point, axis, quant_min, quant_max)
+        self.assertEqual(Y, Y_prime)
+        self.assertEqual(mask.dtype, torch.bool)
+
+        dout = torch.rand(shape, device=device)
+        dX, = torch.autograd.grad(Y, X, dout)
+        dX_prime, = torch.autograd.grad(Y_prime, X, dout)
+        self.assertEqual(dX, dX_prime)
+        self.assertEqual(dX_prime, dout * mask)
+
     def _test_learnable_backward_per_channel(self, X_base, device, scale_base, zero_point_base, axis):
         r"""Tests the backward path of the learnable FakeQuantizePerTensorAffine op.
         """
@@ -38,6 +38,7 @@ TESTS = [
     'distributed/test_distributed',
     'test_distributions',
     'test_expecttest',
+    'test_foreach',
     'test_indexing',
     'test_jit',
     'test_logging',
@@ -51,6 +52,7 @@ TESTS = [
     'test_optim',
     'test_mobile_optimizer',
     'test_xnnpack_integration',
+    'test_cpu_prepacked',
     'test_vulkan',
     'test_quantization',
     'test_sparse',
@@ -66,6 +68,7 @@ TESTS = [
     'test_jit_fuser_legacy',
     'test_tensorboard',
     'test_namedtensor',
+    'test_nested_tensor',
     'test_type_promotion',
     'test_jit_disabled',
     'test_function_schema',
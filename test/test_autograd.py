@@ -2705,6 +2705,55 @@ class TestAutograd(TestCase):
                 last_end = info.cpu_interval.end
             self.assertEqual(info.name, expected_name)
 
+    def test_sampled_profiler(self):
+        x = torch.randn(10, 10)
+        batches = []
+        prof = torch.autograd.profiler.sampled_profile(batches.append, sampling_prob=1.0, batch_size=4)
+
+        with prof:
+            self.assertTrue(torch.autograd._sampled_profiler_enabled())
+            with record_function("outer"):
+                for _ in range(5):
+                    y = x * 2 + 4
+            # Only one sampled profiler at a time
+            with self.assertRaisesRegex(RuntimeError, "already enabled"):
+                prof.start()
+            # Batches are streamed while the profiler runs
+            self.assertTrue(len(batches) > 0)
+        self.assertFalse(torch.autograd._sampled_profiler_enabled())
+
+        events = [e for batch in batches for e in batch]
+        self.assertTrue(all(0 < len(batch) <= 4 for batch in batches))
+        self.assertEqual(sum(e.name == 'aten::mul' for e in events), 5)
+        self.assertEqual(sum(e.name == 'aten::add' for e in events), 5)
+        outer = [e for e in events if e.name == 'outer']
+        self.assertEqual(len(outer), 1)
+        self.assertEqual(outer[0].scope, 'user_scope')
+        for e in events:
+            self.assertTrue(e.duration_us >= 0)
+            if e.name == 'aten::mul':
+                self.assertEqual(e.scope, 'function')
+                self.assertTrue(outer[0].start_us <= e.start_us)
+                self.assertTrue(e.start_us + e.duration_us <= outer[0].start_us + outer[0].duration_us)
+
+        # Nothing is recorded once stopped
+        num_events = len(events)
+        y = x * 2
+        self.assertEqual(sum(len(batch) for batch in batches), num_events)
+
+        # Low sampling probabilities pick a fraction of the ranges
+        batches.clear()
+        with torch.autograd.profiler.sampled_profile(batches.append, sampling_prob=0.1):
+            for _ in range(1000):
+                y = x + 1
+        num_adds = sum(e.name == 'aten::add' for batch in batches for e in batch)
+        self.assertTrue(0 < num_adds < 500)
+
+        with self.assertRaisesRegex(ValueError, "sampling_prob"):
+            torch.autograd.profiler.sampled_profile(batches.append, sampling_prob=0)
+        with self.assertRaisesRegex(RuntimeError, "not running"):
+            torch.autograd._disable_sampled_profiler()
+
     def test_profiler_unboxed_only(self):
         x = torch.rand(3, 4)
 
@@ -2877,6 +2926,32 @@ class TestAutograd(TestCase):
                 self.assertEqual(event.input_shapes, input_shape_expected)
                 last_end = event.cpu_interval.end
 
+    def test_profiler_op_costs(self):
+        layer = torch.nn.Linear(20, 30)
+        input = torch.randn(128, 20)
+        with profile(record_shapes=True) as prof:
+            torch.relu(layer(input))
+
+        addmm = [evt for evt in prof.function_events if evt.name == 'aten::addmm']
+        self.assertEqual(len(addmm), 1)
+        # 2 * M * K * N for the product, plus the bias
+        self.assertEqual(addmm[0].flops, 2 * 128 * 20 * 30 + 128 * 30)
+        self.assertEqual(addmm[0].bytes_moved, 4 * (128 * 20 + 20 * 30 + 2 * 128 * 30))
+        relu = [evt for evt in prof.function_events if evt.name == 'aten::relu']
+        self.assertEqual(relu[0].flops, 128 * 30)
+
+        averages = prof.key_averages()
+        table = averages.table(peak_gflops=100.0, peak_gbps=10.0)
+        self.assertIn('GFLOP/s', table)
+        self.assertIn('% Roofline', table)
+        avg_addmm = [evt for evt in averages if evt.key == 'aten::addmm'][0]
+        self.assertEqual(avg_addmm.flops, addmm[0].flops)
+
+        with profile() as prof:
+            layer(input)
+        self.assertIsNone(prof.function_events[0].flops)
+        self.assertNotIn('GFLOP/s', prof.table())
+
     def test_profiler_no_cuda(self):
         print("")
         layer = torch.nn.Linear(20, 30)
@@ -3032,6 +3107,76 @@ class TestAutograd(TestCase):
             ]
         )
 
+    def test_memory_profiler_peak_and_timeline(self):
+        with profile(profile_memory=True) as prof:
+            with record_function("test_peak_scope"):
+                tmp = torch.rand(100, 100)
+                del tmp
+                kept = torch.rand(10, 10)
+
+        events = [evt for evt in prof.function_events if evt.name == "test_peak_scope"]
+        self.assertEqual(len(events), 1)
+        # The peak is reached while `tmp` is alive, before it is freed
+        self.assertTrue(events[0].cpu_memory_usage >= 10 * 10 * 4)
+        self.assertTrue(events[0].cpu_memory_peak >= 100 * 100 * 4)
+        self.assertTrue(events[0].cpu_memory_peak > events[0].cpu_memory_usage)
+        stats = {evt.key: evt for evt in prof.key_averages()}
+        self.assertEqual(stats["test_peak_scope"].cpu_memory_peak, events[0].cpu_memory_peak)
+
+        # The timeline holds the running total of the allocations
+        timeline = [mem for mem in prof.function_events.memory_events if mem.device_type == 'CPU']
+        self.assertTrue(len(timeline) >= 3)
+        self.assertEqual(timeline, sorted(timeline, key=lambda mem: mem.time_us))
+        total = 0
+        for mem in timeline:
+            total += mem.alloc_size
+            self.assertEqual(mem.total_allocated, total)
+        self.assertTrue(max(mem.total_allocated for mem in timeline) >= 100 * 100 * 4)
+
+        with tempfile.NamedTemporaryFile(mode="w+") as f:
+            prof.export_chrome_trace(f.name)
+            trace = json.load(f)
+        counters = [e for e in trace if e["ph"] == "C"]
+        self.assertEqual(len(counters), len(prof.function_events.memory_events))
+        self.assertEqual(counters[-1]["args"]["Total Allocated"],
+                         prof.function_events.memory_events[-1].total_allocated)
+
+    def test_profiler_streamed_trace(self):
+        x = torch.randn(10, 10)
+        with tempfile.NamedTemporaryFile(mode="w+") as f:
+            with profile(trace_path=f.name, profile_memory=True) as prof:
+                with record_function("test_streamed_scope"):
+                    y = x.mm(x)
+            # The events went to the file
+            self.assertEqual(len(prof.function_events), 0)
+            trace = json.load(f)
+        begins = [e for e in trace if e["ph"] == "B"]
+        ends = [e for e in trace if e["ph"] == "E"]
+        self.assertEqual(len(begins), len(ends))
+        self.assertTrue(any(e["name"] == "test_streamed_scope" for e in begins))
+        self.assertTrue(any(e["name"] == "aten::mm" for e in begins))
+        self.assertTrue(any(e["ph"] == "C" for e in trace))
+
+        if not torch.cuda.is_available():
+            return
+        x = x.cuda()
+        try:
+            with profile(use_cupti=True) as prof:
+                with record_function("test_cupti_scope"):
+                    y = x.mm(x).cpu()
+        except RuntimeError as e:
+            if "compiled without CUPTI" in str(e):
+                return
+            raise
+        mm = [evt for evt in prof.function_events if evt.name == "aten::mm"]
+        self.assertEqual(len(mm), 1)
+        self.assertTrue(len(mm[0].kernels) > 0)
+        for kernel in mm[0].kernels:
+            self.assertTrue(kernel.interval.elapsed_us() >= 0)
+        self.assertTrue(any(evt.name == "aten::copy_" and
+                            any("Memcpy" in k.name for k in evt.kernels)
+                            for evt in prof.function_events))
+
     def test_record_function(self):
         x = torch.randn(10, 10)
 
@@ -3663,6 +3808,237 @@ for shape in [(1,), ()]:
         v2 = torch.tensor(200.0, requires_grad=True)
         DeepReentrant.apply(v2).sum().backward()
 
+    def test_static_graph(self):
+        class Reentrant(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                with torch.enable_grad():
+                    y = torch.ones(3, requires_grad=True)
+                    (y * 3).sum().backward()
+                return grad * y.grad
+
+        def run(iterations, wide):
+            torch.manual_seed(0)
+            x = torch.randn(3, requires_grad=True)
+            w = torch.randn(3, requires_grad=True)
+            results = []
+            for i in range(iterations):
+                hook_grads = []
+                h = x * w
+                h.register_hook(lambda g: hook_grads.append(g.clone()))
+                out = h.exp() + Reentrant.apply(h) + w.sin()
+                if wide and i % 2:
+                    # Changes the topology every other iteration
+                    out = out + (x * 2).tanh()
+                out.sum().backward(retain_graph=True)
+                out.sum().backward()
+                results.append([x.grad.clone(), w.grad.clone()] + hook_grads)
+                x.grad = None
+                w.grad = None
+            return results
+
+        self.assertFalse(torch.autograd.is_static_graph())
+        expected = [run(4, False), run(4, True)]
+        torch.autograd.set_static_graph(True)
+        try:
+            self.assertTrue(torch.autograd.is_static_graph())
+            self.assertEqual([run(4, False), run(4, True)], expected)
+
+            # Errors and final callbacks in replayed graphs
+            class Fail(Function):
+                @staticmethod
+                def forward(ctx, x):
+                    return x.clone()
+
+                @staticmethod
+                def backward(ctx, grad):
+                    if ctx.fail:
+                        raise RuntimeError("Simulate error")
+                    return grad
+
+            called = []
+            for fail in [False, False, True]:
+                a = torch.randn(3, requires_grad=True)
+                y = Fail.apply(a)
+                y.grad_fn.fail = fail
+                y.register_hook(lambda g: Variable._execution_engine.queue_callback(lambda: called.append(1)))
+                if fail:
+                    with self.assertRaisesRegex(RuntimeError, "Simulate error"):
+                        y.sum().backward()
+                else:
+                    y.sum().backward()
+                    self.assertEqual(a.grad, torch.ones(3))
+            self.assertEqual(len(called), 2)
+        finally:
+            torch.autograd.set_static_graph(False)
+
+    def test_saved_tensors_hooks(self):
+        packed = []
+
+        def pack(x):
+            self.assertFalse(x.requires_grad)
+            packed.append(x)
+            return len(packed) - 1
+
+        unpacked = []
+
+        def unpack(i):
+            unpacked.append(i)
+            return packed[i] * 1
+
+        a = torch.randn(5, requires_grad=True)
+        with torch.autograd.graph.saved_tensors_hooks(pack, unpack):
+            y = (a * a).exp().sum()
+        self.assertEqual(len(packed), 3)  # a twice, exp output once
+        # Hooks are only applied to tensors saved within the context manager
+        z = (a * a).sum()
+        self.assertEqual(len(packed), 3)
+
+        y.backward(retain_graph=True)
+        self.assertEqual(a.grad, 2 * a * (a * a).exp())
+        self.assertEqual(sorted(unpacked), [0, 1, 2])
+        y.backward()
+        self.assertEqual(len(unpacked), 6)
+        z.backward()
+
+        # The innermost hooks win
+        outer = []
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: outer.append(x) or x, lambda x: x):
+            with torch.autograd.graph.saved_tensors_hooks(lambda x: x * 2, lambda x: x / 2):
+                y = a.sin()
+        self.assertEqual(outer, [])
+        self.assertEqual(torch.autograd.grad(y.sum(), a)[0], a.cos())
+
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: x, lambda x: "not a tensor"):
+            y = a.exp().sum()
+        with self.assertRaisesRegex(TypeError, "expected to be a Tensor"):
+            y.backward()
+
+        def failing_pack(x):
+            raise RuntimeError("pack failed")
+
+        with torch.autograd.graph.saved_tensors_hooks(failing_pack, lambda x: x):
+            with self.assertRaisesRegex(RuntimeError, "pack failed"):
+                a.exp()
+
+        # In-place modifications are still detected
+        b = a.clone()
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: x.clone(), lambda x: x):
+            y = b.sin()
+        b.add_(1)
+        with self.assertRaisesRegex(RuntimeError, "modified by an inplace operation"):
+            y.sum().backward()
+
+    def test_save_on_cpu(self):
+        devices = ['cpu'] + (['cuda'] if torch.cuda.is_available() else [])
+        for device, pin_memory, prefetch in product(devices, [True, False], [0, 2]):
+            if device == 'cpu' and pin_memory:
+                continue
+            torch.manual_seed(0)
+            x = torch.randn(10, 10, device=device, requires_grad=True)
+            ws = [torch.randn(10, 10, device=device, requires_grad=True) for _ in range(5)]
+
+            def fn():
+                out = x
+                for w in ws:
+                    out = (out @ w).tanh()
+                return out.sum()
+
+            expected = torch.autograd.grad(fn(), [x] + ws)
+            with torch.autograd.graph.save_on_cpu(pin_memory=pin_memory, prefetch=prefetch):
+                y = fn()
+            self.assertEqual(torch.autograd.grad(y, [x] + ws, retain_graph=True), expected)
+            self.assertEqual(torch.autograd.grad(y, [x] + ws), expected)
+
+        with self.assertRaisesRegex(ValueError, "prefetch must be non-negative"):
+            torch.autograd.graph.save_on_cpu(prefetch=-1)
+
+    def test_multithreaded_cpu_backward(self):
+        def towers(inputs):
+            out = 0
+            for i, x in enumerate(inputs):
+                for _ in range(i + 2):
+                    x = (x * 1.5).tanh()
+                out = out + x.sum()
+            return out
+
+        def grads(num_threads):
+            prev = torch.autograd.get_num_cpu_threads()
+            torch.autograd.set_num_cpu_threads(num_threads)
+            try:
+                torch.manual_seed(0)
+                inputs = [torch.randn(5, 5, requires_grad=True) for _ in range(4)]
+                towers(inputs).backward()
+                first = [x.grad.clone() for x in inputs]
+                # Accumulation into the same leaves from several branches
+                shared = torch.randn(5, 5, requires_grad=True)
+                towers([shared] * 4).backward()
+                second = torch.autograd.grad(towers(inputs + [shared]), inputs)
+                return first + [shared.grad] + list(second)
+            finally:
+                torch.autograd.set_num_cpu_threads(prev)
+
+        self.assertEqual(torch.autograd.get_num_cpu_threads(), 1)
+        self.assertEqual(grads(4), grads(1))
+
+        with self.assertRaisesRegex(RuntimeError, "must be positive"):
+            torch.autograd.set_num_cpu_threads(0)
+
+        # Independent branches run concurrently: each waits for the other.
+        barrier = threading.Barrier(2, timeout=30)
+
+        class Wait(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                barrier.wait()
+                return grad
+
+        class Fail(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                raise RuntimeError("Simulate error")
+
+        class Reentrant(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                with torch.enable_grad():
+                    y = torch.ones(3, requires_grad=True)
+                    (y * 2).sum().backward()
+                return grad * y.grad
+
+        torch.autograd.set_num_cpu_threads(3)
+        try:
+            a = torch.randn(3, requires_grad=True)
+            b = torch.randn(3, requires_grad=True)
+            (Wait.apply(a).sum() + Wait.apply(b).sum()).backward()
+            self.assertEqual(a.grad, torch.ones(3))
+            self.assertEqual(b.grad, torch.ones(3))
+
+            with self.assertRaisesRegex(RuntimeError, "Simulate error"):
+                (Fail.apply(a).sum() + (b * 2).sum()).backward()
+
+            a.grad = None
+            (Reentrant.apply(a).sum() + Reentrant.apply(b).sum()).backward()
+            self.assertEqual(a.grad, torch.full((3,), 2.))
+        finally:
+            torch.autograd.set_num_cpu_threads(1)
+
     def test_reentrant_priority(self):
         order = []
 
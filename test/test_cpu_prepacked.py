@@ -0,0 +1,187 @@
+import io
+import unittest
+
+import torch
+import torch.nn as nn
+from torch.nn import functional as F
+from torch.testing import FileCheck
+from torch.testing._internal.common_utils import TestCase, run_tests
+
+
+class TestCPUPrePackedOps(TestCase):
+    def test_linear(self):
+        for data_shape, out_features, use_bias in [((4, 32), 24, True),
+                                                   ((2, 3, 17), 5, False),
+                                                   ((0, 8), 3, True),
+                                                   ((64,), 33, True)]:
+            input_data = torch.rand(data_shape)
+            weight = torch.rand(out_features, data_shape[-1])
+            bias = torch.rand(out_features) if use_bias else None
+            ref_result = F.linear(input_data, weight, bias)
+            packed_weight_bias = torch.ops.cpu_prepacked.linear_prepack(weight, bias)
+            result = torch.ops.cpu_prepacked.linear_run(input_data, packed_weight_bias)
+            self.assertEqual(result, ref_result)
+            # non-contiguous weights and inputs
+            packed_weight_bias = torch.ops.cpu_prepacked.linear_prepack(
+                weight.t().contiguous().t(), bias)
+            result = torch.ops.cpu_prepacked.linear_run(
+                input_data.transpose(0, -1).contiguous().transpose(0, -1), packed_weight_bias)
+            self.assertEqual(result, ref_result)
+
+    def test_conv2d(self):
+        for groups, stride, padding, dilation, use_bias in [(1, (1, 1), (0, 0), (1, 1), True),
+                                                            (2, (2, 1), (1, 2), (1, 1), False),
+                                                            (4, (1, 1), (1, 1), (2, 2), True)]:
+            input_data = torch.rand(2, 4 * groups, 13, 11)
+            weight = torch.rand(3 * groups, 4, 3, 3)
+            bias = torch.rand(3 * groups) if use_bias else None
+            ref_result = F.conv2d(input_data, weight, bias, stride, padding, dilation, groups)
+            packed_weight_bias = torch.ops.cpu_prepacked.conv2d_prepack(
+                weight, bias, stride, padding, dilation, groups)
+            result = torch.ops.cpu_prepacked.conv2d_run(input_data, packed_weight_bias)
+            self.assertEqual(result, ref_result, atol=1e-4, rtol=1e-4)
+            result = torch.ops.cpu_prepacked.conv2d_run(
+                input_data.contiguous(memory_format=torch.channels_last), packed_weight_bias)
+            self.assertEqual(result, ref_result, atol=1e-4, rtol=1e-4)
+            result = torch.ops.cpu_prepacked.conv2d_relu_run(input_data, packed_weight_bias)
+            self.assertEqual(result, F.relu(ref_result), atol=1e-4, rtol=1e-4)
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_conv2d_mkldnn_input(self):
+        # opaque inputs give opaque outputs
+        input_data = torch.rand(2, 4, 13, 11)
+        weight = torch.rand(6, 4, 3, 3)
+        bias = torch.rand(6)
+        ref_result = F.conv2d(input_data, weight, bias, padding=1)
+        packed_weight_bias = torch.ops.cpu_prepacked.conv2d_prepack(
+            weight, bias, [1, 1], [1, 1], [1, 1], 1)
+        result = torch.ops.cpu_prepacked.conv2d_run(input_data.to_mkldnn(), packed_weight_bias)
+        self.assertTrue(result.is_mkldnn)
+        self.assertEqual(result.to_dense(), ref_result, atol=1e-4, rtol=1e-4)
+        result = torch.ops.cpu_prepacked.conv2d_relu_run(input_data.to_mkldnn(), packed_weight_bias)
+        self.assertTrue(result.is_mkldnn)
+        self.assertEqual(result.to_dense(), F.relu(ref_result), atol=1e-4, rtol=1e-4)
+
+    def test_fallback(self):
+        # inputs the packed weight can't serve still give the eager result
+        weight = torch.rand(6, 8)
+        bias = torch.rand(6)
+        packed_weight_bias = torch.ops.cpu_prepacked.linear_prepack(weight, bias)
+        input_data = torch.rand(3, 8, requires_grad=True)
+        result = torch.ops.cpu_prepacked.linear_run(input_data, packed_weight_bias)
+        self.assertEqual(result, F.linear(input_data, weight, bias))
+        result.sum().backward()
+        self.assertEqual(input_data.grad, weight.sum(0).expand(3, 8))
+
+        packed_weight_bias = torch.ops.cpu_prepacked.linear_prepack(weight.double(), bias.double())
+        input_data = torch.rand(3, 8, dtype=torch.double)
+        result = torch.ops.cpu_prepacked.linear_run(input_data, packed_weight_bias)
+        self.assertEqual(result, F.linear(input_data, weight.double(), bias.double()))
+
+        with self.assertRaisesRegex(RuntimeError, "last dimension of input"):
+            packed_weight_bias = torch.ops.cpu_prepacked.linear_prepack(weight, bias)
+            torch.ops.cpu_prepacked.linear_run(torch.rand(3, 7), packed_weight_bias)
+
+
+class TestCPUPrePackedRewritePass(TestCase):
+    def test_frozen_module(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.conv = nn.Conv2d(3, 8, 3, padding=1)
+                self.linear = nn.Linear(8, 4)
+
+            def forward(self, x):
+                y = self.conv(x).mean([2, 3])
+                return self.linear(y)
+
+        model = torch.jit.script(M().eval())
+        input_data = torch.rand(2, 3, 10, 10)
+        ref_result = model(input_data)
+
+        model._c = torch._C._freeze_module(model._c)
+        torch._C._jit_pass_insert_cpu_prepacked_ops(model._c)
+        FileCheck().check_not("aten::linear").check_not("aten::conv2d") \
+                   .check_not("cpu_prepacked::linear_prepack") \
+                   .check_not("cpu_prepacked::conv2d_prepack").run(model.graph)
+        FileCheck().check("cpu_prepacked::conv2d_run") \
+                   .check("cpu_prepacked::linear_run").run(model.graph)
+        with torch.no_grad():
+            self.assertEqual(model(input_data), ref_result, atol=1e-4, rtol=1e-4)
+
+        buffer = io.BytesIO()
+        torch.jit.save(model, buffer)
+        buffer.seek(0)
+        deserialized_model = torch.jit.load(buffer)
+        with torch.no_grad():
+            self.assertEqual(deserialized_model(input_data), ref_result, atol=1e-4, rtol=1e-4)
+
+    def test_non_constant_weight(self):
+        # weights that are not constants are left to the eager ops
+        def f(x, w):
+            return F.linear(x, w)
+
+        graph = torch.jit.script(f).graph
+        torch._C._jit_pass_insert_cpu_prepacked_ops(graph)
+        FileCheck().check("aten::linear").check_not("cpu_prepacked::").run(graph)
+
+
+class TestConvertFrozenOpsToMKLDNN(TestCase):
+    def _check_frozen_module(self, model, input_data):
+        model = torch.jit.script(model.eval())
+        ref_result = model(input_data)
+        model._c = torch._C._freeze_module(model._c)
+        torch._C._jit_pass_convert_frozen_ops_to_mkldnn(model._c)
+        with torch.no_grad():
+            self.assertEqual(model(input_data), ref_result, atol=1e-4, rtol=1e-4)
+        return model
+
+    def test_conv_bn_relu(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.conv = nn.Conv2d(3, 8, 3, padding=1)
+                self.bn = nn.BatchNorm2d(8)
+
+            def forward(self, x):
+                return F.relu(self.bn(self.conv(x)))
+
+        m = M()
+        m.bn.running_mean.uniform_()
+        m.bn.running_var.uniform_(0.5, 1.5)
+        model = self._check_frozen_module(m, torch.rand(2, 3, 10, 10))
+        FileCheck().check_not("aten::batch_norm").check_not("aten::relu") \
+                   .check("cpu_prepacked::conv2d_relu_run").run(model.graph)
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_mkldnn_region(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = nn.Conv2d(8, 8, 3, padding=1)
+                self.linear = nn.Linear(8, 4)
+
+            def forward(self, x):
+                y = F.relu(self.conv1(x))
+                y = F.max_pool2d(y, 2)
+                y = F.relu(self.conv2(y) + y)
+                return self.linear(y.mean([2, 3]))
+
+        model = self._check_frozen_module(M(), torch.rand(2, 3, 12, 12))
+        # reorders only where the region starts and ends
+        FileCheck().check_count("aten::to_mkldnn", 1, exactly=True) \
+                   .check_count("aten::to_dense", 1, exactly=True) \
+                   .check("cpu_prepacked::linear_run").run(model.graph)
+
+        buffer = io.BytesIO()
+        torch.jit.save(model, buffer)
+        buffer.seek(0)
+        deserialized_model = torch.jit.load(buffer)
+        input_data = torch.rand(2, 3, 12, 12)
+        with torch.no_grad():
+            self.assertEqual(deserialized_model(input_data), model(input_data))
+
+
+if __name__ == "__main__":
+    run_tests()
@@ -36,6 +36,8 @@ load_tests = load_tests
 # cause CUDA OOM error on Windows.
 TEST_CUDA = torch.cuda.is_available()
 TEST_MULTIGPU = TEST_CUDA and torch.cuda.device_count() >= 2
+TEST_CUDA_GRAPH = TEST_CUDA and not TEST_WITH_ROCM and \
+    torch.version.cuda and int(torch.version.cuda.split(".")[0]) >= 11
 
 if not TEST_CUDA:
     print('CUDA not available, skipping tests')
@@ -288,6 +290,89 @@ class TestCuda(TestCase):
         for _ in self._test_memory_stats_generator(self):
             self._check_memory_stat_consistency()
 
+    def test_set_per_process_memory_fraction(self):
+        # test invalid fraction value.
+        with self.assertRaisesRegex(TypeError, "Invalid type"):
+            torch.cuda.set_per_process_memory_fraction(int(1))
+        with self.assertRaisesRegex(ValueError, "Invalid fraction value"):
+            torch.cuda.set_per_process_memory_fraction(-0.1)
+        with self.assertRaisesRegex(ValueError, "Invalid fraction value"):
+            torch.cuda.set_per_process_memory_fraction(2.0)
+
+        gc.collect()
+        torch.cuda.empty_cache()
+        total_memory = torch.cuda.get_device_properties(0).total_memory
+        torch.cuda.set_per_process_memory_fraction(0.5, 0)
+        try:
+            # an allocation within the cap succeeds, and cached blocks are
+            # released to make room for it
+            cached = torch.empty(int(total_memory * 0.3), dtype=torch.int8, device='cuda')
+            del cached
+            application = int(total_memory * 0.4)
+            tmp_tensor = torch.empty(application, dtype=torch.int8, device='cuda')
+            del tmp_tensor
+
+            with self.assertRaisesRegex(RuntimeError, "out of memory"):
+                torch.empty(int(total_memory * 0.6), dtype=torch.int8, device='cuda')
+        finally:
+            torch.cuda.set_per_process_memory_limit(0, 0)
+            torch.cuda.empty_cache()
+
+    def test_set_per_process_memory_limit(self):
+        with self.assertRaisesRegex(ValueError, "Invalid limit_bytes"):
+            torch.cuda.set_per_process_memory_limit(-1)
+        with self.assertRaisesRegex(ValueError, "Invalid limit_bytes"):
+            torch.cuda.set_per_process_soft_memory_limit(1.5)
+
+        gc.collect()
+        torch.cuda.empty_cache()
+        torch.cuda.set_per_process_memory_limit(64 * 1024 * 1024, 0)
+        try:
+            tmp_tensor = torch.empty(32 * 1024 * 1024, dtype=torch.int8, device='cuda')
+            del tmp_tensor
+            with self.assertRaisesRegex(RuntimeError, "out of memory"):
+                torch.empty(128 * 1024 * 1024, dtype=torch.int8, device='cuda')
+        finally:
+            torch.cuda.set_per_process_memory_limit(0, 0)
+            torch.cuda.empty_cache()
+
+        # going over the soft limit releases the cached blocks, but the
+        # allocation succeeds
+        torch.cuda.set_per_process_soft_memory_limit(32 * 1024 * 1024, 0)
+        try:
+            cached = torch.empty(24 * 1024 * 1024, dtype=torch.int8, device='cuda')
+            del cached
+            tensor = torch.empty(64 * 1024 * 1024, dtype=torch.int8, device='cuda')
+            self.assertLessEqual(torch.cuda.memory_reserved(0), torch.cuda.memory_allocated(0) + 2 * 1024 * 1024)
+            del tensor
+        finally:
+            torch.cuda.set_per_process_soft_memory_limit(0, 0)
+            torch.cuda.empty_cache()
+
+    def test_memory_history(self):
+        gc.collect()
+        torch.cuda.empty_cache()
+        torch.cuda.record_memory_history(True, max_entries=4)
+        try:
+            x = torch.empty(1024 * 1024 * 4, device='cuda')
+            address = x.data_ptr()
+            del x
+            torch.cuda.empty_cache()
+            history = torch.cuda.memory_history()
+            actions = [entry['action'] for entry in history]
+            self.assertEqual(actions, ['segment_map', 'alloc', 'free', 'segment_unmap'])
+            self.assertEqual(history[1]['address'], address)
+            self.assertEqual(history[1]['size'], history[2]['size'])
+
+            # the ring buffer keeps only the most recent entries
+            y = torch.empty(1024, device='cuda')
+            del y
+            self.assertEqual(len(torch.cuda.memory_history()), 4)
+            self.assertEqual(torch.cuda.memory_history()[-1]['action'], 'free')
+        finally:
+            torch.cuda.record_memory_history(False)
+        self.assertEqual(torch.cuda.memory_history(), [])
+
     def test_memory_allocation(self):
         gc.collect()
         torch.cuda.empty_cache()
@@ -476,6 +561,21 @@ class TestCuda(TestCase):
         x2 = torch.zeros(5, 5, device=d0)
         self._test_copy_sync_current_stream(x0, x2)
 
+    @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
+    def test_copy_strided_cross_device(self):
+        # Copies converting to a wider dtype may run on the destination, and
+        # copies without P2P above 32MB are staged in chunks, including along
+        # broadcast dimensions.
+        for src_dtype, dst_dtype in [(torch.float, torch.float), (torch.half, torch.float),
+                                     (torch.float, torch.half), (torch.int32, torch.double)]:
+            for src_device, dst_device in [('cuda:0', 'cuda:1'), ('cuda:1', 'cuda:0')]:
+                x = torch.randint(-64, 64, (1025, 8193), device=src_device, dtype=src_dtype)
+                for src in [x, x.t(), x[:, ::2], x[:1].expand(1025, 8193)]:
+                    dst = torch.empty(src.shape, device=dst_device, dtype=dst_dtype).t().contiguous().t()
+                    dst.copy_(src)
+                    self.assertEqual(dst.cpu(), src.cpu().to(dst_dtype))
+                    self.assertEqual(src.to(dst_device, dst_dtype).cpu(), src.cpu().to(dst_dtype))
+
     def test_copy_non_blocking(self):
         def _test_copy_non_blocking(a, b):
             event = torch.cuda.Event()
@@ -536,6 +636,39 @@ class TestCuda(TestCase):
         self.assertEqual(torch._C._get_cublas_allow_tf32(), not orig)
         torch.backends.cuda.matmul.allow_tf32 = orig
 
+    def test_copy_streams_get_set(self):
+        orig = torch.backends.cuda.copy.use_copy_streams
+        self.assertEqual(torch._C._get_cuda_copy_streams(), orig)
+        torch.backends.cuda.copy.use_copy_streams = not orig
+        self.assertEqual(torch._C._get_cuda_copy_streams(), not orig)
+        torch.backends.cuda.copy.use_copy_streams = orig
+
+    def test_copy_streams(self):
+        orig = torch.backends.cuda.copy.use_copy_streams
+        torch.backends.cuda.copy.use_copy_streams = True
+        try:
+            for stream in [torch.cuda.current_stream(), torch.cuda.Stream()]:
+                with torch.cuda.stream(stream):
+                    # Keep the current stream busy while copying.
+                    a = torch.randn(1024, 1024, device='cuda')
+                    for _ in range(10):
+                        a = a.mm(a).div_(1024)
+
+                    x = torch.randn(1000, 1000).pin_memory()
+                    y = x.to('cuda', non_blocking=True)
+                    self.assertEqual((y * 2).cpu(), x * 2)
+
+                    x = torch.randn(10, 20)[:, ::2]
+                    y = x.to('cuda', torch.double, non_blocking=True)
+                    self.assertEqual(y.cpu(), x.double())
+
+                    z = (a * 2).to('cpu', non_blocking=True)
+                    self.assertTrue(z.is_pinned())
+                    stream.synchronize()
+                    self.assertEqual(z, (a * 2).cpu())
+        finally:
+            torch.backends.cuda.copy.use_copy_streams = orig
+
     def test_type_conversions(self):
         x = torch.randn(5, 5)
         self.assertIsInstance(x.float(), torch.FloatTensor)
@@ -1329,6 +1462,179 @@ class TestCuda(TestCase):
         # cached blocks in case it affects future tests.
         torch.cuda.empty_cache()
 
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_capture_simple(self):
+        s = torch.cuda.Stream()
+
+        with torch.cuda.stream(s):
+            a = torch.full((1000,), 1, device="cuda")
+            g = torch.cuda.CUDAGraph()
+            g.capture_begin()
+            b = a
+            for _ in range(10):
+                b = b + 1
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        # nothing ran during capture
+        g.replay()
+        self.assertEqual(b.sum().item(), 11000.)
+
+        a.fill_(5)
+        g.replay()
+        self.assertEqual(b.sum().item(), 15000.)
+
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_rng_functional(self):
+        ops_with_kwargs = ((torch.nn.functional.dropout, {"p": 0.1}),
+                           (torch.nn.functional.dropout, {"p": 0.5}),)
+        size = 10000
+
+        for op, kwargs in ops_with_kwargs:
+            a = torch.randn((size,), device="cuda", dtype=torch.float)
+
+            # Control
+            torch.cuda.manual_seed(5)
+            eager_out = a
+            for _ in range(6):
+                eager_out = op(eager_out, **kwargs)
+
+            graph_in = a.clone()
+            stream = torch.cuda.Stream()
+            stream.wait_stream(torch.cuda.current_stream())
+            with torch.cuda.stream(stream):
+                torch.cuda.manual_seed(5)
+
+                g = torch.cuda.CUDAGraph()
+                torch.cuda.empty_cache()
+                g.capture_begin()
+                graph_out = graph_in
+                for _ in range(2):
+                    graph_out = op(graph_out, **kwargs)
+                g.capture_end()
+            torch.cuda.current_stream().wait_stream(stream)
+
+            # Runs a graphed->eager->graphed sequence of RNG ops.
+            # replay() plays 2 invocations of the op, so the sequence has 6
+            # invocations total, matching Control.
+            # replay() reads from graph_in and writes to graph_out.
+            g.replay()
+            out = op(graph_out, **kwargs)
+            out = op(out, **kwargs)
+            graph_in.copy_(out)
+            g.replay()
+
+            # If replay() updated RNG state correctly, graph_out
+            # should now hold data equal to eager_out.
+            self.assertEqual(eager_out, graph_out)
+
+            # We hold references to all tensors used across streams up til this sync,
+            # so no need to call record_stream on those tensors.
+            torch.cuda.synchronize()
+
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_rng_distributions(self):
+        size = 10000
+        input = torch.rand((size,), device="cuda", dtype=torch.float)
+
+        for op in ("uniform_", "normal_", "exponential_", "cauchy_", "geometric_", "log_normal_", "bernoulli_"):
+            kwargs = {}
+            if op == "geometric_":
+                kwargs = {"p": 0.2}
+            elif op == "bernoulli_":
+                kwargs = {"p": torch.rand_like(input)}
+
+            # Control: two eager invocations
+            torch.cuda.manual_seed(5)
+            control = input.clone()
+            getattr(control, op)(**kwargs)
+            control_1 = control.clone()
+            getattr(control, op)(**kwargs)
+            control_2 = control.clone()
+
+            stream = torch.cuda.Stream()
+            stream.wait_stream(torch.cuda.current_stream())
+            with torch.cuda.stream(stream):
+                torch.cuda.manual_seed(5)
+                static = input.clone()
+                g = torch.cuda.CUDAGraph()
+                g.capture_begin()
+                getattr(static, op)(**kwargs)
+                g.capture_end()
+            torch.cuda.current_stream().wait_stream(stream)
+
+            # Each replay draws the numbers the matching eager call drew
+            g.replay()
+            self.assertEqual(static, control_1)
+            g.replay()
+            self.assertEqual(static, control_2)
+            torch.cuda.synchronize()
+
+    def test_rng_offsets_from_threads(self):
+        # Random ops reserve their philox offsets without taking the generator
+        # lock, so ops issued from several threads must still advance the
+        # generator by their total increment.
+        num_threads = 4
+        ops_per_thread = 50
+        input = torch.randn(1000, device="cuda")
+
+        def run_dropouts(count):
+            for _ in range(count):
+                torch.nn.functional.dropout(input, p=0.5)
+
+        torch.cuda.manual_seed(5)
+        run_dropouts(num_threads * ops_per_thread)
+        expected = torch.rand(1000, device="cuda")
+
+        torch.cuda.manual_seed(5)
+        threads = [threading.Thread(target=run_dropouts, args=(ops_per_thread,))
+                   for _ in range(num_threads)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        torch.cuda.synchronize()
+        self.assertEqual(torch.rand(1000, device="cuda"), expected)
+
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_memory_pool(self):
+        s = torch.cuda.Stream()
+        kSmallSize = 1048576
+
+        for numel in (kSmallSize // 4 // 8, 2 * kSmallSize // 4):
+            a = torch.ones((numel,), device="cuda")
+
+            with torch.cuda.stream(s):
+                g0 = torch.cuda.CUDAGraph()
+                g0.capture_begin()
+                b = a * 2
+                c = b + 1
+                del b
+                g0.capture_end()
+
+                g1 = torch.cuda.CUDAGraph()
+                g1.capture_begin(g0.pool())
+                d = c * 3
+                g1.capture_end()
+            torch.cuda.current_stream().wait_stream(s)
+
+            # Memory used during capture is not handed out outside of it:
+            # replays keep writing c and d.
+            e = torch.zeros((numel,), device="cuda")
+            g0.replay()
+            g1.replay()
+            self.assertEqual(c.sum().item(), 3 * numel)
+            self.assertEqual(d.sum().item(), 9 * numel)
+            self.assertEqual(e.sum().item(), 0)
+            torch.cuda.synchronize()
+
+            reserved_before = torch.cuda.memory_reserved()
+            del c, d, g0, g1
+            torch.cuda.synchronize()
+            torch.cuda.empty_cache()
+            # The pool is released once both graphs are gone
+            self.assertLess(torch.cuda.memory_reserved(), reserved_before)
+
     # Tests for historic illegal memory access, see #17040.
     def test_reduction_gpu_memory_accessing(self):
         x = torch.ones(512, 8, dtype=torch.float32, device='cuda')
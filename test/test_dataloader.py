@@ -1742,6 +1742,29 @@ except RuntimeError as e:
 
         self.assertTrue((tensor == tensor.new_tensor([[0, 1], [2, 3], [4, 5], [6, 7]])).all().item())
 
+    def test_default_collate_nested_fast_path(self):
+        batch = [{'x': torch.full((2, 3), i), 'y': (i, float(i), 'name'),
+                  'z': [torch.tensor([i]), torch.ones(1, requires_grad=True)]}
+                 for i in range(4)]
+        fast = _utils.collate.default_collate(batch)
+        python = _utils.collate._default_collate_python(batch)
+        self.assertEqual(fast.keys(), python.keys())
+        self.assertEqual(fast['x'], torch.stack([b['x'] for b in batch]))
+        self.assertEqual(fast['x'], python['x'])
+        self.assertEqual(fast['y'][0], torch.arange(4))
+        self.assertEqual(fast['y'][1].dtype, torch.float64)
+        self.assertEqual(fast['y'][2], ['name'] * 4)
+        self.assertEqual(fast['z'][0], torch.arange(4).view(4, 1))
+        # Tensors which require grad go through torch.stack.
+        self.assertTrue(fast['z'][1].requires_grad)
+
+        if TEST_CUDA:
+            pinned = torch._C._collate([torch.ones(2), torch.zeros(2)],
+                                       _utils.collate._default_collate_python,
+                                       False, True)
+            self.assertEqual(pinned, torch.tensor([[1., 1.], [0., 0.]]))
+            self.assertTrue(pinned.is_pinned())
+
     def test_default_collate_bad_sequence_type(self):
         batch = [['X'], ['X', 'X']]
         self.assertRaises(RuntimeError, lambda: _utils.collate.default_collate(batch))
@@ -0,0 +1,158 @@
+import torch
+from torch.testing._internal.common_utils import TestCase, run_tests, load_tests
+from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes, dtypesIfCUDA
+
+# load_tests from torch.testing._internal.common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+class TestForeach(TestCase):
+    # Lists long enough, and tensors large enough, for the CUDA kernels to span
+    # several launches and several chunks per tensor.
+    N_values = [1, 20, 150]
+    sizes = [(1,), (3, 5), (70000,)]
+
+    binary_ops = [
+        (torch._foreach_add, torch._foreach_add_, torch.add),
+        (torch._foreach_sub, torch._foreach_sub_, torch.sub),
+        (torch._foreach_mul, torch._foreach_mul_, torch.mul),
+        (torch._foreach_div, torch._foreach_div_, torch.div),
+    ]
+
+    unary_ops = [
+        (torch._foreach_sqrt, torch._foreach_sqrt_, torch.sqrt),
+        (torch._foreach_exp, torch._foreach_exp_, torch.exp),
+    ]
+
+    pointwise_ops = [
+        (torch._foreach_addcmul, torch._foreach_addcmul_, torch.addcmul),
+        (torch._foreach_addcdiv, torch._foreach_addcdiv_, torch.addcdiv),
+    ]
+
+    def _make_tensors(self, N, device, dtype, low=1, high=3):
+        return [torch.empty(self.sizes[i % len(self.sizes)], device=device, dtype=dtype).uniform_(low, high)
+                for i in range(N)]
+
+    def _check_lists(self, actual, expected, dtype):
+        self.assertEqual(len(actual), len(expected))
+        for a, e in zip(actual, expected):
+            if dtype in (torch.half, torch.bfloat16):
+                self.assertEqual(a, e, atol=1e-3, rtol=1e-3)
+            else:
+                self.assertEqual(a, e)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.bfloat16, torch.float, torch.double)
+    def test_binary_op_scalar(self, device, dtype):
+        for N in self.N_values:
+            for foreach_op, foreach_op_, torch_op in self.binary_ops:
+                tensors = self._make_tensors(N, device, dtype)
+                expected = [torch_op(t, 2.5) for t in tensors]
+
+                self._check_lists(foreach_op(tensors, 2.5), expected, dtype)
+                foreach_op_(tensors, 2.5)
+                self._check_lists(tensors, expected, dtype)
+
+    @dtypes(torch.int32, torch.int64)
+    def test_binary_op_scalar_integral(self, device, dtype):
+        for foreach_op, foreach_op_, torch_op in self.binary_ops[:3]:
+            tensors = [torch.arange(10, device=device, dtype=dtype) for _ in range(20)]
+            expected = [torch_op(t, 3) for t in tensors]
+
+            self._check_lists(foreach_op(tensors, 3), expected, dtype)
+            foreach_op_(tensors, 3)
+            self._check_lists(tensors, expected, dtype)
+
+            # A floating point scalar promotes like the regular op, which
+            # fails in place.
+            self._check_lists(foreach_op(tensors, 1.5), [torch_op(t, 1.5) for t in tensors], dtype)
+            with self.assertRaises(RuntimeError):
+                foreach_op_(tensors, 1.5)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.bfloat16, torch.float, torch.double)
+    def test_binary_op_list(self, device, dtype):
+        for N in self.N_values:
+            for foreach_op, foreach_op_, torch_op in self.binary_ops:
+                tensors1 = self._make_tensors(N, device, dtype)
+                tensors2 = self._make_tensors(N, device, dtype)
+                expected = [torch_op(t1, t2) for t1, t2 in zip(tensors1, tensors2)]
+
+                self._check_lists(foreach_op(tensors1, tensors2), expected, dtype)
+                foreach_op_(tensors1, tensors2)
+                self._check_lists(tensors1, expected, dtype)
+
+    @dtypes(torch.float, torch.double)
+    def test_binary_op_list_alpha(self, device, dtype):
+        for foreach_op, foreach_op_, torch_op in self.binary_ops[:2]:
+            tensors1 = self._make_tensors(30, device, dtype)
+            tensors2 = self._make_tensors(30, device, dtype)
+            expected = [torch_op(t1, t2, alpha=0.5) for t1, t2 in zip(tensors1, tensors2)]
+
+            self._check_lists(foreach_op(tensors1, tensors2, alpha=0.5), expected, dtype)
+            foreach_op_(tensors1, tensors2, alpha=0.5)
+            self._check_lists(tensors1, expected, dtype)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.bfloat16, torch.float, torch.double)
+    def test_unary_op(self, device, dtype):
+        for N in self.N_values:
+            for foreach_op, foreach_op_, torch_op in self.unary_ops:
+                tensors = self._make_tensors(N, device, dtype)
+                expected = [torch_op(t) for t in tensors]
+
+                self._check_lists(foreach_op(tensors), expected, dtype)
+                foreach_op_(tensors)
+                self._check_lists(tensors, expected, dtype)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.bfloat16, torch.float, torch.double)
+    def test_pointwise_op(self, device, dtype):
+        for N in self.N_values:
+            for foreach_op, foreach_op_, torch_op in self.pointwise_ops:
+                tensors = self._make_tensors(N, device, dtype)
+                tensors1 = self._make_tensors(N, device, dtype)
+                tensors2 = self._make_tensors(N, device, dtype)
+                expected = [torch_op(t, t1, t2, value=-0.5) for t, t1, t2 in zip(tensors, tensors1, tensors2)]
+
+                self._check_lists(foreach_op(tensors, tensors1, tensors2, -0.5), expected, dtype)
+                foreach_op_(tensors, tensors1, tensors2, -0.5)
+                self._check_lists(tensors, expected, dtype)
+
+    @dtypes(torch.float)
+    def test_slow_path(self, device, dtype):
+        # Non-contiguous tensors, empty tensors, tensors with different layouts
+        # than their partner and mixed dtypes may not take the multi tensor
+        # apply kernels, but must give the same results.
+        base = torch.rand(20, 20, device=device, dtype=dtype)
+        cases = [
+            ([base.t(), base[::2]], [torch.rand(20, 20, device=device, dtype=dtype).t(),
+                                     torch.rand(10, 20, device=device, dtype=dtype)]),
+            ([torch.rand(0, device=device), torch.rand(5, device=device)],
+             [torch.rand(0, device=device), torch.rand(5, device=device)]),
+            ([torch.rand(4, 5, device=device)], [torch.rand(5, 4, device=device).t()]),
+            ([torch.rand(3, device=device), torch.rand(3, device=device, dtype=torch.double)],
+             [torch.rand(3, device=device), torch.rand(3, device=device, dtype=torch.double)]),
+        ]
+        for tensors1, tensors2 in cases:
+            expected = [t1 + t2 for t1, t2 in zip(tensors1, tensors2)]
+            self.assertEqual(torch._foreach_add(tensors1, tensors2), expected)
+
+            tensors1 = [t.clone() for t in tensors1]
+            torch._foreach_add_(tensors1, tensors2)
+            self.assertEqual(tensors1, expected)
+
+    def test_errors(self, device):
+        tensors = [torch.rand(3, device=device) for _ in range(3)]
+        with self.assertRaises(RuntimeError):
+            torch._foreach_add([], 1)
+        with self.assertRaisesRegex(RuntimeError, "same number of tensors"):
+            torch._foreach_add(tensors, tensors[:2])
+        with self.assertRaisesRegex(RuntimeError, "same size"):
+            torch._foreach_mul_(tensors, [torch.rand(3, device=device), torch.rand(3, device=device),
+                                          torch.rand(4, device=device)])
+
+instantiate_device_type_tests(TestForeach, globals())
+
+if __name__ == '__main__':
+    run_tests()
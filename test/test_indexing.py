@@ -30,6 +30,32 @@ class TestIndexing(TestCase):
         self.assertEqual(v[::11].tolist(), [0])
         self.assertEqual(v[1:6:2].tolist(), [1, 3, 5])
 
+    def test_basic_indexing_views(self, device):
+        base = torch.randn(6, 8, 10, device=device)
+        v = base.transpose(0, 2)[1:]
+        cases = [
+            ((slice(None), 3, slice(1, 5)), v[:, 3].narrow(1, 1, 4)),
+            ((-1, slice(None, None, 3)), v.select(0, -1)[::3]),
+            ((None, Ellipsis, 2, None), v.select(2, 2).unsqueeze(0).unsqueeze(-1)),
+            ((slice(-100, 100, 2), Ellipsis), v[::2]),
+            ((slice(5, 2), 0), v[5:2].select(1, 0)),
+            ((Ellipsis,), v),
+        ]
+        for index, expected in cases:
+            result = v[index]
+            self.assertEqual(result.shape, expected.shape)
+            self.assertEqual(result, expected)
+            self.assertIs(result._base, base)
+
+        x = torch.randn(4, 5, 6, device=device, requires_grad=True)
+        x[:, 3, 1:5].sum().backward()
+        expected = torch.zeros(4, 5, 6, device=device)
+        expected[:, 3, 1:5] = 1
+        self.assertEqual(x.grad, expected)
+
+        with self.assertRaisesRegex(IndexError, "out of range"):
+            v[0, 10]
+
     def test_step_assignment(self, device):
         v = torch.zeros(4, 4, device=device)
         v[0, 1::2] = torch.tensor([3., 4.], device=device)
@@ -51,7 +51,7 @@ from torch.testing._internal import jit_utils
 from torch.testing._internal.common_utils import run_tests, IS_WINDOWS, TEST_WITH_UBSAN, \
     suppress_warnings, IS_SANDCASTLE, GRAPH_EXECUTOR, ProfilingMode, \
     freeze_rng_state, set_rng_seed, slowTest, TemporaryFileName, skipIfCompiledWithoutNumpy, \
-    enable_profiling_mode_for_profiling_tests, TEST_MKL, set_default_dtype, num_profiled_runs
+    enable_profiling_mode_for_profiling_tests, set_default_dtype, num_profiled_runs
 from torch.testing._internal.jit_utils import JitTestCase, enable_cpu_fuser, disable_autodiff_subgraph_inlining, \
     _trace, enable_cpu_fuser_if, do_input_map, get_execution_plan, \
     execWrapper, _inline_everything, _tmp_donotuse_dont_inline_everything, \
@@ -669,6 +669,83 @@ class TestJit(JitTestCase):
         torch.testing.assert_allclose(orig_res, a_copy)
 
     @unittest.skipIf(GRAPH_EXECUTOR == ProfilingMode.SIMPLE, "Simple executor doesn't have shape information")
+    def test_dropout_add_layer_norm_fusion(self):
+        class M(torch.nn.Module):
+            __constants__ = ['residual_first']
+
+            def __init__(self, residual_first):
+                super(M, self).__init__()
+                self.residual_first = residual_first
+                self.dropout = torch.nn.Dropout(0.1)
+                self.norm = torch.nn.LayerNorm(11)
+
+            def forward(self, x, r):
+                if self.residual_first:
+                    s = r + self.dropout(x)
+                else:
+                    s = self.dropout(x) + r
+                return self.norm(s)
+
+        x = torch.rand((7, 11))
+        r = torch.rand((7, 11))
+        for residual_first in [False, True]:
+            m = torch.jit.script(M(residual_first)).eval()
+            orig_res = m(x, r)
+            torch._C._jit_pass_inline(m.graph)
+            torch._C._jit_pass_constant_propagation(m.graph)
+            torch._C._jit_pass_fuse_dropout_add_layer_norm(m.graph)
+            buffer = io.BytesIO()
+            torch.jit.save(m, buffer)
+            buffer.seek(0)
+            m = torch.jit.load(buffer)
+            FileCheck().check_not("aten::dropout(") \
+                .check_not("aten::layer_norm(") \
+                .check("aten::dropout_add_layer_norm(") \
+                .run(m.graph)
+            torch.testing.assert_allclose(orig_res, m(x, r))
+
+        # The sum is used by something else than the layer norm.
+        @torch.jit.script
+        def f(x, r, w, b):
+            s = torch.dropout(x, 0.1, False) + r
+            return torch.layer_norm(s, [11], w, b), s
+
+        torch._C._jit_pass_fuse_dropout_add_layer_norm(f.graph)
+        FileCheck().check_not("aten::dropout_add_layer_norm(").run(f.graph)
+
+    def test_addmm_activation_fusion(self):
+        @torch.jit.script
+        def addmm_relu(b, x, w):
+            return torch.relu(torch.addmm(b, x, w, beta=0.5))
+
+        b = torch.rand(5)
+        x = torch.rand((3, 4))
+        w = torch.rand((4, 5))
+        orig_res = addmm_relu(b, x, w)
+        torch._C._jit_pass_fuse_addmm_activation(addmm_relu.graph)
+        FileCheck().check_not("aten::addmm(") \
+            .check_not("aten::relu(") \
+            .check("aten::_addmm_activation(") \
+            .run(addmm_relu.graph)
+        torch.testing.assert_allclose(orig_res, addmm_relu(b, x, w))
+
+        # linear is only an addmm for the 2-D inputs a trace records.
+        m = torch.nn.Sequential(torch.nn.Linear(4, 5), torch.nn.ReLU())
+        traced = torch.jit.trace(m, (x,))
+        torch._C._jit_pass_inline(traced.graph)
+        torch._C._jit_pass_fuse_linear(traced.graph)
+        torch._C._jit_pass_fuse_addmm_activation(traced.graph)
+        FileCheck().check_not("aten::linear(") \
+            .check("aten::_addmm_activation(") \
+            .run(traced.graph)
+        torch.testing.assert_allclose(m(x), traced(x))
+
+        traced = torch.jit.trace(m, (torch.rand((2, 3, 4)),))
+        torch._C._jit_pass_inline(traced.graph)
+        torch._C._jit_pass_fuse_linear(traced.graph)
+        torch._C._jit_pass_fuse_addmm_activation(traced.graph)
+        FileCheck().check_not("aten::_addmm_activation(").run(traced.graph)
+
     def test_peephole_optimize_shape_ops(self):
         def test_input(func, input, result):
             # if result == 2 we will trigger a bailout and
@@ -2742,6 +2819,62 @@ class TestScript(JitTestCase):
                 FileCheck().check_not("Double(1:2, 2:1, requires_grad=0, device=cpu) = ").run(graph_str)
 
 
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING, "skip if profiling isn't enabled")
+    def test_out_variants_in_loop(self):
+        @torch.jit.script
+        def fn(x, w, n: int):
+            acc = torch.zeros_like(x)
+            for _ in range(n):
+                y = torch.mm(x, w)
+                acc = acc + torch.tanh(y)
+            return acc
+
+        x, w = torch.randn(4, 4), torch.randn(4, 4)
+        with enable_profiling_mode_for_profiling_tests():
+            for _ in range(3):
+                self.assertEqual(fn(x, w, 3), torch.tanh(x.mm(w)) * 3)
+            g = torch.jit.last_executed_optimized_graph()
+            # mm writes into a buffer allocated before the loop, acc is loop
+            # carried
+            FileCheck().check("aten::empty_strided").check("prim::Loop").check("aten::mm").run(g)
+            self.assertTrue(all(n.inputsSize() == 3 for n in g.findAllNodes("aten::mm")))
+
+            # the buffers have the profiled strides, so the outputs keep the
+            # layout of eager mode
+            @torch.jit.script
+            def fn_channels_last(x, n: int):
+                acc = torch.zeros_like(x)
+                stride = 0
+                for _ in range(n):
+                    y = torch.sigmoid(x)
+                    stride += y.stride(1)
+                    acc = acc + y
+                return acc, stride
+
+            x = torch.randn(2, 3, 4, 5).contiguous(memory_format=torch.channels_last)
+            for _ in range(3):
+                result, stride = fn_channels_last(x, 2)
+                self.assertEqual(result, torch.sigmoid(x) * 2)
+                self.assertEqual(stride, torch.sigmoid(x).stride(1) * 2)
+            g = torch.jit.last_executed_optimized_graph()
+            self.assertTrue(any(n.inputsSize() == 2 for n in g.findAllNodes("aten::sigmoid")))
+
+            torch._C._jit_set_out_variants_enabled(False)
+            try:
+                @torch.jit.script
+                def fn2(x, w, n: int):
+                    acc = torch.zeros_like(x)
+                    for _ in range(n):
+                        acc = acc + torch.mm(x, w)
+                    return acc
+
+                fn2(x, w, 2)
+                fn2(x, w, 2)
+                g = torch.jit.last_executed_optimized_graph()
+                self.assertTrue(all(n.inputsSize() == 2 for n in g.findAllNodes("aten::mm")))
+            finally:
+                torch._C._jit_set_out_variants_enabled(True)
+
     def test_nested_bailouts(self):
         @torch.jit.script
         def fct_loop(x):
@@ -6292,6 +6425,50 @@ a")
         inputs = self._make_scalar_vars([4321, 1234], torch.int64)
         self.checkScript(func, inputs)
 
+    def test_script_stack_native_ops(self):
+        # add, mul, relu, linear, conv2d, cat and view skip the boxed
+        # calling convention, see register_c10_ops.cpp
+        def fn(x, w, b, cw):
+            y = torch.add(x, x, alpha=2) * x
+            y = torch.nn.functional.linear(y.relu(), w, b) + torch.nn.functional.linear(y, w)
+            z = torch.conv2d(y.view(1, 1, 4, 4), cw, None, [1, 1], [1, 1], [1, 1], 1)
+            return torch.cat([z.view(-1), y.view(-1)], 0)
+
+        inputs = (torch.randn(4, 3), torch.randn(4, 3), torch.randn(4), torch.randn(1, 1, 3, 3))
+        self.checkScript(fn, inputs)
+
+    def test_static_runtime(self):
+        class M(torch.nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.w1 = torch.nn.Parameter(torch.randn(16, 8))
+                self.b1 = torch.nn.Parameter(torch.randn(16))
+                self.w2 = torch.nn.Parameter(torch.randn(8, 16))
+
+            def forward(self, x, y):
+                # nn.Linear branches on the input rank, which StaticRuntime
+                # doesn't support
+                a = torch.addmm(self.b1, x, self.w1.t()).relu()
+                b = torch.sigmoid(torch.mm(a, self.w2.t())) * y
+                c = torch.cat([b, a.tanh()], 1)
+                return c + 1, b
+
+        m = torch.jit.freeze(torch.jit.script(M().eval()))
+        runtime = torch._C.StaticRuntime(m._c)
+        x, y = torch.randn(4, 8), torch.randn(4, 8)
+        for _ in range(3):
+            self.assertEqual(runtime.run([x, y]), m(x, y))
+        self.assertGreater(runtime.num_planned_values, 0)
+        self.assertGreater(runtime.arena_bytes, 0)
+
+        # New input shapes are planned again
+        x, y = torch.randn(2, 8), torch.randn(2, 8)
+        for _ in range(2):
+            self.assertEqual(runtime.run([x, y]), m(x, y))
+
+        with self.assertRaisesRegex(RuntimeError, "frozen"):
+            torch._C.StaticRuntime(torch.jit.script(M())._c)
+
     def test_script_optional_none(self):
         def none_stmt(x):
             output = None
@@ -8565,7 +8742,6 @@ a")
         self.assertTrue(imported.unpack_called.item())
         torch.testing.assert_allclose(imported(x), x + torch.neg(torch.ones(3, 4, dtype=torch.float)))
 
-    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
     def test_torch_functional(self):
         def stft(input, n_fft):
             # type: (Tensor, int) -> Tensor
@@ -10473,6 +10649,41 @@ a")
             self.assertEqual(torch.autograd.grad(sout.sum(), inputs),
                              torch.autograd.grad(out.sum(), inputs))
 
+    def test_batch_independent_ops(self):
+        def fn(x, y, w1, w2, b1, b2, t1, t2, i1, i2, o1, o2, c1, c2, k1, k2):
+            l1 = torch._C._nn.linear(x, w1, b1)
+            l2 = torch._C._nn.linear(x, w2, b2)
+            l3 = torch._C._nn.linear(y, w1, b1)
+            l4 = torch._C._nn.linear(x, w2, b1)
+            e1, _, _, _ = torch.embedding_bag(t1, i1, o1, False, 1, False, None, False)
+            e2, _, _, _ = torch.embedding_bag(t2, i2, o2, False, 1, False, None, False)
+            r1 = torch.conv2d(c1, k1, None, 1, 1)
+            r2 = torch.conv2d(c2, k2, None, 1, 1)
+            return torch.tanh(l1), torch.tanh(l2), l3, l4, e1, e2, r1, r2
+
+        inputs = (torch.randn(4, 8), torch.randn(4, 8),
+                  torch.randn(8, 8), torch.randn(8, 8), torch.randn(8), torch.randn(8),
+                  torch.randn(10, 3), torch.randn(20, 3),
+                  torch.tensor([1, 2, 9, 0]), torch.tensor([19, 4, 5]),
+                  torch.tensor([0, 2]), torch.tensor([0, 0]),
+                  torch.randn(1, 2, 5, 5), torch.randn(1, 2, 5, 5),
+                  torch.randn(3, 2, 3, 3), torch.randn(3, 2, 3, 3))
+        graph = torch.jit.script(fn).graph
+        torch._C._jit_pass_lower_all_tuples(graph)
+        torch._C._jit_pass_dce(graph)
+        torch._C._jit_pass_batch_mm(graph)
+        FileCheck().check_not("aten::linear").check_not("aten::embedding_bag") \
+            .check_not("aten::conv2d").check_not("aten::tanh").run(str(graph))
+        FileCheck().check_count("prim::BatchedLinear", 1, exactly=True) \
+            .check("prim::BatchedEmbeddingBag").check("prim::BatchedConv2d") \
+            .check("prim::BatchedPointwise").run(str(graph))
+
+        batched = torch._C._create_function_from_graph("batched", graph)
+        self.assertEqual(batched(*inputs), fn(*inputs))
+        # Mismatching shapes go through the unbatched ops
+        inputs = inputs[:1] + (torch.randn(5, 8),) + inputs[2:]
+        self.assertEqual(batched(*inputs), fn(*inputs))
+
     def test_loop_unrolling(self):
         def fn(x):
             y = 0
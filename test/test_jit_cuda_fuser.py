@@ -498,6 +498,33 @@ class TestCudaFuser(JitTestCase):
             self.assertEqual(oo, jit_oo)
         self.assertGraphContains(t_jit.graph_for(x, y, z), FUSION_GROUP)
 
+    @unittest.skipIf(not RUN_CUDA, "requires CUDA")
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING and GRAPH_EXECUTOR !=
+                     ProfilingMode.LEGACY, "Requires fusion optimization pass to be effective")
+    @skipIfRocm
+    def test_linear_epilogue(self):
+        dtype = torch.float
+        device = "cuda"
+        x = torch.randn([4, 16, 32], dtype=dtype, device=device)
+        w = torch.randn([64, 32], dtype=dtype, device=device)
+        r = torch.randn([4, 16, 64], dtype=dtype, device=device)
+
+        def t(x: torch.Tensor, w: torch.Tensor, r: torch.Tensor):
+            o = torch.nn.functional.linear(x, w)
+            o = torch.add(o, r)
+            o = torch.relu(o)
+            return o
+        t_jit = torch.jit.script(t)
+        jit_o = t_jit(x, w, r)
+        jit_o = t_jit(x, w, r)
+        o = t(x, w, r)
+        self.assertEqual(o.dtype, jit_o.dtype)
+        self.assertEqual(o, jit_o)
+        graph = t_jit.graph_for(x, w, r)
+        self.assertGraphContains(graph, FUSION_GROUP)
+        fusion_groups = graph.findAllNodes(FUSION_GROUP)
+        self.assertGraphContains(fusion_groups[0].g('Subgraph'), 'aten::linear')
+
 
 class TestPassManagerCudaFuser(JitTestCase):
 
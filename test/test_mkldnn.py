@@ -630,5 +630,46 @@ class TestMkldnn(TestCase):
         self._test_imagenet_model(model)
 
 
+
+@unittest.skipIf(not torch.backends.mkldnn.is_bf16_supported(), "MKL-DNN has no bfloat16 kernels for this CPU")
+class TestAutocastCPU(TestCase):
+    def test_autocast_conv_linear_bf16(self):
+        conv = torch.nn.Conv2d(3, 8, 3, padding=1)
+        linear = torch.nn.Linear(8, 4)
+        x = torch.randn(2, 3, 6, 6)
+        with torch.no_grad():
+            with torch.cpu.amp.autocast():
+                y = conv(x)
+                self.assertEqual(y.dtype, torch.bfloat16)
+                z = linear(y.permute(0, 2, 3, 1))
+                self.assertEqual(z.dtype, torch.bfloat16)
+            self.assertFalse(torch.is_autocast_cpu_enabled())
+
+            y_ref = F.conv2d(x.bfloat16(), conv.weight.bfloat16(), conv.bias.bfloat16(), padding=1)
+            self.assertEqual(y, y_ref)
+            z_ref = F.linear(y_ref.permute(0, 2, 3, 1), linear.weight.bfloat16(), linear.bias.bfloat16())
+            self.assertEqual(z, z_ref)
+
+    def test_autocast_fp32_ops(self):
+        x = torch.randn(4, 8).bfloat16()
+        target = torch.randn(4, 8)
+        with torch.cpu.amp.autocast():
+            self.assertEqual(F.mse_loss(x, target).dtype, torch.float)
+            self.assertEqual(torch.softmax(x, 1).dtype, torch.float)
+            self.assertEqual(torch.sum(x).dtype, torch.float)
+            self.assertEqual(torch.cat((x, target)).dtype, torch.float)
+            # Ops autocast leaves alone keep their input types
+            self.assertEqual(torch.mm(x, x.t()).dtype, torch.bfloat16)
+            self.assertEqual(torch.mm(target, target.t()).dtype, torch.float)
+
+    def test_autocast_disabled_region(self):
+        linear = torch.nn.Linear(8, 4)
+        x = torch.randn(2, 8)
+        with torch.no_grad(), torch.cpu.amp.autocast():
+            with torch.cpu.amp.autocast(enabled=False):
+                self.assertEqual(linear(x).dtype, torch.float)
+            self.assertEqual(linear(x).dtype, torch.bfloat16)
+
+
 if __name__ == '__main__':
     run_tests()
@@ -156,6 +156,46 @@ class TestOptimizer(unittest.TestCase):
         self.assertNotEqual(preserveThis, None)
 
 
+    @unittest.skipUnless(torch.backends.xnnpack.enabled,
+                         " XNNPACK must be enabled for these tests."
+                         " Please build with USE_XNNPACK=1.")
+    def test_channels_last_regions(self):
+        class MyTestModule(torch.nn.Module):
+            def __init__(self):
+                super(MyTestModule, self).__init__()
+                self.conv1 = torch.nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = torch.nn.Conv2d(8, 8, 3, padding=1)
+                self.conv3 = torch.nn.Conv2d(16, 8, 1)
+                self.linear = torch.nn.Linear(8, 4)
+
+            def forward(self, x):
+                a = F.hardswish(self.conv1(x))
+                b = torch.sigmoid(self.conv2(a)) + a
+                o = torch.cat([a, b], dim=1)
+                o = F.avg_pool2d(self.conv3(o), 2)
+                o = F.adaptive_avg_pool2d(o, 1)
+                return self.linear(o.flatten(1)), b
+
+        scripted_model = torch.jit.script(MyTestModule())
+        scripted_model.eval()
+        input_data = torch.rand((2, 3, 16, 16))
+        initial_result = scripted_model(input_data)
+
+        # The input is converted to channels last once, and the tensors leaving
+        # the region, to flatten and to the output, back to contiguous.
+        optimized_scripted_model = optimize_for_mobile(scripted_model)
+        FileCheck().check_count("aten::contiguous", 3, exactly=True) \
+                   .run(optimized_scripted_model.graph)
+        optimized_result = optimized_scripted_model(input_data)
+        for initial, optimized in zip(initial_result, optimized_result):
+            self.assertTrue(optimized.is_contiguous())
+            torch.testing.assert_allclose(initial, optimized, rtol=1e-2, atol=1e-3)
+
+        optimization_blacklist_no_regions = {MobileOptimizerType.CHANNELS_LAST_REGIONS}
+        optimized_scripted_model_no_regions = optimize_for_mobile(scripted_model, optimization_blacklist_no_regions)
+        FileCheck().check_not("aten::contiguous") \
+                   .run(optimized_scripted_model_no_regions.graph)
+
     def test_generate_mobile_module_lints(self):
         class MyTestModule(torch.nn.Module):
             def __init__(self):
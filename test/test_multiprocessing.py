@@ -14,7 +14,7 @@ import torch.multiprocessing as mp
 import torch.utils.hooks
 from torch.nn import Parameter
 from torch.testing._internal.common_utils import (TestCase, run_tests, IS_WINDOWS, NO_MULTIPROCESSING_SPAWN, TEST_WITH_ASAN,
-                                                  load_tests, slowTest, TEST_WITH_TSAN)
+                                                  load_tests, slowTest, TEST_WITH_TSAN, TEST_WITH_ROCM)
 
 # load_tests from common_utils is used to automatically filter tests for
 # sharding on sandcastle. This line silences flake warnings
@@ -95,6 +95,14 @@ def receive_and_send(queue, out_queue, event, count):
     event.wait()
 
 
+def receive_and_ack(queue, out_queue, count):
+    for i in range(count):
+        t = queue.get()
+        s = t.sum().item()
+        del t
+        out_queue.put(s)
+
+
 def sum_tensors(inq, outq):
     with torch.cuda.device(1):
         tensors = inq.get()
@@ -506,6 +514,31 @@ class TestMultiprocessing(TestCase):
         # memory 'file' for performance reason
         torch.cuda.ipc_collect()
 
+    @unittest.skipIf(IS_WINDOWS, 'not applicable to Windows (only fails with fork)')
+    @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
+    def test_cuda_ipc_stats(self):
+        count = 10
+        ctx = mp.get_context('spawn')
+        queue = ctx.Queue()
+        out_queue = ctx.Queue()
+        p = ctx.Process(target=receive_and_ack, args=(queue, out_queue, count))
+        p.start()
+
+        before = torch.cuda.ipc_stats()
+        for i in range(count):
+            t = torch.full([5], i, device='cuda')
+            queue.put(t)
+            self.assertEqual(out_queue.get(), 5 * i)
+            # The consumer released the block, so its event can be reused.
+            del t
+        p.join()
+        after = torch.cuda.ipc_stats()
+
+        self.assertEqual(after['blocks_shared'] - before['blocks_shared'], count)
+        if not TEST_WITH_ROCM:
+            self.assertGreater(after['events_reused'] - before['events_reused'], 0)
+        self.assertEqual(after['blocks_in_limbo'], 0)
+
     @unittest.skipIf(IS_WINDOWS, 'not applicable to Windows (only fails with fork)')
     @unittest.skipIf(not torch.cuda.is_available(), 'CUDA not available')
     def test_cuda_bad_call(self):
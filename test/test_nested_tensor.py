@@ -0,0 +1,171 @@
+from torch.testing._internal.common_utils import TestCase, run_tests
+import torch
+import torch.nn.functional as F
+
+
+def padded_and_mask(components):
+    # The zero padded batch of `components`, and a mask of the rows that are padding
+    padded = torch.nn.utils.rnn.pad_sequence(components, batch_first=True)
+    lengths = torch.tensor([c.size(0) for c in components])
+    mask = torch.arange(padded.size(1)).unsqueeze(0) >= lengths.unsqueeze(1)
+    return padded, mask
+
+
+class TestNestedTensor(TestCase):
+    def random_components(self, lengths, *inner):
+        return [torch.randn(length, *inner, dtype=torch.double) for length in lengths]
+
+    def assertComponentsEqual(self, nt, expected):
+        self.assertTrue(nt.is_nested)
+        actual = nt.unbind()
+        self.assertEqual(len(actual), len(expected))
+        for a, e in zip(actual, expected):
+            self.assertEqual(a, e)
+
+    def test_construction(self):
+        components = self.random_components([3, 1, 0, 4], 2, 5)
+        nt = torch.nested_tensor(components)
+        self.assertTrue(nt.is_nested)
+        self.assertFalse(components[0].is_nested)
+        self.assertEqual(nt.shape, (4, 4, 2, 5))
+        self.assertEqual(nt.dim(), 4)
+        self.assertEqual(nt.size(-1), 5)
+        self.assertEqual(nt.dtype, torch.double)
+        self.assertComponentsEqual(nt, components)
+        self.assertIn('nested_tensor(', repr(nt))
+
+        with self.assertRaisesRegex(RuntimeError, 'non-empty list'):
+            torch.nested_tensor([])
+        with self.assertRaisesRegex(RuntimeError, 'at least one dim'):
+            torch.nested_tensor([torch.randn(())])
+        with self.assertRaisesRegex(RuntimeError, 'size of their first dim'):
+            torch.nested_tensor([torch.randn(2, 3), torch.randn(2, 4)])
+        with self.assertRaisesRegex(RuntimeError, 'same dtype and device'):
+            torch.nested_tensor([torch.randn(2, 3), torch.randn(2, 3, dtype=torch.double)])
+
+    def test_padded_conversions(self):
+        components = self.random_components([3, 1, 0, 4], 2)
+        padded, mask = padded_and_mask(components)
+        nt = torch.nested_tensor(components)
+        self.assertEqual(nt.to_padded_tensor(), padded)
+        filled = nt.to_padded_tensor(padding=-1.)
+        self.assertTrue((filled[mask] == -1).all())
+        self.assertEqual(filled[~mask], padded[~mask])
+
+        nt = torch.nested_tensor_from_padded(filled, [3, 1, 0, 4])
+        self.assertComponentsEqual(nt, components)
+
+        with self.assertRaisesRegex(RuntimeError, 'expected 4 lengths'):
+            torch.nested_tensor_from_padded(padded, [3, 1])
+        with self.assertRaisesRegex(RuntimeError, 'lengths must be in'):
+            torch.nested_tensor_from_padded(padded, [3, 1, 0, 5])
+        with self.assertRaisesRegex(RuntimeError, 'expected a nested tensor'):
+            padded.to_padded_tensor()
+
+    def test_pointwise(self):
+        components = self.random_components([3, 1, 4], 5)
+        others = self.random_components([3, 1, 4], 5)
+        bias = torch.randn(5, dtype=torch.double)
+        nt = torch.nested_tensor(components)
+        other = torch.nested_tensor(others)
+
+        for op in [torch.relu, torch.tanh, torch.sigmoid, torch.exp, torch.neg, F.gelu]:
+            self.assertComponentsEqual(op(nt), [op(c) for c in components])
+        self.assertComponentsEqual(nt + other, [c + o for c, o in zip(components, others)])
+        self.assertComponentsEqual(nt.sub(other, alpha=2), [c - 2 * o for c, o in zip(components, others)])
+        self.assertComponentsEqual(nt * bias, [c * bias for c in components])
+        self.assertComponentsEqual(bias / nt, [bias / c for c in components])
+        self.assertComponentsEqual(nt * 2, [c * 2 for c in components])
+
+        result = torch.nested_tensor(components)
+        result += bias
+        result.mul_(other)
+        self.assertComponentsEqual(result, [(c + bias) * o for c, o in zip(components, others)])
+
+        with self.assertRaisesRegex(RuntimeError, 'same component lengths'):
+            nt + torch.nested_tensor(self.random_components([1, 3, 4], 5))
+        with self.assertRaisesRegex(RuntimeError, 'dims past the ragged dim'):
+            nt + torch.randn(4, 5, dtype=torch.double)
+
+    def test_linear_and_layer_norm(self):
+        components = self.random_components([3, 1, 0, 4], 6)
+        nt = torch.nested_tensor(components)
+        weight = torch.randn(5, 6, dtype=torch.double)
+        bias = torch.randn(5, dtype=torch.double)
+        self.assertComponentsEqual(F.linear(nt, weight, bias), [F.linear(c, weight, bias) for c in components])
+        self.assertComponentsEqual(F.linear(nt, weight), [F.linear(c, weight) for c in components])
+        self.assertComponentsEqual(torch.matmul(nt, weight.t()), [c.matmul(weight.t()) for c in components])
+
+        ln_weight = torch.randn(6, dtype=torch.double)
+        ln_bias = torch.randn(6, dtype=torch.double)
+        self.assertComponentsEqual(
+            F.layer_norm(nt, [6], ln_weight, ln_bias),
+            [F.layer_norm(c, [6], ln_weight, ln_bias) for c in components])
+        with self.assertRaisesRegex(RuntimeError, 'dims past the ragged dim'):
+            F.layer_norm(nt, [4, 6])
+
+    def test_softmax(self):
+        components = self.random_components([3, 1, 4], 2, 5)
+        nt = torch.nested_tensor(components)
+        for dim in [1, 2, 3, -1]:
+            self.assertComponentsEqual(nt.softmax(dim), [c.softmax(dim - 1 if dim > 0 else dim) for c in components])
+            self.assertComponentsEqual(
+                torch.log_softmax(nt, dim), [torch.log_softmax(c, dim - 1 if dim > 0 else dim) for c in components])
+        with self.assertRaisesRegex(RuntimeError, 'batch dim'):
+            nt.softmax(0)
+
+    def test_embedding(self):
+        indices = [torch.randint(10, (length,)) for length in [3, 1, 4]]
+        weight = torch.randn(10, 5)
+        self.assertComponentsEqual(
+            F.embedding(torch.nested_tensor(indices), weight), [F.embedding(i, weight) for i in indices])
+
+    def test_attention(self):
+        queries = self.random_components([3, 1, 5], 2, 4)
+        keys = self.random_components([2, 6, 5], 2, 4)
+        values = self.random_components([2, 6, 5], 2, 3)
+        result = torch.nested_attention(
+            torch.nested_tensor(queries), torch.nested_tensor(keys), torch.nested_tensor(values))
+        self.assertEqual(result.shape, (3, 5, 2, 3))
+
+        # the same as attention over the padded batch, with the padding keys masked out
+        q, _ = padded_and_mask(queries)
+        k, key_mask = padded_and_mask(keys)
+        v, _ = padded_and_mask(values)
+        scores = torch.einsum('bqhe,bkhe->bhqk', q, k) / 2
+        scores = scores.masked_fill(key_mask[:, None, None, :], float('-inf'))
+        expected = torch.einsum('bhqk,bkhe->bqhe', scores.softmax(-1), v)
+        self.assertComponentsEqual(result, [e[:len(query)] for e, query in zip(expected, queries)])
+
+        # dense inputs are a padded batch with no padding
+        dense = torch.nested_attention(k, k, v, scale=0.5)
+        self.assertEqual(dense, torch.einsum('bhqk,bkhe->bqhe', (torch.einsum('bqhe,bkhe->bhqk', k, k) * 0.5).softmax(-1), v))
+
+        with self.assertRaisesRegex(RuntimeError, 'all nested or all dense'):
+            torch.nested_attention(torch.nested_tensor(queries), k, v)
+
+    def test_autograd(self):
+        components = self.random_components([3, 1, 4], 6)
+        for c in components:
+            c.requires_grad_()
+        weight = torch.randn(5, 6, dtype=torch.double, requires_grad=True)
+        nt = torch.nested_tensor(components)
+        out = F.layer_norm(F.linear(nt, weight).relu(), [5]).to_padded_tensor()
+        out.pow(2).sum().backward()
+
+        expected = [F.layer_norm(F.linear(c, weight).relu(), [5]).pow(2).sum() for c in components]
+        expected_grads = torch.autograd.grad(sum(expected), components + [weight])
+        for c, g in zip(components + [weight], expected_grads):
+            self.assertEqual(c.grad, g)
+
+    def test_unsupported_op_raises(self):
+        nt = torch.nested_tensor(self.random_components([3, 1], 2))
+        with self.assertRaisesRegex(RuntimeError, 'not supported for nested tensors'):
+            nt.sum()
+        with self.assertRaisesRegex(RuntimeError, 'do not have strides'):
+            nt.stride()
+        self.assertEqual(nt.to_padded_tensor().sum(), sum(c.sum() for c in nt.unbind()))
+
+
+if __name__ == '__main__':
+    run_tests()
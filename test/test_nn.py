@@ -1777,6 +1777,41 @@ class TestNN(NNTestCase):
         sample = next(model.parameters())[0, 0, 0]
         self.assertTrue(torch.equal(sample.data, vec.data[:5]))
 
+    def test_grads_to_flat_buffer(self):
+        conv1 = nn.Conv2d(3, 10, 5).to(memory_format=torch.channels_last)
+        fc1 = nn.Linear(10, 20)
+        model = nn.Sequential(conv1, nn.Flatten(), fc1)
+        params = list(model.parameters())
+        input = torch.randn(2, 3, 5, 5)
+
+        model(input).sum().backward()
+        expected = [p.grad.clone() for p in params]
+        fc1.bias.grad = None
+
+        flat_grad = torch.nn.utils.grads_to_flat_buffer(params)
+        self.assertEqual(flat_grad.size(), (980,))
+        self.assertEqual(flat_grad[-20:], torch.zeros(20))
+        for p in params:
+            self.assertTrue(p.grad._base is flat_grad)
+        # The grads keep the layout of their params
+        self.assertEqual(conv1.weight.grad.stride(), conv1.weight.stride())
+
+        # Backward accumulates straight into the buffer
+        model.zero_grad()
+        model(input).sum().backward()
+        model(input).sum().backward()
+        self.assertEqual(flat_grad, parameters_to_vector([2 * e for e in expected]))
+        for p in params:
+            self.assertTrue(p.grad._base is flat_grad)
+
+        buffer = torch.empty(980)
+        self.assertTrue(torch.nn.utils.grads_to_flat_buffer(params, buffer) is buffer)
+        self.assertEqual(buffer, flat_grad)
+        with self.assertRaisesRegex(ValueError, "expected a contiguous 1-D buffer"):
+            torch.nn.utils.grads_to_flat_buffer(params, torch.empty(979))
+        with self.assertRaisesRegex(TypeError, "different dtypes"):
+            torch.nn.utils.grads_to_flat_buffer(params + [torch.randn(2, dtype=torch.double)])
+
     # torch/nn/utils/prune.py
     @unittest.skipIf(not TEST_NUMPY, "numpy not found")
     def test_validate_pruning_amount_init(self):
@@ -3910,6 +3945,34 @@ class TestNN(NNTestCase):
             bias=True).cuda()
         result = m(x)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    @skipIfRocm
+    def test_cudnn_benchmark_cache_file(self):
+        x = torch.randn(2, 3, 9, 9, device="cuda", requires_grad=True)
+        conv = torch.nn.Conv2d(3, 5, 3).cuda()
+        with cudnn.flags(enabled=True, benchmark=True), TemporaryFileName() as fname:
+            expected = conv(x)
+            expected.sum().backward()
+            cudnn.save_benchmark_cache(fname)
+            with open(fname) as f:
+                lines = f.read().splitlines()
+            self.assertTrue(lines[0].startswith('cudnn_benchmark_cache '))
+            kinds = {line.split('\t')[0] for line in lines[1:]}
+            self.assertTrue({'fwd', 'bwd_data', 'bwd_filter'} <= kinds)
+            # loading the entries back keeps the results
+            cudnn.load_benchmark_cache(fname)
+            self.assertEqual(conv(x), expected)
+
+            with open(fname, 'w') as f:
+                f.write('cudnn_benchmark_cache 0 0\n')
+            with self.assertWarnsRegex(UserWarning, "ignoring"):
+                cudnn.load_benchmark_cache(fname)
+            with open(fname, 'w') as f:
+                f.write('not a cache\n')
+            with self.assertRaisesRegex(RuntimeError, "not a cuDNN benchmark cache"):
+                cudnn.load_benchmark_cache(fname)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
     def test_Conv2d_inconsistent_types_on_GPU_with_cudnn(self):
@@ -4037,6 +4100,22 @@ class TestNN(NNTestCase):
         i = torch.rand(1, 2, 1, 1, 1)
         out = m(i, output_size=(1, 2, 2, 2, 2))
 
+    def test_ConvTranspose_batch_parallel_cpu(self):
+        # The samples of the batch are computed in parallel, each with its
+        # own columns
+        for module, size in [(nn.ConvTranspose2d, (5, 7)), (nn.ConvTranspose3d, (3, 4, 5))]:
+            m = module(3, 4, 3, stride=2, padding=1, output_padding=1).double()
+            x = torch.randn(9, 3, *size, dtype=torch.double, requires_grad=True)
+            out = m(x)
+            grad = torch.randn_like(out)
+            grad_x, = torch.autograd.grad(out, x, grad)
+            for i in range(x.size(0)):
+                xi = x[i:i + 1].detach().requires_grad_()
+                out_i = m(xi)
+                self.assertEqual(out_i, out[i:i + 1])
+                grad_xi, = torch.autograd.grad(out_i, xi, grad[i:i + 1])
+                self.assertEqual(grad_xi, grad_x[i:i + 1])
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_ConvTranspose2d_half_cublas_gemm(self):
         with torch.backends.cudnn.flags(enabled=False):
@@ -4046,6 +4125,156 @@ class TestNN(NNTestCase):
             output = deconv(inputs)
             output.mean().backward()
 
+    def test_Conv2d_small_channel_cpu(self):
+        # Inference on few channels goes through the Winograd and direct
+        # channels last kernels, double through thnn_conv2d.
+        torch.manual_seed(123)
+        with torch.backends.mkldnn.flags(enabled=False), torch.no_grad():
+            for in_channels, out_channels, size, padding in [(3, 8, (9, 7), 1), (16, 5, (6, 13), 0),
+                                                             (1, 1, (3, 3), 0), (8, 17, (2, 2), 1)]:
+                x = torch.randn(2, in_channels, *size)
+                weight = torch.randn(out_channels, in_channels, 3, 3)
+                bias = torch.randn(out_channels)
+                expected = F.conv2d(x.double(), weight.double(), bias.double(), padding=padding)
+                self.assertEqual(F.conv2d(x, weight, bias, padding=padding), expected,
+                                 atol=1e-4, rtol=1e-5, exact_dtype=False)
+                self.assertEqual(F.conv2d(x, weight, None, padding=padding),
+                                 F.conv2d(x.double(), weight.double(), None, padding=padding),
+                                 atol=1e-4, rtol=1e-5, exact_dtype=False)
+
+            for kernel_size, stride, padding, dilation in [((3, 3), 1, 1, 1), ((1, 1), 1, 0, 1),
+                                                           ((5, 3), (2, 1), (2, 0), 1), ((3, 3), 2, 1, 2)]:
+                x = torch.randn(2, 6, 11, 10).contiguous(memory_format=torch.channels_last)
+                weight = torch.randn(19, 6, *kernel_size)
+                bias = torch.randn(19)
+                output = F.conv2d(x, weight, bias, stride, padding, dilation)
+                self.assertTrue(output.is_contiguous(memory_format=torch.channels_last))
+                expected = F.conv2d(x.double(), weight.double(), bias.double(), stride, padding, dilation)
+                self.assertEqual(output, expected, atol=1e-4, rtol=1e-5, exact_dtype=False)
+
+        # gradients still go through the differentiable ops
+        x = torch.randn(2, 3, 8, 8, requires_grad=True)
+        weight = torch.randn(4, 3, 3, 3)
+        F.conv2d(x, weight).sum().backward()
+        x_double = x.detach().double().requires_grad_()
+        F.conv2d(x_double, weight.double()).sum().backward()
+        self.assertEqual(x.grad, x_double.grad, atol=1e-4, rtol=1e-5, exact_dtype=False)
+
+    def test_Conv2d_depthwise_cpu(self):
+        # Depthwise convolutions go through thnn_conv_depthwise2d; compare
+        # with one convolution per group.
+        def reference(x, weight, bias, stride, padding, dilation):
+            channels = x.size(1)
+            multiplier = weight.size(0) // channels
+            return torch.cat([
+                F.conv2d(x[:, c:c + 1], weight[c * multiplier:(c + 1) * multiplier],
+                         bias[c * multiplier:(c + 1) * multiplier], stride, padding, dilation)
+                for c in range(channels)], 1)
+
+        torch.manual_seed(123)
+        cases = [(3, 1, (3, 3), 1, 1, 1), (8, 1, (5, 5), 2, 2, 1), (6, 2, (3, 5), (1, 2), (0, 2), 1),
+                 (13, 1, (3, 3), 1, 2, 2), (4, 3, (1, 1), 1, 0, 1), (9, 1, (7, 7), 3, 3, 1)]
+        with torch.backends.mkldnn.flags(enabled=False):
+            for channels, multiplier, kernel_size, stride, padding, dilation in cases:
+                for dtype, channels_last in product([torch.float, torch.double], [False, True]):
+                    x = torch.randn(2, channels, 12, 11, dtype=dtype)
+                    if channels_last:
+                        x = x.contiguous(memory_format=torch.channels_last)
+                    x.requires_grad_()
+                    weight = torch.randn(channels * multiplier, 1, *kernel_size, dtype=dtype, requires_grad=True)
+                    bias = torch.randn(channels * multiplier, dtype=dtype, requires_grad=True)
+                    args = (stride, padding, dilation)
+                    output = F.conv2d(x, weight, bias, *args, groups=channels)
+                    expected = reference(x, weight, bias, *args)
+                    self.assertEqual(output, expected, atol=1e-4, rtol=1e-5)
+                    if channels_last and multiplier == 1:
+                        self.assertTrue(output.is_contiguous(memory_format=torch.channels_last))
+                    grad = torch.randn_like(output)
+                    grads = torch.autograd.grad(output, (x, weight, bias), grad)
+                    grads_expected = torch.autograd.grad(expected, (x, weight, bias), grad)
+                    for g, g_expected in zip(grads, grads_expected):
+                        self.assertEqual(g, g_expected, atol=1e-4, rtol=1e-5)
+
+            for channels_last in [False, True]:
+                x = torch.randn(1, 4, 6, 5, dtype=torch.double)
+                if channels_last:
+                    x = x.contiguous(memory_format=torch.channels_last)
+                x.requires_grad_()
+                weight = torch.randn(4, 1, 3, 3, dtype=torch.double, requires_grad=True)
+                bias = torch.randn(4, dtype=torch.double, requires_grad=True)
+                func = lambda x, weight, bias: F.conv2d(x, weight, bias, 2, 1, 1, 4)
+                self.assertTrue(gradcheck(func, (x, weight, bias)))
+                self.assertTrue(gradgradcheck(func, (x, weight, bias)))
+
+    def test_Conv2d_cpu_benchmark(self):
+        # Whichever backend the benchmark picks gives the heuristic result,
+        # and the choices survive a save and load of the cache.
+        torch.backends.cpu.clear_benchmark_cache()
+        cases = [((2, 3, 9, 8), (8, 3, 3, 3), {'padding': 1}),
+                 ((1, 8, 7, 7), (8, 4, 3, 3), {'groups': 2, 'dilation': 2}),
+                 ((2, 6, 10, 10), (12, 6, 5, 3), {'stride': (2, 1)})]
+        for input_size, weight_size, kwargs in cases:
+            for dtype, channels_last, requires_grad in product([torch.float, torch.double],
+                                                              [False, True], [False, True]):
+                x = torch.randn(input_size, dtype=dtype)
+                if channels_last:
+                    x = x.contiguous(memory_format=torch.channels_last)
+                weight = torch.randn(weight_size, dtype=dtype, requires_grad=requires_grad)
+                bias = torch.randn(weight_size[0], dtype=dtype)
+                expected = F.conv2d(x, weight, bias, **kwargs)
+                with torch.backends.cpu.flags(benchmark=True):
+                    result = F.conv2d(x, weight, bias, **kwargs)
+                    self.assertEqual(result, expected, atol=1e-4, rtol=1e-5)
+                    if requires_grad:
+                        grad_expected, = torch.autograd.grad(expected.sum(), weight)
+                        grad, = torch.autograd.grad(result.sum(), weight)
+                        self.assertEqual(grad, grad_expected, atol=1e-4, rtol=1e-5)
+
+        with TemporaryFileName() as fname:
+            torch.backends.cpu.save_benchmark_cache(fname)
+            with open(fname) as f:
+                saved = sorted(f.read().splitlines())
+            self.assertEqual(len(saved), 1 + len(cases) * 8)
+            torch.backends.cpu.clear_benchmark_cache()
+            torch.backends.cpu.load_benchmark_cache(fname)
+            torch.backends.cpu.save_benchmark_cache(fname)
+            with open(fname) as f:
+                self.assertEqual(sorted(f.read().splitlines()), saved)
+            with open(fname, 'w') as f:
+                f.write('not_a_valid_line\n')
+            with self.assertRaisesRegex(RuntimeError, "malformed line"):
+                torch.backends.cpu.load_benchmark_cache(fname)
+        torch.backends.cpu.clear_benchmark_cache()
+
+    def test_channels_last_pool_upsample_batchnorm_cpu(self):
+        # The channels last kernels give the contiguous results and keep the
+        # layout, in the forward and the backward.
+        def cases():
+            yield lambda x: F.max_pool2d(x, 3, 2, 1)
+            yield lambda x: F.max_pool2d(x, (2, 3), 1, 0, (2, 1), ceil_mode=True)
+            yield lambda x: F.avg_pool2d(x, 3, 2, 1, count_include_pad=False)
+            yield lambda x: F.avg_pool2d(x, 2, ceil_mode=True, divisor_override=3)
+            yield lambda x: F.adaptive_avg_pool2d(x, (3, 4))
+            yield lambda x: F.interpolate(x, scale_factor=2, mode='nearest')
+            yield lambda x: F.interpolate(x, size=(9, 5), mode='bilinear', align_corners=False)
+            yield lambda x: F.batch_norm(x, None, None, torch.rand(x.size(1)) + 0.5,
+                                         torch.rand(x.size(1)), training=True)
+
+        for dtype, channels in product([torch.float, torch.double], [3, 19]):
+            x = torch.randn(2, channels, 7, 8, dtype=dtype)
+            for op in cases():
+                x_cont = x.clone().requires_grad_()
+                x_cl = x.contiguous(memory_format=torch.channels_last).requires_grad_()
+                out_cont = op(x_cont)
+                out_cl = op(x_cl)
+                self.assertTrue(out_cl.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(out_cl, out_cont)
+                grad = torch.randn_like(out_cont)
+                out_cont.backward(grad)
+                out_cl.backward(grad.contiguous(memory_format=torch.channels_last))
+                self.assertTrue(x_cl.grad.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(x_cl.grad, x_cont.grad)
+
     # For https://github.com/pytorch/pytorch/pull/1273
     # Almost identical to the above `test_Conv2d_naive_groups`
     def test_Conv2d_groups_nobias(self):
@@ -4379,6 +4608,22 @@ class TestNN(NNTestCase):
         with self.assertRaises(RuntimeError):
             torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths)
 
+    def test_CTCLoss_repeated_labels_cpu(self):
+        # Few labels, so that the targets repeat some, and target lengths on
+        # both sides of the vector sizes of the lattice recursion
+        torch.manual_seed(0)
+        target_lengths = [0, 1, 2, 7, 13]
+        input_lengths = [30, 30, 25, 30, 28]
+        targets = torch.randint(1, 4, (sum(target_lengths),), dtype=torch.long)
+        for dtype in (torch.float, torch.double):
+            log_probs = torch.randn(30, 5, 4, dtype=dtype).log_softmax(2).requires_grad_()
+            res = torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths, reduction='sum')
+            expected = ctcloss_reference(log_probs, targets, input_lengths, target_lengths, reduction='sum')
+            self.assertEqual(res, expected.to(dtype))
+            grad, = torch.autograd.grad(res, log_probs)
+            expected_grad, = torch.autograd.grad(expected, log_probs)
+            self.assertEqual(grad, expected_grad)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_CTCLoss_long_targets(self):
         input_length = 4000
@@ -4666,6 +4911,70 @@ class TestNN(NNTestCase):
 
             (hx + cx).sum().backward()
 
+    def test_fused_rnn_cells_cpu(self):
+        # hidden size 11 exercises the vectorized tails of the CPU kernels
+        batch, hidden_size = 3, 11
+
+        def ref_lstm(igates, hgates, cx, b1, b2):
+            gates = igates + hgates + b1 + b2
+            i, f, g, o = gates.chunk(4, 1)
+            cy = f.sigmoid() * cx + i.sigmoid() * g.tanh()
+            return o.sigmoid() * cy.tanh(), cy
+
+        def ref_gru(igates, hgates, hx, b1, b2):
+            ir, ii, in_ = (igates + b1).chunk(3, 1)
+            hr, hi, hn = (hgates + b2).chunk(3, 1)
+            r = (ir + hr).sigmoid()
+            i = (ii + hi).sigmoid()
+            n = (in_ + r * hn).tanh()
+            return n + i * (hx - n)
+
+        for dtype in (torch.float, torch.double):
+            igates = torch.randn(batch, 4 * hidden_size, dtype=dtype, requires_grad=True)
+            hgates = torch.randn(batch, 4 * hidden_size, dtype=dtype, requires_grad=True)
+            cx = torch.randn(batch, hidden_size, dtype=dtype, requires_grad=True)
+            b1 = torch.randn(4 * hidden_size, dtype=dtype, requires_grad=True)
+            b2 = torch.randn(4 * hidden_size, dtype=dtype, requires_grad=True)
+            hy, cy, _ = torch._thnn_fused_lstm_cell(igates, hgates, cx, b1, b2)
+            ref_hy, ref_cy = ref_lstm(igates, hgates, cx, b1, b2)
+            self.assertEqual(hy, ref_hy)
+            self.assertEqual(cy, ref_cy)
+            grads = torch.autograd.grad((hy + cy).sum(), (igates, cx, b1))
+            ref_grads = torch.autograd.grad((ref_hy + ref_cy).sum(), (igates, cx, b1))
+            self.assertEqual(grads, ref_grads)
+
+            igates = torch.randn(batch, 3 * hidden_size, dtype=dtype, requires_grad=True)
+            hgates = torch.randn(batch, 3 * hidden_size, dtype=dtype, requires_grad=True)
+            hx = torch.randn(batch, hidden_size, dtype=dtype, requires_grad=True)
+            b1 = torch.randn(3 * hidden_size, dtype=dtype, requires_grad=True)
+            b2 = torch.randn(3 * hidden_size, dtype=dtype, requires_grad=True)
+            hy, _ = torch._thnn_fused_gru_cell(igates, hgates, hx, b1, b2)
+            ref_hy = ref_gru(igates, hgates, hx, b1, b2)
+            self.assertEqual(hy, ref_hy)
+            grads = torch.autograd.grad(hy.sum(), (igates, hgates, hx, b2))
+            ref_grads = torch.autograd.grad(ref_hy.sum(), (igates, hgates, hx, b2))
+            self.assertEqual(grads, ref_grads)
+
+        igates = torch.randn(batch, 4 * hidden_size, dtype=torch.double, requires_grad=True)
+        hgates = torch.randn(batch, 4 * hidden_size, dtype=torch.double, requires_grad=True)
+        cx = torch.randn(batch, hidden_size, dtype=torch.double, requires_grad=True)
+        self.assertTrue(gradcheck(lambda *args: torch._thnn_fused_lstm_cell(*args)[:2], (igates, hgates, cx)))
+        self.assertTrue(gradgradcheck(lambda *args: torch._thnn_fused_lstm_cell(*args)[:2], (igates, hgates, cx)))
+        igates = torch.randn(batch, 3 * hidden_size, dtype=torch.double, requires_grad=True)
+        hgates = torch.randn(batch, 3 * hidden_size, dtype=torch.double, requires_grad=True)
+        hx = torch.randn(batch, hidden_size, dtype=torch.double, requires_grad=True)
+        self.assertTrue(gradcheck(lambda *args: torch._thnn_fused_gru_cell(*args)[0], (igates, hgates, hx)))
+        self.assertTrue(gradgradcheck(lambda *args: torch._thnn_fused_gru_cell(*args)[0], (igates, hgates, hx)))
+
+        # Inference over several steps packs w_hh up front; it has to match
+        # the unpacked weights used when gradients are needed.
+        for module in (nn.LSTM(5, hidden_size, num_layers=2), nn.GRU(5, hidden_size, num_layers=2)):
+            input = torch.randn(7, batch, 5)
+            expected, _ = module(input)
+            with torch.no_grad():
+                output, _ = module(input)
+            self.assertEqual(output, expected)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_pack_sequence_batch_sizes_throw(self):
         with self.assertRaisesRegex(ValueError, r"batch_sizes should always be on CPU"):
@@ -5997,6 +6306,19 @@ class TestNN(NNTestCase):
                 _test_gelu(n, m, torch.float64, True)
                 _test_gelu(n, m, torch.float64, False)
 
+    def test_cpu_fast_math(self):
+        X = torch.randn(1000, 37) * 5
+        ref = [F.gelu(X), torch.sigmoid(X), torch.tanh(X), torch.erf(X)]
+        orig = torch._C._get_cpu_allow_fast_math()
+        torch._C._set_cpu_allow_fast_math(True)
+        try:
+            self.assertTrue(torch._C._get_cpu_allow_fast_math())
+            res = [F.gelu(X), torch.sigmoid(X), torch.tanh(X), torch.erf(X)]
+        finally:
+            torch._C._set_cpu_allow_fast_math(orig)
+        for r, e in zip(res, ref):
+            self.assertEqual(r, e, atol=1e-6, rtol=1e-5)
+
 
     def test_bce_loss_always_nonnegative(self):
         target = torch.ones(5)
@@ -8154,6 +8476,40 @@ class TestNN(NNTestCase):
         self.assertEqual(input.grad.dtype, dtype)
         self.assertEqual(input.grad, inputf.grad.to(dtype), atol=0.1, rtol=0)
 
+    def test_softmax_cpu(self, dtype=torch.bfloat16):
+        inputf = torch.rand(32, 100, device="cpu", dtype=torch.float, requires_grad=True)
+        input = inputf.to(dtype).detach().requires_grad_(True)
+        for dim in [0, -1]:
+            outf = F.softmax(inputf, dim=dim)
+            out = F.softmax(input, dim=dim)
+            self.assertEqual(out.dtype, dtype)
+            self.assertEqual(out, outf.to(dtype), atol=1e-2, rtol=0)
+
+            grad = torch.rand_like(outf)
+            out.backward(grad.to(dtype))
+            outf.backward(grad)
+            self.assertEqual(input.grad.dtype, dtype)
+            self.assertEqual(input.grad, inputf.grad.to(dtype), atol=1e-2, rtol=0)
+            input.grad = None
+            inputf.grad = None
+
+    def test_layer_norm_cpu(self, dtype=torch.bfloat16):
+        inputf = torch.randn(16, 300, device="cpu", dtype=torch.float, requires_grad=True)
+        input = inputf.to(dtype).detach().requires_grad_(True)
+        mf = nn.LayerNorm(300)
+        m = deepcopy(mf).to(dtype)
+        outf = mf(inputf)
+        out = m(input)
+        self.assertEqual(out.dtype, dtype)
+        self.assertEqual(out, outf.to(dtype), atol=5e-2, rtol=0)
+
+        grad = torch.randn_like(outf)
+        out.backward(grad.to(dtype))
+        outf.backward(grad)
+        self.assertEqual(input.grad, inputf.grad.to(dtype), atol=5e-2, rtol=0)
+        self.assertEqual(m.weight.grad, mf.weight.grad.to(dtype), atol=0.5, rtol=1e-2)
+        self.assertEqual(m.bias.grad, mf.bias.grad.to(dtype), atol=0.5, rtol=1e-2)
+
     def test_adaptive_log_softmax(self):
         # args validation
         with self.assertRaises(ValueError):
@@ -9441,6 +9797,70 @@ class TestNNDeviceType(NNTestCase):
         if self.device_type == 'cuda':
             self._test_LayerNorm_cuda_half(device)
 
+    @onlyCUDA
+    @dtypes(torch.float, torch.double, torch.half)
+    def test_LayerNorm_persistent(self, device, dtype):
+        # Rows of up to 4096 elements are normalized by the persistent kernels, with vectorized
+        # accesses only when the size and the data are aligned; compare both against the CPU.
+        for N in [1, 7, 768, 1023, 1024, 2047, 3072, 4096, 4097]:
+            for shift in [0, 1]:
+                # A shift of one element misaligns the (contiguous) rows.
+                x = torch.randn(9 * N + shift, device=device, dtype=dtype)[shift:].view(9, N)
+                x.requires_grad_(True)
+                ln = nn.LayerNorm(N).to(device, dtype)
+                ln.weight.data.uniform_(0.5, 1.5)
+                ln.bias.data.uniform_(-0.5, 0.5)
+                ref_x = x.detach().cpu().double().requires_grad_(True)
+                ref_ln = nn.LayerNorm(N).double()
+                ref_ln.load_state_dict(ln.state_dict())
+
+                out = ln(x)
+                ref_out = ref_ln(ref_x)
+                grad = torch.randn_like(out)
+                out.backward(grad)
+                ref_out.backward(grad.cpu().double())
+
+                prec = 1e-2 if dtype == torch.half else 1e-4
+                self.assertEqual(out.double().cpu(), ref_out, atol=prec, rtol=prec)
+                self.assertEqual(x.grad.double().cpu(), ref_x.grad, atol=prec, rtol=prec)
+                self.assertEqual(ln.weight.grad.double().cpu(), ref_ln.weight.grad, atol=prec * 10, rtol=prec)
+
+    @onlyCUDA
+    @dtypes(torch.float, torch.double, torch.half)
+    def test_dropout_add_layer_norm(self, device, dtype):
+        # The fused kernel against dropout with the mask it returns, then add and layer norm, for rows
+        # held in registers (vectorized or not) and longer ones.
+        keep = 0.75
+        for N in [7, 768, 3072, 4097]:
+            x = torch.randn(9, N, device=device, dtype=dtype, requires_grad=True)
+            r = torch.randn(9, N, device=device, dtype=dtype, requires_grad=True)
+            w = torch.empty(N, device=device, dtype=dtype).uniform_(0.5, 1.5).requires_grad_(True)
+            b = torch.empty(N, device=device, dtype=dtype).uniform_(-0.5, 0.5).requires_grad_(True)
+            out, s, mask, _, _ = torch._fused_dropout_add_layer_norm(x, r, w, b, 9, N, keep, 1e-5)
+            self.assertEqual(mask.dtype, torch.uint8)
+            self.assertTrue(0.6 < mask.double().mean().item() < 0.9)
+
+            ref_x, ref_r, ref_w, ref_b = (t.detach().double().requires_grad_(True) for t in (x, r, w, b))
+            ref_s = ref_x * mask.double() / keep + ref_r
+            ref_out = torch.nn.functional.layer_norm(ref_s, (N,), ref_w, ref_b)
+            grad = torch.randn_like(out)
+            out.backward(grad)
+            ref_out.backward(grad.double())
+
+            prec = 1e-2 if dtype == torch.half else 1e-4
+            self.assertEqual(s.double(), ref_s, atol=prec, rtol=prec)
+            self.assertEqual(out.double(), ref_out, atol=prec, rtol=prec)
+            for t, ref_t in [(x, ref_x), (r, ref_r), (b, ref_b)]:
+                self.assertEqual(t.grad.double(), ref_t.grad, atol=prec, rtol=prec)
+            self.assertEqual(w.grad.double(), ref_w.grad, atol=prec * 10, rtol=prec)
+
+        # The composite falls back to the separate ops in eval mode.
+        x = torch.randn(4, 16, device=device, dtype=dtype)
+        r = torch.randn(4, 16, device=device, dtype=dtype)
+        self.assertEqual(torch.dropout_add_layer_norm(x, r, 0.5, False, (16,)),
+                         torch.nn.functional.layer_norm(x + r, (16,)))
+        self.assertEqual(torch.dropout_add_layer_norm(x, r, 0.5, True, (16,)).shape, x.shape)
+
     def test_GroupNorm_general(self, device):
         self._test_GroupNorm_general(device)
 
@@ -9880,8 +10300,10 @@ class TestNNDeviceType(NNTestCase):
     @dtypes(torch.float)
     def test_softmax_results(self, device, dtype):
         # Non-even sizes and non-zero shifts test fallback paths in vectorized kernel
-        # Note: dim1 > 1024 is needed to exercise the vectorized (non-persistent) path, (16, 30576) is BERT-esque
-        sizes = [(0, 10), (32, 20), (10, 0), (31, 20), (32, 21), (31, 23), (32, 1536), (31, 2048), (33, 2049), (16, 30576)]
+        # Note: 1024 < dim1 <= 4096 exercises the block persistent path, dim1 > 4096 is needed to exercise the
+        # vectorized (non-persistent) path, (16, 30576) is BERT-esque
+        sizes = [(0, 10), (32, 20), (10, 0), (31, 20), (32, 21), (31, 23), (32, 1536), (31, 2048), (33, 2049),
+                 (8, 3072), (9, 4096), (8, 4097), (16, 30576)]
         shifts = [(0, 0), (1, 0), (0, 1), (1, 1)]
         for fn in [F.softmax, F.log_softmax]:
             for size in sizes:
@@ -9910,6 +10332,37 @@ class TestNNDeviceType(NNTestCase):
                         self.assertEqual(grad_input, ref_grad_input)
                         self.assertEqual(input.grad, ref_input.grad)
 
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    def test_incremental_attention(self, device, dtype):
+        # (batch * heads, key_dim, value_dim); value_dim 300 is wider than a CUDA block
+        for batch, key_dim, value_dim in [(6, 16, 16), (3, 64, 40), (2, 7, 300)]:
+            key_cache = torch.empty(0, batch, key_dim, device=device, dtype=dtype)
+            value_cache = torch.empty(0, batch, value_dim, device=device, dtype=dtype)
+            keys, values = [], []
+            # a prompt of several steps, then one step at a time
+            for steps in [5, 1, 1, 1]:
+                query = torch.randn(batch, key_dim, device=device, dtype=dtype)
+                key = torch.randn(steps, batch, key_dim, device=device, dtype=dtype)
+                value = torch.randn(steps, batch, value_dim, device=device, dtype=dtype)
+                if steps == 1:
+                    key, value = key[0], value[0]
+                out = torch._incremental_attention(query, key_cache, value_cache, key, value)
+
+                keys.append(key.view(-1, batch, key_dim).double())
+                values.append(value.view(-1, batch, value_dim).double())
+                k, v = torch.cat(keys).transpose(0, 1), torch.cat(values).transpose(0, 1)
+                scores = torch.bmm(k, query.double().unsqueeze(2)).squeeze(2) / math.sqrt(key_dim)
+                expected = torch.bmm(scores.softmax(1).unsqueeze(1), v).squeeze(1)
+                self.assertEqual(key_cache.size(0), k.size(1))
+                self.assertEqual(out, expected.to(dtype), atol=1e-2 if dtype == torch.half else 1e-5, rtol=0)
+
+        query = torch.randn(4, 8, device=device, dtype=dtype)
+        cache = torch.empty(0, 4, 8, device=device, dtype=dtype)
+        with self.assertRaisesRegex(RuntimeError, "do not match query"):
+            torch._incremental_attention(query, cache, torch.empty(0, 3, 8, device=device, dtype=dtype),
+                                         query, query)
+
     @dtypes(torch.float)
     @dtypesIfCUDA(torch.float, torch.half)
     def test_log_softmax_big(self, device, dtype):
@@ -10743,6 +11196,38 @@ class TestNNDeviceType(NNTestCase):
         self._test_EmbeddingBag(device, 'mean', True, dtype, test_backward=test_backward)
 
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_embedding_bag_small_dims(self, device, dtype):
+        # Small embeddings take a warp per bag forward and a single pass
+        # backward. Check them against the CPU in double for each vector
+        # width, rows that aren't contiguous, hot indices and empty bags.
+        num_weights = 10
+        indices = torch.randint(num_weights, (300,), dtype=torch.long)
+        indices[::3] = 7
+        offsets = torch.tensor([0, 0, 1, 5, 5, 40, 100, 299], dtype=torch.long)
+        prec = dtype2prec_DONTUSE[dtype]
+
+        def run(weight, per_sample_weights, grad, mode, device, dtype):
+            D = grad.size(1)
+            weight = weight.to(device=device, dtype=dtype)[:, :D].requires_grad_()
+            if per_sample_weights is not None:
+                per_sample_weights = per_sample_weights.to(device=device, dtype=dtype)
+            out = F.embedding_bag(indices.to(device), weight, offsets.to(device), mode=mode,
+                                  per_sample_weights=per_sample_weights)
+            out.backward(grad.to(device=device, dtype=dtype))
+            return out.double().cpu(), weight.grad.double().cpu()
+
+        for D, row_padding in itertools.product((1, 2, 3, 4, 6, 8, 16, 33, 64, 128, 129), (0, 1)):
+            weight = torch.randn(num_weights, D + row_padding).to(dtype).double()
+            grad = torch.randn(offsets.numel(), D).to(dtype).double()
+            for mode, with_weights in (('sum', False), ('sum', True), ('mean', False), ('max', False)):
+                per_sample_weights = torch.randn(indices.numel()).to(dtype).double() if with_weights else None
+                expected, expected_grad = run(weight, per_sample_weights, grad, mode, 'cpu', torch.double)
+                out, out_grad = run(weight, per_sample_weights, grad, mode, device, dtype)
+                self.assertEqual(out, expected, atol=prec, rtol=0)
+                self.assertEqual(out_grad, expected_grad, atol=prec * 10, rtol=0)
+
     @onlyCUDA
     @skipCUDAIfNotRocm
     def test_embedding_bag_bfloat16(self, device):
@@ -358,6 +358,63 @@ class TestOptim(TestCase):
         with self.assertRaisesRegex(ValueError, "Invalid beta parameter at index 0: 1.0"):
             optim.SparseAdam(None, lr=1e-2, betas=(1.0, 0.0))
 
+    def _embedding_grad(self, num_rows, dim, dtype):
+        # uncoalesced, with duplicate and untouched rows
+        i = torch.tensor([[3, 0, 3, 7, 0, 3]])
+        v = torch.randn(i.size(1), dim, dtype=dtype)
+        return torch.sparse_coo_tensor(i, v, (num_rows, dim))
+
+    def test_sparse_adagrad_fused(self):
+        for dtype in (torch.float, torch.double):
+            grad = self._embedding_grad(10, 13, dtype)
+            dense_grad = grad.to_dense()
+            param = torch.randn(10, 13, dtype=dtype)
+            state_sum = torch.rand(10, 13, dtype=dtype)
+            expected_sum = state_sum + dense_grad * dense_grad
+            expected = param - 0.1 * dense_grad / (expected_sum.sqrt() + 1e-10)
+            torch._sparse_adagrad_(param, state_sum, grad, 0.1, 1e-10)
+            self.assertEqual(state_sum, expected_sum)
+            self.assertEqual(param, expected)
+
+            # the optimizer takes the fused step for embedding gradients
+            weight = torch.randn(10, 13, dtype=dtype, requires_grad=True)
+            weight_ref = weight.detach().clone().requires_grad_()
+            weight.grad = grad
+            weight_ref.grad = dense_grad
+            optim.Adagrad([weight], lr=0.1).step()
+            optim.Adagrad([weight_ref], lr=0.1).step()
+            self.assertEqual(weight, weight_ref)
+
+    def test_rowwise_adagrad_fused(self):
+        for dtype in (torch.float, torch.double):
+            grad = self._embedding_grad(10, 13, dtype)
+            dense_grad = grad.to_dense()
+            param = torch.randn(10, 13, dtype=dtype)
+            state_sum = torch.rand(10, dtype=dtype)
+            expected_sum = state_sum + (dense_grad * dense_grad).mean(1)
+            expected = param - 0.1 * dense_grad / (expected_sum.sqrt() + 1e-10).unsqueeze(1)
+            touched = torch.tensor([0, 3, 7])
+            torch._rowwise_adagrad_(param, state_sum, grad, 0.1, 1e-10)
+            self.assertEqual(state_sum[touched], expected_sum[touched])
+            self.assertEqual(param, expected)
+
+    def test_sparse_adam_fused(self):
+        for dtype in (torch.float, torch.double):
+            weight = torch.randn(10, 13, dtype=dtype, requires_grad=True)
+            # a non-contiguous parameter takes the unfused path
+            weight_ref = weight.detach().t().clone().t().requires_grad_()
+            opt = optim.SparseAdam([weight], lr=0.1)
+            opt_ref = optim.SparseAdam([weight_ref], lr=0.1)
+            for _ in range(3):
+                grad = self._embedding_grad(10, 13, dtype)
+                weight.grad = grad
+                weight_ref.grad = grad.clone()
+                opt.step()
+                opt_ref.step()
+                self.assertEqual(weight, weight_ref)
+            self.assertEqual(opt.state[weight]['exp_avg'], opt_ref.state[weight_ref]['exp_avg'])
+            self.assertEqual(opt.state[weight]['exp_avg_sq'], opt_ref.state[weight_ref]['exp_avg_sq'])
+
     # ROCm precision is too low to pass this test
     @skipIfRocm
     def test_adadelta(self):
@@ -8,6 +8,7 @@ import zipfile
 import warnings
 import gzip
 import copy
+import json
 import pickle
 import shutil
 import pathlib
@@ -713,6 +714,84 @@ class TestSerialization(TestCase, SerializationMixin):
 
         test(io.BytesIO())
 
+    @unittest.skipIf(IS_WINDOWS, "mmap on windows")
+    def test_serialization_mmap(self):
+        data = {'a': torch.randn(64, 3), 'b': torch.arange(10)}
+        with tempfile.NamedTemporaryFile() as f:
+            torch.save(data, f.name)
+            result = torch.load(f.name, mmap=True)
+            self.assertEqual(result, data)
+            # Writes are copied on write, the file keeps the saved data
+            result['a'].zero_()
+            self.assertEqual(torch.load(f.name), data)
+
+            m = torch.jit.script(torch.nn.Linear(3, 4))
+            torch.jit.save(m, f.name)
+            loaded = torch.jit.load(f.name, mmap=True)
+            self.assertEqual(loaded.weight, m.weight)
+            x = torch.randn(2, 3)
+            self.assertEqual(loaded(x), m(x))
+
+        with self.assertRaisesRegex(ValueError, "mmap requires a file name"):
+            torch.load(io.BytesIO(), mmap=True)
+
+    def test_serialization_sharded(self):
+        data = {'a': torch.randn(64, 3), 'b': torch.arange(100), 'c': [torch.ones(2, 2)]}
+        data['a_view'] = data['a'][2:]
+        with tempfile.TemporaryDirectory() as path:
+            torch.save(data, path, max_shard_size=1024)
+            with open(os.path.join(path, 'manifest.json')) as f:
+                manifest = json.load(f)
+            self.assertGreater(len(manifest['shards']), 1)
+            for mmap in (False, True):
+                result = torch.load(path, mmap=mmap)
+                self.assertEqual(result, data)
+                # Storage sharing is preserved across shards
+                self.assertEqual(result['a_view'].storage().data_ptr(), result['a'].storage().data_ptr())
+
+            # A save that fails leaves no manifest behind
+            with self.assertRaises((pickle.PicklingError, AttributeError)):
+                torch.save([torch.ones(1), lambda: None], path, max_shard_size=1024)
+            self.assertFalse(os.path.exists(os.path.join(path, 'manifest.json')))
+
+        with self.assertRaisesRegex(ValueError, "max_shard_size requires a directory name"):
+            torch.save(data, io.BytesIO(), max_shard_size=1024)
+
+    def test_serialization_compress(self):
+        # Large enough to be compressed in several chunks
+        data = {'a': torch.arange(1 << 20).remainder(100).float(), 'b': torch.ones(5)}
+        plain = io.BytesIO()
+        torch.save(data, plain)
+        compressed = io.BytesIO()
+        torch.save(data, compressed, compress=True)
+        self.assertLess(len(compressed.getvalue()), len(plain.getvalue()) // 2)
+        compressed.seek(0)
+        self.assertEqual(torch.load(compressed), data)
+
+        m = torch.jit.script(torch.nn.Linear(1000, 1000))
+        buf = io.BytesIO()
+        torch.jit.save(m, buf, _compress=True)
+        buf.seek(0)
+        self.assertEqual(torch.jit.load(buf).weight, m.weight)
+
+        with self.assertRaisesRegex(ValueError, "compress is only supported"):
+            torch.save(data, io.BytesIO(), _use_new_zipfile_serialization=False, compress=True)
+
+    @unittest.skipIf(not torch.cuda.is_available(), "CUDA unavailable")
+    def test_serialization_cuda_staging(self):
+        data = [torch.randn(1000, device='cuda') for _ in range(10)]
+        data.append(torch.arange(10))
+        staging_bytes = torch.serialization._CUDA_STAGING_BYTES
+        try:
+            # Only a few storages are staged at once
+            torch.serialization._CUDA_STAGING_BYTES = 10000
+            buf = io.BytesIO()
+            torch.save(data, buf)
+        finally:
+            torch.serialization._CUDA_STAGING_BYTES = staging_bytes
+        buf.seek(0)
+        self.assertEqual(torch.load(buf), data)
+
     @unittest.skipIf(IS_WINDOWS, "NamedTemporaryFile on windows")
     def test_serialization_zipfile_actually_jit(self):
         with tempfile.NamedTemporaryFile() as f:
@@ -199,6 +199,35 @@ class TestSparse(TestCase):
             t, _, _ = self._gen_sparse(len(sparse_size), nnz, sparse_size + dense_size)
             self.safeCoalesce(t)  # this tests correctness
 
+    def test_coalesce_large(self):
+        # enough nonzeros, with many duplicates, for the CPU coalesce to sort
+        # and merge in parallel
+        nnz = 100000
+        for sparse_size, dense_size in [([300, 200], []), ([300, 200], [3]), ([1000], [2])]:
+            i = torch.stack([torch.randint(size, (nnz,)) for size in sparse_size])
+            v = torch.randn(nnz, *dense_size, dtype=torch.double)
+            x = self.sparse_tensor(i.to(self.device), v.to(self.device),
+                                   torch.Size(sparse_size + dense_size))
+            indices_before = x._indices().clone()
+            y = x.coalesce()
+            self.assertTrue(y.is_coalesced())
+            self.assertEqual(x._indices(), indices_before)
+
+            # the indices come out sorted and unique
+            flat = y._indices()[0].clone()
+            for d in range(1, len(sparse_size)):
+                flat = flat * sparse_size[d] + y._indices()[d]
+            self.assertTrue((flat[1:] > flat[:-1]).all())
+
+            expected = torch.zeros(sparse_size + dense_size, dtype=torch.double)
+            expected.index_put_(tuple(i), v, accumulate=True)
+            self.assertEqual(self.safeToDense(y), expected.to(self.device))
+
+            # the additions of dense and sparse tensors update the slices of
+            # the nonzeros in parallel
+            dense = torch.randn(sparse_size + dense_size, dtype=torch.double, device=self.device)
+            self.assertEqual(torch.add(dense, x, alpha=2), dense + 2 * expected.to(self.device))
+
     def test_ctor_size_checks(self):
         indices = self.index_tensor([
             [0, 0, 0],
@@ -1202,6 +1231,19 @@ class TestSparse(TestCase):
         expected = y + r * self.safeToDense(x_)
         self.assertEqual(res, expected)
 
+    @cpu_only
+    def test_addmm_parallel_rows(self):
+        # the rows of the result are computed in parallel, each from its
+        # nonzeros in the order they appear in, whether coalesced or not
+        i = torch.stack([torch.randint(500, (20000,)), torch.randint(300, (20000,))])
+        v = torch.randn(20000, dtype=torch.double)
+        x = self.sparse_tensor(i, v, torch.Size([500, 300]))
+        dense = torch.randn(300, 40, dtype=torch.double)
+        t = torch.randn(500, 40, dtype=torch.double)
+        expected = 0.5 * t + 2 * self.safeToDense(x).mm(dense)
+        self.assertEqual(torch.addmm(t, x, dense, beta=0.5, alpha=2), expected)
+        self.assertEqual(torch.addmm(t, x.coalesce(), dense, beta=0.5, alpha=2), expected)
+
     def test_spadd(self):
         self._test_spadd_shape(10, [5, 6])
         self._test_spadd_shape(10, [10, 10, 10])
@@ -2726,5 +2768,102 @@ class TestSparseOneOff(TestCase):
             x + sparse_y
 
 
+class TestSparseCsr(TestCase):
+    def _gen_csr(self, m, n, density, dtype=torch.double, index_dtype=torch.long, device='cpu'):
+        dense = torch.randn(m, n, dtype=dtype, device=device)
+        dense = dense * (torch.rand(m, n, device=device) < density).to(dtype)
+        csr = dense.to_sparse_csr()
+        if index_dtype != torch.long:
+            csr = torch.sparse_csr_tensor(csr.crow_indices().to(index_dtype), csr.col_indices().to(index_dtype),
+                                          csr.values(), csr.shape)
+        return csr, dense
+
+    def test_sparse_csr_tensor(self):
+        crow_indices = torch.tensor([0, 2, 2, 3])
+        col_indices = torch.tensor([0, 2, 1])
+        values = torch.tensor([1., 2., 3.])
+        x = torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 4])
+        self.assertTrue(x.is_sparse_csr)
+        self.assertFalse(x.is_sparse)
+        self.assertEqual(x.layout, torch.sparse_csr)
+        self.assertEqual(x.shape, (3, 4))
+        self.assertEqual(x._nnz(), 3)
+        self.assertEqual(x.crow_indices(), crow_indices)
+        self.assertEqual(x.col_indices(), col_indices)
+        self.assertEqual(x.values(), values)
+        self.assertEqual(x.to_dense(), torch.tensor([[1., 0., 2., 0.],
+                                                     [0., 0., 0., 0.],
+                                                     [0., 3., 0., 0.]]))
+        # size inferred from the indices
+        self.assertEqual(torch.sparse_csr_tensor(crow_indices, col_indices, values).shape, (3, 3))
+        self.assertEqual(torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 4],
+                                                 dtype=torch.float).dtype, torch.float)
+        self.assertTrue('crow_indices=tensor([0, 2, 2, 3])' in str(x))
+
+    def test_sparse_csr_tensor_invalid(self):
+        crow_indices = torch.tensor([0, 2, 2, 3])
+        col_indices = torch.tensor([0, 2, 1])
+        values = torch.tensor([1., 2., 3.])
+        with self.assertRaisesRegex(RuntimeError, "crow_indices must have nrows \\+ 1"):
+            torch.sparse_csr_tensor(crow_indices, col_indices, values, [4, 4])
+        with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+            torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 2])
+        with self.assertRaisesRegex(RuntimeError, "non-decreasing"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2, 1, 3]), col_indices, values, [3, 4])
+        with self.assertRaisesRegex(RuntimeError, "same nnz"):
+            torch.sparse_csr_tensor(crow_indices, col_indices, values[:2], [3, 4])
+        with self.assertRaisesRegex(RuntimeError, "same dtype"):
+            torch.sparse_csr_tensor(crow_indices.int(), col_indices, values, [3, 4])
+
+    def test_sparse_csr_conversions(self):
+        for m, n in [(0, 0), (5, 0), (7, 9), (30, 20)]:
+            csr, dense = self._gen_csr(m, n, 0.3)
+            self.assertEqual(csr.to_dense(), dense)
+            self.assertEqual(csr.to_sparse().to_dense(), dense)
+            self.assertEqual(dense.to_sparse().to_sparse_csr().to_dense(), dense)
+            self.assertEqual(csr._nnz(), (dense != 0).sum().item())
+
+        # the columns of a row need not be sorted and duplicates are summed
+        x = torch.sparse_csr_tensor(torch.tensor([0, 3]), torch.tensor([1, 0, 1]), torch.tensor([1., 2., 3.]), [1, 2])
+        self.assertEqual(x.to_dense(), torch.tensor([[2., 4.]]))
+        self.assertEqual(x.to_sparse().to_dense(), torch.tensor([[2., 4.]]))
+
+    def _test_sparse_csr_matmul(self, device):
+        for index_dtype in [torch.int, torch.long]:
+            for m, n, k in [(0, 4, 3), (5, 3, 0), (7, 9, 1), (50, 40, 30)]:
+                csr, dense = self._gen_csr(m, n, 0.2, index_dtype=index_dtype, device=device)
+                y = torch.randn(n, k, device=device)
+                t = torch.randn(m, k, device=device)
+                self.assertEqual(torch.mm(csr, y), torch.mm(dense, y))
+                self.assertEqual(torch.addmm(t, csr, y, beta=0.5, alpha=2), torch.addmm(t, dense, y, beta=0.5, alpha=2))
+                self.assertEqual(torch.addmm(t, csr, y, beta=0), torch.mm(dense, y))
+                # non-contiguous dense operand and result
+                y_t = torch.randn(k, n, device=device).t()
+                out = torch.empty(k, m, device=device).t()
+                torch.addmm(t, csr, y_t, out=out)
+                self.assertEqual(out, torch.addmm(t, dense, y_t))
+                r = t.clone()
+                r.addmm_(csr, y)
+                self.assertEqual(r, torch.addmm(t, dense, y))
+                v = torch.randn(n, device=device)
+                self.assertEqual(torch.mv(csr, v), torch.mv(dense, v))
+
+    def test_sparse_csr_matmul(self):
+        self._test_sparse_csr_matmul('cpu')
+
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    def test_sparse_csr_matmul_cuda(self):
+        self._test_sparse_csr_matmul('cuda')
+
+    def test_sparse_csr_matmul_backward(self):
+        csr, dense = self._gen_csr(6, 5, 0.4)
+        y = torch.randn(5, 4, requires_grad=True)
+        v = torch.randn(5, requires_grad=True)
+        torch.mm(csr, y).sum().backward()
+        self.assertEqual(y.grad, dense.t().mm(torch.ones(6, 4)))
+        torch.mv(csr, v).sum().backward()
+        self.assertEqual(v.grad, dense.t().mv(torch.ones(6)))
+
+
 if __name__ == '__main__':
     run_tests()
@@ -6,7 +6,7 @@ import unittest
 from torch.testing._internal.common_utils import suppress_warnings, num_profiled_runs
 
 from te_utils import CudaCodeGenCreated, CudaCodeGenExecuted, \
-    LLVMCodeGenExecuted, SimpleIREvalExecuted
+    LLVMCodeGenCreated, LLVMCodeGenExecuted, SimpleIREvalExecuted
 
 class BaseTestClass(unittest.TestCase):
     def setUp(self):
@@ -550,6 +550,39 @@ class TestTensorExprFuser(BaseTestClass):
         np.testing.assert_allclose(traced(a)[0], np.amin(a.numpy(), axis=1))
 
 
+    def test_layer_norm_gelu(self):
+        llvm_executed = LLVMCodeGenExecuted()
+        simple_ir_eval_executed = SimpleIREvalExecuted()
+
+        def test(x, b, w, c):
+            y = F.layer_norm(x + b, [64], w, c)
+            return F.gelu(y) + F.softmax(x, -1)
+
+        shapes = [(4, 64), (64,), (64,), (64,)]
+        traced = torch.jit.trace(test, tuple(torch.zeros(s) for s in shapes))
+        args = [torch.randn(s) for s in shapes]
+        for _ in range(3):
+            np.testing.assert_allclose(
+                traced(*args).numpy(), test(*args).numpy(), rtol=1e-4, atol=1e-4
+            )
+        assert (
+            llvm_executed.elapsed_value() >= 1
+            or simple_ir_eval_executed.elapsed_value() >= 1
+        )
+
+
+    def test_sum_mean(self):
+        def test(x):
+            return (x.sum(1, keepdim=True) * x).mean(0) + x.sum()
+
+        traced = torch.jit.trace(test, (torch.zeros(16, 32)))
+        a = torch.rand(16, 32)
+        for _ in range(3):
+            np.testing.assert_allclose(
+                traced(a).numpy(), test(a).numpy(), rtol=1e-5
+            )
+
+
     def test_clamp(self):
         def test(x):
             return torch.clamp(x + 3.0, 0.0, 6.0)
@@ -1138,6 +1171,52 @@ class TestTensorExprFuser(BaseTestClass):
         assert llvm.elapsed_value() == 1 or interp.elapsed_value() > 1
 
 
+    def test_dynamic_shape_cpu(self):
+        old_dynamic_shapes = torch._C._jit_texpr_dynamic_shapes_enabled()
+        torch._C._jit_set_texpr_dynamic_shapes_enabled(True)
+        try:
+            with num_profiled_runs(2):
+                @torch.jit.script
+                def test(x, y, z):
+                    return torch.softmax(x * y + z, -1)
+                llvm = LLVMCodeGenCreated()
+                z = torch.rand(8)
+                _ = test(torch.rand(4, 8), torch.rand(4, 8), z)
+                _ = test(torch.rand(6, 8), torch.rand(6, 8), z)
+                # The profiled runs had different batch sizes, the kernel
+                # takes it as an argument instead of being recompiled.
+                for n in (4, 5, 33):
+                    x, y = torch.rand(n, 8), torch.rand(n, 8)
+                    res = test(x, y, z)
+                    ref = torch.softmax(x * y + z, -1)
+                    np.testing.assert_allclose(ref.numpy(), res.numpy(), rtol=1e-5)
+                assert llvm.elapsed_value() <= 1
+
+                # Changing a static dimension fails guards.
+                x, y, z = torch.rand(4, 7), torch.rand(4, 7), torch.rand(7)
+                res = test(x, y, z)
+                ref = torch.softmax(x * y + z, -1)
+                np.testing.assert_allclose(ref.numpy(), res.numpy(), rtol=1e-5)
+        finally:
+            torch._C._jit_set_texpr_dynamic_shapes_enabled(old_dynamic_shapes)
+
+    def test_async_compilation(self):
+        old_async = torch._C._jit_texpr_async_compilation_enabled()
+        torch._C._jit_set_texpr_async_compilation_enabled(True)
+        try:
+            @torch.jit.script
+            def test(x, y, z):
+                return x * y + z * x
+            x, y, z = torch.rand(64), torch.rand(64), torch.rand(64)
+            ref = x * y + z * x
+            # Results are the same whether the runs go through the interpreter
+            # or through the kernel once it is compiled.
+            for _ in range(20):
+                res = test(x, y, z)
+                np.testing.assert_allclose(ref.numpy(), res.numpy(), rtol=1e-6)
+        finally:
+            torch._C._jit_set_texpr_async_compilation_enabled(old_async)
+
     @unittest.skipIf(not torch.cuda.is_available(), "requires CUDA")
     @unittest.skip("dynamic shapes are not quite there yet")
     def test_dynamic_shape(self):
@@ -1,8 +1,11 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 
+import sys
 import torch
 import tempfile
+import unittest
 from torch.utils import ThroughputBenchmark
+from torch.utils.throughput_benchmark import DynamicBatcher
 from torch.testing import assert_allclose
 
 from torch.testing._internal.common_utils import run_tests, TestCase
@@ -69,6 +72,16 @@ class TestThroughputBenchmark(TestCase):
 
         print(stats)
 
+        self.assertEqual(len(stats.thread_stats), 4)
+        self.assertEqual(sum(t.num_iters for t in stats.thread_stats), stats.num_iters)
+        self.assertEqual(sum(count for _, count in stats.latency_histogram), stats.num_iters)
+        self.assertGreater(stats.latency_p50_ms, 0)
+        self.assertLessEqual(stats.latency_p50_ms, stats.latency_p90_ms)
+        self.assertLessEqual(stats.latency_p90_ms, stats.latency_p99_ms)
+        self.assertLessEqual(stats.latency_p99_ms, stats.latency_p999_ms)
+        self.assertLessEqual(stats.latency_p999_ms, stats.latency_max_ms)
+        self.assertGreater(stats.warmup_latency_avg_ms, 0)
+
 
     def test_script_module(self):
         self.linear_test(TwoLayerNet)
@@ -76,10 +89,54 @@ class TestThroughputBenchmark(TestCase):
     def test_module(self):
         self.linear_test(TwoLayerNetModule)
 
+    @unittest.skipIf(not sys.platform.startswith('linux'), "CPU pinning is only supported on Linux")
+    def test_cpu_affinity(self):
+        module = TwoLayerNet(10, 5, 15)
+        bench = ThroughputBenchmark(module)
+        bench.add_input(torch.randn(8, 10), torch.randn(8, 10))
+        stats = bench.benchmark(num_calling_threads=2, num_iters=100, cpu_affinity=[0])
+        self.assertEqual(stats.num_iters, 100)
+
     def test_profiling(self):
         with tempfile.NamedTemporaryFile(delete=False) as f:
             self.linear_test(TwoLayerNetModule, profiler_output_path=f.name)
 
+    def test_dynamic_batcher(self):
+        D_in = 10
+        H = 5
+        D_out = 15
+        module = TwoLayerNet(D_in, H, D_out)
+        batcher = DynamicBatcher(max_batch_size=4, max_delay_us=100000)
+        batcher.add_model("linear", module)
+
+        inputs = [(torch.randn(D_in), torch.randn(D_in)) for _ in range(8)]
+        futures = [batcher.submit("linear", *input) for input in inputs]
+        for input, fut in zip(inputs, futures):
+            expected = module(input[0].unsqueeze(0), input[1].unsqueeze(0))
+            assert_allclose(fut.wait(), expected.squeeze(0))
+
+        stats = batcher.stats("linear")
+        self.assertEqual(stats.num_requests, 8)
+        self.assertLess(stats.num_batches, 8)
+        self.assertGreaterEqual(stats.latency_p99_ms, stats.latency_p50_ms)
+        batcher.shutdown()
+        with self.assertRaisesRegex(RuntimeError, "shut down"):
+            batcher.submit("linear", *inputs[0])
+
+    def test_dynamic_batcher_padding(self):
+        class Double(torch.jit.ScriptModule):
+            @torch.jit.script_method
+            def forward(self, x):
+                return x * 2
+
+        batcher = DynamicBatcher(max_batch_size=3, max_delay_us=100000, padding_value=-1)
+        batcher.add_model("double", Double())
+        inputs = [torch.randn(length, 4) for length in (2, 5, 3)]
+        futures = [batcher.submit("double", input) for input in inputs]
+        for input, fut in zip(inputs, futures):
+            self.assertEqual(fut.wait(), input * 2)
+        batcher.shutdown()
+
 
 if __name__ == '__main__':
     run_tests()
@@ -20,18 +20,19 @@ from torch._six import inf, nan, string_classes, istuple
 from itertools import product, combinations, combinations_with_replacement, permutations
 from functools import reduce
 from functools import partial
+from contextlib import contextmanager
 from random import randrange
 from torch import multiprocessing as mp
 from torch.testing._internal.common_methods_invocations import tri_tests_args, run_additional_tri_tests, \
     _compare_trilu_indices
-from torch.testing._internal.common_utils import TestCase, iter_indices, TEST_NUMPY, TEST_SCIPY, TEST_MKL, \
+from torch.testing._internal.common_utils import TestCase, iter_indices, TEST_NUMPY, TEST_SCIPY, \
     TEST_LIBROSA, TEST_WITH_ROCM, run_tests, skipIfNoLapack, suppress_warnings, \
     IS_WINDOWS, NO_MULTIPROCESSING_SPAWN, do_test_dtypes, do_test_empty_full, \
     IS_SANDCASTLE, load_tests, slowTest, skipCUDANonDefaultStreamIf, skipCUDAMemoryLeakCheckIf, \
     BytesIOContext, skipIfRocm, torch_to_numpy_dtype_dict, skipIfNoSciPy, IS_MACOS, IS_PPC
 from multiprocessing.reduction import ForkingPickler
 from torch.testing._internal.common_device_type import instantiate_device_type_tests, \
-    skipCPUIfNoLapack, skipCPUIfNoMkl, skipCUDAIfNoMagma, skipCUDAIfRocm, skipCUDAIfNotRocm, onlyCUDA, onlyCPU, \
+    skipCPUIfNoLapack, skipCUDAIfNoMagma, skipCUDAIfRocm, skipCUDAIfNotRocm, onlyCUDA, onlyCPU, \
     dtypes, dtypesIfCUDA, dtypesIfCPU, deviceCountAtLeast, skipCUDAIf, precisionOverride, \
     PYTORCH_CUDA_MEMCHECK, largeCUDATensorTest, largeTensorTest, onlyOnCPUAndCUDA
 from typing import Dict, List, Tuple, Union
@@ -798,6 +799,39 @@ class AbstractTestCases:
             self.assertEqual(y[:, 0], range(100))
             self.assertEqual(y[:, 40], range(4000, 4100))
 
+        def test_copy_permuted(self):
+            # transposed copies go through the blocked transpose kernel;
+            # check them against an element by element reference
+            for dtype in [torch.uint8, torch.int16, torch.float, torch.double, torch.bool]:
+                x = torch.arange(3 * 37 * 70).reshape(3, 37, 70).to(dtype)
+                for dims in [(0, 2, 1), (2, 1, 0), (1, 2, 0)]:
+                    p = x.permute(*dims)
+                    self.assertEqual(p.contiguous().tolist(), p.tolist())
+
+                # contiguous source, transposed destination
+                x = torch.arange(64 * 35).reshape(64, 35).to(dtype)
+                y = torch.empty(35, 64, dtype=dtype).t()
+                y.copy_(x)
+                self.assertEqual(y.tolist(), x.tolist())
+
+        def test_copy_float_16bit(self):
+            # contiguous float <-> half / bfloat16 casts convert a vector at a
+            # time; check them against the element by element strided copies
+            special = torch.tensor([0., -0., 1., 65504., 65520., 1e-8, 6e-8, -2e-5, 3.5e38,
+                                    float('inf'), float('-inf'), float('nan')])
+            x = torch.cat([special, torch.randn(1003), torch.randn(1000) * 1e5, torch.randn(1000) * 1e-6])
+            x_strided = torch.stack([x, x], dim=1)[:, 0]
+            self.assertFalse(x_strided.is_contiguous())
+            for dtype in [torch.half, torch.bfloat16]:
+                y = x.to(dtype)
+                self.assertEqual(y.float(), x_strided.to(dtype).float(), atol=0, rtol=0)
+                y_strided = torch.stack([y, y], dim=1)[:, 0]
+                self.assertEqual(y.float(), y_strided.float(), atol=0, rtol=0)
+                out = torch.empty(x.numel(), dtype=dtype)
+                out.copy_(x)
+                self.assertEqual(out.float(), y.float(), atol=0, rtol=0)
+            self.assertEqual(x.half().numpy(), x.numpy().astype(np.float16))
+
         def test_device(self):
             cpu = torch.device('cpu')
             self.assertEqual('cpu', str(cpu))
@@ -2104,10 +2138,51 @@ class AbstractTestCases:
             _test_complex((50,), 2, lambda x: x.as_strided([5, 5, 2], [4, 2, 2]))
             _test_complex((50,), 2, lambda x: x.as_strided([5, 5, 2], [4, 3, 1]))
 
-        @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
         def test_fft_ifft_rfft_irfft(self):
             self._test_fft_ifft_rfft_irfft(self)
 
+            @contextmanager
+            def plan_cache_max_size(n):
+                plan_cache = torch.backends.cpu.fft_plan_cache
+                original = plan_cache.max_size
+                plan_cache.max_size = n
+                yield
+                plan_cache.max_size = original
+
+            with plan_cache_max_size(max(1, torch.backends.cpu.fft_plan_cache.size - 10)):
+                self._test_fft_ifft_rfft_irfft(self)
+
+            with plan_cache_max_size(0):
+                self._test_fft_ifft_rfft_irfft(self)
+
+            torch.backends.cpu.fft_plan_cache.clear()
+            self.assertEqual(torch.backends.cpu.fft_plan_cache.size, 0)
+
+            with self.assertRaisesRegex(RuntimeError, r"must be non-negative"):
+                torch.backends.cpu.fft_plan_cache.max_size = -1
+
+            with self.assertRaisesRegex(RuntimeError, r"read-only property"):
+                torch.backends.cpu.fft_plan_cache.size = -1
+
+        @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+        def test_fft_odd_and_prime_sizes(self):
+            # radix 3 and generic butterflies, odd real lengths and the
+            # Bluestein path for large primes
+            for n in (1, 7, 30, 97, 210, 1009):
+                for dtype, prec in ((torch.double, 1e-8), (torch.float, 1e-3)):
+                    x = torch.randn(3, n, dtype=dtype)
+                    expected = np.fft.fft(x.double().numpy())
+                    res = x.rfft(1, onesided=False)
+                    self.assertEqual(res[..., 0], torch.from_numpy(expected.real), atol=prec * n, rtol=0)
+                    self.assertEqual(res[..., 1], torch.from_numpy(expected.imag), atol=prec * n, rtol=0)
+                    rec = x.rfft(1).irfft(1, signal_sizes=(n,))
+                    self.assertEqual(rec, x, atol=prec, rtol=0)
+                    xc = torch.randn(2, n, 5, 2, dtype=dtype)
+                    expected = np.fft.fft2(xc[..., 0].double().numpy() + 1j * xc[..., 1].double().numpy())
+                    res = xc.fft(2)
+                    self.assertEqual(res[..., 0], torch.from_numpy(expected.real), atol=prec * n, rtol=0)
+                    self.assertEqual(res[..., 1], torch.from_numpy(expected.imag), atol=prec * n, rtol=0)
+
         @unittest.skip("Not implemented yet")
         def test_conv2(self):
             x = torch.rand(math.floor(torch.uniform(50, 100)), math.floor(torch.uniform(50, 100)))
@@ -2300,6 +2375,45 @@ class AbstractTestCases:
             self.assertEqual(seeded, reseeded, atol=0, rtol=0,
                              msg='repeated calls to manual_seed not generating same sequence of normally distributed numbers')
 
+        def test_parallel_cpu_rng(self):
+            # See Note [Parallel CPU random numbers]
+            def fill(num_threads, size, dtype):
+                torch.set_num_threads(num_threads)
+                torch.manual_seed(7)
+                return (torch.empty(size, dtype=dtype).uniform_(-2, 3),
+                        torch.empty(size, dtype=dtype).normal_(1, 2),
+                        torch.empty(size, dtype=dtype).bernoulli_(0.3),
+                        torch.empty(size, dtype=torch.uint8).bernoulli_(0.3),
+                        torch.rand(3))
+
+            orig_parallel_rng = torch._C._get_cpu_parallel_rng()
+            orig_num_threads = torch.get_num_threads()
+            torch._C._set_cpu_parallel_rng(True)
+            try:
+                for dtype, size in product((torch.float, torch.double), (1, 15, 17, 100003)):
+                    expected = fill(1, size, dtype)
+                    for num_threads in (2, 4):
+                        for a, b in zip(expected, fill(num_threads, size, dtype)):
+                            self.assertEqual(a, b, atol=0, rtol=0)
+                    uniform, normal, bernoulli, bernoulli_uint8, _ = expected
+                    self.assertTrue(uniform.ge(-2).all() and uniform.lt(3).all())
+                    self.assertTrue(normal.isfinite().all())
+                    self.assertTrue(bernoulli.eq(0).logical_or(bernoulli.eq(1)).all())
+                    self.assertTrue(bernoulli_uint8.le(1).all())
+                    if size > 100000:
+                        self.assertEqual(uniform.mean().item(), 0.5, atol=0.05, rtol=0)
+                        self.assertEqual(normal.mean().item(), 1, atol=0.05, rtol=0)
+                        self.assertEqual(normal.std().item(), 2, atol=0.05, rtol=0)
+                        self.assertEqual(bernoulli.mean().item(), 0.3, atol=0.05, rtol=0)
+
+                # Each op advances the generator, so consecutive ops draw
+                # different numbers.
+                torch.manual_seed(7)
+                self.assertNotEqual(torch.rand(100), torch.rand(100))
+            finally:
+                torch._C._set_cpu_parallel_rng(orig_parallel_rng)
+                torch.set_num_threads(orig_num_threads)
+
         def test_manual_seed(self):
             rng_state = torch.get_rng_state()
             torch.manual_seed(2)
@@ -4427,6 +4541,60 @@ tensor([[[1.+1.j, 1.+1.j, 1.+1.j,  ..., 1.+1.j, 1.+1.j, 1.+1.j],
             x.strides = (3,)
             self.assertRaises(ValueError, lambda: torch.from_numpy(x))
 
+        def test_frombuffer(self) -> None:
+            import array
+            a = array.array('d', [1, 2, 3, 4])
+            t = torch.frombuffer(a, dtype=torch.float64)
+            self.assertEqual(t, torch.tensor([1., 2., 3., 4.], dtype=torch.float64))
+            t[0] = 5
+            self.assertEqual(a[0], 5)
+
+            b = bytearray(range(16))
+            t = torch.frombuffer(b, dtype=torch.uint8, count=4, offset=8)
+            self.assertEqual(t.tolist(), [8, 9, 10, 11])
+            self.assertEqual(torch.frombuffer(b, dtype=torch.int32).numel(), 4)
+            self.assertEqual(torch.frombuffer(b, dtype=torch.uint8, offset=16).numel(), 0)
+
+            # the tensor keeps the buffer alive
+            t = torch.frombuffer(bytearray(b'\x01\x02'), dtype=torch.uint8)
+            self.assertEqual(t.tolist(), [1, 2])
+
+            with warnings.catch_warnings(record=True):
+                self.assertEqual(torch.frombuffer(b'\x03', dtype=torch.uint8).tolist(), [3])
+
+            self.assertRaises(ValueError, lambda: torch.frombuffer(b, dtype=torch.int32, offset=2))
+            self.assertRaises(ValueError, lambda: torch.frombuffer(b, dtype=torch.uint8, count=10, offset=8))
+            self.assertRaises(ValueError, lambda: torch.frombuffer(b, dtype=torch.uint8, offset=17))
+            self.assertRaises(TypeError, lambda: torch.frombuffer([1, 2], dtype=torch.uint8))
+
+        def test_from_arrow(self) -> None:
+            try:
+                import pyarrow
+            except ImportError:
+                raise unittest.SkipTest("pyarrow not found")
+            for arrow_type, dtype in [(pyarrow.int8(), torch.int8), (pyarrow.uint8(), torch.uint8),
+                                      (pyarrow.int32(), torch.int32), (pyarrow.int64(), torch.int64),
+                                      (pyarrow.float32(), torch.float32), (pyarrow.float64(), torch.float64)]:
+                a = pyarrow.array([1, 2, 3, 4, 5], type=arrow_type)
+                t = torch.from_arrow(a)
+                self.assertEqual(t.dtype, dtype)
+                self.assertEqual(t.tolist(), [1, 2, 3, 4, 5])
+                self.assertEqual(torch.from_arrow(a[1:3]).tolist(), [2, 3])
+            self.assertRaises(ValueError, lambda: torch.from_arrow(pyarrow.array([1, None])))
+            self.assertRaises(TypeError, lambda: torch.from_arrow(pyarrow.array(['a'])))
+
+        def test_tensor_from_nested_lists(self) -> None:
+            floats = [[float(i * 5 + j) for j in range(5)] for i in range(4)]
+            ints = [[i * 5 + j for j in range(5)] for i in range(4)]
+            for data, dtype in [(floats, torch.float32), (floats, torch.float64),
+                                (ints, torch.float32), (ints, torch.int64), (ints, torch.int16)]:
+                t = torch.tensor(data, dtype=dtype)
+                self.assertEqual(t, torch.arange(20, dtype=dtype).view(4, 5))
+            # ints, bools and tensors can be mixed with floats
+            self.assertEqual(torch.tensor([[1, 2.5, True, torch.tensor(3)]], dtype=torch.float32),
+                             torch.tensor([[1., 2.5, 1., 3.]]))
+            self.assertEqual(torch.tensor([[1, True, 2]], dtype=torch.int64).tolist(), [[1, 1, 2]])
+
         @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
         def test_ctor_with_numpy_scalar_ctor(self) -> None:
             dtypes = [
@@ -7195,6 +7363,46 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(res1, res2)
         self.assertTrue(res2.is_contiguous(memory_format=torch.channels_last))
 
+    @onlyCUDA
+    def test_cat_stack_many_mixed_strides(self, device):
+        # inputs of any layout, and the skipped empty ones, are copied by the
+        # batched kernel; compare against the CPU, past one batch of inputs
+        def make_inputs(n, shape, dim):
+            inputs = []
+            for i in range(n):
+                size = list(shape)
+                size[dim] = i % 3 + 1
+                if i % 4 == 0:
+                    t = torch.randn(size, device=device)
+                elif i % 4 == 1:
+                    t = torch.randn(size[::-1], device=device).permute(*reversed(range(len(size))))
+                elif i % 4 == 2:
+                    t = torch.randn([2 * s for s in size], device=device)[(slice(None, None, 2),) * len(size)]
+                else:
+                    t = torch.randn(size[-1], device=device).expand(size)
+                inputs.append(t)
+                if i % 100 == 0:
+                    inputs.append(torch.randn(0, device=device))
+            return inputs
+
+        for shape in ((3, 5), (2, 3, 4, 5), (2, 3, 2, 2, 2)):
+            for dim in range(len(shape)):
+                inputs = make_inputs(1100, shape, dim)
+                res = torch.cat(inputs, dim)
+                self.assertEqual(res, torch.cat([t.cpu() for t in inputs], dim))
+
+        # channels last inputs, some of them strided
+        for dim in range(4):
+            inputs = [t for t in make_inputs(1100, (2, 3, 4, 5), dim) if t.dim() == 4]
+            inputs = [torch.cat((t, t), 3).contiguous(memory_format=torch.channels_last)[:, :, :, ::2] if i % 2
+                      else t.contiguous(memory_format=torch.channels_last) for i, t in enumerate(inputs)]
+            res = torch.cat(inputs, dim)
+            self.assertEqual(res, torch.cat([t.cpu() for t in inputs], dim))
+
+        inputs = [torch.randn(4, 5, device=device).t() for _ in range(500)]
+        for dim in range(3):
+            self.assertEqual(torch.stack(inputs, dim), torch.stack([t.cpu() for t in inputs], dim))
+
     @onlyCUDA
     @deviceCountAtLeast(2)
     def test_cat_different_devices(self, devices):
@@ -7402,6 +7610,57 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(torch.matmul(matrices, matrices_inverse),
                          torch.eye(3, dtype=torch.float64).to(device).expand_as(matrices))
 
+    # Covers the CPU kernels for matrices of size up to 8 and, with n = 9,
+    # the LAPACK path, both run in parallel over the batch
+    @onlyCPU
+    @skipCPUIfNoLapack
+    @dtypes(torch.double)
+    def test_linalg_small_matrices_batched(self, device, dtype):
+        from torch.testing._internal.common_utils import random_fullrank_matrix_distinct_singular_value
+
+        batch = 1000
+        for n in range(1, 10):
+            A = random_fullrank_matrix_distinct_singular_value(n, batch).to(dtype)
+            b = torch.randn(batch, n, 3, dtype=dtype)
+            eye = torch.eye(n, dtype=dtype).expand_as(A)
+
+            A_LU, pivots, infos = torch.lu(A, get_infos=True)
+            self.assertEqual(infos, torch.zeros_like(infos))
+            P, L, U = torch.lu_unpack(A_LU, pivots)
+            self.assertEqual(P.to(dtype).matmul(L).matmul(U), A)
+            self.assertEqual(A.matmul(torch.lu_solve(b, A_LU, pivots)), b)
+
+            self.assertEqual(A.matmul(torch.solve(b, A)[0]), b)
+            self.assertEqual(A.matmul(torch.inverse(A)), eye)
+
+            for upper in [True, False]:
+                pd = A.matmul(A.transpose(-2, -1).conj()) + eye
+                chol = torch.cholesky(pd, upper=upper)
+                if upper:
+                    self.assertEqual(chol.transpose(-2, -1).conj().matmul(chol), pd)
+                else:
+                    self.assertEqual(chol.matmul(chol.transpose(-2, -1).conj()), pd)
+                self.assertEqual(pd.matmul(torch.cholesky_solve(b, chol, upper=upper)), b)
+
+                for transpose, unitriangular in product([True, False], repeat=2):
+                    tri = (A_LU.triu() if upper else A_LU.tril()) + 2 * eye
+                    x = torch.triangular_solve(b, tri, upper=upper, transpose=transpose,
+                                               unitriangular=unitriangular)[0]
+                    if unitriangular:
+                        tri = tri - tri.diagonal(dim1=-2, dim2=-1).diag_embed() + eye
+                    if transpose:
+                        tri = tri.transpose(-2, -1)
+                    self.assertEqual(tri.matmul(x), b)
+
+            # singular matrices report the same info as LAPACK
+            singular = A.clone()
+            singular[::2, :, -1] = 0
+            infos = torch.lu(singular, get_infos=True)[2]
+            self.assertEqual(infos[::2], torch.full((batch // 2,), n, dtype=torch.int32))
+            self.assertEqual(infos[1::2], torch.zeros(batch // 2, dtype=torch.int32))
+            with self.assertRaisesRegex(RuntimeError, r'For batch 0: U\({0},{0}\) is zero'.format(n)):
+                torch.inverse(singular)
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     @dtypes(torch.double)
@@ -8005,6 +8264,31 @@ class TestTorchDeviceType(TestCase):
         for upper, batchsize in product([True, False], [(3,), (3, 4), (2, 3, 4)]):
             cholesky_test_helper(3, batchsize, upper)
 
+    @onlyCUDA
+    @unittest.skipIf(not torch._C.has_lapack, "PyTorch compiled without Lapack")
+    @dtypes(torch.double)
+    def test_linalg_small_matrices_batched(self, device, dtype):
+        from torch.testing._internal.common_utils import random_symmetric_matrix, random_symmetric_pd_matrix
+
+        # Sizes of up to 16 are factorized by one thread per matrix, unrolled up to 8
+        for n, upper in product([1, 3, 8, 9, 16], [True, False]):
+            A = random_symmetric_pd_matrix(n, 300, dtype=dtype, device=device)
+            self.assertEqual(torch.cholesky(A.cpu(), upper=upper), torch.cholesky(A, upper=upper))
+
+            A = random_symmetric_matrix(n, 300, dtype=dtype, device=device)
+            # Leave garbage in the triangle that should not be read
+            A_one_triangle = A.triu() + A.tril(-1).mul(2) if upper else A.tril() + A.triu(1).mul(2)
+            e, v = torch.symeig(A_one_triangle, eigenvectors=True, upper=upper)
+            self.assertEqual(torch.symeig(A.cpu())[0], e)
+            self.assertEqual(A, torch.matmul(torch.matmul(v, torch.diag_embed(e)), v.transpose(-2, -1)))
+            e_only, _ = torch.symeig(A_one_triangle, eigenvectors=False, upper=upper)
+            self.assertEqual(e, e_only)
+
+        A = torch.eye(3, dtype=dtype, device=device).expand(4, 3, 3).clone()
+        A[2, 1, 1] = -1
+        with self.assertRaisesRegex(RuntimeError, r'For batch 2: U\(2,2\) is zero'):
+            torch.cholesky(A)
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     @dtypes(torch.double)
@@ -9679,6 +9963,24 @@ class TestTorchDeviceType(TestCase):
                 self.assertEqual(xs1[j].item(), size[1] - i)
                 self.assertEqual(xs2[j].item(), size[1] - i)
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double, torch.uint8)
+    def test_reduction_vectorize_along_input_shifts(self, device, dtype):
+        # Inputs of 1 and 2 bytes are loaded 8 at a time, and every thread issues several loads before
+        # reducing them: cover every misalignment of the head, and lengths that leave a tail and a remainder
+        # of the unrolled loop, against the CPU.
+        for size in [129, 1000, 4096 + 7, 1024 * 1024 + 5]:
+            for shift in range(8):
+                x = torch.randint(0, 4, (size + shift,), device=device).to(dtype)
+                y = x[shift:]
+                self.assertEqual(y.sum(), y.cpu().sum())
+                self.assertEqual(y.view(1, -1).sum(dim=1), y.cpu().view(1, -1).sum(dim=1))
+                if dtype != torch.uint8:
+                    z = y.clone()
+                    z[size // 3] = 5
+                    self.assertEqual(z.argmax().item(), size // 3)
+                    self.assertEqual(z.max(), 5)
+
     @onlyCUDA
     @dtypes(torch.half, torch.float, torch.double)
     def test_reduction_vectorize_along_output(self, device, dtype):
@@ -10707,6 +11009,48 @@ class TestTorchDeviceType(TestCase):
             alias_samples = torch._multinomial_alias_draw(prob_table, alias_table, MAX_SAMPLES)
             self.assertEqual(alias_samples.unique(), probs.nonzero().squeeze(-1))
 
+    def test_multinomial_alias_large(self, device):
+        n_categories, n_samples = 1000, 1 << 20
+        probs = torch.softmax(torch.randn(n_categories, dtype=torch.double), 0).to(device)
+        alias_table, prob_table = torch._multinomial_alias_setup(probs)
+
+        def draw(seed):
+            torch.manual_seed(seed)
+            return torch._multinomial_alias_draw(prob_table, alias_table, n_samples)
+
+        # on CPU, draw both sequentially and with the parallel random numbers
+        parallel_modes = (False, True) if self.device_type == 'cpu' else (False,)
+        orig_parallel_rng = torch._C._get_cpu_parallel_rng()
+        try:
+            for parallel in parallel_modes:
+                torch._C._set_cpu_parallel_rng(parallel)
+                samples = draw(0)
+                self.assertEqual(samples, draw(0), atol=0, rtol=0)
+                self.assertTrue(samples.ge(0).all() and samples.lt(n_categories).all())
+                freqs = torch.bincount(samples, minlength=n_categories).to(probs.dtype) / n_samples
+                self.assertEqual(freqs, probs, atol=1e-3, rtol=0)
+        finally:
+            torch._C._set_cpu_parallel_rng(orig_parallel_rng)
+
+    @onlyCPU
+    def test_multinomial_rows_parallel(self, device):
+        # the rows are sampled in parallel from numbers drawn up front, so
+        # the samples don't depend on the number of threads
+        probs = torch.rand(1000, 50, dtype=torch.double)
+        orig_num_threads = torch.get_num_threads()
+        try:
+            for replacement in (True, False):
+                expected = None
+                for num_threads in (1, 4):
+                    torch.set_num_threads(num_threads)
+                    torch.manual_seed(0)
+                    samples = torch.multinomial(probs, 10, replacement)
+                    if expected is None:
+                        expected = samples
+                    self.assertEqual(samples, expected, atol=0, rtol=0)
+        finally:
+            torch.set_num_threads(orig_num_threads)
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     def test_lapack_empty(self, device):
@@ -11611,6 +11955,31 @@ class TestTorchDeviceType(TestCase):
             self.assertTrue(y.is_contiguous())
             self.assertEqual(expected, actual)
 
+    def test_cdist_topk(self, device):
+        def check(x, y, k, p):
+            values, indices = torch._cdist_topk(x, y, k, p)
+            expected_values, expected_indices = torch.cdist(x, y, p=p).topk(k, largest=False)
+            self.assertEqual(values, expected_values)
+            self.assertEqual(indices, expected_indices)
+
+        for p in [1, 2, 3, float('inf')]:
+            check(torch.randn(5, 3, dtype=torch.double, device=device),
+                  torch.randn(7, 3, dtype=torch.double, device=device), 4, p)
+            check(torch.randn(2, 3, 5, 3, dtype=torch.double, device=device),
+                  torch.randn(3, 7, 3, dtype=torch.double, device=device), 7, p)
+            check(torch.randn(5, 3, dtype=torch.double, device=device),
+                  torch.randn(7, 3, dtype=torch.double, device=device), 0, p)
+        # More than one tile of rows and of columns
+        check(torch.randn(1100, 3, dtype=torch.double, device=device),
+              torch.randn(5000, 3, dtype=torch.double, device=device), 10, 2)
+
+        x = torch.randn(4, 3, dtype=torch.double, device=device, requires_grad=True)
+        y = torch.randn(6, 3, dtype=torch.double, device=device, requires_grad=True)
+        self.assertTrue(torch.autograd.gradcheck(lambda x, y: torch._cdist_topk(x, y, 3)[0], (x, y)))
+
+        with self.assertRaisesRegex(RuntimeError, "must be between 0 and the number of rows of X2"):
+            torch._cdist_topk(torch.randn(5, 3, device=device), torch.randn(4, 3, device=device), 5)
+
     def test_multinomial_constraints(self, device):
         x = torch.empty(1, 2, 3, dtype=torch.double, device=device)
         self.assertRaisesRegex(
@@ -12156,6 +12525,26 @@ class TestTorchDeviceType(TestCase):
             expanded = torch.randn(1, 5, 1, 2, device=device).expand(3, 5, 7, 2)
             test_against_np(expanded)
 
+    def test_histc_bincount_large(self, device):
+        # enough elements for the CPU kernels to count in parallel, and bin
+        # counts that span the single and multi-pass shared memory histograms
+        # as well as the global memory one on CUDA
+        n = 1 << 20
+        for nbins in (10, 1000, 5000, 30000):
+            x = torch.randint(nbins, (n,), device=device)
+            w = torch.rand(n, dtype=torch.double, device=device)
+            counts = torch.zeros(nbins, dtype=torch.long).index_add_(
+                0, x.cpu(), torch.ones(n, dtype=torch.long))
+            sums = torch.zeros(nbins, dtype=torch.double).index_add_(0, x.cpu(), w.cpu())
+
+            self.assertEqual(torch.bincount(x, minlength=nbins).cpu(), counts)
+            self.assertEqual(torch.bincount(x, w, minlength=nbins).cpu(), sums)
+            # values halfway between the bin edges, which rounding can't
+            # move to a neighbouring bin
+            for dtype in (torch.float, torch.double):
+                actual = torch.histc(x.to(dtype) + 0.5, bins=nbins, min=0, max=nbins)
+                self.assertEqual(actual.cpu(), counts.to(dtype))
+
     def test_bool_tensor_comparison_ops(self, device):
         a = torch.tensor([True, False, True, False, True, False], dtype=torch.bool, device=device)
         b = torch.tensor([True, False, True, True, True, True], dtype=torch.bool, device=device)
@@ -12225,6 +12614,38 @@ class TestTorchDeviceType(TestCase):
             x.resize_as_(y)
             self.assertEqual(y.shape, x.shape)
 
+    def test_append_(self, device):
+        x = torch.empty(0, 3, device=device)
+        expected = []
+        for i in range(20):
+            row = torch.full((3,), i, device=device)
+            x.append_(row)
+            expected.append(row)
+        self.assertEqual(x, torch.stack(expected))
+        # the storage grows geometrically, not on every append
+        self.assertLess(x.storage().size(), 2 * x.numel() + 1)
+        self.assertGreater(x.storage().size(), x.numel() - 1)
+
+        data_ptr = x.data_ptr()
+        x.append_(torch.ones(1, 3, device=device))
+        self.assertEqual(x.data_ptr(), data_ptr)
+        x.append_(torch.zeros(2, 3, device=device, dtype=torch.int64))
+        self.assertEqual(x[-3:], torch.tensor([[1.] * 3, [0.] * 3, [0.] * 3], device=device))
+
+        # appending self or a view of it reads the rows from before the append
+        y = torch.arange(6., device=device).view(2, 3)
+        y.append_(y)
+        self.assertEqual(y, torch.arange(6., device=device).view(2, 3).repeat(2, 1))
+        y.append_(y[1:3])
+        self.assertEqual(y[4:], torch.tensor([[3., 4., 5.], [0., 1., 2.]], device=device))
+        y.append_(y[-1])
+        self.assertEqual(y[-1], torch.tensor([0., 1., 2.], device=device))
+
+        with self.assertRaisesRegex(RuntimeError, "cannot append a tensor of size"):
+            x.append_(torch.ones(2, device=device))
+        with self.assertRaisesRegex(RuntimeError, "expected a contiguous tensor"):
+            x.t().append_(torch.ones(3, device=device))
+
     def test_view_all_dtypes_and_devices(self, device):
         for dt in torch.testing.get_all_dtypes():
             x = torch.tensor([[1, 2], [3, 4], [5, 6]], dtype=dt, device=device)
@@ -12816,6 +13237,41 @@ class TestTorchDeviceType(TestCase):
                          torch.tensor([[3], [1]], device=device,
                                       dtype=torch.float32).repeat(1, width))
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_index_add_scatter_add_duplicates(self, device, dtype):
+        # many more indices than rows goes through the sort-based accumulation
+        atol, rtol = (1e-1, 1e-2) if dtype == torch.half else (1e-4, 1e-4)
+        index = torch.randint(0, 100, (5000,), device=device)
+        source = torch.randn(5000, 64, device=device, dtype=dtype)
+        expected = torch.zeros(100, 64, dtype=torch.double).index_add_(0, index.cpu(), source.cpu().double())
+        res = torch.zeros(100, 64, device=device, dtype=dtype).index_add_(0, index, source)
+        self.assertEqual(res, expected.to(dtype), atol=atol, rtol=rtol)
+
+        res = torch.zeros(64, 100, device=device, dtype=dtype).index_add_(1, index, source.t())
+        self.assertEqual(res, expected.t().to(dtype), atol=atol, rtol=rtol)
+
+        deterministic_restore = torch.is_deterministic()
+        try:
+            torch.set_deterministic(True)
+            # few duplicates, which also take the sort in deterministic mode
+            index = torch.randint(0, 4000, (5000,), device=device)
+            results = [torch.zeros(4000, 64, device=device, dtype=dtype).index_add_(0, index, source)
+                       for _ in range(2)]
+            self.assertEqual(results[0], results[1], atol=0, rtol=0)
+            expected = torch.zeros(4000, 64, dtype=torch.double).index_add_(0, index.cpu(), source.cpu().double())
+            self.assertEqual(results[0], expected.to(dtype), atol=atol, rtol=rtol)
+
+            scatter_index = torch.randint(0, 10, (300, 64), device=device)
+            results = [torch.zeros(10, 70, device=device, dtype=dtype).scatter_add_(0, scatter_index, source)
+                       for _ in range(2)]
+            self.assertEqual(results[0], results[1], atol=0, rtol=0)
+            expected = torch.zeros(10, 70, dtype=torch.double).scatter_add_(
+                0, scatter_index.cpu(), source.cpu().double())
+            self.assertEqual(results[0], expected.to(dtype), atol=atol, rtol=rtol)
+        finally:
+            torch.set_deterministic(deterministic_restore)
+
     @onlyCPU
     def test_scatter_reduce_non_unique_index(self, device):
         height = 2
@@ -12847,6 +13303,46 @@ class TestTorchDeviceType(TestCase):
             self.assertEqual(input, result)
 
 
+    @dtypes(torch.float, torch.double, torch.long)
+    def test_scatter_gather_rows(self, device, dtype):
+        # an index expanded along dim 1 moves whole rows; compare against
+        # the same index materialized, which takes the elementwise loop
+        for num_nodes, num_edges, features in [(10, 5000, 3), (7, 100, 1000), (50, 200, 16), (5, 40, 1)]:
+            src = torch.randint(-10, 10, (num_edges, features), device=device).to(dtype)
+            idx = torch.randint(0, num_nodes, (num_edges, 1), device=device)
+            expanded = idx.expand(num_edges, features)
+            materialized = expanded.contiguous()
+
+            x = torch.randint(-10, 10, (num_nodes, features), device=device).to(dtype)
+            self.assertEqual(x.gather(0, expanded), x.gather(0, materialized))
+            self.assertEqual(x.index_select(0, idx.view(-1)), x.gather(0, materialized))
+
+            out = torch.zeros(num_nodes, features, device=device, dtype=dtype)
+            expected = out.clone().scatter_add_(0, materialized, src)
+            self.assertEqual(out.scatter_add_(0, expanded, src), expected)
+
+        x = torch.zeros(3, 4, device=device, dtype=dtype)
+        idx = torch.tensor([[3]], device=device).expand(1, 4)
+        self.assertRaises(RuntimeError, lambda: x.gather(0, idx))
+        self.assertRaises(RuntimeError, lambda: x.scatter_add_(0, idx, torch.ones(1, 4, device=device, dtype=dtype)))
+
+    @onlyCPU
+    @dtypes(torch.bool, torch.half, torch.cfloat)
+    def test_scatter_gather_rows_other_dtypes(self, device, dtype):
+        # the dtypes the row fast paths don't vectorize still work with an
+        # expanded index
+        src = torch.randint(0, 2, (100, 5), device=device).to(dtype)
+        idx = torch.randint(0, 7, (100, 1), device=device)
+        expanded = idx.expand(100, 5)
+        materialized = expanded.contiguous()
+
+        x = torch.randint(0, 2, (7, 5), device=device).to(dtype)
+        self.assertEqual(x.gather(0, expanded), x.gather(0, materialized))
+
+        out = torch.zeros(7, 5, device=device, dtype=dtype)
+        expected = out.clone().scatter_add_(0, materialized, src)
+        self.assertEqual(out.scatter_add_(0, expanded, src), expected)
+
     def test_scatter_to_large_input(self, device):
         input = torch.zeros(4, 4, device=device)
         src = torch.ones(2, 2, device=device)
@@ -13803,7 +14299,6 @@ class TestTorchDeviceType(TestCase):
     # passes on ROCm w/ python 2.7, fails w/ python 3.6
     @skipCUDAIfRocm
     # stft -> rfft -> _fft -> _fft_with_size -> _fft_mkl
-    @skipCPUIfNoMkl
     @dtypes(torch.double)
     def test_stft(self, device, dtype):
         if not TEST_LIBROSA:
@@ -13865,7 +14360,6 @@ class TestTorchDeviceType(TestCase):
         _test((10,), 5, 4, win_sizes=(1, 1), expected_error=RuntimeError)
 
     @skipIfRocm
-    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
     def test_fft_input_modification(self, device):
         # FFT functions should not modify their input (gh-34551)
 
@@ -13886,7 +14380,6 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(half_spectrum, half_spectrum_copy)
 
     @onlyOnCPUAndCUDA
-    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
     @dtypes(torch.double)
     def test_istft_round_trip_simple_cases(self, device, dtype):
         """stft -> istft should recover the original signale"""
@@ -13899,7 +14392,6 @@ class TestTorchDeviceType(TestCase):
         _test(torch.zeros(4, dtype=dtype, device=device), 4, 4)
 
     @onlyOnCPUAndCUDA
-    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
     @dtypes(torch.double)
     def test_istft_round_trip_various_params(self, device, dtype):
         """stft -> istft should recover the original signale"""
@@ -14002,7 +14494,6 @@ class TestTorchDeviceType(TestCase):
 
     @onlyOnCPUAndCUDA
     @skipIfRocm
-    @skipCPUIfNoMkl
     @dtypes(torch.double)
     def test_istft_of_sine(self, device, dtype):
         def _test(amplitude, L, n):
@@ -14037,7 +14528,6 @@ class TestTorchDeviceType(TestCase):
 
     @onlyOnCPUAndCUDA
     @skipIfRocm
-    @skipCPUIfNoMkl
     @dtypes(torch.double)
     def test_istft_linearity(self, device, dtype):
         num_trials = 100
@@ -14102,7 +14592,6 @@ class TestTorchDeviceType(TestCase):
             _test(data_size, kwargs)
 
     @onlyOnCPUAndCUDA
-    @skipCPUIfNoMkl
     @skipIfRocm
     def test_batch_istft(self, device):
         original = torch.tensor([
@@ -14777,6 +15266,74 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(val, expected_val, atol=0, rtol=0)
         self.assertEqual(ind, expected_ind, atol=0, rtol=0)
 
+    @onlyCUDA
+    @dtypes(torch.uint8, torch.int8, torch.int16, torch.int32, torch.int64, torch.float, torch.double)
+    def test_sort_topk_large_slices(self, device, dtype):
+        # slices past the bitonic sort go through the segmented radix sort;
+        # compare against the CPU, across dims, with nans of either sign
+        shape = (3, 5000, 4)
+        if dtype.is_floating_point:
+            x = torch.randn(shape, dtype=dtype)
+            x[:, ::700] = float('nan')
+            x[:, 1::700] = -float('nan')
+            x[:, 2::700] = 0
+        else:
+            x = torch.randint(0, 100, shape, dtype=dtype)
+        x_cuda = x.to(device)
+        for dim in (1, 0, -1):
+            for descending in (False, True):
+                val, idx = x_cuda.sort(dim, descending=descending)
+                self.assertEqual(val, x.sort(dim, descending=descending)[0])
+                self.assertEqual(x_cuda.gather(dim, idx), val)
+                self.assertEqual(x_cuda.argsort(dim, descending=descending), idx)
+
+        for largest in (False, True):
+            val, idx = x_cuda.topk(3000, dim=1, largest=largest)
+            self.assertEqual(val, x_cuda.sort(1, descending=largest)[0][:, :3000])
+            self.assertEqual(x_cuda.gather(1, idx), val)
+
+    @onlyCPU
+    @dtypes(torch.int32, torch.int64, torch.float, torch.double)
+    def test_sort_topk_unique_large(self, device, dtype):
+        # large slices go through the parallel sort; compare against numpy
+        n = 1 << 17
+        if dtype.is_floating_point:
+            x = torch.randn(n, device=device, dtype=dtype)
+            x[::1000] = float('nan')
+            x[1::1000] = 0
+        else:
+            x = torch.randint(-100, 100, (n,), device=device, dtype=dtype)
+        for descending in (False, True):
+            val, idx = x.sort(descending=descending)
+            expected = np.sort(x.numpy(), kind='stable')
+            if descending:
+                expected = expected[::-1].copy()
+            self.assertEqual(val, torch.from_numpy(expected))
+            self.assertEqual(x[idx], val)
+
+        for largest in (False, True):
+            val, idx = x.topk(10, largest=largest)
+            self.assertEqual(val, x.sort(descending=largest)[0][:10])
+            self.assertEqual(x[idx], val)
+
+        if not dtype.is_floating_point:
+            out, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+            expected_out, expected_inverse, expected_counts = np.unique(
+                x.numpy(), return_inverse=True, return_counts=True)
+            self.assertEqual(out, torch.from_numpy(expected_out))
+            self.assertEqual(inverse, torch.from_numpy(expected_inverse))
+            self.assertEqual(counts, torch.from_numpy(expected_counts))
+
+            out, inverse, counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+            self.assertEqual(out[inverse], x)
+            self.assertEqual(out.sort()[0], torch.from_numpy(expected_out))
+            self.assertEqual(counts[out.argsort()], torch.from_numpy(expected_counts))
+
+            out, inverse, counts = torch.unique_consecutive(x, return_inverse=True, return_counts=True)
+            self.assertEqual(out[inverse], x)
+            self.assertEqual(torch.repeat_interleave(out, counts), x)
+            self.assertTrue((out[1:] != out[:-1]).all())
+
 
 
 
@@ -15293,6 +15850,29 @@ class TestTorchDeviceType(TestCase):
         z = from_dlpack(to_dlpack(x))
         self.assertEqual(z, x)
 
+    def test_dlpack_protocol(self, device):
+        x = torch.randn(1, 2, 3, 4, device=device, dtype=torch.float)
+        z = from_dlpack(x)
+        self.assertEqual(z, x)
+        self.assertEqual(z.data_ptr(), x.data_ptr())
+        device_type, device_index = x.__dlpack_device__()
+        self.assertEqual(device_type, 2 if x.is_cuda else 1)
+        self.assertEqual(device_index, x.device.index if x.is_cuda else 0)
+
+    @onlyCUDA
+    def test_dlpack_stream(self, device):
+        x = torch.zeros(1000, device=device)
+        side = torch.cuda.Stream()
+        with torch.cuda.stream(side):
+            torch.cuda._sleep(10000000)
+            x.fill_(1)
+            # the default stream, which the capsule is used on, waits for side
+            capsule = x.__dlpack__(stream=1)
+        self.assertFalse(side.query())
+        z = from_dlpack(capsule)
+        self.assertEqual(z.cpu(), torch.ones(1000))
+        self.assertRaises(ValueError, lambda: x.__dlpack__(stream=0))
+
     @onlyCUDA
     @unittest.skipIf(PYTORCH_CUDA_MEMCHECK, "is_pinned uses failure to detect pointer property")
     def test_pin_memory_from_constructor(self, device):
@@ -15435,6 +16015,49 @@ class TestTorchDeviceType(TestCase):
         self.assertTrue(torch.all(torch.min(a, dim=1)[0] == (-inf)).item())
         self.assertTrue(torch.min(a).item() == -inf)
 
+    @dtypes(torch.float, torch.double, torch.int8, torch.int32, torch.int64)
+    def test_aminmax(self, device, dtype):
+        a = torch.randint(-100, 100, (37, 1031), device=device, dtype=dtype)
+        for t in (a, a.t()):
+            mn, mx = torch.aminmax(t)
+            self.assertEqual(mn, t.min())
+            self.assertEqual(mx, t.max())
+            for dim in range(t.dim()):
+                for keepdim in (False, True):
+                    mn, mx = t.aminmax(dim=dim, keepdim=keepdim)
+                    self.assertEqual(mn, t.min(dim, keepdim=keepdim)[0])
+                    self.assertEqual(mx, t.max(dim, keepdim=keepdim)[0])
+
+        if dtype.is_floating_point:
+            b = a.clone()
+            b[3, 500] = nan
+            mn, mx = torch.aminmax(b, dim=1)
+            self.assertTrue(mn[3].isnan() and mx[3].isnan())
+            self.assertEqual(mn[:3], a[:3].min(1)[0])
+            self.assertTrue(torch.aminmax(b)[0].isnan())
+
+        with self.assertRaisesRegex(RuntimeError, 'empty'):
+            torch.aminmax(torch.empty(3, 0, dtype=dtype, device=device), dim=1)
+
+    @dtypes(torch.float, torch.double, torch.int8, torch.int32)
+    def test_max_min_dim_contiguous(self, device, dtype):
+        # long rows so the blocked path of the dim kernels is taken, with
+        # ties that have to resolve to the first index
+        a = torch.randint(-50, 50, (4, 3000), device=device, dtype=dtype)
+        a[0, 100] = a[0, 2900] = 60
+        a[1, 2000] = a[1, 10] = -60
+        for op, np_op in ((torch.max, np.amax), (torch.min, np.amin)):
+            values, indices = op(a, dim=1)
+            self.assertEqual(values.cpu(), torch.from_numpy(np_op(a.cpu().numpy(), axis=1)))
+            self.assertEqual(a.gather(1, indices.unsqueeze(1)).squeeze(1), values)
+        self.assertEqual(torch.max(a, dim=1)[1][0], 100)
+        self.assertEqual(torch.min(a, dim=1)[1][1], 10)
+        if dtype.is_floating_point:
+            a[2, 1700] = nan
+            a[2, 2500] = nan
+            self.assertEqual(torch.max(a, dim=1)[1][2], 1700)
+            self.assertEqual(torch.min(a, dim=1)[1][2], 1700)
+
     def test_bincount(self, device):
         # negative input throws
         with self.assertRaisesRegex(RuntimeError, '1-d non-negative integral'):
@@ -16529,6 +17152,57 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
                                 res2[i, j] += m1[i, l] * m2[l, j]
                     self.assertEqual(res1, res2)
 
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.float, torch.double, torch.half)
+    @tf32_on_and_off(0.005)
+    def test_addmm_activation(self, device, dtype):
+        def gelu_tanh(x):
+            return 0.5 * x * (1 + torch.tanh(math.sqrt(2 / math.pi) * (x + 0.044715 * x.pow(3))))
+
+        # A 1-D bias takes the cuBLASLt epilogue on CUDA, the other shapes and
+        # a beta other than 1 the separate activation.
+        for m, n, k in [(1, 8, 16), (7, 24, 8), (33, 64, 40)]:
+            for bias_shape, beta in [((n,), 1), ((n,), 0.5), ((m, n), 1), ((1, n), 1)]:
+                for use_gelu in [False, True]:
+                    bias = torch.randn(bias_shape, device=device, dtype=dtype)
+                    mat1 = torch.randn(m, k, device=device, dtype=dtype)
+                    mat2 = torch.randn(n, k, device=device, dtype=dtype).t()
+                    res = torch._addmm_activation(bias, mat1, mat2, beta=beta, alpha=0.5, use_gelu=use_gelu)
+                    ref = torch.addmm(bias.double(), mat1.double(), mat2.double(), beta=beta, alpha=0.5)
+                    ref = gelu_tanh(ref) if use_gelu else ref.relu()
+                    self.assertEqual(res, ref.to(dtype), atol=1e-2 if dtype == torch.half else None,
+                                     rtol=1e-2 if dtype == torch.half else None)
+
+        if dtype == torch.double:
+            for use_gelu in [False, True]:
+                bias = torch.randn(5, device=device, dtype=dtype, requires_grad=True)
+                mat1 = torch.randn(3, 4, device=device, dtype=dtype, requires_grad=True)
+                mat2 = torch.randn(4, 5, device=device, dtype=dtype, requires_grad=True)
+                def f(b, x, y):
+                    return torch._addmm_activation(b, x, y, beta=0.5, use_gelu=use_gelu)
+                self.assertTrue(torch.autograd.gradcheck(f, (bias, mat1, mat2)))
+                self.assertTrue(torch.autograd.gradgradcheck(f, (bias, mat1, mat2)))
+
+    @onlyCUDA
+    @skipCUDAIfRocm
+    @skipCUDAIf(torch.version.cuda is not None and int(torch.version.cuda.split('.')[0]) < 11,
+                "cuBLASLt is only used from CUDA 11 on")
+    def test_int_mm(self, device):
+        for m, k, n in [(1, 8, 8), (17, 32, 24), (64, 128, 72)]:
+            a = torch.randint(-128, 128, (m, k), device=device, dtype=torch.int8)
+            b = torch.randint(-128, 128, (k, n), device=device, dtype=torch.int8)
+            ref = torch.mm(a.cpu().int(), b.cpu().int())
+            self.assertEqual(torch._int_mm(a, b).cpu(), ref)
+            # Other layouts are copied to the one of the IMMA kernels.
+            self.assertEqual(torch._int_mm(a.t().contiguous().t(), b.t().contiguous().t()).cpu(), ref)
+            self.assertEqual(torch._int_mm(a, b.contiguous()).dtype, torch.int32)
+
+        with self.assertRaisesRegex(RuntimeError, "multiples of 8"):
+            torch._int_mm(torch.zeros(8, 7, device=device, dtype=torch.int8),
+                          torch.zeros(7, 8, device=device, dtype=torch.int8))
+        with self.assertRaisesRegex(RuntimeError, "int8"):
+            torch._int_mm(torch.zeros(8, 8, device=device), torch.zeros(8, 8, device=device))
+
     @onlyCPU
     @dtypes(torch.float, torch.double)
     def test_dot(self, device, dtype):
@@ -17123,6 +17797,35 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
             self.assertRaises(RuntimeError, lambda: torch.bmm(b1, b2.cuda()))
             self.assertRaises(RuntimeError, lambda: torch.bmm(b1.cuda(), b2))
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_bmm_small_batched(self, device, dtype):
+        # many small matrices go through the batched microkernel, which
+        # takes any strides; compare against per-matrix mm in double
+        for M, N, O in [(64, 64, 64), (7, 33, 17), (1, 5, 100), (13, 1, 6)]:
+            b1 = torch.randn(37, M, N, dtype=dtype, device=device)
+            b2 = torch.randn(37, N, O, dtype=dtype, device=device)
+            operands = [
+                (b1, b2),
+                (b1.transpose(1, 2).contiguous().transpose(1, 2), b2),
+                (b1, b2.transpose(1, 2).contiguous().transpose(1, 2)),
+                (b1, b2[:1].expand_as(b2)),
+                (b1[::2], b2[::2]),
+            ]
+            for x, y in operands:
+                expected = torch.stack([x[i].double().mm(y[i].double()) for i in range(x.size(0))])
+                self.assertEqual(torch.bmm(x, y), expected, exact_dtype=False)
+
+                out = torch.full((O, M, x.size(0)), nan, dtype=dtype, device=device).permute(2, 1, 0)
+                torch.bmm(x, y, out=out)
+                self.assertEqual(out, expected, exact_dtype=False)
+
+                c = torch.randn(x.size(0), M, O, dtype=dtype, device=device)
+                self.assertEqual(torch.baddbmm(c, x, y, beta=0.5, alpha=2),
+                                 0.5 * c.double() + 2 * expected, exact_dtype=False)
+                c.fill_(nan)
+                self.assertEqual(torch.baddbmm(c, x, y, beta=0), expected, exact_dtype=False)
+
     @onlyCPU
     @dtypes(torch.float)
     def test_addbmm(self, device, dtype):
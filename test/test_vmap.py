@@ -117,10 +117,10 @@ class TestVmapAPI(TestCase):
 
     def test_unsupported_op_err_msg(self):
         def foo(x):
-            return torch.cos(x)
+            return torch.digamma(x)
 
         x = torch.randn(3)
-        with self.assertRaisesRegex(RuntimeError, 'NYI: Calling aten::cos inside of vmap'):
+        with self.assertRaisesRegex(RuntimeError, 'NYI: Calling aten::digamma inside of vmap'):
             vmap(foo)(x)
 
     def test_unsupported_inplace_op_err_msg(self):
@@ -433,5 +433,12 @@ class TestVmapAPI(TestCase):
         vmap(foo, in_dims=(0,))(torch.randn(2, 3))
         vmap(foo, in_dims=(1,))(torch.randn(2, 3))
 
+    def test_basic_indexing(self):
+        # Batched tensors don't have strides, so indexing goes through the
+        # batching rules of the ops it is made of.
+        x = torch.randn(2, 3, 5)
+        self.assertEqual(vmap(lambda t: t[None, ...])(x), x.unsqueeze(1))
+        self.assertEqual(vmap(lambda t: t[..., None])(x), x.unsqueeze(-1))
+
 if __name__ == '__main__':
     run_tests()
@@ -602,7 +602,7 @@ Tensor clamp_backward(const Tensor & grad, const Tensor &self, const optional<Sc
 
 Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, const Tensor & mat1, const Scalar & alpha) {
   // if input was column-major, return grad as column-order for efficiency
-  if (mat1.is_sparse()) {
+  if (mat1.is_sparse() || mat1.is_sparse_csr()) {
     throw std::runtime_error("calculating the gradient of a sparse Tensor argument to mm is not supported.");
   }
   at::IntArrayRef sizes = mat1.sizes();
@@ -615,6 +615,10 @@ Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, const Tensor &
 }
 
 Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef sizes, IntArrayRef strides, const Scalar & alpha) {
+  if (mat1.is_sparse_csr()) {
+    // A CSR matrix can't be transposed in place, but its COO view can
+    return mm_mat2_backward(grad, mat1.to_sparse(), sizes, strides, alpha);
+  }
   // if input was column-major, return grad as column-order for efficiency
   if (strides[0] == 1 && strides[1] == sizes[0]) {
     if (mat1.is_sparse()) {
@@ -634,6 +638,28 @@ Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef si
   }
 }
 
+std::tuple<Tensor, Tensor, Tensor> addmm_activation_backward(
+    const Tensor & grad, const Tensor & result, const Tensor & self, const Tensor & mat1, const Tensor & mat2,
+    const Scalar & beta, const Scalar & alpha, bool use_gelu, std::array<bool, 3> grad_input_mask) {
+  Tensor grad_addmm;
+  if (use_gelu) {
+    // The derivative of the tanh approximation of gelu needs its input, which
+    // is recomputed rather than saved.
+    const double kBeta = M_2_SQRTPI * M_SQRT1_2;
+    const double kKappa = 0.044715;
+    Tensor x = at::addmm(self, mat1, mat2, beta, alpha);
+    Tensor tanh_inner = (kBeta * (x + kKappa * x.pow(3))).tanh();
+    grad_addmm = grad * (0.5 * (1 + tanh_inner) +
+        0.5 * x * (1 - tanh_inner * tanh_inner) * kBeta * (1 + 3 * kKappa * x * x));
+  } else {
+    grad_addmm = threshold_backward(grad, result, 0);
+  }
+  return std::make_tuple(
+      grad_input_mask[0] ? maybe_multiply(grad_addmm, beta) : Tensor(),
+      grad_input_mask[1] ? mm_mat1_backward(grad_addmm, mat2, mat1, alpha) : Tensor(),
+      grad_input_mask[2] ? mm_mat2_backward(grad_addmm, mat1, mat2.sizes(), mat2.strides(), alpha) : Tensor());
+}
+
 Tensor _sparse_addmm_sparse_backward(const Tensor& grad, const Tensor& sparse_, const Tensor& dense, const Scalar& alpha) {
   AT_ASSERT(sparse_.is_sparse());
   auto sparse = sparse_.coalesce();
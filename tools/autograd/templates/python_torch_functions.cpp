@@ -15,6 +15,7 @@
 #include "torch/csrc/Exceptions.h"
 #include "torch/csrc/utils/pybind.h"
 #include "torch/csrc/utils/python_arg_parser.h"
+#include "torch/csrc/utils/tensor_arrow.h"
 #include "torch/csrc/utils/tensor_layouts.h"
 #include "torch/csrc/utils/tensor_new.h"
 #include "torch/csrc/utils/tensor_numpy.h"
@@ -403,6 +404,24 @@ static PyObject * THPVariable_from_numpy(PyObject* module, PyObject* arg)
   END_HANDLE_TH_ERRORS
 }
 
+// implemented on python object for the same reason as from_numpy
+static PyObject * THPVariable_frombuffer(PyObject* self, PyObject* args, PyObject* kwargs)
+{
+  HANDLE_TH_ERRORS
+  jit::tracer::warn("torch.frombuffer", jit::tracer::WARN_CONSTRUCTOR);
+  return THPVariable_Wrap(torch::utils::tensor_frombuffer(torch::tensors::get_default_scalar_type(), args, kwargs));
+  END_HANDLE_TH_ERRORS
+}
+
+// implemented on python object for the same reason as from_numpy
+static PyObject * THPVariable_from_arrow(PyObject* module, PyObject* arg)
+{
+  HANDLE_TH_ERRORS
+  jit::tracer::warn("torch.from_arrow", jit::tracer::WARN_CONSTRUCTOR);
+  return THPVariable_Wrap(torch::utils::tensor_from_arrow(arg));
+  END_HANDLE_TH_ERRORS
+}
+
 static Tensor dispatch_nonzero(const Tensor & self) {
   pybind11::gil_scoped_release no_gil;
   OptionalDeviceGuard device_guard(device_of(self));
@@ -492,6 +511,8 @@ static PyMethodDef torch_functions[] = {
   {"arange", (PyCFunction)(void(*)(void))THPVariable_arange, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
   {"as_tensor", (PyCFunction)(void(*)(void))THPVariable_as_tensor, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
   {"dsmm", (PyCFunction)(void(*)(void))THPVariable_mm, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
+  {"frombuffer", (PyCFunction)(void(*)(void))THPVariable_frombuffer, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
+  {"from_arrow", (PyCFunction)THPVariable_from_arrow, METH_STATIC | METH_O, NULL},
   {"from_numpy", (PyCFunction)THPVariable_from_numpy, METH_STATIC | METH_O, NULL},
   {"full", (PyCFunction)(void(*)(void))THPVariable_full, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
   {"hsmm", (PyCFunction)(void(*)(void))THPVariable_hspmm, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
@@ -457,6 +457,7 @@ del ComplexFloatStorageBase
 ################################################################################
 
 import torch.cuda
+import torch.cpu
 import torch.autograd
 from torch.autograd import no_grad, enable_grad, set_grad_enabled
 import torch.futures
@@ -473,6 +474,7 @@ import torch.hub
 import torch.random
 import torch.distributions
 import torch.testing
+import torch.backends.cpu
 import torch.backends.cuda
 import torch.backends.mkl
 import torch.backends.mkldnn
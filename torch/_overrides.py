@@ -66,7 +66,9 @@ def get_ignored_functions():
         torch.set_num_threads,
         torch.wait,
         torch.as_tensor,
+        torch.from_arrow,
         torch.from_numpy,
+        torch.frombuffer,
         torch.get_device,
         torch.tensor,
         torch.default_generator,
@@ -143,6 +145,8 @@ def get_ignored_functions():
         torch.nn.functional.tanh,
         torch.set_autocast_enabled,
         torch.is_autocast_enabled,
+        torch.set_autocast_cpu_enabled,
+        torch.is_autocast_cpu_enabled,
         torch.clear_autocast_cache,
         torch.autocast_increment_nesting,
         torch.autocast_decrement_nesting,
@@ -190,6 +194,7 @@ def get_testing_overrides():
         torch.all: lambda input, dim=None: -1,
         torch.allclose: lambda input, other, trol=1e-05, atol=1e-08, equal_nan=False: -1,
         torch.alpha_dropout: lambda input, p, train, inplace=False: -1,
+        torch.aminmax: lambda input, dim=None, keepdim=False: -1,
         torch.angle: lambda input, out=None: -1,
         torch.any: lambda input, dim=None, keepdim=False, out=None: -1,
         torch.argmax: lambda input: -1,
@@ -282,6 +287,8 @@ def get_testing_overrides():
         torch.div: lambda input, other, out=None: -1,
         torch.dot: lambda mat1, mat2: -1,
         torch.dropout: lambda input, p, train, inplace=False: -1,
+        torch.dropout_add_layer_norm: (lambda input, residual, p, train, normalized_shape, weight=None, bias=None,
+                                       eps=1e-05: -1),
         torch.dsmm: lambda input, mat2: -1,
         torch.hsmm: lambda mat1, mat2: -1,
         torch.eig: lambda input, eigenvectors=False, out=None: -1,
@@ -299,7 +306,9 @@ def get_testing_overrides():
         torch.exp: lambda input, out=None: -1,
         torch.expm1: lambda input, out=None: -1,
         torch.fake_quantize_per_channel_affine: lambda input, scale, zero_point, axis, quant_min, quant_max: -1,
+        torch.fake_quantize_per_channel_affine_cachemask: lambda input, scale, zero_point, axis, quant_min, quant_max: -1,
         torch.fake_quantize_per_tensor_affine: lambda input, scale, zero_point, quant_min, quant_max: -1,
+        torch.fake_quantize_per_tensor_affine_cachemask: lambda input, scale, zero_point, quant_min, quant_max: -1,
         torch.fbgemm_linear_fp16_weight: lambda input, packed_weight, bias: -1,
         torch.fbgemm_linear_fp16_weight_fp32_activation: lambda input, packed_weight, bias: -1,
         torch.fbgemm_linear_int8_weight: lambda input, weight, packed, col_offsets, weight_scale, weight_zero_point, bias: -1,
@@ -432,6 +441,9 @@ def get_testing_overrides():
         torch.native_norm: lambda input, p=2: -1,
         torch.ne: lambda input, other, out=None: -1,
         torch.neg: lambda input, out=None: -1,
+        torch.nested_attention: lambda query, key, value, scale=None: -1,
+        torch.nested_tensor: lambda tensors: -1,
+        torch.nested_tensor_from_padded: lambda padded, lengths: -1,
         torch.nn.functional.adaptive_avg_pool2d: lambda input, output_size: -1,
         torch.nn.functional.adaptive_avg_pool3d: lambda input, output_size: -1,
         torch.nn.functional.adaptive_max_pool1d: lambda input, output_size, return_indices=False: -1,
@@ -419,6 +419,13 @@ allclose(other, rtol=1e-05, atol=1e-08, equal_nan=False) -> Tensor
 See :func:`torch.allclose`
 """)
 
+add_docstr_all('aminmax',
+               r"""
+aminmax(*, dim=None, keepdim=False) -> (Tensor min, Tensor max)
+
+See :func:`torch.aminmax`
+""")
+
 add_docstr_all('angle',
                r"""
 angle() -> Tensor
@@ -482,6 +489,34 @@ each element with the value returned by :attr:`callable`.
     sections that require high performance.
 """)
 
+add_docstr_all('append_',
+               r"""
+append_(other) -> Tensor
+
+Appends :attr:`other` to :attr:`self` along the first dimension, in-place.
+:attr:`other` is either one more slice of :attr:`self` along the first
+dimension, or several of them.
+
+When the storage of :attr:`self` is too small, it grows to at least twice its
+size, and the next appends use the space left. Growing a tensor by appends
+copies its elements a constant number of times on average, unlike
+:func:`torch.cat`, which copies all of them on every call.
+
+Args:
+    other (Tensor): the slices to append, the same size as :attr:`self` past
+        the first dimension
+
+Example::
+
+    >>> x = torch.empty(0, 2)
+    >>> x.append_(torch.tensor([1., 2.]))
+    tensor([[1., 2.]])
+    >>> x.append_(torch.tensor([[3., 4.], [5., 6.]]))
+    tensor([[1., 2.],
+            [3., 4.],
+            [5., 6.]])
+""")
+
 add_docstr_all('asin', r"""
 asin() -> Tensor
 
@@ -1389,6 +1424,28 @@ See also :meth:`Tensor.values`.
   :meth:`Tensor.coalesce` for details.
 """)
 
+add_docstr_all('crow_indices',
+               r"""
+crow_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of the compressed row offsets, of size ``nrows + 1``.
+Otherwise, this throws an error.
+
+See also :meth:`Tensor.col_indices` and :meth:`Tensor.values`.
+""")
+
+add_docstr_all('col_indices',
+               r"""
+col_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of the column index of each nonzero. Otherwise, this
+throws an error.
+
+See also :meth:`Tensor.crow_indices` and :meth:`Tensor.values`.
+""")
+
 add_docstr_all('get_device',
                r"""
 get_device() -> Device ordinal (Integer)
@@ -1408,11 +1465,12 @@ add_docstr_all('values',
                r"""
 values() -> Tensor
 
-If :attr:`self` is a sparse COO tensor (i.e., with ``torch.sparse_coo`` layout),
-this returns a view of the contained values tensor. Otherwise, this throws an
-error.
+If :attr:`self` is a sparse COO tensor (i.e., with ``torch.sparse_coo`` layout)
+or a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout), this returns a
+view of the contained values tensor. Otherwise, this throws an error.
 
-See also :meth:`Tensor.indices`.
+See also :meth:`Tensor.indices`, :meth:`Tensor.crow_indices` and
+:meth:`Tensor.col_indices`.
 
 .. note::
   This method can only be called on a coalesced sparse tensor. See
@@ -3318,6 +3376,35 @@ Example::
            size=(3, 3), nnz=1, layout=torch.sparse_coo)
 """)
 
+add_docstr_all('to_sparse_csr',
+               r"""
+to_sparse_csr() -> Tensor
+Returns a copy of the matrix in compressed sparse row (CSR) format, see
+:func:`torch.sparse_csr_tensor`. :attr:`self` can be a strided or sparse COO
+2-D tensor. The indices of the result are int64.
+
+Example::
+
+    >>> d = torch.tensor([[0, 0, 0], [9, 0, 10], [0, 0, 0]])
+    >>> d.to_sparse_csr()
+    tensor(crow_indices=tensor([0, 0, 2, 2]),
+           col_indices=tensor([0, 2]),
+           values=tensor([ 9, 10]), size=(3, 3), nnz=2,
+           layout=torch.sparse_csr)
+""")
+
+add_docstr_all('to_padded_tensor',
+               r"""
+to_padded_tensor(padding=0) -> Tensor
+
+Returns a copy of a nested tensor as a regular tensor of the same size, with
+the components padded with :attr:`padding` up to the longest one. See
+:func:`torch.nested_tensor`.
+
+Args:
+    padding (float, optional): the value of the padding. Default: 0
+""")
+
 add_docstr_all('to_mkldnn',
                r"""
 to_mkldnn() -> Tensor
@@ -3900,6 +3987,12 @@ Is ``True`` if the Tensor is a meta tensor, ``False`` otherwise.  Meta tensors
 are like normal tensors, but they carry no data.
 """)
 
+add_docstr_all('is_nested',
+               r"""
+Is ``True`` if the Tensor is a nested tensor, ``False`` otherwise. See
+:func:`torch.nested_tensor`.
+""")
+
 add_docstr_all('device',
                r"""
 Is the :class:`torch.device` where this Tensor is.
@@ -275,7 +275,7 @@ def get_summarized_data(self):
         return torch.stack([get_summarized_data(x) for x in self])
 
 def _str_intern(self):
-    prefix = 'tensor('
+    prefix = 'nested_tensor(' if self.is_nested else 'tensor('
     indent = len(prefix)
     suffixes = []
 
@@ -309,6 +309,37 @@ def _str_intern(self):
         if values.numel() == 0:
             values_str += ', size=' + str(tuple(values.shape))
         tensor_str = indices_prefix + indices_str + '),\n' + ' ' * indent + values_prefix + values_str + ')'
+    elif self.is_sparse_csr:
+        suffixes.append('size=' + str(tuple(self.shape)))
+        suffixes.append('nnz=' + str(self._nnz()))
+        if not has_default_dtype:
+            suffixes.append('dtype=' + str(self.dtype))
+        crow_indices_prefix = 'crow_indices=tensor('
+        crow_indices = self.crow_indices().detach()
+        crow_indices_str = _tensor_str(crow_indices, indent + len(crow_indices_prefix))
+        col_indices_prefix = 'col_indices=tensor('
+        col_indices = self.col_indices().detach()
+        col_indices_str = _tensor_str(col_indices, indent + len(col_indices_prefix))
+        if col_indices.numel() == 0:
+            col_indices_str += ', size=' + str(tuple(col_indices.shape))
+        values_prefix = 'values=tensor('
+        values = self.values().detach()
+        values_str = _tensor_str(values, indent + len(values_prefix))
+        if values.numel() == 0:
+            values_str += ', size=' + str(tuple(values.shape))
+        tensor_str = crow_indices_prefix + crow_indices_str + '),\n' + ' ' * indent + \
+            col_indices_prefix + col_indices_str + '),\n' + ' ' * indent + \
+            values_prefix + values_str + ')'
+    elif self.is_nested:
+        # Printed as the list of components, each one a dense tensor
+        suffixes.append('size=' + str(tuple(self.shape)))
+        if not has_default_dtype:
+            suffixes.append('dtype=' + str(self.dtype))
+        component_prefix = 'tensor('
+        component_indent = indent + 1 + len(component_prefix)
+        component_strs = [component_prefix + _tensor_str(component.detach(), component_indent) + ')'
+                          for component in self.unbind()]
+        tensor_str = '[' + (',\n' + ' ' * (indent + 1)).join(component_strs) + ']'
     elif self.is_quantized:
         suffixes.append('size=' + str(tuple(self.shape)))
         if not has_default_dtype:
@@ -331,7 +362,7 @@ def _str_intern(self):
             # a meta tensor, which it could be, but it isn't right now
             tensor_str = '...'
         else:
-            if self.numel() == 0 and not self.is_sparse:
+            if self.numel() == 0 and not self.is_sparse and not self.is_sparse_csr:
                 # Explicitly print the shape if it is not (0,), to match NumPy behavior
                 if self.dim() != 1:
                     suffixes.append('size=' + str(tuple(self.shape)))
@@ -364,7 +395,7 @@ def _str_intern(self):
     if self.has_names():
         suffixes.append('names={}'.format(self.names))
 
-    return _add_suffixes(prefix + tensor_str, suffixes, indent, force_newline=self.is_sparse)
+    return _add_suffixes(prefix + tensor_str, suffixes, indent, force_newline=self.is_sparse or self.is_sparse_csr or self.is_nested)
 
 def _str(self):
     with torch.no_grad():
@@ -527,6 +527,41 @@ Example::
     True
 """)
 
+add_docstr(torch.aminmax,
+           r"""
+aminmax(input, *, dim=None, keepdim=False) -> (Tensor min, Tensor max)
+
+Computes the minimum and maximum values of the :attr:`input` tensor in a
+single pass over the data.
+
+If :attr:`dim` is given, the minimum and maximum are taken along that
+dimension. Otherwise they are taken over all elements and returned as
+0-dimensional tensors.
+
+{keepdim_details}
+
+If any of the reduced values is ``NaN``, the corresponding minimum and
+maximum are ``NaN``. Unlike :func:`torch.min` and :func:`torch.max`, no
+indices are returned and the result is not differentiable.
+
+Args:
+    {input}
+    dim (int, optional): the dimension to reduce. Default: reduce all dimensions
+    {keepdim} Default: ``False``
+
+Example::
+
+    >>> a = torch.tensor([[1., -2., 3.], [4., 0., -6.]])
+    >>> torch.aminmax(a)
+    torch.return_types.aminmax(
+    min=tensor(-6.),
+    max=tensor(4.))
+    >>> torch.aminmax(a, dim=1)
+    torch.return_types.aminmax(
+    min=tensor([-2., -6.]),
+    max=tensor([3., 4.]))
+""".format(**single_dim_common))
+
 add_docstr(torch.angle,
            r"""
 angle(input, out=None) -> Tensor
@@ -2442,6 +2477,68 @@ Example::
     array([-1,  2,  3])
 """)
 
+add_docstr(torch.frombuffer,
+           r"""
+frombuffer(buffer, *, dtype=None, count=-1, offset=0, requires_grad=False) -> Tensor
+
+Creates a 1-dimensional :class:`Tensor` from an object that implements the
+Python buffer protocol, such as :class:`bytes`, :class:`bytearray`,
+:class:`memoryview` or :class:`array.array`.
+
+The returned tensor and :attr:`buffer` share the same memory, and the tensor
+keeps :attr:`buffer` alive. Modifications to the tensor will be reflected in
+the :attr:`buffer` and vice versa. The returned tensor is not resizable.
+
+.. note::
+    If :attr:`buffer` is read-only, such as :class:`bytes`, writing to the
+    tensor writes to the (supposedly read-only) buffer, and a warning is
+    issued.
+
+Args:
+    buffer (object): a Python object that exposes the buffer interface.
+
+Keyword args:
+    {dtype}
+    count (int, optional): the number of elements to read. If negative (the
+        default), all the elements after :attr:`offset` are read.
+    offset (int, optional): the number of bytes to skip at the start of the
+        buffer. Default: 0.
+    {requires_grad}
+
+Example::
+
+    >>> a = bytearray([1, 2, 3, 4])
+    >>> t = torch.frombuffer(a, dtype=torch.uint8, offset=1)
+    >>> t
+    tensor([2, 3, 4], dtype=torch.uint8)
+    >>> t[0] = 7
+    >>> a
+    bytearray(b'\x01\x07\x03\x04')
+""".format(**factory_common_args))
+
+add_docstr(torch.from_arrow,
+           r"""
+from_arrow(array) -> Tensor
+
+Creates a 1-dimensional :class:`Tensor` from an Arrow array, such as a
+:class:`pyarrow.Array`, without copying its data. The array is exported through
+the Arrow C data interface, by calling its ``_export_to_c`` method.
+
+The returned tensor and :attr:`array` share the same memory, and the tensor
+keeps the memory alive. Arrow arrays are immutable, and the returned tensor
+should not be written to.
+
+The array must not hold nulls, and its type must be one of ``int8``,
+``uint8``, ``int16``, ``int32``, ``int64``, ``float16``, ``float32`` or
+``float64``.
+
+Example::
+
+    >>> a = pyarrow.array([1, 2, 3])
+    >>> torch.from_arrow(a)
+    tensor([1, 2, 3])
+""")
+
 add_docstr(torch.flatten,
            r"""
 flatten(input, start_dim=0, end_dim=-1) -> Tensor
@@ -4447,6 +4544,93 @@ Example::
     tensor([-0.0090,  0.2262,  0.0682,  0.2866, -0.3940])
 """.format(**common_args))
 
+add_docstr(torch.nested_tensor,
+           r"""
+nested_tensor(tensors) -> Tensor
+
+Packs a sequence of tensors that only differ in the size of their first
+dimension, such as sequences of different lengths, into a nested tensor.
+
+The components are copied back to back into one buffer, with no padding.
+The nested tensor reports the size of the padded batch,
+``(len(tensors), max_length, *tensors[0].shape[1:])``; dimension 1 is ragged.
+Pointwise operations, :func:`torch.nn.functional.linear`,
+:func:`torch.nn.functional.layer_norm` over the trailing dimensions,
+:func:`torch.softmax`, :func:`torch.nested_attention` and a few more work on
+the packed elements directly. Other operations raise an error, use
+:meth:`Tensor.to_padded_tensor` to convert to a regular tensor first.
+
+Gradients flow back to the components through the supported operations.
+
+Args:
+    tensors (sequence of Tensors): the components, all of at least one
+        dimension and with the same dtype, device and trailing sizes
+
+Example::
+
+    >>> nt = torch.nested_tensor([torch.ones(2, 3), torch.zeros(1, 3)])
+    >>> nt.shape
+    torch.Size([2, 2, 3])
+    >>> (nt * 2).to_padded_tensor(padding=-1)
+    tensor([[[ 2.,  2.,  2.],
+             [ 2.,  2.,  2.]],
+
+            [[ 0.,  0.,  0.],
+             [-1., -1., -1.]]])
+""")
+
+add_docstr(torch.nested_tensor_from_padded,
+           r"""
+nested_tensor_from_padded(padded, lengths) -> Tensor
+
+Packs the first ``lengths[i]`` rows of ``padded[i]`` for every ``i`` into a
+nested tensor, dropping the padding. See :func:`torch.nested_tensor`.
+
+Args:
+    padded (Tensor): a padded batch of size ``(B, L, *)``
+    lengths (list of int): the ``B`` lengths of the components, each at most ``L``
+
+Example::
+
+    >>> padded = torch.arange(12.).view(2, 3, 2)
+    >>> nt = torch.nested_tensor_from_padded(padded, [3, 1])
+    >>> nt.unbind()
+    (tensor([[0., 1.],
+            [2., 3.],
+            [4., 5.]]), tensor([[6., 7.]]))
+""")
+
+add_docstr(torch.nested_attention,
+           r"""
+nested_attention(query, key, value, scale=None) -> Tensor
+
+Computes scaled dot product attention,
+:math:`\text{softmax}(\text{scale} \cdot QK^T) V`, for every head of every
+sequence in the batch.
+
+The inputs are either all nested tensors or all regular tensors of size
+``(B, L, *heads, E)``. For nested tensors, the queries of sequence ``i``
+attend to the key and value sequence ``i`` only, so no attention mask is
+needed for the padding, and no work is done on it.
+
+Args:
+    query (Tensor): the queries, of size ``(B, L_q, *heads, E)``
+    key (Tensor): the keys, of size ``(B, L_k, *heads, E)``
+    value (Tensor): the values, of size ``(B, L_k, *heads, E_v)``
+    scale (float, optional): the scale of the dot products.
+        Default: ``1 / sqrt(E)``
+
+Returns:
+    a tensor of size ``(B, L_q, *heads, E_v)``, nested if the inputs are
+
+Example::
+
+    >>> q = torch.nested_tensor([torch.randn(5, 8, 16), torch.randn(2, 8, 16)])
+    >>> out = torch.nested_attention(q, q, q)
+    >>> out.shape
+    torch.Size([2, 5, 8, 16])
+""")
+
 add_docstr(torch.nonzero,
            r"""
 nonzero(input, *, out=None, as_tuple=False) -> LongTensor or tuple of LongTensors
@@ -6105,6 +6289,46 @@ Example::
     tensor(2.6503e-06)
 """)
 
+add_docstr(torch.sparse_csr_tensor,
+           r"""
+sparse_csr_tensor(crow_indices, col_indices, values, size=None, dtype=None, device=None, requires_grad=False) -> Tensor
+
+Constructs a sparse matrix in CSR (compressed sparse row) format with the given
+:attr:`values` in the columns :attr:`col_indices`, where the nonzeros of row
+``i`` are ``values[crow_indices[i]:crow_indices[i + 1]]``. Compared to a
+sparse COO tensor, the row indices are stored compressed, one offset per row,
+which lets :func:`torch.mm`, :func:`torch.addmm` and :func:`torch.mv` work on
+the rows in parallel without converting the matrix on every call.
+
+The indices are validated once, when the tensor is constructed.
+
+Args:
+    crow_indices (Tensor): 1-D int32 or int64 tensor of size ``nrows + 1``. It
+        starts at 0, is non-decreasing and ends at the number of nonzeros.
+    col_indices (Tensor): 1-D tensor of the column of each nonzero, with the
+        same dtype as :attr:`crow_indices`.
+    values (Tensor): 1-D tensor of the value of each nonzero.
+    size (list, tuple, or :class:`torch.Size`, optional): Size of the matrix.
+        If not provided, the number of columns is inferred from the
+        largest column index.
+    dtype (:class:`torch.dtype`, optional): the desired data type of returned tensor.
+        Default: if None, infers data type from :attr:`values`.
+    device (:class:`torch.device`, optional): the desired device of returned tensor.
+        Default: if None, uses the device of :attr:`values`.
+    {requires_grad}
+
+Example::
+
+    >>> crow_indices = torch.tensor([0, 2, 2, 3])
+    >>> col_indices = torch.tensor([0, 2, 1])
+    >>> values = torch.tensor([1., 2., 3.])
+    >>> torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 3])
+    tensor(crow_indices=tensor([0, 2, 2, 3]),
+           col_indices=tensor([0, 2, 1]),
+           values=tensor([1., 2., 3.]), size=(3, 3), nnz=3,
+           layout=torch.sparse_csr)
+""".format(**factory_common_args))
+
 add_docstr(torch.symeig,
            r"""
 symeig(input, eigenvectors=False, upper=True, out=None) -> (Tensor, Tensor)
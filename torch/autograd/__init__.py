@@ -18,6 +18,7 @@ from .grad_mode import no_grad, enable_grad, set_grad_enabled
 from .anomaly_mode import detect_anomaly, set_detect_anomaly
 from . import profiler
 from . import functional
+from . import graph
 
 __all__ = ['Variable', 'Function', 'backward', 'grad_mode']
 
@@ -192,6 +193,60 @@ def grad(
         inputs, allow_unused)
 
 
+def set_num_cpu_threads(num_threads: int) -> None:
+    r"""Sets the number of threads that run the CPU part of a backward pass.
+
+    By default, the CPU nodes of the graph are all executed by the thread that
+    called :func:`backward` or :func:`grad`. With ``num_threads > 1``, that
+    thread is helped by ``num_threads - 1`` worker threads, so that
+    independent branches of the graph (e.g. the towers of a multi-tower model)
+    are differentiated concurrently. Each node still runs only once all the
+    gradients flowing into it have been accumulated.
+
+    This is unrelated to :func:`torch.set_num_threads`, which controls the
+    parallelism within a single operator; the two multiply, so it is usually
+    worth lowering the latter when raising the former.
+
+    Arguments:
+        num_threads (int): number of threads, including the calling one.
+            Must be positive; 1 restores the default behavior.
+    """
+    Variable._execution_engine.set_num_cpu_threads(num_threads)
+
+
+def get_num_cpu_threads() -> int:
+    r"""Returns the number of threads that run the CPU part of a backward
+    pass, see :func:`set_num_cpu_threads`."""
+    return Variable._execution_engine.num_cpu_threads()
+
+
+def set_static_graph(mode: bool) -> None:
+    r"""Enables or disables the replay of backward graphs with a known topology.
+
+    When enabled, the autograd engine remembers the structure of the graphs it
+    differentiates. A later :func:`backward` call on a graph with the same
+    structure, e.g. the next iteration of a training loop over a model with a
+    fixed topology, skips the dependency analysis and the scheduling of the
+    regular engine and runs the nodes in the recorded order. Graphs whose
+    structure changes are differentiated the regular way.
+
+    Only :func:`backward` calls on graphs that run entirely on CPU are
+    replayed, and not while anomaly detection is enabled or
+    :func:`set_num_cpu_threads` is set above 1. Gradients are the same in
+    both modes, but gradient hooks may run in a different order.
+
+    Arguments:
+        mode (bool): whether to replay graphs with a known topology.
+    """
+    Variable._execution_engine.set_static_graph(mode)
+
+
+def is_static_graph() -> bool:
+    r"""Returns whether graphs with a known topology are replayed, see
+    :func:`set_static_graph`."""
+    return Variable._execution_engine.is_static_graph()
+
+
 # This function applies in case of gradient checkpointing for memory
 # optimization. Currently, for gradient checkpointing, we only support imperative
 # backwards call i.e. torch.autograd.backward() and the torch.autograd.grad() won't
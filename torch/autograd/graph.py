@@ -0,0 +1,147 @@
+import torch
+import weakref
+from typing import Any, Callable, Dict, List, Optional
+
+__all__ = ["saved_tensors_hooks", "save_on_cpu"]
+
+
+class saved_tensors_hooks():
+    r"""Context-manager that sets a pair of pack / unpack hooks for the tensors
+    saved for backward by the operations run within it.
+
+    ``pack_hook`` is called with every tensor saved for backward and may
+    return any object. When the tensor is needed during the backward pass,
+    ``unpack_hook`` is called with that object and must return a tensor with
+    the same content as the one given to ``pack_hook``. This allows to keep
+    saved activations in host memory, compress them, or even drop them and
+    recompute them on demand.
+
+    If the graph is retained, ``unpack_hook`` may be called several times with
+    the same object. Both hooks run with grad mode disabled, and the tensor
+    given to ``pack_hook`` never requires grad.
+
+    The hooks are thread local and apply when the tensor is saved, i.e. during
+    the forward pass: exiting the context manager doesn't affect tensors that
+    were already packed. The innermost pair of hooks wins.
+
+    Arguments:
+        pack_hook (Callable): called as ``pack_hook(tensor)`` when a tensor is
+            saved for backward.
+        unpack_hook (Callable): called as ``unpack_hook(packed)`` with the
+            output of ``pack_hook`` when the tensor is needed.
+
+    Example::
+
+        >>> def pack_hook(x):
+        ...     return x.half()
+        >>> def unpack_hook(x):
+        ...     return x.float()
+        >>> a = torch.randn(5, requires_grad=True)
+        >>> with torch.autograd.graph.saved_tensors_hooks(pack_hook, unpack_hook):
+        ...     y = (a * a).sum()
+        >>> y.backward()  # the saved copies of ``a`` are stored in half
+    """
+    def __init__(self, pack_hook: Callable[[torch.Tensor], Any], unpack_hook: Callable[[Any], torch.Tensor]):
+        self.pack_hook = pack_hook
+        self.unpack_hook = unpack_hook
+
+    def __enter__(self):
+        torch.autograd._push_saved_tensors_default_hooks(self.pack_hook, self.unpack_hook)
+
+    def __exit__(self, *args):
+        torch.autograd._pop_saved_tensors_default_hooks()
+
+
+class _OffloadedTensor(object):
+    __slots__ = ["device", "cpu_tensor", "index", "device_tensor", "event", "__weakref__"]
+
+    def __init__(self, device, cpu_tensor, index):
+        self.device = device
+        self.cpu_tensor = cpu_tensor
+        # Position in the packing order, see save_on_cpu._unpack
+        self.index = index
+        # Copy back to the device, in flight or done once event is reached
+        self.device_tensor: Optional[torch.Tensor] = None
+        self.event: Optional[torch.cuda.Event] = None
+
+
+class save_on_cpu(saved_tensors_hooks):
+    r"""Context-manager under which the CUDA tensors saved for backward are
+    moved to host memory, and brought back to the device when needed.
+
+    The copies run on a side stream, so that they overlap with the
+    computation of the forward and backward passes. As the backward pass
+    roughly visits the graph in the reverse order of its construction, when a
+    tensor is brought back the ``prefetch`` tensors saved right before it are
+    copied to the device ahead of time as well.
+
+    Tensors that are not on a CUDA device are saved as usual.
+
+    Arguments:
+        pin_memory (bool, optional): stage the tensors in pinned memory, which
+            makes the copies asynchronous with respect to the host. Default:
+            ``True``.
+        prefetch (int, optional): number of tensors to bring back ahead of
+            their use. Default: ``2``.
+
+    Example::
+
+        >>> with torch.autograd.graph.save_on_cpu():
+        ...     loss = model(input).sum()
+        >>> loss.backward()
+    """
+    def __init__(self, pin_memory: bool = True, prefetch: int = 2):
+        if prefetch < 0:
+            raise ValueError("prefetch must be non-negative, got {}".format(prefetch))
+        self.pin_memory = pin_memory
+        self.prefetch = prefetch
+        self._streams: Dict[torch.device, torch.cuda.Stream] = {}
+        # Weak references to the packed tensors, in packing order
+        self._packed: List[weakref.ReferenceType] = []
+        super(save_on_cpu, self).__init__(self._pack, self._unpack)
+
+    def _stream(self, device):
+        if device not in self._streams:
+            self._streams[device] = torch.cuda.Stream(device)
+        return self._streams[device]
+
+    def _pack(self, tensor):
+        if not tensor.is_cuda:
+            return tensor
+        stream = self._stream(tensor.device)
+        stream.wait_stream(torch.cuda.current_stream(tensor.device))
+        with torch.cuda.stream(stream):
+            cpu_tensor = torch.empty(tensor.size(), dtype=tensor.dtype, pin_memory=self.pin_memory)
+            cpu_tensor.copy_(tensor, non_blocking=self.pin_memory)
+        # The device memory may only be reused once the copy is done
+        tensor.record_stream(stream)
+        packed = _OffloadedTensor(tensor.device, cpu_tensor, len(self._packed))
+        self._packed.append(weakref.ref(packed))
+        return packed
+
+    def _load(self, packed):
+        if packed.device_tensor is not None:
+            return
+        stream = self._stream(packed.device)
+        with torch.cuda.stream(stream):
+            packed.device_tensor = packed.cpu_tensor.to(packed.device, non_blocking=self.pin_memory)
+            packed.event = torch.cuda.Event()
+            packed.event.record(stream)
+
+    def _unpack(self, packed):
+        if isinstance(packed, torch.Tensor):
+            return packed
+        for i in range(packed.index - 1, max(packed.index - 1 - self.prefetch, -1), -1):
+            previous = self._packed[i]()
+            if previous is not None:
+                self._load(previous)
+        self._load(packed)
+
+        current_stream = torch.cuda.current_stream(packed.device)
+        current_stream.wait_event(packed.event)
+        tensor = packed.device_tensor
+        tensor.record_stream(current_stream)
+        # Don't keep the device copy alive if the graph is retained
+        packed.device_tensor = None
+        packed.event = None
+        return tensor
@@ -25,10 +25,13 @@ class EventList(list):
     def __init__(self, *args, **kwargs):
         use_cuda = kwargs.pop('use_cuda', True)
         profile_memory = kwargs.pop('profile_memory', False)
+        memory_events = kwargs.pop('memory_events', None)
         super(EventList, self).__init__(*args, **kwargs)
         self._cpu_children_populated = False
         self._use_cuda = use_cuda
         self._profile_memory = profile_memory
+        # Allocations and frees in time order, see parse_memory_trace
+        self.memory_events = memory_events if memory_events is not None else []
 
     def __str__(self):
         return self.table()
@@ -105,15 +108,25 @@ class EventList(list):
     def cpu_children_populated(self):
         return self._cpu_children_populated
 
-    def table(self, sort_by=None, row_limit=100, header=None):
+    def table(self, sort_by=None, row_limit=100, header=None, peak_gflops=None, peak_gbps=None):
         """Prints an EventList as a nicely formatted table.
 
+        When the shapes were recorded, the table also shows the GFLOP/s and
+        GB/s achieved by the matmul, convolution, pointwise, reduction and
+        embedding ops, from estimates of their floating point operations and
+        bytes moved (see ``FunctionEvent.flops``).
+
         Arguments:
             sort_by (str, optional): Attribute used to sort entries. By default
                 they are printed in the same order as they were registered.
                 Valid keys include: ``cpu_time``, ``cuda_time``, ``cpu_time_total``,
                 ``cuda_time_total``, ``cpu_memory_usage``, ``cuda_memory_usage``,
-                ``self_cpu_memory_usage``, ``self_cuda_memory_usage``, ``count``.
+                ``self_cpu_memory_usage``, ``self_cuda_memory_usage``,
+                ``cpu_memory_peak``, ``cuda_memory_peak``, ``count``.
+            peak_gflops (float, optional): Peak GFLOP/s of the device. Together
+                with ``peak_gbps``, adds a column with the share of the roofline
+                bound the ops achieve.
+            peak_gbps (float, optional): Peak memory bandwidth of the device in GB/s.
 
         Returns:
             A string containing the table.
@@ -124,12 +137,16 @@ class EventList(list):
             row_limit=row_limit,
             header=header,
             use_cuda=self._use_cuda,
-            profile_memory=self._profile_memory)
+            profile_memory=self._profile_memory,
+            peak_gflops=peak_gflops,
+            peak_gbps=peak_gbps)
 
     def export_chrome_trace(self, path):
         """Exports an EventList as a Chrome tracing tools file.
 
         The checkpoint can be later loaded and inspected under ``chrome://tracing`` URL.
+        With ``profile_memory=True``, the memory allocated on the CPU and on
+        the CUDA devices is shown as counters along the functions.
 
         Arguments:
             path (str): Path where the trace will be written.
@@ -189,6 +206,13 @@ class EventList(list):
                                                k.interval.elapsed_us(), k.device))
                     next_id += 1
 
+            for mem in self.memory_events:
+                f.write('{"name": "%s Memory", '
+                        '"ph": "C", '
+                        '"ts": %s, '
+                        '"pid": "CPU functions", '
+                        '"args": {"Total Allocated": %s}}, ' % (mem.device_type, mem.time_us, mem.total_allocated))
+
             # remove trailing whitespace and comma
             f.seek(f.tell() - 2, os.SEEK_SET)
             f.truncate()
@@ -247,6 +271,18 @@ class profile(object):
             Adds approximately 4us of overhead to each tensor operation.
             Default: ``False``
 
+        use_cupti (bool, optional): Traces the CUDA kernels, memcpys and memsets
+            with CUPTI instead, without synchronizing. Each of them is added to
+            the ``kernels`` of the innermost function or :class:`record_function`
+            that launched it, with its actual start and end time on the device.
+            Requires PyTorch to be built with CUPTI. Default: ``False``
+
+        trace_path (str, optional): If set, the functions, the memory events
+            and the CUPTI activities are streamed to this file as a Chrome trace
+            while they are recorded, instead of being kept in memory until the
+            end; the profiler then holds no events. Only with ``use_cuda=False``.
+            Default: ``None``
+
         record_shapes (bool, optional): If shapes recording is set, information
             about input dimensions will be collected. This allows one to see which
             dimensions have been used under the hood and further group by them
@@ -258,7 +294,14 @@ class profile(object):
             self cpu time might be artificially increased because of the shape
             collection.
 
-        profile_memory (bool, optional): Whether to report memory usage, default: ``False``
+        profile_memory (bool, optional): Whether to report memory usage, default: ``False``.
+            The allocations are attributed to the functions and
+            :class:`record_function` scopes running on the allocating thread:
+            ``cpu_memory_usage`` is the net memory allocated during a function,
+            ``cpu_memory_peak`` the highest it reached while the function ran
+            (likewise for CUDA), and ``function_events.memory_events`` holds
+            the timeline of the allocations, which is also exported by
+            :meth:`export_chrome_trace`.
 
     .. warning:
         Enabling memory profiling incurs additional profiler overhead
@@ -297,15 +340,21 @@ class profile(object):
             enabled=True,
             use_cuda=False,
             record_shapes=False,
-            profile_memory=False):
+            profile_memory=False,
+            use_cupti=False,
+            trace_path=None):
         self.enabled = enabled
         self.use_cuda = use_cuda
         self.function_events = None
         if not self.enabled:
             return
+        if use_cuda and use_cupti:
+            raise ValueError("use_cuda and use_cupti are mutually exclusive")
         self.entered = False
         self.record_shapes = record_shapes
         self.profile_memory = profile_memory
+        self.use_cupti = use_cupti
+        self.trace_path = trace_path
 
     def __enter__(self):
         if not self.enabled:
@@ -313,10 +362,15 @@ class profile(object):
         if self.entered:
             raise RuntimeError("autograd profiler traces are not reentrant")
         self.entered = True
-        profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
-            else torch.autograd.ProfilerState.CPU
-
-        config = torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes, self.profile_memory)
+        if self.use_cuda:
+            profiler_kind = torch.autograd.ProfilerState.CUDA
+        elif self.use_cupti:
+            profiler_kind = torch.autograd.ProfilerState.CUPTI
+        else:
+            profiler_kind = torch.autograd.ProfilerState.CPU
+
+        config = torch.autograd.ProfilerConfig(
+            profiler_kind, self.record_shapes, self.profile_memory, self.trace_path or "")
         torch.autograd._enable_profiler(config)
         return self
 
@@ -326,8 +380,9 @@ class profile(object):
         records = torch.autograd._disable_profiler()
         self.function_events = EventList(
             parse_cpu_trace(records),
-            use_cuda=self.use_cuda,
-            profile_memory=self.profile_memory)
+            use_cuda=self.use_cuda or self.use_cupti,
+            profile_memory=self.profile_memory,
+            memory_events=parse_memory_trace(records) if self.profile_memory else None)
         return False
 
     def __repr__(self):
@@ -346,10 +401,11 @@ class profile(object):
             raise RuntimeError("can't export a trace that didn't finish running")
         self.function_events.populate_cpu_children()
 
-    def table(self, sort_by=None, row_limit=100, header=None):
+    def table(self, sort_by=None, row_limit=100, header=None, peak_gflops=None, peak_gbps=None):
         self._check_finish()
         return self.function_events.table(
-            sort_by=sort_by, row_limit=row_limit, header=header)
+            sort_by=sort_by, row_limit=row_limit, header=header,
+            peak_gflops=peak_gflops, peak_gbps=peak_gbps)
     table.__doc__ = EventList.table.__doc__
 
     def export_chrome_trace(self, path):
@@ -453,6 +509,76 @@ class record_function(ContextDecorator):
         return profiled_future
 
 
+SampledEvent = namedtuple('SampledEvent', ['name', 'scope', 'thread', 'sequence_nr', 'start_us', 'duration_us'])
+SampledEvent.__doc__ = """A range timed by :class:`sampled_profile`.
+
+``scope`` is one of ``"function"`` (ops and autograd functions),
+``"torchscript_function"`` and ``"user_scope"`` (:class:`record_function`).
+``start_us`` is on the monotonic clock used by the profiler.
+"""
+
+
+class sampled_profile(object):
+    """Low overhead profiler that times a random sample of the ops, meant to
+    stay enabled in production, e.g. to feed metrics.
+
+    Unlike :class:`profile`, it is enabled for all the threads of the process,
+    and doesn't keep the events: each operation, autograd function or
+    :class:`record_function` range is picked with probability
+    ``sampling_prob``, and the events of the picked ranges are handed to
+    ``on_events`` by batches of ``batch_size``, as soon as a thread has filled
+    a batch. The cost of the ranges that are not picked is a cheap coin flip.
+    Stopping the profiler flushes the partial batches.
+
+    ``on_events`` is called with a list of :class:`SampledEvent`, on the
+    thread which filled the batch, while an operation is running; it should
+    be quick and must not run PyTorch ops. Ranges ending on another thread
+    than the one they started on are dropped. Only one instance can run at a
+    time.
+
+    Arguments:
+        on_events (Callable): called with each batch of events.
+        sampling_prob (float, optional): probability to time each range, in
+            ``(0, 1]``. Default: ``0.001``.
+        batch_size (int, optional): number of events per batch. Default:
+            ``1024``.
+
+    Example:
+        >>> counts = collections.Counter()
+        >>> def on_events(events):
+        ...     counts.update(e.name for e in events)
+        >>> prof = torch.autograd.profiler.sampled_profile(on_events, sampling_prob=0.01)
+        >>> prof.start()
+        >>> train()
+        >>> prof.stop()
+        >>> counts.most_common(10)
+    """
+    def __init__(self, on_events, sampling_prob=0.001, batch_size=1024):
+        if not 0 < sampling_prob <= 1:
+            raise ValueError("sampling_prob must be in (0, 1], got {}".format(sampling_prob))
+        if batch_size <= 0:
+            raise ValueError("batch_size must be positive, got {}".format(batch_size))
+        self.on_events = on_events
+        self.sampling_prob = sampling_prob
+        self.batch_size = batch_size
+
+    def _on_batch(self, events):
+        self.on_events([SampledEvent(*e) for e in events])
+
+    def start(self):
+        torch.autograd._enable_sampled_profiler(self.sampling_prob, self._on_batch, self.batch_size)
+
+    def stop(self):
+        torch.autograd._disable_sampled_profiler()
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.stop()
+
+
 class emit_nvtx(object):
     """Context manager that makes every autograd operation emit an NVTX range.
 
@@ -611,6 +737,116 @@ def attr_formatter(name):
     return property(lambda self: format_time(getattr(self, name)))
 
 
+################################################################################
+# Op cost estimates
+#
+# The number of floating point operations and the bytes read and written by an
+# op, estimated from the input shapes the profiler records with
+# ``record_shapes=True``. The dtypes aren't recorded, so every element is
+# counted as 4 bytes. The bytes are the least memory traffic of the op (every
+# input read and every output written once), which is what the roofline
+# model compares with the memory bandwidth.
+
+_BYTES_PER_ELEMENT = 4
+
+_POINTWISE_OPS = {
+    'add', 'sub', 'mul', 'div', 'rsub', 'relu', 'threshold', 'sigmoid', 'tanh',
+    'exp', 'log', 'sqrt', 'rsqrt', 'neg', 'abs', 'pow', 'clamp', 'gelu',
+    'hardtanh', 'leaky_relu', 'elu', 'where', 'addcmul', 'addcdiv', 'lerp',
+    'copy', 'fill', 'dropout', 'sin', 'cos', 'reciprocal', 'sign', 'floor',
+    'ceil', 'round', 'maximum', 'minimum', 'eq', 'ne', 'lt', 'le', 'gt', 'ge',
+}
+_REDUCTION_OPS = {
+    'sum', 'mean', 'prod', 'max', 'min', 'amax', 'amin', 'norm', 'std', 'var',
+    'argmax', 'argmin', 'logsumexp', 'all', 'any',
+}
+_SOFTMAX_OPS = {'softmax', '_softmax', 'log_softmax', '_log_softmax'}
+_CONV_OPS = {
+    'conv1d', 'conv2d', 'conv3d', 'convolution', '_convolution',
+    'mkldnn_convolution', 'cudnn_convolution', 'miopen_convolution',
+    'thnn_conv2d', 'slow_conv3d', 'thnn_conv_depthwise2d',
+}
+
+
+def _numel(shape):
+    n = 1
+    for size in shape:
+        n *= size
+    return n
+
+
+def _broadcast_numel(shapes):
+    ndim = max(len(shape) for shape in shapes)
+    sizes = [1] * ndim
+    for shape in shapes:
+        for i, size in enumerate(shape):
+            dim = ndim - len(shape) + i
+            sizes[dim] = max(sizes[dim], size)
+    return _numel(sizes)
+
+
+def _estimate_cost(name, input_shapes):
+    """Returns the estimated (flops, bytes) of a call of the op, or None for
+    the ops which aren't estimated."""
+    if not input_shapes or not name.startswith('aten::'):
+        return None
+    op = name[len('aten::'):]
+    inplace = op.endswith('_') and not op.startswith('_')
+    if inplace:
+        op = op[:-1]
+    tensors = [shape for shape in input_shapes if len(shape) > 0]
+    nbytes = _BYTES_PER_ELEMENT
+
+    if op == 'mm' and len(tensors) >= 2:
+        (m, k), (_, n) = tensors[0][-2:], tensors[1][-2:]
+        return 2 * m * k * n, nbytes * (m * k + k * n + m * n)
+    if op in ('addmm', 'baddbmm', 'addbmm') and len(tensors) >= 3:
+        batch = _numel(tensors[1][:-2])
+        (m, k), (_, n) = tensors[1][-2:], tensors[2][-2:]
+        out = m * n if op == 'addmm' or op == 'addbmm' else batch * m * n
+        return (2 * batch * m * k * n + out,
+                nbytes * (batch * (m * k + k * n) + 2 * out))
+    if op == 'bmm' and len(tensors) >= 2:
+        b, m, k = tensors[0][-3:]
+        n = tensors[1][-1]
+        return 2 * b * m * k * n, nbytes * b * (m * k + k * n + m * n)
+    if op in _CONV_OPS and len(tensors) >= 2:
+        input, weight = tensors[0], tensors[1]
+        if len(input) < 3 or len(weight) != len(input):
+            return None
+        # The strides and paddings aren't recorded: the output is assumed to
+        # have the spatial sizes of the input (stride 1, "same" padding), so the
+        # strided convolutions are over-estimated.
+        out = input[0] * weight[0] * _numel(input[2:])
+        flops = 2 * out * _numel(weight[1:])
+        return flops, nbytes * (_numel(input) + _numel(weight) + out)
+    if op == 'embedding_bag' and len(tensors) >= 2:
+        weight, indices = tensors[0], tensors[1]
+        dim = weight[-1]
+        lookups = _numel(indices)
+        bags = tensors[2][0] if len(tensors) > 2 else lookups
+        # The indices are int64.
+        return (lookups * dim,
+                nbytes * (lookups * dim + bags * dim) + 8 * lookups)
+    if op == 'embedding' and len(tensors) >= 2:
+        dim = tensors[0][-1]
+        lookups = _numel(tensors[1])
+        return 0, nbytes * 2 * lookups * dim + 8 * lookups
+    if op in _POINTWISE_OPS and tensors:
+        out = _broadcast_numel(tensors)
+        reads = sum(_numel(shape) for shape in tensors)
+        return out, nbytes * (reads + (0 if inplace else out))
+    if op in _SOFTMAX_OPS and tensors:
+        n = _numel(tensors[0])
+        # max, exp, sum and div for every element.
+        return 4 * n, nbytes * 2 * n
+    if op in _REDUCTION_OPS and tensors:
+        # The reduced dims aren't recorded, the output is left out.
+        n = _numel(tensors[0])
+        return n, nbytes * n
+    return None
+
+
 class FormattedTimesMixin(object):
     """Helpers for FunctionEvent and FunctionEventAvg.
 
@@ -647,7 +883,8 @@ class FunctionEvent(FormattedTimesMixin):
     """Profiling information about a single function."""
     def __init__(
             self, id, node_id, name, thread, cpu_start, cpu_end, input_shapes=None,
-            cpu_memory_usage=0, cuda_memory_usage=0, is_async=False, is_remote=True):
+            cpu_memory_usage=0, cuda_memory_usage=0, is_async=False, is_remote=True,
+            cpu_memory_peak=0, cuda_memory_peak=0):
         self.id = id
         self.node_id = node_id
         self.name = name
@@ -659,8 +896,36 @@ class FunctionEvent(FormattedTimesMixin):
         self.input_shapes = input_shapes
         self.cpu_memory_usage = cpu_memory_usage
         self.cuda_memory_usage = cuda_memory_usage
+        # Highest net memory allocated at any point while the function ran
+        self.cpu_memory_peak = cpu_memory_peak
+        self.cuda_memory_peak = cuda_memory_peak
         self.is_async = is_async
         self.is_remote = is_remote
+        self._cost = None
+
+    @property
+    def flops(self):
+        """Estimated floating point operations of the call, None when the op
+        isn't estimated or its shapes weren't recorded."""
+        return self._estimated_cost()[0]
+
+    @property
+    def bytes_moved(self):
+        """Estimated bytes read and written by the call, see ``flops``."""
+        return self._estimated_cost()[1]
+
+    @property
+    def estimated_cpu_time_total(self):
+        return self.cpu_time_total if self.flops is not None else 0
+
+    @property
+    def estimated_cuda_time_total(self):
+        return self.cuda_time_total if self.flops is not None else 0
+
+    def _estimated_cost(self):
+        if self._cost is None:
+            self._cost = _estimate_cost(self.name, self.input_shapes) or (None, None)
+        return self._cost
 
     def append_kernel(self, name, device, start, end):
         self.kernels.append(Kernel(name, device, Interval(start, end)))
@@ -751,6 +1016,15 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cuda_memory_usage = 0
         self.self_cpu_memory_usage = 0
         self.self_cuda_memory_usage = 0
+        # The highest peak over the calls
+        self.cpu_memory_peak = 0
+        self.cuda_memory_peak = 0
+        # Totals over the calls, None if none of the calls was estimated
+        self.flops = None
+        self.bytes_moved = None
+        # The times of the calls which were estimated
+        self.estimated_cpu_time_total = 0
+        self.estimated_cuda_time_total = 0
 
     def add(self, other, group_by_input_shapes=False):
         if self.key is None:
@@ -776,7 +1050,18 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cuda_memory_usage += other.cuda_memory_usage
         self.self_cpu_memory_usage += other.self_cpu_memory_usage
         self.self_cuda_memory_usage += other.self_cuda_memory_usage
+        self.cpu_memory_peak = max(self.cpu_memory_peak, other.cpu_memory_peak)
+        self.cuda_memory_peak = max(self.cuda_memory_peak, other.cuda_memory_peak)
         self.count += other.count
+        if other.flops is not None:
+            self.flops = (self.flops or 0) + other.flops
+            self.bytes_moved = (self.bytes_moved or 0) + other.bytes_moved
+            if isinstance(other, FunctionEventAvg):
+                self.estimated_cpu_time_total += other.estimated_cpu_time_total
+                self.estimated_cuda_time_total += other.estimated_cuda_time_total
+            else:
+                self.estimated_cpu_time_total += other.cpu_time_total
+                self.estimated_cuda_time_total += other.cuda_time_total
         return self
 
     def __iadd__(self, other):
@@ -861,10 +1146,18 @@ def parse_cpu_trace(thread_records):
 
     assert start_record is not None and not start_record.is_remote()
 
+    activity_records = []
     for thread_record_list in thread_records:
+        if len(thread_record_list) > 0 and thread_record_list[0].kind() == 'gpu_activity':
+            # The kernels, memcpys and memsets traced by CUPTI, in a list of their own
+            activity_records.extend(thread_record_list)
+            continue
         # accumulated memory allocations per handle
         cpu_memory_allocs = {}
         cuda_memory_allocs = {}
+        # highest accumulated memory allocations per handle
+        cpu_memory_peaks = {}
+        cuda_memory_peaks = {}
         # ranges per handle
         range_starts = {}
 
@@ -893,6 +1186,8 @@ def parse_cpu_trace(thread_records):
                 range_starts[record_key] = record
                 cpu_memory_allocs[record_key] = 0
                 cuda_memory_allocs[record_key] = 0
+                cpu_memory_peaks[record_key] = 0
+                cuda_memory_peaks[record_key] = 0
             elif record.kind() == 'pop':
                 assert (
                     record_key in range_starts
@@ -920,6 +1215,8 @@ def parse_cpu_trace(thread_records):
                     cuda_memory_usage=cuda_memory_usage,
                     is_async=is_async,
                     is_remote=is_remote_event,
+                    cpu_memory_peak=cpu_memory_peaks[record_key],
+                    cuda_memory_peak=cuda_memory_peaks[record_key],
                 )
                 # note: async events have only cpu total time
                 if not is_async and start.has_cuda():
@@ -935,13 +1232,25 @@ def parse_cpu_trace(thread_records):
                 del range_starts[record_key]
                 del cpu_memory_allocs[record_key]
                 del cuda_memory_allocs[record_key]
+                del cpu_memory_peaks[record_key]
+                del cuda_memory_peaks[record_key]
             elif record.kind() == 'memory_alloc':
                 for handle in cpu_memory_allocs.keys():
                     cpu_memory_allocs[handle] += record.cpu_memory_usage()
+                    cpu_memory_peaks[handle] = max(cpu_memory_peaks[handle], cpu_memory_allocs[handle])
                 for handle in cuda_memory_allocs.keys():
                     cuda_memory_allocs[handle] += record.cuda_memory_usage()
+                    cuda_memory_peaks[handle] = max(cuda_memory_peaks[handle], cuda_memory_allocs[handle])
             prev_record = record
 
+    # Attach each GPU activity to the innermost range that launched it
+    functions_by_key = {(fe.id, fe.node_id): fe for fe in functions} if activity_records else {}
+    for record in activity_records:
+        fe = functions_by_key.get(get_record_key(record))
+        if fe is not None:
+            start = start_record.cpu_elapsed_us(record)
+            fe.append_kernel(record.name(), record.device(), start, start + record.activity_duration_us())
+
     # Sort functions by start time then by end time ascending.
     # This ensures that--in the case of nested events which
     # have the same start time (which may happen due to the
@@ -952,6 +1261,38 @@ def parse_cpu_trace(thread_records):
     return functions
 
 
+MemoryEvent = namedtuple('MemoryEvent', ['time_us', 'thread', 'device_type', 'alloc_size', 'total_allocated'])
+
+
+def parse_memory_trace(thread_records):
+    """Returns the allocations (positive ``alloc_size``) and frees recorded
+    by the profiler, as :class:`MemoryEvent` sorted by time.
+
+    ``device_type`` is ``'CPU'`` or ``'CUDA'``, and ``total_allocated`` the
+    memory allocated on that device type right after the event, counting from
+    the start of the profiler.
+    """
+    start_record = None
+    for record in itertools.chain(*thread_records):
+        if record.name() == '__start_profile':
+            start_record = record
+            break
+    assert start_record is not None
+
+    events = []
+    for record in itertools.chain(*thread_records):
+        if record.kind() != 'memory_alloc' or record.is_remote():
+            continue
+        time_us = start_record.cpu_elapsed_us(record)
+        if record.cuda_memory_usage() != 0:
+            device_type, alloc_size = 'CUDA', record.cuda_memory_usage()
+        else:
+            device_type, alloc_size = 'CPU', record.cpu_memory_usage()
+        events.append(MemoryEvent(time_us, record.thread_id(), device_type, alloc_size, record.total_allocated()))
+    events.sort(key=attrgetter('time_us'))
+    return events
+
+
 ################################################################################
 # CUDA checkpoints
 
@@ -1032,6 +1373,32 @@ def parse_nvprof_trace(path):
 ################################################################################
 # Pretty printer
 
+def _format_throughput(evt, use_cuda, peak_gflops, peak_gbps, has_roofline):
+    """Returns the GFLOP/s, GB/s and, if has_roofline, the share of the
+    roofline bound achieved by the event."""
+    columns = 3 if has_roofline else 2
+    if evt.flops is None:
+        return [''] * columns
+    time_us = evt.estimated_cpu_time_total
+    if use_cuda and evt.estimated_cuda_time_total > 0:
+        time_us = evt.estimated_cuda_time_total
+    if time_us <= 0:
+        return [''] * columns
+    values = [
+        '{:.2f}'.format(evt.flops / (time_us * 1e3)),
+        '{:.2f}'.format(evt.bytes_moved / (time_us * 1e3)),
+    ]
+    if has_roofline:
+        # The op can't run faster than its compute or its memory traffic
+        # allows, whichever is slower.
+        bound_us = 0.0
+        if peak_gflops:
+            bound_us = max(bound_us, evt.flops / (peak_gflops * 1e3))
+        if peak_gbps:
+            bound_us = max(bound_us, evt.bytes_moved / (peak_gbps * 1e3))
+        values.append('{:.2f}%'.format(bound_us * 100.0 / time_us))
+    return values
+
 
 def build_table(
         events,
@@ -1039,7 +1406,9 @@ def build_table(
         header=None,
         row_limit=100,
         use_cuda=True,
-        profile_memory=False):
+        profile_memory=False,
+        peak_gflops=None,
+        peak_gbps=None):
     """Prints a summary of events (which can be a list of FunctionEvent or FunctionEventAvg)."""
     if len(events) == 0:
         return ""
@@ -1073,12 +1442,23 @@ def build_table(
         headers.extend([
             'CPU Mem',
             'Self CPU Mem',
+            'CPU Mem Peak',
         ])
         if torch.cuda.is_available():
             headers.extend([
                 'CUDA Mem',
                 'Self CUDA Mem',
+                'CUDA Mem Peak',
             ])
+    has_costs = any([evt.flops is not None for evt in events])
+    has_roofline = has_costs and (peak_gflops is not None or peak_gbps is not None)
+    if has_costs:
+        headers.extend([
+            'GFLOP/s',
+            'GB/s',
+        ])
+        if has_roofline:
+            headers.append('% Roofline')
     headers.append(
         'Number of Calls'
     )
@@ -1155,6 +1535,8 @@ def build_table(
                 format_memory(evt.cpu_memory_usage),
                 # Self CPU Mem Total
                 format_memory(evt.self_cpu_memory_usage),
+                # CPU Mem Peak
+                format_memory(evt.cpu_memory_peak),
             ])
             if torch.cuda.is_available():
                 row_values.extend([
@@ -1162,7 +1544,11 @@ def build_table(
                     format_memory(evt.cuda_memory_usage),
                     # Self CUDA Mem Total
                     format_memory(evt.self_cuda_memory_usage),
+                    # CUDA Mem Peak
+                    format_memory(evt.cuda_memory_peak),
                 ])
+        if has_costs:
+            row_values.extend(_format_throughput(evt, use_cuda, peak_gflops, peak_gbps, has_roofline))
         row_values.append(
             evt.count,  # Number of calls
         )
@@ -0,0 +1,74 @@
+import sys
+import torch
+from contextlib import contextmanager
+from torch.backends import ContextProp, PropModule, __allow_nonbracketed_mutation
+
+def set_flags(_benchmark):
+    orig_flags = (torch._C._get_cpu_conv_benchmark(),)
+    torch._C._set_cpu_conv_benchmark(_benchmark)
+    return orig_flags
+
+@contextmanager
+def flags(benchmark=False):
+    with __allow_nonbracketed_mutation():
+        orig_flags = set_flags(benchmark)
+    try:
+        yield
+    finally:
+        with __allow_nonbracketed_mutation():
+            set_flags(orig_flags[0])
+
+def save_benchmark_cache(path):
+    r"""Writes the convolution backends chosen in benchmark mode to ``path``."""
+    torch._C._cpu_conv_benchmark_cache_save(path)
+
+def load_benchmark_cache(path):
+    r"""Adds the choices saved by :func:`save_benchmark_cache` to the cache,
+    so their shapes are not timed again."""
+    torch._C._cpu_conv_benchmark_cache_load(path)
+
+def clear_benchmark_cache():
+    r"""Forgets the choices made in benchmark mode."""
+    torch._C._cpu_conv_benchmark_cache_clear()
+
+class FFTPlanCache(object):
+    r"""
+    The plan cache of the CPU FFT backend, the CPU counterpart of
+    ``torch.backends.cuda.cufft_plan_cache``. The attributes `size` and
+    `max_size`, and method `clear`, can fetch and/ or change properties of
+    the C++ plan cache.
+    """
+    @property
+    def size(self):
+        return torch._cpu_fft_get_plan_cache_size()
+
+    @size.setter
+    def size(self, value):
+        raise RuntimeError('.size is a read-only property showing the number of plans currently in the '
+                           'cache. To change the cache capacity, set fft_plan_cache.max_size.')
+
+    @property
+    def max_size(self):
+        return torch._cpu_fft_get_plan_cache_max_size()
+
+    @max_size.setter
+    def max_size(self, value):
+        torch._cpu_fft_set_plan_cache_max_size(value)
+
+    def clear(self):
+        return torch._cpu_fft_clear_plan_cache()
+
+
+fft_plan_cache = FFTPlanCache()
+
+class CPUModule(PropModule):
+    def __init__(self, m, name):
+        super(CPUModule, self).__init__(m, name)
+
+    # Times the CPU convolution backends on the first use of each shape and
+    # uses the fastest from then on.
+    benchmark = ContextProp(torch._C._get_cpu_conv_benchmark, torch._C._set_cpu_conv_benchmark)
+
+# Cool stuff from torch/backends/cudnn/__init__.py and
+# https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
+sys.modules[__name__] = CPUModule(sys.modules[__name__], __name__)
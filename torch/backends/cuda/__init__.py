@@ -93,5 +93,16 @@ class cuBLASModule:
         return torch._C._set_cublas_allow_tf32(value)
 
 
+class CopyModule:
+    def __getattr__(self, name):
+        assert name == "use_copy_streams", "Unknown attribute " + name
+        return torch._C._get_cuda_copy_streams()
+
+    def __setattr__(self, name, value):
+        assert name == "use_copy_streams", "Unknown attribute " + name
+        return torch._C._set_cuda_copy_streams(value)
+
+
 cufft_plan_cache = cuFFTPlanCacheManager()
 matmul = cuBLASModule()
+copy = CopyModule()
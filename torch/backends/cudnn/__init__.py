@@ -83,6 +83,27 @@ def is_acceptable(tensor):
     return True
 
 
+def _check_benchmark_cache_support():
+    if _cudnn is None or not _cudnn.is_cuda:
+        raise RuntimeError("the benchmark cache is only available with cuDNN")
+
+
+def save_benchmark_cache(path):
+    r"""Writes the convolution algorithms cuDNN picked so far to ``path``,
+    for :func:`load_benchmark_cache` in another process."""
+    _check_benchmark_cache_support()
+    _cudnn.saveBenchmarkCache(path)
+
+
+def load_benchmark_cache(path):
+    r"""Reuses the convolution algorithms saved by :func:`save_benchmark_cache`,
+    so ``benchmark`` mode doesn't search them again. The file is ignored,
+    with a warning, when it was written with another cuDNN or driver
+    version. Only entries of GPU models present in this process are loaded."""
+    _check_benchmark_cache_support()
+    _cudnn.loadBenchmarkCache(path)
+
+
 def set_flags(_enabled, _benchmark, _deterministic):
     orig_flags = (torch._C._get_cudnn_enabled(),
                   torch._C._get_cudnn_benchmark(),
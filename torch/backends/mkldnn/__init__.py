@@ -7,6 +7,10 @@ def is_available():
     r"""Returns whether PyTorch is built with MKL-DNN support."""
     return torch._C.has_mkldnn
 
+def is_bf16_supported():
+    r"""Returns whether MKL-DNN has bfloat16 kernels for this CPU (it needs AVX512)."""
+    return torch._C._is_mkldnn_bf16_supported()
+
 def set_flags(_enabled):
     orig_flags = (torch._C._get_mkldnn_enabled(),)
     torch._C._set_mkldnn_enabled(_enabled)
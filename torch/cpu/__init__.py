@@ -0,0 +1 @@
+from . import amp  # noqa: F401
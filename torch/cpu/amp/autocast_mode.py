@@ -0,0 +1,59 @@
+import torch
+import functools
+import warnings
+
+
+class autocast(object):
+    r"""
+    Instances of :class:`autocast` serve as context managers or decorators that
+    allow regions of your script to run in mixed precision on the CPU.
+
+    In these regions, CPU ops run in an op-specific dtype chosen by autocast:
+    convolutions and ``linear`` run in ``bfloat16`` through their MKL-DNN kernels,
+    while ops that need the range or precision of ``float32`` (losses, norms,
+    reductions, softmax) run in ``float32``.  Like :class:`torch.cuda.amp.autocast`,
+    ``float32`` weights that require grad are cast once per autocast-enabled region
+    and the casts are reused by every op in it.
+
+    Example::
+
+        model = Net().eval()
+
+        with torch.no_grad(), torch.cpu.amp.autocast():
+            output = model(input)
+
+    Floating-point Tensors produced in an autocast-enabled region may be ``bfloat16``.
+    Cast them back to ``float32`` before using them with ``float32`` Tensors outside of it.
+
+    CPU autocasting is independent of CUDA autocasting; both may be enabled at the same time.
+    The autocast state is thread-local.
+
+    Arguments:
+        enabled(bool, optional, default=True):  Whether autocasting should be enabled in the region.
+    """
+    def __init__(self, enabled=True):
+        if enabled and not torch.backends.mkldnn.is_bf16_supported():
+            warnings.warn("torch.cpu.amp.autocast runs CPU ops on the bfloat16 kernels of MKL-DNN, "
+                          "but this build or CPU has none.  Disabling.")
+            self._enabled = False
+        else:
+            self._enabled = enabled
+
+    def __enter__(self):
+        self.prev = torch.is_autocast_cpu_enabled()
+        torch.set_autocast_cpu_enabled(self._enabled)
+        torch.autocast_increment_nesting()
+
+    def __exit__(self, *args):
+        # Drop the cache when we exit to a nesting level that's outside any instance of autocast.
+        if torch.autocast_decrement_nesting() == 0:
+            torch.clear_autocast_cache()
+        torch.set_autocast_cpu_enabled(self.prev)
+        return False
+
+    def __call__(self, func):
+        @functools.wraps(func)
+        def decorate_autocast(*args, **kwargs):
+            with self:
+                return func(*args, **kwargs)
+        return decorate_autocast
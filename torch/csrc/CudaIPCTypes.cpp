@@ -1,6 +1,7 @@
 #ifdef USE_CUDA
 #include <torch/csrc/CudaIPCTypes.h>
 #include <TH/THAllocator.h>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <random>
@@ -31,6 +32,16 @@ struct CudaIPCGlobalEntities {
   std::map<std::string, std::shared_ptr<CudaIPCRefCountersFile>>
       ref_counters_files_;
   std::shared_ptr<CudaIPCRefCountersFile> next_available_ref_counters_file_;
+  // The events of the blocks which were released by their consumers, which
+  // can be recorded again for new blocks of the same device. They count
+  // towards sync_events_used_.
+  std::mutex free_events_mutex_;
+  std::map<c10::DeviceIndex, std::vector<cudaEvent_t>> free_events_;
+  std::atomic<int64_t> blocks_shared_{0};
+  std::atomic<int64_t> events_created_{0};
+  std::atomic<int64_t> events_reused_{0};
+  std::atomic<int64_t> stream_syncs_{0};
+  std::atomic<int64_t> ref_counter_files_created_{0};
   CudaIPCSentDataLimbo CudaIPCSentDataLimbo_;
   CudaIPCGlobalEntities() : ref_counters_files_() {}
   ~CudaIPCGlobalEntities() {
@@ -39,6 +50,8 @@ struct CudaIPCGlobalEntities {
     if (next_available_ref_counters_file_) {
       warnProducerTerminatedBeforeSharedTensorsReleased();
     }
+    // The free events are left to the driver, which might already be shut
+    // down at this point.
   }
   void safe_clean_current_file() {
     std::lock_guard<std::mutex> lock(ref_counters_mutex_);
@@ -48,24 +61,46 @@ struct CudaIPCGlobalEntities {
       next_available_ref_counters_file_.reset();
     }
   }
+  cudaEvent_t take_free_event(c10::DeviceIndex device) {
+    std::lock_guard<std::mutex> lock(free_events_mutex_);
+    auto& events = free_events_[device];
+    if (events.empty()) {
+      return nullptr;
+    }
+    auto event = events.back();
+    events.pop_back();
+    return event;
+  }
+  void return_free_event(c10::DeviceIndex device, cudaEvent_t event) {
+    std::lock_guard<std::mutex> lock(free_events_mutex_);
+    free_events_[device].push_back(event);
+  }
 };
 
 CudaIPCGlobalEntities cuda_ipc_global_entities;
 
 CudaIPCSentDataLimbo::~CudaIPCSentDataLimbo() {
   collect();
-  if (shared_blocks_.size() > 0) {
+  if (size() > 0) {
     warnProducerTerminatedBeforeSharedTensorsReleased();
   }
 }
 
 bool CudaIPCSentDataLimbo::collect() {
+  bool freed_memory = false;
+  for (auto& shard : shards_) {
+    freed_memory |= collect(shard);
+  }
+  return freed_memory;
+}
+
+bool CudaIPCSentDataLimbo::collect(Shard& shard) {
   bool freed_memory = false;
   std::vector<std::unique_ptr<CudaIPCSentData>> reset_blocks;
   { // Begin critical section to modify shared blocks
-    std::lock_guard<std::mutex> lock(limbo_mutex_);
+    std::lock_guard<std::mutex> lock(shard.limbo_mutex_);
     std::vector<std::unique_ptr<CudaIPCSentData>> kept_blocks;
-    for (auto& sd : shared_blocks_) {
+    for (auto& sd : shard.shared_blocks_) {
       if (sd->counter_value() > 0) {
         kept_blocks.push_back(std::move(sd));
       } else {
@@ -73,8 +108,9 @@ bool CudaIPCSentDataLimbo::collect() {
         reset_blocks.push_back(std::move(sd));
       }
     }
-    shared_blocks_ = std::move(kept_blocks);
+    shard.shared_blocks_ = std::move(kept_blocks);
   }
+  size_ -= reset_blocks.size();
   // Need to reset blocks out of the critical section here, otherwise it deadlocks.
   for (auto& sd : reset_blocks) {
     sd.reset();
@@ -83,18 +119,22 @@ bool CudaIPCSentDataLimbo::collect() {
 }
 
 void CudaIPCSentDataLimbo::add(std::unique_ptr<CudaIPCSentData> shared_block) {
-  std::lock_guard<std::mutex> lock(limbo_mutex_);
-  static bool warned = false;
-  if (shared_blocks_.size() > CUDA_IPC_WARN_AFTER_X_BLOCKS_IN_LIMBO &&
-      !warned) {
+  static std::atomic<bool> warned(false);
+  if (size() > CUDA_IPC_WARN_AFTER_X_BLOCKS_IN_LIMBO && !warned.exchange(true)) {
     LOG(WARNING)
         << "Producer process tried to deallocate over "
         << CUDA_IPC_WARN_AFTER_X_BLOCKS_IN_LIMBO
         << " memory blocks referred by consumer processes. Deallocation might be significantly slowed down. "
         << "We assume it will never going to be the case, but if it is, please file but to https://github.com/pytorch/pytorch";
-    warned = true;
   }
-  shared_blocks_.push_back(std::move(shared_block));
+  auto& shard = shards_[std::hash<CudaIPCSentData*>()(shared_block.get()) % kNumShards];
+  std::lock_guard<std::mutex> lock(shard.limbo_mutex_);
+  shard.shared_blocks_.push_back(std::move(shared_block));
+  size_++;
+}
+
+bool CudaIPCSentDataLimbo::collect_next() {
+  return collect(shards_[next_shard_++ % kNumShards]);
 }
 
 void CudaIPCSentDataDelete(void* ptr) {
@@ -103,16 +143,16 @@ void CudaIPCSentDataDelete(void* ptr) {
   if (sent_data->counter_value() > 0) {
     cuda_ipc_global_entities.CudaIPCSentDataLimbo_.add(std::move(sent_data));
   }
-  cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
+  cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect_next();
 }
 
-void ReturnRefCounter(const std::string& handle, uint64_t offset /* unused */) {
+void ReturnRefCounter(const std::string& handle, uint64_t offset) {
   std::lock_guard<std::mutex> lock(
       cuda_ipc_global_entities.ref_counters_mutex_);
-  cuda_ipc_global_entities.ref_counters_files_[handle]->return_offset(offset);
-  if (cuda_ipc_global_entities.ref_counters_files_[handle]->offsets_in_use() ==
-          0 &&
-      !cuda_ipc_global_entities.ref_counters_files_[handle]->have_offsets()) {
+  auto& file = cuda_ipc_global_entities.ref_counters_files_[handle];
+  file->return_offset(offset);
+  if (file->offsets_in_use() == 0 &&
+      file != cuda_ipc_global_entities.next_available_ref_counters_file_) {
     cuda_ipc_global_entities.ref_counters_files_.erase(handle);
   }
 }
@@ -141,20 +181,31 @@ CudaIPCSentData::CudaIPCSentData(
   //  [i.record() for i in a]
   //  ```
   //
-  if (cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
-    // TODO: More efficient would be to create event inside of main thread (at
-    // the moment of the queue.put). The reason this is more efficient is
-    // because the main thread may have queued extra work on the stream, which
-    // this event will consequently wait for (uselessly).
+  //
+  // The event of a block is only recorded again once all the consumers of the
+  // block released it, when they have long waited on it and closed it.
+  cuda_ipc_global_entities.blocks_shared_++;
+  event_ = cuda_ipc_global_entities.take_free_event(device.index());
+  if (event_ != nullptr) {
+    cuda_ipc_global_entities.events_reused_++;
+  } else if (cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
     cuda_ipc_global_entities.sync_events_used_ ++;
+    cuda_ipc_global_entities.events_created_++;
     C10_CUDA_CHECK(cudaEventCreateWithFlags(
         &event_,
         cudaEventDisableTiming | cudaEventInterprocess |
             cudaEventBlockingSync));
+  }
+  if (event_ != nullptr) {
+    // TODO: More efficient would be to record the event inside of main thread
+    // (at the moment of the queue.put). The reason this is more efficient is
+    // because the main thread may have queued extra work on the stream, which
+    // this event will consequently wait for (uselessly).
     C10_CUDA_CHECK(cudaEventRecord(
         event_, c10::cuda::getCurrentCUDAStream(device.index())));
     event_sync_required_ = true;
   } else {
+    cuda_ipc_global_entities.stream_syncs_++;
     auto stream = c10::cuda::getCurrentCUDAStream(device.index());
     C10_CUDA_CHECK(cudaStreamSynchronize(stream));
     event_sync_required_ = false;
@@ -162,6 +213,8 @@ CudaIPCSentData::CudaIPCSentData(
 #else
   // cuIpcGetEventHandle with HIP is not supported, so we have to sync
   // stream instead of passing event
+  cuda_ipc_global_entities.blocks_shared_++;
+  cuda_ipc_global_entities.stream_syncs_++;
   auto stream = c10::cuda::getCurrentCUDAStream(device.index());
   C10_CUDA_CHECK(cudaStreamSynchronize(stream));
   event_sync_required_ = false;
@@ -173,9 +226,7 @@ CudaIPCSentData::~CudaIPCSentData() {
 #ifndef __HIP_PLATFORM_HCC__
   try {
     if (event_sync_required_) {
-      at::cuda::CUDAGuard device_guard(device_.index());
-      cudaEventDestroy(event_);
-      cuda_ipc_global_entities.sync_events_used_ --;
+      cuda_ipc_global_entities.return_free_event(device_.index(), event_);
     }
   } catch (...) { /* No throw */
   }
@@ -187,6 +238,9 @@ int64_t CudaIPCSentData::counter_value() {
 }
 
 at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
+  std::string handle;
+  int64_t offset;
+  int64_t* counter_ptr;
   {
     std::lock_guard<std::mutex> lock(
         cuda_ipc_global_entities.ref_counters_mutex_);
@@ -211,23 +265,33 @@ at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
           ref_counter_handle, CUDA_IPC_REF_COUNTER_FILE_SIZE, std::move(sptr));
       cuda_ipc_global_entities.ref_counters_files_[ref_counter_handle] = rc;
       cuda_ipc_global_entities.next_available_ref_counters_file_ = rc;
+      cuda_ipc_global_entities.ref_counter_files_created_++;
+    }
+    auto& file = cuda_ipc_global_entities.next_available_ref_counters_file_;
+    handle = file->handle();
+    offset = file->take_offset(1);
+    counter_ptr = file->counter_ptr(offset);
+    if (!file->have_offsets()) {
+      file.reset();
     }
   }
-  cuda_ipc_global_entities.next_available_ref_counters_file_->set_counter(1);
-  auto sent_data = new CudaIPCSentData(
-      cuda_ipc_global_entities.next_available_ref_counters_file_->handle(),
-      cuda_ipc_global_entities.next_available_ref_counters_file_->get_offset(),
-      cuda_ipc_global_entities.next_available_ref_counters_file_->counter_ptr(),
-      device);
-
-  cuda_ipc_global_entities.next_available_ref_counters_file_->rotate_offset();
-  if (!cuda_ipc_global_entities.next_available_ref_counters_file_
-           ->have_offsets()) {
-    cuda_ipc_global_entities.next_available_ref_counters_file_.reset();
-  }
+  auto sent_data = new CudaIPCSentData(handle, offset, counter_ptr, device);
   return at::DataPtr(data, sent_data, CudaIPCSentDataDelete, device);
 }
 
+CudaIPCStats CudaIPCGetStats() {
+  CudaIPCStats stats;
+  stats.blocks_shared = cuda_ipc_global_entities.blocks_shared_.load();
+  stats.events_created = cuda_ipc_global_entities.events_created_.load();
+  stats.events_reused = cuda_ipc_global_entities.events_reused_.load();
+  stats.stream_syncs = cuda_ipc_global_entities.stream_syncs_.load();
+  stats.ref_counter_files_created =
+      cuda_ipc_global_entities.ref_counter_files_created_.load();
+  stats.blocks_in_limbo =
+      cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size();
+  return stats;
+}
+
 bool CudaIPCCollect() {
   bool freed_memory = cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
   if (cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size() == 0) {
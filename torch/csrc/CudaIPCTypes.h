@@ -7,12 +7,35 @@
 #include <c10/cuda/CUDAStream.h>
 #include <c10/util/Logging.h>
 #include <cuda_runtime_api.h>
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <mutex>
+#include <vector>
 
 namespace torch {
 
 bool CudaIPCCollect();
 
+// Counters of the CUDA tensors shared by this process, since it started.
+struct CudaIPCStats final {
+  // Number of memory blocks sent to other processes.
+  int64_t blocks_shared;
+  // Number of interprocess events created, and of events reused from the pool
+  // after the consumers of the block they were recorded for released it.
+  int64_t events_created;
+  int64_t events_reused;
+  // Number of shares which had to synchronize the stream, because the limit
+  // of interprocess events was reached.
+  int64_t stream_syncs;
+  // Number of shared memory files allocated for the reference counters.
+  int64_t ref_counter_files_created;
+  // Number of blocks freed by the producer but still used by consumers.
+  int64_t blocks_in_limbo;
+};
+
+CudaIPCStats CudaIPCGetStats();
+
 struct CudaIPCReceivedData final {
   explicit CudaIPCReceivedData(std::shared_ptr<void> shared_ptr)
       : shared_ptr_(std::move(shared_ptr)) {}
@@ -59,20 +82,37 @@ constexpr int64_t CUDA_IPC_WARN_AFTER_X_BLOCKS_IN_LIMBO = 1000;
 // tensors effectively.
 constexpr int64_t CUDA_IPC_MAXIMUM_EVENTS_TO_USE = 1000;
 
-// All to be deleted data blocks with non zero reference counter goes there
+// All to be deleted data blocks with non zero reference counter goes there.
+// The blocks are spread over shards, each with its own lock, so that the
+// threads freeing shared tensors don't all wait on a single mutex.
 struct CudaIPCSentDataLimbo final {
   ~CudaIPCSentDataLimbo();
+  // Frees the blocks of all shards whose reference counter dropped to zero.
   bool collect();
+  // Frees the blocks of the next shard, in turn, whose reference counter
+  // dropped to zero. Called whenever a shared block is freed, so that every
+  // shard is checked regularly without scanning the whole limbo each time.
+  bool collect_next();
   void add(std::unique_ptr<CudaIPCSentData> shared_block);
   uint64_t size() {
-    return shared_blocks_.size();
+    return size_.load();
   }
 
  private:
-  // TODO: Can be changed to FIFO in order to avoid full traverse on every
-  // collect()
-  std::vector<std::unique_ptr<CudaIPCSentData>> shared_blocks_;
-  std::mutex limbo_mutex_;
+  static constexpr size_t kNumShards = 8;
+
+  struct Shard {
+    // TODO: Can be changed to FIFO in order to avoid full traverse on every
+    // collect()
+    std::vector<std::unique_ptr<CudaIPCSentData>> shared_blocks_;
+    std::mutex limbo_mutex_;
+  };
+
+  bool collect(Shard& shard);
+
+  std::array<Shard, kNumShards> shards_;
+  std::atomic<uint64_t> size_{0};
+  std::atomic<size_t> next_shard_{0};
 };
 
 struct CudaIPCRefCountersFile final {
@@ -86,33 +126,37 @@ struct CudaIPCRefCountersFile final {
         handle_(handle),
         refcounted_shared_mem_(std::move(data_ptr)) {}
 
-  int64_t* counter_ptr() {
-    return static_cast<int64_t*>(refcounted_shared_mem_.get()) + next_offset_;
+  // Takes a free slot, and sets its counter to `value`. The slots returned by
+  // the blocks which were released are reused before the untouched ones, so
+  // that a steady flow of shares doesn't need new files.
+  int64_t take_offset(int64_t value) {
+    uint64_t offset;
+    if (!free_offsets_.empty()) {
+      offset = free_offsets_.back();
+      free_offsets_.pop_back();
+    } else {
+      offset = next_offset_++;
+    }
+    used_slots_++;
+    *counter_ptr(offset) = value;
+    return offset;
   }
 
-  void set_counter(uint64_t value) {
-    *counter_ptr() = value;
+  int64_t* counter_ptr(uint64_t offset) {
+    return static_cast<int64_t*>(refcounted_shared_mem_.get()) + offset;
   }
 
   bool have_offsets() {
-    return next_offset_ < size_;
+    return next_offset_ < size_ || !free_offsets_.empty();
   }
 
   bool offsets_in_use() {
     return used_slots_;
   }
 
-  int64_t get_offset() {
-    return next_offset_;
-  }
-
-  void rotate_offset() {
-    next_offset_++;
-    used_slots_++;
-  }
-
-  void return_offset(uint64_t offset /* unused */) {
+  void return_offset(uint64_t offset) {
     used_slots_--;
+    free_offsets_.push_back(offset);
   }
 
   std::string handle() {
@@ -123,6 +167,7 @@ struct CudaIPCRefCountersFile final {
   uint64_t next_offset_;
   uint64_t size_;
   uint64_t used_slots_;
+  std::vector<uint64_t> free_offsets_;
   std::string handle_;
   at::DataPtr refcounted_shared_mem_;
 };
@@ -1,5 +1,14 @@
 #include <torch/csrc/DataLoader.h>
 
+#include <ATen/Parallel.h>
+#include <torch/csrc/Exceptions.h>
+#include <torch/csrc/autograd/python_variable.h>
+#include <torch/csrc/utils/object_ptr.h>
+#include <torch/csrc/utils/pybind.h>
+
+#include <algorithm>
+#include <vector>
+
 // Together with `torch/utils/data/_utils/signal_handling.py`, the following
 // is an effort to do our best to provide some error message to users when a
 // worker dies due to error / critical signals.
@@ -213,10 +222,197 @@ static PyObject *THPModule_errorIfAnyWorkerFails(PyObject *module, PyObject *_ig
 
 #endif
 
+// Fast path of `default_collate` in `torch/utils/data/_utils/collate.py`. It
+// walks dicts, lists and tuples of tensors, floats, ints and strings like the
+// Python implementation does, and stacks every field of tensors into an output
+// which is preallocated (in shared memory in worker processes, or optionally
+// in pinned memory) and filled in parallel, without the GIL. Everything it
+// doesn't handle (numpy arrays, namedtuples, other mappings and sequences,
+// tensor subclasses, tensors which can't be stacked trivially) goes to the
+// Python implementation, which calls back into the fast path for the fields
+// it recurses into. Python handle is _collate().
+
+namespace {
+
+struct Collator {
+  THPObjectPtr collate(PyObject* batch) const;
+
+  THPObjectPtr collate_tensors(PyObject* batch, PyObject** samples, Py_ssize_t size) const;
+
+  THPObjectPtr call_fallback(PyObject* batch) const {
+    THPObjectPtr result(PyObject_CallFunctionObjArgs(fallback, batch, nullptr));
+    if (!result) throw python_error();
+    return result;
+  }
+
+  PyObject* fallback;
+  bool shared;
+  bool pin_memory;
+};
+
+THPObjectPtr Collator::collate(PyObject* batch) const {
+  THPObjectPtr sequence(PySequence_Fast(batch, "default_collate: batch must be a sequence"));
+  if (!sequence) throw python_error();
+  const Py_ssize_t size = PySequence_Fast_GET_SIZE(sequence.get());
+  PyObject** samples = PySequence_Fast_ITEMS(sequence.get());
+  if (size == 0) {
+    return call_fallback(batch);
+  }
+  PyObject* elem = samples[0];
+  auto all_samples = [&](int (*check)(PyObject*)) {
+    return std::all_of(samples, samples + size, [check](PyObject* sample) { return check(sample); });
+  };
+
+  if (THPVariable_CheckExact(elem)) {
+    if (all_samples([](PyObject* o) -> int { return THPVariable_CheckExact(o); })) {
+      return collate_tensors(batch, samples, size);
+    }
+  } else if (PyFloat_CheckExact(elem)) {
+    if (all_samples([](PyObject* o) -> int { return PyFloat_CheckExact(o); })) {
+      auto out = at::empty({size}, at::kDouble);
+      auto data = out.data_ptr<double>();
+      for (Py_ssize_t i = 0; i < size; i++) {
+        data[i] = PyFloat_AS_DOUBLE(samples[i]);
+      }
+      return THPObjectPtr(THPVariable_Wrap(std::move(out)));
+    }
+  } else if (PyLong_CheckExact(elem)) {
+    if (all_samples([](PyObject* o) -> int { return PyLong_CheckExact(o); })) {
+      auto out = at::empty({size}, at::kLong);
+      auto data = out.data_ptr<int64_t>();
+      for (Py_ssize_t i = 0; i < size; i++) {
+        int overflow = 0;
+        data[i] = PyLong_AsLongLongAndOverflow(samples[i], &overflow);
+        if (overflow != 0) {
+          return call_fallback(batch);
+        }
+      }
+      return THPObjectPtr(THPVariable_Wrap(std::move(out)));
+    }
+  } else if (PyUnicode_Check(elem) || PyBytes_Check(elem)) {
+    Py_INCREF(batch);
+    return THPObjectPtr(batch);
+  } else if (PyDict_CheckExact(elem)) {
+    THPObjectPtr result(PyDict_New());
+    if (!result) throw python_error();
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(elem, &pos, &key, &value)) {
+      THPObjectPtr field(PyList_New(size));
+      if (!field) throw python_error();
+      for (Py_ssize_t i = 0; i < size; i++) {
+        PyObject* item = PyObject_GetItem(samples[i], key);
+        if (!item) throw python_error();
+        PyList_SET_ITEM(field.get(), i, item);
+      }
+      auto collated = collate(field.get());
+      if (PyDict_SetItem(result.get(), key, collated.get()) != 0) throw python_error();
+    }
+    return result;
+  } else if (PyList_CheckExact(elem) || PyTuple_CheckExact(elem)) {
+    std::vector<THPObjectPtr> sample_sequences;
+    sample_sequences.reserve(size);
+    for (Py_ssize_t i = 0; i < size; i++) {
+      sample_sequences.emplace_back(PySequence_Fast(samples[i], "default_collate: samples must be sequences"));
+      if (!sample_sequences.back()) throw python_error();
+    }
+    const Py_ssize_t elem_size = PySequence_Fast_GET_SIZE(sample_sequences[0].get());
+    for (const auto& sample : sample_sequences) {
+      if (PySequence_Fast_GET_SIZE(sample.get()) != elem_size) {
+        throw std::runtime_error("each element in list of batch should be of equal size");
+      }
+    }
+    THPObjectPtr result(PyList_New(elem_size));
+    if (!result) throw python_error();
+    for (Py_ssize_t j = 0; j < elem_size; j++) {
+      THPObjectPtr field(PyList_New(size));
+      if (!field) throw python_error();
+      for (Py_ssize_t i = 0; i < size; i++) {
+        PyObject* item = PySequence_Fast_GET_ITEM(sample_sequences[i].get(), j);
+        Py_INCREF(item);
+        PyList_SET_ITEM(field.get(), i, item);
+      }
+      PyList_SET_ITEM(result.get(), j, collate(field.get()).release());
+    }
+    return result;
+  }
+  return call_fallback(batch);
+}
+
+THPObjectPtr Collator::collate_tensors(PyObject* batch, PyObject** samples, Py_ssize_t size) const {
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(size);
+  for (Py_ssize_t i = 0; i < size; i++) {
+    tensors.push_back(THPVariable_Unpack(samples[i]));
+  }
+  const auto& elem = tensors[0];
+  const bool stackable = std::all_of(tensors.begin(), tensors.end(), [&](const at::Tensor& tensor) {
+    return tensor.device().is_cpu() && tensor.layout() == at::kStrided &&
+        !tensor.requires_grad() && !tensor.has_names() &&
+        tensor.scalar_type() == elem.scalar_type() && tensor.sizes() == elem.sizes();
+  });
+  if (!stackable) {
+    return call_fallback(batch);
+  }
+
+  std::vector<int64_t> sizes = {static_cast<int64_t>(size)};
+  sizes.insert(sizes.end(), elem.sizes().begin(), elem.sizes().end());
+  THPObjectPtr result;
+  at::Tensor out;
+  if (shared) {
+    // Like the Python implementation, so that the batch is sent to the main
+    // process with the sharing strategy in use.
+    THPObjectPtr storage(PyObject_CallMethod(samples[0], "storage", nullptr));
+    if (!storage) throw python_error();
+    THPObjectPtr shared_storage(PyObject_CallMethod(
+        storage.get(), "_new_shared", "L", static_cast<long long>(size * elem.numel())));
+    if (!shared_storage) throw python_error();
+    result = PyObject_CallMethod(samples[0], "new", "O", shared_storage.get());
+    if (!result) throw python_error();
+    out = THPVariable_Unpack(result.get());
+    out.resize_(sizes);
+  } else {
+    out = at::empty(sizes, elem.options().pinned_memory(pin_memory));
+  }
+
+  {
+    pybind11::gil_scoped_release no_gil;
+    const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, elem.numel()));
+    at::parallel_for(0, size, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        out.select(0, i).copy_(tensors[i]);
+      }
+    });
+  }
+  if (!result) {
+    result = THPVariable_Wrap(std::move(out));
+  }
+  return result;
+}
+
+} // namespace
+
+static PyObject *THPModule_collate(PyObject *module, PyObject *args) {
+  HANDLE_TH_ERRORS
+  PyObject *batch = nullptr;
+  Collator collator;
+  int shared = 0;
+  int pin_memory = 0;
+  if (!PyArg_ParseTuple(args, "OOpp", &batch, &collator.fallback, &shared, &pin_memory)) {
+    return nullptr;
+  }
+  collator.shared = shared;
+  collator.pin_memory = pin_memory;
+  return collator.collate(batch).release();
+  END_HANDLE_TH_ERRORS
+}
+
 PyMethodDef DataLoaderMethods[] = {
   {"_set_worker_signal_handlers",  (PyCFunction)THPModule_setWorkerSignalHandlers,  METH_NOARGS,   nullptr},
   {"_set_worker_pids",             (PyCFunction)THPModule_setWorkerPIDs,            METH_VARARGS,  nullptr},
   {"_remove_worker_pids",          (PyCFunction)THPModule_removeWorkerPIDs,         METH_O,        nullptr},
   {"_error_if_any_worker_fails",   (PyCFunction)THPModule_errorIfAnyWorkerFails,    METH_NOARGS,   nullptr},
+  {"_collate",                     (PyCFunction)THPModule_collate,                  METH_VARARGS,  nullptr},
   {nullptr, nullptr, 0, nullptr}
 };
@@ -16,6 +16,8 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 #include <ATen/Utils.h>
+#include <ATen/native/ConvBenchmarkCache.h>
+#include <ATen/native/mkldnn/Utils.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -412,6 +414,12 @@ PyObject *THPModule_userEnabledMkldnn(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_isMkldnnBF16Supported(PyObject *_unused, PyObject *noargs)
+{
+  if (at::hasMKLDNN() && at::native::mkldnn_bf16_device_check()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setDeterministicCuDNN(PyObject *_unused, PyObject *arg)
 {
   THPUtils_assert(PyBool_Check(arg), "set_deterministic_cudnn expects a bool, "
@@ -474,6 +482,62 @@ PyObject *THPModule_allowTF32CuBLAS(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setUseCUDACopyStreams(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cuda_copy_streams expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setUseCUDACopyStreams(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_useCUDACopyStreams(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().useCUDACopyStreams()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setAllowFastMathCPU(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cpu_allow_fast_math expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setAllowFastMathCPU(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_allowFastMathCPU(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().allowFastMathCPU()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setBenchmarkCPUConv(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cpu_conv_benchmark expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setBenchmarkCPUConv(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_benchmarkCPUConv(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().benchmarkCPUConv()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setParallelCPURNG(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cpu_parallel_rng expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setParallelCPURNG(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_parallelCPURNG(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().parallelCPURNG()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setFlushDenormal(PyObject *_unused, PyObject *arg) {
   THPUtils_assert(PyBool_Check(arg), "flush_denormal expects a bool, "
           "but got %s", THPUtils_typename(arg));
@@ -561,6 +625,7 @@ static PyMethodDef TorchMethods[] = {
   {"_set_cudnn_enabled", (PyCFunction)THPModule_setUserEnabledCuDNN, METH_O,  nullptr},
   {"_get_mkldnn_enabled", (PyCFunction)THPModule_userEnabledMkldnn, METH_NOARGS,     nullptr},
   {"_set_mkldnn_enabled", (PyCFunction)THPModule_setUserEnabledMkldnn, METH_O,  nullptr},
+  {"_is_mkldnn_bf16_supported", (PyCFunction)THPModule_isMkldnnBF16Supported, METH_NOARGS, nullptr},
   {"_get_cudnn_benchmark", (PyCFunction)THPModule_benchmarkCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_benchmark", (PyCFunction)THPModule_setBenchmarkCuDNN, METH_O,  nullptr},
   {"_get_cudnn_deterministic", (PyCFunction)THPModule_deterministicCuDNN, METH_NOARGS,     nullptr},
@@ -569,6 +634,14 @@ static PyMethodDef TorchMethods[] = {
   {"_set_deterministic", (PyCFunction)THPModule_setDeterministic, METH_O,  nullptr},
   {"_get_cublas_allow_tf32", (PyCFunction)THPModule_allowTF32CuBLAS, METH_NOARGS,     nullptr},
   {"_set_cublas_allow_tf32", (PyCFunction)THPModule_setAllowTF32CuBLAS, METH_O,  nullptr},
+  {"_get_cuda_copy_streams", (PyCFunction)THPModule_useCUDACopyStreams, METH_NOARGS,     nullptr},
+  {"_set_cuda_copy_streams", (PyCFunction)THPModule_setUseCUDACopyStreams, METH_O,  nullptr},
+  {"_get_cpu_allow_fast_math", (PyCFunction)THPModule_allowFastMathCPU, METH_NOARGS,     nullptr},
+  {"_set_cpu_allow_fast_math", (PyCFunction)THPModule_setAllowFastMathCPU, METH_O,  nullptr},
+  {"_get_cpu_conv_benchmark", (PyCFunction)THPModule_benchmarkCPUConv, METH_NOARGS,     nullptr},
+  {"_set_cpu_conv_benchmark", (PyCFunction)THPModule_setBenchmarkCPUConv, METH_O,  nullptr},
+  {"_get_cpu_parallel_rng", (PyCFunction)THPModule_parallelCPURNG, METH_NOARGS,     nullptr},
+  {"_set_cpu_parallel_rng", (PyCFunction)THPModule_setParallelCPURNG, METH_O,  nullptr},
   {"_to_dlpack",      (PyCFunction)THPModule_toDLPack,          METH_O,       nullptr},
   {"_from_dlpack",    (PyCFunction)THPModule_fromDLPack,        METH_O,       nullptr},
   {"set_flush_denormal", (PyCFunction)THPModule_setFlushDenormal, METH_O,     nullptr},
@@ -596,6 +669,7 @@ bool THCPComplexFloatStorage_init(PyObject *module);
 
 void THCPStream_init(PyObject *module);
 void THCPEvent_init(PyObject *module);
+void THCPGraph_init(PyObject *module);
 
 #ifdef USE_CUDA
 PyMethodDef* THCPModule_methods();
@@ -732,6 +806,7 @@ PyObject* initModule() {
 
   THCPStream_init(module);
   THCPEvent_init(module);
+  THCPGraph_init(module);
 #endif
 
   auto set_module_attr = [&](const char* name, PyObject* v, bool incref = true) {
@@ -766,6 +841,12 @@ PyObject* initModule() {
   auto py_module = py::reinterpret_borrow<py::module>(module);
   py_module.def("_demangle", &c10::demangle);
   py_module.def("_log_api_usage_once", &LogAPIUsageOnceFromPython);
+  py_module.def("_cpu_conv_benchmark_cache_save",
+                torch::wrap_pybind_function(at::native::save_cpu_conv_benchmark_cache));
+  py_module.def("_cpu_conv_benchmark_cache_load",
+                torch::wrap_pybind_function(at::native::load_cpu_conv_benchmark_cache));
+  py_module.def("_cpu_conv_benchmark_cache_clear",
+                torch::wrap_pybind_function(at::native::clear_cpu_conv_benchmark_cache));
 
   py_module.def(
     "init_num_threads",
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/data/dataloader_options.h>
+#include <torch/data/detail/batch_tensors.h>
 #include <torch/data/detail/data_shuttle.h>
 #include <torch/data/detail/sequencers.h>
 #include <torch/data/iterator.h>
@@ -11,6 +12,9 @@
 #include <torch/csrc/utils/memory.h>
 #include <torch/csrc/utils/variadic.h>
 
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
 #include <c10/util/Exception.h>
 
 #include <cstddef>
@@ -36,6 +40,7 @@ class DataLoaderBase {
       DataLoaderOptions options,
       std::unique_ptr<Dataset> main_thread_dataset = nullptr)
       : options_(std::move(options)),
+        device_(resolve_device(options_.device)),
         main_thread_dataset_(std::move(main_thread_dataset)),
         sequencer_(new_sequencer()) {}
 
@@ -126,6 +131,9 @@ class DataLoaderBase {
         : Sequenced(sqn), exception(std::move(exception)) {}
     optional<Batch> batch;
     std::exception_ptr exception;
+    /// Recorded once the copies of the batch to the device are done, if they
+    /// run on a stream of the device pool.
+    std::shared_ptr<c10::Event> copied;
   };
 
   /// Subclass hook for getting the next batch request. The stateless case will
@@ -169,11 +177,17 @@ class DataLoaderBase {
           throw WorkerException(result->exception);
         } else if (result->batch) {
           prefetch(1);
+          wait_for_copies(*result);
           return std::move(result->batch);
         }
       }
     } else if (auto batch_request = get_batch_request()) {
-      return this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      Result result(
+          this->main_thread_dataset_->get_batch(std::move(*batch_request)),
+          /*sqn=*/0);
+      transfer_batch(result);
+      wait_for_copies(result);
+      return std::move(result.batch);
     }
     return nullopt;
   }
@@ -186,14 +200,84 @@ class DataLoaderBase {
         break;
       }
       try {
-        auto batch = dataset.get_batch(std::move(*job.batch_request));
-        shuttle_.push_result({std::move(batch), job.sequence_number});
+        Result result(
+            dataset.get_batch(std::move(*job.batch_request)),
+            job.sequence_number);
+        transfer_batch(result);
+        shuttle_.push_result(std::move(result));
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
       }
     }
   }
 
+  /// Pins the tensors of the batch and starts their copies to the device,
+  /// according to the options. Called by worker threads, or by the main thread
+  /// if there are none.
+  void transfer_batch(Result& result) const {
+    if (!result.batch) {
+      return;
+    }
+    if (options_.pin_memory) {
+      result.batch = detail::BatchTensors<Batch>::map(
+          std::move(*result.batch), [](const Tensor& tensor) {
+            return tensor.device().is_cpu() && !tensor.is_pinned()
+                ? tensor.pin_memory()
+                : tensor;
+          });
+    }
+    if (!device_) {
+      return;
+    }
+    const auto device = *device_;
+    const auto to_device = [device](const Tensor& tensor) {
+      return tensor.to(device, /*non_blocking=*/true);
+    };
+    if (device.is_cpu()) {
+      result.batch =
+          detail::BatchTensors<Batch>::map(std::move(*result.batch), to_device);
+      return;
+    }
+    c10::impl::VirtualGuardImpl guard_impl(device.type());
+    const auto stream = guard_impl.getStreamFromGlobalPool(device);
+    c10::StreamGuard stream_guard(stream);
+    result.batch =
+        detail::BatchTensors<Batch>::map(std::move(*result.batch), to_device);
+    result.copied = std::make_shared<c10::Event>(device.type());
+    result.copied->record(stream);
+  }
+
+  /// Makes the current stream of the main thread wait for the copies of the
+  /// batch, and tells the caching allocator that its tensors are used on that
+  /// stream.
+  void wait_for_copies(Result& result) const {
+    if (!result.copied) {
+      return;
+    }
+    c10::impl::VirtualGuardImpl guard_impl(device_->type());
+    const auto stream = guard_impl.getStream(*device_);
+    result.copied->block(stream);
+    result.batch = detail::BatchTensors<Batch>::map(
+        std::move(*result.batch), [&](const Tensor& tensor) {
+          if (tensor.has_storage()) {
+            guard_impl.recordDataPtrOnStream(
+                tensor.storage().data_ptr(), stream);
+          }
+          return tensor;
+        });
+  }
+
+  /// Gives an index to the device to move the batches to, so that the worker
+  /// threads copy them to the current device of the thread which created the
+  /// DataLoader.
+  static optional<Device> resolve_device(optional<Device> device) {
+    if (device && !device->is_cpu() && !device->has_index()) {
+      c10::impl::VirtualGuardImpl guard_impl(device->type());
+      return guard_impl.getDevice();
+    }
+    return device;
+  }
+
   /// Convenience method that calls `shuttle_.push_job()` with the next sequence
   /// number.
   template <typename T>
@@ -220,6 +304,9 @@ class DataLoaderBase {
   /// The options the DataLoader was configured with.
   const FullDataLoaderOptions options_;
 
+  /// The device to move the batches to, with an index if it isn't the CPU.
+  const optional<Device> device_;
+
   /// The dataset for the main thread, only has a value if the number of
   /// worker threads was configured as zero, meaning the main thread has to do
   /// all the work (synchronously). NOTE: Really want this to be on the heap
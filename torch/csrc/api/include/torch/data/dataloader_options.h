@@ -22,8 +22,11 @@ struct DataLoaderOptions {
   /// synchronously perform the data loading.
   TORCH_ARG(size_t, workers) = 0;
 
+  /// The number of batches loaded in advance by each worker thread.
+  TORCH_ARG(size_t, prefetch_factor) = 2;
+
   /// The maximum number of jobs to enqueue for fetching by worker threads.
-  /// Defaults to two times the number of worker threads.
+  /// Defaults to `prefetch_factor` times the number of worker threads.
   TORCH_ARG(optional<size_t>, max_jobs);
 
   /// An optional limit on the time to wait for the next batch.
@@ -37,11 +40,23 @@ struct DataLoaderOptions {
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// Whether to copy the tensors of each batch into pinned (page-locked)
+  /// memory before returning it, which makes their copies to CUDA devices
+  /// asynchronous. The worker threads do the pinning.
+  TORCH_ARG(bool, pin_memory) = false;
+
+  /// An optional device to move the tensors of each batch to. For CUDA
+  /// devices, the worker threads issue the copies on streams of the device
+  /// pool, and the batch is only handed to the current stream of the main
+  /// thread once its copies are done, so that they overlap with the work
+  /// already queued on that stream.
+  TORCH_ARG(optional<Device>, device);
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
 /// `DataLoaderOptions` has some options that depend on other options
-/// (`max_jobs` => `2 * workers`). In the spirit of properly using the C++ type
+/// (`max_jobs` => `prefetch_factor * workers`). In the spirit of properly using the C++ type
 /// system, `DataLoaderOptions` allows only setting values. To access values,
 /// you must create a `FullDataLoaderOptions` from a `DataLoaderOptions`
 /// instance, which will do any necessary coalescing.
@@ -49,10 +64,13 @@ struct FullDataLoaderOptions {
   explicit FullDataLoaderOptions(DataLoaderOptions options)
       : batch_size(options.batch_size()),
         workers(options.workers()),
-        max_jobs(options.max_jobs().value_or(2 * workers)),
+        max_jobs(
+            options.max_jobs().value_or(options.prefetch_factor() * workers)),
         timeout(options.timeout()),
         enforce_ordering(options.enforce_ordering()),
-        drop_last(options.drop_last()) {}
+        drop_last(options.drop_last()),
+        pin_memory(options.pin_memory()),
+        device(options.device()) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +78,8 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  bool pin_memory;
+  optional<Device> device;
 };
 } // namespace data
 } // namespace torch
@@ -4,7 +4,11 @@
 #include <torch/csrc/utils/memory.h>
 #include <torch/data/datasets/stateful.h>
 #include <torch/data/samplers.h>
+#include <torch/types.h>
+#include <atomic>
+#include <limits>
 #include <queue>
+#include <random>
 #include <thread>
 
 #include <torch/serialize.h>
@@ -43,6 +47,13 @@ namespace detail {
 /// queue. When get_batch is called from data loader, it pops cached batches and
 /// return. If the cache is empty, it either waits to load more chunks or return
 /// null if all chunks are loaded.
+///
+/// If it has shuffle shards, the examples of the loaded chunks are kept in a
+/// shuffle buffer split in as many shards, each with its own lock, instead of
+/// being split into batches. Every batch is then made of examples drawn at
+/// random across the whole buffer, so that it mixes examples of all the chunks
+/// in the buffer, while the preloaders and the readers only contend on the
+/// shards they touch.
 template <
     typename UnwrappedBatch,
     typename ExampleSampler = samplers::RandomSampler>
@@ -55,14 +66,24 @@ class BatchDataBuffer {
   BatchDataBuffer(
       size_t batch_size,
       ExampleSampler& example_sampler,
-      size_t queue_capacity)
+      size_t queue_capacity,
+      size_t shuffle_shard_count = 0)
       : batch_size_(batch_size),
         example_sampler_(example_sampler),
-        queue_capacity_(queue_capacity) {}
+        queue_capacity_(queue_capacity),
+        shuffle_shards_(shuffle_shard_count),
+        shuffle_seed_(torch::randint(
+                          std::numeric_limits<int32_t>::max(),
+                          {1},
+                          torch::kLong)
+                          .template item<int64_t>()) {}
 
   /// Return batch data from the queue. Called from the ChunkDataset main
   /// thread.
   BatchType get_batch() {
+    if (!shuffle_shards_.empty()) {
+      return get_shuffled_batch();
+    }
     std::unique_lock<std::mutex> lock(queue_mutex_);
     cv_read_.wait(lock, [this] {
       // wait till there is available data in the queue or if all chunks are
@@ -104,6 +125,11 @@ class BatchDataBuffer {
       // Return without any further processing.
       return;
     }
+    if (!shuffle_shards_.empty()) {
+      lock.unlock();
+      add_shuffled_chunk_data(std::move(data));
+      return;
+    }
 
     auto data_size = data.size();
     auto remaining_size = data_size;
@@ -195,6 +221,76 @@ class BatchDataBuffer {
     // notify all readers too.
     cv_read_.notify_all();
   }
+  /// Spreads the examples of a chunk over the shuffle shards, starting from a
+  /// different shard for every chunk, and takes the lock of every shard once.
+  /// Called from the ChunkDataset worker threads, without the queue lock.
+  void add_shuffled_chunk_data(UnwrappedBatchType data) {
+    const auto data_size = data.size();
+    const auto shard_count = shuffle_shards_.size();
+    const auto first_shard = next_shuffle_shard_++;
+    for (size_t s = 0; s < shard_count && s < data_size; ++s) {
+      auto& shard = shuffle_shards_[(first_shard + s) % shard_count];
+      std::lock_guard<std::mutex> shard_lock(shard.mutex);
+      for (size_t i = s; i < data_size; i += shard_count) {
+        shard.examples.emplace_back(std::move(data[i]));
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      total_example_count_in_queue_ += data_size;
+    }
+    cv_read_.notify_all();
+  }
+
+  /// Draws a batch of examples at random across the shuffle shards. A reader
+  /// waits for the buffer to be half full, so that batches mix examples of
+  /// several chunks, and then reserves its examples under the queue lock, so
+  /// that concurrent readers never wait for the same examples.
+  BatchType get_shuffled_batch() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    cv_read_.wait(lock, [this] {
+      return (
+          (this->total_example_count_in_queue_ >= batch_size_ &&
+           this->total_example_count_in_queue_ >= queue_capacity_ / 2) ||
+          !this->batch_queue_.empty() || this->stop_);
+    });
+    if (!batch_queue_.empty()) {
+      // Only exceptions go through the batch queue in this mode.
+      UnwrappedBatchData batch = std::move(batch_queue_.front());
+      batch_queue_.pop();
+      throw WorkerException(batch.exception);
+    }
+    if (total_example_count_in_queue_ == 0) {
+      AT_ASSERT(stop_);
+      return nullopt;
+    }
+    const auto example_count =
+        std::min(batch_size_, total_example_count_in_queue_);
+    total_example_count_in_queue_ -= example_count;
+    std::minstd_rand generator(shuffle_seed_ + shuffle_batch_count_++);
+    lock.unlock();
+    cv_write_.notify_all();
+
+    UnwrappedBatchType batch;
+    batch.reserve(example_count);
+    const auto shard_count = shuffle_shards_.size();
+    while (batch.size() < example_count) {
+      // The reservation guarantees that there are enough examples across the
+      // shards, but not that the drawn shard holds any.
+      auto& shard = shuffle_shards_[generator() % shard_count];
+      std::lock_guard<std::mutex> shard_lock(shard.mutex);
+      auto& examples = shard.examples;
+      if (examples.empty()) {
+        continue;
+      }
+      std::swap(examples[generator() % examples.size()], examples.back());
+      batch.emplace_back(std::move(examples.back()));
+      examples.pop_back();
+    }
+    return batch;
+  }
+
   /// The batch size is needed to create batches from the chunk data. Similar to
   /// regular dataloader where the batches are created with prefetches,
   /// BatchDataBuffer perform the batch creation using the provided batch size.
@@ -233,6 +329,24 @@ class BatchDataBuffer {
   // configurable maximun number of elements the queue can hold at one time.
   size_t queue_capacity_;
 
+  /// A shard of the shuffle buffer.
+  struct ShuffleShard {
+    std::mutex mutex;
+    UnwrappedBatchType examples;
+  };
+
+  /// The shards of the shuffle buffer, empty if batches are made in order from
+  /// every chunk instead.
+  std::vector<ShuffleShard> shuffle_shards_;
+
+  /// The shard which takes the first example of the next chunk.
+  std::atomic<size_t> next_shuffle_shard_{0};
+
+  /// Seeds the draws of every batch from the shuffle buffer, together with the
+  /// number of batches drawn so far.
+  const uint64_t shuffle_seed_;
+  uint64_t shuffle_batch_count_ = 0;
+
   // When set to true, it wakes the writer threads from the wait and exit current
   // function call. This is needed when ChunkDataSet.Reset is called while the
   // previous epoch is not exhausted yet. When ChunkDataset is waiting its
@@ -250,11 +364,13 @@ struct ChunkDatasetOptions {
       size_t preloader_count,
       size_t batch_size,
       size_t cache_size = 2048,
-      size_t cross_chunk_shuffle_count = 1)
+      size_t cross_chunk_shuffle_count = 1,
+      size_t shuffle_shard_count = 0)
       : preloader_count_(preloader_count),
         batch_size_(batch_size),
         cache_size_(cache_size),
-        cross_chunk_shuffle_count_(cross_chunk_shuffle_count) {
+        cross_chunk_shuffle_count_(cross_chunk_shuffle_count),
+        shuffle_shard_count_(shuffle_shard_count) {
     TORCH_CHECK(
         preloader_count_ > 0,
         "Preloader count is 0. At least one preloader needs to be specified.");
@@ -292,6 +408,17 @@ struct ChunkDatasetOptions {
   // penalty when this value is greater than 1, as we need to do extra merge
   // between multiple chunks before performing example sampling.
   TORCH_ARG(size_t, cross_chunk_shuffle_count) = 1;
+
+  // The number of shards of the shuffle buffer. Default to 0 meaning no
+  // shuffle buffer: the examples of each loaded chunk are sampled by the
+  // example sampler and split into batches in that order. When it is greater
+  // than 0, the examples of the loaded chunks are kept in a buffer of
+  // `cache_size` examples split in that many shards, and every batch is drawn
+  // at random from the whole buffer, which mixes examples across chunks
+  // without the cost of loading several chunks at once. The example sampler
+  // is not used in this mode. Using about as many shards as preloaders and
+  // DataLoader workers keeps them from contending on the same lock.
+  TORCH_ARG(size_t, shuffle_shard_count) = 0;
 };
 
 /// A stateful dataset that support hierarchical sampling and prefetching of
@@ -387,7 +514,8 @@ class ChunkDataset final
         detail::BatchDataBuffer<UnwrappedBatchType, ExampleSamplerType>>(
         options_.batch_size(),
         example_sampler_,
-        options_.cache_size());
+        options_.cache_size(),
+        options_.shuffle_shard_count());
 
     // create new workers for this new epoch.
     quit_worker_ = false;
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <torch/data/datasets/base.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+/// A dataset of records, stored back to back in a data file, with the offset of
+/// every record in an index file next to it (`<path>.index`). Records are
+/// opaque bytes, which are returned as 1-D `kByte` tensors, and are usually
+/// decoded with a transform applied with `map()`. Such files are written with
+/// `RecordWriter`.
+///
+/// Random access to the records is about as fast as sequential access: the
+/// index is memory mapped, and batches of records are fetched all at once, so
+/// that the reads of a batch overlap in the kernel.
+class TORCH_API RecordDataset : public Dataset<RecordDataset, TensorExample> {
+ public:
+  /// How the records are read from the data file.
+  enum class Mode {
+    /// The data file is memory mapped, and every record is a copy-on-write
+    /// view of the mapping, so that no bytes are copied until a record is
+    /// written to. `get_batch` asks the kernel to fetch the pages of all its
+    /// records before touching any of them.
+    kMmap,
+    /// Every record is read into its own tensor. `get_batch` reads the records
+    /// which follow each other in the file with a single `preadv`.
+    kRead,
+  };
+
+  /// Opens the record file at `path` and its index at `<path>.index`.
+  explicit RecordDataset(const std::string& path, Mode mode = Mode::kMmap);
+
+  /// Returns the record at the given `index`.
+  TensorExample get(size_t index) override;
+
+  /// Returns the records at the given `indices`.
+  std::vector<TensorExample> get_batch(ArrayRef<size_t> indices) override;
+
+  /// Returns the number of records.
+  optional<size_t> size() const override;
+
+  /// Returns the mode in which the records are read.
+  Mode mode() const noexcept;
+
+ private:
+  struct Impl;
+  /// Shared between the copies of the dataset that the DataLoader gives to its
+  /// worker threads.
+  std::shared_ptr<Impl> impl_;
+};
+
+/// Writes a record file and its index for `RecordDataset`.
+class TORCH_API RecordWriter {
+ public:
+  /// Creates (or truncates) the record file at `path`. The index is written to
+  /// `<path>.index` by `close()`.
+  explicit RecordWriter(const std::string& path);
+
+  /// Closes the writer if it hasn't been closed yet.
+  ~RecordWriter();
+
+  RecordWriter(const RecordWriter&) = delete;
+  RecordWriter& operator=(const RecordWriter&) = delete;
+
+  /// Appends a record made of `nbytes` bytes at `data`.
+  void write(const void* data, size_t nbytes);
+
+  /// Appends a record made of the bytes of the (CPU) tensor.
+  void write(const Tensor& tensor);
+
+  /// Flushes the records and writes the index. No record can be written after.
+  void close();
+
+  /// Returns the number of records written so far.
+  size_t size() const noexcept;
+
+ private:
+  std::string path_;
+  std::FILE* file_;
+  std::vector<uint64_t> offsets_;
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Applies a function to every tensor of a batch, and returns the batch made of
+/// the results. This is how the `pin_memory` and `device` options of the
+/// DataLoader reach the tensors of a batch. Batches of other types are returned
+/// unchanged, specialize `BatchTensors` for custom batch types which hold
+/// tensors.
+template <typename Batch>
+struct BatchTensors {
+  template <typename Function>
+  static Batch map(Batch batch, const Function& function) {
+    return batch;
+  }
+};
+
+template <>
+struct BatchTensors<Tensor> {
+  template <typename Function>
+  static Tensor map(Tensor tensor, const Function& function) {
+    return function(tensor);
+  }
+};
+
+template <typename Data, typename Target>
+struct BatchTensors<Example<Data, Target>> {
+  template <typename Function>
+  static Example<Data, Target> map(
+      Example<Data, Target> example,
+      const Function& function) {
+    return {BatchTensors<Data>::map(std::move(example.data), function),
+            BatchTensors<Target>::map(std::move(example.target), function)};
+  }
+};
+
+template <typename Data>
+struct BatchTensors<Example<Data, example::NoTarget>> {
+  template <typename Function>
+  static Example<Data, example::NoTarget> map(
+      Example<Data, example::NoTarget> example,
+      const Function& function) {
+    return {BatchTensors<Data>::map(std::move(example.data), function)};
+  }
+};
+
+template <typename T>
+struct BatchTensors<std::vector<T>> {
+  template <typename Function>
+  static std::vector<T> map(std::vector<T> batch, const Function& function) {
+    for (auto& element : batch) {
+      element = BatchTensors<T>::map(std::move(element), function);
+    }
+    return batch;
+  }
+};
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -0,0 +1,343 @@
+#include <torch/data/datasets/record.h>
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace {
+// The index file holds the magic number, the number of records, and then the
+// offsets of the records in the data file followed by the size of the data
+// file, all as native 64-bit integers.
+constexpr uint64_t kIndexMagicNumber = 0x5845444e49434552; // "RECINDEX"
+constexpr size_t kIndexHeaderSize = 2;
+constexpr const char* kIndexSuffix = ".index";
+
+#ifndef _WIN32
+struct MappedFile {
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (data != nullptr) {
+      munmap(data, size);
+    }
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+
+  // Opens the file, and maps it if `map` is true. The mapping is private, so
+  // that writes to it stay in this process instead of reaching the file.
+  void open(const std::string& path, bool map) {
+    fd = ::open(path.c_str(), O_RDONLY);
+    TORCH_CHECK(fd >= 0, "Error opening ", path, ": ", std::strerror(errno));
+    struct stat st;
+    TORCH_CHECK(
+        fstat(fd, &st) == 0,
+        "Error reading the size of ",
+        path,
+        ": ",
+        std::strerror(errno));
+    size = static_cast<size_t>(st.st_size);
+    if (!map || size == 0) {
+      return;
+    }
+    void* ptr = mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, /*offset=*/0);
+    TORCH_CHECK(
+        ptr != MAP_FAILED, "Error mapping ", path, ": ", std::strerror(errno));
+    data = static_cast<char*>(ptr);
+  }
+
+  int fd = -1;
+  char* data = nullptr;
+  size_t size = 0;
+};
+
+// Reads into the buffers until they are full, starting at offset in the file.
+void read_fully(
+    int fd,
+    std::vector<struct iovec>& buffers,
+    uint64_t offset,
+    const std::string& path) {
+  size_t first = 0;
+  while (first < buffers.size()) {
+    if (buffers[first].iov_len == 0) {
+      first++;
+      continue;
+    }
+#ifdef __linux__
+    const auto count =
+        std::min<size_t>(buffers.size() - first, static_cast<size_t>(IOV_MAX));
+    ssize_t bytes = preadv(fd, &buffers[first], count, offset);
+#else
+    ssize_t bytes =
+        pread(fd, buffers[first].iov_base, buffers[first].iov_len, offset);
+#endif
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    TORCH_CHECK(bytes >= 0, "Error reading ", path, ": ", std::strerror(errno));
+    TORCH_CHECK(bytes > 0, "Unexpected end of file in ", path);
+    offset += bytes;
+    // Skips the buffers which are now full, and moves into the partial one.
+    while (bytes > 0) {
+      auto& buffer = buffers[first];
+      const auto consumed = std::min<size_t>(bytes, buffer.iov_len);
+      buffer.iov_base = static_cast<char*>(buffer.iov_base) + consumed;
+      buffer.iov_len -= consumed;
+      bytes -= consumed;
+      if (buffer.iov_len == 0) {
+        first++;
+      }
+    }
+  }
+}
+#endif
+} // namespace
+
+struct RecordDataset::Impl {
+  Impl(const std::string& path, Mode mode) : path(path), mode(mode) {
+#ifdef _WIN32
+    TORCH_CHECK(false, "RecordDataset is not supported on Windows");
+#else
+    const auto index_path = path + kIndexSuffix;
+    index.open(index_path, /*map=*/true);
+    TORCH_CHECK(
+        index.size >= (kIndexHeaderSize + 1) * sizeof(uint64_t) &&
+            index.size % sizeof(uint64_t) == 0,
+        "Malformed record index ",
+        index_path);
+    const auto* header = reinterpret_cast<const uint64_t*>(index.data);
+    TORCH_CHECK(
+        header[0] == kIndexMagicNumber,
+        "Expected ",
+        index_path,
+        " to be a record index, but found magic number ",
+        header[0]);
+    count = header[1];
+    TORCH_CHECK(
+        index.size == (kIndexHeaderSize + count + 1) * sizeof(uint64_t),
+        "Expected ",
+        count,
+        " records in ",
+        index_path,
+        " but the index has ",
+        index.size / sizeof(uint64_t) - kIndexHeaderSize - 1);
+    offsets = header + kIndexHeaderSize;
+
+    data.open(path, /*map=*/mode == Mode::kMmap);
+    TORCH_CHECK(
+        offsets[count] == data.size,
+        "Expected ",
+        path,
+        " to hold ",
+        offsets[count],
+        " bytes of records, but it has ",
+        data.size);
+#endif
+  }
+
+  void check_index(size_t i) const {
+    TORCH_CHECK(
+        i < count,
+        "Index ",
+        i,
+        " is out of range for a record file with ",
+        count,
+        " records");
+  }
+
+  size_t record_size(size_t i) const {
+    return offsets[i + 1] - offsets[i];
+  }
+
+  const std::string path;
+  const Mode mode;
+#ifndef _WIN32
+  MappedFile index;
+  MappedFile data;
+#endif
+  const uint64_t* offsets = nullptr;
+  size_t count = 0;
+};
+
+RecordDataset::RecordDataset(const std::string& path, Mode mode)
+    : impl_(std::make_shared<Impl>(path, mode)) {}
+
+TensorExample RecordDataset::get(size_t index) {
+  return get_batch(index).front();
+}
+
+std::vector<TensorExample> RecordDataset::get_batch(ArrayRef<size_t> indices) {
+  std::vector<TensorExample> batch;
+  batch.reserve(indices.size());
+#ifndef _WIN32
+  for (const auto i : indices) {
+    impl_->check_index(i);
+  }
+
+  if (impl_->mode == Mode::kMmap) {
+    // Lets the kernel fetch the pages of all the records at once, instead of
+    // faulting them in one record at a time.
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+    if (indices.size() > 1) {
+      for (const auto i : indices) {
+        const auto begin = impl_->offsets[i] / page_size * page_size;
+        const auto end = impl_->offsets[i + 1];
+        if (end > begin) {
+          madvise(impl_->data.data + begin, end - begin, MADV_WILLNEED);
+        }
+      }
+    }
+    // The records keep the mapping alive.
+    auto impl = impl_;
+    for (const auto i : indices) {
+      batch.emplace_back(torch::from_blob(
+          impl_->data.data + impl_->offsets[i],
+          {static_cast<int64_t>(impl_->record_size(i))},
+          [impl](void*) {},
+          torch::kByte));
+    }
+    return batch;
+  }
+
+  std::vector<struct iovec> buffers(indices.size());
+  for (size_t b = 0; b < indices.size(); b++) {
+    const auto i = indices[b];
+    batch.emplace_back(
+        torch::empty({static_cast<int64_t>(impl_->record_size(i))}, torch::kByte));
+    buffers[b].iov_base = batch.back().data.data_ptr();
+    buffers[b].iov_len = impl_->record_size(i);
+  }
+
+  // Reads the records in the order of the file, with one read for every run of
+  // records which follow each other.
+  std::vector<size_t> order(indices.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return impl_->offsets[indices[a]] < impl_->offsets[indices[b]];
+  });
+  std::vector<struct iovec> run;
+  for (size_t o = 0; o < order.size();) {
+    const auto offset = impl_->offsets[indices[order[o]]];
+    run.clear();
+    do {
+      run.push_back(buffers[order[o]]);
+      o++;
+    } while (o < order.size() &&
+             impl_->offsets[indices[order[o]]] ==
+                 impl_->offsets[indices[order[o - 1]] + 1]);
+    read_fully(impl_->data.fd, run, offset, impl_->path);
+  }
+#endif
+  return batch;
+}
+
+optional<size_t> RecordDataset::size() const {
+  return impl_->count;
+}
+
+RecordDataset::Mode RecordDataset::mode() const noexcept {
+  return impl_->mode;
+}
+
+RecordWriter::RecordWriter(const std::string& path)
+    : path_(path), file_(std::fopen(path.c_str(), "wb")), offsets_({0}) {
+  TORCH_CHECK(
+      file_ != nullptr,
+      "Error opening ",
+      path,
+      " for writing: ",
+      std::strerror(errno));
+}
+
+RecordWriter::~RecordWriter() {
+  if (file_ != nullptr) {
+    try {
+      close();
+    } catch (const std::exception&) {
+      // Destructors can't throw, call close() to see the error.
+    }
+  }
+}
+
+void RecordWriter::write(const void* data, size_t nbytes) {
+  TORCH_CHECK(file_ != nullptr, "Attempted to write to a closed RecordWriter");
+  TORCH_CHECK(
+      std::fwrite(data, 1, nbytes, file_) == nbytes,
+      "Error writing to ",
+      path_,
+      ": ",
+      std::strerror(errno));
+  offsets_.push_back(offsets_.back() + nbytes);
+}
+
+void RecordWriter::write(const Tensor& tensor) {
+  TORCH_CHECK(
+      tensor.device().is_cpu(),
+      "RecordWriter expects CPU tensors, but got a tensor on ",
+      tensor.device());
+  const auto contiguous = tensor.contiguous();
+  write(contiguous.data_ptr(), contiguous.nbytes());
+}
+
+void RecordWriter::close() {
+  TORCH_CHECK(file_ != nullptr, "Attempted to close a closed RecordWriter");
+  const auto closed = std::fclose(file_);
+  file_ = nullptr;
+  TORCH_CHECK(
+      closed == 0, "Error writing to ", path_, ": ", std::strerror(errno));
+
+  const auto index_path = path_ + kIndexSuffix;
+  std::FILE* index = std::fopen(index_path.c_str(), "wb");
+  TORCH_CHECK(
+      index != nullptr,
+      "Error opening ",
+      index_path,
+      " for writing: ",
+      std::strerror(errno));
+  const uint64_t header[kIndexHeaderSize] = {kIndexMagicNumber, size()};
+  const bool written =
+      std::fwrite(header, sizeof(uint64_t), kIndexHeaderSize, index) ==
+          kIndexHeaderSize &&
+      std::fwrite(offsets_.data(), sizeof(uint64_t), offsets_.size(), index) ==
+          offsets_.size();
+  const auto index_closed = std::fclose(index);
+  TORCH_CHECK(
+      written && index_closed == 0,
+      "Error writing to ",
+      index_path,
+      ": ",
+      std::strerror(errno));
+}
+
+size_t RecordWriter::size() const noexcept {
+  return offsets_.size() - 1;
+}
+
+} // namespace datasets
+} // namespace data
+} // namespace torch
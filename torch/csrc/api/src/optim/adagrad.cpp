@@ -8,6 +8,7 @@
 #include <ATen/ATen.h>
 
 #include <functional>
+#include <map>
 
 namespace torch {
 namespace optim {
@@ -55,6 +56,16 @@ void AdagradParamState::serialize(torch::serialize::InputArchive& archive) {
 
 /// Adapted from
 /// https://github.com/pytorch/pytorch/blob/master/torch/optim/adagrad.py
+namespace {
+// Parameters of a group with dense gradients that are at the same step, and
+// their state.
+struct AdagradBatch {
+  std::vector<Tensor> params;
+  std::vector<Tensor> grads;
+  std::vector<Tensor> sums;
+};
+} // namespace
+
 Tensor Adagrad::step(LossClosure closure) {
   NoGradGuard no_grad;
   Tensor loss = {};
@@ -63,6 +74,12 @@ Tensor Adagrad::step(LossClosure closure) {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<AdagradOptions&>(group.options());
+    // Parameters with dense gradients are updated with _foreach_ ops, which
+    // take a handful of kernel launches for all the tensors instead of several
+    // per tensor on CUDA. The learning rate decays with the step, so they are
+    // batched by step, which usually gives a single batch.
+    std::map<int64_t, AdagradBatch> batches;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -70,40 +87,54 @@ Tensor Adagrad::step(LossClosure closure) {
       auto grad = p.grad();
       TORCH_INTERNAL_ASSERT(state_[c10::guts::to_string(p.unsafeGetTensorImpl())] != nullptr, "state found NULL for the Tensor ", p);
       auto& state = static_cast<AdagradParamState&>(*state_[c10::guts::to_string(p.unsafeGetTensorImpl())]);
-      auto& options = static_cast<AdagradOptions&>(group.options());
 
       state.step(state.step() + 1);
 
-      if (options.weight_decay() != 0) {
-        TORCH_CHECK(!p.grad().is_sparse(), "weight_decay option is not compatible with sparse gradients");
-        grad = grad.add(p, options.weight_decay());
+      if (!grad.is_sparse()) {
+        auto& batch = batches[state.step()];
+        batch.params.push_back(p);
+        batch.grads.push_back(grad);
+        batch.sums.push_back(state.sum());
+        continue;
       }
+
+      TORCH_CHECK(options.weight_decay() == 0, "weight_decay option is not compatible with sparse gradients");
       const auto clr = options.lr() /
           (1 + static_cast<double>(state.step() - 1) * options.lr_decay());
 
-      if (grad.is_sparse()) {
-        grad = grad.coalesce();
-        auto grad_indices = grad._indices();
-        auto grad_values = grad._values();
-        auto size = grad.sizes();
-
-        auto make_sparse = [&] (const Tensor& values) -> Tensor {
-          if (grad_indices.dim() == 0 || values.dim() == 0) {
-            return torch::empty({0}, grad.options()).resize_as_(grad);
-          }
-          return torch::sparse_coo_tensor(grad_indices, values, size, grad.options());
-        };
-        state.sum(state.sum().add_(make_sparse(grad_values.pow(2))));
-        auto std = state.sum().sparse_mask(grad);
-        const auto std_values = std._values().sqrt_().add_(options.eps());
-
-        p.add_(make_sparse(grad_values / std_values), -clr);
-      }
-      else {
-        state.sum(state.sum().addcmul_(grad, grad, 1.0));
-        const auto std = state.sum().sqrt().add_(options.eps());
-        p.addcdiv_(grad, std, -clr);
+      grad = grad.coalesce();
+      auto grad_indices = grad._indices();
+      auto grad_values = grad._values();
+      auto size = grad.sizes();
+
+      auto make_sparse = [&] (const Tensor& values) -> Tensor {
+        if (grad_indices.dim() == 0 || values.dim() == 0) {
+          return torch::empty({0}, grad.options()).resize_as_(grad);
+        }
+        return torch::sparse_coo_tensor(grad_indices, values, size, grad.options());
+      };
+      state.sum(state.sum().add_(make_sparse(grad_values.pow(2))));
+      auto std = state.sum().sparse_mask(grad);
+      const auto std_values = std._values().sqrt_().add_(options.eps());
+
+      p.add_(make_sparse(grad_values / std_values), -clr);
+    }
+
+    for (auto& step_and_batch : batches) {
+      auto step = step_and_batch.first;
+      auto& batch = step_and_batch.second;
+
+      auto grads = batch.grads;
+      if (options.weight_decay() != 0) {
+        grads = torch::_foreach_add(grads, batch.params, options.weight_decay());
       }
+      const auto clr = options.lr() /
+          (1 + static_cast<double>(step - 1) * options.lr_decay());
+
+      torch::_foreach_addcmul_(batch.sums, grads, grads, 1.0);
+      auto stds = torch::_foreach_sqrt(batch.sums);
+      torch::_foreach_add_(stds, options.eps());
+      torch::_foreach_addcdiv_(batch.params, grads, stds, -clr);
     }
   }
   return loss;
@@ -71,6 +71,15 @@ Tensor RMSprop::step(LossClosure closure)  {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<RMSpropOptions&>(group.options());
+    // The parameters of the group are updated together with _foreach_ ops,
+    // which take a handful of kernel launches for all the tensors instead of
+    // several per tensor on CUDA.
+    std::vector<Tensor> params;
+    std::vector<Tensor> grads;
+    std::vector<Tensor> square_avgs;
+    std::vector<Tensor> grad_avgs;
+    std::vector<Tensor> momentum_buffers;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -78,7 +87,6 @@ Tensor RMSprop::step(LossClosure closure)  {
       auto grad = p.grad();
       TORCH_CHECK(!grad.is_sparse(), "RMSprop does not support sparse gradients");
       auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
-      auto& options = static_cast<RMSpropOptions&>(group.options());
 
       // State initialization
       if (param_state == state_.end()) {
@@ -95,36 +103,51 @@ Tensor RMSprop::step(LossClosure closure)  {
       }
 
       auto& state = static_cast<RMSpropParamState&>(*state_[c10::guts::to_string(p.unsafeGetTensorImpl())]);
-      auto& square_avg = state.square_avg();
-      auto alpha = options.alpha();
-
       state.step(state.step() + 1);
 
-      if (options.weight_decay() != 0) {
-        grad = grad.add(p, options.weight_decay());
-      }
-
-      square_avg.mul_(alpha).addcmul_(grad, grad, 1 - alpha);
-
-      Tensor avg;
+      params.push_back(p);
+      grads.push_back(grad);
+      square_avgs.push_back(state.square_avg());
       if (options.centered()) {
-        auto& grad_avg = state.grad_avg();
-        grad_avg.mul_(alpha).add_(grad, 1-alpha);
-        avg = square_avg.addcmul(grad_avg, grad_avg, -1).sqrt_().add_(options.eps());
-      } else {
-        avg = square_avg.sqrt().add_(options.eps());
+        grad_avgs.push_back(state.grad_avg());
       }
-
       if (options.momentum() > 0) {
-        auto& buf = state.momentum_buffer();
-        buf.mul_(options.momentum()).addcdiv_(grad, avg);
-        // Need to avoid version tracking for parameter.
-        p.add_(buf, -options.lr());
-      } else {
-        // Need to avoid version tracking for parameter.
-        p.addcdiv_(grad, avg, -options.lr());
+        momentum_buffers.push_back(state.momentum_buffer());
       }
     }
+    if (params.empty()) {
+      continue;
+    }
+
+    auto alpha = options.alpha();
+
+    if (options.weight_decay() != 0) {
+      grads = torch::_foreach_add(grads, params, options.weight_decay());
+    }
+
+    torch::_foreach_mul_(square_avgs, alpha);
+    torch::_foreach_addcmul_(square_avgs, grads, grads, 1 - alpha);
+
+    std::vector<Tensor> avgs;
+    if (options.centered()) {
+      torch::_foreach_mul_(grad_avgs, alpha);
+      torch::_foreach_add_(grad_avgs, grads, 1 - alpha);
+      avgs = torch::_foreach_addcmul(square_avgs, grad_avgs, grad_avgs, -1);
+      torch::_foreach_sqrt_(avgs);
+    } else {
+      avgs = torch::_foreach_sqrt(square_avgs);
+    }
+    torch::_foreach_add_(avgs, options.eps());
+
+    if (options.momentum() > 0) {
+      torch::_foreach_mul_(momentum_buffers, options.momentum());
+      torch::_foreach_addcdiv_(momentum_buffers, grads, avgs);
+      // Need to avoid version tracking for parameter.
+      torch::_foreach_add_(params, momentum_buffers, -options.lr());
+    } else {
+      // Need to avoid version tracking for parameter.
+      torch::_foreach_addcdiv_(params, grads, avgs, -options.lr());
+    }
   }
   return loss;
 }
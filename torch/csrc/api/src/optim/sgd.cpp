@@ -66,34 +66,57 @@ Tensor SGD::step(LossClosure closure)  {
     auto dampening = options.dampening();
     auto nesterov = options.nesterov();
 
+    // The parameters of the group are updated together with _foreach_ ops,
+    // which take a handful of kernel launches for all the tensors instead of
+    // several per tensor on CUDA.
+    std::vector<Tensor> params;
+    std::vector<Tensor> d_ps;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
       }
-      auto d_p = p.grad().data();
-      if (weight_decay != 0) {
-        d_p = d_p.add(p.data(), weight_decay);
-      }
-      if (momentum != 0) {
+      params.push_back(p);
+      d_ps.push_back(p.grad().data());
+    }
+    if (params.empty()) {
+      continue;
+    }
+
+    if (weight_decay != 0) {
+      d_ps = torch::_foreach_add(d_ps, params, weight_decay);
+    }
+    if (momentum != 0) {
+      std::vector<Tensor> bufs;
+      // The buffers created at this step already hold their d_p.
+      std::vector<Tensor> old_bufs;
+      std::vector<Tensor> old_bufs_d_ps;
+      bufs.reserve(params.size());
+      for (size_t i = 0; i < params.size(); i++) {
         Tensor buf;
-        auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
+        auto param_state = state_.find(c10::guts::to_string(params[i].unsafeGetTensorImpl()));
         if(param_state == state_.end()) {
-          buf = torch::clone(d_p).detach();
+          buf = torch::clone(d_ps[i]).detach();
           auto state = std::make_unique<SGDParamState>();
           state->momentum_buffer(buf);
-          state_[c10::guts::to_string(p.unsafeGetTensorImpl())] = std::move(state);
+          state_[c10::guts::to_string(params[i].unsafeGetTensorImpl())] = std::move(state);
         } else {
           buf = static_cast<SGDParamState&>(*param_state->second).momentum_buffer();
-          buf.mul_(momentum).add_(d_p, 1 - dampening);
-        }
-        if (nesterov) {
-          d_p = d_p.add(buf, momentum);
-        } else {
-          d_p = buf;
+          old_bufs.push_back(buf);
+          old_bufs_d_ps.push_back(d_ps[i]);
         }
+        bufs.push_back(buf);
+      }
+      if (!old_bufs.empty()) {
+        torch::_foreach_mul_(old_bufs, momentum);
+        torch::_foreach_add_(old_bufs, old_bufs_d_ps, 1 - dampening);
+      }
+      if (nesterov) {
+        d_ps = torch::_foreach_add(d_ps, bufs, momentum);
+      } else {
+        d_ps = bufs;
       }
-      p.data().add_(d_p, -1 * options.lr());
     }
+    torch::_foreach_add_(params, d_ps, -1 * options.lr());
   }
   return loss;
 }
@@ -6,6 +6,7 @@
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
 #include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/utils/hash.h>
 #include <torch/csrc/utils/memory.h>
 
 #include <ATen/DeviceGuard.h>
@@ -28,6 +29,7 @@
 #include <set>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <typeinfo>
 #include <sstream>
@@ -97,6 +99,25 @@ static thread_local std::shared_ptr<GraphTask> current_graph_task = nullptr;
 // see Note [Reentrant backwards] for more details.
 static thread_local std::shared_ptr<ReadyQueue> local_ready_queue = nullptr;
 
+namespace {
+// Points local_ready_queue at the cpu_ready_queue_ of the graph task the
+// current thread is about to drive, and restores it on exit. The two only
+// differ when the engine runs CPU tasks on several threads, see
+// Note [Multithreaded CPU backward].
+struct LocalReadyQueueGuard {
+  explicit LocalReadyQueueGuard(std::shared_ptr<ReadyQueue> ready_queue)
+      : prev_ready_queue_(std::move(local_ready_queue)) {
+    local_ready_queue = std::move(ready_queue);
+  }
+  ~LocalReadyQueueGuard() {
+    local_ready_queue = std::move(prev_ready_queue_);
+  }
+
+ private:
+  std::shared_ptr<ReadyQueue> prev_ready_queue_;
+};
+} // namespace
+
 // Note [Reentrant backwards]
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~
 // To understand the reentrant backwards problem, we have to notice two
@@ -405,6 +426,14 @@ auto Engine::thread_main(const std::shared_ptr<GraphTask>& graph_task) -> void {
             ->push(NodeTask(local_graph_task, nullptr, InputBuffer(0)));
       }
     }
+
+    // Once the graph task is done, possibly with an error, the other threads
+    // draining its cpu_ready_queue_ might be sleeping on pop().
+    // See Note [Multithreaded CPU backward]
+    if (local_graph_task->num_cpu_workers_ > 0 &&
+        local_graph_task->future_result_->completed()) {
+      local_graph_task->wake_cpu_workers();
+    }
   }
 }
 
@@ -444,6 +473,19 @@ void Engine::thread_on_exception(
   graph_task->set_exception(e, fn);
 }
 
+void GraphTask::wake_cpu_workers() {
+  if (cpu_workers_woken_.exchange(true)) {
+    return;
+  }
+  // One dummy task for the owning thread and for each worker. Threads that
+  // are not sleeping exit thread_main without popping theirs; the leftovers
+  // are dropped along with cpu_ready_queue_, which no other graph task uses.
+  std::atomic_thread_fence(std::memory_order_release);
+  for (int i = 0; i <= num_cpu_workers_; ++i) {
+    cpu_ready_queue_->push(NodeTask(shared_from_this(), nullptr, InputBuffer(0)));
+  }
+}
+
 bool GraphTask::completed() {
   return outstanding_tasks_.load() == 0 ||
       (exit_on_error_ && has_error_.load());
@@ -828,16 +870,225 @@ auto Engine::compute_dependencies(Node* root, GraphTask& task) -> void {
   // Queue contains all nodes that will start propagating gradients.
   // We no longer have to expand functions that don't require grad.
   auto& dependencies = task.dependencies_;
+  // Nodes with several dependencies get their InputBuffer in not_ready_ while
+  // they wait; count them so that the map is allocated upfront.
+  size_t num_waiting_nodes = 0;
   while (!queue.empty()) {
     auto fn = queue.back(); queue.pop_back();
     for (const auto& edge : fn->next_edges()) {
       if (auto next_ptr = edge.function.get()) {
-        dependencies[next_ptr] += 1;
+        if (++dependencies[next_ptr] == 2) {
+          ++num_waiting_nodes;
+        }
         const bool was_inserted = seen.insert(next_ptr).second;
         if (was_inserted) queue.push_back(next_ptr);
       }
     }
   }
+  task.not_ready_.reserve(num_waiting_nodes);
+}
+
+// Note [Multithreaded CPU backward]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default the CPU tasks of a backward call all run on the calling thread,
+// so independent branches of the graph are executed one after the other.
+// With set_num_cpu_threads(n), n > 1, a non-reentrant backward call gets a
+// cpu_ready_queue_ of its own, which the calling thread drains together with
+// n - 1 workers borrowed from the reentrant thread pool (see
+// add_thread_pool_task). A task is pushed to the queue only once all its
+// dependencies are done, and dependencies_, not_ready_ and the input buffers
+// are only touched with the GraphTask mutex_ held, so any thread may run any
+// ready task.
+//
+// Every thread leaves thread_main once the future of the graph task is
+// completed. As several threads may be sleeping on the shared queue at that
+// point, the first thread to notice the completion wakes them all up with
+// dummy tasks (GraphTask::wake_cpu_workers).
+//
+// A reentrant backward call made from one of these threads gets a fresh
+// cpu_ready_queue_ as well, so that the thread waiting on it is the only
+// one running its tasks and the usual completion notification reaches it.
+// The reentrant graph task itself runs on a single thread.
+void Engine::set_num_cpu_threads(int num_threads) {
+  TORCH_CHECK(num_threads > 0,
+              "Number of CPU threads must be positive, got ", num_threads);
+  num_cpu_threads_.store(num_threads);
+}
+
+int Engine::num_cpu_threads() const {
+  return num_cpu_threads_.load();
+}
+
+// Note [Static graph replay]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Models with a fixed topology build the same graph on every iteration, and
+// backward() then pays for compute_dependencies and a trip through the ready
+// queues for every node. With set_static_graph(true), the engine records the
+// topology of the graphs it runs: the nodes numbered breadth first from the
+// root, how many inputs each one has and where each of its next edges points.
+// The topology is recorded along with an execution order, computed once with
+// the priorities of the ready queue (higher sequence_nr first).
+//
+// When a later backward call builds a graph with a known topology, it is
+// replayed: the nodes run one after the other on the calling thread in the
+// recorded order, with their inputs accumulated in an array of InputBuffers
+// indexed by node number, instead of the dependencies_ and not_ready_ maps.
+// A graph with an unknown topology takes the regular path and is recorded
+// for next time; only the kMaxStaticGraphPlans most recent ones are kept.
+//
+// Replay only covers plain backward() calls whose nodes all run on CPU; the
+// regular path is always taken for .grad() calls, reentrant calls, anomaly
+// mode and multithreaded CPU backward (see Note [Multithreaded CPU backward]).
+struct StaticGraphPlan {
+  // Node i has num_inputs_[i] inputs and the next edges in
+  // [edge_offsets_[i], edge_offsets_[i + 1]), pointing to the input
+  // edge_input_nrs_ of node edge_targets_ (-1 for an invalid edge).
+  std::vector<uint32_t> num_inputs_;
+  std::vector<size_t> edge_offsets_;
+  std::vector<int64_t> edge_targets_;
+  std::vector<uint32_t> edge_input_nrs_;
+  size_t hash_ = 0;
+  std::vector<uint32_t> order_;
+
+  bool same_topology(const StaticGraphPlan& other) const {
+    return hash_ == other.hash_ && num_inputs_ == other.num_inputs_ &&
+        edge_targets_ == other.edge_targets_ &&
+        edge_input_nrs_ == other.edge_input_nrs_ &&
+        edge_offsets_ == other.edge_offsets_;
+  }
+};
+
+namespace {
+static constexpr size_t kMaxStaticGraphPlans = 8;
+
+// Numbers the nodes reachable from graph_root into `nodes` and records their
+// topology in `plan`. Returns false if the graph can't be replayed.
+bool record_static_graph_topology(
+    Node* graph_root,
+    std::vector<Node*>& nodes,
+    StaticGraphPlan& plan) {
+  std::unordered_map<Node*, uint32_t> index;
+  nodes.push_back(graph_root);
+  index.emplace(graph_root, 0);
+  size_t hash = 0;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    Node* fn = nodes[i];
+    const uint32_t num_inputs = fn->num_inputs();
+    for (uint32_t j = 0; j < num_inputs; ++j) {
+      if (fn->input_metadata(j).device().type() != c10::DeviceType::CPU) {
+        return false;
+      }
+    }
+    plan.num_inputs_.push_back(num_inputs);
+    plan.edge_offsets_.push_back(plan.edge_targets_.size());
+    hash = torch::hash_combine(hash, num_inputs);
+    for (const auto& edge : fn->next_edges()) {
+      int64_t target = -1;
+      if (edge.is_valid()) {
+        auto it = index.emplace(edge.function.get(), nodes.size());
+        if (it.second) {
+          nodes.push_back(edge.function.get());
+        }
+        target = it.first->second;
+      }
+      plan.edge_targets_.push_back(target);
+      plan.edge_input_nrs_.push_back(edge.input_nr);
+      hash = torch::hash_combine(hash, torch::hash_combine(target, edge.input_nr));
+    }
+  }
+  plan.edge_offsets_.push_back(plan.edge_targets_.size());
+  plan.hash_ = hash;
+  return true;
+}
+
+// Topological order of the nodes of `plan`, among the ready nodes the one
+// with the highest sequence_nr first, as in ReadyQueue.
+void compute_static_graph_order(
+    const std::vector<Node*>& nodes,
+    StaticGraphPlan& plan) {
+  std::vector<uint32_t> dependencies(nodes.size(), 0);
+  for (auto target : plan.edge_targets_) {
+    if (target >= 0) {
+      ++dependencies[target];
+    }
+  }
+  auto runs_later = [&nodes](uint32_t a, uint32_t b) {
+    return nodes[a]->sequence_nr() < nodes[b]->sequence_nr();
+  };
+  std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(runs_later)> ready(runs_later);
+  ready.push(0);
+  plan.order_.reserve(nodes.size());
+  while (!ready.empty()) {
+    auto i = ready.top();
+    ready.pop();
+    plan.order_.push_back(i);
+    for (auto e = plan.edge_offsets_[i]; e < plan.edge_offsets_[i + 1]; ++e) {
+      auto target = plan.edge_targets_[e];
+      if (target >= 0 && --dependencies[target] == 0) {
+        ready.push(target);
+      }
+    }
+  }
+}
+} // namespace
+
+void Engine::set_static_graph(bool enabled) {
+  static_graph_.store(enabled);
+  if (!enabled) {
+    std::lock_guard<std::mutex> lock(static_graph_plans_mutex_);
+    static_graph_plans_.clear();
+  }
+}
+
+bool Engine::is_static_graph() const {
+  return static_graph_.load();
+}
+
+void Engine::execute_static_graph(
+    const std::shared_ptr<GraphTask>& graph_task,
+    const std::vector<Node*>& nodes,
+    const StaticGraphPlan& plan) {
+  // Reentrant backward calls made by the nodes may need the thread pool
+  initialize_device_threads_pool();
+  // As in execute_with_graph_task, so that backward calls made by the nodes
+  // are seen as reentrant.
+  set_device(CPU_DEVICE);
+  graph_task->owner_ = worker_device;
+
+  std::vector<InputBuffer> input_buffers;
+  input_buffers.reserve(nodes.size());
+  for (auto num_inputs : plan.num_inputs_) {
+    input_buffers.emplace_back(num_inputs);
+  }
+
+  auto local_graph_task = graph_task;
+  for (auto i : plan.order_) {
+    Node* fn = nodes[i];
+    try {
+      AutoGradMode grad_mode(graph_task->grad_mode_);
+      GraphTaskGuard guard(graph_task);
+      auto outputs = call_function(local_graph_task, fn, input_buffers[i]);
+      if (!graph_task->keep_graph_) {
+        fn->release_variables();
+      }
+      // call_function checked that there is one output per next edge
+      auto e = plan.edge_offsets_[i];
+      for (auto& output : outputs) {
+        auto target = plan.edge_targets_[e];
+        if (target >= 0) {
+          input_buffers[target].add(
+              plan.edge_input_nrs_[e], std::move(output), c10::nullopt, c10::nullopt);
+        }
+        ++e;
+      }
+    } catch (std::exception& e) {
+      thread_on_exception(graph_task, fn->shared_from_this(), e);
+      break;
+    }
+  }
+
+  worker_device = NO_DEVICE;
+  graph_task->mark_as_completed_and_run_post_processing();
 }
 
 auto Engine::execute(const edge_list& roots,
@@ -857,14 +1108,58 @@ auto Engine::execute(const edge_list& roots,
   init_local_ready_queue();
   bool not_reentrant_backward_call = worker_device == NO_DEVICE;
 
+  // See Note [Multithreaded CPU backward]
+  auto cpu_ready_queue = local_ready_queue;
+  int num_cpu_workers = 0;
+  if (not_reentrant_backward_call) {
+    num_cpu_workers = num_cpu_threads() - 1;
+    if (num_cpu_workers > 0) {
+      cpu_ready_queue = std::make_shared<ReadyQueue>();
+    }
+  } else if (current_graph_task && current_graph_task->num_cpu_workers_ > 0 &&
+             current_graph_task->cpu_ready_queue_ == local_ready_queue) {
+    cpu_ready_queue = std::make_shared<ReadyQueue>();
+  }
+
   auto graph_task = std::make_shared<GraphTask>(
       /* keep_graph */ keep_graph,
       /* create_graph */ create_graph,
       /* depth */ not_reentrant_backward_call ? 0 : total_depth + 1,
-      /* cpu_ready_queue */ local_ready_queue);
+      /* cpu_ready_queue */ std::move(cpu_ready_queue));
+  graph_task->num_cpu_workers_ = num_cpu_workers;
 
   // Now compute the dependencies for all executable functions and queue the root
   auto graph_root = std::make_shared<GraphRoot>(roots, inputs);
+
+  // See Note [Static graph replay]
+  if (not_reentrant_backward_call && outputs.empty() && num_cpu_workers == 0 &&
+      is_static_graph() && !AnomalyMode::is_enabled()) {
+    std::vector<Node*> nodes;
+    auto topology = std::make_shared<StaticGraphPlan>();
+    if (record_static_graph_topology(graph_root.get(), nodes, *topology)) {
+      std::shared_ptr<StaticGraphPlan> plan;
+      {
+        std::lock_guard<std::mutex> lock(static_graph_plans_mutex_);
+        for (const auto& cached : static_graph_plans_) {
+          if (cached->same_topology(*topology)) {
+            plan = cached;
+            break;
+          }
+        }
+      }
+      if (plan) {
+        execute_static_graph(graph_task, nodes, *plan);
+        return graph_task->future_result_->wait();
+      }
+      compute_static_graph_order(nodes, *topology);
+      std::lock_guard<std::mutex> lock(static_graph_plans_mutex_);
+      if (static_graph_plans_.size() >= kMaxStaticGraphPlans) {
+        static_graph_plans_.erase(static_graph_plans_.begin());
+      }
+      static_graph_plans_.push_back(std::move(topology));
+    }
+  }
+
   compute_dependencies(graph_root.get(), *graph_task);
 
   if (!outputs.empty()) {
@@ -906,6 +1201,11 @@ std::shared_ptr<FutureVariableList> Engine::execute_with_graph_task(
     // The owning thread start to drive the engine execution with the GraphTask
     // that has already been pushed to the current CPU thread's ready_queue
     lock.unlock();
+    // See Note [Multithreaded CPU backward]
+    for (int i = 0; i < graph_task->num_cpu_workers_; ++i) {
+      add_thread_pool_task(graph_task);
+    }
+    LocalReadyQueueGuard queue_guard(graph_task->cpu_ready_queue_);
     thread_main(graph_task);
     TORCH_INTERNAL_ASSERT(graph_task->future_result_->completed());
     // reset the worker_device after the completion of the graph_task, this is so
@@ -932,7 +1232,10 @@ std::shared_ptr<FutureVariableList> Engine::execute_with_graph_task(
       // complete!
       ++current_depth;
       lock.unlock();
-      thread_main(graph_task);
+      {
+        LocalReadyQueueGuard queue_guard(graph_task->cpu_ready_queue_);
+        thread_main(graph_task);
+      }
       --current_depth;
       --total_depth;
 
@@ -10,6 +10,7 @@
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/autograd/input_buffer.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
 #include <torch/csrc/utils/future.h>
 
 #include <deque>
@@ -128,6 +129,9 @@ struct GraphTask: std::enable_shared_from_this<GraphTask> {
   bool completed();
   // mark the graph task as completed and trigger post processing
   void mark_as_completed_and_run_post_processing();
+  // wake up every thread that may be sleeping on cpu_ready_queue_ so that it
+  // notices the completion of this graph task
+  void wake_cpu_workers();
 
   // Set an appropriate exception on this graph_task which was encountered while
   // running the provided function.
@@ -151,6 +155,14 @@ struct GraphTask: std::enable_shared_from_this<GraphTask> {
   // and but next NodeTask should be run on CPU.
   std::shared_ptr<ReadyQueue> cpu_ready_queue_;
 
+  // Number of threads, besides the owning thread, draining cpu_ready_queue_.
+  // Zero unless the engine runs CPU tasks on several threads, see
+  // Note [Multithreaded CPU backward]. Safe to read without synchronization.
+  int num_cpu_workers_ = 0;
+  // Whether the waiting CPU worker threads have been woken up after the
+  // completion of this graph task
+  std::atomic_bool cpu_workers_woken_{false};
+
   // Future representing the completion of the graph task. Notified when all
   // tasks are done.
   std::shared_ptr<FutureVariableList> future_result_;
@@ -255,6 +267,10 @@ struct ReadyQueue {
   size_t size() const;
 };
 
+// Cached topology and execution order of a backward graph, see
+// Note [Static graph replay]
+struct StaticGraphPlan;
+
 // A single instance of this struct should be created through the whole process lifetime.
 // The worker thread creation logic and Engine's destructor rely on this.
 struct TORCH_API Engine {
@@ -285,10 +301,27 @@ struct TORCH_API Engine {
       const std::shared_ptr<GraphTask>& graph_task,
       std::shared_ptr<Node> graph_root);
 
+  // Number of threads that run the CPU tasks of a backward call, including
+  // the calling thread. Defaults to 1, i.e. the calling thread alone.
+  // See Note [Multithreaded CPU backward]
+  void set_num_cpu_threads(int num_threads);
+  int num_cpu_threads() const;
+
+  // Whether the graphs of backward calls are cached and replayed when their
+  // topology doesn't change. See Note [Static graph replay]
+  void set_static_graph(bool enabled);
+  bool is_static_graph() const;
+
   virtual std::unique_ptr<AnomalyMetadata> make_anomaly_metadata() {
     return nullptr;
   }
 
+  // Hooks for a tensor about to be saved for backward, see SavedVariableHooks.
+  // Returns nullptr if the saved tensor should be kept as is.
+  virtual std::unique_ptr<SavedVariableHooks> get_default_saved_variable_hooks() {
+    return nullptr;
+  }
+
   // We pass cpu_ready_queue to evaluate_function, so that it knows
   // the correct ready queue to push to after a NodeTask is ready
   void evaluate_function(
@@ -322,6 +355,13 @@ struct TORCH_API Engine {
   Engine();
   void compute_dependencies(Node* root, GraphTask& task);
 
+  // Runs a backward call on the current thread without the ready queues, in
+  // the order of `plan`. nodes[i] is the i-th node of the topology of `plan`.
+  void execute_static_graph(
+      const std::shared_ptr<GraphTask>& graph_task,
+      const std::vector<Node*>& nodes,
+      const StaticGraphPlan& plan);
+
   // initialize the thread local ready queue with the ready queue that is created
   // elsewhere (i.e. thread_init, Engine::execute, etc), or create a new
   // ready queue if ready_queue is not provided.
@@ -354,6 +394,15 @@ struct TORCH_API Engine {
   // How many nested reentrant calls are allowed until a new thread is used
   int max_recursion_depth_;
 
+  // See set_num_cpu_threads
+  std::atomic<int> num_cpu_threads_{1};
+
+  // See set_static_graph
+  std::atomic<bool> static_graph_{false};
+  // Most recently recorded last, protected by static_graph_plans_mutex_
+  std::vector<std::shared_ptr<StaticGraphPlan>> static_graph_plans_;
+  std::mutex static_graph_plans_mutex_;
+
   struct ThreadPoolShared {
     // Data structures used by the threads for executing reentrant backwards
     // tasks. See Note [Reentrant backwards]
@@ -40,6 +40,78 @@ static void gatherFunctions(
   }
 }
 
+namespace {
+
+// Node sizes are rounded up to a multiple of kNodeSizeGranularity, and each
+// rounded size up to kMaxPooledNodeSize has its own free list of at most
+// kMaxPooledNodesPerSize blocks. The cap bounds the memory kept by threads
+// that mostly delete nodes created elsewhere, e.g. autograd device threads.
+constexpr size_t kNodeSizeGranularity = 16;
+constexpr size_t kMaxPooledNodeSize = 512;
+constexpr size_t kMaxPooledNodesPerSize = 1024;
+
+// Stays readable once NodeFreeLists is destroyed at thread exit, since it is
+// trivially destructible. Nodes may still be created or deleted then, e.g.
+// by the destructors of other thread locals.
+enum class FreeListsState : uint8_t { Uninitialized, Alive, Destroyed };
+thread_local FreeListsState node_free_lists_state = FreeListsState::Uninitialized;
+
+struct NodeFreeLists {
+  NodeFreeLists() {
+    node_free_lists_state = FreeListsState::Alive;
+  }
+  ~NodeFreeLists() {
+    node_free_lists_state = FreeListsState::Destroyed;
+    for (auto& list : lists) {
+      for (void* block : list) {
+        ::operator delete(block);
+      }
+    }
+  }
+  std::vector<void*> lists[kMaxPooledNodeSize / kNodeSizeGranularity];
+};
+
+thread_local NodeFreeLists node_free_lists;
+
+inline size_t node_size_class(size_t size) {
+  return (size + kNodeSizeGranularity - 1) / kNodeSizeGranularity - 1;
+}
+
+} // namespace
+
+void* Node::operator new(size_t size) {
+  if (size > kMaxPooledNodeSize) {
+    return ::operator new(size);
+  }
+  const auto size_class = node_size_class(size);
+  if (node_free_lists_state == FreeListsState::Destroyed) {
+    return ::operator new((size_class + 1) * kNodeSizeGranularity);
+  }
+  auto& list = node_free_lists.lists[size_class];
+  if (!list.empty()) {
+    void* block = list.back();
+    list.pop_back();
+    return block;
+  }
+  return ::operator new((size_class + 1) * kNodeSizeGranularity);
+}
+
+void Node::operator delete(void* ptr, size_t size) noexcept {
+  // Threads that never created a node don't get free lists
+  if (size <= kMaxPooledNodeSize && node_free_lists_state == FreeListsState::Alive) {
+    auto& list = node_free_lists.lists[node_size_class(size)];
+    if (list.size() < kMaxPooledNodesPerSize) {
+      try {
+        list.push_back(ptr);
+        return;
+      } catch (...) {
+        // Out of memory: just release the block
+      }
+    }
+  }
+  ::operator delete(ptr);
+}
+
 /*
   * Fix for #5534: prevent stack overflow on deletion of deep computation graph
   *
@@ -110,6 +110,16 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   Node& operator=(Node&& other) = delete;
   virtual ~Node() = default;
 
+  /// A node is allocated for every differentiable operation, so nodes come
+  /// from thread local free lists of recently deleted nodes of the same size
+  /// rather than straight from the system allocator.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size) noexcept;
+  static void* operator new(size_t size, void* ptr) noexcept {
+    return ptr;
+  }
+  static void operator delete(void* ptr, void* place) noexcept {}
+
   /// Evaluates the function on the given inputs and returns the result of the
   /// function call.
   variable_list operator()(variable_list&& inputs) {
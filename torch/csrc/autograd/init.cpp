@@ -6,6 +6,8 @@
 #include <ATen/autocast_mode.h>
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/autograd/python_function.h>
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
+#include <torch/csrc/autograd/utils/grad_layout_contract.h>
 #include <torch/csrc/autograd/function.h>
 
 PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
@@ -34,10 +36,12 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .value("Disabled", ProfilerState::Disabled)
       .value("CPU", ProfilerState::CPU)
       .value("CUDA", ProfilerState::CUDA)
-      .value("NVTX", ProfilerState::NVTX);
+      .value("NVTX", ProfilerState::NVTX)
+      .value("CUPTI", ProfilerState::CUPTI);
 
   py::class_<ProfilerConfig>(m, "ProfilerConfig")
-      .def(py::init<ProfilerState, bool, bool>());
+      .def(py::init<ProfilerState, bool, bool>())
+      .def(py::init<ProfilerState, bool, bool, std::string>());
 
   py::class_<Event>(m, "ProfilerEvent")
       .def("kind", &Event::kind)
@@ -45,11 +49,14 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .def("thread_id", &Event::thread_id)
       .def("device", &Event::device)
       .def("cpu_elapsed_us", &Event::cpu_elapsed_us)
+      .def("activity_duration_us", &Event::activity_duration_us)
+      .def("stream", &Event::stream)
       .def("cuda_elapsed_us", &Event::cuda_elapsed_us)
       .def("has_cuda", &Event::has_cuda)
       .def("shapes", &Event::shapes)
       .def("cpu_memory_usage", &Event::cpu_memory_usage)
       .def("cuda_memory_usage", &Event::cuda_memory_usage)
+      .def("total_allocated", &Event::total_allocated)
       .def("handle", &Event::handle)
       .def("node_id", &Event::node_id)
       .def("is_remote", &Event::isRemote);
@@ -57,6 +64,38 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
   m.def("_enable_profiler", enableProfiler);
   m.def("_disable_profiler", disableProfiler);
   m.def("_profiler_enabled", profilerEnabled);
+  m.def("_enable_sampled_profiler", [](double sampling_prob, py::function sink, size_t batch_size) {
+    // The sink may be released from any thread
+    std::shared_ptr<py::function> sink_ptr(
+        new py::function(std::move(sink)), [](py::function* fn) {
+          pybind11::gil_scoped_acquire gil;
+          delete fn;
+        });
+    enableSampledProfiler(
+        sampling_prob,
+        [sink_ptr](std::vector<SampledEvent>&& events) {
+          static const char* scope_names[] = {"function", "torchscript_function", "user_scope"};
+          static_assert(
+              sizeof(scope_names) / sizeof(scope_names[0]) == static_cast<size_t>(at::RecordScope::NUM_SCOPES),
+              "Expected a name for each RecordScope");
+          pybind11::gil_scoped_acquire gil;
+          py::list batch(events.size());
+          for (size_t i = 0; i < events.size(); ++i) {
+            const auto& evt = events[i];
+            batch[i] = py::make_tuple(
+                evt.name,
+                scope_names[static_cast<size_t>(evt.scope)],
+                evt.thread_id,
+                evt.sequence_nr,
+                evt.start_ns / 1000.0,
+                evt.duration_ns / 1000.0);
+          }
+          (*sink_ptr)(batch);
+        },
+        batch_size);
+  });
+  m.def("_disable_sampled_profiler", disableSampledProfiler);
+  m.def("_sampled_profiler_enabled", sampledProfilerEnabled);
   m.def("_enable_record_function", [](bool enable) {
     at::enableRecordFunction(enable);
   });
@@ -76,6 +115,14 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
     at::clearCallbacks();
   });
 
+  m.def("_push_saved_tensors_default_hooks", [](py::function& pack_hook, py::function& unpack_hook) {
+    torch::autograd::PyDefaultSavedVariableHooks::push_hooks(pack_hook, unpack_hook);
+  });
+  m.def("_pop_saved_tensors_default_hooks", []() {
+    torch::autograd::PyDefaultSavedVariableHooks::pop_hooks();
+  });
+  m.def("_grad_view_obey_contract", &torch::autograd::utils::view_obey_contract);
+
   Py_RETURN_TRUE;
 }
 
@@ -101,6 +148,26 @@ static PyObject * is_autocast_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_cpu_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (at::autocast::is_cpu_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * clear_autocast_cache(PyObject* _unused, PyObject *arg) {
   HANDLE_TH_ERRORS
   at::autocast::clear_cache();
@@ -166,6 +233,8 @@ static PyMethodDef methods[] = { // NOLINT
   {"is_grad_enabled", (PyCFunction)is_grad_enabled, METH_NOARGS, nullptr},
   {"set_autocast_enabled", (PyCFunction)set_autocast_enabled, METH_O, nullptr},
   {"is_autocast_enabled", (PyCFunction)is_autocast_enabled, METH_NOARGS, nullptr},
+  {"set_autocast_cpu_enabled", (PyCFunction)set_autocast_cpu_enabled, METH_O, nullptr},
+  {"is_autocast_cpu_enabled", (PyCFunction)is_autocast_cpu_enabled, METH_NOARGS, nullptr},
   {"clear_autocast_cache", (PyCFunction)clear_autocast_cache, METH_NOARGS, nullptr},
   {"autocast_increment_nesting", (PyCFunction)autocast_increment_nesting, METH_NOARGS, nullptr},
   {"autocast_decrement_nesting", (PyCFunction)autocast_decrement_nesting, METH_NOARGS, nullptr},
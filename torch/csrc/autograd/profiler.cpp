@@ -7,7 +7,11 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <torch/library.h>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <iomanip>
+#include <limits>
 #include <list>
 #include <mutex>
 #include <sstream>
@@ -36,6 +40,9 @@ namespace {
     CUDA_MEM_USAGE,
     CUDA_DEVICE,
     CUDA_US,
+    TOTAL_ALLOCATED,
+    ACTIVITY_DURATION_NS,
+    STREAM,
     NUM_EVENT_IVALUE_IDX // must be last in list
   };
 
@@ -142,12 +149,127 @@ static CUDAStubs* cuda_stubs = default_stubs_addr;
 //  - save profiling events into the profiling state
 //
 
+// Writes the events of a profiling run to a chrome trace file as they are
+// recorded (see ProfilerConfig::trace_path). The events are formatted into an
+// in-memory chunk, which is appended to the file once it reaches kChunkSize,
+// so that neither the events nor the whole trace are held in memory.
+class ChromeTraceWriter {
+ public:
+  ChromeTraceWriter(const std::string& path, int64_t start_ns)
+    : out_(path), start_ns_(start_ns) {
+    TORCH_CHECK(out_, "Could not open ", path, " to write the profiler trace");
+    chunk_ << std::fixed << std::setprecision(3) << "[";
+  }
+
+  ~ChromeTraceWriter() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    chunk_ << "\n]\n";
+    flush();
+  }
+
+  void beginRange(
+      const char* name,
+      uint64_t thread_id,
+      at::RecordFunctionHandle handle,
+      int64_t ns) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    nextEvent();
+    chunk_ << "{\"name\": ";
+    writeString(name);
+    chunk_ << ", \"ph\": \"B\", \"ts\": " << us(ns)
+           << ", \"pid\": \"CPU Functions\", \"tid\": " << thread_id
+           << ", \"args\": {\"handle\": " << handle << "}}";
+    maybeFlush();
+  }
+
+  void endRange(uint64_t thread_id, int64_t ns) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    nextEvent();
+    chunk_ << "{\"ph\": \"E\", \"ts\": " << us(ns)
+           << ", \"pid\": \"CPU Functions\", \"tid\": " << thread_id << "}";
+    maybeFlush();
+  }
+
+  void memory(const char* device_type, int64_t total_allocated, int64_t ns) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    nextEvent();
+    chunk_ << "{\"name\": \"" << device_type << " Memory\", \"ph\": \"C\", \"ts\": "
+           << us(ns) << ", \"pid\": \"CPU Functions\""
+           << ", \"args\": {\"Total Allocated\": " << total_allocated << "}}";
+    maybeFlush();
+  }
+
+  void activities(const std::vector<GPUActivity>& activities) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (const auto& activity : activities) {
+      nextEvent();
+      chunk_ << "{\"name\": ";
+      writeString(activity.name.c_str());
+      chunk_ << ", \"ph\": \"X\", \"ts\": " << us(activity.start_ns)
+             << ", \"dur\": " << (activity.end_ns - activity.start_ns) / 1000.0
+             << ", \"pid\": \"CUDA device " << activity.device
+             << "\", \"tid\": \"stream " << activity.stream
+             << "\", \"args\": {\"handle\": " << activity.correlation_id << "}}";
+    }
+    maybeFlush();
+  }
+
+ private:
+  static constexpr std::streamoff kChunkSize = 1 << 20;
+
+  double us(int64_t ns) const {
+    return (ns - start_ns_) / 1000.0;
+  }
+
+  void nextEvent() {
+    if (!first_) {
+      chunk_ << ",";
+    }
+    first_ = false;
+    chunk_ << "\n";
+  }
+
+  void writeString(const char* str) {
+    chunk_ << '"';
+    for (; *str; ++str) {
+      if (*str == '"' || *str == '\\') {
+        chunk_ << '\\';
+      }
+      chunk_ << *str;
+    }
+    chunk_ << '"';
+  }
+
+  void maybeFlush() {
+    if (chunk_.tellp() >= kChunkSize) {
+      flush();
+    }
+  }
+
+  void flush() {
+    out_ << chunk_.str();
+    out_.flush();
+    chunk_.str("");
+  }
+
+  // Also serializes the writes to the file, which keeps the events in order
+  std::mutex mutex_;
+  std::ofstream out_;
+  std::ostringstream chunk_;
+  bool first_ = true;
+  const int64_t start_ns_;
+};
+
 // Profiler state
 struct ProfilerThreadLocalState
     : public c10::MemoryReportingInfoBase {
   explicit ProfilerThreadLocalState(
       const ProfilerConfig& config)
-    : config_(config), remoteProfiledEvents_{c10::nullopt} {}
+    : config_(config), remoteProfiledEvents_{c10::nullopt} {
+    if (!config_.trace_path.empty()) {
+      trace_writer_ = std::make_unique<ChromeTraceWriter>(config_.trace_path, getTime());
+    }
+  }
   ~ProfilerThreadLocalState() override = default;
 
   inline const ProfilerConfig& config() const {
@@ -161,6 +283,9 @@ struct ProfilerThreadLocalState
       auto& list = kv.second;
       result.emplace_back(list->consolidate());
     }
+    if (!activities_.empty()) {
+      result.emplace_back(std::move(activities_));
+    }
     // Consolidate remote events if applicable as well.
     if (remoteProfiledEvents_) {
       result.insert(
@@ -210,9 +335,15 @@ struct ProfilerThreadLocalState
     if (config_.state == ProfilerState::Disabled) {
       return;
     }
+    if (config_.state == ProfilerState::CUPTI) {
+      cuda_stubs->pushCorrelationId(handle);
+    }
     if (config_.state == ProfilerState::NVTX) {
       cuda_stubs->nvtxRangePushA(getNvtxStr(
           name, msg, sequence_nr, shapes).c_str());
+    } else if (trace_writer_) {
+      trace_writer_->beginRange(
+          name.str(), at::RecordFunction::currentThreadId(), handle, getTime());
     } else {
       getEventList().record(
           EventKind::PushRange,
@@ -229,8 +360,15 @@ struct ProfilerThreadLocalState
     if (config_.state == ProfilerState::Disabled) {
       return;
     }
+    if (config_.state == ProfilerState::CUPTI &&
+        thread_id == at::RecordFunction::currentThreadId()) {
+      // Otherwise the id was pushed on another thread
+      cuda_stubs->popCorrelationId();
+    }
     if (config_.state == ProfilerState::NVTX) {
       cuda_stubs->nvtxRangePop();
+    } else if (trace_writer_) {
+      trace_writer_->endRange(thread_id, getTime());
     } else {
       // In some cases RecordFunction (and popRange) may be
       // called on a different thread than pushRange
@@ -258,12 +396,22 @@ struct ProfilerThreadLocalState
       void* /* unused */, int64_t alloc_size, c10::Device device) override {
     if (config_.profile_memory && config_.state != ProfilerState::Disabled) {
       uint64_t thread_id = at::RecordFunction::currentThreadId();
+      bool is_cuda = device.type() == c10::DeviceType::CUDA ||
+          device.type() == c10::DeviceType::HIP;
+      // Lets the allocations be shown as a timeline, and the peaks computed
+      auto& total = is_cuda ? cuda_allocated_ : cpu_allocated_;
+      auto total_allocated = total.fetch_add(alloc_size) + alloc_size;
+      if (trace_writer_) {
+        trace_writer_->memory(is_cuda ? "CUDA" : "CPU", total_allocated, getTime());
+        return;
+      }
       Event evt(
           EventKind::MemoryAlloc,
           at::StringView(""),
           thread_id,
           config_.state == ProfilerState::CUDA);
       evt.updateMemoryStats(alloc_size, device);
+      evt.setTotalAllocated(total_allocated);
       getEventList(thread_id).record(std::move(evt));
     }
   }
@@ -272,6 +420,25 @@ struct ProfilerThreadLocalState
     return config_.profile_memory;
   }
 
+  // Sink of the CUPTI tracer
+  void recordGPUActivities(std::vector<GPUActivity>&& activities) {
+    if (trace_writer_) {
+      trace_writer_->activities(activities);
+      return;
+    }
+    // Attributed to a thread id that no range uses
+    auto thread_id = std::numeric_limits<uint16_t>::max();
+    std::lock_guard<std::mutex> guard(state_mutex_);
+    for (const auto& activity : activities) {
+      activities_.emplace_back(activity, thread_id);
+    }
+  }
+
+  // Writes the end of the trace, if streamed
+  void closeTrace() {
+    trace_writer_.reset();
+  }
+
  private:
   std::string getNvtxStr(
       const at::StringView& name,
@@ -334,6 +501,11 @@ struct ProfilerThreadLocalState
   ProfilerConfig config_ = ProfilerConfig(ProfilerState::Disabled, false, false);
   at::CallbackHandle handle_ = 0;
   c10::optional<std::vector<std::vector<Event>>> remoteProfiledEvents_;
+  // Memory allocated since the profiler was enabled, see reportMemoryUsage
+  std::atomic<int64_t> cpu_allocated_ {0};
+  std::atomic<int64_t> cuda_allocated_ {0};
+  std::vector<Event> activities_;
+  std::unique_ptr<ChromeTraceWriter> trace_writer_;
 };
 
 ProfilerThreadLocalState* getProfilerTLSState() {
@@ -385,6 +557,115 @@ void pushProfilingCallbacks() {
   state_ptr->setCallbackHandle(handle);
 }
 
+// State of the sampled profiler (see enableSampledProfiler in profiler.h),
+// shared with its callbacks.
+struct SampledProfilerState {
+  // Touched by the owning thread only, but for the events, which the other
+  // threads flush when the profiler is disabled.
+  struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<SampledEvent> events;
+    // (handle, start time) of the picked ranges that are running on this
+    // thread, innermost last
+    std::vector<std::pair<at::RecordFunctionHandle, int64_t>> open_ranges;
+  };
+
+  SampledProfilerState(SampledEventsSink sink, size_t batch_size)
+    : id_(nextId()), sink_(std::move(sink)), batch_size_(batch_size) {}
+
+  ThreadBuffer& threadBuffer() {
+    thread_local uint64_t owner_id = 0;
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (owner_id != id_) {
+      // First event of this thread since the profiler was enabled
+      buffer = std::make_shared<ThreadBuffer>();
+      buffer->events.reserve(batch_size_);
+      owner_id = id_;
+      std::lock_guard<std::mutex> guard(mutex_);
+      buffers_.push_back(buffer);
+    }
+    return *buffer;
+  }
+
+  void startRange(const at::RecordFunction& fn) {
+    threadBuffer().open_ranges.emplace_back(fn.handle(), getTime());
+  }
+
+  void endRange(const at::RecordFunction& fn) {
+    auto end_ns = getTime();
+    auto& buffer = threadBuffer();
+    auto& ranges = buffer.open_ranges;
+    auto it = std::find_if(ranges.rbegin(), ranges.rend(),
+        [&fn](const std::pair<at::RecordFunctionHandle, int64_t>& range) {
+          return range.first == fn.handle();
+        });
+    if (it == ranges.rend()) {
+      // Started on another thread
+      return;
+    }
+    SampledEvent evt{
+        // The only copy of the name, for the picked ranges
+        fn.name().str(),
+        fn.scope(),
+        fn.getStartCallbacksThreadId(),
+        fn.seqNr(),
+        it->second,
+        end_ns - it->second};
+    // Also drops the inner ranges which ended on another thread
+    ranges.erase(std::next(it).base(), ranges.end());
+
+    std::vector<SampledEvent> batch;
+    {
+      std::lock_guard<std::mutex> guard(buffer.mutex);
+      buffer.events.push_back(std::move(evt));
+      if (buffer.events.size() < batch_size_) {
+        return;
+      }
+      batch.swap(buffer.events);
+      buffer.events.reserve(batch_size_);
+    }
+    sink_(std::move(batch));
+  }
+
+  void flush() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      buffers.swap(buffers_);
+    }
+    for (auto& buffer : buffers) {
+      std::vector<SampledEvent> batch;
+      {
+        std::lock_guard<std::mutex> guard(buffer->mutex);
+        batch.swap(buffer->events);
+      }
+      if (!batch.empty()) {
+        sink_(std::move(batch));
+      }
+    }
+  }
+
+  at::CallbackHandle handle_ = 0;
+
+ private:
+  static uint64_t nextId() {
+    static std::atomic<uint64_t> next_id {0};
+    return ++next_id;
+  }
+
+  // Tells apart the thread buffers of successive profiling sessions
+  const uint64_t id_;
+  SampledEventsSink sink_;
+  const size_t batch_size_;
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+};
+
+std::shared_ptr<SampledProfilerState>& sampledProfilerState() {
+  static std::shared_ptr<SampledProfilerState> state;
+  return state;
+}
+
 const int kCUDAWarmupStart = 5;
 
 // temp. workaround for dispatcher ::Profiler key
@@ -441,6 +722,11 @@ bool profilerEnabled() {
 void enableProfiler(const ProfilerConfig& new_config) {
   TORCH_CHECK(new_config.state != ProfilerState::NVTX || cuda_stubs->enabled(),
     "Can't use NVTX profiler - PyTorch was compiled without CUDA");
+  TORCH_CHECK(new_config.state != ProfilerState::CUPTI || cuda_stubs->activityTracingEnabled(),
+    "Can't use CUPTI profiler - PyTorch was compiled without CUPTI");
+  TORCH_CHECK(new_config.trace_path.empty() ||
+      new_config.state == ProfilerState::CPU || new_config.state == ProfilerState::CUPTI,
+    "Only the CPU and CUPTI profilers can stream a trace");
 
   auto state_ptr = getProfilerTLSState();
   TORCH_CHECK(!state_ptr, "Profiler is already enabled on this thread");
@@ -468,6 +754,11 @@ void enableProfiler(const ProfilerConfig& new_config) {
         state->mark("__cuda_start_event");
     });
   }
+  if (new_config.state == ProfilerState::CUPTI) {
+    cuda_stubs->enableActivityTracing([state](std::vector<GPUActivity>&& activities) {
+      state->recordGPUActivities(std::move(activities));
+    });
+  }
   state->mark("__start_profile", false);
 }
 
@@ -485,6 +776,12 @@ thread_event_lists disableProfiler() {
     return thread_event_lists();
   }
 
+  if (state_ptr->config().state == ProfilerState::CUPTI) {
+    // The activities are only recorded once done
+    cuda_stubs->synchronize();
+    cuda_stubs->disableActivityTracing();
+  }
+  state_ptr->closeTrace();
   state_ptr->mark("__stop_profile");
 
   return state_ptr->consolidate();
@@ -496,6 +793,42 @@ void addEventList(std::vector<Event>&& profiledEvents) {
   state_ptr->setOrAddRemoteProfiledEvents(std::move(profiledEvents));
 }
 
+void enableSampledProfiler(
+    double sampling_prob,
+    SampledEventsSink sink,
+    size_t batch_size) {
+  auto& state = sampledProfilerState();
+  TORCH_CHECK(!state, "Sampled profiler is already enabled");
+  TORCH_CHECK(sampling_prob > 0.0 && sampling_prob <= 1.0,
+      "Expected a sampling probability in (0, 1], got ", sampling_prob);
+  TORCH_CHECK(batch_size > 0, "Expected a positive batch size");
+  TORCH_CHECK(sink, "Expected a sink for the sampled events");
+
+  auto new_state = std::make_shared<SampledProfilerState>(std::move(sink), batch_size);
+  new_state->handle_ = at::addGlobalCallback(at::RecordFunctionCallback(
+      [new_state](const at::RecordFunction& fn) {
+        new_state->startRange(fn);
+      },
+      [new_state](const at::RecordFunction& fn) {
+        new_state->endRange(fn);
+      })
+    .samplingProb(sampling_prob)
+    .needsIds(true));
+  state = std::move(new_state);
+}
+
+void disableSampledProfiler() {
+  auto& state = sampledProfilerState();
+  TORCH_CHECK(state, "Can't disable sampled profiler when it's not running");
+  at::removeCallback(state->handle_);
+  auto old_state = std::move(state);
+  old_state->flush();
+}
+
+bool sampledProfilerEnabled() {
+  return sampledProfilerState() != nullptr;
+}
+
 void Event::record(bool record_cuda) {
   if (record_cuda) {
     cuda_stubs->record(&device_, &cuda_event, &cpu_ns_);
@@ -530,7 +863,10 @@ void Event::record(bool record_cuda) {
       ivalues.get(EventIValueIdx::CUDA_RECORDED).toBool(), // was cuda recorded
       ivalues.get(EventIValueIdx::CUDA_MEM_USAGE).toInt(), // cuda memory usage
       ivalues.get(EventIValueIdx::CUDA_DEVICE).toInt(), // device
-      ivalues.get(EventIValueIdx::CUDA_US).toInt() // cuda_us
+      ivalues.get(EventIValueIdx::CUDA_US).toInt(), // cuda_us
+      ivalues.get(EventIValueIdx::TOTAL_ALLOCATED).toInt(), // total_allocated
+      ivalues.get(EventIValueIdx::ACTIVITY_DURATION_NS).toInt(), // activity_duration_ns
+      ivalues.get(EventIValueIdx::STREAM).toInt() // stream
   );
   return evt;
 }
@@ -551,6 +887,9 @@ at::IValue Event::toIValue() const {
   eventIValueList.emplace_back(static_cast<int64_t>(cuda_memory_usage_));
   eventIValueList.emplace_back(device_);
   eventIValueList.emplace_back(cuda_us_);
+  eventIValueList.emplace_back(total_allocated_);
+  eventIValueList.emplace_back(activity_duration_ns_);
+  eventIValueList.emplace_back(static_cast<int64_t>(stream_));
   return at::IValue(eventIValueList);
 }
 
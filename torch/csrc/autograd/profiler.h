@@ -29,6 +29,21 @@ struct Node;
 
 namespace profiler {
 
+// A kernel, memcpy or memset traced by CUPTI, see ProfilerState::CUPTI
+struct TORCH_API GPUActivity {
+  std::string name;
+  int device;
+  uint32_t stream;
+  // In the getTime() clock
+  int64_t start_ns;
+  int64_t end_ns;
+  // Handle of the innermost range running on the launching thread, 0 if none
+  at::RecordFunctionHandle correlation_id;
+};
+
+// Receives the GPU activities in batches, on a thread owned by CUPTI
+using GPUActivitySink = std::function<void(std::vector<GPUActivity>&&)>;
+
 struct TORCH_API CUDAStubs {
   virtual void record(int* device, CUDAEventStub* event, int64_t* cpu_ns) {
     fail();
@@ -55,6 +70,25 @@ struct TORCH_API CUDAStubs {
   virtual void synchronize() {
     fail();
   }
+  // CUPTI activity tracing, only available when built with USE_CUPTI.
+  virtual bool activityTracingEnabled() {
+    return false;
+  }
+  virtual void enableActivityTracing(GPUActivitySink sink) {
+    fail();
+  }
+  // Flushes the activities recorded so far into the sink, then releases it
+  virtual void disableActivityTracing() {
+    fail();
+  }
+  // Tags the activities launched by the current thread with `id`, until the
+  // matching pop
+  virtual void pushCorrelationId(at::RecordFunctionHandle id) {
+    fail();
+  }
+  virtual void popCorrelationId() {
+    fail();
+  }
   virtual ~CUDAStubs();
 
 private:
@@ -99,20 +133,27 @@ enum class TORCH_API ProfilerState {
     CPU, // CPU-only profiling
     CUDA, // CPU + CUDA events
     NVTX,  // only emit NVTX markers
+    CUPTI, // CPU events + CUDA kernel, memcpy and memset activities
 };
 
 struct TORCH_API ProfilerConfig {
   ProfilerConfig(
       ProfilerState state,
       bool report_input_shapes,
-      bool profile_memory)
+      bool profile_memory,
+      std::string trace_path = "")
       : state(state),
         report_input_shapes(report_input_shapes),
-        profile_memory(profile_memory) {}
+        profile_memory(profile_memory),
+        trace_path(std::move(trace_path)) {}
   ~ProfilerConfig();
   ProfilerState state;
   bool report_input_shapes;
   bool profile_memory;
+  // If set, the ranges, memory events and GPU activities are streamed to this
+  // file as a chrome trace instead of being returned by disableProfiler. Not
+  // serialized: a remote profiler returns its events.
+  std::string trace_path;
 
   // Returns IValues corresponding to ProfilerConfig struct, to be used for
   // serialization.
@@ -128,6 +169,7 @@ enum class TORCH_API EventKind : uint16_t {
   PushRange,
   PopRange,
   MemoryAlloc,
+  GPUActivity,
 };
 #ifndef _MSC_VER
 #  pragma GCC diagnostic pop
@@ -165,7 +207,10 @@ struct TORCH_API Event final {
       bool cuda_recorded,
       int64_t cuda_memory_usage = 0,
       int device = -1,
-      double cuda_us = -1)
+      double cuda_us = -1,
+      int64_t total_allocated = 0,
+      int64_t activity_duration_ns = 0,
+      uint32_t stream = 0)
       : cpu_ns_(cpu_ns),
         name_(std::move(name)),
         kind_(kind),
@@ -177,7 +222,10 @@ struct TORCH_API Event final {
         device_(device),
         node_id_(node_id),
         is_remote_(is_remote),
-        cuda_us_(cuda_us) {
+        cuda_us_(cuda_us),
+        total_allocated_(total_allocated),
+        activity_duration_ns_(activity_duration_ns),
+        stream_(stream) {
     // Sanity check values that were deserialized
     TORCH_INTERNAL_ASSERT(cpu_ns_ > 0);
     if (cuda_recorded) {
@@ -186,6 +234,18 @@ struct TORCH_API Event final {
     }
   }
 
+  // Constructor of the GPUActivity events, handle() being the correlation id
+  Event(const GPUActivity& activity, uint16_t thread_id)
+      : cpu_ns_(activity.start_ns),
+        name_(activity.name),
+        kind_(EventKind::GPUActivity),
+        thread_id_(thread_id),
+        handle_(activity.correlation_id),
+        device_(activity.device),
+        node_id_(at::RecordFunction::getDefaultNodeId()),
+        activity_duration_ns_(activity.end_ns - activity.start_ns),
+        stream_(activity.stream) {}
+
   // Returns IValues corresponding to event structure, to be used for
   // serialization.
   at::IValue toIValue() const;
@@ -200,6 +260,7 @@ struct TORCH_API Event final {
       case EventKind::PushRange: return "push";
       case EventKind::PopRange: return "pop";
       case EventKind::MemoryAlloc: return "memory_alloc";
+      case EventKind::GPUActivity: return "gpu_activity";
     }
     throw std::runtime_error("unknown EventKind");
   }
@@ -255,6 +316,26 @@ struct TORCH_API Event final {
     return cuda_memory_usage_;
   }
 
+  // For MemoryAlloc events, the memory allocated on the device type (CPU or
+  // CUDA) of the allocation right after it, counting from the start of the
+  // profiler; can be negative if memory allocated before is freed.
+  int64_t total_allocated() const {
+    return total_allocated_;
+  }
+
+  void setTotalAllocated(int64_t total_allocated) {
+    total_allocated_ = total_allocated;
+  }
+
+  // For GPUActivity events, which start at cpu_us()
+  double activity_duration_us() const {
+    return activity_duration_ns_ / (1000.0);
+  }
+
+  uint32_t stream() const {
+    return stream_;
+  }
+
   at::RecordFunctionHandle handle() const {
     return handle_;
   }
@@ -296,6 +377,9 @@ private:
   int node_id_ = 0;
   bool is_remote_ = false;
   int64_t cuda_us_ = -1;
+  int64_t total_allocated_ = 0;
+  int64_t activity_duration_ns_ = 0;
+  uint32_t stream_ = 0;
 };
 
 // a linked-list of fixed sized vectors, to avoid
@@ -398,5 +482,42 @@ struct TORCH_API TLSProfilerGuard {
   c10::optional<std::function<void(const thread_event_lists&)>> cb_;
 };
 
+// Sampled profiler: a process wide, low overhead profiling mode meant to stay
+// enabled in production. Every RecordFunction range is picked with
+// probability sampling_prob by a cheap thread local coin flip; ranges that are
+// not picked don't run any profiler code, in particular their names are not
+// copied. Picked ranges are timed on the CPU and buffered per thread, and each
+// full batch of batch_size events is handed to the sink on the thread that
+// filled it, so that the events can be streamed out (e.g. aggregated into
+// metrics) while the profiler keeps running.
+//
+// Usage:
+//   enableSampledProfiler(0.001, [](std::vector<SampledEvent>&& events) {
+//     // export events
+//   });
+//   ...
+//   disableSampledProfiler(); // flushes the partial batches
+//
+// Ranges ending on another thread than the one they started on are dropped.
+// Like addGlobalCallback, enabling and disabling is not thread safe.
+struct TORCH_API SampledEvent {
+  std::string name;
+  at::RecordScope scope;
+  uint64_t thread_id;
+  int64_t sequence_nr;
+  // CPU time, in ns; see getTime
+  int64_t start_ns;
+  int64_t duration_ns;
+};
+
+using SampledEventsSink = std::function<void(std::vector<SampledEvent>&&)>;
+
+TORCH_API void enableSampledProfiler(
+    double sampling_prob,
+    SampledEventsSink sink,
+    size_t batch_size = 1024);
+TORCH_API void disableSampledProfiler();
+TORCH_API bool sampledProfilerEnabled();
+
 } // namespace profiler
 }} // namespace torch::autograd
@@ -1,8 +1,14 @@
 #include <torch/csrc/autograd/profiler.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <nvToolsExt.h>
+#ifdef USE_CUPTI
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/Type.h>
+#include <cupti.h>
+#endif
 
 #include <sstream>
+#include <unordered_map>
 
 namespace torch { namespace autograd { namespace profiler {
 
@@ -31,6 +37,179 @@ static inline void cudaCheck(cudaError_t result, const char * file, int line) {
 }
 #define TORCH_CUDA_CHECK(result) cudaCheck(result,__FILE__,__LINE__);
 
+#ifdef USE_CUPTI
+static inline void cuptiCheck(CUptiResult result, const char * file, int line) {
+  if (result != CUPTI_SUCCESS) {
+    const char* msg = nullptr;
+    cuptiGetResultString(result, &msg);
+    std::stringstream ss;
+    ss << file << ":" << line << ": " << (msg ? msg : "unknown CUPTI error");
+    throw std::runtime_error(ss.str());
+  }
+}
+#define TORCH_CUPTI_CHECK(result) cuptiCheck(result,__FILE__,__LINE__);
+
+// Collects the kernel, memcpy and memset activity records of CUPTI.
+//
+// CUPTI fills the buffers we hand it and gives them back, from its own
+// thread, once full or flushed. The activities of a buffer are converted and
+// passed to the sink right away, so nothing accumulates here. To attribute
+// them to the profiled ranges, the ranges push their handle as an external
+// correlation id while they run: CUPTI emits, for each launch, a record
+// mapping its own correlation id to the innermost external id.
+class ActivityTracer {
+ public:
+  static ActivityTracer& get() {
+    static ActivityTracer tracer;
+    return tracer;
+  }
+
+  void enable(GPUActivitySink sink) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    TORCH_CHECK(!sink_, "CUDA activity tracing is already enabled");
+    sink_ = std::move(sink);
+    uint64_t cupti_ns;
+    TORCH_CUPTI_CHECK(cuptiGetTimestamp(&cupti_ns));
+    clock_offset_ns_ = getTime() - static_cast<int64_t>(cupti_ns);
+    TORCH_CUPTI_CHECK(cuptiActivityRegisterCallbacks(bufferRequested, bufferCompleted));
+    for (auto kind : kActivityKinds) {
+      TORCH_CUPTI_CHECK(cuptiActivityEnable(kind));
+    }
+  }
+
+  void disable() {
+    for (auto kind : kActivityKinds) {
+      TORCH_CUPTI_CHECK(cuptiActivityDisable(kind));
+    }
+    // Hands back all the buffers, synchronously
+    TORCH_CUPTI_CHECK(cuptiActivityFlushAll(CUPTI_ACTIVITY_FLAG_FLUSH_FORCED));
+    std::lock_guard<std::mutex> guard(mutex_);
+    // The launches whose correlation record never came
+    for (auto& activity : pending_) {
+      activity.second.correlation_id = 0;
+    }
+    deliver(/*keep_pending=*/false);
+    correlation_ids_.clear();
+    sink_ = nullptr;
+  }
+
+ private:
+  static constexpr size_t kBufferSize = 4 * 1024 * 1024;
+
+  static constexpr CUpti_ActivityKind kActivityKinds[] = {
+      CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL,
+      CUPTI_ACTIVITY_KIND_MEMCPY,
+      CUPTI_ACTIVITY_KIND_MEMSET,
+      CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION,
+  };
+
+  static void CUPTIAPI bufferRequested(uint8_t** buffer, size_t* size, size_t* max_num_records) {
+    // CUPTI wants 8 bytes alignment, which alloc_cpu exceeds
+    *buffer = static_cast<uint8_t*>(c10::alloc_cpu(kBufferSize));
+    *size = kBufferSize;
+    *max_num_records = 0;
+  }
+
+  static void CUPTIAPI bufferCompleted(
+      CUcontext /* unused */, uint32_t /* unused */,
+      uint8_t* buffer, size_t /* unused */, size_t valid_size) {
+    get().process(buffer, valid_size);
+    c10::free_cpu(buffer);
+  }
+
+  static const char* memcpyName(uint8_t kind) {
+    switch (kind) {
+      case CUPTI_ACTIVITY_MEMCPY_KIND_HTOD: return "Memcpy HtoD";
+      case CUPTI_ACTIVITY_MEMCPY_KIND_DTOH: return "Memcpy DtoH";
+      case CUPTI_ACTIVITY_MEMCPY_KIND_DTOD: return "Memcpy DtoD";
+      case CUPTI_ACTIVITY_MEMCPY_KIND_HTOH: return "Memcpy HtoH";
+      case CUPTI_ACTIVITY_MEMCPY_KIND_PTOP: return "Memcpy PtoP";
+      default: return "Memcpy";
+    }
+  }
+
+  void process(uint8_t* buffer, size_t valid_size) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    CUpti_Activity* record = nullptr;
+    while (cuptiActivityGetNextRecord(buffer, valid_size, &record) == CUPTI_SUCCESS) {
+      switch (record->kind) {
+        case CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION: {
+          auto r = reinterpret_cast<CUpti_ActivityExternalCorrelation*>(record);
+          correlation_ids_[r->correlationId] = r->externalId;
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL: {
+          auto r = reinterpret_cast<CUpti_ActivityKernel4*>(record);
+          add(r->correlationId, c10::demangle(r->name),
+              r->deviceId, r->streamId, r->start, r->end);
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_MEMCPY: {
+          auto r = reinterpret_cast<CUpti_ActivityMemcpy*>(record);
+          add(r->correlationId, memcpyName(r->copyKind),
+              r->deviceId, r->streamId, r->start, r->end);
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_MEMSET: {
+          auto r = reinterpret_cast<CUpti_ActivityMemset*>(record);
+          add(r->correlationId, "Memset",
+              r->deviceId, r->streamId, r->start, r->end);
+          break;
+        }
+        default:
+          break;
+      }
+    }
+    deliver(/*keep_pending=*/true);
+  }
+
+  void add(uint32_t correlation_id, std::string name, uint32_t device,
+      uint32_t stream, uint64_t start, uint64_t end) {
+    GPUActivity activity{
+        std::move(name),
+        static_cast<int>(device),
+        stream,
+        static_cast<int64_t>(start) + clock_offset_ns_,
+        static_cast<int64_t>(end) + clock_offset_ns_,
+        0};
+    pending_.emplace_back(correlation_id, std::move(activity));
+  }
+
+  // Passes the activities with a known correlation id to the sink, and the
+  // others as well unless keep_pending; expects mutex_ to be held.
+  void deliver(bool keep_pending) {
+    std::vector<GPUActivity> ready;
+    std::vector<std::pair<uint32_t, GPUActivity>> still_pending;
+    for (auto& activity : pending_) {
+      auto it = correlation_ids_.find(activity.first);
+      if (it != correlation_ids_.end()) {
+        activity.second.correlation_id = it->second;
+        correlation_ids_.erase(it);
+      } else if (keep_pending) {
+        still_pending.push_back(std::move(activity));
+        continue;
+      }
+      ready.push_back(std::move(activity.second));
+    }
+    pending_.swap(still_pending);
+    if (!ready.empty() && sink_) {
+      sink_(std::move(ready));
+    }
+  }
+
+  std::mutex mutex_;
+  GPUActivitySink sink_;
+  // getTime() - CUPTI timestamp
+  int64_t clock_offset_ns_ = 0;
+  // CUPTI correlation id -> external id, i.e. range handle
+  std::unordered_map<uint32_t, uint64_t> correlation_ids_;
+  // (CUPTI correlation id, activity) of the activities not delivered yet
+  std::vector<std::pair<uint32_t, GPUActivity>> pending_;
+};
+
+constexpr CUpti_ActivityKind ActivityTracer::kActivityKinds[];
+#endif
+
 struct CUDAMethods : public CUDAStubs {
   void record(int* device, CUDAEventStub* event, int64_t* cpu_ns) override {
     TORCH_CUDA_CHECK(cudaGetDevice(device));
@@ -73,6 +252,26 @@ struct CUDAMethods : public CUDAStubs {
   bool enabled() override {
     return true;
   }
+#ifdef USE_CUPTI
+  bool activityTracingEnabled() override {
+    return true;
+  }
+  void enableActivityTracing(GPUActivitySink sink) override {
+    ActivityTracer::get().enable(std::move(sink));
+  }
+  void disableActivityTracing() override {
+    ActivityTracer::get().disable();
+  }
+  void pushCorrelationId(at::RecordFunctionHandle id) override {
+    TORCH_CUPTI_CHECK(cuptiActivityPushExternalCorrelationId(
+        CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0, id));
+  }
+  void popCorrelationId() override {
+    uint64_t id;
+    TORCH_CUPTI_CHECK(cuptiActivityPopExternalCorrelationId(
+        CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0, &id));
+  }
+#endif
 
 };
 
@@ -8,6 +8,7 @@
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/python_anomaly_mode.h>
 #include <torch/csrc/autograd/python_function.h>
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
 #include <pybind11/pybind11.h>
 
 #ifndef _WIN32
@@ -79,6 +80,10 @@ std::unique_ptr<AnomalyMetadata> PythonEngine::make_anomaly_metadata() {
   return std::unique_ptr<AnomalyMetadata>(new PyAnomalyMetadata());
 }
 
+std::unique_ptr<SavedVariableHooks> PythonEngine::get_default_saved_variable_hooks() {
+  return PyDefaultSavedVariableHooks::get_hooks();
+}
+
 variable_list PythonEngine::execute(
     const edge_list& roots,
     const variable_list& inputs,
@@ -254,6 +259,44 @@ PyObject* THPEngine_is_checkpoint_valid(PyObject *self, PyObject *noargs) {
   END_HANDLE_TH_ERRORS
 }
 
+PyObject* THPEngine_set_num_cpu_threads(PyObject *self, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "set_num_cpu_threads expects an int, "
+          "but got %s", THPUtils_typename(arg));
+  auto& engine = python::PythonEngine::get_python_engine();
+  engine.set_num_cpu_threads(static_cast<int>(THPUtils_unpackLong(arg)));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject* THPEngine_num_cpu_threads(PyObject *self, PyObject *noargs) {
+  HANDLE_TH_ERRORS
+  auto& engine = python::PythonEngine::get_python_engine();
+  return THPUtils_packInt64(engine.num_cpu_threads());
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject* THPEngine_set_static_graph(PyObject *self, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  THPUtils_assert(PyBool_Check(arg), "set_static_graph expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  auto& engine = python::PythonEngine::get_python_engine();
+  engine.set_static_graph(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject* THPEngine_is_static_graph(PyObject *self, PyObject *noargs) {
+  HANDLE_TH_ERRORS
+  auto& engine = python::PythonEngine::get_python_engine();
+  if (engine.is_static_graph()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject *THPEngine_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 {
   return type->tp_alloc(type, 0);
@@ -263,6 +306,10 @@ static struct PyMethodDef THPEngine_methods[] = {
   {(char*)"run_backward", (PyCFunction)(void(*)(void))THPEngine_run_backward, METH_VARARGS | METH_KEYWORDS, nullptr},
   {(char*)"queue_callback", (PyCFunction)THPEngine_queue_callback, METH_O, nullptr},
   {(char*)"is_checkpoint_valid", (PyCFunction)THPEngine_is_checkpoint_valid, METH_NOARGS, nullptr},
+  {(char*)"set_num_cpu_threads", (PyCFunction)THPEngine_set_num_cpu_threads, METH_O, nullptr},
+  {(char*)"num_cpu_threads", (PyCFunction)THPEngine_num_cpu_threads, METH_NOARGS, nullptr},
+  {(char*)"set_static_graph", (PyCFunction)THPEngine_set_static_graph, METH_O, nullptr},
+  {(char*)"is_static_graph", (PyCFunction)THPEngine_is_static_graph, METH_NOARGS, nullptr},
   {nullptr}
 };
 
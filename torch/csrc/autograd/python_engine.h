@@ -30,6 +30,7 @@ struct PythonEngine : public Engine {
       std::shared_ptr<Node> graph_root) override;
 
   std::unique_ptr<AnomalyMetadata> make_anomaly_metadata() override;
+  std::unique_ptr<SavedVariableHooks> get_default_saved_variable_hooks() override;
   private:
     PythonEngine();
 };
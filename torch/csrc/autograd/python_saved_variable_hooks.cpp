@@ -0,0 +1,85 @@
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
+
+#include <torch/csrc/Exceptions.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/python_variable.h>
+#include <torch/csrc/utils/object_ptr.h>
+#include <torch/csrc/utils.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+PySavedVariableHooks::PySavedVariableHooks(PyObject* pack_hook, PyObject* unpack_hook)
+    : pack_hook_(pack_hook), unpack_hook_(unpack_hook) {
+  // The caller holds the GIL
+  Py_INCREF(pack_hook_);
+  Py_INCREF(unpack_hook_);
+}
+
+void PySavedVariableHooks::call_pack_hook(at::Tensor tensor) {
+  pybind11::gil_scoped_acquire gil;
+  // Tensors saved by the ops of the hook itself must not come back here
+  AutoGradMode no_grad(false);
+  THPObjectPtr obj(THPVariable_Wrap(std::move(tensor)));
+  THPObjectPtr packed(PyObject_CallFunctionObjArgs(pack_hook_, obj.get(), nullptr));
+  if (!packed) {
+    throw python_error();
+  }
+  data_ = packed.release();
+}
+
+at::Tensor PySavedVariableHooks::call_unpack_hook() {
+  pybind11::gil_scoped_acquire gil;
+  AutoGradMode no_grad(false);
+  TORCH_INTERNAL_ASSERT(data_);
+  THPObjectPtr res(PyObject_CallFunctionObjArgs(unpack_hook_, data_, nullptr));
+  if (!res) {
+    throw python_error();
+  }
+  TORCH_CHECK_TYPE(THPVariable_Check(res.get()),
+                   "Output of saved tensor unpack_hook expected to be a Tensor but got result of type ",
+                   THPUtils_typename(res.get()));
+  return THPVariable_Unpack(res.get());
+}
+
+PySavedVariableHooks::~PySavedVariableHooks() {
+  // If python is already dead, leak the wrapped python objects
+  if (Py_IsInitialized()) {
+    pybind11::gil_scoped_acquire gil;
+    Py_XDECREF(pack_hook_);
+    Py_XDECREF(unpack_hook_);
+    Py_XDECREF(data_);
+  }
+}
+
+namespace {
+// Owns a reference to each hook; only accessed with the GIL held, except for
+// the emptiness check in get_hooks.
+thread_local std::vector<std::pair<PyObject*, PyObject*>> default_hooks_stack;
+} // namespace
+
+void PyDefaultSavedVariableHooks::push_hooks(py::function& pack_hook, py::function& unpack_hook) {
+  default_hooks_stack.emplace_back(pack_hook.release().ptr(), unpack_hook.release().ptr());
+}
+
+void PyDefaultSavedVariableHooks::pop_hooks() {
+  TORCH_CHECK(!default_hooks_stack.empty(), "No saved tensors default hooks to pop");
+  auto hooks = default_hooks_stack.back();
+  default_hooks_stack.pop_back();
+  Py_DECREF(hooks.first);
+  Py_DECREF(hooks.second);
+}
+
+std::unique_ptr<SavedVariableHooks> PyDefaultSavedVariableHooks::get_hooks() {
+  if (default_hooks_stack.empty()) {
+    return nullptr;
+  }
+  pybind11::gil_scoped_acquire gil;
+  const auto& hooks = default_hooks_stack.back();
+  return std::unique_ptr<SavedVariableHooks>(
+      new PySavedVariableHooks(hooks.first, hooks.second));
+}
+
+}} // namespace torch::autograd
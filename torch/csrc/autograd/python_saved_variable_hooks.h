@@ -0,0 +1,36 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+#include <torch/csrc/python_headers.h>
+#include <torch/csrc/utils/pybind.h>
+
+namespace py = pybind11;
+
+namespace torch { namespace autograd {
+
+// Saved variable hooks calling a pair of Python functions: pack_hook(tensor)
+// returns any Python object, which is later given back to unpack_hook to
+// rebuild the tensor.
+struct PySavedVariableHooks : public SavedVariableHooks {
+  PySavedVariableHooks(PyObject* pack_hook, PyObject* unpack_hook);
+  void call_pack_hook(at::Tensor tensor) override;
+  at::Tensor call_unpack_hook() override;
+  ~PySavedVariableHooks() override;
+
+ private:
+  PyObject* pack_hook_;
+  PyObject* unpack_hook_;
+  PyObject* data_ = nullptr;
+};
+
+// Thread local stack of the (pack_hook, unpack_hook) pairs installed by
+// torch.autograd.graph.saved_tensors_hooks. The innermost pair applies to
+// every tensor saved for backward on this thread.
+struct PyDefaultSavedVariableHooks {
+  static void push_hooks(py::function& pack_hook, py::function& unpack_hook);
+  static void pop_hooks();
+  static std::unique_ptr<SavedVariableHooks> get_hooks();
+};
+
+}} // namespace torch::autograd
@@ -21,6 +21,7 @@
 #include <c10/core/TensorOptions.h>
 #include <ATen/core/LegacyTypeDispatch.h>
 
+#include <algorithm>
 #include <vector>
 #include <tuple>
 
@@ -197,6 +198,101 @@ static inline Variable applySlicing(
   return result;
 }
 
+// Computes the view that applySlicing would return for a tuple made only of
+// integers, slices, None and at most one Ellipsis, with a single as_strided
+// call instead of one select/slice/unsqueeze per entry. Returns false, and
+// leaves `result` alone, for any other index or for indices which are out of
+// range, so that applySlicing handles them and reports the errors.
+static inline bool applyBasicSlicing(const Variable& self, PyObject* index, Variable& result) {
+  if (self.layout() != at::kStrided || self.is_quantized() || self.has_names() ||
+      !(self.device().is_cpu() || self.is_cuda())) {
+    return false;
+  }
+  // Only plain dense tensors: wrappers such as the BatchedTensorImpl of vmap
+  // don't have strides and go through the batching rules of the per-entry ops.
+  const auto key_set = self.unsafeGetTensorImpl()->key_set();
+  if (!(key_set - c10::DispatchKeySet({c10::DispatchKey::CPU,
+                                       c10::DispatchKey::CUDA,
+                                       c10::DispatchKey::Autograd})).empty()) {
+    return false;
+  }
+  const auto size = PyTuple_GET_SIZE(index); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+  int64_t specified_dims = 0;
+  bool has_ellipsis = false;
+  for (Py_ssize_t i = 0; i < size; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(index, i); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    if (PyLong_CheckExact(obj) || PySlice_Check(obj)) {
+      specified_dims++;
+    } else if (obj == Py_Ellipsis) {
+      if (has_ellipsis) {
+        return false;
+      }
+      has_ellipsis = true;
+    } else if (obj != Py_None) {
+      return false;
+    }
+  }
+
+  const auto self_sizes = self.sizes();
+  const auto self_strides = self.strides();
+  const auto ndim = static_cast<int64_t>(self_sizes.size());
+  if (specified_dims > ndim) {
+    return false;
+  }
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides;
+  sizes.reserve(ndim + size);
+  strides.reserve(ndim + size);
+  int64_t storage_offset = self.storage_offset();
+  int64_t dim = 0;
+  for (Py_ssize_t i = 0; i < size; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(index, i); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    if (PyLong_CheckExact(obj)) {
+      int64_t idx = THPUtils_unpackLong(obj);
+      const auto dim_size = self_sizes[dim];
+      if (idx < -dim_size || idx >= dim_size) {
+        return false;
+      }
+      if (idx < 0) {
+        idx += dim_size;
+      }
+      storage_offset += idx * self_strides[dim];
+      dim++;
+    } else if (PySlice_Check(obj)) {
+      Py_ssize_t start, stop, step;
+      checkUnpackSlice(obj, &start, &stop, &step);
+      if (step <= 0) {
+        return false;
+      }
+      // Clamps the bounds the same way as at::slice.
+      const auto dim_size = self_sizes[dim];
+      int64_t begin = start < 0 ? start + dim_size : start;
+      int64_t end = stop < 0 ? stop + dim_size : stop;
+      begin = std::min(std::max<int64_t>(begin, 0), dim_size);
+      end = std::min(std::max<int64_t>(end, begin), dim_size);
+      sizes.push_back((end - begin + step - 1) / step);
+      strides.push_back(self_strides[dim] * step);
+      storage_offset += begin * self_strides[dim];
+      dim++;
+    } else if (obj == Py_Ellipsis) {
+      for (const auto end = dim + ndim - specified_dims; dim < end; dim++) {
+        sizes.push_back(self_sizes[dim]);
+        strides.push_back(self_strides[dim]);
+      }
+    } else {
+      // None, with the stride that unsqueeze would give it.
+      sizes.push_back(1);
+      strides.push_back(dim < ndim ? self_sizes[dim] * self_strides[dim] : 1);
+    }
+  }
+  for (; dim < ndim; dim++) {
+    sizes.push_back(self_sizes[dim]);
+    strides.push_back(self_strides[dim]);
+  }
+  result = self.as_strided(sizes, strides, storage_offset);
+  return true;
+}
+
 static inline bool treatSequenceAsTuple(PyObject* index) {
   if (PyTuple_Check(index)) {
     return true;
@@ -253,7 +349,11 @@ static inline THPObjectPtr wrapTuple(PyObject* index) {
 // 1. Python 1-D getter calls C++ `at::indexing::get_item` after
 // converting Python index to C++ TensorIndex.
 //
-// 2. Python N-D getter calls C++ `at::indexing::handleDimInMultiDimIndexing`
+// 2. Python N-D getter made only of integers, slices, None and Ellipsis computes
+// the resulting view with `applyBasicSlicing`, and returns it from a single
+// `as_strided` call, unless we are tracing.
+//
+// 3. Otherwise, Python N-D getter calls C++ `at::indexing::handleDimInMultiDimIndexing`
 // for each dim, after converting Python index to C++ TensorIndex. If advanced
 // indexing is needed, it calls C++ `at::indexing::dispatch_index`.
 PyObject* THPVariable_getitem(PyObject* self, PyObject* index) {
@@ -297,8 +397,14 @@ PyObject* THPVariable_getitem(PyObject* self, PyObject* index) {
   // wrap index in a tuple if it's not already one
   THPObjectPtr holder = wrapTuple(index);
 
+  // The tracer records every select and slice, so it needs applySlicing.
+  Variable sliced;
+  if (!is_tracing && applyBasicSlicing(self_, holder.get(), sliced)) {
+    return THPVariable_Wrap(std::move(sliced));
+  }
+
   variable_list variableIndices;
-  Variable sliced = applySlicing(
+  sliced = applySlicing(
     self_, holder.get(), variableIndices, /*is_tracing=*/is_tracing, self_.device(), self_.sizes());
   if (variableIndices.empty()) {
     if (sliced.is_same(self_)) {
@@ -1,6 +1,7 @@
 #include <torch/csrc/autograd/saved_variable.h>
 
 #include <torch/csrc/autograd/edge.h>
+#include <torch/csrc/autograd/engine.h>
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
@@ -33,11 +34,30 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_i
     }
     version_counter_ = impl::version_counter(variable);
     saved_version_ = version_counter_.current_version();
+
+    if (auto hooks = Engine::get_default_engine().get_default_saved_variable_hooks()) {
+      register_hooks(std::move(hooks));
+    }
   }
 }
 
-Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
+void SavedVariable::register_hooks(std::unique_ptr<SavedVariableHooks>&& hooks) {
+  TORCH_CHECK(!hooks_, "Saved variable hooks can only be registered once");
   if (!data_.defined()) {
+    if (!was_default_constructed_) {
+      throw std::runtime_error(ERR_BACKWARD_TWICE);
+    }
+    TORCH_CHECK(false, "Calling register_hooks on a saved variable holding an undefined tensor");
+  }
+  hooks_ = std::move(hooks);
+  // data_ has no autograd metadata, so the hooks can't create a reference
+  // cycle through the grad_fn of an output.
+  hooks_->call_pack_hook(std::move(data_));
+  data_.reset();
+}
+
+Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
+  if (!data_.defined() && !hooks_) {
     if (!was_default_constructed_) {
       throw std::runtime_error(ERR_BACKWARD_TWICE);
     }
@@ -54,11 +74,14 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
     grad_fn = std::move(saved_for);
   }
 
+  auto data = hooks_ ? hooks_->call_unpack_hook() : data_;
+  TORCH_CHECK(data.defined(), "The unpack hook of a saved variable returned an undefined tensor");
+
   if (saved_version_ != version_counter_.current_version()) {
     std::stringstream message;
     message << "one of the variables needed for gradient computation has been "
-        "modified by an inplace operation: [" << data_.toString() << " "
-        << data_.sizes() << "]";
+        "modified by an inplace operation: [" << data.toString() << " "
+        << data.sizes() << "]";
     if (grad_fn) {
         message << ", which is output " << output_nr_
             << " of " << grad_fn->name() << ",";
@@ -83,9 +106,9 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
   // in-place functions on unpacked variables.
   Variable var;
   if (grad_fn) {
-    var = make_variable(data_, Edge(std::move(grad_fn), output_nr_));
+    var = make_variable(std::move(data), Edge(std::move(grad_fn), output_nr_));
   } else {
-    var = make_variable(data_, requires_grad_);
+    var = make_variable(std::move(data), requires_grad_);
   }
   impl::set_version_counter(var, saved_version_);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
 
 #include <ATen/ATen.h>
 
@@ -28,7 +29,12 @@ class TORCH_API SavedVariable {
   /// circular reference.
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
+  /// Hands the saved tensor over to `hooks`. By default, the hooks returned by
+  /// `Engine::get_default_saved_variable_hooks()` at construction are used.
+  void register_hooks(std::unique_ptr<SavedVariableHooks>&& hooks);
+
   void reset_data() {
+    hooks_.reset();
     return data_.reset();
   }
 
@@ -39,6 +45,9 @@ class TORCH_API SavedVariable {
  private:
   at::Tensor data_;
 
+  // When set, the saved tensor is owned by the hooks and data_ is undefined.
+  std::unique_ptr<SavedVariableHooks> hooks_;
+
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
   // it would create a circular reference. In that case, the grad_fn must be
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+
+namespace torch { namespace autograd {
+
+/// Hooks that take over the storage of the tensor held by a `SavedVariable`,
+/// e.g. to move it to host memory, compress it, or drop it and recompute it
+/// during the backward pass. `call_pack_hook` is called once, when the tensor
+/// is saved, and `call_unpack_hook` every time it is needed again; it must
+/// return a tensor with the same content.
+struct TORCH_API SavedVariableHooks {
+  virtual void call_pack_hook(at::Tensor tensor) = 0;
+  virtual at::Tensor call_unpack_hook() = 0;
+  virtual ~SavedVariableHooks() = default;
+};
+
+}} // namespace torch::autograd
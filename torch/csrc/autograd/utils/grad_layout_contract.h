@@ -34,6 +34,19 @@ inline at::Tensor clone_obey_contract(const at::Tensor& new_grad, const at::Tens
   }
 }
 
+// Creates a view of numel(variable) elements of flat, starting at offset,
+// that obeys the contract with variable. Gradients stashed as such views are
+// accumulated in place by AccumulateGrad, i.e. straight into flat.
+inline at::Tensor view_obey_contract(const at::Tensor& flat, int64_t offset, const at::Tensor& variable) {
+  if (variable.is_non_overlapping_and_dense()) {
+    // (1)
+    return flat.as_strided(variable.sizes(), variable.strides(), flat.storage_offset() + offset);
+  } else {
+    // (2)
+    return flat.narrow(0, offset, variable.numel()).view(variable.sizes());
+  }
+}
+
 } // namespace utils
 } // namespace autograd
 } // namespace torch
@@ -0,0 +1,36 @@
+#include <torch/csrc/python_headers.h>
+#include <torch/csrc/utils/pybind.h>
+
+#include <ATen/cuda/CUDAGraph.h>
+
+// THCPGraph_init is forward declared in its only consumer, csrc/Module.cpp,
+// like THCPStream_init and THCPEvent_init.
+
+template <typename T>
+using shared_ptr_class_ = py::class_<T, std::shared_ptr<T>>;
+
+void THCPGraph_init(PyObject *module) {
+  auto torch_C_m = py::handle(module).cast<py::module>();
+
+  torch_C_m.def("_graph_pool_handle", &::at::cuda::graph_pool_handle);
+
+  // None of the methods touch Python state, so they run without the GIL.
+  shared_ptr_class_<::at::cuda::CUDAGraph>(torch_C_m, "_CUDAGraph")
+      .def(py::init<>())
+      .def("capture_begin",
+           &::at::cuda::CUDAGraph::capture_begin,
+           py::call_guard<py::gil_scoped_release>(),
+           py::arg("pool") = c10::cuda::CUDACachingAllocator::MempoolId_t{0, 0})
+      .def("capture_end",
+           &::at::cuda::CUDAGraph::capture_end,
+           py::call_guard<py::gil_scoped_release>())
+      .def("replay",
+           &::at::cuda::CUDAGraph::replay,
+           py::call_guard<py::gil_scoped_release>())
+      .def("reset",
+           &::at::cuda::CUDAGraph::reset,
+           py::call_guard<py::gil_scoped_release>())
+      .def("pool",
+           &::at::cuda::CUDAGraph::pool,
+           py::call_guard<py::gil_scoped_release>());
+}
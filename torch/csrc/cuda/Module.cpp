@@ -148,6 +148,33 @@ PyObject * THCPModule_setStream_wrap(PyObject *self, PyObject *obj)
   END_HANDLE_TH_ERRORS
 }
 
+// Makes a stream that PyTorch doesn't manage, given by its raw cudaStream_t
+// value, wait for the work queued so far on the current stream, without
+// blocking the host. This is how a tensor is handed over to another library
+// through __dlpack__(stream=...).
+PyObject * THCPModule_externalStreamWait(PyObject *self, PyObject *obj)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(PyLong_Check(obj), "invalid stream");
+  uintptr_t ptr = PyLong_AsUnsignedLongLong(obj);
+  if (ptr == static_cast<uintptr_t>(-1) && PyErr_Occurred()) {
+    throw python_error();
+  }
+  auto external = reinterpret_cast<cudaStream_t>(ptr);
+  auto current = at::cuda::getCurrentCUDAStream();
+  if (external != current.stream()) {
+    pybind11::gil_scoped_release no_gil;
+    cudaEvent_t event;
+    THCudaCheck(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    THCudaCheck(cudaEventRecord(event, current));
+    THCudaCheck(cudaStreamWaitEvent(external, event, 0));
+    // The wait holds on to the event, which is only destroyed once it's done.
+    THCudaCheck(cudaEventDestroy(event));
+  }
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THCPModule_isDriverSufficient(PyObject *self, PyObject *noargs)
 {
   int count;
@@ -228,6 +255,21 @@ PyObject * THCPModule_cudaIPCCollect(PyObject *_unused, PyObject *noargs)
   END_HANDLE_TH_ERRORS
 }
 
+PyObject * THCPModule_cudaIPCStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  const auto stats = torch::CudaIPCGetStats();
+  py::dict result;
+  result["blocks_shared"] = stats.blocks_shared;
+  result["events_created"] = stats.events_created;
+  result["events_reused"] = stats.events_reused;
+  result["stream_syncs"] = stats.stream_syncs;
+  result["ref_counter_files_created"] = stats.ref_counter_files_created;
+  result["blocks_in_limbo"] = stats.blocks_in_limbo;
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THCPModule_cudaSleep(PyObject *_unused, PyObject *cycles)
 {
   HANDLE_TH_ERRORS
@@ -294,6 +336,77 @@ PyObject * THCPModule_emptyCache(PyObject *_unused, PyObject *noargs)
   Py_RETURN_NONE;
 }
 
+PyObject * THCPModule_setMemoryFraction(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject* fraction_o = nullptr;
+  PyObject* device_o = nullptr;
+  if(!PyArg_ParseTuple(args, "OO", &fraction_o, &device_o)) {
+    THPUtils_invalidArguments(
+        args,
+        nullptr,
+        "set_memory_fraction",
+        1,
+        "(double fraction, int device);");
+    return nullptr;
+  }
+  THPUtils_assert(
+      THPUtils_checkDouble(fraction_o) && THPUtils_checkLong(device_o),
+      "invalid arguments to set_memory_fraction");
+  double fraction = THPUtils_unpackDouble(fraction_o);
+  int64_t device = THPUtils_unpackLong(device_o);
+
+  c10::cuda::CUDACachingAllocator::setMemoryFraction(fraction, device);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+// Parses the (int limit_bytes, int device) arguments of the byte limits of
+// the caching allocator
+static bool unpackMemoryLimitArgs(
+    PyObject* args, const char* name, size_t* limit_bytes, int* device) {
+  PyObject* limit_o = nullptr;
+  PyObject* device_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OO", &limit_o, &device_o) ||
+      !THPUtils_checkLong(limit_o) || !THPUtils_checkLong(device_o)) {
+    PyErr_Clear();
+    THPUtils_invalidArguments(args, nullptr, name, 1, "(int limit_bytes, int device);");
+    return false;
+  }
+  const int64_t limit = THPUtils_unpackLong(limit_o);
+  THPUtils_assertRet(false, limit >= 0, "%s: expected a non-negative limit, but got %lld",
+      name, static_cast<long long>(limit));
+  *limit_bytes = static_cast<size_t>(limit);
+  *device = static_cast<int>(THPUtils_unpackLong(device_o));
+  return true;
+}
+
+PyObject * THCPModule_setMemoryLimit(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  size_t limit_bytes;
+  int device;
+  if (!unpackMemoryLimitArgs(args, "set_memory_limit", &limit_bytes, &device)) {
+    return nullptr;
+  }
+  c10::cuda::CUDACachingAllocator::setMemoryLimit(limit_bytes, device);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_setSoftMemoryLimit(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  size_t limit_bytes;
+  int device;
+  if (!unpackMemoryLimitArgs(args, "set_soft_memory_limit", &limit_bytes, &device)) {
+    return nullptr;
+  }
+  c10::cuda::CUDACachingAllocator::setSoftMemoryLimit(limit_bytes, device);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THCPModule_memoryStats(PyObject *_unused, PyObject *arg)
 {
   HANDLE_TH_ERRORS
@@ -379,6 +492,7 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
     segmentDict["allocated_size"] = segmentInfo.allocated_size;
     segmentDict["active_size"] = segmentInfo.active_size;
     segmentDict["segment_type"] = (segmentInfo.is_large ? "large" : "small");
+    segmentDict["is_expandable"] = segmentInfo.is_expandable;
 
     py::list blocks;
     for (const auto& blockInfo : segmentInfo.blocks) {
@@ -403,6 +517,65 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
   END_HANDLE_TH_ERRORS
 }
 
+PyObject * THCPModule_recordMemoryHistory(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject* enabled_o = nullptr;
+  PyObject* max_entries_o = nullptr;
+  PyObject* record_backtraces_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OOO", &enabled_o, &max_entries_o, &record_backtraces_o)) {
+    THPUtils_invalidArguments(
+        args,
+        nullptr,
+        "_record_memory_history",
+        1,
+        "(bool enabled, int max_entries, bool record_backtraces);");
+    return nullptr;
+  }
+  THPUtils_assert(THPUtils_checkLong(max_entries_o), "invalid argument to _record_memory_history");
+  const int64_t max_entries = THPUtils_unpackLong(max_entries_o);
+  THPUtils_assert(max_entries >= 0, "max_entries must be non-negative");
+  c10::cuda::CUDACachingAllocator::recordHistory(
+      PyObject_IsTrue(enabled_o), max_entries, PyObject_IsTrue(record_backtraces_o));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_memoryHistory(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+
+  using c10::cuda::CUDACachingAllocator::TraceEntry;
+  using c10::cuda::CUDACachingAllocator::TraceEventAction;
+
+  const auto actionToString = [](TraceEventAction action) {
+    switch (action) {
+      case TraceEventAction::ALLOC: return "alloc";
+      case TraceEventAction::FREE: return "free";
+      case TraceEventAction::SEGMENT_MAP: return "segment_map";
+      case TraceEventAction::SEGMENT_UNMAP: return "segment_unmap";
+      case TraceEventAction::OOM: return "oom";
+    }
+    return "unknown";
+  };
+
+  py::list result;
+  for (const TraceEntry& entry : c10::cuda::CUDACachingAllocator::history()) {
+    py::dict entryDict;
+    entryDict["action"] = actionToString(entry.action);
+    entryDict["device"] = entry.device;
+    entryDict["address"] = entry.address;
+    entryDict["size"] = entry.size;
+    entryDict["stream"] = reinterpret_cast<int64_t>(entry.stream);
+    entryDict["time_us"] = entry.time_us;
+    entryDict["backtrace"] = entry.backtrace;
+    result.append(entryDict);
+  }
+
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cuda module initialization
 ////////////////////////////////////////////////////////////////////////////////
@@ -521,20 +694,27 @@ static struct PyMethodDef _THCPModule_methods[] = {
     (PyCFunction)THCPModule_getDefaultStream_wrap, METH_O, nullptr},
   {"_cuda_getCurrentBlasHandle", (PyCFunction)THCPModule_getCurrentBlasHandle_wrap, METH_NOARGS, nullptr},
   {"_cuda_setStream",    (PyCFunction)THCPModule_setStream_wrap,  METH_O, nullptr},
+  {"_cuda_externalStreamWait", (PyCFunction)THCPModule_externalStreamWait, METH_O, nullptr},
   {"_cuda_isDriverSufficient", (PyCFunction)THCPModule_isDriverSufficient, METH_NOARGS, nullptr},
   {"_cuda_getDriverVersion", (PyCFunction)THCPModule_getDriverVersion, METH_NOARGS, nullptr},
   {"_cuda_getCompiledVersion", (PyCFunction)THCPModule_getCompiledVersion, METH_NOARGS, nullptr},
   {"_cuda_hasPrimaryContext", (PyCFunction) THCPModule_hasPrimaryContext,  METH_O,  nullptr},
   {"_cuda_emptyCache", (PyCFunction) THCPModule_emptyCache, METH_NOARGS, nullptr},
+  {"_cuda_setMemoryFraction", (PyCFunction) THCPModule_setMemoryFraction, METH_VARARGS, nullptr},
+  {"_cuda_setMemoryLimit", (PyCFunction) THCPModule_setMemoryLimit, METH_VARARGS, nullptr},
+  {"_cuda_setSoftMemoryLimit", (PyCFunction) THCPModule_setSoftMemoryLimit, METH_VARARGS, nullptr},
   {"_cuda_memoryStats", (PyCFunction) THCPModule_memoryStats, METH_O, nullptr},
   {"_cuda_resetAccumulatedMemoryStats", (PyCFunction) THCPModule_resetAccumulatedMemoryStats, METH_O, nullptr},
   {"_cuda_resetPeakMemoryStats", (PyCFunction) THCPModule_resetPeakMemoryStats, METH_O,  nullptr},
   {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS, nullptr},
+  {"_cuda_recordMemoryHistory", (PyCFunction) THCPModule_recordMemoryHistory, METH_VARARGS, nullptr},
+  {"_cuda_memoryHistory", (PyCFunction) THCPModule_memoryHistory, METH_NOARGS, nullptr},
   {"_cuda_cudaHostAllocator", (PyCFunction)THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_alloc", (PyCFunction)THCPModule_cudaCachingAllocator_raw_alloc, METH_VARARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_delete", (PyCFunction)THCPModule_cudaCachingAllocator_raw_delete, METH_O, nullptr},
   {"_cuda_synchronize", (PyCFunction)THCPModule_cudaSynchronize, METH_NOARGS, nullptr},
   {"_cuda_ipc_collect", (PyCFunction)THCPModule_cudaIPCCollect, METH_NOARGS, nullptr},
+  {"_cuda_ipc_stats", (PyCFunction)THCPModule_cudaIPCStats, METH_NOARGS, nullptr},
   {"_cuda_sleep", (PyCFunction)THCPModule_cudaSleep, METH_O, nullptr},
   {"_cuda_lock_mutex",   (PyCFunction)THCPModule_cudaLockMutex,   METH_NOARGS,  nullptr},
   {"_cuda_unlock_mutex", (PyCFunction)THCPModule_cudaUnlockMutex, METH_NOARGS,  nullptr},
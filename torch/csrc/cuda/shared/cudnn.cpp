@@ -12,6 +12,8 @@ using version_tuple = std::tuple<size_t, size_t, size_t>;
 
 #ifdef USE_CUDNN
 #include <cudnn.h>
+#include <ATen/native/cudnn/BenchmarkCache.h>
+#include <torch/csrc/Exceptions.h>
 
 namespace {
 
@@ -87,6 +89,10 @@ void initCudnnBindings(PyObject* module) {
   cudnn.def("getRuntimeVersion", getRuntimeVersion);
   cudnn.def("getCompileVersion", getCompileVersion);
   cudnn.def("getVersionInt", getVersionInt);
+#ifdef USE_CUDNN
+  cudnn.def("saveBenchmarkCache", torch::wrap_pybind_function(at::native::save_cudnn_benchmark_cache));
+  cudnn.def("loadBenchmarkCache", torch::wrap_pybind_function(at::native::load_cudnn_benchmark_cache));
+#endif
 }
 
 } // namespace shared
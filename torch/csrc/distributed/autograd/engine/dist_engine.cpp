@@ -292,15 +292,23 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
       NodeTask(graph_task, std::move(root_to_execute), InputBuffer(0)),
       incrementOutstandingTasks);
 
+  ++numLocalExecutionThreads_;
+  executeReadyQueue(graph_task, cpu_ready_queue);
+}
+
+void DistEngine::executeReadyQueue(
+    const std::shared_ptr<GraphTask>& graphTask,
+    const std::shared_ptr<ReadyQueue>& cpuReadyQueue) {
+  const int maxLocalExecutionThreads = at::get_num_interop_threads();
   torch::autograd::set_device(torch::autograd::CPU_DEVICE);
-  graph_task->owner_ = torch::autograd::CPU_DEVICE;
-  while (!cpu_ready_queue->empty()) {
+  graphTask->owner_ = torch::autograd::CPU_DEVICE;
+  while (!cpuReadyQueue->empty()) {
     std::shared_ptr<GraphTask> local_graph_task;
     {
       // Scope this block of execution since NodeTask is not needed after this
       // block and can be deallocated (release any references to grad tensors
       // as part of inputs_)
-      NodeTask task = cpu_ready_queue->pop();
+      NodeTask task = cpuReadyQueue->pop();
       if (!(local_graph_task = task.base_.lock())) {
         continue;
       }
@@ -309,7 +317,7 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
         try {
           GraphTaskGuard guard(local_graph_task);
           engine_.evaluate_function(
-              local_graph_task, task.fn_.get(), task.inputs_, cpu_ready_queue);
+              local_graph_task, task.fn_.get(), task.inputs_, cpuReadyQueue);
         } catch (std::exception& e) {
           engine_.thread_on_exception(local_graph_task, task.fn_, e);
           // break the loop in error so that we immediately stop the execution
@@ -321,14 +329,37 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
     }
     // Decrement the outstanding task.
     --local_graph_task->outstanding_tasks_;
+
+    // Keep the next task for this thread and hand off the other ready ones,
+    // as long as there are inter-op threads to run them. They are already
+    // counted in 'outstanding_tasks_'.
+    while (cpuReadyQueue->size() > 1) {
+      int numThreads = numLocalExecutionThreads_.load();
+      if (numThreads >= maxLocalExecutionThreads) {
+        break;
+      }
+      if (!numLocalExecutionThreads_.compare_exchange_weak(
+              numThreads, numThreads + 1)) {
+        continue;
+      }
+      auto readyQueue = std::make_shared<ReadyQueue>();
+      readyQueue->push(
+          cpuReadyQueue->pop(), /* incrementOutstandingTasks */ false);
+      at::launch([this, graphTask, readyQueue]() {
+        executeReadyQueue(graphTask, readyQueue);
+      });
+    }
   }
-  // Check if we've completed execution.
-  if (graph_task->completed()) {
+  --numLocalExecutionThreads_;
+
+  // Check if we've completed execution. Several threads may see the GraphTask
+  // completed, 'mark_as_completed_and_run_post_processing' only runs once.
+  if (graphTask->completed()) {
     // We don't need to explicitly notify the owner thread, since
     // 'mark_as_completed_and_run_post_processing' would mark the Future as
     // completed and this would notify the owner thread that the task has been
     // completed.
-    graph_task->mark_as_completed_and_run_post_processing();
+    graphTask->mark_as_completed_and_run_post_processing();
   }
 }
 
@@ -388,18 +419,35 @@ std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionAsync(
     const ContextPtr& autogradContext,
     const std::shared_ptr<Node>& sendFunction,
     bool retainGraph) {
+  const auto contextId = autogradContext->contextId();
   std::unique_lock<std::mutex> lock(initializedContextIdsLock_);
-  if (initializedContextIds_.find(autogradContext->contextId()) ==
-      initializedContextIds_.end()) {
-    edge_list outputEdges;
-    // Pass in a dummy graphRoot since all send functions are the roots.
-    auto dummyRoot = std::make_shared<GraphRoot>(edge_list(), variable_list());
-    computeDependencies(
-        autogradContext, {}, {}, dummyRoot, outputEdges, retainGraph);
+  if (initializedContextIds_.find(contextId) == initializedContextIds_.end()) {
+    // Mark the autograd context id as initialized and unlock, the other send
+    // functions of the context wait on 'initialized'.
+    initializedContextIds_.insert(contextId);
+    auto initialized = std::make_shared<torch::utils::Future<bool>>();
+    initializingContexts_[contextId] = initialized;
+    lock.unlock();
 
-    // Mark the autograd context id as initialized and unlock.
-    initializedContextIds_.insert(autogradContext->contextId());
+    edge_list outputEdges;
+    try {
+      // Pass in a dummy graphRoot since all send functions are the roots.
+      auto dummyRoot =
+          std::make_shared<GraphRoot>(edge_list(), variable_list());
+      computeDependencies(
+          autogradContext, {}, {}, dummyRoot, outputEdges, retainGraph);
+    } catch (std::exception& e) {
+      lock.lock();
+      initializedContextIds_.erase(contextId);
+      initializingContexts_.erase(contextId);
+      lock.unlock();
+      initialized->setError(e.what());
+      throw;
+    }
+    lock.lock();
+    initializingContexts_.erase(contextId);
     lock.unlock();
+    initialized->markCompleted(true);
 
     // Enqueue the current send function.
     auto graphTask = autogradContext->retrieveGraphTask();
@@ -456,14 +504,35 @@ std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionAsync(
     // Return the future which waits for all async processing to be done.
     return callbackFuture;
   } else {
+    std::shared_ptr<torch::utils::Future<bool>> initialized;
+    auto it = initializingContexts_.find(contextId);
+    if (it != initializingContexts_.end()) {
+      initialized = it->second;
+    }
     lock.unlock();
-    auto graphTask = autogradContext->retrieveGraphTask();
-    at::launch([this, graphTask, sendFunction]() {
-      execute_graph_task_until_ready_queue_empty(
-          /*graph_task*/ graphTask,
-          /*root_to_execute*/ sendFunction,
-          /*incrementOutstandingTasks*/ false);
-    });
+
+    auto execute = [this, autogradContext, sendFunction]() {
+      auto graphTask = autogradContext->retrieveGraphTask();
+      at::launch([this, graphTask, sendFunction]() {
+        execute_graph_task_until_ready_queue_empty(
+            /*graph_task*/ graphTask,
+            /*root_to_execute*/ sendFunction,
+            /*incrementOutstandingTasks*/ false);
+      });
+    };
+    if (!initialized) {
+      execute();
+    } else {
+      // The dependencies are still being computed by another thread, this
+      // send function runs right after.
+      initialized->addCallback(
+          [initialized, execute = std::move(execute)]() {
+            // The first send function reports the error.
+            if (!initialized->hasError()) {
+              execute();
+            }
+          });
+    }
     return std::make_shared<rpc::FutureMessage>(rpc::Message());
   }
 }
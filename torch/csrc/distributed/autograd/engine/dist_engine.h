@@ -1,12 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <torch/csrc/autograd/engine.h>
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/distributed/autograd/context/context.h>
+#include <torch/csrc/utils/future.h>
 
 namespace torch {
 namespace distributed {
@@ -44,6 +47,11 @@ class TORCH_API DistEngine {
   // This method is used to kick off the autograd computation on a node when it
   // receives gradients from the corresponding 'recv' method on another node.
   // The gradients are accumulated in the provided autograd context.
+  // The dependencies are computed outside of any engine wide lock, so that
+  // gradients of different contexts don't wait for each other. Gradients
+  // received for the context in the meantime are kept by the send function,
+  // and executed as soon as the dependencies are ready instead of blocking the
+  // RPC thread that received them.
   std::shared_ptr<rpc::FutureMessage> executeSendFunctionAsync(
       const ContextPtr& autogradContext,
       const std::shared_ptr<torch::autograd::Node>& sendFunction,
@@ -123,6 +131,18 @@ class TORCH_API DistEngine {
       std::shared_ptr<torch::autograd::Node> root_to_execute,
       bool incrementOutstandingTasks = true);
 
+  // Executes the tasks of the ready queue until it is empty, see
+  // execute_graph_task_until_ready_queue_empty. Whenever more than one task is
+  // ready, the extra ones are handed off to other inter-op threads with a
+  // ready queue of their own, so that independent branches of the graph (e.g.
+  // the subgraphs leading to different RecvRpcBackward functions) run in
+  // parallel. At most at::get_num_interop_threads() of these loops run at once
+  // in the engine. The caller must have counted this one in
+  // numLocalExecutionThreads_.
+  void executeReadyQueue(
+      const std::shared_ptr<torch::autograd::GraphTask>& graphTask,
+      const std::shared_ptr<torch::autograd::ReadyQueue>& cpuReadyQueue);
+
   // Run the local autograd engine using the provided graphTask and graphRoot
   // and accumulate the gradients part 'outputEdges' in the provided autograd
   // context.
@@ -141,6 +161,14 @@ class TORCH_API DistEngine {
 
   mutable std::mutex initializedContextIdsLock_;
 
+  // Contexts in initializedContextIds_ whose dependencies are still being
+  // computed, mapped to a future completed once they are.
+  std::unordered_map<int64_t, std::shared_ptr<torch::utils::Future<bool>>>
+      initializingContexts_;
+
+  // Number of threads currently running executeReadyQueue.
+  std::atomic<int> numLocalExecutionThreads_{0};
+
   // Reference to local autograd engine.
   torch::autograd::Engine& engine_;
 
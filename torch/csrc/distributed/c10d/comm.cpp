@@ -7,6 +7,10 @@
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <torch/csrc/utils/tensor_flatten.h>
 
+#ifdef USE_C10D_NCCL
+#include <c10d/ProcessGroupNCCL.hpp>
+#endif
+
 namespace c10d {
 namespace {
 
@@ -45,6 +49,31 @@ class BroadcastWork {
   std::shared_ptr<c10d::ProcessGroup::Work> work_;
 };
 
+#ifdef USE_C10D_NCCL
+// ProcessGroupNCCL broadcasts dense tensors on a single device in one NCCL
+// group, without copying them to flat buckets first. Returns false if the
+// tensors have to go through the buckets.
+bool broadcast_coalesced_nccl(
+    const std::shared_ptr<c10d::ProcessGroup>& process_group,
+    at::TensorList tensors) {
+  auto nccl_process_group =
+      std::dynamic_pointer_cast<c10d::ProcessGroupNCCL>(process_group);
+  if (!nccl_process_group || tensors.empty()) {
+    return false;
+  }
+  for (const auto& tensor : tensors) {
+    if (!tensor.is_cuda() || tensor.is_sparse() ||
+        !tensor.is_non_overlapping_and_dense() ||
+        tensor.device() != tensors[0].device()) {
+      return false;
+    }
+  }
+  auto tensor_list = tensors.vec();
+  nccl_process_group->broadcast_coalesced(tensor_list)->wait();
+  return true;
+}
+#endif
+
 } // namespace
 
 // Broadcast many tensors to all processes in the process group.
@@ -52,6 +81,12 @@ void broadcast_coalesced(
     std::shared_ptr<c10d::ProcessGroup> process_group,
     at::TensorList tensors,
     size_t buffer_size) {
+#ifdef USE_C10D_NCCL
+  if (broadcast_coalesced_nccl(process_group, tensors)) {
+    return;
+  }
+#endif
+
   // Coalesce tensors into buckets taking into account the maximum buffer size.
   // This routine is multi-device aware, so the tensors can be split across
   // multiple devices and can contain a mix of CPU and CUDA tensors.
@@ -80,13 +115,17 @@ void broadcast_coalesced(
   }
 }
 
-GradBucket::GradBucket(std::vector<at::Tensor> tensors)
-    : tensors_(std::move(tensors)){};
+GradBucket::GradBucket(std::vector<at::Tensor> tensors, size_t index)
+    : tensors_(std::move(tensors)), index_(index){};
 
-const std::vector<at::Tensor>& GradBucket::getTensors() {
+const std::vector<at::Tensor>& GradBucket::getTensors() const {
   return tensors_;
 }
 
+size_t GradBucket::getIndex() const {
+  return index_;
+}
+
 PythonCommHook::PythonCommHook(py::object state, py::object hook)
     : state_(std::move(state)), hook_(std::move(hook)){};
 
@@ -15,16 +15,19 @@ void broadcast_coalesced(
     size_t buffer_size);
 
 // This class passes bucket contents tensor (for multiple replicas) to
-// DDP communication hook.
+// DDP communication hook, along with the index of the bucket so that hooks
+// can keep state per bucket across iterations.
 // Optionally in the future this can be enhanced with parameter to bucket
 // mappings as well.
 class GradBucket {
  public:
-  explicit GradBucket(std::vector<at::Tensor> tensors);
-  const std::vector<at::Tensor>& getTensors();
+  explicit GradBucket(std::vector<at::Tensor> tensors, size_t index = 0);
+  const std::vector<at::Tensor>& getTensors() const;
+  size_t getIndex() const;
 
  private:
   std::vector<at::Tensor> tensors_;
+  size_t index_;
 };
 
 // DDP's c10d reducer allows communcation hooks defined as a sub class
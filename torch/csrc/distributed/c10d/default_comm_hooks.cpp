@@ -0,0 +1,241 @@
+#include <torch/csrc/distributed/c10d/default_comm_hooks.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <c10/util/Exception.h>
+
+namespace c10d {
+namespace {
+
+// Seed of the initial Q of PowerSGD, which has to be the same on every rank
+constexpr uint64_t kPowerSGDSeed = 0;
+
+} // namespace
+
+CppCommHook::CppCommHook(std::shared_ptr<ProcessGroup> process_group)
+    : process_group_(std::move(process_group)) {}
+
+bool CppCommHook::compresses(const std::vector<at::Tensor>& tensors) const {
+  for (const auto& tensor : tensors) {
+    if (tensor.is_sparse() || !at::isFloatingType(tensor.scalar_type())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+c10::intrusive_ptr<torch::jit::Future> CppCommHook::runHook(
+    const GradBucket& bucket) {
+  PendingBucket pending;
+  pending.index = bucket.getIndex();
+  pending.tensors = bucket.getTensors();
+  pending.compressed = compresses(pending.tensors);
+  if (pending.compressed) {
+    launch(pending);
+  } else {
+    pending.work.push_back(process_group_->allreduce(pending.tensors));
+  }
+
+  const int64_t ticket = next_ticket_++;
+  pending_.emplace(ticket, std::move(pending));
+  auto future = c10::make_intrusive<torch::jit::Future>(c10::IntType::get());
+  future->markCompleted(ticket);
+  return future;
+}
+
+std::vector<at::Tensor> CppCommHook::processFuture(c10::IValue future_value) {
+  auto it = pending_.find(future_value.toInt());
+  TORCH_INTERNAL_ASSERT(it != pending_.end(), "Unknown comm hook ticket");
+  PendingBucket pending = std::move(it->second);
+  pending_.erase(it);
+
+  for (auto& work : pending.work) {
+    work->wait();
+  }
+  if (!pending.compressed) {
+    return pending.tensors;
+  }
+  return finish(pending);
+}
+
+FP16CompressCommHook::FP16CompressCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    at::ScalarType dtype)
+    : CppCommHook(std::move(process_group)), dtype_(dtype) {
+  TORCH_CHECK(
+      dtype_ == at::kHalf || dtype_ == at::kBFloat16,
+      "FP16CompressCommHook compresses to Half or BFloat16, not ",
+      dtype_);
+}
+
+bool FP16CompressCommHook::compresses(
+    const std::vector<at::Tensor>& tensors) const {
+  if (!CppCommHook::compresses(tensors)) {
+    return false;
+  }
+  // Don't widen buckets that are already in a 16 bit type
+  for (const auto& tensor : tensors) {
+    if (c10::elementSize(tensor.scalar_type()) <= c10::elementSize(dtype_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void FP16CompressCommHook::launch(PendingBucket& bucket) {
+  bucket.buffers.reserve(bucket.tensors.size());
+  for (const auto& tensor : bucket.tensors) {
+    bucket.buffers.push_back(tensor.to(dtype_));
+  }
+  bucket.work.push_back(process_group_->allreduce(bucket.buffers));
+}
+
+std::vector<at::Tensor> FP16CompressCommHook::finish(PendingBucket& bucket) {
+  for (size_t i = 0; i < bucket.tensors.size(); i++) {
+    bucket.tensors[i].copy_(bucket.buffers[i]);
+  }
+  return bucket.tensors;
+}
+
+PowerSGDCommHook::PowerSGDCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t matrix_approximation_rank)
+    : CppCommHook(std::move(process_group)), rank_(matrix_approximation_rank) {
+  TORCH_CHECK(
+      rank_ > 0,
+      "PowerSGD needs a positive matrix approximation rank, got ",
+      rank_);
+}
+
+bool PowerSGDCommHook::compresses(
+    const std::vector<at::Tensor>& tensors) const {
+  return tensors.size() == 1 && CppCommHook::compresses(tensors);
+}
+
+void PowerSGDCommHook::launch(PendingBucket& bucket) {
+  const auto& tensor = bucket.tensors[0];
+  const int64_t numel = tensor.numel();
+  auto& state = states_[bucket.index];
+  // Start over if the bucket changed, e.g. when the buckets are rebuilt after
+  // the first iteration
+  if (!state.error.defined() || state.numel != numel ||
+      state.error.device() != tensor.device()) {
+    state.numel = numel;
+    state.cols = static_cast<int64_t>(std::ceil(std::sqrt(numel)));
+    state.rows = (numel + state.cols - 1) / state.cols;
+    const auto options = tensor.options().dtype(at::kFloat);
+    state.error = at::zeros({state.rows, state.cols}, options);
+    const int64_t rank = std::min({rank_, state.rows, state.cols});
+    auto generator = at::detail::createCPUGenerator(kPowerSGDSeed);
+    state.q = at::randn({state.cols, rank}, generator, options.device(at::kCPU))
+                  .to(tensor.device());
+  }
+
+  // M = bucket + error, the padding stays zero
+  auto matrix = state.error;
+  matrix.view(-1).narrow(0, 0, numel).add_(tensor.view(-1));
+  std::vector<at::Tensor> p = {at::mm(matrix, state.q)};
+  bucket.buffers = {matrix, p[0]};
+  bucket.work.push_back(process_group_->allreduce(p));
+}
+
+std::vector<at::Tensor> PowerSGDCommHook::finish(PendingBucket& bucket) {
+  auto& state = states_[bucket.index];
+  auto& matrix = bucket.buffers[0];
+  const auto p = std::get<0>(at::qr(bucket.buffers[1]));
+
+  std::vector<at::Tensor> q = {at::mm(matrix.t(), p)};
+  process_group_->allreduce(q)->wait();
+  state.q = q[0];
+
+  const auto approximation = at::mm(p, state.q.t());
+  // The error is what the approximation missed
+  matrix.sub_(approximation);
+  const int64_t numel = bucket.tensors[0].numel();
+  matrix.view(-1).narrow(0, numel, matrix.numel() - numel).zero_();
+
+  auto& tensor = bucket.tensors[0];
+  tensor.view(-1).copy_(approximation.view(-1).narrow(0, 0, numel));
+  return bucket.tensors;
+}
+
+TopKCommHook::TopKCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    double compress_ratio)
+    : CppCommHook(std::move(process_group)), compress_ratio_(compress_ratio) {
+  TORCH_CHECK(
+      compress_ratio_ > 0 && compress_ratio_ <= 1,
+      "Top-k compression needs a ratio in (0, 1], got ",
+      compress_ratio_);
+}
+
+bool TopKCommHook::compresses(const std::vector<at::Tensor>& tensors) const {
+  return tensors.size() == 1 && CppCommHook::compresses(tensors);
+}
+
+void TopKCommHook::launch(PendingBucket& bucket) {
+  const auto tensor = bucket.tensors[0].view(-1);
+  auto& error = errors_[bucket.index];
+  if (!error.defined() || error.numel() != tensor.numel() ||
+      error.device() != tensor.device()) {
+    error = at::zeros_like(tensor);
+  }
+
+  // The error becomes bucket + error, except for the entries that are sent
+  error.add_(tensor);
+  const int64_t k = std::max<int64_t>(
+      1, static_cast<int64_t>(std::ceil(tensor.numel() * compress_ratio_)));
+  auto indices = std::get<1>(error.abs().topk(k, /*dim=*/0, /*largest=*/true,
+                                              /*sorted=*/false));
+  auto values = error.index_select(0, indices);
+  error.index_fill_(0, indices, 0);
+
+  const int size = process_group_->getSize();
+  bucket.buffers = {values, indices};
+  bucket.gathered.resize(2);
+  for (int i = 0; i < size; i++) {
+    bucket.gathered[0].push_back(at::empty_like(values));
+    bucket.gathered[1].push_back(at::empty_like(indices));
+  }
+  std::vector<std::vector<at::Tensor>> gathered_values = {bucket.gathered[0]};
+  std::vector<std::vector<at::Tensor>> gathered_indices = {bucket.gathered[1]};
+  std::vector<at::Tensor> inputs = {values};
+  bucket.work.push_back(process_group_->allgather(gathered_values, inputs));
+  inputs = {indices};
+  bucket.work.push_back(process_group_->allgather(gathered_indices, inputs));
+}
+
+std::vector<at::Tensor> TopKCommHook::finish(PendingBucket& bucket) {
+  auto tensor = bucket.tensors[0].view(-1);
+  tensor.zero_();
+  for (size_t i = 0; i < bucket.gathered[0].size(); i++) {
+    tensor.index_add_(0, bucket.gathered[1][i], bucket.gathered[0][i]);
+  }
+  return bucket.tensors;
+}
+
+std::unique_ptr<CommHookInterface> makeBuiltinCommHook(
+    BuiltinCommHookType type,
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t matrix_approximation_rank,
+    double compress_ratio) {
+  switch (type) {
+    case BuiltinCommHookType::FP16_COMPRESS:
+      return std::make_unique<FP16CompressCommHook>(
+          std::move(process_group), at::kHalf);
+    case BuiltinCommHookType::BF16_COMPRESS:
+      return std::make_unique<FP16CompressCommHook>(
+          std::move(process_group), at::kBFloat16);
+    case BuiltinCommHookType::POWER_SGD:
+      return std::make_unique<PowerSGDCommHook>(
+          std::move(process_group), matrix_approximation_rank);
+    case BuiltinCommHookType::TOP_K:
+      return std::make_unique<TopKCommHook>(
+          std::move(process_group), compress_ratio);
+  }
+  TORCH_CHECK(false, "Unknown built-in comm hook type");
+}
+
+} // namespace c10d
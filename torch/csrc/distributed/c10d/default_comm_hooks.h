@@ -0,0 +1,159 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+#include <torch/csrc/distributed/c10d/comm.h>
+
+namespace c10d {
+
+// Gradient compression hooks implemented in C++, registered with
+// `_register_builtin_comm_hook` instead of a Python callable.
+enum class BuiltinCommHookType : uint8_t {
+  // Casts the buckets to half / bfloat16 for the allreduce
+  FP16_COMPRESS,
+  BF16_COMPRESS,
+  // Low-rank approximation of the buckets with error feedback
+  POWER_SGD,
+  // Allgather of the largest entries of the buckets with error feedback
+  TOP_K,
+};
+
+// Base of the built-in hooks. They run on the thread calling into the reducer
+// and never take the GIL.
+//
+// runHook launches the collectives of the first stage and returns a future
+// that is already completed with a ticket. processFuture waits for these
+// collectives, runs the remaining stages of the hook and returns the reduced
+// bucket contents. The reducer calls both in bucket order on every rank (see
+// Reducer::mark_bucket_ready and Reducer::finalize_backward), so the
+// collectives issued in either are in the same order on all ranks.
+//
+// The reducer has already divided the gradients by the world size, the
+// collectives only have to sum them. Sparse buckets, and buckets a hook can't
+// compress, are allreduced as they are.
+class TORCH_API CppCommHook : public CommHookInterface {
+ public:
+  explicit CppCommHook(std::shared_ptr<ProcessGroup> process_group);
+
+  c10::intrusive_ptr<torch::jit::Future> runHook(
+      const GradBucket& bucket) override;
+
+  std::vector<at::Tensor> processFuture(c10::IValue future_value) override;
+
+ protected:
+  // A bucket between runHook and processFuture
+  struct PendingBucket {
+    size_t index;
+    // Whether the hook compresses the bucket, or it is allreduced as it is
+    bool compressed;
+    // Contents of the bucket, one per model replica
+    std::vector<at::Tensor> tensors;
+    // Tensors used by the collectives of the hook
+    std::vector<at::Tensor> buffers;
+    std::vector<std::vector<at::Tensor>> gathered;
+    std::vector<std::shared_ptr<ProcessGroup::Work>> work;
+  };
+
+  // Whether the hook compresses the bucket, by default any dense floating
+  // point bucket
+  virtual bool compresses(const std::vector<at::Tensor>& tensors) const;
+
+  // Launches the collectives of the first stage
+  virtual void launch(PendingBucket& bucket) = 0;
+
+  // Called once the work of the first stage is done, returns the reduced
+  // contents of the bucket
+  virtual std::vector<at::Tensor> finish(PendingBucket& bucket) = 0;
+
+  std::shared_ptr<ProcessGroup> process_group_;
+
+ private:
+  int64_t next_ticket_ = 0;
+  std::unordered_map<int64_t, PendingBucket> pending_;
+};
+
+// Allreduces the buckets in a lower precision floating point type, halving
+// the bytes sent for float gradients.
+class TORCH_API FP16CompressCommHook : public CppCommHook {
+ public:
+  FP16CompressCommHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      at::ScalarType dtype = at::kHalf);
+
+ protected:
+  bool compresses(const std::vector<at::Tensor>& tensors) const override;
+  void launch(PendingBucket& bucket) override;
+  std::vector<at::Tensor> finish(PendingBucket& bucket) override;
+
+ private:
+  const at::ScalarType dtype_;
+};
+
+// PowerSGD (Vogels et al., 2019): the flattened bucket, plus the error of the
+// previous approximation, is padded to a rows x cols matrix M and
+// approximated by P Q^T, with P and Q of rank `matrix_approximation_rank`.
+// One power iteration per step: P = M Q is allreduced and orthogonalized,
+// then Q = M^T P is allreduced, and each one of them sends (rows + cols) *
+// rank values instead of rows * cols. Q is kept as the starting point of the
+// next step, and starts from the same random matrix on every rank.
+//
+// Only buckets of a single model replica are compressed.
+class TORCH_API PowerSGDCommHook : public CppCommHook {
+ public:
+  PowerSGDCommHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      int64_t matrix_approximation_rank = 1);
+
+ protected:
+  bool compresses(const std::vector<at::Tensor>& tensors) const override;
+  void launch(PendingBucket& bucket) override;
+  std::vector<at::Tensor> finish(PendingBucket& bucket) override;
+
+ private:
+  struct State {
+    int64_t numel;
+    int64_t rows;
+    int64_t cols;
+    // Accumulated error, in float, as a rows x cols matrix
+    at::Tensor error;
+    at::Tensor q;
+  };
+
+  const int64_t rank_;
+  std::unordered_map<size_t, State> states_;
+};
+
+// Top-k sparsification: only the `compress_ratio` fraction of the entries of
+// largest magnitude of each bucket, plus the error of the previous steps, is
+// allgathered with its indices, the rest is kept as error.
+//
+// Only buckets of a single model replica are compressed.
+class TORCH_API TopKCommHook : public CppCommHook {
+ public:
+  TopKCommHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      double compress_ratio = 0.01);
+
+ protected:
+  bool compresses(const std::vector<at::Tensor>& tensors) const override;
+  void launch(PendingBucket& bucket) override;
+  std::vector<at::Tensor> finish(PendingBucket& bucket) override;
+
+ private:
+  const double compress_ratio_;
+  std::unordered_map<size_t, at::Tensor> errors_;
+};
+
+// Creates the built-in hook of the given type. `matrix_approximation_rank` is
+// only used by POWER_SGD and `compress_ratio` by TOP_K.
+TORCH_API std::unique_ptr<CommHookInterface> makeBuiltinCommHook(
+    BuiltinCommHookType type,
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t matrix_approximation_rank = 1,
+    double compress_ratio = 0.01);
+
+} // namespace c10d
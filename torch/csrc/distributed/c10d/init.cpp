@@ -17,13 +17,16 @@
 #endif
 
 #include <c10d/PrefixStore.hpp>
+#include <c10d/ProcessGroupHierarchical.hpp>
 #include <c10d/ProcessGroupRoundRobin.hpp>
 #include <c10d/TCPStore.hpp>
 #include <pybind11/chrono.h>
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/distributed/c10d/comm.h>
+#include <torch/csrc/distributed/c10d/default_comm_hooks.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
+#include <torch/csrc/distributed/c10d/sharded_embedding_bag.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
 
@@ -35,6 +38,7 @@ namespace {
 
 #ifdef USE_C10D_GLOO
 constexpr char* GLOO_SOCKET_IFNAME_ENV = "GLOO_SOCKET_IFNAME";
+constexpr char* GLOO_ALLREDUCE_ALGORITHM_ENV = "GLOO_ALLREDUCE_ALGORITHM";
 #endif
 
 std::vector<std::string> split(char separator, const std::string& string) {
@@ -120,6 +124,21 @@ void _register_comm_hook(
       std::move(state), std::move(comm_hook)));
 };
 
+// Same as `_register_comm_hook`, for the hooks implemented in C++. They
+// communicate over `process_group` and don't need the GIL.
+void _register_builtin_comm_hook(
+    ::c10d::Reducer& reducer,
+    std::shared_ptr<::c10d::ProcessGroup> process_group,
+    ::c10d::BuiltinCommHookType comm_hook_type,
+    int64_t matrix_approximation_rank,
+    double compress_ratio) {
+  reducer.register_comm_hook(::c10d::makeBuiltinCommHook(
+      comm_hook_type,
+      std::move(process_group),
+      matrix_approximation_rank,
+      compress_ratio));
+};
+
 PyObject* c10d_init(PyObject* _unused) {
   C10_LOG_API_USAGE_ONCE("c10d.python.import");
   auto c10d_module = THPObjectPtr(PyImport_ImportModule("torch.distributed"));
@@ -136,12 +155,34 @@ PyObject* c10d_init(PyObject* _unused) {
       py::arg("state"),
       py::arg("comm_hook"));
 
+  py::enum_<::c10d::BuiltinCommHookType>(module, "BuiltinCommHookType", R"(
+An enum-like class for the DDP communication hooks implemented in C++:
+``FP16_COMPRESS``, ``BF16_COMPRESS``, ``POWER_SGD`` and ``TOP_K``.)")
+      .value("FP16_COMPRESS", ::c10d::BuiltinCommHookType::FP16_COMPRESS)
+      .value("BF16_COMPRESS", ::c10d::BuiltinCommHookType::BF16_COMPRESS)
+      .value("POWER_SGD", ::c10d::BuiltinCommHookType::POWER_SGD)
+      .value("TOP_K", ::c10d::BuiltinCommHookType::TOP_K);
+
+  module.def(
+      "_register_builtin_comm_hook",
+      &_register_builtin_comm_hook,
+      py::arg("reducer"),
+      py::arg("process_group"),
+      py::arg("comm_hook_type"),
+      py::arg("matrix_approximation_rank") = 1,
+      py::arg("compress_ratio") = 0.01,
+      py::call_guard<py::gil_scoped_release>());
+
   shared_ptr_class_<::c10d::GradBucket>(module, "GradBucket")
-      .def(py::init<std::vector<Tensor>&>(), py::arg("tensors"))
+      .def(
+          py::init<std::vector<Tensor>&, size_t>(),
+          py::arg("tensors"),
+          py::arg("index") = 0)
       .def(
           "get_tensors",
           &::c10d::GradBucket::getTensors,
-          py::call_guard<py::gil_scoped_release>());
+          py::call_guard<py::gil_scoped_release>())
+      .def("get_index", &::c10d::GradBucket::getIndex);
 
   shared_ptr_class_<::c10d::Reducer>(module, "Reducer")
       .def(
@@ -151,6 +192,7 @@ PyObject* c10d_init(PyObject* _unused) {
               std::shared_ptr<::c10d::ProcessGroup>,
               std::vector<std::vector<bool>>,
               int64_t,
+              bool,
               bool>(),
           py::arg("replicas"),
           py::arg("bucket_indices"),
@@ -158,6 +200,7 @@ PyObject* c10d_init(PyObject* _unused) {
           py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>(),
           py::arg("bucket_bytes_cap") = ::c10d::kDefaultBucketBytesCap,
           py::arg("find_unused_parameters") = false,
+          py::arg("gradient_as_bucket_view") = false,
           py::call_guard<py::gil_scoped_release>())
       .def(
           "initialize_buckets",
@@ -172,7 +215,71 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def(
+          "_get_bucket_indices",
+          &::c10d::Reducer::get_bucket_indices,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "_register_bucket_finalized_hook",
+          [](::c10d::Reducer& reducer, py::object hook) {
+            // The hook is released by the reducer, which doesn't hold the GIL.
+            std::shared_ptr<py::object> fn(
+                new py::object(std::move(hook)), [](py::object* obj) {
+                  pybind11::gil_scoped_acquire ag;
+                  delete obj;
+                });
+            reducer.register_bucket_finalized_hook(
+                [fn](
+                    size_t bucket_index,
+                    const std::vector<torch::autograd::Variable>& variables,
+                    const std::vector<at::Tensor>& grads) {
+                  pybind11::gil_scoped_acquire ag;
+                  (*fn)(bucket_index, variables, grads);
+                });
+          },
+          py::arg("hook"));
+
+  py::enum_<::c10d::ShardingType>(module, "ShardingType", R"(
+An enum-like class for the ways the tables of a sharded embedding bag are split
+over the ranks: ``TABLE_WISE``, every table lives on a single rank, and
+``ROW_WISE``, every rank holds a contiguous block of the rows of every table.)")
+      .value("TABLE_WISE", ::c10d::ShardingType::TABLE_WISE)
+      .value("ROW_WISE", ::c10d::ShardingType::ROW_WISE);
+
+  shared_ptr_class_<::c10d::ShardedEmbeddingBag>(
+      module, "_ShardedEmbeddingBag")
+      .def(
+          py::init<
+              std::shared_ptr<::c10d::ProcessGroup>,
+              std::vector<int64_t>,
+              std::vector<int64_t>,
+              ::c10d::ShardingType,
+              int64_t,
+              bool>(),
+          py::arg("process_group"),
+          py::arg("num_embeddings"),
+          py::arg("embedding_dims"),
+          py::arg("sharding_type"),
+          py::arg("mode"),
+          py::arg("sparse"))
+      .def(
+          "local_shards",
+          [](const ::c10d::ShardedEmbeddingBag& self) {
+            std::vector<std::tuple<int64_t, int64_t, int64_t, int64_t>> shards;
+            for (const auto& shard : self.localShards()) {
+              shards.emplace_back(
+                  shard.table, shard.row_begin, shard.num_rows, shard.dim);
+            }
+            return shards;
+          })
+      .def(
+          "forward",
+          &::c10d::ShardedEmbeddingBag::forward,
+          py::arg("weights"),
+          py::arg("indices"),
+          py::arg("offsets"),
+          py::call_guard<py::gil_scoped_release>());
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class for available reduction operations: ``SUM``, ``PRODUCT``,
@@ -269,6 +376,57 @@ They are used in specifying strategies for reduction collectives, e.g.,
               "add",
               &::c10d::Store::add,
               py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                py::list result;
+                for (const auto& value : values) {
+                  result.append(py::bytes(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size()));
+                }
+                return result;
+              })
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          // Sets the key to desired_value if its current value is
+          // expected_value, or if it is missing and expected_value is empty.
+          // Returns the value of the key after the operation.
+          .def(
+              "compare_set",
+              [](::c10d::Store& store,
+                 const std::string& key,
+                 const std::string& expected_value,
+                 const std::string& desired_value) -> py::bytes {
+                std::vector<uint8_t> value;
+                {
+                  py::gil_scoped_release release;
+                  value = store.compareSet(
+                      key,
+                      std::vector<uint8_t>(
+                          expected_value.begin(), expected_value.end()),
+                      std::vector<uint8_t>(
+                          desired_value.begin(), desired_value.end()));
+                }
+                return py::bytes(
+                    reinterpret_cast<const char*>(value.data()), value.size());
+              })
           .def(
               "set_timeout",
               &::c10d::Store::setTimeout,
@@ -379,6 +537,17 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("opts") = ::c10d::AllreduceCoalescedOptions(),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "broadcast_coalesced",
+              [](::c10d::ProcessGroup& pg,
+                 std::vector<at::Tensor>& xs,
+                 ::c10d::BroadcastOptions opts) {
+                return pg.broadcast_coalesced(xs, opts);
+              },
+              py::arg("tensors"),
+              py::arg("opts") = ::c10d::BroadcastOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "reduce",
               &::c10d::ProcessGroup::reduce,
@@ -425,6 +594,14 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("input_tensor"),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "_allgather_base",
+              &::c10d::ProcessGroup::allgather_base,
+              py::arg("output"),
+              py::arg("input"),
+              py::arg("opts") = ::c10d::AllgatherOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "allgather_coalesced",
               &::c10d::ProcessGroup::allgather_coalesced,
@@ -589,18 +766,55 @@ They are used in specifying strategies for reduction collectives, e.g.,
       py::arg("process_groups"),
       py::call_guard<py::gil_scoped_release>());
 
+  module.def(
+      "_hierarchical_process_group",
+      [](std::shared_ptr<::c10d::ProcessGroup> intraNodeGroup,
+         std::shared_ptr<::c10d::ProcessGroup> interNodeGroup,
+         std::shared_ptr<::c10d::ProcessGroup> globalGroup,
+         bool intraNodeReduceScatter)
+          -> std::shared_ptr<::c10d::ProcessGroup> {
+        const auto rank = globalGroup->getRank();
+        const auto size = globalGroup->getSize();
+        return std::make_shared<::c10d::ProcessGroupHierarchical>(
+            rank,
+            size,
+            std::move(intraNodeGroup),
+            std::move(interNodeGroup),
+            std::move(globalGroup),
+            intraNodeReduceScatter);
+      },
+      py::arg("intra_node_group"),
+      py::arg("inter_node_group"),
+      py::arg("global_group"),
+      py::arg("intra_node_reduce_scatter") = true,
+      py::call_guard<py::gil_scoped_release>());
+
 #ifdef USE_C10D_GLOO
   auto processGroupGloo = shared_ptr_class_<::c10d::ProcessGroupGloo>(
       module, "ProcessGroupGloo", processGroup);
 
   shared_ptr_class_<::gloo::transport::Device>(processGroupGloo, "Device");
 
+  py::enum_<::c10d::ProcessGroupGloo::AllreduceAlgorithm>(
+      processGroupGloo, "AllreduceAlgorithm", R"(
+Algorithm of the allreduces of ``ProcessGroupGloo``: ``AUTO`` lets Gloo pick,
+``RING`` and ``BCUBE`` force one, and ``AUTOTUNE`` benchmarks both for every
+message size, rounded up to a power of two, and keeps the fastest.)")
+      .value("AUTO", ::c10d::ProcessGroupGloo::AllreduceAlgorithm::AUTO)
+      .value("RING", ::c10d::ProcessGroupGloo::AllreduceAlgorithm::RING)
+      .value("BCUBE", ::c10d::ProcessGroupGloo::AllreduceAlgorithm::BCUBE)
+      .value(
+          "AUTOTUNE", ::c10d::ProcessGroupGloo::AllreduceAlgorithm::AUTOTUNE);
+
   shared_ptr_class_<::c10d::ProcessGroupGloo::Options>(
       processGroupGloo, "Options")
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "allreduce_algorithm",
+          &::c10d::ProcessGroupGloo::Options::allreduceAlgorithm);
 
   processGroupGloo.def_static(
       "create_device",
@@ -646,6 +860,28 @@ They are used in specifying strategies for reduction collectives, e.g.,
                   ::c10d::ProcessGroupGloo::createDefaultDevice());
             }
 
+            // Use the allreduce algorithm in "GLOO_ALLREDUCE_ALGORITHM", if
+            // set: "ring", "bcube" or "autotune".
+            char* algorithmEnv = getenv(GLOO_ALLREDUCE_ALGORITHM_ENV);
+            if (algorithmEnv) {
+              const std::string algorithm(algorithmEnv);
+              if (algorithm == "ring") {
+                options.allreduceAlgorithm =
+                    ::c10d::ProcessGroupGloo::AllreduceAlgorithm::RING;
+              } else if (algorithm == "bcube") {
+                options.allreduceAlgorithm =
+                    ::c10d::ProcessGroupGloo::AllreduceAlgorithm::BCUBE;
+              } else if (algorithm == "autotune") {
+                options.allreduceAlgorithm =
+                    ::c10d::ProcessGroupGloo::AllreduceAlgorithm::AUTOTUNE;
+              } else {
+                throw std::invalid_argument(
+                    "Unknown allreduce algorithm in " +
+                    std::string(GLOO_ALLREDUCE_ALGORITHM_ENV) + ": " +
+                    algorithm);
+              }
+            }
+
             options.timeout = timeout;
             options.threads = options.devices.size() * 2;
             return std::make_shared<::c10d::ProcessGroupGloo>(
@@ -654,23 +890,43 @@ They are used in specifying strategies for reduction collectives, e.g.,
           py::arg("store"),
           py::arg("rank"),
           py::arg("size"),
-          py::arg("timeout") = std::chrono::milliseconds(10 * 1000)); // NOLINT
+          py::arg("timeout") = std::chrono::milliseconds(10 * 1000)) // NOLINT
+      .def(
+          "_get_tuned_allreduce_algorithms",
+          &::c10d::ProcessGroupGloo::getTunedAllreduceAlgorithms,
+          py::call_guard<py::gil_scoped_release>());
 #endif
 
 #ifdef USE_C10D_NCCL
-  shared_ptr_class_<::c10d::ProcessGroupNCCL>(
-      module, "ProcessGroupNCCL", processGroup)
+  auto processGroupNCCL =
+      shared_ptr_class_<::c10d::ProcessGroupNCCL>(
+          module, "ProcessGroupNCCL", processGroup)
+          .def(
+              py::init<
+                  const std::shared_ptr<::c10d::Store>&,
+                  int,
+                  int,
+                  const std::chrono::milliseconds&>(),
+              py::arg("store"),
+              py::arg("rank"),
+              py::arg("size"),
+              py::arg("timeout") = std::chrono::milliseconds(
+                  ::c10d::ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis))
+          .def(
+              "_batch_send_recv",
+              &::c10d::ProcessGroupNCCL::batchSendRecv,
+              py::arg("ops"),
+              py::call_guard<py::gil_scoped_release>());
+
+  py::class_<::c10d::ProcessGroupNCCL::P2POp>(processGroupNCCL, "P2POp")
       .def(
-          py::init<
-              const std::shared_ptr<::c10d::Store>&,
-              int,
-              int,
-              const std::chrono::milliseconds&>(),
-          py::arg("store"),
-          py::arg("rank"),
-          py::arg("size"),
-          py::arg("timeout") = std::chrono::milliseconds(
-              ::c10d::ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis));
+          py::init<bool, at::Tensor, int>(),
+          py::arg("is_send"),
+          py::arg("tensor"),
+          py::arg("peer"))
+      .def_readonly("is_send", &::c10d::ProcessGroupNCCL::P2POp::isSend)
+      .def_readonly("tensor", &::c10d::ProcessGroupNCCL::P2POp::tensor)
+      .def_readonly("peer", &::c10d::ProcessGroupNCCL::P2POp::peer);
 #endif
 
 #ifdef USE_C10D_MPI
@@ -30,7 +30,8 @@ Reducer::Reducer(
     std::shared_ptr<c10d::ProcessGroup> process_group,
     std::vector<std::vector<bool>> expect_sparse_gradients,
     int64_t bucket_bytes_cap,
-    bool find_unused_parameters)
+    bool find_unused_parameters,
+    bool gradient_as_bucket_view)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
       expect_sparse_gradients_(std::move(expect_sparse_gradients)),
@@ -39,6 +40,7 @@ Reducer::Reducer(
       next_bucket_(0),
       has_marked_unused_parameters_(false),
       find_unused_parameters_(find_unused_parameters),
+      gradient_as_bucket_view_(gradient_as_bucket_view),
       local_used_maps_reduced_(false),
       backward_stats_base_(0),
       has_rebuilt_bucket_(false),
@@ -181,7 +183,8 @@ Reducer::Reducer(
 // used for algorithms like Gradient Compression/GossipGrad. This hook can be
 // registered from Python API using `register_comm_hook`. `PythonCommHook`
 // enables registering a Python hook and is a sub class of `CommHookInterface`.
-// `CommHookInterface` can be used to implement CPP hooks in the future.
+// The gradient compression hooks of default_comm_hooks.h are implemented in
+// C++ and registered with `_register_builtin_comm_hook`.
 
 Reducer::~Reducer() noexcept(false) {
   // Remove all hooks on variables registered by this Reducer. This is necessary
@@ -324,10 +327,17 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
           bucket_view.toString(),
           ", got ",
           grad.toString());
-      // Assert that the grad tensor and the bucket don't share storage.
-      // If they did, we could avoid the copy altogether.
-      // The reason for not doing this is that existing code calls
-      // `detach_` from `zero_grad`, which is incompatible with views.
+      // imitates wrapped_scalar_tensor in ATen/native/BinaryOps.cpp
+      auto wrapped =
+          c10::scalar_to_tensor(double(1.) / process_group_->getSize());
+      wrapped.unsafeGetTensorImpl()->set_wrapped_number(true);
+      // With gradient_as_bucket_view, AccumulateGrad has accumulated the grad
+      // straight into the bucket: only divide it in place. The grad and the
+      // bucket view only share storage in that case.
+      if (gradient_as_bucket_view_ && grad.is_alias_of(replica.contents)) {
+        grad.mul_(wrapped);
+        return false;
+      }
       TORCH_INTERNAL_ASSERT(!grad.is_alias_of(bucket_view));
       TORCH_INTERNAL_ASSERT(grad.device() == bucket_view.device());
       TORCH_INTERNAL_ASSERT(grad.numel() == bucket_view.numel());
@@ -351,15 +361,19 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
             ", strides() = ",
             bucket_view.strides());
       }
-      // imitates wrapped_scalar_tensor in ATen/native/BinaryOps.cpp
-      auto wrapped =
-          c10::scalar_to_tensor(double(1.) / process_group_->getSize());
-      wrapped.unsafeGetTensorImpl()->set_wrapped_number(true);
       // Divides while copying into the bucket view.
       at::native::mul_out(bucket_view, grad, wrapped);
     } else {
       bucket_view.zero_();
     }
+    if (gradient_as_bucket_view_) {
+      // The grad was reset or replaced, e.g. set to None by the user: point
+      // it at the bucket again. bucket_view may hold the result of a
+      // comm hook instead of the contents.
+      grad = torch::autograd::utils::view_obey_contract(
+          replica.contents, offset, variable);
+      return true;
+    }
     // The grad is not modified and dosesn't need to be written back.
     return false;
   });
@@ -413,22 +427,6 @@ void Reducer::autograd_hook(VariableIndex index) {
     return;
   }
 
-  // Rebuild bucket only if 1) it is the first time to rebuild bucket 2)
-  // find_unused_parameters_ is false, currently it does not support when there
-  // are unused parameters 3) this backward pass needs to run allreduce. Here,
-  // we just dump tensors and their parameter indices into rebuilt_params_ and
-  // rebuilt_param_indices_ based on gradient arriving order, and then at the
-  // end of finalize_backward(), buckets will be rebuilt based on
-  // rebuilt_params_ and rebuilt_param_indices_, and then will be broadcasted
-  // and intialized. Also we only need to dump tensors and parameter indcies of
-  // one replica.
-  if (!has_rebuilt_bucket_ && !find_unused_parameters_ &&
-      index.replica_index == 0) {
-    rebuilt_params_.push_back(
-        replicas_[index.replica_index][index.variable_index]);
-    rebuilt_param_indices_.push_back(index.variable_index);
-  }
-
   // If `find_unused_parameters_` is true there may be model parameters that
   // went unused when computing the model output, they won't be part of the
   // autograd graph, and won't receive gradients. These parameters are
@@ -455,6 +453,23 @@ void Reducer::mark_variable_ready(VariableIndex index) {
   backward_stats_[replica_index][variable_index] =
       current_time_in_nanos() - backward_stats_base_;
 
+  // Rebuild bucket only if 1) it is the first time to rebuild bucket 2) this
+  // backward pass needs to run allreduce (we are only called then). Here, we
+  // just dump tensors and their parameter indices into rebuilt_params_ and
+  // rebuilt_param_indices_ based on gradient arriving order, and then at the
+  // end of finalize_backward(), buckets will be rebuilt based on
+  // rebuilt_params_ and rebuilt_param_indices_, and then will be broadcasted
+  // and intialized. Also we only need to dump tensors and parameter indcies of
+  // one replica.
+  //
+  // Unused parameters are recorded when they are marked ready, that is when
+  // the first gradient arrives, so they end up in the first buckets, which
+  // are reduced without waiting for them.
+  if (!has_rebuilt_bucket_ && replica_index == 0) {
+    rebuilt_params_.push_back(replicas_[replica_index][variable_index]);
+    rebuilt_param_indices_.push_back(variable_index);
+  }
+
   // Any time we mark a variable ready (be it in line due to unused parameters,
   // or via an autograd hook), we require a call to the finalize function. If
   // this doesn't happen before the next iteration (or call to
@@ -547,6 +562,14 @@ void Reducer::mark_variable_ready(VariableIndex index) {
       // Rebuild bucket if this is the first time to rebuild
       if (!rebuilt_params_.empty()) {
         auto rebuilt_bucket_indices = rebuildBuckets();
+        // Keep the buckets, and the grads that may be views of them, if the
+        // gradients arrived in the order they were already laid out in. The
+        // current layout is the same on every rank, and so is the rebuilt one
+        // after sync_bucket_indices(), so all ranks agree here.
+        if (rebuilt_bucket_indices == get_bucket_indices_locked()) {
+          lock.unlock();
+          return;
+        }
         // Unlock before initialize_buckets() as initialize_buckets() requires a
         // lock, it could result in self deadlock without unlocking here.
         lock.unlock();
@@ -594,7 +617,8 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
     if (comm_hook_ == nullptr) {
       bucket.work = process_group_->allreduce(tensors);
     } else {
-      bucket.future_work = comm_hook_->runHook(GradBucket(tensors));
+      bucket.future_work =
+          comm_hook_->runHook(GradBucket(tensors, next_bucket_));
     }
   }
 }
@@ -724,6 +748,9 @@ void Reducer::initialize_buckets(
         // param layouts over time, but not messing with params after DDP
         // construction is already a documented constraint.
         initialize_bucketviews(replica, replica.contents);
+        if (gradient_as_bucket_view_) {
+          set_grads_to_bucketviews(replica);
+        }
       }
 
       // Add bucket replica to enclosing bucket.
@@ -753,22 +780,44 @@ void Reducer::initialize_bucketviews(
     Reducer::BucketReplica& replica,
     at::Tensor& contents) {
   for (size_t i = 0; i < replica.variables.size(); i++) {
-    const auto& v = replica.variables[i];
-    const auto offset = replica.offsets[i];
-    const auto length = replica.lengths[i];
-    if (v.is_non_overlapping_and_dense()) {
-      // If the param's memory is dense, match its layout, anticipating
-      // the autograd engine (AccumulateGrad) will also create gradients
-      // matching its layout.
-      replica.bucket_views.push_back(
-          contents.as_strided(v.sizes(), v.strides(), offset));
-    } else {
-      // Fall back to a C-style contiguous view, again anticipating
-      // AccumulateGrad will do the same when stashing grads for non-dense
-      // params.
-      replica.bucket_views.push_back(
-          contents.narrow(0, offset, length).view(v.sizes()));
-    }
+    // If the param's memory is dense, match its layout, anticipating the
+    // autograd engine (AccumulateGrad) will also create gradients matching
+    // its layout. Otherwise fall back to a C-style contiguous view, again
+    // anticipating AccumulateGrad will do the same when stashing grads for
+    // non-dense params.
+    replica.bucket_views.push_back(torch::autograd::utils::view_obey_contract(
+        contents, replica.offsets[i], replica.variables[i]));
+  }
+}
+
+// Note [Gradient as bucket view]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default, AccumulateGrad stashes every grad in its own tensor, and the
+// reducer copies the grads into the bucket contents before the allreduce,
+// and copies the result back afterwards. With gradient_as_bucket_view, the
+// grad of each param is the bucket view itself: AccumulateGrad accumulates in
+// place into the bucket, mark_variable_ready_dense only divides by the world
+// size, and finalize_bucket_dense has nothing to copy back, unless a comm
+// hook returned the result in other tensors. This saves the copies and the
+// memory of the grads.
+//
+// Code that replaces `.grad` (e.g. setting it to None, or
+// backward(create_graph=True), which accumulates out of place) simply falls
+// back to the copying path for that iteration, after which the grad is made
+// a bucket view again. Optimizers can also work on the flat bucket contents.
+void Reducer::set_grads_to_bucketviews(Reducer::BucketReplica& replica) {
+  for (size_t i = 0; i < replica.variables.size(); i++) {
+    auto& variable = replica.variables[i];
+    const auto& bucket_view = replica.bucket_views[i];
+    runGradCallbackForVariable(variable, [&](auto& grad) {
+      if (grad.defined()) {
+        bucket_view.copy_(grad);
+      } else {
+        bucket_view.zero_();
+      }
+      grad = bucket_view;
+      return true;
+    });
   }
 }
 
@@ -924,6 +973,9 @@ void Reducer::finalize_bucket_dense(Bucket& bucket) {
             // (see torch/csrc/grad/AccumulateGrad.h)
             grad = torch::autograd::utils::clone_obey_contract(
                 bucket_view, variable);
+          } else if (grad.is_alias_of(bucket_view)) {
+            // The reduced values are already in the grad.
+            return false;
           } else {
             grad.copy_(bucket_view);
           }
@@ -950,7 +1002,9 @@ void Reducer::finalize_backward() {
   TORCH_INTERNAL_ASSERT(next_bucket_ == buckets_.size());
 
   // Wait for asynchronous reduction to complete and unflatten contents.
-  for (auto& bucket : buckets_) {
+  for (size_t bucket_index = 0; bucket_index < buckets_.size();
+       bucket_index++) {
+    auto& bucket = buckets_[bucket_index];
     // See Note [DDP Communication Hook]
     if (comm_hook_ == nullptr) {
       TORCH_INTERNAL_ASSERT(
@@ -981,6 +1035,9 @@ void Reducer::finalize_backward() {
       // the allreduce is done, the sparse grads are automatically updated.
       finalize_bucket_dense(bucket);
     }
+    if (bucket_finalized_hook_) {
+      run_bucket_finalized_hook(bucket_index, bucket);
+    }
   }
 
   // See Note [Skip allreducing local_used_maps_dev]
@@ -1002,6 +1059,20 @@ void Reducer::finalize_backward() {
   }
 }
 
+void Reducer::run_bucket_finalized_hook(size_t bucket_index, Bucket& bucket) {
+  auto& replica = bucket.replicas[0];
+  std::vector<at::Tensor> grads;
+  grads.reserve(replica.variables.size());
+  for (auto& variable : replica.variables) {
+    // The grads live in the dist autograd context when there is one.
+    runGradCallbackForVariable(variable, [&](auto& grad) {
+      grads.push_back(grad);
+      return false;
+    });
+  }
+  bucket_finalized_hook_(bucket_index, replica.variables, grads);
+}
+
 void Reducer::runGradCallbackForVariable(
     torch::autograd::Variable& variable,
     GradCallback&& cb) {
@@ -1128,6 +1199,20 @@ std::vector<std::vector<size_t>> Reducer::rebuildBuckets() {
   return rebuilt_bucket_indices;
 }
 
+std::vector<std::vector<size_t>> Reducer::get_bucket_indices() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return get_bucket_indices_locked();
+}
+
+std::vector<std::vector<size_t>> Reducer::get_bucket_indices_locked() const {
+  std::vector<std::vector<size_t>> bucket_indices;
+  bucket_indices.reserve(buckets_.size());
+  for (const auto& bucket : buckets_) {
+    bucket_indices.push_back(bucket.variable_indices);
+  }
+  return bucket_indices;
+}
+
 // See Note [DDP Communication Hook]
 void Reducer::register_comm_hook(std::unique_ptr<CommHookInterface> iface) {
   TORCH_CHECK(
@@ -1136,6 +1221,13 @@ void Reducer::register_comm_hook(std::unique_ptr<CommHookInterface> iface) {
   comm_hook_ = std::move(iface);
 }
 
+void Reducer::register_bucket_finalized_hook(BucketFinalizedHook hook) {
+  TORCH_CHECK(
+      !bucket_finalized_hook_,
+      "register_bucket_finalized_hook can only be called once.");
+  bucket_finalized_hook_ = std::move(hook);
+}
+
 namespace {
 
 // Tensors may be coalesced into buckets. Buckets must contain tensors of
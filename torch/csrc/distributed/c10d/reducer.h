@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <tuple>
@@ -30,7 +31,8 @@ class Reducer {
       std::shared_ptr<c10d::ProcessGroup> process_group,
       std::vector<std::vector<bool>> expect_sparse_gradients,
       int64_t bucket_bytes_cap,
-      bool find_unused_parameters);
+      bool find_unused_parameters,
+      bool gradient_as_bucket_view = false);
 
   ~Reducer() noexcept(false);
 
@@ -54,11 +56,31 @@ class Reducer {
     return backward_stats_;
   }
 
+  // Returns the current bucket assignment, as a list of variable indices per
+  // bucket. After the first backward pass that reduces gradients, the buckets
+  // follow the order in which the gradients of rank 0 were ready.
+  std::vector<std::vector<size_t>> get_bucket_indices();
+
   // Registeres a hook to the reducer. The hook is `CommHookInterface`
   // type to allow both Python and CPP hooks. This function can only
   // be called once before calling backward.
   void register_comm_hook(std::unique_ptr<CommHookInterface> iface);
 
+  // Called at the end of the backward pass for every bucket, in bucket order,
+  // as soon as its reduction completed and the reduced gradients were written
+  // back, with the variables of the bucket in the first replica and their
+  // gradients. It runs before waiting for the reductions of the next buckets,
+  // so that an optimizer can update the variables of a bucket while the
+  // reductions of the next ones are still in flight.
+  using BucketFinalizedHook = std::function<void(
+      size_t bucket_index,
+      const std::vector<torch::autograd::Variable>& variables,
+      const std::vector<at::Tensor>& grads)>;
+
+  // Registers a hook to run on every finalized bucket, see
+  // BucketFinalizedHook. This function can only be called once.
+  void register_bucket_finalized_hook(BucketFinalizedHook hook);
+
  protected:
   // Forward declaration.
   struct Bucket;
@@ -86,6 +108,9 @@ class Reducer {
 
   bool has_marked_unused_parameters_;
   const bool find_unused_parameters_;
+  // If set, the grads of dense params are views of the bucket contents, see
+  // Note [Gradient as bucket view].
+  const bool gradient_as_bucket_view_;
   std::vector<VariableIndex> unused_parameters_;
   // Locally used parameter maps indicating if parameters are used locally
   // during the current iteration or no_sync session if no_sync is on. One
@@ -121,6 +146,8 @@ class Reducer {
 
   void finalize_bucket_dense(Bucket& replica);
 
+  void run_bucket_finalized_hook(size_t bucket_index, Bucket& bucket);
+
   void finalize_backward();
 
   // Broadcast rebuilt buckets from rank 0 to other ranks before initializing
@@ -137,6 +164,9 @@ class Reducer {
   // the performance cost is negligible.
   std::vector<std::vector<size_t>> rebuildBuckets();
 
+  // get_bucket_indices() with mutex_ held
+  std::vector<std::vector<size_t>> get_bucket_indices_locked() const;
+
   using GradCallback =
       torch::distributed::autograd::DistAutogradContext::GradCallback;
   void runGradCallbackForVariable(
@@ -195,6 +225,10 @@ class Reducer {
   // `finalize_backward` call, views must be cleared.
   void initialize_bucketviews(BucketReplica& replica, at::Tensor& contents);
 
+  // Makes the grads of the variables of this replica the bucket views, keeping
+  // their values (see Note [Gradient as bucket view]).
+  void set_grads_to_bucketviews(BucketReplica& replica);
+
   // A bucket holds N bucket replicas (1 per model replica).
   //
   // If every bucket in this struct is ready, the reduction can be kicked off.
@@ -261,6 +295,8 @@ class Reducer {
  private:
   // comm_hook_ is used to access the DDP communication hook if registered.
   std::unique_ptr<CommHookInterface> comm_hook_;
+
+  BucketFinalizedHook bucket_finalized_hook_;
 };
 
 std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
@@ -0,0 +1,537 @@
+#include <torch/csrc/distributed/c10d/sharded_embedding_bag.h>
+
+#include <algorithm>
+#include <numeric>
+
+#include <torch/csrc/autograd/engine.h>
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/functions/utils.h>
+
+namespace c10d {
+
+namespace {
+
+// Modes of at::embedding_bag
+constexpr int64_t kSumMode = 0;
+constexpr int64_t kMeanMode = 1;
+
+std::vector<int64_t> toVector(const at::Tensor& tensor) {
+  const auto cpu = tensor.to(at::kCPU).contiguous();
+  const auto data = cpu.data_ptr<int64_t>();
+  return std::vector<int64_t>(data, data + cpu.numel());
+}
+
+// The number of indices in each bag, for offsets in the format of
+// at::embedding_bag
+at::Tensor bagLengths(const at::Tensor& indices, const at::Tensor& offsets) {
+  if (offsets.numel() == 0) {
+    return offsets.clone();
+  }
+  const auto ends = at::cat(
+      {offsets.slice(0, 1), at::full({1}, indices.numel(), offsets.options())});
+  return ends - offsets;
+}
+
+void alltoall(
+    ProcessGroup& process_group,
+    at::Tensor output,
+    at::Tensor input,
+    std::vector<int64_t> output_sizes,
+    std::vector<int64_t> input_sizes) {
+  process_group.alltoall_base(output, input, output_sizes, input_sizes)
+      ->wait();
+}
+
+// Accumulates the gradient of a shard like AccumulateGrad does, without
+// taking ownership of it.
+void accumulateGrad(at::Tensor& weight, const at::Tensor& grad) {
+  auto& weight_grad = weight.mutable_grad();
+  if (!weight_grad.defined()) {
+    weight_grad = grad;
+  } else if (!weight_grad.is_sparse()) {
+    weight_grad.add_(grad);
+  } else {
+    weight_grad = grad.is_sparse() ? weight_grad + grad : grad + weight_grad;
+  }
+}
+
+// What the backward of a lookup needs, shared with the callback that finishes
+// it at the end of the backward.
+struct LookupState {
+  std::shared_ptr<ProcessGroup> process_group;
+  bool sparse;
+  // The shards of every rank
+  std::vector<std::vector<ShardedEmbeddingBag::Shard>> shards;
+  std::vector<int64_t> embedding_dims;
+  // The weights of the local shards
+  std::vector<at::Tensor> weights;
+  // The number of bags of every rank
+  std::vector<int64_t> batch_sizes;
+  // In mean mode, the number of indices of every bag of the local batch, at
+  // least 1, for every table
+  std::vector<at::Tensor> bag_lengths;
+  // The lookups of the local shards, for at::_embedding_bag_backward
+  struct Lookup {
+    at::Tensor indices;
+    at::Tensor offsets;
+    at::Tensor offset2bag;
+    at::Tensor bag_size;
+    at::Tensor max_indices;
+  };
+  std::vector<Lookup> lookups;
+};
+
+// The sum of the dims of `shards`
+int64_t totalDim(const std::vector<ShardedEmbeddingBag::Shard>& shards) {
+  int64_t dim = 0;
+  for (const auto& shard : shards) {
+    dim += shard.dim;
+  }
+  return dim;
+}
+
+class ShardedEmbeddingBagBackward : public torch::autograd::Node {
+ public:
+  explicit ShardedEmbeddingBagBackward(std::shared_ptr<LookupState> state)
+      : state_(std::move(state)) {}
+
+  torch::autograd::variable_list apply(
+      torch::autograd::variable_list&& grads) override;
+
+ private:
+  std::shared_ptr<LookupState> state_;
+};
+
+// Launches the alltoall of the gradients of the pooled embeddings of the
+// local batch to the ranks holding their shards, and leaves the rest of the
+// backward to a callback at the end of it. The gradients of the weights
+// aren't returned but accumulated by the callback.
+torch::autograd::variable_list ShardedEmbeddingBagBackward::apply(
+    torch::autograd::variable_list&& grads) {
+  auto state = state_;
+  const auto& shards = state->shards;
+  const auto world_size = state->process_group->getSize();
+  const auto rank = state->process_group->getRank();
+  const auto batch_size = state->batch_sizes[rank];
+  const auto num_tables = state->embedding_dims.size();
+
+  // The output may be unused, but the other ranks still wait for its
+  // gradient.
+  auto grad = grads[0];
+  if (!grad.defined()) {
+    grad = at::zeros(
+        {batch_size,
+         std::accumulate(
+             state->embedding_dims.begin(), state->embedding_dims.end(), 0L)},
+        state->weights.front().options());
+  }
+  std::vector<at::Tensor> table_grads;
+  table_grads.reserve(num_tables);
+  int64_t column = 0;
+  for (size_t t = 0; t < num_tables; t++) {
+    auto table_grad = grad.narrow(1, column, state->embedding_dims[t]);
+    if (!state->bag_lengths.empty()) {
+      table_grad = table_grad / state->bag_lengths[t];
+    }
+    table_grads.push_back(table_grad);
+    column += state->embedding_dims[t];
+  }
+
+  // To every rank, the gradients of the tables of its shards side by side,
+  // the same layout as the pooled embeddings it sent.
+  std::vector<at::Tensor> send_pieces;
+  std::vector<int64_t> send_sizes(world_size);
+  std::vector<int64_t> recv_sizes(world_size);
+  for (int d = 0; d < world_size; d++) {
+    std::vector<at::Tensor> columns;
+    for (const auto& shard : shards[d]) {
+      columns.push_back(table_grads[shard.table]);
+    }
+    send_pieces.push_back(at::cat(columns, 1).view(-1));
+    send_sizes[d] = batch_size * totalDim(shards[d]);
+  }
+  const auto local_dim = totalDim(shards[rank]);
+  for (int r = 0; r < world_size; r++) {
+    recv_sizes[r] = state->batch_sizes[r] * local_dim;
+  }
+  auto send = at::cat(send_pieces);
+  auto recv = at::empty(
+      {std::accumulate(recv_sizes.begin(), recv_sizes.end(), 0L)},
+      grad.options());
+  auto work =
+      state->process_group->alltoall_base(recv, send, recv_sizes, send_sizes);
+
+  torch::autograd::Engine::get_default_engine().queue_callback(
+      [state, work, send, recv, recv_sizes, rank, local_dim]() {
+        work->wait();
+        at::NoGradGuard no_grad;
+        const auto& local_shards = state->shards[rank];
+
+        std::vector<at::Tensor> rows;
+        const auto from_ranks = recv.split_with_sizes(recv_sizes);
+        for (size_t r = 0; r < from_ranks.size(); r++) {
+          rows.push_back(
+              from_ranks[r].view({state->batch_sizes[r], local_dim}));
+        }
+        const auto grad_pooled = at::cat(rows);
+
+        int64_t column = 0;
+        for (size_t k = 0; k < local_shards.size(); k++) {
+          const auto& shard = local_shards[k];
+          const auto& lookup = state->lookups[k];
+          const auto grad_weight = at::_embedding_bag_backward(
+              grad_pooled.narrow(1, column, shard.dim).contiguous(),
+              lookup.indices,
+              lookup.offsets,
+              lookup.offset2bag,
+              lookup.bag_size,
+              lookup.max_indices,
+              shard.num_rows,
+              /*scale_grad_by_freq=*/false,
+              kSumMode,
+              state->sparse,
+              /*per_sample_weights=*/at::Tensor());
+          accumulateGrad(state->weights[k], grad_weight);
+          column += shard.dim;
+        }
+      });
+
+  return torch::autograd::variable_list(num_outputs());
+}
+
+} // namespace
+
+ShardedEmbeddingBag::ShardedEmbeddingBag(
+    std::shared_ptr<ProcessGroup> process_group,
+    std::vector<int64_t> num_embeddings,
+    std::vector<int64_t> embedding_dims,
+    ShardingType sharding_type,
+    int64_t mode,
+    bool sparse)
+    : process_group_(std::move(process_group)),
+      num_embeddings_(std::move(num_embeddings)),
+      embedding_dims_(std::move(embedding_dims)),
+      sharding_type_(sharding_type),
+      mode_(mode),
+      sparse_(sparse) {
+  const auto world_size = process_group_->getSize();
+  const auto num_tables = num_embeddings_.size();
+  TORCH_CHECK(
+      num_tables > 0 && embedding_dims_.size() == num_tables,
+      "ShardedEmbeddingBag: expected the number of embeddings and the dim of "
+      "one or more tables, but got ",
+      num_tables,
+      " and ",
+      embedding_dims_.size());
+  for (size_t t = 0; t < num_tables; t++) {
+    TORCH_CHECK(
+        num_embeddings_[t] > 0 && embedding_dims_[t] > 0,
+        "ShardedEmbeddingBag: expected tables with positive sizes, but table ",
+        t,
+        " is ",
+        num_embeddings_[t],
+        " x ",
+        embedding_dims_[t]);
+  }
+  TORCH_CHECK(
+      mode_ == kSumMode || mode_ == kMeanMode,
+      "ShardedEmbeddingBag: only the sum and mean modes are supported");
+
+  shards_.resize(world_size);
+  if (sharding_type_ == ShardingType::TABLE_WISE) {
+    TORCH_CHECK(
+        num_tables >= static_cast<size_t>(world_size),
+        "ShardedEmbeddingBag: table-wise sharding needs a table for every "
+        "rank, but got ",
+        num_tables,
+        " tables for ",
+        world_size,
+        " ranks");
+    // Largest tables first, to the rank with the fewest parameters so far.
+    // This is the same on all ranks.
+    std::vector<size_t> order(num_tables);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return num_embeddings_[a] * embedding_dims_[a] >
+          num_embeddings_[b] * embedding_dims_[b];
+    });
+    std::vector<int64_t> owners(num_tables);
+    std::vector<int64_t> loads(world_size, 0);
+    for (auto t : order) {
+      owners[t] = std::min_element(loads.begin(), loads.end()) - loads.begin();
+      loads[owners[t]] += num_embeddings_[t] * embedding_dims_[t];
+    }
+    for (size_t t = 0; t < num_tables; t++) {
+      shards_[owners[t]].push_back(
+          {static_cast<int64_t>(t), 0, num_embeddings_[t], embedding_dims_[t]});
+    }
+  } else {
+    for (size_t t = 0; t < num_tables; t++) {
+      const auto rows_per_rank =
+          (num_embeddings_[t] + world_size - 1) / world_size;
+      for (int d = 0; d < world_size; d++) {
+        const auto begin = std::min(num_embeddings_[t], d * rows_per_rank);
+        const auto end = std::min(num_embeddings_[t], begin + rows_per_rank);
+        shards_[d].push_back(
+            {static_cast<int64_t>(t), begin, end - begin, embedding_dims_[t]});
+      }
+    }
+  }
+}
+
+const std::vector<ShardedEmbeddingBag::Shard>& ShardedEmbeddingBag::
+    localShards() const {
+  return shards_[process_group_->getRank()];
+}
+
+at::Tensor ShardedEmbeddingBag::forward(
+    const std::vector<at::Tensor>& weights,
+    const std::vector<at::Tensor>& indices,
+    const std::vector<at::Tensor>& offsets) {
+  const auto world_size = process_group_->getSize();
+  const auto rank = process_group_->getRank();
+  const auto num_tables = num_embeddings_.size();
+  const auto& local_shards = shards_[rank];
+  const auto num_local = static_cast<int64_t>(local_shards.size());
+
+  TORCH_CHECK(
+      weights.size() == local_shards.size(),
+      "ShardedEmbeddingBag: expected the weights of the ",
+      local_shards.size(),
+      " shards of this rank, but got ",
+      weights.size());
+  for (size_t k = 0; k < weights.size(); k++) {
+    TORCH_CHECK(
+        weights[k].dim() == 2 &&
+            weights[k].size(0) == local_shards[k].num_rows &&
+            weights[k].size(1) == local_shards[k].dim,
+        "ShardedEmbeddingBag: expected the weight of shard ",
+        k,
+        " to be of size [",
+        local_shards[k].num_rows,
+        ", ",
+        local_shards[k].dim,
+        "], but got ",
+        weights[k].sizes());
+  }
+  TORCH_CHECK(
+      indices.size() == num_tables && offsets.size() == num_tables,
+      "ShardedEmbeddingBag: expected indices and offsets for ",
+      num_tables,
+      " tables, but got ",
+      indices.size(),
+      " and ",
+      offsets.size());
+  const int64_t batch_size = offsets.front().numel();
+  std::vector<at::Tensor> lengths;
+  for (size_t t = 0; t < num_tables; t++) {
+    TORCH_CHECK(
+        indices[t].dim() == 1 && offsets[t].dim() == 1 &&
+            offsets[t].numel() == batch_size,
+        "ShardedEmbeddingBag: expected 1-D indices and offsets, with ",
+        batch_size,
+        " bags for every table, but got indices of size ",
+        indices[t].sizes(),
+        " and offsets of size ",
+        offsets[t].sizes(),
+        " for table ",
+        t);
+    TORCH_CHECK(
+        indices[t].scalar_type() == at::kLong &&
+            offsets[t].scalar_type() == at::kLong,
+        "ShardedEmbeddingBag: expected int64 indices and offsets");
+    // The bad index would only be found on the rank looking it up, and the
+    // other ranks would wait for it forever.
+    TORCH_CHECK(
+        !(indices[t].lt(0) | indices[t].ge(num_embeddings_[t]))
+             .any()
+             .item<bool>(),
+        "ShardedEmbeddingBag: indices of table ",
+        t,
+        " out of range [0, ",
+        num_embeddings_[t],
+        ")");
+    lengths.push_back(bagLengths(indices[t], offsets[t]));
+    TORCH_CHECK(
+        batch_size == 0 ||
+            (offsets[t][0].item<int64_t>() == 0 &&
+             !lengths.back().lt(0).any().item<bool>()),
+        "ShardedEmbeddingBag: expected the offsets of table ",
+        t,
+        " to start at 0 and to be non-decreasing");
+  }
+
+  const bool requires_grad = torch::autograd::GradMode::is_enabled() &&
+      torch::autograd::any_variable_requires_grad(weights);
+  auto state = std::make_shared<LookupState>();
+  at::Tensor output;
+  {
+    at::NoGradGuard no_grad;
+    const auto long_options = indices.front().options();
+
+    // To every rank go, for each of its shards, the lengths of the bags in
+    // the rows of the shard, then the indices in the rows of each of its
+    // shards, relative to the first row. Ahead of that, the number of bags
+    // and of the indices for each of its shards.
+    std::vector<at::Tensor> bags;
+    if (sharding_type_ == ShardingType::ROW_WISE) {
+      for (size_t t = 0; t < num_tables; t++) {
+        bags.push_back(at::repeat_interleave(lengths[t]));
+      }
+    }
+    std::vector<int64_t> counts;
+    std::vector<int64_t> count_send_sizes(world_size);
+    std::vector<int64_t> count_recv_sizes(world_size, 1 + num_local);
+    std::vector<at::Tensor> send_pieces;
+    std::vector<int64_t> send_sizes(world_size);
+    for (int d = 0; d < world_size; d++) {
+      std::vector<at::Tensor> shard_indices;
+      counts.push_back(batch_size);
+      send_sizes[d] = batch_size * shards_[d].size();
+      for (const auto& shard : shards_[d]) {
+        const auto& table_indices = indices[shard.table];
+        if (sharding_type_ == ShardingType::TABLE_WISE) {
+          send_pieces.push_back(lengths[shard.table]);
+          shard_indices.push_back(table_indices);
+        } else {
+          const auto in_shard = table_indices.ge(shard.row_begin)
+                                    .logical_and_(table_indices.lt(
+                                        shard.row_begin + shard.num_rows));
+          send_pieces.push_back(
+              at::zeros({batch_size}, long_options)
+                  .index_add_(0, bags[shard.table], in_shard.to(at::kLong)));
+          shard_indices.push_back(
+              table_indices.masked_select(in_shard) - shard.row_begin);
+        }
+        counts.push_back(shard_indices.back().numel());
+        send_sizes[d] += shard_indices.back().numel();
+      }
+      send_pieces.insert(
+          send_pieces.end(), shard_indices.begin(), shard_indices.end());
+      count_send_sizes[d] = 1 + shards_[d].size();
+    }
+    auto count_recv = at::empty({world_size * (1 + num_local)}, long_options);
+    alltoall(
+        *process_group_,
+        count_recv,
+        at::tensor(counts, at::kLong).to(long_options.device()),
+        count_recv_sizes,
+        count_send_sizes);
+    const auto recv_counts = toVector(count_recv);
+
+    auto& batch_sizes = state->batch_sizes;
+    std::vector<std::vector<int64_t>> num_indices(world_size);
+    std::vector<int64_t> recv_sizes(world_size);
+    for (int r = 0; r < world_size; r++) {
+      const auto first = recv_counts.begin() + r * (1 + num_local);
+      batch_sizes.push_back(*first);
+      num_indices[r].assign(first + 1, first + 1 + num_local);
+      recv_sizes[r] = num_local * batch_sizes[r] +
+          std::accumulate(num_indices[r].begin(), num_indices[r].end(), 0L);
+    }
+    auto indices_recv = at::empty(
+        {std::accumulate(recv_sizes.begin(), recv_sizes.end(), 0L)},
+        long_options);
+    alltoall(
+        *process_group_,
+        indices_recv,
+        at::cat(send_pieces),
+        recv_sizes,
+        send_sizes);
+
+    // Each local shard pools the bags of all ranks, rank by rank.
+    std::vector<std::vector<at::Tensor>> shard_lengths(num_local);
+    std::vector<std::vector<at::Tensor>> shard_indices(num_local);
+    const auto from_ranks = indices_recv.split_with_sizes(recv_sizes);
+    for (int r = 0; r < world_size; r++) {
+      const auto rank_lengths = from_ranks[r]
+                                    .narrow(0, 0, num_local * batch_sizes[r])
+                                    .view({num_local, batch_sizes[r]});
+      const auto rank_indices =
+          from_ranks[r]
+              .narrow(
+                  0,
+                  num_local * batch_sizes[r],
+                  recv_sizes[r] - num_local * batch_sizes[r])
+              .split_with_sizes(num_indices[r]);
+      for (int64_t k = 0; k < num_local; k++) {
+        shard_lengths[k].push_back(rank_lengths[k]);
+        shard_indices[k].push_back(rank_indices[k]);
+      }
+    }
+    std::vector<at::Tensor> pooled;
+    for (int64_t k = 0; k < num_local; k++) {
+      const auto bag_lengths = at::cat(shard_lengths[k]);
+      auto lookup_indices = at::cat(shard_indices[k]);
+      auto lookup_offsets = bag_lengths.cumsum(0) - bag_lengths;
+      auto result = at::embedding_bag(
+          weights[k], lookup_indices, lookup_offsets, false, kSumMode, sparse_);
+      pooled.push_back(std::get<0>(result));
+      if (requires_grad) {
+        state->lookups.push_back({std::move(lookup_indices),
+                                  std::move(lookup_offsets),
+                                  std::move(std::get<1>(result)),
+                                  std::move(std::get<2>(result)),
+                                  std::move(std::get<3>(result))});
+      }
+    }
+
+    // The pooled embeddings go back to the ranks the bags came from: to every
+    // rank, its bags pooled by every local shard, side by side.
+    auto pooled_send = at::cat(pooled, 1);
+    const auto local_dim = pooled_send.size(1);
+    std::vector<int64_t> pooled_send_sizes(world_size);
+    std::vector<int64_t> pooled_recv_sizes(world_size);
+    for (int r = 0; r < world_size; r++) {
+      pooled_send_sizes[r] = batch_sizes[r] * local_dim;
+      pooled_recv_sizes[r] = batch_size * totalDim(shards_[r]);
+    }
+    auto pooled_recv = at::empty(
+        {std::accumulate(
+            pooled_recv_sizes.begin(), pooled_recv_sizes.end(), 0L)},
+        pooled_send.options());
+    alltoall(
+        *process_group_,
+        pooled_recv,
+        pooled_send.view(-1),
+        pooled_recv_sizes,
+        pooled_send_sizes);
+
+    // Row-wise shards are partial sums of the bags.
+    std::vector<at::Tensor> tables(num_tables);
+    const auto from_shards = pooled_recv.split_with_sizes(pooled_recv_sizes);
+    for (int d = 0; d < world_size; d++) {
+      const auto block =
+          from_shards[d].view({batch_size, totalDim(shards_[d])});
+      int64_t column = 0;
+      for (const auto& shard : shards_[d]) {
+        const auto piece = block.narrow(1, column, shard.dim);
+        auto& table = tables[shard.table];
+        table = table.defined() ? table + piece : piece;
+        column += shard.dim;
+      }
+    }
+    if (mode_ == kMeanMode) {
+      for (size_t t = 0; t < num_tables; t++) {
+        state->bag_lengths.push_back(
+            lengths[t].clamp_min(1).to(pooled_send.scalar_type()).unsqueeze(1));
+        tables[t] = tables[t] / state->bag_lengths.back();
+      }
+    }
+    output = at::cat(tables, 1);
+  }
+
+  if (requires_grad) {
+    state->process_group = process_group_;
+    state->sparse = sparse_;
+    state->shards = shards_;
+    state->embedding_dims = embedding_dims_;
+    state->weights = weights;
+    auto grad_fn = std::make_shared<ShardedEmbeddingBagBackward>(state);
+    grad_fn->set_next_edges(torch::autograd::collect_next_edges(weights));
+    torch::autograd::set_history(output, grad_fn);
+  }
+  return output;
+}
+
+} // namespace c10d
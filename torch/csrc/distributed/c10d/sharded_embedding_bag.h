@@ -0,0 +1,85 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// How the tables of a ShardedEmbeddingBag are split over the ranks.
+enum class ShardingType : uint8_t {
+  // Every table lives on a single rank. The tables are assigned largest
+  // first to the rank with the fewest parameters so far.
+  TABLE_WISE,
+  // Every rank holds a contiguous block of the rows of every table, and the
+  // pooled embeddings are the sums of the partial poolings of the blocks.
+  ROW_WISE,
+};
+
+// Several embedding bags ("tables") whose weights are too large for one
+// device, sharded over the ranks of a process group. Every rank calls
+// `forward` with the indices of its own batch for all the tables, in the
+// format of at::embedding_bag, and gets the pooled embeddings of its batch
+// back, concatenated in the order of the tables.
+//
+// The forward exchanges, with ProcessGroup::alltoall_base, first the indices
+// of every rank with the ranks that hold their rows, then the pooled
+// embeddings computed there with at::embedding_bag back to the ranks the bags
+// came from. The backward sends the gradients of the pooled embeddings back
+// the same way. It only launches that alltoall; the engine carries on with
+// the rest of the backward, e.g. of the dense layers and their allreduces by
+// the DDP reducer, while it is in flight. A callback queued at the end of the
+// backward waits for it and accumulates the gradient of the shards with
+// at::_embedding_bag_backward.
+//
+// All ranks have to run the forward and the backward of every lookup, in the
+// same order. The collectives are issued from wherever the autograd engine
+// runs the backward, so the module should get a process group of its own,
+// not the one DDP uses for the dense part. Only the sum and mean modes are
+// supported.
+class TORCH_API ShardedEmbeddingBag {
+ public:
+  // A block of rows of a table
+  struct Shard {
+    int64_t table;
+    // First row of the block in the table
+    int64_t row_begin;
+    int64_t num_rows;
+    int64_t dim;
+  };
+
+  ShardedEmbeddingBag(
+      std::shared_ptr<ProcessGroup> process_group,
+      std::vector<int64_t> num_embeddings,
+      std::vector<int64_t> embedding_dims,
+      ShardingType sharding_type,
+      int64_t mode,
+      bool sparse);
+
+  // The shards of this rank, in the order `forward` takes their weights.
+  const std::vector<Shard>& localShards() const;
+
+  // `weights` are the weights of the local shards, of size num_rows x dim.
+  // `indices` and `offsets` have one 1-D tensor per table: the indices of the
+  // bags of the local batch, and the offsets of the bags in them. All tables
+  // have the same number of bags.
+  at::Tensor forward(
+      const std::vector<at::Tensor>& weights,
+      const std::vector<at::Tensor>& indices,
+      const std::vector<at::Tensor>& offsets);
+
+ private:
+  std::shared_ptr<ProcessGroup> process_group_;
+  std::vector<int64_t> num_embeddings_;
+  std::vector<int64_t> embedding_dims_;
+  ShardingType sharding_type_;
+  int64_t mode_;
+  bool sparse_;
+
+  // The shards of every rank, by table within a rank
+  std::vector<std::vector<Shard>> shards_;
+};
+
+} // namespace c10d
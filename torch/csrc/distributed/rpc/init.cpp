@@ -1,5 +1,6 @@
 #include <torch/csrc/python_headers.h>
 
+#include <torch/csrc/distributed/rpc/pipeline_executor.h>
 #include <torch/csrc/distributed/rpc/process_group_agent.h>
 #include <torch/csrc/distributed/rpc/profiler/remote_profiler_manager.h>
 #include <torch/csrc/distributed/rpc/profiler/server_process_global_profiler.h>
@@ -379,6 +380,33 @@ PyObject* rpc_init(PyObject* /* unused */) {
           // not releasing GIL to avoid context switch
           .def("__repr__", &PyRRef::str);
 
+  shared_ptr_class_<PipelineExecutor>(module, "_PipelineExecutor")
+      .def(
+          py::init([](const std::vector<PyRRef>& stages,
+                      int64_t numMicroBatches,
+                      float rpcTimeoutSeconds) {
+            std::vector<c10::intrusive_ptr<RRef>> rrefs;
+            rrefs.reserve(stages.size());
+            for (const auto& stage : stages) {
+              rrefs.push_back(c10::static_intrusive_pointer_cast<RRef>(
+                  stage.toIValue().toRRef()));
+            }
+            return std::make_shared<PipelineExecutor>(
+                std::move(rrefs), numMicroBatches, rpcTimeoutSeconds);
+          }),
+          py::arg("stages"),
+          py::arg("num_micro_batches"),
+          py::arg("rpc_timeout") = kUnsetRpcTimeout)
+      .def(
+          "forward_async",
+          [](const PipelineExecutor& self, const at::Tensor& input) {
+            return std::make_shared<jit::PythonFutureWrapper>(
+                self.forwardAsync(input));
+          },
+          py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly(
+          "num_micro_batches", &PipelineExecutor::numMicroBatches);
+
   shared_ptr_class_<ProcessGroupRpcBackendOptions>(
       module,
       "ProcessGroupRpcBackendOptions",
@@ -399,34 +427,73 @@ PyObject* rpc_init(PyObject* /* unused */) {
                   :meth:`~torch.distributed.rpc.rpc_async` if necessary.
               init_method (str, optional): The URL to initialize
                   ``ProcessGroupGloo`` (default: ``env://``).
+              max_batch_size (int, optional): The maximum number of messages
+                  to the same destination that ``ProcessGroupAgent`` sends in
+                  one frame (default: 64). Messages sent while the previous
+                  frame to their destination is in flight are batched into
+                  the next one, 1 disables batching.
+              batch_flush_interval (float, optional): The time, in seconds,
+                  that a message may wait for more messages to the same
+                  destination before its frame is sent, unless the frame is
+                  full (default: 0, frames are sent as soon as possible).
       )")
       .def(
-          py::init<int, float, std::string>(),
+          py::init<int, float, std::string, int, float>(),
           py::arg("num_send_recv_threads") = kDefaultNumSendRecvThreads,
           py::arg("rpc_timeout") = kDefaultRpcTimeoutSeconds,
-          py::arg("init_method") = kDefaultInitMethod)
+          py::arg("init_method") = kDefaultInitMethod,
+          py::arg("max_batch_size") = kDefaultMaxBatchSize,
+          py::arg("batch_flush_interval") = kDefaultBatchFlushInterval)
       .def_readwrite(
           "num_send_recv_threads",
           &ProcessGroupRpcBackendOptions::numSendRecvThreads,
           R"(
               The number of threads in the thread-pool used by ProcessGroupAgent.
+          )")
+      .def_readonly(
+          "max_batch_size",
+          &ProcessGroupRpcBackendOptions::maxBatchSize,
+          R"(
+              The maximum number of messages to the same destination sent in
+              one frame by ProcessGroupAgent.
+          )")
+      .def_readonly(
+          "batch_flush_interval",
+          &ProcessGroupRpcBackendOptions::batchFlushInterval,
+          R"(
+              The time, in seconds, that a message may wait for more messages
+              to the same destination before being sent.
           )");
 
   module.attr("_DEFAULT_NUM_SEND_RECV_THREADS") =
       py::cast(kDefaultNumSendRecvThreads);
+  module.attr("_DEFAULT_MAX_BATCH_SIZE") = py::cast(kDefaultMaxBatchSize);
+  module.attr("_DEFAULT_BATCH_FLUSH_INTERVAL") =
+      py::cast(kDefaultBatchFlushInterval);
 
   shared_ptr_class_<ProcessGroupAgent>(module, "ProcessGroupAgent", rpcAgent)
-      .def(py::init([](std::string workerName,
-                       const std::shared_ptr<::c10d::ProcessGroup>& pg,
-                       int numSendRecvThreads,
-                       std::chrono::milliseconds rpcTimeout) {
-        return std::make_unique<ProcessGroupAgent>(
-            std::move(workerName),
-            pg,
-            numSendRecvThreads,
-            rpcTimeout,
-            std::make_unique<RequestCallbackImpl>());
-      }))
+      .def(
+          py::init([](std::string workerName,
+                      const std::shared_ptr<::c10d::ProcessGroup>& pg,
+                      int numSendRecvThreads,
+                      std::chrono::milliseconds rpcTimeout,
+                      int maxBatchSize,
+                      std::chrono::microseconds batchFlushInterval) {
+            return std::make_unique<ProcessGroupAgent>(
+                std::move(workerName),
+                pg,
+                numSendRecvThreads,
+                rpcTimeout,
+                std::make_unique<RequestCallbackImpl>(),
+                maxBatchSize,
+                batchFlushInterval);
+          }),
+          py::arg("name"),
+          py::arg("process_group"),
+          py::arg("num_send_recv_threads"),
+          py::arg("rpc_timeout"),
+          py::arg("max_batch_size") = kDefaultMaxBatchSize,
+          py::arg("batch_flush_interval") = std::chrono::microseconds::zero())
       .def(
           "get_worker_info",
           (const WorkerInfo& (ProcessGroupAgent::*)(void)const) &
@@ -480,6 +547,10 @@ PyObject* rpc_init(PyObject* /* unused */) {
                   store used for rendezvous. It takes any value accepted for the
                   same argument of :meth:`~torch.distributed.init_process_group`
                   (default: ``env://``).
+              device_maps (Dict[str, Dict[int, int]], optional): Device
+                  placement mappings from this worker to the callee, see
+                  :meth:`set_device_map` (default: no mapping, only CPU tensors
+                  can be sent).
       )")
       .def(
           py::init<
@@ -487,12 +558,14 @@ PyObject* rpc_init(PyObject* /* unused */) {
               optional<std::vector<std::string>>,
               optional<std::vector<std::string>>,
               float,
-              std::string>(),
+              std::string,
+              std::unordered_map<std::string, DeviceMap>>(),
           py::arg("num_worker_threads") = kDefaultNumWorkerThreads,
           py::arg("_transports") = optional<std::vector<std::string>>(),
           py::arg("_channels") = optional<std::vector<std::string>>(),
           py::arg("rpc_timeout") = kDefaultRpcTimeoutSeconds,
-          py::arg("init_method") = kDefaultInitMethod)
+          py::arg("init_method") = kDefaultInitMethod,
+          py::arg("device_maps") = std::unordered_map<std::string, DeviceMap>())
       .def_readwrite(
           "num_worker_threads",
           &TensorPipeRpcBackendOptions::numWorkerThreads,
@@ -500,6 +573,51 @@ PyObject* rpc_init(PyObject* /* unused */) {
               The number of threads in the thread-pool used by
               :class:`~torch.distributed.rpc.TensorPipeAgent` to execute
               requests.
+          )")
+      .def_readonly(
+          "device_maps",
+          &TensorPipeRpcBackendOptions::deviceMaps,
+          R"(The device map locations.)")
+      .def(
+          "set_device_map",
+          &TensorPipeRpcBackendOptions::setDeviceMap,
+          py::arg("to"),
+          py::arg("device_map"),
+          R"(
+              Set the device mapping between this worker and the callee
+              ``to``. CUDA tensors on a device in ``device_map`` are sent to
+              the device they are mapped to on the callee, and the CUDA
+              tensors of the responses are sent back with the reverse
+              mapping, so several devices can't be mapped to the same one.
+              The tensors are staged in pinned host memory on both workers.
+              Calling this function several times for the same callee adds
+              to its mapping.
+
+              Arguments:
+                  to (str): Name of the callee.
+                  device_map (Dict[int, int]): Device placement mapping from
+                      this worker to the callee.
+
+              Example::
+                  >>> # both workers
+                  >>> options = TensorPipeRpcBackendOptions(num_worker_threads=8)
+                  >>> options.set_device_map("worker1", {1: 2})
+                  >>> # maps worker0's cuda:1 to worker1's cuda:2
+                  >>>
+                  >>> rpc.init_rpc(
+                  >>>     "worker0",
+                  >>>     rank=0,
+                  >>>     world_size=2,
+                  >>>     backend=rpc.BackendType.TENSORPIPE,
+                  >>>     rpc_backend_options=options
+                  >>> )
+                  >>>
+                  >>> x = torch.ones(2)
+                  >>> rets = rpc.rpc_sync("worker1", torch.add, args=(x.to(1), 1))
+                  >>> # the first argument is moved to cuda:2 on worker1, and
+                  >>> # the result, on cuda:2, is moved back to cuda:1 on
+                  >>> # worker0
+                  >>> print(rets.device)  # cuda:1
           )");
 
   module.attr("_DEFAULT_NUM_WORKER_THREADS") =
@@ -86,6 +86,7 @@ bool Message::isRequest() const {
       MessageType::RREF_USER_DELETE == type_ ||
       MessageType::RREF_CHILD_ACCEPT == type_ ||
       MessageType::RREF_FORK_REQUEST == type_ ||
+      MessageType::RREF_NOTIFICATION_BATCH == type_ ||
       // Autograd message
       MessageType::BACKWARD_AUTOGRAD_REQ == type_ ||
       MessageType::FORWARD_AUTOGRAD_REQ == type_ ||
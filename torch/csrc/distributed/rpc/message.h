@@ -56,6 +56,10 @@ enum MessageType {
   RUN_WITH_PROFILING_REQ = 21,
   RUN_WITH_PROFILING_RESP = 22,
 
+  // Several RREF_USER_DELETE, RREF_FORK_REQUEST or RREF_CHILD_ACCEPT
+  // notifications for the same worker, acked with a single RREF_ACK.
+  RREF_NOTIFICATION_BATCH = 23,
+
   // Other internal message types
   EXCEPTION = 55,
   UNKNOWN = 60
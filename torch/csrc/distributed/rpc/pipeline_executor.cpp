@@ -0,0 +1,153 @@
+#include <torch/csrc/distributed/rpc/pipeline_executor.h>
+
+#include <ATen/ThreadLocalState.h>
+#include <torch/csrc/distributed/autograd/context/container.h>
+#include <torch/csrc/distributed/autograd/utils.h>
+#include <torch/csrc/distributed/rpc/rpc_agent.h>
+#include <torch/csrc/distributed/rpc/script_call.h>
+#include <torch/csrc/distributed/rpc/utils.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+using namespace torch::distributed::autograd;
+
+namespace {
+
+// The callbacks of the FutureMessages run on the threads of the RPC agent,
+// which don't have the autograd context of the caller.
+struct DistAutogradContextGuard {
+  explicit DistAutogradContextGuard(int64_t ctxId) {
+    auto& container = DistAutogradContainer::getInstance();
+    prevCtxId_ = container.currentContextId();
+    container.forceCurrentContextId(ctxId);
+  }
+  ~DistAutogradContextGuard() {
+    auto& container = DistAutogradContainer::getInstance();
+    container.forceCurrentContextId(prevCtxId_);
+  }
+
+  int64_t prevCtxId_;
+};
+
+} // namespace
+
+struct PipelineExecutor::PipelineRun {
+  PipelineRun(
+      const PipelineExecutor& executor,
+      size_t numMicroBatches,
+      int64_t ctxId)
+      : stages(executor.stages_),
+        rpcTimeoutSeconds(executor.rpcTimeoutSeconds_),
+        op(executor.op_),
+        outputs(numMicroBatches),
+        remaining(numMicroBatches),
+        ctxId(ctxId),
+        future(c10::make_intrusive<c10::ivalue::Future>(TensorType::get())) {}
+
+  const std::vector<c10::intrusive_ptr<RRef>> stages;
+  const float rpcTimeoutSeconds;
+  const std::shared_ptr<jit::Operator> op;
+  std::mutex mutex;
+  std::vector<at::Tensor> outputs;
+  size_t remaining;
+  const int64_t ctxId;
+  const c10::intrusive_ptr<c10::ivalue::Future> future;
+};
+
+PipelineExecutor::PipelineExecutor(
+    std::vector<c10::intrusive_ptr<RRef>> stages,
+    int64_t numMicroBatches,
+    float rpcTimeoutSeconds)
+    : stages_(std::move(stages)),
+      numMicroBatches_(numMicroBatches),
+      rpcTimeoutSeconds_(rpcTimeoutSeconds),
+      op_(jit::getOperatorForLiteral(kPipelineStageForwardSchema)) {
+  TORCH_CHECK(!stages_.empty(), "A pipeline needs at least one stage");
+  TORCH_CHECK(
+      numMicroBatches_ > 0,
+      "A pipeline needs a positive number of micro-batches, got ",
+      numMicroBatches_);
+  TORCH_INTERNAL_ASSERT(op_, "Missing operator ", kPipelineStageForwardSchema);
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> PipelineExecutor::forwardAsync(
+    const at::Tensor& input) const {
+  TORCH_CHECK(
+      input.dim() > 0, "The input of a pipeline needs a batch dimension");
+  auto microBatches = input.chunk(numMicroBatches_, /*dim=*/0);
+  auto& container = DistAutogradContainer::getInstance();
+  auto run = std::make_shared<PipelineRun>(
+      *this, microBatches.size(), container.currentContextId());
+
+  // All the micro-batches enter the first stage right away, the RPC agent and
+  // the owner of the stage queue the ones it can't run yet.
+  for (size_t i = 0; i < microBatches.size(); i++) {
+    runStage(run, 0, i, microBatches[i]);
+  }
+  return run->future;
+}
+
+void PipelineExecutor::runStage(
+    const std::shared_ptr<PipelineRun>& run,
+    size_t stage,
+    size_t index,
+    at::Tensor input) {
+  if (run->future->completed()) {
+    // Another micro-batch already failed
+    return;
+  }
+
+  std::shared_ptr<FutureMessage> futMessage;
+  try {
+    auto agent = RpcAgent::getCurrentRpcAgent();
+    const auto& rref = run->stages[stage];
+    std::vector<IValue> stack = {
+        IValue(c10::static_intrusive_pointer_cast<c10::RRefInterface>(rref)),
+        IValue(std::move(input))};
+    ScriptCall scriptCall(run->op, std::move(stack));
+    futMessage = autograd::sendMessageWithAutograd(
+        *agent,
+        agent->getWorkerInfo(rref->owner()),
+        std::move(scriptCall).toMessage(),
+        /*forceGradRecording=*/true,
+        run->rpcTimeoutSeconds);
+  } catch (const std::exception& e) {
+    run->future->setErrorIfNeeded(e.what());
+    return;
+  }
+
+  std::weak_ptr<FutureMessage> wp = futMessage;
+  futMessage->addCallback(
+      at::wrapPropagateTLSState<void>([run, stage, index, wp]() {
+        auto futMessage = wp.lock();
+        if (futMessage->hasError()) {
+          run->future->setErrorIfNeeded(futMessage->error()->what());
+          return;
+        }
+        try {
+          DistAutogradContextGuard ctxGuard(run->ctxId);
+          auto output =
+              deserializeRespToIValue(futMessage->constValue()).toTensor();
+          if (stage + 1 < run->stages.size()) {
+            runStage(run, stage + 1, index, std::move(output));
+            return;
+          }
+
+          std::unique_lock<std::mutex> lock(run->mutex);
+          run->outputs[index] = std::move(output);
+          if (--run->remaining > 0) {
+            return;
+          }
+          lock.unlock();
+          run->future->markCompleted(at::cat(run->outputs, /*dim=*/0));
+        } catch (const std::exception& e) {
+          run->future->setErrorIfNeeded(e.what());
+        }
+      }));
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/distributed/rpc/rref_impl.h>
+#include <torch/csrc/distributed/rpc/types.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// Name of the builtin operator which runs the forward method of the
+// ScriptModule held by an OwnerRRef on a tensor. It is what the
+// PipelineExecutor sends to the owner of every stage.
+constexpr const char* kPipelineStageForwardSchema =
+    "aten::_pipeline_stage_forward(RRef(t) module, Tensor input) -> Tensor";
+
+// Runs a model split in consecutive stages over RPC, with micro-batches flowing
+// through the stages like in GPipe. Every stage is an RRef to a ScriptModule
+// owned by the worker that runs it, and every hop is a builtin ScriptCall, so
+// neither the caller nor the stage owners need the GIL while the pipeline
+// runs.
+//
+// The input is split along dim 0 in numMicroBatches chunks. Every micro-batch
+// is sent to the next stage as soon as it leaves the previous one, so that up
+// to numStages micro-batches are in flight at once. Stages placed on a device
+// run every micro-batch on a stream of the device pool, which lets the copies
+// and kernels of consecutive micro-batches overlap.
+//
+// If it is called within a distributed autograd context, all the RPCs are
+// recorded in it, and the backward pass of the micro-batches can be run with
+// dist_autograd.backward on the concatenated output.
+class TORCH_API PipelineExecutor {
+ public:
+  PipelineExecutor(
+      std::vector<c10::intrusive_ptr<RRef>> stages,
+      int64_t numMicroBatches,
+      float rpcTimeoutSeconds = kUnsetRpcTimeout);
+
+  // Returns a future which is completed with the output of the last stage for
+  // all the micro-batches, concatenated along dim 0, or with the first error
+  // that happened in any of them.
+  c10::intrusive_ptr<c10::ivalue::Future> forwardAsync(
+      const at::Tensor& input) const;
+
+  inline int64_t numMicroBatches() const {
+    return numMicroBatches_;
+  }
+
+ private:
+  struct PipelineRun;
+
+  // Sends the micro-batch at index to the given stage, and hands its output to
+  // the next stage once the response gets back. The run holds everything it
+  // needs, so that it can outlive the executor.
+  static void runStage(
+      const std::shared_ptr<PipelineRun>& run,
+      size_t stage,
+      size_t index,
+      at::Tensor input);
+
+  const std::vector<c10::intrusive_ptr<RRef>> stages_;
+  const int64_t numMicroBatches_;
+  const float rpcTimeoutSeconds_;
+  const std::shared_ptr<jit::Operator> op_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
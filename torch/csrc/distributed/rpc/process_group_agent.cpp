@@ -13,7 +13,12 @@ const std::string kRPCTimeoutErrorStr =
 
 namespace {
 constexpr auto kSecToMsConversion = 1000;
-}
+// A frame starts with a preamble of the source rank, the size of the frame and
+// its number of messages. The frame itself starts with a header of the size,
+// type and id of each message, followed by the serialized messages.
+constexpr int64_t kPreambleSize = 3;
+constexpr int64_t kHeaderItemsPerMessage = 3;
+} // namespace
 
 //////////////////////////  MessageCounter  /////////////////////////////////
 
@@ -99,7 +104,9 @@ ProcessGroupAgent::ProcessGroupAgent(
     std::shared_ptr<c10d::ProcessGroup> pg,
     int numSendRecvThreads,
     std::chrono::milliseconds rpcTimeout,
-    std::unique_ptr<RequestCallback> cb)
+    std::unique_ptr<RequestCallback> cb,
+    int maxBatchSize,
+    std::chrono::microseconds batchFlushInterval)
     : RpcAgent(
           WorkerInfo(std::move(workerName), (int64_t)pg->getRank()),
           std::move(cb),
@@ -109,6 +116,9 @@ ProcessGroupAgent::ProcessGroupAgent(
       recvCounts_(pg_->getSize()),
       nextId_(0),
       sendMutexes_(pg_->getSize()),
+      maxBatchSize_(maxBatchSize),
+      batchFlushInterval_(batchFlushInterval),
+      sendQueues_(pg_->getSize()),
       threadPool_(numSendRecvThreads),
       timeoutThreadEnabled_{false} {
   // initialize metric info counters
@@ -258,6 +268,11 @@ void ProcessGroupAgent::shutdownImpl() {
   }
   futureTimeoutCV_.notify_one();
   futureTimeoutThread_.join();
+  // Don't wait for more messages to batch, rpcAgentRunning_ is now false.
+  {
+    std::lock_guard<std::mutex> lock(sendQueueMutex_);
+  }
+  sendQueueCV_.notify_all();
   // Abort listener thread to stop accepting new work. We need to interrupt the
   // recvWork->wait() call the listener loop may be blocked in before joining
   // the thread.
@@ -389,34 +404,64 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
   return future;
 }
 
-void ProcessGroupAgent::handleSend(const SendWork& work) {
-  auto serializedPayload = std::make_unique<std::string>(std::move(
-      wireSerialize(work.message_.payload(), work.message_.tensors())));
+void ProcessGroupAgent::handleSend(const std::vector<SendWork>& works) {
+  const auto dst = works.front().to_.id_;
+  std::vector<int64_t> header;
+  header.reserve(works.size() * kHeaderItemsPerMessage);
+  std::vector<std::string> serializedPayloads;
+  serializedPayloads.reserve(works.size());
+  size_t frameSize = 0;
+  for (const auto& work : works) {
+    try {
+      serializedPayloads.emplace_back(
+          wireSerialize(work.message_.payload(), work.message_.tensors()));
+    } catch (std::exception& e) {
+      handleSendError(work, e);
+      continue;
+    }
+    header.push_back(serializedPayloads.back().size());
+    header.push_back((int64_t)work.message_.type());
+    header.push_back(work.message_.id());
+    frameSize += serializedPayloads.back().size();
+  }
+  if (serializedPayloads.empty()) {
+    return;
+  }
+
+  const size_t headerSize = header.size() * sizeof(int64_t);
+  frameSize += headerSize;
+  auto serializedFrame = std::make_unique<std::string>();
+  serializedFrame->reserve(frameSize);
+  serializedFrame->append(
+      reinterpret_cast<const char*>(header.data()), headerSize);
+  for (const auto& serializedPayload : serializedPayloads) {
+    serializedFrame->append(serializedPayload);
+  }
 
   std::vector<torch::Tensor> preamble = {torch::tensor(
       {(int64_t)pg_->getRank(),
-       (int64_t)serializedPayload->length(),
-       (int64_t)work.message_.type(),
-       (int64_t)work.message_.id()},
+       (int64_t)serializedFrame->length(),
+       (int64_t)serializedPayloads.size()},
       {torch::kInt64})};
 
   // ProcessGroup is not thread-safe when sending with the same tag,
   // hence the lock
   std::vector<std::shared_ptr<c10d::ProcessGroup::Work>> pendingSends;
-  const auto dst = work.to_.id_;
 
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
-  auto serializedPayloadData = const_cast<char*>(serializedPayload->data());
-  auto serializedPayloadSize = serializedPayload->size();
-  std::string* deleteWhenDone = serializedPayload.release();
+  auto serializedFrameData = const_cast<char*>(serializedFrame->data());
+  auto serializedFrameSize = serializedFrame->size();
+  std::string* deleteWhenDone = serializedFrame.release();
   std::vector<torch::Tensor> payload = {torch::from_blob(
-      reinterpret_cast<void*>(serializedPayloadData),
-      serializedPayloadSize,
+      reinterpret_cast<void*>(serializedFrameData),
+      serializedFrameSize,
       [deleteWhenDone](void*) { delete deleteWhenDone; },
       {torch::kChar})};
   pendingSends.reserve(2);
 
-  sendCounts_.increment(dst);
+  for (size_t i = 0; i < serializedPayloads.size(); ++i) {
+    sendCounts_.increment(dst);
+  }
 
   {
     std::lock_guard<std::mutex> guard(sendMutexes_[dst]);
@@ -451,6 +496,66 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
   }
 }
 
+void ProcessGroupAgent::handleSendError(
+    const SendWork& work,
+    const std::exception& e) {
+  auto errorStr = c10::str(
+      "Encountered exception in ProcessGroupAgent::enqueueSend: ",
+      e.what(),
+      " on node: ",
+      RpcAgent::getWorkerInfo().id_);
+  auto exceptionMsg =
+      rpc::createExceptionResponse(errorStr, work.message_.id());
+  if (work.message_.isRequest()) {
+    // Mark the future with corresponding to this request with an error.
+    markFutureWithError(exceptionMsg);
+  } else if (work.message_.isResponse()) {
+    // Try sending the error along.
+    try {
+      handleSend({SendWork(work.to_, std::move(exceptionMsg))});
+    } catch (std::exception& sendError) {
+      LOG(WARNING) << "Failed to send the error of response #"
+                   << work.message_.id() << " to worker " << work.to_.id_
+                   << ": " << sendError.what();
+    }
+  }
+}
+
+void ProcessGroupAgent::flushSendQueue(worker_id_t dst) {
+  while (true) {
+    std::vector<SendWork> works;
+    {
+      std::unique_lock<std::mutex> lock(sendQueueMutex_);
+      auto& queue = sendQueues_[dst];
+      if (!queue.works_.empty() && batchFlushInterval_.count() > 0) {
+        // Give the next messages a chance to join this frame
+        sendQueueCV_.wait_for(lock, batchFlushInterval_, [&] {
+          return queue.works_.size() >= maxBatchSize_ ||
+              !rpcAgentRunning_.load();
+        });
+      }
+      if (queue.works_.empty()) {
+        queue.flushing_ = false;
+        return;
+      }
+      const auto numWorks = std::min(queue.works_.size(), maxBatchSize_);
+      works.reserve(numWorks);
+      for (size_t i = 0; i < numWorks; ++i) {
+        works.emplace_back(std::move(queue.works_.front()));
+        queue.works_.pop_front();
+      }
+    }
+
+    try {
+      handleSend(works);
+    } catch (std::exception& e) {
+      for (const auto& work : works) {
+        handleSendError(work, e);
+      }
+    }
+  }
+}
+
 void ProcessGroupAgent::sendToSelf(Message&& message) {
   threadPool_.run(std::bind(
       [this](const Message& message) {
@@ -485,34 +590,31 @@ void ProcessGroupAgent::sendToSelf(Message&& message) {
 }
 
 void ProcessGroupAgent::enqueueSend(SendWork work) {
-  // NB: this can be changed to use a native move capture when moved to C++14
-  threadPool_.run(std::bind(
-      [this](const SendWork& work) {
-        try {
-          handleSend(work);
-        } catch (std::exception& e) {
-          auto errorStr = c10::str(
-              "Encountered exception in ProcessGroupAgent::enqueueSend: ",
-              e.what(),
-              " on node: ",
-              RpcAgent::getWorkerInfo().id_);
-          auto exceptionMsg =
-              rpc::createExceptionResponse(errorStr, work.message_.id());
-          if (work.message_.isRequest()) {
-            // Mark the future with corresponding to this request with an error.
-            markFutureWithError(exceptionMsg);
-          } else if (work.message_.isResponse()) {
-            // Try sending the error along.
-            handleSend(SendWork(work.to_, std::move(exceptionMsg)));
-          }
-        }
-      },
-      std::move(work)));
+  const auto dst = work.to_.id_;
+  bool scheduleFlush = false;
+  bool batchFull = false;
+  {
+    std::lock_guard<std::mutex> lock(sendQueueMutex_);
+    auto& queue = sendQueues_[dst];
+    queue.works_.emplace_back(std::move(work));
+    if (!queue.flushing_) {
+      queue.flushing_ = true;
+      scheduleFlush = true;
+    } else {
+      batchFull = queue.works_.size() >= maxBatchSize_;
+    }
+  }
+  if (batchFull) {
+    sendQueueCV_.notify_all();
+  }
+  if (scheduleFlush) {
+    threadPool_.run([this, dst]() { flushSendQueue(dst); });
+  }
 }
 
 bool ProcessGroupAgent::handleRecv(RecvWork& work) {
   torch::Tensor& payload = work.payload_;
-  auto data = wireDeserialize(payload.storage().data(), payload.numel());
+  auto data = wireDeserialize(payload.data_ptr(), payload.numel());
   Message message(
       std::move(data.first), std::move(data.second), work.type_, work.id_);
   if (message.isRequest()) {
@@ -715,8 +817,9 @@ void ProcessGroupAgent::listenLoop() {
 
 void ProcessGroupAgent::listenLoopInternal() {
   while (rpcAgentRunning_.load()) {
-    // rank, tensor size, message type
-    std::vector<torch::Tensor> preamble = {torch::empty({4}, {torch::kInt64})};
+    // rank, frame size, number of messages
+    std::vector<torch::Tensor> preamble = {
+        torch::empty({kPreambleSize}, {torch::kInt64})};
     auto work = pg_->recvAnysource(preamble, pg_->getRank());
     {
       // Write class variable so it can be aborted by shutdown()
@@ -732,8 +835,7 @@ void ProcessGroupAgent::listenLoopInternal() {
 
     auto srcRank = preamble_items[0];
     auto size = preamble_items[1];
-    MessageType type = MessageType(preamble_items[2]);
-    int64_t id = preamble_items[3];
+    auto numMessages = preamble_items[2];
 
     std::vector<torch::Tensor> tensors = {torch::empty({size}, {torch::kChar})};
     work = pg_->recv(tensors, srcRank, pg_->getRank());
@@ -747,8 +849,24 @@ void ProcessGroupAgent::listenLoopInternal() {
       return;
     }
 
-    enqueueRecv(
-        RecvWork(allWorkerInfo_[srcRank], type, id, std::move(tensors[0])));
+    // Every message of the frame is processed separately, they share the
+    // frame as storage.
+    const auto& frame = tensors[0];
+    std::vector<int64_t> header(numMessages * kHeaderItemsPerMessage);
+    const int64_t headerSize = header.size() * sizeof(int64_t);
+    memcpy(header.data(), frame.data_ptr(), headerSize);
+    int64_t offset = headerSize;
+    for (int64_t i = 0; i < numMessages; ++i) {
+      const auto messageSize = header[i * kHeaderItemsPerMessage];
+      MessageType type = MessageType(header[i * kHeaderItemsPerMessage + 1]);
+      int64_t id = header[i * kHeaderItemsPerMessage + 2];
+      enqueueRecv(RecvWork(
+          allWorkerInfo_[srcRank],
+          type,
+          id,
+          frame.narrow(0, offset, messageSize)));
+      offset += messageSize;
+    }
   }
 }
 
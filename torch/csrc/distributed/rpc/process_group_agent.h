@@ -6,6 +6,7 @@
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 
 #include <atomic>
+#include <deque>
 #include <thread>
 
 namespace torch {
@@ -13,22 +14,41 @@ namespace distributed {
 namespace rpc {
 
 constexpr auto kDefaultNumSendRecvThreads = 4;
+constexpr auto kDefaultMaxBatchSize = 64;
+constexpr float kDefaultBatchFlushInterval = 0;
 
 struct ProcessGroupRpcBackendOptions : public RpcBackendOptions {
   ProcessGroupRpcBackendOptions(
       int num_send_recv_threads,
       float rpc_timeout,
-      std::string init_method)
+      std::string init_method,
+      int max_batch_size = kDefaultMaxBatchSize,
+      float batch_flush_interval = kDefaultBatchFlushInterval)
       : RpcBackendOptions(rpc_timeout, init_method),
-        numSendRecvThreads(num_send_recv_threads) {
+        numSendRecvThreads(num_send_recv_threads),
+        maxBatchSize(max_batch_size),
+        batchFlushInterval(batch_flush_interval) {
     TORCH_CHECK(
         num_send_recv_threads > 0,
         "Cannot create ProcessGroup RPC backend with ",
         num_send_recv_threads,
         " threads in the thread-pool.");
+    TORCH_CHECK(
+        max_batch_size > 0,
+        "max_batch_size must be positive, got ",
+        max_batch_size);
+    TORCH_CHECK(
+        batch_flush_interval >= 0,
+        "batch_flush_interval must be non-negative, got ",
+        batch_flush_interval);
   }
 
   int numSendRecvThreads;
+  // Maximum number of messages to the same destination sent in one frame
+  int maxBatchSize;
+  // Time, in seconds, that a message may wait for others to the same
+  // destination before its frame is sent
+  float batchFlushInterval;
 };
 
 // SendWork and RecvWork will be put into a task queue, and later picked up by
@@ -64,7 +84,10 @@ class TORCH_API ProcessGroupAgent : public RpcAgent {
       std::shared_ptr<c10d::ProcessGroup> pg,
       int numSendRecvThreads,
       std::chrono::milliseconds rpcTimeout,
-      std::unique_ptr<RequestCallback> cb);
+      std::unique_ptr<RequestCallback> cb,
+      int maxBatchSize = kDefaultMaxBatchSize,
+      std::chrono::microseconds batchFlushInterval =
+          std::chrono::microseconds::zero());
 
   const WorkerInfo& getWorkerInfo(const std::string& workerName) const override;
 
@@ -86,14 +109,15 @@ class TORCH_API ProcessGroupAgent : public RpcAgent {
 
  protected:
   // This method wraps the destination information and the message into a
-  // SendWork object, and put the SendWork into a queue. Another thread will
-  // consume SendWork from the queue and send it out.
+  // SendWork object, and put the SendWork into the queue of its destination.
+  // Another thread will consume SendWorks from the queue and send them out.
   std::shared_ptr<FutureMessage> send(
       const WorkerInfo& to,
       Message&& message,
       const float rpcTimeoutSeconds = kUnsetRpcTimeout) override;
 
-  // put SendWork into a queue and notify the worker thread
+  // put SendWork into the queue of its destination, and schedule a flush of
+  // that queue if none is running
   virtual void enqueueSend(SendWork work);
   // Bypass handleSend() logic and send a message to self rank
   virtual void sendToSelf(Message&& message);
@@ -146,11 +170,25 @@ class TORCH_API ProcessGroupAgent : public RpcAgent {
     FutureInfo() = delete;
   };
 
+  // The messages waiting to be sent to a destination. At most one flush of
+  // the queue runs at a time, so the messages are sent in order, and the ones
+  // enqueued while a frame is being sent are batched into the next frame.
+  struct SendQueue {
+    std::deque<SendWork> works_;
+    bool flushing_{false};
+  };
+
   void collectNames();
-  // handle a SendWork request. This serializes the payload inside the work
-  // object, and sends the message to the receiver using the underlying
-  // ProcessGroup.
-  void handleSend(const SendWork& work);
+  // handle a batch of SendWork requests to the same destination. This
+  // serializes the messages and sends them to the receiver in one frame
+  // using the underlying ProcessGroup.
+  void handleSend(const std::vector<SendWork>& works);
+  // Marks the future of a request that could not be sent with an error, or
+  // sends the error along for a response.
+  void handleSendError(const SendWork& work, const std::exception& e);
+  // Sends the messages queued for dst in frames of up to maxBatchSize_
+  // messages, until its queue is empty.
+  void flushSendQueue(worker_id_t dst);
   // put RecvWork into a queue and notify the worker thread
   void enqueueRecv(RecvWork work);
   // handle a RecvWork request. Return true if we should increment recvCounts,
@@ -224,6 +262,14 @@ class TORCH_API ProcessGroupAgent : public RpcAgent {
   // one mutex per ProcessGroup rank, as ProcessGroup::send is not thread-safe
   // when using the same tag.
   std::vector<std::mutex> sendMutexes_;
+  // Message batching knobs, see ProcessGroupRpcBackendOptions.
+  const size_t maxBatchSize_;
+  const std::chrono::microseconds batchFlushInterval_;
+  // One queue of messages to send per ProcessGroup rank, the mutex guards all
+  // of them and the CV signals that a queue holds a full batch.
+  std::vector<SendQueue> sendQueues_;
+  std::mutex sendQueueMutex_;
+  std::condition_variable sendQueueCV_;
   std::thread listenerThread_;
   // A thread to poll existing futures and check for timed out ones.
   std::thread futureTimeoutThread_;
@@ -362,6 +362,35 @@ void RequestCallbackNoPython::processRpc(
       markComplete(RRefAck().toMessage());
       return;
     }
+    case MessageType::RREF_NOTIFICATION_BATCH: {
+      auto& rnb = static_cast<RRefNotificationBatch&>(rpc);
+      auto& ctx = RRefContext::getInstance();
+      for (const auto& notification : rnb.notifications()) {
+        switch (notification.type) {
+          case MessageType::RREF_USER_DELETE: {
+            auto deletedRRef =
+                ctx.delForkOfOwner(notification.rrefId, notification.forkId);
+            handleRRefDelete(deletedRRef);
+            break;
+          }
+          case MessageType::RREF_CHILD_ACCEPT: {
+            ctx.delPendingChild(notification.forkId);
+            break;
+          }
+          case MessageType::RREF_FORK_REQUEST: {
+            ctx.addForkOfOwnerIfNotPresent(
+                notification.rrefId, notification.forkId);
+            break;
+          }
+          default: {
+            TORCH_INTERNAL_ASSERT(
+                false, "Unexpected notification type ", notification.type);
+          }
+        }
+      }
+      markComplete(RRefAck().toMessage());
+      return;
+    }
     case MessageType::FORWARD_AUTOGRAD_REQ: {
       auto& rpcWithAutograd = static_cast<RpcWithAutograd&>(rpc);
 
@@ -11,6 +11,12 @@ namespace rpc {
 thread_local std::vector<std::shared_ptr<RRefContext::PendingUserState>>
     RRefContext::userTable_;
 thread_local bool RRefContext::recording_ = false;
+thread_local std::
+    unordered_map<worker_id_t, std::vector<RRefContext::ForkNotification>>
+        RRefContext::forkRequestTable_;
+thread_local std::
+    unordered_map<worker_id_t, std::vector<RRefContext::ForkNotification>>
+        RRefContext::childAcceptTable_;
 
 namespace callback {
 void confirmPendingUser(
@@ -75,6 +81,7 @@ const std::string kNumOwnerRRefs = "num_owner_rrefs";
 const std::string kNumPendingFutures = "num_pending_futures";
 const std::string kNumPendingUsers = "num_pending_users";
 const std::string kNumForks = "num_forks";
+const std::string kNumPendingUserDeletes = "num_pending_user_deletes";
 
 RRefContext& RRefContext::getInstance() {
   // Leaky singleton to avoid module destructor races.
@@ -89,6 +96,14 @@ std::vector<c10::intrusive_ptr<RRef>> RRefContext::destroyInstance(
     std::lock_guard<std::mutex> lock(ctx.destroyedMutex_);
     ctx.destroyed_ = true;
   }
+  {
+    std::lock_guard<std::mutex> lock(ctx.userDeleteMutex_);
+    ctx.stopFlushingUserDeletes_ = true;
+  }
+  ctx.userDeleteCV_.notify_all();
+  if (ctx.userDeleteFlushThread_.joinable()) {
+    ctx.userDeleteFlushThread_.join();
+  }
   ctx.checkRRefLeaks(ignoreRRefLeak);
   std::vector<c10::intrusive_ptr<RRef>> deletedRRefs;
   for (auto& entry : ctx.owners_) {
@@ -130,10 +145,18 @@ std::unordered_map<std::string, std::string> RRefContext::getDebugInfo() {
     numForks += owner.second.size();
   }
   lock.unlock();
+  size_t numPendingUserDeletes = 0;
+  {
+    std::lock_guard<std::mutex> deleteLock(userDeleteMutex_);
+    for (const auto& owner : pendingUserDeletes_) {
+      numPendingUserDeletes += owner.second.size();
+    }
+  }
   info[kNumOwnerRRefs] = c10::to_string(ownerSize);
   info[kNumPendingFutures] = c10::to_string(numPendingFutures_.load());
   info[kNumPendingUsers] = c10::to_string(numPendingUsers);
   info[kNumForks] = c10::to_string(numForks);
+  info[kNumPendingUserDeletes] = c10::to_string(numPendingUserDeletes);
   return info;
 }
 
@@ -207,16 +230,34 @@ void RRefContext::delUser(
     if (!destroyed_) {
       // Sending an RRefUserDelete causes the receiver to run delForkOfOwner,
       // which is now idempotent. See the comment at RRefContext::delForkOfOwner
-      // for more details.
+      // for more details. Delaying it only keeps the OwnerRRef alive a bit
+      // longer, as this UserRRef has no pending child anymore.
+      // NB: the queued notification counts as a pending future, until the
+      // owner acks the message carrying it.
       ++numPendingFutures_;
-      auto fm = agent_->sendWithRetries(
-          agent_->getWorkerInfo(owner),
-          RRefUserDelete(rrefId, forkId).toMessage());
-
-      fm->addCallback([this](const FutureMessage& fm) {
-        handleException(fm);
-        --numPendingFutures_;
-      });
+      std::vector<Notification> batch;
+      {
+        std::lock_guard<std::mutex> deleteLock(userDeleteMutex_);
+        auto& deletes = pendingUserDeletes_[owner];
+        deletes.push_back({MessageType::RREF_USER_DELETE, rrefId, forkId});
+        if (deletes.size() >= kMaxUserDeleteBatchSize) {
+          batch.swap(deletes);
+          pendingUserDeletes_.erase(owner);
+        } else if (!userDeleteFlushThread_.joinable()) {
+          userDeleteFlushThread_ =
+              std::thread(&RRefContext::userDeleteFlushLoop, this);
+        }
+      }
+      if (batch.empty()) {
+        userDeleteCV_.notify_one();
+      } else {
+        const auto numDeletes = batch.size();
+        auto fm = sendNotifications(owner, std::move(batch));
+        fm->addCallback([this, numDeletes](const FutureMessage& fm) {
+          handleException(fm);
+          numPendingFutures_ -= numDeletes;
+        });
+      }
     }
   }
 
@@ -224,6 +265,106 @@ void RRefContext::delUser(
   confirmedUsers_.erase(forkId);
 }
 
+void RRefContext::flushUserDeletes() {
+  std::unordered_map<worker_id_t, std::vector<Notification>> deletes;
+  {
+    std::lock_guard<std::mutex> lock(userDeleteMutex_);
+    deletes.swap(pendingUserDeletes_);
+  }
+  if (deletes.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(destroyedMutex_);
+  for (auto& entry : deletes) {
+    const auto numDeletes = entry.second.size();
+    if (destroyed_) {
+      numPendingFutures_ -= numDeletes;
+      continue;
+    }
+    auto fm = sendNotifications(entry.first, std::move(entry.second));
+    fm->addCallback([this, numDeletes](const FutureMessage& fm) {
+      handleException(fm);
+      numPendingFutures_ -= numDeletes;
+    });
+  }
+}
+
+void RRefContext::userDeleteFlushLoop() {
+  std::unique_lock<std::mutex> lock(userDeleteMutex_);
+  while (!stopFlushingUserDeletes_) {
+    userDeleteCV_.wait(lock, [this] {
+      return stopFlushingUserDeletes_ || !pendingUserDeletes_.empty();
+    });
+    // Give the next deletes some time to join the queued ones.
+    userDeleteCV_.wait_for(lock, kUserDeleteFlushInterval, [this] {
+      return stopFlushingUserDeletes_;
+    });
+    lock.unlock();
+    flushUserDeletes();
+    lock.lock();
+  }
+}
+
+void RRefContext::setMetricsConfig(const RpcMetricsConfig& config) {
+  std::shared_ptr<RpcMetricsHandler> handler;
+  if (config.enabled_) {
+    handler = RpcMetricsHandlerRegistry()->Create(config.handlerName_);
+    TORCH_CHECK(
+        handler, "No RpcMetricsHandler registered as ", config.handlerName_);
+  }
+  std::lock_guard<std::mutex> lock(metricsMutex_);
+  metricsHandler_ = std::move(handler);
+}
+
+std::shared_ptr<FutureMessage> RRefContext::sendNotifications(
+    worker_id_t dst,
+    std::vector<Notification> notifications) {
+  TORCH_INTERNAL_ASSERT(!notifications.empty());
+  const auto numNotifications = notifications.size();
+  Message message;
+  if (numNotifications == 1) {
+    const auto& notification = notifications.front();
+    switch (notification.type) {
+      case MessageType::RREF_USER_DELETE: {
+        message = RRefUserDelete(notification.rrefId, notification.forkId)
+                      .toMessage();
+        break;
+      }
+      case MessageType::RREF_FORK_REQUEST: {
+        message = RRefForkRequest(notification.rrefId, notification.forkId)
+                      .toMessage();
+        break;
+      }
+      case MessageType::RREF_CHILD_ACCEPT: {
+        message = RRefChildAccept(notification.forkId).toMessage();
+        break;
+      }
+      default: {
+        TORCH_INTERNAL_ASSERT(
+            false, "Unexpected notification type ", notification.type);
+      }
+    }
+  } else {
+    message = RRefNotificationBatch(std::move(notifications)).toMessage();
+  }
+
+  std::shared_ptr<RpcMetricsHandler> handler;
+  {
+    std::lock_guard<std::mutex> lock(metricsMutex_);
+    handler = metricsHandler_;
+  }
+  if (handler) {
+    handler->incrementMetric(
+        std::string(kRpcMetricsKeyPrefix) + kRRefControlMessagesMetric);
+    handler->accumulateMetric(
+        std::string(kRpcMetricsKeyPrefix) + kRRefNotificationsPerMessageMetric,
+        numNotifications);
+  }
+  return agent_->sendWithRetries(
+      agent_->getWorkerInfo(dst), std::move(message));
+}
+
 void RRefContext::delAllUsersAndUnforkedOwners(
     std::chrono::milliseconds timeoutMillis) {
   // First, wait for all pending UserRRefs to be confirmed,
@@ -255,6 +396,7 @@ void RRefContext::delAllUsersAndUnforkedOwners(
     // tryDel() below will re-acquire lock, lock must be released here.
     rref_ptr->tryDel();
   }
+  flushUserDeletes();
 
   // If an rref in the owners_ map has never been forked, we will never get a
   // corresponding message from the forking node(s) telling us to delete the
@@ -482,28 +624,76 @@ void RRefContext::notifyOwnerAndParentOfFork(
     // In this case, the owner is the caller, and it does not add the fork id
     // into forks_. Because, there will be no real `UserRRef` associated
     // with this fork ID.
-    ++numPendingFutures_;
-    auto fm = agent_->sendWithRetries(
-        agent_->getWorkerInfo(parent), RRefChildAccept(forkId).toMessage());
-    fm->addCallback([this](const FutureMessage& fm) {
-      handleException(fm);
-      --numPendingFutures_;
-    });
+    ForkNotification childAccept{rref->rrefId(), forkId, parent};
+    if (recording_) {
+      childAcceptTable_[parent].push_back(childAccept);
+    } else {
+      sendChildAccepts(parent, {childAccept});
+    }
   } else {
-    ++numPendingFutures_;
-    auto fm = agent_->sendWithRetries(
-        agent_->getWorkerInfo(rref->owner()),
-        RRefForkRequest(rref->rrefId(), forkId).toMessage());
-
     addPendingUser(forkId, rref);
-    fm->addCallback([this, forkId, parent](const FutureMessage& fm) {
-      handleException(fm);
-      this->finishForkRequest(forkId, parent);
-      // Decrease after calling finishForkRequest because, as that creates a new
-      // future, it might otherwise cause the count to briefly go to zero.
-      --numPendingFutures_;
-    });
+    ForkNotification forkRequest{rref->rrefId(), forkId, parent};
+    if (recording_) {
+      forkRequestTable_[rref->owner()].push_back(forkRequest);
+    } else {
+      sendForkRequests(rref->owner(), {forkRequest});
+    }
+  }
+}
+
+void RRefContext::sendForkRequests(
+    worker_id_t owner,
+    std::vector<ForkNotification> forkRequests) {
+  std::vector<Notification> notifications;
+  notifications.reserve(forkRequests.size());
+  for (const auto& forkRequest : forkRequests) {
+    notifications.push_back(
+        {MessageType::RREF_FORK_REQUEST,
+         forkRequest.rrefId,
+         forkRequest.forkId});
+  }
+
+  ++numPendingFutures_;
+  auto fm = sendNotifications(owner, std::move(notifications));
+  fm->addCallback([this, forkRequests = std::move(forkRequests)](
+                      const FutureMessage& fm) {
+    handleException(fm);
+    this->finishForkRequests(forkRequests);
+    // Decrease after calling finishForkRequests because, as that creates new
+    // futures, it might otherwise cause the count to briefly go to zero.
+    --numPendingFutures_;
+  });
+}
+
+void RRefContext::sendChildAccepts(
+    worker_id_t parent,
+    const std::vector<ForkNotification>& childAccepts) {
+  std::vector<Notification> notifications;
+  notifications.reserve(childAccepts.size());
+  for (const auto& childAccept : childAccepts) {
+    notifications.push_back(
+        {MessageType::RREF_CHILD_ACCEPT,
+         childAccept.rrefId,
+         childAccept.forkId});
+  }
+
+  ++numPendingFutures_;
+  auto fm = sendNotifications(parent, std::move(notifications));
+  fm->addCallback([this](const FutureMessage& fm) {
+    handleException(fm);
+    --numPendingFutures_;
+  });
+}
+
+void RRefContext::sendThreadLocalForkNotifications() {
+  for (auto& entry : forkRequestTable_) {
+    sendForkRequests(entry.first, std::move(entry.second));
+  }
+  forkRequestTable_.clear();
+  for (const auto& entry : childAcceptTable_) {
+    sendChildAccepts(entry.first, entry.second);
   }
+  childAcceptTable_.clear();
 }
 
 void RRefContext::addPendingChild(
@@ -665,24 +855,29 @@ std::shared_ptr<Future<bool>> RRefContext::waitForThreadLocalPendingRRefs() {
     userTable_.clear();
   }
   recording_ = false;
+  sendThreadLocalForkNotifications();
   return future;
 }
 
 void RRefContext::clearRecordedPendingRRefsOnError() {
   userTable_.clear();
   recording_ = false;
-}
-
-void RRefContext::finishForkRequest(const ForkId& forkId, worker_id_t parent) {
-  delPendingUser(forkId);
-  ++numPendingFutures_;
-  auto fm = agent_->sendWithRetries(
-      agent_->getWorkerInfo(parent), RRefChildAccept(forkId).toMessage());
-
-  fm->addCallback([this](const FutureMessage& fm) {
-    handleException(fm);
-    --numPendingFutures_;
-  });
+  // The forks that were already deserialized still have to be confirmed, or
+  // their parents would keep them alive forever.
+  sendThreadLocalForkNotifications();
+}
+
+void RRefContext::finishForkRequests(
+    const std::vector<ForkNotification>& forkRequests) {
+  // The child accepts for the same parent share a message as well.
+  std::unordered_map<worker_id_t, std::vector<ForkNotification>> childAccepts;
+  for (const auto& forkRequest : forkRequests) {
+    delPendingUser(forkRequest.forkId);
+    childAccepts[forkRequest.parent].push_back(forkRequest);
+  }
+  for (const auto& entry : childAccepts) {
+    sendChildAccepts(entry.first, entry.second);
+  }
 }
 
 void RRefContext::addSelfAsFork(c10::intrusive_ptr<OwnerRRef>& rref) {
@@ -2,13 +2,16 @@
 
 #include <c10/util/Optional.h>
 #include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/distributed/rpc/metrics/RpcMetricsHandler.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 #include <torch/csrc/distributed/rpc/rref_impl.h>
+#include <torch/csrc/distributed/rpc/rref_proto.h>
 #include <torch/csrc/distributed/rpc/types.h>
 #include <torch/csrc/distributed/rpc/utils.h>
 #include <torch/csrc/utils/future.h>
 
 #include <atomic>
+#include <thread>
 
 namespace torch {
 namespace distributed {
@@ -30,6 +33,22 @@ c10::intrusive_ptr<RRef> TORCH_API finishCreatingOwnerRRef(
 
 using torch::utils::Future;
 
+// The RREF_USER_DELETE notifications are queued per owner, and sent out in a
+// single message once kUserDeleteFlushInterval has passed since the first one
+// was queued, or once kMaxUserDeleteBatchSize of them are queued for the same
+// owner.
+constexpr std::chrono::milliseconds kUserDeleteFlushInterval(10);
+constexpr size_t kMaxUserDeleteBatchSize = 64;
+
+// Names of the metrics reported through the RpcMetricsHandler, see
+// RRefContext::setMetricsConfig.
+// Counts the RREF_USER_DELETE, RREF_FORK_REQUEST, RREF_CHILD_ACCEPT and
+// RREF_NOTIFICATION_BATCH messages sent.
+constexpr char kRRefControlMessagesMetric[] = "rref.control_messages";
+// Number of notifications carried by each of these messages.
+constexpr char kRRefNotificationsPerMessageMetric[] =
+    "rref.notifications_per_message";
+
 // Manages RRef lifetime and keeps track of RRef forks.
 class TORCH_API RRefContext {
  public:
@@ -201,15 +220,33 @@ class TORCH_API RRefContext {
   // TODO: make this a context guard
   void clearRecordedPendingRRefsOnError();
 
+  // Queues a RREF_USER_DELETE for the owner, see kUserDeleteFlushInterval.
   void delUser(
       const worker_id_t owner,
       const RRefId& rrefId,
       const ForkId& forkId);
+  // Sends out all the queued RREF_USER_DELETE notifications now.
+  void flushUserDeletes();
   void delAllUsersAndUnforkedOwners(std::chrono::milliseconds timeoutMillis);
 
+  // Reports the RRef control messages sent by this worker to the
+  // RpcMetricsHandler registered as config.handlerName_, or stops reporting
+  // them if config.enabled_ is false.
+  void setMetricsConfig(const RpcMetricsConfig& config);
+
   std::unordered_map<std::string, std::string> getDebugInfo();
 
  private:
+  using Notification = RRefNotificationBatch::Notification;
+
+  // A RREF_FORK_REQUEST or RREF_CHILD_ACCEPT for the fork forkId of rrefId,
+  // which was forked by parent.
+  struct ForkNotification {
+    RRefId rrefId;
+    ForkId forkId;
+    worker_id_t parent;
+  };
+
   struct PendingUserState {
     PendingUserState(c10::intrusive_ptr<RRef> rref) : rref_(std::move(rref)) {}
 
@@ -232,7 +269,24 @@ class TORCH_API RRefContext {
       const ForkId& forkId,
       const TypePtr& type);
 
-  void finishForkRequest(const ForkId& forkId, worker_id_t parent);
+  // Sends the notifications to dst, as a message of their own type if there
+  // is only one of them and as a RREF_NOTIFICATION_BATCH otherwise.
+  std::shared_ptr<FutureMessage> sendNotifications(
+      worker_id_t dst,
+      std::vector<Notification> notifications);
+  void sendForkRequests(
+      worker_id_t owner,
+      std::vector<ForkNotification> forkRequests);
+  void sendChildAccepts(
+      worker_id_t parent,
+      const std::vector<ForkNotification>& childAccepts);
+  // Sends the fork notifications recorded in forkRequestTable_ and
+  // childAcceptTable_ by the current thread, and clears them.
+  void sendThreadLocalForkNotifications();
+
+  void finishForkRequests(const std::vector<ForkNotification>& forkRequests);
+
+  void userDeleteFlushLoop();
 
   // If there is any leak on any RRef, this method will throw an error.
   void checkRRefLeaks(bool ignoreRRefLeak);
@@ -304,6 +358,19 @@ class TORCH_API RRefContext {
   std::mutex destroyedMutex_;
   bool destroyed_;
 
+  // RREF_USER_DELETE notifications queued by delUser() per owner, sent out by
+  // userDeleteFlushThread_.
+  std::mutex userDeleteMutex_;
+  std::condition_variable userDeleteCV_;
+  std::unordered_map<worker_id_t, std::vector<Notification>>
+      pendingUserDeletes_;
+  // Started on the first delUser(), and stopped by destroyInstance().
+  std::thread userDeleteFlushThread_;
+  bool stopFlushingUserDeletes_{false};
+
+  std::mutex metricsMutex_;
+  std::shared_ptr<RpcMetricsHandler> metricsHandler_;
+
   // Thread local states to keep UserRRefs deserialized from user function
   // arguments.
   static thread_local std::vector<std::shared_ptr<PendingUserState>> userTable_;
@@ -331,6 +398,17 @@ class TORCH_API RRefContext {
   // or forward the UserRRef, and both would then require confirmations from the
   // owner.
   static thread_local bool recording_;
+  // While recording, the RREF_FORK_REQUEST and RREF_CHILD_ACCEPT notifications
+  // of the RRefs deserialized from the user function arguments are kept in
+  // these tables per destination, instead of being sent right away. They are
+  // sent in waitForThreadLocalPendingRRefs(), so that all the RRefs of the
+  // same owner in a message share a single fork request.
+  static thread_local std::
+      unordered_map<worker_id_t, std::vector<ForkNotification>>
+          forkRequestTable_;
+  static thread_local std::
+      unordered_map<worker_id_t, std::vector<ForkNotification>>
+          childAcceptTable_;
 };
 
 } // namespace rpc
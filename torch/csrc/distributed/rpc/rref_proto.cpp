@@ -189,6 +189,48 @@ std::unique_ptr<RRefForkRequest> RRefForkRequest::fromMessage(
   return std::make_unique<RRefForkRequest>(pair.first, pair.second);
 }
 
+const std::vector<RRefNotificationBatch::Notification>& RRefNotificationBatch::
+    notifications() const {
+  return notifications_;
+}
+
+Message RRefNotificationBatch::toMessageImpl() && {
+  std::vector<IValue> ivalues;
+  ivalues.reserve(notifications_.size() * 3);
+  for (const auto& notification : notifications_) {
+    ivalues.emplace_back(static_cast<int64_t>(notification.type));
+    ivalues.emplace_back(notification.rrefId.toIValue());
+    ivalues.emplace_back(notification.forkId.toIValue());
+  }
+  return fromIValues(std::move(ivalues), MessageType::RREF_NOTIFICATION_BATCH);
+}
+
+std::unique_ptr<RRefNotificationBatch> RRefNotificationBatch::fromMessage(
+    const Message& message) {
+  auto values = toIValues(message, MessageType::RREF_NOTIFICATION_BATCH);
+  TORCH_INTERNAL_ASSERT(
+      values.size() % 3 == 0,
+      "Expect 3 IValues per notification from message, got ",
+      values.size());
+
+  std::vector<Notification> notifications;
+  notifications.reserve(values.size() / 3);
+  for (size_t i = 0; i < values.size(); i += 3) {
+    auto type = static_cast<MessageType>(values[i].toInt());
+    TORCH_INTERNAL_ASSERT(
+        type == MessageType::RREF_USER_DELETE ||
+            type == MessageType::RREF_FORK_REQUEST ||
+            type == MessageType::RREF_CHILD_ACCEPT,
+        "Unexpected notification type ",
+        type);
+    notifications.push_back(
+        {type,
+         RRefId::fromIValue(values[i + 1]),
+         ForkId::fromIValue(values[i + 2])});
+  }
+  return std::make_unique<RRefNotificationBatch>(std::move(notifications));
+}
+
 Message RRefAck::toMessageImpl() && {
   return Message({}, {}, MessageType::RREF_ACK);
 }
@@ -155,6 +155,31 @@ class TORCH_API RRefForkRequest final : public ForkMessageBase {
   static std::unique_ptr<RRefForkRequest> fromMessage(const Message& message);
 };
 
+// Several RREF_USER_DELETE, RREF_FORK_REQUEST or RREF_CHILD_ACCEPT
+// notifications for the same worker in a single message. The receiver handles
+// them in order and replies with a single RRefAck.
+class TORCH_API RRefNotificationBatch final : public RpcCommandBase {
+ public:
+  struct Notification {
+    // One of RREF_USER_DELETE, RREF_FORK_REQUEST or RREF_CHILD_ACCEPT
+    MessageType type;
+    RRefId rrefId;
+    ForkId forkId;
+  };
+
+  explicit RRefNotificationBatch(std::vector<Notification> notifications)
+      : notifications_(std::move(notifications)) {}
+
+  const std::vector<Notification>& notifications() const;
+
+  Message toMessageImpl() && override;
+  static std::unique_ptr<RRefNotificationBatch> fromMessage(
+      const Message& message);
+
+ private:
+  const std::vector<Notification> notifications_;
+};
+
 class TORCH_API RRefAck final : public RpcCommandBase {
  public:
   RRefAck() {}
@@ -1,7 +1,9 @@
 #include <torch/csrc/distributed/rpc/tensorpipe_agent.h>
 
 #include <limits>
+#include <unordered_set>
 
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <fmt/format.h>
 #include <torch/csrc/distributed/rpc/request_callback_impl.h>
 #include <torch/csrc/distributed/rpc/utils.h>
@@ -29,6 +31,36 @@ const std::string kServerActiveAsyncCalls = "agent.server_active_async_calls";
 const std::string kRpcTimeoutErrorStr =
     "RPC ran for more than set timeout ({} ms) and will now be marked with an error";
 
+// Device maps are stored as "src:dst,src:dst,..."
+std::vector<uint8_t> serializeDeviceMap(const DeviceMap& deviceMap) {
+  std::string str;
+  for (const auto& entry : deviceMap) {
+    if (!str.empty()) {
+      str += ",";
+    }
+    str += c10::str(entry.first, ":", entry.second);
+  }
+  return std::vector<uint8_t>(str.begin(), str.end());
+}
+
+DeviceMap deserializeDeviceMap(const std::vector<uint8_t>& data) {
+  DeviceMap deviceMap;
+  std::string str(data.begin(), data.end());
+  size_t begin = 0;
+  while (begin < str.size()) {
+    size_t end = str.find(',', begin);
+    if (end == std::string::npos) {
+      end = str.size();
+    }
+    const auto entry = str.substr(begin, end - begin);
+    const auto colon = entry.find(':');
+    deviceMap.emplace(
+        std::stoi(entry.substr(0, colon)), std::stoi(entry.substr(colon + 1)));
+    begin = end + 1;
+  }
+  return deviceMap;
+}
+
 } // namespace
 
 C10_DEFINE_REGISTRY(TensorPipeTransportRegistry, TransportRegistration);
@@ -226,6 +258,7 @@ TensorPipeAgent::TensorPipeAgent(
           tensorpipe::ContextOptions().name(workerInfo_.name_))),
       rankToNameStore_("names", store),
       nameToAddressStore_("addrs", store),
+      deviceMapsStore_("device_maps", store),
       worldSize_(worldSize),
       processGroup_(std::move(processGroup)) {
   collectNames();
@@ -239,6 +272,102 @@ TensorPipeAgent::~TensorPipeAgent() {
   shutdown();
 }
 
+void TensorPipeAgent::exchangeDeviceMaps() {
+  const int numGPUs = at::detail::getCUDAHooks().getNumGPUs();
+
+  for (const auto& p : opts_.deviceMaps) {
+    TORCH_CHECK(
+        workerNameToInfo_.count(p.first) > 0,
+        "Device map set for unknown worker ",
+        p.first);
+    std::unordered_set<c10::DeviceIndex> targets;
+    for (const auto& entry : p.second) {
+      TORCH_CHECK(
+          entry.first >= 0 && entry.first < numGPUs,
+          "The device map from ",
+          workerInfo_.name_,
+          " to ",
+          p.first,
+          " uses device ",
+          entry.first,
+          " but ",
+          numGPUs,
+          " CUDA devices are available");
+      // The map has to be reversible for the responses
+      TORCH_CHECK(
+          targets.insert(entry.second).second,
+          "The device map from ",
+          workerInfo_.name_,
+          " to ",
+          p.first,
+          " maps several devices to device ",
+          entry.second);
+    }
+  }
+
+  // Every worker publishes its map to each other worker, even if empty, so
+  // that the maps to this worker can be read all at once.
+  std::vector<std::string> setKeys;
+  std::vector<std::vector<uint8_t>> setValues;
+  std::vector<std::string> getKeys;
+  std::vector<std::string> getNames;
+  for (const auto& p : workerNameToInfo_) {
+    const auto& name = p.first;
+    auto it = opts_.deviceMaps.find(name);
+    setKeys.push_back(c10::str(workerInfo_.name_, "/", name));
+    setValues.push_back(
+        it == opts_.deviceMaps.end() ? std::vector<uint8_t>()
+                                     : serializeDeviceMap(it->second));
+    getKeys.push_back(c10::str(name, "/", workerInfo_.name_));
+    getNames.push_back(name);
+  }
+  deviceMapsStore_.multiSet(setKeys, setValues);
+  const auto values = deviceMapsStore_.multiGet(getKeys);
+
+  for (size_t i = 0; i < values.size(); i++) {
+    if (values[i].empty()) {
+      continue;
+    }
+    auto& reverseDeviceMap = reverseDeviceMaps_[getNames[i]];
+    for (const auto& entry : deserializeDeviceMap(values[i])) {
+      TORCH_CHECK(
+          entry.second >= 0 && entry.second < numGPUs,
+          "The device map from ",
+          getNames[i],
+          " to ",
+          workerInfo_.name_,
+          " uses device ",
+          entry.second,
+          " but ",
+          numGPUs,
+          " CUDA devices are available");
+      reverseDeviceMap.emplace(entry.second, entry.first);
+    }
+  }
+}
+
+c10::optional<std::string> TensorPipeAgent::checkDevices(
+    const Message& message,
+    const DeviceMap& deviceMap,
+    const std::string& workerName) const {
+  for (const auto& tensor : message.tensors()) {
+    if (tensor.device().is_cpu() ||
+        (tensor.is_cuda() && !tensor.is_sparse() &&
+         deviceMap.count(tensor.device().index()) > 0)) {
+      continue;
+    }
+    return c10::str(
+        "TensorPipe RPC backend only supports CPU tensors by default, please ",
+        "move your tensors to CPU before sending them over RPC, or call ",
+        "`set_device_map` on `TensorPipeRpcBackendOptions` to map the devices ",
+        "of the tensors exchanged with ",
+        workerName,
+        ". Found tensor on device: ",
+        tensor.device());
+  }
+  return c10::nullopt;
+}
+
 void TensorPipeAgent::startImpl() {
   VLOG(1) << "RPC agent for " << workerInfo_.name_ << " is starting";
 
@@ -312,6 +441,8 @@ void TensorPipeAgent::startImpl() {
     workerNameToURL_.insert({name, nodeAddrStr});
   }
 
+  exchangeDeviceMaps();
+
   // Start the Timeout Thread
   timeoutThread_ = std::thread(&TensorPipeAgent::pollTimeoutRpcs, this);
 
@@ -389,10 +520,12 @@ void TensorPipeAgent::pipeRead(
 void TensorPipeAgent::pipeWrite(
     const std::shared_ptr<tensorpipe::Pipe>& pipe,
     Message&& rpcMessage,
+    const DeviceMap& deviceMap,
     std::function<void(const tensorpipe::Error&)> fn) {
   tensorpipe::Message tpMessage;
   TensorpipeWriteBuffers tpBuffers;
-  std::tie(tpMessage, tpBuffers) = tensorpipeSerialize(std::move(rpcMessage));
+  std::tie(tpMessage, tpBuffers) =
+      tensorpipeSerialize(std::move(rpcMessage), deviceMap);
   pipe->write(
       std::move(tpMessage),
       [tpBuffers{
@@ -423,22 +556,20 @@ void TensorPipeAgent::sendCompletedResponseMessage(
   Message&& responseMessage = std::move(*futureResponseMessage).moveValue();
   responseMessage.setId(messageId);
   if (!error) {
-    for (const auto& tensor : responseMessage.tensors()) {
-      if (!tensor.device().is_cpu()) {
-        responseMessage = createExceptionResponse(
-            c10::str(
-                "TensorPipe RPC backend only supports CPU tensors, please ",
-                "move your tensors to CPU before sending them over RPC. Found ",
-                "tensor on device: ",
-                tensor.device()),
-            responseMessage.id());
-        break;
-      }
+    const auto& remoteName = pipe->getRemoteName();
+    auto it = reverseDeviceMaps_.find(remoteName);
+    const DeviceMap& deviceMap =
+        it == reverseDeviceMaps_.end() ? DeviceMap() : it->second;
+    auto deviceError = checkDevices(responseMessage, deviceMap, remoteName);
+    if (deviceError) {
+      responseMessage =
+          createExceptionResponse(*deviceError, responseMessage.id());
     }
 
     pipeWrite(
         pipe,
         std::move(responseMessage),
+        deviceMap,
         [this, pipe, messageId](const tensorpipe::Error& error) {
           if (error) {
             LOG(WARNING)
@@ -457,6 +588,7 @@ void TensorPipeAgent::sendCompletedResponseMessage(
     pipeWrite(
         pipe,
         createExceptionResponse(error->what(), responseMessage.id()),
+        DeviceMap(),
         [this, pipe, messageId](const tensorpipe::Error& error) {
           if (error) {
             LOG(WARNING)
@@ -566,13 +698,13 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
     throw std::runtime_error(err);
   }
 
-  for (const auto& tensor : requestMessage.tensors()) {
-    TORCH_CHECK(
-        tensor.device().is_cpu(),
-        "TensorPipe RPC backend only supports CPU tensors, please move your ",
-        "tensors to CPU before sending them over RPC. Found tensor on device: ",
-        tensor.device());
-  }
+  auto deviceMapIt = opts_.deviceMaps.find(toWorkerInfo.name_);
+  const DeviceMap& deviceMap = deviceMapIt == opts_.deviceMaps.end()
+      ? DeviceMap()
+      : deviceMapIt->second;
+  auto deviceError =
+      checkDevices(requestMessage, deviceMap, toWorkerInfo.name_);
+  TORCH_CHECK(!deviceError, *deviceError);
 
   const auto& url = findWorkerURL(toWorkerInfo);
 
@@ -632,6 +764,7 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
   pipeWrite(
       clientPipe.pipe_,
       std::move(requestMessage),
+      deviceMap,
       [this, &clientPipe, messageId](const tensorpipe::Error& error) mutable {
         if (error) {
           if (error.isOfType<tensorpipe::PipeClosedError>() &&
@@ -10,6 +10,7 @@
 #include <c10d/ProcessGroup.hpp>
 #include <c10d/Store.hpp>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
+#include <torch/csrc/distributed/rpc/utils.h>
 
 namespace torch {
 namespace distributed {
@@ -41,11 +42,13 @@ struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
       optional<std::vector<std::string>> transports,
       optional<std::vector<std::string>> channels,
       float rpc_timeout,
-      std::string init_method)
+      std::string init_method,
+      std::unordered_map<std::string, DeviceMap> device_maps = {})
       : RpcBackendOptions(rpc_timeout, init_method),
         numWorkerThreads(numWorkerThreads),
         transports(std::move(transports)),
-        channels(std::move(channels)) {
+        channels(std::move(channels)),
+        deviceMaps(std::move(device_maps)) {
     TORCH_CHECK(
         numWorkerThreads > 0,
         "num_worker_threads must be positive, got ",
@@ -70,9 +73,22 @@ struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
     }
   }
 
+  // Adds the entries of deviceMap to the device map of workerName
+  void setDeviceMap(
+      const std::string& workerName,
+      const DeviceMap& deviceMap) {
+    auto& workerDeviceMap = deviceMaps[workerName];
+    for (const auto& entry : deviceMap) {
+      workerDeviceMap[entry.first] = entry.second;
+    }
+  }
+
   int numWorkerThreads;
   const optional<std::vector<std::string>> transports;
   const optional<std::vector<std::string>> channels;
+  // CUDA tensors can only be sent to the workers in deviceMaps, from the
+  // devices in their map. The responses are sent back with the reverse map.
+  std::unordered_map<std::string, DeviceMap> deviceMaps;
 };
 
 // Struct to track the network source metrics
@@ -92,7 +108,9 @@ struct AggregatedNetworkData {
 // TensorPipeAgent leverages TensorPipe (https://github.com/pytorch/tensorpipe)
 // to transparently move tensors and payloads through the fastest available
 // transport or channel. It acts like a hybrid RPC transport, providing shared
-// memory (linux) and TCP (linux & mac) support. CUDA support is in progress.
+// memory (linux) and TCP (linux & mac) support. CUDA tensors are sent to the
+// workers for which a device map is set in the options, through pinned host
+// memory, as the TensorPipe channels only move host memory.
 class TensorPipeAgent : public RpcAgent {
  public:
   TensorPipeAgent(
@@ -149,6 +167,17 @@ class TensorPipeAgent : public RpcAgent {
 
   const std::string& findWorkerURL(const WorkerInfo& worker) const;
 
+  // Checks the device maps of the options, and populates reverseDeviceMaps_
+  // with the ones set by the other workers using the store
+  void exchangeDeviceMaps();
+
+  // Returns an error if a tensor of the message is neither on CPU nor on a
+  // CUDA device in deviceMap
+  c10::optional<std::string> checkDevices(
+      const Message& message,
+      const DeviceMap& deviceMap,
+      const std::string& workerName) const;
+
   // TensorPipe read function that could be used to read response messages
   // by client, and read request messages by server.
   void pipeRead(
@@ -160,6 +189,7 @@ class TensorPipeAgent : public RpcAgent {
   void pipeWrite(
       const std::shared_ptr<tensorpipe::Pipe>&,
       Message&& message,
+      const DeviceMap& deviceMap,
       std::function<void(const tensorpipe::Error&)>);
 
   // Callback of listener accept()
@@ -223,8 +253,13 @@ class TensorPipeAgent : public RpcAgent {
   std::unordered_map<std::string, WorkerInfo> workerNameToInfo_;
   std::unordered_map<std::string, std::string> workerNameToURL_;
 
+  // Device maps for the responses, keyed on the name of the worker sending
+  // the requests. They are the reverse of the device map of that worker.
+  std::unordered_map<std::string, DeviceMap> reverseDeviceMaps_;
+
   ::c10d::PrefixStore rankToNameStore_;
   ::c10d::PrefixStore nameToAddressStore_;
+  ::c10d::PrefixStore deviceMapsStore_;
   const int worldSize_;
 
   // The join method is required to behave like a barrier and perform collective
@@ -132,6 +132,7 @@ MessageType FaultyProcessGroupAgent::messageStringToType(
       {"RREF_FORK_REQUEST", MessageType::RREF_FORK_REQUEST},
       {"RREF_CHILD_ACCEPT", MessageType::RREF_CHILD_ACCEPT},
       {"RREF_USER_DELETE", MessageType::RREF_USER_DELETE},
+      {"RREF_NOTIFICATION_BATCH", MessageType::RREF_NOTIFICATION_BATCH},
       {"CLEANUP_AUTOGRAD_CONTEXT_REQ",
        MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ},
       {"PYTHON_REMOTE_CALL", MessageType::PYTHON_REMOTE_CALL},
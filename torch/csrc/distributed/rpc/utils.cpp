@@ -22,6 +22,7 @@
 #include <torch/csrc/jit/serialization/unpickler.h>
 
 #ifdef USE_TENSORPIPE
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <tensorpipe/core/message.h>
 #endif
 
@@ -125,6 +126,9 @@ std::unique_ptr<RpcCommandBase> deserializeRequest(const Message& request) {
     case MessageType::RREF_FORK_REQUEST: {
       return RRefForkRequest::fromMessage(request);
     }
+    case MessageType::RREF_NOTIFICATION_BATCH: {
+      return RRefNotificationBatch::fromMessage(request);
+    }
     case MessageType::FORWARD_AUTOGRAD_REQ: {
       return autograd::RpcWithAutograd::fromMessage(request);
     }
@@ -472,7 +476,8 @@ constexpr int kTpMessagePickleIdx = 3;
 } // namespace
 
 std::tuple<tensorpipe::Message, TensorpipeWriteBuffers> tensorpipeSerialize(
-    Message&& rpcMessage) {
+    Message&& rpcMessage,
+    const DeviceMap& deviceMap) {
   tensorpipe::Message tpMessage;
   TensorpipeWriteBuffers buffers;
 
@@ -495,6 +500,26 @@ std::tuple<tensorpipe::Message, TensorpipeWriteBuffers> tensorpipeSerialize(
 
   // Tensors
   buffers.tensors = cloneSparseTensors(rpcMessage.tensors()).vec();
+  // CUDA tensors are copied once to pinned memory, which TensorPipe sends as
+  // it is. The device they are received on is kept in the metadata of the
+  // TensorPipe tensor of their storage.
+  std::unordered_map<const void*, c10::Device> targetDevices;
+  for (auto& tensor : buffers.tensors) {
+    if (!tensor.is_cuda()) {
+      continue;
+    }
+    auto it = deviceMap.find(tensor.device().index());
+    TORCH_CHECK(
+        it != deviceMap.end(),
+        "No device map for the tensor on device ",
+        tensor.device());
+    auto staged = at::empty(
+        tensor.sizes(), tensor.options().device(at::kCPU).pinned_memory(true));
+    staged.copy_(tensor);
+    tensor = std::move(staged);
+    targetDevices.emplace(
+        tensor.storage().data(), c10::Device(at::kCUDA, it->second));
+  }
   torch::jit::Pickler pickler([&](const void* buf, size_t sz) -> size_t {
     buffers.pickle.insert(
         buffers.pickle.end(),
@@ -509,6 +534,7 @@ std::tuple<tensorpipe::Message, TensorpipeWriteBuffers> tensorpipeSerialize(
       buffers.pickle.data(), buffers.pickle.size()});
   for (const auto& tensor : pickler.tensorData()) {
     const auto& tensorData = jit::getWriteableTensorData(tensor);
+    auto targetDevice = targetDevices.find(tensor.storage().data());
     // Enforce memory copy if tensor is created from torch::from_blob, means
     // that the tensor doesn't own the memory.
     if (!tensorData.storageHasDeleter()) {
@@ -525,6 +551,9 @@ std::tuple<tensorpipe::Message, TensorpipeWriteBuffers> tensorpipeSerialize(
       tpMessage.tensors.push_back(
           tensorpipe::Message::Tensor{tensorPtr, tensorData.sizeInBytes()});
     }
+    if (targetDevice != targetDevices.end()) {
+      tpMessage.tensors.back().metadata = targetDevice->second.str();
+    }
   }
 
   return std::make_tuple(std::move(tpMessage), std::move(buffers));
@@ -568,7 +597,11 @@ TensorpipeReadBuffers tensorpipeAllocate(tensorpipe::Message& tpMessage) {
   tpMessage.payloads[kTpMessagePickleIdx].data = buffers.pickle.data();
 
   for (auto& tensor : tpMessage.tensors) {
-    buffers.tensors.push_back(at::getCPUAllocator()->allocate(tensor.length));
+    // Tensors received on a CUDA device have it in their metadata
+    auto allocator = tensor.metadata.empty()
+        ? at::getCPUAllocator()
+        : at::detail::getCUDAHooks().getPinnedMemoryAllocator();
+    buffers.tensors.push_back(allocator->allocate(tensor.length));
     tensor.data = buffers.tensors.back().get();
   }
 
@@ -592,6 +625,13 @@ Message tensorpipeDeserialize(
     picklePos += toCopy;
     return toCopy;
   };
+  std::unordered_map<const void*, c10::Device> targetDevices;
+  for (size_t i = 0; i < message.tensors.size(); i++) {
+    if (!message.tensors[i].metadata.empty()) {
+      targetDevices.emplace(
+          buffers.tensors[i].get(), c10::Device(message.tensors[i].metadata));
+    }
+  }
   auto tensorReadFunc = [&](const std::string& ename) -> at::DataPtr {
     unsigned long index = std::stoul(ename);
     return std::move(buffers.tensors.at(index));
@@ -605,6 +645,12 @@ Message tensorpipeDeserialize(
   for (auto&& t : ival.toTensorList()) {
     tensors.emplace_back(std::move(t));
   }
+  for (auto& tensor : tensors) {
+    auto it = targetDevices.find(tensor.storage().data());
+    if (it != targetDevices.end()) {
+      tensor = tensor.to(it->second, /* non_blocking */ true);
+    }
+  }
 
   return Message(
       std::move(buffers.payload),
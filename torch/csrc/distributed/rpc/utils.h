@@ -52,6 +52,10 @@ TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
     const void* data,
     size_t data_size);
 
+// Maps the CUDA devices of the tensors sent to a worker to the devices they
+// are received on by that worker.
+using DeviceMap = std::unordered_map<c10::DeviceIndex, c10::DeviceIndex>;
+
 // We use vector<char> as the type of blobs because it's what rpc::Message uses
 // for its payload, even though it has the disadvantage that it cannot be
 // allocated with uninitialized memory: it is always zeroed out.
@@ -84,13 +88,16 @@ struct TensorpipeReadBuffers {
 
 // Convert an RPC message into a TensorPipe message, plus a holder to all the
 // data that must be kept alive while the write is performed asynchronously.
+// CUDA tensors are staged in pinned host memory, and received on the device
+// that deviceMap maps their device to, which must be in deviceMap.
 TORCH_API std::tuple<tensorpipe::Message, TensorpipeWriteBuffers>
-tensorpipeSerialize(Message&& rpcMessage);
+tensorpipeSerialize(Message&& rpcMessage, const DeviceMap& deviceMap = {});
 
 // Allocate the buffers that will hold the incoming data. They will be managed
 // by the returned holder, which must be kept alive until the asynchronous read
 // has finished. Pointers to these buffers will be stored in-place in the
-// TensorPipe message.
+// TensorPipe message. The buffers of tensors received on a CUDA device are
+// pinned, so that they are copied to the device asynchronously.
 TORCH_API TensorpipeReadBuffers
 tensorpipeAllocate(tensorpipe::Message& tpMessage);
 
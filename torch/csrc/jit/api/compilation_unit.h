@@ -94,7 +94,9 @@ struct TORCH_API CompilationUnit {
       // if non-null, the first argument to each def, is bound to this value
       const Self* self,
       // see [name mangling]
-      bool shouldMangle = false);
+      bool shouldMangle = false,
+      // compile each function on first use, see GraphFunction
+      bool lazy = false);
 
   // same as above but parse the definitions from source
   // Returns the list of Function's just defined.
@@ -260,7 +262,8 @@ struct TORCH_API CompilationUnit {
       const ResolverPtr& resolver,
       const Self* self,
       const std::unordered_map<std::string, Function*>& function_table,
-      bool shouldMangle = false) const;
+      bool shouldMangle = false,
+      bool lazy = false) const;
 
   Function& register_function(std::unique_ptr<Function> fn) {
     TORCH_CHECK(
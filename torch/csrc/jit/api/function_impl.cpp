@@ -25,6 +25,11 @@ c10::FunctionSchema defaultSchemaFor(const Function& function) {
   }
   return {function.name(), "", std::move(args), std::move(returns)};
 }
+
+std::recursive_mutex& lazyDefinitionMutex() {
+  static std::recursive_mutex mutex;
+  return mutex;
+}
 } // namespace
 
 void placeholderCreator(GraphFunction&) {
@@ -51,8 +56,38 @@ IValue GraphFunction::operator()(
   return stack.front();
 }
 
+void GraphFunction::define_lazily() {
+  std::lock_guard<std::recursive_mutex> guard(lazyDefinitionMutex());
+  // The creator itself fetches the graph it emits
+  if (!lazy_.load(std::memory_order_relaxed) || defining_lazily_) {
+    return;
+  }
+  defining_lazily_ = true;
+  auto creator = function_creator_;
+  function_creator_ = placeholderCreator;
+  try {
+    creator(*this);
+  } catch (...) {
+    // Leave the function as it was, the error is reported on each use
+    graph_ = std::make_shared<Graph>();
+    schema_ = nullptr;
+    function_creator_ = creator;
+    defining_lazily_ = false;
+    throw;
+  }
+  function_creator_ = nullptr;
+  defining_lazily_ = false;
+  lazy_.store(false, std::memory_order_release);
+}
+
 void GraphFunction::ensure_defined() {
-  if (function_creator_) {
+  if (lazy_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::recursive_mutex> guard(lazyDefinitionMutex());
+    if (defining_lazily_) {
+      placeholderCreator(*this);
+    }
+    define_lazily();
+  } else if (function_creator_) {
     auto creator = function_creator_;
     function_creator_ = placeholderCreator;
     creator(*this);
@@ -62,6 +97,9 @@ void GraphFunction::ensure_defined() {
 }
 
 const c10::FunctionSchema& GraphFunction::getSchema() const {
+  if (lazy_.load(std::memory_order_acquire)) {
+    const_cast<GraphFunction*>(this)->define_lazily();
+  }
   if (schema_ == nullptr) {
     schema_ = std::make_unique<c10::FunctionSchema>(defaultSchemaFor(*this));
   }
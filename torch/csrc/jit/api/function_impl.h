@@ -5,17 +5,24 @@
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/utils/memory.h>
 
+#include <atomic>
+
 namespace torch {
 namespace jit {
 
 struct TORCH_API GraphFunction : public Function {
+  // A lazy function runs its function_creator on first use, that is the first
+  // time its graph or schema is requested, instead of in ensure_defined()
+  // calls made while the other functions are compiled
   GraphFunction(
       c10::QualifiedName name,
       std::shared_ptr<Graph> graph,
-      std::function<void(GraphFunction&)> function_creator)
+      std::function<void(GraphFunction&)> function_creator,
+      bool lazy = false)
       : name_(std::move(name)),
         graph_(std::move(graph)),
-        function_creator_(std::move(function_creator)) {}
+        function_creator_(std::move(function_creator)),
+        lazy_(lazy && function_creator_) {}
 
   bool isGraphFunction() const override {
     return true;
@@ -31,15 +38,20 @@ struct TORCH_API GraphFunction : public Function {
       override;
 
   std::shared_ptr<Graph> graph() const override {
+    if (lazy_.load(std::memory_order_acquire)) {
+      const_cast<GraphFunction*>(this)->define_lazily();
+    }
     return graph_;
   }
 
   std::shared_ptr<Graph> optimized_graph() const override {
+    // Defined before taking the lock, the creator may inline other functions
+    auto graph = this->graph();
     std::lock_guard<std::recursive_mutex> lock(compile_mutex);
     if (optimized_graph_) {
       return *optimized_graph_;
     }
-    optimized_graph_ = graph_->copy();
+    optimized_graph_ = graph->copy();
     if (getGraphExecutorOptimize()) {
       preoptimizeGraph(*optimized_graph_);
     }
@@ -112,6 +124,8 @@ struct TORCH_API GraphFunction : public Function {
   }
 
  private:
+  void define_lazily();
+
   c10::QualifiedName name_;
   // The original, non-optimized graph
   std::shared_ptr<Graph> graph_; // for debugging and for inlining
@@ -135,6 +149,12 @@ struct TORCH_API GraphFunction : public Function {
   // that it can construct methods out of order
   std::function<void(GraphFunction&)> function_creator_;
 
+  // Whether function_creator_ still has to run on first use, and whether it
+  // is running. Lazy functions are defined under a global lock, as they may
+  // be first used from several threads.
+  std::atomic<bool> lazy_;
+  bool defining_lazily_ = false;
+
   // if absent, then we generate a default schema based on the graph
   // mutable because getSchema caches the default schema if one is requested
   // before a call to setSchema
@@ -10,6 +10,7 @@
 #include <torch/csrc/jit/codegen/cuda/kernel_resource_strings.h>
 #include <torch/csrc/jit/codegen/cuda/lower2device.h>
 #include <torch/csrc/jit/codegen/cuda/parser.h>
+#include <torch/csrc/jit/codegen/fuser/disk_cache.h>
 
 #include <torch/csrc/jit/resource_guard.h>
 #include <fstream>
@@ -435,38 +436,52 @@ void compileKernel(CudaKernel* entry) {
   int major, minor;
   major = prop->major;
   minor = prop->minor;
-  nvrtcProgram program;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
-      &program, code.c_str(), nullptr, 0, nullptr, nullptr));
-  ResourceGuard holdProgram(
-      [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
-
   const std::string compute = "--gpu-architecture=compute_" +
       std::to_string(major) + std::to_string(minor);
   const std::vector<const char*> args = {
       "--std=c++14", compute.c_str(), "-default-device"};
 
-  nvrtc().nvrtcAddNameExpression(program, func_name.c_str());
-  const auto result =
-      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
-  if (result != NVRTC_SUCCESS) {
-    size_t logsize;
-    nvrtc().nvrtcGetProgramLogSize(program, &logsize);
-    std::vector<char> log(logsize);
-    nvrtc().nvrtcGetProgramLog(program, log.data());
+  auto compile = [&]() {
+    nvrtcProgram program;
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
+        &program, code.c_str(), nullptr, 0, nullptr, nullptr));
+    ResourceGuard holdProgram(
+        [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
+
+    nvrtc().nvrtcAddNameExpression(program, func_name.c_str());
+    const auto result =
+        nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
+    if (result != NVRTC_SUCCESS) {
+      size_t logsize;
+      nvrtc().nvrtcGetProgramLogSize(program, &logsize);
+      std::vector<char> log(logsize);
+      nvrtc().nvrtcGetProgramLog(program, log.data());
 
-    TORCH_INTERNAL_ASSERT(
-        false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
+      TORCH_INTERNAL_ASSERT(
+          false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
+    }
+    const char* lowered_kernel_name;
+    nvrtc().nvrtcGetLoweredName(
+        program, func_name.c_str(), &lowered_kernel_name);
+
+    AT_CUDA_NVRTC_CHECK(result);
+    size_t ptx_size;
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
+    std::string ptx(ptx_size, '\0');
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, &ptx[0]));
+    // The lowered name lives in the program, copy it before destroying it
+    return fuser::CachedKernel{lowered_kernel_name, std::move(ptx)};
+  };
+  std::stringstream config;
+  config << "nvrtc " << nvrtc_major << "." << nvrtc_minor;
+  for (const char* arg : args) {
+    config << " " << arg;
   }
-  const char* lowered_kernel_name;
-  nvrtc().nvrtcGetLoweredName(program, func_name.c_str(), &lowered_kernel_name);
-
-  AT_CUDA_NVRTC_CHECK(result);
-  size_t ptx_size;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
-  std::vector<char> ptx;
-  ptx.resize(ptx_size);
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx.data()));
+  auto cached = fuser::compileWithDiskCache(
+      /*name=*/"", code, config.str(), compile);
+  const char* lowered_kernel_name = cached.name.c_str();
+  std::vector<char> ptx(cached.binary.begin(), cached.binary.end());
+  size_t ptx_size = ptx.size();
 
   // TODO: We do go through different code path, should investigate whether this
   // has an impact on generated binary.
@@ -2,12 +2,16 @@
 #include <torch/csrc/jit/codegen/cuda/fusion.h>
 #include <torch/csrc/jit/codegen/cuda/kernel_cache.h>
 #include <torch/csrc/jit/codegen/cuda/parser.h>
+#include <torch/csrc/jit/codegen/cuda/partition.h>
 #include <torch/csrc/jit/codegen/cuda/shape_inference.h>
 #include <torch/csrc/jit/codegen/cuda/utils.h>
+#include <torch/csrc/jit/ir/constants.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/runtime/interpreter.h>
 
+#include <algorithm>
 #include <unordered_map>
 
 namespace torch {
@@ -25,6 +29,126 @@ std::unique_ptr<KernelArgsReq> makePWKernelSupport(
   return req_ptr;
 }
 
+// Value of an input of a node of `graph`, either a graph input or a constant
+IValue nodeInput(
+    const std::shared_ptr<Graph>& graph,
+    const at::ArrayRef<IValue>& inputs,
+    Value* v) {
+  auto it = std::find(graph->inputs().begin(), graph->inputs().end(), v);
+  if (it != graph->inputs().end()) {
+    return inputs[it - graph->inputs().begin()];
+  }
+  auto constant = toIValue(v);
+  TORCH_INTERNAL_ASSERT(constant.has_value(), "GEMM operand not found");
+  return *constant;
+}
+
+// A tensor added to the GEMM output is folded into the GEMM as its C matrix
+// (cuBLAS computes A * B + beta * C) when it doesn't broadcast the output:
+// a bias along the last dim, or a residual of the same size.
+c10::optional<at::Tensor> foldableAddend(
+    const std::shared_ptr<Graph>& graph,
+    const at::ArrayRef<IValue>& inputs,
+    Node* add,
+    Value* gemm_output,
+    at::IntArrayRef output_sizes) {
+  if (!add->matches(
+          "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor")) {
+    return c10::nullopt;
+  }
+  auto alpha = toIValue(add->input(2));
+  if (!alpha || !alpha->isInt() || alpha->toInt() != 1) {
+    return c10::nullopt;
+  }
+  Value* other = add->input(0) == gemm_output ? add->input(1) : add->input(0);
+  if (other == gemm_output ||
+      std::find(graph->inputs().begin(), graph->inputs().end(), other) ==
+          graph->inputs().end()) {
+    return c10::nullopt;
+  }
+  const auto addend = nodeInput(graph, inputs, other).toTensor();
+  const bool is_bias =
+      addend.dim() == 1 && addend.size(0) == output_sizes.back();
+  if (!is_bias && addend.sizes() != output_sizes) {
+    return c10::nullopt;
+  }
+  return addend;
+}
+
+// The fusion of the pointwise consumers of a GEMM (see partition.h) runs in
+// two steps: the GEMM itself through ATen, then the rest of the graph as an
+// epilogue kernel taking the GEMM output as its last input. A bias or a
+// residual added first is accumulated by cuBLAS (see foldableAddend).
+//
+// Rewrites `graph` into the epilogue and returns its inputs, or nullopt if
+// there is no GEMM in the fusion.
+c10::optional<std::vector<IValue>> runGemmPrologue(
+    std::shared_ptr<Graph>& graph,
+    const at::ArrayRef<IValue>& inputs) {
+  auto nodes = graph->nodes();
+  auto gemm_it = std::find_if(nodes.begin(), nodes.end(), isGemmNode);
+  if (gemm_it == nodes.end()) {
+    return c10::nullopt;
+  }
+  Node* gemm = *gemm_it;
+  const bool is_linear = gemm->kind() == aten::linear;
+  const auto self = nodeInput(graph, inputs, gemm->input(0)).toTensor();
+  const auto other = nodeInput(graph, inputs, gemm->input(1)).toTensor();
+  const auto bias =
+      is_linear ? nodeInput(graph, inputs, gemm->input(2)) : IValue();
+
+  Value* result = gemm->output();
+  at::Tensor output;
+  // Only the GEMMs that are a single cuBLAS call accumulate into C
+  if (self.dim() >= 2 && other.dim() == 2 && bias.isNone()) {
+    const auto mat2 = is_linear ? other.t() : other;
+    std::vector<int64_t> output_sizes = self.sizes().vec();
+    output_sizes.back() = mat2.size(1);
+    const auto mat1 = self.reshape({-1, mat2.size(0)});
+    Node* add = gemm->output()->uses().size() == 1
+        ? gemm->output()->uses()[0].user
+        : nullptr;
+    auto addend = add
+        ? foldableAddend(graph, inputs, add, gemm->output(), output_sizes)
+        : c10::nullopt;
+    if (addend && addend->scalar_type() == self.scalar_type()) {
+      output = at::addmm(
+          addend->dim() == 1 ? *addend
+                             : addend->reshape({-1, mat2.size(1)}),
+          mat1,
+          mat2);
+      result = add->output();
+    } else {
+      output = at::mm(mat1, mat2);
+    }
+    output = output.view(output_sizes);
+  } else if (is_linear) {
+    output = at::linear(
+        self, other, bias.isNone() ? at::Tensor() : bias.toTensor());
+  } else {
+    output = at::matmul(self, other);
+  }
+
+  Value* epilogue_input = graph->addInput();
+  epilogue_input->setType(TensorType::create(output));
+  result->replaceAllUsesWith(epilogue_input);
+  if (result != gemm->output()) {
+    result->node()->destroy();
+  }
+  gemm->destroy();
+  EliminateDeadCode(graph);
+
+  std::vector<IValue> epilogue_inputs(inputs.begin(), inputs.end());
+  epilogue_inputs.emplace_back(std::move(output));
+  for (int64_t i = graph->inputs().size() - 1; i >= 0; i--) {
+    if (!graph->inputs()[i]->hasUses()) {
+      graph->eraseInput(i);
+      epilogue_inputs.erase(epilogue_inputs.begin() + i);
+    }
+  }
+  return epilogue_inputs;
+}
+
 // CudaFusionManager holds compiled `CudaKernel` and handles all interfacing
 // including compilation and execution.
 //
@@ -173,14 +297,46 @@ void runCudaFusionGroup(const Node* fusion_node, Stack& stack) {
     const auto nInputs = graph->inputs().size();
     at::ArrayRef<IValue> inputs = last(stack, nInputs);
 
+    // The epilogue of a GEMM is rewritten on a copy, as the fallback runs
+    // the whole graph
+    std::shared_ptr<Graph> kernel_graph = graph;
+    int32_t kernel_graph_id = kernel_id;
+    c10::optional<std::vector<IValue>> epilogue_inputs;
+    if (std::any_of(
+            graph->nodes().begin(), graph->nodes().end(), isGemmNode)) {
+      kernel_graph = graph->copy();
+      epilogue_inputs = runGemmPrologue(kernel_graph, inputs);
+    }
+    if (epilogue_inputs) {
+      inputs = *epilogue_inputs;
+      // Nothing left to generate when an add folded into the GEMM was the
+      // only consumer
+      if (kernel_graph->nodes().begin() == kernel_graph->nodes().end()) {
+        std::vector<IValue> results;
+        for (auto output : kernel_graph->outputs()) {
+          results.push_back(nodeInput(kernel_graph, inputs, output));
+        }
+        drop(stack, nInputs);
+        stack.insert(
+            stack.end(),
+            std::make_move_iterator(results.begin()),
+            std::make_move_iterator(results.end()));
+        return;
+      }
+      // Whether the add is folded depends on the shapes of the inputs, each
+      // epilogue has its own kernels
+      kernel_graph_id =
+          CudaFusionManager::getManager().registerOrGetCacheId(kernel_graph);
+    }
+
     // shape inference in graph
     // update shape information per the new inputs;
-    EraseShapeInformation(graph);
-    for (size_t i = 0; i < nInputs; i++) {
-      graph->inputs()[i]->setType(inputs[i].type());
+    EraseShapeInformation(kernel_graph);
+    for (size_t i = 0; i < inputs.size(); i++) {
+      kernel_graph->inputs()[i]->setType(inputs[i].type());
     }
     // shape inference
-    ShapeTypePropagate(graph);
+    ShapeTypePropagate(kernel_graph);
 
     // TODO: temporary WAR that allows us to handle fusion with uniform output
     // shape and consistent broadcast scheme. The difinition is loose and the
@@ -190,7 +346,7 @@ void runCudaFusionGroup(const Node* fusion_node, Stack& stack) {
 
     // we need to construct outputs;
     std::vector<at::Tensor> outputs;
-    for (const auto* output : graph->outputs()) {
+    for (const auto* output : kernel_graph->outputs()) {
       const auto type = output->type()->expect<TensorType>();
       // Expect output to be tensor;
       TORCH_CHECK(
@@ -216,7 +372,7 @@ void runCudaFusionGroup(const Node* fusion_node, Stack& stack) {
       // TODO: unsafe broadcast assumption. We assume all output from fusion has
       //       identical size when broadcasting.
       if (broadcasted_shape.empty()) {
-        if (!hasReductionNode(graph->block())) {
+        if (!hasReductionNode(kernel_graph->block())) {
           broadcasted_shape = sizes;
         } else if (isReductionNode(output->node())) {
           auto i_type =
@@ -237,8 +393,8 @@ void runCudaFusionGroup(const Node* fusion_node, Stack& stack) {
     }
 
     CudaFusionManager::getManager().runFusionNode(
-        kernel_id, graph, inputs, outputs, broadcasted_shape);
-    drop(stack, inputs.size());
+        kernel_graph_id, kernel_graph, inputs, outputs, broadcasted_shape);
+    drop(stack, nInputs);
     stack.insert(
         stack.end(),
         std::make_move_iterator(outputs.begin()),
@@ -2,6 +2,8 @@
 #include <ATen/core/jit_type.h>
 #include <torch/csrc/jit/codegen/cuda/parser.h>
 
+#include <algorithm>
+
 namespace torch {
 namespace jit {
 namespace fuser {
@@ -71,8 +73,67 @@ bool hasReductionOperation(const Node* node) {
   return false;
 }
 
+bool hasGemmOperation(const Node* node) {
+  if (isGemmNode(node)) {
+    return true;
+  }
+  if (node->kind() == prim::CudaFusionGroup) {
+    for (auto n : node->g(attr::Subgraph)->nodes()) {
+      if (isGemmNode(n)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Whether `node` computes one of the operands of the GEMM in `fusion`. The
+// GEMM runs before the epilogue kernel, its operands can't be computed there.
+bool feedsGemm(const Node* fusion, const Node* node) {
+  if (fusion->kind() != prim::CudaFusionGroup) {
+    return false;
+  }
+  auto subgraph = fusion->g(attr::Subgraph);
+  for (auto n : subgraph->nodes()) {
+    if (!isGemmNode(n)) {
+      continue;
+    }
+    for (auto input : n->inputs()) {
+      auto it = std::find(
+          subgraph->inputs().begin(), subgraph->inputs().end(), input);
+      if (it != subgraph->inputs().end() &&
+          fusion->inputs()[it - subgraph->inputs().begin()]->node() == node) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// A GEMM is only attached to the fusion consuming all of its output, at most
+// one per fusion.
+bool isFusableGemm(const Node* fusion, const Node* gemm) {
+  if (hasGemmOperation(fusion) || hasReductionOperation(fusion)) {
+    return false;
+  }
+  for (auto use : gemm->output()->uses()) {
+    if (use.user != fusion) {
+      return false;
+    }
+  }
+  auto device = getDevice(gemm);
+  return device.has_value() && device->is_cuda() &&
+      isFusableDevice(fusion, device.value());
+}
+
 } // namespace
 
+bool isGemmNode(const Node* node) {
+  return node->matches(
+             "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor") ||
+      node->matches("aten::matmul(Tensor self, Tensor other) -> Tensor");
+}
+
 bool isFusableCudaFusionGroup(const Node* node) {
   if (isFusableNode(node)) {
     return isFusableDevice(node);
@@ -81,6 +142,13 @@ bool isFusableCudaFusionGroup(const Node* node) {
 }
 
 bool isFusableCudaFusionGroup(const Node* fusion, const Node* node) {
+  if (isGemmNode(node)) {
+    return isFusableGemm(fusion, node);
+  }
+  if (feedsGemm(fusion, node) ||
+      (hasGemmOperation(fusion) && hasGemmOperation(node))) {
+    return false;
+  }
   // TODO: lift the restriction of not fusing producer containing reduction when
   //       we have proper scheduling.
   if (isFusableCudaFusionGroup(node) && !hasReductionOperation(node)) {
@@ -12,6 +12,11 @@
  *
  * Logic right now is very simple. On top of device placement, we consider a
  * `Node` compatible when we have a parsing rule for it in our parser.
+ *
+ * A GEMM (`aten::linear`/`aten::matmul`) has no parsing rule, but it can be
+ * attached to the fusion of its pointwise consumers. At runtime it is computed
+ * by ATen, and the rest of the fusion becomes an epilogue kernel reading its
+ * output once (see manager.cpp).
  */
 
 namespace torch {
@@ -21,6 +26,8 @@ namespace cuda {
 
 TORCH_CUDA_API bool isFusableCudaFusionGroup(const Node* node);
 
+TORCH_CUDA_API bool isGemmNode(const Node* node);
+
 // consider if `node` could be fused into `fusion`
 TORCH_CUDA_API bool isFusableCudaFusionGroup(
     const Node* fusion,
@@ -3,10 +3,12 @@
 #include <c10/util/Optional.h>
 #include <torch/csrc/jit/codegen/fuser/compiler.h>
 #include <torch/csrc/jit/codegen/fuser/cpu/temp_file.h>
+#include <torch/csrc/jit/codegen/fuser/disk_cache.h>
 #include <torch/csrc/jit/frontend/code_template.h>
 #include <torch/csrc/utils/memory.h>
 
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -269,6 +271,38 @@ static void runCompiler(
   TORCH_CHECK(r == 0, "Failed to compile a fused CPU kernel");
 }
 
+// Describes everything a compiled kernel depends on besides its code, for
+// the disk cache
+static std::string compilerCacheConfig() {
+  auto& config = getConfig();
+  TemplateEnv env;
+  env.s("cxx", config.cxx);
+  env.s("fopenmp", config.openmp ? config.openmp_flags : "");
+  env.s("cpp_file", "");
+  env.s("so_file", "");
+  std::stringstream ss;
+  ss << format(compile_string, env) << "\n";
+  // The version of the compiler is only queried once per process
+  static const std::string version = [&]() -> std::string {
+#ifdef _MSC_VER
+    return exec("\"" + config.cxx + "\" 2>&1").value_or("");
+#else
+    std::string out;
+    std::string cmd = "\"" + config.cxx + "\" --version 2>/dev/null";
+    if (FILE* pipe = popen(cmd.c_str(), "r")) {
+      char buffer[128];
+      while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+        out += buffer;
+      }
+      pclose(pipe);
+    }
+    return out;
+#endif
+  }();
+  ss << version;
+  return ss.str();
+}
+
 #ifdef _MSC_VER
 static const std::string disas_string =
     "dumpbin /DISASM:NOBYTES \"${so_file}\"";
@@ -300,20 +334,45 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(concat_desc),
           has_random) {
   TempFile so_file(so_template, so_suffix_len);
-  TempFile cpp_file(cpp_template, cpp_suffix_len);
-  cpp_file.write(code_);
-  cpp_file.sync();
 #ifdef _MSC_VER
   so_file.close();
-  cpp_file.close();
 #endif
-  runCompiler(cpp_file.name(), so_file.name());
+  bool compiled = false;
+  auto compile = [&]() {
+    TempFile cpp_file(cpp_template, cpp_suffix_len);
+    cpp_file.write(code_);
+    cpp_file.sync();
+#ifdef _MSC_VER
+    cpp_file.close();
+#endif
+    runCompiler(cpp_file.name(), so_file.name());
+    compiled = true;
+    CachedKernel cached{name_, ""};
+    if (!diskCacheDir().empty()) {
+      std::ifstream so(so_file.name(), std::ios::in | std::ios::binary);
+      std::stringstream binary;
+      binary << so.rdbuf();
+      cached.binary = binary.str();
+    }
+    return cached;
+  };
+  auto cached = compileWithDiskCache(
+      name_,
+      code_,
+      diskCacheDir().empty() ? "" : compilerCacheConfig(),
+      compile);
+  if (!compiled) {
+    std::ofstream so(so_file.name(), std::ios::out | std::ios::binary);
+    so.write(cached.binary.data(), cached.binary.size());
+    so.close();
+    TORCH_CHECK(so.good(), "Failed to write a cached fused CPU kernel");
+  }
   if (debugFuser() >= 2)
     disas(so_file.name());
   so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
 #pragma GCC diagnostic ignored "-Wpedantic"
-  kernel =
-      reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
+  kernel = reinterpret_cast<void (*)(uint32_t, void**)>(
+      so_lib->sym(cached.name.c_str()));
 #pragma GCC diagnostic pop
 }
 
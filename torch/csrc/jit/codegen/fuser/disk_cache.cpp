@@ -0,0 +1,188 @@
+#include <torch/csrc/jit/codegen/fuser/disk_cache.h>
+
+#include <c10/util/Optional.h>
+#include <c10/util/StringUtil.h>
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+std::string& diskCacheDir() {
+  static std::string disk_cache_dir = []() -> std::string {
+    const char* dir_c_str = std::getenv("PYTORCH_FUSER_CACHE_DIR");
+    return dir_c_str ? dir_c_str : "";
+  }();
+  return disk_cache_dir;
+}
+
+namespace {
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Replaces the whole word occurrences of name in code
+std::string canonicalCode(const std::string& name, const std::string& code) {
+  if (name.empty()) {
+    return code;
+  }
+  std::string result;
+  size_t pos = 0;
+  while (true) {
+    size_t found = code.find(name, pos);
+    if (found == std::string::npos) {
+      break;
+    }
+    size_t end = found + name.size();
+    bool whole_word = (found == 0 || !isIdentifierChar(code[found - 1])) &&
+        (end == code.size() || !isIdentifierChar(code[end]));
+    result.append(code, pos, found - pos);
+    result.append(whole_word ? "${kernel_name}" : name);
+    pos = end;
+  }
+  result.append(code, pos, std::string::npos);
+  return result;
+}
+
+// An entry of the cache is a sequence of length prefixed fields: the config
+// and the canonical code, which are compared on lookup so that a collision
+// of the hashes can't return the wrong kernel, then the kernel.
+void writeField(std::ostream& out, const std::string& field) {
+  out << field.size() << '\n';
+  out.write(field.data(), field.size());
+}
+
+bool readField(std::istream& in, std::string& field) {
+  size_t size;
+  if (!(in >> size) || in.get() != '\n') {
+    return false;
+  }
+  field.resize(size);
+  return static_cast<bool>(in.read(&field[0], size));
+}
+
+c10::optional<CachedKernel> loadEntry(
+    const std::string& path,
+    const std::string& config,
+    const std::string& code) {
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  if (!in.is_open()) {
+    return c10::nullopt;
+  }
+  std::string entry_config, entry_code;
+  CachedKernel kernel;
+  if (!readField(in, entry_config) || !readField(in, entry_code) ||
+      !readField(in, kernel.name) || !readField(in, kernel.binary) ||
+      entry_config != config || entry_code != code) {
+    return c10::nullopt;
+  }
+  return kernel;
+}
+
+// Failing to store an entry (e.g. because the cache is read-only) isn't an
+// error, the kernel is just compiled again next time.
+void storeEntry(
+    const std::string& path,
+    const std::string& config,
+    const std::string& code,
+    const CachedKernel& kernel) {
+#ifdef _WIN32
+  const std::string tmp_path = c10::str(path, ".", _getpid(), ".tmp");
+#else
+  const std::string tmp_path = c10::str(path, ".", getpid(), ".tmp");
+#endif
+  {
+    std::ofstream out(tmp_path, std::ios::out | std::ios::binary);
+    if (!out.is_open()) {
+      return;
+    }
+    writeField(out, config);
+    writeField(out, code);
+    writeField(out, kernel.name);
+    writeField(out, kernel.binary);
+    if (!out.good()) {
+      out.close();
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  // Readers only ever see complete entries
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
+// Exclusive lock on a file, held for the lifetime of the object. A failure to
+// lock only means that several processes may compile the same kernel.
+class FileLock {
+ public:
+  explicit FileLock(const std::string& path) {
+#ifndef _WIN32
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd_ >= 0 && flock(fd_, LOCK_EX) != 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+#endif
+  }
+
+  ~FileLock() {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+      flock(fd_, LOCK_UN);
+      close(fd_);
+    }
+#endif
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+} // namespace
+
+CachedKernel compileWithDiskCache(
+    const std::string& name,
+    const std::string& code,
+    const std::string& config,
+    const std::function<CachedKernel()>& compile) {
+  const std::string& dir = diskCacheDir();
+  if (dir.empty()) {
+    return compile();
+  }
+  const std::string canonical_code = canonicalCode(name, code);
+  std::stringstream key;
+  key << std::hex << std::hash<std::string>()(config) << "_"
+      << std::hash<std::string>()(canonical_code);
+  const std::string path = dir + "/" + key.str() + ".kernel";
+
+  if (auto kernel = loadEntry(path, config, canonical_code)) {
+    return *kernel;
+  }
+  FileLock lock(path + ".lock");
+  // Another process may have compiled the kernel while we were waiting
+  if (auto kernel = loadEntry(path, config, canonical_code)) {
+    return *kernel;
+  }
+  CachedKernel kernel = compile();
+  storeEntry(path, config, canonical_code, kernel);
+  return kernel;
+}
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <functional>
+#include <string>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// On-disk cache for the binaries of the fused kernels of the legacy fuser,
+// the CUDA fuser and TensorExpr's LLVM backend, so that new processes don't
+// have to compile them again. It is shared by all the processes using
+// the same directory: a process compiling a kernel holds a lock on it, and
+// the other ones wait for the binary instead of compiling it too.
+
+// Directory of the cache, initialized from PYTORCH_FUSER_CACHE_DIR. The
+// cache is disabled if it is empty.
+TORCH_API std::string& diskCacheDir();
+
+struct CachedKernel {
+  // Name of the kernel function in the binary
+  std::string name;
+  std::string binary;
+};
+
+// Returns the compiled kernel, either from the cache or by calling compile()
+// and storing its result.
+//
+// The kernel is looked up by its code and by config, which must describe
+// everything else the binary depends on (compiler version, flags, target
+// architecture). Occurrences of name in the code are ignored, so that the
+// same kernel is found whatever order the kernels were generated in, and the
+// name of the cached kernel is returned instead.
+TORCH_API CachedKernel compileWithDiskCache(
+    const std::string& name,
+    const std::string& code,
+    const std::string& config,
+    const std::function<CachedKernel()>& compile);
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -3714,7 +3714,8 @@ std::unique_ptr<Function> CompilationUnit::define(
     const ResolverPtr& resolver,
     const Self* self,
     const std::unordered_map<std::string, Function*>& function_table,
-    bool shouldMangle) const {
+    bool shouldMangle,
+    bool lazy) const {
   TORCH_INTERNAL_ASSERT(resolver);
   auto _resolver = resolver;
   if (!self) {
@@ -3747,7 +3748,7 @@ std::unique_ptr<Function> CompilationUnit::define(
     }
   }
   auto fn = torch::make_unique<GraphFunction>(
-      std::move(name), std::make_shared<Graph>(), creator);
+      std::move(name), std::make_shared<Graph>(), creator, lazy);
   if (self) {
     // Register this as a method on `self`'s type
     self->getClassType()->addMethod(fn.get());
@@ -3760,7 +3761,8 @@ std::vector<Function*> CompilationUnit::define(
     const std::vector<Def>& definitions,
     const std::vector<ResolverPtr>& resolvers,
     const Self* self,
-    bool shouldMangle) {
+    bool shouldMangle,
+    bool lazy) {
   TORCH_INTERNAL_ASSERT(definitions.size() == resolvers.size());
   std::vector<Function*> functions;
   std::unordered_map<std::string, Function*> function_table;
@@ -3772,13 +3774,18 @@ std::vector<Function*> CompilationUnit::define(
         resolvers[i],
         self,
         function_table,
-        shouldMangle);
+        shouldMangle,
+        lazy);
     const auto& name = fn->name();
     function_table[name] = fn.get();
     functions.push_back(fn.get());
     register_function(std::move(fn));
   }
 
+  if (lazy) {
+    return functions;
+  }
+
   // We need to compile `__init__` first, since it can determine what attributes
   // are available to other methods. So reorder the definitions accordingly.
   for (size_t i = 0; i < definitions.size(); i++) {
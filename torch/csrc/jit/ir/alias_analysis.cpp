@@ -491,6 +491,10 @@ void AliasDb::analyzeImpl(Node* node) {
     case prim::FusedConcat:
     case prim::MMTreeReduce:
     case prim::MMBatchSide:
+    case prim::BatchedLinear:
+    case prim::BatchedConv2d:
+    case prim::BatchedEmbeddingBag:
+    case prim::BatchedPointwise:
     case prim::BroadcastSizes:
     case prim::ChunkSizes:
     case prim::Function:
@@ -1113,6 +1117,27 @@ void AliasDb::copyValue(Value* from, Value* to) {
   origElem->values.insert(to);
 }
 
+void AliasDb::removeWrites(Node* n) {
+  auto it = writeIndex_->find(n);
+  if (it == writeIndex_->end()) {
+    return;
+  }
+  if (!numWritersOfLocation_) {
+    numWritersOfLocation_ = std::unordered_map<unsigned, size_t>();
+    for (const auto& pr : *writeIndex_) {
+      for (const unsigned loc : pr.second) {
+        (*numWritersOfLocation_)[loc]++;
+      }
+    }
+  }
+  for (const unsigned loc : it->second) {
+    if (--numWritersOfLocation_->at(loc) == 0) {
+      writtenToLocationsIndex_->reset(loc);
+    }
+  }
+  writeIndex_->erase(it);
+}
+
 bool AliasDb::moveAfterTopologicallyValid(Node* n, Node* movePoint) {
   return tryMove(n, movePoint, MoveSide::AFTER, /*dryRun=*/false);
 }
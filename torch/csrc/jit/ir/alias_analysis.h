@@ -134,6 +134,10 @@ class AliasDb {
   void copyValue(Value* from, Value* to);
   // Create a new `value` that does not alias anything else.
   void createValue(const Value* value);
+  // Forget the writes of `n` (but not of the nodes in its blocks), e.g. before
+  // destroying it. Takes time proportional to the writes of `n` rather than to
+  // all the writes in the graph.
+  void removeWrites(Node* n);
 
   friend struct MutationRemover;
 
@@ -256,6 +260,9 @@ class AliasDb {
   // Collection of all memory locations that are written to.
   c10::optional<MemoryLocations> writtenToLocationsIndex_;
   MemoryLocations buildWrittenToLocationsIndex() const;
+  // Number of nodes writing to each memory location, built by the first
+  // removeWrites to update writtenToLocationsIndex_ incrementally.
+  c10::optional<std::unordered_map<unsigned, size_t>> numWritersOfLocation_;
 
   std::unordered_set<const Value*> wildcards_;
 
@@ -39,6 +39,11 @@ class SubgraphMatcher {
   bool matchValues(const Value* v1, Value* v2);
   bool matchNodes(const Node* n1, Node* n2);
   bool matchAttributes(const Node* n1, Node* n2);
+  const std::regex& patternRegex(const std::string& pattern);
+
+  // compiled string attribute patterns, compiling them is much more expensive
+  // than matching them
+  std::unordered_map<std::string, std::regex> regexes_;
 
   std::unordered_map<const Node*, Node*> nodes_map_;
   std::unordered_map<const Value*, Value*> values_map_;
@@ -117,6 +122,14 @@ bool SubgraphMatcher::matchValues(const Value* v1, Value* v2) {
   return matchNodes(v1->node(), v2->node());
 }
 
+const std::regex& SubgraphMatcher::patternRegex(const std::string& pattern) {
+  auto it = regexes_.find(pattern);
+  if (it == regexes_.end()) {
+    it = regexes_.emplace(pattern, std::regex(pattern)).first;
+  }
+  return it->second;
+}
+
 bool SubgraphMatcher::matchAttributes(const Node* n1, Node* n2) {
   if (n1->numAttributes() != n2->numAttributes()) {
     GRAPH_DEBUG("Nodes did not match in number attributes:\n", *n1, *n2);
@@ -134,7 +147,8 @@ bool SubgraphMatcher::matchAttributes(const Node* n1, Node* n2) {
     }
     switch (n1->kindOf(attr_name)) {
       case AttributeKind::s:
-        if (!std::regex_match(n2->s(attr_name), std::regex(n1->s(attr_name)))) {
+        if (!std::regex_match(
+                n2->s(attr_name), patternRegex(n1->s(attr_name)))) {
           GRAPH_DEBUG(
               "Nodes did not match because attribute '",
               attr_name.toQualString(),
@@ -308,6 +322,37 @@ bool SubgraphMatcher::matchesSubgraphFromAnchorNode(Node* anchor) {
   return true;
 }
 
+/**
+ * The kind a node must have to anchor a match of \p PATTERN, if there is a
+ * single one. The special match::module node matches nodes of any kind.
+ */
+c10::optional<Symbol> anchorKind(const Graph& pattern) {
+  const Node* bottom_node = pattern.return_node()->input()->node();
+  if (bottom_node->kind() == prim::Param ||
+      bottom_node->kind() == Symbol::fromQualString("match::module")) {
+    return c10::nullopt;
+  }
+  return bottom_node->kind();
+}
+
+// Calls \p FN on all nodes in the graph (including nodes in subblocks), in the
+// order matches are looked for.
+template <typename Fn>
+void visitNodes(Graph& graph, const Fn& fn) {
+  std::stack<Block*> blocks_to_visit;
+  blocks_to_visit.push(graph.block());
+  while (!blocks_to_visit.empty()) {
+    Block* block = blocks_to_visit.top();
+    blocks_to_visit.pop();
+    for (Node* n : block->nodes()) {
+      fn(n);
+      for (Block* subblock : n->blocks()) {
+        blocks_to_visit.push(subblock);
+      }
+    }
+  }
+}
+
 } // unnamed namespace
 
 // Main entry point for the subgraph matching.
@@ -317,22 +362,46 @@ std::vector<Match> findPatternMatches(const Graph& pattern, Graph& graph) {
   GRAPH_DUMP("Target graph: ", &graph);
 
   SubgraphMatcher m(pattern);
+  const c10::optional<Symbol> anchor_kind = anchorKind(pattern);
   std::vector<Match> matches;
-  std::stack<Block*> blocks_to_visit;
 
-  // Iterate over all nodes in the graph (including nodes in subblocks) trying
-  // to match the pattern each node.
-  blocks_to_visit.push(graph.block());
-  while (!blocks_to_visit.empty()) {
-    Block* block = blocks_to_visit.top();
-    blocks_to_visit.pop();
-    for (Node* n : block->nodes()) {
-      if (m.matchesSubgraphFromAnchorNode(n)) {
-        matches.push_back({n, m.nodes_map(), m.values_map()});
-      }
-      for (Block* subblock : n->blocks()) {
-        blocks_to_visit.push(subblock);
-      }
+  // Try to match the pattern at each node of the kind the pattern ends in
+  visitNodes(graph, [&](Node* n) {
+    if ((!anchor_kind || n->kind() == *anchor_kind) &&
+        m.matchesSubgraphFromAnchorNode(n)) {
+      matches.push_back({n, m.nodes_map(), m.values_map()});
+    }
+  });
+  return matches;
+}
+
+NodesByKind indexNodesByKind(Graph& graph) {
+  NodesByKind nodes_by_kind;
+  visitNodes(graph, [&](Node* n) { nodes_by_kind[n->kind()].push_back(n); });
+  return nodes_by_kind;
+}
+
+std::vector<Match> findPatternMatches(
+    const Graph& pattern,
+    Graph& graph,
+    const NodesByKind& nodes_by_kind) {
+  const c10::optional<Symbol> anchor_kind = anchorKind(pattern);
+  if (!anchor_kind) {
+    return findPatternMatches(pattern, graph);
+  }
+  AT_ASSERT(patternGraphIsValid(pattern));
+  GRAPH_DUMP("Pattern graph: ", &pattern);
+  GRAPH_DUMP("Target graph: ", &graph);
+
+  std::vector<Match> matches;
+  auto it = nodes_by_kind.find(*anchor_kind);
+  if (it == nodes_by_kind.end()) {
+    return matches;
+  }
+  SubgraphMatcher m(pattern);
+  for (Node* n : it->second) {
+    if (m.matchesSubgraphFromAnchorNode(n)) {
+      matches.push_back({n, m.nodes_map(), m.values_map()});
     }
   }
   return matches;
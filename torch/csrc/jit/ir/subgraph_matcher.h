@@ -49,5 +49,30 @@ struct Match {
 std::vector<Match> TORCH_API
 findPatternMatches(const Graph& pattern, Graph& graph);
 
+/**
+ * \brief The nodes of a graph, including the nodes in subblocks, grouped by
+ * kind.
+ *
+ * Only nodes of the kind of the node a pattern returns can anchor a match, so
+ * with an index matching a pattern only visits those. Each group keeps the
+ * order `findPatternMatches` visits the nodes in. The index is invalidated by
+ * any change to the graph.
+ */
+using NodesByKind = std::unordered_map<Symbol, std::vector<Node*>>;
+
+NodesByKind TORCH_API indexNodesByKind(Graph& graph);
+
+/**
+ * \brief Find all matches of a \p PATTERN in a \p GRAPH whose nodes are
+ * indexed in \p NODES_BY_KIND.
+ *
+ * Returns the same matches as the overload above, but is cheaper when matching
+ * several patterns on an unchanged graph.
+ */
+std::vector<Match> TORCH_API findPatternMatches(
+    const Graph& pattern,
+    Graph& graph,
+    const NodesByKind& nodes_by_kind);
+
 } // namespace jit
 } // namespace torch
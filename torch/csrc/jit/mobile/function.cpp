@@ -11,9 +11,49 @@ namespace jit {
 
 char const* toString(OpCode op);
 namespace mobile {
+namespace {
+
+// Operators of the JIT registry resolved so far, shared by all the functions
+// of all the loaded modules. findOperatorFor locks the registry and scans the
+// overloads of the operator, while the same few dozen operators typically
+// appear hundreds of times across the methods of a model. The registry owns
+// its operators through shared_ptrs, so the entries can't dangle. Operators
+// not found aren't cached, since they may be registered later.
+class JitOperatorCache {
+ public:
+  std::shared_ptr<Operator> find(const c10::OperatorName& opname) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto it = operators_.find(opname);
+      if (it != operators_.end()) {
+        return it->second;
+      }
+    }
+    auto op = findOperatorFor(opname);
+    if (op) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      operators_.emplace(opname, op);
+    }
+    return op;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<c10::OperatorName, std::shared_ptr<Operator>> operators_;
+};
+
+JitOperatorCache& jitOperatorCache() {
+  static JitOperatorCache cache;
+  return cache;
+}
+
+} // namespace
+
 Function::Function(c10::QualifiedName name)
     : name_(name), code_(std::make_shared<Code>()) {}
 
+Function::~Function() = default;
+
 void Function::append_instruction(OpCode op, int X, int N) {
   TORCH_CHECK(
       op != CREATE_OBJECT,
@@ -37,7 +77,7 @@ bool Function::append_operator(
   auto opname_c10 = opname;
   std::function<void(Stack&)> fn;
 
-  auto jit_op = findOperatorFor(opname);
+  auto jit_op = jitOperatorCache().find(opname);
   if (jit_op) {
     fn = [jit_op](Stack& stack) { jit_op->getOperation()(&stack); };
   } else {
@@ -65,9 +105,32 @@ void Function::set_register_size(size_t size) {
   code_->register_size_ = size;
 }
 
+void Function::set_stack_size(size_t size) {
+  code_->stack_size_ = size;
+}
+
+size_t Function::stack_size() const {
+  return code_->stack_size_;
+}
+
 bool Function::run(Stack& stack) const {
-  InterpreterState interp_state(code_);
-  return interp_state.run(stack);
+  std::unique_ptr<InterpreterState> interp_state;
+  {
+    std::lock_guard<std::mutex> guard(idle_states_mutex_);
+    if (!idle_states_.empty()) {
+      interp_state = std::move(idle_states_.back());
+      idle_states_.pop_back();
+    }
+  }
+  if (!interp_state) {
+    interp_state = std::make_unique<InterpreterState>(code_);
+  }
+  // A state left by an exception may still hold values in its registers, it
+  // is dropped instead of being reused
+  bool result = interp_state->run(stack);
+  std::lock_guard<std::mutex> guard(idle_states_mutex_);
+  idle_states_.push_back(std::move(interp_state));
+  return result;
 }
 } // namespace mobile
 } // namespace jit
@@ -1,6 +1,7 @@
 #pragma once
 #include <ATen/core/ivalue.h>
 //#include <aten/src/Aten/core/operator_name.h>
+#include <mutex>
 #include <vector>
 
 namespace torch {
@@ -10,10 +11,12 @@ enum OpCode : uint8_t;
 
 namespace mobile {
 struct Code;
+struct InterpreterState;
 
 class Function {
  public:
   Function(c10::QualifiedName name);
+  ~Function();
   bool run(Stack& stack) const;
   const std::string& name() const;
   const c10::QualifiedName& qualname() const;
@@ -25,10 +28,17 @@ class Function {
   void append_type(const c10::TypePtr& type);
 
   void set_register_size(size_t size);
+  void set_stack_size(size_t size);
+  size_t stack_size() const;
 
  private:
   c10::QualifiedName name_;
   std::shared_ptr<Code> code_;
+  // States that finished running code_, reused by the next calls so that
+  // their registers are only allocated once. Concurrent and recursive calls
+  // each take their own.
+  mutable std::mutex idle_states_mutex_;
+  mutable std::vector<std::unique_ptr<InterpreterState>> idle_states_;
 };
 
 } // namespace mobile
@@ -1,6 +1,7 @@
 #include <torch/csrc/jit/mobile/import.h>
 #include <ATen/core/ivalue.h>
 #include <caffe2/serialize/inline_container.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
 #include <torch/csrc/jit/api/compilation_unit.h>
 #include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/mobile/type_parser.h>
@@ -27,7 +28,8 @@
 //      ('operators', (('aten::Int', 'Tensor'),)),
 //      ('constants', ()),
 //      ('types', ()),
-//      ('register_size', 2))))
+//      ('register_size', 2),
+//      ('stack_size', 1))))
 
 // Note that currently the backward compatibility is not supported by bytecode.
 // This format and process need to be revisted and redesigned if we want to
@@ -125,7 +127,14 @@ void parseMethods(
             ->elements();
     const auto& types_list =
         expect_field(table, "types", BYTECODE_INDEX_TYPE).toTuple()->elements();
-    const auto& register_size = expect_field(table, "register_size", 4).toInt();
+    const auto& register_size =
+        expect_field(table, "register_size", BYTECODE_INDEX_REGISTER_SIZE)
+            .toInt();
+    int64_t stack_size = 0;
+    if (table.toTuple()->elements().size() > BYTECODE_INDEX_STACK_SIZE) {
+      stack_size =
+          expect_field(table, "stack_size", BYTECODE_INDEX_STACK_SIZE).toInt();
+    }
 
     for (const auto& ins : ins_list) {
       auto ins_item = ins.toTuple()->elements();
@@ -165,6 +174,7 @@ void parseMethods(
     }
 
     function->set_register_size(register_size);
+    function->set_stack_size(stack_size);
 
     mcu.register_function(std::move(function));
   }
@@ -176,14 +186,26 @@ class BytecodeDeserializer final {
   explicit BytecodeDeserializer(std::unique_ptr<PyTorchStreamReader> reader);
   mobile::Module deserialize(c10::optional<at::Device> device);
 
+  // Bytes of the records read so far, see
+  // MobileModuleObserver::onLoadModelMemory
+  size_t mappedBytes() const {
+    return mapped_bytes_;
+  }
+  size_t copiedBytes() const {
+    return copied_bytes_;
+  }
+
  private:
   c10::IValue readArchive(
       const std::string& archive_name,
       std::shared_ptr<mobile::CompilationUnit> mcu);
+  std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
   std::shared_ptr<CompilationUnit> compilation_unit_;
   std::unordered_set<std::string> imported_libs_;
   std::unique_ptr<PyTorchStreamReader> reader_;
   c10::optional<at::Device> device_;
+  size_t mapped_bytes_ = 0;
+  size_t copied_bytes_ = 0;
 };
 
 BytecodeDeserializer::BytecodeDeserializer(
@@ -201,6 +223,17 @@ mobile::Module BytecodeDeserializer::deserialize(
   return mobile::Module(readArchive("data", mcu).toObject(), mcu);
 }
 
+std::tuple<at::DataPtr, size_t> BytecodeDeserializer::getRecord(
+    const std::string& name) {
+  auto record = reader_->getRecord(name);
+  if (caffe2::serialize::MmapFileAdapter::isMapped(std::get<0>(record))) {
+    mapped_bytes_ += std::get<1>(record);
+  } else {
+    copied_bytes_ += std::get<1>(record);
+  }
+  return record;
+}
+
 c10::IValue BytecodeDeserializer::readArchive(
     const std::string& archive_name,
     std::shared_ptr<mobile::CompilationUnit> mcu) {
@@ -208,7 +241,7 @@ c10::IValue BytecodeDeserializer::readArchive(
   picklename << archive_name << ".pkl";
   at::DataPtr pickle_ptr;
   size_t pickle_size;
-  std::tie(pickle_ptr, pickle_size) = reader_->getRecord(picklename.str());
+  std::tie(pickle_ptr, pickle_size) = getRecord(picklename.str());
 
   size_t bytes_read = 0;
   auto data = reinterpret_cast<const char*>(pickle_ptr.get());
@@ -282,7 +315,7 @@ c10::IValue BytecodeDeserializer::readArchive(
   auto read_record = [&](const std::string& name) {
     std::stringstream ss;
     ss << archive_name << "/" << name;
-    return std::get<0>(reader_->getRecord(ss.str()));
+    return std::get<0>(getRecord(ss.str()));
   };
 
   Unpickler unpickler(
@@ -306,8 +339,14 @@ mobile::Module _load_for_mobile(
 
 mobile::Module _load_for_mobile(
     const std::string& filename,
-    c10::optional<at::Device> device) {
-  std::unique_ptr<FileAdapter> rai = std::make_unique<FileAdapter>(filename);
+    c10::optional<at::Device> device,
+    bool mmap) {
+  std::unique_ptr<ReadAdapterInterface> rai;
+  if (mmap) {
+    rai = std::make_unique<caffe2::serialize::MmapFileAdapter>(filename);
+  } else {
+    rai = std::make_unique<FileAdapter>(filename);
+  }
   auto module = _load_for_mobile(std::move(rai), device);
   return module;
 }
@@ -325,6 +364,8 @@ mobile::Module _load_for_mobile(
     mobile::Module result = deserializer.deserialize(std::move(device));
     std::string name = result.name();
     if (observer) {
+      observer->onLoadModelMemory(
+          deserializer.mappedBytes(), deserializer.copiedBytes());
       observer->onExitLoadModel(name);
     }
     return result;
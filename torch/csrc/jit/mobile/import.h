@@ -16,9 +16,15 @@ TORCH_API mobile::Module _load_for_mobile(
     std::istream& in,
     c10::optional<at::Device> device = c10::nullopt);
 
+// With mmap, the file is mapped in memory and read through a
+// caffe2::serialize::MmapFileAdapter: the bytecode is unpickled in place and
+// the CPU tensors point into the mapping instead of being copied, so that
+// loading doesn't need memory for the whole archive. Writes to the tensors are
+// not seen in the file.
 TORCH_API mobile::Module _load_for_mobile(
     const std::string& filename,
-    c10::optional<at::Device> device = c10::nullopt);
+    c10::optional<at::Device> device = c10::nullopt,
+    bool mmap = false);
 
 TORCH_API mobile::Module _load_for_mobile(
     std::unique_ptr<ReadAdapterInterface> rai,
@@ -6,13 +6,54 @@
 #include <torch/csrc/jit/runtime/vararg_functions.h>
 
 #include <ATen/record_function.h>
+#include <c10/core/Allocator.h>
 #include <torch/csrc/jit/mobile/observer.h>
 
+#include <atomic>
+#include <chrono>
+
 namespace torch {
 namespace jit {
 char const* toString(OpCode op);
 std::ostream& operator<<(std::ostream& out, Instruction inst);
 namespace mobile {
+
+namespace {
+
+// Counts the CPU memory the operators allocate while an op observer is set,
+// passing the reports on to the memory profiler if that is enabled too.
+class OpMemoryCounter : public c10::MemoryReportingInfoBase {
+ public:
+  explicit OpMemoryCounter(std::shared_ptr<c10::DebugInfoBase> parent)
+      : parent_(std::move(parent)) {}
+
+  void reportMemoryUsage(void* ptr, int64_t alloc_size, c10::Device device)
+      override {
+    if (alloc_size > 0 && device.is_cpu()) {
+      allocated_bytes_ += alloc_size;
+    }
+    auto* parent = static_cast<c10::MemoryReportingInfoBase*>(parent_.get());
+    if (parent && parent->memoryProfilingEnabled()) {
+      parent->reportMemoryUsage(ptr, alloc_size, device);
+    }
+  }
+
+  bool memoryProfilingEnabled() const override {
+    return true;
+  }
+
+  int64_t allocatedBytes() const {
+    return allocated_bytes_;
+  }
+
+ private:
+  std::shared_ptr<c10::DebugInfoBase> parent_;
+  // Kernels may allocate from the threads of the intra-op pool
+  std::atomic<int64_t> allocated_bytes_{0};
+};
+
+} // namespace
+
 InterpreterState::InterpreterState(std::shared_ptr<Code> code)
     : code_(std::move(code)) {
   registers_.resize(code_->register_size_);
@@ -21,6 +62,34 @@ InterpreterState::InterpreterState(std::shared_ptr<Code> code)
 using namespace at;
 
 bool InterpreterState::run(Stack& stack) {
+  // No-op once the caller's stack has been grown to the frame size
+  stack.reserve(stack.size() + code_->stack_size_);
+
+  MobileOpObserver* op_observer = torch::observerConfig().getOpObserver();
+  std::shared_ptr<OpMemoryCounter> memory_counter;
+  std::unique_ptr<at::DebugInfoGuard> memory_guard;
+  if (C10_UNLIKELY(op_observer)) {
+    memory_counter = std::make_shared<OpMemoryCounter>(
+        c10::ThreadLocalDebugInfo::get(c10::DebugInfoKind::PROFILER_STATE));
+    memory_guard = std::make_unique<at::DebugInfoGuard>(
+        c10::DebugInfoKind::PROFILER_STATE, memory_counter);
+  }
+  const auto run_operator = [&](size_t index) {
+    if (C10_LIKELY(!op_observer)) {
+      code_->operators_[index](stack);
+      return;
+    }
+    const int64_t allocated_bytes = memory_counter->allocatedBytes();
+    const auto start = std::chrono::steady_clock::now();
+    code_->operators_[index](stack);
+    const auto end = std::chrono::steady_clock::now();
+    op_observer->onOp(
+        code_->op_names_[index],
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count(),
+        memory_counter->allocatedBytes() - allocated_bytes);
+  };
+
   size_t pc = 0;
   while (true) {
     Instruction inst = code_->instructions_[pc];
@@ -56,12 +125,12 @@ bool InterpreterState::run(Stack& stack) {
         if (!prev_value) {
           enableRecordFunction(false);
         }
-        code_->operators_[inst.X](stack);
+        run_operator(inst.X);
         ++pc;
       } break;
       case OPN: {
         stack.push_back(inst.N);
-        code_->operators_[inst.X](stack);
+        run_operator(inst.X);
         ++pc;
       } break;
       case INTERFACE_CALL: {
@@ -148,6 +217,9 @@ bool InterpreterState::run(Stack& stack) {
         }
       } break;
       case RET:
+        for (auto& r : registers_) {
+          r = IValue();
+        }
         return false;
       case LIST_CONSTRUCT: {
         auto type = code_->types_[inst.X]->expect<at::ListType>();
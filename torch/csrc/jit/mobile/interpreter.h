@@ -15,8 +15,11 @@ struct Code {
   std::vector<c10::IValue> constants_;
   std::vector<c10::TypePtr> types_;
   size_t register_size_; // Aggregated output size.
+  size_t stack_size_ = 0; // Maximum depth of the stack, 0 if unknown.
 };
 
+// The registers are allocated once, and cleared when run returns, so that a
+// state can run its code again without allocating.
 struct InterpreterState {
   TORCH_API explicit InterpreterState(std::shared_ptr<Code> code);
   TORCH_API bool run(Stack& stack);
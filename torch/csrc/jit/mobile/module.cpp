@@ -38,9 +38,14 @@ c10::IValue Module::run_method(const std::string& method_name, Stack stack) {
     observer->onEnterRunMethod(name(), method_name);
   }
 
-  auto debug_info = std::make_shared<MobileDebugInfo>();
-  debug_info->setModelName(name());
-  debug_info->setMethodName(method_name);
+  // The debug info is only read by the RecordFunction callbacks, don't
+  // allocate it for every call when there are none
+  std::shared_ptr<MobileDebugInfo> debug_info;
+  if (at::hasCallbacks()) {
+    debug_info = std::make_shared<MobileDebugInfo>();
+    debug_info->setModelName(name());
+    debug_info->setMethodName(method_name);
+  }
   at::DebugInfoGuard guard(at::DebugInfoKind::MOBILE_RUNTIME_INFO, debug_info);
 
   auto m = find_method(method_name);
@@ -53,9 +58,11 @@ c10::IValue Module::run_method(const std::string& method_name, Stack stack) {
     AT_ERROR("Method '", method_name, "' is not defined.");
   }
   try {
+    // Grow the stack to the whole frame at once
+    stack.reserve(stack.size() + 1 + m->stack_size());
     stack.insert(stack.begin(), object_);
     m->run(stack);
-    c10::IValue result = stack.front();
+    c10::IValue result = std::move(stack.front());
     if (observer) {
       observer->onExitRunMethod();
     }
@@ -1,5 +1,7 @@
 #include <torch/csrc/jit/mobile/observer.h>
 
+#include <algorithm>
+
 namespace torch {
 
 MobileObserverConfig& observerConfig() {
@@ -7,4 +9,44 @@ MobileObserverConfig& observerConfig() {
   return instance;
 }
 
+void MobileOpStatsObserver::onOp(
+    const c10::OperatorName& op,
+    int64_t latency_ns,
+    int64_t allocated_bytes) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = stats_.find(op);
+  if (it == stats_.end()) {
+    it = stats_.emplace(op, MobileOpStats()).first;
+    it->second.op_name = c10::toString(op);
+  }
+  MobileOpStats& stats = it->second;
+  ++stats.count;
+  stats.total_ns += latency_ns;
+  stats.max_ns = std::max(stats.max_ns, latency_ns);
+  stats.allocated_bytes += allocated_bytes;
+}
+
+std::vector<MobileOpStats> MobileOpStatsObserver::summary() const {
+  std::vector<MobileOpStats> summary;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    summary.reserve(stats_.size());
+    for (const auto& entry : stats_) {
+      summary.push_back(entry.second);
+    }
+  }
+  std::sort(
+      summary.begin(),
+      summary.end(),
+      [](const MobileOpStats& a, const MobileOpStats& b) {
+        return a.total_ns > b.total_ns;
+      });
+  return summary;
+}
+
+void MobileOpStatsObserver::reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  stats_.clear();
+}
+
 } // namespace torch
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <ATen/core/operator_name.h>
 #include <c10/util/ThreadLocalDebugInfo.h>
+
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace torch {
 
@@ -49,9 +54,60 @@ class MobileModuleObserver {
   virtual void onFailRunMethod(const std::string&) {}
   virtual void onEnterLoadModel() {}
   virtual void onExitLoadModel(const std::string&) {}
+  // Called before onExitLoadModel with the sizes of the records read from
+  // the model file: the ones pointing into a memory mapping of the file (see
+  // the mmap argument of _load_for_mobile), and the ones copied to memory of
+  // their own, which add up to the load-time memory on top of the mapping.
+  virtual void onLoadModelMemory(
+      size_t /*mapped_bytes*/,
+      size_t /*copied_bytes*/) {}
   virtual void onFailLoadModel(const std::string&) {}
 };
 
+// Called by the lite interpreter after each of the operators it runs. The
+// interpreter only times the operators and counts their allocations while an
+// op observer is set, which is not the case by default.
+class MobileOpObserver {
+ public:
+  virtual ~MobileOpObserver() = default;
+
+  // latency_ns is the wall time the operator took, and allocated_bytes the
+  // CPU memory it allocated, whether freed again or not.
+  virtual void onOp(
+      const c10::OperatorName& /*op*/,
+      int64_t /*latency_ns*/,
+      int64_t /*allocated_bytes*/) {}
+};
+
+struct MobileOpStats {
+  // name.overload_name
+  std::string op_name;
+  int64_t count = 0;
+  int64_t total_ns = 0;
+  int64_t max_ns = 0;
+  int64_t allocated_bytes = 0;
+};
+
+// Aggregates the operators run by all the interpreters by operator, for
+// apps to report which operators their models spend their time in.
+class MobileOpStatsObserver : public MobileOpObserver {
+ public:
+  void onOp(
+      const c10::OperatorName& op,
+      int64_t latency_ns,
+      int64_t allocated_bytes) override;
+
+  // The operators run since the last reset, by decreasing total time.
+  std::vector<MobileOpStats> summary() const;
+  void reset();
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<c10::OperatorName, MobileOpStats> stats_;
+};
+
+// The observers must be set before, and stay set while, models are loaded or
+// run on other threads.
 class MobileObserverConfig {
  public:
   void setModuleObserver(std::unique_ptr<MobileModuleObserver> reporter) {
@@ -60,9 +116,16 @@ class MobileObserverConfig {
   MobileModuleObserver* getModuleObserver() {
     return module_observer_.get();
   }
+  void setOpObserver(std::unique_ptr<MobileOpObserver> op_observer) {
+    op_observer_ = std::move(op_observer);
+  }
+  MobileOpObserver* getOpObserver() {
+    return op_observer_.get();
+  }
 
  private:
   std::unique_ptr<MobileModuleObserver> module_observer_;
+  std::unique_ptr<MobileOpObserver> op_observer_;
 };
 
 MobileObserverConfig& observerConfig();
@@ -11,6 +11,8 @@
 
 #include <ATen/ATen.h>
 #include <algorithm>
+#include <map>
+#include <sstream>
 #include <unordered_map>
 
 namespace torch {
@@ -361,6 +363,27 @@ RegisterOperators mm_batch_side_reg({Operator(
     },
     aliasAnalysisIsSpecialCase())});
 
+// Filter out the nodes that depend on one of the previous ones. Nodes must be
+// sorted in topological order. This algorithm might do very badly if e.g. you
+// have a lot of independent nodes, that depend on the first one, but I doubt
+// this will be a common scenario.
+std::vector<Node*> filterDependentNodes(
+    std::vector<Node*> nodes,
+    AliasDb& alias_db) {
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i] == nullptr)
+      continue;
+    for (size_t j = i + 1; j < nodes.size(); ++j) {
+      if (nodes[j] == nullptr)
+        continue;
+      if (!alias_db.couldMoveBeforeTopologically(nodes[j], nodes[i])) {
+        nodes[j] = nullptr;
+      }
+    }
+  }
+  return c10::filter(nodes, [](Node* n) { return n != nullptr; });
+}
+
 std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
     Value* value,
     AliasDb& alias_db) {
@@ -371,21 +394,7 @@ std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
     std::sort(mms.begin(), mms.end(), [](Node* n, Node* m) {
       return n->isBefore(m);
     });
-    // Filter out dependent MMs. This algorithm might do very badly if e.g. you
-    // have a lot of independent MMs, that depend on the first one, but I doubt
-    // this will be a common scenario.
-    for (size_t i = 0; i < mms.size(); ++i) {
-      if (mms[i] == nullptr)
-        continue;
-      for (size_t j = i + 1; j < mms.size(); ++j) {
-        if (mms[j] == nullptr)
-          continue;
-        if (!alias_db.couldMoveBeforeTopologically(mms[j], mms[i])) {
-          mms[j] = nullptr;
-        }
-      }
-    }
-    return c10::filter(mms, [](Node* n) { return n != nullptr; });
+    return filterDependentNodes(std::move(mms), alias_db);
   };
 
   Block* block = value->node()->owningBlock();
@@ -452,6 +461,470 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   }
 }
 
+// Horizontal batching of independent ops
+//
+// Models often apply the same op to several inputs that don't depend on each
+// other: the towers of a multi-task model all start with a linear layer on the
+// same features, a recommendation model looks up many embedding tables with
+// the same embedding dim, an ensemble runs identical convolutions side by
+// side. Each of these ops is usually too small to keep the device busy, so we
+// replace N independent calls that can be moved next to each other with a
+// single prim::Batched* node. When the shapes check out at runtime it computes
+// all of them with one larger kernel, and otherwise it runs the ops one by
+// one.
+//
+// prim::BatchedLinear(inputs..., weights..., biases...)
+//   If all the inputs are the same tensor, the weights are concatenated along
+//   the output features, and the output of a single linear is split. If the
+//   inputs and the weights all have the same shapes, a single bmm is run on
+//   the stacked inputs and weights.
+// prim::BatchedConv2d(inputs..., weights..., biases...)
+//   If the inputs and the weights all have the same shapes, the inputs are
+//   concatenated along the channels and the weights along the output
+//   channels, and a single convolution with N times more groups is run. Only
+//   used on CUDA, where grouped convolutions are fast.
+// prim::BatchedEmbeddingBag(weights..., indices..., offsets...)
+//   If the tables have the same embedding dim and all the lookups have the
+//   same number of bags, the tables are concatenated, the indices are shifted
+//   by the number of rows of the tables before them, and a single
+//   embedding_bag is run.
+// prim::BatchedPointwise(inputs...)
+//   If the inputs are small CUDA tensors of the same shape, the op is run once
+//   on the stacked inputs, saving the kernel launches.
+//
+// Weights and biases that are constants (e.g. in a frozen module) are
+// concatenated once, when the op is created.
+
+// Tunable parameter. Set to something larger if it turns out to be better.
+static constexpr size_t min_batch_size = 2;
+
+bool have_same_options(at::TensorList inputs) {
+  return std::all_of(inputs.begin(), inputs.end(), [&](const at::Tensor& t) {
+    return t.scalar_type() == inputs[0].scalar_type() &&
+        t.device() == inputs[0].device();
+  });
+}
+
+bool have_same_inner_dim(at::TensorList weights) {
+  return std::all_of(weights.begin(), weights.end(), [&](const at::Tensor& w) {
+    return w.dim() == 2 && w.size(1) == weights[0].size(1);
+  });
+}
+
+// Biases are batched only if they are all given or all None
+bool biases_are_uniform(at::TensorList biases, bool& has_bias) {
+  has_bias = biases[0].defined();
+  return std::all_of(biases.begin(), biases.end(), [&](const at::Tensor& b) {
+    return b.defined() == has_bias;
+  });
+}
+
+bool shape_is_fast_for_pointwise(const at::Tensor& input) {
+  // Past this size the kernel launch isn't what dominates
+  return input.is_cuda() && input.numel() <= 64 * 1024;
+}
+
+std::vector<at::Tensor> pop_tensors(Stack* stack, size_t num_tensors) {
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(num_tensors);
+  for (auto it = stack->end() - num_tensors; it != stack->end(); ++it) {
+    tensors.push_back(it->isNone() ? at::Tensor() : std::move(*it).toTensor());
+  }
+  drop(stack, num_tensors);
+  return tensors;
+}
+
+void push_tensors(Stack* stack, std::vector<at::Tensor> tensors) {
+  stack->insert(
+      stack->end(),
+      std::make_move_iterator(tensors.begin()),
+      std::make_move_iterator(tensors.end()));
+}
+
+// Concatenation of the given values if they are all constant tensors which
+// don't require grad
+c10::optional<at::Tensor> cat_constant_tensors(
+    at::ArrayRef<const Value*> values,
+    int64_t dim) {
+  std::vector<at::Tensor> tensors;
+  for (const Value* v : values) {
+    auto ival = toIValue(v);
+    if (!ival || !ival->isTensor() || ival->toTensor().requires_grad()) {
+      return c10::nullopt;
+    }
+    tensors.push_back(ival->toTensor());
+  }
+  try {
+    return at::cat(tensors, dim);
+  } catch (const c10::Error&) {
+    // The shapes don't allow it, we'll fall back at runtime
+    return c10::nullopt;
+  }
+}
+
+RegisterOperators batched_ops_reg(
+    {Operator(
+         prim::BatchedLinear,
+         [](const Node* node) -> Operation {
+           size_t num_ops = node->outputs().size();
+           auto const_weight =
+               cat_constant_tensors(node->inputs().slice(num_ops, num_ops), 0);
+           auto const_bias = cat_constant_tensors(
+               node->inputs().slice(2 * num_ops, num_ops), 0);
+           return [num_ops, const_weight, const_bias](Stack* stack) {
+             auto biases = pop_tensors(stack, num_ops);
+             auto weights = pop_tensors(stack, num_ops);
+             auto inputs = pop_tensors(stack, num_ops);
+
+             bool has_bias = false;
+             bool same_input = std::all_of(
+                 inputs.begin(), inputs.end(), [&](const at::Tensor& t) {
+                   return t.is_same(inputs[0]);
+                 });
+             if (!biases_are_uniform(biases, has_bias) ||
+                 !have_same_options(weights)) {
+               // Fall through to the unbatched version
+             } else if (same_input && have_same_inner_dim(weights)) {
+               auto weight = const_weight ? *const_weight : at::cat(weights, 0);
+               at::Tensor bias;
+               if (has_bias) {
+                 bias = const_bias ? *const_bias : at::cat(biases, 0);
+               }
+               auto split_sizes = fmap(
+                   weights, [](const at::Tensor& w) { return w.size(0); });
+               push_tensors(
+                   stack,
+                   at::split_with_sizes(
+                       at::linear(inputs[0], weight, bias),
+                       split_sizes,
+                       /*dim=*/-1));
+               return;
+             } else if (
+                 have_same_shape(inputs) && have_same_options(inputs) &&
+                 have_same_shape(weights) && weights[0].dim() == 2 &&
+                 inputs[0].dim() >= 1) {
+               auto out_sizes = inputs[0].sizes().vec();
+               out_sizes.back() = weights[0].size(0);
+               auto flat_inputs = fmap(inputs, [](const at::Tensor& t) {
+                 return t.reshape({-1, t.size(-1)});
+               });
+               auto batched_input = at::stack(flat_inputs);
+               auto batched_weight = at::stack(weights).transpose(1, 2);
+               auto out = has_bias
+                   ? at::baddbmm(
+                         at::stack(biases).unsqueeze(1),
+                         batched_input,
+                         batched_weight)
+                   : at::bmm(batched_input, batched_weight);
+               push_tensors(
+                   stack, fmap(at::unbind(out), [&](const at::Tensor& o) {
+                     return o.view(out_sizes);
+                   }));
+               return;
+             }
+             for (size_t i = 0; i < num_ops; ++i) {
+               stack->emplace_back(at::linear(inputs[i], weights[i], biases[i]));
+             }
+           };
+         },
+         aliasAnalysisIsSpecialCase()),
+     Operator(
+         prim::BatchedConv2d,
+         [](const Node* node) -> Operation {
+           size_t num_ops = node->outputs().size();
+           auto stride = node->is(Symbol::attr("stride"));
+           auto padding = node->is(Symbol::attr("padding"));
+           auto dilation = node->is(Symbol::attr("dilation"));
+           auto groups = node->i(Symbol::attr("groups"));
+           auto const_weight =
+               cat_constant_tensors(node->inputs().slice(num_ops, num_ops), 0);
+           auto const_bias = cat_constant_tensors(
+               node->inputs().slice(2 * num_ops, num_ops), 0);
+           return [=](Stack* stack) {
+             auto biases = pop_tensors(stack, num_ops);
+             auto weights = pop_tensors(stack, num_ops);
+             auto inputs = pop_tensors(stack, num_ops);
+
+             bool has_bias = false;
+             if (inputs[0].is_cuda() && inputs[0].dim() == 4 &&
+                 biases_are_uniform(biases, has_bias) &&
+                 have_same_shape(inputs) && have_same_options(inputs) &&
+                 have_same_shape(weights) && have_same_options(weights)) {
+               auto weight = const_weight ? *const_weight : at::cat(weights, 0);
+               at::Tensor bias;
+               if (has_bias) {
+                 bias = const_bias ? *const_bias : at::cat(biases, 0);
+               }
+               auto out = at::conv2d(
+                   at::cat(inputs, /*dim=*/1),
+                   weight,
+                   bias,
+                   stride,
+                   padding,
+                   dilation,
+                   groups * num_ops);
+               push_tensors(stack, at::chunk(out, num_ops, /*dim=*/1));
+               return;
+             }
+             for (size_t i = 0; i < num_ops; ++i) {
+               stack->emplace_back(at::conv2d(
+                   inputs[i],
+                   weights[i],
+                   biases[i],
+                   stride,
+                   padding,
+                   dilation,
+                   groups));
+             }
+           };
+         },
+         aliasAnalysisIsSpecialCase()),
+     Operator(
+         prim::BatchedEmbeddingBag,
+         [](const Node* node) -> Operation {
+           size_t num_ops = node->outputs().size();
+           bool scale_grad_by_freq =
+               node->i(Symbol::attr("scale_grad_by_freq"));
+           int64_t mode = node->i(Symbol::attr("mode"));
+           auto const_weight =
+               cat_constant_tensors(node->inputs().slice(0, num_ops), 0);
+           return [=](Stack* stack) {
+             auto offsets = pop_tensors(stack, num_ops);
+             auto indices = pop_tensors(stack, num_ops);
+             auto weights = pop_tensors(stack, num_ops);
+
+             int64_t num_bags = offsets[0].size(0);
+             bool lookups_match = std::all_of(
+                 indices.begin(), indices.end(), [&](const at::Tensor& t) {
+                   return t.dim() == 1 &&
+                       t.scalar_type() == indices[0].scalar_type();
+                 });
+             lookups_match = lookups_match &&
+                 std::all_of(
+                     offsets.begin(), offsets.end(), [&](const at::Tensor& t) {
+                       return t.dim() == 1 && t.size(0) == num_bags &&
+                           t.scalar_type() == indices[0].scalar_type();
+                     });
+             if (lookups_match && have_same_inner_dim(weights) &&
+                 have_same_options(weights)) {
+               std::vector<at::Tensor> shifted_indices;
+               std::vector<at::Tensor> shifted_offsets;
+               int64_t num_rows = 0;
+               int64_t num_indices = 0;
+               for (size_t i = 0; i < num_ops; ++i) {
+                 shifted_indices.push_back(indices[i] + num_rows);
+                 shifted_offsets.push_back(offsets[i] + num_indices);
+                 num_rows += weights[i].size(0);
+                 num_indices += indices[i].size(0);
+               }
+               auto out = std::get<0>(at::embedding_bag(
+                   const_weight ? *const_weight : at::cat(weights, 0),
+                   at::cat(shifted_indices),
+                   at::cat(shifted_offsets),
+                   scale_grad_by_freq,
+                   mode));
+               push_tensors(
+                   stack,
+                   at::split_with_sizes(
+                       out, std::vector<int64_t>(num_ops, num_bags)));
+               return;
+             }
+             for (size_t i = 0; i < num_ops; ++i) {
+               stack->emplace_back(std::get<0>(at::embedding_bag(
+                   weights[i],
+                   indices[i],
+                   offsets[i],
+                   scale_grad_by_freq,
+                   mode)));
+             }
+           };
+         },
+         aliasAnalysisIsSpecialCase()),
+     Operator(
+         prim::BatchedPointwise,
+         [](const Node* node) -> Operation {
+           size_t num_ops = node->outputs().size();
+           const auto& name = node->s(attr::name);
+           at::Tensor (*fn)(const at::Tensor&) = nullptr;
+           if (name == "relu") {
+             fn = at::relu;
+           } else if (name == "sigmoid") {
+             fn = at::sigmoid;
+           } else if (name == "tanh") {
+             fn = at::tanh;
+           }
+           TORCH_INTERNAL_ASSERT(fn, "Unsupported batched op ", name);
+           return [num_ops, fn](Stack* stack) {
+             auto inputs = pop_tensors(stack, num_ops);
+             if (shape_is_fast_for_pointwise(inputs[0]) &&
+                 have_same_shape(inputs) && have_same_options(inputs)) {
+               push_tensors(stack, at::unbind(fn(at::stack(inputs))));
+               return;
+             }
+             for (const at::Tensor& input : inputs) {
+               stack->emplace_back(fn(input));
+             }
+           };
+         },
+         aliasAnalysisIsSpecialCase())});
+
+// Returns the kind of the batched node that can replace node, or nullopt if
+// it can't be batched. Nodes with the same key can be batched together.
+c10::optional<Symbol> batchable(Node* node, std::string& key) {
+  if (node->matches(
+          "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor")) {
+    key = "linear";
+    return prim::BatchedLinear;
+  }
+  if (node->matches(
+          "aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor")) {
+    std::stringstream ss;
+    ss << "conv2d";
+    for (size_t i = 3; i < 7; ++i) {
+      auto ival = toIValue(node->inputs()[i]);
+      if (!ival) {
+        return c10::nullopt;
+      }
+      ss << " " << *ival;
+    }
+    key = ss.str();
+    return prim::BatchedConv2d;
+  }
+  if (node->matches(
+          "aten::embedding_bag(Tensor weight, Tensor indices, Tensor offsets, bool scale_grad_by_freq=False, int mode=0, bool sparse=False, Tensor? per_sample_weights=None, bool include_last_offset=False) -> (Tensor, Tensor, Tensor, Tensor)")) {
+    // The other outputs describe the bags of each lookup, we can't produce
+    // them from the batched one
+    for (size_t i = 1; i < node->outputs().size(); ++i) {
+      if (node->outputs()[i]->hasUses()) {
+        return c10::nullopt;
+      }
+    }
+    auto scale_grad_by_freq = toIValue(node->inputs()[3]);
+    auto mode = toIValue(node->inputs()[4]);
+    auto sparse = toIValue(node->inputs()[5]);
+    auto include_last_offset = toIValue(node->inputs()[7]);
+    // Sparse gradients can't flow through the concatenation of the tables
+    if (!scale_grad_by_freq || !mode || !sparse || sparse->toBool() ||
+        !node->inputs()[6]->mustBeNone() || !include_last_offset ||
+        include_last_offset->toBool()) {
+      return c10::nullopt;
+    }
+    key = c10::str(
+        "embedding_bag ", scale_grad_by_freq->toBool(), " ", mode->toInt());
+    return prim::BatchedEmbeddingBag;
+  }
+  if (node->matches("aten::relu(Tensor self) -> Tensor") ||
+      node->matches("aten::sigmoid(Tensor self) -> Tensor") ||
+      node->matches("aten::tanh(Tensor self) -> Tensor")) {
+    key = node->kind().toQualString();
+    return prim::BatchedPointwise;
+  }
+  return c10::nullopt;
+}
+
+// Keeps the nodes that don't depend on the previous ones, and moves them next
+// to each other. Nodes must be sorted in topological order.
+std::vector<Node*> gatherIndependentNodes(
+    std::vector<Node*> nodes,
+    AliasDb& alias_db) {
+  nodes = filterDependentNodes(std::move(nodes), alias_db);
+  for (int64_t i = static_cast<int64_t>(nodes.size()) - 2; i >= 0; --i) {
+    // If a move isn't possible, batchIndependentNodes will notice that the
+    // group can't be batched
+    alias_db.moveBeforeTopologicallyValid(nodes[i], nodes[i + 1]);
+  }
+  return nodes;
+}
+
+// All the groups are gathered before any node is inserted, since the AliasDb
+// doesn't know about the new nodes
+void gatherBatchableGroups(
+    Block* block,
+    AliasDb& alias_db,
+    std::vector<std::vector<Node*>>& groups) {
+  std::map<std::string, std::vector<Node*>> candidates;
+  for (Node* node : block->nodes()) {
+    std::string key;
+    if (batchable(node, key)) {
+      candidates[key].push_back(node);
+    }
+    for (Block* subblock : node->blocks()) {
+      gatherBatchableGroups(subblock, alias_db, groups);
+    }
+  }
+  for (auto& item : candidates) {
+    if (item.second.size() < min_batch_size)
+      continue;
+    auto nodes = gatherIndependentNodes(std::move(item.second), alias_db);
+    if (nodes.size() >= min_batch_size) {
+      groups.push_back(std::move(nodes));
+    }
+  }
+}
+
+void batchIndependentNodes(std::vector<Node*> nodes) {
+  std::sort(nodes.begin(), nodes.end(), [](Node* n, Node* m) {
+    return n->isBefore(m);
+  });
+  // The batched node goes right before the last node, so that all the inputs
+  // are available. Bail out if one of the outputs is used before that.
+  Node* insert_point = nodes.back();
+  for (Node* node : nodes) {
+    for (const Use& use : node->output()->uses()) {
+      if (!use.user->isAfter(insert_point)) {
+        return;
+      }
+    }
+  }
+
+  std::string key;
+  Symbol kind = *batchable(nodes[0], key);
+  size_t num_batched_inputs = kind == prim::BatchedPointwise ? 1 : 3;
+  Graph* graph = insert_point->owningGraph();
+  WithInsertPoint insert_guard{insert_point};
+  Node* batched = graph->insertNode(
+      graph->create(kind, /*inputs=*/{}, /*num_outputs=*/nodes.size()));
+  for (size_t i = 0; i < num_batched_inputs; ++i) {
+    for (Node* node : nodes) {
+      batched->addInput(node->inputs().at(i));
+    }
+  }
+  Node* first = nodes[0];
+  if (kind == prim::BatchedConv2d) {
+    batched->is_(
+        Symbol::attr("stride"), toIValue(first->inputs()[3])->toIntVector());
+    batched->is_(
+        Symbol::attr("padding"), toIValue(first->inputs()[4])->toIntVector());
+    batched->is_(
+        Symbol::attr("dilation"), toIValue(first->inputs()[5])->toIntVector());
+    batched->i_(Symbol::attr("groups"), toIValue(first->inputs()[6])->toInt());
+  } else if (kind == prim::BatchedEmbeddingBag) {
+    batched->i_(
+        Symbol::attr("scale_grad_by_freq"),
+        toIValue(first->inputs()[3])->toBool());
+    batched->i_(Symbol::attr("mode"), toIValue(first->inputs()[4])->toInt());
+  } else if (kind == prim::BatchedPointwise) {
+    batched->s_(attr::name, first->kind().toUnqualString());
+  }
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    Value* output = nodes[i]->outputs().at(0);
+    batched->outputs().at(i)->setType(output->type());
+    output->replaceAllUsesWith(batched->outputs().at(i));
+  }
+  // NB: don't bother with cleaning up after yourself. We'll use DCE for that.
+}
+
+void BatchIndependentOps(std::shared_ptr<Graph>& graph) {
+  std::vector<std::vector<Node*>> groups;
+  {
+    AliasDb alias_db(graph);
+    gatherBatchableGroups(graph->block(), alias_db, groups);
+  }
+  for (auto& group : groups) {
+    batchIndependentNodes(std::move(group));
+  }
+}
+
 bool hasMutableOperators(Block* block) {
   for (auto n : block->nodes()) {
     if (n->kind().is_aten() && n->schema().is_mutable())
@@ -472,6 +945,7 @@ void BatchMM(std::shared_ptr<Graph>& graph) {
   AliasDb alias_db(graph);
   BatchMMTreeReduce(graph->block());
   BatchMMSide(graph->block(), alias_db);
+  BatchIndependentOps(graph);
   EliminateDeadCode(graph);
   // It's possible that transpose rearrangements have created sequences of
   // consecutive transposes that didn't exist before.
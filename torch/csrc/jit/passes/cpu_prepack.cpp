@@ -0,0 +1,86 @@
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
+#include <torch/csrc/jit/passes/cpu_prepack.h>
+#include <torch/csrc/jit/passes/fuse_linear.h>
+#include <torch/csrc/jit/passes/graph_rewrite_helper.h>
+#include <torch/csrc/jit/passes/prepack_folding.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Only constant weights get packed once; packing a weight computed at run
+// time would repack it on every call, which is exactly what the eager op
+// already does.
+bool hasConstantWeight(
+    const Match& match,
+    const std::unordered_map<std::string, Value*>& vmap) {
+  const Value* weight = match.values_map.at(vmap.at("weight"));
+  return weight->node()->kind() == prim::Constant;
+}
+
+void insertCpuPrePackedLinearOp(std::shared_ptr<Graph>& graph) {
+  // fuse decomposed linear into aten::linear
+  FuseLinear(graph);
+
+  std::string linear_pattern = R"(
+    graph(%input, %weight, %bias):
+        %r = aten::linear(%input, %weight, %bias)
+        return (%r))";
+  std::string prepacked_ops_pattern = R"(
+    graph(%input, %weight, %bias):
+        %packed_weight_bias = cpu_prepacked::linear_prepack(%weight, %bias)
+        %res = cpu_prepacked::linear_run(%input, %packed_weight_bias)
+        return (%res))";
+
+  SubgraphRewriter linear_rewriter;
+  linear_rewriter.RegisterRewritePattern(linear_pattern, prepacked_ops_pattern);
+  linear_rewriter.runOnGraph(graph, hasConstantWeight);
+}
+
+void insertCpuPrePackedConv2dOp(std::shared_ptr<Graph>& graph) {
+  // Replace _convolution with conv2d
+  graph_rewrite_helper::replaceConvolutionWithAtenConv(graph);
+
+  std::string conv_2d_pattern = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[], %dilation:int[], %groups:int):
+        %r = aten::conv2d(%input, %weight, %bias, %stride, %padding, %dilation, %groups)
+        return (%r) )";
+
+  std::string prepacked_ops_conv2d_pattern = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[], %dilation:int[], %groups:int):
+        %packed_weight_bias = cpu_prepacked::conv2d_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups)
+        %r = cpu_prepacked::conv2d_run(%input, %packed_weight_bias)
+        return (%r) )";
+
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(
+      conv_2d_pattern, prepacked_ops_conv2d_pattern);
+  rewriter.runOnGraph(graph, hasConstantWeight);
+}
+
+} // namespace
+
+void insertCpuPrePackedOps(std::shared_ptr<Graph>& graph) {
+  insertCpuPrePackedLinearOp(graph);
+  insertCpuPrePackedConv2dOp(graph);
+}
+
+void insertCpuPrePackedOps(script::Module& frozen_module) {
+  auto graph = frozen_module.get_method("forward").graph();
+  insertCpuPrePackedOps(graph);
+
+  PrePackingOpsFilterFn filter_fn = [](const Node* n) -> bool {
+    return (
+        (n->kind() ==
+         Symbol::fromQualString("cpu_prepacked::linear_prepack")) ||
+        n->kind() == Symbol::fromQualString("cpu_prepacked::conv2d_prepack"));
+  };
+  PrePackingOpsFolder(frozen_module, filter_fn, "cpu_prepack_folding");
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Replaces aten::linear and aten::conv2d calls on constant weights with
+// cpu_prepacked::{linear,conv2d}_prepack + _run, see
+// Note [CPU prepacked weights]. Meant for frozen graphs, where the weights
+// are constants.
+TORCH_API void insertCpuPrePackedOps(std::shared_ptr<Graph>& graph);
+
+// Runs insertCpuPrePackedOps on the forward method of a frozen module and
+// then folds the prepack calls into attributes of the module, so weights
+// are packed once when the pass runs rather than on every call.
+TORCH_API void insertCpuPrePackedOps(script::Module& frozen_module);
+
+} // namespace jit
+} // namespace torch
@@ -267,9 +267,8 @@ class AttributePropagator {
       }
     } else if (attr.isTuple()) {
       auto tuple = std::move(attr).toTuple();
-      std::vector<IValue>& elems = tuple->elements();
-      for (auto& elem : elems) {
-        elem = overrideGradient(elem);
+      for (size_t i = 0; i < tuple->size(); i++) {
+        tuple->unsafeSetElement(i, overrideGradient(tuple->elements()[i]));
       }
       attr = std::move(tuple);
 
@@ -0,0 +1,74 @@
+#include <torch/csrc/jit/passes/fuse_addmm_activation.h>
+
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+void fuseAddMMRelu(std::shared_ptr<Graph>& graph) {
+  std::string addmm_relu_fused = R"(
+    graph(%self, %mat1, %mat2, %beta, %alpha):
+        %use_gelu : bool = prim::Constant[value=0]()
+        %res = aten::_addmm_activation(
+            %self, %mat1, %mat2, %beta, %alpha, %use_gelu)
+        return (%res))";
+
+  for (const std::string relu : {"aten::relu", "aten::relu_"}) {
+    std::string addmm_relu = R"(
+      graph(%self, %mat1, %mat2, %beta, %alpha):
+          %addmm_res = aten::addmm(%self, %mat1, %mat2, %beta, %alpha)
+          %res = )" + relu + R"((%addmm_res)
+          return (%res))";
+
+    SubgraphRewriter rewriter;
+    rewriter.RegisterRewritePattern(addmm_relu, addmm_relu_fused);
+    rewriter.runOnGraph(graph);
+  }
+}
+
+void fuseLinearRelu(std::shared_ptr<Graph>& graph) {
+  std::string linear_relu_fused = R"(
+    graph(%input, %weight, %bias):
+        %one : int = prim::Constant[value=1]()
+        %use_gelu : bool = prim::Constant[value=0]()
+        %weight_t = aten::t(%weight)
+        %res = aten::_addmm_activation(
+            %bias, %input, %weight_t, %one, %one, %use_gelu)
+        return (%res))";
+
+  // linear is only an addmm for 2-D inputs with a bias.
+  auto is_2d_input_with_bias =
+      [](const Match& match,
+         const std::unordered_map<std::string, Value*>& vmap) {
+        const Value* input = match.values_map.at(vmap.at("input"));
+        const Value* bias = match.values_map.at(vmap.at("bias"));
+        const auto input_type = input->type()->cast<TensorType>();
+        return input_type && input_type->dim() && *input_type->dim() == 2 &&
+            bias->type()->cast<TensorType>();
+      };
+
+  for (const std::string relu : {"aten::relu", "aten::relu_"}) {
+    std::string linear_relu = R"(
+      graph(%input, %weight, %bias):
+          %linear_res = aten::linear(%input, %weight, %bias)
+          %res = )" + relu + R"((%linear_res)
+          return (%res))";
+
+    SubgraphRewriter rewriter;
+    rewriter.RegisterRewritePattern(linear_relu, linear_relu_fused);
+    rewriter.runOnGraph(graph, is_2d_input_with_bias);
+  }
+}
+
+} // namespace
+
+void FuseAddMMActivation(std::shared_ptr<Graph>& graph) {
+  fuseAddMMRelu(graph);
+  fuseLinearRelu(graph);
+}
+
+} // namespace jit
+} // namespace torch
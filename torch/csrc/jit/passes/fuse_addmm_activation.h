@@ -0,0 +1,16 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Replaces aten::relu of aten::addmm, or of aten::linear of a 2-D input with
+// a bias, with aten::_addmm_activation, which adds the bias and applies the
+// activation in the epilogue of the matmul on CUDA. The addmm or linear must
+// have no other uses. aten::gelu is left alone, as the epilogue computes its
+// tanh approximation.
+TORCH_API void FuseAddMMActivation(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,58 @@
+#include <torch/csrc/jit/passes/fuse_dropout_add_layer_norm.h>
+
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
+#include <torch/csrc/jit/passes/graph_rewrite_helper.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+void FuseDropoutAddLayerNorm(std::shared_ptr<Graph>& graph) {
+  std::string dropout_add_layer_norm_fused = R"(
+    graph(%x, %residual, %p, %train, %alpha, %shape, %weight, %bias, %eps,
+          %cudnn_enable):
+        %res = aten::dropout_add_layer_norm(
+            %x, %residual, %p, %train, %shape, %weight, %bias, %eps)
+        return (%res))";
+
+  // The residual is added on either side of the dropout.
+  std::string dropout_add_layer_norm = R"(
+    graph(%x, %residual, %p, %train, %alpha, %shape, %weight, %bias, %eps,
+          %cudnn_enable):
+        %dropout_res = aten::dropout(%x, %p, %train)
+        %add_res = aten::add(%dropout_res, %residual, %alpha)
+        %res = aten::layer_norm(
+            %add_res, %shape, %weight, %bias, %eps, %cudnn_enable)
+        return (%res))";
+  std::string add_dropout_layer_norm = R"(
+    graph(%x, %residual, %p, %train, %alpha, %shape, %weight, %bias, %eps,
+          %cudnn_enable):
+        %dropout_res = aten::dropout(%x, %p, %train)
+        %add_res = aten::add(%residual, %dropout_res, %alpha)
+        %res = aten::layer_norm(
+            %add_res, %shape, %weight, %bias, %eps, %cudnn_enable)
+        return (%res))";
+
+  auto alpha_is_one = [](const Match& match,
+                         const std::unordered_map<std::string, Value*>& vmap) {
+    const auto alpha =
+        graph_rewrite_helper::getIValue("alpha", match.values_map, vmap);
+    if (!alpha) {
+      return false;
+    }
+    if (alpha->isInt()) {
+      return alpha->toInt() == 1;
+    }
+    return alpha->isDouble() && alpha->toDouble() == 1.0;
+  };
+
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(
+      dropout_add_layer_norm, dropout_add_layer_norm_fused);
+  rewriter.RegisterRewritePattern(
+      add_dropout_layer_norm, dropout_add_layer_norm_fused);
+  rewriter.runOnGraph(graph, alpha_is_one);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Replaces aten::layer_norm(aten::dropout(x) + residual) with
+// aten::dropout_add_layer_norm, which runs as a single kernel on CUDA. The
+// dropout and the add must have no other uses, and the add an alpha of 1.
+TORCH_API void FuseDropoutAddLayerNorm(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
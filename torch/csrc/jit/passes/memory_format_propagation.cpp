@@ -0,0 +1,154 @@
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/graph_rewrite_helper.h>
+#include <torch/csrc/jit/passes/memory_format_propagation.h>
+#include <torch/csrc/jit/passes/remove_mutation.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool isTensor(const Value* v) {
+  return v->type()->isSubtypeOf(TensorType::get());
+}
+
+// Whether n, taking its activations from a region, returns a tensor in the
+// memory format of its input. These are the TensorIterator ops, and the ops
+// with channels last kernels on all of CPU, cuDNN and XNNPACK. Binary ops
+// only keep the format when no operand from outside the region could decide
+// it instead.
+bool keepsMemoryFormat(
+    const Node* n,
+    const std::unordered_set<Value*>& region) {
+  const auto in_region = [&](const size_t i) {
+    return region.count(n->input(i)) > 0;
+  };
+  switch (n->kind()) {
+    case aten::relu:
+    case aten::sigmoid:
+    case aten::tanh:
+    case aten::hardtanh:
+    case aten::clamp:
+    case aten::dropout:
+    case aten::batch_norm:
+    case aten::max_pool2d:
+    case aten::avg_pool2d:
+    case aten::adaptive_avg_pool2d:
+    case aten::upsample_nearest2d:
+    case aten::upsample_bilinear2d:
+      return in_region(0);
+    case aten::add:
+    case aten::sub:
+    case aten::mul:
+    case aten::div:
+      return in_region(0) && (in_region(1) || !isTensor(n->input(1)));
+    default:
+      return false;
+  }
+}
+
+void convertFrozenConvWeights(Node* conv) {
+  const c10::optional<IValue> weight = toIValue(conv->input(1));
+  if (!weight || !weight->isTensor() || weight->toTensor().dim() != 4) {
+    return;
+  }
+  Graph* graph = conv->owningGraph();
+  WithInsertPoint guard(conv);
+  conv->replaceInput(
+      1,
+      graph->insertConstant(
+          weight->toTensor().contiguous(at::MemoryFormat::ChannelsLast)));
+}
+
+void insertChannelsLastRegions(std::shared_ptr<Graph>& graph) {
+  AliasDb aliasDb(graph);
+  std::unordered_set<Value*> region;
+  std::unordered_set<Node*> region_nodes;
+  std::unordered_map<Value*, Value*> channels_last_inputs;
+
+  const auto contiguous = [&](Value* v, const at::MemoryFormat format) {
+    return graph->create(aten::contiguous, {v, graph->insertConstant(format)});
+  };
+
+  // A value nothing writes to is converted once, before its first
+  // convolution, for all of its convolutions.
+  const auto to_channels_last = [&](Value* input, Node* conv) {
+    const bool shared = !aliasDb.hasWriters(input);
+    if (shared) {
+      const auto it = channels_last_inputs.find(input);
+      if (it != channels_last_inputs.end()) {
+        return it->second;
+      }
+    }
+    WithInsertPoint guard(conv);
+    Value* channels_last_input =
+        graph->insertNode(contiguous(input, at::MemoryFormat::ChannelsLast))
+            ->output();
+    if (shared) {
+      channels_last_inputs.emplace(input, channels_last_input);
+    }
+    return channels_last_input;
+  };
+
+  // Regions start at the convolutions and grow through the ops that keep the
+  // memory format of the outputs of the convolutions.
+  for (Node* n : graph->nodes()) {
+    if (n->outputs().size() != 1 || aliasDb.hasWriters(n->output())) {
+      continue;
+    }
+    if (n->kind() == aten::conv2d) {
+      convertFrozenConvWeights(n);
+      if (!region.count(n->input(0))) {
+        n->replaceInput(0, to_channels_last(n->input(0), n));
+      }
+    } else if (!keepsMemoryFormat(n, region)) {
+      continue;
+    }
+    region.insert(n->output());
+    region_nodes.insert(n);
+  }
+
+  // Everything else, including the graph outputs, gets contiguous tensors
+  // back, except for the ops reading only the sizes. Values in a region have
+  // no writers, so one conversion right after the definition serves all the
+  // uses outside of the region.
+  for (Value* v : region) {
+    std::vector<Use> outside_uses;
+    for (const Use& use : v->uses()) {
+      const NodeKind kind = use.user->kind();
+      if (!region_nodes.count(use.user) && kind != aten::size &&
+          kind != aten::dim) {
+        outside_uses.push_back(use);
+      }
+    }
+    if (outside_uses.empty()) {
+      continue;
+    }
+    WithInsertPoint guard(v->node()->next());
+    Node* to_contiguous =
+        graph->insertNode(contiguous(v, at::MemoryFormat::Contiguous));
+    for (const Use& use : outside_uses) {
+      use.user->replaceInput(use.offset, to_contiguous->output());
+    }
+  }
+}
+
+} // namespace
+
+void convertFrozenOpsToChannelsLast(std::shared_ptr<Graph>& graph) {
+  graph_rewrite_helper::replaceConvolutionWithAtenConv(graph);
+  RemoveTensorMutation(graph);
+  insertChannelsLastRegions(graph);
+  EliminateDeadCode(graph);
+}
+
+void convertFrozenOpsToChannelsLast(script::Module& frozen_module) {
+  auto graph = frozen_module.get_method("forward").graph();
+  convertFrozenOpsToChannelsLast(graph);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Makes the 2-D convolutions of a frozen graph, and the ops around them that
+// keep the memory format of their input, compute on channels last tensors:
+//
+// - the constant weights of aten::conv2d are converted to channels last once,
+//   at the time of the pass,
+// - the convolutions, and the ops they feed that keep the memory format, form
+//   regions. aten::contiguous(memory_format=channels_last) is only inserted
+//   where a region starts and aten::contiguous() where its values are used
+//   outside of it, so the activations are not copied between the ops of a
+//   region, and the NHWC kernels of cuDNN, MKL-DNN and XNNPACK apply
+//   throughout.
+//
+// Only values nothing writes to join a region; the pass removes what mutation
+// it safely can beforehand. Memory formats only change strides, so the results
+// of the graph are the same.
+TORCH_API void convertFrozenOpsToChannelsLast(std::shared_ptr<Graph>& graph);
+
+// Runs convertFrozenOpsToChannelsLast on the forward method of a frozen
+// module.
+TORCH_API void convertFrozenOpsToChannelsLast(script::Module& frozen_module);
+
+} // namespace jit
+} // namespace torch
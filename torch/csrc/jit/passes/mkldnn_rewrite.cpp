@@ -0,0 +1,255 @@
+#include <ATen/Config.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/passes/cpu_prepack.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/graph_rewrite_helper.h>
+#include <torch/csrc/jit/passes/mkldnn_rewrite.h>
+#include <torch/csrc/jit/passes/prepack_folding.h>
+#include <torch/csrc/jit/passes/remove_mutation.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+c10::optional<at::Tensor> constantTensor(Value* v) {
+  const c10::optional<IValue> ivalue = toIValue(v);
+  if (!ivalue || !ivalue->isTensor()) {
+    return c10::nullopt;
+  }
+  return ivalue->toTensor();
+}
+
+// Same update as FoldConvBatchNorm, but on the constants of a frozen graph
+// instead of on the attributes of submodules.
+void foldFrozenConvBatchNorm(Block* block) {
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* bn = *it++;
+    for (Block* sub_block : bn->blocks()) {
+      foldFrozenConvBatchNorm(sub_block);
+    }
+    if (bn->kind() != aten::batch_norm) {
+      continue;
+    }
+    Node* conv = bn->input(0)->node();
+    if (conv->kind() != aten::conv2d || conv->output()->uses().size() != 1) {
+      continue;
+    }
+
+    // batch_norm(input, weight, bias, running_mean, running_var, training,
+    //            momentum, eps, cudnn_enabled)
+    const c10::optional<IValue> training = toIValue(bn->input(5));
+    const c10::optional<IValue> eps = toIValue(bn->input(7));
+    const c10::optional<at::Tensor> conv_w = constantTensor(conv->input(1));
+    const c10::optional<at::Tensor> bn_rm = constantTensor(bn->input(3));
+    const c10::optional<at::Tensor> bn_rv = constantTensor(bn->input(4));
+    if (!training || !training->isBool() || training->toBool() || !eps ||
+        !eps->isDouble() || !conv_w || !conv_w->is_floating_point() ||
+        !bn_rm || !bn_rv) {
+      continue;
+    }
+    const auto optional_param = [](Value* v, const at::Tensor& fallback)
+        -> c10::optional<at::Tensor> {
+      if (v->mustBeNone()) {
+        return fallback;
+      }
+      return constantTensor(v);
+    };
+    const at::TensorOptions options = conv_w->options();
+    const c10::optional<at::Tensor> conv_b =
+        optional_param(conv->input(2), at::zeros({conv_w->size(0)}, options));
+    const c10::optional<at::Tensor> bn_w =
+        optional_param(bn->input(1), at::ones_like(*bn_rm));
+    const c10::optional<at::Tensor> bn_b =
+        optional_param(bn->input(2), at::zeros_like(*bn_rm));
+    if (!conv_b || !bn_w || !bn_b) {
+      continue;
+    }
+
+    const at::Tensor bn_var_rsqrt = at::rsqrt(*bn_rv + eps->toDouble());
+    const at::Tensor new_w =
+        *conv_w * (*bn_w * bn_var_rsqrt).reshape({-1, 1, 1, 1});
+    const at::Tensor new_b = (*conv_b - *bn_rm) * bn_var_rsqrt * *bn_w + *bn_b;
+
+    Graph* graph = block->owningGraph();
+    WithInsertPoint guard(conv);
+    conv->replaceInput(1, graph->insertConstant(new_w.to(options)));
+    conv->replaceInput(2, graph->insertConstant(new_b.to(options)));
+    bn->output()->replaceAllUsesWith(conv->output());
+    bn->destroy();
+  }
+}
+
+void fuseReluWithCpuPrePackedConv(std::shared_ptr<Graph>& graph) {
+  std::string conv2d_prepack_run_relu_fused = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %dilation:int[], %groups:int):
+        %packed_weight_bias = cpu_prepacked::conv2d_prepack(
+            %weight, %bias, %stride, %padding, %dilation, %groups)
+        %r = cpu_prepacked::conv2d_relu_run(%input, %packed_weight_bias)
+        return (%r) )";
+
+  for (const std::string relu : {"aten::relu", "aten::relu_"}) {
+    std::string conv2d_prepack_run_relu = R"(
+      graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+            %dilation:int[], %groups:int):
+          %packed_weight_bias = cpu_prepacked::conv2d_prepack(
+              %weight, %bias, %stride, %padding, %dilation, %groups)
+          %conv2d_res = cpu_prepacked::conv2d_run(%input, %packed_weight_bias)
+          %r = )" + relu + R"((%conv2d_res)
+          return (%r) )";
+
+    SubgraphRewriter rewriter;
+    rewriter.RegisterRewritePattern(
+        conv2d_prepack_run_relu, conv2d_prepack_run_relu_fused);
+    rewriter.runOnGraph(graph);
+  }
+}
+
+#if AT_MKLDNN_ENABLED()
+
+bool isCpuPrePackedConv(const Node* n) {
+  return n->kind() == Symbol::fromQualString("cpu_prepacked::conv2d_run") ||
+      n->kind() == Symbol::fromQualString("cpu_prepacked::conv2d_relu_run");
+}
+
+bool isConstantIntList(Value* v, const int64_t expected) {
+  const c10::optional<IValue> ivalue = toIValue(v);
+  if (!ivalue || !ivalue->isIntList()) {
+    return false;
+  }
+  for (const int64_t value : ivalue->toIntList()) {
+    if (value != expected) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether n, taking its activations from a region, computes on the opaque
+// MKL-DNN tensors with the MKL-DNN kernel of the op. mkldnn_add needs both
+// operands to have the same shape, which the residual adds of CNNs have.
+bool runsOnMKLDNN(const Node* n, const std::unordered_set<Value*>& region) {
+  const auto in_region = [&](const size_t i) {
+    return region.count(n->input(i)) > 0;
+  };
+  switch (n->kind()) {
+    case aten::relu:
+    case aten::sigmoid:
+      return in_region(0);
+    case aten::max_pool2d:
+      // max_pool2d(self, kernel_size, stride, padding, dilation, ceil_mode)
+      return in_region(0) && isConstantIntList(n->input(4), 1);
+    case aten::avg_pool2d:
+      // avg_pool2d(self, kernel_size, stride, padding, ceil_mode,
+      //            count_include_pad, divisor_override)
+      return in_region(0) && n->input(6)->mustBeNone();
+    case aten::adaptive_avg_pool2d:
+      return in_region(0) && isConstantIntList(n->input(1), 1);
+    case aten::add:
+      return n->inputs().size() == 3 && in_region(0) && in_region(1);
+    default:
+      return false;
+  }
+}
+
+void insertMKLDNNRegions(std::shared_ptr<Graph>& graph) {
+  AliasDb aliasDb(graph);
+  std::unordered_set<Value*> region;
+  std::unordered_set<Node*> region_nodes;
+  std::unordered_map<Value*, Value*> mkldnn_inputs;
+
+  // A value nothing writes to is reordered once, before its first
+  // convolution, for all of its convolutions.
+  const auto to_mkldnn = [&](Value* input, Node* conv) {
+    const bool shared = !aliasDb.hasWriters(input);
+    if (shared) {
+      const auto it = mkldnn_inputs.find(input);
+      if (it != mkldnn_inputs.end()) {
+        return it->second;
+      }
+    }
+    WithInsertPoint guard(conv);
+    Value* mkldnn_input = graph->insertNode(graph->create(
+        Symbol::fromQualString("aten::to_mkldnn"), {input}))->output();
+    if (shared) {
+      mkldnn_inputs.emplace(input, mkldnn_input);
+    }
+    return mkldnn_input;
+  };
+
+  // Regions start at the prepacked convolutions, which take either layout,
+  // and grow through the ops that run on the outputs of the convolutions.
+  for (Node* n : graph->nodes()) {
+    if (n->outputs().size() != 1 || aliasDb.hasWriters(n->output())) {
+      continue;
+    }
+    if (isCpuPrePackedConv(n)) {
+      if (!region.count(n->input(0))) {
+        n->replaceInput(0, to_mkldnn(n->input(0), n));
+      }
+    } else if (!runsOnMKLDNN(n, region)) {
+      continue;
+    }
+    region.insert(n->output());
+    region_nodes.insert(n);
+  }
+
+  // Everything else, including the graph outputs, gets dense tensors back,
+  // except for the ops reading only the sizes, which opaque tensors keep.
+  // Values in a region have no writers, so one reorder right after the
+  // definition serves all the uses outside of the region.
+  for (Value* v : region) {
+    std::vector<Use> outside_uses;
+    for (const Use& use : v->uses()) {
+      const NodeKind kind = use.user->kind();
+      if (!region_nodes.count(use.user) && kind != aten::size &&
+          kind != aten::dim) {
+        outside_uses.push_back(use);
+      }
+    }
+    if (outside_uses.empty()) {
+      continue;
+    }
+    Node* to_dense = graph->create(aten::to_dense, {v});
+    to_dense->insertAfter(v->node());
+    for (const Use& use : outside_uses) {
+      use.user->replaceInput(use.offset, to_dense->output());
+    }
+  }
+}
+
+#endif // AT_MKLDNN_ENABLED
+
+} // namespace
+
+void convertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph) {
+  graph_rewrite_helper::replaceConvolutionWithAtenConv(graph);
+  foldFrozenConvBatchNorm(graph->block());
+  RemoveTensorMutation(graph);
+  insertCpuPrePackedOps(graph);
+  fuseReluWithCpuPrePackedConv(graph);
+#if AT_MKLDNN_ENABLED()
+  insertMKLDNNRegions(graph);
+#endif // AT_MKLDNN_ENABLED
+  EliminateDeadCode(graph);
+}
+
+void convertFrozenOpsToMKLDNN(script::Module& frozen_module) {
+  auto graph = frozen_module.get_method("forward").graph();
+  convertFrozenOpsToMKLDNN(graph);
+
+  PrePackingOpsFilterFn filter_fn = [](const Node* n) -> bool {
+    return (
+        (n->kind() ==
+         Symbol::fromQualString("cpu_prepacked::linear_prepack")) ||
+        n->kind() == Symbol::fromQualString("cpu_prepacked::conv2d_prepack"));
+  };
+  PrePackingOpsFolder(frozen_module, filter_fn, "cpu_prepack_folding");
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Rewrites a frozen fp32 CPU inference graph to run on MKL-DNN:
+//
+// - aten::batch_norm of a constant aten::conv2d is folded into the weight
+//   and bias of the convolution,
+// - the convolutions become cpu_prepacked ops (see insertCpuPrePackedOps),
+//   with a following aten::relu fused in as an MKL-DNN post-op,
+// - the convolutions, and the ops between them MKL-DNN implements, form
+//   regions computing on opaque MKL-DNN tensors. aten::to_mkldnn and
+//   aten::to_dense are only inserted where a region starts and ends, so the
+//   activations are not reordered between consecutive MKL-DNN ops.
+//
+// Without MKL-DNN the regions are left out and the rest still applies. Only
+// values nothing writes to join a region; the pass removes what mutation it
+// safely can beforehand.
+TORCH_API void convertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph);
+
+// Runs convertFrozenOpsToMKLDNN on the forward method of a frozen module and
+// folds the prepack calls into attributes of the module, like the module
+// overload of insertCpuPrePackedOps.
+TORCH_API void convertFrozenOpsToMKLDNN(script::Module& frozen_module);
+
+} // namespace jit
+} // namespace torch
@@ -174,7 +174,8 @@ void unpackQuantizedWeightsHelper(
       // stored as bound C++ classes.
       auto ser_tup = itr->second.toTuple();
       unpacked_weight = ser_tup->elements()[0].toTensor();
-      bias = ser_tup->elements()[1].toOptional<at::Tensor>();
+      IValue bias_ivalue = ser_tup->elements()[1];
+      bias = bias_ivalue.toOptional<at::Tensor>();
       // conv only parameters
       if (ser_tup->elements().size() > 2) {
         auto stride_ivalue = ser_tup->elements()[stride_idx].toListRef();
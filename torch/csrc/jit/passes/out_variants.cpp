@@ -0,0 +1,181 @@
+#include <torch/csrc/jit/passes/out_variants.h>
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Functional ops rewritten to their `.out` overload, which takes the same
+// arguments followed by `out`
+const std::vector<const char*>& functionalSchemas() {
+  static const std::vector<const char*> schemas = {
+      "aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+      "aten::sub.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+      "aten::mul.Tensor(Tensor self, Tensor other) -> Tensor",
+      "aten::div.Tensor(Tensor self, Tensor other) -> Tensor",
+      "aten::mm(Tensor self, Tensor mat2) -> Tensor",
+      "aten::bmm(Tensor self, Tensor mat2) -> Tensor",
+      "aten::matmul(Tensor self, Tensor other) -> Tensor",
+      "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+      "aten::cat(Tensor[] tensors, int dim=0) -> Tensor",
+      "aten::sigmoid(Tensor self) -> Tensor",
+      "aten::tanh(Tensor self) -> Tensor",
+  };
+  return schemas;
+}
+
+bool hasOutVariant(Node* n) {
+  for (const char* schema : functionalSchemas()) {
+    if (n->matches(schema)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The type of `v` as seen by the profiling executor: either its own type or
+// the one of the guard checking it
+TensorTypePtr profiledType(Value* v) {
+  auto complete = [](const TypePtr& type) -> TensorTypePtr {
+    auto tt = type->cast<TensorType>();
+    if (tt && tt->scalarType() && tt->device() && tt->requiresGrad() &&
+        !*tt->requiresGrad()) {
+      return tt;
+    }
+    return nullptr;
+  };
+  if (auto tt = complete(v->type())) {
+    return tt;
+  }
+  for (const Use& use : v->uses()) {
+    if ((use.user->kind() == prim::Guard && use.offset == 0) ||
+        (use.user->kind() == prim::BailOut && use.offset == 1)) {
+      if (auto tt = complete(use.user->output()->type())) {
+        return tt;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void collectValues(Block* b, const Block* skip, std::vector<Value*>& values) {
+  if (b == skip) {
+    return;
+  }
+  for (Value* v : b->inputs()) {
+    values.push_back(v);
+  }
+  for (Node* n : b->nodes()) {
+    for (Value* v : n->outputs()) {
+      values.push_back(v);
+    }
+    for (Block* sub : n->blocks()) {
+      collectValues(sub, skip, values);
+    }
+  }
+}
+
+void collectLoops(Block* b, std::vector<Node*>& loops) {
+  for (Node* n : b->nodes()) {
+    if (n->kind() == prim::Loop) {
+      loops.push_back(n);
+    }
+    for (Block* sub : n->blocks()) {
+      collectLoops(sub, loops);
+    }
+  }
+}
+
+struct Candidate {
+  Node* loop;
+  Node* node;
+  TensorTypePtr type;
+};
+
+void rewrite(Graph& graph, const Candidate& c) {
+  Value* buffer = nullptr;
+  {
+    WithInsertPoint guard(c.loop);
+    // With the profiled strides, so that ops on e.g. channels last inputs
+    // keep the layout they have in eager mode and the guards expect
+    buffer = graph.insert(
+        aten::empty_strided,
+        {*c.type->sizes().concrete_sizes(), *c.type->strides().concrete_sizes()},
+        {NamedValue("dtype", *c.type->scalarType()),
+         NamedValue("device", *c.type->device())});
+  }
+
+  Node* out_node = graph.create(c.node->kind(), c.node->inputs(), 1);
+  out_node->addInput(buffer);
+  out_node->output()->copyMetadata(c.node->output());
+  out_node->insertBefore(c.node);
+  auto schema = out_node->maybeSchema();
+  if (!schema || schema->overload_name() != "out") {
+    out_node->destroy();
+    buffer->node()->destroy();
+    return;
+  }
+  GRAPH_UPDATE(
+      "Replacing ", getHeader(c.node), " with ", getHeader(out_node));
+  c.node->output()->replaceAllUsesWith(out_node->output());
+  c.node->destroy();
+}
+
+} // namespace
+
+static bool out_variants_enabled_ = true;
+void setOutVariantsEnabled(bool val) {
+  out_variants_enabled_ = val;
+}
+
+bool outVariantsEnabled() {
+  return out_variants_enabled_;
+}
+
+void InsertOutVariants(std::shared_ptr<Graph>& graph) {
+  std::vector<Node*> loops;
+  collectLoops(graph->block(), loops);
+  if (loops.empty()) {
+    return;
+  }
+
+  std::vector<Candidate> candidates;
+  {
+    AliasDb alias_db(graph);
+    for (Node* loop : loops) {
+      Block* body = loop->blocks().at(0);
+      std::vector<Value*> outside;
+      collectValues(graph->block(), body, outside);
+      for (Node* n : body->nodes()) {
+        if (n->outputs().size() != 1 || !hasOutVariant(n)) {
+          continue;
+        }
+        Value* output = n->output();
+        auto type = profiledType(output);
+        if (!type || !type->sizes().concrete_sizes() ||
+            !type->strides().concrete_sizes()) {
+          continue;
+        }
+        // The buffer is overwritten on the next iteration, so the output
+        // must be dead by the end of this one
+        if (alias_db.escapesScope({output}) ||
+            alias_db.mayContainAlias({output}, body->outputs()) ||
+            alias_db.mayContainAlias({output}, outside)) {
+          continue;
+        }
+        candidates.push_back({loop, n, type});
+      }
+    }
+  }
+
+  for (const auto& candidate : candidates) {
+    rewrite(*graph, candidate);
+  }
+  GRAPH_DUMP("After InsertOutVariants: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
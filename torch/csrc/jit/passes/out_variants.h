@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Rewrites the ops of loop bodies that have an `.out` overload (add, mul,
+// addmm, cat, ...) to write into a buffer allocated once before the loop,
+// instead of allocating their output on every iteration.
+//
+// Only applies to outputs that don't outlive the iteration (they may not be
+// loop carried, nor alias a value defined outside of the loop body), that
+// don't require grad, and whose dtype and device are known from profiling.
+// The buffer is allocated with the profiled sizes when they are known: the
+// out variants resize it if the shapes change from one iteration to the
+// next, so this is only a performance assumption.
+TORCH_API void InsertOutVariants(std::shared_ptr<Graph>& graph);
+
+// Whether the profiling executor runs InsertOutVariants, on by default
+TORCH_API void setOutVariantsEnabled(bool val);
+TORCH_API bool outVariantsEnabled();
+
+} // namespace jit
+} // namespace torch
@@ -25,6 +25,7 @@ std::vector<std::string> _static_quantizable_call_funcs = {
     "layer_norm",
     "group_norm",
     "instance_norm",
+    "softmax",
 };
 
 std::vector<std::string> _static_quantizable_aten_funcs = {
@@ -42,6 +43,8 @@ std::vector<std::string> _static_quantizable_aten_funcs = {
     "layer_norm",
     "group_norm",
     "instance_norm",
+    "bmm",
+    "softmax",
 };
 
 std::vector<std::string> _dynamic_quantizable_call_funcs = {
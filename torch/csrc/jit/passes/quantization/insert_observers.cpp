@@ -387,7 +387,10 @@ class InsertObserversHelper {
     return true;
   }
 
-  void delayObservingValuesInPattern(Graph& graph, const PatternInfo& pattern);
+  void delayObservingValuesInPattern(
+      Graph& graph,
+      const PatternInfo& pattern,
+      const NodesByKind& nodes_by_kind);
 
   // Find and mark known patterns such as conv-relu (and others) where
   // we should not insert observers in the middle of the pattern.
@@ -968,11 +971,13 @@ void InsertObserversHelper::insertObserverFor(
 
 void InsertObserversHelper::delayObservingValuesInPattern(
     Graph& graph,
-    const PatternInfo& pattern) {
+    const PatternInfo& pattern,
+    const NodesByKind& nodes_by_kind) {
   const Graph& pattern_graph = *pattern.pattern_graph;
   const std::unordered_map<std::string, Value*>& vmap = pattern.vmap;
 
-  const auto& matches = findPatternMatches(pattern_graph, graph);
+  const auto& matches =
+      findPatternMatches(pattern_graph, graph, nodes_by_kind);
   for (const auto& match : matches) {
     if (!std::all_of(
             pattern.filters.begin(),
@@ -997,8 +1002,10 @@ void InsertObserversHelper::addValuesToDelayObservation(
   Method method = module.get_method(method_name);
   auto graph = method.graph();
 
+  // the graph doesn't change while the patterns are matched
+  const NodesByKind nodes_by_kind = indexNodesByKind(*graph);
   for (const auto& pattern : delay_patterns) {
-    delayObservingValuesInPattern(*graph, pattern);
+    delayObservingValuesInPattern(*graph, pattern, nodes_by_kind);
   }
 }
 
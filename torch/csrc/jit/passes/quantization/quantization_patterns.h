@@ -230,6 +230,16 @@ bool input_b_is_scalar(
   return isScalar(b_scalar);
 }
 
+// filter that checks %softmax_dtype is None, quantized::softmax has no
+// dtype argument
+bool softmax_dtype_is_none(
+    const Match& match,
+    const std::unordered_map<std::string, Value*>& vmap) {
+  const auto& match_vmap = match.values_map;
+  auto softmax_dtype = match_vmap.at(vmap.at("softmax_dtype"));
+  return softmax_dtype->mustBeNone();
+}
+
 // Patterns for ops that require observation for output quantization parameters
 // Example:
 //
@@ -527,6 +537,62 @@ graph(%a_quant, %b_quant, %alpha, %scale, %zero_point, %dtype):
          %r = aten::quantize_per_tensor(%r_add, %scale, %zero_point, %dtype)
          return (%r) )";
 
+  // quantized::conv2d - quantized::add, the residual add of ResNet blocks.
+  // These match the ops the patterns above produce, so they come after them
+  // in the list, and take either operand of the add.
+  std::string conv2d_add = R"(
+graph(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point):
+         %conv_out = quantized::conv2d(%a_quant, %packed_params, %conv_scale, %conv_zero_point)
+         %r = quantized::add(%conv_out, %b_quant, %scale, %zero_point)
+         return (%r) )";
+
+  std::string conv2d_add_swapped = R"(
+graph(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point):
+         %conv_out = quantized::conv2d(%a_quant, %packed_params, %conv_scale, %conv_zero_point)
+         %r = quantized::add(%b_quant, %conv_out, %scale, %zero_point)
+         return (%r) )";
+
+  std::string quantized_conv2d_add = R"(
+graph(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point):
+         %r = quantized::conv2d_add(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point)
+         return (%r) )";
+
+  // quantized::conv2d - quantized::add_relu
+  std::string conv2d_add_relu = R"(
+graph(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point):
+         %conv_out = quantized::conv2d(%a_quant, %packed_params, %conv_scale, %conv_zero_point)
+         %r = quantized::add_relu(%conv_out, %b_quant, %scale, %zero_point)
+         return (%r) )";
+
+  std::string conv2d_add_relu_swapped = R"(
+graph(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point):
+         %conv_out = quantized::conv2d(%a_quant, %packed_params, %conv_scale, %conv_zero_point)
+         %r = quantized::add_relu(%b_quant, %conv_out, %scale, %zero_point)
+         return (%r) )";
+
+  std::string quantized_conv2d_add_relu = R"(
+graph(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point):
+         %r = quantized::conv2d_add_relu(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point)
+         return (%r) )";
+
+  // quantized::linear - quantized::add
+  std::string linear_add = R"(
+graph(%a_quant, %b_quant, %packed_params, %linear_scale, %linear_zero_point, %scale, %zero_point):
+         %linear_out = quantized::linear(%a_quant, %packed_params, %linear_scale, %linear_zero_point)
+         %r = quantized::add(%linear_out, %b_quant, %scale, %zero_point)
+         return (%r) )";
+
+  std::string linear_add_swapped = R"(
+graph(%a_quant, %b_quant, %packed_params, %linear_scale, %linear_zero_point, %scale, %zero_point):
+         %linear_out = quantized::linear(%a_quant, %packed_params, %linear_scale, %linear_zero_point)
+         %r = quantized::add(%b_quant, %linear_out, %scale, %zero_point)
+         return (%r) )";
+
+  std::string quantized_linear_add = R"(
+graph(%a_quant, %b_quant, %packed_params, %linear_scale, %linear_zero_point, %scale, %zero_point):
+         %r = quantized::linear_add(%a_quant, %b_quant, %packed_params, %linear_scale, %linear_zero_point, %scale, %zero_point)
+         return (%r) )";
+
   auto add_scalar = getBinaryOpScalarFusionInfo(
       "aten::add",
       {"%b_scalar", "%alpha"},
@@ -611,6 +677,21 @@ graph(%a_quant, %weight, %bias, %mean, %var, %training, %eaf, %eps, %7, %scale,
          %r = quantized::batch_norm_relu(%a_quant, %weight, %bias, %mean, %var, %eps, %scale, %zero_point)
          return (%r) )";
 
+  // aten::bmm
+  std::string bmm = R"(
+graph(%a_quant, %b_quant, %scale, %zero_point, %dtype):
+         %a_dequant = aten::dequantize(%a_quant)
+         %b_dequant = aten::dequantize(%b_quant)
+         %r_bmm = aten::bmm(%a_dequant, %b_dequant)
+         %r = aten::quantize_per_tensor(%r_bmm, %scale, %zero_point, %dtype)
+         return (%r) )";
+
+  // quantized::bmm
+  std::string quantized_bmm = R"(
+graph(%a_quant, %b_quant, %scale, %zero_point, %dtype):
+         %r = quantized::bmm(%a_quant, %b_quant, %scale, %zero_point)
+         return (%r) )";
+
   // aten::mul
   std::string mul = R"(
 graph(%a_quant, %b_quant, %scale, %zero_point, %dtype):
@@ -851,6 +932,13 @@ graph(%a_quant, %alpha, %scale, %input_scale, %r_scale, %r_zero_point, %r_dtype)
   auto hardswish_ = getObservedQParamOpFusionInfo(
       "aten::hardswish_", "quantized::hardswish", {}, {});
 
+  auto softmax = getObservedQParamOpFusionInfo(
+      "aten::softmax",
+      "quantized::softmax",
+      {"%dim", "%softmax_dtype"},
+      {"%dim"});
+  softmax.filters = {softmax_dtype_is_none};
+
   auto layer_norm = getObservedQParamOpFusionInfo(
       "aten::layer_norm",
       "quantized::layer_norm",
@@ -923,6 +1011,16 @@ graph(%a_quant, %alpha, %scale, %input_scale, %r_scale, %r_zero_point, %r_dtype)
        quantized_add_scalar_relu_out_replacement},
       {"quantized::add", add, quantized_add, {aten_add_alpha_is_one}},
       {"quantized::add", inplace_add, quantized_add, {aten_add_alpha_is_one}},
+      {"quantized::conv2d_add", conv2d_add, quantized_conv2d_add},
+      {"quantized::conv2d_add", conv2d_add_swapped, quantized_conv2d_add},
+      {"quantized::conv2d_add_relu",
+       conv2d_add_relu,
+       quantized_conv2d_add_relu},
+      {"quantized::conv2d_add_relu",
+       conv2d_add_relu_swapped,
+       quantized_conv2d_add_relu},
+      {"quantized::linear_add", linear_add, quantized_linear_add},
+      {"quantized::linear_add", linear_add_swapped, quantized_linear_add},
       {"quantized::cat", cat, quantized_cat},
       {"quantized::batch_norm", batch_norm, quantized_batch_norm},
       {"quantized::batch_norm_relu",
@@ -953,11 +1051,13 @@ graph(%a_quant, %alpha, %scale, %input_scale, %r_scale, %r_zero_point, %r_dtype)
       {"quantized::mul_relu", inplace_mul_inplace_relu, quantized_mul_relu},
       {"quantized::mul", mul, quantized_mul},
       {"quantized::mul", inplace_mul, quantized_mul},
+      {"quantized::bmm", bmm, quantized_bmm},
       hardswish,
       hardswish_,
       layer_norm,
       group_norm,
       instance_norm,
+      softmax,
       {"quantized::elu", elu, quantized_elu},
       {"quantized::elu_", elu_, quantized_elu},
       avg_pool1d,
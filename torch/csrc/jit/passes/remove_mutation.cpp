@@ -181,12 +181,8 @@ struct MutationRemover {
       Node* list_construct = mutated_value->node();
       list_construct->addInput(node->inputs().at(1));
       node->output()->replaceAllUsesWith(mutated_value);
-      aliasDb_->writeIndex_->erase(node);
+      aliasDb_->removeWrites(node);
       node->destroy();
-
-      // TODO: don't strictly need to reset write cache, evaluate on models
-      aliasDb_->writtenToLocationsIndex_ =
-          aliasDb_->buildWrittenToLocationsIndex();
     }
   }
 
@@ -247,14 +243,10 @@ struct MutationRemover {
       // that the mutated value is a fresh alias with a single use.
       aliasDb_->createValue(mutated_value);
 
-      // We must erase the destroyed node from the AliasDb lists of writes
-      aliasDb_->writeIndex_->erase(node);
+      // We must erase the destroyed node from the AliasDb lists of writes,
+      // which also updates the write cache
+      aliasDb_->removeWrites(node);
       node->destroy();
-
-      // now that we have removed a mutating op, the write cache is stale
-      // TODO: don't strictly need to reset write cache, evaluate on models
-      aliasDb_->writtenToLocationsIndex_ =
-          aliasDb_->buildWrittenToLocationsIndex();
     }
   }
 
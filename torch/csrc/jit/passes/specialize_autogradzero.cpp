@@ -4,12 +4,51 @@
 namespace torch {
 namespace jit {
 
+// The pointwise ops the symbolic derivatives are made of, which always return
+// defined tensors when their tensor inputs are defined.
+static bool keepsNonzero(Node* n) {
+  switch (n->kind()) {
+    case aten::add:
+    case aten::sub:
+    case aten::mul:
+    case aten::div:
+    case aten::neg:
+    case aten::reciprocal:
+    case aten::pow:
+    case aten::exp:
+    case aten::log:
+    case aten::sqrt:
+    case aten::rsqrt:
+    case aten::sigmoid:
+    case aten::tanh:
+    case aten::relu:
+    case aten::threshold:
+    case aten::clamp:
+    case aten::where:
+    case aten::type_as:
+    case aten::eq:
+    case aten::ne:
+    case aten::ge:
+    case aten::gt:
+    case aten::le:
+    case aten::lt:
+    case aten::_grad_sum_to_size:
+    case aten::_sigmoid_backward:
+    case aten::_tanh_backward:
+      return true;
+    default:
+      return false;
+  }
+}
+
 // propagate autograd zero information through a gradient graph and
 // remove grad_of blocks if present.
 // Note: this is a very limited pass. It only propagates autograd zeros for
 // operations generated by the symbolic autodiff code and cleans up
 // AutogradAdds when possible. Outputs of other nodes are conservatively
-// marked Unknown and not optimized.
+// marked Unknown and not optimized, except for the pointwise ops of
+// Nonzero inputs, so that chains of derivatives can lose their GradOf blocks
+// and AutogradAdds, which the fusers cannot fuse across.
 void specializeAutogradZero(Graph& g) {
   enum class State { Nonzero, Zero, Unknown };
   std::unordered_map<Value*, State> state;
@@ -148,11 +187,22 @@ void specializeAutogradZero(Graph& g) {
         }
         break;
       }
-      default:
+      default: {
+        const bool nonzero = keepsNonzero(n) &&
+            std::all_of(n->inputs().begin(),
+                        n->inputs().end(),
+                        [&](Value* v) {
+                          if (!v->type()->isSubtypeOf(TensorType::get())) {
+                            return true;
+                          }
+                          const auto it = state.find(v);
+                          return it != state.end() &&
+                              it->second == State::Nonzero;
+                        });
         for (auto o : n->outputs()) {
-          state[o] = State::Unknown;
+          state[o] = nonzero ? State::Nonzero : State::Unknown;
         }
-        break;
+      } break;
     }
   }
 }
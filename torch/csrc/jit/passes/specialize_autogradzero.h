@@ -10,7 +10,8 @@ namespace jit {
 // Note: this is a very limited pass. It only propagates autograd zeros for
 // operations generated by the symbolic autodiff code and cleans up
 // AutogradAdds when possible. Outputs of other nodes are conservatively
-// marked Unknown and not optimized.
+// marked Unknown and not optimized, except for the pointwise ops of
+// Nonzero inputs.
 TORCH_API void specializeAutogradZero(Graph& g);
 
 } // namespace jit
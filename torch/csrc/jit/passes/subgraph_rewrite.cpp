@@ -23,7 +23,11 @@ void SubgraphRewriter::RegisterRewritePattern(
     const std::string& pattern,
     const std::string& replacement) {
   RewritePatternDescr d = {pattern, replacement};
-  patterns_.push_back(d);
+  d.pattern_graph = std::make_shared<Graph>();
+  parseIR(pattern, d.pattern_graph.get(), d.vmap);
+  d.replacement_graph = std::make_shared<Graph>();
+  parseIR(replacement, d.replacement_graph.get());
+  patterns_.push_back(std::move(d));
 }
 
 Module SubgraphRewriter::runOnModule(const Module& module) {
@@ -38,26 +42,31 @@ Module SubgraphRewriter::runOnModule(const Module& module) {
 void SubgraphRewriter::runOnGraph(
     std::shared_ptr<Graph>& graph,
     const std::vector<MatchFilter>& filters) {
+  // Most patterns match nothing, so rather than scanning the whole graph for
+  // each of them, only the nodes of the kind a pattern ends in are visited.
+  // Rewriting invalidates the index.
+  NodesByKind nodes_by_kind = indexNodesByKind(*graph);
   for (const RewritePatternDescr& pattern : patterns_) {
-    rewriteSinglePatternOnGraph(graph, pattern, filters);
+    if (rewriteSinglePatternOnGraph(graph, pattern, filters, nodes_by_kind)) {
+      nodes_by_kind = indexNodesByKind(*graph);
+    }
   }
 }
 
-void SubgraphRewriter::rewriteSinglePatternOnGraph(
+bool SubgraphRewriter::rewriteSinglePatternOnGraph(
     std::shared_ptr<Graph>& graph,
     const RewritePatternDescr& pattern,
-    const std::vector<MatchFilter>& filters) {
+    const std::vector<MatchFilter>& filters,
+    const NodesByKind& nodes_by_kind) {
   std::unordered_map<Value*, Value*> rewrite_map;
   std::vector<Value*> values_to_rewrite;
 
-  Graph pattern_graph;
-  std::unordered_map<std::string, Value*> vmap;
-  parseIR(pattern.pattern, &pattern_graph, vmap);
-
-  Graph replacement_graph;
-  parseIR(pattern.replacement, &replacement_graph);
+  Graph& pattern_graph = *pattern.pattern_graph;
+  const std::unordered_map<std::string, Value*>& vmap = pattern.vmap;
+  Graph& replacement_graph = *pattern.replacement_graph;
 
-  const auto& matches = findPatternMatches(pattern_graph, *graph);
+  const auto& matches =
+      findPatternMatches(pattern_graph, *graph, nodes_by_kind);
   for (const Match& match : matches) {
     if (!std::all_of(filters.begin(), filters.end(), [&](const MatchFilter& f) {
           return f(match, vmap);
@@ -106,6 +115,7 @@ void SubgraphRewriter::rewriteSinglePatternOnGraph(
     }
   }
 
+  const bool rewritten = !values_to_rewrite.empty();
   // Perform planned rewritings
   for (auto v : values_to_rewrite) {
     v->replaceAllUsesWith(rewrite_map.at(v));
@@ -119,6 +129,7 @@ void SubgraphRewriter::rewriteSinglePatternOnGraph(
     n->destroy();
   }
   nodes_to_delete_.clear();
+  return rewritten;
 }
 
 bool SubgraphRewriter::overlapsWithPreviousMatches(const Match* match) {
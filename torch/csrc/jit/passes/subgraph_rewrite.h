@@ -89,10 +89,12 @@ class TORCH_API SubgraphRewriter {
   std::vector<RewritePatternDescr> patterns_;
   std::unordered_set<Node*> nodes_to_delete_;
 
-  void rewriteSinglePatternOnGraph(
+  // Returns whether the graph was rewritten.
+  bool rewriteSinglePatternOnGraph(
       std::shared_ptr<Graph>& graph,
       const RewritePatternDescr& pattern,
-      const std::vector<MatchFilter>& filters);
+      const std::vector<MatchFilter>& filters,
+      const std::unordered_map<Symbol, std::vector<Node*>>& nodes_by_kind);
 
   bool overlapsWithPreviousMatches(const Match* match);
 };
@@ -105,6 +107,10 @@ class TORCH_API SubgraphRewriter {
 struct RewritePatternDescr {
   std::string pattern;
   std::string replacement;
+  // The parsed pattern and replacement, shared by the graphs rewritten
+  std::shared_ptr<Graph> pattern_graph;
+  std::unordered_map<std::string, Value*> vmap;
+  std::shared_ptr<Graph> replacement_graph;
 };
 
 } // namespace jit
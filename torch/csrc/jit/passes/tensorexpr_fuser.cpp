@@ -14,6 +14,19 @@ namespace torch {
 namespace jit {
 
 namespace tensorexpr {
+static const OperatorSet& supportedReductionSet() {
+  static const OperatorSet reductions{
+      "aten::sum(Tensor self, *, ScalarType? dtype=None) -> Tensor",
+      "aten::sum.dim_IntList(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
+      "aten::mean(Tensor self, *, ScalarType? dtype=None) -> Tensor",
+      "aten::mean.dim(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
+      "aten::softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+      "aten::log_softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+      "aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight=None, Tensor? bias=None, float eps=1e-05, bool cudnn_enable=True) -> Tensor",
+  };
+  return reductions;
+}
+
 bool isSupported(Node* node) {
   // TODO:
   switch (node->kind()) {
@@ -81,7 +94,14 @@ bool isSupported(Node* node) {
     case aten::__lshift__:
     case aten::__rshift__:
     case aten::where:
+    case aten::gelu:
       return true;
+    case aten::sum:
+    case aten::mean:
+    case aten::softmax:
+    case aten::log_softmax:
+    case aten::layer_norm:
+      return node->isMemberOf(supportedReductionSet());
     // Operators that can be both elementwise or reductions:
     case aten::min:
     case aten::max:
@@ -104,6 +124,24 @@ void setTensorExprFuserEnabled(bool val) {
   texpr_fuser_enabled_ = val;
 }
 
+static bool texpr_dynamic_shapes_enabled_ = false;
+void setTensorExprDynamicShapesEnabled(bool val) {
+  texpr_dynamic_shapes_enabled_ = val;
+}
+
+bool tensorExprDynamicShapesEnabled() {
+  return texpr_dynamic_shapes_enabled_;
+}
+
+static bool texpr_async_compilation_enabled_ = false;
+void setTensorExprAsyncCompilationEnabled(bool val) {
+  texpr_async_compilation_enabled_ = val;
+}
+
+bool tensorExprAsyncCompilationEnabled() {
+  return texpr_async_compilation_enabled_;
+}
+
 bool tensorExprFuserEnabled() {
   static const char* enable_c_str = std::getenv("PYTORCH_TENSOREXPR");
   if (!enable_c_str) {
@@ -139,15 +177,51 @@ value_list sortReverseTopological(
   return result;
 }
 
+// With dynamic shapes, the dims that varied across the profiled runs become
+// size args of the kernel: only the rank, dtype and device of the tensors
+// have to be known.
+bool hasSymbolicShape(Value* v) {
+  auto tt = v->type()->cast<TensorType>();
+  return tensorExprDynamicShapesEnabled() && tt && tt->dim() &&
+      tt->scalarType() && tt->device();
+}
+
 bool allShapesAreKnown(Value* v) {
   if (!v->type()->cast<TensorType>()) {
     return true;
   }
-  return v->isCompleteTensor();
+  return v->isCompleteTensor() || hasSymbolicShape(v);
+}
+
+// The lowerings of these ops compute offsets and output sizes from the sizes
+// of the inputs at compile time.
+bool needsStaticShapes(Node* node) {
+  switch (node->kind()) {
+    case aten::cat:
+    case aten::slice:
+    case prim::ConstantChunk:
+    case prim::ListConstruct:
+      break;
+    default:
+      return false;
+  }
+  for (torch::jit::Value* v : node->inputs()) {
+    if (v->type()->cast<TensorType>() && !v->isCompleteTensor()) {
+      return true;
+    }
+  }
+  for (torch::jit::Value* v : node->outputs()) {
+    if (v->type()->cast<TensorType>() && !v->isCompleteTensor()) {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool allShapesAreKnown(Node* node) {
-  // TODO: Relax the checks to support dynamic shapes
+  if (needsStaticShapes(node)) {
+    return false;
+  }
   for (torch::jit::Value* output : node->outputs()) {
     if (!allShapesAreKnown(output)) {
       return false;
@@ -161,6 +235,34 @@ bool allShapesAreKnown(Node* node) {
   return true;
 }
 
+// The reductions are lowered for float CPU tensors, with the dims and the
+// other scalar args known at compile time: the CUDA codegen emits a single
+// kernel, with no way to synchronize the threads between a reduction and
+// its uses.
+bool canHandleReduction(Node* node) {
+  auto tt = node->inputs()[0]->type()->cast<TensorType>();
+  if (!tt || tt->scalarType() != at::kFloat || !tt->device() ||
+      !tt->device()->is_cpu() || *tt->dim() == 0) {
+    return false;
+  }
+  for (torch::jit::Value* input : node->inputs().slice(1)) {
+    // weight and bias of layer_norm
+    if (input->type()->cast<TensorType>()) {
+      continue;
+    }
+    if (!toIValue(input)) {
+      return false;
+    }
+  }
+  // The result is accumulated in the type of the input, the dtype arg
+  // comes last in the other schemas
+  if (node->kind() != aten::layer_norm &&
+      !toIValue(node->inputs().back())->isNone()) {
+    return false;
+  }
+  return true;
+}
+
 bool canHandle(Node* node, AliasDb& aliasDb) {
   if (node->kind() == prim::Constant) {
     if (node->output()->type()->cast<TensorType>()) {
@@ -185,6 +287,10 @@ bool canHandle(Node* node, AliasDb& aliasDb) {
       return false;
     }
   }
+  if (node->isMemberOf(tensorexpr::supportedReductionSet()) &&
+      !canHandleReduction(node)) {
+    return false;
+  }
   return tensorexpr::isSupported(node);
 }
 
@@ -195,9 +301,9 @@ bool canHandle(Node* node, AliasDb& aliasDb) {
   }
 
 bool canMerge(Node* consumer, Node* producer, AliasDb& aliasDb) {
-  // Only handle complete tensor types
+  // Only handle complete tensor types, or symbolic ones with dynamic shapes
   for (torch::jit::Value* output : consumer->outputs()) {
-    REQ(output->isCompleteTensor());
+    REQ(output->isCompleteTensor() || hasSymbolicShape(output));
   }
 
   // Only fuse within a block
@@ -370,8 +476,8 @@ void FuseTensorExprs(std::shared_ptr<Graph>& graph) {
 }
 
 Operation createTensorExprOp(const Node* node) {
-  auto kernel =
-      std::make_shared<tensorexpr::TensorExprKernel>(node->g(attr::Subgraph));
+  auto kernel = std::make_shared<tensorexpr::TensorExprKernel>(
+      node->g(attr::Subgraph), tensorExprAsyncCompilationEnabled());
   return [kernel](Stack* stack) {
     RECORD_FUNCTION("TensorExpr", std::vector<c10::IValue>());
     if (!tensorexpr::fallbackAllowed()) {
@@ -14,6 +14,14 @@ TORCH_API void FuseTensorExprs(std::shared_ptr<Graph>& graph);
 
 TORCH_API void setTensorExprFuserEnabled(bool val);
 TORCH_API bool tensorExprFuserEnabled();
+// Fuse tensors whose dims varied across the profiled runs, one kernel then
+// covers all their sizes
+TORCH_API void setTensorExprDynamicShapesEnabled(bool val);
+TORCH_API bool tensorExprDynamicShapesEnabled();
+// Compile the kernels of the fusion groups on the inter-op thread pool, the
+// groups run unfused until their kernel is ready
+TORCH_API void setTensorExprAsyncCompilationEnabled(bool val);
+TORCH_API bool tensorExprAsyncCompilationEnabled();
 
 namespace tensorexpr {
 TORCH_API bool isSupported(Node* node);
@@ -235,6 +235,231 @@ void fuseReluWithPackedOps(std::shared_ptr<Graph>& graph) {
   rewriter.runOnGraph(graph, torch::jit::graph_rewrite_helper::isClampFusable);
 }
 
+// The ops which compute the same values whatever the memory format of their
+// tensor inputs, and whose outputs take the memory format of their first
+// input.  XNNPACK implements all of them in NHWC, so a region of these ops
+// starting at a convolution runs without a single layout conversion once its
+// input is NHWC.
+bool isChannelsLastAgnostic(const Node* node, const size_t offset) {
+  static const std::unordered_set<Symbol> ops = {
+      Symbol::fromQualString("aten::relu"),
+      Symbol::fromQualString("aten::hardtanh"),
+      Symbol::fromQualString("aten::hardswish"),
+      Symbol::fromQualString("aten::sigmoid"),
+      Symbol::fromQualString("aten::clamp"),
+      Symbol::fromQualString("aten::add"),
+      Symbol::fromQualString("aten::add_relu"),
+      Symbol::fromQualString("aten::sub"),
+      Symbol::fromQualString("aten::mul"),
+      Symbol::fromQualString("aten::max_pool2d"),
+      Symbol::fromQualString("aten::avg_pool2d"),
+      Symbol::fromQualString("aten::adaptive_avg_pool2d"),
+      Symbol::fromQualString("aten::dropout"),
+  };
+
+  if (node->kind() == Symbol::fromQualString("prepacked::conv2d_clamp_run")) {
+    // The second input is the packed weights.
+    return 0u == offset;
+  }
+
+  return ops.count(node->kind()) > 0u;
+}
+
+// The in-place counterparts of the ops above.  Their output aliases their
+// first input.
+bool isChannelsLastAgnosticInPlace(const Node* node) {
+  static const std::unordered_set<Symbol> ops = {
+      Symbol::fromQualString("aten::relu_"),
+      Symbol::fromQualString("aten::hardtanh_"),
+      Symbol::fromQualString("aten::hardswish_"),
+      Symbol::fromQualString("aten::sigmoid_"),
+      Symbol::fromQualString("aten::clamp_"),
+      Symbol::fromQualString("aten::add_"),
+      Symbol::fromQualString("aten::add_relu_"),
+      Symbol::fromQualString("aten::sub_"),
+      Symbol::fromQualString("aten::mul_"),
+  };
+
+  return ops.count(node->kind()) > 0u;
+}
+
+// A list of region tensors only concatenated along a (logical) dimension.
+bool isConcatenatedList(const Node* node) {
+  if (node->kind() != prim::ListConstruct) {
+    return false;
+  }
+
+  for (const Use& use : node->output()->uses()) {
+    if (use.user->kind() != aten::cat || use.offset != 0u) {
+      return false;
+    }
+  }
+
+  return !node->output()->uses().empty();
+}
+
+// The nodes which read a tensor without depending on its memory format.
+bool ignoresMemoryFormat(const Node* node) {
+  return node->kind() == aten::size || node->kind() == aten::dim ||
+      node->kind() == aten::contiguous;
+}
+
+// Whether the use of a region tensor doesn't need it converted back.
+bool isRegionUse(const Use& use) {
+  return isChannelsLastAgnostic(use.user, use.offset) ||
+      (isChannelsLastAgnosticInPlace(use.user) && 0u == use.offset) ||
+      isConcatenatedList(use.user) || ignoresMemoryFormat(use.user);
+}
+
+// Whether the region tensor can be handed over as a copy, converted back to
+// contiguous, to a node outside of the region.
+bool acceptsConvertedInput(const Node* node) {
+  if (node->kind() == prim::Return || node->kind() == prim::TupleConstruct ||
+      node->kind() == prim::ListConstruct) {
+    return true;
+  }
+
+  // A node which writes to its input must see the tensor itself.
+  const FunctionSchema* const schema = node->maybeSchema();
+  return schema && !schema->is_mutable();
+}
+
+Value* insertMemoryFormatConversion(
+    Value* value,
+    const c10::MemoryFormat memory_format,
+    Node* insert_point) {
+  Graph* const graph = value->owningGraph();
+  WithInsertPoint guard(insert_point);
+
+  Value* const format = graph->insertConstant(memory_format);
+  Node* const contiguous =
+      graph->insertNode(graph->create(aten::contiguous, {value, format}));
+  contiguous->output()->setType(value->type());
+  return contiguous->output();
+}
+
+// Converts the graph inputs which feed an XNNPACK convolution to NHWC once,
+// ahead of the region of NHWC capable ops the convolution starts, and converts
+// the tensors leaving the region back to contiguous where they do.  Left
+// alone, every prepacked convolution converts its NCHW input to NHWC and its
+// output back, as does every other XNNPACK op.
+void insertChannelsLastRegions(std::shared_ptr<Graph>& graph) {
+  for (Value* const input : graph->inputs()) {
+    if (!input->type()->isSubtypeOf(TensorType::get())) {
+      continue;
+    }
+
+    // The uses of the input which enter the region.
+    std::vector<Use> entries;
+    bool feeds_convolution = false;
+    bool mutated = false;
+
+    for (const Use& use : input->uses()) {
+      if (isChannelsLastAgnostic(use.user, use.offset)) {
+        entries.push_back(use);
+        feeds_convolution = feeds_convolution ||
+            use.user->kind() ==
+                Symbol::fromQualString("prepacked::conv2d_clamp_run");
+      } else if (isChannelsLastAgnosticInPlace(use.user)) {
+        // The conversion copies, so the input of the caller wouldn't be
+        // written to anymore.
+        mutated = true;
+      }
+    }
+
+    if (!feeds_convolution || mutated) {
+      continue;
+    }
+
+    // Walk the region, collecting the tensors leaving it.  A tensor written
+    // to in place can't leave the region since its copy could be taken before
+    // the write, so the region is given up on in that case.  Tensors written
+    // to in place are tracked through the first tensor of their alias set.
+    std::unordered_map<Value*, Value*> alias_roots;
+    std::unordered_set<Value*> written_roots;
+    std::unordered_set<Value*> leaving_roots;
+    std::vector<Value*> leaving;
+    std::vector<Value*> worklist;
+    bool region_is_valid = true;
+
+    const auto enter = [&](Value* const value, Value* const root) {
+      if (alias_roots.emplace(value, root).second) {
+        worklist.push_back(value);
+      }
+    };
+
+    for (const Use& use : entries) {
+      for (Value* const output : use.user->outputs()) {
+        enter(output, output);
+      }
+    }
+
+    while (!worklist.empty() && region_is_valid) {
+      Value* const value = worklist.back();
+      worklist.pop_back();
+      Value* const root = alias_roots.at(value);
+      bool leaves = false;
+
+      for (const Use& use : value->uses()) {
+        Node* const user = use.user;
+
+        if (isChannelsLastAgnostic(user, use.offset)) {
+          for (Value* const output : user->outputs()) {
+            enter(output, output);
+          }
+        } else if (isChannelsLastAgnosticInPlace(user) && 0u == use.offset) {
+          written_roots.insert(root);
+          enter(user->output(), root);
+        } else if (isConcatenatedList(user)) {
+          for (const Use& list_use : user->output()->uses()) {
+            enter(list_use.user->output(), list_use.user->output());
+          }
+        } else if (ignoresMemoryFormat(user)) {
+          // Nothing to convert.
+        } else if (acceptsConvertedInput(user)) {
+          leaves = true;
+        } else {
+          region_is_valid = false;
+        }
+      }
+
+      if (leaves) {
+        leaving_roots.insert(root);
+        leaving.push_back(value);
+      }
+    }
+
+    for (Value* const root : written_roots) {
+      region_is_valid = region_is_valid && !leaving_roots.count(root);
+    }
+
+    if (!region_is_valid) {
+      continue;
+    }
+
+    // Leave the region first, so that the uses replaced are only those
+    // outside of it.
+    for (Value* const value : leaving) {
+      std::vector<Use> uses = value->uses();
+      Value* const contiguous = insertMemoryFormatConversion(
+          value, c10::MemoryFormat::Contiguous, value->node()->next());
+
+      for (const Use& use : uses) {
+        if (!isRegionUse(use)) {
+          use.user->replaceInput(use.offset, contiguous);
+        }
+      }
+    }
+
+    Value* const channels_last = insertMemoryFormatConversion(
+        input, c10::MemoryFormat::ChannelsLast, graph->nodes().front());
+
+    for (const Use& use : entries) {
+      use.user->replaceInput(use.offset, channels_last);
+    }
+  }
+}
+
 void runCanonicalOptimizations(script::Module& module) {
   auto graph = module.get_method("forward").graph();
   // Not sure if we have models running on mobile that require loop unrolling.
@@ -275,6 +500,11 @@ void FoldPrePackingOps(script::Module& m) {
   PrePackingOpsFolder(m, filter_fn, "prepack_folding");
 }
 
+void insertChannelsLastRegions(script::Module& module) {
+  auto graph = module.get_method("forward").graph();
+  insertChannelsLastRegions(graph);
+}
+
 script::Module optimizeForMobile(
     const script::Module& m,
     const std::set<MobileOptimizerType>& optimization_blocklist,
@@ -307,6 +537,14 @@ script::Module optimizeForMobile(
     FuseAddRelu(cloned_module);
   }
 
+  // Regions start at the prepacked convolutions.
+  if (!optimization_blocklist.count(
+          MobileOptimizerType::INSERT_FOLD_PREPACK_OPS) &&
+      !optimization_blocklist.count(
+          MobileOptimizerType::CHANNELS_LAST_REGIONS)) {
+    insertChannelsLastRegions(cloned_module);
+  }
+
   return cloned_module;
 }
 
@@ -332,6 +570,11 @@ void FoldPrePackingOps(script::Module& m) {
       "XNNPACK is not enabled. Please build with USE_XNNPACK=1");
 }
 
+void insertChannelsLastRegions(script::Module& module) {
+  TORCH_INTERNAL_ASSERT(
+      "XNNPACK is not enabled. Please build with USE_XNNPACK=1");
+}
+
 script::Module optimizeForMobile(
     const script::Module& module,
     const std::set<MobileOptimizerType>& blocklist,
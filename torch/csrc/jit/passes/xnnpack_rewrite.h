@@ -11,12 +11,14 @@ enum class MobileOptimizerType : int8_t {
   INSERT_FOLD_PREPACK_OPS,
   REMOVE_DROPOUT,
   FUSE_ADD_RELU,
+  CHANNELS_LAST_REGIONS,
 };
 
 TORCH_API void insertPrePackedOps(std::shared_ptr<Graph>& graph);
 TORCH_API void insertPrePackedOps(script::Module& module);
 TORCH_API void fusePrePackedLinearConvWithClamp(script::Module& module);
 TORCH_API void FoldPrePackingOps(script::Module& module);
+TORCH_API void insertChannelsLastRegions(script::Module& module);
 TORCH_API script::Module optimizeForMobile(
     const script::Module& module,
     const std::set<MobileOptimizerType>& optimization_blocklist = {},
@@ -2,16 +2,19 @@
 
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/backends/backend_init.h>
+#include <torch/csrc/jit/codegen/fuser/disk_cache.h>
 #include <torch/csrc/jit/codegen/fuser/interface.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
 #include <torch/csrc/jit/frontend/ir_emitter.h>
 #include <torch/csrc/jit/frontend/tracer.h>
 #include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/canonicalize_graph_fuser_ops.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
 #include <torch/csrc/jit/passes/constant_pooling.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/cpu_prepack.h>
 #include <torch/csrc/jit/passes/create_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/create_functional_graphs.h>
 #include <torch/csrc/jit/passes/cuda_graph_fuser.h>
@@ -20,6 +23,8 @@
 #include <torch/csrc/jit/passes/erase_number_types.h>
 #include <torch/csrc/jit/passes/fold_conv_bn.h>
 #include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/fuse_addmm_activation.h>
+#include <torch/csrc/jit/passes/fuse_dropout_add_layer_norm.h>
 #include <torch/csrc/jit/passes/fuse_linear.h>
 #include <torch/csrc/jit/passes/fuse_relu.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
@@ -28,8 +33,11 @@
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_graph.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_format_propagation.h>
+#include <torch/csrc/jit/passes/mkldnn_rewrite.h>
 #include <torch/csrc/jit/passes/normalize_ops.h>
 #include <torch/csrc/jit/passes/onnx.h>
+#include <torch/csrc/jit/passes/out_variants.h>
 #include <torch/csrc/jit/passes/onnx/cast_all_constant_to_floating.h>
 #include <torch/csrc/jit/passes/onnx/constant_fold.h>
 #include <torch/csrc/jit/passes/onnx/fixup_onnx_conditionals.h>
@@ -71,6 +79,7 @@
 #include <torch/csrc/jit/runtime/jit_exception.h>
 #include <torch/csrc/jit/runtime/operator.h>
 #include <torch/csrc/jit/runtime/print_handler.h>
+#include <torch/csrc/jit/runtime/static_runtime.h>
 #include <torch/csrc/jit/serialization/export.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
@@ -78,6 +87,7 @@
 
 #include <c10/macros/Export.h>
 #include <caffe2/serialize/inline_container.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
 
 #include <ATen/core/function_schema.h>
 
@@ -163,6 +173,9 @@ void initJITBindings(PyObject* module) {
           "_jit_pass_onnx_prepare_inplace_ops_for_onnx",
           PrepareInplaceOpsForONNX)
       .def("_jit_pass_fuse", FuseGraph)
+      .def(
+          "_jit_pass_batch_mm",
+          [](std::shared_ptr<Graph>& g) { return BatchMM(g); })
       .def(
           "_jit_pass_dce",
           [](std::shared_ptr<Graph>& g) {
@@ -244,6 +257,14 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_fuse_add_relu",
           [](std::shared_ptr<Graph>& graph) { FuseAddRelu(graph); })
+      .def(
+          "_jit_pass_fuse_dropout_add_layer_norm",
+          [](std::shared_ptr<Graph>& graph) {
+            FuseDropoutAddLayerNorm(graph);
+          })
+      .def(
+          "_jit_pass_fuse_addmm_activation",
+          [](std::shared_ptr<Graph>& graph) { FuseAddMMActivation(graph); })
       .def("_jit_pass_dedup_module_uses", &DedupModuleUses)
       .def("_jit_pass_replicate_dequantize", &ReplicateDeQuant)
       .def(
@@ -334,6 +355,9 @@ void initJITBindings(PyObject* module) {
             PropagateInputShapes(graph);
           })
       .def("_jit_pass_remove_expands", RemoveExpands)
+      .def(
+          "_jit_pass_insert_out_variants",
+          [](std::shared_ptr<Graph>& g) { return InsertOutVariants(g); })
       .def("_jit_pass_erase_number_types", EraseNumberTypes)
       .def("_jit_pass_inline_fork_wait", InlineForkWait)
       .def("_jit_pass_inline", Inline)
@@ -404,6 +428,10 @@ void initJITBindings(PyObject* module) {
       .def("_jit_override_can_fuse_on_gpu", &overrideCanFuseOnGPU)
       .def("_jit_can_fuse_on_cpu", &canFuseOnCPU)
       .def("_jit_can_fuse_on_gpu", &canFuseOnGPU)
+      .def("_jit_get_fuser_cache_dir", []() { return fuser::diskCacheDir(); })
+      .def(
+          "_jit_set_fuser_cache_dir",
+          [](const std::string& dir) { fuser::diskCacheDir() = dir; })
       .def(
           "_jit_differentiate",
           [](Graph& g) {
@@ -451,6 +479,13 @@ void initJITBindings(PyObject* module) {
             getBailoutDepth() = depth;
             return old_depth;
           })
+      .def(
+          "_jit_set_num_specializations",
+          [](size_t num) {
+            size_t old_num = getNumSpecializations();
+            getNumSpecializations() = num;
+            return old_num;
+          })
       .def(
           "_jit_set_inline_everything_mode",
           [](bool enabled) { getInlineEverythingMode() = enabled; })
@@ -512,6 +547,26 @@ void initJITBindings(PyObject* module) {
           })
       .def("_jit_set_texpr_fuser_enabled", &setTensorExprFuserEnabled)
       .def("_jit_texpr_fuser_enabled", &tensorExprFuserEnabled)
+      .def(
+          "_jit_set_texpr_dynamic_shapes_enabled",
+          &setTensorExprDynamicShapesEnabled)
+      .def(
+          "_jit_texpr_dynamic_shapes_enabled",
+          &tensorExprDynamicShapesEnabled)
+      .def(
+          "_jit_set_texpr_async_compilation_enabled",
+          &setTensorExprAsyncCompilationEnabled)
+      .def(
+          "_jit_texpr_async_compilation_enabled",
+          &tensorExprAsyncCompilationEnabled)
+      .def(
+          "_jit_set_lazy_method_compilation_enabled",
+          &setLazyMethodCompilationEnabled)
+      .def(
+          "_jit_lazy_method_compilation_enabled",
+          &lazyMethodCompilationEnabled)
+      .def("_jit_set_out_variants_enabled", &setOutVariantsEnabled)
+      .def("_jit_out_variants_enabled", &outVariantsEnabled)
       .def("_jit_texpr_fallback_allowed", &tensorexpr::fallbackAllowed)
       .def("_jit_texpr_set_fallback_allowed", &tensorexpr::setFallbackAllowed)
       .def(
@@ -541,6 +596,34 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_fold_prepacking_ops",
           [](script::Module& module) { return FoldPrePackingOps(module); })
+      .def(
+          "_jit_pass_insert_cpu_prepacked_ops",
+          [](std::shared_ptr<Graph>& graph) {
+            return insertCpuPrePackedOps(graph);
+          })
+      .def(
+          "_jit_pass_insert_cpu_prepacked_ops",
+          [](script::Module& module) { return insertCpuPrePackedOps(module); })
+      .def(
+          "_jit_pass_convert_frozen_ops_to_mkldnn",
+          [](std::shared_ptr<Graph>& graph) {
+            return convertFrozenOpsToMKLDNN(graph);
+          })
+      .def(
+          "_jit_pass_convert_frozen_ops_to_mkldnn",
+          [](script::Module& module) {
+            return convertFrozenOpsToMKLDNN(module);
+          })
+      .def(
+          "_jit_pass_convert_frozen_ops_to_channels_last",
+          [](std::shared_ptr<Graph>& graph) {
+            return convertFrozenOpsToChannelsLast(graph);
+          })
+      .def(
+          "_jit_pass_convert_frozen_ops_to_channels_last",
+          [](script::Module& module) {
+            return convertFrozenOpsToChannelsLast(module);
+          })
       .def(
           "_jit_pass_optimize_for_mobile",
           [](script::Module& module,
@@ -676,6 +759,27 @@ void initJITBindings(PyObject* module) {
       .def_property_readonly(
           "fallback", [](GraphExecutorState& s) { return s.fallback; });
 
+  py::class_<StaticRuntime>(m, "StaticRuntime")
+      .def(py::init<const Module&>())
+      .def(
+          "run",
+          [](StaticRuntime& self, const std::vector<at::Tensor>& inputs) {
+            auto outputs =
+                self.run(std::vector<IValue>(inputs.begin(), inputs.end()));
+            if (outputs.size() == 1) {
+              return toPyObject(std::move(outputs[0]));
+            }
+            py::tuple result(outputs.size());
+            for (size_t i = 0; i < outputs.size(); ++i) {
+              result[i] = toPyObject(std::move(outputs[i]));
+            }
+            return py::object(std::move(result));
+          })
+      .def_property_readonly("graph", &StaticRuntime::graph)
+      .def_property_readonly("arena_bytes", &StaticRuntime::arenaBytes)
+      .def_property_readonly(
+          "num_planned_values", &StaticRuntime::numPlannedValues);
+
   py::class_<PyTorchStreamWriter>(m, "PyTorchFileWriter")
       .def(py::init<std::string>())
       .def(py::init([](const py::object& buffer) {
@@ -694,6 +798,11 @@ void initJITBindings(PyObject* module) {
              const char* data,
              size_t size) { return self.writeRecord(name, data, size); })
       .def("write_end_of_file", &PyTorchStreamWriter::writeEndOfFile)
+      .def(
+          "set_compress_records",
+          &PyTorchStreamWriter::setCompressRecords,
+          py::arg("compress_records"),
+          py::arg("num_threads") = 0)
       .def(
           "write_record",
           [](PyTorchStreamWriter& self,
@@ -711,6 +820,8 @@ void initJITBindings(PyObject* module) {
           MobileOptimizerType::INSERT_FOLD_PREPACK_OPS)
       .value("REMOVE_DROPOUT", MobileOptimizerType::REMOVE_DROPOUT)
       .value("FUSE_ADD_RELU", MobileOptimizerType::FUSE_ADD_RELU)
+      .value(
+          "CHANNELS_LAST_REGIONS", MobileOptimizerType::CHANNELS_LAST_REGIONS)
       .export_values();
 
   // This allows PyTorchStreamReader to read from a Python buffer. It requires
@@ -778,6 +889,13 @@ void initJITBindings(PyObject* module) {
 
   py::class_<PyTorchStreamReader>(m, "PyTorchFileReader")
       .def(py::init<std::string>())
+      .def(py::init([](const std::string& file_name, bool mmap) {
+        if (!mmap) {
+          return std::make_unique<PyTorchStreamReader>(file_name);
+        }
+        return std::make_unique<PyTorchStreamReader>(
+            std::make_unique<caffe2::serialize::MmapFileAdapter>(file_name));
+      }))
       .def(py::init([](const py::object& buffer) {
         auto adapter = std::make_unique<BufferAdapter>(std::move(buffer));
         return std::make_unique<PyTorchStreamReader>(std::move(adapter));
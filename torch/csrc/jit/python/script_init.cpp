@@ -28,6 +28,8 @@
 
 #include <torch/csrc/api/include/torch/ordered_dict.h>
 
+#include <caffe2/serialize/mmap_file_adapter.h>
+
 #include <ATen/ATen.h>
 #include <ATen/core/function_schema.h>
 #include <ATen/core/qualified_name.h>
@@ -881,19 +883,24 @@ void initJitScriptBindings(PyObject* module) {
           "save",
           [](Module& m,
              const std::string& filename,
-             const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
-            m.save(filename, _extra_files);
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             bool _compress = false) {
+            ExportModule(m, filename, _extra_files, false, _compress);
           },
           py::arg("filename"),
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_compress") = false)
       .def(
           "save_to_buffer",
-          [](Module& m, const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
+          [](Module& m,
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             bool _compress = false) {
             std::ostringstream buf;
-            m.save(buf, _extra_files);
+            ExportModule(m, buf, _extra_files, false, _compress);
             return py::bytes(buf.str());
           },
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_compress") = false)
       .def(
           "_save_for_mobile",
           [](Module& m,
@@ -1112,7 +1119,8 @@ void initJitScriptBindings(PyObject* module) {
           "save",
           [](const StrongFunctionPtr& self,
              const std::string& filename,
-             const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             bool _compress = false) {
             Module module("__torch__.PlaceholderModule");
             // [issue 27343]
             // Modules have 'training' attributes by default, but due to
@@ -1123,23 +1131,26 @@ void initJitScriptBindings(PyObject* module) {
             // be deleted.
             module.register_attribute("training", BoolType::get(), true);
             addFunctionToModule(module, self);
-            module.save(filename, _extra_files);
+            ExportModule(module, filename, _extra_files, false, _compress);
           },
           py::arg("filename"),
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_compress") = false)
       .def(
           "save_to_buffer",
           [](const StrongFunctionPtr& self,
-             const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             bool _compress = false) {
             std::ostringstream buf;
             Module module("__torch__.PlaceholderModule");
             // see [issue 27343]
             module.register_attribute("training", BoolType::get(), true);
             addFunctionToModule(module, self);
-            module.save(buf, _extra_files);
+            ExportModule(module, buf, _extra_files, false, _compress);
             return py::bytes(buf.str());
           },
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_compress") = false)
       .def_property_readonly(
           "graph",
           [](const StrongFunctionPtr& self) { return self.function_->graph(); })
@@ -1341,16 +1352,29 @@ void initJitScriptBindings(PyObject* module) {
       [](std::shared_ptr<CompilationUnit> cu,
          const std::string& filename,
          py::object map_location,
-         ExtraFilesMap& extra_files) {
+         ExtraFilesMap& extra_files,
+         bool mmap) {
         c10::optional<at::Device> optional_device;
         if (!map_location.is(py::none())) {
           AT_ASSERT(THPDevice_Check(map_location.ptr()));
           optional_device =
               reinterpret_cast<THPDevice*>(map_location.ptr())->device;
         }
+        if (mmap) {
+          return import_ir_module(
+              std::move(cu),
+              std::make_unique<caffe2::serialize::MmapFileAdapter>(filename),
+              optional_device,
+              extra_files);
+        }
         return import_ir_module(
             std::move(cu), filename, optional_device, extra_files);
-      });
+      },
+      py::arg("cu"),
+      py::arg("filename"),
+      py::arg("map_location"),
+      py::arg("extra_files"),
+      py::arg("mmap") = false);
   m.def(
       "import_ir_module_from_buffer",
       [](std::shared_ptr<CompilationUnit> cu,
@@ -1369,15 +1393,18 @@ void initJitScriptBindings(PyObject* module) {
       });
   m.def(
       "_load_for_lite_interpreter",
-      [](const std::string& filename, py::object map_location) {
+      [](const std::string& filename, py::object map_location, bool mmap) {
         c10::optional<at::Device> optional_device;
         if (!map_location.is(py::none())) {
           AT_ASSERT(THPDevice_Check(map_location.ptr()));
           optional_device =
               reinterpret_cast<THPDevice*>(map_location.ptr())->device;
         }
-        return _load_for_mobile(filename, optional_device);
-      });
+        return _load_for_mobile(filename, optional_device, mmap);
+      },
+      py::arg("filename"),
+      py::arg("map_location"),
+      py::arg("mmap") = false);
   m.def(
       "_load_for_lite_interpreter_from_buffer",
       [](const std::string& buffer, py::object map_location) {
@@ -614,6 +614,117 @@ static void deduplicateSizeCaptures(
   }
 }
 
+// Pointwise ops that are cheaper to run again in df, where the fuser can fold
+// them into the kernels of the backward, than to save their outputs.
+static bool isCheapPointwise(Node* node) {
+  switch (node->kind()) {
+    case aten::add:
+    case aten::sub:
+    case aten::mul:
+    case aten::div:
+    case aten::neg:
+    case aten::reciprocal:
+    case aten::relu:
+    case aten::sigmoid:
+    case aten::tanh:
+    case aten::exp:
+    case aten::log:
+    case aten::sqrt:
+    case aten::rsqrt:
+    case aten::abs:
+    case aten::threshold:
+    case aten::clamp:
+    case aten::type_as:
+    case aten::eq:
+    case aten::ne:
+    case aten::ge:
+    case aten::gt:
+    case aten::le:
+    case aten::lt:
+      return node->outputs().size() == 1 && node->blocks().empty();
+    default:
+      return false;
+  }
+}
+
+// A capture that is neither an input nor an output of f has to be added to
+// the outputs of f and kept alive until df runs. When cheap pointwise ops
+// compute it from values df has anyway (the inputs of f, the captures that
+// are kept and constants), the ops are rerun at the start of the reverse block
+// instead.
+static void recomputeCheapCaptures(
+    Gradient& grad_desc,
+    ReverseDetails& rev_info) {
+  auto& graph = *grad_desc.f;
+  Block* reverse_block = rev_info.reverse_block;
+  const value_set outputs(graph.outputs().begin(), graph.outputs().end());
+  value_set available(graph.inputs().begin(), graph.inputs().end());
+
+  std::unordered_map<Value*, bool> recomputable;
+  std::function<bool(Value*)> can_recompute = [&](Value* v) {
+    if (available.count(v) || v->node()->kind() == prim::Constant) {
+      return true;
+    }
+    const auto it = recomputable.find(v);
+    if (it != recomputable.end()) {
+      return it->second;
+    }
+    Node* node = v->node();
+    const bool result = isCheapPointwise(node) &&
+        std::all_of(node->inputs().begin(),
+                    node->inputs().end(),
+                    can_recompute);
+    recomputable.emplace(v, result);
+    return result;
+  };
+
+  // The captures are in topological order, so whether the captures a capture
+  // depends on are kept is known by the time it is visited.
+  value_list recomputed_captures;
+  for (Value* capture : getReverseCaptures(grad_desc)) {
+    if (!available.count(capture) && !outputs.count(capture) &&
+        can_recompute(capture)) {
+      recomputed_captures.push_back(capture);
+    } else {
+      available.insert(capture);
+    }
+  }
+  if (recomputed_captures.empty()) {
+    return;
+  }
+
+  WithInsertPoint guard(*reverse_block->nodes().begin());
+  value_map recomputed;
+  std::function<Value*(Value*)> recompute = [&](Value* v) {
+    if (available.count(v) || v->node()->kind() == prim::Constant) {
+      return v;
+    }
+    const auto it = recomputed.find(v);
+    if (it != recomputed.end()) {
+      return it->second;
+    }
+    Node* clone = graph.insertNode(graph.createClone(v->node(), recompute));
+    liftConstants(clone, reverse_block);
+    GRAPH_DEBUG(
+        "Recomputing ",
+        v->debugName(),
+        " as ",
+        clone->output()->debugName(),
+        " in the backprop block");
+    recomputed.emplace(v, clone->output());
+    return clone->output();
+  };
+  for (Value* capture : recomputed_captures) {
+    Value* value = recompute(capture);
+    const auto uses = capture->uses();
+    for (const Use& use : uses) {
+      if (inBlock(use.user, reverse_block)) {
+        use.user->replaceInput(use.offset, value);
+      }
+    }
+  }
+}
+
 static void eliminateDeadCode(ReverseDetails& rev_info) {
   // addReverseInline has to call gradientForNode if *any* of the inputs
   // require grad, but it will emit vjps for *all* inputs. Use DCE to remove
@@ -815,7 +926,9 @@ void packReturnValuesIntoTuple(const std::shared_ptr<Graph>& graph) {
   returnNode->addInput(tuple->output());
 }
 
-Gradient differentiate(std::shared_ptr<Graph>& graph) {
+Gradient differentiate(
+    std::shared_ptr<Graph>& graph,
+    bool recompute_captures) {
   Gradient grad_desc;
   // Take ownership of the graph
   TORCH_CHECK(
@@ -831,6 +944,9 @@ Gradient differentiate(std::shared_ptr<Graph>& graph) {
   // Fills in df_input_vjps and df_output_vjps
   auto rev_info = addReverseInline(grad_desc);
   Optimize(grad_desc, rev_info);
+  if (recompute_captures) {
+    recomputeCheapCaptures(grad_desc, rev_info);
+  }
   // Clean up old nodes which has been replaced by forward graphs in torchscript
   EliminateDeadCode(grad_desc.f->block());
 
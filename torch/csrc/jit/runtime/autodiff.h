@@ -87,7 +87,13 @@ struct Gradient {
   //   - Interpret df
   //   - Wrap outputs of df into Variables (that don't require grad)
 };
-TORCH_API Gradient differentiate(std::shared_ptr<Graph>& graph);
+
+// With recompute_captures, the cheap pointwise intermediates df needs are
+// recomputed in df from values it captures anyway, instead of being saved as
+// extra outputs of f. This only pays off when the ops of df get fused.
+TORCH_API Gradient differentiate(
+    std::shared_ptr<Graph>& graph,
+    bool recompute_captures = false);
 
 // can we take a derivative of this node symbolically?
 TORCH_API bool isDifferentiable(Node* n);
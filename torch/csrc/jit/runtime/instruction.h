@@ -17,6 +17,7 @@ namespace jit {
 // T - index into the type table, used for guard instructions
 // S - index into object slots
 // C - index into code table
+// X - index into the register op table, see RegisterOp in interpreter.cpp
 
 #define FORALL_OPCODES(_)                                                   \
   _(OP, "O") /* invoke operator X */                                        \
@@ -53,7 +54,8 @@ namespace jit {
   _(FORK, "CN") /* launch a thread to run code entry x with N inputs  */    \
   _(WARN, "") /* emit a warning with line information */                    \
   _(ENTER, "EN") /* enter scope of a contextmanager */                      \
-  _(EXIT, "EX") /* exit the last entered contextmanager */
+  _(EXIT, "EX") /* exit the last entered contextmanager */                  \
+  _(OPR, "X") /* invoke an operator on registers, see RegisterOp */
 
 enum OpCode : uint8_t {
 #define DEFINE_OP(op, _) op,
@@ -411,6 +411,24 @@ struct BailoutBlock {
   std::vector<Instruction> instructions; // ends in a TAIL_CALL
 };
 
+// With GCC and clang, each instruction of the interpreter loop jumps to the
+// next one through a table of label addresses (computed goto), rather than
+// going back to the single indirect branch of the switch.
+#if defined(__GNUC__) || defined(__clang__)
+#define JIT_INTERPRETER_COMPUTED_GOTO
+#endif
+
+// Operands of an OPR instruction: the operator reads its inputs from
+// registers or from the constant table (as LOAD, MOVE or LOADC would), and
+// its output, if any, is stored to register `output`. This replaces the
+// LOAD/MOVE/LOADC ... OP STORE sequence of the node with a single
+// instruction.
+struct RegisterOp {
+  int op; // index into the operator table
+  std::vector<Instruction> inputs;
+  int output; // 0 if the operator has no output
+};
+
 struct CodeImpl {
   friend struct InterpreterState;
   std::vector<Instruction> instructions_;
@@ -422,6 +440,7 @@ struct CodeImpl {
 
   std::vector<IValue> constant_table_;
   std::vector<Operation> operator_table_;
+  std::vector<RegisterOp> register_op_table_;
   std::vector<Function*> function_table_;
   std::vector<std::unique_ptr<GraphFunction>> forked_functions_;
   std::vector<TypePtr> type_table_;
@@ -459,15 +478,18 @@ struct CodeImpl {
   std::vector<BailoutBlock> bailout_blocks_;
   std::vector<std::unique_ptr<Function>> bailout_functions_;
   size_t remaining_bailout_depth_;
+  bool emit_register_ops_;
 
   CodeImpl(
       const std::shared_ptr<Graph>& graph,
       std::string function_name,
-      size_t remaining_bailout_depth)
+      size_t remaining_bailout_depth,
+      bool emit_register_ops)
       : function_name_(std::move(function_name)),
         preprocess_(*graph),
         current_node_(preprocess_.graph->return_node()),
-        remaining_bailout_depth_(remaining_bailout_depth) {
+        remaining_bailout_depth_(remaining_bailout_depth),
+        emit_register_ops_(emit_register_ops) {
     graph_ = preprocess_.graph;
     n_outputs = graph_->outputs().size();
     if (n_outputs == 1) {
@@ -522,7 +544,7 @@ struct CodeImpl {
     instructions_source_.emplace_back(current_node_);
 
     // check that we didn't accidentally emit nodes out of topological order
-    if (op == OP) {
+    if (op == OP || op == OPR) {
       if (last_inserted_op_ != nullptr && current_node_ != last_inserted_op_ &&
           current_node_->owningBlock() == last_inserted_op_->owningBlock()) {
         TORCH_INTERNAL_ASSERT(
@@ -577,21 +599,27 @@ struct CodeImpl {
         insertInstruction(DROP);
       }
     } else {
-      int reg = registerFor(input);
-      bool moved = input->uses().size() == ++use_count_[input];
-
-      OpCode op;
-      if (input->node()->kind() == prim::Constant) {
-        op = LOADC;
-      } else if (drop) {
-        op = DROPR;
-      } else if (moved) {
-        op = MOVE;
-      } else {
-        op = LOAD;
-      }
-      insertInstruction(op, reg);
+      Instruction use = registerUse(input, drop);
+      insertInstruction(use.op, use.X);
+    }
+  }
+
+  // The instruction reading `input` from its register or the constant table
+  Instruction registerUse(Value* input, bool drop) {
+    int reg = registerFor(input);
+    bool moved = input->uses().size() == ++use_count_[input];
+
+    OpCode op;
+    if (input->node()->kind() == prim::Constant) {
+      op = LOADC;
+    } else if (drop) {
+      op = DROPR;
+    } else if (moved) {
+      op = MOVE;
+    } else {
+      op = LOAD;
     }
+    return Instruction(op, reg, 0);
   }
 
   void emitLoadInputs(at::ArrayRef<Value*> inputs) {
@@ -600,9 +628,37 @@ struct CodeImpl {
     }
   }
 
+  // A node emitted at block level whose inputs all live in registers or in
+  // the constant table becomes a single OPR instruction
+  bool canEmitRegisterOp(Node* node, const Operator& op) {
+    if (!emit_register_ops_ || preprocess_.can_emit_inline[node] ||
+        node->outputs().size() > 1 ||
+        (op.hasOperation() && op.schema().is_vararg())) {
+      return false;
+    }
+    for (Value* input : node->inputs()) {
+      if (preprocess_.can_emit_inline[input->node()]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   void emitOperator(Node* node) {
-    emitLoadInputs(node->inputs());
     const Operator& op = node->getOperator();
+    if (canEmitRegisterOp(node, op)) {
+      RegisterOp rop;
+      rop.op = operator_table_.size();
+      for (Value* input : node->inputs()) {
+        rop.inputs.push_back(registerUse(input, false));
+      }
+      rop.output = node->outputs().empty() ? 0 : allocRegs(node->outputs());
+      insertInstruction(OPR, register_op_table_.size());
+      register_op_table_.emplace_back(std::move(rop));
+      operator_table_.emplace_back(op.getOperation(node));
+      return;
+    }
+    emitLoadInputs(node->inputs());
     if (op.hasOperation() && op.schema().is_vararg()) {
       insertInstruction(OPN, operator_table_.size(), node->inputs().size());
     } else {
@@ -624,7 +680,8 @@ struct CodeImpl {
 
   void emitStoreOutputs(Node* node) {
     size_t N = node->outputs().size();
-    if (N == 0)
+    // OPR instructions store their output themselves
+    if (N == 0 || value_to_reg_.count(node->outputs().at(0)))
       return;
     int regs = allocRegs(node->outputs());
     if (N == 1) {
@@ -951,7 +1008,7 @@ struct CodeImpl {
   void dump(std::ostream& out, size_t i) const {
     out << i << " " << instructions_[i];
     if (instructions_[i].op == OP || instructions_[i].op == CALL ||
-        instructions_[i].op == OPN) {
+        instructions_[i].op == OPN || instructions_[i].op == OPR) {
       out << " # " << *instructions_source_[i];
     } else {
       out << "\n";
@@ -1026,6 +1083,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     Instruction* instructions;
     IValue* constants;
     Operation* operators;
+    RegisterOp* register_ops;
     Function** functions;
     std::function<void(std::vector<IValue>&)>* profile_functions;
     TypePtr* types;
@@ -1035,6 +1093,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
           instructions(frame.function->instructions_.data()),
           constants(frame.function->constant_table_.data()),
           operators(frame.function->operator_table_.data()),
+          register_ops(frame.function->register_op_table_.data()),
           functions(frame.function->function_table_.data()),
           profile_functions(frame.function->profile_function_table_.data()),
           types(frame.function->type_table_.data()) {}
@@ -1124,6 +1183,23 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
       stack_start_ = 0;
     }
 
+#ifdef JIT_INTERPRETER_COMPUTED_GOTO
+    static const void* dispatch_table[] = {
+#define DISPATCH_LABEL(op, _) &&label_##op,
+        FORALL_OPCODES(DISPATCH_LABEL)
+#undef DISPATCH_LABEL
+    };
+#define INST(op) \
+  case op:       \
+  label_##op
+#define INST_NEXT                 \
+  inst = af.instructions[af.pc]; \
+  goto* dispatch_table[inst.op]
+#else
+#define INST(op) case op
+#define INST_NEXT break
+#endif
+
     ActiveFrame af(frames.back());
     try {
       while (true) {
@@ -1131,13 +1207,13 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
         // frames.back().function->dump(std::cout, af.pc);
         Instruction inst = af.instructions[af.pc];
         switch (inst.op) {
-          case ENTER: {
+          INST(ENTER): {
             auto obj = peek(stack, 0, 1);
             TORCH_INTERNAL_ASSERT(obj.isObject());
             entered_objects.push_back(obj);
             ++af.pc;
-          } break;
-          case EXIT: {
+          } INST_NEXT;
+          INST(EXIT): {
             auto obj = entered_objects.back().toObject();
             auto& f = obj->type()->getMethod("__exit__");
             push(stack, obj);
@@ -1146,65 +1222,82 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             push(stack, IValue());
             push(stack, IValue());
             runGraphFunction(stack, &f, &af);
-          } break;
-          case OP:
+          } INST_NEXT;
+          INST(OP):
             af.operators[inst.X](&stack);
             ++af.pc;
-            break;
-          case OPN:
+            INST_NEXT;
+          INST(OPR): {
+            const RegisterOp& rop = af.register_ops[inst.X];
+            for (const Instruction& use : rop.inputs) {
+              if (use.op == MOVE) {
+                stack.emplace_back(std::move(reg(use.X)));
+              } else if (use.op == LOAD) {
+                stack.emplace_back(reg(use.X));
+              } else {
+                stack.emplace_back(af.constants[use.X]);
+              }
+            }
+            af.operators[rop.op](&stack);
+            if (rop.output != 0) {
+              reg(rop.output) = pop(stack);
+            }
+            ++af.pc;
+          } INST_NEXT;
+          INST(OPN):
             stack.push_back(inst.N);
             af.operators[inst.X](&stack);
             ++af.pc;
-            break;
-          case LOAD:
+            INST_NEXT;
+          INST(LOAD):
             stack.emplace_back(reg(inst.X));
             ++af.pc;
-            break;
-          case MOVE:
+            INST_NEXT;
+          INST(MOVE):
             stack.emplace_back(std::move(reg(inst.X)));
             ++af.pc;
-            break;
-          case STORE:
+            INST_NEXT;
+          INST(STORE):
             reg(inst.X) = pop(stack);
             ++af.pc;
-            break;
-          case STOREN:
+            INST_NEXT;
+          INST(STOREN):
             for (size_t i = inst.N; i > 0; --i) {
               reg(inst.X + i - 1) = pop(stack);
             }
             ++af.pc;
-            break;
-          case DROP:
+            INST_NEXT;
+          INST(DROP):
             pop(stack);
             ++af.pc;
-            break;
-          case DROPR:
+            INST_NEXT;
+          INST(DROPR):
             reg(inst.X) = IValue();
             ++af.pc;
-            break;
-          case LOADC:
+            INST_NEXT;
+          INST(LOADC):
             stack.emplace_back(af.constants[inst.X]);
             ++af.pc;
-            break;
-          case GET_ATTR: {
+            INST_NEXT;
+          INST(GET_ATTR): {
             auto userObj = pop(stack).toObject();
             auto value = userObj->getSlot(inst.X);
             push(stack, std::move(value));
             ++af.pc;
-          } break;
-          case SET_ATTR: {
+          } INST_NEXT;
+          INST(SET_ATTR): {
             auto v = pop(stack);
             auto userObj = pop(stack).toObject();
             userObj->setSlot(inst.X, std::move(v));
             ++af.pc;
-          } break;
-          case JF:
+          } INST_NEXT;
+          INST(JF):
             af.pc += (pop(stack).toBool()) ? 1 : inst.X;
-            break;
-          case JMP:
+            INST_NEXT;
+          INST(JMP):
             af.pc += inst.X;
-            break;
-          case LOOP: {
+            INST_NEXT;
+          INST(LOOP): {
             // stack: iteration_count, max_iter, cond, loop_carried_deps...
             auto frame = stack.end() - (inst.N + 1);
             int64_t trip_count = frame[0].toInt();
@@ -1222,16 +1315,16 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               drop(stack, 3); // iteration_count, max_iter, cond
               af.pc += inst.X;
             }
-          } break;
-          case CALL: {
+          } INST_NEXT;
+          INST(CALL): {
             Function* fn = af.functions[inst.X];
             if (!fn->isGraphFunction()) {
               runBuiltinFunction(stack, fn, &af);
             } else {
               runGraphFunction(stack, fn, &af);
             }
-          } break;
-          case INTERFACE_CALL: {
+          } INST_NEXT;
+          INST(INTERFACE_CALL): {
             // note the hash table lookup to find the function
             // this can be more optimized if necessary, caching parts
             // of the hashing computation or storing the offset when
@@ -1254,12 +1347,12 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             } else {
               runGraphFunction(stack, &function, &af);
             }
-          } break;
-          case RET:
+          } INST_NEXT;
+          INST(RET):
             if (frames.size() > 1) {
               leaveFrame();
               af = ActiveFrame(frames.back());
-              break;
+              INST_NEXT;
             }
             if (future_) {
               auto num_outputs = frames.back().function->n_outputs;
@@ -1271,7 +1364,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               }
             }
             return false;
-          case WAIT: {
+          INST(WAIT): {
             auto future = stack.back().toFuture();
             if (!future->completed()) {
               getOrCreateFuture();
@@ -1324,8 +1417,8 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             stack.pop_back();
             stack.emplace_back(future->value());
             ++af.pc;
-          } break;
-          case PROFILE_OP: {
+          } INST_NEXT;
+          INST(PROFILE_OP): {
             auto& frame_id_ref = frames.back().id;
             if (!frame_id_ref.has_value()) {
               frame_id_ref = Frame::num_frames++;
@@ -1334,18 +1427,18 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             push(stack, c10::IValue{static_cast<int64_t>(*frame_id_ref)});
             callback(stack);
             ++af.pc;
-            break;
+            INST_NEXT;
           }
-          case FAIL_GUARD: {
+          INST(FAIL_GUARD): {
             // patch FAIL_GUARD back to GUARD
             GRAPH_DEBUG(
                 "Bailout ", inst.X, " triggered via bailout_requests_!");
             af.instructions[af.pc].op = GUARD;
             push(stack, false);
             ++af.pc;
-            break;
+            INST_NEXT;
           }
-          case GUARD: {
+          INST(GUARD): {
             if (!stack.back().isTensor()) {
               // stack.back() is an Uninitialized IValue and this is a guard
               // on a block output. Uninitialized IValues are never used
@@ -1364,8 +1457,8 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               }
             }
             ++af.pc;
-          } break;
-          case TAIL_CALL: {
+          } INST_NEXT;
+          INST(TAIL_CALL): {
             GRAPH_DEBUG("running TAIL_CALL for ", inst.X);
             af.functions[inst.X]->ensure_defined();
             size_t remaining_bailout_depth =
@@ -1388,46 +1481,46 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             leaveFrame();
             enterFrame(code, base_pointer);
             af = ActiveFrame(frames.back());
-          } break;
-          case LIST_UNPACK: {
+          } INST_NEXT;
+          INST(LIST_UNPACK): {
             listUnpack(stack, inst.X);
             ++af.pc;
-          } break;
-          case TUPLE_CONSTRUCT: {
+          } INST_NEXT;
+          INST(TUPLE_CONSTRUCT): {
             tupleConstruct(stack, inst.X);
             ++af.pc;
-          } break;
-          case TUPLE_SLICE: {
+          } INST_NEXT;
+          INST(TUPLE_SLICE): {
             tupleSlice(stack, inst.X, inst.X + inst.N);
             ++af.pc;
-          } break;
-          case NAMED_TUPLE_CONSTRUCT: {
+          } INST_NEXT;
+          INST(NAMED_TUPLE_CONSTRUCT): {
             auto type = af.types[inst.X]->expect<TupleType>();
             namedTupleConstruct(stack, type, inst.N);
             ++af.pc;
-          } break;
-          case LIST_CONSTRUCT: {
+          } INST_NEXT;
+          INST(LIST_CONSTRUCT): {
             auto type = af.types[inst.X]->expect<ListType>();
             listConstruct(stack, type, inst.N);
             ++af.pc;
-          } break;
-          case DICT_CONSTRUCT: {
+          } INST_NEXT;
+          INST(DICT_CONSTRUCT): {
             auto type = af.types[inst.X]->expect<DictType>();
             dictConstruct(stack, type, inst.N);
             ++af.pc;
-          } break;
-          case CREATE_OBJECT: {
+          } INST_NEXT;
+          INST(CREATE_OBJECT): {
             auto type = af.types[inst.X]->expect<ClassType>();
             createObject(stack, type);
             ++af.pc;
-          } break;
-          case ISINSTANCE: {
+          } INST_NEXT;
+          INST(ISINSTANCE): {
             at::ArrayRef<TypePtr> types(
                 af.types + inst.X, af.types + inst.X + inst.N);
             isinstance(stack, types);
             ++af.pc;
-          } break;
-          case FORK: {
+          } INST_NEXT;
+          INST(FORK): {
             // Move inputs to a separate stack
             Function* forked_fn = af.functions[inst.X];
             InterpreterState forked_interpreter(
@@ -1442,8 +1535,8 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             push(stack, forked_interpreter.getFuture());
             at::launch(std::move(continuation));
             ++af.pc;
-          } break;
-          case WARN: {
+          } INST_NEXT;
+          INST(WARN): {
             Node* node = frames.back().function->instructions_source_.at(af.pc);
             auto range = node->sourceRange().source();
             if (range->filename()) {
@@ -1461,9 +1554,11 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               TORCH_WARN(pop(stack).toStringRef());
             }
             ++af.pc;
-          } break;
+          } INST_NEXT;
         }
       }
+#undef INST
+#undef INST_NEXT
     } catch (std::exception& e) {
       frames.back().pc = af.pc;
       for (auto it = entered_objects.rbegin(), end = entered_objects.rend();
@@ -1545,6 +1640,11 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
 
   void run(Stack& stack) {
     if (runImpl(stack)) {
+      // The future is likely waiting on forked inter-op tasks: run them here
+      // rather than blocking
+      while (!future_->completed() &&
+             at::internal::run_pending_interop_task()) {
+      }
       future_->wait();
 
       auto num_outputs = frames.front().function->n_outputs;
@@ -1571,11 +1671,13 @@ std::ostream& operator<<(std::ostream& out, const Code& code) {
 Code::Code(
     const std::shared_ptr<Graph>& graph,
     std::string function_name,
-    size_t remaining_bailout_depth)
+    size_t remaining_bailout_depth,
+    bool emit_register_ops)
     : pImpl(new CodeImpl(
           graph,
           std::move(function_name),
-          remaining_bailout_depth)) {}
+          remaining_bailout_depth,
+          emit_register_ops)) {}
 Code::~Code() = default;
 
 const std::vector<GraphExecutor*>& Code::grad_executors() {
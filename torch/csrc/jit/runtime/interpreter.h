@@ -36,11 +36,14 @@ struct TORCH_API Code {
   Code() : pImpl(nullptr) {}
   // remaining_bailout_depth is irrelevant in a `Code` object unless the `Code`
   // is directly created by `GraphExecutor` in which case it's likely to contain
-  // `prim::BailOut`s to control the maximum depth of bailout chains
+  // `prim::BailOut`s to control the maximum depth of bailout chains.
+  // emit_register_ops enables the OPR instruction, which the mobile
+  // interpreter doesn't support
   explicit Code(
       const std::shared_ptr<Graph>& graph,
       std::string function_name,
-      size_t remaining_bailout_depth = 0);
+      size_t remaining_bailout_depth = 0,
+      bool emit_register_ops = true);
   ~Code();
 
   const std::vector<GraphExecutor*>& grad_executors();
@@ -72,12 +72,24 @@ constexpr const char* EXECUTION_PLAN_CACHE_HIT =
     "pytorch_runtime.execution_plan_cache_hit";
 constexpr const char* EXECUTION_PLAN_CACHE_MISS =
     "pytorch_runtime.execution_plan_cache_miss";
+// The profiling executor's cache of plans specialized to profiled input types:
+// a hit reuses a plan, a miss adds one, and full means no plan matched but the
+// cache has no room for another one.
+constexpr const char* SPECIALIZED_PLAN_CACHE_HIT =
+    "pytorch_runtime.specialized_plan_cache_hit";
+constexpr const char* SPECIALIZED_PLAN_CACHE_MISS =
+    "pytorch_runtime.specialized_plan_cache_miss";
+constexpr const char* SPECIALIZED_PLAN_CACHE_FULL =
+    "pytorch_runtime.specialized_plan_cache_full";
 
 inline std::vector<const char*> allRuntimeCounters() {
   return {GRAPH_EXECUTORS_CONSTRUCTED,
           GRAPH_EXECUTOR_INVOCATIONS,
           EXECUTION_PLAN_CACHE_HIT,
-          EXECUTION_PLAN_CACHE_MISS};
+          EXECUTION_PLAN_CACHE_MISS,
+          SPECIALIZED_PLAN_CACHE_HIT,
+          SPECIALIZED_PLAN_CACHE_MISS,
+          SPECIALIZED_PLAN_CACHE_FULL};
 }
 
 } // namespace runtime_counters
@@ -18,11 +18,14 @@
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/out_variants.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/requires_grad_analysis.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
+#include <torch/csrc/jit/passes/tensorexpr_fuser.h>
+#include <torch/csrc/jit/runtime/logging.h>
 
 C10_DECLARE_bool();
 
@@ -45,6 +48,7 @@ static std::atomic<bool> profiling_mode{false};
 
 static std::atomic<size_t> num_profiled_runs{1};
 static std::atomic<size_t> bailout_depth{1};
+static std::atomic<size_t> num_specializations{4};
 
 std::atomic<bool>& getProfilingMode() {
   return profiling_mode;
@@ -61,6 +65,10 @@ std::atomic<size_t>& getBailoutDepth() {
   return bailout_depth;
 }
 
+std::atomic<size_t>& getNumSpecializations() {
+  return num_specializations;
+}
+
 static bool needsGradientInProfilingMode(Block* b) {
   for (auto n : b->nodes()) {
     if (n->kind() == prim::BailOut) {
@@ -79,6 +87,43 @@ static bool needsGradientInProfilingMode(Block* b) {
   return false;
 }
 
+// The types the guards at the top of an optimized graph expect its inputs to
+// have, i.e. the profiled types of the inputs.
+static std::vector<TypePtr> guardedInputTypes(const Graph& graph) {
+  std::vector<TypePtr> input_types(graph.inputs().size());
+  for (const Node* n : graph.nodes()) {
+    if (n->kind() != prim::BailOut) {
+      continue;
+    }
+    // the unoptimized graph is at index 0, the guarded value at index 1
+    const Value* guarded = n->input(1);
+    if (guarded->node()->kind() == prim::Param &&
+        !input_types[guarded->offset()]) {
+      input_types[guarded->offset()] = n->output()->type();
+    }
+  }
+  return input_types;
+}
+
+static bool matchesInputTypes(
+    const std::vector<TypePtr>& input_types,
+    const Stack& stack) {
+  const size_t num_inputs = input_types.size();
+  TORCH_INTERNAL_ASSERT(stack.size() >= num_inputs);
+  auto inputs = last(stack, num_inputs);
+  for (size_t i = 0; i < num_inputs; i++) {
+    if (!input_types[i]) {
+      continue;
+    }
+    if (!inputs[i].isTensor() ||
+        !input_types[i]->expect<TensorType>()->matchTensor(
+            inputs[i].toTensor())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void ProfilingGraphExecutorImpl::runProfilingOptimizations(
     std::shared_ptr<Graph>& copy) {
   if (!getGraphExecutorOptimize()) {
@@ -105,7 +150,10 @@ void ProfilingGraphExecutorImpl::runProfilingOptimizations(
         getAutodiffSubgraphInlining() ? autodiffSubgraphNodeThreshold : 1);
     for (Node* dnode : diff_nodes) {
       auto diff_graph = std::move(dnode->g(attr::Subgraph));
-      Gradient gradient = differentiate(diff_graph);
+      // The TensorExpr fuser fuses the backward graphs too, so cheap
+      // intermediates are recomputed there instead of saved.
+      Gradient gradient =
+          differentiate(diff_graph, tensorExprFuserEnabled());
       runOptimization(gradient.f);
       // run non diff optimization on the forward graph
       runNondiffOptimization(gradient.f, true);
@@ -117,6 +165,10 @@ void ProfilingGraphExecutorImpl::runProfilingOptimizations(
 
   } else {
     runNondiffOptimization(copy, true);
+    // Out variants don't support autograd
+    if (outVariantsEnabled()) {
+      InsertOutVariants(copy);
+    }
   }
   EliminateDeadCode(copy);
   GRAPH_DUMP("Optimized Graph : ", copy);
@@ -153,13 +205,34 @@ ProfilingGraphExecutorImpl::ProfilingGraphExecutorImpl(
     std::string function_name)
     : GraphExecutorImplBase(graph, std::move(function_name)) {}
 
+const ProfilingGraphExecutorImpl::Specialization* ProfilingGraphExecutorImpl::
+    findSpecialization(const Stack& stack) const {
+  for (const Specialization& specialization : specializations_) {
+    if (matchesInputTypes(specialization.input_types, stack)) {
+      return &specialization;
+    }
+  }
+  return nullptr;
+}
+
 ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     Stack& stack,
     size_t remaining_bailout_depth) {
   std::lock_guard<std::mutex> lock(compile_mutex);
   GRAPH_DEBUG("Running ProfilingGraphExecutorImpl ", this);
 
-  if (optimized_plan_) {
+  if (const Specialization* specialization = findSpecialization(stack)) {
+    logging::getLogger()->addStatValue(
+        logging::runtime_counters::SPECIALIZED_PLAN_CACHE_HIT, 1.0);
+    optimized_plan_ = specialization->plan;
+    return *optimized_plan_;
+  }
+
+  if (!specializations_.empty() &&
+      specializations_.size() >= getNumSpecializations()) {
+    logging::getLogger()->addStatValue(
+        logging::runtime_counters::SPECIALIZED_PLAN_CACHE_FULL, 1.0);
+    optimized_plan_ = specializations_.front().plan;
     return *optimized_plan_;
   }
 
@@ -168,7 +241,10 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     auto copy = graph->copy();
     runProfilingInsensitiveOptimizations(copy);
     GRAPH_DUMP("Optimized SimpleExecutor Graph : ", copy);
-    optimized_plan_ = ExecutionPlan(copy, function_name_);
+    // matches any inputs
+    specializations_.push_back(Specialization{
+        std::vector<TypePtr>(), ExecutionPlan(copy, function_name_)});
+    optimized_plan_ = specializations_.back().plan;
     return *optimized_plan_;
   }
 
@@ -194,8 +270,15 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
   auto copy = pr_->graph()->copy();
   runProfilingOptimizations(copy);
   // cache
-  optimized_plan_ =
-      ExecutionPlan(copy, function_name_, remaining_bailout_depth);
+  logging::getLogger()->addStatValue(
+      logging::runtime_counters::SPECIALIZED_PLAN_CACHE_MISS, 1.0);
+  specializations_.push_back(Specialization{
+      guardedInputTypes(*copy),
+      ExecutionPlan(copy, function_name_, remaining_bailout_depth)});
+  // the next inputs none of the plans match start a new profiling round
+  retired_prs_.push_back(std::move(pr_));
+  profiling_plan_.reset();
+  optimized_plan_ = specializations_.back().plan;
   return *optimized_plan_;
 }
 
@@ -15,12 +15,28 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   ~ProfilingGraphExecutorImpl() override = default;
 
  private:
+  // An optimized plan along with the profiled types of the graph inputs its
+  // entry guards check. A null type matches any input.
+  struct Specialization {
+    std::vector<TypePtr> input_types;
+    ExecutionPlan plan;
+  };
+
   void runProfilingInsensitiveOptimizations(std::shared_ptr<Graph>& graph);
   void runProfilingOptimizations(std::shared_ptr<Graph>& graph);
+  const Specialization* findSpecialization(const Stack& stack) const;
   std::unique_ptr<ProfilingRecord> pr_;
+  // records of earlier profiling rounds, kept alive for the profiling plans
+  // other threads may still be running
+  std::vector<std::unique_ptr<ProfilingRecord>> retired_prs_;
   c10::optional<ExecutionPlan>
       profiling_plan_; // plan to run in order to profiling the code
-  c10::optional<ExecutionPlan> optimized_plan_;
+  // Inline cache of optimized plans, in the order they were created. Inputs
+  // matching none of them are profiled and get a plan of their own, until
+  // there are getNumSpecializations() plans; the first one then serves the
+  // rest, bailing out of its guards as needed.
+  std::vector<Specialization> specializations_;
+  c10::optional<ExecutionPlan> optimized_plan_; // the plan picked last
 };
 
 } // namespace jit
@@ -88,9 +88,10 @@ c10::SymbolicShape ProfilingRecord::mergeSymbolicShapes(
       *new_sizes.rank() == *sym_shapes.rank());
 
   for (size_t i = 0; i < *new_sizes.rank(); i++) {
-    if (!(*sym_shapes.sizes())[i].is_static() ||
-        !(*new_sizes.sizes())[i].is_static()) {
-      new_symbols.emplace_back();
+    // The dims that already vary are partitioned further, so that the dims
+    // sharing a symbol had the same size in all the runs
+    if (!(*new_sizes.sizes())[i].is_static()) {
+      new_symbols.emplace_back(c10::ShapeSymbol::newSymbol());
       continue;
     }
     auto symbol = (*sym_shapes.sizes())[i];
@@ -280,7 +281,7 @@ std::unique_ptr<ProfilingRecord> ProfilingRecord::instrumentGraph(
                   profiled_types_iter->first,
                   " into ",
                   *type);
-              merged_type = type->withSymbolicShapes(new_shape);
+              merged_type = merged_type->withSymbolicShapes(new_shape);
               GRAPH_DEBUG("Result : ", *merged_type);
               merged_profiled_types[val_type_pair.first] = merged_type;
             } else {
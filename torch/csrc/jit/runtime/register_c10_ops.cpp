@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/frontend/tracer.h>
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/runtime/operator.h>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace torch {
@@ -160,8 +161,142 @@ Operator createOperatorFromC10_withTracingHandledHere(
   });
 }
 
+// Stack-native operations of the most common ops.
+//
+// The boxed calling convention unboxes the arguments again in
+// make_boxed_from_unboxed_functor, through intermediate lists for the list
+// arguments. Instead, these take the arguments straight from the interpreter
+// stack (moving the tensors out, as they are dropped anyway) and call the
+// unboxed kernels. They must match the schemas of native_functions.yaml, and
+// the C++ signatures of the generated at:: functions.
+
+at::Tensor toOptionalTensor(IValue&& v) {
+  return v.isNone() ? at::Tensor() : std::move(v).toTensor();
+}
+
+Operation stackNativeAdd(const c10::OperatorHandle& op) {
+  // aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor
+  auto typed_op =
+      op.typed<at::Tensor(const at::Tensor&, const at::Tensor&, at::Scalar)>();
+  return [typed_op](Stack* stack) {
+    auto result = typed_op.call(
+        std::move(peek(stack, 0, 3)).toTensor(),
+        std::move(peek(stack, 1, 3)).toTensor(),
+        peek(stack, 2, 3).toScalar());
+    drop(stack, 3);
+    pack(stack, std::move(result));
+  };
+}
+
+Operation stackNativeMul(const c10::OperatorHandle& op) {
+  // aten::mul.Tensor(Tensor self, Tensor other) -> Tensor
+  auto typed_op = op.typed<at::Tensor(const at::Tensor&, const at::Tensor&)>();
+  return [typed_op](Stack* stack) {
+    auto result = typed_op.call(
+        std::move(peek(stack, 0, 2)).toTensor(),
+        std::move(peek(stack, 1, 2)).toTensor());
+    drop(stack, 2);
+    pack(stack, std::move(result));
+  };
+}
+
+Operation stackNativeRelu(const c10::OperatorHandle& op) {
+  // aten::relu(Tensor self) -> Tensor
+  auto typed_op = op.typed<at::Tensor(const at::Tensor&)>();
+  return [typed_op](Stack* stack) {
+    auto result = typed_op.call(std::move(peek(stack, 0, 1)).toTensor());
+    drop(stack, 1);
+    pack(stack, std::move(result));
+  };
+}
+
+Operation stackNativeLinear(const c10::OperatorHandle& op) {
+  // aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor
+  auto typed_op = op.typed<at::Tensor(
+      const at::Tensor&, const at::Tensor&, const at::Tensor&)>();
+  return [typed_op](Stack* stack) {
+    auto result = typed_op.call(
+        std::move(peek(stack, 0, 3)).toTensor(),
+        std::move(peek(stack, 1, 3)).toTensor(),
+        toOptionalTensor(std::move(peek(stack, 2, 3))));
+    drop(stack, 3);
+    pack(stack, std::move(result));
+  };
+}
+
+Operation stackNativeConv2d(const c10::OperatorHandle& op) {
+  // aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None,
+  //     int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1)
+  //     -> Tensor
+  auto typed_op = op.typed<at::Tensor(
+      const at::Tensor&,
+      const at::Tensor&,
+      const at::Tensor&,
+      at::IntArrayRef,
+      at::IntArrayRef,
+      at::IntArrayRef,
+      int64_t)>();
+  return [typed_op](Stack* stack) {
+    auto result = typed_op.call(
+        std::move(peek(stack, 0, 7)).toTensor(),
+        std::move(peek(stack, 1, 7)).toTensor(),
+        toOptionalTensor(std::move(peek(stack, 2, 7))),
+        peek(stack, 3, 7).toIntVector(),
+        peek(stack, 4, 7).toIntVector(),
+        peek(stack, 5, 7).toIntVector(),
+        peek(stack, 6, 7).toInt());
+    drop(stack, 7);
+    pack(stack, std::move(result));
+  };
+}
+
+Operation stackNativeCat(const c10::OperatorHandle& op) {
+  // aten::cat(Tensor[] tensors, int dim=0) -> Tensor
+  auto typed_op = op.typed<at::Tensor(at::TensorList, int64_t)>();
+  return [typed_op](Stack* stack) {
+    auto result = typed_op.call(
+        peek(stack, 0, 2).toTensorVector(), peek(stack, 1, 2).toInt());
+    drop(stack, 2);
+    pack(stack, std::move(result));
+  };
+}
+
+Operation stackNativeView(const c10::OperatorHandle& op) {
+  // aten::view(Tensor(a) self, int[] size) -> Tensor(a)
+  auto typed_op = op.typed<at::Tensor(const at::Tensor&, at::IntArrayRef)>();
+  return [typed_op](Stack* stack) {
+    auto result = typed_op.call(
+        std::move(peek(stack, 0, 2)).toTensor(),
+        peek(stack, 1, 2).toIntVector());
+    drop(stack, 2);
+    pack(stack, std::move(result));
+  };
+}
+
+c10::optional<Operation> createStackNativeOperation(
+    const c10::OperatorHandle& op) {
+  using Creator = Operation (*)(const c10::OperatorHandle&);
+  static const std::unordered_map<c10::OperatorName, Creator> creators = {
+      {{"aten::add", "Tensor"}, stackNativeAdd},
+      {{"aten::mul", "Tensor"}, stackNativeMul},
+      {{"aten::relu", ""}, stackNativeRelu},
+      {{"aten::linear", ""}, stackNativeLinear},
+      {{"aten::conv2d", ""}, stackNativeConv2d},
+      {{"aten::cat", ""}, stackNativeCat},
+      {{"aten::view", ""}, stackNativeView},
+  };
+  auto it = creators.find(op.operator_name());
+  if (it == creators.end()) {
+    return c10::nullopt;
+  }
+  return it->second(op);
+}
+
 Operator createOperatorFromC10_withTracingNotHandledHere(
     const c10::OperatorHandle& op) {
+  if (auto operation = createStackNativeOperation(op)) {
+    return Operator(op, std::move(*operation));
+  }
   return Operator(op, [op](Stack* stack) { op.callBoxed(stack); });
 }
 
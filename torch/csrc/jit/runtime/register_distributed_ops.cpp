@@ -1,11 +1,16 @@
 #include <ATen/ATen.h>
 #include <ATen/core/op_registration/op_registration.h>
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
 #include <torch/csrc/distributed/autograd/autograd.h>
 #include <torch/csrc/distributed/autograd/context/container.h>
 #include <torch/csrc/distributed/autograd/engine/dist_engine.h>
+#include <torch/csrc/distributed/rpc/pipeline_executor.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 #include <torch/csrc/distributed/rpc/rref_impl.h>
 #include <torch/csrc/distributed/rpc/torchscript_functions.h>
+#include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <torch/csrc/jit/runtime/register_ops_utils.h>
 #include <torch/library.h>
@@ -90,6 +95,45 @@ RegisterOperators reg_rpc_ops(
            push(stack, rref->confirmedByOwner());
          },
          aliasAnalysisFromSchema()),
+     Operator(
+         dist_rpc::kPipelineStageForwardSchema,
+         [](Stack* stack) {
+           auto input = pop(stack).toTensor();
+           auto rref = pop(stack).toRRef();
+           TORCH_CHECK(
+               rref->isOwner(),
+               "Pipeline stages can only run on the owner of their module.");
+           Module module(
+               c10::static_intrusive_pointer_cast<dist_rpc::OwnerRRef>(rref)
+                   ->getValue()
+                   .toObject());
+           auto params = module.parameters();
+           if (params.size() == 0 || (*params.begin()).device().is_cpu()) {
+             push(stack, module.forward({input}));
+             return;
+           }
+           // Every micro-batch runs on its own stream, so that the copies and
+           // kernels of the ones in flight on the same stage can overlap.
+           auto device = (*params.begin()).device();
+           c10::impl::VirtualGuardImpl impl(device.type());
+           auto callerStream = impl.getStream(device);
+           auto stageStream = impl.getStreamFromGlobalPool(device);
+           c10::Event inputReady(device.type());
+           inputReady.record(callerStream);
+           inputReady.block(stageStream);
+           at::Tensor output;
+           {
+             c10::StreamGuard streamGuard(stageStream);
+             output = module.forward({input.to(device, /*non_blocking=*/true)})
+                          .toTensor()
+                          .to(input.device());
+           }
+           c10::Event outputReady(device.type());
+           outputReady.record(stageStream);
+           outputReady.block(callerStream);
+           push(stack, std::move(output));
+         },
+         aliasAnalysisFromSchema()),
      Operator(
          "aten::dist_backward(int context_id, Tensor[] roots, bool retain_graph=False) -> ()",
          [](Stack* stack) {
@@ -0,0 +1,447 @@
+#include <torch/csrc/jit/runtime/static_runtime.h>
+
+#include <ATen/ATen.h>
+#include <ATen/core/grad_mode.h>
+#include <c10/core/CPUAllocator.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/passes/liveness.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Offsets in the arena are aligned to a cache line
+constexpr size_t kArenaAlignment = 64;
+
+const at::Tensor& tensorAt(
+    const std::vector<IValue>& values,
+    const std::vector<size_t>& inputs,
+    size_t i) {
+  return values[inputs[i]].toTensor();
+}
+
+at::Scalar scalarAt(
+    const std::vector<IValue>& values,
+    const std::vector<size_t>& inputs,
+    size_t i) {
+  return values[inputs[i]].toScalar();
+}
+
+using OutVariantFn = void (*)(
+    const std::vector<IValue>&,
+    const std::vector<size_t>&,
+    at::Tensor&);
+
+// Ops that StaticRuntime runs into preallocated outputs. The out variants
+// resize `out` when its shape doesn't match, which can't happen with the
+// shapes of the memory plan.
+const std::vector<std::pair<const char*, OutVariantFn>>& outVariants() {
+  static const std::vector<std::pair<const char*, OutVariantFn>> variants = {
+      {"aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::add_out(out, tensorAt(v, in, 0), tensorAt(v, in, 1), scalarAt(v, in, 2));
+       }},
+      {"aten::sub.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::sub_out(out, tensorAt(v, in, 0), tensorAt(v, in, 1), scalarAt(v, in, 2));
+       }},
+      {"aten::mul.Tensor(Tensor self, Tensor other) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::mul_out(out, tensorAt(v, in, 0), tensorAt(v, in, 1));
+       }},
+      {"aten::div.Tensor(Tensor self, Tensor other) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::div_out(out, tensorAt(v, in, 0), tensorAt(v, in, 1));
+       }},
+      {"aten::mm(Tensor self, Tensor mat2) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::mm_out(out, tensorAt(v, in, 0), tensorAt(v, in, 1));
+       }},
+      {"aten::bmm(Tensor self, Tensor mat2) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::bmm_out(out, tensorAt(v, in, 0), tensorAt(v, in, 1));
+       }},
+      {"aten::matmul(Tensor self, Tensor other) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::matmul_out(out, tensorAt(v, in, 0), tensorAt(v, in, 1));
+       }},
+      {"aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::addmm_out(
+             out,
+             tensorAt(v, in, 0),
+             tensorAt(v, in, 1),
+             tensorAt(v, in, 2),
+             scalarAt(v, in, 3),
+             scalarAt(v, in, 4));
+       }},
+      {"aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::matmul_out(out, tensorAt(v, in, 0), tensorAt(v, in, 1).t());
+         const auto& bias = v[in[2]];
+         if (!bias.isNone()) {
+           out.add_(bias.toTensor());
+         }
+       }},
+      {"aten::relu(Tensor self) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::threshold_out(out, tensorAt(v, in, 0), 0, 0);
+       }},
+      {"aten::sigmoid(Tensor self) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) { at::sigmoid_out(out, tensorAt(v, in, 0)); }},
+      {"aten::tanh(Tensor self) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) { at::tanh_out(out, tensorAt(v, in, 0)); }},
+      {"aten::cat(Tensor[] tensors, int dim=0) -> Tensor",
+       [](const std::vector<IValue>& v,
+          const std::vector<size_t>& in,
+          at::Tensor& out) {
+         at::cat_out(out, v[in[0]].toTensorVector(), v[in[1]].toInt());
+       }},
+  };
+  return variants;
+}
+
+OutVariantFn getOutVariant(Node* node) {
+  for (const auto& entry : outVariants()) {
+    if (node->matches(entry.first)) {
+      return entry.second;
+    }
+  }
+  return nullptr;
+}
+
+// Bytes spanned by a strided tensor, rounded up to the arena alignment
+size_t alignedNbytes(
+    at::IntArrayRef sizes,
+    at::IntArrayRef strides,
+    size_t itemsize) {
+  size_t span = 1;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (sizes[i] == 0) {
+      return 0;
+    }
+    span += (sizes[i] - 1) * strides[i];
+  }
+  size_t nbytes = span * itemsize;
+  return (nbytes + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+}
+
+} // namespace
+
+StaticRuntime::StaticRuntime(const Module& module) {
+  graph_ = module.get_method("forward").graph()->copy();
+  Inline(*graph_);
+  TORCH_CHECK(
+      !graph_->inputs().at(0)->hasUses(),
+      "StaticRuntime expects a frozen module, where forward doesn't use self "
+      "(see torch.jit.freeze)");
+  graph_->eraseInput(0);
+  processGraph();
+}
+
+StaticRuntime::StaticRuntime(std::shared_ptr<Graph> graph)
+    : graph_(graph->copy()) {
+  Inline(*graph_);
+  processGraph();
+}
+
+void StaticRuntime::processGraph() {
+  ConstantPropagation(graph_);
+
+  for (Value* input : graph_->inputs()) {
+    TORCH_CHECK(
+        input->type()->isSubtypeOf(TensorType::get()),
+        "StaticRuntime only supports tensor inputs, got ",
+        input->type()->str(),
+        " for input ",
+        input->debugName());
+  }
+
+  std::unordered_map<Value*, size_t> value_indices;
+  auto indexOf = [&](Value* v) {
+    auto it = value_indices.find(v);
+    if (it != value_indices.end()) {
+      return it->second;
+    }
+    value_indices.emplace(v, values_.size());
+    values_.emplace_back();
+    is_constant_.push_back(false);
+    return values_.size() - 1;
+  };
+
+  for (Value* input : graph_->inputs()) {
+    input_indices_.push_back(indexOf(input));
+  }
+
+  std::unordered_map<Node*, size_t> node_indices;
+  for (Node* node : graph_->nodes()) {
+    TORCH_CHECK(
+        node->blocks().empty(),
+        "StaticRuntime doesn't support control flow, found ",
+        node->kind().toQualString());
+    if (node->kind() == prim::Constant) {
+      size_t index = indexOf(node->output());
+      values_[index] = *toIValue(node->output());
+      is_constant_[index] = true;
+      continue;
+    }
+    ProcessedNode pnode;
+    pnode.node = node;
+    pnode.op = node->getOperation();
+    for (Value* input : node->inputs()) {
+      pnode.inputs.push_back(indexOf(input));
+    }
+    for (Value* output : node->outputs()) {
+      pnode.outputs.push_back(indexOf(output));
+    }
+    if (node->outputs().size() == 1 &&
+        node->output()->type()->isSubtypeOf(TensorType::get())) {
+      pnode.out_variant = getOutVariant(node);
+    }
+    node_indices.emplace(node, nodes_.size());
+    nodes_.push_back(std::move(pnode));
+  }
+
+  for (Value* output : graph_->outputs()) {
+    output_indices_.push_back(indexOf(output));
+  }
+
+  // A value is live from the node defining it up to the last node it is live
+  // at, which is also the last node using it.
+  std::unordered_map<Value*, size_t> last_use;
+  for (const auto& entry : BuildLivenessSets(graph_)) {
+    auto it = node_indices.find(entry.first);
+    if (it == node_indices.end()) {
+      continue;
+    }
+    for (Value* v : entry.second) {
+      auto& end = last_use[v];
+      end = std::max(end, it->second);
+    }
+  }
+
+  // The memory of a planned tensor may only be reused once all the values
+  // that may alias it are dead as well.
+  AliasDb alias_db(graph_);
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    auto& pnode = nodes_[i];
+    if (!pnode.out_variant) {
+      continue;
+    }
+    Value* v = pnode.node->output();
+    if (alias_db.mayContainAlias({v}, graph_->outputs())) {
+      continue;
+    }
+    pnode.plannable = true;
+    pnode.lifetime_end = std::max(i, last_use[v]);
+    for (size_t j = i + 1; j < nodes_.size(); ++j) {
+      for (Value* u : nodes_[j].node->outputs()) {
+        if (alias_db.mayContainAlias(v, u)) {
+          pnode.lifetime_end = std::max(pnode.lifetime_end, last_use[u]);
+        }
+      }
+    }
+  }
+}
+
+bool StaticRuntime::matchesPlan(const std::vector<IValue>& inputs) const {
+  if (!planned_) {
+    return false;
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& t = inputs[i].toTensor();
+    if (t.scalar_type() != planned_input_dtypes_[i] ||
+        t.sizes() != at::IntArrayRef(planned_inputs_[i].first) ||
+        t.strides() != at::IntArrayRef(planned_inputs_[i].second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void StaticRuntime::plan(const std::vector<IValue>& inputs) {
+  planned_values_.clear();
+  for (auto& pnode : nodes_) {
+    pnode.planned_output.reset();
+  }
+
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    const auto& pnode = nodes_[i];
+    if (!pnode.plannable) {
+      continue;
+    }
+    const auto& value = values_[pnode.outputs[0]];
+    if (!value.isTensor()) {
+      continue;
+    }
+    const auto& t = value.toTensor();
+    if (!t.defined() || !t.device().is_cpu() ||
+        t.layout() != c10::kStrided) {
+      continue;
+    }
+    PlannedValue planned;
+    planned.node_index = i;
+    planned.begin = i;
+    planned.end = pnode.lifetime_end;
+    planned.sizes = t.sizes().vec();
+    planned.strides = t.strides().vec();
+    planned.dtype = t.scalar_type();
+    planned.nbytes = alignedNbytes(t.sizes(), t.strides(), t.itemsize());
+    planned.offset = 0;
+    planned_values_.push_back(std::move(planned));
+  }
+
+  // Greedy by size: the largest tensors go first, each at the lowest offset
+  // that doesn't overlap the tensors already placed and alive at the same
+  // time.
+  std::vector<PlannedValue*> order;
+  for (auto& planned : planned_values_) {
+    order.push_back(&planned);
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [](PlannedValue* a, PlannedValue* b) {
+        return a->nbytes > b->nbytes;
+      });
+  size_t arena_bytes = 0;
+  std::vector<PlannedValue*> placed;
+  for (PlannedValue* planned : order) {
+    std::vector<PlannedValue*> conflicts;
+    for (PlannedValue* other : placed) {
+      if (other->begin <= planned->end && planned->begin <= other->end) {
+        conflicts.push_back(other);
+      }
+    }
+    std::sort(
+        conflicts.begin(),
+        conflicts.end(),
+        [](PlannedValue* a, PlannedValue* b) { return a->offset < b->offset; });
+    size_t offset = 0;
+    for (PlannedValue* other : conflicts) {
+      if (offset + planned->nbytes <= other->offset) {
+        break;
+      }
+      offset = std::max(offset, other->offset + other->nbytes);
+    }
+    planned->offset = offset;
+    arena_bytes = std::max(arena_bytes, offset + planned->nbytes);
+    placed.push_back(planned);
+  }
+
+  // Not resizable, so that an out variant can't silently move a tensor out of
+  // the arena
+  arena_ = at::Storage(
+      at::Storage::use_byte_size_t(),
+      arena_bytes,
+      c10::GetCPUAllocator(),
+      /*resizable=*/false);
+  for (const auto& planned : planned_values_) {
+    auto t = at::empty({0}, at::dtype(planned.dtype));
+    t.set_(
+        arena_,
+        planned.offset / t.itemsize(),
+        planned.sizes,
+        planned.strides);
+    nodes_[planned.node_index].planned_output = std::move(t);
+  }
+
+  planned_inputs_.clear();
+  planned_input_dtypes_.clear();
+  for (const auto& input : inputs) {
+    const auto& t = input.toTensor();
+    planned_inputs_.emplace_back(t.sizes().vec(), t.strides().vec());
+    planned_input_dtypes_.push_back(t.scalar_type());
+  }
+  planned_ = true;
+}
+
+std::vector<IValue> StaticRuntime::run(std::vector<IValue> inputs) {
+  TORCH_CHECK(
+      inputs.size() == input_indices_.size(),
+      "Expected ",
+      input_indices_.size(),
+      " inputs, got ",
+      inputs.size());
+  for (const auto& input : inputs) {
+    TORCH_CHECK(input.isTensor(), "StaticRuntime only supports tensor inputs");
+  }
+  at::NoGradGuard no_grad;
+
+  const bool use_plan = matchesPlan(inputs);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    values_[input_indices_[i]] = inputs[i];
+  }
+
+  Stack stack;
+  for (auto& pnode : nodes_) {
+    if (use_plan && pnode.planned_output) {
+      pnode.out_variant(values_, pnode.inputs, *pnode.planned_output);
+      values_[pnode.outputs[0]] = *pnode.planned_output;
+      continue;
+    }
+    for (size_t i : pnode.inputs) {
+      stack.emplace_back(values_[i]);
+    }
+    pnode.op(&stack);
+    for (size_t i = pnode.outputs.size(); i-- > 0;) {
+      values_[pnode.outputs[i]] = pop(stack);
+    }
+  }
+
+  std::vector<IValue> outputs;
+  outputs.reserve(output_indices_.size());
+  for (size_t i : output_indices_) {
+    outputs.push_back(values_[i]);
+  }
+
+  // The shapes of this run are those of the next runs with the same inputs
+  if (!use_plan) {
+    plan(inputs);
+  }
+  for (size_t i = 0; i < values_.size(); ++i) {
+    if (!is_constant_[i]) {
+      values_[i] = IValue();
+    }
+  }
+  return outputs;
+}
+
+size_t StaticRuntime::arenaBytes() const {
+  return arena_ ? arena_.nbytes() : 0;
+}
+
+size_t StaticRuntime::numPlannedValues() const {
+  return planned_values_.size();
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <ATen/core/stack.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// Runs the forward method of a frozen module (see freeze_module.h) with
+// static input shapes, for inference on CPU.
+//
+// The graph is inlined and constant propagated, and must not have any control
+// flow left. The first run, and any run with new input shapes, executes the
+// nodes as the interpreter would and records the shapes of the intermediate
+// tensors. The outputs of the ops that have an out variant (see
+// static_runtime.cpp) are then laid out in a single arena: tensors whose
+// lifetimes, given by passes/liveness.h and extended to their aliases, don't
+// overlap share the same bytes. The next runs call the out variants on
+// tensors preallocated in the arena, so that no intermediate tensor goes
+// through the allocator as long as the input shapes don't change.
+//
+// Graph outputs and the values that may alias them are never planned, since
+// they outlive the run.
+//
+// A StaticRuntime is not thread safe: use one per thread.
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(const Module& module);
+  explicit StaticRuntime(std::shared_ptr<Graph> graph);
+
+  std::vector<IValue> run(std::vector<IValue> inputs);
+
+  const std::shared_ptr<Graph>& graph() const {
+    return graph_;
+  }
+
+  // Size of the arena in bytes, 0 before the first run
+  size_t arenaBytes() const;
+  // Number of intermediate tensors living in the arena
+  size_t numPlannedValues() const;
+
+ private:
+  // Kernel writing the output of a node into a preallocated tensor
+  using OutVariant = void (*)(
+      const std::vector<IValue>& values,
+      const std::vector<size_t>& inputs,
+      at::Tensor& out);
+
+  struct ProcessedNode {
+    Node* node;
+    Operation op;
+    // Out variant, if the node has a single tensor output
+    OutVariant out_variant = nullptr;
+    std::vector<size_t> inputs;
+    std::vector<size_t> outputs;
+    // Whether the output may be planned, and the index of the last node
+    // using it or one of its aliases
+    bool plannable = false;
+    size_t lifetime_end = 0;
+    // Tensor preallocated in the arena for the output, if planned
+    c10::optional<at::Tensor> planned_output;
+  };
+
+  struct PlannedValue {
+    size_t node_index;
+    size_t begin;
+    size_t end;
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    at::ScalarType dtype;
+    size_t nbytes;
+    size_t offset;
+  };
+
+  void processGraph();
+  bool matchesPlan(const std::vector<IValue>& inputs) const;
+  void plan(const std::vector<IValue>& inputs);
+
+  std::shared_ptr<Graph> graph_;
+  std::vector<ProcessedNode> nodes_;
+  // Values of the graph, indexed by the ProcessedNodes. Constants are
+  // loaded once, the rest only lives during a run.
+  std::vector<IValue> values_;
+  std::vector<size_t> input_indices_;
+  std::vector<size_t> output_indices_;
+  std::vector<bool> is_constant_;
+
+  // Memory plan, valid for the input shapes in planned_inputs_
+  bool planned_ = false;
+  std::vector<std::pair<std::vector<int64_t>, std::vector<int64_t>>>
+      planned_inputs_;
+  std::vector<at::ScalarType> planned_input_dtypes_;
+  std::vector<PlannedValue> planned_values_;
+  at::Storage arena_;
+};
+
+} // namespace jit
+} // namespace torch
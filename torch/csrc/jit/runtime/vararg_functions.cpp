@@ -51,6 +51,30 @@ void listUnpack(Stack& stack, size_t num_outputs) {
 }
 
 void tupleConstruct(Stack& stack, size_t num_inputs) {
+  // Tuples of up to 3 elements keep them inline, without a vector.
+  switch (num_inputs) {
+    case 1:
+      stack.back() = c10::ivalue::Tuple::create(std::move(stack.back()));
+      return;
+    case 2: {
+      auto tuple = c10::ivalue::Tuple::create(
+          std::move(stack[stack.size() - 2]), std::move(stack.back()));
+      stack.pop_back();
+      stack.back() = std::move(tuple);
+      return;
+    }
+    case 3: {
+      auto tuple = c10::ivalue::Tuple::create(
+          std::move(stack[stack.size() - 3]),
+          std::move(stack[stack.size() - 2]),
+          std::move(stack.back()));
+      drop(stack, 2);
+      stack.back() = std::move(tuple);
+      return;
+    }
+    default:
+      break;
+  }
   std::vector<IValue> elems{std::make_move_iterator(stack.end() - num_inputs),
                             std::make_move_iterator(stack.end())};
   drop(stack, num_inputs);
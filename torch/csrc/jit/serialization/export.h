@@ -53,23 +53,28 @@ TORCH_API std::string pretty_print_onnx(
     const std::map<std::string, int>& custom_opsets = {},
     bool add_node_names = true);
 
+// With compress_records, the records of the archive are deflated, see
+// PyTorchStreamWriter::setCompressRecords.
 TORCH_API void ExportModule(
     const Module& module,
     std::ostream& out,
     const ExtraFilesMap& metadata = ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    bool compress_records = false);
 
 TORCH_API void ExportModule(
     const Module& module,
     const std::string& filename,
     const ExtraFilesMap& metadata = ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    bool compress_records = false);
 
 TORCH_API void ExportModule(
     const Module& module,
     const std::function<size_t(const void*, size_t)>& writer_func,
     const ExtraFilesMap& metadata = ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    bool compress_records = false);
 
 // Write the bytes of a pickle archive and the tensors referenced inside that
 // archive
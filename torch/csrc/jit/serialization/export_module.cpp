@@ -18,6 +18,7 @@
 #include <ATen/core/jit_type.h>
 #include <ATen/core/qualified_name.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace torch {
@@ -44,21 +45,116 @@ static IValue Table(
   return Tup(std::move(ivalue_entries));
 }
 
+// Maximum depth of the operand stack while running instructions, so that the
+// lite interpreter can reserve it up front. The depth at each instruction is
+// the same on all the paths reaching it, so each one is visited once.
+// Methods called through INTERFACE_CALL grow the stack further on their own.
+size_t maxStackSize(
+    const std::vector<Instruction>& instructions,
+    const std::vector<Node*>& sources,
+    size_t num_inputs) {
+  std::vector<int64_t> depths(instructions.size(), -1);
+  // The method starts with its inputs on the stack
+  std::vector<std::pair<size_t, int64_t>> to_visit = {{0, num_inputs}};
+  int64_t max_depth = num_inputs;
+  while (!to_visit.empty()) {
+    size_t pc;
+    int64_t depth;
+    std::tie(pc, depth) = to_visit.back();
+    to_visit.pop_back();
+    if (pc >= instructions.size() || depths[pc] >= 0) {
+      continue;
+    }
+    depths[pc] = depth;
+    const Instruction& ins = instructions[pc];
+    size_t next = pc + 1;
+    switch (ins.op) {
+      case OP:
+      case OPN:
+      case INTERFACE_CALL: {
+        const Node* node = sources[pc];
+        // OPN pushes the number of inputs before calling the operator
+        max_depth = std::max<int64_t>(max_depth, depth + (ins.op == OPN));
+        depth += static_cast<int64_t>(node->outputs().size()) -
+            static_cast<int64_t>(node->inputs().size());
+      } break;
+      case LOAD:
+      case MOVE:
+      case LOADC:
+        ++depth;
+        break;
+      case STORE:
+      case DROP:
+        --depth;
+        break;
+      case STOREN:
+        depth -= ins.N;
+        break;
+      case SET_ATTR:
+      case WARN:
+        depth -= 2;
+        break;
+      case LIST_UNPACK:
+        depth += ins.X - 1;
+        break;
+      case TUPLE_CONSTRUCT:
+        depth -= ins.X - 1;
+        break;
+      case LIST_CONSTRUCT:
+      case DICT_CONSTRUCT:
+      case NAMED_TUPLE_CONSTRUCT:
+        depth -= ins.N - 1;
+        break;
+      case JF:
+        --depth;
+        to_visit.emplace_back(pc + ins.X, depth);
+        break;
+      case JMP:
+        next = pc + ins.X;
+        break;
+      case LOOP:
+        // Leaving the loop drops the iteration count, max and condition
+        to_visit.emplace_back(pc + ins.X, depth - 3);
+        break;
+      case RET:
+        next = instructions.size();
+        break;
+      default:
+        // DROPR, GET_ATTR and TUPLE_SLICE leave the depth unchanged
+        break;
+    }
+    max_depth = std::max(max_depth, depth);
+    to_visit.emplace_back(next, depth);
+  }
+  return max_depth;
+}
+
 c10::IValue getFunctionTuple(const Function& func) {
   auto graph = func.graph()->copy();
   Inline(*graph);
-  torch::jit::Code code(graph, func.name());
+  torch::jit::Code code(
+      graph,
+      func.name(),
+      /*remaining_bailout_depth=*/0,
+      /*emit_register_ops=*/false);
 
   auto instructions_copy = code.instructions();
 
-  // operator names
+  // operator names, each one is written once and the instructions calling it
+  // share its index, so that the lite interpreter resolves it once
   std::vector<c10::OperatorName> opnames;
+  std::unordered_map<c10::OperatorName, int32_t> opname_indices;
   std::vector<std::string> method_names;
   for (size_t i = 0; i < instructions_copy.size(); ++i) {
     Instruction ins = instructions_copy[i];
     if (ins.op == OP || ins.op == OPN) {
       auto node = code.instructions_source()[i];
-      opnames.emplace_back(node->schema().operator_name());
+      auto opname = node->schema().operator_name();
+      auto index = opname_indices.emplace(opname, opnames.size());
+      if (index.second) {
+        opnames.emplace_back(std::move(opname));
+      }
+      instructions_copy[i].X = index.first->second;
     }
     // CALL nodes at this point represent built-in (i.e. non-Graph)
     // functions that were not inlined. Here we convert the CALL
@@ -126,12 +222,19 @@ c10::IValue getFunctionTuple(const Function& func) {
   // since the register location is embedded into the bytecode, pass the
   // register size
   auto register_size = static_cast<int>(code.register_size());
+  // and the stack size, so that no frame grows while running the method
+  auto stack_size = static_cast<int>(
+      maxStackSize(
+          instructions_copy,
+          code.instructions_source(),
+          graph->inputs().size()));
 
   auto table = Table({{"instructions", Tup(instructions)},
                       {"operators", Tup(operators)},
                       {"constants", Tup(constants)},
                       {"types", Tup(types)},
-                      {"register_size", register_size}});
+                      {"register_size", register_size},
+                      {"stack_size", stack_size}});
 
   return Tup({func.qualname().qualifiedName(), table});
 }
@@ -183,8 +286,10 @@ class ScriptModuleSerializer {
   void serialize(
       const Module& module,
       const ExtraFilesMap& extra_files,
-      bool bytecode_format) {
+      bool bytecode_format,
+      bool compress_records = false) {
     C10_LOG_API_USAGE_ONCE("torch.script.save");
+    writer_.setCompressRecords(compress_records);
     writeExtraFiles(module, extra_files);
     // Serialize the model object
     writeArchive("data", module._ivalue());
@@ -356,31 +461,34 @@ void ExportModule(
     const Module& module,
     std::ostream& out,
     const ExtraFilesMap& extra_files,
-    bool bytecode_format) {
+    bool bytecode_format,
+    bool compress_records) {
   ScriptModuleSerializer serializer(
       [&](const void* buf, size_t nbytes) -> size_t {
         out.write(static_cast<const char*>(buf), nbytes);
         return !out ? 0 : nbytes;
       });
-  serializer.serialize(module, extra_files, bytecode_format);
+  serializer.serialize(module, extra_files, bytecode_format, compress_records);
 }
 
 void ExportModule(
     const Module& module,
     const std::string& filename,
     const ExtraFilesMap& extra_files,
-    bool bytecode_format) {
+    bool bytecode_format,
+    bool compress_records) {
   ScriptModuleSerializer serializer(filename);
-  serializer.serialize(module, extra_files, bytecode_format);
+  serializer.serialize(module, extra_files, bytecode_format, compress_records);
 }
 
 void ExportModule(
     const Module& module,
     const std::function<size_t(const void*, size_t)>& writer_func,
     const ExtraFilesMap& extra_files,
-    bool bytecode_format) {
+    bool bytecode_format,
+    bool compress_records) {
   ScriptModuleSerializer serializer(writer_func);
-  serializer.serialize(module, extra_files, bytecode_format);
+  serializer.serialize(module, extra_files, bytecode_format, compress_records);
 }
 
 namespace {
@@ -18,8 +18,10 @@
 #include <caffe2/serialize/istream_adapter.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <unordered_map>
@@ -55,6 +57,82 @@ void postSetStateValidate(const IValue& v) {
   }
 }
 
+namespace {
+
+// Reads the tensor records of an archive ahead of the unpickler, in parallel
+// on the inter-op threads. They are read in the order they were written, in
+// batches of about kBatchBytes so that the records of tensors moved to
+// another device don't all stay in memory.
+class RecordPrefetcher {
+ public:
+  RecordPrefetcher(PyTorchStreamReader& reader, const std::string& prefix)
+      : reader_(reader) {
+    for (const auto& record : reader_.getAllRecords()) {
+      // Records are named archive_name/path
+      auto name = record.substr(record.find('/') + 1);
+      if (name.compare(0, prefix.size(), prefix) == 0) {
+        names_.push_back(std::move(name));
+      }
+    }
+    // The records are numbered by the pickler
+    std::sort(
+        names_.begin(),
+        names_.end(),
+        [](const std::string& a, const std::string& b) {
+          return a.size() != b.size() ? a.size() < b.size() : a < b;
+        });
+    for (size_t i = 0; i < names_.size(); ++i) {
+      positions_[names_[i]] = i;
+    }
+  }
+
+  at::DataPtr getRecord(const std::string& name) {
+    auto it = records_.find(name);
+    if (it == records_.end()) {
+      prefetch(name);
+      it = records_.find(name);
+    }
+    if (it == records_.end()) {
+      return std::get<0>(reader_.getRecord(name));
+    }
+    auto data = std::move(it->second);
+    records_.erase(it);
+    return data;
+  }
+
+ private:
+  static constexpr size_t kBatchBytes = 64 << 20;
+
+  void prefetch(const std::string& name) {
+    auto it = positions_.find(name);
+    if (it == positions_.end()) {
+      return;
+    }
+    std::vector<std::string> batch;
+    size_t bytes = 0;
+    for (size_t i = it->second; i < names_.size() && bytes < kBatchBytes;
+         ++i) {
+      if (!positions_.erase(names_[i])) {
+        continue;
+      }
+      bytes += reader_.getRecordSize(names_[i]);
+      batch.push_back(names_[i]);
+    }
+    auto records = reader_.getRecords(batch, at::get_num_interop_threads());
+    for (size_t i = 0; i < batch.size(); ++i) {
+      records_[batch[i]] = std::move(std::get<0>(records[i]));
+    }
+  }
+
+  PyTorchStreamReader& reader_;
+  std::vector<std::string> names_;
+  // Positions in names_ of the records not read yet
+  std::unordered_map<std::string, size_t> positions_;
+  std::unordered_map<std::string, at::DataPtr> records_;
+};
+
+} // namespace
+
 IValue readArchiveAndTensors(
     const std::string& archive_name,
     c10::optional<TypeResolver> type_resolver,
@@ -81,9 +159,10 @@ IValue readArchiveAndTensors(
   };
 
   std::string archive_name_plus_slash = archive_name + "/";
+  RecordPrefetcher prefetcher(stream_reader, archive_name_plus_slash);
   auto read_record = [&](const std::string& name) {
     std::string ss = archive_name_plus_slash + name;
-    return std::get<0>(stream_reader.getRecord(ss));
+    return prefetcher.getRecord(ss);
   };
 
   Unpickler unpickler(
@@ -96,8 +175,36 @@ IValue readArchiveAndTensors(
   return unpickler.parse_ivalue();
 }
 
+static bool lazy_method_compilation_enabled_ = false;
+void setLazyMethodCompilationEnabled(bool enabled) {
+  lazy_method_compilation_enabled_ = enabled;
+}
+
+bool lazyMethodCompilationEnabled() {
+  return lazy_method_compilation_enabled_;
+}
+
 namespace {
 
+// What the methods compiled on first use still need from the archive once
+// load() returned: the constants and the code of the types they refer to.
+struct ImportedArchive {
+  std::shared_ptr<Source> findSource(const std::string& qualifier) const {
+    if (reader) {
+      return findSourceInArchiveFromQualifier(*reader, export_prefix, qualifier);
+    }
+    auto it = sources.find(qualifier);
+    return it != sources.end() ? it->second : nullptr;
+  }
+
+  std::vector<at::IValue> constants;
+  // Reads the code while the archive is open
+  PyTorchStreamReader* reader = nullptr;
+  std::string export_prefix = "code/";
+  // Code read before the archive was closed, by qualifier
+  std::unordered_map<std::string, std::shared_ptr<Source>> sources;
+};
+
 // This is a deserializer class which loads script modules from pt files.
 // Content of the file is written using PyTorchStreamWriter, for details please
 // check caffe2/serialize/inline_container.h.
@@ -110,14 +217,22 @@ class ScriptModuleDeserializer final {
       std::unique_ptr<PyTorchStreamReader> reader)
       : compilation_unit_(cu),
         reader_(std::move(reader)),
+        lazy_methods_(lazyMethodCompilationEnabled()),
+        archive_(std::make_shared<ImportedArchive>()),
         source_importer_(
             compilation_unit_,
-            &constants_table_,
-            [this](const std::string& qualifier) {
-              return findSourceInArchiveFromQualifier(
-                  *reader_, export_prefix_, qualifier);
+            &archive_->constants,
+            [archive = archive_](const std::string& qualifier) {
+              return archive->findSource(qualifier);
             },
-            reader_->version()) {}
+            reader_->version(),
+            lazy_methods_) {
+    archive_->reader = reader_.get();
+  }
+
+  ~ScriptModuleDeserializer() {
+    archive_->reader = nullptr;
+  }
 
   Module deserialize(
       c10::optional<at::Device> device,
@@ -125,13 +240,15 @@ class ScriptModuleDeserializer final {
 
  private:
   IValue readArchive(const std::string& archive_name);
+  void readAllSources();
+  bool hasQuantizedConv() const;
 
   std::shared_ptr<CompilationUnit> compilation_unit_;
   std::unique_ptr<PyTorchStreamReader> reader_;
   c10::optional<at::Device> device_;
-  std::vector<at::IValue> constants_table_;
+  bool lazy_methods_;
+  std::shared_ptr<ImportedArchive> archive_;
   SourceImporter source_importer_;
-  std::string export_prefix_ = "code/";
 };
 
 IValue ScriptModuleDeserializer::readArchive(const std::string& archive_name) {
@@ -179,6 +296,36 @@ IValue ScriptModuleDeserializer::readArchive(const std::string& archive_name) {
       archive_name, type_resolver, obj_loader, device_, *reader_.get());
 }
 
+void ScriptModuleDeserializer::readAllSources() {
+  const auto& prefix = archive_->export_prefix;
+  const std::string suffix = ".py";
+  for (const auto& record : reader_->getAllRecords()) {
+    // Records are named archive_name/path
+    auto path = record.substr(record.find('/') + 1);
+    if (path.compare(0, prefix.size(), prefix) != 0 ||
+        path.size() < prefix.size() + suffix.size() ||
+        path.compare(path.size() - suffix.size(), suffix.size(), suffix) !=
+            0) {
+      continue;
+    }
+    auto qualifier = path.substr(
+        prefix.size(), path.size() - prefix.size() - suffix.size());
+    std::replace(qualifier.begin(), qualifier.end(), '/', '.');
+    archive_->sources.emplace(
+        qualifier, findSourceInArchiveFromQualifier(*reader_, prefix, qualifier));
+  }
+}
+
+bool ScriptModuleDeserializer::hasQuantizedConv() const {
+  for (const auto& source : archive_->sources) {
+    if (source.second->text().find("ops.quantized.conv") !=
+        std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void rewriteQuantizedConvForBC(const Module& module) {
   const std::string& old_quantized_conv2d = R"(
 graph(%x, %packed_params, %stride, %padding, %dilation, %groups, %r_scale, %r_zero_point):
@@ -264,10 +411,19 @@ Module ScriptModuleDeserializer::deserialize(
   }
   auto tuple = readArchive("constants").toTuple();
   for (auto constant : tuple->elements()) {
-    constants_table_.push_back(constant.toIValue());
+    archive_->constants.push_back(constant.toIValue());
   }
   auto m = Module(readArchive("data").toObject());
-  rewriteQuantizedConvForBC(m);
+  if (!lazy_methods_) {
+    rewriteQuantizedConvForBC(m);
+    return m;
+  }
+  // Only the code is read here, it is compiled when the methods are first
+  // used, unless the rewrite below needs their graphs
+  readAllSources();
+  if (hasQuantizedConv()) {
+    rewriteQuantizedConvForBC(m);
+  }
   return m;
 }
 
@@ -18,6 +18,12 @@ namespace jit {
 
 static ExtraFilesMap default_extra_files;
 
+// Compile the methods of the loaded modules on their first use rather than in
+// load(), which then only reads the archive. Errors in the code of a method
+// are reported on its first use.
+TORCH_API void setLazyMethodCompilationEnabled(bool enabled);
+TORCH_API bool lazyMethodCompilationEnabled();
+
 TORCH_API Module import_ir_module(
     std::shared_ptr<CompilationUnit> cu,
     const std::string& filename,
@@ -60,6 +66,9 @@ TORCH_API Module load(
 /// The reader adapter, which is for customized input stream, must contain a
 /// serialized `Module`, exported either via `ScriptModule.save()` in
 /// Python or `torch::jit::ExportModule` in C++.
+///
+/// With a `caffe2::serialize::MmapFileAdapter`, the parameters and buffers of
+/// the module point into the mapped file instead of being copied.
 TORCH_API Module load(
     std::unique_ptr<caffe2::serialize::ReadAdapterInterface> rai,
     c10::optional<c10::Device> device = c10::nullopt,
@@ -95,8 +95,11 @@ struct SourceImporterImpl : public Resolver,
       const std::shared_ptr<CompilationUnit> cu,
       const std::vector<at::IValue>* constant_table,
       SourceLoader source_loader,
-      size_t version)
-      : cu_(cu), source_loader_(std::move(source_loader)) {
+      size_t version,
+      bool lazy_methods)
+      : cu_(cu),
+        source_loader_(std::move(source_loader)),
+        lazy_methods_(lazy_methods) {
     env_ = {
         {"torch", std::make_shared<BuiltinModule>("aten", version)},
         {"ops", std::make_shared<OpsValue>(version)},
@@ -231,7 +234,13 @@ struct SourceImporterImpl : public Resolver,
   void importFunction(const std::string& qualifier, const Def& def) {
     std::vector<Def> definitions{def};
     std::vector<ResolverPtr> resolvers{shared_from_this()};
-    cu_->define(qualifier, definitions, resolvers, nullptr);
+    cu_->define(
+        qualifier,
+        definitions,
+        resolvers,
+        nullptr,
+        /*shouldMangle=*/false,
+        lazy_methods_);
   }
 
   void importNamedType(
@@ -472,7 +481,13 @@ struct SourceImporterImpl : public Resolver,
 
     cu_->register_type(class_type);
     const auto self = SimpleSelf(class_type);
-    cu_->define(qualified_classname, methods, resolvers, &self);
+    cu_->define(
+        qualified_classname,
+        methods,
+        resolvers,
+        &self,
+        /*shouldMangle=*/false,
+        lazy_methods_);
   }
 
   void importNamedTuple(
@@ -535,6 +550,7 @@ struct SourceImporterImpl : public Resolver,
   std::shared_ptr<CompilationUnit> cu_;
   std::unordered_map<std::string, std::shared_ptr<SugaredValue>> env_;
   SourceLoader source_loader_;
+  bool lazy_methods_;
   std::unordered_set<std::string> loaded_sources_;
   // named types and functions loaded from a file but not yet defined because
   // their type has not been requested yet.
@@ -569,12 +585,14 @@ SourceImporter::SourceImporter(
     std::shared_ptr<CompilationUnit> cu,
     const std::vector<IValue>* constant_table,
     SourceLoader loader,
-    size_t version)
+    size_t version,
+    bool lazy_methods)
     : pImpl(std::make_shared<SourceImporterImpl>(
           std::move(cu),
           constant_table,
           std::move(loader),
-          version)) {}
+          version,
+          lazy_methods)) {}
 
 TypePtr SourceImporter::loadType(const QualifiedName& name) const {
   ScriptTypeParser type_parser(pImpl);
@@ -24,7 +24,10 @@ struct TORCH_API SourceImporter {
       std::shared_ptr<CompilationUnit> cu,
       const std::vector<at::IValue>* constant_table,
       SourceLoader loader,
-      size_t version);
+      size_t version,
+      // compile the imported functions and methods on first use, the
+      // constant table and the loader have to outlive them
+      bool lazy_methods = false);
 
   TypePtr loadType(const QualifiedName& name) const;
 
@@ -228,10 +228,13 @@ inline void append<bool>(std::vector<bool>& a, bool&& e) {
   a.push_back(e);
 }
 
-static std::vector<int64_t> tupleToIntList(const IValue& v) {
-  return fmap(v.toTuple()->elements(), [](const IValue& v) -> int64_t {
-    return v.toInt();
-  });
+static c10::SmallVector<int64_t, 5> tupleToIntList(const IValue& v) {
+  const auto& elements = v.toTuple()->elements();
+  c10::SmallVector<int64_t, 5> result(elements.size());
+  for (size_t i = 0; i < elements.size(); ++i) {
+    result[i] = elements[i].toInt();
+  }
+  return result;
 }
 
 // note we cannot use toIntList, toDoubleList because during unpickling the
@@ -300,7 +303,7 @@ PickleOpCode Unpickler::readInstruction() {
     } break;
     case PickleOpCode::BINUNICODE: {
       uint32_t length = read<uint32_t>();
-      stack_.emplace_back(readBytes(length));
+      stack_.emplace_back(readString(length));
     } break;
     case PickleOpCode::BINFLOAT:
       stack_.emplace_back(readFloat());
@@ -308,26 +311,29 @@ PickleOpCode Unpickler::readInstruction() {
     case PickleOpCode::TUPLE: {
       size_t start = marks_.back();
       marks_.pop_back();
-      auto tuple = c10::ivalue::Tuple::create({});
-      tuple->elements().reserve(stack_.size() - start);
+      std::vector<IValue> elements;
+      elements.reserve(stack_.size() - start);
       auto start_it = stack_.begin() + start;
       for (auto it = start_it; it != stack_.end(); ++it) {
-        tuple->elements().emplace_back(*it);
+        elements.emplace_back(std::move(*it));
       }
       stack_.erase(start_it, stack_.end());
-      stack_.emplace_back(tuple);
+      stack_.emplace_back(c10::ivalue::Tuple::create(std::move(elements)));
     } break;
+    // Tuples of up to 3 elements keep them inline, without a vector.
     case PickleOpCode::TUPLE1: {
-      auto tuple = c10::ivalue::Tuple::create(pop(stack_, 1));
-      stack_.emplace_back(tuple);
+      stack_.back() = c10::ivalue::Tuple::create(std::move(stack_.back()));
     } break;
     case PickleOpCode::TUPLE2: {
-      auto tuple = c10::ivalue::Tuple::create(pop(stack_, 2));
-      stack_.emplace_back(tuple);
+      IValue e1 = pop(stack_);
+      stack_.back() = c10::ivalue::Tuple::create(
+          std::move(stack_.back()), std::move(e1));
     } break;
     case PickleOpCode::TUPLE3: {
-      auto tuple = c10::ivalue::Tuple::create(pop(stack_, 3));
-      stack_.emplace_back(tuple);
+      IValue e2 = pop(stack_);
+      IValue e1 = pop(stack_);
+      stack_.back() = c10::ivalue::Tuple::create(
+          std::move(stack_.back()), std::move(e1), std::move(e2));
     } break;
     case PickleOpCode::EMPTY_DICT:
       stack_.emplace_back(
@@ -393,44 +399,8 @@ PickleOpCode Unpickler::readInstruction() {
       globals_.at(idx)();
     } break;
     case PickleOpCode::BINPERSID: {
-      auto args = pop(stack_).toTuple()->elements();
-      AT_ASSERT(
-          args.at(0).toStringRef() == "storage",
-          "unknown PERSID key ",
-          args.at(0).toStringRef());
-      at::ScalarType type = args.at(1).toScalarType();
-      const std::string& key = args.at(2).toStringRef();
-      at::Device device(args.at(3).toStringRef());
-      if (device_) {
-        device = *device_;
-      }
-      at::DataPtr storage_ptr = read_record_(key);
-      int64_t numel = args.at(4).toInt();
-      caffe2::TypeMeta dtype = at::CPU(type).typeMeta();
-      at::Storage storage(
-          c10::Storage::use_byte_size_t(),
-          numel * dtype.itemsize(),
-          std::move(storage_ptr),
-          /*allocator=*/nullptr,
-          /*resizable=*/false); // NB: we didn't set any allocator for the
-                                // tensor
-      auto options = at::CPU(type).options();
-      at::Tensor tensor;
-      if (options.backend() == c10::Backend::QuantizedCPU) {
-        tensor = at::_empty_affine_quantized({}, options, 0, 0)
-                     .set_(storage, 0, {}, {});
-      } else {
-        tensor = at::empty({0}, options).set_(storage);
-      }
-
-      if (device.type() == DeviceType::CUDA) {
-        tensor = tensor.to(device, tensor.scalar_type());
-      } else if (device.type() != DeviceType::CPU) {
-        AT_ERROR(
-            "supported devices include CPU and CUDA, however got ",
-            DeviceTypeName(device.type(), false));
-      }
-      stack_.push_back(std::move(tensor));
+      auto args = pop(stack_).toTuple();
+      stack_.push_back(readStorage(args->elements()));
     } break;
     default: {
       AT_ERROR(
@@ -498,8 +468,8 @@ void Unpickler::readGlobal(
         }
         // TODO: Use lookahead to avoid creating the tuple and immediately
         // destroying it here
-        restoreContainerTypeTags(data.at(0), type);
-        stack_.emplace_back(data.at(0));
+        restoreContainerTypeTags(data[0], type);
+        stack_.emplace_back(data[0]);
       });
     } else {
       TypePtr elem_type = nullptr;
@@ -607,10 +577,10 @@ void Unpickler::rebuildTensor(bool quantized) {
     auto tup = pop(stack_).toTuple();
     const auto& elements = tup->elements();
     size_t idx = 0;
-    auto storage_tensor = elements.at(idx++).toTensor();
+    const auto& storage_tensor = elements.at(idx++).toTensor();
     int64_t storage_offset = elements.at(idx++).toInt();
-    std::vector<int64_t> size = tupleToIntList(elements.at(idx++));
-    std::vector<int64_t> stride = tupleToIntList(elements.at(idx++));
+    auto size = tupleToIntList(elements.at(idx++));
+    auto stride = tupleToIntList(elements.at(idx++));
     at::Tensor result;
     if (quantized) {
       auto qparams_tuple = elements.at(idx++).toTuple();
@@ -638,7 +608,13 @@ void Unpickler::rebuildTensor(bool quantized) {
           break;
       }
     } else {
-      result = at::empty({0}, storage_tensor.options());
+      // Fast path for the bulk of the tensors of a state dict: view the
+      // storage directly instead of going through at::empty, the same way
+      // as_strided does
+      result = at::detail::make_tensor<at::TensorImpl>(
+          c10::Storage(storage_tensor.storage()),
+          storage_tensor.key_set(),
+          storage_tensor.dtype());
     }
     bool requires_grad = elements.at(idx).toBool();
     // elements[idx++] is empty backwards hooks
@@ -651,6 +627,54 @@ void Unpickler::rebuildTensor(bool quantized) {
   });
 }
 
+at::Tensor Unpickler::readStorage(const std::vector<IValue>& args) {
+  AT_ASSERT(
+      args.at(0).toStringRef() == "storage",
+      "unknown PERSID key ",
+      args.at(0).toStringRef());
+  const std::string& key = args.at(2).toStringRef();
+  auto memoized = storage_memo_.find(key);
+  if (memoized != storage_memo_.end()) {
+    return memoized->second;
+  }
+
+  at::ScalarType type = args.at(1).toScalarType();
+  at::Device device(args.at(3).toStringRef());
+  if (device_) {
+    device = *device_;
+  }
+  at::DataPtr storage_ptr = read_record_(key);
+  int64_t numel = args.at(4).toInt();
+  caffe2::TypeMeta dtype = at::CPU(type).typeMeta();
+  at::Storage storage(
+      c10::Storage::use_byte_size_t(),
+      numel * dtype.itemsize(),
+      std::move(storage_ptr),
+      /*allocator=*/nullptr,
+      /*resizable=*/false); // NB: we didn't set any allocator for the
+                            // tensor
+  auto options = at::CPU(type).options();
+  at::Tensor tensor;
+  if (options.backend() == c10::Backend::QuantizedCPU) {
+    tensor = at::_empty_affine_quantized({}, options, 0, 0)
+                 .set_(storage, 0, {}, {});
+  } else {
+    tensor = at::detail::make_tensor<at::TensorImpl>(
+        std::move(storage), at::DispatchKey::CPU, dtype);
+    tensor.unsafeGetTensorImpl()->set_sizes_contiguous({numel});
+  }
+
+  if (device.type() == DeviceType::CUDA) {
+    tensor = tensor.to(device, tensor.scalar_type());
+  } else if (device.type() != DeviceType::CPU) {
+    AT_ERROR(
+        "supported devices include CPU and CUDA, however got ",
+        DeviceTypeName(device.type(), false));
+  }
+  storage_memo_.emplace(key, tensor);
+  return tensor;
+}
+
 #ifdef USE_DISTRIBUTED
 void Unpickler::rebuildRRef() {
   globals_.emplace_back([this] {
@@ -748,6 +772,20 @@ std::string Unpickler::readBytes(size_t length) {
   return data;
 }
 
+IValue Unpickler::readString(size_t length) {
+  if (length > kMaxInternedStringLength) {
+    return readBytes(length);
+  }
+  // The same short strings, like the keys of a list of dicts, repeat
+  // throughout pickles whose writer doesn't memoize them, so they share one
+  // ConstantString
+  auto it = interned_strings_.emplace(readBytes(length), IValue()).first;
+  if (it->second.isNone()) {
+    it->second = it->first;
+  }
+  return it->second;
+}
+
 // Pop all the list items off of the stack and append them to the list at
 // the corresponding MARK
 void Unpickler::readList(IValue list_ivalue) {
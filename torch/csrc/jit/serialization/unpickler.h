@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ATen/core/ivalue.h>
+#include <c10/util/flat_hash_map.h>
 #include <caffe2/serialize/inline_container.h>
 #include <torch/csrc/jit/serialization/pickler.h>
 
@@ -90,12 +91,16 @@ class Unpickler {
   }
   void readSlowWithBuffer(char* dest, size_t sz);
   std::string readBytes(size_t num_bytes);
+  // Reads a string, sharing the IValue of the short ones between all their
+  // occurrences in the pickle
+  IValue readString(size_t num_bytes);
 
   double readFloat();
   void readGlobal(
       const std::string& module_name,
       const std::string& class_name);
   void rebuildTensor(bool quantized);
+  at::Tensor readStorage(const std::vector<IValue>& args);
 #ifdef USE_DISTRIBUTED
   void rebuildRRef();
 #endif
@@ -125,12 +130,21 @@ class Unpickler {
   std::vector<size_t> marks_;
   const std::vector<at::Tensor>* tensor_table_;
 
+  // Tensors holding the storages read so far, by record key. Python's pickler
+  // doesn't memoize persistent ids, so torch.save emits a BINPERSID for each
+  // tensor viewing a storage.
+  ska::flat_hash_map<std::string, at::Tensor> storage_memo_;
+
   // When deserializing types on lists and dicts, cache the type here
   // so we don't have to parse the same type multiple times. Strings
   // are already de-duplicated and replaced with BINGETs in the
   // pickler, so we can just use the actual data pointer of each string.
   std::unordered_map<std::string, c10::TypePtr> type_cache_;
 
+  // Short strings read so far, see readString
+  static constexpr size_t kMaxInternedStringLength = 64;
+  std::unordered_map<std::string, IValue> interned_strings_;
+
   // optionally nullptr, needs to be present for creating classes
   TypeResolver type_resolver_;
   ObjLoader obj_loader_;
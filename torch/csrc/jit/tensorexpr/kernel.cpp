@@ -1,11 +1,15 @@
 #include <torch/csrc/jit/tensorexpr/kernel.h>
 
+#include <ATen/Parallel.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/native/DispatchStub.h>
 #include <c10/util/string_utils.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
 #include <torch/csrc/jit/tensorexpr/loopnest.h>
+#include <torch/csrc/jit/tensorexpr/var_substitutor.h>
 
 using namespace torch::jit;
 using namespace torch::jit::tensorexpr;
@@ -56,16 +60,25 @@ static at::ScalarType tensorType(Tensor* t) {
   return static_cast<at::ScalarType>(t->body()->dtype().scalar_type());
 }
 
-static std::vector<ExprHandle> texprSizes(
-    const c10::VaryingShape<int64_t>& shape) {
+std::vector<ExprHandle> TensorExprKernel::texprSizes(
+    const c10::SymbolicShape& shape) {
   std::vector<ExprHandle> dims;
-  for (size_t i = 0; i < *shape.size(); i++) {
-    dims.push_back(IntImm::make(*shape[i]));
+  for (auto const& symbol : *shape.sizes()) {
+    if (symbol.is_static()) {
+      dims.push_back(IntImm::make(symbol.static_size()));
+      continue;
+    }
+    // A symbolic dim is the size var of an input with the same symbol
+    auto it = shapeSymbols_.find(symbol);
+    if (it == shapeSymbols_.end()) {
+      throw malformed_input("symbolic dim not found in the inputs");
+    }
+    dims.push_back(it->second);
   }
   return dims;
 }
 
-static std::vector<DimArg> texprDims(const torch::jit::Value* v) {
+std::vector<DimArg> TensorExprKernel::texprDims(const torch::jit::Value* v) {
   if (v->type()->kind() != TypeKind::TensorType) {
     throw malformed_input("type is not Tensor");
   }
@@ -73,7 +86,7 @@ static std::vector<DimArg> texprDims(const torch::jit::Value* v) {
   auto tt = v->type()->cast<TensorType>();
   std::vector<DimArg> dimArgs;
   int i = 0;
-  for (auto const& s : texprSizes(tt->sizes())) {
+  for (auto const& s : texprSizes(tt->symbolic_sizes())) {
     dimArgs.emplace_back(DimArg(s, "i" + c10::to_string(i++)));
   }
   return dimArgs;
@@ -216,6 +229,12 @@ static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
         dim = *bt;
         broadcast = true;
       }
+    } else if (
+        !isOne(*bt) && at->node() != bt->node() &&
+        !(at->AsNode<IntImm>() && bt->AsNode<IntImm>())) {
+      // A symbolic dim may be 1 at runtime, it can only be broadcast with
+      // a dim of size 1 or with the same size var
+      throw malformed_input("cannot broadcast symbolic dims");
     }
     ret.push_back(dim);
     at++;
@@ -413,6 +432,201 @@ Tensor* TensorExprKernel::computeFourOperand(
       });
 }
 
+// Lowers aten::sum and aten::mean over constant dims, or over all of them
+// for the overloads without a dim list.
+Tensor* TensorExprKernel::computeSum(const torch::jit::Value* v, bool mean) {
+  auto const& n = v->node();
+  auto const& inputShape = valueShape(n->inputs()[0]);
+  int64_t rank = inputShape.size();
+  std::vector<bool> reduced(rank, true);
+  bool keepdim = false;
+  if (n->inputs().size() > 2) {
+    auto dims = toIValue(n->inputs()[1])->toIntVector();
+    // An empty dim list reduces all the dims, as in ATen
+    if (!dims.empty()) {
+      std::fill(reduced.begin(), reduced.end(), false);
+      for (int64_t dim : dims) {
+        reduced[at::maybe_wrap_dim(dim, rank)] = true;
+      }
+    }
+    keepdim = toIValue(n->inputs()[2])->toBool();
+  }
+
+  std::vector<DimArg> reduceDims;
+  ExprHandle count = 1;
+  for (int64_t i = 0; i < rank; i++) {
+    if (reduced[i]) {
+      reduceDims.emplace_back(inputShape[i], "r" + c10::to_string(i));
+      count = count * inputShape[i];
+    }
+  }
+
+  auto outputDims = texprDims(v);
+  size_t outputRank = outputDims.size();
+  Tensor* sum = Reduce(
+      mean ? "aten_mean_sum" : "aten_sum",
+      outputDims,
+      Sum(),
+      [this, v, reduced, keepdim, outputRank](
+          const std::vector<VarHandle>& vars) {
+        // The output axes come first, then the reduced ones
+        std::vector<ExprHandle> indices;
+        size_t outputIdx = 0;
+        size_t reduceIdx = outputRank;
+        for (bool r : reduced) {
+          if (r) {
+            indices.push_back(vars[reduceIdx++]);
+            outputIdx += keepdim;
+          } else {
+            indices.push_back(vars[outputIdx++]);
+          }
+        }
+        return tensorOrConstant(v->node()->inputs()[0], indices);
+      },
+      reduceDims);
+  reductions_.push_back(sum);
+  if (!mean) {
+    return sum;
+  }
+
+  return Compute(
+      "aten_mean",
+      outputDims,
+      [this, v, sum, count](const std::vector<VarHandle>& axes) {
+        ExprHandle s = sum->call(axes);
+        return demoteOutput(s / Cast::make(s.dtype(), count), v);
+      });
+}
+
+// softmax(x) = exp(x - max(x)) / sum(exp(x - max(x))) along dim, subtracting
+// the max keeps exp from overflowing.
+Tensor* TensorExprKernel::computeSoftmax(
+    const torch::jit::Value* v,
+    bool logSoftmax) {
+  auto const& n = v->node();
+  auto outputDims = texprDims(v);
+  size_t rank = outputDims.size();
+  size_t dim = at::maybe_wrap_dim(toIValue(n->inputs()[1])->toInt(), rank);
+
+  std::vector<DimArg> nonSoftmaxDims;
+  for (size_t i = 0; i < rank; i++) {
+    if (i != dim) {
+      nonSoftmaxDims.push_back(outputDims[i]);
+    }
+  }
+  // Indices of the input for the axes of a reduction over dim
+  auto inputIndices = [dim](const std::vector<VarHandle>& vars) {
+    std::vector<ExprHandle> indices(vars.begin(), vars.end() - 1);
+    indices.insert(indices.begin() + dim, vars.back());
+    return indices;
+  };
+
+  Tensor* max = Reduce(
+      "aten_softmax_max",
+      nonSoftmaxDims,
+      Maximum(ExprHandle(-std::numeric_limits<float>::infinity())),
+      [this, v, inputIndices](const std::vector<VarHandle>& vars) {
+        return tensorOrConstant(v->node()->inputs()[0], inputIndices(vars));
+      },
+      {outputDims[dim]});
+  Tensor* sum = Reduce(
+      "aten_softmax_sum",
+      nonSoftmaxDims,
+      Sum(),
+      [this, v, max, inputIndices](const std::vector<VarHandle>& vars) {
+        std::vector<ExprHandle> outer(vars.begin(), vars.end() - 1);
+        return exp(
+            tensorOrConstant(v->node()->inputs()[0], inputIndices(vars)) -
+            max->call(outer));
+      },
+      {outputDims[dim]});
+  reductions_.push_back(max);
+  reductions_.push_back(sum);
+
+  return Compute(
+      logSoftmax ? "aten_log_softmax" : "aten_softmax",
+      outputDims,
+      [this, v, max, sum, dim, logSoftmax](
+          const std::vector<VarHandle>& axes) {
+        std::vector<ExprHandle> outer(axes.begin(), axes.end());
+        outer.erase(outer.begin() + dim);
+        ExprHandle shifted =
+            tensorOrConstant(v->node()->inputs()[0], axes) - max->call(outer);
+        ExprHandle result = logSoftmax ? shifted - log(sum->call(outer))
+                                       : exp(shifted) / sum->call(outer);
+        return demoteOutput(result, v);
+      });
+}
+
+// layer_norm normalizes the trailing normalized_shape dims of the input. The
+// variance is a second reduction over the centered input, which is more
+// accurate than E[x^2] - E[x]^2.
+Tensor* TensorExprKernel::computeLayerNorm(const torch::jit::Value* v) {
+  auto const& n = v->node();
+  auto outputDims = texprDims(v);
+  size_t outerRank =
+      outputDims.size() - toIValue(n->inputs()[1])->toIntVector().size();
+  std::vector<DimArg> outerDims(
+      outputDims.begin(), outputDims.begin() + outerRank);
+  std::vector<DimArg> innerDims(
+      outputDims.begin() + outerRank, outputDims.end());
+  ExprHandle count = 1;
+  for (const DimArg& d : innerDims) {
+    count = count * d.dim();
+  }
+
+  Tensor* sum = Reduce(
+      "aten_layer_norm_sum",
+      outerDims,
+      Sum(),
+      [this, v](const std::vector<VarHandle>& vars) {
+        return tensorOrConstant(v->node()->inputs()[0], vars);
+      },
+      innerDims);
+  auto mean = [sum, count](const std::vector<ExprHandle>& outer) {
+    ExprHandle s = sum->call(outer);
+    return s / Cast::make(s.dtype(), count);
+  };
+  Tensor* var = Reduce(
+      "aten_layer_norm_var",
+      outerDims,
+      Sum(),
+      [this, v, mean, outerRank](const std::vector<VarHandle>& vars) {
+        std::vector<ExprHandle> outer(vars.begin(), vars.begin() + outerRank);
+        ExprHandle centered =
+            tensorOrConstant(v->node()->inputs()[0], vars) - mean(outer);
+        return centered * centered;
+      },
+      innerDims);
+  reductions_.push_back(sum);
+  reductions_.push_back(var);
+
+  return Compute(
+      "aten_layer_norm",
+      outputDims,
+      [this, v, mean, var, count, outerRank](
+          const std::vector<VarHandle>& axes) {
+        auto const& n = v->node();
+        std::vector<ExprHandle> outer(axes.begin(), axes.begin() + outerRank);
+        std::vector<VarHandle> inner(axes.begin() + outerRank, axes.end());
+        ExprHandle variance = var->call(outer);
+        variance =
+            variance / Cast::make(variance.dtype(), count);
+        ExprHandle eps = Cast::make(variance.dtype(), constant(n->inputs()[4]));
+        ExprHandle result =
+            (tensorOrConstant(n->inputs()[0], axes) - mean(outer)) *
+            rsqrt(variance + eps);
+        // weight and bias are optional
+        if (n->inputs()[2]->type()->cast<TensorType>()) {
+          result = result * tensorOrConstant(n->inputs()[2], inner);
+        }
+        if (n->inputs()[3]->type()->cast<TensorType>()) {
+          result = result + tensorOrConstant(n->inputs()[3], inner);
+        }
+        return demoteOutput(result, v);
+      });
+}
+
 Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
   switch (v->node()->kind()) {
     case aten::add: {
@@ -967,6 +1181,34 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
           });
     }
 
+    case aten::gelu: {
+      return computeOneOperand("aten_gelu", v, [](const ExprHandle& a) {
+        // x * Phi(x), with erf(x / sqrt(2))
+        return a * ExprHandle(0.5f) *
+            (ExprHandle(1.0f) + erf(a * ExprHandle(0.7071067811865476f)));
+      });
+    }
+
+    case aten::sum: {
+      return computeSum(v, false);
+    }
+
+    case aten::mean: {
+      return computeSum(v, true);
+    }
+
+    case aten::softmax: {
+      return computeSoftmax(v, false);
+    }
+
+    case aten::log_softmax: {
+      return computeSoftmax(v, true);
+    }
+
+    case aten::layer_norm: {
+      return computeLayerNorm(v);
+    }
+
     default: {
       throw std::runtime_error("Unhandled node kind");
     }
@@ -1018,7 +1260,130 @@ void TensorExprKernel::flattenTensors(BackendType backendType) {
   }
 }
 
+// Number of float lanes to vectorize the loops with: the width of the SIMD
+// registers of the host as seen by the ATen kernels, capped to the 8 lanes
+// that the Sleef math functions are bound for in LLVMCodeGen.
+static int nativeVectorWidth() {
+  switch (at::native::get_cpu_capability()) {
+    case at::native::CPUCapability::DEFAULT:
+      return 4;
+    default:
+      return 8;
+  }
+}
+
+// Extent of a loop, if it is known at compile time.
+static c10::optional<int64_t> constantExtent(For* f) {
+  const IntImm* start =
+      dynamic_cast<const IntImm*>(IRSimplifier::simplify(f->start()));
+  const IntImm* stop =
+      dynamic_cast<const IntImm*>(IRSimplifier::simplify(f->stop()));
+  if (!start || !stop) {
+    return c10::nullopt;
+  }
+  return stop->value() - start->value();
+}
+
+// Number of elements stored by a statement, 0 if it has loops of unknown
+// extent.
+static int64_t storedElements(Stmt* s) {
+  if (Store* store = dynamic_cast<Store*>(s)) {
+    return store->value()->dtype().lanes();
+  }
+  if (For* f = dynamic_cast<For*>(s)) {
+    auto extent = constantExtent(f);
+    return extent ? *extent * storedElements(f->body()) : 0;
+  }
+  int64_t elements = 0;
+  if (tensorexpr::Block* b = dynamic_cast<tensorexpr::Block*>(s)) {
+    for (Stmt* stmt : *b) {
+      elements += storedElements(stmt);
+    }
+  }
+  return elements;
+}
+
+// Outermost loops of a statement, looking through the blocks.
+static std::vector<For*> outermostLoops(Stmt* root) {
+  std::vector<For*> loops;
+  if (For* rootF = dynamic_cast<For*>(root)) {
+    loops.push_back(rootF);
+  } else if (auto body = dynamic_cast<tensorexpr::Block*>(root)) {
+    std::vector<tensorexpr::Block*> blocks = {body};
+    while (blocks.size()) {
+      tensorexpr::Block* b = blocks.back();
+      blocks.pop_back();
+
+      for (Stmt* s : *b) {
+        if (For* f = dynamic_cast<For*>(s)) {
+          loops.push_back(f);
+        } else if (auto b2 = dynamic_cast<tensorexpr::Block*>(s)) {
+          blocks.push_back(b2);
+        }
+      }
+    }
+  }
+  return loops;
+}
+
+// Splits the innermost reduce loop of a reduction by the vector width and
+// rfactors the inner part of the split, so that each iteration of the outer
+// part accumulates a vector of partial results:
+//
+//   for (i0) {                      for (i0) {
+//     for (r0) {                      tmp[0:8] = 0
+//       sum[i0] += x[i0, r0]   =>     for (r0_outer)
+//     }                                 tmp[0:8] += x[i0, 8*r0_outer + 0:8]
+//   }                                 for (r0_inner)
+//                                       sum[i0] += tmp[r0_inner]
+//                                   }
+//
+// The vectorization itself is left to generateStmt.
+static void scheduleReduction(LoopNest& l, Tensor* t) {
+  std::vector<For*> loops = l.getLoopStmtsFor(t);
+  if (loops.size() <= t->buf()->ndim()) {
+    return;
+  }
+  For* inner = loops.back();
+  auto extent = constantExtent(inner);
+  int width = nativeVectorWidth();
+  if (!extent || *extent < 2 * width || *extent % width != 0) {
+    return;
+  }
+
+  For* outer;
+  For* vectorized;
+  l.splitWithMask(inner, width, &outer, &vectorized);
+  for (ReduceOp* r : NodeFinder<ReduceOp>::find(l.root_stmt())) {
+    if (r->accumulator() == t->buf()) {
+      l.rfactor(r, vectorized->var());
+      break;
+    }
+  }
+}
+
+// A loop can only be vectorized if all the stores in its body depend on its
+// var, a loop accumulating a reduction into the same element can't.
+static bool storesDependOnLoopVar(For* f) {
+  for (Store* s : NodeFinder<Store>::find(f->body())) {
+    bool dependent = false;
+    for (const Expr* index : s->indices()) {
+      dependent |= VarFinder().findVars(index).count(f->var()) > 0;
+    }
+    if (!dependent) {
+      return false;
+    }
+  }
+  return true;
+}
+
 Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
+  if (backendType == kCudaCodeGen && !reductions_.empty()) {
+    // The CUDA codegen emits a single kernel, with no way to synchronize the
+    // threads between a reduction and its uses.
+    throw std::runtime_error("Reductions are not supported on CUDA");
+  }
+
   flattenTensors(backendType);
 
   torch::jit::tensorexpr::LoopNest l(flatTensorOutputs_);
@@ -1028,6 +1393,11 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
     if (!l.hasLoopBodyFor(p.second)) {
       continue;
     }
+    // Reductions are computed into their own buffers
+    if (std::find(reductions_.begin(), reductions_.end(), p.second) !=
+        reductions_.end()) {
+      continue;
+    }
     Stmt* loop = l.getLoopBodyFor(p.second);
     if (torch::jit::tensorexpr::HasRand(loop).has_rand()) {
       l.computeInlineWithRandom(loop);
@@ -1082,30 +1452,17 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
     }
   }
 
+  if (backendType == kLLVMCodeGen) {
+    for (Tensor* t : reductions_) {
+      scheduleReduction(l, t);
+    }
+  }
+
   l.prepareForCodegen();
 
   if (backendType == kLLVMCodeGen) {
     std::vector<For*> innerLoops;
-    std::vector<For*> worklist;
-
-    // Find outer-most For loops
-    if (For* rootF = dynamic_cast<For*>(l.root_stmt())) {
-      worklist.push_back(rootF);
-    } else if (Block* body = dynamic_cast<Block*>(l.root_stmt())) {
-      std::vector<Block*> blocks = {body};
-      while (blocks.size()) {
-        Block* b = blocks.back();
-        blocks.pop_back();
-
-        for (Stmt* s : *b) {
-          if (For* f = dynamic_cast<For*>(s)) {
-            worklist.push_back(f);
-          } else if (Block* b2 = dynamic_cast<Block*>(s)) {
-            blocks.push_back(b2);
-          }
-        }
-      }
-    }
+    std::vector<For*> worklist = outermostLoops(l.root_stmt());
 
     // Traverse the For loop nest find inner-most loops, which are
     // vectorization candidates.
@@ -1123,22 +1480,22 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
         }
       }
 
-      if (!containsSubLoops) {
+      if (!containsSubLoops && storesDependOnLoopVar(f)) {
         innerLoops.push_back(f);
       }
     }
 
     // vectorize inner loops.
+    const int kBodyVectorWidth = nativeVectorWidth();
     for (For* loop : innerLoops) {
       For* outer1;
       For* split1;
       For* tail1;
 
-      static const int kBodyVectorWidth = 8;
       l.splitWithTail(loop, kBodyVectorWidth, &outer1, &split1, &tail1);
       l.vectorize(split1);
 
-      if (tail1) {
+      if (tail1 && kBodyVectorWidth > 4) {
         For* outer2;
         For* split2;
         For* tail2;
@@ -1147,6 +1504,17 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
         l.vectorize(split2);
       }
     }
+
+    // Run the outer loops in parallel when they have enough work to amortize
+    // the dispatch, with the same grain size as the ATen kernels. A loop
+    // carrying a full reduction can't be parallelized.
+    for (For* loop : outermostLoops(l.root_stmt())) {
+      auto extent = constantExtent(loop);
+      if (extent && *extent > 1 && storesDependOnLoopVar(loop) &&
+          storedElements(loop) >= at::internal::GRAIN_SIZE) {
+        l.setParallel(loop);
+      }
+    }
   }
 
   Stmt* stmt = l.root_stmt();
@@ -1172,10 +1540,14 @@ std::string TensorExprKernel::getCodeGenName(BackendType backendType) {
 
 std::vector<CodeGen::BufferArg> TensorExprKernel::prepareBufferArgs() {
   std::vector<CodeGen::BufferArg> params;
+  // The size vars shared by several inputs are only passed once
+  std::unordered_set<const Var*> sizeVars;
   for (auto const& arg : kernelArgs_) {
     params.push_back(arg.buffer());
     for (auto const& size : arg.sizes()) {
-      params.emplace_back(size.var);
+      if (sizeVars.insert(size.var.node()).second) {
+        params.emplace_back(size.var);
+      }
     }
     for (auto const& stride : arg.strides()) {
       params.emplace_back(stride.var);
@@ -1305,13 +1677,40 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
           "t" + input->debugName(),
           ToDtype(static_cast<ScalarType>(*tt->scalarType())),
           {0});
+      // The symbolic dims get a size var, shared by the inputs with the same
+      // symbol, and the strides that are not known at compile time are
+      // passed at runtime too.
+      auto const symbols = *tt->symbolic_sizes().sizes();
+      auto const strides = tt->strides();
       std::vector<DimArg> inputTensorDims;
-      for (size_t i = 0; i < *tt->sizes().size(); i++) {
-        auto const size = *tt->sizes()[i];
-        inputTensorDims.emplace_back(
-            DimArg(IntImm::make(size), "i" + c10::to_string(i)));
+      std::vector<ExprHandle> inputTensorStrides;
+      std::vector<ShapeArg> sizeArgs;
+      std::vector<ShapeArg> strideArgs;
+      for (size_t i = 0; i < symbols.size(); i++) {
+        auto const& symbol = symbols[i];
+        if (symbol.is_static()) {
+          inputTensorDims.emplace_back(DimArg(
+              IntImm::make(symbol.static_size()), "i" + c10::to_string(i)));
+        } else {
+          auto it = shapeSymbols_.find(symbol);
+          if (it == shapeSymbols_.end()) {
+            VarHandle size(
+                "size" + c10::to_string(shapeSymbols_.size()), kInt);
+            it = shapeSymbols_.emplace(symbol, size).first;
+          }
+          sizeArgs.emplace_back(i, it->second);
+          inputTensorDims.emplace_back(
+              DimArg(it->second, "i" + c10::to_string(i)));
+        }
+        if (strides.size() && strides[i]) {
+          inputTensorStrides.push_back(IntImm::make(*strides[i]));
+        } else {
+          VarHandle stride(
+              "t" + input->debugName() + "_stride" + c10::to_string(i), kInt);
+          strideArgs.emplace_back(i, stride);
+          inputTensorStrides.push_back(stride);
+        }
       }
-      auto const strides = tt->strides();
       tensors_.emplace(
           input->unique(),
           Compute(
@@ -1320,12 +1719,12 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
               [&](const std::vector<VarHandle>& axes) {
                 ExprHandle idx = 0;
                 for (size_t i = 0; i < axes.size(); i++) {
-                  idx = idx + axes[i] * IntImm::make(*strides[i]);
+                  idx = idx + axes[i] * inputTensorStrides[i];
                 }
                 return inBuffer(idx);
               }));
       kernelArgs_.emplace_back(
-          inBuffer, std::vector<ShapeArg>(), std::vector<ShapeArg>());
+          inBuffer, std::move(sizeArgs), std::move(strideArgs));
       break;
     }
     case TypeKind::FloatType: {
@@ -1400,10 +1799,18 @@ void TensorExprKernel::compile() {
   codegen_ = CreateCodeGen(getCodeGenName(backendType), stmt, params, device_);
 }
 
-TensorExprKernel::TensorExprKernel(const std::shared_ptr<Graph>& subgraph)
+TensorExprKernel::TensorExprKernel(
+    const std::shared_ptr<Graph>& subgraph,
+    bool compileAsync)
     : graph_(subgraph), code_(subgraph, "") {
+  if (compileAsync) {
+    this->compileAsync();
+    return;
+  }
+
   if (!fallbackAllowed()) {
     compile();
+    compiled_ = true;
     return;
   }
 
@@ -1412,10 +1819,44 @@ TensorExprKernel::TensorExprKernel(const std::shared_ptr<Graph>& subgraph)
   } catch (...) {
     fallback_ = true;
   }
+  compiled_ = true;
+}
+
+TensorExprKernel::~TensorExprKernel() {
+  // The pending compilation still refers to the kernel
+  std::unique_lock<std::mutex> lock(compileMutex_);
+  compileDone_.wait(lock, [this] { return !compiling_; });
+}
+
+void TensorExprKernel::compileAsync() {
+  compiling_ = true;
+  at::launch([this]() {
+    try {
+      compile();
+    } catch (...) {
+      compileError_ = std::current_exception();
+      fallback_ = true;
+    }
+    // The destructor may run as soon as the mutex is released, so the
+    // notification is sent while holding it
+    std::lock_guard<std::mutex> guard(compileMutex_);
+    compiled_.store(true, std::memory_order_release);
+    compiling_ = false;
+    compileDone_.notify_all();
+  });
 }
 
 void TensorExprKernel::run(Stack& stack) {
+  if (!compiled_.load(std::memory_order_acquire)) {
+    // The unfused graph computes the same results while the kernel compiles
+    fallback(stack);
+    return;
+  }
+
   if (!fallbackAllowed()) {
+    if (compileError_) {
+      std::rethrow_exception(compileError_);
+    }
     runKernel(stack);
     return;
   }
@@ -1449,8 +1890,9 @@ std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
       runArgs.emplace_back(tensor.data_ptr());
       for (auto const& size : kernelArgs_[i].sizes()) {
         int32_t s = tensor.sizes()[size.idx];
-        runArgs.emplace_back(s);
-        varToSize[size.var.node()] = s;
+        if (varToSize.emplace(size.var.node(), s).second) {
+          runArgs.emplace_back(s);
+        }
       }
       for (auto const& stride : kernelArgs_[i].strides()) {
         int32_t s = tensor.strides()[stride.idx];
@@ -1481,6 +1923,25 @@ std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
   return runArgs;
 }
 
+bool TensorExprKernel::symbolicSizesMatch(
+    const at::ArrayRef<IValue>& inputs) {
+  std::unordered_map<const Expr*, int64_t> varToSize;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    if (!inputs[i].isTensor()) {
+      continue;
+    }
+    auto const& tensor = inputs[i].toTensor();
+    for (auto const& size : kernelArgs_[i].sizes()) {
+      int64_t s = tensor.sizes()[size.idx];
+      auto it = varToSize.emplace(size.var.node(), s).first;
+      if (it->second != s) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 Stmt* TensorExprKernel::getCodeGenStmt() {
   return codegen_->stmt();
 }
@@ -1490,6 +1951,12 @@ void TensorExprKernel::runKernel(Stack& stack) {
 
   // Set up arguments (inputs, then outputs) for kernel call.
   auto inputs = last(stack, nInputs_);
+  // The inputs sharing a symbolic dim had the same size in all the profiled
+  // runs, but the guards only check the static dims.
+  if (!symbolicSizesMatch(inputs)) {
+    fallback(stack);
+    return;
+  }
   std::vector<at::Tensor> outputs;
 
   std::vector<CodeGen::CallArg> runArgs = prepareRunArgs(inputs, outputs);
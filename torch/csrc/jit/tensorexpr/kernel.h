@@ -5,6 +5,11 @@
 #include <torch/csrc/jit/tensorexpr/codegen.h>
 #include <torch/csrc/jit/tensorexpr/tensor.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
 namespace torch {
 namespace jit {
 namespace tensorexpr {
@@ -44,7 +49,12 @@ inline std::vector<ExprHandle> computeIndicesToBroadcast(
 
 class TORCH_API TensorExprKernel {
  public:
-  explicit TensorExprKernel(const std::shared_ptr<Graph>& subgraph);
+  // With compileAsync, the kernel is compiled on the inter-op thread pool and
+  // run() goes through the interpreter until it is ready
+  explicit TensorExprKernel(
+      const std::shared_ptr<Graph>& subgraph,
+      bool compileAsync = false);
+  ~TensorExprKernel();
 
   void run(Stack& stack);
 
@@ -63,6 +73,7 @@ class TORCH_API TensorExprKernel {
   };
 
   void compile();
+  void compileAsync();
 
   void runKernel(Stack& stack);
 
@@ -96,6 +107,9 @@ class TORCH_API TensorExprKernel {
     return t->call(indices);
   }
 
+  std::vector<ExprHandle> texprSizes(const c10::SymbolicShape& shape);
+  std::vector<DimArg> texprDims(const torch::jit::Value* v);
+
   std::vector<ExprHandle> valueShape(const torch::jit::Value* v);
 
   void promoteInputs(std::vector<ExprHandle>& inputs);
@@ -153,6 +167,12 @@ class TORCH_API TensorExprKernel {
           const ExprHandle&,
           const ExprHandle&)>& innerExpr);
 
+  Tensor* computeSum(const torch::jit::Value* v, bool mean);
+
+  Tensor* computeSoftmax(const torch::jit::Value* v, bool logSoftmax);
+
+  Tensor* computeLayerNorm(const torch::jit::Value* v);
+
   Tensor* computeValue(const torch::jit::Value* v);
 
   void flattenTensors(BackendType backendType);
@@ -164,6 +184,8 @@ class TORCH_API TensorExprKernel {
   std::vector<CodeGen::CallArg> prepareRunArgs(
       const at::ArrayRef<IValue>& inputs,
       std::vector<at::Tensor>& outputs);
+  // Whether the inputs agree on the sizes of the symbolic dims they share
+  bool symbolicSizesMatch(const at::ArrayRef<IValue>& inputs);
   BackendType inferBackendTypeFromDevice(at::Device device);
   at::Device pickDeviceType(const at::ArrayRef<torch::jit::Value*>& inputs);
 
@@ -209,7 +231,11 @@ class TORCH_API TensorExprKernel {
   std::vector<Tensor*> tensorOutputs_;
   std::vector<Tensor*> flatTensorOutputs_;
   std::unordered_map<int64_t, Tensor*> tensors_;
+  // Reductions, computed into their own buffers instead of being inlined
+  std::vector<Tensor*> reductions_;
   std::unordered_map<int64_t, VarHandle> scalars_;
+  // Size vars of the symbolic dims of the inputs, passed at runtime
+  std::map<c10::ShapeSymbol, VarHandle> shapeSymbols_;
   std::unique_ptr<CodeGen> codegen_;
   at::Device device_ = at::kCPU;
   KernelArena kernelArena_;
@@ -217,6 +243,13 @@ class TORCH_API TensorExprKernel {
   std::shared_ptr<Graph> graph_;
   Code code_;
   bool fallback_{false};
+  // Set once compile() is done, with compileError_ holding its exception if
+  // it threw on the thread pool
+  std::atomic<bool> compiled_{false};
+  std::exception_ptr compileError_;
+  bool compiling_{false};
+  std::mutex compileMutex_;
+  std::condition_variable compileDone_;
   bool hasRandom_{false};
   bool hasBroadcast_{false};
 };
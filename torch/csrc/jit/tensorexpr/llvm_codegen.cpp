@@ -4,17 +4,21 @@
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
 #include <memory>
+#include <unordered_set>
 
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 
+#include <torch/csrc/jit/codegen/fuser/disk_cache.h>
 #include <torch/csrc/jit/tensorexpr/buffer.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
 #include <torch/csrc/jit/tensorexpr/ir.h>
@@ -57,6 +61,8 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::Type* dtypeToLLVMPtr(Dtype dtype);
   void emitWrapper(const std::vector<llvm::Type*>& params);
   void emitKernel(Stmt* stmt, const std::vector<llvm::Type*>& params);
+  void emitParallelFor(const For* v);
+  void compile();
 
  public:
   LLVMCodeGenImpl(
@@ -262,9 +268,8 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
 
   emitWrapper(params);
   emitKernel(stmt, params);
+  compile();
 
-  cantFail(jit_->addModule(
-      llvm::orc::ThreadSafeModule(std::move(module_), context_)));
   auto sym = jit_->findSymbol("wrapper");
   kernelAddress_ = cantFail(sym.getAddress());
   argv_ = std::make_unique<void*[]>(params.size());
@@ -438,21 +443,68 @@ void LLVMCodeGenImpl::emitKernel(
   if (llvm::verifyFunction(*fn_, &llvm::outs())) {
     throw std::runtime_error("Function verification failed");
   }
-  optimize(*module_);
+}
+
+// Optimizes the module and adds it to the JIT. If the fuser's disk cache is
+// enabled, the object code is looked up by the unoptimized IR before running
+// any LLVM pass, so that processes starting from a cache populated ahead of
+// time (e.g. by running the frozen model once when building the image) skip
+// the compilation entirely.
+void LLVMCodeGenImpl::compile() {
+  auto optimizeModule = [&]() {
+    optimize(*module_);
 
 #if DEBUG_PRINT
-  llvm::errs() << *module_;
-  llvm::SmallVector<char, 0> asmBuffer;
-  llvm::raw_svector_ostream asmStream(asmBuffer);
-  llvm::legacy::PassManager PM;
-  TM_->addPassesToEmitFile(
-      PM,
-      asmStream,
-      nullptr,
-      llvm::TargetMachine::CodeGenFileType::CGFT_AssemblyFile);
-  PM.run(*module_);
-  llvm::errs() << asmStream.str();
+    llvm::errs() << *module_;
+    llvm::SmallVector<char, 0> asmBuffer;
+    llvm::raw_svector_ostream asmStream(asmBuffer);
+    llvm::legacy::PassManager PM;
+    TM_->addPassesToEmitFile(
+        PM,
+        asmStream,
+        nullptr,
+        llvm::TargetMachine::CodeGenFileType::CGFT_AssemblyFile);
+    PM.run(*module_);
+    llvm::errs() << asmStream.str();
 #endif
+  };
+
+  if (fuser::diskCacheDir().empty()) {
+    optimizeModule();
+    cantFail(jit_->addModule(
+        llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+    return;
+  }
+
+  std::string code;
+  llvm::raw_string_ostream codeStream(code);
+  codeStream << *module_;
+  codeStream.flush();
+  std::string config;
+  llvm::raw_string_ostream configStream(config);
+  configStream << "llvm " << LLVM_VERSION_STRING << "\n"
+               << TM_->getTargetCPU() << "\n"
+               << TM_->getTargetFeatureString();
+  configStream.flush();
+
+  auto cached =
+      fuser::compileWithDiskCache("", code, config, [&]() {
+        optimizeModule();
+        llvm::SmallVector<char, 0> objBuffer;
+        llvm::raw_svector_ostream objStream(objBuffer);
+        llvm::legacy::PassManager objPM;
+        if (TM_->addPassesToEmitFile(
+                objPM,
+                objStream,
+                nullptr,
+                llvm::TargetMachine::CodeGenFileType::CGFT_ObjectFile)) {
+          throw std::runtime_error("Target can't emit object files");
+        }
+        objPM.run(*module_);
+        return fuser::CachedKernel{"wrapper", objStream.str().str()};
+      });
+  cantFail(jit_->addObject(
+      llvm::MemoryBuffer::getMemBufferCopy(cached.binary, "pytorch")));
 }
 
 // TODO: The binary ops are copypasta.
@@ -960,7 +1012,117 @@ void LLVMCodeGenImpl::visit(const Load* v) {
   value_ = load;
 }
 
+// Collects the vars used in a statement, in the order they appear.
+class UsedVarsCollector : public IRVisitor {
+ public:
+  const std::vector<const Var*>& vars() const {
+    return vars_;
+  }
+
+  void visit(const Var* v) override {
+    if (seen_.insert(v).second) {
+      vars_.push_back(v);
+    }
+  }
+
+ private:
+  std::unordered_set<const Var*> seen_;
+  std::vector<const Var*> vars_;
+};
+
+// The body of a parallel loop is outlined into a function taking the index
+// of the iteration and an array of pointers to the values it uses from the
+// enclosing code. DispatchParallel (see llvm_jit.cpp) then calls it for each
+// index from at::parallel_for.
+void LLVMCodeGenImpl::emitParallelFor(const For* v) {
+  v->start()->accept(this);
+  auto start = irb_.CreateSExt(value_, LongTy_);
+  v->stop()->accept(this);
+  auto stop = irb_.CreateSExt(value_, LongTy_);
+
+  std::vector<std::pair<const Var*, llvm::Value*>> captured;
+  UsedVarsCollector collector;
+  v->body()->accept(&collector);
+  for (const Var* var : collector.vars()) {
+    auto it = varToVal_.find(var);
+    if (it != varToVal_.end()) {
+      captured.emplace_back(var, it->second);
+    }
+  }
+
+  // Pack the captured values. The allocas go in the entry block, so that the
+  // stack doesn't grow when the loop is nested in another one.
+  auto voidPtrTy = llvm::Type::getInt8PtrTy(getContext());
+  auto voidPtrPtrTy = voidPtrTy->getPointerTo();
+  llvm::IRBuilder<> entryIrb(
+      &fn_->getEntryBlock(), fn_->getEntryBlock().begin());
+  auto packed = entryIrb.CreateAlloca(
+      voidPtrTy,
+      llvm::ConstantInt::getSigned(
+          IntTy_, std::max<size_t>(captured.size(), 1)));
+  for (size_t i = 0; i < captured.size(); i++) {
+    llvm::Value* val = captured[i].second;
+    auto slot = entryIrb.CreateAlloca(val->getType());
+    irb_.CreateStore(val, slot);
+    irb_.CreateStore(
+        irb_.CreatePointerCast(slot, voidPtrTy),
+        irb_.CreateGEP(packed, llvm::ConstantInt::getSigned(IntTy_, i)));
+  }
+
+  auto bodyFn = llvm::Function::Create(
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()), {LongTy_, voidPtrPtrTy}, false),
+      llvm::Function::PrivateLinkage,
+      "parallel_body",
+      module_.get());
+
+  // Emit the body in the outlined function, with the captured values
+  // unpacked and the loop var bound to the index.
+  auto callerFn = fn_;
+  auto callerBB = irb_.GetInsertBlock();
+  auto callerVarToVal = varToVal_;
+  fn_ = bodyFn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  auto index = fn_->arg_begin();
+  auto args = fn_->arg_begin() + 1;
+  varToVal_.clear();
+  for (size_t i = 0; i < captured.size(); i++) {
+    auto slot = irb_.CreateLoad(
+        irb_.CreateGEP(args, llvm::ConstantInt::getSigned(IntTy_, i)));
+    varToVal_[captured[i].first] = irb_.CreateLoad(irb_.CreatePointerCast(
+        slot, captured[i].second->getType()->getPointerTo()));
+  }
+  varToVal_[v->var()] =
+      irb_.CreateTrunc(index, dtypeToLLVM(v->var()->dtype()));
+  v->body()->accept(this);
+  irb_.CreateRetVoid();
+  if (llvm::verifyFunction(*fn_, &llvm::outs())) {
+    throw std::runtime_error("Function verification failed");
+  }
+
+  fn_ = callerFn;
+  irb_.SetInsertPoint(callerBB);
+  varToVal_ = std::move(callerVarToVal);
+
+  auto dispatch = module_->getOrInsertFunction(
+      "DispatchParallel",
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()),
+          {voidPtrTy, LongTy_, LongTy_, voidPtrPtrTy},
+          false),
+      {});
+  irb_.CreateCall(
+      dispatch,
+      {irb_.CreatePointerCast(bodyFn, voidPtrTy), start, stop, packed});
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
+
 void LLVMCodeGenImpl::visit(const For* v) {
+  if (v->loop_options().is_parallel()) {
+    emitParallelFor(v);
+    return;
+  }
+
   // Create "start" and "stop" values.
   v->start()->accept(this);
   auto start = this->value_;
@@ -2,6 +2,7 @@
 
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <ATen/Parallel.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <sleef.h>
 #include <algorithm>
@@ -12,6 +13,22 @@
 namespace llvm {
 namespace orc {
 
+// Runs the outlined body of a parallel loop (see LLVMCodeGenImpl) for each
+// index in [start, stop).
+static void dispatchParallel(
+    int8_t* func,
+    int64_t start,
+    int64_t stop,
+    int8_t** packed_data) {
+  using ParallelBody = void (*)(int64_t, int8_t**);
+  auto body = reinterpret_cast<ParallelBody>(func);
+  at::parallel_for(start, stop, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t index = begin; index < end; index++) {
+      body(index, packed_data);
+    }
+  });
+}
+
 // Lightly modified implementation from LLVM's Kaleidoscope JIT tutorial:
 // https://llvm.org/docs/tutorial/BuildingAJIT1.html
 class TORCH_API PytorchLLVMJITImpl {
@@ -416,6 +433,11 @@ class TORCH_API PytorchLLVMJITImpl {
         *Mangle("Sleef_fmodd4"),
         {llvm::pointerToJITTargetAddress(&Sleef_fmodd4), {}}));
 #endif
+
+    // Runtime support for the parallel loops
+    cantFail(LLJ->defineAbsolute(
+        *Mangle("DispatchParallel"),
+        {llvm::pointerToJITTargetAddress(&dispatchParallel), {}}));
   }
 
   Error addModule(ThreadSafeModule M) {
@@ -425,6 +447,10 @@ class TORCH_API PytorchLLVMJITImpl {
     return Error::success();
   }
 
+  Error addObject(std::unique_ptr<MemoryBuffer> Obj) {
+    return LLJ->addObjectFile(std::move(Obj));
+  }
+
   JITSymbol findSymbol(const std::string Name) {
     return cantFail(LLJ->lookup(Name));
   }
@@ -443,6 +469,10 @@ Error PytorchLLVMJIT::addModule(ThreadSafeModule M) {
   return impl_->addModule(std::move(M));
 }
 
+Error PytorchLLVMJIT::addObject(std::unique_ptr<MemoryBuffer> Obj) {
+  return impl_->addObject(std::move(Obj));
+}
+
 JITSymbol PytorchLLVMJIT::findSymbol(const std::string Name) {
   return impl_->findSymbol(std::move(Name));
 }
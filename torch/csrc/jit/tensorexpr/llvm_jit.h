@@ -6,6 +6,7 @@
 #include <llvm/ExecutionEngine/JITSymbol.h>
 #include <llvm/ExecutionEngine/Orc/Core.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Target/TargetMachine.h>
 
 #include <memory>
@@ -22,6 +23,8 @@ class TORCH_API PytorchLLVMJIT {
   ~PytorchLLVMJIT();
 
   Error addModule(ThreadSafeModule M);
+  // Adds code compiled ahead of time, see LLVMCodeGenImpl::compile
+  Error addObject(std::unique_ptr<MemoryBuffer> Obj);
 
   JITSymbol findSymbol(const std::string Name);
 
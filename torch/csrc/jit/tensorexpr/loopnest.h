@@ -42,6 +42,9 @@ class TORCH_API LoopNest {
 
   void setGPUBlockIndex(For* f, int idx);
   void setGPUThreadIndex(For* f, int idx);
+  // Run the iterations of f in parallel, only supported by the LLVM backend
+  // (the other ones run them in sequence).
+  void setParallel(For* f);
 
   // Insert a temporary computation of statement S in the scope of loop AT.
   // S is assumed to be a Store or a Block containing a Store. Along with the
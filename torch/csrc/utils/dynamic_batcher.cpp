@@ -0,0 +1,329 @@
+#include <torch/csrc/utils/dynamic_batcher.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/grad_mode.h>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <ostream>
+
+namespace torch {
+namespace throughput_benchmark {
+namespace {
+
+// How the first argument of every request of a batch was padded, to cut the
+// outputs back to the length of each request.
+struct Padding {
+  bool padded{false};
+  int64_t padded_length{0};
+  std::vector<int64_t> lengths;
+};
+
+// Stacks the tensors into a batch, padding them to the largest size in every
+// dimension if they don't all have the same sizes.
+at::Tensor batchTensors(
+    const std::vector<at::Tensor>& tensors,
+    double padding_value,
+    bool* padded) {
+  const auto& first = tensors.front();
+  std::vector<int64_t> sizes = first.sizes().vec();
+  bool same_sizes = true;
+  for (const auto& tensor : tensors) {
+    TORCH_CHECK(
+        tensor.dim() == first.dim(),
+        "Can't batch tensors of different dimensions: ",
+        first.dim(),
+        " and ",
+        tensor.dim());
+    for (int64_t d = 0; d < tensor.dim(); d++) {
+      same_sizes &= tensor.size(d) == sizes[d];
+      sizes[d] = std::max(sizes[d], tensor.size(d));
+    }
+  }
+  *padded = !same_sizes;
+  if (same_sizes) {
+    return at::stack(tensors);
+  }
+  sizes.insert(sizes.begin(), static_cast<int64_t>(tensors.size()));
+  auto batch = at::full(sizes, padding_value, first.options());
+  for (size_t i = 0; i < tensors.size(); i++) {
+    auto slot = batch.select(0, i);
+    for (int64_t d = 0; d < tensors[i].dim(); d++) {
+      slot = slot.narrow(d, 0, tensors[i].size(d));
+    }
+    slot.copy_(tensors[i]);
+  }
+  return batch;
+}
+
+// Returns the output of the i-th request of the batch.
+c10::IValue unbatchOutput(
+    const c10::IValue& output,
+    int64_t i,
+    const Padding& padding) {
+  if (output.isTensor()) {
+    auto tensor = output.toTensor().select(0, i);
+    if (padding.padded) {
+      for (int64_t d = 0; d < tensor.dim(); d++) {
+        if (tensor.size(d) == padding.padded_length) {
+          tensor = tensor.narrow(d, 0, padding.lengths[i]);
+        }
+      }
+    }
+    return tensor;
+  }
+  if (output.isTuple()) {
+    std::vector<c10::IValue> elements;
+    for (const auto& element : output.toTuple()->elements()) {
+      elements.push_back(unbatchOutput(element, i, padding));
+    }
+    return c10::ivalue::Tuple::create(std::move(elements));
+  }
+  if (output.isTensorList()) {
+    c10::List<at::Tensor> tensors;
+    for (const at::Tensor& tensor : output.toTensorList()) {
+      tensors.push_back(unbatchOutput(tensor, i, padding).toTensor());
+    }
+    return tensors;
+  }
+  TORCH_CHECK(
+      false,
+      "DynamicBatcher expects the model to return a Tensor, or a tuple or a "
+      "list of them, but got ",
+      output.tagKind());
+}
+
+} // namespace
+
+std::ostream& operator<<(std::ostream& os, const DynamicBatcherStats& value) {
+  return os << "Number of requests: " << value.num_requests
+            << "\n Number of batches: " << value.num_batches
+            << "\n Average batch size: " << value.avg_batch_size
+            << "\n Average latency (ms): " << value.latency_avg_ms
+            << "\n Latency p50 / p90 / p99 (ms): " << value.latency_p50_ms
+            << " / " << value.latency_p90_ms << " / " << value.latency_p99_ms;
+}
+
+DynamicBatcher::DynamicBatcher(DynamicBatcherConfig config)
+    : config_(std::move(config)) {
+  TORCH_CHECK(config_.max_batch_size > 0, "max_batch_size must be positive");
+  TORCH_CHECK(config_.max_delay_us >= 0, "max_delay_us can't be negative");
+  TORCH_CHECK(
+      config_.num_worker_threads > 0, "num_worker_threads must be positive");
+  TORCH_CHECK(config_.latency_window > 0, "latency_window must be positive");
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  shutdown();
+}
+
+void DynamicBatcher::addModel(const std::string& name, jit::Module module) {
+  std::lock_guard<std::mutex> lock(models_mutex_);
+  TORCH_CHECK(!stopped_, "DynamicBatcher has been shut down");
+  TORCH_CHECK(
+      models_.find(name) == models_.end(),
+      "DynamicBatcher already serves a model named ",
+      name);
+  auto model = std::make_unique<Model>(std::move(module));
+  for (int i = 0; i < config_.num_worker_threads; i++) {
+    auto* m = model.get();
+    model->workers.emplace_back([this, m]() { work(*m); });
+  }
+  models_.emplace(name, std::move(model));
+}
+
+DynamicBatcher::Model& DynamicBatcher::getModel(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(models_mutex_);
+  auto it = models_.find(name);
+  TORCH_CHECK(
+      it != models_.end(), "DynamicBatcher doesn't serve a model named ", name);
+  return *it->second;
+}
+
+const jit::Module& DynamicBatcher::module(const std::string& name) const {
+  return getModel(name).module;
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> DynamicBatcher::submit(
+    const std::string& name,
+    std::vector<c10::IValue> inputs) {
+  auto& model = getModel(name);
+  auto future = c10::make_intrusive<c10::ivalue::Future>(c10::AnyType::get());
+  {
+    std::lock_guard<std::mutex> lock(model.mutex);
+    TORCH_CHECK(!model.stopping, "DynamicBatcher has been shut down");
+    model.queue.push_back(Request{std::move(inputs), future, Clock::now()});
+  }
+  model.cv.notify_all();
+  return future;
+}
+
+void DynamicBatcher::work(Model& model) {
+  // The batches are only run for inference.
+  torch::autograd::AutoGradMode no_grad(false);
+  const auto max_batch_size = static_cast<size_t>(config_.max_batch_size);
+  const auto max_delay = std::chrono::microseconds(config_.max_delay_us);
+  std::vector<Request> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(model.mutex);
+      model.cv.wait(
+          lock, [&]() { return model.stopping || !model.queue.empty(); });
+      if (model.queue.empty()) {
+        return;
+      }
+      // Waits for the batch to fill up, until the first request has waited
+      // for max_delay_us.
+      const auto deadline = model.queue.front().submitted + max_delay;
+      model.cv.wait_until(lock, deadline, [&]() {
+        return model.stopping || model.queue.size() >= max_batch_size;
+      });
+      while (!model.queue.empty() && batch.size() < max_batch_size) {
+        batch.push_back(std::move(model.queue.front()));
+        model.queue.pop_front();
+      }
+    }
+    if (!batch.empty()) {
+      runBatch(model, batch);
+      batch.clear();
+    }
+  }
+}
+
+void DynamicBatcher::runBatch(Model& model, std::vector<Request>& batch) {
+  try {
+    const auto num_args = batch.front().inputs.size();
+    for (const auto& request : batch) {
+      TORCH_CHECK(
+          request.inputs.size() == num_args,
+          "Can't batch requests with ",
+          num_args,
+          " and ",
+          request.inputs.size(),
+          " arguments");
+    }
+
+    jit::Stack stack;
+    stack.reserve(num_args + 1);
+    stack.emplace_back(model.module._ivalue());
+    Padding padding;
+    for (size_t arg = 0; arg < num_args; arg++) {
+      if (!batch.front().inputs[arg].isTensor()) {
+        stack.push_back(batch.front().inputs[arg]);
+        continue;
+      }
+      std::vector<at::Tensor> tensors;
+      tensors.reserve(batch.size());
+      for (const auto& request : batch) {
+        TORCH_CHECK(
+            request.inputs[arg].isTensor(),
+            "Argument ",
+            arg,
+            " is a Tensor in some requests of the batch but not in others");
+        tensors.push_back(request.inputs[arg].toTensor());
+      }
+      bool padded = false;
+      stack.emplace_back(batchTensors(tensors, config_.padding_value, &padded));
+      if (arg == 0 && padded && tensors.front().dim() > 0) {
+        padding.padded = true;
+        padding.padded_length = stack.back().toTensor().size(1);
+        for (const auto& tensor : tensors) {
+          padding.lengths.push_back(tensor.size(0));
+        }
+      }
+    }
+
+    auto output = model.module.get_method("forward").function()(std::move(stack));
+    for (size_t i = 0; i < batch.size(); i++) {
+      batch[i].future->markCompleted(unbatchOutput(output, i, padding));
+    }
+  } catch (const std::exception& e) {
+    for (auto& request : batch) {
+      if (!request.future->completed()) {
+        request.future->setError(e.what());
+      }
+    }
+  }
+
+  const auto now = Clock::now();
+  std::lock_guard<std::mutex> lock(model.mutex);
+  const auto window = static_cast<size_t>(config_.latency_window);
+  for (const auto& request : batch) {
+    const float latency_ms =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now - request.submitted)
+            .count() /
+        1000.0 / 1000.0;
+    if (model.latencies_ms.size() < window) {
+      model.latencies_ms.push_back(latency_ms);
+    } else {
+      model.latencies_ms[model.next_latency] = latency_ms;
+    }
+    model.next_latency = (model.next_latency + 1) % window;
+  }
+  model.num_requests += batch.size();
+  model.num_batches++;
+}
+
+DynamicBatcherStats DynamicBatcher::stats(const std::string& name) const {
+  auto& model = getModel(name);
+  DynamicBatcherStats stats;
+  std::vector<float> latencies;
+  {
+    std::lock_guard<std::mutex> lock(model.mutex);
+    latencies = model.latencies_ms;
+    stats.num_requests = model.num_requests;
+    stats.num_batches = model.num_batches;
+  }
+  if (stats.num_batches > 0) {
+    stats.avg_batch_size =
+        static_cast<float>(stats.num_requests) / stats.num_batches;
+  }
+  if (latencies.empty()) {
+    return stats;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    const auto rank = static_cast<size_t>(std::ceil(p * latencies.size()));
+    return latencies[std::min(latencies.size(), std::max<size_t>(rank, 1)) - 1];
+  };
+  double total = 0;
+  for (const auto latency : latencies) {
+    total += latency;
+  }
+  stats.latency_avg_ms = total / latencies.size();
+  stats.latency_p50_ms = percentile(0.5);
+  stats.latency_p90_ms = percentile(0.9);
+  stats.latency_p99_ms = percentile(0.99);
+  return stats;
+}
+
+void DynamicBatcher::shutdown() {
+  std::vector<Model*> models;
+  {
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+    for (auto& entry : models_) {
+      models.push_back(entry.second.get());
+    }
+  }
+  for (auto* model : models) {
+    {
+      std::lock_guard<std::mutex> lock(model->mutex);
+      model->stopping = true;
+    }
+    model->cv.notify_all();
+    for (auto& worker : model->workers) {
+      worker.join();
+    }
+    model->workers.clear();
+  }
+}
+
+} // namespace throughput_benchmark
+} // namespace torch
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/jit/api/module.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace throughput_benchmark {
+
+/**
+ * Use this struct in order to configure how a DynamicBatcher groups the
+ * requests of a model into batches.
+ */
+struct DynamicBatcherConfig {
+ public:
+  // The largest number of requests run as a single batch.
+  int64_t max_batch_size{8};
+  // How long the first request of a batch waits for more requests to arrive,
+  // before the batch is run with the requests it has.
+  int64_t max_delay_us{1000};
+  // Number of threads running the batches of each model.
+  int num_worker_threads{1};
+  // The value the shorter tensors of a batch are padded with, when the
+  // requests don't all have the same sizes.
+  double padding_value{0};
+  // Number of latencies kept per model to compute the percentiles. The oldest
+  // latencies are dropped first.
+  int64_t latency_window{10000};
+};
+
+/**
+ * The latencies of the requests of a model, from submission to completion,
+ * over the last DynamicBatcherConfig::latency_window requests.
+ */
+struct DynamicBatcherStats {
+  int64_t num_requests{0};
+  int64_t num_batches{0};
+  float avg_batch_size{0};
+  float latency_avg_ms{-1};
+  float latency_p50_ms{-1};
+  float latency_p90_ms{-1};
+  float latency_p99_ms{-1};
+};
+
+std::ostream& operator<<(std::ostream& os, const DynamicBatcherStats& value);
+
+/**
+ * This class is a small c++ component which serves requests to one or more
+ * ScriptModules the way an inference server would: requests are queued per
+ * model, and worker threads run them in batches of up to max_batch_size
+ * requests, waiting at most max_delay_us for a batch to fill up.
+ *
+ * A request is the positional arguments of the model's forward, without their
+ * batch dimension (ScriptModuleInput without the module). The tensor
+ * arguments at each position are stacked into a batch, after padding them to
+ * the largest size in every dimension with padding_value, so that sequences of
+ * variable lengths can be batched. The other arguments must be the same for
+ * all the requests of a batch, and the first one is used.
+ *
+ * The output of the model, a tensor or a tuple or list of them, is split back
+ * along the batch dimension. When the first arguments were padded, the output
+ * dimensions whose size is the padded length of the first arguments (their
+ * size in dimension 0, e.g. the length of a sequence) are cut back to the
+ * length of the request's own first argument.
+ */
+class C10_HIDDEN DynamicBatcher {
+ public:
+  explicit DynamicBatcher(DynamicBatcherConfig config);
+  ~DynamicBatcher();
+
+  DynamicBatcher(const DynamicBatcher&) = delete;
+  DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+
+  // Starts serving the requests for `name` with the module. Must be called
+  // before any request for the model is submitted.
+  void addModel(const std::string& name, jit::Module module);
+
+  // Queues a request to the model, and returns the future of its output.
+  c10::intrusive_ptr<c10::ivalue::Future> submit(
+      const std::string& name,
+      std::vector<c10::IValue> inputs);
+
+  // Returns the module serving the requests for `name`.
+  const jit::Module& module(const std::string& name) const;
+
+  DynamicBatcherStats stats(const std::string& name) const;
+
+  // Runs the requests already queued and stops the worker threads. Requests
+  // submitted after are rejected.
+  void shutdown();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Request {
+    std::vector<c10::IValue> inputs;
+    c10::intrusive_ptr<c10::ivalue::Future> future;
+    Clock::time_point submitted;
+  };
+
+  struct Model {
+    explicit Model(jit::Module module) : module(std::move(module)) {}
+
+    jit::Module module;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Request> queue;
+    bool stopping{false};
+    std::vector<std::thread> workers;
+    // Guarded by mutex.
+    std::vector<float> latencies_ms;
+    size_t next_latency{0};
+    int64_t num_requests{0};
+    int64_t num_batches{0};
+  };
+
+  void work(Model& model);
+  void runBatch(Model& model, std::vector<Request>& batch);
+  Model& getModel(const std::string& name) const;
+
+  const DynamicBatcherConfig config_;
+  mutable std::mutex models_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Model>> models_;
+  bool stopped_{false};
+};
+
+} // namespace throughput_benchmark
+} // namespace torch
@@ -1,4 +1,6 @@
 #include <ATen/core/ivalue.h>
+#include <torch/csrc/jit/python/pybind_utils.h>
+#include <torch/csrc/utils/dynamic_batcher.h>
 #include <torch/csrc/utils/init.h>
 #include <torch/csrc/utils/throughput_benchmark.h>
 
@@ -17,11 +19,30 @@ void initThroughputBenchmarkBindings(PyObject* module) {
       .def_readwrite("num_worker_threads", &BenchmarkConfig::num_worker_threads)
       .def_readwrite("num_warmup_iters", &BenchmarkConfig::num_warmup_iters)
       .def_readwrite("num_iters", &BenchmarkConfig::num_iters)
-      .def_readwrite("profiler_output_path", &BenchmarkConfig::profiler_output_path);
+      .def_readwrite("profiler_output_path", &BenchmarkConfig::profiler_output_path)
+      .def_readwrite("cpu_affinity", &BenchmarkConfig::cpu_affinity);
+
+  py::class_<BenchmarkThreadStats>(m, "BenchmarkThreadStats")
+      .def_readonly("num_iters", &BenchmarkThreadStats::num_iters)
+      .def_readonly("latency_avg_ms", &BenchmarkThreadStats::latency_avg_ms)
+      .def_readonly("latency_p50_ms", &BenchmarkThreadStats::latency_p50_ms)
+      .def_readonly("latency_p99_ms", &BenchmarkThreadStats::latency_p99_ms);
 
   py::class_<BenchmarkExecutionStats>(m, "BenchmarkExecutionStats")
       .def_readonly("latency_avg_ms", &BenchmarkExecutionStats::latency_avg_ms)
-      .def_readonly("num_iters", &BenchmarkExecutionStats::num_iters);
+      .def_readonly("num_iters", &BenchmarkExecutionStats::num_iters)
+      .def_readonly("latency_p50_ms", &BenchmarkExecutionStats::latency_p50_ms)
+      .def_readonly("latency_p90_ms", &BenchmarkExecutionStats::latency_p90_ms)
+      .def_readonly("latency_p99_ms", &BenchmarkExecutionStats::latency_p99_ms)
+      .def_readonly(
+          "latency_p999_ms", &BenchmarkExecutionStats::latency_p999_ms)
+      .def_readonly("latency_max_ms", &BenchmarkExecutionStats::latency_max_ms)
+      .def_readonly(
+          "warmup_latency_avg_ms",
+          &BenchmarkExecutionStats::warmup_latency_avg_ms)
+      .def_readonly("thread_stats", &BenchmarkExecutionStats::thread_stats)
+      .def_readonly(
+          "latency_histogram", &BenchmarkExecutionStats::latency_histogram);
 
   py::class_<ThroughputBenchmark>(m, "ThroughputBenchmark", py::dynamic_attr())
       .def(py::init<jit::Module>())
@@ -46,7 +67,56 @@ void initThroughputBenchmarkBindings(PyObject* module) {
         return self.benchmark(config);
       });
 
+  py::class_<DynamicBatcherConfig>(m, "DynamicBatcherConfig")
+      .def(py::init<>())
+      .def_readwrite("max_batch_size", &DynamicBatcherConfig::max_batch_size)
+      .def_readwrite("max_delay_us", &DynamicBatcherConfig::max_delay_us)
+      .def_readwrite(
+          "num_worker_threads", &DynamicBatcherConfig::num_worker_threads)
+      .def_readwrite("padding_value", &DynamicBatcherConfig::padding_value)
+      .def_readwrite("latency_window", &DynamicBatcherConfig::latency_window);
 
+  py::class_<DynamicBatcherStats>(m, "DynamicBatcherStats")
+      .def_readonly("num_requests", &DynamicBatcherStats::num_requests)
+      .def_readonly("num_batches", &DynamicBatcherStats::num_batches)
+      .def_readonly("avg_batch_size", &DynamicBatcherStats::avg_batch_size)
+      .def_readonly("latency_avg_ms", &DynamicBatcherStats::latency_avg_ms)
+      .def_readonly("latency_p50_ms", &DynamicBatcherStats::latency_p50_ms)
+      .def_readonly("latency_p90_ms", &DynamicBatcherStats::latency_p90_ms)
+      .def_readonly("latency_p99_ms", &DynamicBatcherStats::latency_p99_ms);
+
+  py::class_<DynamicBatcher>(m, "DynamicBatcher")
+      .def(py::init<DynamicBatcherConfig>())
+      .def(
+          "add_model",
+          &DynamicBatcher::addModel,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "submit",
+          [](DynamicBatcher& self,
+             const std::string& name,
+             py::args args,
+             py::kwargs kwargs) {
+            // The request is the stack of forward without the module, which
+            // the batch of requests is run with.
+            const auto& module = self.module(name);
+            auto stack = jit::createStackForSchema(
+                module.get_method("forward").function().getSchema(),
+                std::move(args),
+                std::move(kwargs),
+                module._ivalue());
+            stack.erase(stack.begin());
+            return std::make_shared<jit::PythonFutureWrapper>(
+                self.submit(name, std::move(stack)));
+          })
+      .def(
+          "stats",
+          &DynamicBatcher::stats,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "shutdown",
+          &DynamicBatcher::shutdown,
+          py::call_guard<py::gil_scoped_release>());
 }
 
 } // namespace throughput_benchmark
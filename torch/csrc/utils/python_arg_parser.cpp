@@ -9,6 +9,7 @@
 #include <ATen/ATen.h>
 #include <ATen/TracerMode.h>
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -798,6 +799,35 @@ void PythonArgParser::check_deprecated(const FunctionSignature & signature) {
   }
 }
 
+// Computes the key of a call whose positional arguments are all plain tensors
+// or Python numbers, and returns false for any other call. The key holds
+// everything that FunctionParameter::check looks at for such arguments: their
+// types, and for tensors, whether they are 0-dim, require grad or are
+// integral, which decides whether they can be used as scalars. Two calls with
+// the same key thus succeed or fail to parse with every signature alike.
+template <size_t N>
+static bool overload_cache_key(PyObject* args, std::array<uintptr_t, N>& key) {
+  const auto nargs = PyTuple_GET_SIZE(args);
+  if (nargs > static_cast<ssize_t>(N)) {
+    return false;
+  }
+  for (ssize_t i = 0; i < nargs; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(args, i);
+    auto type = reinterpret_cast<uintptr_t>(Py_TYPE(obj));
+    if (THPVariable_CheckExact(obj)) {
+      const auto& var = reinterpret_cast<THPVariable*>(obj)->cdata;
+      // Type objects are aligned, which leaves their low bits free.
+      type |= (var.dim() == 0 ? 1 : 0) |
+          (var.requires_grad() ? 2 : 0) |
+          (at::isIntegralType(var.scalar_type(), /*includeBool=*/false) ? 4 : 0);
+    } else if (!PyFloat_CheckExact(obj) && !PyLong_CheckExact(obj) && !PyBool_Check(obj)) {
+      return false;
+    }
+    key[i] = type;
+  }
+  return true;
+}
+
 PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]) {
   if (signatures_.size() == 1) {
     auto& signature = signatures_[0];
@@ -806,8 +836,27 @@ PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject
     return PythonArgs(traceable, signature, parsed_args);
   }
 
-  for (auto& signature : signatures_) {
+  std::array<uintptr_t, kMaxCachedArgs> key;
+  const auto nargs = PyTuple_GET_SIZE(args);
+  const bool cacheable = (!kwargs || PyDict_Size(kwargs) == 0) &&
+      overload_cache_key(args, key);
+  if (cacheable && cached_nargs_ == nargs &&
+      std::equal(key.begin(), key.begin() + nargs, cached_key_.begin())) {
+    auto& signature = signatures_[cached_signature_];
+    if (signature.parse(args, kwargs, parsed_args, false)) {
+      check_deprecated(signature);
+      return PythonArgs(traceable, signature, parsed_args);
+    }
+  }
+
+  for (size_t i = 0; i < signatures_.size(); i++) {
+    auto& signature = signatures_[i];
     if (signature.parse(args, kwargs, parsed_args, false)) {
+      if (cacheable) {
+        cached_key_ = key;
+        cached_nargs_ = nargs;
+        cached_signature_ = i;
+      }
       check_deprecated(signature);
       return PythonArgs(traceable, signature, parsed_args);
     }
@@ -112,6 +112,16 @@ private:
   std::string function_name;
   ssize_t max_args;
   bool traceable;
+
+  // The signature which matched the last call made with positional tensors
+  // and numbers only, together with the key of its arguments (see
+  // overload_cache_key in python_arg_parser.cpp). A call with the same key
+  // can't match any signature before it, so raw_parse tries it first. Only
+  // accessed with the GIL held.
+  static constexpr ssize_t kMaxCachedArgs = 4;
+  std::array<uintptr_t, kMaxCachedArgs> cached_key_;
+  ssize_t cached_nargs_ = -1;
+  ssize_t cached_signature_ = -1;
 };
 
 struct PYBIND11_EXPORT FunctionSignature {
@@ -0,0 +1,124 @@
+#include <torch/csrc/utils/tensor_arrow.h>
+
+#include <torch/csrc/Exceptions.h>
+#include <torch/csrc/utils/object_ptr.h>
+
+#include <c10/util/Exception.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+// The structures of the Arrow C data interface, as laid out in
+// https://arrow.apache.org/docs/format/CDataInterface.html. The interface is
+// meant to be copied into the projects which use it, rather than linked.
+struct ArrowSchema {
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+  void (*release)(struct ArrowSchema*);
+  void* private_data;
+};
+
+struct ArrowArray {
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+  void (*release)(struct ArrowArray*);
+  void* private_data;
+};
+
+struct ReleaseArrowSchema {
+  void operator()(ArrowSchema* schema) const {
+    if (schema->release != nullptr) {
+      schema->release(schema);
+    }
+    delete schema;
+  }
+};
+
+struct ReleaseArrowArray {
+  void operator()(ArrowArray* array) const {
+    if (array->release != nullptr) {
+      array->release(array);
+    }
+    delete array;
+  }
+};
+
+at::ScalarType arrow_format_to_aten(const char* format) {
+  // Only the fixed-width primitive formats can be viewed as tensors. Booleans
+  // are bit-packed in Arrow, and so can't.
+  if (format != nullptr && format[0] != '\0' && format[1] == '\0') {
+    switch (format[0]) {
+      case 'c': return at::kChar;
+      case 'C': return at::kByte;
+      case 's': return at::kShort;
+      case 'i': return at::kInt;
+      case 'l': return at::kLong;
+      case 'e': return at::kHalf;
+      case 'f': return at::kFloat;
+      case 'g': return at::kDouble;
+      default: break;
+    }
+  }
+  throw torch::TypeError(
+      "can't convert an Arrow array of format '%s' to a tensor. The only "
+      "supported formats are: int8, uint8, int16, int32, int64, float16, "
+      "float32 and float64.", format != nullptr ? format : "");
+}
+
+} // namespace
+
+namespace torch { namespace utils {
+
+at::Tensor tensor_from_arrow(PyObject* obj) {
+  std::unique_ptr<ArrowSchema, ReleaseArrowSchema> schema(new ArrowSchema());
+  std::unique_ptr<ArrowArray, ReleaseArrowArray> array(new ArrowArray());
+  THPObjectPtr result(PyObject_CallMethod(
+      obj,
+      "_export_to_c",
+      "KK",
+      static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(array.get())),
+      static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(schema.get()))));
+  if (!result) {
+    throw python_error();
+  }
+  TORCH_CHECK(
+      array->release != nullptr && schema->release != nullptr,
+      "_export_to_c() of ", Py_TYPE(obj)->tp_name, " didn't export an Arrow array");
+
+  const auto dtype = arrow_format_to_aten(schema->format);
+  TORCH_CHECK_VALUE(
+      array->null_count == 0 || array->buffers[0] == nullptr,
+      "can't convert an Arrow array with ", array->null_count,
+      " null values to a tensor");
+  TORCH_CHECK_VALUE(
+      array->n_buffers == 2 && array->n_children == 0,
+      "expected a primitive Arrow array with 2 buffers, but got ",
+      array->n_buffers, " buffers and ", array->n_children, " children");
+
+  auto data = static_cast<const char*>(array->buffers[1]) +
+      array->offset * static_cast<int64_t>(c10::elementSize(dtype));
+  const auto length = array->length;
+  // Arrow arrays are immutable, like the buffers of bytes objects which
+  // torch.frombuffer also views.
+  return at::from_blob(
+      const_cast<char*>(data),
+      {length},
+      [array = array.release()](void*) { ReleaseArrowArray()(array); },
+      at::device(at::kCPU).dtype(dtype));
+}
+
+}} // namespace torch::utils
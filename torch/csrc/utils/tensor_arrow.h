@@ -0,0 +1,14 @@
+#pragma once
+
+#include <torch/csrc/python_headers.h>
+#include <ATen/ATen.h>
+
+namespace torch { namespace utils {
+
+// Returns a 1-D CPU tensor sharing memory with a primitive Arrow array, which
+// is exported through the Arrow C data interface by calling
+// `obj._export_to_c(array_address, schema_address)` (as pyarrow arrays do).
+// The exported array is released by the deleter of the tensor.
+at::Tensor tensor_from_arrow(PyObject* obj);
+
+}} // namespace torch::utils
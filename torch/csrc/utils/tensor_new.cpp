@@ -24,6 +24,7 @@
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
 
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -204,6 +205,25 @@ ScalarType infer_scalar_type(PyObject *obj) {
   AT_ERROR("Could not infer dtype of ", Py_TYPE(obj)->tp_name);
 }
 
+// Stores a sequence of floats into the innermost dimension, reading exact
+// Python floats in place instead of going through store_scalar.
+template <typename T>
+void store_floats(char* data, int64_t stride, PyObject** items, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    PyObject* item = items[i];
+    *reinterpret_cast<T*>(data) = static_cast<T>(
+        PyFloat_CheckExact(item) ? PyFloat_AS_DOUBLE(item) : THPUtils_unpackDouble(item));
+    data += stride;
+  }
+}
+
+void store_longs(char* data, int64_t stride, PyObject** items, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    *reinterpret_cast<int64_t*>(data) = THPUtils_unpackLong(items[i]);
+    data += stride;
+  }
+}
+
 void recursive_store(char* data, IntArrayRef sizes, IntArrayRef strides, int64_t dim,
                             ScalarType scalarType, int elementSize, PyObject* obj) {
   int64_t ndim = sizes.size();
@@ -222,6 +242,17 @@ void recursive_store(char* data, IntArrayRef sizes, IntArrayRef strides, int64_t
   }
 
   PyObject** items = PySequence_Fast_ITEMS(seq.get());
+  if (dim + 1 == ndim) {
+    // The innermost dimension of the common dtypes is stored with one loop,
+    // rather than with a call and a dtype switch per element.
+    const auto stride = strides[dim] * elementSize;
+    switch (scalarType) {
+      case at::kFloat: return store_floats<float>(data, stride, items, n);
+      case at::kDouble: return store_floats<double>(data, stride, items, n);
+      case at::kLong: return store_longs(data, stride, items, n);
+      default: break;
+    }
+  }
   for (int64_t i = 0; i < n; i++) {
     recursive_store(data, sizes, strides, dim + 1, scalarType, elementSize, items[i]);
     data += strides[dim] * elementSize;
@@ -775,4 +806,71 @@ Tensor new_ones(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObj
   throw std::runtime_error("new_ones(): invalid arguments");
 }
 
+Tensor tensor_frombuffer(at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
+  static PythonArgParser parser({
+    "frombuffer(PyObject* buffer, *, ScalarType dtype=None, int64_t count=-1, int64_t offset=0, bool requires_grad=False)",
+  });
+
+  ParsedArgs<5> parsed_args;
+  auto r = parser.parse(args, kwargs, parsed_args);
+  if (r.idx != 0) {
+    throw std::runtime_error("frombuffer(): invalid arguments");
+  }
+  PyObject* obj = r.pyobject(0);
+  const auto dtype = r.scalartypeWithDefault(1, scalar_type);
+  auto count = r.toInt64(2);
+  const auto offset = r.toInt64(3);
+
+  // The buffer is released by the deleter of the tensor, which keeps the
+  // exporting object alive and its memory in place until then.
+  auto view = std::make_unique<Py_buffer>();
+  if (PyObject_GetBuffer(obj, view.get(), PyBUF_WRITABLE) != 0) {
+    PyErr_Clear();
+    if (PyObject_GetBuffer(obj, view.get(), PyBUF_SIMPLE) != 0) {
+      throw TypeError(
+          "frombuffer(): expected an object implementing the buffer protocol (got %s)",
+          Py_TYPE(obj)->tp_name);
+    }
+    TORCH_WARN_ONCE(
+      "The given buffer is not writable, and PyTorch does not support "
+      "non-writable tensors. This means you can write to the underlying "
+      "(supposedly non-writable) buffer using the tensor. You may want to copy "
+      "the buffer to protect its data or make it writable before converting it "
+      "to a tensor. This type of warning will be suppressed for the rest of "
+      "this program.");
+  }
+  auto release = [](Py_buffer* view) {
+    pybind11::gil_scoped_acquire gil;
+    PyBuffer_Release(view);
+    delete view;
+  };
+  std::unique_ptr<Py_buffer, decltype(release)> owner(view.release(), release);
+
+  const auto element_size = static_cast<int64_t>(c10::elementSize(dtype));
+  const auto length = static_cast<int64_t>(owner->len);
+  TORCH_CHECK_VALUE(
+      offset >= 0 && offset <= length,
+      "frombuffer(): offset must be within [0, ", length, "] (got ", offset, ")");
+  if (count < 0) {
+    TORCH_CHECK_VALUE(
+        (length - offset) % element_size == 0,
+        "frombuffer(): the ", length - offset, " bytes of the buffer after the offset "
+        "are not a multiple of the element size ", element_size);
+    count = (length - offset) / element_size;
+  }
+  TORCH_CHECK_VALUE(
+      offset + count * element_size <= length,
+      "frombuffer(): requested ", count, " elements at offset ", offset,
+      ", but the buffer only has ", length, " bytes");
+
+  auto data = static_cast<char*>(owner->buf) + offset;
+  auto tensor = at::from_blob(
+      data,
+      {count},
+      [view = owner.release(), release](void*) { release(view); },
+      at::device(kCPU).dtype(dtype));
+  tensor.set_requires_grad(r.toBool(4));
+  return tensor;
+}
+
 }} // namespace torch::utils
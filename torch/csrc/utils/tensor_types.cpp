@@ -21,6 +21,8 @@ static const char* backend_to_string(const at::Backend& backend) {
     case at::Backend::CUDA: return "torch.cuda";
     case at::Backend::SparseCPU: return "torch.sparse";
     case at::Backend::SparseCUDA: return "torch.cuda.sparse";
+    case at::Backend::SparseCsrCPU: return "torch.sparse_csr";
+    case at::Backend::SparseCsrCUDA: return "torch.cuda.sparse_csr";
     default: AT_ERROR("Unimplemented backend ", backend);
   }
 }
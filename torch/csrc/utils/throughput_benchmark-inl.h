@@ -1,8 +1,15 @@
 #pragma once
 
+#include <chrono>
+#include <cstring>
 #include <random>
 #include <thread>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <torch/csrc/utils/pybind.h>
@@ -13,6 +20,26 @@ namespace torch {
 namespace throughput_benchmark {
 namespace detail {
 
+// Pins the calling thread to the CPU, warning instead of failing if it can't.
+inline void pinThreadToCpu(int cpu) {
+#ifdef __linux__
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  const int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  if (err != 0) {
+    TORCH_WARN(
+        "Failed to pin a calling thread to CPU ", cpu, ": ", std::strerror(err));
+  }
+#else
+  TORCH_WARN_ONCE("Pinning calling threads to CPUs is only supported on Linux");
+#endif
+}
+
+inline float nsToMs(double ns) {
+  return ns / 1000.0 / 1000.0;
+}
+
 template <class Input, class Output, class Model>
 BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     const BenchmarkConfig& config) const {
@@ -57,16 +84,30 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   bool start{false};
   std::atomic<int64_t> num_attempted_iters{0};
   std::vector<std::thread> callers;
+  // Every thread records the latencies of its own iterations, so that the
+  // measurements don't contend with each other.
+  using Clock = std::chrono::high_resolution_clock;
+  std::vector<LatencyHistogram> thread_latencies(config.num_calling_threads);
+  std::vector<double> thread_warmup_ns(config.num_calling_threads, 0);
 
   for (auto thread_id = 0; thread_id < config.num_calling_threads;
        ++thread_id) {
     callers.emplace_back([&, thread_id]() {
+      if (!config.cpu_affinity.empty()) {
+        pinThreadToCpu(
+            config.cpu_affinity[thread_id % config.cpu_affinity.size()]);
+      }
       // We use conditional variable as a barrier to make sure each thread
       // performs required warmeup iterations before we start measuring
+      const auto warmup_start = Clock::now();
       for (auto j = 0; j < config.num_warmup_iters; ++j) {
         runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
         ++input_iters[thread_id];
       }
+      thread_warmup_ns[thread_id] =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              Clock::now() - warmup_start)
+              .count();
       {
         std::unique_lock<std::mutex> lock(m);
         ++initialized;
@@ -76,8 +117,13 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
         }
       }
       LOG(INFO) << "Starting forward thread " << thread_id;
+      auto& latencies = thread_latencies[thread_id];
       while (num_attempted_iters.fetch_add(1) < config.num_iters) {
+        const auto iter_start = Clock::now();
         runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
+        latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             Clock::now() - iter_start)
+                             .count());
         ++input_iters[thread_id];
       }
 
@@ -92,7 +138,6 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     });
   }
 
-  using Clock = std::chrono::high_resolution_clock;
   using TimePoint = std::chrono::time_point<Clock>;
   TimePoint start_time;
 
@@ -138,6 +183,36 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   for (auto& t : callers) {
     t.join();
   }
+
+  LatencyHistogram latencies;
+  double warmup_ns = 0;
+  for (int thread_id = 0; thread_id < config.num_calling_threads; ++thread_id) {
+    const auto& thread_latency = thread_latencies[thread_id];
+    BenchmarkThreadStats thread_stats;
+    thread_stats.num_iters = thread_latency.count();
+    if (thread_latency.count() > 0) {
+      thread_stats.latency_avg_ms = nsToMs(thread_latency.mean());
+      thread_stats.latency_p50_ms = nsToMs(thread_latency.quantile(0.5));
+      thread_stats.latency_p99_ms = nsToMs(thread_latency.quantile(0.99));
+    }
+    stats.thread_stats.push_back(thread_stats);
+    latencies.merge(thread_latency);
+    warmup_ns += thread_warmup_ns[thread_id];
+  }
+  if (latencies.count() > 0) {
+    stats.latency_p50_ms = nsToMs(latencies.quantile(0.5));
+    stats.latency_p90_ms = nsToMs(latencies.quantile(0.9));
+    stats.latency_p99_ms = nsToMs(latencies.quantile(0.99));
+    stats.latency_p999_ms = nsToMs(latencies.quantile(0.999));
+    stats.latency_max_ms = nsToMs(latencies.max());
+    for (const auto& bucket : latencies.buckets()) {
+      stats.latency_histogram.emplace_back(nsToMs(bucket.first), bucket.second);
+    }
+  }
+  if (config.num_warmup_iters > 0) {
+    stats.warmup_latency_avg_ms = nsToMs(
+        warmup_ns / (config.num_warmup_iters * config.num_calling_threads));
+  }
   return stats;
 }
 
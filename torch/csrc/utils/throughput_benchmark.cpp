@@ -3,12 +3,18 @@
 #include <pybind11/pybind11.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace torch {
 namespace throughput_benchmark {
 
 std::ostream& operator<<(std::ostream& os, const BenchmarkExecutionStats& value) {
     return os << "Average latency / iter (ms): " << value.latency_avg_ms
-              << "\n Total number of iters: " << value.num_iters;
+              << "\n Total number of iters: " << value.num_iters
+              << "\n Latency p50 / p90 / p99 / p99.9 (ms): "
+              << value.latency_p50_ms << " / " << value.latency_p90_ms << " / "
+              << value.latency_p99_ms << " / " << value.latency_p999_ms;
 }
 
 void ThroughputBenchmark::addInput(py::args args, py::kwargs kwargs) {
@@ -63,6 +69,92 @@ BenchmarkExecutionStats ThroughputBenchmark::benchmark(
 
 namespace detail {
 
+namespace {
+// Latencies below 2^kSubBucketBits ns get a bucket of their own. Above, each
+// power of two is split in half as many buckets.
+constexpr int kSubBucketBits = 7;
+constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+constexpr size_t kHalfSubBuckets = kSubBuckets / 2;
+constexpr size_t kNumBuckets = (64 - kSubBucketBits + 1) * kHalfSubBuckets +
+    kHalfSubBuckets;
+
+int highestBit(uint64_t value) {
+  int bit = -1;
+  while (value != 0) {
+    value >>= 1;
+    bit++;
+  }
+  return bit;
+}
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : counts_(kNumBuckets, 0) {}
+
+size_t LatencyHistogram::bucketIndex(int64_t latency_ns) {
+  const auto value = static_cast<uint64_t>(std::max<int64_t>(latency_ns, 0));
+  if (value < kSubBuckets) {
+    return value;
+  }
+  const int exponent = highestBit(value) - kSubBucketBits + 1;
+  return exponent * kHalfSubBuckets + (value >> exponent);
+}
+
+int64_t LatencyHistogram::bucketUpperBound(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const size_t exponent = index / kHalfSubBuckets - 1;
+  const uint64_t mantissa = index % kHalfSubBuckets + kHalfSubBuckets;
+  return static_cast<int64_t>(((mantissa + 1) << exponent) - 1);
+}
+
+void LatencyHistogram::record(int64_t latency_ns) {
+  counts_[bucketIndex(latency_ns)]++;
+  count_++;
+  max_ = std::max(max_, latency_ns);
+  sum_ns_ += latency_ns;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  max_ = std::max(max_, other.max_);
+  sum_ns_ += other.sum_ns_;
+}
+
+int64_t LatencyHistogram::quantile(double quantile) const {
+  if (count_ == 0) {
+    return -1;
+  }
+  const auto rank = std::max<int64_t>(
+      1, static_cast<int64_t>(std::ceil(quantile * count_)));
+  int64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      // The bucket's bound can't overshoot the largest latency recorded.
+      return std::min(bucketUpperBound(i), max_);
+    }
+  }
+  return max_;
+}
+
+double LatencyHistogram::mean() const {
+  return count_ == 0 ? -1 : sum_ns_ / count_;
+}
+
+std::vector<std::pair<int64_t, int64_t>> LatencyHistogram::buckets() const {
+  std::vector<std::pair<int64_t, int64_t>> buckets;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    if (counts_[i] != 0) {
+      buckets.emplace_back(bucketUpperBound(i), counts_[i]);
+    }
+  }
+  return buckets;
+}
+
 template <>
 void ScriptModuleBenchmark::runOnce(ScriptModuleInput&& input) const {
   CHECK(initialized_);
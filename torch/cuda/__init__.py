@@ -14,10 +14,11 @@ import torch
 import traceback
 import warnings
 import threading
-from typing import List, Optional, Tuple, Union
+from typing import Dict, List, Optional, Tuple, Union
 from torch._six import raise_from
 from ._utils import _get_device_index, _dummy_type
 from .streams import Stream, Event
+from .graphs import CUDAGraph, graph_pool_handle
 from .. import device as _device
 import torch._C
 
@@ -411,6 +412,29 @@ def ipc_collect():
     return torch._C._cuda_ipc_collect()
 
 
+def ipc_stats() -> Dict[str, int]:
+    r"""Returns a dictionary of counters of the CUDA tensors shared by this
+    process with others, since it started.
+
+    The counters are:
+
+    - ``"blocks_shared"``: number of memory blocks sent to other processes.
+    - ``"events_created"``: number of interprocess events created to let the
+      consumers wait for the blocks.
+    - ``"events_reused"``: number of those events recorded again for new
+      blocks, once the consumers released the blocks they were first recorded
+      for.
+    - ``"stream_syncs"``: number of shares which synchronized the stream
+      instead, because the limit of interprocess events was reached.
+    - ``"ref_counter_files_created"``: number of shared memory files
+      allocated for the reference counters of the blocks.
+    - ``"blocks_in_limbo"``: number of blocks freed by this process which
+      consumers still use. See Note [Sharing CUDA tensors].
+    """
+    _lazy_init()
+    return torch._C._cuda_ipc_stats()
+
+
 def current_stream(device: Optional[_device_t] = None) -> Stream:
     r"""Returns the currently selected :class:`Stream` for a given device.
 
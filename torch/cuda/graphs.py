@@ -0,0 +1,92 @@
+import torch
+
+from ._utils import _dummy_type
+
+
+if not hasattr(torch._C, '_CUDAGraph'):
+    # Define dummy base classes
+    torch._C.__dict__['_CUDAGraph'] = _dummy_type('_CUDAGraph')
+    torch._C.__dict__['_graph_pool_handle'] = _dummy_type('_graph_pool_handle')
+
+
+def graph_pool_handle():
+    r"""Returns an opaque token representing the id of a graph memory pool.
+
+    Passing it as ``pool`` to :meth:`CUDAGraph.capture_begin` of several graphs
+    makes them share a private memory pool. See :class:`CUDAGraph`.
+    """
+    return torch._C._graph_pool_handle()
+
+
+class CUDAGraph(torch._C._CUDAGraph):
+    r"""Wrapper around a CUDA graph.
+
+    The kernels issued to the current stream between :meth:`capture_begin` and
+    :meth:`capture_end` are not run but recorded; :meth:`replay` then launches
+    all of them at once, without the CPU overhead of launching them one by one.
+    Requires CUDA 11.0 or newer.
+
+    Capture must happen on a stream other than the default one. Replays reuse
+    the memory the captured kernels used, so shapes are static: to run the graph
+    on new data, copy it into the input tensors used during capture, replay, and
+    read the tensors the captured region returned. Allocations made during
+    capture come from a private memory pool that stays reserved until the graph
+    is reset or deleted. Random ops using the default CUDA generator draw fresh
+    numbers on every replay.
+
+    Example::
+
+        >>> s = torch.cuda.Stream()
+        >>> static_input = torch.zeros(8, 1024, device='cuda')
+        >>> with torch.cuda.stream(s):
+        ...     # warm up outside of capture, e.g. for cuDNN autotuning
+        ...     model(static_input)
+        ...     g = torch.cuda.CUDAGraph()
+        ...     g.capture_begin()
+        ...     static_output = model(static_input)
+        ...     g.capture_end()
+        >>> torch.cuda.current_stream().wait_stream(s)
+        >>> static_input.copy_(real_input)
+        >>> g.replay()
+        >>> result = static_output.clone()
+
+    .. warning::
+        This API is experimental. Ops that synchronize with the host, use
+        a generator other than the default one of the capturing device, or
+        touch other devices can't be captured.
+    """
+
+    def __new__(cls):
+        return super(CUDAGraph, cls).__new__(cls)
+
+    def capture_begin(self, pool=None):
+        r"""Begins capturing CUDA work on the current stream.
+
+        Arguments:
+            pool (optional): token returned by :func:`graph_pool_handle` or
+                :meth:`other_graph.pool() <CUDAGraph.pool>`, hinting this graph may
+                share memory with the indicated pool. Only safe if the graphs
+                sharing a pool are replayed in the order they were captured.
+        """
+        if pool is None:
+            super(CUDAGraph, self).capture_begin()
+        else:
+            super(CUDAGraph, self).capture_begin(pool)
+
+    def capture_end(self):
+        r"""Ends CUDA graph capture on the current stream and instantiates the graph."""
+        super(CUDAGraph, self).capture_end()
+
+    def replay(self):
+        r"""Replays the CUDA work captured by this graph on the current stream."""
+        super(CUDAGraph, self).replay()
+
+    def reset(self):
+        r"""Deletes the graph held by this instance, releasing its memory pool
+        once no other graph shares it."""
+        super(CUDAGraph, self).reset()
+
+    def pool(self):
+        r"""Returns a token representing the id of this graph's memory pool,
+        which can be passed to another graph's :meth:`capture_begin`."""
+        return super(CUDAGraph, self).pool()
@@ -4,7 +4,7 @@ import warnings
 from typing import Any, Dict, Union
 
 import torch
-from . import is_initialized, _get_device_index
+from . import is_initialized, _get_device_index, _lazy_init
 from torch.types import Device
 
 def _host_allocator():
@@ -87,6 +87,70 @@ def empty_cache() -> None:
         torch._C._cuda_emptyCache()
 
 
+def set_per_process_memory_fraction(fraction, device: Union[Device, int] = None) -> None:
+    r"""Caps the memory the caching allocator may reserve on a CUDA device.
+
+    Once the cap is reached, cached blocks are released, least recently freed
+    first, before an allocation fails with an out-of-memory error.
+
+    Arguments:
+        fraction (float): fraction of the device's total memory, in (0, 1].
+        device (torch.device or int, optional): selected device. Uses the
+            current device, given by :func:`~torch.cuda.current_device`,
+            if :attr:`device` is ``None`` (default).
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    _lazy_init()
+    device = _get_device_index(device, optional=True)
+    if not isinstance(fraction, float):
+        raise TypeError('Invalid type for fraction argument, must be `float`')
+    if fraction <= 0 or fraction > 1:
+        raise ValueError('Invalid fraction value: {}. '
+                         'Allowed range: (0, 1]'.format(fraction))
+    torch._C._cuda_setMemoryFraction(fraction, device)
+
+
+def set_per_process_memory_limit(limit_bytes: int, device: Union[Device, int] = None) -> None:
+    r"""Caps the memory the caching allocator may reserve on a CUDA device, in
+    bytes. Same as :func:`set_per_process_memory_fraction`, which sets the
+    same cap.
+
+    Arguments:
+        limit_bytes (int): the cap in bytes. ``0`` removes the cap.
+        device (torch.device or int, optional): selected device. Uses the
+            current device, given by :func:`~torch.cuda.current_device`,
+            if :attr:`device` is ``None`` (default).
+    """
+    _lazy_init()
+    device = _get_device_index(device, optional=True)
+    if not isinstance(limit_bytes, int) or limit_bytes < 0:
+        raise ValueError('Invalid limit_bytes: {}, must be a non-negative int'.format(limit_bytes))
+    torch._C._cuda_setMemoryLimit(limit_bytes, device)
+
+
+def set_per_process_soft_memory_limit(limit_bytes: int, device: Union[Device, int] = None) -> None:
+    r"""Sets a soft limit on the memory the caching allocator reserves on a
+    CUDA device, in bytes.
+
+    Going over the soft limit releases cached blocks, least recently freed
+    first, but the allocation itself still succeeds.
+
+    Arguments:
+        limit_bytes (int): the soft limit in bytes. ``0`` removes it.
+        device (torch.device or int, optional): selected device. Uses the
+            current device, given by :func:`~torch.cuda.current_device`,
+            if :attr:`device` is ``None`` (default).
+    """
+    _lazy_init()
+    device = _get_device_index(device, optional=True)
+    if not isinstance(limit_bytes, int) or limit_bytes < 0:
+        raise ValueError('Invalid limit_bytes: {}, must be a non-negative int'.format(limit_bytes))
+    torch._C._cuda_setSoftMemoryLimit(limit_bytes, device)
+
+
 def memory_stats(device: Union[Device, int] = None) -> Dict[str, Any]:
     r"""Returns a dictionary of CUDA memory allocator statistics for a
     given device.
@@ -368,6 +432,48 @@ def memory_snapshot():
     return torch._C._cuda_memorySnapshot()
 
 
+def record_memory_history(enabled=True, max_entries=10000, record_backtraces=False):
+    r"""Starts or stops recording CUDA memory allocator events on all devices.
+
+    While enabled, each device keeps the last :attr:`max_entries` allocation,
+    free, segment map/unmap and out-of-memory events in a ring buffer, which
+    can be retrieved with :func:`~torch.cuda.memory_history`. Disabling
+    recording discards the recorded events.
+
+    Arguments:
+        enabled (bool, optional): whether to record events (default: ``True``).
+        max_entries (int, optional): number of events kept per device
+            (default: ``10000``).
+        record_backtraces (bool, optional): capture a C++ backtrace for every
+            event. This is expensive (default: ``False``).
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    _lazy_init()
+    torch._C._cuda_recordMemoryHistory(enabled, max_entries, record_backtraces)
+
+
+def memory_history():
+    r"""Returns the CUDA memory allocator events recorded since
+    :func:`~torch.cuda.record_memory_history` was enabled, oldest first on
+    each device.
+
+    Each event is a dictionary with the keys ``action`` (one of ``"alloc"``,
+    ``"free"``, ``"segment_map"``, ``"segment_unmap"`` and ``"oom"``),
+    ``device``, ``address``, ``size``, ``stream``, ``time_us`` and
+    ``backtrace``.
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    if not is_initialized():
+        return []
+    return torch._C._cuda_memoryHistory()
+
+
 def memory_summary(device: Union[Device, int] = None, abbreviated: bool = False) -> str:
     r"""Returns a human-readable printout of the current memory allocator
     statistics for a given device.
@@ -26,3 +26,4 @@ if is_available():
     # this.
 
     from .distributed_c10d import _backend
+    from .distributed_c10d import _new_hierarchical_group
@@ -20,6 +20,7 @@ from . import (
 )
 from . import ReduceOp
 from . import PrefixStore
+from . import _hierarchical_process_group
 
 
 _MPI_AVAILABLE = True
@@ -367,7 +368,12 @@ def init_process_group(backend,
             the process group. Default value equals 30 minutes.
             This is applicable for the ``gloo`` backend. For ``nccl``, this is
             applicable only if the environment variable ``NCCL_BLOCKING_WAIT``
-            is set to 1.
+            or ``NCCL_ASYNC_ERROR_HANDLING`` is set to 1. With
+            ``NCCL_BLOCKING_WAIT``, ``wait()`` blocks until the operation
+            completes and throws if it times out. With
+            ``NCCL_ASYNC_ERROR_HANDLING``, ``wait()`` doesn't block, a
+            background thread aborts the NCCL communicators of the operations
+            that fail or time out, and the next collective throws the error.
         group_name (str, optional, deprecated): Group name.
 
     To enable ``backend == Backend.MPI``, PyTorch needs to be built from source
@@ -1191,6 +1197,42 @@ def all_gather(tensor_list,
     else:
         work.wait()
 
+def _all_gather_base(output_tensor,
+                     input_tensor,
+                     group=group.WORLD,
+                     async_op=False):
+    """
+    Gathers the tensors from the whole group into a single flat output.
+
+    Arguments:
+        output_tensor (Tensor): Contiguous output tensor, with world size
+            times the elements of ``input_tensor``. The tensor of rank ``i``
+            is gathered at offset ``i * input_tensor.numel()``.
+        input_tensor (Tensor): Tensor to be broadcast from current process.
+        group (ProcessGroup, optional): The process group to work on
+        async_op (bool, optional): Whether this op should be an async op
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group
+
+    """
+    _check_single_tensor(output_tensor, "output_tensor")
+    _check_single_tensor(input_tensor, "input_tensor")
+    if _rank_not_in_group(group):
+        return
+
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg._allgather_base(output_tensor, input_tensor)
+    else:
+        work = group._allgather_base(output_tensor, input_tensor)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
 def all_gather_coalesced(output_tensor_lists,
                          input_tensor_list,
                          group=group.WORLD,
@@ -1792,3 +1834,73 @@ def new_group(ranks=None, timeout=default_pg_timeout, backend=None):
     }
 
     return pg
+
+
+def _new_hierarchical_group(nodes, intra_node_backend=None, inter_node_backend=None,
+                            timeout=default_pg_timeout):
+    """
+    Creates a group of all the processes whose allreduce is done in two
+    levels: a reduce-scatter within each node, an allreduce of the shards
+    across nodes, and an allgather within each node. Each process only sends
+    ``1 / len(nodes[0])`` of the tensor across nodes.
+
+    Like :func:`new_group`, this function must be called by all processes,
+    in the same order.
+
+    Arguments:
+        nodes (list[list[int]]): The ranks of the processes of each node.
+            All the nodes must have the same number of processes, and every
+            rank must be on a node.
+        intra_node_backend (str or Backend, optional): The backend used
+            within a node. By default uses the same backend as the global
+            group. With ``gloo``, which has no reduce-scatter, the first stage
+            is an allreduce within the node.
+        inter_node_backend (str or Backend, optional): The backend used
+            across nodes. By default uses the same backend as the global
+            group.
+        timeout (timedelta, optional): Timeout for operations executed against
+            the process groups.
+
+    Returns:
+        A handle of distributed group that can be given to collective calls.
+        The collectives other than allreduce go through a group of all the
+        processes, that uses ``intra_node_backend``.
+    """
+    _check_default_pg()
+
+    default_backend, _ = _pg_map[_default_pg]
+    global_rank = _default_pg.rank()
+    global_world_size = _default_pg.size()
+
+    nodes = [sorted(node) for node in nodes]
+    if any(len(node) != len(nodes[0]) for node in nodes):
+        raise RuntimeError("All the nodes must have the same number of processes")
+    if sorted(rank for node in nodes for rank in node) != list(range(global_world_size)):
+        raise RuntimeError("Every rank must be on exactly one node")
+
+    intra_node_backend = Backend(intra_node_backend or default_backend)
+
+    intra_node_group = None
+    for node in nodes:
+        group = new_group(node, timeout=timeout, backend=intra_node_backend)
+        if global_rank in node:
+            intra_node_group = group
+
+    # The shards are reduced across nodes by the processes with the same
+    # rank within their node.
+    inter_node_group = None
+    for local_rank in range(len(nodes[0])):
+        ranks = [node[local_rank] for node in nodes]
+        group = new_group(ranks, timeout=timeout, backend=inter_node_backend)
+        if global_rank in ranks:
+            inter_node_group = group
+
+    global_group = new_group(timeout=timeout, backend=intra_node_backend)
+
+    pg = _hierarchical_process_group(
+        intra_node_group,
+        inter_node_group,
+        global_group,
+        intra_node_reduce_scatter=(intra_node_backend != Backend.GLOO))
+    _pg_group_ranks[pg] = {rank: rank for rank in range(global_world_size)}
+    return pg
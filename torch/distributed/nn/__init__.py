@@ -1 +1,2 @@
 from .api.remote_module import RemoteModule
+from .api.sharded_embedding_bag import ShardedEmbeddingBag
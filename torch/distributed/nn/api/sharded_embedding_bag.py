@@ -0,0 +1,84 @@
+from typing import List, Optional
+
+import torch
+import torch.distributed as dist
+from torch import Tensor, nn
+from torch.distributed.distributed_c10d import _get_default_group
+
+
+_MODES = {'sum': 0, 'mean': 1}
+
+
+class ShardedEmbeddingBag(nn.Module):
+    r"""Several embedding bags ("tables") sharded over the ranks of a process
+    group, for models whose embedding tables don't fit on a single device.
+
+    Every rank holds only the shards in :attr:`local_shards`, either whole
+    tables (``ShardingType.TABLE_WISE``) or a contiguous block of the rows of
+    every table (``ShardingType.ROW_WISE``). The forward sends the indices of
+    the local batch to the ranks holding their rows and gets the pooled
+    embeddings back, both with an alltoall. The alltoall of the gradients in
+    the backward runs while the autograd engine carries on with the rest of
+    the backward, and the gradients of the shards are accumulated at its end.
+
+    All ranks must run the forward and the backward of every batch. The dense
+    part of the model can be wrapped in
+    :class:`~torch.nn.parallel.DistributedDataParallel`, but with a different
+    process group than the one of this module.
+
+    Args:
+        num_embeddings (list of int): the number of rows of every table
+        embedding_dims (list of int): the size of the embeddings of every table
+        sharding_type (ShardingType, optional): how the tables are split over
+            the ranks. Default: ``ShardingType.TABLE_WISE``
+        mode (string, optional): ``'sum'`` or ``'mean'``, the reduction of the
+            bags, as in :class:`~torch.nn.EmbeddingBag`. Default: ``'sum'``
+        sparse (bool, optional): if ``True``, the gradients of the shards are
+            sparse tensors. Default: ``False``
+        process_group (ProcessGroup, optional): the process group of the
+            alltoalls. Default: the default process group
+
+    Attributes:
+        weight (ParameterList): the weights of the local shards, initialized
+            from :math:`\mathcal{N}(0, 1)`
+        local_shards (list of tuple): ``(table, row_begin, num_rows, dim)`` for
+            every local shard, in the order of :attr:`weight`
+
+    Shape:
+        - indices: a list of 1-D ``torch.long`` tensors, the indices of the
+          bags of the local batch in every table
+        - offsets: a list of 1-D ``torch.long`` tensors of size :math:`(B)`, the
+          starting position of every bag in the indices of every table
+        - output: :math:`(B, \sum embedding\_dims)`, the pooled embeddings of
+          the tables side by side
+    """
+
+    def __init__(
+        self,
+        num_embeddings: List[int],
+        embedding_dims: List[int],
+        sharding_type=dist.ShardingType.TABLE_WISE,
+        mode: str = 'sum',
+        sparse: bool = False,
+        process_group: Optional[dist.ProcessGroup] = None,
+    ):
+        super(ShardedEmbeddingBag, self).__init__()
+        if mode not in _MODES:
+            raise ValueError("mode has to be one of 'sum' or 'mean', but got {}".format(mode))
+        if process_group is None:
+            process_group = _get_default_group()
+        self.mode = mode
+        self.sparse = sparse
+        self._module = dist._ShardedEmbeddingBag(
+            process_group, list(num_embeddings), list(embedding_dims), sharding_type, _MODES[mode], sparse)
+        self.local_shards = self._module.local_shards()
+        self.weight = nn.ParameterList(
+            [nn.Parameter(torch.empty(num_rows, dim)) for _, _, num_rows, dim in self.local_shards])
+        self.reset_parameters()
+
+    def reset_parameters(self) -> None:
+        for weight in self.weight:
+            nn.init.normal_(weight)
+
+    def forward(self, indices: List[Tensor], offsets: List[Tensor]) -> Tensor:
+        return self._module.forward(list(self.weight), indices, offsets)
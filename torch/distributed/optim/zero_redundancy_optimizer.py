@@ -0,0 +1,179 @@
+import torch
+import torch.distributed as dist
+
+
+class _Bucket(object):
+    def __init__(self, params, world_size, rank):
+        self.params = params
+        numel = sum(p.numel() for p in params)
+        # Padded so that every rank owns a shard of the same size
+        self.shard_numel = (numel + world_size - 1) // world_size
+        padded_numel = self.shard_numel * world_size
+        self.flat_param = torch.zeros(
+            padded_numel, dtype=params[0].dtype, device=params[0].device)
+        self.flat_grad = torch.zeros_like(self.flat_param)
+        self.grad_views = []
+        offset = 0
+        with torch.no_grad():
+            for p in params:
+                n = p.numel()
+                self.flat_param[offset:offset + n].copy_(p.view(-1))
+                # The parameters become views of the flat buffer, so that
+                # gathering the shards rebuilds them in place.
+                p.data = self.flat_param[offset:offset + n].view_as(p)
+                self.grad_views.append(
+                    self.flat_grad[offset:offset + n].view_as(p))
+                offset += n
+        begin = rank * self.shard_numel
+        self.shard = self.flat_param[begin:begin + self.shard_numel]
+        self.shard_grad = torch.empty_like(self.shard)
+        self.pending = len(params)
+        self.work = None
+
+
+class ZeroRedundancyOptimizer(object):
+    r"""
+    Wraps a local optimizer so that each rank only keeps the optimizer state
+    of a shard of the parameters, as in ZeRO (Rajbhandari et al., 2019).
+
+    The parameters are split in buckets of about ``bucket_cap_mb`` megabytes,
+    in the reverse order of ``params`` like in
+    :class:`~torch.nn.parallel.DistributedDataParallel`, and every bucket is
+    flattened and split in one shard per rank. During the backward pass, the
+    gradients of a bucket are reduce-scattered as soon as all of them are
+    ready, so that each rank gets the average gradient of its own shard
+    only. :meth:`step` runs ``optimizer_class`` on the shards, then gathers
+    them to rebuild the parameters on every rank.
+
+    This replaces the gradient allreduce of
+    :class:`~torch.nn.parallel.DistributedDataParallel`, so the model must
+    not be wrapped in it. The parameters must be the same on every rank when
+    the optimizer is created, and :meth:`step` must be called after every
+    backward pass. After :meth:`step`, the gradients of the parameters are
+    the local ones, not the averaged ones.
+
+    Arguments:
+        params (iterable): dense parameters to optimize, in the order they
+            are used in the forward pass.
+        optimizer_class (type): class of the local optimizer, e.g.
+            :class:`torch.optim.Adam`.
+        group (ProcessGroup, optional): The process group to work on.
+        bucket_cap_mb (float, optional): size of the buckets in megabytes.
+        **defaults: arguments of ``optimizer_class``.
+
+    Example::
+        >>> model = nn.Linear(1000, 1000).to(rank)
+        >>> optimizer = ZeroRedundancyOptimizer(
+        >>>     model.parameters(), torch.optim.Adam, lr=1e-3)
+        >>> model(inputs).sum().backward()
+        >>> optimizer.step()
+    """
+
+    def __init__(self, params, optimizer_class, group=dist.group.WORLD,
+                 bucket_cap_mb=25, **defaults):
+        self.group = group
+        if group == dist.group.WORLD:
+            self.world_size = dist.get_world_size()
+            self.rank = dist.get_rank()
+        else:
+            self.world_size = group.size()
+            self.rank = group.rank()
+
+        params = [p for p in params if p.requires_grad]
+        if not params:
+            raise ValueError("ZeroRedundancyOptimizer got no parameters")
+        if any(p.is_sparse for p in params):
+            raise ValueError("ZeroRedundancyOptimizer only supports dense parameters")
+        params = list(reversed(params))
+        bucket_indices = dist._compute_bucket_assignment_by_size(
+            params, [int(bucket_cap_mb * 1024 * 1024)])
+        self._buckets = [
+            _Bucket([params[i] for i in indices], self.world_size, self.rank)
+            for indices in bucket_indices
+        ]
+        self._next_bucket = 0
+
+        # The hooks are on the gradient accumulators, which run once the
+        # gradient of the parameter is accumulated during the backward pass.
+        # They have to be kept alive for the hooks to run.
+        self._grad_accumulators = []
+        for bucket_index, bucket in enumerate(self._buckets):
+            for param_index, p in enumerate(bucket.params):
+                grad_accumulator = p.expand_as(p).grad_fn.next_functions[0][0]
+                grad_accumulator.register_hook(
+                    self._make_hook(bucket_index, param_index))
+                self._grad_accumulators.append(grad_accumulator)
+
+        self.optimizer = optimizer_class(
+            [bucket.shard for bucket in self._buckets], **defaults)
+
+    @property
+    def param_groups(self):
+        return self.optimizer.param_groups
+
+    def _make_hook(self, bucket_index, param_index):
+        def hook(*unused):
+            bucket = self._buckets[bucket_index]
+            p = bucket.params[param_index]
+            if p.grad is not None:
+                bucket.grad_views[param_index].copy_(p.grad)
+            bucket.pending -= 1
+            self._launch_ready_buckets()
+        return hook
+
+    def _launch_ready_buckets(self, force=False):
+        # Buckets are reduce-scattered in the same order on every rank, like
+        # in the reducer of DistributedDataParallel.
+        while self._next_bucket < len(self._buckets):
+            bucket = self._buckets[self._next_bucket]
+            if bucket.pending > 0 and not force:
+                break
+            bucket.work = dist.reduce_scatter(
+                bucket.shard_grad,
+                list(bucket.flat_grad.chunk(self.world_size)),
+                group=self.group,
+                async_op=True)
+            self._next_bucket += 1
+
+    def zero_grad(self):
+        for bucket in self._buckets:
+            for p in bucket.params:
+                if p.grad is not None:
+                    p.grad.detach_()
+                    p.grad.zero_()
+
+    def step(self, closure=None):
+        # Buckets with unused parameters are launched now, their gradients
+        # count as zero.
+        self._launch_ready_buckets(force=True)
+        for bucket in self._buckets:
+            bucket.work.wait()
+            bucket.shard.grad = bucket.shard_grad.div_(self.world_size)
+            bucket.flat_grad.zero_()
+            bucket.pending = len(bucket.params)
+            bucket.work = None
+        self._next_bucket = 0
+
+        loss = self.optimizer.step(closure)
+
+        # Every rank sends its shard from within the flat buffer it gathers
+        # into: NCCL supports this in place, and Gloo gathers into a
+        # temporary buffer first.
+        work = [
+            dist._all_gather_base(
+                bucket.flat_param, bucket.shard, group=self.group, async_op=True)
+            for bucket in self._buckets
+        ]
+        for w in work:
+            w.wait()
+        return loss
+
+    def state_dict(self):
+        r"""
+        Returns the state of the local optimizer, which only covers the
+        shards of this rank.
+        """
+        return self.optimizer.state_dict()
+
+    def load_state_dict(self, state_dict):
+        self.optimizer.load_state_dict(state_dict)
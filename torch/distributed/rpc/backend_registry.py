@@ -98,6 +98,8 @@ def _process_group_construct_rpc_backend_options_handler(
     rpc_timeout,
     init_method,
     num_send_recv_threads=rpc_constants.DEFAULT_NUM_SEND_RECV_THREADS,
+    max_batch_size=rpc_constants.DEFAULT_MAX_BATCH_SIZE,
+    batch_flush_interval=rpc_constants.DEFAULT_BATCH_FLUSH_INTERVAL,
     **kwargs
 ):
     from . import ProcessGroupRpcBackendOptions
@@ -105,7 +107,9 @@ def _process_group_construct_rpc_backend_options_handler(
     return ProcessGroupRpcBackendOptions(
         rpc_timeout=rpc_timeout,
         init_method=init_method,
-        num_send_recv_threads=num_send_recv_threads
+        num_send_recv_threads=num_send_recv_threads,
+        max_batch_size=max_batch_size,
+        batch_flush_interval=batch_flush_interval,
     )
 
 def _init_process_group(store, rank, world_size):
@@ -143,6 +147,8 @@ def _process_group_init_backend_handler(
         group,
         rpc_backend_options.num_send_recv_threads,
         timedelta(seconds=rpc_backend_options.rpc_timeout),
+        rpc_backend_options.max_batch_size,
+        timedelta(seconds=rpc_backend_options.batch_flush_interval),
     )
 
 
@@ -1,7 +1,9 @@
 from datetime import timedelta
 
 from . import (
+    _DEFAULT_BATCH_FLUSH_INTERVAL,
     _DEFAULT_INIT_METHOD,
+    _DEFAULT_MAX_BATCH_SIZE,
     _DEFAULT_NUM_SEND_RECV_THREADS,
     _DEFAULT_NUM_WORKER_THREADS,
     _DEFAULT_RPC_TIMEOUT_SEC,
@@ -15,6 +17,8 @@ DEFAULT_INIT_METHOD = _DEFAULT_INIT_METHOD
 
 # For ProcessGroupAgent.
 DEFAULT_NUM_SEND_RECV_THREADS = _DEFAULT_NUM_SEND_RECV_THREADS
+DEFAULT_MAX_BATCH_SIZE = _DEFAULT_MAX_BATCH_SIZE
+DEFAULT_BATCH_FLUSH_INTERVAL = _DEFAULT_BATCH_FLUSH_INTERVAL
 # For TensorPipeAgent.
 DEFAULT_NUM_WORKER_THREADS = _DEFAULT_NUM_WORKER_THREADS
 # Ensure that we don't time out when there are long periods of time without
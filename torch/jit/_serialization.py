@@ -18,7 +18,7 @@ from torch.serialization import validate_cuda_device
 DEFAULT_EXTRA_FILES_MAP = torch._C.ExtraFilesMap()
 
 
-def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
+def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP, _compress=False):
     r"""
     Save an offline version of this module for use in a separate process. The
     saved module serializes all of the methods, submodules, parameters, and
@@ -40,6 +40,8 @@ def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
         f: A file-like object (has to implement write and flush) or a string
            containing a file name.
         _extra_files: Map from filename to contents which will be stored as part of `f`.
+        _compress: if ``True``, the records of the archive are deflated, see the
+            ``compress`` argument of :func:`torch.save`.
 
     .. note::
         torch.jit.save attempts to preserve the behavior of some operators
@@ -79,13 +81,13 @@ def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
         torch.jit.save(m, 'scriptmodule.pt', _extra_files=extra_files)
     """
     if isinstance(f, str) or isinstance(f, pathlib.Path):
-        m.save(f, _extra_files=_extra_files)
+        m.save(f, _extra_files=_extra_files, _compress=_compress)
     else:
-        ret = m.save_to_buffer(_extra_files=_extra_files)
+        ret = m.save_to_buffer(_extra_files=_extra_files, _compress=_compress)
         f.write(ret)
 
 
-def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
+def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP, mmap=False):
     r"""
     Load a :class:`ScriptModule` or :class:`ScriptFunction` previously
     saved with :func:`torch.jit.save <torch.jit.save>`
@@ -104,6 +106,10 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
         _extra_files (dictionary of filename to content): The extra
             filenames given in the map would be loaded and their content
             would be stored in the provided map.
+        mmap (bool): If ``True``, ``f`` has to be a file name, which is mapped
+            in memory. The CPU tensors of the module then point into the
+            mapping instead of being copied, writes to them are not seen in
+            the file.
 
     Returns:
         A :class:`ScriptModule` object.
@@ -158,8 +164,10 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
 
     cu = torch._C.CompilationUnit()
     if isinstance(f, str) or isinstance(f, pathlib.Path):
-        cpp_module = torch._C.import_ir_module(cu, f, map_location, _extra_files)
+        cpp_module = torch._C.import_ir_module(cu, str(f), map_location, _extra_files, mmap)
     else:
+        if mmap:
+            raise ValueError("mmap requires a file name, got {}".format(type(f)))
         cpp_module = torch._C.import_ir_module_from_buffer(
             cu, f.read(), map_location, _extra_files
         )
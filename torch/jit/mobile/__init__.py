@@ -5,7 +5,7 @@ from torch.jit._serialization import validate_map_location
 import pathlib
 import os
 
-def _load_for_lite_interpreter(f, map_location=None):
+def _load_for_lite_interpreter(f, map_location=None, mmap=False):
     r"""
     Load a :class:`LiteScriptModule`
     saved with :func:`torch.jit._save_for_lite_interpreter`
@@ -15,6 +15,10 @@ def _load_for_lite_interpreter(f, map_location=None):
             or a string containing a file name
         map_location: a string or torch.device used to dynamically remap
             storages to an alternative set of devices.
+        mmap: if ``True``, ``f`` has to be a file name, which is mapped in
+            memory. The bytecode is read in place and the CPU tensors point
+            into the mapping instead of being copied, writes to them are not
+            seen in the file.
 
     Returns:
         A :class:`LiteScriptModule` object.
@@ -45,8 +49,10 @@ def _load_for_lite_interpreter(f, map_location=None):
     map_location = validate_map_location(map_location)
 
     if isinstance(f, str) or isinstance(f, pathlib.Path):
-        cpp_module = torch._C._load_for_lite_interpreter(f, map_location)
+        cpp_module = torch._C._load_for_lite_interpreter(str(f), map_location, mmap)
     else:
+        if mmap:
+            raise ValueError("mmap requires a file name, got {}".format(type(f)))
         cpp_module = torch._C._load_for_lite_interpreter_from_buffer(f.read(), map_location)
 
     return LiteScriptModule(cpp_module)
@@ -303,6 +303,31 @@ int64_t FileStore::add(const std::string& key, int64_t value) {
   return addHelper(regKey, value);
 }
 
+std::vector<uint8_t> FileStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::string regKey = regularPrefix_ + key;
+  std::unique_lock<std::mutex> l(activeFileOpLock_);
+  File file(path_, O_RDWR | O_CREAT, timeout_);
+  auto lock = file.lockExclusive();
+  pos_ = refresh(file, pos_, cache_);
+
+  auto it = cache_.find(regKey);
+  if (it == cache_.end()) {
+    if (!expectedValue.empty()) {
+      return expectedValue;
+    }
+  } else if (it->second != expectedValue) {
+    return it->second;
+  }
+  // Same as set(), under the exclusive lock taken for the comparison
+  file.seek(0, SEEK_END);
+  file.write(regKey);
+  file.write(desiredValue);
+  return desiredValue;
+}
+
 bool FileStore::check(const std::vector<std::string>& keys) {
   std::unique_lock<std::mutex> l(activeFileOpLock_);
   File file(path_, O_RDONLY, timeout_);
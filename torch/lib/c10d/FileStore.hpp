@@ -23,6 +23,11 @@ class FileStore : public Store {
 
   bool check(const std::vector<std::string>& keys) override;
 
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue) override;
+
   void wait(const std::vector<std::string>& keys) override;
 
   void wait(
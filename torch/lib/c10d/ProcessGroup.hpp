@@ -119,6 +119,16 @@ class ProcessGroup {
       std::vector<at::Tensor>& data,
       const BroadcastOptions& opts = BroadcastOptions()) = 0;
 
+  // Broadcasts a list of tensors, which may have different sizes and types,
+  // in a single operation. Unlike broadcast, the tensors are all on the same
+  // device, and the root tensor is the one of the same index on the root.
+  virtual std::shared_ptr<ProcessGroup::Work> broadcast_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) {
+    throw std::runtime_error(
+        "ProcessGroup does not support broadcast_coalesced");
+  }
+
   virtual std::shared_ptr<ProcessGroup::Work> allreduce(
       std::vector<at::Tensor>& data,
       const AllreduceOptions& opts = AllreduceOptions()) = 0;
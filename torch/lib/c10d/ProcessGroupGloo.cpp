@@ -7,6 +7,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <type_traits>
 
 #include <gloo/allgather.h>
@@ -31,6 +32,7 @@
 #include <c10/cuda/CUDAStream.h>
 #endif
 
+#include <c10/util/Optional.h>
 #include <c10/util/StringUtil.h>
 #include <gloo/config.h>
 #include <gloo/rendezvous/context.h>
@@ -339,12 +341,137 @@ void initializeStreamsEvents(
   }
 }
 
+// Size of the chunks that CUDA allreduce copies to the host, reduces and
+// copies back, and number of them that can be in flight per tensor.
+constexpr size_t kStagingChunkBytes = 4 * 1024 * 1024;
+constexpr size_t kStagingChunksInFlight = 4;
+
 #endif
 
 const auto kLoopbackAddress = "127.0.0.1";
 
+// Number of times AUTOTUNE runs every candidate allreduce algorithm.
+constexpr int kAutotuneIterations = 3;
+
 } // namespace
 
+// The allreduce algorithm of a message size under AUTOTUNE. The first
+// allreduce of the size picks it, the next ones wait for it.
+class AllreduceAlgorithmDecision {
+ public:
+  void set(ProcessGroupGloo::AllreduceAlgorithm algorithm) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      algorithm_ = algorithm;
+    }
+    cv_.notify_all();
+  }
+
+  ProcessGroupGloo::AllreduceAlgorithm get() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return algorithm_.has_value(); });
+    return *algorithm_;
+  }
+
+  c10::optional<ProcessGroupGloo::AllreduceAlgorithm> tryGet() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return algorithm_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  c10::optional<ProcessGroupGloo::AllreduceAlgorithm> algorithm_;
+};
+
+struct AllreduceSelection {
+  ProcessGroupGloo::AllreduceAlgorithm algorithm =
+      ProcessGroupGloo::AllreduceAlgorithm::AUTO;
+  // Only set under AUTOTUNE.
+  std::shared_ptr<AllreduceAlgorithmDecision> decision;
+  // Whether this allreduce has to benchmark the algorithms for its size.
+  bool decides = false;
+};
+
+class AllreduceAlgorithmCache {
+ public:
+  explicit AllreduceAlgorithmCache(
+      ProcessGroupGloo::AllreduceAlgorithm algorithm)
+      : algorithm_(algorithm) {}
+
+  // Must be called in the order the allreduces are issued, which is the same
+  // on every rank, so that the same allreduce benchmarks on every rank.
+  AllreduceSelection select(size_t nbytes) {
+    AllreduceSelection selection;
+    selection.algorithm = algorithm_;
+    if (algorithm_ != ProcessGroupGloo::AllreduceAlgorithm::AUTOTUNE) {
+      return selection;
+    }
+    size_t bucket = 1;
+    while (bucket < nbytes) {
+      bucket <<= 1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& decision = decisions_[bucket];
+    if (!decision) {
+      decision = std::make_shared<AllreduceAlgorithmDecision>();
+      selection.decides = true;
+    }
+    selection.decision = decision;
+    return selection;
+  }
+
+  std::map<size_t, ProcessGroupGloo::AllreduceAlgorithm> tuned() const {
+    std::map<size_t, ProcessGroupGloo::AllreduceAlgorithm> tuned;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& it : decisions_) {
+      auto algorithm = it.second->tryGet();
+      if (algorithm) {
+        tuned.emplace(it.first, *algorithm);
+      }
+    }
+    return tuned;
+  }
+
+ private:
+  const ProcessGroupGloo::AllreduceAlgorithm algorithm_;
+  mutable std::mutex mutex_;
+  std::map<size_t, std::shared_ptr<AllreduceAlgorithmDecision>> decisions_;
+};
+
+#ifdef USE_CUDA
+
+// Pinned host buffers of kStagingChunkBytes, kept alive for the lifetime of
+// the process group instead of being allocated for every collective.
+class PinnedStagingPool {
+ public:
+  c10::Storage acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+      return c10::Storage(
+          c10::Storage::use_byte_size_t(),
+          kStagingChunkBytes,
+          at::cuda::getPinnedMemoryAllocator(),
+          /*resizable=*/false);
+    }
+    auto storage = std::move(free_.back());
+    free_.pop_back();
+    return storage;
+  }
+
+  // The caller must make sure that no copy from or to the buffer is pending.
+  void release(c10::Storage storage) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(std::move(storage));
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<c10::Storage> free_;
+};
+
+#endif
+
 ProcessGroupGloo::SendWork::SendWork(
     at::Tensor& tensor,
     std::unique_ptr<::gloo::transport::UnboundBuffer> buffer)
@@ -405,7 +532,9 @@ void ProcessGroupGloo::RecvWork::abort() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      allreduceAlgorithm(AllreduceAlgorithm::AUTO) {}
 
 namespace {
 
@@ -523,7 +652,9 @@ ProcessGroupGloo::ProcessGroupGloo(
     : ProcessGroup(rank, size),
       store_(new GlooStore(store)),
       stop_(false),
-      collectiveCounter_(0) {
+      collectiveCounter_(0),
+      allreduceAlgorithms_(std::make_shared<AllreduceAlgorithmCache>(
+          options.allreduceAlgorithm)) {
   auto& devices = options.devices;
   if (devices.empty()) {
     throw std::runtime_error("No device(s) specified");
@@ -548,6 +679,9 @@ ProcessGroupGloo::ProcessGroupGloo(
     context->setTimeout(options.timeout);
     context->connectFullMesh(store, options.devices[i]);
     contexts_.push_back(std::move(context));
+#ifdef USE_CUDA
+    stagingPools_.push_back(std::make_shared<PinnedStagingPool>());
+#endif
   }
 
   // Every worker thread stores the AsyncWork object it's currently
@@ -584,10 +718,22 @@ uint32_t ProcessGroupGloo::nextTag() {
   return collectiveCounter_++;
 }
 
+std::map<size_t, ProcessGroupGloo::AllreduceAlgorithm> ProcessGroupGloo::
+    getTunedAllreduceAlgorithms() const {
+  return allreduceAlgorithms_->tuned();
+}
+
 std::shared_ptr<::gloo::Context> ProcessGroupGloo::getContext(uint32_t tag) {
   return contexts_[tag % contexts_.size()];
 }
 
+#ifdef USE_CUDA
+std::shared_ptr<PinnedStagingPool> ProcessGroupGloo::getStagingPool(
+    uint32_t tag) {
+  return stagingPools_[tag % stagingPools_.size()];
+}
+#endif
+
 void ProcessGroupGloo::runLoop(int workerIndex) {
   std::unique_lock<std::mutex> lock(workMutex_);
 
@@ -785,15 +931,88 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
   const ReduceOp reduceOp;
   const uint32_t tag;
 
+  AllreduceSelection selection;
+
   void allreduce(std::vector<at::Tensor>& tensors) {
+    runAllreduce(tensors, reduceOp, getAlgorithm(tensors[0]));
+  }
+
+  void runAllreduce(
+      std::vector<at::Tensor>& tensors,
+      ReduceOp op,
+      ProcessGroupGloo::AllreduceAlgorithm algorithm) {
     const auto& scalarType = tensors[0].scalar_type();
     gloo::AllreduceOptions opts(context);
-    opts.setReduceFunction(getFunction(scalarType, reduceOp));
+    opts.setReduceFunction(getFunction(scalarType, op));
     opts.setTag(tag);
+    switch (algorithm) {
+      case ProcessGroupGloo::AllreduceAlgorithm::RING:
+        opts.setAlgorithm(gloo::AllreduceOptions::Algorithm::RING);
+        break;
+      case ProcessGroupGloo::AllreduceAlgorithm::BCUBE:
+        opts.setAlgorithm(gloo::AllreduceOptions::Algorithm::BCUBE);
+        break;
+      default:
+        break;
+    }
     GENERATE_ALL_TYPES(scalarType, setOutputs, opts, tensors);
     gloo::allreduce(opts);
   }
 
+  ProcessGroupGloo::AllreduceAlgorithm getAlgorithm(const at::Tensor& tensor) {
+    if (!selection.decision) {
+      return selection.algorithm;
+    }
+    if (!selection.decides) {
+      return selection.decision->get();
+    }
+    selection.decides = false;
+    auto algorithm = ProcessGroupGloo::AllreduceAlgorithm::AUTO;
+    try {
+      algorithm = autotune(tensor);
+    } catch (...) {
+      // Don't leave the next allreduces of the size waiting
+      selection.decision->set(algorithm);
+      throw;
+    }
+    selection.decision->set(algorithm);
+    return algorithm;
+  }
+
+  // Every rank runs the same allreduces on a scratch tensor of the size of the
+  // message, with the same tag, and they agree on the sum of their times.
+  ProcessGroupGloo::AllreduceAlgorithm autotune(const at::Tensor& tensor) {
+    const std::vector<ProcessGroupGloo::AllreduceAlgorithm> candidates = {
+        ProcessGroupGloo::AllreduceAlgorithm::RING,
+        ProcessGroupGloo::AllreduceAlgorithm::BCUBE,
+    };
+    if (context->size == 1) {
+      return candidates[0];
+    }
+
+    std::vector<at::Tensor> scratch = {at::zeros(
+        {tensor.numel()}, tensor.options().device(at::kCPU))};
+    std::vector<double> times(candidates.size(), 0);
+    for (size_t i = 0; i < candidates.size(); i++) {
+      for (int iteration = 0; iteration < kAutotuneIterations; iteration++) {
+        const auto start = std::chrono::steady_clock::now();
+        runAllreduce(scratch, ReduceOp::SUM, candidates[i]);
+        times[i] += std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+      }
+    }
+
+    gloo::AllreduceOptions opts(context);
+    opts.setReduceFunction(getFunction(at::kDouble, ReduceOp::SUM));
+    opts.setTag(tag);
+    opts.setOutput(times.data(), times.size());
+    gloo::allreduce(opts);
+
+    const auto best = std::min_element(times.begin(), times.end());
+    return candidates[best - times.begin()];
+  }
+
   void run() override {
     allreduce(inputs);
 
@@ -1186,6 +1405,122 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
   std::vector<at::cuda::CUDAEvent> events;
 };
 
+// Allreduce of contiguous CUDA tensors, staged through the host in chunks of
+// kStagingChunkBytes. The chunks are copied to the host ahead of time, so that
+// the device to host copy of the next chunks, the allreduce of the current one
+// and the host to device copy of the previous ones all overlap.
+class AsyncAllreduceCUDAChunkedWork : public AsyncAllreduceWork {
+ public:
+  AsyncAllreduceCUDAChunkedWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag,
+      std::shared_ptr<PinnedStagingPool> pool)
+      : AsyncAllreduceWork(context, inputs, reduceOp, tag),
+        pool(std::move(pool)),
+        numel(inputs[0].numel()),
+        chunkNumel(std::max<int64_t>(
+            1,
+            kStagingChunkBytes / inputs[0].element_size())),
+        numChunks((numel + chunkNumel - 1) / chunkNumel) {
+    initializeStreamsEvents(inputs, streams, events);
+
+    const auto numSlots =
+        std::min<int64_t>(numChunks, kStagingChunksInFlight);
+    slots.resize(inputs.size());
+    slotEvents.resize(inputs.size());
+    at::cuda::OptionalCUDAStreamGuard guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.reset_stream(streams[i]);
+      slotEvents[i].resize(numSlots);
+      for (int64_t slot = 0; slot < numSlots; slot++) {
+        slots[i].push_back(this->pool->acquire());
+        copyToHost(i, slot);
+      }
+    }
+  }
+
+  ~AsyncAllreduceCUDAChunkedWork() override {
+    // The buffers go back to the pool once nothing reads from them anymore.
+    for (size_t i = 0; i < slots.size(); i++) {
+      streams[i].synchronize();
+      for (auto& slot : slots[i]) {
+        pool->release(std::move(slot));
+      }
+    }
+  }
+
+  void run() override {
+    at::cuda::OptionalCUDAStreamGuard stream_guard;
+    std::vector<at::Tensor> staged(inputs.size());
+    for (int64_t chunk = 0; chunk < numChunks; chunk++) {
+      const size_t slot = chunk % slots[0].size();
+      for (size_t i = 0; i < inputs.size(); i++) {
+        slotEvents[i][slot].synchronize();
+        staged[i] = stagingTensor(i, slot, chunk);
+      }
+
+      allreduce(staged);
+
+      // Only the first output in the tensor list contains the results.
+      // See https://github.com/facebookincubator/gloo/issues/152.
+      // The copy to the host of the chunk that takes over the slot is queued
+      // after the copy back on the same stream, so it can't overwrite it.
+      const auto nextChunk = chunk + static_cast<int64_t>(slots[0].size());
+      for (size_t i = 0; i < inputs.size(); i++) {
+        stream_guard.reset_stream(streams[i]);
+        deviceChunk(i, chunk).copy_(staged[0], /* non_blocking */ true);
+        if (nextChunk < numChunks) {
+          copyToHost(i, nextChunk);
+        }
+      }
+    }
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+      events[i].record(streams[i]);
+    }
+  }
+
+  void synchronize() override {
+    // Synchronize with the copy back to CUDA tensors.
+    at::cuda::OptionalCUDAGuard guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.set_index(inputs[i].device().index());
+      events[i].block(at::cuda::getCurrentCUDAStream());
+    }
+  }
+
+  const std::shared_ptr<PinnedStagingPool> pool;
+  const int64_t numel;
+  const int64_t chunkNumel;
+  const int64_t numChunks;
+  std::vector<at::cuda::CUDAStream> streams;
+  std::vector<at::cuda::CUDAEvent> events;
+  std::vector<std::vector<c10::Storage>> slots;
+  std::vector<std::vector<at::cuda::CUDAEvent>> slotEvents;
+
+ private:
+  at::Tensor deviceChunk(size_t i, int64_t chunk) {
+    const auto begin = chunk * chunkNumel;
+    return inputs[i].view(-1).narrow(
+        0, begin, std::min(chunkNumel, numel - begin));
+  }
+
+  at::Tensor stagingTensor(size_t i, size_t slot, int64_t chunk) {
+    const auto length = std::min(chunkNumel, numel - chunk * chunkNumel);
+    return at::empty({0}, inputs[i].options().device(at::kCPU))
+        .set_(slots[i][slot], 0, {length}, {1});
+  }
+
+  // Must be called with the stream of the input set as current stream.
+  void copyToHost(size_t i, int64_t chunk) {
+    const size_t slot = chunk % slots[i].size();
+    stagingTensor(i, slot, chunk).copy_(deviceChunk(i, chunk), true);
+    slotEvents[i][slot].record(streams[i]);
+  }
+};
+
 class AsyncSparseAllreduceCUDAWork : public AsyncSparseAllreduceWork {
  public:
   AsyncSparseAllreduceCUDAWork(
@@ -1283,10 +1618,13 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   std::shared_ptr<AsyncWork> work;
   auto tag = nextTag();
   auto context = getContext(tag);
+  const size_t nbytes = inputs[0].numel() * inputs[0].element_size();
   if (device.type() == at::kCPU) {
     if (layout == c10::kStrided) {
-      work = std::make_shared<AsyncAllreduceWork>(
+      auto allreduceWork = std::make_shared<AsyncAllreduceWork>(
           std::move(context), inputs, opts.reduceOp, tag);
+      allreduceWork->selection = allreduceAlgorithms_->select(nbytes);
+      work = std::move(allreduceWork);
     } else if (layout == c10::kSparse) {
       work = std::make_shared<AsyncSparseAllreduceWork>(
           std::move(context), inputs, tag);
@@ -1295,9 +1633,22 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
     }
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
-    if (layout == c10::kStrided) {
-      work = std::make_shared<AsyncAllreduceCUDAWork>(
+    const bool contiguous =
+        std::all_of(inputs.begin(), inputs.end(), [](const at::Tensor& t) {
+          return t.is_contiguous();
+        });
+    if (layout == c10::kStrided && contiguous) {
+      auto allreduceWork = std::make_shared<AsyncAllreduceCUDAChunkedWork>(
+          std::move(context), inputs, opts.reduceOp, tag, getStagingPool(tag));
+      // The chunks are what gets allreduced
+      allreduceWork->selection = allreduceAlgorithms_->select(
+          std::min<size_t>(nbytes, kStagingChunkBytes));
+      work = std::move(allreduceWork);
+    } else if (layout == c10::kStrided) {
+      auto allreduceWork = std::make_shared<AsyncAllreduceCUDAWork>(
           std::move(context), inputs, opts.reduceOp, tag);
+      allreduceWork->selection = allreduceAlgorithms_->select(nbytes);
+      work = std::move(allreduceWork);
     } else if (layout == c10::kSparse) {
       work = std::make_shared<AsyncSparseAllreduceCUDAWork>(
           std::move(context), inputs, tag);
@@ -1361,8 +1712,14 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce_coalesced(
   std::shared_ptr<gloo::Context> context = getContext(tag);
   if (device.type() == c10::kCPU) {
     if (layout == c10::kStrided) {
-      work = std::make_shared<AsyncAllreduceCoalescedWork>(
+      size_t nbytes = 0;
+      for (const auto& tensor : tensors) {
+        nbytes += tensor.numel() * tensor.element_size();
+      }
+      auto allreduceWork = std::make_shared<AsyncAllreduceCoalescedWork>(
           std::move(context), tensors, opts.reduceOp, tag);
+      allreduceWork->selection = allreduceAlgorithms_->select(nbytes);
+      work = std::move(allreduceWork);
     } else {
       invalidArgument("unsupported layout");
     }
@@ -1857,11 +2214,30 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allgather_coalesced(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allgather_base(
-    at::Tensor& /*unused */,
-    at::Tensor& /*unused */,
-    const AllgatherOptions& /*unused */) {
-  throw std::runtime_error(
-      "no support for allgather_base in Gloo process group");
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const AllgatherOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::allgather_base: " + msg);
+  };
+
+  if (!outputBuffer.is_contiguous()) {
+    invalidArgument("requires a contiguous output buffer");
+  }
+  if (outputBuffer.numel() != inputBuffer.numel() * getSize()) {
+    invalidArgument(
+        "output buffer must have world size times the elements of the input");
+  }
+
+  // The contributions of the ranks are views of the output buffer, one after
+  // the other.
+  std::vector<std::vector<at::Tensor>> outputs(1);
+  outputs[0].reserve(getSize());
+  for (const auto& chunk : outputBuffer.view(-1).chunk(getSize())) {
+    outputs[0].push_back(chunk.view(inputBuffer.sizes()));
+  }
+  std::vector<at::Tensor> inputs = {inputBuffer};
+  return allgather(outputs, inputs, opts);
 }
 
 namespace {
@@ -2254,11 +2630,74 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::scatter(
   return work;
 }
 
+namespace {
+
+// Gloo doesn't have a reduce-scatter collective: the inputs are flattened and
+// allreduced, then every rank keeps its own chunk.
+class AsyncReduceScatterWork : public AsyncAllreduceWork {
+ public:
+  AsyncReduceScatterWork(
+      const std::shared_ptr<gloo::Context>& context,
+      at::Tensor& output,
+      std::vector<at::Tensor>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : AsyncAllreduceWork(context, inputs, reduceOp, tag), output(output) {}
+
+  at::Tensor output;
+
+  void run() override {
+    std::vector<at::Tensor> flat = {flattenDenseTensors(inputs)};
+    allreduce(flat);
+    const auto numel = output.numel();
+    output.copy_(flat[0]
+                     .slice(0, context->rank * numel, (context->rank + 1) * numel)
+                     .view(output.sizes()));
+  }
+};
+
+} // namespace
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce_scatter(
     std::vector<at::Tensor>& outputs,
     std::vector<std::vector<at::Tensor>>& inputs,
     const ReduceScatterOptions& opts) {
-  throw std::runtime_error("ProcessGroupGloo does not support reduce_scatter");
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::reduce_scatter: " + msg);
+  };
+
+  if (outputs.size() != 1 || inputs.size() != 1) {
+    invalidArgument("requires a single output tensor and input list");
+  }
+  auto& output = outputs[0];
+  auto& input = inputs[0];
+  if (input.size() != static_cast<size_t>(getSize())) {
+    invalidArgument(
+        "requires an input list with one tensor per rank (expected length " +
+        std::to_string(getSize()) + ", got " + std::to_string(input.size()) +
+        ")");
+  }
+
+  assertDense(invalidArgument, input);
+  assertTypeAndSizesMatch(
+      invalidArgument, input, output.options(), output.sizes());
+
+  const auto& device = output.device();
+  switch (device.type()) {
+    case at::kCPU:
+      break;
+    default:
+      invalidArgument(c10::str("unsupported device type ", device.type()));
+  }
+
+  const auto tag = nextTag();
+  auto context = getContext(tag);
+  auto work = std::make_shared<AsyncReduceScatterWork>(
+      std::move(context), output, input, opts.reduceOp, tag);
+  work->selection = allreduceAlgorithms_->select(
+      output.numel() * output.element_size() * input.size());
+  enqueue(work);
+  return work;
 }
 
 namespace {
@@ -2,6 +2,7 @@
 
 #include <condition_variable>
 #include <deque>
+#include <map>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
@@ -27,6 +28,12 @@
 
 namespace c10d {
 
+class AllreduceAlgorithmCache;
+
+#ifdef USE_CUDA
+class PinnedStagingPool;
+#endif
+
 // ProcessGroupGloo implements Gloo bindings for c10d.
 //
 // All functions on this class are expected to be called in the same
@@ -123,12 +130,24 @@ class ProcessGroupGloo : public ProcessGroup {
     int srcRank_;
   };
 
+  // Algorithm that allreduce runs with on dense tensors.
+  //
+  //   AUTO: Gloo picks one by itself.
+  //   RING, BCUBE: always the given one.
+  //   AUTOTUNE: the first allreduce of every message size, rounded up to a
+  //     power of two, benchmarks ring and bcube on the actual topology. The
+  //     one that is fastest on average over the ranks is used for that size
+  //     from then on.
+  //
+  enum class AllreduceAlgorithm : uint8_t { AUTO, RING, BCUBE, AUTOTUNE };
+
   struct Options {
     explicit Options();
 
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+    AllreduceAlgorithm allreduceAlgorithm;
   };
 
   // Helper functions to create a new device object.
@@ -228,6 +247,10 @@ class ProcessGroupGloo : public ProcessGroup {
   std::shared_ptr<ProcessGroup::Work> barrier(
       const BarrierOptions& opts = BarrierOptions()) override;
 
+  // Returns the algorithms that AUTOTUNE picked so far, by the message size
+  // in bytes they are used up to.
+  std::map<size_t, AllreduceAlgorithm> getTunedAllreduceAlgorithms() const;
+
  protected:
   std::unique_ptr<::gloo::rendezvous::Store> store_;
 
@@ -252,6 +275,19 @@ class ProcessGroupGloo : public ProcessGroup {
   // to contexts being used in a round-robin fashion.
   std::shared_ptr<::gloo::Context> getContext(uint32_t tag);
 
+  // Picks the algorithm of every allreduce, see AllreduceAlgorithm.
+  std::shared_ptr<AllreduceAlgorithmCache> allreduceAlgorithms_;
+
+#ifdef USE_CUDA
+  // Pinned host buffers that CUDA collectives stage their tensors in on their
+  // way to and from the network. There is one pool per context, so that the
+  // collectives running on different contexts don't contend on it.
+  std::vector<std::shared_ptr<PinnedStagingPool>> stagingPools_;
+
+  // Returns the staging pool of the context for the specified tag.
+  std::shared_ptr<PinnedStagingPool> getStagingPool(uint32_t tag);
+#endif
+
   // Entrypoint for worker threads.
   void runLoop(int workerIndex);
 
@@ -0,0 +1,236 @@
+#include <c10d/ProcessGroupHierarchical.hpp>
+
+namespace c10d {
+
+namespace {
+
+// Last stage of a hierarchical allreduce: the allgather of the reduced shards
+// within the node. If the shards live in a padded copy of the tensor, the
+// result is copied back once the allgather is done.
+class HierarchicalAllreduceWork : public ProcessGroup::Work {
+ public:
+  HierarchicalAllreduceWork(
+      std::shared_ptr<ProcessGroup::Work> work,
+      at::Tensor tensor,
+      at::Tensor buffer)
+      : work_(std::move(work)),
+        tensor_(std::move(tensor)),
+        buffer_(std::move(buffer)) {}
+
+  bool isCompleted() override {
+    return work_->isCompleted();
+  }
+
+  bool isSuccess() const override {
+    return work_->isSuccess();
+  }
+
+  std::exception_ptr exception() const override {
+    return work_->exception();
+  }
+
+  void synchronize() override {
+    work_->synchronize();
+    copyBack();
+  }
+
+  bool wait(std::chrono::milliseconds timeout = kNoTimeout) override {
+    work_->wait(timeout);
+    copyBack();
+    return true;
+  }
+
+ private:
+  void copyBack() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (buffer_.defined()) {
+      tensor_.copy_(buffer_.narrow(0, 0, tensor_.numel()).view_as(tensor_));
+      buffer_ = at::Tensor();
+    }
+  }
+
+  std::shared_ptr<ProcessGroup::Work> work_;
+  at::Tensor tensor_;
+  at::Tensor buffer_;
+};
+
+} // namespace
+
+ProcessGroupHierarchical::ProcessGroupHierarchical(
+    int rank,
+    int size,
+    std::shared_ptr<ProcessGroup> intraNodeGroup,
+    std::shared_ptr<ProcessGroup> interNodeGroup,
+    std::shared_ptr<ProcessGroup> globalGroup,
+    bool intraNodeReduceScatter)
+    : ProcessGroup(rank, size),
+      intraNodeGroup_(std::move(intraNodeGroup)),
+      interNodeGroup_(std::move(interNodeGroup)),
+      globalGroup_(std::move(globalGroup)),
+      intraNodeReduceScatter_(intraNodeReduceScatter) {
+  TORCH_CHECK(intraNodeGroup_ && interNodeGroup_ && globalGroup_);
+  TORCH_CHECK(
+      intraNodeGroup_->getSize() * interNodeGroup_->getSize() == size_,
+      "ProcessGroupHierarchical expects the same number of processes on "
+      "every node, got ",
+      intraNodeGroup_->getSize(),
+      " processes per node and ",
+      interNodeGroup_->getSize(),
+      " nodes for ",
+      size_,
+      " processes");
+  TORCH_CHECK(globalGroup_->getRank() == rank_);
+  TORCH_CHECK(globalGroup_->getSize() == size_);
+}
+
+ProcessGroupHierarchical::~ProcessGroupHierarchical() {}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::broadcast(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  return globalGroup_->broadcast(tensors, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    broadcast_coalesced(
+        std::vector<at::Tensor>& tensors,
+        const BroadcastOptions& opts) {
+  return globalGroup_->broadcast_coalesced(tensors, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allreduce(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  if (tensors.size() != 1 || tensors[0].is_sparse()) {
+    return globalGroup_->allreduce(tensors, opts);
+  }
+  if (intraNodeGroup_->getSize() == 1) {
+    return interNodeGroup_->allreduce(tensors, opts);
+  }
+  if (interNodeGroup_->getSize() == 1) {
+    return intraNodeGroup_->allreduce(tensors, opts);
+  }
+
+  // Reduce the tensor in place if it can be split in equal shards, in a
+  // padded copy otherwise.
+  const auto& tensor = tensors[0];
+  const int64_t localSize = intraNodeGroup_->getSize();
+  const int64_t numel = tensor.numel();
+  const int64_t shardNumel = (numel + localSize - 1) / localSize;
+  at::Tensor buffer;
+  at::Tensor padded;
+  if (tensor.is_contiguous() && shardNumel * localSize == numel) {
+    buffer = tensor.view(-1);
+  } else {
+    padded = at::zeros({shardNumel * localSize}, tensor.options());
+    padded.narrow(0, 0, numel).copy_(tensor.reshape(-1));
+    buffer = padded;
+  }
+  std::vector<std::vector<at::Tensor>> shards = {buffer.chunk(localSize)};
+  std::vector<at::Tensor> shard = {shards[0][intraNodeGroup_->getRank()]};
+
+  if (intraNodeReduceScatter_) {
+    ReduceScatterOptions reduceScatterOpts;
+    reduceScatterOpts.reduceOp = opts.reduceOp;
+    reduceScatterOpts.timeout = opts.timeout;
+    intraNodeGroup_->reduce_scatter(shard, shards, reduceScatterOpts)->wait();
+  } else {
+    std::vector<at::Tensor> flat = {buffer};
+    intraNodeGroup_->allreduce(flat, opts)->wait();
+  }
+
+  interNodeGroup_->allreduce(shard, opts)->wait();
+
+  AllgatherOptions allgatherOpts;
+  allgatherOpts.timeout = opts.timeout;
+  auto work = intraNodeGroup_->allgather(shards, shard, allgatherOpts);
+  if (!padded.defined()) {
+    return work;
+  }
+  return std::make_shared<HierarchicalAllreduceWork>(
+      std::move(work), tensor, std::move(padded));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    allreduce_coalesced(
+        std::vector<at::Tensor>& tensors,
+        const AllreduceCoalescedOptions& opts) {
+  return globalGroup_->allreduce_coalesced(tensors, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::reduce(
+    std::vector<at::Tensor>& tensors,
+    const ReduceOptions& opts) {
+  return globalGroup_->reduce(tensors, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allgather(
+    std::vector<std::vector<at::Tensor>>& outputs,
+    std::vector<at::Tensor>& inputs,
+    const AllgatherOptions& opts) {
+  return globalGroup_->allgather(outputs, inputs, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allgather_base(
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const AllgatherOptions& opts) {
+  return globalGroup_->allgather_base(outputBuffer, inputBuffer, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    allgather_coalesced(
+        std::vector<std::vector<at::Tensor>>& outputTensorLists,
+        std::vector<at::Tensor>& inputTensors,
+        const AllgatherOptions& opts) {
+  return globalGroup_->allgather_coalesced(
+      outputTensorLists, inputTensors, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::gather(
+    std::vector<std::vector<at::Tensor>>& outputs,
+    std::vector<at::Tensor>& inputs,
+    const GatherOptions& opts) {
+  return globalGroup_->gather(outputs, inputs, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::scatter(
+    std::vector<at::Tensor>& outputs,
+    std::vector<std::vector<at::Tensor>>& inputs,
+    const ScatterOptions& opts) {
+  return globalGroup_->scatter(outputs, inputs, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::reduce_scatter(
+    std::vector<at::Tensor>& outputs,
+    std::vector<std::vector<at::Tensor>>& inputs,
+    const ReduceScatterOptions& opts) {
+  return globalGroup_->reduce_scatter(outputs, inputs, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::send(
+    std::vector<at::Tensor>& tensors,
+    int dstRank,
+    int tag) {
+  return globalGroup_->send(tensors, dstRank, tag);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::recv(
+    std::vector<at::Tensor>& tensors,
+    int srcRank,
+    int tag) {
+  return globalGroup_->recv(tensors, srcRank, tag);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::recvAnysource(
+    std::vector<at::Tensor>& tensors,
+    int tag) {
+  return globalGroup_->recvAnysource(tensors, tag);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::barrier(
+    const BarrierOptions& opts) {
+  return globalGroup_->barrier(opts);
+}
+
+} // namespace c10d
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// ProcessGroupHierarchical implements allreduce in two levels, for clusters
+// where the links between the processes of a node are much faster than the
+// ones between nodes.
+//
+// It is constructed with three process groups:
+//
+// - intraNodeGroup: the processes of the node of this process,
+// - interNodeGroup: the processes that have the same rank in the
+//   intraNodeGroup of their own node, one per node,
+// - globalGroup: all the processes, used for all the other collectives.
+//
+// All the nodes must have the same number of processes. An allreduce is a
+// reduce-scatter within the node, so that each process reduces one shard of
+// the tensor, an allreduce of the shards across nodes, and an allgather of
+// the shards within the node. Each process only sends 1/L of the tensor
+// across nodes, L being the number of processes per node, and the groups
+// may use different backends, e.g. NCCL within the node and Gloo across.
+//
+// Gloo doesn't implement reduce-scatter: with intraNodeReduceScatter false,
+// the first stage is an allreduce within the node instead, of which each
+// process only uses its shard. This still sends 1/L of the tensor across
+// nodes, but more within the node.
+//
+// The stages are issued by the calling thread, which waits for the reduce-
+// scatter and the inter-node allreduce (with NCCL, this only makes the
+// current stream wait) before issuing the next stage. Only allreduce of a
+// single dense tensor per process is hierarchical.
+//
+// All functions of the class are expected to be called in the same order
+// across all processes in the process group. This is the only way that we
+// can guarantee to match up the same calls among all processes.
+//
+class ProcessGroupHierarchical final : public ProcessGroup {
+ public:
+  explicit ProcessGroupHierarchical(
+      int rank,
+      int size,
+      std::shared_ptr<ProcessGroup> intraNodeGroup,
+      std::shared_ptr<ProcessGroup> interNodeGroup,
+      std::shared_ptr<ProcessGroup> globalGroup,
+      bool intraNodeReduceScatter = true);
+
+  ~ProcessGroupHierarchical() override;
+
+  std::shared_ptr<ProcessGroup::Work> broadcast(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> broadcast_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allreduce(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts = AllreduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceCoalescedOptions& opts =
+          AllreduceCoalescedOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce(
+      std::vector<at::Tensor>& tensors,
+      const ReduceOptions& opts = ReduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather_base(
+      at::Tensor& outputBuffer,
+      at::Tensor& inputBuffer,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather_coalesced(
+      std::vector<std::vector<at::Tensor>>& outputTensorLists,
+      std::vector<at::Tensor>& inputTensors,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> gather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const GatherOptions& opts = GatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ScatterOptions& opts = ScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce_scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> send(
+      std::vector<at::Tensor>& tensors,
+      int dstRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recv(
+      std::vector<at::Tensor>& tensors,
+      int srcRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recvAnysource(
+      std::vector<at::Tensor>& tensors,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> barrier(
+      const BarrierOptions& opts = BarrierOptions()) override;
+
+ private:
+  std::shared_ptr<ProcessGroup> intraNodeGroup_;
+  std::shared_ptr<ProcessGroup> interNodeGroup_;
+  std::shared_ptr<ProcessGroup> globalGroup_;
+  const bool intraNodeReduceScatter_;
+};
+
+} // namespace c10d
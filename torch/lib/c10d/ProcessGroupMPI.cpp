@@ -1,5 +1,6 @@
 #include <c10d/ProcessGroupMPI.hpp>
 
+#include <algorithm>
 #include <limits>
 #include <map>
 
@@ -42,21 +43,26 @@ std::map<at::ScalarType, MPI_Datatype> mpiDatatype = {
     {at::kShort, MPI_SHORT},
 };
 
+// How often the worker thread tests the nonblocking operations in flight
+// when there is nothing else to start
+constexpr auto kInFlightPollInterval = std::chrono::microseconds(100);
+
 // Checking CUDA-aware MPI support, currently we only support CUDA aware
-// MPI ops through Open MPI
+// MPI ops through Open MPI. Without it, CUDA tensors go through host copies.
 bool cudaAwareMpiCheck() {
-// Run time check
+// Run time check, done once as it doesn't change for the process
 #if defined(MPIX_CUDA_AWARE_SUPPORT)
-  if (MPIX_Query_cuda_support() == 1) {
-    return true;
-  } else {
-    return false;
-  }
+  static const bool cudaAware = MPIX_Query_cuda_support() == 1;
+  return cudaAware;
 #else // !defined(MPIX_CUDA_AWARE_SUPPORT)
   return false;
 #endif // MPIX_CUDA_AWARE_SUPPORT
 }
 
+bool needsHostStaging(const at::Tensor& tensor) {
+  return tensor.defined() && tensor.is_cuda() && !cudaAwareMpiCheck();
+}
+
 // Checking the input tensor's validity
 void checkSingleTensorHelper(const at::Tensor& tensor) {
   if (!tensor.is_contiguous()) {
@@ -65,11 +71,6 @@ void checkSingleTensorHelper(const at::Tensor& tensor) {
   if (tensor.is_sparse()) {
     throw std::runtime_error("input tensor has to be dense");
   }
-  if (tensor.is_cuda() && !cudaAwareMpiCheck()) {
-    throw std::runtime_error(
-        "CUDA tensor detected and the MPI used doesn't "
-        "have CUDA-aware MPI support");
-  }
 }
 
 void checkSingleTensor(const std::vector<at::Tensor>& tensors) {
@@ -160,8 +161,47 @@ int64_t computeLengthsAndOffsets(
 
 } // namespace
 
-ProcessGroupMPI::AsyncWork::AsyncWork(at::Tensor tensor, MPI_Request request)
-    : tensor_(std::move(tensor)), request_(request) {
+void WorkEntry::stageToHost() {
+  stagedSrc_.resize(src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    if (needsHostStaging(src[i])) {
+      stagedSrc_[i] = src[i];
+      src[i] = src[i].cpu();
+    }
+  }
+  // Outputs are overwritten, so they don't need the device data
+  stagedDst_.resize(dst.size());
+  for (size_t i = 0; i < dst.size(); ++i) {
+    if (needsHostStaging(dst[i])) {
+      stagedDst_[i] = dst[i];
+      dst[i] = at::empty(dst[i].sizes(), dst[i].options().device(at::kCPU));
+    }
+  }
+}
+
+void WorkEntry::unstageFromHost() {
+  // Only the ops without outputs (broadcast, allreduce, reduce) write to src
+  if (dst.empty()) {
+    for (size_t i = 0; i < stagedSrc_.size(); ++i) {
+      if (stagedSrc_[i].defined()) {
+        stagedSrc_[i].copy_(src[i]);
+      }
+    }
+  }
+  for (size_t i = 0; i < stagedDst_.size(); ++i) {
+    if (stagedDst_[i].defined()) {
+      stagedDst_[i].copy_(dst[i]);
+    }
+  }
+}
+
+ProcessGroupMPI::AsyncWork::AsyncWork(
+    at::Tensor tensor,
+    MPI_Request request,
+    at::Tensor stagedTensor)
+    : tensor_(std::move(tensor)),
+      stagedTensor_(std::move(stagedTensor)),
+      request_(request) {
   memset(&status_, 0, sizeof(status_));
 }
 
@@ -179,7 +219,7 @@ bool ProcessGroupMPI::AsyncWork::isCompleted() {
     return true;
   }
 
-  std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+  auto globalLock = lockMPI();
   int flag = 0;
   MPI_CHECK(MPI_Test(&request_, &flag, &status_));
   if (request_ != MPI_REQUEST_NULL) {
@@ -190,6 +230,8 @@ bool ProcessGroupMPI::AsyncWork::isCompleted() {
   // Populate exception if request was not successful
   if (status_.MPI_ERROR != MPI_SUCCESS) {
     populateException();
+  } else {
+    completed();
   }
 
   return true;
@@ -213,13 +255,14 @@ bool ProcessGroupMPI::AsyncWork::wait(std::chrono::milliseconds /* unused */) {
     return true;
   }
 
-  std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+  auto globalLock = lockMPI();
   MPI_CHECK(MPI_Wait(&request_, &status_));
   auto ok = (status_.MPI_ERROR == MPI_SUCCESS);
   if (!ok) {
     populateException();
     std::rethrow_exception(exception_);
   }
+  completed();
   // Always return true, because abort API is not implemented.
   return true;
 }
@@ -228,6 +271,14 @@ void ProcessGroupMPI::AsyncWork::abort() {
   TORCH_CHECK(false, "ProcessGroupMPI::AsyncWork::abort not implemented.")
 }
 
+void ProcessGroupMPI::AsyncWork::completed() {
+  // Copy the data received in the host copy to the CUDA tensor
+  if (stagedTensor_.defined()) {
+    stagedTensor_.copy_(tensor_);
+    stagedTensor_ = at::Tensor();
+  }
+}
+
 void ProcessGroupMPI::AsyncWork::populateException() {
   std::array<char, MPI_MAX_ERROR_STRING> buf;
   int len = buf.size();
@@ -243,15 +294,23 @@ std::mutex ProcessGroupMPI::pgGlobalMutex_;
 std::once_flag ProcessGroupMPI::onceFlagInitMPI;
 
 void ProcessGroupMPI::mpiExit() {
-  std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+  std::lock_guard<std::mutex> globalLock(pgGlobalMutex_);
   MPI_CHECK(MPI_Finalize());
 }
 
+std::unique_lock<std::mutex> ProcessGroupMPI::lockMPI() {
+  if (mpiThreadSupport_ >= MPI_THREAD_MULTIPLE) {
+    return std::unique_lock<std::mutex>(pgGlobalMutex_, std::defer_lock);
+  }
+  return std::unique_lock<std::mutex>(pgGlobalMutex_);
+}
+
 void ProcessGroupMPI::initMPIOnce() {
-  // Initialize MPI environment
+  // Initialize MPI environment, with concurrent MPI calls if the
+  // implementation supports them
   std::call_once(onceFlagInitMPI, []() {
     MPI_CHECK(MPI_Init_thread(
-        nullptr, nullptr, MPI_THREAD_SERIALIZED, &mpiThreadSupport_));
+        nullptr, nullptr, MPI_THREAD_MULTIPLE, &mpiThreadSupport_));
     if (mpiThreadSupport_ < MPI_THREAD_SERIALIZED) {
       throw std::runtime_error(
           "Used MPI implementation doesn't have the "
@@ -347,9 +406,20 @@ void ProcessGroupMPI::abort() {
 void ProcessGroupMPI::runLoop() {
   std::unique_lock<std::mutex> lock(pgMutex_);
 
-  while (!stop_) {
+  while (!stop_ || !inFlight_.empty()) {
     if (queue_.empty()) {
-      queueProduceCV_.wait(lock);
+      if (inFlight_.empty()) {
+        queueProduceCV_.wait(lock);
+        continue;
+      }
+      // Make progress on the operations in flight until they complete or
+      // more operations are enqueued
+      lock.unlock();
+      testInFlight();
+      lock.lock();
+      if (queue_.empty() && !inFlight_.empty()) {
+        queueProduceCV_.wait_for(lock, kInFlightPollInterval);
+      }
       continue;
     }
 
@@ -365,7 +435,13 @@ void ProcessGroupMPI::runLoop() {
 
     try {
       workEntry->run(workEntry);
-      work->finish();
+      if (workEntry->request != MPI_REQUEST_NULL) {
+        // Started a nonblocking operation, go on with the next ones
+        inFlight_.push_back(std::move(workTuple));
+      } else {
+        workEntry->unstageFromHost();
+        work->finish();
+      }
     } catch (...) {
       work->finish(std::current_exception());
     }
@@ -374,8 +450,62 @@ void ProcessGroupMPI::runLoop() {
   }
 }
 
+void ProcessGroupMPI::testInFlight() {
+  std::vector<MPI_Request> requests;
+  requests.reserve(inFlight_.size());
+  for (const auto& workTuple : inFlight_) {
+    requests.push_back(std::get<0>(workTuple)->request);
+  }
+  std::vector<int> indices(requests.size());
+  std::vector<MPI_Status> statuses(requests.size());
+  int numCompleted = 0;
+
+  try {
+    auto globalLock = lockMPI();
+    MPI_CHECK(MPI_Testsome(
+        static_cast<int>(requests.size()),
+        requests.data(),
+        &numCompleted,
+        indices.data(),
+        statuses.data()));
+  } catch (...) {
+    // There is no telling which of the operations failed
+    for (auto& workTuple : inFlight_) {
+      std::get<1>(workTuple)->finish(std::current_exception());
+    }
+    inFlight_.clear();
+    return;
+  }
+  if (numCompleted == MPI_UNDEFINED) {
+    numCompleted = 0;
+  }
+
+  for (int i = 0; i < numCompleted; ++i) {
+    auto& workEntry = std::get<0>(inFlight_[indices[i]]);
+    auto& work = std::get<1>(inFlight_[indices[i]]);
+    workEntry->request = MPI_REQUEST_NULL;
+    try {
+      workEntry->unstageFromHost();
+      work->finish();
+    } catch (...) {
+      work->finish(std::current_exception());
+    }
+  }
+  inFlight_.erase(
+      std::remove_if(
+          inFlight_.begin(),
+          inFlight_.end(),
+          [](const WorkType& workTuple) {
+            return std::get<0>(workTuple)->request == MPI_REQUEST_NULL;
+          }),
+      inFlight_.end());
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::enqueue(
     std::unique_ptr<WorkEntry> entry) {
+  // Without CUDA-aware MPI, the operation runs on host copies of the CUDA
+  // tensors, made before returning as the caller may reuse its tensors
+  entry->stageToHost();
   auto work = std::make_shared<WorkMPI>();
   std::unique_lock<std::mutex> lock(pgMutex_);
   queue_.push_back(std::make_tuple(std::move(entry), work));
@@ -392,13 +522,14 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::broadcast(
       [opts, this](std::unique_ptr<WorkEntry>& entry) {
         auto data = (entry->src)[0];
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Bcast(
+        auto globalLock = lockMPI();
+        MPI_CHECK(MPI_Ibcast(
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
+            pgComm_,
+            &entry->request));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -414,14 +545,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allreduce(
       [opts, this](std::unique_ptr<WorkEntry>& entry) {
         auto data = (entry->src)[0];
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Allreduce(
+        auto globalLock = lockMPI();
+        MPI_CHECK(MPI_Iallreduce(
             MPI_IN_PLACE,
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             mpiOp.at(opts.reduceOp),
-            pgComm_));
+            pgComm_,
+            &entry->request));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -448,15 +580,16 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce(
         void* recvbuf = (rank_ == opts.rootRank) ? dataPtr : nullptr;
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Reduce(
+        auto globalLock = lockMPI();
+        MPI_CHECK(MPI_Ireduce(
             sendbuf,
             recvbuf,
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             mpiOp.at(opts.reduceOp),
             opts.rootRank,
-            pgComm_));
+            pgComm_,
+            &entry->request));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -488,7 +621,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allgather(
         auto flatOutputTensor = newLikeFlat(outputDataVec);
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Allgather(
             data.data_ptr(),
             data.numel(),
@@ -551,7 +684,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::gather(
         }
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Gather(
             data.data_ptr(),
             data.numel(),
@@ -625,7 +758,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::scatter(
         }
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Scatter(
             sendbuf,
             data.numel(),
@@ -679,7 +812,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall_base(
           auto srcdata = (entry->src)[0];
           auto dstdata = (entry->dst)[0];
           c10::DeviceGuard guard(srcdata.device());
-          std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+          auto globalLock = lockMPI();
           MPI_CHECK(MPI_Alltoall(
               srcdata.data_ptr(),
               srcdata.numel() / size_,
@@ -712,7 +845,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall_base(
           computeLengthsAndOffsets(
               outputSplitSizes, dstdata, &recv_lengths, &recv_offsets);
           c10::DeviceGuard guard(srcdata.device());
-          std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+          auto globalLock = lockMPI();
           MPI_CHECK(MPI_Alltoallv(
               srcdata.data_ptr(),
               send_lengths.data(),
@@ -765,7 +898,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall(
           srcFlatDataSplits[i].copy_(srcdata[i].view({-1}));
         }
         c10::DeviceGuard guard1(srcdata[0].device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Alltoallv(
             srcFlatData.data_ptr(),
             send_lengths.data(),
@@ -794,12 +927,14 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::send(
     int tag) {
   checkSingleTensor(tensors);
 
-  auto& tensor = tensors[0];
+  // Without CUDA-aware MPI, send a host copy
+  auto tensor =
+      needsHostStaging(tensors[0]) ? tensors[0].cpu() : tensors[0];
   MPI_Request request = MPI_REQUEST_NULL;
 
   {
     c10::DeviceGuard guard(tensor.device());
-    std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+    auto globalLock = lockMPI();
     MPI_CHECK(MPI_Isend(
         tensor.data_ptr(),
         tensor.numel(),
@@ -819,12 +954,19 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::recv(
     int tag) {
   checkSingleTensor(tensors);
 
-  auto& tensor = tensors[0];
+  // Without CUDA-aware MPI, receive in a host copy, which the work copies to
+  // the CUDA tensor when it completes
+  at::Tensor stagedTensor;
+  auto tensor = tensors[0];
+  if (needsHostStaging(tensor)) {
+    stagedTensor = tensor;
+    tensor = at::empty(tensor.sizes(), tensor.options().device(at::kCPU));
+  }
   MPI_Request request = MPI_REQUEST_NULL;
 
   {
     c10::DeviceGuard guard(tensor.device());
-    std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+    auto globalLock = lockMPI();
     MPI_CHECK(MPI_Irecv(
         tensor.data_ptr(),
         tensor.numel(),
@@ -835,7 +977,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::recv(
         &request));
   }
 
-  return std::make_shared<AsyncWork>(tensor, request);
+  return std::make_shared<AsyncWork>(tensor, request, stagedTensor);
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::recvAnysource(
@@ -843,12 +985,19 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::recvAnysource(
     int tag) {
   checkSingleTensor(tensors);
 
-  auto& tensor = tensors[0];
+  // Without CUDA-aware MPI, receive in a host copy, which the work copies to
+  // the CUDA tensor when it completes
+  at::Tensor stagedTensor;
+  auto tensor = tensors[0];
+  if (needsHostStaging(tensor)) {
+    stagedTensor = tensor;
+    tensor = at::empty(tensor.sizes(), tensor.options().device(at::kCPU));
+  }
   MPI_Request request = MPI_REQUEST_NULL;
 
   {
     c10::DeviceGuard guard(tensor.device());
-    std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+    auto globalLock = lockMPI();
     MPI_CHECK(MPI_Irecv(
         tensor.data_ptr(),
         tensor.numel(),
@@ -859,15 +1008,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::recvAnysource(
         &request));
   }
 
-  return std::make_shared<AsyncWork>(tensor, request);
+  return std::make_shared<AsyncWork>(tensor, request, stagedTensor);
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::barrier(
     const BarrierOptions& opts) {
   std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
       [this](std::unique_ptr<WorkEntry>& entry) {
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Barrier(pgComm_));
+        auto globalLock = lockMPI();
+        MPI_CHECK(MPI_Ibarrier(pgComm_, &entry->request));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(nullptr, nullptr, std::move(runFunc)));
@@ -38,12 +38,25 @@ struct WorkEntry {
   // Not copy assignable
   WorkEntry& operator=(const WorkEntry&) = delete;
 
+  // Replaces the CUDA tensors by host copies, for MPI implementations that
+  // aren't CUDA-aware, and copies the results back after the run
+  void stageToHost();
+  void unstageFromHost();
+
   // For input and output tensors (in-place), we will always use src
   std::vector<at::Tensor> src;
   std::vector<at::Tensor> dst;
   // src rank returned, for recv only
   int* srcRank = nullptr;
   std::function<void(std::unique_ptr<WorkEntry>&)> run;
+  // Set by run when it only starts a nonblocking operation, which completes
+  // the work when the request does
+  MPI_Request request = MPI_REQUEST_NULL;
+
+ private:
+  // The CUDA tensors that src and dst hold host copies of, if any
+  std::vector<at::Tensor> stagedSrc_;
+  std::vector<at::Tensor> stagedDst_;
 };
 
 // ProcessGroupMPI implements MPI bindings for c10d.
@@ -63,13 +76,21 @@ struct WorkEntry {
 //
 // If you would like to use multiple ProcessGroupMPI, it requres your MPI
 // implemenation to have a thread support value of MPI_THREAD_MULTIPLE, that is,
-// multiple threads may call MPI, with no restriction.
+// multiple threads may call MPI, with no restriction. ProcessGroupMPI asks
+// for it, and then makes MPI calls without serializing them, so that process
+// groups and point-to-point operations proceed concurrently.
+//
+// The worker thread starts broadcast, allreduce, reduce and barrier as
+// nonblocking operations and goes on with the next operations in the queue,
+// polling the ones in flight until they complete, so that several of them
+// overlap. The order in which operations start stays the order of the calls.
 //
 // Also note that ProcessGroupMPI only supports a single Tensor operation. In
 // other words, the size of the input Tensor vector should always be 1.
 //
-// CUDA tensor can be supported if the MPI used is CUDA-aware MPI, and
-// ProcessGroupMPI will automatically detect this support.
+// CUDA tensors are passed to MPI directly if the MPI used is CUDA-aware MPI,
+// which ProcessGroupMPI detects at run time, and go through host copies
+// otherwise.
 class ProcessGroupMPI : public ProcessGroup {
  public:
   class WorkMPI : public ProcessGroup::Work {
@@ -79,7 +100,12 @@ class ProcessGroupMPI : public ProcessGroup {
 
   class AsyncWork : public ProcessGroup::Work {
    public:
-    AsyncWork(at::Tensor tensor, MPI_Request request);
+    // stagedTensor is the CUDA tensor that tensor is a host copy of, to copy
+    // the received data to
+    AsyncWork(
+        at::Tensor tensor,
+        MPI_Request request,
+        at::Tensor stagedTensor = at::Tensor());
     virtual ~AsyncWork();
 
     bool isCompleted() override;
@@ -94,8 +120,10 @@ class ProcessGroupMPI : public ProcessGroup {
 
    protected:
     void populateException();
+    void completed();
 
     at::Tensor tensor_;
+    at::Tensor stagedTensor_;
     MPI_Request request_;
     MPI_Status status_;
   };
@@ -193,17 +221,26 @@ class ProcessGroupMPI : public ProcessGroup {
       std::tuple<std::unique_ptr<WorkEntry>, std::shared_ptr<WorkMPI>>;
   // Worker thread loop
   void runLoop();
+  // Completes the works of the in-flight operations that are done, on the
+  // worker thread
+  void testInFlight();
   // Helper function that is called by the destructor
   void destroy();
 
   std::shared_ptr<ProcessGroup::Work> enqueue(std::unique_ptr<WorkEntry> entry);
 
+  // Serializes the MPI calls, unless MPI supports concurrent calls
+  // (MPI_THREAD_MULTIPLE)
+  static std::unique_lock<std::mutex> lockMPI();
+
   bool stop_;
 
   std::mutex pgMutex_;
   std::thread workerThread_;
 
   std::deque<WorkType> queue_;
+  // Started nonblocking operations, only used by the worker thread
+  std::vector<WorkType> inFlight_;
   std::condition_variable queueProduceCV_;
   std::condition_variable queueConsumeCV_;
 
@@ -1,5 +1,6 @@
 #include <c10d/ProcessGroupNCCL.hpp>
 
+#include <algorithm>
 #include <map>
 #include <tuple>
 #include <unordered_set>
@@ -129,12 +130,33 @@ std::string getNcclAbortedCommStoreKey(const std::string ncclIdStr) {
   return std::string(kNCCLAbortedCommStoreKey) + ":" + ncclIdStr;
 }
 
+// Reads an environment variable which may be unset, 0 or 1.
+bool parseEnvVarFlag(const char* envVarName) {
+  char* stringValue = getenv(envVarName);
+  if (stringValue == nullptr) {
+    return false;
+  }
+  int val;
+  try {
+    val = std::stoi(stringValue);
+  } catch (std::exception& e) {
+    val = -1;
+  }
+  if (val != 0 && val != 1) {
+    throw std::runtime_error(
+        "Invalid value for environment variable: " + std::string(envVarName));
+  }
+  return val == 1;
+}
+
 } // namespace
 
 const int64_t ProcessGroupNCCL::kWatchdogThreadSleepMillis = 10000;
 constexpr int64_t kWaitForAbortCommStoreKey = 1000;
 constexpr int64_t kSynchronizeBusyWaitMillis = 10;
+constexpr size_t kMaxOpsPerNcclGroup = 2048;
 const int64_t ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis = 10 * 1000;
+const int64_t ProcessGroupNCCL::kWorkCleanupThreadSleepMillis = 1000;
 
 ProcessGroupNCCL::WorkNCCL::WorkNCCL(const std::vector<at::Device>& devices)
     : devices_(devices), workStartTime_(std::chrono::steady_clock::now()) {
@@ -178,6 +200,28 @@ bool ProcessGroupNCCL::WorkNCCL::finishedGPUExecution() {
   return finishedGPUExecutionInternal();
 }
 
+bool ProcessGroupNCCL::WorkNCCL::timedOut() const {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - workStartTime_) > opTimeout_;
+}
+
+void ProcessGroupNCCL::WorkNCCL::setException(std::exception_ptr exception) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!exception_) {
+    exception_ = exception;
+  }
+}
+
+void ProcessGroupNCCL::WorkNCCL::abortCommunicators() {
+  for (const auto& ncclComm : ncclComms_) {
+    ncclComm->ncclCommAbort();
+    const auto& storeKey = getNcclAbortedCommStoreKey(
+        buildNcclUniqueIdStr(ncclComm->getNcclId()));
+    store_->set(storeKey, {});
+    LOG(INFO) << "Wrote aborted communicator id to store: " << storeKey;
+  }
+}
+
 bool ProcessGroupNCCL::WorkNCCL::finishedGPUExecutionInternal() const {
   for (size_t i = 0; i < devices_.size(); ++i) {
     // Checking the work's corresponding CUDA events' status
@@ -237,13 +281,7 @@ void ProcessGroupNCCL::WorkNCCL::synchronizeInternal(
         // if throwing timed out excepiton without aborting nccl communicators
         // here, it was observed that CUDA GPU will have 100% utilization and
         // can not run new events successfully.
-        for (const auto& ncclComm : ncclComms_) {
-          ncclComm->ncclCommAbort();
-          const auto& storeKey = getNcclAbortedCommStoreKey(
-              buildNcclUniqueIdStr(ncclComm->getNcclId()));
-          store_->set(storeKey, {});
-          LOG(INFO) << "Wrote aborted communicator id to store: " << storeKey;
-        }
+        abortCommunicators();
         throw std::runtime_error("Operation timed out!");
       }
       // Check for errors and throw appropriate exception.
@@ -252,6 +290,10 @@ void ProcessGroupNCCL::WorkNCCL::synchronizeInternal(
           std::chrono::milliseconds(kSynchronizeBusyWaitMillis));
     }
     checkAndThrowException();
+  } else if (asyncErrorHandling_ && exception()) {
+    // The work already failed or timed out, and its communicators were
+    // aborted by the work cleanup thread.
+    std::rethrow_exception(exception());
   }
 
   // Device synchronize only after we've completed timeout checks.
@@ -276,18 +318,20 @@ void ProcessGroupNCCL::WorkNCCL::abort() {
 }
 
 void ProcessGroupNCCL::parseNcclBlockingWait() {
-  char* blockingWait = getenv(NCCL_BLOCKING_WAIT);
-  if (blockingWait != nullptr) {
-    auto val = std::stoi(blockingWait);
-    if (val == 1) {
-      // Make wait() and synchronize() a blocking call.
-      blockingWait_ = true;
-    } else if (val != 0) {
-      throw std::runtime_error(
-          "Invalid value for environment variable: " +
-          std::string(NCCL_BLOCKING_WAIT));
-    }
+  // Make wait() and synchronize() a blocking call.
+  blockingWait_ = parseEnvVarFlag(NCCL_BLOCKING_WAIT);
+}
+
+void ProcessGroupNCCL::parseNcclAsyncErrorHandling() {
+  asyncErrorHandling_ = parseEnvVarFlag(NCCL_ASYNC_ERROR_HANDLING);
+#ifndef ENABLE_NCCL_ERROR_CHECKING
+  if (asyncErrorHandling_) {
+    // Communicators can't be aborted with this version of NCCL.
+    LOG(WARNING) << NCCL_ASYNC_ERROR_HANDLING
+                 << " is ignored, it needs NCCL 2.4 or newer";
+    asyncErrorHandling_ = false;
   }
+#endif
 }
 
 ProcessGroupNCCL::ProcessGroupNCCL(
@@ -300,25 +344,27 @@ ProcessGroupNCCL::ProcessGroupNCCL(
       ncclCommCounter_(0),
       terminateWatchdog_(false),
       opTimeout_(opTimeout) {
-  try {
-    parseNcclBlockingWait();
-  } catch (std::exception& e) {
-    throw std::runtime_error(
-        "Invalid value for environment variable: " +
-        std::string(NCCL_BLOCKING_WAIT));
-  }
+  parseNcclBlockingWait();
+  parseNcclAsyncErrorHandling();
 
 #ifdef ENABLE_NCCL_ERROR_CHECKING
   ncclCommWatchdogThread_ =
       std::thread(&ProcessGroupNCCL::ncclCommWatchdog, this);
+  if (asyncErrorHandling_) {
+    workCleanupThread_ = std::thread(&ProcessGroupNCCL::workCleanupLoop, this);
+  }
 #endif
 }
 
 ProcessGroupNCCL::~ProcessGroupNCCL() {
   terminateWatchdog_.store(true);
   watchdogCV_.notify_one();
+  workListCV_.notify_one();
 #ifdef ENABLE_NCCL_ERROR_CHECKING
   ncclCommWatchdogThread_.join();
+  if (workCleanupThread_.joinable()) {
+    workCleanupThread_.join();
+  }
 #endif
 
   {
@@ -364,7 +410,7 @@ void ProcessGroupNCCL::ncclCommWatchdogInternal() {
         if (checkForNCCLErrors(ncclComms)) {
           LOG(INFO) << "Received NCCL errors for communicators in the cache";
 
-          if (blockingWait_) {
+          if (blockingWait_ || asyncErrorHandling_) {
             LOG(INFO) << "Aborting communicators that received errors";
             // We should not abort the communicators if we are performing a
             // non-blocking wait(). The reason for this is that if we abort the
@@ -392,7 +438,7 @@ void ProcessGroupNCCL::ncclCommWatchdogInternal() {
       }
     }
 
-    if (blockingWait_) {
+    if (blockingWait_ || asyncErrorHandling_) {
       // When we abort a communicator on one rank, it is likely that might cause
       // other ranks to hang indefinitely. As a result, whenever we abort a
       // communicator, we write its ID to the store. The watchdog on other ranks
@@ -446,6 +492,71 @@ void ProcessGroupNCCL::ncclCommWatchdogInternal() {
   }
 }
 
+void ProcessGroupNCCL::workCleanupLoop() {
+  while (!terminateWatchdog_.load()) {
+    std::list<std::shared_ptr<WorkNCCL>> failedWork;
+    {
+      std::unique_lock<std::mutex> lock(workListMutex_);
+      workListCV_.wait_for(
+          lock,
+          std::chrono::milliseconds(kWorkCleanupThreadSleepMillis),
+          [&]() -> bool { return terminateWatchdog_.load(); });
+
+      for (auto it = workList_.begin(); it != workList_.end();) {
+        auto& work = *it;
+        // isCompleted() also sets the exception of the work on NCCL errors.
+        const bool completed = work->isCompleted();
+        if (work->exception() || (!completed && work->timedOut())) {
+          failedWork.push_back(work);
+          it = workList_.erase(it);
+        } else if (completed) {
+          it = workList_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    // Abort outside of the lock, so that new collectives aren't blocked on
+    // the store.
+    for (auto& work : failedWork) {
+      if (!work->exception()) {
+        LOG(ERROR) << "NCCL work timed out after " << opTimeout_.count()
+                   << "ms, aborting its communicators";
+        work->setException(std::make_exception_ptr(std::runtime_error(
+            "NCCL operation timed out after " +
+            std::to_string(opTimeout_.count()) + "ms")));
+      } else {
+        LOG(ERROR) << "NCCL work failed, aborting its communicators";
+      }
+      work->abortCommunicators();
+
+      std::lock_guard<std::mutex> lock(workListMutex_);
+      if (!asyncError_) {
+        asyncError_ = work->exception();
+      }
+    }
+  }
+}
+
+void ProcessGroupNCCL::enqueueWork(const std::shared_ptr<WorkNCCL>& work) {
+  if (!asyncErrorHandling_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(workListMutex_);
+  workList_.push_back(work);
+}
+
+void ProcessGroupNCCL::checkAsyncError() {
+  if (!asyncErrorHandling_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(workListMutex_);
+  if (asyncError_) {
+    std::rethrow_exception(asyncError_);
+  }
+}
+
 std::exception_ptr ProcessGroupNCCL::WorkNCCL::checkForNCCLErrors(
     const std::vector<std::shared_ptr<NCCLComm>>& ncclComms) const {
   return checkForNCCLErrorsInternal(ncclComms);
@@ -469,15 +580,30 @@ std::exception_ptr ProcessGroupNCCL::checkForNCCLErrorsInternal(
   return nullptr;
 }
 
-void ProcessGroupNCCL::broadcastUniqueNCCLID(ncclUniqueId* ncclID) {
+void ProcessGroupNCCL::broadcastUniqueNCCLID(
+    ncclUniqueId* ncclID,
+    const std::vector<int>& ranks) {
   // For every NCCL communicator that we create we need to broadcast
   // a unique ID from rank 0 to all other ranks. This broadcast is
   // done by rank 0 setting a key in the store and all other ranks
   // retrieving the contents of that key. A single process group
   // may create multiple NCCL communicators, so we use a sequence
-  // number to differentiate between them.
-  std::string storeKey = std::to_string(ncclCommCounter_++);
-  if (rank_ == 0) {
+  // number to differentiate between them. Communicators of a subset of
+  // the ranks count apart, with the lowest of the ranks as the root.
+  std::string storeKey;
+  int root = 0;
+  if (ranks.empty()) {
+    storeKey = std::to_string(ncclCommCounter_++);
+  } else {
+    std::string ranksKey = "p2p";
+    for (const auto rank : ranks) {
+      ranksKey += ":" + std::to_string(rank);
+    }
+    storeKey =
+        ranksKey + ":" + std::to_string(p2pCommCounters_[ranksKey]++);
+    root = ranks.front();
+  }
+  if (rank_ == root) {
     auto vec = std::vector<uint8_t>(
         reinterpret_cast<uint8_t*>(ncclID),
         reinterpret_cast<uint8_t*>(ncclID) + NCCL_UNIQUE_ID_BYTES);
@@ -491,7 +617,8 @@ void ProcessGroupNCCL::broadcastUniqueNCCLID(ncclUniqueId* ncclID) {
 
 std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
     const std::string& devicesKey,
-    const std::vector<at::Device>& devices) {
+    const std::vector<at::Device>& devices,
+    const std::vector<int>& ranks) {
   // Sanity check
   if (devicesKey.empty()) {
     throw std::runtime_error(
@@ -515,15 +642,25 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
   std::vector<std::shared_ptr<NCCLComm>> ncclComms;
   ncclComms.resize(devices.size());
 
+  // Rank of this process among the ranks of the communicators
+  int groupRank = getRank();
+  int groupSize = getSize();
+  if (!ranks.empty()) {
+    const auto it = std::find(ranks.begin(), ranks.end(), rank_);
+    TORCH_INTERNAL_ASSERT(it != ranks.end());
+    groupRank = it - ranks.begin();
+    groupSize = ranks.size();
+  }
+
   // Create the unique NCCL ID and broadcast it
   ncclUniqueId ncclID;
 
-  if (rank_ == 0) {
+  if (groupRank == 0) {
     C10D_NCCL_CHECK(ncclGetUniqueId(&ncclID));
   }
 
   // Broadcast so that each process can have a unique NCCL ID
-  broadcastUniqueNCCLID(&ncclID);
+  broadcastUniqueNCCLID(&ncclID, ranks);
 
   at::cuda::OptionalCUDAGuard gpuGuard;
 
@@ -535,8 +672,8 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
 
   for (size_t i = 0; i < devices.size(); ++i) {
     // GPU world size and GPU rank
-    int numRanks = getSize() * devices.size();
-    int rank = getRank() * devices.size() + i;
+    int numRanks = groupSize * devices.size();
+    int rank = groupRank * devices.size() + i;
 
     gpuGuard.set_index(devices[i].index());
     ncclComms[i] = NCCLComm::create(numRanks, rank, ncclID);
@@ -611,6 +748,28 @@ void check_gpu_tensors(const std::vector<at::Tensor>& tensors) {
   }
 }
 
+// Check that all `tensors' are dense CUDA tensors on a single GPU, for the
+// coalesced collectives. Unlike check_gpu_tensors, they may have different
+// types and shapes.
+void check_single_gpu_tensors(const std::vector<at::Tensor>& tensors) {
+  if (tensors.size() == 0) {
+    throw std::runtime_error("Tensor list must be nonempty");
+  }
+
+  const auto& first = tensors.front();
+  for (const auto& t : tensors) {
+    if (!t.is_cuda() || t.is_sparse()) {
+      throw std::runtime_error("Tensors must be CUDA and dense");
+    }
+    if (!t.is_non_overlapping_and_dense()) {
+      throw std::runtime_error("Tensors must be non-overlapping and dense");
+    }
+    if (t.device() != first.device()) {
+      throw std::runtime_error("Tensors must be on the same GPU device");
+    }
+  }
+}
+
 // Flatten each list in `tensor_lists' for a gather or scatter operation, and
 // ensure compatibility with the corresponding tensor in `other'.
 std::vector<at::Tensor> flatten_for_scatter_gather(
@@ -653,6 +812,42 @@ std::vector<at::Tensor> flatten_for_scatter_gather(
   return flattened;
 }
 
+// The number of elements of `tensor' to exchange with each rank in an
+// alltoall, for the split sizes along dim 0; no split sizes split it equally.
+std::vector<size_t> alltoall_counts(
+    const std::vector<int64_t>& splitSizes,
+    const at::Tensor& tensor,
+    int size) {
+  if (tensor.dim() == 0) {
+    throw std::runtime_error("Tensors to alltoall must have at least one dim");
+  }
+  const size_t rowNumel = tensor.size(0) == 0 ? 0 : tensor.numel() / tensor.size(0);
+  std::vector<size_t> counts(size);
+  if (splitSizes.empty()) {
+    if (tensor.size(0) % size != 0) {
+      throw std::runtime_error(
+          "Tensor's dim 0 does not divide equally across group size");
+    }
+    std::fill(counts.begin(), counts.end(), tensor.size(0) / size * rowNumel);
+    return counts;
+  }
+  if (splitSizes.size() != static_cast<size_t>(size)) {
+    throw std::runtime_error("Number of tensor splits not equal to group size");
+  }
+  int64_t sum = 0;
+  for (int i = 0; i < size; ++i) {
+    if (splitSizes[i] < 0) {
+      throw std::runtime_error("Split sizes must be non-negative");
+    }
+    sum += splitSizes[i];
+    counts[i] = splitSizes[i] * rowNumel;
+  }
+  if (sum != tensor.size(0)) {
+    throw std::runtime_error("Split sizes doesn't match total dim 0 size");
+  }
+  return counts;
+}
+
 } // namespace
 
 std::shared_ptr<ProcessGroupNCCL::WorkNCCL> ProcessGroupNCCL::initWork(
@@ -667,6 +862,8 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
     Fn fn,
     PreProcess pre,
     PostProcess post) {
+  checkAsyncError();
+
   const auto devices = getDeviceList(inputs);
   const auto key = getKeyFromDevices(devices);
   auto& ncclComms = getNCCLComm(key, devices);
@@ -715,10 +912,12 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
     work->cudaEvents_[i].record(ncclStream);
     work->ncclComms_[i] = ncclComms[i];
     work->blockingWait_ = blockingWait_;
+    work->asyncErrorHandling_ = asyncErrorHandling_;
     work->opTimeout_ = opTimeout_;
     work->store_ = store_;
   }
 
+  enqueueWork(work);
   return work;
 }
 
@@ -735,6 +934,61 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
       [](std::vector<at::cuda::CUDAStream>&) {});
 }
 
+template <typename Fn, typename PostProcess>
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collectiveCoalesced(
+    std::vector<at::Tensor>& inputs,
+    std::vector<at::Tensor>& outputs,
+    Fn fn,
+    PostProcess post) {
+  checkAsyncError();
+
+  const std::vector<at::Device> devices = {inputs.front().device()};
+  const auto key = getKeyFromDevices(devices);
+  auto& ncclComms = getNCCLComm(key, devices);
+
+  // First let NCCL streams wait for input tensors allocation streams
+  syncStreams(devices, ncclEvents_[key], ncclStreams_[key]);
+
+  auto work = initWork(devices);
+
+  at::cuda::OptionalCUDAGuard gpuGuard(devices[0]);
+  at::cuda::CUDAStream& ncclStream = ncclStreams_[key][0];
+  ncclComm_t comm = ncclComms[0]->getNcclComm();
+
+  // See [Sync Streams].
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    c10::cuda::CUDACachingAllocator::recordStream(
+        inputs[i].storage().data_ptr(), ncclStream);
+    if (!outputs[i].is_same(inputs[i])) {
+      c10::cuda::CUDACachingAllocator::recordStream(
+          outputs[i].storage().data_ptr(), ncclStream);
+    }
+  }
+
+  // NCCL versions before 2.7 fail on groups of more than 2048 operations, so
+  // very long lists are split in several groups.
+  for (size_t begin = 0; begin < inputs.size(); begin += kMaxOpsPerNcclGroup) {
+    const auto end = std::min(inputs.size(), begin + kMaxOpsPerNcclGroup);
+    AutoNcclGroup nccl_group_guard;
+    for (size_t i = begin; i < end; ++i) {
+      C10D_NCCL_CHECK(fn(inputs[i], outputs[i], comm, ncclStream));
+    }
+  }
+
+  post(ncclStream);
+
+  // Event should only be recorded after the ncclGroupEnd()
+  work->cudaEvents_[0].record(ncclStream);
+  work->ncclComms_[0] = ncclComms[0];
+  work->blockingWait_ = blockingWait_;
+  work->asyncErrorHandling_ = asyncErrorHandling_;
+  work->opTimeout_ = opTimeout_;
+  work->store_ = store_;
+
+  enqueueWork(work);
+  return work;
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
     std::vector<at::Tensor>& tensors,
     const AllreduceOptions& opts) {
@@ -761,8 +1015,25 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
-  throw std::runtime_error(
-      "allreduce_coalesced is currently not supported with NCCL");
+  check_single_gpu_tensors(tensors);
+
+  return collectiveCoalesced(
+      tensors,
+      tensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        return ncclAllReduce(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            ncclOp[opts.reduceOp],
+            comm,
+            stream.stream());
+      },
+      [](at::cuda::CUDAStream&) {});
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
@@ -788,6 +1059,31 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
       });
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  check_single_gpu_tensors(tensors);
+
+  return collectiveCoalesced(
+      tensors,
+      tensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        // A single device per process, so the rank of the root in the
+        // communicator is its rank in the process group.
+        return ncclBcast(
+            input.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            opts.rootRank,
+            comm,
+            stream.stream());
+      },
+      [](at::cuda::CUDAStream&) {});
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce(
     std::vector<at::Tensor>& tensors,
     const ReduceOptions& opts) {
@@ -857,11 +1153,72 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_coalesced(
-    std::vector<std::vector<at::Tensor>>& /* unused */,
-    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& outputLists,
+    std::vector<at::Tensor>& inputTensors,
     const AllgatherOptions& /* unused */) {
-  throw std::runtime_error(
-      "ProcessGroupNCCL does not support allgather_coalesced");
+  check_single_gpu_tensors(inputTensors);
+
+  // As in ProcessGroupGloo::allgather_coalesced, outputLists[r][i] receives
+  // the i-th input of rank r.
+  if (outputLists.size() != static_cast<size_t>(size_)) {
+    throw std::runtime_error(
+        "allgather_coalesced needs one output list per rank");
+  }
+  for (const auto& outputs : outputLists) {
+    if (outputs.size() != inputTensors.size()) {
+      throw std::runtime_error(
+          "allgather_coalesced needs one output per input in every list");
+    }
+    for (size_t i = 0; i < inputTensors.size(); ++i) {
+      if (outputs[i].device() != inputTensors[i].device() ||
+          outputs[i].scalar_type() != inputTensors[i].scalar_type() ||
+          outputs[i].numel() != inputTensors[i].numel()) {
+        throw std::runtime_error(
+            "allgather_coalesced outputs must match the inputs in device, "
+            "type and number of elements");
+      }
+    }
+  }
+
+  // NCCL gathers each input in the memory order of its elements, so the
+  // inputs have to be contiguous to be copied out as views of the buffers.
+  std::vector<at::Tensor> inputs;
+  std::vector<at::Tensor> gathered;
+  inputs.reserve(inputTensors.size());
+  gathered.reserve(inputTensors.size());
+  for (const auto& input : inputTensors) {
+    inputs.push_back(input.contiguous());
+    gathered.push_back(at::empty({size_, input.numel()}, input.options()));
+  }
+
+  return collectiveCoalesced(
+      inputs,
+      gathered,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        return ncclAllGather(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      },
+      [&](at::cuda::CUDAStream& ncclStream) {
+        // Copy the gathered buffers to the outputs.
+        at::cuda::CUDAStreamGuard guard(ncclStream);
+        for (size_t r = 0; r < outputLists.size(); ++r) {
+          for (size_t i = 0; i < outputLists[r].size(); ++i) {
+            // See [Sync Streams].
+            c10::cuda::CUDACachingAllocator::recordStream(
+                outputLists[r][i].storage().data_ptr(), ncclStream);
+            outputLists[r][i].copy_(
+                gathered[i][r].view(inputs[i].sizes()), true);
+          }
+        }
+      });
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
@@ -908,6 +1265,61 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
       [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {});
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputSplitSizes,
+    std::vector<int64_t>& inputSplitSizes,
+    const AllToAllOptions& /* unused */) {
+#ifdef ENABLE_NCCL_P2P_SUPPORT
+  std::vector<at::Tensor> inputTensors = {inputTensor};
+  std::vector<at::Tensor> outputTensors = {outputTensor};
+  check_single_gpu_tensors({inputTensor, outputTensor});
+  if (!inputTensor.is_contiguous() || !outputTensor.is_contiguous()) {
+    throw std::runtime_error("Tensors to alltoall must be contiguous");
+  }
+  if (inputTensor.scalar_type() != outputTensor.scalar_type()) {
+    throw std::runtime_error("Tensors to alltoall must have identical type");
+  }
+  const auto sendCounts = alltoall_counts(inputSplitSizes, inputTensor, size_);
+  const auto recvCounts =
+      alltoall_counts(outputSplitSizes, outputTensor, size_);
+
+  return collective(
+      inputTensors,
+      outputTensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            output.storage().data_ptr(), stream);
+        const auto type = getNcclDataType(input.scalar_type());
+        const size_t elementSize = input.element_size();
+        auto sendData = static_cast<char*>(input.data_ptr());
+        auto recvData = static_cast<char*>(output.data_ptr());
+        for (int r = 0; r < size_; ++r) {
+          // Both ends of an empty split skip it, so the sends and receives
+          // still match.
+          if (sendCounts[r] != 0) {
+            C10D_NCCL_CHECK(ncclSend(
+                sendData, sendCounts[r], type, r, comm, stream.stream()));
+          }
+          if (recvCounts[r] != 0) {
+            C10D_NCCL_CHECK(ncclRecv(
+                recvData, recvCounts[r], type, r, comm, stream.stream()));
+          }
+          sendData += sendCounts[r] * elementSize;
+          recvData += recvCounts[r] * elementSize;
+        }
+        return ncclSuccess;
+      });
+#else
+  throw std::runtime_error(
+      "ProcessGroupNCCL only supports alltoall with NCCL 2.7 or later");
+#endif // ENABLE_NCCL_P2P_SUPPORT
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::barrier(
     const BarrierOptions& opts) {
   std::vector<at::Device> devices;
@@ -963,17 +1375,132 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::scatter(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::send(
-    std::vector<at::Tensor>& /* unused */,
-    int /* unused */,
+    std::vector<at::Tensor>& tensors,
+    int dstRank,
     int /* unused */) {
-  throw std::runtime_error("ProcessGroupNCCL does not support send");
+  if (tensors.size() != 1) {
+    throw std::runtime_error(
+        "ProcessGroupNCCL only supports sending a single tensor");
+  }
+  std::vector<P2POp> ops = {P2POp(true, tensors[0], dstRank)};
+  return batchSendRecv(ops);
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::recv(
-    std::vector<at::Tensor>& /* unused */,
-    int /* unused */,
+    std::vector<at::Tensor>& tensors,
+    int srcRank,
     int /* unused */) {
-  throw std::runtime_error("ProcessGroupNCCL does not support recv");
+  if (tensors.size() != 1) {
+    throw std::runtime_error(
+        "ProcessGroupNCCL only supports receiving a single tensor");
+  }
+  std::vector<P2POp> ops = {P2POp(false, tensors[0], srcRank)};
+  return batchSendRecv(ops);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::batchSendRecv(
+    std::vector<P2POp>& ops) {
+#ifdef ENABLE_NCCL_P2P_SUPPORT
+  checkAsyncError();
+
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(ops.size());
+  for (const auto& op : ops) {
+    if (op.peer < 0 || op.peer >= size_ || op.peer == rank_) {
+      throw std::runtime_error(
+          "Invalid peer rank for a NCCL send or receive: " +
+          std::to_string(op.peer));
+    }
+    tensors.push_back(op.tensor);
+  }
+  check_single_gpu_tensors(tensors);
+  const std::vector<at::Device> devices = {tensors.front().device()};
+  const auto devicesKey = getKeyFromDevices(devices);
+
+  // Each pair of ranks has its own communicators, which only the pair creates
+  // and which are cached like the others. They are looked up in the order of
+  // the peers, which is the same order on all ranks, so that the creation
+  // of the communicators of one rank with its several peers doesn't deadlock.
+  std::vector<int> peers;
+  for (const auto& op : ops) {
+    peers.push_back(op.peer);
+  }
+  std::sort(peers.begin(), peers.end());
+  peers.erase(std::unique(peers.begin(), peers.end()), peers.end());
+
+  std::vector<std::string> keys;
+  std::vector<ncclComm_t> comms;
+  auto work = initWork(std::vector<at::Device>(peers.size(), devices[0]));
+  for (size_t i = 0; i < peers.size(); ++i) {
+    const std::vector<int> ranks = {
+        std::min(rank_, peers[i]), std::max(rank_, peers[i])};
+    keys.push_back(
+        devicesKey + ":" + std::to_string(ranks[0]) + "," +
+        std::to_string(ranks[1]));
+    auto& ncclComms = getNCCLComm(keys[i], devices, ranks);
+    comms.push_back(ncclComms[0]->getNcclComm());
+    work->ncclComms_[i] = ncclComms[0];
+
+    // First let NCCL streams wait for input tensors allocation streams
+    syncStreams(devices, ncclEvents_[keys[i]], ncclStreams_[keys[i]]);
+  }
+
+  at::cuda::OptionalCUDAGuard gpuGuard(devices[0]);
+
+  // See [Sync Streams].
+  std::vector<size_t> peerIndices;
+  peerIndices.reserve(ops.size());
+  for (const auto& op : ops) {
+    const auto peerIndex =
+        std::lower_bound(peers.begin(), peers.end(), op.peer) - peers.begin();
+    peerIndices.push_back(peerIndex);
+    c10::cuda::CUDACachingAllocator::recordStream(
+        op.tensor.storage().data_ptr(), ncclStreams_[keys[peerIndex]][0]);
+  }
+
+  for (size_t begin = 0; begin < ops.size(); begin += kMaxOpsPerNcclGroup) {
+    const auto end = std::min(ops.size(), begin + kMaxOpsPerNcclGroup);
+    AutoNcclGroup nccl_group_guard;
+    for (size_t i = begin; i < end; ++i) {
+      auto& tensor = ops[i].tensor;
+      // The lower rank of a pair is rank 0 of its communicators
+      const int peer = ops[i].peer < rank_ ? 0 : 1;
+      auto& stream = ncclStreams_[keys[peerIndices[i]]][0];
+      if (ops[i].isSend) {
+        C10D_NCCL_CHECK(ncclSend(
+            tensor.data_ptr(),
+            tensor.numel(),
+            getNcclDataType(tensor.scalar_type()),
+            peer,
+            comms[peerIndices[i]],
+            stream.stream()));
+      } else {
+        C10D_NCCL_CHECK(ncclRecv(
+            tensor.data_ptr(),
+            tensor.numel(),
+            getNcclDataType(tensor.scalar_type()),
+            peer,
+            comms[peerIndices[i]],
+            stream.stream()));
+      }
+    }
+  }
+
+  // Event should only be recorded after the ncclGroupEnd()
+  for (size_t i = 0; i < peers.size(); ++i) {
+    work->cudaEvents_[i].record(ncclStreams_[keys[i]][0]);
+  }
+  work->blockingWait_ = blockingWait_;
+  work->asyncErrorHandling_ = asyncErrorHandling_;
+  work->opTimeout_ = opTimeout_;
+  work->store_ = store_;
+
+  enqueueWork(work);
+  return work;
+#else
+  throw std::runtime_error(
+      "ProcessGroupNCCL only supports send and recv with NCCL 2.7 or later");
+#endif // ENABLE_NCCL_P2P_SUPPORT
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::recvAnysource(
@@ -983,11 +1510,43 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::recvAnysource(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_base(
-    at::Tensor& /*unused */,
-    at::Tensor& /*unused */,
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
     const AllgatherOptions& /*unused */) {
-  throw std::runtime_error(
-      "no support for allgather_base in NCCL process group");
+  check_single_gpu_tensors({outputBuffer, inputBuffer});
+  if (outputBuffer.scalar_type() != inputBuffer.scalar_type()) {
+    throw std::runtime_error(
+        "allgather_base input and output buffers must have the same type");
+  }
+  if (outputBuffer.numel() != inputBuffer.numel() * size_) {
+    throw std::runtime_error(
+        "allgather_base output buffer must have world size times the "
+        "elements of the input buffer");
+  }
+  if (!outputBuffer.is_contiguous() || !inputBuffer.is_contiguous()) {
+    throw std::runtime_error("allgather_base buffers must be contiguous");
+  }
+
+  // NCCL writes the contributions of the ranks one after the other, straight
+  // into the output buffer.
+  std::vector<at::Tensor> inputs = {inputBuffer};
+  std::vector<at::Tensor> outputs = {outputBuffer};
+  return collectiveCoalesced(
+      inputs,
+      outputs,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        return ncclAllGather(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      },
+      [](at::cuda::CUDAStream&) {});
 }
 
 } // namespace c10d
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <list>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
@@ -17,6 +18,12 @@ namespace c10d {
 // non-blocking.
 constexpr const char* NCCL_BLOCKING_WAIT = "NCCL_BLOCKING_WAIT";
 
+// Environment variable which controls whether a thread of the process group
+// watches the outstanding work, and aborts the communicators of the work that
+// fails or times out, without waiting for wait() to be called. The error is
+// then thrown by the next collective of the process group.
+constexpr const char* NCCL_ASYNC_ERROR_HANDLING = "NCCL_ASYNC_ERROR_HANDLING";
+
 // ProcessGroupNCCL implements NCCL bindings for c10d.
 //
 // All functions of the class are expected to be called in the same order
@@ -54,6 +61,17 @@ constexpr const char* NCCL_BLOCKING_WAIT = "NCCL_BLOCKING_WAIT";
 //   // Now continue on other work in the current stream.
 class ProcessGroupNCCL : public ProcessGroup {
  public:
+  // A send or a receive of batchSendRecv
+  struct P2POp {
+    P2POp(bool isSend, at::Tensor tensor, int peer)
+        : isSend(isSend), tensor(std::move(tensor)), peer(peer) {}
+
+    bool isSend;
+    at::Tensor tensor;
+    // Rank to send to or to receive from
+    int peer;
+  };
+
   class WorkNCCL : public ProcessGroup::Work {
    public:
     // Constructor takes a list of CUDA devices
@@ -97,6 +115,9 @@ class ProcessGroupNCCL : public ProcessGroup {
     // Clone of blockingWait_ from ProcessGroupNCCL.
     bool blockingWait_ = false;
 
+    // Clone of asyncErrorHandling_ from ProcessGroupNCCL.
+    bool asyncErrorHandling_ = false;
+
     // Clone of opTimeout_ from ProcessGroupNCCL.
     std::chrono::milliseconds opTimeout_;
 
@@ -121,6 +142,16 @@ class ProcessGroupNCCL : public ProcessGroup {
     // exception_ptr.
     bool finishedGPUExecutionInternal() const;
 
+    // Whether the work has been running for longer than opTimeout_.
+    bool timedOut() const;
+
+    // Sets the exception of the work, unless it already has one.
+    void setException(std::exception_ptr exception);
+
+    // Aborts the communicators of the work and writes their ids to the store,
+    // so that the watchdogs of the other ranks abort them too.
+    void abortCommunicators();
+
     // Reference to the store so that we can write aborted communicators
     // to the store.
     std::shared_ptr<Store> store_;
@@ -167,6 +198,13 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<at::Tensor>& tensors,
       const BroadcastOptions& opts = BroadcastOptions()) override;
 
+  // The coalesced collectives take any number of tensors on a single device,
+  // and issue the operations on all of them in a single NCCL group, without
+  // flattening them.
+  std::shared_ptr<ProcessGroup::Work> broadcast_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> allreduce(
       std::vector<at::Tensor>& tensors,
       const AllreduceOptions& opts = AllreduceOptions()) override;
@@ -200,6 +238,15 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputTensors,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  // Sends and receives the splits along dim 0 with ncclSend() and ncclRecv()
+  // to and from every rank, in one NCCL group. Requires NCCL 2.7 or later.
+  std::shared_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputSplitSizes,
+      std::vector<int64_t>& inputSplitSizes,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> barrier(
       const BarrierOptions& opts = BarrierOptions()) override;
 
@@ -228,17 +275,31 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<at::Tensor>& tensors,
       int tag) override;
 
+  // Issues all the sends and receives of `ops', of tensors on a single GPU,
+  // in one NCCL group, so that they proceed concurrently, e.g. the exchanges
+  // of a pipeline stage with both of its neighbors. NCCL has no tags: the
+  // operations between two ranks match in the order they are issued. The work
+  // completes with all of them. Requires NCCL 2.7 or later.
+  std::shared_ptr<ProcessGroup::Work> batchSendRecv(std::vector<P2POp>& ops);
+
   static const int64_t kProcessGroupNCCLOpTimeoutMillis;
 
  protected:
-  // Helper that broadcasts nccl unique ID to all ranks through the store
-  void broadcastUniqueNCCLID(ncclUniqueId* ncclID);
+  // Helper that broadcasts nccl unique ID to the ranks of the communicator
+  // through the store: all ranks, or the sorted `ranks' of a point-to-point
+  // communicator
+  void broadcastUniqueNCCLID(
+      ncclUniqueId* ncclID,
+      const std::vector<int>& ranks = {});
 
   // Helper that either looks up the cached NCCL communicators or creates
-  // a new set of NCCL communicators as a cache entry
+  // a new set of NCCL communicators as a cache entry. The communicators span
+  // all ranks, or only the sorted `ranks' if given, which then are the only
+  // ones to take part in their creation.
   std::vector<std::shared_ptr<NCCLComm>>& getNCCLComm(
       const std::string& devicesKey,
-      const std::vector<at::Device>& devices);
+      const std::vector<at::Device>& devices,
+      const std::vector<int>& ranks = {});
 
   // Wrapper method which can be overridden for tests.
   virtual std::exception_ptr checkForNCCLErrors(
@@ -267,6 +328,16 @@ class ProcessGroupNCCL : public ProcessGroup {
       PreProcess pre,
       PostProcess post);
 
+  // Same as collective(), for any number of tensors on a single device: `fn'
+  // is called on every pair of input and output in the same NCCL group, on
+  // the NCCL stream of the device, and the work completes with all of them.
+  template <typename Fn, typename PostProcess>
+  std::shared_ptr<ProcessGroup::Work> collectiveCoalesced(
+      std::vector<at::Tensor>& inputs,
+      std::vector<at::Tensor>& outputs,
+      Fn fn,
+      PostProcess post);
+
   // Checks for NCCL errors on each of the communicators and returns an
   // appropriate exception_ptr (nullptr if no errors).
   static std::exception_ptr checkForNCCLErrorsInternal(
@@ -285,13 +356,32 @@ class ProcessGroupNCCL : public ProcessGroup {
 
   void ncclCommWatchdogInternal();
 
+  // Function that runs as part of a separate thread when asyncErrorHandling_
+  // is set. It removes the completed work from workList_, and aborts the
+  // communicators of the work that failed or timed out, which unblocks the
+  // kernels of this rank waiting for the other ranks. The first error is kept
+  // in asyncError_.
+  void workCleanupLoop();
+
+  // Adds the work to workList_ when asyncErrorHandling_ is set.
+  void enqueueWork(const std::shared_ptr<WorkNCCL>& work);
+
+  // Throws the error found by workCleanupLoop, if any.
+  void checkAsyncError();
+
   // Reads the NCCL_BLOCKING_WAIT environment variable and sets blockingWait_
   // accordingly.
   void parseNcclBlockingWait();
 
+  // Reads the NCCL_ASYNC_ERROR_HANDLING environment variable and sets
+  // asyncErrorHandling_ accordingly.
+  void parseNcclAsyncErrorHandling();
+
  protected:
   static const int64_t kWatchdogThreadSleepMillis;
 
+  static const int64_t kWorkCleanupThreadSleepMillis;
+
   // The store is used to broadcast the NCCL unique ID of rank 0.
   std::shared_ptr<Store> store_;
 
@@ -300,6 +390,10 @@ class ProcessGroupNCCL : public ProcessGroup {
   // used to scope keys used in the store.
   uint64_t ncclCommCounter_{0};
 
+  // Same as ncclCommCounter_, for the communicators of a set of ranks, which
+  // the other ranks don't create.
+  std::unordered_map<std::string, uint64_t> p2pCommCounters_;
+
   // The NCCL communicator that the process group has cached.
   // The key is a list of GPU devices that an operation is operating on
   // The GPU devices are stored in a device sequence and the cache NCCL
@@ -341,6 +435,21 @@ class ProcessGroupNCCL : public ProcessGroup {
   // Mutex for watchdog.
   std::mutex watchdogCVMutex_;
 
+  // Thread running workCleanupLoop, when asyncErrorHandling_ is set.
+  std::thread workCleanupThread_;
+
+  // Outstanding work, watched by workCleanupLoop.
+  std::list<std::shared_ptr<WorkNCCL>> workList_;
+
+  // First error found by workCleanupLoop, thrown by the next collective.
+  std::exception_ptr asyncError_;
+
+  // Mutex to guard workList_ and asyncError_.
+  std::mutex workListMutex_;
+
+  // Condition variable to control how long workCleanupLoop waits.
+  std::condition_variable workListCV_;
+
   // The CUDA steams used by NCCL kernels
   std::unordered_map<std::string, std::vector<at::cuda::CUDAStream>>
       ncclStreams_;
@@ -375,7 +484,11 @@ class ProcessGroupNCCL : public ProcessGroup {
   // for the operation to complete.
   bool blockingWait_ = false;
 
-  // Timeout for operations. This is only used when blockingWait_ is enabled.
+  // Whether or not the outstanding work is watched by workCleanupLoop.
+  bool asyncErrorHandling_ = false;
+
+  // Timeout for operations. This is only used when blockingWait_ or
+  // asyncErrorHandling_ is enabled.
   std::chrono::milliseconds opTimeout_;
 
   // Set of communicators that this process group has aborted and their
@@ -23,6 +23,12 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::broadcast(
   return next()->broadcast(tensors, opts);
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::broadcast_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  return next()->broadcast_coalesced(tensors, opts);
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allreduce(
     std::vector<at::Tensor>& tensors,
     const AllreduceOptions& opts) {
@@ -111,11 +117,10 @@ const std::shared_ptr<ProcessGroup>& ProcessGroupRoundRobin::next() {
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allgather_base(
-    at::Tensor& /*unused */,
-    at::Tensor& /*unused */,
-    const AllgatherOptions& /*unused */) {
-  throw std::runtime_error(
-      "no support for allgather_base in RoundRobin process group");
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const AllgatherOptions& opts) {
+  return next()->allgather_base(outputBuffer, inputBuffer, opts);
 }
 
 } // namespace c10d
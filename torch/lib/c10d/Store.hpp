@@ -38,6 +38,24 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Batched versions of get and set. Stores that can do them in fewer round
+  // trips override them, by default they call get and set for every key.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  // Atomically sets `key` to `desiredValue` if its current value is
+  // `expectedValue`, or if it doesn't exist and `expectedValue` is empty.
+  // Returns the value of `key` after the operation, or `expectedValue` if it
+  // doesn't exist. Not supported by default.
+  virtual std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
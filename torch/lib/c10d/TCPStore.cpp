@@ -1,21 +1,57 @@
 #include <c10d/TCPStore.hpp>
 
 #include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #include <unistd.h>
 #include <algorithm>
 #include <system_error>
+#include <unordered_set>
 
 namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_GET,
+  MULTI_SET,
+  COMPARE_SET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
 enum class WaitResponseType : uint8_t { STOP_WAITING };
 
+#ifdef __linux__
+// Maximum number of events handled per call to epoll_wait
+constexpr int kMaxEpollEvents = 256;
+#endif
+
+std::vector<std::string> recvKeys(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  return keys;
+}
+
+void sendKeys(int socket, const std::vector<std::string>& keys, bool moreData) {
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(socket, &nkeys, 1, moreData || (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(socket, keys[i], moreData || (i != (nkeys - 1)));
+  }
+}
+
 } // anonymous namespace
 
 // TCPStoreDaemon class methods
@@ -54,6 +90,66 @@ void TCPStoreDaemon::join() {
   daemonThread_.join();
 }
 
+#ifdef __linux__
+
+// With epoll, every round only visits the sockets that have a request, instead
+// of all the connected workers.
+void TCPStoreDaemon::run() {
+  int epollFd;
+  SYSCHECK_ERR_RETURN_NEG1(epollFd = ::epoll_create1(EPOLL_CLOEXEC));
+  const auto addFd = [epollFd](int fd, uint32_t events) {
+    struct epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+    SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event));
+  };
+  addFd(storeListenSocket_, EPOLLIN);
+  // The read end of the pipe signals the stopping of the daemon run
+  addFd(controlPipeFd_[0], EPOLLHUP);
+
+  std::vector<struct epoll_event> events(kMaxEpollEvents);
+  bool finished = false;
+  while (!finished) {
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd, events.data(), events.size(), -1));
+
+    for (int i = 0; i < numEvents && !finished; ++i) {
+      const int fd = events[i].data.fd;
+      const uint32_t revents = events[i].events;
+      if (fd == storeListenSocket_) {
+        // TCPStore's listening socket has an event and it should now be able
+        // to accept new connections.
+        if (revents ^ EPOLLIN) {
+          ::close(epollFd);
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the master's listening socket: " +
+                  std::to_string(revents));
+        }
+        int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
+        sockets_.push_back(sockFd);
+        addFd(sockFd, EPOLLIN);
+      } else if (fd == controlPipeFd_[0]) {
+        // The pipe receives an event which tells us to shutdown the daemon
+        finished = true;
+      } else {
+        try {
+          query(fd);
+        } catch (...) {
+          // See the poll based run below. Closing the socket also removes it
+          // from the epoll set.
+          closeSocket(fd);
+        }
+      }
+    }
+  }
+  ::close(epollFd);
+}
+
+#else
+
 void TCPStoreDaemon::run() {
   std::vector<struct pollfd> fds;
   fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
@@ -63,7 +159,7 @@ void TCPStoreDaemon::run() {
   // receive the queries
   bool finished = false;
   while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
+    for (size_t i = 0; i < fds.size(); i++) {
       fds[i].revents = 0;
     }
 
@@ -115,32 +211,8 @@ void TCPStoreDaemon::run() {
         // exception, other connections will get an exception once they try to
         // use the store. We will go ahead and close this connection whenever
         // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
+        closeSocket(fds[fdIdx].fd);
         fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
         --fdIdx;
         continue;
       }
@@ -148,6 +220,28 @@ void TCPStoreDaemon::run() {
   }
 }
 
+#endif
+
+void TCPStoreDaemon::closeSocket(int socket) {
+  ::close(socket);
+
+  // Remove all the tracking state of the close FD
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    auto& sockets = it->second;
+    sockets.erase(
+        std::remove(sockets.begin(), sockets.end(), socket), sockets.end());
+    if (sockets.size() == 0) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+  pendingGets_.erase(socket);
+  sockets_.erase(
+      std::remove(sockets_.begin(), sockets_.end(), socket), sockets_.end());
+}
+
 void TCPStoreDaemon::stop() {
   if (controlPipeFd_[1] != -1) {
     // close the write end of the pipe
@@ -159,7 +253,7 @@ void TCPStoreDaemon::stop() {
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of queries taking several keys
 // type of query | number of args | size of arg1 | arg1 | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
@@ -180,6 +274,15 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::WAIT) {
     waitHandler(socket);
 
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::COMPARE_SET) {
+    compareSetHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -187,14 +290,26 @@ void TCPStoreDaemon::query(int socket) {
 
 void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
   auto socketsToWait = waitingSockets_.find(key);
-  if (socketsToWait != waitingSockets_.end()) {
-    for (int socket : socketsToWait->second) {
-      if (--keysAwaited_[socket] == 0) {
-        tcputil::sendValue<WaitResponseType>(
-            socket, WaitResponseType::STOP_WAITING);
-      }
+  if (socketsToWait == waitingSockets_.end()) {
+    return;
+  }
+  const auto sockets = std::move(socketsToWait->second);
+  waitingSockets_.erase(socketsToWait);
+  for (int socket : sockets) {
+    auto it = keysAwaited_.find(socket);
+    if (it == keysAwaited_.end() || --it->second > 0) {
+      continue;
+    }
+    keysAwaited_.erase(it);
+    auto pendingGet = pendingGets_.find(socket);
+    if (pendingGet != pendingGets_.end()) {
+      const auto keys = std::move(pendingGet->second);
+      pendingGets_.erase(pendingGet);
+      sendValues(socket, keys);
+    } else {
+      tcputil::sendValue<WaitResponseType>(
+          socket, WaitResponseType::STOP_WAITING);
     }
-    waitingSockets_.erase(socketsToWait);
   }
 }
 
@@ -205,6 +320,36 @@ void TCPStoreDaemon::setHandler(int socket) {
   wakeupWaitingClients(key);
 }
 
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  const auto keys = recvKeys(socket);
+  for (const auto& key : keys) {
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+  }
+  for (const auto& key : keys) {
+    wakeupWaitingClients(key);
+  }
+}
+
+void TCPStoreDaemon::compareSetHandler(int socket) {
+  std::string key = tcputil::recvString(socket);
+  auto expectedValue = tcputil::recvVector<uint8_t>(socket);
+  auto desiredValue = tcputil::recvVector<uint8_t>(socket);
+
+  auto it = tcpStore_.find(key);
+  if (it == tcpStore_.end()) {
+    if (!expectedValue.empty()) {
+      tcputil::sendVector<uint8_t>(socket, expectedValue);
+      return;
+    }
+  } else if (it->second != expectedValue) {
+    tcputil::sendVector<uint8_t>(socket, it->second);
+    return;
+  }
+  tcpStore_[key] = desiredValue;
+  tcputil::sendVector<uint8_t>(socket, desiredValue);
+  wakeupWaitingClients(key);
+}
+
 void TCPStoreDaemon::addHandler(int socket) {
   std::string key = tcputil::recvString(socket);
   int64_t addVal = tcputil::recvValue<int64_t>(socket);
@@ -222,19 +367,28 @@ void TCPStoreDaemon::addHandler(int socket) {
   wakeupWaitingClients(key);
 }
 
-void TCPStoreDaemon::getHandler(int socket) const {
-  std::string key = tcputil::recvString(socket);
-  auto data = tcpStore_.at(key);
-  tcputil::sendVector<uint8_t>(socket, data);
+// A get that doesn't find its key waits for it, and only replies once it is
+// set, so that getting a key takes a single round trip.
+void TCPStoreDaemon::getHandler(int socket) {
+  std::vector<std::string> keys = {tcputil::recvString(socket)};
+  if (addWaitingSocket(socket, keys)) {
+    pendingGets_[socket] = std::move(keys);
+  } else {
+    sendValues(socket, keys);
+  }
 }
 
-void TCPStoreDaemon::checkHandler(int socket) const {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
+void TCPStoreDaemon::multiGetHandler(int socket) {
+  auto keys = recvKeys(socket);
+  if (addWaitingSocket(socket, keys)) {
+    pendingGets_[socket] = std::move(keys);
+  } else {
+    sendValues(socket, keys);
   }
+}
+
+void TCPStoreDaemon::checkHandler(int socket) const {
+  const auto keys = recvKeys(socket);
   // Now we have received all the keys
   if (checkKeys(keys)) {
     tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::READY);
@@ -244,20 +398,10 @@ void TCPStoreDaemon::checkHandler(int socket) const {
 }
 
 void TCPStoreDaemon::waitHandler(int socket) {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
-  }
-  if (checkKeys(keys)) {
+  const auto keys = recvKeys(socket);
+  if (!addWaitingSocket(socket, keys)) {
     tcputil::sendValue<WaitResponseType>(
         socket, WaitResponseType::STOP_WAITING);
-  } else {
-    for (auto& key : keys) {
-      waitingSockets_[key].push_back(socket);
-    }
-    keysAwaited_[socket] = keys.size();
   }
 }
 
@@ -267,6 +411,35 @@ bool TCPStoreDaemon::checkKeys(const std::vector<std::string>& keys) const {
   });
 }
 
+bool TCPStoreDaemon::addWaitingSocket(
+    int socket,
+    const std::vector<std::string>& keys) {
+  // Only the missing keys are awaited, the others may never be set again
+  std::unordered_set<std::string> missingKeys;
+  for (const auto& key : keys) {
+    if (tcpStore_.count(key) == 0) {
+      missingKeys.insert(key);
+    }
+  }
+  if (missingKeys.empty()) {
+    return false;
+  }
+  for (const auto& key : missingKeys) {
+    waitingSockets_[key].push_back(socket);
+  }
+  keysAwaited_[socket] = missingKeys.size();
+  return true;
+}
+
+void TCPStoreDaemon::sendValues(
+    int socket,
+    const std::vector<std::string>& keys) const {
+  for (size_t i = 0; i < keys.size(); i++) {
+    tcputil::sendVector<uint8_t>(
+        socket, tcpStore_.at(keys[i]), i != (keys.size() - 1));
+  }
+}
+
 // TCPStore class methods
 TCPStore::TCPStore(
     const std::string& masterAddr,
@@ -346,12 +519,62 @@ std::vector<uint8_t> TCPStore::get(const std::string& key) {
 }
 
 std::vector<uint8_t> TCPStore::getHelper_(const std::string& key) {
-  waitHelper_({key}, timeout_);
-  tcputil::sendValue<QueryType>(storeSocket_, QueryType::GET);
+  // The daemon replies once the key is set
+  setReceiveTimeout_(timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::GET, true);
   tcputil::sendString(storeSocket_, key);
   return tcputil::recvVector<uint8_t>(storeSocket_);
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.reserve(keys.size());
+  for (const auto& key : keys) {
+    regKeys.emplace_back(regularPrefix_ + key);
+  }
+  setReceiveTimeout_(timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET, true);
+  sendKeys(storeSocket_, regKeys, false);
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values.emplace_back(tcputil::recvVector<uint8_t>(storeSocket_));
+  }
+  return values;
+}
+
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument("multiSet needs one value per key");
+  }
+  std::vector<std::string> regKeys;
+  regKeys.reserve(keys.size());
+  for (const auto& key : keys) {
+    regKeys.emplace_back(regularPrefix_ + key);
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET, true);
+  sendKeys(storeSocket_, regKeys, !values.empty());
+  for (size_t i = 0; i < values.size(); ++i) {
+    tcputil::sendVector<uint8_t>(
+        storeSocket_, values[i], i != (values.size() - 1));
+  }
+}
+
+std::vector<uint8_t> TCPStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::string regKey = regularPrefix_ + key;
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::COMPARE_SET, true);
+  tcputil::sendString(storeSocket_, regKey, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, expectedValue, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, desiredValue);
+  return tcputil::recvVector<uint8_t>(storeSocket_);
+}
+
 int64_t TCPStore::add(const std::string& key, int64_t value) {
   std::string regKey = regularPrefix_ + key;
   return addHelper_(regKey, value);
@@ -365,13 +588,13 @@ int64_t TCPStore::addHelper_(const std::string& key, int64_t value) {
 }
 
 bool TCPStore::check(const std::vector<std::string>& keys) {
-  tcputil::sendValue<QueryType>(storeSocket_, QueryType::CHECK);
-  SizeType nkeys = keys.size();
-  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
-  for (size_t i = 0; i < nkeys; i++) {
-    std::string regKey = regularPrefix_ + keys[i];
-    tcputil::sendString(storeSocket_, regKey, (i != (nkeys - 1)));
+  std::vector<std::string> regKeys;
+  regKeys.reserve(keys.size());
+  for (const auto& key : keys) {
+    regKeys.emplace_back(regularPrefix_ + key);
   }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::CHECK, true);
+  sendKeys(storeSocket_, regKeys, false);
   auto checkResponse = tcputil::recvValue<CheckResponseType>(storeSocket_);
   if (checkResponse == CheckResponseType::READY) {
     return true;
@@ -397,9 +620,7 @@ void TCPStore::wait(
   waitHelper_(regKeys, timeout);
 }
 
-void TCPStore::waitHelper_(
-    const std::vector<std::string>& keys,
-    const std::chrono::milliseconds& timeout) {
+void TCPStore::setReceiveTimeout_(const std::chrono::milliseconds& timeout) {
   // Set the socket timeout if there is a wait timeout
   if (timeout != kNoTimeout) {
     struct timeval timeoutTV = {.tv_sec = timeout.count() / 1000,
@@ -411,12 +632,14 @@ void TCPStore::waitHelper_(
         reinterpret_cast<char*>(&timeoutTV),
         sizeof(timeoutTV)));
   }
-  tcputil::sendValue<QueryType>(storeSocket_, QueryType::WAIT);
-  SizeType nkeys = keys.size();
-  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
-  for (size_t i = 0; i < nkeys; i++) {
-    tcputil::sendString(storeSocket_, keys[i], (i != (nkeys - 1)));
-  }
+}
+
+void TCPStore::waitHelper_(
+    const std::vector<std::string>& keys,
+    const std::chrono::milliseconds& timeout) {
+  setReceiveTimeout_(timeout);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::WAIT, true);
+  sendKeys(storeSocket_, keys, false);
   auto waitResponse = tcputil::recvValue<WaitResponseType>(storeSocket_);
   if (waitResponse != WaitResponseType::STOP_WAITING) {
     throw std::runtime_error("Stop_waiting response is expected");
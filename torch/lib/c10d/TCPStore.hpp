@@ -22,13 +22,23 @@ class TCPStoreDaemon {
 
   void query(int socket);
 
+  // Closes a socket and drops the requests waiting on it
+  void closeSocket(int socket);
+
   void setHandler(int socket);
+  void multiSetHandler(int socket);
+  void compareSetHandler(int socket);
   void addHandler(int socket);
-  void getHandler(int socket) const;
+  void getHandler(int socket);
+  void multiGetHandler(int socket);
   void checkHandler(int socket) const;
   void waitHandler(int socket);
 
   bool checkKeys(const std::vector<std::string>& keys) const;
+  // Makes the socket wait for the keys that aren't in the store yet. Returns
+  // false if all of them already are.
+  bool addWaitingSocket(int socket, const std::vector<std::string>& keys);
+  void sendValues(int socket, const std::vector<std::string>& keys) const;
   void wakeupWaitingClients(const std::string& key);
 
   std::thread daemonThread_;
@@ -37,6 +47,9 @@ class TCPStoreDaemon {
   std::unordered_map<std::string, std::vector<int>> waitingSockets_;
   // From socket -> number of keys awaited
   std::unordered_map<int, size_t> keysAwaited_;
+  // From socket -> keys of a get waiting for them, the values are sent
+  // instead of a stop waiting response once they are all set
+  std::unordered_map<int, std::vector<std::string>> pendingGets_;
 
   std::vector<int> sockets_;
   int storeListenSocket_;
@@ -69,6 +82,19 @@ class TCPStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  // Waits for all the keys and gets them in a single round trip.
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue) override;
+
   // Waits for all workers to join.
   void waitForWorkers();
 
@@ -81,6 +107,8 @@ class TCPStore : public Store {
   void waitHelper_(
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout);
+  // Sets how long the replies of the daemon are awaited
+  void setReceiveTimeout_(const std::chrono::milliseconds& timeout);
 
   bool isServer_;
   int storeSocket_ = -1;
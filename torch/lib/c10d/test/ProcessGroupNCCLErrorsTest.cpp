@@ -1,4 +1,5 @@
 #include <chrono>
+#include <thread>
 
 #include <c10d/FileStore.hpp>
 #include <c10d/ProcessGroupNCCL.hpp>
@@ -54,6 +55,11 @@ class ProcessGroupNCCLSimulateErrors : public c10d::ProcessGroupNCCL {
         ProcessGroupNCCLSimulateErrors::kWatchdogThreadSleepMillis);
   }
 
+  std::chrono::duration<int64_t, std::milli> getWorkCleanupSleepInterval() {
+    return std::chrono::milliseconds(
+        ProcessGroupNCCLSimulateErrors::kWorkCleanupThreadSleepMillis);
+  }
+
   std::shared_ptr<ProcessGroupNCCL::WorkNCCL> initWork(
       std::vector<at::Device> devices) override {
     return std::make_shared<WorkNCCLSimulateErrors>(devices, simulate_error_);
@@ -152,6 +158,7 @@ class ProcessGroupNCCLErrorsTest : public ::testing::Test {
 
   void TearDown() override {
     ASSERT_TRUE(setenv(c10d::NCCL_BLOCKING_WAIT, "0", 1) == 0);
+    ASSERT_TRUE(setenv(c10d::NCCL_ASYNC_ERROR_HANDLING, "0", 1) == 0);
   }
 
   std::vector<at::Tensor> tensors_;
@@ -246,3 +253,62 @@ TEST_F(ProcessGroupNCCLErrorsTest, testNCCLErrorsNonBlocking) {
 
   // Communicators might be aborted here, further operations would fail.
 }
+
+TEST_F(ProcessGroupNCCLErrorsTest, testNCCLErrorsAsync) {
+  bool skip;
+  std::string skipReason;
+  std::tie(skip, skipReason) = skipTest();
+  if (skip) {
+    LOG(INFO) << skipReason;
+    return;
+  }
+
+  ASSERT_TRUE(setenv(c10d::NCCL_ASYNC_ERROR_HANDLING, "1", 1) == 0);
+  ProcessGroupNCCLSimulateErrors pg(
+      store_, 0, 1, std::chrono::milliseconds(3000));
+
+  auto work = pg.allreduce(tensors_);
+  work->wait();
+  EXPECT_TRUE(work->isSuccess());
+
+  // Now run all reduce with errors, wait() doesn't block.
+  pg.simulate_error();
+  work = pg.allreduce(tensors_);
+  work->wait();
+
+  // The cleanup thread finds the error and aborts the communicators, then
+  // the next collective throws it.
+  std::this_thread::sleep_for(2 * pg.getWorkCleanupSleepInterval());
+  pg.reset_error();
+  EXPECT_THROW(pg.allreduce(tensors_), std::runtime_error);
+  EXPECT_THROW(work->wait(), std::runtime_error);
+}
+
+TEST_F(ProcessGroupNCCLErrorsTest, testNCCLTimedoutErrorsAsync) {
+  bool skip;
+  std::string skipReason;
+  std::tie(skip, skipReason) = skipTest();
+  if (skip) {
+    LOG(INFO) << skipReason;
+    return;
+  }
+
+  ASSERT_TRUE(setenv(c10d::NCCL_ASYNC_ERROR_HANDLING, "1", 1) == 0);
+  ProcessGroupNCCLTimedOutErrors pg(
+      store_, 0, 1, std::chrono::milliseconds(1000));
+
+  auto work = pg.allreduce(tensors_);
+  work->wait();
+  EXPECT_TRUE(work->isSuccess());
+
+  // The work never completes, without blocking wait() returns right away.
+  pg.set_timedout_error();
+  work = pg.allreduce(tensors_);
+  work->wait();
+
+  // Once the work timed out, the next collective throws.
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(1000) + 2 * pg.getWorkCleanupSleepInterval());
+  pg.reset_timedout_error();
+  EXPECT_THROW(pg.allreduce(tensors_), std::runtime_error);
+}
@@ -116,3 +116,39 @@ TEST(TCPStoreTest, testHelper) {
 TEST(TCPStoreTest, testHelperPrefix) {
   testHelper("testPrefix");
 }
+
+// A get of a missing key is answered by the daemon once another client sets
+// it, and a multiGet once all of its keys are set.
+TEST(TCPStoreTest, testPendingGet) {
+  auto serverStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1", 0, 3, true, std::chrono::seconds(30), /* wait */ false);
+  auto getStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1", serverStore->getPort(), 3, false);
+  auto multiGetStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1", serverStore->getPort(), 3, false);
+
+  auto getThread = std::thread(
+      [&getStore] { c10d::test::check(*getStore, "key0", "value0"); });
+  std::vector<std::vector<uint8_t>> values;
+  auto multiGetThread = std::thread([&multiGetStore, &values] {
+    values = multiGetStore->multiGet({"key1", "key0", "key1"});
+  });
+
+  c10d::test::set(*serverStore, "key0", "value0");
+  serverStore->multiSet(
+      {"key1", "key2"},
+      {std::vector<uint8_t>{'1'}, std::vector<uint8_t>{'2'}});
+  getThread.join();
+  multiGetThread.join();
+
+  ASSERT_EQ(3, values.size());
+  EXPECT_EQ(std::vector<uint8_t>{'1'}, values[0]);
+  EXPECT_EQ(std::string("value0"), std::string(values[1].begin(), values[1].end()));
+  EXPECT_EQ(std::vector<uint8_t>{'1'}, values[2]);
+
+  const std::vector<uint8_t> two = {'2'};
+  const std::vector<uint8_t> three = {'3'};
+  EXPECT_EQ(two, getStore->compareSet("key2", three, three));
+  EXPECT_EQ(three, getStore->compareSet("key2", two, three));
+  c10d::test::check(*multiGetStore, "key2", "3");
+}
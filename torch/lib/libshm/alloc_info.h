@@ -5,5 +5,6 @@
 struct AllocInfo {
   pid_t pid;
   char free;
+  char pooled;
   char filename[60];
 };
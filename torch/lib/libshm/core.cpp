@@ -1,6 +1,10 @@
+#include <pthread.h>
+#include <cstdlib>
 #include <cstring>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <TH/TH.h>
 #include <libshm/err.h>
@@ -78,8 +82,8 @@ void libshm_init(const char *manager_exec_path) {
   manager_executable_path = std::string(manager_exec_path);
 }
 
-THManagedMapAllocatorInit::THManagedMapAllocatorInit(const char* manager_handle, const char* filename)
-  : manager_handle_(manager_handle ? manager_handle : "") {
+THManagedMapAllocatorInit::THManagedMapAllocatorInit(const char* manager_handle, const char* filename, size_t pooled_size)
+  : manager_handle_(manager_handle ? manager_handle : ""), pooled_size_(pooled_size), pool_pid_(getpid()) {
   // TODO: unlock GIL when contacting the manager
   try {
     ClientSocket *socket;
@@ -94,30 +98,143 @@ THManagedMapAllocatorInit::THManagedMapAllocatorInit(const char* manager_handle,
       socket = &manager->second;
     }
     AllocInfo info = get_alloc_info(filename);
+    info.pooled = pooled_size_ > 0;
     socket->register_allocation(info);
   } catch(std::exception &e) {
     THError(e.what());
   }
 }
 
-THManagedMapAllocator::THManagedMapAllocator(const char *manager_handle, const char *filename, int flags, ptrdiff_t size)
-  : THManagedMapAllocatorInit(manager_handle, filename), THRefcountedMapAllocator(filename, flags, size) {}
+THManagedMapAllocator::THManagedMapAllocator(const char *manager_handle, const char *filename, int flags, ptrdiff_t size, size_t pooled_size)
+  : THManagedMapAllocatorInit(manager_handle, filename, pooled_size), THRefcountedMapAllocator(filename, flags, size) {}
 
 void THManagedMapAllocator::close() {
   if (closed_) return;
   AllocInfo info = get_alloc_info(filename());
   info.free = true;
+  info.pooled = pooled_size_ > 0;
   ClientSocket &socket = get_manager_socket(manager_handle_);
   THRefcountedMapAllocator::close();
   socket.register_deallocation(info);
 }
 
+namespace {
+
+constexpr size_t kMinPooledSegmentSize = 4096;
+constexpr size_t kDefaultMaxPooledBytes = 256 * 1024 * 1024;
+
+// Segments of this process which are not used by any of its storages. They
+// are grouped by size class, and still hold the reference of this process.
+struct SegmentPool {
+  std::mutex mutex;
+  std::unordered_map<size_t, std::vector<THManagedMapAllocator*>> free_segments;
+  size_t pooled_bytes = 0;
+};
+
+SegmentPool* segment_pool = nullptr;
+std::once_flag segment_pool_flag;
+
+// The pooled segments of the parent belong to the parent, a forked child
+// starts with an empty pool. The pools are never destroyed, because storages
+// can still be freed during static destruction, and the manager drops the
+// references of the pool once the process is gone.
+void reset_segment_pool() {
+  segment_pool = new SegmentPool();
+}
+
+SegmentPool& get_segment_pool() {
+  std::call_once(segment_pool_flag, [] {
+    reset_segment_pool();
+    pthread_atfork(nullptr, nullptr, &reset_segment_pool);
+  });
+  return *segment_pool;
+}
+
+size_t max_pooled_bytes() {
+  static const size_t max_bytes = [] {
+    const char* env = std::getenv("TORCH_SHM_POOL_MAX_BYTES");
+    return env ? static_cast<size_t>(std::strtoull(env, nullptr, 10))
+               : kDefaultMaxPooledBytes;
+  }();
+  return max_bytes;
+}
+
+// Rounds size up to a quarter of its highest power of two, which wastes less
+// than 25% of the segment while letting batches of slightly different sizes
+// share a size class.
+size_t pooled_segment_size(size_t size) {
+  if (size <= kMinPooledSegmentSize) {
+    return kMinPooledSegmentSize;
+  }
+  size_t step = 1;
+  while (step <= size / 2) {
+    step *= 2;
+  }
+  step /= 4;
+  return (size + step - 1) / step * step;
+}
+
+// A pooled segment can be reused once the pool holds the only reference left,
+// i.e. all the processes which received it have closed it.
+THManagedMapAllocator* take_pooled_segment(const char* manager_handle, size_t pooled_size) {
+  auto& pool = get_segment_pool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  auto it = pool.free_segments.find(pooled_size);
+  if (it == pool.free_segments.end()) {
+    return nullptr;
+  }
+  auto& segments = it->second;
+  for (auto segment = segments.begin(); segment != segments.end(); ++segment) {
+    auto* context = *segment;
+    if ((manager_handle && manager_handle[0] != '\0' &&
+         strcmp(manager_handle, context->manager_handle()) != 0) ||
+        context->refcount() != 1) {
+      continue;
+    }
+    segments.erase(segment);
+    pool.pooled_bytes -= pooled_size;
+    return context;
+  }
+  return nullptr;
+}
+
+bool return_pooled_segment(THManagedMapAllocator* context) {
+  auto& pool = get_segment_pool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  if (pool.pooled_bytes + context->pooled_size() > max_pooled_bytes()) {
+    return false;
+  }
+  pool.free_segments[context->pooled_size()].push_back(context);
+  pool.pooled_bytes += context->pooled_size();
+  return true;
+}
+
+} // namespace
+
 static void deleteTHManagedMapAllocator(void* ptr) {
-  delete static_cast<THManagedMapAllocator*>(ptr);
+  auto* context = static_cast<THManagedMapAllocator*>(ptr);
+  if (context->pooled_size() > 0 && context->pool_pid() == getpid() &&
+      return_pooled_segment(context)) {
+    return;
+  }
+  delete context;
 }
 
 at::DataPtr THManagedMapAllocator::makeDataPtr(const char* manager_handle, const char* filename, int flags, ptrdiff_t size) {
-  auto* context = new THManagedMapAllocator(manager_handle, filename, flags, size);
+  THManagedMapAllocator* context = nullptr;
+  size_t pooled_size = 0;
+  if ((flags & TH_ALLOCATOR_MAPPED_EXCLUSIVE) && max_pooled_bytes() > 0) {
+    pooled_size = pooled_segment_size(size);
+    context = take_pooled_segment(manager_handle, pooled_size);
+  }
+  if (!context) {
+    context = new THManagedMapAllocator(
+        manager_handle,
+        filename,
+        flags,
+        pooled_size > 0 ? pooled_size : size,
+        pooled_size);
+  }
   return {context->data(), context, &deleteTHManagedMapAllocator, at::DeviceType::CPU};
 }
 
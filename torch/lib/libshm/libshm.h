@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unistd.h>
+
 #include <TH/TH.h>
 
 #ifdef __cplusplus
@@ -9,16 +11,30 @@ void libshm_init(const char *manager_exec_path);
 // Superclass to run a constructor before THRefcountedMapAllocator
 class THManagedMapAllocatorInit {
 protected:
-  THManagedMapAllocatorInit(const char* manager_handle, const char* filename);
+  THManagedMapAllocatorInit(const char* manager_handle, const char* filename, size_t pooled_size);
   std::string manager_handle_;
+  // Size class of the segment if it belongs to the pool of its creator, 0
+  // otherwise. See makeDataPtr.
+  size_t pooled_size_;
+  pid_t pool_pid_;
 };
 
 // Like a THRefcountedMapAllocator, but it also makes use of an external
 // shared memory manager process to ensure that shared memory regions actually
 // get freed in the end (even if processes lose the memory).
+//
+// The segments created by makeDataPtr with TH_ALLOCATOR_MAPPED_EXCLUSIVE are
+// rounded up to a size class and recycled by the process that created them:
+// when its storage is freed, such a segment stays mapped in a per-process pool
+// which keeps the reference of the creator, and it is handed out again for the
+// next storage of the same size class once no other process holds it anymore.
+// This saves the creation, the registration with the manager and the unlinking
+// of a segment for every batch that is sent between processes. If the creator
+// dies, the manager drops the reference of its pool. The size of the pool is
+// capped by TORCH_SHM_POOL_MAX_BYTES (256MB by default, 0 disables it).
 class THManagedMapAllocator : private THManagedMapAllocatorInit, public THRefcountedMapAllocator {
 public:
-  THManagedMapAllocator(const char* manager_handle, const char* filename, int flags, ptrdiff_t size);
+  THManagedMapAllocator(const char* manager_handle, const char* filename, int flags, ptrdiff_t size, size_t pooled_size = 0);
 
   void close() override;
 
@@ -28,6 +44,8 @@ public:
   static THManagedMapAllocator* fromDataPtr(const at::DataPtr&);
 
   const char* manager_handle() const { return manager_handle_.c_str(); }
+  size_t pooled_size() const { return pooled_size_; }
+  pid_t pool_pid() const { return pool_pid_; }
 };
 
 #endif
@@ -3,6 +3,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <atomic>
 #include <vector>
 #include <set>
 #include <algorithm>
@@ -30,6 +31,8 @@ struct ClientSession {
 
   ManagerSocket socket;
   pid_t pid;
+  // Segments which the client keeps in its pool, see THManagedMapAllocator.
+  std::set<std::string> pooled_objects;
 };
 
 
@@ -81,6 +84,31 @@ void free_used_object(const std::string &name) {
   }
 }
 
+// Drops the reference that the pool of a dead client held on one of its
+// segments, and unlinks the segment if no other process holds it anymore.
+void release_pooled_object(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    free_used_object(name);
+    return;
+  }
+  // The refcount is the first field of the header of the segment, see
+  // THMapInfo in THAllocator.cpp
+  void *ptr = mmap(nullptr, sizeof(std::atomic<int>), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    DEBUG("could not map pooled object %s", name.c_str());
+    return;
+  }
+  auto *refcount = static_cast<std::atomic<int>*>(ptr);
+  if (--*refcount == 0) {
+    DEBUG("freeing pooled object %s", name.c_str());
+    shm_unlink(name.c_str());
+    used_objects.erase(name);
+  }
+  munmap(ptr, sizeof(std::atomic<int>));
+}
+
 int main(int argc, char *argv[]) {
   setsid();  // Daemonize the process
 
@@ -120,8 +148,11 @@ int main(int argc, char *argv[]) {
         // some process died
         DEBUG("detaching process");
         auto &session = client_sessions.at(pfd.fd);
-        (void) session;
         DEBUG("%d has died", session.pid);
+        for (auto &obj_name: session.pooled_objects) {
+          release_pooled_object(obj_name);
+        }
+        session.pooled_objects.clear();
         to_remove.push_back(pfd.fd);
       } else if (pfd.revents & POLLIN) {
         if (pfd.fd == srv_socket->socket_fd) {
@@ -139,9 +170,15 @@ int main(int argc, char *argv[]) {
           session.pid = info.pid;
           DEBUG("got alloc info: %d %d %s", (int)info.free, info.pid, info.filename);
           if (info.free) {
+            if (info.pooled) {
+              session.pooled_objects.erase(info.filename);
+            }
             free_used_object(info.filename);
           } else {
             used_objects.insert(info.filename);
+            if (info.pooled) {
+              session.pooled_objects.insert(info.filename);
+            }
             DEBUG("registered object %s", info.filename);
             session.socket.confirm();
           }
@@ -43,6 +43,7 @@ def _dump_DDP_relevant_env_vars():
         "GLOO_DEVICE_TRANSPORT",
         "NCCL_SOCKET_IFNAME",
         "NCCL_BLOCKING_WAIT",
+        "NCCL_ASYNC_ERROR_HANDLING",
         "NCCL_DEBUG",
         "NCCL_DEBUG_SUBSYS",
         "NCCL_IB_DISABLE",
@@ -306,6 +307,15 @@ class DistributedDataParallel(Module):
                          are getting different gradients, which should not
                          happen if DistributedDataParallel is correctly used.
                          (default: ``False``)
+        gradient_as_bucket_view (bool): when set to ``True``, the gradients of
+                      the parameters are views into the flat bucket tensors
+                      that are allreduced: the autograd engine accumulates
+                      gradients straight into the buckets, which saves the
+                      copies of the gradients in and out of the buckets and
+                      the memory of the gradients. ``.grad`` must then not
+                      be detached in place, and is always defined after the
+                      backward pass, even for the parameters that are unused.
+                      (default: ``False``)
 
     Attributes:
         module (Module): the module to be parallelized
@@ -320,7 +330,8 @@ class DistributedDataParallel(Module):
                  process_group=None,
                  bucket_cap_mb=25,
                  find_unused_parameters=False,
-                 check_reduction=False):
+                 check_reduction=False,
+                 gradient_as_bucket_view=False):
 
         super(DistributedDataParallel, self).__init__()
 
@@ -367,6 +378,7 @@ class DistributedDataParallel(Module):
         self.module = module
         self.broadcast_buffers = broadcast_buffers
         self.find_unused_parameters = find_unused_parameters
+        self.gradient_as_bucket_view = gradient_as_bucket_view
         self.require_backward_grad_sync = True
         self.require_forward_param_sync = True
 
@@ -501,7 +513,8 @@ class DistributedDataParallel(Module):
             self.process_group,
             expect_sparse_gradient,
             self.bucket_bytes_cap,
-            self.find_unused_parameters)
+            self.find_unused_parameters,
+            self.gradient_as_bucket_view)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -519,6 +532,7 @@ class DistributedDataParallel(Module):
         super(DistributedDataParallel, self).__setstate__(state)
         self.__dict__.setdefault('require_forward_param_sync', True)
         self.__dict__.setdefault('require_backward_grad_sync', True)
+        self.__dict__.setdefault('gradient_as_bucket_view', False)
         self._ddp_init_helper()
 
     def _check_default_group(self):
@@ -657,6 +671,76 @@ class DistributedDataParallel(Module):
         self._check_comm_hook(hook)
         dist._register_comm_hook(self.reducer, state, hook)
 
+    def _register_builtin_comm_hook(self, comm_hook_type, matrix_approximation_rank=1,
+                                    compress_ratio=0.01):
+        r"""
+        Register one of the gradient compression hooks implemented in C++.
+        Unlike the hooks registered by :meth:`_register_comm_hook`, they run
+        without taking the GIL.
+
+        Arguments:
+            comm_hook_type (dist.BuiltinCommHookType): the hook to register:
+
+                * ``FP16_COMPRESS`` / ``BF16_COMPRESS``: the buckets are cast
+                  to half / bfloat16 for the allreduce, and back.
+                * ``POWER_SGD``: the buckets are approximated by matrices of
+                  rank ``matrix_approximation_rank`` (PowerSGD), the error
+                  is added to the next gradients.
+                * ``TOP_K``: only the ``compress_ratio`` fraction of the
+                  entries of largest magnitude of the buckets are
+                  allgathered, the rest is added to the next gradients.
+
+            matrix_approximation_rank (int): rank of the approximation of
+                ``POWER_SGD``.
+            compress_ratio (float): fraction of the entries sent by ``TOP_K``.
+
+        ``POWER_SGD`` and ``TOP_K`` only compress the buckets of modules
+        replicated on a single device per process, the other buckets are
+        allreduced as they are, like sparse gradients.
+
+        .. warning ::
+            DDP communication hook can only be registered once and should be registered
+            before calling backward.
+
+        .. warning ::
+            DDP communication hook is experimental and subject to change.
+
+        Example::
+            >>> ddp._register_builtin_comm_hook(dist.BuiltinCommHookType.POWER_SGD,
+            >>>                                 matrix_approximation_rank=4)
+        """
+        dist._register_builtin_comm_hook(
+            self.reducer, self.process_group, comm_hook_type,
+            matrix_approximation_rank, compress_ratio)
+
+    def _register_bucket_finalized_hook(self, hook):
+        r"""
+        Register a hook called at the end of the backward pass for every
+        gradient bucket, in bucket order, as soon as its reduction completed.
+        It runs before waiting for the reductions of the next buckets, so an
+        optimizer can update the parameters of a bucket while the reductions
+        of the next ones are still in flight, instead of waiting for all of
+        them to run :meth:`~torch.optim.Optimizer.step` at once.
+
+        Arguments:
+            hook (callable): called as ``hook(bucket_index, params, grads)``
+                with the parameters of the bucket and their reduced
+                gradients. It runs on the thread of the autograd engine, so
+                it must update the parameters under :func:`torch.no_grad`.
+
+        .. warning ::
+            The hook can only be registered once.
+
+        Example::
+            >>> def sgd_step(bucket_index, params, grads):
+            >>>     with torch.no_grad():
+            >>>         for p, g in zip(params, grads):
+            >>>             if g is not None:
+            >>>                 p.add_(g, alpha=-lr)
+            >>> ddp._register_bucket_finalized_hook(sgd_step)
+        """
+        self.reducer._register_bucket_finalized_hook(hook)
+
     def _distributed_broadcast_coalesced(self, tensors, buffer_size):
         dist._broadcast_coalesced(self.process_group, tensors, buffer_size)
 
@@ -685,7 +769,10 @@ class DistributedDataParallel(Module):
                         # to zero the grads on all model replicas as well.
                         # This snippet is copied from torch.optim.Optimizer.
                         if param.grad is not None:
-                            param.grad.detach_()
+                            if param.grad.grad_fn is not None:
+                                param.grad.detach_()
+                            else:
+                                param.grad.requires_grad_(False)
                             param.grad.zero_()
 
             # module buffer sync
@@ -1,9 +1,13 @@
 
 from .linear import Linear
+from .conv import Conv1d, Conv2d, Conv3d
 from .rnn import LSTM, LSTMCell, RNNCell, GRUCell
 
 __all__ = [
     'Linear',
+    'Conv1d',
+    'Conv2d',
+    'Conv3d',
     'LSTM',
     'LSTMCell',
     'RNNCell',
@@ -0,0 +1,150 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+import torch
+import torch.nn as nn
+import torch.nn.quantized as nnq
+from torch.nn.quantized.modules.utils import _quantize_weight
+
+def _from_float(cls, mod):
+    assert type(mod) == cls._FLOAT_MODULE, \
+        'nn.quantized.dynamic.' + cls.__name__ + '.from_float only works for ' + \
+        cls._FLOAT_MODULE.__name__
+    assert hasattr(mod, 'qconfig'), 'Input float module must have qconfig defined'
+    if mod.qconfig is not None and mod.qconfig.weight is not None:
+        weight_observer = mod.qconfig.weight()
+    else:
+        # Postponed to avoid the circular import of the qconfig, see
+        # nn.quantized.dynamic.Linear
+        from torch.quantization.qconfig import default_dynamic_qconfig
+        weight_observer = default_dynamic_qconfig.weight()
+    assert weight_observer.dtype == torch.qint8, \
+        'The only supported dtype for dynamic quantized convolutions is qint8'
+    weight_observer(mod.weight)
+    qweight = _quantize_weight(mod.weight.float(), weight_observer)
+    qconv = cls(mod.in_channels, mod.out_channels, mod.kernel_size,
+                mod.stride, mod.padding, mod.dilation, mod.groups,
+                mod.bias is not None, mod.padding_mode)
+    qconv.set_weight_bias(qweight, mod.bias)
+    return qconv
+
+
+class Conv1d(nnq.Conv1d):
+    r"""
+    A dynamic quantized Conv1d module with floating point tensors as inputs and
+    outputs. The activation is quantized with qparams computed from its range
+    on every call, so the module needs no calibration. We adopt the same
+    interface as :class:`~torch.nn.Conv1d`.
+
+    The :attr:`scale` and :attr:`zero_point` attributes of
+    :class:`~torch.nn.quantized.Conv1d` are unused.
+
+    Examples::
+
+        >>> m = nn.quantized.dynamic.Conv1d(16, 33, 3, stride=2)
+        >>> input = torch.randn(20, 16, 100)
+        >>> output = m(input)
+    """
+
+    _FLOAT_MODULE = nn.Conv1d
+
+    def _get_name(self):
+        return 'DynamicQuantizedConv1d'
+
+    def forward(self, input):
+        # Temporarily using len(shape) instead of ndim due to JIT issue
+        # https://github.com/pytorch/pytorch/issues/23890
+        if len(input.shape) != 3:
+            raise ValueError("Input shape must be `(N, C, L)`!")
+        return torch.ops.quantized.conv1d_dynamic(
+            input, self._packed_params, reduce_range=True)
+
+    @classmethod
+    def from_float(cls, mod):
+        r"""Create a dynamic quantized module from a float module
+
+        Args:
+            mod (Module): a float module, either produced by torch.quantization
+                          utilities or provided by the user
+        """
+        return _from_float(cls, mod)
+
+
+class Conv2d(nnq.Conv2d):
+    r"""
+    A dynamic quantized Conv2d module with floating point tensors as inputs and
+    outputs. The activation is quantized with qparams computed from its range
+    on every call, so the module needs no calibration. We adopt the same
+    interface as :class:`~torch.nn.Conv2d`.
+
+    The :attr:`scale` and :attr:`zero_point` attributes of
+    :class:`~torch.nn.quantized.Conv2d` are unused.
+
+    Examples::
+
+        >>> m = nn.quantized.dynamic.Conv2d(16, 33, (3, 5), stride=(2, 1), padding=(4, 2))
+        >>> input = torch.randn(20, 16, 50, 100)
+        >>> output = m(input)
+    """
+
+    _FLOAT_MODULE = nn.Conv2d
+
+    def _get_name(self):
+        return 'DynamicQuantizedConv2d'
+
+    def forward(self, input):
+        # Temporarily using len(shape) instead of ndim due to JIT issue
+        # https://github.com/pytorch/pytorch/issues/23890
+        if len(input.shape) != 4:
+            raise ValueError("Input shape must be `(N, C, H, W)`!")
+        return torch.ops.quantized.conv2d_dynamic(
+            input, self._packed_params, reduce_range=True)
+
+    @classmethod
+    def from_float(cls, mod):
+        r"""Create a dynamic quantized module from a float module
+
+        Args:
+            mod (Module): a float module, either produced by torch.quantization
+                          utilities or provided by the user
+        """
+        return _from_float(cls, mod)
+
+
+class Conv3d(nnq.Conv3d):
+    r"""
+    A dynamic quantized Conv3d module with floating point tensors as inputs and
+    outputs. The activation is quantized with qparams computed from its range
+    on every call, so the module needs no calibration. We adopt the same
+    interface as :class:`~torch.nn.Conv3d`.
+
+    The :attr:`scale` and :attr:`zero_point` attributes of
+    :class:`~torch.nn.quantized.Conv3d` are unused.
+
+    Examples::
+
+        >>> m = nn.quantized.dynamic.Conv3d(16, 33, 3, stride=2)
+        >>> input = torch.randn(20, 16, 10, 50, 100)
+        >>> output = m(input)
+    """
+
+    _FLOAT_MODULE = nn.Conv3d
+
+    def _get_name(self):
+        return 'DynamicQuantizedConv3d'
+
+    def forward(self, input):
+        # Temporarily using len(shape) instead of ndim due to JIT issue
+        # https://github.com/pytorch/pytorch/issues/23890
+        if len(input.shape) != 5:
+            raise ValueError("Input shape must be `(N, C, D, H, W)`!")
+        return torch.ops.quantized.conv3d_dynamic(
+            input, self._packed_params, reduce_range=True)
+
+    @classmethod
+    def from_float(cls, mod):
+        r"""Create a dynamic quantized module from a float module
+
+        Args:
+            mod (Module): a float module, either produced by torch.quantization
+                          utilities or provided by the user
+        """
+        return _from_float(cls, mod)
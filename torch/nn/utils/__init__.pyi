@@ -1,5 +1,5 @@
 from .clip_grad import clip_grad_norm_ as clip_grad_norm_, clip_grad_value_ as clip_grad_value_
 from .convert_parameters import parameters_to_vector as parameters_to_vector, \
-    vector_to_parameters as vector_to_parameters
+    vector_to_parameters as vector_to_parameters, grads_to_flat_buffer as grads_to_flat_buffer
 from .spectral_norm import remove_spectral_norm as remove_spectral_norm, spectral_norm as spectral_norm
 from .weight_norm import remove_weight_norm as remove_weight_norm, weight_norm as weight_norm
@@ -53,6 +53,68 @@ def vector_to_parameters(vec, parameters):
         pointer += num_param
 
 
+def grads_to_flat_buffer(parameters, buffer=None):
+    r"""Make the gradients of the parameters views of one flat buffer
+
+    Each ``.grad`` becomes a view of a slice of ``buffer``, with the same
+    strides as its parameter when the parameter is dense. Since the autograd
+    engine accumulates into existing gradients in place, the backward passes
+    then write the gradients straight into ``buffer``, without allocating
+    them, and ``buffer`` can be reduced, clipped or updated by an optimizer
+    with a single operation. The current values of the gradients are kept,
+    missing gradients are zeroed.
+
+    ``.grad`` stops being a view of ``buffer`` if it is replaced, e.g. by
+    setting it to ``None`` or by a backward pass with ``create_graph=True``.
+
+    Arguments:
+        parameters (Iterable[Tensor]): an iterator of Tensors that are the
+            parameters of a model, all with the same dtype and device.
+        buffer (Tensor, optional): a contiguous 1-D tensor with as many
+            elements as all the parameters together. If ``None``, a new one
+            is allocated.
+
+    Returns:
+        The flat buffer holding the gradients
+
+    Example::
+
+        >>> params = list(model.parameters())
+        >>> flat_grad = torch.nn.utils.grads_to_flat_buffer(params)
+        >>> model(input).sum().backward()
+        >>> flat_grad.norm()  # the norm of all the gradients
+    """
+    parameters = list(parameters)
+    if len(parameters) == 0:
+        raise ValueError('expected at least one parameter')
+    param_device = None
+    for param in parameters:
+        param_device = _check_param_device(param, param_device)
+        if param.dtype != parameters[0].dtype:
+            raise TypeError('Found two parameters with different dtypes, '
+                            'this is currently not supported.')
+    numel = sum(param.numel() for param in parameters)
+    if buffer is None:
+        buffer = torch.empty(numel, dtype=parameters[0].dtype, device=parameters[0].device)
+    elif (buffer.dim() != 1 or buffer.numel() != numel or not buffer.is_contiguous() or
+          buffer.dtype != parameters[0].dtype or buffer.device != parameters[0].device):
+        raise ValueError('expected a contiguous 1-D buffer of {} elements with dtype {} on {}, '
+                         'but got {}'.format(numel, parameters[0].dtype, parameters[0].device,
+                                             buffer.type()))
+
+    with torch.no_grad():
+        pointer = 0
+        for param in parameters:
+            view = torch.autograd._grad_view_obey_contract(buffer, pointer, param)
+            if param.grad is None:
+                view.zero_()
+            elif not param.grad.is_set_to(view):
+                view.copy_(param.grad)
+            param.grad = view
+            pointer += param.numel()
+    return buffer
+
+
 def _check_param_device(param, old_param_device):
     r"""This helper function is to check if the parameters are located
     in the same device. Currently, the conversion between model parameters
@@ -1,4 +1,4 @@
-from typing import Iterable
+from typing import Iterable, Optional
 from ... import Tensor
 
 
@@ -6,3 +6,6 @@ def parameters_to_vector(parameters: Iterable[Tensor]) -> Tensor: ...
 
 
 def vector_to_parameters(vec: Tensor, parameters: Iterable[Tensor]) -> None: ...
+
+
+def grads_to_flat_buffer(parameters: Iterable[Tensor], buffer: Optional[Tensor] = ...) -> Tensor: ...
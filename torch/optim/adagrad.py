@@ -1,5 +1,5 @@
 import torch
-from .optimizer import Optimizer
+from .optimizer import Optimizer, _fused_sparse_step_supported
 
 
 class Adagrad(Optimizer):
@@ -79,7 +79,9 @@ class Adagrad(Optimizer):
 
                 clr = group['lr'] / (1 + (state['step'] - 1) * group['lr_decay'])
 
-                if grad.is_sparse:
+                if _fused_sparse_step_supported(p, grad, state['sum']):
+                    torch._sparse_adagrad_(p, state['sum'], grad, clr, group['eps'])
+                elif grad.is_sparse:
                     grad = grad.coalesce()  # the update is non-linear so indices must be unique
                     grad_indices = grad._indices()
                     grad_values = grad._values()
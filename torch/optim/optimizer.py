@@ -14,6 +14,16 @@ class _RequiredParameter(object):
 required = _RequiredParameter()
 
 
+def _fused_sparse_step_supported(p, grad, *states):
+    r"""Whether the fused sparse steps (``torch._sparse_adagrad_`` and
+    friends) can update ``p`` in place: ``grad`` must be the gradient of an
+    embedding table, i.e. sparse in its rows and dense in its columns."""
+    return (grad.is_sparse and grad.device.type == 'cpu' and
+            grad.sparse_dim() == 1 and grad.dense_dim() == 1 and
+            p.dtype in (torch.float, torch.double) and p.dim() == 2 and p.is_contiguous() and
+            all(s.is_contiguous() and s.dtype == p.dtype for s in states))
+
+
 class Optimizer(object):
     r"""Base class for all optimizers.
 
@@ -168,7 +178,10 @@ class Optimizer(object):
         for group in self.param_groups:
             for p in group['params']:
                 if p.grad is not None:
-                    p.grad.detach_()
+                    if p.grad.grad_fn is not None:
+                        p.grad.detach_()
+                    else:
+                        p.grad.requires_grad_(False)
                     p.grad.zero_()
 
     def step(self, closure):
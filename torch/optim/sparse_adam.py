@@ -1,6 +1,6 @@
 import math
 import torch
-from .optimizer import Optimizer
+from .optimizer import Optimizer, _fused_sparse_step_supported
 
 
 class SparseAdam(Optimizer):
@@ -67,6 +67,14 @@ class SparseAdam(Optimizer):
 
                 state['step'] += 1
 
+                exp_avg, exp_avg_sq = state['exp_avg'], state['exp_avg_sq']
+                beta1, beta2 = group['betas']
+
+                if _fused_sparse_step_supported(p, grad, exp_avg, exp_avg_sq):
+                    torch._sparse_adam_(p, exp_avg, exp_avg_sq, grad, group['lr'],
+                                        beta1, beta2, group['eps'], state['step'])
+                    continue
+
                 grad = grad.coalesce()  # the update is non-linear so indices must be unique
                 grad_indices = grad._indices()
                 grad_values = grad._values()
@@ -78,9 +86,6 @@ class SparseAdam(Optimizer):
                         return constructor().resize_as_(grad)
                     return constructor(grad_indices, values, size)
 
-                exp_avg, exp_avg_sq = state['exp_avg'], state['exp_avg_sq']
-                beta1, beta2 = group['betas']
-
                 # Decay the first and second moment running average coefficient
                 #      old <- b * old + (1 - b) * new
                 # <==> old += (1 - b) * (new - old)
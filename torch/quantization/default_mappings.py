@@ -61,6 +61,9 @@ DEFAULT_QAT_MODULE_MAPPING = {
 # Map for swapping dynamic modules
 DEFAULT_DYNAMIC_MODULE_MAPPING = {
     nn.Linear: nnqd.Linear,
+    nn.Conv1d: nnqd.Conv1d,
+    nn.Conv2d: nnqd.Conv2d,
+    nn.Conv3d: nnqd.Conv3d,
     nn.LSTM: nnqd.LSTM,
     nn.LSTMCell: nnqd.LSTMCell,
     nn.RNNCell: nnqd.RNNCell,
@@ -97,13 +97,24 @@ class FakeQuantize(Module):
             self.zero_point.copy_(_zero_point)
 
         if self.fake_quant_enabled[0] == 1:
+            # In training, the cachemask ops save a 1 byte mask for the
+            # backward pass, which then needs neither X nor the qparams. The
+            # plain ops are kept for eval, which export (e.g. ONNX) relies on.
             if self.qscheme == torch.per_channel_symmetric or self.qscheme == torch.per_channel_affine:
-                X = torch.fake_quantize_per_channel_affine(X, self.scale, self.zero_point,
-                                                           self.ch_axis, self.quant_min, self.quant_max)
+                if self.training:
+                    X = torch.fake_quantize_per_channel_affine_cachemask(
+                        X, self.scale, self.zero_point, self.ch_axis, self.quant_min, self.quant_max)[0]
+                else:
+                    X = torch.fake_quantize_per_channel_affine(X, self.scale, self.zero_point,
+                                                               self.ch_axis, self.quant_min, self.quant_max)
             else:
-                X = torch.fake_quantize_per_tensor_affine(X, float(self.scale),
-                                                          int(self.zero_point), self.quant_min,
-                                                          self.quant_max)
+                if self.training:
+                    X = torch.fake_quantize_per_tensor_affine_cachemask(
+                        X, float(self.scale), int(self.zero_point), self.quant_min, self.quant_max)[0]
+                else:
+                    X = torch.fake_quantize_per_tensor_affine(X, float(self.scale),
+                                                              int(self.zero_point), self.quant_min,
+                                                              self.quant_max)
         return X
 
     with_args = classmethod(_with_args)
@@ -1,4 +1,6 @@
+import collections
 import difflib
+import json
 import os
 import io
 import shutil
@@ -238,8 +240,12 @@ def _open_file_like(name_or_buffer, mode):
 
 
 class _open_zipfile_reader(_opener):
-    def __init__(self, name_or_buffer) -> None:
-        super(_open_zipfile_reader, self).__init__(torch._C.PyTorchFileReader(name_or_buffer))
+    def __init__(self, name_or_buffer, mmap=False) -> None:
+        if mmap:
+            reader = torch._C.PyTorchFileReader(str(name_or_buffer), True)
+        else:
+            reader = torch._C.PyTorchFileReader(name_or_buffer)
+        super(_open_zipfile_reader, self).__init__(reader)
 
 
 class _open_zipfile_writer_file(_opener):
@@ -269,6 +275,104 @@ def _open_zipfile_writer(name_or_buffer):
     return container(name_or_buffer)
 
 
+# Name of the file of a sharded checkpoint directory mapping each record to its
+# shard, see _open_sharded_zipfile_writer
+_SHARD_MANIFEST = 'manifest.json'
+_SHARD_MANIFEST_VERSION = 1
+
+
+class _open_sharded_zipfile_writer(_opener):
+    """Writes the records to the zip archives ``shard_<N>.pt`` of the directory
+    ``name``, and starts a new archive when the current one would get larger
+    than ``max_shard_size`` bytes. A record is never split across shards.
+
+    The manifest is written last, so that a save that didn't complete can't be
+    loaded.
+    """
+    def __init__(self, name, max_shard_size) -> None:
+        if max_shard_size <= 0:
+            raise ValueError("max_shard_size must be positive, got {}".format(max_shard_size))
+        self.directory = str(name)
+        self.max_shard_size = max_shard_size
+        self.shards: list = []
+        self.records: Dict[str, int] = {}
+        self.shard_size = 0
+        self.compress = False
+        os.makedirs(self.directory, exist_ok=True)
+        manifest = os.path.join(self.directory, _SHARD_MANIFEST)
+        if os.path.exists(manifest):
+            os.remove(manifest)
+        self._start_shard()
+        super(_open_sharded_zipfile_writer, self).__init__(self)
+
+    def _start_shard(self) -> None:
+        shard = 'shard_{:05d}.pt'.format(len(self.shards))
+        self.writer = torch._C.PyTorchFileWriter(os.path.join(self.directory, shard))
+        self.writer.set_compress_records(self.compress)
+        self.shards.append(shard)
+        self.shard_size = 0
+
+    def set_compress_records(self, compress) -> None:
+        self.compress = compress
+        self.writer.set_compress_records(compress)
+
+    def write_record(self, name, data, size) -> None:
+        if self.shard_size > 0 and self.shard_size + size > self.max_shard_size:
+            self.writer.write_end_of_file()
+            self._start_shard()
+        self.writer.write_record(name, data, size)
+        self.records[name] = len(self.shards) - 1
+        self.shard_size += size
+
+    def __exit__(self, exc_type, *args) -> None:
+        self.writer.write_end_of_file()
+        if exc_type is not None:
+            return
+        manifest = dict(version=_SHARD_MANIFEST_VERSION, shards=self.shards, records=self.records)
+        with open(os.path.join(self.directory, _SHARD_MANIFEST), 'w') as f:
+            json.dump(manifest, f)
+
+
+class _open_sharded_zipfile_reader(_opener):
+    """Reads the records of a directory written by _open_sharded_zipfile_writer.
+    The shards are opened, or mapped in memory, when one of their records is
+    first read.
+    """
+    def __init__(self, name, mmap=False) -> None:
+        self.directory = str(name)
+        self.mmap = mmap
+        with open(os.path.join(self.directory, _SHARD_MANIFEST)) as f:
+            manifest = json.load(f)
+        if manifest.get('version') != _SHARD_MANIFEST_VERSION:
+            raise RuntimeError("unsupported version {} of the manifest of sharded checkpoint {}"
+                               .format(manifest.get('version'), self.directory))
+        self.shards = manifest['shards']
+        self.records = manifest['records']
+        self.readers: list = [None] * len(self.shards)
+        super(_open_sharded_zipfile_reader, self).__init__(self)
+
+    def _reader(self, name):
+        if name not in self.records:
+            raise RuntimeError("record {} not found in sharded checkpoint {}".format(name, self.directory))
+        index = self.records[name]
+        if self.readers[index] is None:
+            path = os.path.join(self.directory, self.shards[index])
+            self.readers[index] = _open_zipfile_reader(path, self.mmap).file_like
+        return self.readers[index]
+
+    def get_record(self, name):
+        return self._reader(name).get_record(name)
+
+    def get_storage_from_record(self, name, size, dtype):
+        return self._reader(name).get_storage_from_record(name, size, dtype)
+
+    def get_all_records(self):
+        return list(self.records.keys())
+
+    def __exit__(self, *args) -> None:
+        self.readers = [None] * len(self.shards)
+
+
 def _is_compressed_file(f) -> bool:
     compress_modules = ['gzip']
     try:
@@ -331,7 +435,8 @@ def _check_dill_version(pickle_module) -> None:
             ))
 
 def save(obj, f: Union[str, os.PathLike, BinaryIO],
-         pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, _use_new_zipfile_serialization=True) -> None:
+         pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, _use_new_zipfile_serialization=True,
+         *, max_shard_size: Optional[int] = None, compress: bool = False) -> None:
     """Saves an object to a disk file.
 
     See also: :ref:`recommend-saving-models`
@@ -342,6 +447,19 @@ def save(obj, f: Union[str, os.PathLike, BinaryIO],
            os.PathLike object containing a file name
         pickle_module: module used for pickling metadata and objects
         pickle_protocol: can be specified to override the default protocol
+        max_shard_size: if set, :attr:`f` has to be the name of a directory.
+           The storages are written to several zip files of the directory, of
+           about :attr:`max_shard_size` bytes each, along with a manifest.
+           :func:`torch.load` on the directory reads them back.
+        compress: if ``True``, the records of the zip file are deflated. Large
+           records are compressed in chunks on all the cores, and decompressed
+           likewise by :func:`torch.load`. Compressed records can't be mapped
+           in memory with ``torch.load(mmap=True)``; they are read into memory.
+
+    .. note::
+        CUDA storages are copied to pinned host memory ahead of time, while the
+        previous ones are written. At most ``torch.serialization._CUDA_STAGING_BYTES``
+        are staged at once, on top of the storage being written.
 
     .. note::
         A common PyTorch convention is to save tensors using .pt file extension.
@@ -366,9 +484,31 @@ def save(obj, f: Union[str, os.PathLike, BinaryIO],
     """
     _check_dill_version(pickle_module)
 
+    if max_shard_size is not None:
+        if not _is_path(f):
+            raise ValueError("max_shard_size requires a directory name, got {}".format(type(f)))
+        if not _use_new_zipfile_serialization:
+            raise ValueError("max_shard_size is only supported with the zip file format")
+        with _open_sharded_zipfile_writer(f, max_shard_size) as opened_zipfile:
+            opened_zipfile.set_compress_records(compress)
+            _save(obj, opened_zipfile, pickle_module, pickle_protocol)
+        return
+
+    if compress and not _use_new_zipfile_serialization:
+        raise ValueError("compress is only supported with the zip file format")
+
+    if _use_new_zipfile_serialization and _is_path(f):
+        # Written by the C++ writer directly instead of through a Python file
+        # object, which would take a copy of each record
+        with _open_zipfile_writer(f) as opened_zipfile:
+            opened_zipfile.set_compress_records(compress)
+            _save(obj, opened_zipfile, pickle_module, pickle_protocol)
+            return
+
     with _open_file_like(f, 'wb') as opened_file:
         if _use_new_zipfile_serialization:
             with _open_zipfile_writer(opened_file) as opened_zipfile:
+                opened_zipfile.set_compress_records(compress)
                 _save(obj, opened_zipfile, pickle_module, pickle_protocol)
                 return
         _legacy_save(obj, opened_file, pickle_module, pickle_protocol)
@@ -478,22 +618,69 @@ def _save(obj, zip_file, pickle_module, pickle_protocol):
     zip_file.write_record('data.pkl', data_value, len(data_value))
 
     # Write each tensor to a file named tensor/the_tensor_key in the zip archive
-    for key in sorted(serialized_storages.keys()):
+    for key, storage in _staged_storages(serialized_storages, sorted(serialized_storages.keys())):
         name = 'data/{}'.format(key)
-        storage = serialized_storages[key]
-        if storage.device.type == 'cpu':
-            # If it's on the CPU we can directly copy it into the zip file
-            num_bytes = storage.size() * storage.element_size()
-            zip_file.write_record(name, storage.data_ptr(), num_bytes)
-        else:
-            # Copy to a buffer, then serialize that
-            buf = io.BytesIO()
-            storage._write_file(buf, _should_read_directly(buf))
-            buf_value = buf.getvalue()
-            zip_file.write_record(name, buf_value, len(buf_value))
+        num_bytes = storage.size() * storage.element_size()
+        zip_file.write_record(name, storage.data_ptr(), num_bytes)
+
+
+# Bytes of pinned host memory that torch.save may use to copy the next CUDA
+# storages while it writes the current one
+_CUDA_STAGING_BYTES = 256 * 1024 * 1024
 
 
-def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
+def _staged_storages(storages, keys):
+    """Yields the key and a CPU copy of the storage for each of ``keys``.
+
+    The CUDA storages are copied to pinned memory on a side stream ahead of
+    time, as long as the staged copies fit in _CUDA_STAGING_BYTES, so that the
+    copies overlap with the writes. The storages are staged one at a time if
+    they don't fit.
+    """
+    streams: Dict[torch.device, Any] = {}
+
+    def staged_bytes(storage):
+        if storage.device.type != 'cuda':
+            return 0
+        return storage.size() * storage.element_size()
+
+    def stage(key):
+        storage = storages[key]
+        if storage.device.type == 'cpu':
+            return key, storage, None
+        if storage.device.type != 'cuda':
+            return key, storage.cpu(), None
+        device = storage.device
+        if device not in streams:
+            streams[device] = torch.cuda.Stream(device)
+        stream = streams[device]
+        # The storage may still be written by kernels of the current stream
+        stream.wait_stream(torch.cuda.current_stream(device))
+        source = torch.tensor([], dtype=storage.dtype, device=device).set_(storage)
+        with torch.cuda.stream(stream):
+            pinned = torch.empty(storage.size(), dtype=storage.dtype, pin_memory=True)
+            pinned.copy_(source, non_blocking=True)
+            event = torch.cuda.Event()
+            event.record(stream)
+        return key, pinned.storage(), event
+
+    remaining = collections.deque(keys)
+    staged: collections.deque = collections.deque()
+    in_flight = 0
+    while remaining or staged:
+        while remaining and (not staged or
+                             in_flight + staged_bytes(storages[remaining[0]]) <= _CUDA_STAGING_BYTES):
+            key = remaining.popleft()
+            in_flight += staged_bytes(storages[key])
+            staged.append(stage(key))
+        key, storage, event = staged.popleft()
+        if event is not None:
+            event.synchronize()
+        yield key, storage
+        in_flight -= staged_bytes(storages[key])
+
+
+def load(f, map_location=None, pickle_module=pickle, *, mmap=False, **pickle_load_args):
     """Loads an object saved with :func:`torch.save` from a file.
 
     :func:`torch.load` uses Python's unpickling facilities but treats storages,
@@ -527,11 +714,17 @@ def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
 
     Args:
         f: a file-like object (has to implement :meth:`read`, :meth`readline`, :meth`tell`, and :meth`seek`),
-            or a string or os.PathLike object containing a file name
+            or a string or os.PathLike object containing a file name, or the name of a directory
+            saved with the :attr:`max_shard_size` argument of :func:`torch.save`
         map_location: a function, :class:`torch.device`, string or a dict specifying how to remap storage
             locations
         pickle_module: module used for unpickling metadata and objects (has to
             match the :attr:`pickle_module` used to serialize file)
+        mmap: if ``True``, :attr:`f` has to be a file name, saved in the zip
+            file format. The file is mapped in memory and the CPU storages
+            point into the mapping instead of being copied. Writes to them are
+            not seen in the file. Each shard of a sharded checkpoint is mapped
+            on its own.
         pickle_load_args: (Python 3 only) optional keyword arguments passed over to
             :func:`pickle_module.load` and :func:`pickle_module.Unpickler`, e.g.,
             :attr:`errors=...`.
@@ -578,20 +771,32 @@ def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
     if 'encoding' not in pickle_load_args.keys():
         pickle_load_args['encoding'] = 'utf-8'
 
+    if mmap and not _is_path(f):
+        raise ValueError("mmap requires a file name, got {}".format(type(f)))
+
+    if _is_path(f) and os.path.isdir(f):
+        with _open_sharded_zipfile_reader(f, mmap) as opened_zipfile:
+            return _load(opened_zipfile, map_location, pickle_module, **pickle_load_args)
+
     with _open_file_like(f, 'rb') as opened_file:
         if _is_zipfile(opened_file):
             # The zipfile reader is going to advance the current file position.
             # If we want to actually tail call to torch.jit.load, we need to
             # reset back to the original position.
             orig_position = opened_file.tell()
-            with _open_zipfile_reader(opened_file) as opened_zipfile:
+            with _open_zipfile_reader(f if mmap else opened_file, mmap) as opened_zipfile:
                 if _is_torchscript_zip(opened_zipfile):
                     warnings.warn("'torch.load' received a zip file that looks like a TorchScript archive"
                                   " dispatching to 'torch.jit.load' (call 'torch.jit.load' directly to"
                                   " silence this warning)", UserWarning)
+                    if mmap:
+                        return torch.jit.load(str(f), mmap=True)
                     opened_file.seek(orig_position)
                     return torch.jit.load(opened_file)
                 return _load(opened_zipfile, map_location, pickle_module, **pickle_load_args)
+        if mmap:
+            raise RuntimeError("mmap is only supported for files saved in the zip file format, "
+                               "see the _use_new_zipfile_serialization argument of torch.save")
         return _legacy_load(opened_file, map_location, pickle_module, **pickle_load_args)
 
 
@@ -489,6 +489,38 @@ class Tensor(torch._C._TensorBase):
             array = array.astype('uint8')
         return torch.from_numpy(array)
 
+    # DLPack exchange protocol, to support `other_library.from_dlpack(tensor)`
+    def __dlpack__(self, stream=None):
+        r"""Returns a DLPack capsule of the tensor, for the ``from_dlpack`` of
+        another library.
+
+        Arguments:
+            stream (int, optional): for CUDA tensors, the raw value of the
+                stream on which the consumer will use the tensor: ``None`` or
+                1 for the legacy default stream, 2 for the per-thread default
+                stream, or a ``cudaStream_t``. That stream is made to wait for
+                the work queued so far on the current stream, without blocking
+                the host. -1 skips the wait.
+        """
+        if self.is_cuda and stream != -1:
+            if stream is None:
+                stream = 1
+            elif stream == 0:
+                raise ValueError("__dlpack__(): 0 is not a valid stream, use 1 for the legacy default stream")
+            with torch.cuda.device(self.device):
+                torch._C._cuda_externalStreamWait(stream)
+        from torch.utils.dlpack import to_dlpack
+        return to_dlpack(self)
+
+    def __dlpack_device__(self):
+        r"""Returns the DLPack device type and index of the tensor."""
+        from torch.utils.dlpack import _DL_CPU, _DL_GPU
+        if self.is_cuda:
+            return (_DL_GPU, self.device.index)
+        if self.device.type == 'cpu':
+            return (_DL_CPU, 0)
+        raise ValueError("__dlpack_device__(): unsupported device {}".format(self.device))
+
     def __contains__(self, element):
         r"""Check if `element` is present in tensor
 
@@ -1088,6 +1088,28 @@ class DistAutogradTest(RpcAgentTestFixture):
                 )
                 local_grads = ret if ret else local_grads
 
+    @dist_init
+    def test_backward_parallel_branches(self):
+        # The distributed engine can execute independent branches of the
+        # graph on different threads, the gradients must stay the same.
+        local_grads = None
+        t1 = torch.rand((3, 3), requires_grad=True)
+        t2 = torch.rand((3, 3), requires_grad=True)
+
+        for exec_mode in [ExecMode.LOCAL, ExecMode.RPC_SYNC, ExecMode.REMOTE]:
+            with dist_autograd.context() as context_id:
+                branches = []
+                for i in range(4):
+                    val = self._exec_func(exec_mode, torch.mul, t1, i + 1)
+                    val = self._exec_func(exec_mode, torch.matmul, val, t2)
+                    branches.append(self._exec_func(exec_mode, torch.tanh, val))
+                loss = torch.stack(branches).sum()
+
+                ret = self._verify_backwards(
+                    exec_mode, [loss], context_id, local_grads, t1, t2
+                )
+                local_grads = ret if ret else local_grads
+
     @dist_init
     def test_backward_different_tensor_dims(self):
         local_grads = None
@@ -2243,7 +2265,7 @@ class FaultyAgentDistAutogradTest(FaultyRpcAgentTestFixture):
         self.assertEqual(self.rpc_backend, rpc.backend_registry.BackendType.FAULTY_PROCESS_GROUP)
         self.assertEqual(self.rpc_backend_options.num_send_recv_threads, 8)
         self.assertEqual(self.rpc_backend_options.num_fail_sends, 3)
-        self.assertEqual(len(self.rpc_backend_options.messages_to_fail), 4)
+        self.assertEqual(len(self.rpc_backend_options.messages_to_fail), 5)
 
 class TensorPipeAgentDistAutogradTest(TensorPipeRpcAgentTestFixture,
                                       DistAutogradTest):
@@ -4,6 +4,7 @@ from typing import Dict, List, Tuple
 
 import torch
 import torch.distributed as dist
+import torch.distributed.autograd as dist_autograd
 import torch.distributed.rpc as rpc
 from torch import Tensor
 from torch.distributed.rpc import RRef
@@ -841,6 +842,30 @@ def load_script_module_with_pickled_rref(pickled_script_module):
     return m()
 
 
+@torch.jit.interface
+class PipelineStageInterface(torch.nn.Module):
+    def forward(self, x: Tensor) -> Tensor:
+        pass
+
+
+class PipelineStage(torch.jit.ScriptModule):
+    def __init__(self, scale: float):
+        super().__init__()
+        self.weight = torch.nn.Parameter(torch.full((2,), scale))
+
+    @torch.jit.script_method
+    def forward(self, x: Tensor) -> Tensor:
+        return x * self.weight
+
+
+def owner_create_rref_pipeline_stage(scale):
+    return rpc.RRef(PipelineStage(scale), PipelineStageInterface)
+
+
+def get_pipeline_stage_grad(context_id, rref):
+    return dist_autograd.get_gradients(context_id)[rref.local_value().weight]
+
+
 class JitRpcTest(
     RRefAPITest,
     RRefTypingTest,
@@ -863,6 +888,37 @@ class JitRpcTest(
         )
         self.assertEqual(local_rref.to_here(), local_ret)
 
+    @dist_init
+    def test_pipeline_executor(self):
+        owners = [
+            worker_name((self.rank + 1) % self.world_size),
+            worker_name((self.rank + 2) % self.world_size),
+        ]
+        stages = [
+            rpc.rpc_sync(owner, owner_create_rref_pipeline_stage, args=(scale,))
+            for owner, scale in zip(owners, [2.0, 3.0])
+        ]
+        executor = torch._C._distributed_rpc._PipelineExecutor(
+            stages, num_micro_batches=3
+        )
+        self.assertEqual(executor.num_micro_batches, 3)
+
+        x = torch.arange(8, dtype=torch.float).view(4, 2)
+        self.assertEqual(executor.forward_async(x).wait(), x * 6)
+
+        with dist_autograd.context() as context_id:
+            out = executor.forward_async(x.requires_grad_()).wait()
+            dist_autograd.backward(context_id, [out.sum()])
+            self.assertEqual(
+                dist_autograd.get_gradients(context_id)[x],
+                torch.full_like(x, 6),
+            )
+            for owner, stage, other_scale in zip(owners, stages, [3.0, 2.0]):
+                grad = rpc.rpc_sync(
+                    owner, get_pipeline_stage_grad, args=(context_id, stage)
+                )
+                self.assertEqual(grad, x.detach().sum(0) * other_scale)
+
     @dist_init
     def test_torchscript_function_exception(self):
         dst_worker_name = worker_name((self.rank + 1) % self.world_size)
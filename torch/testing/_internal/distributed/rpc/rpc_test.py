@@ -177,6 +177,10 @@ def add_rref_to_value(rref, value):
     return rref.to_here() + value
 
 
+def sum_rrefs(rrefs):
+    return sum(rref.to_here() for rref in rrefs)
+
+
 def run_nested_pickle(pickle_cls_instance, tensor):
     return pickle_cls_instance.t + tensor
 
@@ -2351,6 +2355,39 @@ class RpcTest(RpcAgentTestFixture):
         # barrier after check 3
         dist.barrier()
 
+    @dist_init(setup_rpc=False)
+    def test_rref_notification_batching(self):
+        # All the RRefs of the same owner in the arguments of a call share a
+        # single fork request and child accept, and the deletes of the
+        # UserRRefs are batched as well.
+        rpc.init_rpc(
+            name=worker_name(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=self.rpc_backend_options,
+        )
+        initialize_pg(self.init_method, self.rank, self.world_size)
+
+        owner_rank = (self.rank + 1) % self.world_size
+        callee = worker_name((self.rank + 2) % self.world_size)
+        rrefs = [
+            rpc.remote(worker_name(owner_rank), torch.add, args=(torch.ones(2), i))
+            for i in range(10)
+        ]
+        ret = rpc.rpc_sync(callee, sum_rrefs, args=(rrefs,))
+        self.assertEqual(ret, sum(torch.ones(2) + i for i in range(10)))
+
+        del rrefs
+        wait_until_pending_futures_and_users_flushed()
+        info = _rref_context_get_debug_info()
+        self.assertEqual(0, int(info["num_pending_user_deletes"]))
+        # Wait for all the workers to delete their UserRRefs
+        dist.barrier()
+        wait_until_owners_and_forks_on_rank(0, 0, rank=owner_rank)
+        dist.barrier()
+        rpc.shutdown()
+
     @dist_init
     def test_disable_gil_profiling(self):
         # test that rpc.enable_gil_profilig(false) will result in
@@ -2619,6 +2656,43 @@ class RpcTest(RpcAgentTestFixture):
                 rpc_timeout=timeout,
             )
 
+    @dist_init(setup_rpc=False)
+    @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
+    @_skip_if_tensorpipe_agent
+    def test_process_group_message_batching(self):
+        # A power of two, which float options hold exactly
+        batch_flush_interval = 2 ** -7
+        rpc_backend_options = rpc.ProcessGroupRpcBackendOptions(
+            init_method=self.rpc_backend_options.init_method,
+            num_send_recv_threads=self.rpc_backend_options.num_send_recv_threads,
+            max_batch_size=16,
+            batch_flush_interval=batch_flush_interval,
+        )
+        self.assertEqual(rpc_backend_options.max_batch_size, 16)
+        self.assertEqual(
+            rpc_backend_options.batch_flush_interval, batch_flush_interval)
+        rpc.init_rpc(
+            name=worker_name(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=rpc_backend_options,
+        )
+
+        # Many small requests in flight to the same destination end up in
+        # shared frames, and every one of them gets its own response.
+        dst = worker_name((self.rank + 1) % self.world_size)
+        futs = [
+            rpc.rpc_async(dst, torch.add, args=(torch.ones(2) * i, 1))
+            for i in range(100)
+        ]
+        for i, fut in enumerate(futs):
+            self.assertEqual(fut.wait(), torch.ones(2) * (i + 1))
+        rpc.shutdown()
+
+        with self.assertRaisesRegex(RuntimeError, "max_batch_size must be positive"):
+            rpc.ProcessGroupRpcBackendOptions(max_batch_size=0)
+
     @dist_init
     def test_default_timeout_used(self):
         """
@@ -3431,7 +3505,7 @@ class FaultyAgentRpcTest(FaultyRpcAgentTestFixture):
         self.assertEqual(self.rpc_backend, rpc.backend_registry.BackendType.FAULTY_PROCESS_GROUP)
         self.assertEqual(self.rpc_backend_options.num_send_recv_threads, 8)
         self.assertEqual(self.rpc_backend_options.num_fail_sends, 3)
-        self.assertEqual(len(self.rpc_backend_options.messages_to_fail), 4)
+        self.assertEqual(len(self.rpc_backend_options.messages_to_fail), 5)
         self.assertEqual(len(self.rpc_backend_options.messages_to_delay), 2)
         self.assertEqual(self.rpc_backend_options.rpc_timeout, rpc.constants.DEFAULT_RPC_TIMEOUT_SEC)
 
@@ -3775,3 +3849,63 @@ class TensorPipeAgentRpcTest(TensorPipeRpcAgentTestFixture, RpcTest):
                 num_worker_threads=self.rpc_backend_options.num_worker_threads,
                 rpc_timeout=timeout,
             )
+
+    @dist_init(setup_rpc=False)
+    def test_device_maps_options(self):
+        options = rpc.TensorPipeRpcBackendOptions(device_maps={"worker1": {0: 1}})
+        options.set_device_map("worker1", {1: 0})
+        options.set_device_map("worker2", {0: 0})
+        self.assertEqual(
+            options.device_maps, {"worker1": {0: 1, 1: 0}, "worker2": {0: 0}})
+
+    def _init_rpc_with_device_map(self, dst, device_map):
+        options = self.rpc_backend_options
+        rpc_backend_options = rpc.TensorPipeRpcBackendOptions(
+            init_method=options.init_method,
+            num_worker_threads=options.num_worker_threads,
+            device_maps={dst: device_map},
+        )
+        rpc.init_rpc(
+            name=worker_name(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=rpc_backend_options,
+        )
+
+    @staticmethod
+    def _add_on_device(t, device):
+        if t.device != torch.device(device):
+            raise ValueError("Expected a tensor on {}".format(device))
+        return t + 1
+
+    @skip_if_lt_x_gpu(2)
+    @dist_init(setup_rpc=False)
+    def test_device_maps(self):
+        dst = worker_name((self.rank + 1) % self.world_size)
+        self._init_rpc_with_device_map(dst, {0: 1})
+
+        # The argument is received on cuda:1, the result is sent back to cuda:0
+        ret = rpc.rpc_sync(
+            dst,
+            TensorPipeAgentRpcTest._add_on_device,
+            args=(torch.zeros(2, 2).to(0), "cuda:1"))
+        self.assertEqual(ret.device, torch.device("cuda:0"))
+        self.assertEqual(ret, torch.ones(2, 2).to(0))
+
+        # CPU tensors are left on CPU
+        ret = rpc.rpc_sync(
+            dst,
+            TensorPipeAgentRpcTest._add_on_device,
+            args=(torch.zeros(2, 2), "cpu"))
+        self.assertEqual(ret, torch.ones(2, 2))
+
+        # cuda:1 is not mapped
+        with self.assertRaisesRegex(RuntimeError, "Found tensor on device: cuda:1"):
+            rpc.rpc_sync(dst, torch.add, args=(torch.zeros(2).to(1), 1))
+
+        # The result on cuda:0 is not in the reverse map
+        with self.assertRaisesRegex(RuntimeError, "Found tensor on device: cuda:0"):
+            rpc.rpc_sync(dst, RpcTest._return_gpu_tensor, args=())
+
+        rpc.shutdown()
@@ -42,6 +42,13 @@ default_collate_err_msg_format = (
 def default_collate(batch):
     r"""Puts each data field into a tensor with outer dimension batch size"""
 
+    # The fast path in C++ handles tensors, numbers, strings, dicts, lists and
+    # tuples, and calls `_default_collate_python` for anything else.
+    in_worker = torch.utils.data.get_worker_info() is not None
+    return torch._C._collate(batch, _default_collate_python, in_worker, False)
+
+
+def _default_collate_python(batch):
     elem = batch[0]
     elem_type = type(elem)
     if isinstance(elem, torch.Tensor):
@@ -1,20 +1,44 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 import torch
 
-from torch._C import _from_dlpack as from_dlpack
 from torch._C import _to_dlpack as to_dlpack
 
-torch._C._add_docstr(from_dlpack, r"""from_dlpack(dlpack) -> Tensor
+# The device types of DLPack, from dlpack.h.
+_DL_CPU = 1
+_DL_GPU = 2
 
-Decodes a DLPack to a tensor.
 
-Args:
-    dlpack: a PyCapsule object with the dltensor
+def from_dlpack(ext_tensor):
+    r"""from_dlpack(ext_tensor) -> Tensor
+
+    Decodes a DLPack to a tensor.
+
+    Args:
+        ext_tensor: a PyCapsule object with the dltensor, or an object of
+            another library which implements ``__dlpack__`` and
+            ``__dlpack_device__``
+
+    The tensor will share the memory with the object represented
+    in the dlpack.
+    Note that each dlpack can only be consumed once.
+
+    When given an object implementing ``__dlpack__``, the current stream of
+    the device of the object is passed to it, so that the object's library
+    orders the work that produces it before the work that PyTorch queues on
+    that stream, with no need to synchronize the device.
+    """
+    if hasattr(ext_tensor, '__dlpack__'):
+        device_type, device_index = ext_tensor.__dlpack_device__()
+        if device_type == _DL_GPU:
+            stream = torch.cuda.current_stream(device_index).cuda_stream
+            # 0 is ambiguous in the protocol, 1 is the legacy default stream.
+            dlpack = ext_tensor.__dlpack__(stream=stream if stream != 0 else 1)
+        else:
+            dlpack = ext_tensor.__dlpack__()
+    else:
+        dlpack = ext_tensor
+    return torch._C._from_dlpack(dlpack)
 
-The tensor will share the memory with the object represented
-in the dlpack.
-Note that each dlpack can only be consumed once.
-""")
 
 torch._C._add_docstr(to_dlpack, r"""to_dlpack(tensor) -> PyCapsule
 
@@ -25,4 +49,7 @@ Args:
 
 The dlpack shares the tensors memory.
 Note that each dlpack can only be consumed once.
+
+The work queued on the tensor is not waited for, use ``tensor.__dlpack__``
+to hand the tensor to another stream.
 """)
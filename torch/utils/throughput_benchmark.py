@@ -37,6 +37,46 @@ class ExecutionStats(object):
     def num_iters(self):
         return self._c_stats.num_iters
 
+    @property
+    def latency_p50_ms(self):
+        return self._c_stats.latency_p50_ms
+
+    @property
+    def latency_p90_ms(self):
+        return self._c_stats.latency_p90_ms
+
+    @property
+    def latency_p99_ms(self):
+        return self._c_stats.latency_p99_ms
+
+    @property
+    def latency_p999_ms(self):
+        return self._c_stats.latency_p999_ms
+
+    @property
+    def latency_max_ms(self):
+        return self._c_stats.latency_max_ms
+
+    @property
+    def warmup_latency_avg_ms(self):
+        return self._c_stats.warmup_latency_avg_ms
+
+    @property
+    def thread_stats(self):
+        '''
+        Returns a list with the num_iters, latency_avg_ms, latency_p50_ms and
+        latency_p99_ms of every calling thread
+        '''
+        return self._c_stats.thread_stats
+
+    @property
+    def latency_histogram(self):
+        '''
+        Returns the non-empty buckets of the latency histogram, as a list of
+        (largest latency of the bucket in ms, number of iterations) pairs
+        '''
+        return self._c_stats.latency_histogram
+
     @property
     def iters_per_second(self):
         '''
@@ -53,6 +93,9 @@ class ExecutionStats(object):
     def __str__(self):
         return '\n'.join([
             "Average latency per example: " + format_time(time_ms=self.latency_avg_ms),
+            "Latency p50 / p90 / p99 / p99.9: " + " / ".join(
+                format_time(time_ms=latency) for latency in
+                [self.latency_p50_ms, self.latency_p90_ms, self.latency_p99_ms, self.latency_p999_ms]),
             "Total number of iterations: {}".format(self.num_iters),
             "Total number of iterations per second (across all threads): {:.2f}".format(self.iters_per_second),
             "Total time: " + format_time(time_s=self.total_time_seconds)
@@ -122,7 +165,8 @@ class ThroughputBenchmark(object):
             num_calling_threads=1,
             num_warmup_iters=10,
             num_iters=100,
-            profiler_output_path=""):
+            profiler_output_path="",
+            cpu_affinity=None):
         '''
         Args:
             num_warmup_iters (int): Warmup iters are used to make sure we run a module
@@ -142,16 +186,105 @@ class ThroughputBenchmark(object):
                 execution (but not the warmup phase). The full trace will be saved
                 into the file path provided by this argument
 
+            cpu_affinity (list of int, optional): CPUs to pin the calling threads
+                to, calling thread i being pinned to cpu_affinity[i % len(cpu_affinity)].
+                Pinning avoids migrations of the callers between cores, which show
+                up in the tail latencies. Only supported on Linux
 
         This function returns BenchmarkExecutionStats object which is defined via pybind11.
-        It currently has two fields:
+        It currently has the following fields:
             - num_iters - number of actual iterations the benchmark have made
             - avg_latency_ms - average time it took to infer on one input example in milliseconds
+            - latency_p50_ms, latency_p90_ms, latency_p99_ms, latency_p999_ms, latency_max_ms -
+              percentiles of the latencies of the individual iterations, within 2%
+            - warmup_latency_avg_ms - average latency of the warmup iterations, which
+              are left out of all the other fields
+            - thread_stats - the latencies of every calling thread
+            - latency_histogram - the histogram the percentiles are computed from
         '''
         config = torch._C.BenchmarkConfig()
         config.num_calling_threads = num_calling_threads
         config.num_warmup_iters = num_warmup_iters
         config.num_iters = num_iters
         config.profiler_output_path = profiler_output_path
+        if cpu_affinity is not None:
+            config.cpu_affinity = list(cpu_affinity)
         c_stats = self._benchmark.benchmark(config)
         return ExecutionStats(c_stats, config)
+
+
+class DynamicBatcher(object):
+    '''
+    This class is a wrapper around a c++ component
+    throughput_benchmark::DynamicBatcher which serves requests to one or more
+    ScriptModules the way an inference server would. The requests of every
+    model are queued, and worker threads run them in batches: a batch is run
+    when it has ``max_batch_size`` requests, or when its first request has
+    waited for ``max_delay_us`` microseconds.
+
+    A request is the arguments of the model's forward for a single example,
+    without the batch dimension. The tensor arguments of the requests of a
+    batch are stacked along a new first dimension, after padding them with
+    ``padding_value`` to the largest size in every dimension if they don't
+    all have the same sizes. The output of the model (a Tensor, or a tuple or
+    a list of them) is split back into the output of each request, and the
+    output dimensions of the padded length of the first argument are cut back
+    to the length of the request's own first argument.
+
+    Example::
+
+        >>> from torch.utils.throughput_benchmark import DynamicBatcher
+        >>> batcher = DynamicBatcher(max_batch_size=16, max_delay_us=2000)
+        >>> batcher.add_model("encoder", scripted_encoder)
+        >>> futures = [batcher.submit("encoder", x) for x in examples]
+        >>> outputs = [fut.wait() for fut in futures]
+        >>> print(batcher.stats("encoder").latency_p99_ms)
+        >>> batcher.shutdown()
+    '''
+
+    def __init__(
+            self,
+            max_batch_size=8,
+            max_delay_us=1000,
+            num_worker_threads=1,
+            padding_value=0,
+            latency_window=10000):
+        config = torch._C.DynamicBatcherConfig()
+        config.max_batch_size = max_batch_size
+        config.max_delay_us = max_delay_us
+        config.num_worker_threads = num_worker_threads
+        config.padding_value = padding_value
+        config.latency_window = latency_window
+        self._batcher = torch._C.DynamicBatcher(config)
+
+    def add_model(self, name, module):
+        '''
+        Starts serving the requests submitted for ``name`` with the module,
+        which must be a ScriptModule.
+        '''
+        if not isinstance(module, torch.jit.ScriptModule):
+            raise TypeError("DynamicBatcher only serves ScriptModules, but got {}"
+                            .format(type(module).__name__))
+        self._batcher.add_model(name, module._c)
+
+    def submit(self, name, *args, **kwargs):
+        '''
+        Queues a request to the model ``name`` and returns a ``torch._C.Future``
+        holding its output.
+        '''
+        return self._batcher.submit(name, *args, **kwargs)
+
+    def stats(self, name):
+        '''
+        Returns the DynamicBatcherStats of the model ``name``, defined via
+        pybind11: num_requests, num_batches, avg_batch_size, and the average,
+        p50, p90 and p99 latencies in milliseconds from the submission of the
+        requests to their completion.
+        '''
+        return self._batcher.stats(name)
+
+    def shutdown(self):
+        '''
+        Runs the requests already queued, and stops the worker threads.
+        '''
+        self._batcher.shutdown()